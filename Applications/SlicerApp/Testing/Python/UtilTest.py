@@ -69,6 +69,7 @@ class UtilTestTest(ScriptedLoadableModuleTest):
     self.test_arrayFromVolume()
     self.test_updateVolumeFromArray()
     self.test_updateTableFromArray()
+    self.test_updateTableColumnFromArray()
     self.test_arrayFromModelPoints()
     self.test_arrayFromVTKMatrix()
     self.test_arrayFromTransformMatrix()
@@ -259,6 +260,37 @@ class UtilTestTest(ScriptedLoadableModuleTest):
 
     self.delayDisplay('Testing slicer.util.test_updateTableFromArray passed')
 
+  def test_updateTableColumnFromArray(self):
+    # Test if table columns can be set from numpy arrays without copying
+    import numpy as np
+
+    tableNode = slicer.mrmlScene.AddNewNodeByClass("vtkMRMLTableNode")
+    values = np.arange(100, dtype=np.float64)
+    slicer.util.updateTableColumnFromArray(tableNode, "Values", values)
+    slicer.util.updateTableColumnFromArray(tableNode, "Squares", values*values)
+    self.assertEqual(tableNode.GetNumberOfColumns(), 2)
+    self.assertEqual(tableNode.GetNumberOfRows(), 100)
+    self.assertEqual(tableNode.GetCellValue(10, 1).ToDouble(), 100.0)
+
+    # memory is shared with the numpy array
+    values[5] = -1.0
+    slicer.util.arrayFromTableColumnModified(tableNode, "Values")
+    self.assertEqual(tableNode.GetCellValue(5, 0).ToDouble(), -1.0)
+
+    # existing column is replaced
+    slicer.util.updateTableColumnFromArray(tableNode, "Values", np.zeros(100))
+    self.assertEqual(tableNode.GetNumberOfColumns(), 2)
+    self.assertEqual(tableNode.GetColumnName(0), "Values")
+    self.assertEqual(tableNode.GetCellValue(5, 0).ToDouble(), 0.0)
+
+    with self.assertRaises(ValueError):
+      slicer.util.updateTableColumnFromArray(tableNode, "Values", np.zeros(3))
+
+    self.assertEqual(tableNode.AddEmptyRows(10), 100)
+    self.assertEqual(tableNode.GetNumberOfRows(), 110)
+
+    self.delayDisplay('Testing slicer.util.test_updateTableColumnFromArray passed')
+
   def test_arrayFromModelPoints(self):
     # Test if retrieving point coordinates as a numpy array works
 
@@ -433,6 +465,15 @@ class UtilTestTest(ScriptedLoadableModuleTest):
     markupsNode.GetNthControlPointPositionWorld(1,position)
     np.testing.assert_array_equal(position,narray[1,:])
 
+    self.delayDisplay('Test arrayFromMarkupsControlPointPositions')
+
+    narray = slicer.util.arrayFromMarkupsControlPointPositions(markupsNode)
+    self.assertEqual(narray.shape, (2, 3))
+    narray[1,:] = [11, 12, 13]
+    slicer.util.arrayFromMarkupsControlPointPositionsModified(markupsNode)
+    markupsNode.GetNthControlPointPosition(1,position)
+    np.testing.assert_array_equal(position,[11, 12, 13])
+
   def test_array(self):
     # Test if convenience function of getting numpy array from various nodes works
 
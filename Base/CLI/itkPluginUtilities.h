@@ -8,6 +8,8 @@
 #include <itkPluginFilterWatcher.h>
 
 // STD includes
+#include <iostream>
+#include <sstream>
 #include <vector>
 #include <string>
 
@@ -86,6 +88,50 @@ namespace itk
       }
   }
 
+  //-----------------------------------------------------------------------------
+  /// Get the name of the file where the index-th intermediate result of an
+  /// output can be written. The name is made from the output file name given on
+  /// the command line, by inserting "_intermediate<index>" before the extension.
+  /// Returns an empty string if the output is not transferred through a file
+  /// or shared memory (e.g., shared object modules writing the scene directly).
+  /// \sa PublishIntermediateOutput()
+  std::string GetIntermediateOutputFileName(const std::string& outputFileName, unsigned int index)
+    {
+    if (outputFileName.empty() || outputFileName.compare(0, 7, "slicer:") == 0)
+      {
+      return std::string();
+      }
+    std::ostringstream suffix;
+    suffix << "_intermediate" << index;
+    std::string::size_type directoryEnd = outputFileName.find_last_of("/\\");
+    std::string::size_type extensionStart = outputFileName.rfind('.');
+    if (extensionStart == std::string::npos
+      || (directoryEnd != std::string::npos && extensionStart < directoryEnd))
+      {
+      return outputFileName + suffix.str();
+      }
+    return outputFileName.substr(0, extensionStart) + suffix.str() + outputFileName.substr(extensionStart);
+    }
+
+  //-----------------------------------------------------------------------------
+  /// Tell Slicer that an intermediate result of an output has been written,
+  /// so that it is loaded into the output node while the module keeps running.
+  /// intermediateFileName must be obtained by GetIntermediateOutputFileName()
+  /// and the file must be completely written. Slicer takes the ownership of
+  /// the file and removes it after loading.
+  void PublishIntermediateOutput(const std::string& outputFileName, const std::string& intermediateFileName)
+    {
+    if (intermediateFileName.empty())
+      {
+      return;
+      }
+    std::cout << "<filter-intermediate-output>"
+              << "<output>" << outputFileName << "</output>"
+              << "<file>" << intermediateFileName << "</file>"
+              << "</filter-intermediate-output>"
+              << std::endl << std::flush;
+    }
+
 } // end namespace itk
 
 #endif
@@ -22,6 +22,7 @@
 #include "vtkSlicerApplicationLogic.h"
 #include "vtkMRMLCoreTestingMacros.h"
 #include "vtkSlicerConfigure.h"
+#include "vtkSlicerTask.h"
 
 // Slicer MRML includes
 #include "vtkMRMLScene.h"
@@ -29,6 +30,84 @@
 
 // VTK includes
 #include <vtkNew.h>
+#include <vtkObjectFactory.h>
+
+// ITKSYS includes
+#include <itksys/SystemTools.hxx>
+
+// STD includes
+#include <atomic>
+#include <set>
+#include <thread>
+
+namespace
+{
+
+//-----------------------------------------------------------------------------
+/// Logic with a task function that records how many tasks run at the same time
+class vtkSchedulingTestLogic : public vtkMRMLAbstractLogic
+{
+public:
+  static vtkSchedulingTestLogic* New();
+  vtkTypeMacro(vtkSchedulingTestLogic, vtkMRMLAbstractLogic);
+
+  void RunTask(void* vtkNotUsed(clientData))
+  {
+    int running = ++this->NumberOfRunningTasks;
+    int maximum = this->MaximumNumberOfRunningTasks;
+    while (running > maximum && !this->MaximumNumberOfRunningTasks.compare_exchange_weak(maximum, running))
+      {
+      }
+    vtkSlicerTask* task = vtkSlicerTask::GetExecutingTask();
+    this->AllocatedNumberOfThreads = task ? task->GetAllocatedNumberOfThreads() : -1;
+    itksys::SystemTools::Delay(500);
+    --this->NumberOfRunningTasks;
+    ++this->NumberOfCompletedTasks;
+  }
+
+  void Reset()
+  {
+    this->NumberOfRunningTasks = 0;
+    this->MaximumNumberOfRunningTasks = 0;
+    this->NumberOfCompletedTasks = 0;
+    this->AllocatedNumberOfThreads = 0;
+  }
+
+  std::atomic<int> NumberOfRunningTasks{0};
+  std::atomic<int> MaximumNumberOfRunningTasks{0};
+  std::atomic<int> NumberOfCompletedTasks{0};
+  std::atomic<int> AllocatedNumberOfThreads{0};
+};
+vtkStandardNewMacro(vtkSchedulingTestLogic);
+
+//-----------------------------------------------------------------------------
+/// Schedule tasks and wait until all of them are completed
+int RunTasks(vtkSlicerApplicationLogic* appLogic, vtkSchedulingTestLogic* logic,
+  int numberOfTasks, int numberOfThreads, bool exclusive, bool sameClientData)
+{
+  logic->Reset();
+  int clientData[10];
+  for (int i = 0; i < numberOfTasks; ++i)
+    {
+    vtkNew<vtkSlicerTask> task;
+    task->SetTypeToProcessing();
+    task->SetTaskFunction(logic, (vtkSlicerTask::TaskFunctionPointer)
+      &vtkSchedulingTestLogic::RunTask, sameClientData ? &clientData[0] : &clientData[i]);
+    task->SetNumberOfThreads(numberOfThreads);
+    task->SetExclusive(exclusive);
+    CHECK_BOOL(appLogic->ScheduleTask(task.GetPointer()) != 0, true);
+    }
+  for (int i = 0; i < 200
+    && (logic->NumberOfCompletedTasks < numberOfTasks || appLogic->GetNumberOfRunningProcessingTasks() > 0); ++i)
+    {
+    itksys::SystemTools::Delay(100);
+    }
+  CHECK_INT(logic->NumberOfCompletedTasks, numberOfTasks);
+  CHECK_INT(appLogic->GetNumberOfRunningProcessingTasks(), 0);
+  return EXIT_SUCCESS;
+}
+
+} // end of anonymous namespace
 
 //-----------------------------------------------------------------------------
 int vtkSlicerApplicationLogicTest1(int , char * [])
@@ -343,6 +422,134 @@ int vtkSlicerApplicationLogicTest1(int , char * [])
     }
   }
 
+  //-----------------------------------------------------------------------------
+  // Test RequestModified(vtkObject*) and ProcessModified()
+  //-----------------------------------------------------------------------------
+  {
+  vtkNew<vtkSlicerApplicationLogic> appLogic;
+  vtkNew<vtkMRMLModelHierarchyNode> node;
+  // requests are rejected until the processing thread is created
+  CHECK_BOOL(appLogic->RequestModified(node.GetPointer()) == 0, true);
+  appLogic->CreateProcessingThread();
+  CHECK_BOOL(appLogic->GetModifiedQueueCapacity() > 0, true);
+  vtkMTimeType mtime = node->GetMTime();
+  for (int i = 0; i < 10; ++i)
+    {
+    CHECK_BOOL(appLogic->RequestModified(node.GetPointer()) != 0, true);
+    }
+  CHECK_INT(appLogic->GetModifiedQueueSize(), 10);
+  // node is not modified until the requests are processed
+  CHECK_BOOL(node->GetMTime() == mtime, true);
+  appLogic->ProcessModified();
+  CHECK_INT(appLogic->GetModifiedQueueSize(), 0);
+  CHECK_INT(appLogic->GetModifiedQueueMaximumSize(), 10);
+  CHECK_BOOL(node->GetMTime() > mtime, true);
+  CHECK_BOOL(appLogic->GetModifiedQueueLastLatency() >= 0., true);
+  appLogic->ResetModifiedQueueStatistics();
+  CHECK_INT(appLogic->GetModifiedQueueMaximumSize(), 0);
+
+  // requests beyond the ring capacity, posted concurrently, are neither
+  // dropped nor given duplicate UIDs
+  const int numberOfThreads = 4;
+  const int requestsPerThread = appLogic->GetModifiedQueueCapacity() / 2 + 10;
+  std::vector< std::vector<vtkMTimeType> > uids(numberOfThreads);
+  std::vector<std::thread> producers;
+  for (int t = 0; t < numberOfThreads; ++t)
+    {
+    producers.emplace_back([&, t]()
+      {
+      for (int i = 0; i < requestsPerThread; ++i)
+        {
+        uids[t].push_back(appLogic->RequestModified(node.GetPointer()));
+        }
+      });
+    }
+  for (std::thread& producer : producers)
+    {
+    producer.join();
+    }
+  std::set<vtkMTimeType> uniqueUIDs;
+  for (const std::vector<vtkMTimeType>& threadUIDs : uids)
+    {
+    for (vtkMTimeType uid : threadUIDs)
+      {
+      CHECK_BOOL(uid != 0, true);
+      uniqueUIDs.insert(uid);
+      }
+    }
+  CHECK_INT(static_cast<int>(uniqueUIDs.size()), numberOfThreads * requestsPerThread);
+  CHECK_INT(appLogic->GetModifiedQueueSize(), numberOfThreads * requestsPerThread);
+  appLogic->ProcessModified();
+  CHECK_INT(appLogic->GetModifiedQueueSize(), 0);
+  CHECK_INT(node->GetReferenceCount(), 1);
+
+  // requests posted while the main thread processes the queue are all processed
+  std::atomic<int> numberOfRunningProducers(numberOfThreads);
+  std::atomic<int> numberOfRejectedRequests(0);
+  producers.clear();
+  for (int t = 0; t < numberOfThreads; ++t)
+    {
+    producers.emplace_back([&]()
+      {
+      for (int i = 0; i < requestsPerThread; ++i)
+        {
+        if (appLogic->RequestModified(node.GetPointer()) == 0)
+          {
+          ++numberOfRejectedRequests;
+          }
+        }
+      --numberOfRunningProducers;
+      });
+    }
+  while (numberOfRunningProducers > 0 || appLogic->GetModifiedQueueSize() > 0)
+    {
+    appLogic->ProcessModified();
+    }
+  for (std::thread& producer : producers)
+    {
+    producer.join();
+    }
+  appLogic->ProcessModified();
+  CHECK_INT(numberOfRejectedRequests.load(), 0);
+  CHECK_INT(appLogic->GetModifiedQueueSize(), 0);
+  CHECK_INT(node->GetReferenceCount(), 1);
+  appLogic->TerminateProcessingThread();
+  }
+
+  //-----------------------------------------------------------------------------
+  // Test concurrent processing tasks
+  //-----------------------------------------------------------------------------
+  {
+  vtkNew<vtkSlicerApplicationLogic> appLogic;
+  vtkNew<vtkSchedulingTestLogic> logic;
+  appLogic->CreateProcessingThread();
+
+  // tasks run one after the other by default
+  CHECK_INT(appLogic->GetMaximumNumberOfConcurrentProcessingTasks(), 1);
+  CHECK_EXIT_SUCCESS(RunTasks(appLogic.GetPointer(), logic.GetPointer(), 3, 1, false, false));
+  CHECK_INT(logic->MaximumNumberOfRunningTasks, 1);
+
+  // number of concurrent tasks is limited by the number of threads
+  appLogic->SetMaximumNumberOfConcurrentProcessingTasks(3);
+  appLogic->SetProcessingNumberOfThreadsLimit(4);
+  CHECK_EXIT_SUCCESS(RunTasks(appLogic.GetPointer(), logic.GetPointer(), 6, 2, false, false));
+  CHECK_INT(logic->MaximumNumberOfRunningTasks, 2);
+  CHECK_INT(logic->AllocatedNumberOfThreads, 2);
+
+  // tasks that use all the threads run one after the other
+  CHECK_EXIT_SUCCESS(RunTasks(appLogic.GetPointer(), logic.GetPointer(), 3, 0, false, false));
+  CHECK_INT(logic->MaximumNumberOfRunningTasks, 1);
+  CHECK_INT(logic->AllocatedNumberOfThreads, 4);
+
+  // exclusive tasks and tasks of the same client data do not run concurrently
+  CHECK_EXIT_SUCCESS(RunTasks(appLogic.GetPointer(), logic.GetPointer(), 3, 1, true, false));
+  CHECK_INT(logic->MaximumNumberOfRunningTasks, 1);
+  CHECK_EXIT_SUCCESS(RunTasks(appLogic.GetPointer(), logic.GetPointer(), 3, 1, false, true));
+  CHECK_INT(logic->MaximumNumberOfRunningTasks, 1);
+
+  appLogic->TerminateProcessingThread();
+  }
+
   return EXIT_SUCCESS;
 }
 
@@ -315,7 +315,12 @@ int vtkDataIOManagerLogic::QueueRead ( vtkMRMLNode *node )
   //--- Again, test for space to download the file.
   //--- This test has been done in MRML (DataIOManager), but with asynchIO,
   //--- Cache may have become full since the remote read was queued.
+  //--- Make room first by removing the least recently used files.
   //---
+  if ( cm->GetEnableLeastRecentlyUsedRemoval() )
+    {
+    cm->RemoveLeastRecentlyUsedFiles();
+    }
   float bufsize = (cm->GetRemoteCacheLimit() * 1000000.0) -  (cm->GetRemoteCacheFreeBufferSize() * 1000000.0);
   if ( (cm->GetCurrentCacheSize()*1000000.0) >= bufsize )
     {
@@ -353,6 +358,12 @@ int vtkDataIOManagerLogic::QueueRead ( vtkMRMLNode *node )
        allCachedFilesExist &&
        ( !(cm->GetEnableForceRedownload())) )
     {
+    //--- keep recently loaded files when the cache is full
+    cm->MarkCachedFileAccessed ( dest );
+    for (int uriNum = 0; uriNum < dnode->GetNthStorageNode(storageNodeIndex)->GetNumberOfURIs(); uriNum++)
+      {
+      cm->MarkCachedFileAccessed ( dnode->GetNthStorageNode(storageNodeIndex)->GetNthFileName(uriNum) );
+      }
     dnode->GetNthStorageNode(storageNodeIndex)->SetReadStateTransferDone();
     vtkDebugMacro("QueueRead: the destination file is there and we're not forceing redownload");
     return 1;
@@ -395,6 +406,7 @@ int vtkDataIOManagerLogic::QueueRead ( vtkMRMLNode *node )
   transfer0->SetTransferType ( vtkDataTransfer::RemoteDownload );
   transfer0->SetTransferStatus ( vtkDataTransfer::Idle );
   transfer0->SetCancelRequested ( 0 );
+  this->SetCachedFileValidators ( transfer0.GetPointer() );
   //--- Add the data transfer to the collection, and
   //--- the resulting mrml call will trigger an event
   //--- that causes GUI to refresh.
@@ -457,6 +469,7 @@ int vtkDataIOManagerLogic::QueueRead ( vtkMRMLNode *node )
     transfer1->SetTransferType ( vtkDataTransfer::RemoteDownload );
     transfer1->SetTransferStatus ( vtkDataTransfer::Idle );
     transfer1->SetCancelRequested ( 0 );
+    this->SetCachedFileValidators ( transfer1.GetPointer() );
     this->AddNewDataTransfer ( transfer1.GetPointer(), node );
     this->GetDataIOManager()->InvokeEvent ( vtkDataIOManager::RefreshDisplayEvent );
 
@@ -667,6 +680,50 @@ int vtkDataIOManagerLogic::QueueWrite ( vtkMRMLNode *node )
 
 
 
+//----------------------------------------------------------------------------
+void vtkDataIOManagerLogic::DataTransferProgressCallback(vtkObject *caller,
+                                                        unsigned long vtkNotUsed(eid),
+                                                        void *clientData,
+                                                        void *vtkNotUsed(callData))
+{
+  vtkDataIOManagerLogic *self = reinterpret_cast<vtkDataIOManagerLogic *>(clientData);
+  if (self == nullptr || self->GetApplicationLogic() == nullptr)
+    {
+    return;
+    }
+  // The observers of the transfer are in the main thread
+  self->GetApplicationLogic()->RequestModified( caller );
+}
+
+//----------------------------------------------------------------------------
+void vtkDataIOManagerLogic::SetCachedFileValidators ( vtkDataTransfer *dt )
+{
+  vtkCacheManager *cm = this->GetDataIOManager()->GetCacheManager();
+  if ( cm == nullptr || !cm->CachedFileExists ( dt->GetDestinationURI() ) )
+    {
+    return;
+    }
+  std::string eTag = cm->GetCachedFileETag ( dt->GetSourceURI() );
+  std::string lastModified = cm->GetCachedFileLastModified ( dt->GetSourceURI() );
+  dt->SetETag ( eTag.empty() ? nullptr : eTag.c_str() );
+  dt->SetLastModified ( lastModified.empty() ? nullptr : lastModified.c_str() );
+}
+
+//----------------------------------------------------------------------------
+void vtkDataIOManagerLogic::AddDownloadedFileToCache ( vtkDataTransfer *dt )
+{
+  vtkDataIOManager *iom = this->GetDataIOManager();
+  vtkCacheManager *cm = iom ? iom->GetCacheManager() : nullptr;
+  if ( cm == nullptr || dt->GetDestinationURI() == nullptr ||
+       !vtksys::SystemTools::FileExists ( dt->GetDestinationURI(), true ) )
+    {
+    return;
+    }
+  cm->AddToCacheIndex ( dt->GetSourceURI(), dt->GetDestinationURI(), dt->GetETag(), dt->GetLastModified() );
+  //--- the cache manager may be observed by the GUI
+  this->GetApplicationLogic()->RequestModified( cm );
+}
+
 //----------------------------------------------------------------------------
 void vtkDataIOManagerLogic::ApplyTransfer( void *clientdata )
 {
@@ -716,7 +773,13 @@ void vtkDataIOManagerLogic::ApplyTransfer( void *clientdata )
         {
         dt->SetTransferStatusNoModify ( vtkDataTransfer::Running );
         this->GetApplicationLogic()->RequestModified( dt );
-        handler->StageFileRead( source, dest);
+        vtkNew<vtkCallbackCommand> progressCallback;
+        progressCallback->SetCallback( vtkDataIOManagerLogic::DataTransferProgressCallback );
+        progressCallback->SetClientData( this );
+        unsigned long progressObserverTag = dt->AddObserver( vtkCommand::ProgressEvent, progressCallback.GetPointer() );
+        handler->StageFileRead( source, dest, dt );
+        dt->RemoveObserver( progressObserverTag );
+        this->AddDownloadedFileToCache( dt );
         dt->SetTransferStatusNoModify ( vtkDataTransfer::Completed );
         this->GetApplicationLogic()->RequestModified( dt );
 
@@ -758,7 +821,8 @@ void vtkDataIOManagerLogic::ApplyTransfer( void *clientdata )
       else
         {
         vtkDebugMacro("ApplyTransfer: stage file read on the handler..., source = " << source << ", dest = " << dest);
-        handler->StageFileRead( source, dest);
+        handler->StageFileRead( source, dest, dt );
+        this->AddDownloadedFileToCache( dt );
         }
       }
     }
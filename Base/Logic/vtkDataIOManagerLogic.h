@@ -69,7 +69,17 @@ class VTK_SLICER_BASE_LOGIC_EXPORT vtkDataIOManagerLogic : public vtkSlicerModul
   vtkObserverManager* GetDataIOObserverManager();
   vtkObserverManager* DataIOObserverManager;
   static void DataIOManagerCallback(vtkObject *caller, unsigned long eid, void *clientData, void *callData);
+  /// Called in the networking thread when the progress of a data transfer changes.
+  /// Requests a Modified of the transfer in the main thread.
+  static void DataTransferProgressCallback(vtkObject *caller, unsigned long eid, void *clientData, void *callData);
   virtual void ProcessDataIOManagerEvents( vtkObject *caller, unsigned long event, void *calldata );
+
+  /// Set the validators of the cached copy of the source of a download,
+  /// so that the handler downloads it only if the remote file has changed.
+  void SetCachedFileValidators ( vtkDataTransfer *transfer );
+  /// Record the file of a completed download in the cache index.
+  /// Can be called from the networking thread.
+  void AddDownloadedFileToCache ( vtkDataTransfer *transfer );
 };
 
 #endif
@@ -30,10 +30,18 @@
 #include <vtkObjectFactory.h>
 
 // ITKSYS includes
+#include <itksys/SystemInformation.hxx>
 #include <itksys/SystemTools.hxx>
 
 // STD includes
 #include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <deque>
+#include <set>
+#include <thread>
 
 #ifdef ITK_USE_PTHREADS
 # include <unistd.h>
@@ -47,10 +55,162 @@
 
 //----------------------------------------------------------------------------
 class ProcessingTaskQueue : public std::queue<vtkSmartPointer<vtkSlicerTask> > {};
-class ModifiedQueue : public std::queue<vtkSmartPointer<vtkObject> > {};
 class ReadDataQueue : public std::queue<DataRequest*> {};
 class WriteDataQueue : public std::queue<DataRequest*> {};
 
+//----------------------------------------------------------------------------
+/// Bounded multiple-producer single-consumer lock-free queue of objects to
+/// modify in the main thread.
+/// Each cell holds a sequence number that tells producers and the consumer
+/// whether the cell is free or filled for the current lap of the ring.
+/// Producers reserve a cell by incrementing EnqueuePosition with a
+/// compare-and-swap, only the main thread dequeues.
+/// When the ring is full, requests go to a mutex-protected overflow queue
+/// instead so that no request is ever dropped.
+class ModifiedQueue
+{
+public:
+  typedef std::chrono::steady_clock ClockType;
+
+  ModifiedQueue(size_t capacity)
+    : Mask(capacity - 1)
+    , MaximumSize(0)
+    , LastLatency(0.)
+    , MaximumLatency(0.)
+    , Cells(new Cell[capacity])
+    , EnqueuePosition(0)
+    , DequeuePosition(0)
+    , OverflowSize(0)
+  {
+    // capacity must be a power of 2
+    assert(capacity >= 2 && (capacity & (capacity - 1)) == 0);
+    for (size_t i = 0; i < capacity; ++i)
+      {
+      this->Cells[i].Sequence.store(i, std::memory_order_relaxed);
+      }
+  }
+
+  ~ModifiedQueue()
+  {
+    delete [] this->Cells;
+  }
+
+  /// Thread-safe. Never fails: requests that do not fit in the ring are
+  /// appended to the overflow queue.
+  void Push(vtkObject* object)
+  {
+    Cell* cell = nullptr;
+    size_t position = this->EnqueuePosition.load(std::memory_order_relaxed);
+    for (;;)
+      {
+      cell = &this->Cells[position & this->Mask];
+      size_t sequence = cell->Sequence.load(std::memory_order_acquire);
+      intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+      if (difference == 0)
+        {
+        if (this->EnqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+          {
+          break;
+          }
+        }
+      else if (difference < 0)
+        {
+        // ring is full
+        this->PushOverflow(object);
+        return;
+        }
+      else
+        {
+        position = this->EnqueuePosition.load(std::memory_order_relaxed);
+        }
+      }
+    cell->Object = object;
+    cell->RequestTime = ClockType::now();
+    cell->Sequence.store(position + 1, std::memory_order_release);
+  }
+
+  /// Must only be called from the consumer (main) thread.
+  /// Return false if the queue is empty.
+  bool Pop(vtkObject*& object, ClockType::time_point& requestTime)
+  {
+    size_t position = this->DequeuePosition.load(std::memory_order_relaxed);
+    Cell* cell = &this->Cells[position & this->Mask];
+    size_t sequence = cell->Sequence.load(std::memory_order_acquire);
+    if (sequence != position + 1)
+      {
+      // ring is empty, or the producer has not finished writing the cell yet
+      return this->PopOverflow(object, requestTime);
+      }
+    object = cell->Object;
+    requestTime = cell->RequestTime;
+    cell->Sequence.store(position + this->Mask + 1, std::memory_order_release);
+    this->DequeuePosition.store(position + 1, std::memory_order_relaxed);
+    return true;
+  }
+
+  /// Approximate number of pending requests.
+  size_t Size() const
+  {
+    size_t enqueuePosition = this->EnqueuePosition.load(std::memory_order_relaxed);
+    size_t dequeuePosition = this->DequeuePosition.load(std::memory_order_relaxed);
+    size_t ringSize = enqueuePosition > dequeuePosition ? enqueuePosition - dequeuePosition : 0;
+    return ringSize + this->OverflowSize.load(std::memory_order_relaxed);
+  }
+
+  size_t Capacity() const
+  {
+    return this->Mask + 1;
+  }
+
+  const size_t Mask;
+
+  // statistics, only updated by the consumer thread
+  size_t MaximumSize;
+  double LastLatency;
+  double MaximumLatency;
+
+private:
+  void PushOverflow(vtkObject* object)
+  {
+    std::lock_guard<std::mutex> lock(this->OverflowLock);
+    this->Overflow.emplace_back(object, ClockType::now());
+    this->OverflowSize.store(this->Overflow.size(), std::memory_order_relaxed);
+  }
+
+  bool PopOverflow(vtkObject*& object, ClockType::time_point& requestTime)
+  {
+    // avoid taking the lock in the common case of an empty overflow queue
+    if (this->OverflowSize.load(std::memory_order_relaxed) == 0)
+      {
+      return false;
+      }
+    std::lock_guard<std::mutex> lock(this->OverflowLock);
+    if (this->Overflow.empty())
+      {
+      return false;
+      }
+    object = this->Overflow.front().first;
+    requestTime = this->Overflow.front().second;
+    this->Overflow.pop_front();
+    this->OverflowSize.store(this->Overflow.size(), std::memory_order_relaxed);
+    return true;
+  }
+
+  struct Cell
+  {
+    std::atomic<size_t> Sequence;
+    vtkObject* Object;
+    ClockType::time_point RequestTime;
+  };
+  Cell* const Cells;
+  std::atomic<size_t> EnqueuePosition;
+  std::atomic<size_t> DequeuePosition;
+
+  std::mutex OverflowLock;
+  std::deque<std::pair<vtkObject*, ClockType::time_point> > Overflow;
+  std::atomic<size_t> OverflowSize;
+};
+
 //----------------------------------------------------------------------------
 vtkStandardNewMacro(vtkSlicerApplicationLogic);
 
@@ -58,17 +218,30 @@ vtkStandardNewMacro(vtkSlicerApplicationLogic);
 vtkSlicerApplicationLogic::vtkSlicerApplicationLogic()
 {
   this->ProcessingThreader = itk::PlatformMultiThreader::New();
-  this->ProcessingThreadId = -1;
   this->ProcessingThreadActive = false;
 
+  this->MaximumNumberOfConcurrentProcessingTasks = 1;
+  this->ProcessingNumberOfThreadsLimit = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+  itksys::SystemInformation systemInformation;
+  systemInformation.RunMemoryCheck();
+  size_t totalPhysicalMemoryMB = systemInformation.GetTotalPhysicalMemory();
+  this->ProcessingMemoryLimitMB = (totalPhysicalMemoryMB > 0 && totalPhysicalMemoryMB < INT_MAX)
+    ? static_cast<int>(totalPhysicalMemoryMB) : INT_MAX;
+  this->NumberOfRunningProcessingTasks = 0;
+  this->NumberOfUsedProcessingThreads = 0;
+  this->UsedProcessingMemoryMB = 0;
+  this->ExclusiveProcessingTaskRunning = false;
+
   this->ModifiedQueueActive = false;
+  this->LastRequestUID = 0;
 
   this->ReadDataQueueActive = false;
 
   this->WriteDataQueueActive = false;
 
   this->InternalTaskQueue = new ProcessingTaskQueue;
-  this->InternalModifiedQueue = new ModifiedQueue;
+  // Maximum number of pending Modified requests (must be a power of 2)
+  this->InternalModifiedQueue = new ModifiedQueue(8192);
 
   this->InternalReadDataQueue = new ReadDataQueue;
   this->InternalWriteDataQueue = new WriteDataQueue;
@@ -82,29 +255,29 @@ vtkSlicerApplicationLogic::~vtkSlicerApplicationLogic()
   // Note that TerminateThread does not kill a thread, it only waits
   // for the thread to finish.  We need to signal the thread that we
   // want to terminate
-  if (this->ProcessingThreadId != -1 && this->ProcessingThreader)
+  if (!this->ProcessingThreadIDs.empty() && this->ProcessingThreader)
     {
-    // Signal the processingThread that we are terminating.
+    // Signal the processing threads that we are terminating.
     this->ProcessingThreadActiveLock.lock();
     this->ProcessingThreadActive = false;
     this->ProcessingThreadActiveLock.unlock();
 
-    // Wait for the thread to finish and clean up the state of the threader
-    this->ProcessingThreader->TerminateThread( this->ProcessingThreadId );
-
-    this->ProcessingThreadId = -1;
+    // Wait for the threads to finish and clean up the state of the threader
+    for (int threadID : this->ProcessingThreadIDs)
+      {
+      this->ProcessingThreader->TerminateThread( threadID );
+      }
+    this->ProcessingThreadIDs.clear();
     }
 
   delete this->InternalTaskQueue;
 
-  this->ModifiedQueueLock.lock();
-  while (!(*this->InternalModifiedQueue).empty())
+  vtkObject *obj = nullptr;
+  ModifiedQueue::ClockType::time_point requestTime;
+  while (this->InternalModifiedQueue->Pop(obj, requestTime))
     {
-    vtkObject *obj = (*this->InternalModifiedQueue).front();
-    (*this->InternalModifiedQueue).pop();
-    obj->Delete(); // decrement ref count
+    obj->UnRegister(this); // decrement ref count
     }
-  this->ModifiedQueueLock.unlock();
   delete this->InternalModifiedQueue;
   delete this->InternalReadDataQueue;
   delete this->InternalWriteDataQueue;
@@ -176,16 +349,13 @@ void vtkSlicerApplicationLogic::PrintSelf(ostream& os, vtkIndent indent)
 //----------------------------------------------------------------------------
 void vtkSlicerApplicationLogic::CreateProcessingThread()
 {
-  if (this->ProcessingThreadId == -1)
+  if (this->ProcessingThreadIDs.empty())
     {
     this->ProcessingThreadActiveLock.lock();
     this->ProcessingThreadActive = true;
     this->ProcessingThreadActiveLock.unlock();
 
-    this->ProcessingThreadId
-      = this->ProcessingThreader
-      ->SpawnThread(vtkSlicerApplicationLogic::ProcessingThreaderCallback,
-                    this);
+    this->SpawnProcessingThreads();
 
     // Start four network threads (TODO: make the number of threads a setting)
     this->NetworkingThreadIDs.push_back ( this->ProcessingThreader
@@ -208,9 +378,7 @@ void vtkSlicerApplicationLogic::CreateProcessingThread()
     */
 
     // Setup the communication channel back to the main thread
-    this->ModifiedQueueActiveLock.lock();
     this->ModifiedQueueActive = true;
-    this->ModifiedQueueActiveLock.unlock();
     this->ReadDataQueueActiveLock.lock();
     this->ReadDataQueueActive = true;
     this->ReadDataQueueActiveLock.unlock();
@@ -228,11 +396,9 @@ void vtkSlicerApplicationLogic::CreateProcessingThread()
 //----------------------------------------------------------------------------
 void vtkSlicerApplicationLogic::TerminateProcessingThread()
 {
-  if (this->ProcessingThreadId != -1)
+  if (!this->ProcessingThreadIDs.empty())
     {
-    this->ModifiedQueueActiveLock.lock();
     this->ModifiedQueueActive = false;
-    this->ModifiedQueueActiveLock.unlock();
 
     this->ReadDataQueueActiveLock.lock();
     this->ReadDataQueueActive = false;
@@ -246,8 +412,11 @@ void vtkSlicerApplicationLogic::TerminateProcessingThread()
     this->ProcessingThreadActive = false;
     this->ProcessingThreadActiveLock.unlock();
 
-    this->ProcessingThreader->TerminateThread( this->ProcessingThreadId );
-    this->ProcessingThreadId = -1;
+    for (int threadID : this->ProcessingThreadIDs)
+      {
+      this->ProcessingThreader->TerminateThread( threadID );
+      }
+    this->ProcessingThreadIDs.clear();
 
     std::vector<int>::const_iterator idIterator;
     idIterator = this->NetworkingThreadIDs.begin();
@@ -295,29 +464,12 @@ void vtkSlicerApplicationLogic::ProcessProcessingTasks()
 
     if (active)
       {
-      // pull a task off the queue
-      this->ProcessingTaskQueueLock.lock();
-      if ((*this->InternalTaskQueue).size() > 0)
-        {
-        // std::cout << "Number of queued tasks: " << (*this->InternalTaskQueue).size() << std::endl;
-
-        // only handle processing tasks in this thread
-        task = (*this->InternalTaskQueue).front();
-        if ( task->GetType() == vtkSlicerTask::Processing )
-          {
-          (*this->InternalTaskQueue).pop();
-          }
-        else
-          {
-          task = nullptr;
-          }
-        }
-      this->ProcessingTaskQueueLock.unlock();
-
-      // process the task (should this be in a separate thread?)
+      // pull a task off the queue if there are enough resources for running it
+      task = this->StartNextProcessingTask();
       if (task)
         {
         task->Execute();
+        this->FinishProcessingTask(task);
         task = nullptr;
         }
       }
@@ -327,6 +479,149 @@ void vtkSlicerApplicationLogic::ProcessProcessingTasks()
     }
 }
 
+//----------------------------------------------------------------------------
+vtkSmartPointer<vtkSlicerTask> vtkSlicerApplicationLogic::StartNextProcessingTask()
+{
+  std::lock_guard<std::mutex> lock(this->ProcessingTaskQueueLock);
+  if ((*this->InternalTaskQueue).empty())
+    {
+    return nullptr;
+    }
+  // only handle processing tasks in this thread
+  vtkSmartPointer<vtkSlicerTask> task = (*this->InternalTaskQueue).front();
+  if (task->GetType() != vtkSlicerTask::Processing)
+    {
+    return nullptr;
+    }
+
+  int numberOfThreads = task->GetNumberOfThreads();
+  if (numberOfThreads <= 0 || numberOfThreads > this->ProcessingNumberOfThreadsLimit)
+    {
+    numberOfThreads = this->ProcessingNumberOfThreadsLimit;
+    }
+  // A task is always started if nothing else is running, even if it requires more
+  // resources than the limits. Tasks are not reordered, so that a task that requires
+  // a lot of resources is not postponed indefinitely by smaller tasks.
+  if (this->NumberOfRunningProcessingTasks > 0)
+    {
+    void* clientData = task->GetTaskClientData();
+    if (this->NumberOfRunningProcessingTasks >= this->MaximumNumberOfConcurrentProcessingTasks
+      || this->ExclusiveProcessingTaskRunning || task->GetExclusive()
+      || numberOfThreads > this->ProcessingNumberOfThreadsLimit - this->NumberOfUsedProcessingThreads
+      || task->GetMemoryMB() > this->ProcessingMemoryLimitMB - this->UsedProcessingMemoryMB
+      || (clientData && std::find(this->RunningProcessingTaskClientData.begin(),
+        this->RunningProcessingTaskClientData.end(), clientData) != this->RunningProcessingTaskClientData.end()))
+      {
+      return nullptr;
+      }
+    }
+
+  (*this->InternalTaskQueue).pop();
+  task->SetAllocatedNumberOfThreads(numberOfThreads);
+  this->NumberOfRunningProcessingTasks++;
+  this->NumberOfUsedProcessingThreads += numberOfThreads;
+  this->UsedProcessingMemoryMB += task->GetMemoryMB();
+  this->ExclusiveProcessingTaskRunning = this->ExclusiveProcessingTaskRunning || task->GetExclusive();
+  this->RunningProcessingTaskClientData.push_back(task->GetTaskClientData());
+  return task;
+}
+
+//----------------------------------------------------------------------------
+void vtkSlicerApplicationLogic::FinishProcessingTask(vtkSlicerTask* task)
+{
+  std::lock_guard<std::mutex> lock(this->ProcessingTaskQueueLock);
+  this->NumberOfRunningProcessingTasks--;
+  this->NumberOfUsedProcessingThreads -= task->GetAllocatedNumberOfThreads();
+  this->UsedProcessingMemoryMB -= task->GetMemoryMB();
+  if (task->GetExclusive())
+    {
+    this->ExclusiveProcessingTaskRunning = false;
+    }
+  std::vector<void*>::iterator clientDataIt = std::find(this->RunningProcessingTaskClientData.begin(),
+    this->RunningProcessingTaskClientData.end(), task->GetTaskClientData());
+  if (clientDataIt != this->RunningProcessingTaskClientData.end())
+    {
+    this->RunningProcessingTaskClientData.erase(clientDataIt);
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkSlicerApplicationLogic::SpawnProcessingThreads()
+{
+  this->ProcessingTaskQueueLock.lock();
+  int numberOfThreads = this->MaximumNumberOfConcurrentProcessingTasks;
+  this->ProcessingTaskQueueLock.unlock();
+  while (static_cast<int>(this->ProcessingThreadIDs.size()) < numberOfThreads)
+    {
+    int threadID = this->ProcessingThreader->SpawnThread(
+      vtkSlicerApplicationLogic::ProcessingThreaderCallback, this);
+    if (threadID < 0)
+      {
+      vtkWarningMacro("SpawnProcessingThreads: failed to start processing thread, "
+        << this->ProcessingThreadIDs.size() << " tasks may run concurrently");
+      break;
+      }
+    this->ProcessingThreadIDs.push_back(threadID);
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkSlicerApplicationLogic::SetMaximumNumberOfConcurrentProcessingTasks(int count)
+{
+  this->ProcessingTaskQueueLock.lock();
+  this->MaximumNumberOfConcurrentProcessingTasks = std::max(1, count);
+  this->ProcessingTaskQueueLock.unlock();
+  // Threads are only added. If the maximum is decreased, the extra threads
+  // do not start tasks while the maximum number of tasks are running.
+  if (!this->ProcessingThreadIDs.empty())
+    {
+    this->SpawnProcessingThreads();
+    }
+}
+
+//----------------------------------------------------------------------------
+int vtkSlicerApplicationLogic::GetMaximumNumberOfConcurrentProcessingTasks()
+{
+  std::lock_guard<std::mutex> lock(this->ProcessingTaskQueueLock);
+  return this->MaximumNumberOfConcurrentProcessingTasks;
+}
+
+//----------------------------------------------------------------------------
+void vtkSlicerApplicationLogic::SetProcessingNumberOfThreadsLimit(int numberOfThreads)
+{
+  std::lock_guard<std::mutex> lock(this->ProcessingTaskQueueLock);
+  this->ProcessingNumberOfThreadsLimit = std::max(1, numberOfThreads);
+}
+
+//----------------------------------------------------------------------------
+int vtkSlicerApplicationLogic::GetProcessingNumberOfThreadsLimit()
+{
+  std::lock_guard<std::mutex> lock(this->ProcessingTaskQueueLock);
+  return this->ProcessingNumberOfThreadsLimit;
+}
+
+//----------------------------------------------------------------------------
+void vtkSlicerApplicationLogic::SetProcessingMemoryLimitMB(int memoryMB)
+{
+  std::lock_guard<std::mutex> lock(this->ProcessingTaskQueueLock);
+  this->ProcessingMemoryLimitMB = std::max(1, memoryMB);
+}
+
+//----------------------------------------------------------------------------
+int vtkSlicerApplicationLogic::GetProcessingMemoryLimitMB()
+{
+  std::lock_guard<std::mutex> lock(this->ProcessingTaskQueueLock);
+  return this->ProcessingMemoryLimitMB;
+}
+
+//----------------------------------------------------------------------------
+int vtkSlicerApplicationLogic::GetNumberOfRunningProcessingTasks()
+{
+  std::lock_guard<std::mutex> lock(this->ProcessingTaskQueueLock);
+  return this->NumberOfRunningProcessingTasks;
+}
+
+//----------------------------------------------------------------------------
 itk::ITK_THREAD_RETURN_TYPE
 vtkSlicerApplicationLogic::NetworkingThreaderCallback(void* arg)
 {
@@ -408,25 +703,27 @@ int vtkSlicerApplicationLogic::ScheduleTask( vtkSlicerTask *task )
   return true;
 }
 
+//----------------------------------------------------------------------------
+vtkMTimeType vtkSlicerApplicationLogic::NewRequestUID()
+{
+  // Requests are posted from several threads holding different locks (or
+  // none for Modified requests), so the counter itself must be atomic.
+  return ++this->LastRequestUID;
+}
+
 //----------------------------------------------------------------------------
 vtkMTimeType vtkSlicerApplicationLogic::RequestModified(vtkObject *obj)
 {
   // only request a Modified if the Modified queue is up
-  this->ModifiedQueueActiveLock.lock();
-  int active = this->ModifiedQueueActive;
-  this->ModifiedQueueActiveLock.unlock();
-  if (!active)
+  if (!this->ModifiedQueueActive)
     {
     // could not request the Modified
     return 0;
     }
 
   obj->Register(this);
-  this->ModifiedQueueLock.lock();
-  this->RequestTimeStamp.Modified();
-  vtkMTimeType uid = this->RequestTimeStamp.GetMTime();
-  (*this->InternalModifiedQueue).push(obj);
-  this->ModifiedQueueLock.unlock();
+  vtkMTimeType uid = this->NewRequestUID();
+  this->InternalModifiedQueue->Push(obj);
   return uid;
 }
 
@@ -444,8 +741,7 @@ vtkMTimeType vtkSlicerApplicationLogic::RequestReadFile(const char *refNode, con
   }
 
   this->ReadDataQueueLock.lock();
-  this->RequestTimeStamp.Modified();
-  vtkMTimeType uid = this->RequestTimeStamp.GetMTime();
+  vtkMTimeType uid = this->NewRequestUID();
   (*this->InternalReadDataQueue).push(
     new ReadDataRequestFile(refNode, filename, displayData, deleteFile, uid));
   this->ReadDataQueueLock.unlock();
@@ -466,8 +762,7 @@ vtkMTimeType vtkSlicerApplicationLogic::RequestUpdateParentTransform(const std::
     }
 
   this->ReadDataQueueLock.lock();
-  this->RequestTimeStamp.Modified();
-  vtkMTimeType uid = this->RequestTimeStamp.GetMTime();
+  vtkMTimeType uid = this->NewRequestUID();
   (*this->InternalReadDataQueue).push(new ReadDataRequestUpdateParentTransform(refNode, parentTransformNode, uid));
   this->ReadDataQueueLock.unlock();
   return uid;
@@ -487,8 +782,7 @@ vtkMTimeType vtkSlicerApplicationLogic::RequestUpdateSubjectHierarchyLocation(co
     }
 
   this->ReadDataQueueLock.lock();
-  this->RequestTimeStamp.Modified();
-  vtkMTimeType uid = this->RequestTimeStamp.GetMTime();
+  vtkMTimeType uid = this->NewRequestUID();
   (*this->InternalReadDataQueue).push(new ReadDataRequestUpdateSubjectHierarchyLocation(updatedNode, siblingNode, uid));
   this->ReadDataQueueLock.unlock();
   return uid;
@@ -508,8 +802,7 @@ vtkMTimeType vtkSlicerApplicationLogic::RequestAddNodeReference(const std::strin
     }
 
   this->ReadDataQueueLock.lock();
-  this->RequestTimeStamp.Modified();
-  vtkMTimeType uid = this->RequestTimeStamp.GetMTime();
+  vtkMTimeType uid = this->NewRequestUID();
   (*this->InternalReadDataQueue).push(new ReadDataRequestAddNodeReference(referencingNode, referencedNode, role, uid));
   this->ReadDataQueueLock.unlock();
   return uid;
@@ -529,8 +822,7 @@ vtkMTimeType vtkSlicerApplicationLogic::RequestWriteData(const char *refNode, co
     }
 
   this->WriteDataQueueLock.lock();
-  this->RequestTimeStamp.Modified();
-  vtkMTimeType uid = this->RequestTimeStamp.GetMTime();
+  vtkMTimeType uid = this->NewRequestUID();
   (*this->InternalWriteDataQueue).push(
     new WriteDataRequestFile(refNode, filename, uid) );
   this->WriteDataQueueLock.unlock();
@@ -555,8 +847,7 @@ vtkMTimeType vtkSlicerApplicationLogic::RequestReadScene(
     }
 
   this->ReadDataQueueLock.lock();
-  this->RequestTimeStamp.Modified();
-  vtkMTimeType uid = this->RequestTimeStamp.GetMTime();
+  vtkMTimeType uid = this->NewRequestUID();
   (*this->InternalReadDataQueue).push(
     new ReadDataRequestScene(targetIDs, sourceIDs, filename, displayData, deleteFile, uid));
   this->ReadDataQueueLock.unlock();
@@ -567,47 +858,96 @@ vtkMTimeType vtkSlicerApplicationLogic::RequestReadScene(
 void vtkSlicerApplicationLogic::ProcessModified()
 {
   // Check to see if we should be shutting down
-  this->ModifiedQueueActiveLock.lock();
-  int active = this->ModifiedQueueActive;
-  this->ModifiedQueueActiveLock.unlock();
-  if (!active)
+  if (!this->ModifiedQueueActive)
     {
     return;
     }
 
-  vtkSmartPointer<vtkObject> obj = nullptr;
-  // pull an object off the queue to modify
-  this->ModifiedQueueLock.lock();
-  if ((*this->InternalModifiedQueue).size() > 0)
+  ModifiedQueue* queue = this->InternalModifiedQueue;
+  // only drain the requests that are already posted so that busy
+  // producers can't starve the event loop
+  size_t batchSize = queue->Size();
+  queue->MaximumSize = std::max(queue->MaximumSize, batchSize);
+
+  // pull the objects off the queue, keeping only one request per object
+  // to save some updates
+  std::vector<vtkObject*> objects;
+  std::set<vtkObject*> uniqueObjects;
+  ModifiedQueue::ClockType::time_point oldestRequestTime = ModifiedQueue::ClockType::now();
+  vtkObject* obj = nullptr;
+  ModifiedQueue::ClockType::time_point requestTime;
+  for (size_t i = 0; i < batchSize && queue->Pop(obj, requestTime); ++i)
     {
-    obj = (*this->InternalModifiedQueue).front();
-    (*this->InternalModifiedQueue).pop();
-
-    // pop off any extra copies of the same object to save some updates
-    while (!(*this->InternalModifiedQueue).empty()
-           && (obj == (*this->InternalModifiedQueue).front()))
+    oldestRequestTime = std::min(oldestRequestTime, requestTime);
+    if (uniqueObjects.insert(obj).second)
+      {
+      objects.push_back(obj);
+      }
+    else
       {
-      (*this->InternalModifiedQueue).pop();
-      obj->Delete(); // decrement ref count
+      obj->UnRegister(this); // decrement ref count
       }
     }
-  this->ModifiedQueueLock.unlock();
 
-  // Modify the object
+  // Modify the objects
   //  - decrement reference count that was increased when it was added to the queue
-  if (obj.GetPointer())
+  for (std::vector<vtkObject*>::iterator objIt = objects.begin(); objIt != objects.end(); ++objIt)
     {
-    obj->Modified();
-    obj->Delete();
-    obj = nullptr;
+    (*objIt)->Modified();
+    (*objIt)->UnRegister(this);
+    }
+
+  if (!objects.empty())
+    {
+    std::chrono::duration<double> latency = ModifiedQueue::ClockType::now() - oldestRequestTime;
+    queue->LastLatency = latency.count();
+    queue->MaximumLatency = std::max(queue->MaximumLatency, queue->LastLatency);
     }
 
   // schedule the next timer sooner in case there is stuff in the queue
   // otherwise for a while later
-  int delay = (*this->InternalModifiedQueue).size() > 0 ? 0: 200;
+  int delay = queue->Size() > 0 ? 0: 200;
   this->InvokeEvent(vtkSlicerApplicationLogic::RequestModifiedEvent, &delay);
 }
 
+//----------------------------------------------------------------------------
+unsigned int vtkSlicerApplicationLogic::GetModifiedQueueSize()
+{
+  return static_cast<unsigned int>(this->InternalModifiedQueue->Size());
+}
+
+//----------------------------------------------------------------------------
+unsigned int vtkSlicerApplicationLogic::GetModifiedQueueMaximumSize()
+{
+  return static_cast<unsigned int>(this->InternalModifiedQueue->MaximumSize);
+}
+
+//----------------------------------------------------------------------------
+unsigned int vtkSlicerApplicationLogic::GetModifiedQueueCapacity()
+{
+  return static_cast<unsigned int>(this->InternalModifiedQueue->Capacity());
+}
+
+//----------------------------------------------------------------------------
+double vtkSlicerApplicationLogic::GetModifiedQueueLastLatency()
+{
+  return this->InternalModifiedQueue->LastLatency;
+}
+
+//----------------------------------------------------------------------------
+double vtkSlicerApplicationLogic::GetModifiedQueueMaximumLatency()
+{
+  return this->InternalModifiedQueue->MaximumLatency;
+}
+
+//----------------------------------------------------------------------------
+void vtkSlicerApplicationLogic::ResetModifiedQueueStatistics()
+{
+  this->InternalModifiedQueue->MaximumSize = 0;
+  this->InternalModifiedQueue->LastLatency = 0.;
+  this->InternalModifiedQueue->MaximumLatency = 0.;
+}
+
 //----------------------------------------------------------------------------
 void vtkSlicerApplicationLogic::ProcessReadData()
 {
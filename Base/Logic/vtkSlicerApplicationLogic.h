@@ -26,12 +26,15 @@
 
 // VTK includes
 #include <vtkCollection.h>
+#include <vtkSmartPointer.h>
 
 // ITK includes
 #include <itkPlatformMultiThreader.h>
 
 // STL includes
+#include <atomic>
 #include <mutex>
+#include <vector>
 
 class vtkMRMLSelectionNode;
 class vtkMRMLInteractionNode;
@@ -77,6 +80,28 @@ class VTK_SLICER_BASE_LOGIC_EXPORT vtkSlicerApplicationLogic
 
   /// Shutdown the processing thread
   void TerminateProcessingThread();
+
+  /// Maximum number of processing tasks (such as CLI modules) that run at the same time.
+  /// Scheduled tasks are started in order, each one when the processing threads
+  /// and memory that it requires are available (see vtkSlicerTask::SetNumberOfThreads()
+  /// and vtkSlicerTask::SetMemoryMB()). A task is not started while another task with
+  /// the same client data (for example the same CLI node) is running.
+  /// Default is 1: tasks run one after the other.
+  void SetMaximumNumberOfConcurrentProcessingTasks(int count);
+  int GetMaximumNumberOfConcurrentProcessingTasks();
+
+  /// Number of CPU threads shared by the running processing tasks.
+  /// Default is the number of hardware threads of the computer.
+  void SetProcessingNumberOfThreadsLimit(int numberOfThreads);
+  int GetProcessingNumberOfThreadsLimit();
+
+  /// Memory in megabytes shared by the running processing tasks.
+  /// Default is the total physical memory of the computer.
+  void SetProcessingMemoryLimitMB(int memoryMB);
+  int GetProcessingMemoryLimitMB();
+
+  /// Number of processing tasks that are running.
+  int GetNumberOfRunningProcessingTasks();
   /// List of events potentially fired by the application logic
   enum RequestEvents
     {
@@ -100,8 +125,12 @@ class VTK_SLICER_BASE_LOGIC_EXPORT vtkSlicerApplicationLogic
   /// performed in the main thread.  This allows the call to Modified
   /// to trigger GUI changes. RequestModified() is called from the
   /// processing thread to modify an object in the main thread.
+  /// RequestModified() can be called concurrently from any number of threads:
+  /// requests are posted into a fixed-size lock-free ring buffer that is
+  /// drained by the main thread in ProcessModified(). Requests that do not
+  /// fit in the ring are kept in an overflow queue, they are never dropped.
   /// Return the request UID (monotonically increasing) of the request or 0 if
-  /// the request failed to be registered.
+  /// the Modified queue is not active.
   /// \todo Fire RequestProcessedEvent when processing Modified requests.
   /// \sa RequestReadData(), RequestWriteData()
   vtkMTimeType RequestModified(vtkObject *);
@@ -170,12 +199,30 @@ class VTK_SLICER_BASE_LOGIC_EXPORT vtkSlicerApplicationLogic
                        int displayData = false,
                        int deleteFile = false);
 
-  /// Process a request on the Modified queue.  This method is called
+  /// Process the requests on the Modified queue.  This method is called
   /// in the main thread of the application because calls to Modified()
   /// can cause an update to the GUI. (Method needs to be public to fit
   /// in the event callback chain.)
+  /// All the requests posted before the call are processed in one batch,
+  /// each object being modified only once per batch.
   void ProcessModified();
 
+  /// Statistics of the Modified queue, for tuning purposes.
+  /// GetModifiedQueueSize() returns the number of pending requests,
+  /// GetModifiedQueueMaximumSize() the largest number of pending requests
+  /// observed by ProcessModified() and GetModifiedQueueCapacity() the
+  /// size of the lock-free ring (requests beyond that go to the slower
+  /// overflow queue).
+  /// Latencies are the time in seconds between RequestModified() and the
+  /// call to Modified() in the main thread.
+  /// \sa ResetModifiedQueueStatistics()
+  unsigned int GetModifiedQueueSize();
+  unsigned int GetModifiedQueueMaximumSize();
+  unsigned int GetModifiedQueueCapacity();
+  double GetModifiedQueueLastLatency();
+  double GetModifiedQueueMaximumLatency();
+  void ResetModifiedQueueStatistics();
+
   /// Process a request to read data and set it on a referenced node.
   /// This method is called in the main thread of the application
   /// because calls to load data will cause a Modified() on a node
@@ -232,9 +279,19 @@ protected:
    /// Callback used by a MultiThreader to start a networking thread
   static itk::ITK_THREAD_RETURN_TYPE NetworkingThreaderCallback( void * );
 
-  /// Task processing loop that is run in the processing thread
+  /// Task processing loop that is run in the processing threads
   void ProcessProcessingTasks();
 
+  /// Remove the next processing task from the queue if the resources that it
+  /// requires are available and reserve them. Returns nullptr if no task can be started.
+  vtkSmartPointer<vtkSlicerTask> StartNextProcessingTask();
+
+  /// Release the resources reserved for a task by StartNextProcessingTask()
+  void FinishProcessingTask(vtkSlicerTask* task);
+
+  /// Start processing threads until their number reaches MaximumNumberOfConcurrentProcessingTasks
+  void SpawnProcessingThreads();
+
   /// Networking Task processing loop that is run in a networking thread
   void ProcessNetworkingTasks();
 
@@ -251,6 +308,9 @@ protected:
   /// specifying background threads priority (default: 20).
   virtual void SetCurrentThreadPriorityToBackground();
 
+  /// Thread-safe. Return a new unique, non-zero request identifier.
+  vtkMTimeType NewRequestUID();
+
 private:
   vtkSlicerApplicationLogic(const vtkSlicerApplicationLogic&);
   void operator=(const vtkSlicerApplicationLogic&);
@@ -258,17 +318,26 @@ private:
   itk::PlatformMultiThreader::Pointer ProcessingThreader;
   std::mutex ProcessingThreadActiveLock;
   std::mutex ProcessingTaskQueueLock;
-  std::mutex ModifiedQueueActiveLock;
-  std::mutex ModifiedQueueLock;
   std::mutex ReadDataQueueActiveLock;
   std::mutex ReadDataQueueLock;
   std::mutex WriteDataQueueActiveLock;
   std::mutex WriteDataQueueLock;
-  vtkTimeStamp RequestTimeStamp;
-  int ProcessingThreadId;
+  /// Last unique identifier given to a request, 0 means "no request"
+  std::atomic<vtkMTimeType> LastRequestUID;
+  std::vector<int> ProcessingThreadIDs;
   std::vector<int> NetworkingThreadIDs;
   int ProcessingThreadActive;
-  int ModifiedQueueActive;
+
+  // Processing resources, protected by ProcessingTaskQueueLock
+  int MaximumNumberOfConcurrentProcessingTasks;
+  int ProcessingNumberOfThreadsLimit;
+  int ProcessingMemoryLimitMB;
+  int NumberOfRunningProcessingTasks;
+  int NumberOfUsedProcessingThreads;
+  int UsedProcessingMemoryMB;
+  bool ExclusiveProcessingTaskRunning;
+  std::vector<void*> RunningProcessingTaskClientData;
+  std::atomic<int> ModifiedQueueActive;
   int ReadDataQueueActive;
   int WriteDataQueueActive;
 
@@ -19,6 +19,13 @@
 #include <vtkMRMLSubjectHierarchyNode.h>
 #include <vtkMRMLTableNode.h>
 
+// VTK includes
+#include <vtkImageData.h>
+#include <vtkNew.h>
+
+// ITKFactoryRegistration includes
+#include <itkSharedMemoryImageSegment.h>
+
 //----------------------------------------------------------------------------
 class DataRequest
 {
@@ -72,8 +79,17 @@ public:
 
     bool useURI = appLogic->GetMRMLScene()->GetCacheManager()->IsRemoteReference(m_Filename.c_str());
 
+    // Images in shared memory are copied directly into the volume node, without a storage node
+    bool useSharedMemory = false;
+    vtkMRMLVolumeNode* volumeNode = vtkMRMLVolumeNode::SafeDownCast(nd);
+    if (volumeNode && itk::SharedMemoryImageSegment::IsSharedMemoryURI(m_Filename.c_str()))
+      {
+      useSharedMemory = true;
+      this->ReadVolumeFromSharedMemory(appLogic, volumeNode);
+      }
+
     vtkMRMLStorableNode *storableNode = vtkMRMLStorableNode::SafeDownCast(nd);
-    if (storableNode)
+    if (storableNode && !useSharedMemory)
       {
       int numStorageNodes = storableNode->GetNumberOfStorageNodes();
       for (int n = 0; n < numStorageNodes; n++)
@@ -174,6 +190,11 @@ public:
         {
         removed = 1;
         }
+      else if (itk::SharedMemoryImageSegment::IsSharedMemoryURI(m_Filename.c_str()))
+        {
+        removed = itk::SharedMemoryImageSegment::Remove(
+          itk::SharedMemoryImageSegment::GetNameFromURI(m_Filename));
+        }
       else
         {
         removed = itksys::SystemTools::RemoveFile(m_Filename.c_str());
@@ -234,6 +255,56 @@ public:
   }
 
 protected:
+  void ReadVolumeFromSharedMemory(vtkSlicerApplicationLogic* appLogic, vtkMRMLVolumeNode* volumeNode)
+  {
+    itk::SharedMemoryImageSegment segment;
+    if (!segment.Open(itk::SharedMemoryImageSegment::GetNameFromURI(m_Filename)))
+      {
+      vtkErrorWithObjectMacro(appLogic, "ProcessReadNodeData: cannot open shared memory segment " << m_Filename);
+      return;
+      }
+    const itk::SharedMemoryImageSegment::Header* header = segment.GetHeader();
+    int scalarType = VTK_VOID;
+    switch (header->ComponentType)
+      {
+      case itk::SharedMemoryImageSegment::UInt8: scalarType = VTK_TYPE_UINT8; break;
+      case itk::SharedMemoryImageSegment::Int8: scalarType = VTK_TYPE_INT8; break;
+      case itk::SharedMemoryImageSegment::UInt16: scalarType = VTK_TYPE_UINT16; break;
+      case itk::SharedMemoryImageSegment::Int16: scalarType = VTK_TYPE_INT16; break;
+      case itk::SharedMemoryImageSegment::UInt32: scalarType = VTK_TYPE_UINT32; break;
+      case itk::SharedMemoryImageSegment::Int32: scalarType = VTK_TYPE_INT32; break;
+      case itk::SharedMemoryImageSegment::UInt64: scalarType = VTK_TYPE_UINT64; break;
+      case itk::SharedMemoryImageSegment::Int64: scalarType = VTK_TYPE_INT64; break;
+      case itk::SharedMemoryImageSegment::Float32: scalarType = VTK_TYPE_FLOAT32; break;
+      case itk::SharedMemoryImageSegment::Float64: scalarType = VTK_TYPE_FLOAT64; break;
+      default:
+        vtkErrorWithObjectMacro(appLogic, "ProcessReadNodeData: unsupported component type in " << m_Filename);
+        return;
+      }
+
+    vtkNew<vtkImageData> imageData;
+    imageData->SetDimensions(static_cast<int>(header->Size[0]),
+      static_cast<int>(header->Size[1]), static_cast<int>(header->Size[2]));
+    imageData->AllocateScalars(scalarType, static_cast<int>(header->NumberOfComponents));
+    memcpy(imageData->GetScalarPointer(), segment.GetPixelData(), static_cast<size_t>(header->PixelDataSize));
+
+    // Segment geometry is in LPS, volume node geometry is in RAS
+    double directions[3][3] = { { 0.0 } };
+    for (int row = 0; row < 3; ++row)
+      {
+      for (int column = 0; column < 3; ++column)
+        {
+        directions[row][column] = (row < 2 ? -1.0 : 1.0) * header->Direction[row * 3 + column];
+        }
+      }
+    int wasModifying = volumeNode->StartModify();
+    volumeNode->SetIJKToRASDirections(directions);
+    volumeNode->SetSpacing(header->Spacing[0], header->Spacing[1], header->Spacing[2]);
+    volumeNode->SetOrigin(-header->Origin[0], -header->Origin[1], header->Origin[2]);
+    volumeNode->SetAndObserveImageData(imageData.GetPointer());
+    volumeNode->EndModify(wasModifying);
+  }
+
   std::string m_TargetNode;
   std::string m_Filename;
   int m_DisplayData;
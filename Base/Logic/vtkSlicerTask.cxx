@@ -3,6 +3,11 @@
 // VTK includes
 #include <vtkObjectFactory.h>
 
+namespace
+{
+thread_local vtkSlicerTask* ExecutingTask = nullptr;
+}
+
 //----------------------------------------------------------------------------
 vtkStandardNewMacro(vtkSlicerTask);
 
@@ -13,6 +18,10 @@ vtkSlicerTask::vtkSlicerTask()
   this->TaskFunction = nullptr;
   this->TaskClientData = nullptr;
   this->Type = vtkSlicerTask::Undefined;
+  this->NumberOfThreads = 0;
+  this->MemoryMB = 0;
+  this->Exclusive = false;
+  this->AllocatedNumberOfThreads = 0;
 }
 //----------------------------------------------------------------------------
 vtkSlicerTask::~vtkSlicerTask() = default;
@@ -32,12 +41,26 @@ void vtkSlicerTask::Execute()
 {
   if (this->TaskObject)
     {
+    vtkSlicerTask* previousExecutingTask = ExecutingTask;
+    ExecutingTask = this;
     ((*this->TaskObject).*(this->TaskFunction))(this->TaskClientData);
+    ExecutingTask = previousExecutingTask;
     }
 }
 
+//----------------------------------------------------------------------------
+vtkSlicerTask* vtkSlicerTask::GetExecutingTask()
+{
+  return ExecutingTask;
+}
+
 //----------------------------------------------------------------------------
 void vtkSlicerTask::PrintSelf(ostream& os, vtkIndent indent)
 {
   Superclass::PrintSelf(os, indent);
+  os << indent << "Type: " << this->GetTypeAsString() << "\n";
+  os << indent << "NumberOfThreads: " << this->NumberOfThreads << "\n";
+  os << indent << "MemoryMB: " << this->MemoryMB << "\n";
+  os << indent << "Exclusive: " << this->Exclusive << "\n";
+  os << indent << "AllocatedNumberOfThreads: " << this->AllocatedNumberOfThreads << "\n";
 }
@@ -48,6 +48,42 @@ public:
     return "Unknown";
   }
 
+  ///
+  /// Number of CPU threads used by a processing task. 0 means that the task
+  /// uses all the processing threads of the application (default).
+  /// \sa vtkSlicerApplicationLogic::SetProcessingNumberOfThreadsLimit()
+  vtkSetClampMacro (NumberOfThreads, int, 0, VTK_INT_MAX);
+  vtkGetMacro (NumberOfThreads, int);
+
+  ///
+  /// Estimated peak memory usage of a processing task in megabytes.
+  /// 0 means unknown (default), such tasks are not limited by available memory.
+  /// \sa vtkSlicerApplicationLogic::SetProcessingMemoryLimitMB()
+  vtkSetClampMacro (MemoryMB, int, 0, VTK_INT_MAX);
+  vtkGetMacro (MemoryMB, int);
+
+  ///
+  /// If enabled, no other processing task runs at the same time as this task.
+  /// Required for tasks that change process-wide state. Disabled by default.
+  vtkSetMacro (Exclusive, bool);
+  vtkGetMacro (Exclusive, bool);
+  vtkBooleanMacro (Exclusive, bool);
+
+  ///
+  /// Number of CPU threads that the task is allowed to use.
+  /// It is set by the application logic before the task is executed.
+  vtkSetMacro (AllocatedNumberOfThreads, int);
+  vtkGetMacro (AllocatedNumberOfThreads, int);
+
+  ///
+  /// Client data that is passed to the task function.
+  void* GetTaskClientData() { return this->TaskClientData; }
+
+  ///
+  /// Return the task that is being executed in the calling thread,
+  /// nullptr if the thread is not executing a task.
+  static vtkSlicerTask* GetExecutingTask();
+
 protected:
   vtkSlicerTask();
   ~vtkSlicerTask() override;
@@ -60,6 +96,10 @@ private:
   void *TaskClientData;
 
   int Type;
+  int NumberOfThreads;
+  int MemoryMB;
+  bool Exclusive;
+  int AllocatedNumberOfThreads;
 
 };
 #endif
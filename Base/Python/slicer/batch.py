@@ -0,0 +1,227 @@
+"""Run processing jobs in headless Slicer processes and collect timing of each processing stage.
+
+A job script runs the same logic that is used interactively (for example the Segmentations, Volumes
+or CLI module logic) and marks its processing stages::
+
+  # processCase.py
+  import slicer, slicer.batch
+  job = slicer.batch.currentJob()
+  with job.stage("load"):
+    volumeNode = slicer.util.loadVolume(job.parameters["inputVolume"])
+  with job.stage("threshold"):
+    slicer.cli.runSync(slicer.modules.thresholdscalarvolume, None, {...})
+  job.finish()
+
+The job script is run on many cases, in parallel processes::
+
+  import slicer.batch
+  runner = slicer.batch.BatchRunner("processCase.py", numberOfProcesses=4)
+  for inputVolume in inputVolumes:
+    runner.submit({"inputVolume": inputVolume})
+  results = runner.run()
+  print(runner.report())
+
+Each process is started with the ``--headless`` option: no main window and no views are created,
+therefore no displayable managers are instantiated.
+"""
+
+import json
+import os
+import subprocess
+import tempfile
+import time
+from contextlib import contextmanager
+
+
+JOB_PARAMETERS_ENVIRONMENT_VARIABLE = "SLICER_BATCH_JOB_PARAMETERS"
+JOB_RESULT_ENVIRONMENT_VARIABLE = "SLICER_BATCH_JOB_RESULT"
+
+
+class BatchJob(object):
+  """Parameters and timing of a job running in the current process.
+
+  Stages are recorded in the order they are started. If a stage with the same name is
+  run multiple times then its times are summed.
+  """
+
+  def __init__(self, parameters=None, resultFilePath=None):
+    self.parameters = parameters if parameters is not None else {}
+    self.resultFilePath = resultFilePath
+    self.stages = []
+    self.status = "running"
+    self.error = None
+    self._startTime = time.perf_counter()
+
+  @contextmanager
+  def stage(self, name):
+    """Record the time spent in the ``with`` block as the stage ``name``.
+    If an exception is raised in the block then the job status is set to ``failed``."""
+    startTime = time.perf_counter()
+    try:
+      yield self
+    except Exception as e:
+      self.status = "failed"
+      self.error = "%s: %s" % (name, e)
+      raise
+    finally:
+      self.addStageTime(name, time.perf_counter() - startTime)
+
+  def addStageTime(self, name, seconds):
+    """Add time (in seconds) to the stage ``name``."""
+    for stage in self.stages:
+      if stage["name"] == name:
+        stage["seconds"] += seconds
+        return
+    self.stages.append({"name": name, "seconds": seconds})
+
+  def result(self):
+    """Return the metrics of the job as a dictionary."""
+    return {
+      "parameters": self.parameters,
+      "status": self.status,
+      "error": self.error,
+      "stages": self.stages,
+      "totalSeconds": time.perf_counter() - self._startTime,
+      }
+
+  def finish(self, status="completed"):
+    """Set the final status of the job and write the metrics into the result file
+    (if the job was submitted by a BatchRunner)."""
+    if self.status == "running":
+      self.status = status
+    if self.resultFilePath:
+      with open(self.resultFilePath, "w") as resultFile:
+        json.dump(self.result(), resultFile)
+    return self.result()
+
+
+_currentJob = None
+
+def currentJob():
+  """Return the job that the current process runs.
+
+  Parameters are read from the environment, as set by BatchRunner. If the script is not run by
+  a BatchRunner then a job without parameters is returned, so that job scripts can be tested
+  interactively.
+  """
+  global _currentJob
+  if _currentJob is None:
+    parameters = json.loads(os.environ.get(JOB_PARAMETERS_ENVIRONMENT_VARIABLE, "{}"))
+    _currentJob = BatchJob(parameters, os.environ.get(JOB_RESULT_ENVIRONMENT_VARIABLE))
+  return _currentJob
+
+
+class BatchRunner(object):
+  """Run a job script on each submitted parameter set, in parallel headless Slicer processes.
+
+  :param scriptPath: Python script that processes one job, see :func:`currentJob`.
+  :param numberOfProcesses: maximum number of Slicer processes running at the same time.
+  :param slicerArguments: additional command-line arguments of the Slicer processes
+    (for example ``["--disable-scripted-loadable-modules"]`` for faster startup).
+  :param executable: Slicer executable. By default, the launcher of the running application.
+  """
+
+  def __init__(self, scriptPath, numberOfProcesses=1, slicerArguments=None, executable=None):
+    self.scriptPath = os.path.abspath(scriptPath)
+    self.numberOfProcesses = max(1, numberOfProcesses)
+    self.slicerArguments = slicerArguments if slicerArguments is not None else []
+    if executable is None:
+      import slicer
+      executable = slicer.app.launcherExecutableFilePath
+    self.executable = executable
+    self.jobs = []
+    self.results = []
+
+  def submit(self, parameters):
+    """Add a job to the queue. Parameters must be JSON serializable, they can be accessed
+    by the job script as ``slicer.batch.currentJob().parameters``. Returns the job index."""
+    self.jobs.append(parameters)
+    return len(self.jobs) - 1
+
+  def run(self):
+    """Run all queued jobs and wait for their completion.
+    Returns the list of job results, in the order of submission."""
+    resultDirectory = tempfile.mkdtemp(prefix="SlicerBatch-")
+    results = [None] * len(self.jobs)
+    pendingJobIndices = list(range(len(self.jobs)))
+    runningJobs = []
+    while pendingJobIndices or runningJobs:
+      while pendingJobIndices and len(runningJobs) < self.numberOfProcesses:
+        jobIndex = pendingJobIndices.pop(0)
+        runningJobs.append(self._startJob(jobIndex, resultDirectory))
+      for runningJob in list(runningJobs):
+        if runningJob["process"].poll() is None:
+          continue
+        runningJobs.remove(runningJob)
+        results[runningJob["index"]] = self._getJobResult(runningJob)
+      if runningJobs:
+        time.sleep(0.05)
+    os.rmdir(resultDirectory)
+    self.jobs = []
+    self.results.extend(results)
+    return results
+
+  def _startJob(self, jobIndex, resultDirectory):
+    resultFilePath = os.path.join(resultDirectory, "job%d.json" % jobIndex)
+    environment = dict(os.environ)
+    environment[JOB_PARAMETERS_ENVIRONMENT_VARIABLE] = json.dumps(self.jobs[jobIndex])
+    environment[JOB_RESULT_ENVIRONMENT_VARIABLE] = resultFilePath
+    # A Python script given as first positional argument is run then the application exits
+    command = [self.executable, "--headless"] + self.slicerArguments + [self.scriptPath]
+    # Output is written into a file (instead of a pipe) so that verbose jobs cannot block
+    outputFile = open(os.path.join(resultDirectory, "job%d.log" % jobIndex), "w+b")
+    process = subprocess.Popen(command, env=environment, stdout=outputFile, stderr=subprocess.STDOUT)
+    return {"index": jobIndex, "process": process, "resultFilePath": resultFilePath, "outputFile": outputFile,
+      "parameters": self.jobs[jobIndex], "startTime": time.perf_counter()}
+
+  def _getJobResult(self, runningJob):
+    processSeconds = time.perf_counter() - runningJob["startTime"]
+    outputFile = runningJob["outputFile"]
+    outputFile.seek(0)
+    output = outputFile.read().decode("utf-8", "replace")
+    outputFile.close()
+    os.remove(outputFile.name)
+    result = None
+    if os.path.exists(runningJob["resultFilePath"]):
+      with open(runningJob["resultFilePath"]) as resultFile:
+        result = json.load(resultFile)
+      os.remove(runningJob["resultFilePath"])
+    if result is None:
+      # The script did not call finish()
+      result = {"parameters": runningJob["parameters"], "status": "failed",
+        "error": "job did not report results", "stages": [], "totalSeconds": None}
+    returnCode = runningJob["process"].returncode
+    if returnCode != 0 and result["status"] == "completed":
+      result["status"] = "failed"
+      result["error"] = "process exited with code %d" % returnCode
+    result["returnCode"] = returnCode
+    # Time including application startup and shutdown
+    result["processSeconds"] = processSeconds
+    result["output"] = output
+    return result
+
+  def report(self, results=None):
+    """Return a table of the per-job and per-stage times (in seconds), and the
+    average time of each stage over the completed jobs."""
+    if results is None:
+      results = self.results
+    stageNames = []
+    for result in results:
+      for stage in result["stages"]:
+        if stage["name"] not in stageNames:
+          stageNames.append(stage["name"])
+    lines = ["\t".join(["job", "status", "process"] + stageNames)]
+    stageTotals = [0.0] * len(stageNames)
+    numberOfCompletedJobs = 0
+    for jobIndex, result in enumerate(results):
+      stageSeconds = {stage["name"]: stage["seconds"] for stage in result["stages"]}
+      lines.append("\t".join([str(jobIndex), result["status"], "%.3f" % result.get("processSeconds", 0.0)]
+        + ["%.3f" % stageSeconds[name] if name in stageSeconds else "-" for name in stageNames]))
+      if result["status"] == "completed":
+        numberOfCompletedJobs += 1
+        for stageIndex, name in enumerate(stageNames):
+          stageTotals[stageIndex] += stageSeconds.get(name, 0.0)
+    if numberOfCompletedJobs > 0:
+      lines.append("\t".join(["average", "", ""]
+        + ["%.3f" % (total / numberOfCompletedJobs) for total in stageTotals]))
+    return "\n".join(lines)
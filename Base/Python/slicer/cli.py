@@ -91,3 +91,36 @@ def run(module, node = None, parameters = None, wait_for_completion = False, del
 
 def cancel(node):
   print("Not yet implemented")
+
+def runScriptInProcess(arguments):
+  """Run a scripted CLI in this Python interpreter, as the Python executable would.
+  arguments: path of the script followed by the command line arguments (set as sys.argv)
+  Returns a tuple of the exit status, standard output, and standard error text.
+  It is called by vtkSlicerCLIModuleLogic for modules that have RunPythonInProcess enabled.
+  """
+  import io, os, runpy, sys, traceback
+  scriptPath = arguments[0]
+  savedArgv, savedPath = sys.argv, list(sys.path)
+  savedStdout, savedStderr = sys.stdout, sys.stderr
+  outputStream, errorStream = io.StringIO(), io.StringIO()
+  exitStatus = 0
+  sys.argv = list(arguments)
+  sys.path.insert(0, os.path.dirname(os.path.abspath(scriptPath)))
+  sys.stdout, sys.stderr = outputStream, errorStream
+  try:
+    runpy.run_path(scriptPath, run_name='__main__')
+  except SystemExit as exc:
+    if exc.code is None:
+      exitStatus = 0
+    elif isinstance(exc.code, int):
+      exitStatus = exc.code
+    else:
+      errorStream.write(str(exc.code) + '\n')
+      exitStatus = 1
+  except Exception:
+    traceback.print_exc(file=errorStream)
+    exitStatus = 1
+  finally:
+    sys.argv, sys.path[:] = savedArgv, savedPath
+    sys.stdout, sys.stderr = savedStdout, savedStderr
+  return (exitStatus, outputStream.getvalue(), errorStream.getvalue())
@@ -0,0 +1,59 @@
+import json
+import os
+import tempfile
+import unittest
+import slicer
+import slicer.batch
+
+
+class SlicerBatchTest(unittest.TestCase):
+
+  def setUp(self):
+    pass
+
+  def test_headless(self):
+    self.assertTrue(slicer.app.commandOptions().headless)
+    self.assertTrue(slicer.app.commandOptions().noMainWindow)
+    self.assertIsNone(slicer.util.mainWindow(verbose=False))
+
+  def test_stages(self):
+    job = slicer.batch.BatchJob({"case": 1})
+    with job.stage("load"):
+      pass
+    with job.stage("process"):
+      pass
+    with job.stage("load"):
+      pass
+    self.assertEqual([stage["name"] for stage in job.stages], ["load", "process"])
+    self.assertTrue(all(stage["seconds"] >= 0.0 for stage in job.stages))
+
+    with self.assertRaises(ValueError):
+      with job.stage("save"):
+        raise ValueError("invalid output")
+    result = job.finish()
+    self.assertEqual(result["status"], "failed")
+    self.assertEqual(result["error"], "save: invalid output")
+    self.assertEqual(result["parameters"], {"case": 1})
+
+  def test_resultFile(self):
+    with tempfile.TemporaryDirectory() as tmpdirname:
+      resultFilePath = os.path.join(tmpdirname, 'result.json')
+      job = slicer.batch.BatchJob({"case": 2}, resultFilePath)
+      with job.stage("load"):
+        pass
+      job.finish()
+      with open(resultFilePath) as resultFile:
+        result = json.load(resultFile)
+      self.assertEqual(result["status"], "completed")
+      self.assertEqual(result["stages"][0]["name"], "load")
+
+  def test_report(self):
+    runner = slicer.batch.BatchRunner("processCase.py", executable="Slicer")
+    results = [
+      {"status": "completed", "processSeconds": 2.0, "stages": [{"name": "load", "seconds": 1.0}]},
+      {"status": "completed", "processSeconds": 3.0, "stages": [{"name": "load", "seconds": 2.0}, {"name": "save", "seconds": 0.5}]},
+      ]
+    lines = runner.report(results).split("\n")
+    self.assertEqual(lines[0], "job\tstatus\tprocess\tload\tsave")
+    self.assertEqual(lines[1], "0\tcompleted\t2.000\t1.000\t-")
+    self.assertEqual(lines[3], "average\t\t\t1.500\t0.250")
@@ -748,12 +748,15 @@ def loadTransform(filename, returnNode=False):
   """
   return loadNodeFromFile(filename, 'TransformFile', {}, returnNode)
 
-def loadTable(filename):
+def loadTable(filename, properties={}):
   """Load table node from file.
   :param filename: full path of the file to load.
+  :param properties:
+    - maximumNumberOfRows: only read the first rows of the file (for previewing large tables)
+    - autoDetectColumnTypes: detect type of columns that are not defined in the schema
   :return: loaded table node
   """
-  return loadNodeFromFile(filename, 'TableFile')
+  return loadNodeFromFile(filename, 'TableFile', properties)
 
 def loadLabelVolume(filename, properties={}, returnNode=False):
   """Load node from file.
@@ -1482,6 +1485,8 @@ def arrayFromGridTransformModified(gridTransformNode):
   displacementGrid = transformGrid.GetDisplacementGrid()
   displacementGrid.GetPointData().GetScalars().Modified()
   displacementGrid.Modified()
+  # The transform node observes the transform, not the displacement grid
+  transformGrid.Modified()
 
 def arrayFromSegment(segmentationNode, segmentId):
   """
@@ -1524,6 +1529,58 @@ def arrayFromSegmentInternalBinaryLabelmap(segmentationNode, segmentId):
   narray = vtk.util.numpy_support.vtk_to_numpy(vimage.GetPointData().GetScalars()).reshape(nshape)
   return narray
 
+def arrayFromSegmentInternalBinaryLabelmapModified(segmentationNode, segmentId):
+  """Indicate that modification of a numpy array returned by :py:meth:`arrayFromSegmentInternalBinaryLabelmap`
+  has been completed. All segments that share the labelmap with the specified segment are updated."""
+  vimage = segmentationNode.GetBinaryLabelmapInternalRepresentation(segmentId)
+  vimage.GetPointData().GetScalars().Modified()
+  # Segmentation observes the master representation and notifies displayable managers and widgets
+  vimage.Modified()
+
+def arrayFromSegmentationLayer(segmentationNode, layer):
+  """Return voxel array of a binary labelmap layer of a segmentation node as numpy array.
+  Voxels values are not copied.
+
+  A layer is a labelmap that is shared by multiple segments. Each segment in the layer has a different
+  label value, see ``segmentationNode.GetSegmentation().GetSegmentIDsForLayer(layer)`` and
+  ``segment.GetLabelValue()``. This allows processing all segments of a layer at once, without
+  exporting or merging labelmaps. Number of layers is ``segmentationNode.GetSegmentation().GetNumberOfLayers()``.
+
+  If binary labelmap is the master representation then voxel values can be modified
+  by changing values in the numpy array. After all modifications has been completed,
+  call :py:meth:`arrayFromSegmentationLayerModified`.
+
+  .. warning:: Important: memory area of the returned array is managed by VTK,
+    therefore values in the array may be changed, but the array must not be reallocated.
+    See :py:meth:`arrayFromVolume` for details.
+  """
+  vimage = _vtkImageFromSegmentationLayer(segmentationNode, layer)
+  nshape = tuple(reversed(vimage.GetDimensions()))
+  import vtk.util.numpy_support
+  narray = vtk.util.numpy_support.vtk_to_numpy(vimage.GetPointData().GetScalars()).reshape(nshape)
+  return narray
+
+def arrayFromSegmentationLayerModified(segmentationNode, layer):
+  """Indicate that modification of a numpy array returned by :py:meth:`arrayFromSegmentationLayer` has been completed."""
+  vimage = _vtkImageFromSegmentationLayer(segmentationNode, layer)
+  vimage.GetPointData().GetScalars().Modified()
+  vimage.Modified()
+
+def _vtkImageFromSegmentationLayer(segmentationNode, layer):
+  """Helper function for getting the binary labelmap of a segmentation layer that throws exception
+  with informative error message if the layer is not found.
+  """
+  import slicer
+  segmentation = segmentationNode.GetSegmentation()
+  representationName = slicer.vtkSegmentationConverter.GetBinaryLabelmapRepresentationName()
+  numberOfLayers = segmentation.GetNumberOfLayers(representationName)
+  if layer < 0 or layer >= numberOfLayers:
+    raise ValueError("Invalid layer index {0}, segmentation has {1} binary labelmap layers".format(layer, numberOfLayers))
+  vimage = segmentation.GetLayerDataObject(layer, representationName)
+  if not vimage or not vimage.GetPointData().GetScalars():
+    raise ValueError("Binary labelmap layer {0} is empty".format(layer))
+  return vimage
+
 def arrayFromSegmentBinaryLabelmap(segmentationNode, segmentId):
   """Return voxel array of a segment's binary labelmap representation as numpy array.
 
@@ -1557,17 +1614,43 @@ def arrayFromMarkupsControlPoints(markupsNode, world = False):
   The returned array is just a copy and so any modification in the array will not affect the markup node.
 
   To modify markup control points based on a numpy array, use :py:meth:`updateMarkupsControlPointsFromArray`.
+  To access control point positions without copying, use :py:meth:`arrayFromMarkupsControlPointPositions`.
   """
-  numberOfControlPoints = markupsNode.GetNumberOfControlPoints()
   import numpy as np
-  narray = np.zeros([numberOfControlPoints, 3])
-  for controlPointIndex in range(numberOfControlPoints):
-    if world:
-      markupsNode.GetNthControlPointPositionWorld(controlPointIndex, narray[controlPointIndex,:])
-    else:
-      markupsNode.GetNthControlPointPosition(controlPointIndex, narray[controlPointIndex,:])
+  import vtk.util.numpy_support
+  points = vtk.vtkPoints()
+  points.SetDataTypeToDouble()
+  # All points are retrieved (and transformed) at once
+  if world:
+    markupsNode.GetControlPointPositionsWorld(points)
+  else:
+    markupsNode.GetControlPointPositions(points)
+  if points.GetNumberOfPoints() == 0:
+    return np.zeros([0, 3])
+  narray = np.array(vtk.util.numpy_support.vtk_to_numpy(points.GetData()))
+  return narray
+
+def arrayFromMarkupsControlPointPositions(markupsNode):
+  """Return control point positions of a markups node (in local coordinate system) as rows in a numpy array (of size Nx3).
+
+  Positions are not copied. Control point positions can be modified by changing values in the numpy array.
+  After all modifications has been completed, call :py:meth:`arrayFromMarkupsControlPointPositionsModified`.
+  Number of control points must not be changed while the array is used, use
+  :py:meth:`updateMarkupsControlPointsFromArray` to add or remove control points.
+
+  .. warning:: Important: memory area of the returned array is managed by VTK,
+    therefore values in the array may be changed, but the array must not be reallocated.
+    See :py:meth:`arrayFromVolume` for details.
+  """
+  import vtk.util.numpy_support
+  narray = vtk.util.numpy_support.vtk_to_numpy(markupsNode.GetControlPointPositionsArray().GetData())
   return narray
 
+def arrayFromMarkupsControlPointPositionsModified(markupsNode):
+  """Indicate that modification of a numpy array returned by :py:meth:`arrayFromMarkupsControlPointPositions`
+  has been completed."""
+  markupsNode.ControlPointPositionsArrayModified()
+
 def updateMarkupsControlPointsFromArray(markupsNode, narray, world = False):
   """Sets control point positions in a markups node from a numpy array of size Nx3.
 
@@ -1581,26 +1664,15 @@ def updateMarkupsControlPointsFromArray(markupsNode, narray, world = False):
     return
   if len(narrayshape) != 2 or narrayshape[1] != 3:
     raise RuntimeError("Unsupported numpy array shape: "+str(narrayshape)+" expected (N,3)")
-  numberOfControlPoints = narrayshape[0]
-  oldNumberOfControlPoints = markupsNode.GetNumberOfControlPoints()
-  # Update existing control points
-  for controlPointIndex in range(min(numberOfControlPoints, oldNumberOfControlPoints)):
-    if world:
-      markupsNode.SetNthControlPointPositionWorldFromArray(controlPointIndex, narray[controlPointIndex,:])
-    else:
-      markupsNode.SetNthControlPointPositionFromArray(controlPointIndex, narray[controlPointIndex,:])
-  if numberOfControlPoints >= oldNumberOfControlPoints:
-    # Add new points to the markup node
-    from vtk import vtkVector3d
-    for controlPointIndex in range(oldNumberOfControlPoints, numberOfControlPoints):
-      if world:
-        markupsNode.AddControlPointWorld(vtkVector3d(narray[controlPointIndex,:]))
-      else:
-        markupsNode.AddControlPoint(vtkVector3d(narray[controlPointIndex,:]))
+  import numpy as np
+  import vtk.util.numpy_support
+  # Existing control points are updated, new ones are added, extra ones are removed, all in one batch
+  points = vtk.vtkPoints()
+  points.SetData(vtk.util.numpy_support.numpy_to_vtk(num_array=np.ascontiguousarray(narray, dtype=np.float64), deep=True))
+  if world:
+    markupsNode.SetControlPointPositionsWorld(points)
   else:
-    # Remove extra point from the markup node
-    for controlPointIndex in range(oldNumberOfControlPoints, numberOfControlPoints, -1):
-      markupsNode.RemoveNthControlPoint(controlPointIndex-1)
+    markupsNode.SetControlPointPositions(points)
 
 def arrayFromMarkupsCurvePoints(markupsNode, world = False):
   """Return interpolated curve point positions of a markups node as rows in a numpy array (of size Nx3).
@@ -1711,6 +1783,39 @@ def addVolumeFromArray(narray, ijkToRAS=None, name=None, nodeClassName=None):
 
   return volumeNode
 
+def arrayFromSequenceVolume(sequenceNode, itemIndex):
+  """Return voxel array of a volume item of a sequence node as numpy array.
+  Voxels values are not copied, therefore frames of a 4D sequence can be processed
+  without creating proxy nodes or switching the selected item of a sequence browser.
+  After all modifications has been completed, call :py:meth:`arrayFromSequenceVolumeModified`.
+
+  Number of items is ``sequenceNode.GetNumberOfDataNodes()``. Volume sequences that are loaded
+  as a single multi-volume node can be accessed as one 4D array using :py:meth:`arrayFromVolume`.
+
+  .. warning:: Important: memory area of the returned array is managed by VTK,
+    therefore values in the array may be changed, but the array must not be reallocated.
+    See :py:meth:`arrayFromVolume` for details.
+  """
+  return arrayFromVolume(_volumeNodeFromSequence(sequenceNode, itemIndex))
+
+def arrayFromSequenceVolumeModified(sequenceNode, itemIndex):
+  """Indicate that modification of a numpy array returned by :py:meth:`arrayFromSequenceVolume` has been completed."""
+  arrayFromVolumeModified(_volumeNodeFromSequence(sequenceNode, itemIndex))
+  # Proxy nodes are updated from the sequence when it is modified
+  sequenceNode.Modified()
+
+def _volumeNodeFromSequence(sequenceNode, itemIndex):
+  """Helper function for getting a volume item of a sequence node that throws exception
+  with informative error message if the item is not a volume.
+  """
+  numberOfItems = sequenceNode.GetNumberOfDataNodes()
+  if itemIndex < 0 or itemIndex >= numberOfItems:
+    raise ValueError("Invalid item index {0}, sequence has {1} items".format(itemIndex, numberOfItems))
+  volumeNode = sequenceNode.GetNthDataNode(itemIndex)
+  if not volumeNode or not volumeNode.IsA("vtkMRMLVolumeNode") or not volumeNode.GetImageData():
+    raise ValueError("Item {0} of the sequence is not a volume".format(itemIndex))
+  return volumeNode
+
 def arrayFromTableColumn(tableNode, columnName):
   """Return values of a table node's column as numpy array.
   Values can be modified by modifying the numpy array.
@@ -1732,6 +1837,36 @@ def arrayFromTableColumnModified(tableNode, columnName):
   columnData.Modified()
   tableNode.GetTable().Modified()
 
+def updateTableColumnFromArray(tableNode, columnName, narray):
+  """Set values of a table node's column from a numpy array.
+
+  Memory is shared between the numpy array and the table column (values are not copied),
+  therefore this is fast even for very large tables. The array must remain unchanged in size;
+  after modifying values in the numpy array, call :py:meth:`arrayFromTableColumnModified`.
+  If the column does not exist yet then it is added to the table.
+  The table node is modified only once.
+
+  Example::
+
+    import numpy as np
+    tableNode = slicer.mrmlScene.AddNewNodeByClass("vtkMRMLTableNode")
+    updateTableColumnFromArray(tableNode, "Index", np.arange(1000000, dtype=np.int32))
+    updateTableColumnFromArray(tableNode, "Random", np.random.rand(1000000))
+
+  """
+  import numpy as np
+  import vtk.util.numpy_support
+  # numpy_to_vtk keeps a reference to the numpy array if it does not have to copy it
+  vcolumn = vtk.util.numpy_support.numpy_to_vtk(num_array=np.ascontiguousarray(narray), deep=False)
+  columnIndex = tableNode.GetColumnIndex(columnName)
+  if columnIndex < 0:
+    vcolumn.SetName(columnName)
+    tableNode.AddColumn(vcolumn)
+  elif not tableNode.SetColumn(columnIndex, vcolumn):
+    raise ValueError("Failed to set column '{0}': the array has {1} values, the table has {2} rows".format(
+      columnName, vcolumn.GetNumberOfTuples(), tableNode.GetNumberOfRows()))
+  return vcolumn
+
 def updateTableFromArray(tableNode, narrays, columnNames=None):
   """Set values in a table node from a numpy array.
 
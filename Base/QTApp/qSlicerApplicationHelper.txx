@@ -44,6 +44,7 @@
 #include "qSlicerCommandOptions.h"
 #include "qSlicerModuleFactoryManager.h"
 #include "qSlicerModuleManager.h"
+#include "qSlicerStartupTrace.h"
 
 namespace
 {
@@ -142,14 +143,18 @@ int qSlicerApplicationHelper::postInitializeApplication(
 
   // Register and instantiate modules
   splashMessage(splashScreen, "Registering modules...");
+  qSlicerStartupTrace::instance()->beginEvent("Register modules");
   moduleFactoryManager->registerModules();
+  qSlicerStartupTrace::instance()->endEvent();
   if (app.commandOptions()->verboseModuleDiscovery())
     {
     qDebug() << "Number of registered modules:"
              << moduleFactoryManager->registeredModuleNames().count();
     }
   splashMessage(splashScreen, "Instantiating modules...");
+  qSlicerStartupTrace::instance()->beginEvent("Instantiate modules");
   moduleFactoryManager->instantiateModules();
+  qSlicerStartupTrace::instance()->endEvent();
   if (app.commandOptions()->verboseModuleDiscovery())
     {
     qDebug() << "Number of instantiated modules:"
@@ -177,6 +182,7 @@ int qSlicerApplicationHelper::postInitializeApplication(
   splashMessage(splashScreen, "Initializing user interface...");
   if (enableMainWindow)
     {
+    qSlicerStartupTraceScope traceScope("Create main window", "Widgets");
     window.reset(new SlicerMainWindowType);
     }
   else if (app.commandOptions()->showPythonInteractor()
@@ -194,12 +200,14 @@ int qSlicerApplicationHelper::postInitializeApplication(
     }
 
   // Load all available modules
+  qSlicerStartupTrace::instance()->beginEvent("Load modules");
   foreach(const QString& name, moduleFactoryManager->instantiatedModuleNames())
     {
     Q_ASSERT(!name.isNull());
     splashMessage(splashScreen, "Loading module \"" + name + "\"...");
     moduleFactoryManager->loadModule(name);
     }
+  qSlicerStartupTrace::instance()->endEvent();
   if (app.commandOptions()->verboseModuleDiscovery())
     {
     qDebug() << "Number of loaded modules:" << moduleManager->modulesNames().count();
@@ -216,6 +224,27 @@ int qSlicerApplicationHelper::postInitializeApplication(
     QTimer::singleShot(0, &app, SIGNAL(startupCompleted()));
     }
 
+  if (qSlicerStartupTrace::instance()->isEnabled())
+    {
+    qSlicerStartupTrace::instance()->beginEvent("Show main window");
+    QObject::connect(&app, &qSlicerApplication::startupCompleted, [&app]()
+      {
+      qSlicerStartupTrace* trace = qSlicerStartupTrace::instance();
+      if (!trace->isEnabled())
+        {
+        return;
+        }
+      trace->endEvent();
+      trace->setEnabled(false);
+      QString traceFile = app.commandOptions()->startupTraceFile();
+      if (trace->writeChromeTrace(traceFile))
+        {
+        qDebug() << "Startup trace written to" << traceFile;
+        }
+      qDebug().noquote() << trace->moduleCostSummary();
+      });
+    }
+
   if (window)
     {
     if (splashScreen)
@@ -19,8 +19,13 @@
 ==============================================================================*/
 
 // Qt includes
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QPair>
 #include <QProcess>
+#include <QSaveFile>
 #include <QStandardPaths>
+#include <QThread>
 
 // Slicer includes
 #include "qSlicerCLIExecutableModuleFactory.h"
@@ -47,6 +52,38 @@ QString findPython()
 
 }
 
+//-----------------------------------------------------------------------------
+namespace
+{
+  const int CLIProcessTimeoutInMs = 5000;
+
+  //---------------------------------------------------------------------------
+  void setupXmlDescriptionProcess(QProcess& cli, const QString& executablePath)
+  {
+    QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
+    env.insert("ITK_AUTOLOAD_PATH", "");
+    cli.setProcessEnvironment(env);
+    cli.setWorkingDirectory(QFileInfo(executablePath).path());
+  }
+
+  //---------------------------------------------------------------------------
+  void writeCachedXmlDescription(const QString& cacheDirectory, const QString& executablePath, const QString& xmlDescription)
+  {
+    if (cacheDirectory.isEmpty() || !QDir().mkpath(cacheDirectory))
+      {
+      return;
+      }
+    // Write to a temporary file first, so that an incomplete file is never read
+    QSaveFile cacheFile(
+      qSlicerCLIExecutableModuleFactoryItem::cachedXmlModuleDescriptionFilePath(cacheDirectory, executablePath));
+    if (cacheFile.open(QIODevice::WriteOnly))
+      {
+      cacheFile.write(xmlDescription.toUtf8());
+      cacheFile.commit();
+      }
+  }
+}
+
 //-----------------------------------------------------------------------------
 qSlicerCLIExecutableModuleFactoryItem::qSlicerCLIExecutableModuleFactoryItem(
   const QString& newTempDirectory)
@@ -61,6 +98,23 @@ bool qSlicerCLIExecutableModuleFactoryItem::load()
   return true;
 }
 
+//-----------------------------------------------------------------------------
+void qSlicerCLIExecutableModuleFactoryItem::setXmlDescriptionCacheDirectory(const QString& cacheDirectory)
+{
+  this->XmlDescriptionCacheDirectory = cacheDirectory;
+}
+
+//-----------------------------------------------------------------------------
+QString qSlicerCLIExecutableModuleFactoryItem::cachedXmlModuleDescriptionFilePath(
+  const QString& cacheDirectory, const QString& executablePath)
+{
+  QFileInfo info(executablePath);
+  QString key = QString("%1|%2|%3").arg(info.absoluteFilePath())
+    .arg(info.size()).arg(info.lastModified().toMSecsSinceEpoch());
+  QString hash = QCryptographicHash::hash(key.toUtf8(), QCryptographicHash::Md5).toHex();
+  return QDir(cacheDirectory).filePath(info.baseName() + "-" + hash + ".xml");
+}
+
 //-----------------------------------------------------------------------------
 QString qSlicerCLIExecutableModuleFactoryItem::xmlModuleDescriptionFilePath()
 {
@@ -98,10 +152,28 @@ qSlicerAbstractCoreModule* qSlicerCLIExecutableModuleFactoryItem::instanciator()
 
   //
   // If the xml file exists, read it and associate it with the module
-  // description. If not, run the CLI executable with "--xml".
+  // description. If not, use the cached description or run the CLI
+  // executable with "--xml".
   //
+  QString cachedXmlFilePath;
+  if (!this->XmlDescriptionCacheDirectory.isEmpty())
+    {
+    cachedXmlFilePath = qSlicerCLIExecutableModuleFactoryItem::cachedXmlModuleDescriptionFilePath(this->XmlDescriptionCacheDirectory, this->path());
+    }
   QString xmlDescription;
-  if (QFile::exists(xmlFilePath))
+  if (!QFile::exists(xmlFilePath) && !cachedXmlFilePath.isEmpty() && QFile::exists(cachedXmlFilePath))
+    {
+    QFile cachedXmlFile(cachedXmlFilePath);
+    if (cachedXmlFile.open(QIODevice::ReadOnly))
+      {
+      xmlDescription = QTextStream(&cachedXmlFile).readAll();
+      }
+    }
+  if (!xmlDescription.isEmpty())
+    {
+    // Description was found in the cache
+    }
+  else if (QFile::exists(xmlFilePath))
     {
     QFile xmlFile(xmlFilePath);
     if (xmlFile.open(QIODevice::ReadOnly))
@@ -117,6 +189,10 @@ qSlicerAbstractCoreModule* qSlicerCLIExecutableModuleFactoryItem::instanciator()
   else
     {
     xmlDescription = this->runCLIWithXmlArgument();
+    if (!xmlDescription.isEmpty())
+      {
+      writeCachedXmlDescription(this->XmlDescriptionCacheDirectory, this->path(), xmlDescription);
+      }
     }
   if (xmlDescription.isEmpty())
     {
@@ -139,11 +215,9 @@ QString qSlicerCLIExecutableModuleFactoryItem::runCLIWithXmlArgument()
 {
   ctkScopedCurrentDir scopedCurrentDir(QFileInfo(this->path()).path());
 
-  int cliProcessTimeoutInMs = 5000;
+  int cliProcessTimeoutInMs = CLIProcessTimeoutInMs;
   QProcess cli;
-  QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
-  env.insert("ITK_AUTOLOAD_PATH", "");
-  cli.setProcessEnvironment(env);
+  setupXmlDescriptionProcess(cli, this->path());
   cli.start(this->path(), QStringList(QString("--xml")));
   bool res = cli.waitForFinished(cliProcessTimeoutInMs);
   if (!res)
@@ -233,8 +307,13 @@ public:
   typedef qSlicerCLIExecutableModuleFactoryPrivate Self;
   qSlicerCLIExecutableModuleFactoryPrivate(qSlicerCLIExecutableModuleFactory& object);
 
+  /// Retrieve and cache the XML descriptions of the given executables by
+  /// running them with "--xml" in parallel
+  void cacheXmlDescriptions(const QStringList& executablePaths);
+
 private:
   QString TempDirectory;
+  QString XmlDescriptionCacheDirectory;
 };
 
 //-----------------------------------------------------------------------------
@@ -242,6 +321,55 @@ qSlicerCLIExecutableModuleFactoryPrivate::qSlicerCLIExecutableModuleFactoryPriva
 :q_ptr(&object)
 {
   this->TempDirectory = QDir::tempPath();
+  QString cacheLocation = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+  if (!cacheLocation.isEmpty())
+    {
+    this->XmlDescriptionCacheDirectory = QDir(cacheLocation).filePath("CLIModuleDescriptions");
+    }
+}
+
+//-----------------------------------------------------------------------------
+void qSlicerCLIExecutableModuleFactoryPrivate::cacheXmlDescriptions(const QStringList& executablePaths)
+{
+  const int maximumNumberOfProcesses = qMax(1, QThread::idealThreadCount());
+  QList<QPair<QString, QProcess*> > runningProcesses;
+
+  // Only descriptions that are retrieved without errors or warnings are cached, other
+  // executables are run again when the module is instantiated so that errors are reported
+  auto finishProcess = [this](const QPair<QString, QProcess*>& runningProcess)
+    {
+    QProcess* cli = runningProcess.second;
+    if (cli->waitForFinished(CLIProcessTimeoutInMs) && cli->exitStatus() == QProcess::NormalExit)
+      {
+      QString xmlDescription = cli->readAllStandardOutput();
+      if (cli->readAllStandardError().isEmpty() && xmlDescription.startsWith("<?xml"))
+        {
+        writeCachedXmlDescription(this->XmlDescriptionCacheDirectory, runningProcess.first, xmlDescription);
+        }
+      }
+    else
+      {
+      cli->kill();
+      cli->waitForFinished();
+      }
+    delete cli;
+    };
+
+  foreach(const QString& executablePath, executablePaths)
+    {
+    if (runningProcesses.size() >= maximumNumberOfProcesses)
+      {
+      finishProcess(runningProcesses.takeFirst());
+      }
+    QProcess* cli = new QProcess();
+    setupXmlDescriptionProcess(*cli, executablePath);
+    cli->start(executablePath, QStringList(QString("--xml")));
+    runningProcesses << qMakePair(executablePath, cli);
+    }
+  while (!runningProcesses.isEmpty())
+    {
+    finishProcess(runningProcesses.takeFirst());
+    }
 }
 
 //-----------------------------------------------------------------------------
@@ -259,8 +387,30 @@ qSlicerCLIExecutableModuleFactory::~qSlicerCLIExecutableModuleFactory() = defaul
 //-----------------------------------------------------------------------------
 void qSlicerCLIExecutableModuleFactory::registerItems()
 {
+  Q_D(qSlicerCLIExecutableModuleFactory);
   QStringList modulePaths = qSlicerCLIModuleFactoryHelper::modulePaths();
   this->registerAllFileItems(modulePaths);
+
+  if (d->XmlDescriptionCacheDirectory.isEmpty())
+    {
+    return;
+    }
+  // Find executables that have neither XML file nor cached description
+  QStringList executablesToDescribe;
+  foreach(const QString& key, this->itemKeys())
+    {
+    QString executablePath = this->path(key);
+    QFileInfo info(executablePath);
+    if (info.suffix().toLower() == "py"
+      || QFile::exists(QDir(info.path()).filePath(info.baseName() + ".xml"))
+      || QFile::exists(qSlicerCLIExecutableModuleFactoryItem::cachedXmlModuleDescriptionFilePath(
+           d->XmlDescriptionCacheDirectory, executablePath)))
+      {
+      continue;
+      }
+    executablesToDescribe << executablePath;
+    }
+  d->cacheXmlDescriptions(executablesToDescribe);
 }
 
 //-----------------------------------------------------------------------------
@@ -285,7 +435,9 @@ ctkAbstractFactoryItem<qSlicerAbstractCoreModule>* qSlicerCLIExecutableModuleFac
 ::createFactoryFileBasedItem()
 {
   Q_D(qSlicerCLIExecutableModuleFactory);
-  return new qSlicerCLIExecutableModuleFactoryItem(d->TempDirectory);
+  qSlicerCLIExecutableModuleFactoryItem* item = new qSlicerCLIExecutableModuleFactoryItem(d->TempDirectory);
+  item->setXmlDescriptionCacheDirectory(d->XmlDescriptionCacheDirectory);
+  return item;
 }
 
 //-----------------------------------------------------------------------------
@@ -300,3 +452,17 @@ void qSlicerCLIExecutableModuleFactory::setTempDirectory(const QString& newTempD
   Q_D(qSlicerCLIExecutableModuleFactory);
   d->TempDirectory = newTempDirectory;
 }
+
+//-----------------------------------------------------------------------------
+void qSlicerCLIExecutableModuleFactory::setXmlDescriptionCacheDirectory(const QString& cacheDirectory)
+{
+  Q_D(qSlicerCLIExecutableModuleFactory);
+  d->XmlDescriptionCacheDirectory = cacheDirectory;
+}
+
+//-----------------------------------------------------------------------------
+QString qSlicerCLIExecutableModuleFactory::xmlDescriptionCacheDirectory()const
+{
+  Q_D(const qSlicerCLIExecutableModuleFactory);
+  return d->XmlDescriptionCacheDirectory;
+}
@@ -38,6 +38,16 @@ public:
   qSlicerCLIExecutableModuleFactoryItem(const QString& newTempDirectory);
   bool load() override;
   void uninstantiate() override;
+
+  /// Directory where XML descriptions retrieved by running the executables are cached.
+  /// Caching is disabled if empty.
+  void setXmlDescriptionCacheDirectory(const QString& cacheDirectory);
+
+  /// Return path of the cached XML description of the executable in  cacheDirectory.
+  /// The file name depends on the path, size and modification time of the executable,
+  /// so that the description is retrieved again when the executable changes.
+  static QString cachedXmlModuleDescriptionFilePath(const QString& cacheDirectory, const QString& executablePath);
+
 protected:
   /// Return path of the expected XML file.
   QString xmlModuleDescriptionFilePath();
@@ -46,6 +56,7 @@ protected:
   QString runCLIWithXmlArgument();
 private:
   QString TempDirectory;
+  QString XmlDescriptionCacheDirectory;
   qSlicerCLIModule* CLIModule;
 };
 
@@ -71,6 +82,14 @@ public:
 
   void setTempDirectory(const QString& newTempDirectory);
 
+  /// Directory where the XML descriptions of the executables are cached.
+  /// Running the executables with "--xml" is slow (especially from network drives),
+  /// therefore the descriptions are retrieved for all the executables in parallel
+  /// when the items are registered, and stored in this directory.
+  /// By default it is in the application cache location. Caching is disabled if empty.
+  void setXmlDescriptionCacheDirectory(const QString& cacheDirectory);
+  QString xmlDescriptionCacheDirectory()const;
+
 protected:
   bool isValidFile(const QFileInfo& file)const override;
 
@@ -30,13 +30,53 @@
 // Slicer includes
 #include "qMRMLNodeComboBox.h"
 #include "qSlicerCLIModuleWidget.h"
+#include "qSlicerCoreApplication.h"
 #include "vtkSlicerCLIModuleLogic.h"
+#include "vtkSlicerConfigure.h" // For Slicer_USE_PYTHONQT
+#ifdef Slicer_USE_PYTHONQT
+# include "qSlicerCorePythonManager.h"
+#endif
 
 // SlicerExecutionModel includes
 #include <ModuleDescription.h>
 #include <ModuleDescriptionParser.h>
 #include <ModuleLogo.h>
 
+#ifdef Slicer_USE_PYTHONQT
+namespace
+{
+//-----------------------------------------------------------------------------
+int executePythonCLIScript(const std::vector<std::string>& arguments,
+                           std::string& outputText, std::string& errorText)
+{
+  qSlicerCoreApplication* app = qSlicerCoreApplication::application();
+  qSlicerCorePythonManager* pythonManager = app ? app->corePythonManager() : nullptr;
+  if (!pythonManager || arguments.empty())
+    {
+    errorText = "Python interpreter is not available";
+    return 1;
+    }
+  QStringList pythonArguments;
+  for (const std::string& argument : arguments)
+    {
+    pythonArguments << qSlicerCorePythonManager::toPythonStringLiteral(QString::fromStdString(argument));
+    }
+  pythonManager->executeString("import slicer.cli");
+  QVariantList result = pythonManager->executeString(
+    QString("slicer.cli.runScriptInProcess([%1])").arg(pythonArguments.join(", ")),
+    ctkAbstractPythonManager::EvalInput).toList();
+  if (pythonManager->pythonErrorOccured() || result.size() != 3)
+    {
+    errorText = "Failed to run Python script " + arguments[0];
+    return 1;
+    }
+  outputText = result[1].toString().toStdString();
+  errorText = result[2].toString().toStdString();
+  return result[0].toInt();
+}
+}
+#endif
+
 //-----------------------------------------------------------------------------
 class qSlicerCLIModulePrivate
 {
@@ -90,6 +130,11 @@ vtkMRMLAbstractLogic* qSlicerCLIModule::createLogic()
   vtkSlicerCLIModuleLogic* logic = vtkSlicerCLIModuleLogic::New();
   logic->SetDefaultModuleDescription(d->Desc);
 
+#ifdef Slicer_USE_PYTHONQT
+  // Allows running scripted CLIs in the application process (see vtkSlicerCLIModuleLogic::SetRunPythonInProcess)
+  vtkSlicerCLIModuleLogic::SetPythonScriptExecutor(executePythonCLIScript);
+#endif
+
   // In developer mode keep the CLI modules input and output files
   QSettings settings;
   bool developerModeEnabled = settings.value("Developer/PreserveCLIModuleDataFiles", false).toBool();
@@ -30,13 +30,16 @@
 #include <vtkMRMLStorageNode.h>
 #include <vtkMRMLModelStorageNode.h>
 #include <vtkMRMLTransformNode.h>
+#include <vtkMRMLVolumeNode.h>
 
 // VTK includes
 #include <vtkCallbackCommand.h>
+#include <vtkImageData.h>
 #include <vtkIntArray.h>
 #include <vtkMultiThreader.h>
 #include <vtkNew.h>
 #include <vtkObjectFactory.h>
+#include <vtkPointData.h>
 #include <vtkStringArray.h>
 #include <vtksys/SystemTools.hxx>
 
@@ -45,6 +48,9 @@
 #include <itksys/SystemTools.hxx>
 #include <itksys/RegularExpression.hxx>
 
+// ITKFactoryRegistration includes
+#include <itkSharedMemoryImageSegment.h>
+
 // Qt includes
 #include <QDebug>
 
@@ -54,14 +60,20 @@
 
 // STL includes
 #include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <cerrno>
+#include <cstring>
 #include <ctime>
+#include <memory>
 #include <mutex>
 #include <random>
 #include <set>
 
 #ifdef _WIN32
+#include <windows.h>
 #else
+#include <csignal>
 #include <sys/types.h>
 #include <unistd.h>
 #endif
@@ -81,6 +93,166 @@ struct DigitsToCharacters
 };
 
 typedef std::pair<vtkSlicerCLIModuleLogic *, vtkMRMLCommandLineModuleNode *> LogicNodePair;
+
+namespace
+{
+/// Serializes changes of the environment around starting executables
+std::mutex ProcessLaunchLock;
+
+/// Runs scripted CLIs in the application process (see vtkSlicerCLIModuleLogic::SetPythonScriptExecutor())
+vtkSlicerCLIModuleLogic::PythonScriptExecutorFunction PythonScriptExecutor = nullptr;
+
+/// Argument that starts a CLI executable in worker mode, and the tag that
+/// the worker writes to its standard output and error when a job is done
+/// (see SEMCommandLineLibraryWrapper.cxx.in).
+const char* WorkerArgument = "--slicer-worker";
+const char* WorkerJobEndCloseTag = "</slicer-worker-job-end>";
+
+#ifdef _WIN32
+const itksysProcess_Pipe_Handle InvalidPipeHandle = nullptr;
+#else
+const itksysProcess_Pipe_Handle InvalidPipeHandle = -1;
+#endif
+
+//----------------------------------------------------------------------------
+bool CreateWorkerInputPipe(itksysProcess_Pipe_Handle pipeHandles[2])
+{
+#ifdef _WIN32
+  // itksysProcess makes an inheritable duplicate of the child's end
+  return CreatePipe(&pipeHandles[0], &pipeHandles[1], nullptr, 0) != 0;
+#else
+  // Writing to a worker that has exited must fail instead of raising SIGPIPE
+  static std::once_flag ignoreBrokenPipeFlag;
+  std::call_once(ignoreBrokenPipeFlag, []() { signal(SIGPIPE, SIG_IGN); });
+  return pipe(pipeHandles) == 0;
+#endif
+}
+
+//----------------------------------------------------------------------------
+void CloseWorkerPipe(itksysProcess_Pipe_Handle& pipeHandle)
+{
+  if (pipeHandle == InvalidPipeHandle)
+    {
+    return;
+    }
+#ifdef _WIN32
+  CloseHandle(pipeHandle);
+#else
+  close(pipeHandle);
+#endif
+  pipeHandle = InvalidPipeHandle;
+}
+
+//----------------------------------------------------------------------------
+bool WriteToWorkerPipe(itksysProcess_Pipe_Handle pipeHandle, const std::string& data)
+{
+  const char* buffer = data.c_str();
+  size_t remaining = data.size();
+  while (remaining > 0)
+    {
+#ifdef _WIN32
+    DWORD written = 0;
+    if (!WriteFile(pipeHandle, buffer, static_cast<DWORD>(remaining), &written, nullptr))
+      {
+      return false;
+      }
+#else
+    ssize_t written = write(pipeHandle, buffer, remaining);
+    if (written < 0 && errno == EINTR)
+      {
+      continue;
+      }
+    if (written <= 0)
+      {
+      return false;
+      }
+#endif
+    buffer += written;
+    remaining -= static_cast<size_t>(written);
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+/// Remove the job end tag from the output of a worker.
+/// Returns true if the tag was found, exitValue is set to the value in the tag.
+bool ExtractWorkerJobEnd(std::string& output, int& exitValue)
+{
+  itksys::RegularExpression jobEndRegExp("<slicer-worker-job-end>([^<]*)</slicer-worker-job-end>[ \t\n\r]*");
+  if (!jobEndRegExp.find(output))
+    {
+    return false;
+    }
+  exitValue = atoi(jobEndRegExp.match(1).c_str());
+  output.erase(jobEndRegExp.start(), jobEndRegExp.end() - jobEndRegExp.start());
+  return true;
+}
+
+//----------------------------------------------------------------------------
+// Copy the voxels and geometry (converted to LPS) of a volume into a new shared memory segment
+bool WriteVolumeToSharedMemory(vtkMRMLVolumeNode* volumeNode,
+  const std::string& segmentName, itk::SharedMemoryImageSegment* segment)
+{
+  vtkImageData* imageData = volumeNode ? volumeNode->GetImageData() : nullptr;
+  if (!imageData || !imageData->GetPointData() || !imageData->GetPointData()->GetScalars())
+    {
+    return false;
+    }
+
+  itk::SharedMemoryImageSegment::Header header;
+  memset(&header, 0, sizeof(header));
+  switch (imageData->GetScalarType())
+    {
+    case VTK_UNSIGNED_CHAR: header.ComponentType = itk::SharedMemoryImageSegment::UInt8; break;
+    case VTK_CHAR:
+    case VTK_SIGNED_CHAR: header.ComponentType = itk::SharedMemoryImageSegment::Int8; break;
+    case VTK_UNSIGNED_SHORT: header.ComponentType = itk::SharedMemoryImageSegment::UInt16; break;
+    case VTK_SHORT: header.ComponentType = itk::SharedMemoryImageSegment::Int16; break;
+    case VTK_UNSIGNED_INT: header.ComponentType = itk::SharedMemoryImageSegment::UInt32; break;
+    case VTK_INT: header.ComponentType = itk::SharedMemoryImageSegment::Int32; break;
+    case VTK_UNSIGNED_LONG:
+      header.ComponentType = (sizeof(unsigned long) == 8 ?
+        itk::SharedMemoryImageSegment::UInt64 : itk::SharedMemoryImageSegment::UInt32);
+      break;
+    case VTK_LONG:
+      header.ComponentType = (sizeof(long) == 8 ?
+        itk::SharedMemoryImageSegment::Int64 : itk::SharedMemoryImageSegment::Int32);
+      break;
+    case VTK_UNSIGNED_LONG_LONG: header.ComponentType = itk::SharedMemoryImageSegment::UInt64; break;
+    case VTK_LONG_LONG: header.ComponentType = itk::SharedMemoryImageSegment::Int64; break;
+    case VTK_FLOAT: header.ComponentType = itk::SharedMemoryImageSegment::Float32; break;
+    case VTK_DOUBLE: header.ComponentType = itk::SharedMemoryImageSegment::Float64; break;
+    default:
+      return false;
+    }
+  header.NumberOfComponents = static_cast<uint32_t>(imageData->GetNumberOfScalarComponents());
+
+  int dimensions[3] = { 0, 0, 0 };
+  imageData->GetDimensions(dimensions);
+  double directions[3][3] = { { 0.0 } };
+  volumeNode->GetIJKToRASDirections(directions);
+  for (int row = 0; row < 3; ++row)
+    {
+    // RAS to LPS
+    double sign = (row < 2 ? -1.0 : 1.0);
+    header.Size[row] = static_cast<uint64_t>(dimensions[row]);
+    header.Spacing[row] = volumeNode->GetSpacing()[row];
+    header.Origin[row] = sign * volumeNode->GetOrigin()[row];
+    for (int column = 0; column < 3; ++column)
+      {
+      header.Direction[row * 3 + column] = sign * directions[row][column];
+      }
+    }
+
+  if (!segment->Create(segmentName, header))
+    {
+    return false;
+    }
+  memcpy(segment->GetPixelData(), imageData->GetScalarPointer(),
+    static_cast<size_t>(segment->GetHeader()->PixelDataSize));
+  return true;
+}
+}
 class MRMLIDMap : public std::map<std::string, std::string> {};
 
 //---------------------------------------------------------------------------
@@ -200,10 +372,33 @@ public:
   ModuleDescription DefaultModuleDescription;
   int DeleteTemporaryFiles;
   int AllowInMemoryTransfer;
+  int AllowSharedMemoryTransfer;
+  int RequiredNumberOfThreads;
+  int RequiredMemoryMB;
+  int UsePersistentWorkers;
+  int RunPythonInProcess;
+
+  /// Executable kept running between executions
+  struct Worker
+  {
+    std::string Executable;
+    itksysProcess* Process;
+    /// Parent's end of the pipe connected to the standard input of the worker
+    itksysProcess_Pipe_Handle Input;
+  };
+  std::mutex WorkersLock;
+  std::vector<Worker> IdleWorkers;
+
+  /// Used for making temporary file names unique to each execution
+  std::atomic<int> TemporaryFileCounter{0};
+
+  /// Used for making shared memory segment names unique within the process
+  std::atomic<int> SharedMemorySegmentCounter{0};
 
   int RedirectModuleStreams;
 
   std::default_random_engine RandomGenerator;
+  std::mutex RandomGeneratorLock;
 
   std::mutex ProcessesKillLock;
   std::vector<itksysProcess*> Processes;
@@ -305,6 +500,11 @@ vtkSlicerCLIModuleLogic::vtkSlicerCLIModuleLogic()
 
   this->Internal->DeleteTemporaryFiles = 1;
   this->Internal->AllowInMemoryTransfer = 1;
+  this->Internal->AllowSharedMemoryTransfer = 0;
+  this->Internal->RequiredNumberOfThreads = 0;
+  this->Internal->RequiredMemoryMB = 0;
+  this->Internal->UsePersistentWorkers = 0;
+  this->Internal->RunPythonInProcess = 0;
   this->Internal->RedirectModuleStreams = 1;
   this->Internal->RescheduleCallback =
     vtkSmartPointer<vtkSlicerCLIRescheduleCallback>::New();
@@ -320,6 +520,7 @@ vtkSlicerCLIModuleLogic::vtkSlicerCLIModuleLogic()
 vtkSlicerCLIModuleLogic::~vtkSlicerCLIModuleLogic()
 {
   this->RemoveObserver(this->Internal->OneShotCallbackCallback);
+  this->ShutdownWorkers();
 
   delete this->Internal;
 }
@@ -408,6 +609,124 @@ int vtkSlicerCLIModuleLogic::GetAllowInMemoryTransfer() const
   return this->Internal->AllowInMemoryTransfer;
 }
 
+//----------------------------------------------------------------------------
+void vtkSlicerCLIModuleLogic::SetAllowSharedMemoryTransfer(int value)
+{
+  vtkDebugMacro(<< this->GetClassName() << " (" << this << "): setting AllowSharedMemoryTransfer to " << value);
+  if (this->Internal->AllowSharedMemoryTransfer != value)
+    {
+    this->Internal->AllowSharedMemoryTransfer = value;
+    }
+}
+
+//----------------------------------------------------------------------------
+int vtkSlicerCLIModuleLogic::GetAllowSharedMemoryTransfer() const
+{
+  return this->Internal->AllowSharedMemoryTransfer;
+}
+
+//----------------------------------------------------------------------------
+void vtkSlicerCLIModuleLogic::SetRequiredNumberOfThreads(int numberOfThreads)
+{
+  this->Internal->RequiredNumberOfThreads = std::max(0, numberOfThreads);
+}
+
+//----------------------------------------------------------------------------
+int vtkSlicerCLIModuleLogic::GetRequiredNumberOfThreads() const
+{
+  return this->Internal->RequiredNumberOfThreads;
+}
+
+//----------------------------------------------------------------------------
+void vtkSlicerCLIModuleLogic::SetRequiredMemoryMB(int memoryMB)
+{
+  this->Internal->RequiredMemoryMB = std::max(0, memoryMB);
+}
+
+//----------------------------------------------------------------------------
+int vtkSlicerCLIModuleLogic::GetRequiredMemoryMB() const
+{
+  return this->Internal->RequiredMemoryMB;
+}
+
+//----------------------------------------------------------------------------
+void vtkSlicerCLIModuleLogic::SetUsePersistentWorkers(int value)
+{
+  vtkDebugMacro(<< this->GetClassName() << " (" << this << "): setting "
+                << "UsePersistentWorkers to " << value);
+  this->Internal->UsePersistentWorkers = value;
+  if (!value)
+    {
+    this->ShutdownWorkers();
+    }
+}
+
+//----------------------------------------------------------------------------
+int vtkSlicerCLIModuleLogic::GetUsePersistentWorkers() const
+{
+  return this->Internal->UsePersistentWorkers;
+}
+
+//----------------------------------------------------------------------------
+void vtkSlicerCLIModuleLogic::ShutdownWorkers()
+{
+  std::vector<vtkInternal::Worker> workers;
+  {
+  std::lock_guard<std::mutex> lock(this->Internal->WorkersLock);
+  workers.swap(this->Internal->IdleWorkers);
+  }
+  for (vtkInternal::Worker& worker : workers)
+    {
+    // workers exit when their standard input is closed
+    CloseWorkerPipe(worker.Input);
+    double timeout = 1.0;
+    if (!itksysProcess_WaitForExit(worker.Process, &timeout))
+      {
+      itksysProcess_Kill(worker.Process);
+      itksysProcess_WaitForExit(worker.Process, nullptr);
+      }
+    itksysProcess_Delete(worker.Process);
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkSlicerCLIModuleLogic::SetPythonScriptExecutor(PythonScriptExecutorFunction executor)
+{
+  PythonScriptExecutor = executor;
+}
+
+//----------------------------------------------------------------------------
+vtkSlicerCLIModuleLogic::PythonScriptExecutorFunction vtkSlicerCLIModuleLogic::GetPythonScriptExecutor()
+{
+  return PythonScriptExecutor;
+}
+
+//----------------------------------------------------------------------------
+void vtkSlicerCLIModuleLogic::SetRunPythonInProcess(int value)
+{
+  vtkDebugMacro(<< this->GetClassName() << " (" << this << "): setting "
+                << "RunPythonInProcess to " << value);
+  this->Internal->RunPythonInProcess = value;
+}
+
+//----------------------------------------------------------------------------
+int vtkSlicerCLIModuleLogic::GetRunPythonInProcess() const
+{
+  return this->Internal->RunPythonInProcess;
+}
+
+//----------------------------------------------------------------------------
+bool vtkSlicerCLIModuleLogic::IsRunningPythonInProcess(const ModuleDescription& moduleDescription) const
+{
+  // Scripted CLIs are command line modules whose target is a .py file
+  // run by the Python executable given as location (see qSlicerCLIExecutableModuleFactory)
+  return this->Internal->RunPythonInProcess && PythonScriptExecutor != nullptr
+    && moduleDescription.GetType() == "CommandLineModule"
+    && !moduleDescription.GetLocation().empty()
+    && vtksys::SystemTools::LowerCase(
+         vtksys::SystemTools::GetFilenameLastExtension(moduleDescription.GetTarget())) == ".py";
+}
+
 //----------------------------------------------------------------------------
 void vtkSlicerCLIModuleLogic::RedirectModuleStreamsOn()
 {
@@ -513,14 +832,10 @@ vtkSlicerCLIModuleLogic
   // The filename will point to the Temporary directory defined for
   // Slicer. The filename will be unique to the process (multiple
   // running instances of slicer will not collide).  The filename
-  // will be unique to the node in the process (the same node will be
-  // encoded to the same filename every time within that running
-  // instance of Slicer).  This last point is an optimization to
-  // minimize the number of times a file is written when running a
-  // module.  However, if we change the execution model such that more
+  // will also be unique to each call within the process, as more
   // than one module can run at the same time within the same Slicer
-  // process, then this encoding will need to be changed to be unique
-  // per module execution.
+  // process (see vtkSlicerApplicationLogic::SetMaximumNumberOfConcurrentProcessingTasks)
+  // and they must not overwrite each other's files.
   //
 
   // Encode process id into a string.  To avoid confusing the
@@ -553,7 +868,11 @@ vtkSlicerCLIModuleLogic
     {
     temporaryDirectory = appLogic->GetTemporaryPath();
     }
-  fname = temporaryDirectory + "/" + pid + "_" + fname;
+  std::ostringstream counterString;
+  counterString << this->Internal->TemporaryFileCounter++;
+  std::string counter = counterString.str();
+  std::transform(counter.begin(), counter.end(), counter.begin(), DigitsToCharacters());
+  fname = temporaryDirectory + "/" + pid + "_" + counter + "_" + fname;
 
   if (tag == "image")
     {
@@ -698,9 +1017,10 @@ void vtkSlicerCLIModuleLogic::Apply ( vtkMRMLCommandLineModuleNode* node, bool u
 {
   bool ret;
 
-  if ( node->GetModuleDescription().GetType() == "PythonModule" )
+  if ( node->GetModuleDescription().GetType() == "PythonModule"
+       || this->IsRunningPythonInProcess(node->GetModuleDescription()) )
     {
-    this->ApplyAndWait ( node );
+    this->ApplyAndWait ( node, updateDisplay );
     return;
     }
 
@@ -721,6 +1041,13 @@ void vtkSlicerCLIModuleLogic::Apply ( vtkMRMLCommandLineModuleNode* node, bool u
   node->Register(this);
   node->SetAttribute("UpdateDisplay", updateDisplay ? "true" : "false");
 
+  // Resources used by the application logic for running tasks concurrently.
+  // Shared object modules run in the Slicer process, redirect the standard
+  // streams and rely on process-wide ITK settings, therefore they must run alone.
+  task->SetNumberOfThreads(this->Internal->RequiredNumberOfThreads);
+  task->SetMemoryMB(this->Internal->RequiredMemoryMB);
+  task->SetExclusive(node->GetModuleDescription().GetType() == "SharedObjectModule");
+
   // Schedule the task
   ret = this->GetApplicationLogic()->ScheduleTask( task.GetPointer() );
 
@@ -898,6 +1225,10 @@ void vtkSlicerCLIModuleLogic::ApplyTask(void *clientdata)
     qDebug() << "Found Python Module";
     commandType = PythonModule;
     }
+  // Scripted CLIs can run in the Python interpreter of Slicer. Their command line
+  // is built as for executables, except that images are exchanged as for shared object modules.
+  bool runPythonInProcess = (commandType == CommandLineModule)
+    && this->IsRunningPythonInProcess(node0->GetModuleDescription());
   // vtkSlicerApplication::GetInstance()->InformationMessage
   qDebug() << "ModuleType:" << node0->GetModuleDescription().GetType().c_str();
 
@@ -921,6 +1252,15 @@ void vtkSlicerCLIModuleLogic::ApplyTask(void *clientdata)
   // vector of files to delete
   std::set<std::string> filesToDelete;
 
+  // Volume node types that can be exchanged with executables through shared memory
+  std::set<std::string> SharedMemoryTransferPossible;
+  SharedMemoryTransferPossible.insert("vtkMRMLScalarVolumeNode");
+  SharedMemoryTransferPossible.insert("vtkMRMLLabelMapVolumeNode");
+  SharedMemoryTransferPossible.insert("vtkMRMLVectorVolumeNode");
+
+  // Shared memory segments of the inputs, they are kept open until the module completes
+  std::vector<std::unique_ptr<itk::SharedMemoryImageSegment> > sharedMemorySegments;
+
   // iterators for parameter groups
   std::vector<ModuleParameterGroup>::iterator pgbeginit
     = node0->GetModuleDescription().GetParameterGroups().begin();
@@ -968,7 +1308,27 @@ void vtkSlicerCLIModuleLogic::ApplyTask(void *clientdata)
                                              (*pit).GetType(),
                                              id,
                                              (*pit).GetFileExtensions(),
-                                             commandType);
+                                             runPythonInProcess ? SharedObjectModule : commandType);
+
+        // Images of executables can be passed through shared memory instead of files.
+        // Outputs need segments that remain available after the executable exits.
+        vtkMRMLVolumeNode* volumeNode = vtkMRMLVolumeNode::SafeDownCast(this->GetMRMLScene()->GetNodeByID(id.c_str()));
+        if (commandType == CommandLineModule && !runPythonInProcess && this->GetAllowSharedMemoryTransfer()
+          && (*pit).GetTag() == "image" && (*pit).GetType() != "dynamic-contrast-enhanced"
+          && volumeNode && SharedMemoryTransferPossible.count(volumeNode->GetClassName())
+          && (((*pit).GetChannel() == "input" && volumeNode->GetImageData())
+            || ((*pit).GetChannel() == "output" && itk::SharedMemoryImageSegment::SegmentsOutliveCreator())))
+          {
+          // Names are kept short, as some systems allow only 31 characters
+          std::ostringstream segmentName;
+#ifdef _WIN32
+          segmentName << "slicer" << GetCurrentProcessId();
+#else
+          segmentName << "slicer" << getpid();
+#endif
+          segmentName << "_" << this->Internal->SharedMemorySegmentCounter++;
+          fname = itk::SharedMemoryImageSegment::GetURIFromName(segmentName.str());
+          }
 
         filesToDelete.insert(fname);
         if ((*pit).GetChannel() == "input")
@@ -1046,12 +1406,23 @@ void vtkSlicerCLIModuleLogic::ApplyTask(void *clientdata)
       // No need to write anything out with Python
       continue;
       }
-    if ((commandType == CommandLineModule) && defaultOut)
+    if (itk::SharedMemoryImageSegment::IsSharedMemoryURI((*id2fn0).second.c_str()))
+      {
+      std::unique_ptr<itk::SharedMemoryImageSegment> segment(new itk::SharedMemoryImageSegment);
+      if (!WriteVolumeToSharedMemory(vtkMRMLVolumeNode::SafeDownCast(nd),
+        itk::SharedMemoryImageSegment::GetNameFromURI((*id2fn0).second), segment.get()))
+        {
+        vtkErrorMacro("ERROR writing shared memory segment " << (*id2fn0).second);
+        }
+      sharedMemorySegments.push_back(std::move(segment));
+      continue;
+      }
+    if ((commandType == CommandLineModule) && !runPythonInProcess && defaultOut)
       {
       // Default case for CommandLineModule is to use a storage node
       out = defaultOut;
       }
-    if ((commandType == SharedObjectModule) && defaultOut)
+    if ((commandType == SharedObjectModule || runPythonInProcess) && defaultOut)
       {
       //std::cerr << nd->GetName() << " is " << nd->GetClassName() << std::endl;
 
@@ -1261,10 +1632,14 @@ void vtkSlicerCLIModuleLogic::ApplyTask(void *clientdata)
         "abcdefghijklmnopqrstuvwxyz";
 
     std::ostringstream code;
+    {
+    // the generator is shared by all the modules that run concurrently
+    std::lock_guard<std::mutex> lock(this->Internal->RandomGeneratorLock);
     for (int ii = 0; ii < 10; ii++)
       {
       code << alphanum[this->Internal->RandomGenerator() % (sizeof(alphanum)-1)];
       }
+    }
     std::string returnFile = temporaryDirectory + "/" + pidString.str()
       + "_" + code.str() + ".params";
 
@@ -1784,56 +2159,215 @@ void vtkSlicerCLIModuleLogic::ApplyTask(void *clientdata)
   node0->SetErrorText("", false);
   node0->SetStatus(vtkMRMLCommandLineModuleNode::Running, false);
   this->GetApplicationLogic()->RequestModified( node0 );
-  if (commandType == CommandLineModule)
+  if (runPythonInProcess)
     {
-    // Run as a command line module
-    //
-    //
+    // Run the script in the Python interpreter of the application,
+    // the first argument (Python executable) is not needed
+    std::vector<std::string> scriptArguments(commandLineAsString.begin() + 1, commandLineAsString.end());
+    std::string outputText;
+    std::string errorText;
+    int exitValue = (*PythonScriptExecutor)(scriptArguments, outputText, errorText);
 
-    // Unset ITK_AUTOLOAD_PATH environment variable to prevent the CLI from
-    // loading the itkMRMLIDIOPlugin plugin because executable CLIs read images
-    // from file and not from shared memory. Worst the plugin in the CLI
-    // could clash by loading libraries (ITK, VTK, MRML) other than the
-    // statically linked to the executable.
-    // Historically, there was an nvidia driver bug that causes the module
-    // to fail on exit with undefined symbol.
-     std::string saveITKAutoLoadPath;
-     itksys::SystemTools::GetEnv("ITK_AUTOLOAD_PATH", saveITKAutoLoadPath);
-     std::string emptyString("ITK_AUTOLOAD_PATH=");
-     int putSuccess =
-       itksys::SystemTools::PutEnv(const_cast <char *> (emptyString.c_str()));
-     if (!putSuccess)
-       {
-       vtkErrorMacro( "Unable to reset ITK_AUTOLOAD_PATH.");
-       }
+    if (!outputText.empty())
+      {
+      std::string tmp(" standard output:\n\n");
+      tmp = node0->GetModuleDescription().GetTitle()+tmp;
+      qDebug() << (tmp + outputText).c_str();
+      }
+    node0->SetOutputText(outputText, false);
+    if (!errorText.empty())
+      {
+      std::string tmp(" standard error:\n\n");
+      tmp = node0->GetModuleDescription().GetTitle()+tmp;
+      vtkErrorMacro( << (tmp + errorText).c_str() );
+      }
+    node0->SetErrorText(errorText, false);
+
+    std::stringstream information;
+    if (exitValue == 0)
+      {
+      information << node0->GetModuleDescription().GetTitle()
+                  << " completed without errors" << std::endl;
+      qDebug() << information.str().c_str();
+      }
+    else
+      {
+      information << node0->GetModuleDescription().GetTitle()
+                  << " completed with errors" << std::endl;
+      vtkErrorMacro( << information.str().c_str() );
+      node0->SetStatus(vtkMRMLCommandLineModuleNode::CompletedWithErrors, false);
+      }
+    this->GetApplicationLogic()->RequestModified( node0 );
+    }
+  else if (commandType == CommandLineModule)
+    {
+    // Run as a command line module
     //
-    // now run the process
     //
-    itksysProcess *process = itksysProcess_New();
 
-    this->Internal->Processes.push_back(process);
+    bool useWorker = this->Internal->UsePersistentWorkers != 0;
+    vtkInternal::Worker worker = { std::string(), nullptr, InvalidPipeHandle };
+    itksysProcess *process = nullptr;
+    std::string workerJob;
+    if (useWorker)
+      {
+      // arguments of the execution, in the format read by the worker
+      vtkSlicerTask* executingTask = vtkSlicerTask::GetExecutingTask();
+      std::ostringstream job;
+      job << (executingTask ? executingTask->GetAllocatedNumberOfThreads() : 0)
+          << " " << commandLineAsString.size() - 1 << "\n";
+      for (std::vector<std::string>::size_type i = 1; i < commandLineAsString.size(); ++i)
+        {
+        job << commandLineAsString[i].size() << "\n" << commandLineAsString[i] << "\n";
+        }
+      workerJob = job.str();
 
-    // setup the command
-    itksysProcess_SetCommand(process, command);
-    itksysProcess_SetOption(process,
-                            itksysProcess_Option_Detach, 0);
-    itksysProcess_SetOption(process,
-                            itksysProcess_Option_HideWindow, 1);
-    // itksysProcess_SetTimeout(process, 5.0); // 5 seconds
+      // reuse an idle worker of the same executable
+      while (!process)
+        {
+        {
+        std::lock_guard<std::mutex> lock(this->Internal->WorkersLock);
+        std::vector<vtkInternal::Worker>::iterator workerIt = this->Internal->IdleWorkers.begin();
+        while (workerIt != this->Internal->IdleWorkers.end() && workerIt->Executable != command[0])
+          {
+          ++workerIt;
+          }
+        if (workerIt == this->Internal->IdleWorkers.end())
+          {
+          break;
+          }
+        worker = *workerIt;
+        this->Internal->IdleWorkers.erase(workerIt);
+        }
+        if (WriteToWorkerPipe(worker.Input, workerJob))
+          {
+          process = worker.Process;
+          }
+        else
+          {
+          // the worker has exited since its last execution
+          CloseWorkerPipe(worker.Input);
+          itksysProcess_Kill(worker.Process);
+          itksysProcess_WaitForExit(worker.Process, nullptr);
+          itksysProcess_Delete(worker.Process);
+          }
+        }
+      }
+    if (!process)
+      {
+      // Unset ITK_AUTOLOAD_PATH environment variable to prevent the CLI from
+      // loading the itkMRMLIDIOPlugin plugin because executable CLIs read images
+      // from file and not from shared memory. Worst the plugin in the CLI
+      // could clash by loading libraries (ITK, VTK, MRML) other than the
+      // statically linked to the executable.
+      // Historically, there was an nvidia driver bug that causes the module
+      // to fail on exit with undefined symbol.
+      // The environment is process-wide, modules that run concurrently
+      // must not launch their executables at the same time.
+      std::unique_lock<std::mutex> launchLock(ProcessLaunchLock);
+       std::string saveITKAutoLoadPath;
+       itksys::SystemTools::GetEnv("ITK_AUTOLOAD_PATH", saveITKAutoLoadPath);
+       std::string emptyString("ITK_AUTOLOAD_PATH=");
+       int putSuccess =
+         itksys::SystemTools::PutEnv(const_cast <char *> (emptyString.c_str()));
+       if (!putSuccess)
+         {
+         vtkErrorMacro( "Unable to reset ITK_AUTOLOAD_PATH.");
+         }
+
+      // Limit the number of threads of the executable to the number
+      // allocated to the task, so that concurrent modules do not oversubscribe the CPU
+      const char* threadVariables[] = { "ITK_GLOBAL_DEFAULT_NUMBER_OF_THREADS", "OMP_NUM_THREADS" };
+      std::vector<std::pair<std::string, std::string> > savedThreadVariables;
+      vtkSlicerTask* executingTask = vtkSlicerTask::GetExecutingTask();
+      if (executingTask && executingTask->GetAllocatedNumberOfThreads() > 0)
+        {
+        std::ostringstream numberOfThreads;
+        numberOfThreads << executingTask->GetAllocatedNumberOfThreads();
+        for (const char* threadVariable : threadVariables)
+          {
+          std::string savedValue;
+          if (!itksys::SystemTools::GetEnv(threadVariable, savedValue))
+            {
+            savedValue.clear();
+            }
+          savedThreadVariables.push_back(std::make_pair(std::string(threadVariable), savedValue));
+          std::string putEnvString = std::string(threadVariable) + "=" + numberOfThreads.str();
+          if (!itksys::SystemTools::PutEnv(putEnvString))
+            {
+            vtkErrorMacro("Unable to set " << threadVariable << ".");
+            }
+          }
+        }
+      //
+      // now run the process
+      //
+      process = itksysProcess_New();
 
-    // execute the command
-    itksysProcess_Execute(process);
+      // setup the command
+      char* workerCommand[] = { command[0], const_cast<char*>(WorkerArgument), nullptr };
+      itksysProcess_SetCommand(process, useWorker ? workerCommand : command);
+      itksysProcess_Pipe_Handle workerPipe[2] = { InvalidPipeHandle, InvalidPipeHandle };
+      if (useWorker)
+        {
+        if (CreateWorkerInputPipe(workerPipe))
+          {
+          itksysProcess_SetPipeNative(process, itksysProcess_Pipe_STDIN, workerPipe);
+          }
+        else
+          {
+          vtkErrorMacro("Unable to create input pipe of worker, running the module without worker.");
+          useWorker = false;
+          itksysProcess_SetCommand(process, command);
+          }
+        }
+      itksysProcess_SetOption(process,
+                              itksysProcess_Option_Detach, 0);
+      itksysProcess_SetOption(process,
+                              itksysProcess_Option_HideWindow, 1);
+      // itksysProcess_SetTimeout(process, 5.0); // 5 seconds
+
+      // execute the command
+      itksysProcess_Execute(process);
+      // the child has its own copy of the read end
+      CloseWorkerPipe(workerPipe[0]);
+      worker.Executable = command[0];
+      worker.Process = process;
+      worker.Input = workerPipe[1];
+
+      // restore the load path
+      std::string putEnvString = ("ITK_AUTOLOAD_PATH=");
+      putEnvString = putEnvString + saveITKAutoLoadPath;
+      putSuccess =
+        itksys::SystemTools::PutEnv(const_cast <char *> (putEnvString.c_str()));
+      if (!putSuccess)
+        {
+        vtkErrorMacro( "Unable to restore ITK_AUTOLOAD_PATH. ");
+        }
+      for (const std::pair<std::string, std::string>& savedThreadVariable : savedThreadVariables)
+        {
+        if (savedThreadVariable.second.empty())
+          {
+          itksys::SystemTools::UnPutEnv(savedThreadVariable.first);
+          }
+        else
+          {
+          itksys::SystemTools::PutEnv(savedThreadVariable.first + "=" + savedThreadVariable.second);
+          }
+        }
+      launchLock.unlock();
 
-    // restore the load path
-    std::string putEnvString = ("ITK_AUTOLOAD_PATH=");
-    putEnvString = putEnvString + saveITKAutoLoadPath;
-    putSuccess =
-      itksys::SystemTools::PutEnv(const_cast <char *> (putEnvString.c_str()));
-    if (!putSuccess)
-      {
-      vtkErrorMacro( "Unable to restore ITK_AUTOLOAD_PATH. ");
+      if (useWorker && !WriteToWorkerPipe(worker.Input, workerJob))
+        {
+        // the worker has exited, the output of the process is handled as usual
+        vtkWarningMacro("Worker of " << node0->GetModuleDescription().GetTitle() << " is not running.");
+        }
       }
 
+    this->Internal->ProcessesKillLock.lock();
+    this->Internal->Processes.push_back(process);
+    this->Internal->ProcessesKillLock.unlock();
+
     // Wait for the command to finish
     char *tbuffer;
     int length;
@@ -1844,6 +2378,12 @@ void vtkSlicerCLIModuleLogic::ApplyTask(void *clientdata)
     std::string stderrbuffer;
     std::string::size_type tagend;
     std::string::size_type tagstart;
+    // a worker keeps running after the execution, its end is signaled
+    // by a tag in both the standard output and error
+    bool workerStdoutFinished = false;
+    bool workerStderrFinished = false;
+    // position in stdoutbuffer from where intermediate outputs are searched
+    std::string::size_type intermediateOutputSearchStart = 0;
     while ((pipe = itksysProcess_WaitForData(process ,&tbuffer,
                                              &length, &timeout)) != 0)
       {
@@ -1859,6 +2399,7 @@ void vtkSlicerCLIModuleLogic::ApplyTask(void *clientdata)
       if (node0->GetModuleDescription().GetProcessInformation()->Abort)
         {
         itksysProcess_Kill(process);
+        CloseWorkerPipe(worker.Input);
         this->Internal->Processes.erase(
               std::find(this->Internal->Processes.begin(), this->Internal->Processes.end(), process));
         node0->GetModuleDescription().GetProcessInformation()->Progress = 0;
@@ -1934,16 +2475,74 @@ void vtkSlicerCLIModuleLogic::ApplyTask(void *clientdata)
             {
             this->GetApplicationLogic()->RequestModified( node0 );
             }
+
+          // load the intermediate outputs that have been published since the last search
+          // (see itk::PublishIntermediateOutput)
+          const std::string intermediateOutputTag("<filter-intermediate-output>");
+          const std::string intermediateOutputCloseTag("</filter-intermediate-output>");
+          while ((tagstart = stdoutbuffer.find(intermediateOutputTag, intermediateOutputSearchStart)) != std::string::npos
+            && (tagend = stdoutbuffer.find(intermediateOutputCloseTag, tagstart)) != std::string::npos)
+            {
+            intermediateOutputSearchStart = tagend + intermediateOutputCloseTag.size();
+            std::string intermediateOutput = stdoutbuffer.substr(tagstart, tagend - tagstart);
+            itksys::RegularExpression intermediateOutputRegExp("<output>([^<]*)</output><file>([^<]*)</file>");
+            if (!intermediateOutputRegExp.find(intermediateOutput))
+              {
+              continue;
+              }
+            std::string outputFileName = intermediateOutputRegExp.match(1);
+            std::string intermediateFileName = intermediateOutputRegExp.match(2);
+            for (id2fn0 = nodesToReload.begin(); id2fn0 != nodesToReload.end(); ++id2fn0)
+              {
+              if ((*id2fn0).second == outputFileName
+                && sceneToMiniSceneMap.find((*id2fn0).first) == sceneToMiniSceneMap.end())
+                {
+                break;
+                }
+              }
+            // only files that are named after the output are accepted, as they are deleted after loading
+            std::string outputBaseName = itksys::SystemTools::GetFilenameWithoutLastExtension(outputFileName);
+            outputBaseName = itksys::SystemTools::GetFilenamePath(outputFileName) + "/" + outputBaseName + "_intermediate";
+            if (id2fn0 == nodesToReload.end()
+              || (intermediateFileName.compare(0, outputBaseName.size(), outputBaseName) != 0
+                  && intermediateFileName.compare(0, outputFileName.size() + 13, outputFileName + "_intermediate") != 0))
+              {
+              vtkWarningMacro("Ignoring intermediate output " << intermediateFileName
+                << " of " << node0->GetModuleDescription().GetTitle());
+              continue;
+              }
+            this->GetApplicationLogic()->RequestReadFile((*id2fn0).first.c_str(),
+              intermediateFileName.c_str(), false, this->GetDeleteTemporaryFiles());
+            }
+          workerStdoutFinished = useWorker && stdoutbuffer.find(WorkerJobEndCloseTag) != std::string::npos;
           }
         else if (pipe == itksysProcess_Pipe_STDERR)
           {
           stderrbuffer = stderrbuffer.append(tbuffer, length);
+          workerStderrFinished = useWorker && stderrbuffer.find(WorkerJobEndCloseTag) != std::string::npos;
           }
         }
+      if (workerStdoutFinished && workerStderrFinished)
+        {
+        break;
+        }
+      }
+
+    int exitValue = 0;
+    bool workerJobFinished = workerStdoutFinished && workerStderrFinished
+      && ExtractWorkerJobEnd(stdoutbuffer, exitValue);
+    if (workerJobFinished)
+      {
+      int stderrExitValue = 0;
+      ExtractWorkerJobEnd(stderrbuffer, stderrExitValue);
+      }
+    else
+      {
+      this->Internal->ProcessesKillLock.lock();
+      itksysProcess_WaitForExit(process, nullptr);
+      this->Internal->ProcessesKillLock.unlock();
+      exitValue = itksysProcess_GetExitValue(process);
       }
-    this->Internal->ProcessesKillLock.lock();
-    itksysProcess_WaitForExit(process, nullptr);
-    this->Internal->ProcessesKillLock.unlock();
 
     // remove the embedded XML from the stdout stream
     //
@@ -1993,6 +2592,14 @@ void vtkSlicerCLIModuleLogic::ApplyTask(void *clientdata)
                          filterStartRegExp.end()
                          - filterStartRegExp.start());
       }
+    itksys::RegularExpression filterIntermediateOutputRegExp(
+      "<filter-intermediate-output><output>[^<]*</output><file>[^<]*</file></filter-intermediate-output>[ \t\n\r]*");
+    while (filterIntermediateOutputRegExp.find(stdoutbuffer))
+      {
+      stdoutbuffer.erase(filterIntermediateOutputRegExp.start(),
+                         filterIntermediateOutputRegExp.end()
+                         - filterIntermediateOutputRegExp.start());
+      }
     itksys::RegularExpression filterEndRegExp("<filter-end>[^<]*</filter-end>[ \t\n\r]*");
     while (filterEndRegExp.find(stdoutbuffer))
       {
@@ -2026,12 +2633,12 @@ void vtkSlicerCLIModuleLogic::ApplyTask(void *clientdata)
       }
     else
       {
-      int result = itksysProcess_GetState(process);
+      int result = workerJobFinished ? itksysProcess_State_Exited : itksysProcess_GetState(process);
       if (result == itksysProcess_State_Exited)
         {
         // executable exited cleanly and must of done
         // "something"
-        if (itksysProcess_GetExitValue(process) == 0)
+        if (exitValue == 0)
           {
           // executable exited without errors,
           std::stringstream information;
@@ -2107,7 +2714,22 @@ void vtkSlicerCLIModuleLogic::ApplyTask(void *clientdata)
       this->Internal->ProcessesKillLock.lock();
       this->Internal->Processes.erase(
             std::find(this->Internal->Processes.begin(), this->Internal->Processes.end(), process));
-      itksysProcess_Delete(process);
+      if (workerJobFinished && this->Internal->UsePersistentWorkers)
+        {
+        // keep the worker for the next execution
+        std::lock_guard<std::mutex> lock(this->Internal->WorkersLock);
+        this->Internal->IdleWorkers.push_back(worker);
+        }
+      else
+        {
+        CloseWorkerPipe(worker.Input);
+        if (workerJobFinished)
+          {
+          itksysProcess_Kill(process);
+          itksysProcess_WaitForExit(process, nullptr);
+          }
+        itksysProcess_Delete(process);
+        }
       this->Internal->ProcessesKillLock.unlock();
       }
     }
@@ -2543,7 +3165,12 @@ void vtkSlicerCLIModuleLogic::ApplyTask(void *clientdata)
     std::set<std::string>::iterator fit;
     for (fit = filesToDelete.begin(); fit != filesToDelete.end(); ++fit)
       {
-      if (itksys::SystemTools::FileExists((*fit).c_str()))
+      if (itk::SharedMemoryImageSegment::IsSharedMemoryURI((*fit).c_str()))
+        {
+        // Inputs are removed when their segments are closed, outputs that were not read are removed here
+        itk::SharedMemoryImageSegment::Remove(itk::SharedMemoryImageSegment::GetNameFromURI(*fit));
+        }
+      else if (itksys::SystemTools::FileExists((*fit).c_str()))
         {
         removed = itksys::SystemTools::RemoveFile((*fit).c_str());
         if (!removed)
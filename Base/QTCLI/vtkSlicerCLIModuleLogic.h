@@ -28,6 +28,7 @@ class MRMLIDMap;
 
 // STL includes
 #include <string>
+#include <vector>
 
 #include "qSlicerBaseQTCLIExport.h"
 
@@ -91,6 +92,64 @@ public:
   void SetAllowInMemoryTransfer(int value);
   int GetAllowInMemoryTransfer() const;
 
+  /// Control exchange of scalar, label map and vector volumes with command line
+  /// module executables through shared memory instead of temporary files.
+  /// The executable must be linked with ITKFactoryRegistration (as Slicer CLIs are)
+  /// for reading and writing the "slicershm:" URIs. On Windows only inputs
+  /// are transferred through shared memory. Disabled by default.
+  void SetAllowSharedMemoryTransfer(int value);
+  int GetAllowSharedMemoryTransfer() const;
+
+  /// Resources required by one execution of the module, used by the application
+  /// logic for deciding which scheduled modules can run at the same time.
+  /// RequiredNumberOfThreads is the number of CPU threads that the module uses,
+  /// 0 means all the processing threads of the application (default).
+  /// Executables are started with ITK_GLOBAL_DEFAULT_NUMBER_OF_THREADS and
+  /// OMP_NUM_THREADS set to the number of threads allocated to them.
+  /// RequiredMemoryMB is the estimated peak memory usage in megabytes, 0 if unknown (default).
+  /// \sa vtkSlicerApplicationLogic::SetMaximumNumberOfConcurrentProcessingTasks()
+  void SetRequiredNumberOfThreads(int numberOfThreads);
+  int GetRequiredNumberOfThreads() const;
+  void SetRequiredMemoryMB(int memoryMB);
+  int GetRequiredMemoryMB() const;
+
+  /// Keep the executable of the module running after an execution and send
+  /// the arguments of the next executions to it, which saves the process
+  /// startup and IO factory registration for each execution (default 0).
+  /// The executable must be built with the CLI library wrapper, which
+  /// supports running as a worker (--slicer-worker argument).
+  /// Disabling it shuts down the idle workers.
+  void SetUsePersistentWorkers(int value);
+  int GetUsePersistentWorkers() const;
+
+  /// Stop the executables that are kept running for the next executions.
+  /// \sa SetUsePersistentWorkers()
+  void ShutdownWorkers();
+
+  /// Function that runs a Python script in the Python interpreter of the application.
+  /// \a arguments are the path of the script followed by the command line arguments (sys.argv).
+  /// Text that the script prints is returned in \a outputText and \a errorText.
+  /// Returns the exit status of the script.
+  typedef int (*PythonScriptExecutorFunction)(const std::vector<std::string>& arguments,
+                                              std::string& outputText, std::string& errorText);
+
+  /// Set the function used for running scripted CLIs in the application process.
+  /// It is set by the application when Python is enabled.
+  /// \sa SetRunPythonInProcess()
+  static void SetPythonScriptExecutor(PythonScriptExecutorFunction executor);
+  static PythonScriptExecutorFunction GetPythonScriptExecutor();
+
+  /// Run scripted CLIs (command line modules implemented as a Python script)
+  /// in the Python interpreter of the application instead of starting a Python
+  /// process for each execution. Images are passed through the "slicer:" scheme,
+  /// which reads and writes the volume nodes directly (for example with SimpleITK),
+  /// other data through temporary files. The interpreter can only be used from
+  /// the main thread, therefore Apply() runs these modules synchronously, as ApplyAndWait().
+  /// It has no effect if no Python script executor is set. Disabled by default.
+  /// \sa SetPythonScriptExecutor()
+  void SetRunPythonInProcess(int value);
+  int GetRunPythonInProcess() const;
+
   /// For debugging, control redirection of cout and cerr
   virtual void RedirectModuleStreamsOn();
   virtual void RedirectModuleStreamsOff();
@@ -146,6 +205,11 @@ protected:
   // The method that runs the command line module
   void ApplyTask(void *clientdata);
 
+  /// Return true if the module is a scripted CLI that runs in the Python
+  /// interpreter of the application.
+  /// \sa SetRunPythonInProcess()
+  bool IsRunningPythonInProcess(const ModuleDescription& moduleDescription) const;
+
   // Communicate progress back to the node
   static void ProgressCallback(void *);
 
@@ -26,6 +26,7 @@
 #include "qSlicerAbstractCoreModule.h"
 #include "qSlicerAbstractModuleRepresentation.h"
 #include "qSlicerCoreApplication.h"
+#include "qSlicerStartupTrace.h"
 
 // SlicerLogic includes
 #include "vtkSlicerModuleLogic.h"
@@ -251,6 +252,7 @@ qSlicerAbstractModuleRepresentation* qSlicerAbstractCoreModule::createNewWidgetR
   Q_ASSERT(currentLogic == this->logic());
 #endif
 
+  qSlicerStartupTraceScope traceScope("Create widget representation", "Widgets", this->name());
   qSlicerAbstractModuleRepresentation *newWidgetRepresentation;
   newWidgetRepresentation = this->createWidgetRepresentation();
 
@@ -282,6 +284,7 @@ vtkMRMLAbstractLogic* qSlicerAbstractCoreModule::logic()
     return d->Logic;
     }
   // Attempt to create a logic object
+  qSlicerStartupTraceScope traceScope("Create logic", "Logic", this->name());
   d->Logic.TakeReference(this->createLogic());
 
   // If createLogic return a valid object, set its Scene and AppLogic
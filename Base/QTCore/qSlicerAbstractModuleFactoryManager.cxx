@@ -25,6 +25,7 @@
 #include "qSlicerCoreApplication.h"
 #include "qSlicerAbstractModuleFactoryManager.h"
 #include "qSlicerAbstractCoreModule.h"
+#include "qSlicerStartupTrace.h"
 
 // STD includes
 #include <csignal>
@@ -254,6 +255,7 @@ void qSlicerAbstractModuleFactoryManager::registerModules()
   // \todo: don't support factories other than filebased factories
   foreach(qSlicerModuleFactory* factory, d->notFileBasedFactories())
     {
+    qSlicerStartupTraceScope traceScope("Register factory items", "Registration");
     factory->registerItems();
     foreach(const QString& moduleName, factory->itemKeys())
       {
@@ -280,6 +282,7 @@ void qSlicerAbstractModuleFactoryManager::registerModules()
 //-----------------------------------------------------------------------------
 void qSlicerAbstractModuleFactoryManager::registerModules(const QString& path)
 {
+  qSlicerStartupTraceScope traceScope(QString("Register modules in %1").arg(path), "Registration");
   QDir directory(path);
   /// \tbd recursive search ?
   foreach (const QFileInfo& file,
@@ -400,6 +403,7 @@ qSlicerAbstractCoreModule* qSlicerAbstractModuleFactoryManager
     qCritical() << "Fail to instantiate module " << moduleName << " (not registered)";
     return nullptr;
     }
+  qSlicerStartupTraceScope traceScope("Instantiate module", "Instantiation", moduleName);
   qSlicerAbstractCoreModule* module = factory->instantiate(moduleName);
   if (!module)
     {
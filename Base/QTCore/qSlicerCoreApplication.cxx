@@ -72,6 +72,7 @@
 #include "qSlicerLoadableModuleFactory.h"
 #include "qSlicerModuleFactoryManager.h"
 #include "qSlicerModuleManager.h"
+#include "qSlicerStartupTrace.h"
 #include "qSlicerUtils.h"
 
 // SlicerLogic includes
@@ -211,6 +212,14 @@ void qSlicerCoreApplicationPrivate::init()
 
   this->parseArguments();
 
+  // Startup steps are recorded from here until the startup is completed
+  // (see qSlicerApplicationHelper::postInitializeApplication)
+  if (!q->coreCommandOptions()->startupTraceFile().isEmpty())
+    {
+    qSlicerStartupTrace::instance()->setEnabled(true);
+    }
+  qSlicerStartupTrace::instance()->beginEvent("Initialize core application");
+
   this->SlicerHome = this->discoverSlicerHomeDirectory();
 
   // Save the environment if no launcher is used (this is for example the case
@@ -293,6 +302,7 @@ void qSlicerCoreApplicationPrivate::init()
     }
 
   // Create the application Logic object,
+  qSlicerStartupTrace::instance()->beginEvent("Create application logic");
   this->AppLogic = vtkSmartPointer<vtkSlicerApplicationLogic>::New();
   this->AppLogic->SetTemporaryPath(q->temporaryPath().toUtf8());
   vtkPersonInformation* userInfo = this->AppLogic->GetUserInformation();
@@ -334,12 +344,16 @@ void qSlicerCoreApplicationPrivate::init()
   //this->AppLogic->ProcessMRMLEvents(scene, vtkCommand::ModifiedEvent, nullptr);
   //this->AppLogic->SetAndObserveMRMLScene(scene);
   this->AppLogic->CreateProcessingThread();
+  qSlicerStartupTrace::instance()->endEvent();
 
   // Set up Slicer to use the system proxy
   QNetworkProxyFactory::setUseSystemConfiguration(true);
 
   // Set up Data IO
+  {
+  qSlicerStartupTraceScope traceScope("Initialize data IO");
   this->initDataIO();
+  }
 
   // Create MRML scene
   vtkNew<vtkMRMLScene> scene;
@@ -359,6 +373,7 @@ void qSlicerCoreApplicationPrivate::init()
     {
     if (q->corePythonManager())
       {
+      qSlicerStartupTraceScope traceScope("Initialize Python", "Python");
       q->corePythonManager()->mainContext(); // Initialize python
       q->corePythonManager()->setSystemExitExceptionHandlerEnabled(true);
       q->connect(q->corePythonManager(), SIGNAL(systemExitExceptionRaised(int)),
@@ -369,6 +384,7 @@ void qSlicerCoreApplicationPrivate::init()
 
 #ifdef Slicer_BUILD_EXTENSIONMANAGER_SUPPORT
 
+  qSlicerStartupTrace::instance()->beginEvent("Update extensions");
   qSlicerExtensionsManagerModel * model = new qSlicerExtensionsManagerModel(q);
   model->setExtensionsSettingsFilePath(q->slicerRevisionUserSettingsFilePath());
   model->setExtensionsHistorySettingsFilePath(q->slicerUserSettingsFilePath());
@@ -398,6 +414,7 @@ void qSlicerCoreApplicationPrivate::init()
     {
     qDebug() << "Successfully uninstalled extension" << extensionName;
     }
+  qSlicerStartupTrace::instance()->endEvent();
 
 #endif
 
@@ -408,6 +425,8 @@ void qSlicerCoreApplicationPrivate::init()
     }
 
   q->connect(q, SIGNAL(aboutToQuit()), q, SLOT(onAboutToQuit()));
+
+  qSlicerStartupTrace::instance()->endEvent();
 }
 
 //-----------------------------------------------------------------------------
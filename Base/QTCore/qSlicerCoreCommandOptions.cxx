@@ -308,6 +308,13 @@ bool qSlicerCoreCommandOptions::verboseModuleDiscovery() const
   return d->ParsedArgs.value("verbose-module-discovery").toBool();
 }
 
+//-----------------------------------------------------------------------------
+QString qSlicerCoreCommandOptions::startupTraceFile()const
+{
+  Q_D(const qSlicerCoreCommandOptions);
+  return d->ParsedArgs.value("startup-trace").toString();
+}
+
 //-----------------------------------------------------------------------------
 bool qSlicerCoreCommandOptions::verbose()const
 {
@@ -457,6 +464,10 @@ void qSlicerCoreCommandOptions::addArguments()
   this->addArgument("verbose-module-discovery", "", QVariant::Bool,
                     "Enable verbose output during module discovery process.");
 
+  this->addArgument("startup-trace", "", QVariant::String,
+                    "Record the duration of the startup steps and write them to the specified file "
+                    "in Chrome trace event format. Time spent in each module is printed on the terminal.");
+
   this->addArgument("disable-settings", "", QVariant::Bool,
                     "Start application ignoring user settings and using new temporary settings.");
 
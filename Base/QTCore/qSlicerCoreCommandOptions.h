@@ -157,6 +157,11 @@ public:
   /// Return True if slicer should display details regarding the module discovery process
   bool verboseModuleDiscovery()const;
 
+  /// Return the file where the startup timing trace should be written (in Chrome trace
+  /// event format). If empty, startup timing is not recorded.
+  /// \sa qSlicerStartupTrace
+  QString startupTraceFile()const;
+
   /// Return True if slicer should display information at startup
   bool verbose()const;
 
@@ -21,6 +21,7 @@
 // Qt includes
 #include <QDebug>
 #include <QFileInfo>
+#include <QTimer>
 
 // CTK includes
 #include <ctkUtils.h>
@@ -40,6 +41,7 @@
 
 // VTK includes
 #include <vtkCollection.h>
+#include <vtkDataIOManager.h>
 #include <vtkDataFileFormatHelper.h> // for GetFileExtensionFromFormatString()
 #include <vtkNew.h>
 #include <vtkStringArray.h>
@@ -63,6 +65,9 @@ public:
   QMap<qSlicerIO::IOFileType, QStringList> FileTypes;
 
   QString DefaultSceneFileType;
+
+  /// Polls background writes while some are pending
+  QTimer BackgroundWriteTimer;
 };
 
 //-----------------------------------------------------------------------------
@@ -188,6 +193,9 @@ qSlicerCoreIOManager::qSlicerCoreIOManager(QObject* _parent)
   :QObject(_parent)
   , d_ptr(new qSlicerCoreIOManagerPrivate)
 {
+  Q_D(qSlicerCoreIOManager);
+  d->BackgroundWriteTimer.setInterval(100);
+  connect(&d->BackgroundWriteTimer, SIGNAL(timeout()), this, SLOT(processBackgroundWrites()));
 }
 
 //-----------------------------------------------------------------------------
@@ -674,9 +682,36 @@ bool qSlicerCoreIOManager::saveNodes(qSlicerIO::IOFileType fileType,
     return false;
     }
 
+  vtkMRMLScene* scene = d->currentScene();
+  if (scene && scene->GetDataIOManager()
+    && scene->GetDataIOManager()->GetNumberOfPendingBackgroundWrites() > 0
+    && !d->BackgroundWriteTimer.isActive())
+    {
+    d->BackgroundWriteTimer.start();
+    }
+
   return true;
 }
 
+//-----------------------------------------------------------------------------
+void qSlicerCoreIOManager::processBackgroundWrites()
+{
+  Q_D(qSlicerCoreIOManager);
+  vtkMRMLScene* scene = d->currentScene();
+  vtkDataIOManager* dataIOManager = scene ? scene->GetDataIOManager() : nullptr;
+  if (!dataIOManager)
+    {
+    d->BackgroundWriteTimer.stop();
+    return;
+    }
+  dataIOManager->ProcessBackgroundWrites();
+  if (dataIOManager->GetNumberOfPendingBackgroundWrites() == 0)
+    {
+    d->BackgroundWriteTimer.stop();
+    emit backgroundWritesFinished();
+    }
+}
+
 //-----------------------------------------------------------------------------
 bool qSlicerCoreIOManager::saveScene(const QString& fileName, QImage screenShot)
 {
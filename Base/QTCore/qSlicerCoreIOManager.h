@@ -182,8 +182,18 @@ public slots:
   /// or "Medical Reality Bundle (.mrb)").
   void setDefaultSceneFileType(QString);
 
+  /// Update the nodes written in the background by writers (see the
+  /// "writeInBackground" property of qSlicerNodeWriter).
+  /// Called periodically while background writes are pending.
+  /// \sa vtkDataIOManager::ProcessBackgroundWrites()
+  void processBackgroundWrites();
+
 signals:
 
+  /// This signal is emitted when all the nodes written in the background
+  /// are saved. Errors are reported in the user messages of their storage node.
+  void backgroundWritesFinished();
+
   /// This signal is emitted each time a file is loaded using loadNodes()
   /// The \a loadedFileParameters QVariant map contains the parameters
   /// passed to the reader and also the \a fileType and \a nodeIDs keys respectively
@@ -26,6 +26,7 @@
 #include <QNetworkRequest>
 #include <QNetworkReply>
 #include <QScopedPointer>
+#include <QSet>
 #include <QSettings>
 #include <QStandardItemModel>
 #include <QTemporaryFile>
@@ -184,6 +185,13 @@ public:
   QString extractArchive(const QDir& extensionsDir, const QString &archiveFile);
 
   qSlicerExtensionDownloadTask* downloadExtension(const QString& extensionId);
+  qSlicerExtensionDownloadTask* downloadExtension(const ExtensionMetadataType& extensionMetadata);
+
+  /// Remove \a task from the active tasks and, if it is part of the current
+  /// batch installation, record whether the extension was \a installed.
+  void finishInstallTask(qSlicerExtensionDownloadTask* task, bool installed);
+  void finishBatchInstallItem(const QString& extensionId, const QString& extensionName, bool installed);
+  void startBatchInstallDownload(const QString& extensionId, const ExtensionMetadataType& serverMetadata);
 
   /// Update (reinstall) specified extension.
   ///
@@ -224,6 +232,9 @@ public:
 
   qSlicerExtensionsManagerModel::ExtensionMetadataType retrieveExtensionMetadata(
     const qMidasAPI::ParametersType& parameters);
+  QString midasResponseCacheKey(const qMidasAPI::ParametersType& parameters)const;
+  /// Convert metadata received from the server to extension description keys.
+  ExtensionMetadataType extensionDescriptionMetadata(const ExtensionMetadataType& serverMetadata)const;
 
   void initializeColumnIdToNameMap(int columnIdx, const char* columnName);
   QHash<int, QString> ColumnIdToName;
@@ -255,6 +266,15 @@ public:
   QMap<QString, ExtensionMetadataType> MidasResponseCache;
 
   QMap<qSlicerExtensionDownloadTask*, QString> ActiveTasks;
+
+  // Batch installation: metadata queries and downloads of all the extensions
+  // are issued at once, extensions are installed as their download completes.
+  qMidasAPI BatchInstallMetadataApi;
+  QHash<QUuid, QString> BatchInstallMetadataRequests;
+  QHash<qSlicerExtensionDownloadTask*, QString> BatchInstallTasks;
+  QSet<QString> BatchInstallPendingExtensionIds;
+  QStringList BatchInstalledExtensions;
+  QStringList BatchFailedExtensionIds;
 };
 
 // --------------------------------------------------------------------------
@@ -318,6 +338,14 @@ void qSlicerExtensionsManagerModelPrivate::init()
   QObject::connect(&this->CheckForUpdatesApi,
                    SIGNAL(errorReceived(QUuid,QString)),
                    q, SLOT(onUpdateCheckFailed(QUuid)));
+
+  QObject::connect(&this->BatchInstallMetadataApi,
+                   SIGNAL(resultReceived(QUuid,QList<QVariantMap>)),
+                   q, SLOT(onBatchInstallMetadataReceived(QUuid,QList<QVariantMap>)));
+
+  QObject::connect(&this->BatchInstallMetadataApi,
+                   SIGNAL(errorReceived(QUuid,QString)),
+                   q, SLOT(onBatchInstallMetadataFailed(QUuid)));
 }
 
 // --------------------------------------------------------------------------
@@ -990,11 +1018,7 @@ qSlicerExtensionsManagerModel::ExtensionMetadataType qSlicerExtensionsManagerMod
 
   ExtensionMetadataType result;
 
-  QString midasResponseCacheKey = q->serverUrl().toString();
-  foreach(const QString & parametersName, parameters.keys())
-    {
-    midasResponseCacheKey += ";" + parameters[parametersName];
-    }
+  const QString midasResponseCacheKey = this->midasResponseCacheKey(parameters);
   if (this->MidasResponseCache.contains(midasResponseCacheKey))
     {
     result = this->MidasResponseCache[midasResponseCacheKey];
@@ -1054,13 +1078,34 @@ qSlicerExtensionsManagerModel::ExtensionMetadataType qSlicerExtensionsManagerMod
     this->MidasResponseCache[midasResponseCacheKey] = result;
     }
 
+  return this->extensionDescriptionMetadata(result);
+}
+
+// --------------------------------------------------------------------------
+QString qSlicerExtensionsManagerModelPrivate::midasResponseCacheKey(
+  const qMidasAPI::ParametersType& parameters)const
+{
+  Q_Q(const qSlicerExtensionsManagerModel);
+  QString key = q->serverUrl().toString();
+  foreach(const QString & parametersName, parameters.keys())
+    {
+    key += ";" + parameters[parametersName];
+    }
+  return key;
+}
+
+// --------------------------------------------------------------------------
+qSlicerExtensionsManagerModel::ExtensionMetadataType
+qSlicerExtensionsManagerModelPrivate::extensionDescriptionMetadata(
+  const ExtensionMetadataType& serverMetadata)const
+{
+  Q_Q(const qSlicerExtensionsManagerModel);
   ExtensionMetadataType updatedExtensionMetadata;
-  foreach(const QString& key, result.keys())
+  foreach(const QString& key, serverMetadata.keys())
     {
     updatedExtensionMetadata.insert(
-      q->serverToExtensionDescriptionKey().value(key, key), result.value(key));
+      q->serverToExtensionDescriptionKey().value(key, key), serverMetadata.value(key));
     }
-
   return updatedExtensionMetadata;
 }
 
@@ -1380,6 +1425,15 @@ qSlicerExtensionsManagerModelPrivate::downloadExtension(
     {
     return nullptr;
     }
+  return this->downloadExtension(extensionMetadata);
+}
+
+// --------------------------------------------------------------------------
+qSlicerExtensionDownloadTask*
+qSlicerExtensionsManagerModelPrivate::downloadExtension(
+  const ExtensionMetadataType& extensionMetadata)
+{
+  Q_Q(qSlicerExtensionsManagerModel);
 
   QString itemId = extensionMetadata["item_id"].toString();
 
@@ -1454,7 +1508,7 @@ void qSlicerExtensionsManagerModel::onInstallDownloadFinished(
   if (reply->error())
     {
     d->critical(QString("Failed downloading: %1").arg(downloadUrl.toString()));
-    d->ActiveTasks.remove(task);
+    d->finishInstallTask(task, false);
     return;
     }
 
@@ -1464,15 +1518,160 @@ void qSlicerExtensionsManagerModel::onInstallDownloadFinished(
   if (!file.open())
     {
     d->critical(QString("Could not create temporary file for writing: %1").arg(file.errorString()));
-    d->ActiveTasks.remove(task);
+    d->finishInstallTask(task, false);
     return;
     }
   file.write(reply->readAll());
   file.close();
   const ExtensionMetadataType& extensionMetadata =
     this->filterExtensionMetadata(task->metadata());
-  this->installExtension(extensionName, extensionMetadata, file.fileName());
-  d->ActiveTasks.remove(task);
+  const bool installed = this->installExtension(extensionName, extensionMetadata, file.fileName());
+  d->finishInstallTask(task, installed);
+}
+
+// --------------------------------------------------------------------------
+bool qSlicerExtensionsManagerModel::downloadAndInstallExtensions(const QStringList& extensionIds)
+{
+  Q_D(qSlicerExtensionsManagerModel);
+  QString error;
+  if (!d->checkExtensionSettingsPermissions(error))
+    {
+    d->critical(error);
+    return false;
+    }
+
+  d->BatchInstallMetadataApi.setServerUrl(this->serverUrl().toString());
+
+  QHash<QString, ExtensionMetadataType> cachedMetadata;
+  foreach(const QString& extensionId, extensionIds)
+    {
+    if (extensionId.isEmpty() || d->BatchInstallPendingExtensionIds.contains(extensionId))
+      {
+      continue;
+      }
+    d->BatchInstallPendingExtensionIds.insert(extensionId);
+
+    qMidasAPI::ParametersType parameters;
+    parameters["extension_id"] = extensionId;
+    const QString cacheKey = d->midasResponseCacheKey(parameters);
+    if (d->MidasResponseCache.contains(cacheKey))
+      {
+      cachedMetadata.insert(extensionId, d->MidasResponseCache[cacheKey]);
+      continue;
+      }
+
+    // Metadata of all the extensions are queried concurrently
+    const QUuid& requestId =
+      d->BatchInstallMetadataApi.get("midas.slicerpackages.extension.list", parameters);
+    d->BatchInstallMetadataRequests.insert(requestId, extensionId);
+    }
+
+  foreach(const QString& extensionId, cachedMetadata.keys())
+    {
+    d->startBatchInstallDownload(extensionId, cachedMetadata[extensionId]);
+    }
+
+  if (d->BatchInstallPendingExtensionIds.isEmpty())
+    {
+    emit this->extensionsInstallFinished(QStringList(), QStringList());
+    }
+  return true;
+}
+
+// --------------------------------------------------------------------------
+void qSlicerExtensionsManagerModel::onBatchInstallMetadataReceived(
+  const QUuid& requestId, const QList<QVariantMap>& results)
+{
+  Q_D(qSlicerExtensionsManagerModel);
+
+  const QString extensionId = d->BatchInstallMetadataRequests.take(requestId);
+  if (extensionId.isEmpty())
+    {
+    return;
+    }
+
+  if (results.count() != 1
+      || !qSlicerExtensionsManagerModelPrivate::validateExtensionMetadata(results.first()))
+    {
+    d->critical(QString("Failed to retrieve metadata for extension %1").arg(extensionId));
+    d->finishBatchInstallItem(extensionId, QString(), false);
+    return;
+    }
+
+  qMidasAPI::ParametersType parameters;
+  parameters["extension_id"] = extensionId;
+  d->MidasResponseCache[d->midasResponseCacheKey(parameters)] = results.first();
+
+  d->startBatchInstallDownload(extensionId, results.first());
+}
+
+// --------------------------------------------------------------------------
+void qSlicerExtensionsManagerModelPrivate::startBatchInstallDownload(
+  const QString& extensionId, const ExtensionMetadataType& serverMetadata)
+{
+  Q_Q(qSlicerExtensionsManagerModel);
+
+  // Downloads are all started at once, the network access manager
+  // limits the number of simultaneous connections to the server.
+  qSlicerExtensionDownloadTask* const task =
+    this->downloadExtension(this->extensionDescriptionMetadata(serverMetadata));
+  this->BatchInstallTasks.insert(task, extensionId);
+  QObject::connect(task, SIGNAL(finished(qSlicerExtensionDownloadTask*)),
+                   q, SLOT(onInstallDownloadFinished(qSlicerExtensionDownloadTask*)));
+  QObject::connect(task, SIGNAL(progress(qSlicerExtensionDownloadTask*, qint64, qint64)),
+                   q, SLOT(onInstallDownloadProgress(qSlicerExtensionDownloadTask*, qint64, qint64)));
+}
+
+// --------------------------------------------------------------------------
+void qSlicerExtensionsManagerModel::onBatchInstallMetadataFailed(const QUuid& requestId)
+{
+  Q_D(qSlicerExtensionsManagerModel);
+  const QString extensionId = d->BatchInstallMetadataRequests.take(requestId);
+  if (extensionId.isEmpty())
+    {
+    return;
+    }
+  d->critical(QString("Failed to retrieve metadata for extension %1").arg(extensionId));
+  d->finishBatchInstallItem(extensionId, QString(), false);
+}
+
+// --------------------------------------------------------------------------
+void qSlicerExtensionsManagerModelPrivate::finishInstallTask(
+  qSlicerExtensionDownloadTask* task, bool installed)
+{
+  this->ActiveTasks.remove(task);
+  if (this->BatchInstallTasks.contains(task))
+    {
+    this->finishBatchInstallItem(this->BatchInstallTasks.take(task), task->extensionName(), installed);
+    }
+}
+
+// --------------------------------------------------------------------------
+void qSlicerExtensionsManagerModelPrivate::finishBatchInstallItem(
+  const QString& extensionId, const QString& extensionName, bool installed)
+{
+  Q_Q(qSlicerExtensionsManagerModel);
+  if (!this->BatchInstallPendingExtensionIds.remove(extensionId))
+    {
+    return;
+    }
+  if (installed)
+    {
+    this->BatchInstalledExtensions << extensionName;
+    }
+  else
+    {
+    this->BatchFailedExtensionIds << extensionId;
+    }
+  if (!this->BatchInstallPendingExtensionIds.isEmpty())
+    {
+    return;
+    }
+  const QStringList installedExtensions = this->BatchInstalledExtensions;
+  const QStringList failedExtensionIds = this->BatchFailedExtensionIds;
+  this->BatchInstalledExtensions.clear();
+  this->BatchFailedExtensionIds.clear();
+  emit q->extensionsInstallFinished(installedExtensions, failedExtensionIds);
 }
 
 // --------------------------------------------------------------------------
@@ -1789,6 +1988,16 @@ void qSlicerExtensionsManagerModel::onUpdateCheckComplete(
 
     const QString& extensionId =
       extensionMetadata.value("extension_id").toString();
+
+    // Cache the response so that downloading the update does not query
+    // the server again
+    if (!extensionId.isEmpty()
+        && qSlicerExtensionsManagerModelPrivate::validateExtensionMetadata(extensionMetadata))
+      {
+      qMidasAPI::ParametersType parameters;
+      parameters["extension_id"] = extensionId;
+      d->MidasResponseCache[d->midasResponseCacheKey(parameters)] = extensionMetadata;
+      }
     const QString& extensionRevision =
       extensionMetadata.value("revision").toString();
 
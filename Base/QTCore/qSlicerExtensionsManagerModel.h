@@ -267,6 +267,13 @@ public slots:
   /// \sa installExtension, scheduleExtensionForUninstall, uninstallScheduledExtensions
   bool downloadAndInstallExtension(const QString& extensionId);
 
+  /// \brief Download and install all the \a extensionIds
+  /// The metadata of all the extensions are queried and the archives are downloaded
+  /// concurrently, each extension is installed as soon as its archive is downloaded.
+  /// extensionsInstallFinished() is emitted once all the extensions are processed.
+  /// \sa downloadAndInstallExtension
+  bool downloadAndInstallExtensions(const QStringList& extensionIds);
+
   /// \brief Schedule \a extensionName of uninstall
   /// Tell the application to uninstall \a extensionName when it will restart
   /// An extension scheduled for uninstall can be effectively uninstalled by calling
@@ -363,6 +370,9 @@ signals:
 
   void extensionInstalled(const QString& extensionName);
 
+  /// Emitted when all the extensions requested by downloadAndInstallExtensions() are processed.
+  void extensionsInstallFinished(const QStringList& installedExtensions, const QStringList& failedExtensionIds);
+
   void extensionUpdated(const QString& extensionName);
 
   void extensionScheduledForUninstall(const QString& extensionName);
@@ -415,6 +425,11 @@ protected slots:
                              const QList<QVariantMap>& results);
   void onUpdateCheckFailed(const QUuid& requestId);
 
+  /// \sa downloadAndInstallExtensions
+  void onBatchInstallMetadataReceived(const QUuid& requestId,
+                                      const QList<QVariantMap>& results);
+  void onBatchInstallMetadataFailed(const QUuid& requestId);
+
 protected:
   QScopedPointer<qSlicerExtensionsManagerModelPrivate> d_ptr;
 
@@ -21,6 +21,7 @@
 // Slicer includes
 #include "qSlicerModuleFactoryManager.h"
 #include "qSlicerAbstractCoreModule.h"
+#include "qSlicerStartupTrace.h"
 
 #include "vtkSlicerConfigure.h" // XXX For modulePaths() function.
 
@@ -165,11 +166,17 @@ bool qSlicerModuleFactoryManager::loadModule(const QString& name, const QString&
       }
     }
 
+  // Dependencies are recorded as separate events
+  qSlicerStartupTraceScope traceScope("Load module", "Loading", name);
+
   // Update internal Map
   d->LoadedModules << name;
 
   // Initialize module
+  {
+  qSlicerStartupTraceScope initializeTraceScope("Initialize module", "Loading", name);
   instance->initialize(d->AppLogic);
+  }
 
   // Check the module has a title (required)
   if (instance->title().isEmpty())
@@ -180,7 +187,10 @@ bool qSlicerModuleFactoryManager::loadModule(const QString& name, const QString&
     }
 
   // Set the MRML scene
+  {
+  qSlicerStartupTraceScope sceneTraceScope("Set module scene", "Loading", name);
   instance->setMRMLScene(d->MRMLScene);
+  }
 
   // Module should also be aware if current MRML scene has changed
   this->connect(this,SIGNAL(mrmlSceneChanged(vtkMRMLScene*)),
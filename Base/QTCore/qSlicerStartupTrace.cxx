@@ -0,0 +1,209 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Copyright (c) Kitware Inc.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// Qt includes
+#include <QCoreApplication>
+#include <QDebug>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+#include <QTextStream>
+
+// STD includes
+#include <algorithm>
+
+// Slicer includes
+#include "qSlicerStartupTrace.h"
+
+//-----------------------------------------------------------------------------
+qSlicerStartupTrace::qSlicerStartupTrace()
+  : Enabled(false)
+{
+}
+
+//-----------------------------------------------------------------------------
+qSlicerStartupTrace* qSlicerStartupTrace::instance()
+{
+  static qSlicerStartupTrace trace;
+  return &trace;
+}
+
+//-----------------------------------------------------------------------------
+void qSlicerStartupTrace::setEnabled(bool enabled)
+{
+  if (enabled && !this->Enabled)
+    {
+    this->Timer.start();
+    }
+  this->Enabled = enabled;
+}
+
+//-----------------------------------------------------------------------------
+bool qSlicerStartupTrace::isEnabled()const
+{
+  return this->Enabled;
+}
+
+//-----------------------------------------------------------------------------
+void qSlicerStartupTrace::beginEvent(const QString& name, const QString& category,
+                                     const QString& moduleName)
+{
+  if (!this->Enabled)
+    {
+    return;
+    }
+  Event event;
+  event.Name = name;
+  event.Category = category;
+  event.ModuleName = moduleName;
+  event.Start = this->Timer.nsecsElapsed() / 1000;
+  event.Duration = -1;
+  event.Parent = this->Stack.isEmpty() ? -1 : this->Stack.last();
+  this->Events << event;
+  this->Stack << this->Events.count() - 1;
+}
+
+//-----------------------------------------------------------------------------
+void qSlicerStartupTrace::endEvent()
+{
+  if (!this->Enabled || this->Stack.isEmpty())
+    {
+    return;
+    }
+  Event& event = this->Events[this->Stack.takeLast()];
+  event.Duration = this->Timer.nsecsElapsed() / 1000 - event.Start;
+}
+
+//-----------------------------------------------------------------------------
+void qSlicerStartupTrace::clear()
+{
+  this->Events.clear();
+  this->Stack.clear();
+}
+
+//-----------------------------------------------------------------------------
+bool qSlicerStartupTrace::writeChromeTrace(const QString& fileName)const
+{
+  const qint64 now = this->Timer.isValid() ? this->Timer.nsecsElapsed() / 1000 : 0;
+  const qint64 pid = QCoreApplication::applicationPid();
+  QJsonArray traceEvents;
+  foreach(const Event& event, this->Events)
+    {
+    QJsonObject traceEvent;
+    traceEvent["name"] = event.Name;
+    traceEvent["cat"] = event.Category.isEmpty() ? QString("Startup") : event.Category;
+    // Complete event. Events that are still running are written until now.
+    traceEvent["ph"] = "X";
+    traceEvent["ts"] = event.Start;
+    traceEvent["dur"] = event.Duration >= 0 ? event.Duration : now - event.Start;
+    traceEvent["pid"] = pid;
+    traceEvent["tid"] = 0;
+    if (!event.ModuleName.isEmpty())
+      {
+      QJsonObject args;
+      args["module"] = event.ModuleName;
+      traceEvent["args"] = args;
+      }
+    traceEvents.append(traceEvent);
+    }
+  QJsonObject trace;
+  trace["traceEvents"] = traceEvents;
+  trace["displayTimeUnit"] = "ms";
+
+  QSaveFile file(fileName);
+  if (!file.open(QIODevice::WriteOnly))
+    {
+    qWarning() << "Failed to write startup trace file" << fileName << ":" << file.errorString();
+    return false;
+    }
+  file.write(QJsonDocument(trace).toJson(QJsonDocument::Compact));
+  return file.commit();
+}
+
+//-----------------------------------------------------------------------------
+QString qSlicerStartupTrace::moduleCostSummary()const
+{
+  // Time spent in nested events of the same module is counted only once
+  // (in the outermost event), time spent in other modules is subtracted.
+  QHash<QString, qint64> moduleCosts;
+  for (int eventIndex = 0; eventIndex < this->Events.count(); ++eventIndex)
+    {
+    const Event& event = this->Events[eventIndex];
+    if (event.ModuleName.isEmpty() || event.Duration < 0)
+      {
+      continue;
+      }
+    int parentIndex = event.Parent;
+    while (parentIndex >= 0 && this->Events[parentIndex].ModuleName.isEmpty())
+      {
+      parentIndex = this->Events[parentIndex].Parent;
+      }
+    if (parentIndex >= 0)
+      {
+      const QString& parentModuleName = this->Events[parentIndex].ModuleName;
+      if (parentModuleName == event.ModuleName)
+        {
+        continue;
+        }
+      moduleCosts[parentModuleName] -= event.Duration;
+      }
+    moduleCosts[event.ModuleName] += event.Duration;
+    }
+
+  QList<QPair<qint64, QString> > sortedCosts;
+  for (QHash<QString, qint64>::const_iterator it = moduleCosts.constBegin(); it != moduleCosts.constEnd(); ++it)
+    {
+    sortedCosts << qMakePair(it.value(), it.key());
+    }
+  std::sort(sortedCosts.begin(), sortedCosts.end(),
+            [](const QPair<qint64, QString>& a, const QPair<qint64, QString>& b) { return a.first > b.first; });
+
+  QString summary;
+  QTextStream stream(&summary);
+  stream << "Startup time per module (ms):\n";
+  for (int index = 0; index < sortedCosts.count(); ++index)
+    {
+    stream << "  " << QString::number(sortedCosts[index].first / 1000.0, 'f', 1).rightJustified(9)
+           << "  " << sortedCosts[index].second << "\n";
+    }
+  return summary;
+}
+
+//-----------------------------------------------------------------------------
+qSlicerStartupTraceScope::qSlicerStartupTraceScope(const QString& name, const QString& category,
+                                                   const QString& moduleName)
+{
+  qSlicerStartupTrace* trace = qSlicerStartupTrace::instance();
+  // Keep track of whether the event was started, in case recording is enabled
+  // or disabled while the scope is active.
+  this->Started = trace->isEnabled();
+  if (this->Started)
+    {
+    trace->beginEvent(name, category, moduleName);
+    }
+}
+
+//-----------------------------------------------------------------------------
+qSlicerStartupTraceScope::~qSlicerStartupTraceScope()
+{
+  if (this->Started)
+    {
+    qSlicerStartupTrace::instance()->endEvent();
+    }
+}
@@ -0,0 +1,116 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Copyright (c) Kitware Inc.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#ifndef __qSlicerStartupTrace_h
+#define __qSlicerStartupTrace_h
+
+// Qt includes
+#include <QElapsedTimer>
+#include <QList>
+#include <QString>
+
+#include "qSlicerBaseQTCoreExport.h"
+
+/// \brief Records the duration of the application startup phases.
+///
+/// Recording is disabled by default, and enabled by the "--startup-trace" command line
+/// option (\sa qSlicerCoreCommandOptions::startupTraceFile()). When disabled, beginEvent()
+/// and endEvent() return immediately.
+///
+/// Events can be nested: an event started while another event is running is recorded as its child.
+/// The recorded events can be written in the Chrome trace event format (can be viewed in
+/// chrome://tracing or https://ui.perfetto.dev) and summarized per module to find
+/// the modules that slow down the startup.
+///
+/// Events are expected to be recorded in the main thread.
+///
+/// \sa qSlicerStartupTraceScope
+class Q_SLICER_BASE_QTCORE_EXPORT qSlicerStartupTrace
+{
+public:
+  typedef qSlicerStartupTrace Self;
+
+  /// Return the application wide instance
+  static qSlicerStartupTrace* instance();
+
+  /// Enable recording. The reference time of the events is reset
+  /// if recording was disabled.
+  void setEnabled(bool enabled);
+  bool isEnabled()const;
+
+  /// Start an event. If \a moduleName is not empty then the duration of the event
+  /// (excluding the duration of nested events of the same module) is added to the
+  /// cost of the module. \sa moduleCostSummary()
+  void beginEvent(const QString& name, const QString& category = QString(),
+                  const QString& moduleName = QString());
+  /// Stop the last started event
+  void endEvent();
+
+  /// Remove all recorded events
+  void clear();
+
+  /// Write the recorded events to \a fileName in Chrome trace event (JSON) format.
+  /// Returns false if the file could not be written.
+  bool writeChromeTrace(const QString& fileName)const;
+
+  /// Return a text table of the total time spent in each module (in milliseconds),
+  /// slowest module first.
+  QString moduleCostSummary()const;
+
+protected:
+  qSlicerStartupTrace();
+
+  struct Event
+    {
+    QString Name;
+    QString Category;
+    QString ModuleName;
+    /// Start time and duration in microseconds
+    qint64 Start;
+    qint64 Duration;
+    /// Index of the parent event, -1 for top-level events
+    int Parent;
+    };
+
+  bool Enabled;
+  QElapsedTimer Timer;
+  QList<Event> Events;
+  /// Indices of the running events
+  QList<int> Stack;
+};
+
+/// \brief Records a startup event while the object is in scope.
+///
+/// \code
+/// {
+///   qSlicerStartupTraceScope traceScope("Load module", "Modules", moduleName);
+///   ...
+/// }
+/// \endcode
+class Q_SLICER_BASE_QTCORE_EXPORT qSlicerStartupTraceScope
+{
+public:
+  qSlicerStartupTraceScope(const QString& name, const QString& category = QString(),
+                           const QString& moduleName = QString());
+  ~qSlicerStartupTraceScope();
+
+private:
+  bool Started;
+  Q_DISABLE_COPY(qSlicerStartupTraceScope);
+};
+
+#endif
@@ -70,6 +70,7 @@
 #include "qSlicerLayoutManager.h"
 #include "qSlicerModuleFactoryManager.h"
 #include "qSlicerModuleManager.h"
+#include "qSlicerStartupTrace.h"
 #ifdef Slicer_USE_PYTHONQT
 # include "qSlicerPythonManager.h"
 # include "qSlicerSettingsPythonPanel.h"
@@ -221,6 +222,7 @@ void qSlicerApplicationPrivate::init()
     QPalette palette = qSlicerApplication::application()->palette();
     q->pythonConsole()->setWelcomeTextColor(palette.color(QPalette::Disabled, QPalette::WindowText));
     q->pythonConsole()->setPromptColor(palette.color(QPalette::Highlight));
+    qSlicerStartupTraceScope traceScope("Initialize Python console", "Python");
     q->pythonConsole()->initialize(q->pythonManager());
     QStringList autocompletePreferenceList;
     autocompletePreferenceList
@@ -40,19 +40,19 @@ bool qSlicerCommandOptions::disableToolTips()const
 //-----------------------------------------------------------------------------
 bool qSlicerCommandOptions::noSplash() const
 {
-  return this->parsedArgs().value("no-splash").toBool();
+  return this->parsedArgs().value("no-splash").toBool() || this->headless();
 }
 
 //-----------------------------------------------------------------------------
 bool qSlicerCommandOptions::noMainWindow() const
 {
-  return this->parsedArgs().value("no-main-window").toBool();
+  return this->parsedArgs().value("no-main-window").toBool() || this->headless();
 }
 
 //-----------------------------------------------------------------------------
 bool qSlicerCommandOptions::showPythonInteractor() const
 {
-  return this->parsedArgs().value("show-python-interactor").toBool();
+  return this->parsedArgs().value("show-python-interactor").toBool() && !this->headless();
 }
 
 //-----------------------------------------------------------------------------
@@ -71,6 +71,12 @@ bool qSlicerCommandOptions::exitAfterStartup()const
   return this->parsedArgs().value("exit-after-startup").toBool();
 }
 
+//-----------------------------------------------------------------------------
+bool qSlicerCommandOptions::headless()const
+{
+  return this->parsedArgs().value("headless").toBool();
+}
+
 //-----------------------------------------------------------------------------
 void qSlicerCommandOptions::addArguments()
 {
@@ -100,4 +106,8 @@ void qSlicerCommandOptions::addArguments()
 
   this->addArgument("exit-after-startup", "", QVariant::Bool,
                     "Exit after startup is complete. Useful for measuring startup time");
+
+  this->addArgument("headless", "", QVariant::Bool,
+                    "Run without main window, splash screen and views, for batch processing of a Python script "
+                    "(see slicer.batch). Implies --no-main-window and --no-splash.");
 }
@@ -37,6 +37,7 @@ class Q_SLICER_BASE_QTGUI_EXPORT qSlicerCommandOptions : public qSlicerCoreComma
   Q_PROPERTY(bool showPythonInteractor READ showPythonInteractor CONSTANT)
   Q_PROPERTY(bool enableQtTesting READ enableQtTesting CONSTANT)
   Q_PROPERTY(bool exitAfterStartup READ exitAfterStartup CONSTANT)
+  Q_PROPERTY(bool headless READ headless CONSTANT)
 public:
   typedef qSlicerCoreCommandOptions Superclass;
   qSlicerCommandOptions();
@@ -54,6 +55,11 @@ public:
 
   bool exitAfterStartup()const;
 
+  /// Return True if the application runs for batch processing: no main window, no splash
+  /// screen and no Python interactor. As no views are created, no displayable managers are
+  /// instantiated. Implies noMainWindow() and noSplash().
+  bool headless()const;
+
 protected:
   void addArguments() override;
 
@@ -415,52 +415,56 @@ void qSlicerExtensionsRestoreWidgetPrivate
 void qSlicerExtensionsRestoreWidgetPrivate
 ::startDownloadAndInstallExtensions(QStringList extensionIds)
 {
+  Q_Q(qSlicerExtensionsRestoreWidget);
+  if (!q->extensionsManagerModel())
+    {
+    // extensions manager model is not set yet
+    qWarning() << Q_FUNC_INFO << " failed: extensions manager model is invalid";
+    return;
+    }
+
   this->extensionsToInstall = extensionIds;
   this->nrOfExtensionsToInstall = extensionsToInstall.size();
-  this->currentExtensionToInstall = -1;
+  // Number of extensions installed so far
+  this->currentExtensionToInstall = 0;
 
   this->progressBar->setMaximum(this->nrOfExtensionsToInstall);
   this->progressDialog->setMaximum(this->nrOfExtensionsToInstall);
 
-  downloadAndInstallNextExtension();
+  // All the extensions are downloaded concurrently,
+  // finishDownloadAndInstallExtensions is called once they are all processed.
+  if (!q->extensionsManagerModel()->downloadAndInstallExtensions(extensionIds))
+    {
+    this->finishDownloadAndInstallExtensions();
+    }
 }
 
 // --------------------------------------------------------------------------
 void qSlicerExtensionsRestoreWidgetPrivate
-::downloadAndInstallNextExtension()
+::finishDownloadAndInstallExtensions()
 {
-  Q_Q(qSlicerExtensionsRestoreWidget);
-  if (!q->extensionsManagerModel())
-    {
-    // extensions manager model is not set yet
-    qWarning() << Q_FUNC_INFO << " failed: extensions manager model is invalid";
-    return;
-    }
-  this->currentExtensionToInstall++;
-  if (this->currentExtensionToInstall >=0 && this->currentExtensionToInstall < this->nrOfExtensionsToInstall)
+  this->currentExtensionToInstall = -1;
+  if (this->headlessMode)
     {
-    q->extensionsManagerModel()->downloadAndInstallExtension(extensionsToInstall.at(currentExtensionToInstall));
+    this->progressDialog->close();
+    this->headlessMode = false;
+    static_cast<qSlicerApplication*>qApp->confirmRestart(
+          qSlicerExtensionsRestoreWidget::tr("All extensions restored. Please restart Slicer."));
     }
   else
     {
-    if (this->headlessMode)
-      {
-      this->progressDialog->close();
-      this->headlessMode = false;
-      static_cast<qSlicerApplication*>qApp->confirmRestart(
-            qSlicerExtensionsRestoreWidget::tr("All extensions restored. Please restart Slicer."));
-      }
-    else
-      {
-      setupList();
-      }
+    setupList();
     }
 }
+
 // --------------------------------------------------------------------------
 void qSlicerExtensionsRestoreWidgetPrivate
 ::downloadProgress(const QString& extensionName, qint64 received, qint64 total)
 {
-  int value = float(currentExtensionToInstall) + (float(received) / float(total));
+  Q_UNUSED(received);
+  Q_UNUSED(total);
+  // Extensions are downloaded concurrently, progress is the number of installed extensions
+  int value = this->currentExtensionToInstall;
   if (this->headlessMode)
     {
     this->progressDialog->setValue(value);
@@ -555,6 +559,7 @@ void qSlicerExtensionsRestoreWidget
 
   disconnect(this, SLOT(onProgressChanged(QString, qint64, qint64)));
   disconnect(this, SLOT(onInstallationFinished(QString)));
+  disconnect(this, SLOT(onAllInstallationsFinished()));
   disconnect(this, SLOT(onExtensionHistoryGatheredOnStartup(QVariantMap)));
   d->ExtensionsManagerModel = model;
   d->setupList();
@@ -565,6 +570,8 @@ void qSlicerExtensionsRestoreWidget
       this, SLOT(onProgressChanged(QString, qint64, qint64)));
     connect(model, SIGNAL(extensionInstalled(QString)),
       this, SLOT(onInstallationFinished(QString)));
+    connect(model, SIGNAL(extensionsInstallFinished(QStringList, QStringList)),
+      this, SLOT(onAllInstallationsFinished()));
     connect(model, SIGNAL(extensionHistoryGatheredOnStartup(QVariantMap)),
       this, SLOT(onExtensionHistoryGatheredOnStartup(QVariantMap)));
     }
@@ -656,7 +663,33 @@ void qSlicerExtensionsRestoreWidget
 {
   Q_UNUSED(extensionName);
   Q_D(qSlicerExtensionsRestoreWidget);
-  d->downloadAndInstallNextExtension();
+  if (d->currentExtensionToInstall < 0)
+    {
+    // installation is not in progress
+    return;
+    }
+  d->currentExtensionToInstall++;
+  if (d->headlessMode)
+    {
+    d->progressDialog->setValue(d->currentExtensionToInstall);
+    }
+  else
+    {
+    d->progressBar->setValue(d->currentExtensionToInstall);
+    }
+}
+
+// --------------------------------------------------------------------------
+void qSlicerExtensionsRestoreWidget
+::onAllInstallationsFinished()
+{
+  Q_D(qSlicerExtensionsRestoreWidget);
+  if (d->currentExtensionToInstall < 0)
+    {
+    // installation is not in progress
+    return;
+    }
+  d->finishDownloadAndInstallExtensions();
 }
 
 void qSlicerExtensionsRestoreWidget
@@ -59,6 +59,7 @@ protected slots :
   void onSilentInstallOnStartupChanged(int state);
   void onProgressChanged(const QString& extensionName, qint64 received, qint64 total);
   void onInstallationFinished(QString extensionName);
+  void onAllInstallationsFinished();
   void onExtensionHistoryGatheredOnStartup(const QVariantMap&);
 
 protected:
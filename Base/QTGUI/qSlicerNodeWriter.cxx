@@ -31,6 +31,7 @@
 #include "qSlicerCoreIOManager.h"
 
 // MRML includes
+#include <vtkDataIOManager.h>
 #include <vtkMRMLScene.h>
 #include <vtkMRMLStorableNode.h>
 #include <vtkMRMLStorageNode.h>
@@ -159,7 +160,17 @@ bool qSlicerNodeWriter::write(const qSlicerIO::IOProperties& properties)
       snode->SetCompressionParameter(properties["compressionParameter"].toString().toStdString());
       }
     }
-  bool res = snode->WriteData(node);
+  bool res = false;
+  vtkDataIOManager* dataIOManager = this->mrmlScene() ? this->mrmlScene()->GetDataIOManager() : nullptr;
+  if (properties.value("writeInBackground", false).toBool() && dataIOManager
+    && dataIOManager->WriteDataInBackground(node, snode))
+    {
+    res = true;
+    }
+  else
+    {
+    res = snode->WriteData(node);
+    }
 
   if (res)
     {
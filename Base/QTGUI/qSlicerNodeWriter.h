@@ -60,6 +60,10 @@ public:
 
   /// Write the node referenced by "nodeID" into the "fileName" file.
   /// Optionally, "useCompression" can be specified.
+  /// If "writeInBackground" is true and the storage node supports it, the
+  /// data is written on a worker thread from a snapshot of the node and
+  /// the node is reported as written once the snapshot is taken.
+  /// \sa vtkDataIOManager::WriteDataInBackground()
   /// Return true on success, false otherwise.
   /// Create a storage node if the storable node doesn't have any.
   bool write(const qSlicerIO::IOProperties& properties) override;
@@ -928,6 +928,9 @@ bool qSlicerSaveDataDialogPrivate::saveNodes()
     savingParameters["nodeID"] = QString(node->GetID());
     savingParameters["fileName"] = file.absoluteFilePath();
     savingParameters["fileFormat"] = format;
+    // Large volumes and models can be written on worker threads, the
+    // application remains responsive while they are written.
+    savingParameters["writeInBackground"] = QSettings().value("Save/WriteInBackground", false).toBool();
 
     QApplication::setOverrideCursor(QCursor(Qt::BusyCursor));
     bool success = coreIOManager->saveNodes(fileType, savingParameters);
@@ -0,0 +1,80 @@
+
+#! Usage:
+#! \code
+#! slicer_add_performance_test(<testname> [DRIVER_TESTNAME <testname>] [BASELINE <file>] [argument1 ...])
+#! \endcode
+#!
+#! This macro adds a test the same way as simple_test() and marks it as a performance test:
+#!
+#! - the test is associated with the "Performance" label (in addition to the ${KIT} label),
+#!   therefore all performance tests can be run by "ctest -L Performance" or excluded by
+#!   "ctest -LE Performance".
+#! - the test is run serially, so that measurements are not disturbed by other tests.
+#! - the BASELINE file path (by default ${CMAKE_CURRENT_SOURCE_DIR}/Baseline/<testname>.json) is
+#!   passed to the test as last argument.
+#! - the SLICER_PERFORMANCE_TEST_TOLERANCE environment variable is set to the value of
+#!   Slicer_PERFORMANCE_TEST_TOLERANCE (by default 1.0).
+#!
+#! The test is expected to report its measurements as DartMeasurements and to fail if a measurement
+#! is larger than baseline * (1 + tolerance). See vtkMRMLCoreTestingUtilities::PerformanceMeasurements.
+#!
+#! If the baseline file does not exist, a "no baseline, comparison skipped" message is printed at
+#! configure time and by the test, and CTest reports the test as skipped instead of passed.
+#!
+#! Baselines depend on the machine, they are generated on the reference machine by configuring
+#! with Slicer_PERFORMANCE_TEST_GENERATE_BASELINES=ON and running "ctest -L Performance": each test
+#! then writes its measurements into its BASELINE file (the
+#! SLICER_PERFORMANCE_TEST_GENERATE_BASELINE environment variable is set) instead of comparing them.
+#! The generated files are then committed next to the tests.
+#!
+#! \sa simple_test
+#!
+#! \ingroup CMakeUtilities
+macro(slicer_add_performance_test testname)
+  set(options
+    )
+  set(oneValueArgs
+    DRIVER_TESTNAME
+    BASELINE
+    )
+  set(multiValueArgs
+    )
+  cmake_parse_arguments(MY_PERFORMANCE_TEST
+    "${options}"
+    "${oneValueArgs}"
+    "${multiValueArgs}"
+    ${ARGN}
+    )
+
+  if("${MY_PERFORMANCE_TEST_DRIVER_TESTNAME}" STREQUAL "")
+    set(MY_PERFORMANCE_TEST_DRIVER_TESTNAME ${testname})
+  endif()
+
+  if("${MY_PERFORMANCE_TEST_BASELINE}" STREQUAL "")
+    set(MY_PERFORMANCE_TEST_BASELINE ${CMAKE_CURRENT_SOURCE_DIR}/Baseline/${testname}.json)
+  endif()
+
+  if("${Slicer_PERFORMANCE_TEST_TOLERANCE}" STREQUAL "")
+    set(Slicer_PERFORMANCE_TEST_TOLERANCE 1.0)
+  endif()
+
+  set(_performance_test_generate_baseline 0)
+  if(Slicer_PERFORMANCE_TEST_GENERATE_BASELINES)
+    set(_performance_test_generate_baseline 1)
+  elseif(NOT EXISTS ${MY_PERFORMANCE_TEST_BASELINE})
+    message(STATUS "Performance test ${testname}: no baseline, comparison skipped"
+      " (${MY_PERFORMANCE_TEST_BASELINE} not found)")
+  endif()
+
+  simple_test(${testname} DRIVER_TESTNAME ${MY_PERFORMANCE_TEST_DRIVER_TESTNAME}
+    ${MY_PERFORMANCE_TEST_UNPARSED_ARGUMENTS} ${MY_PERFORMANCE_TEST_BASELINE})
+  set_property(TEST ${testname} APPEND PROPERTY LABELS Performance)
+  set_property(TEST ${testname} PROPERTY RUN_SERIAL TRUE)
+  set_property(TEST ${testname} APPEND PROPERTY ENVIRONMENT
+    "SLICER_PERFORMANCE_TEST_TOLERANCE=${Slicer_PERFORMANCE_TEST_TOLERANCE}"
+    "SLICER_PERFORMANCE_TEST_GENERATE_BASELINE=${_performance_test_generate_baseline}")
+  if(NOT CMAKE_VERSION VERSION_LESS "3.16")
+    # A baseline may be added without re-configuring, so the test output is checked
+    set_property(TEST ${testname} PROPERTY SKIP_REGULAR_EXPRESSION "no baseline, comparison skipped")
+  endif()
+endmacro()
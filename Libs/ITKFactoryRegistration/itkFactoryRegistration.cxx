@@ -5,6 +5,24 @@
 #include <itkImageFileReader.h>
 #include <itkTransformFileReader.h>
 
+// Slicer includes
+#include "itkSharedMemoryImageIOFactory.h"
+
+namespace
+{
+// Registered in addition to the ITK factories so that command line module
+// executables can read and write images exchanged through shared memory.
+class SharedMemoryImageIOFactoryRegistration
+{
+public:
+  SharedMemoryImageIOFactoryRegistration()
+  {
+    itk::SharedMemoryImageIOFactory::RegisterOneFactory();
+  }
+};
+SharedMemoryImageIOFactoryRegistration SharedMemoryImageIOFactoryRegistrationInstance;
+}
+
 // The following code is required to ensure that the
 // mechanism allowing the ITK factory to be registered is not
 // optimized out by the compiler.
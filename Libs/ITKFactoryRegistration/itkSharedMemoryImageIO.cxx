@@ -0,0 +1,173 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#include "itkSharedMemoryImageIO.h"
+#include "itkSharedMemoryImageSegment.h"
+
+// STD includes
+#include <cstring>
+
+namespace itk
+{
+
+//----------------------------------------------------------------------------
+SharedMemoryImageIO::SharedMemoryImageIO() = default;
+
+//----------------------------------------------------------------------------
+SharedMemoryImageIO::~SharedMemoryImageIO() = default;
+
+//----------------------------------------------------------------------------
+bool SharedMemoryImageIO::SupportsDimension(unsigned long dimension)
+{
+  return dimension >= 1 && dimension <= 3;
+}
+
+//----------------------------------------------------------------------------
+bool SharedMemoryImageIO::CanReadFile(const char* filename)
+{
+  if (!SharedMemoryImageSegment::IsSharedMemoryURI(filename))
+    {
+    return false;
+    }
+  SharedMemoryImageSegment segment;
+  return segment.Open(SharedMemoryImageSegment::GetNameFromURI(filename));
+}
+
+//----------------------------------------------------------------------------
+void SharedMemoryImageIO::ReadImageInformation()
+{
+  SharedMemoryImageSegment segment;
+  if (!segment.Open(SharedMemoryImageSegment::GetNameFromURI(m_FileName)))
+    {
+    itkExceptionMacro("ReadImageInformation: cannot open shared memory segment " << m_FileName);
+    }
+  const SharedMemoryImageSegment::Header* header = segment.GetHeader();
+
+  this->SetNumberOfDimensions(3);
+  for (unsigned int axis = 0; axis < 3; ++axis)
+    {
+    this->SetDimensions(axis, static_cast<SizeValueType>(header->Size[axis]));
+    this->SetSpacing(axis, header->Spacing[axis]);
+    this->SetOrigin(axis, header->Origin[axis]);
+    std::vector<double> direction(3);
+    for (unsigned int row = 0; row < 3; ++row)
+      {
+      direction[row] = header->Direction[row * 3 + axis];
+      }
+    this->SetDirection(axis, direction);
+    }
+
+  this->SetNumberOfComponents(header->NumberOfComponents);
+  this->SetPixelType(header->NumberOfComponents > 1 ? VECTOR : SCALAR);
+  IOComponentType componentType = UNKNOWNCOMPONENTTYPE;
+  switch (header->ComponentType)
+    {
+    case SharedMemoryImageSegment::UInt8: componentType = UCHAR; break;
+    case SharedMemoryImageSegment::Int8: componentType = CHAR; break;
+    case SharedMemoryImageSegment::UInt16: componentType = USHORT; break;
+    case SharedMemoryImageSegment::Int16: componentType = SHORT; break;
+    case SharedMemoryImageSegment::UInt32: componentType = UINT; break;
+    case SharedMemoryImageSegment::Int32: componentType = INT; break;
+    case SharedMemoryImageSegment::UInt64: componentType = ULONGLONG; break;
+    case SharedMemoryImageSegment::Int64: componentType = LONGLONG; break;
+    case SharedMemoryImageSegment::Float32: componentType = FLOAT; break;
+    case SharedMemoryImageSegment::Float64: componentType = DOUBLE; break;
+    default: break;
+    }
+  this->SetComponentType(componentType);
+}
+
+//----------------------------------------------------------------------------
+void SharedMemoryImageIO::Read(void* buffer)
+{
+  SharedMemoryImageSegment segment;
+  if (!segment.Open(SharedMemoryImageSegment::GetNameFromURI(m_FileName)))
+    {
+    itkExceptionMacro("Read: cannot open shared memory segment " << m_FileName);
+    }
+  if (segment.GetHeader()->PixelDataSize != this->GetImageSizeInBytes())
+    {
+    itkExceptionMacro("Read: size of shared memory segment " << m_FileName
+      << " does not match the image information");
+    }
+  memcpy(buffer, segment.GetPixelData(), static_cast<size_t>(segment.GetHeader()->PixelDataSize));
+}
+
+//----------------------------------------------------------------------------
+bool SharedMemoryImageIO::CanWriteFile(const char* filename)
+{
+  return SharedMemoryImageSegment::IsSharedMemoryURI(filename);
+}
+
+//----------------------------------------------------------------------------
+void SharedMemoryImageIO::Write(const void* buffer)
+{
+  unsigned int numberOfDimensions = this->GetNumberOfDimensions();
+  if (!this->SupportsDimension(numberOfDimensions))
+    {
+    itkExceptionMacro("Write: " << numberOfDimensions << "D images are not supported");
+    }
+
+  SharedMemoryImageSegment::Header header;
+  memset(&header, 0, sizeof(header));
+  header.NumberOfComponents = this->GetNumberOfComponents();
+  // Integer types are identified by size, as size of long differs between platforms
+  bool is64Bit = (this->GetComponentSize() == 8);
+  switch (this->GetComponentType())
+    {
+    case UCHAR: header.ComponentType = SharedMemoryImageSegment::UInt8; break;
+    case CHAR: header.ComponentType = SharedMemoryImageSegment::Int8; break;
+    case USHORT: header.ComponentType = SharedMemoryImageSegment::UInt16; break;
+    case SHORT: header.ComponentType = SharedMemoryImageSegment::Int16; break;
+    case UINT:
+    case ULONG:
+    case ULONGLONG:
+      header.ComponentType = is64Bit ? SharedMemoryImageSegment::UInt64 : SharedMemoryImageSegment::UInt32;
+      break;
+    case INT:
+    case LONG:
+    case LONGLONG:
+      header.ComponentType = is64Bit ? SharedMemoryImageSegment::Int64 : SharedMemoryImageSegment::Int32;
+      break;
+    case FLOAT: header.ComponentType = SharedMemoryImageSegment::Float32; break;
+    case DOUBLE: header.ComponentType = SharedMemoryImageSegment::Float64; break;
+    default:
+      itkExceptionMacro("Write: unsupported component type " << this->GetComponentTypeAsString(this->GetComponentType()));
+    }
+
+  for (unsigned int axis = 0; axis < 3; ++axis)
+    {
+    bool imageAxis = (axis < numberOfDimensions);
+    header.Size[axis] = imageAxis ? this->GetDimensions(axis) : 1;
+    header.Spacing[axis] = imageAxis ? this->GetSpacing(axis) : 1.0;
+    header.Origin[axis] = imageAxis ? this->GetOrigin(axis) : 0.0;
+    std::vector<double> direction = imageAxis ? this->GetDirection(axis) : std::vector<double>();
+    for (unsigned int row = 0; row < 3; ++row)
+      {
+      header.Direction[row * 3 + axis] = (row < direction.size()) ? direction[row] : (row == axis ? 1.0 : 0.0);
+      }
+    }
+
+  SharedMemoryImageSegment segment;
+  if (!segment.Create(SharedMemoryImageSegment::GetNameFromURI(m_FileName), header))
+    {
+    itkExceptionMacro("Write: cannot create shared memory segment " << m_FileName);
+    }
+  // The reader removes the segment when it is done with it
+  segment.SetRemoveOnClose(false);
+  memcpy(segment.GetPixelData(), buffer, static_cast<size_t>(segment.GetHeader()->PixelDataSize));
+}
+
+} // end namespace itk
@@ -0,0 +1,85 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#ifndef itkSharedMemoryImageIO_h
+#define itkSharedMemoryImageIO_h
+
+#include "itkFactoryRegistrationConfigure.h"
+
+#include "itkImageIOBase.h"
+
+namespace itk
+{
+/** \class SharedMemoryImageIO
+ * \brief ImageIO object for reading and writing images in shared memory segments
+ *
+ * Slicer passes input and output images of command line module executables
+ * as shared memory segments instead of temporary files when shared memory
+ * transfer is enabled for the module (see vtkSlicerCLIModuleLogic).
+ * The "filename" is an URI:
+ *     <code>slicershm:\<segment name\></code>
+ *
+ * Images of up to 3 dimensions are supported. Written segments are kept
+ * after the executable exits so that Slicer can read them
+ * (see SharedMemoryImageSegment).
+ */
+class ITKFactoryRegistration_EXPORT SharedMemoryImageIO : public ImageIOBase
+{
+public:
+  /** Standard class typedefs. */
+  typedef SharedMemoryImageIO Self;
+  typedef ImageIOBase         Superclass;
+  typedef SmartPointer<Self>  Pointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(SharedMemoryImageIO, ImageIOBase);
+
+  bool SupportsDimension(unsigned long dimension) override;
+
+  /** Determine the file type. Returns true if this ImageIO can read the
+   * file specified. */
+  bool CanReadFile(const char*) override;
+
+  /** Set the spacing and dimension information for the set filename. */
+  void ReadImageInformation() override;
+
+  /** Reads the data from the segment into the memory buffer provided. */
+  void Read(void* buffer) override;
+
+  /** Determine the file type. Returns true if this ImageIO can write the
+   * file specified. */
+  bool CanWriteFile(const char*) override;
+
+  /** Image information is written together with the data. */
+  void WriteImageInformation() override {}
+
+  /** Creates the segment and writes the data from the memory buffer provided. */
+  void Write(const void* buffer) override;
+
+protected:
+  SharedMemoryImageIO();
+  ~SharedMemoryImageIO() override;
+
+private:
+  SharedMemoryImageIO(const Self&) = delete;
+  void operator=(const Self&) = delete;
+};
+
+} // end namespace itk
+
+#endif
@@ -0,0 +1,43 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#include "itkSharedMemoryImageIOFactory.h"
+#include "itkSharedMemoryImageIO.h"
+#include "itkVersion.h"
+
+namespace itk
+{
+SharedMemoryImageIOFactory::SharedMemoryImageIOFactory()
+{
+  this->RegisterOverride("itkImageIOBase",
+                         "itkSharedMemoryImageIO",
+                         "ImageIO to exchange images through shared memory.",
+                         true,
+                         CreateObjectFunction<SharedMemoryImageIO>::New());
+}
+
+SharedMemoryImageIOFactory::~SharedMemoryImageIOFactory() = default;
+
+const char* SharedMemoryImageIOFactory::GetITKSourceVersion() const
+{
+  return ITK_SOURCE_VERSION;
+}
+
+const char* SharedMemoryImageIOFactory::GetDescription() const
+{
+  return "ImageIOFactory that imports/exports images to shared memory segments.";
+}
+
+} // end namespace itk
@@ -0,0 +1,67 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#ifndef itkSharedMemoryImageIOFactory_h
+#define itkSharedMemoryImageIOFactory_h
+
+#include "itkFactoryRegistrationConfigure.h"
+
+#include "itkObjectFactoryBase.h"
+#include "itkImageIOBase.h"
+
+namespace itk
+{
+/** \class SharedMemoryImageIOFactory
+ * \brief Create instances of SharedMemoryImageIO objects using an object factory.
+ */
+class ITKFactoryRegistration_EXPORT SharedMemoryImageIOFactory : public ObjectFactoryBase
+{
+public:
+  /** Standard class typedefs. */
+  typedef SharedMemoryImageIOFactory Self;
+  typedef ObjectFactoryBase          Superclass;
+  typedef SmartPointer<Self>         Pointer;
+  typedef SmartPointer<const Self>   ConstPointer;
+
+  /** Class methods used to interface with the registered factories. */
+  const char* GetITKSourceVersion() const override;
+  const char* GetDescription() const override;
+
+  /** Method for class instantiation. */
+  itkFactorylessNewMacro(Self);
+  static SharedMemoryImageIOFactory* FactoryNew() { return new SharedMemoryImageIOFactory;}
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(SharedMemoryImageIOFactory, ObjectFactoryBase);
+
+  /** Register one factory of this type  */
+  static void RegisterOneFactory()
+  {
+    SharedMemoryImageIOFactory::Pointer factory = SharedMemoryImageIOFactory::New();
+    ObjectFactoryBase::RegisterFactory(factory);
+  }
+
+protected:
+  SharedMemoryImageIOFactory();
+  ~SharedMemoryImageIOFactory() override;
+
+private:
+  SharedMemoryImageIOFactory(const Self&) = delete;
+  void operator=(const Self&) = delete;
+};
+
+} // end namespace itk
+
+#endif
@@ -0,0 +1,331 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#include "itkSharedMemoryImageSegment.h"
+
+// STD includes
+#include <cstring>
+
+#ifdef _WIN32
+# include <windows.h>
+#else
+# include <cerrno>
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <unistd.h>
+#endif
+
+namespace
+{
+const char SharedMemoryImageSegmentSignature[8] = { 'S', 'L', 'C', 'R', 'S', 'H', 'M', '\0' };
+const uint32_t SharedMemoryImageSegmentVersion = 1;
+/// Pixel data is aligned for vectorized access of all component types
+const uint64_t SharedMemoryImageSegmentPixelDataAlignment = 64;
+
+//----------------------------------------------------------------------------
+std::string GetSystemName(const std::string& name)
+{
+#ifdef _WIN32
+  return "Local\\" + name;
+#else
+  return "/" + name;
+#endif
+}
+}
+
+namespace itk
+{
+
+//----------------------------------------------------------------------------
+SharedMemoryImageSegment::SharedMemoryImageSegment() = default;
+
+//----------------------------------------------------------------------------
+SharedMemoryImageSegment::~SharedMemoryImageSegment()
+{
+  this->Close();
+}
+
+//----------------------------------------------------------------------------
+bool SharedMemoryImageSegment::Create(const std::string& name, const Header& header)
+{
+  this->Close();
+  if (name.empty()
+    || SharedMemoryImageSegment::GetComponentSize(header.ComponentType) == 0
+    || header.NumberOfComponents == 0)
+    {
+    return false;
+    }
+
+  Header segmentHeader = header;
+  memcpy(segmentHeader.Signature, SharedMemoryImageSegmentSignature, sizeof(segmentHeader.Signature));
+  segmentHeader.Version = SharedMemoryImageSegmentVersion;
+  segmentHeader.Reserved = 0;
+  segmentHeader.PixelDataOffset = (sizeof(Header) + SharedMemoryImageSegmentPixelDataAlignment - 1)
+    / SharedMemoryImageSegmentPixelDataAlignment * SharedMemoryImageSegmentPixelDataAlignment;
+  segmentHeader.PixelDataSize = SharedMemoryImageSegment::GetPixelDataSize(header);
+  size_t size = static_cast<size_t>(segmentHeader.PixelDataOffset + segmentHeader.PixelDataSize);
+  std::string systemName = GetSystemName(name);
+
+#ifdef _WIN32
+  ULARGE_INTEGER mappingSize;
+  mappingSize.QuadPart = size;
+  HANDLE handle = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+    mappingSize.HighPart, mappingSize.LowPart, systemName.c_str());
+  if (!handle)
+    {
+    return false;
+    }
+  if (GetLastError() == ERROR_ALREADY_EXISTS)
+    {
+    // Another process has a mapping with this name open, its size may be different
+    CloseHandle(handle);
+    return false;
+    }
+  void* address = MapViewOfFile(handle, FILE_MAP_ALL_ACCESS, 0, 0, size);
+  if (!address)
+    {
+    CloseHandle(handle);
+    return false;
+    }
+  this->m_MappingHandle = handle;
+#else
+  int fileDescriptor = shm_open(systemName.c_str(), O_CREAT | O_EXCL | O_RDWR, S_IRUSR | S_IWUSR);
+  if (fileDescriptor < 0 && errno == EEXIST)
+    {
+    // Left over from an earlier run that did not clean up
+    shm_unlink(systemName.c_str());
+    fileDescriptor = shm_open(systemName.c_str(), O_CREAT | O_EXCL | O_RDWR, S_IRUSR | S_IWUSR);
+    }
+  if (fileDescriptor < 0)
+    {
+    return false;
+    }
+  if (ftruncate(fileDescriptor, static_cast<off_t>(size)) != 0)
+    {
+    close(fileDescriptor);
+    shm_unlink(systemName.c_str());
+    return false;
+    }
+  void* address = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fileDescriptor, 0);
+  // the mapping remains valid after the descriptor is closed
+  close(fileDescriptor);
+  if (address == MAP_FAILED)
+    {
+    shm_unlink(systemName.c_str());
+    return false;
+    }
+#endif
+
+  this->m_Address = address;
+  this->m_MappedSize = size;
+  this->m_Name = name;
+  this->m_Created = true;
+  memcpy(this->m_Address, &segmentHeader, sizeof(Header));
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool SharedMemoryImageSegment::Open(const std::string& name)
+{
+  this->Close();
+  if (name.empty())
+    {
+    return false;
+    }
+  std::string systemName = GetSystemName(name);
+
+#ifdef _WIN32
+  HANDLE handle = OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, systemName.c_str());
+  if (!handle)
+    {
+    return false;
+    }
+  void* address = MapViewOfFile(handle, FILE_MAP_ALL_ACCESS, 0, 0, 0);
+  if (!address)
+    {
+    CloseHandle(handle);
+    return false;
+    }
+  MEMORY_BASIC_INFORMATION memoryInfo;
+  if (VirtualQuery(address, &memoryInfo, sizeof(memoryInfo)) == 0)
+    {
+    UnmapViewOfFile(address);
+    CloseHandle(handle);
+    return false;
+    }
+  this->m_MappingHandle = handle;
+  size_t size = static_cast<size_t>(memoryInfo.RegionSize);
+#else
+  int fileDescriptor = shm_open(systemName.c_str(), O_RDWR, 0);
+  if (fileDescriptor < 0)
+    {
+    return false;
+    }
+  struct stat status;
+  if (fstat(fileDescriptor, &status) != 0 || status.st_size < static_cast<off_t>(sizeof(Header)))
+    {
+    close(fileDescriptor);
+    return false;
+    }
+  size_t size = static_cast<size_t>(status.st_size);
+  void* address = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fileDescriptor, 0);
+  close(fileDescriptor);
+  if (address == MAP_FAILED)
+    {
+    return false;
+    }
+#endif
+
+  this->m_Address = address;
+  this->m_MappedSize = size;
+  this->m_Name = name;
+  this->m_Created = false;
+
+  // Validate the header
+  const Header* header = this->GetHeader();
+  if (size < sizeof(Header)
+    || memcmp(header->Signature, SharedMemoryImageSegmentSignature, sizeof(header->Signature)) != 0
+    || header->Version != SharedMemoryImageSegmentVersion
+    || SharedMemoryImageSegment::GetComponentSize(header->ComponentType) == 0
+    || header->PixelDataSize != SharedMemoryImageSegment::GetPixelDataSize(*header)
+    || header->PixelDataOffset < sizeof(Header)
+    || header->PixelDataOffset + header->PixelDataSize > size)
+    {
+    this->Close();
+    return false;
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+void SharedMemoryImageSegment::Close()
+{
+  if (this->m_Address)
+    {
+#ifdef _WIN32
+    UnmapViewOfFile(this->m_Address);
+    CloseHandle(this->m_MappingHandle);
+    this->m_MappingHandle = nullptr;
+#else
+    munmap(this->m_Address, this->m_MappedSize);
+#endif
+    }
+  if (this->m_Created && this->m_RemoveOnClose)
+    {
+    SharedMemoryImageSegment::Remove(this->m_Name);
+    }
+  this->m_Address = nullptr;
+  this->m_MappedSize = 0;
+  this->m_Created = false;
+  this->m_Name.clear();
+}
+
+//----------------------------------------------------------------------------
+SharedMemoryImageSegment::Header* SharedMemoryImageSegment::GetHeader()
+{
+  return static_cast<Header*>(this->m_Address);
+}
+
+//----------------------------------------------------------------------------
+void* SharedMemoryImageSegment::GetPixelData()
+{
+  if (!this->m_Address)
+    {
+    return nullptr;
+    }
+  return static_cast<char*>(this->m_Address) + this->GetHeader()->PixelDataOffset;
+}
+
+//----------------------------------------------------------------------------
+bool SharedMemoryImageSegment::Remove(const std::string& name)
+{
+  if (name.empty())
+    {
+    return false;
+    }
+#ifdef _WIN32
+  // File mappings are removed when the last handle is closed
+  return true;
+#else
+  return shm_unlink(GetSystemName(name).c_str()) == 0 || errno == ENOENT;
+#endif
+}
+
+//----------------------------------------------------------------------------
+const char* SharedMemoryImageSegment::GetURIScheme()
+{
+  return "slicershm:";
+}
+
+//----------------------------------------------------------------------------
+bool SharedMemoryImageSegment::IsSharedMemoryURI(const char* uri)
+{
+  if (!uri)
+    {
+    return false;
+    }
+  const char* scheme = SharedMemoryImageSegment::GetURIScheme();
+  size_t schemeLength = strlen(scheme);
+  return strncmp(uri, scheme, schemeLength) == 0 && strlen(uri) > schemeLength;
+}
+
+//----------------------------------------------------------------------------
+std::string SharedMemoryImageSegment::GetNameFromURI(const std::string& uri)
+{
+  if (!SharedMemoryImageSegment::IsSharedMemoryURI(uri.c_str()))
+    {
+    return std::string();
+    }
+  return uri.substr(strlen(SharedMemoryImageSegment::GetURIScheme()));
+}
+
+//----------------------------------------------------------------------------
+std::string SharedMemoryImageSegment::GetURIFromName(const std::string& name)
+{
+  return std::string(SharedMemoryImageSegment::GetURIScheme()) + name;
+}
+
+//----------------------------------------------------------------------------
+bool SharedMemoryImageSegment::SegmentsOutliveCreator()
+{
+#ifdef _WIN32
+  return false;
+#else
+  return true;
+#endif
+}
+
+//----------------------------------------------------------------------------
+size_t SharedMemoryImageSegment::GetComponentSize(unsigned int componentType)
+{
+  switch (componentType)
+    {
+    case UInt8: case Int8: return 1;
+    case UInt16: case Int16: return 2;
+    case UInt32: case Int32: case Float32: return 4;
+    case UInt64: case Int64: case Float64: return 8;
+    default: return 0;
+    }
+}
+
+//----------------------------------------------------------------------------
+uint64_t SharedMemoryImageSegment::GetPixelDataSize(const Header& header)
+{
+  return header.Size[0] * header.Size[1] * header.Size[2] * header.NumberOfComponents
+    * SharedMemoryImageSegment::GetComponentSize(header.ComponentType);
+}
+
+} // end namespace itk
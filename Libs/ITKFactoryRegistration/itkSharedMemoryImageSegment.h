@@ -0,0 +1,140 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#ifndef itkSharedMemoryImageSegment_h
+#define itkSharedMemoryImageSegment_h
+
+#include "itkFactoryRegistrationConfigure.h"
+
+// STD includes
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace itk
+{
+/** \class SharedMemoryImageSegment
+ * \brief Named shared memory block that holds a header and the voxels of an image.
+ *
+ * The segment is used for exchanging images between Slicer and command line
+ * module executables without writing files. It is a POSIX shared memory object
+ * (shm_open) or a Windows file mapping, referred to by an URI:
+ *     <code>slicershm:\<segment name\></code>
+ *
+ * Geometry is stored in LPS coordinate system, as in ITK images. Voxels are
+ * stored in the same order as in ITK and VTK image buffers, starting
+ * at PixelDataOffset.
+ *
+ * On Windows a file mapping is destroyed when the last process that has it open
+ * closes it, therefore a segment cannot outlive its creator there
+ * (see SegmentsOutliveCreator()).
+ */
+class ITKFactoryRegistration_EXPORT SharedMemoryImageSegment
+{
+public:
+  enum ComponentType
+    {
+    UnknownComponentType = 0,
+    UInt8,
+    Int8,
+    UInt16,
+    Int16,
+    UInt32,
+    Int32,
+    UInt64,
+    Int64,
+    Float32,
+    Float64
+    };
+
+  struct Header
+    {
+    char Signature[8];
+    uint32_t Version;
+    uint32_t ComponentType;
+    uint32_t NumberOfComponents;
+    uint32_t Reserved;
+    uint64_t Size[3];
+    double Spacing[3];
+    double Origin[3];
+    /// Row-major matrix, columns are the directions of the image axes
+    double Direction[9];
+    uint64_t PixelDataOffset;
+    uint64_t PixelDataSize;
+    };
+
+  SharedMemoryImageSegment();
+  ~SharedMemoryImageSegment();
+
+  /** Create a new segment. ComponentType, NumberOfComponents, Size and geometry
+   * are taken from the header, offset and size of the pixel data are computed.
+   * An existing segment with the same name is replaced.
+   * Returns false on failure. */
+  bool Create(const std::string& name, const Header& header);
+
+  /** Open an existing segment and validate its header. Returns false on failure. */
+  bool Open(const std::string& name);
+
+  /** Unmap the segment. A segment created by this object is removed, too,
+   * if RemoveOnClose is enabled. */
+  void Close();
+
+  bool IsOpen() const { return this->m_Address != nullptr; }
+
+  /** Remove the segment on Close() if it was created by this object (default: true).
+   * Disable it when the segment must be available after this process exits. */
+  void SetRemoveOnClose(bool remove) { this->m_RemoveOnClose = remove; }
+  bool GetRemoveOnClose() const { return this->m_RemoveOnClose; }
+
+  const std::string& GetName() const { return this->m_Name; }
+  Header* GetHeader();
+  void* GetPixelData();
+
+  /** Remove a segment by name. Returns true if the segment did not exist or was removed.
+   * Processes that have the segment open can keep using it. */
+  static bool Remove(const std::string& name);
+
+  /** Returns "slicershm:" */
+  static const char* GetURIScheme();
+  static bool IsSharedMemoryURI(const char* uri);
+  static std::string GetNameFromURI(const std::string& uri);
+  static std::string GetURIFromName(const std::string& name);
+
+  /** Returns true if a segment is kept after the process that created it exits. */
+  static bool SegmentsOutliveCreator();
+
+  /** Size of a component in bytes, 0 for unknown types */
+  static size_t GetComponentSize(unsigned int componentType);
+
+  /** Size of the pixel data described by the header, in bytes */
+  static uint64_t GetPixelDataSize(const Header& header);
+
+private:
+  SharedMemoryImageSegment(const SharedMemoryImageSegment&) = delete;
+  void operator=(const SharedMemoryImageSegment&) = delete;
+
+  std::string m_Name;
+  void* m_Address{nullptr};
+  size_t m_MappedSize{0};
+  bool m_Created{false};
+  bool m_RemoveOnClose{true};
+#ifdef _WIN32
+  void* m_MappingHandle{nullptr};
+#endif
+};
+
+} // end namespace itk
+
+#endif
@@ -14,6 +14,7 @@
 #include "vtkArchive.h"
 
 // VTK includes
+#include <vtkNew.h>
 
 // VTKSYS includes
 #include <vtksys/SystemTools.hxx>
@@ -166,6 +167,29 @@ int vtkArchiveTest1(int argc, char * argv[] )
     std::cerr << "failed to extract archive : " << "extractedArchiveTest" << std::endl;
     return EXIT_FAILURE;
     }
+  vtksys::SystemTools::ChangeDirectory("..");
+
+  //
+  // Create a zip file entry by entry, removing the files as they are added
+  //
+  std::cout << "creating streamedArchiveTest.zip" << std::endl;
+  std::string streamedZipFilePath = vtksys::SystemTools::GetCurrentWorkingDirectory() +
+                                                    std::string("/streamedArchiveTest.zip");
+  std::string extractedDirPath = vtksys::SystemTools::GetCurrentWorkingDirectory() +
+                                                    std::string("/extractedArchiveTest/archiveTest");
+  vtkNew<vtkArchive> archive;
+  archive->SetCompressionLevel(1);
+  CHECK_BOOL(archive->OpenZip(streamedZipFilePath.c_str()), true);
+  CHECK_BOOL(archive->AddFileToZip(zipFilePath.c_str(), "nested/archiveTest.zip"), true);
+  CHECK_BOOL(archive->AddDirectoryContentToZip(extractedDirPath.c_str(), true), true);
+  CHECK_BOOL(archive->CloseZip(), true);
+  CHECK_BOOL(vtksys::SystemTools::FileExists(extractedDirPath + "/vol.mrml"), false);
+
+  if (!vtkArchive::ListArchive(streamedZipFilePath.c_str(), files) || files.size() != 4)
+    {
+    std::cerr << "failed to list streamed archive: " << streamedZipFilePath << std::endl;
+    return EXIT_FAILURE;
+    }
 
   return EXIT_SUCCESS;
 }
@@ -0,0 +1,114 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2005 Brigham and Women's Hospital (BWH)
+  All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Program:   3D Slicer
+
+=========================================================================auto=*/
+
+// MRML includes
+#include "vtkCacheManager.h"
+#include "vtkMRMLCoreTestingMacros.h"
+#include "vtkMRMLScene.h"
+
+// VTK includes
+#include <vtkNew.h>
+
+// VTKsys includes
+#include <vtksys/SystemTools.hxx>
+
+// STD includes
+#include <fstream>
+
+namespace
+{
+
+//---------------------------------------------------------------------------
+std::string WriteCachedFile(const std::string& cacheDir, const std::string& name, size_t size)
+{
+  std::string fileName = cacheDir + "/" + name;
+  std::ofstream file(fileName.c_str(), std::ios::binary);
+  file << std::string(size, 'x');
+  return fileName;
+}
+
+} // end of anonymous namespace
+
+//---------------------------------------------------------------------------
+int vtkCacheManagerTest1(int argc, char * argv[])
+{
+  if (argc != 2)
+    {
+    std::cerr << "Line " << __LINE__
+              << " - Missing parameters !\n"
+              << "Usage: " << argv[0] << " /path/to/temp"
+              << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  std::string cacheDir = std::string(argv[1]) + "/vtkCacheManagerTest1";
+  vtksys::SystemTools::RemoveADirectory(cacheDir);
+  vtksys::SystemTools::MakeDirectory(cacheDir);
+
+  // Files that are in the cache before the index is created are indexed
+  WriteCachedFile(cacheDir, "old.nrrd", 500000);
+
+  vtkNew<vtkMRMLScene> scene;
+  std::string fileA;
+  std::string fileB;
+  {
+    vtkNew<vtkCacheManager> cacheManager;
+    cacheManager->SetRemoteCacheDirectory(cacheDir.c_str());
+    CHECK_INT(static_cast<int>(cacheManager->GetCachedFiles().size()), 1);
+    CHECK_BOOL(vtksys::SystemTools::FileExists(cacheDir + "/" + vtkCacheManager::GetCacheIndexFileName()), true);
+
+    fileA = WriteCachedFile(cacheDir, "a.nrrd", 1000000);
+    cacheManager->AddToCacheIndex("http://host/a.nrrd", fileA.c_str(), "\"etag-a\"", nullptr);
+    vtksys::SystemTools::Delay(10);
+    fileB = WriteCachedFile(cacheDir, "b.nrrd", 1000000);
+    cacheManager->AddToCacheIndex("http://host/b.nrrd", fileB.c_str(), nullptr, "Wed, 21 Oct 2015 07:28:00 GMT");
+    CHECK_INT(static_cast<int>(cacheManager->GetCachedFiles().size()), 3);
+    CHECK_STD_STRING(cacheManager->GetCachedFileETag("http://host/a.nrrd"), "\"etag-a\"");
+    CHECK_STD_STRING(cacheManager->GetCachedFileLastModified("http://host/b.nrrd"), "Wed, 21 Oct 2015 07:28:00 GMT");
+    CHECK_STD_STRING(cacheManager->GetCachedFileETag("http://host/unknown.nrrd"), "");
+    CHECK_BOOL(cacheManager->GetCurrentCacheSize() > 2.49f && cacheManager->GetCurrentCacheSize() < 2.51f, true);
+  }
+
+  {
+    // The index is read from the cache directory
+    vtkNew<vtkCacheManager> cacheManager;
+    cacheManager->SetMRMLScene(scene.GetPointer());
+    cacheManager->SetRemoteCacheDirectory(cacheDir.c_str());
+    CHECK_INT(static_cast<int>(cacheManager->GetCachedFiles().size()), 3);
+    CHECK_STD_STRING(cacheManager->GetCachedFileETag("http://host/a.nrrd"), "\"etag-a\"");
+
+    // Nothing is removed if the cache is not full
+    cacheManager->SetRemoteCacheLimit(10);
+    cacheManager->SetRemoteCacheFreeBufferSize(1);
+    CHECK_INT(cacheManager->RemoveLeastRecentlyUsedFiles(), 0);
+
+    // Least recently used files are removed first
+    vtksys::SystemTools::Delay(10);
+    cacheManager->MarkCachedFileAccessed(fileA.c_str());
+    cacheManager->SetRemoteCacheLimit(1);
+    cacheManager->SetRemoteCacheFreeBufferSize(0);
+    CHECK_INT(cacheManager->RemoveLeastRecentlyUsedFiles(), 2);
+    CHECK_BOOL(vtksys::SystemTools::FileExists(cacheDir + "/old.nrrd"), false);
+    CHECK_BOOL(vtksys::SystemTools::FileExists(fileB), false);
+    CHECK_BOOL(vtksys::SystemTools::FileExists(fileA), true);
+    CHECK_INT(static_cast<int>(cacheManager->GetCachedFiles().size()), 1);
+    CHECK_STD_STRING(cacheManager->GetCachedFileLastModified("http://host/b.nrrd"), "");
+
+    // Clearing the cache clears the index
+    cacheManager->ClearCache();
+    CHECK_INT(static_cast<int>(cacheManager->GetCachedFiles().size()), 0);
+    CHECK_BOOL(cacheManager->GetCurrentCacheSize() == 0.0f, true);
+  }
+
+  vtksys::SystemTools::RemoveADirectory(cacheDir);
+  return EXIT_SUCCESS;
+}
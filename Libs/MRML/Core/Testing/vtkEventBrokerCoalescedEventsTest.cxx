@@ -0,0 +1,159 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2016 Brigham and Women's Hospital (BWH)
+  All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Program:   3D Slicer
+
+=========================================================================auto=*/
+
+#include "vtkEventBroker.h"
+#include "vtkMRMLModelNode.h"
+#include "vtkMRMLScene.h"
+
+// VTK includes
+#include <vtkCallbackCommand.h>
+#include <vtkCommand.h>
+#include <vtkNew.h>
+
+// STD includes
+#include <vector>
+
+#include "vtkMRMLCoreTestingMacros.h"
+
+namespace
+{
+
+//------------------------------------------------------------------------------
+struct InvocationRecorder
+{
+  int Id;
+  std::vector<int>* Invocations;
+};
+
+//------------------------------------------------------------------------------
+void RecordInvocation(vtkObject* vtkNotUsed(caller), unsigned long vtkNotUsed(eid),
+                      void* clientData, void* vtkNotUsed(callData))
+{
+  InvocationRecorder* recorder = reinterpret_cast<InvocationRecorder*>(clientData);
+  recorder->Invocations->push_back(recorder->Id);
+}
+
+//------------------------------------------------------------------------------
+void RecordCallData(vtkObject* vtkNotUsed(caller), unsigned long vtkNotUsed(eid),
+                    void* clientData, void* callData)
+{
+  std::vector<void*>* callDataList = reinterpret_cast<std::vector<void*>*>(clientData);
+  callDataList->push_back(callData);
+}
+
+} // end of anonymous namespace
+
+//------------------------------------------------------------------------------
+int vtkEventBrokerCoalescedEventsTest(int , char * [] )
+{
+  vtkEventBroker* broker = vtkEventBroker::GetInstance();
+  CHECK_INT(broker->GetEventMode(), vtkEventBroker::Synchronous);
+
+  vtkNew<vtkMRMLScene> scene;
+  vtkNew<vtkMRMLModelNode> node;
+  scene->AddNode(node.GetPointer());
+
+  std::vector<int> invocations;
+  InvocationRecorder lowPriorityRecorder = { 1, &invocations };
+  InvocationRecorder highPriorityRecorder = { 2, &invocations };
+  vtkNew<vtkCallbackCommand> lowPriorityCallback;
+  lowPriorityCallback->SetCallback(RecordInvocation);
+  lowPriorityCallback->SetClientData(&lowPriorityRecorder);
+  vtkNew<vtkCallbackCommand> highPriorityCallback;
+  highPriorityCallback->SetCallback(RecordInvocation);
+  highPriorityCallback->SetClientData(&highPriorityRecorder);
+
+  vtkNew<vtkMRMLModelNode> observer;
+  broker->AddObservation(node.GetPointer(), vtkCommand::ModifiedEvent,
+    observer.GetPointer(), lowPriorityCallback.GetPointer(), 0.0f);
+  broker->AddObservation(node.GetPointer(), vtkCommand::ModifiedEvent,
+    observer.GetPointer(), highPriorityCallback.GetPointer(), 10.0f);
+
+  // Synchronous mode: every event is delivered
+  node->Modified();
+  node->Modified();
+  CHECK_INT(static_cast<int>(invocations.size()), 4);
+  invocations.clear();
+
+  // Coalesced mode: duplicate events are collapsed, high priority goes first
+  broker->SetEventModeToCoalesced();
+  CHECK_STRING(broker->GetEventModeAsString(), "Coalesced");
+  for (int i = 0; i < 100; ++i)
+    {
+    node->Modified();
+    }
+  CHECK_INT(static_cast<int>(invocations.size()), 0);
+  CHECK_INT(broker->GetNumberOfQueuedObservations(), 2);
+  broker->ProcessEventQueue();
+  CHECK_INT(static_cast<int>(invocations.size()), 2);
+  CHECK_INT(invocations[0], 2);
+  CHECK_INT(invocations[1], 1);
+  CHECK_INT(broker->GetNumberOfQueuedObservations(), 0);
+  invocations.clear();
+
+  // Switching back to synchronous mode flushes the queue
+  node->Modified();
+  broker->SetEventModeToSynchronous();
+  CHECK_INT(static_cast<int>(invocations.size()), 2);
+  invocations.clear();
+
+  // Scene batch processing coalesces events only if requested
+  scene->StartState(vtkMRMLScene::BatchProcessState);
+  node->Modified();
+  node->Modified();
+  scene->EndState(vtkMRMLScene::BatchProcessState);
+  CHECK_INT(static_cast<int>(invocations.size()), 4);
+  invocations.clear();
+
+  scene->CoalesceEventsDuringBatchProcessOn();
+  scene->StartState(vtkMRMLScene::BatchProcessState);
+  CHECK_INT(broker->GetEventMode(), vtkEventBroker::Coalesced);
+  scene->StartState(vtkMRMLScene::ImportState);
+  node->Modified();
+  node->Modified();
+  scene->EndState(vtkMRMLScene::ImportState);
+  node->Modified();
+  CHECK_INT(static_cast<int>(invocations.size()), 0);
+  scene->EndState(vtkMRMLScene::BatchProcessState);
+  CHECK_INT(broker->GetEventMode(), vtkEventBroker::Synchronous);
+  CHECK_INT(static_cast<int>(invocations.size()), 2);
+  CHECK_INT(invocations[0], 2);
+  CHECK_INT(invocations[1], 1);
+
+  broker->RemoveObservations(observer.GetPointer());
+
+  // Events with call data are not coalesced: each added node is notified
+  std::vector<void*> addedNodes;
+  vtkNew<vtkCallbackCommand> nodeAddedCallback;
+  nodeAddedCallback->SetCallback(RecordCallData);
+  nodeAddedCallback->SetClientData(&addedNodes);
+  broker->AddObservation(scene.GetPointer(), vtkMRMLScene::NodeAddedEvent,
+    observer.GetPointer(), nodeAddedCallback.GetPointer());
+  scene->StartState(vtkMRMLScene::BatchProcessState);
+  CHECK_INT(broker->GetEventMode(), vtkEventBroker::Coalesced);
+  vtkNew<vtkMRMLModelNode> addedNode1;
+  vtkNew<vtkMRMLModelNode> addedNode2;
+  vtkNew<vtkMRMLModelNode> addedNode3;
+  scene->AddNode(addedNode1.GetPointer());
+  scene->AddNode(addedNode2.GetPointer());
+  scene->AddNode(addedNode3.GetPointer());
+  CHECK_INT(static_cast<int>(addedNodes.size()), 3);
+  scene->EndState(vtkMRMLScene::BatchProcessState);
+  CHECK_INT(static_cast<int>(addedNodes.size()), 3);
+  CHECK_POINTER(addedNodes[0], addedNode1.GetPointer());
+  CHECK_POINTER(addedNodes[1], addedNode2.GetPointer());
+  CHECK_POINTER(addedNodes[2], addedNode3.GetPointer());
+
+  broker->RemoveObservations(observer.GetPointer());
+
+  return EXIT_SUCCESS;
+}
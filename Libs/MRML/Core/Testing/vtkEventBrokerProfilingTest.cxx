@@ -0,0 +1,114 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2016 Brigham and Women's Hospital (BWH)
+  All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Program:   3D Slicer
+
+=========================================================================auto=*/
+
+#include "vtkEventBroker.h"
+#include "vtkMRMLModelNode.h"
+#include "vtkMRMLScalarVolumeNode.h"
+
+// VTK includes
+#include <vtkCallbackCommand.h>
+#include <vtkCommand.h>
+#include <vtkNew.h>
+
+// STD includes
+#include <string>
+
+#include "vtkMRMLCoreTestingMacros.h"
+
+namespace
+{
+
+//------------------------------------------------------------------------------
+void ModifyTwice(vtkObject* vtkNotUsed(caller), unsigned long vtkNotUsed(eid),
+                 void* clientData, void* vtkNotUsed(callData))
+{
+  vtkObject* object = reinterpret_cast<vtkObject*>(clientData);
+  object->Modified();
+  object->Modified();
+}
+
+//------------------------------------------------------------------------------
+void DoNothing(vtkObject* vtkNotUsed(caller), unsigned long vtkNotUsed(eid),
+               void* vtkNotUsed(clientData), void* vtkNotUsed(callData))
+{
+}
+
+} // end of anonymous namespace
+
+//------------------------------------------------------------------------------
+int vtkEventBrokerProfilingTest(int , char * [] )
+{
+  vtkEventBroker* broker = vtkEventBroker::GetInstance();
+  CHECK_INT(broker->GetEventProfiling(), 0);
+
+  // modelNode modification modifies volumeNode twice
+  vtkNew<vtkMRMLModelNode> modelNode;
+  vtkNew<vtkMRMLScalarVolumeNode> volumeNode;
+  vtkNew<vtkCallbackCommand> modifyTwiceCallback;
+  modifyTwiceCallback->SetCallback(ModifyTwice);
+  modifyTwiceCallback->SetClientData(volumeNode.GetPointer());
+  vtkNew<vtkCallbackCommand> doNothingCallback;
+  doNothingCallback->SetCallback(DoNothing);
+
+  vtkNew<vtkMRMLModelNode> observer1;
+  vtkNew<vtkMRMLScalarVolumeNode> observer2;
+  broker->AddObservation(modelNode.GetPointer(), vtkCommand::ModifiedEvent,
+    observer1.GetPointer(), modifyTwiceCallback.GetPointer());
+  broker->AddObservation(volumeNode.GetPointer(), vtkCommand::ModifiedEvent,
+    observer2.GetPointer(), doNothingCallback.GetPointer());
+
+  // Nothing is recorded while profiling is off
+  modelNode->Modified();
+  CHECK_INT(broker->GetEventProfileInvocationCount("vtkMRMLModelNode", vtkCommand::ModifiedEvent, "vtkMRMLModelNode"), 0);
+
+  broker->EventProfilingOn();
+  for (int i = 0; i < 3; ++i)
+    {
+    modelNode->Modified();
+    }
+  broker->EventProfilingOff();
+
+  CHECK_INT(broker->GetEventProfileInvocationCount(
+    "vtkMRMLModelNode", vtkCommand::ModifiedEvent, "vtkMRMLModelNode"), 3);
+  CHECK_INT(broker->GetEventProfileInvocationCount(
+    "vtkMRMLScalarVolumeNode", vtkCommand::ModifiedEvent, "vtkMRMLScalarVolumeNode"), 6);
+  // each top-level event invokes the volume observation twice
+  CHECK_INT(broker->GetEventProfileRedundantCount(
+    "vtkMRMLModelNode", vtkCommand::ModifiedEvent, "vtkMRMLModelNode"), 0);
+  CHECK_INT(broker->GetEventProfileRedundantCount(
+    "vtkMRMLScalarVolumeNode", vtkCommand::ModifiedEvent, "vtkMRMLScalarVolumeNode"), 3);
+  CHECK_INT(broker->GetEventProfileCascadeCount(
+    "vtkMRMLModelNode", vtkCommand::ModifiedEvent, "vtkMRMLModelNode",
+    "vtkMRMLScalarVolumeNode", vtkCommand::ModifiedEvent, "vtkMRMLScalarVolumeNode"), 6);
+
+  double modelTotalTime = broker->GetEventProfileTotalTime(
+    "vtkMRMLModelNode", vtkCommand::ModifiedEvent, "vtkMRMLModelNode");
+  double modelSelfTime = broker->GetEventProfileSelfTime(
+    "vtkMRMLModelNode", vtkCommand::ModifiedEvent, "vtkMRMLModelNode");
+  CHECK_BOOL(modelTotalTime >= modelSelfTime, true);
+  CHECK_BOOL(modelSelfTime >= 0.0, true);
+
+  std::string report = broker->GetEventProfileReport(5);
+  std::cout << report << std::endl;
+  CHECK_BOOL(report.find("vtkMRMLModelNode ModifiedEvent -> vtkMRMLModelNode") != std::string::npos, true);
+  CHECK_BOOL(report.find("=> vtkMRMLScalarVolumeNode ModifiedEvent -> vtkMRMLScalarVolumeNode: 6 invocations")
+    != std::string::npos, true);
+
+  broker->ResetEventProfile();
+  CHECK_INT(broker->GetEventProfileInvocationCount(
+    "vtkMRMLModelNode", vtkCommand::ModifiedEvent, "vtkMRMLModelNode"), 0);
+
+  broker->RemoveObservations(observer1.GetPointer());
+  broker->RemoveObservations(observer2.GetPointer());
+
+  return EXIT_SUCCESS;
+}
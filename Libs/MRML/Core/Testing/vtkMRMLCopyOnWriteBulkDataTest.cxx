@@ -0,0 +1,94 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2016 Brigham and Women's Hospital (BWH)
+  All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Program:   3D Slicer
+
+=========================================================================auto=*/
+
+#include "vtkMRMLModelNode.h"
+#include "vtkMRMLScalarVolumeNode.h"
+#include "vtkMRMLScene.h"
+
+// VTK includes
+#include <vtkCellArray.h>
+#include <vtkImageData.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+
+#include "vtkMRMLCoreTestingMacros.h"
+
+//------------------------------------------------------------------------------
+int vtkMRMLCopyOnWriteBulkDataTest(int , char * [] )
+{
+  vtkNew<vtkMRMLScene> scene;
+  CHECK_BOOL(scene->GetCopyOnWriteBulkData(), false);
+
+  vtkNew<vtkImageData> imageData;
+  imageData->SetDimensions(10, 10, 10);
+  imageData->AllocateScalars(VTK_SHORT, 1);
+  imageData->GetPointData()->GetScalars()->FillComponent(0, 1.0);
+  vtkNew<vtkMRMLScalarVolumeNode> volumeNode;
+  volumeNode->SetAndObserveImageData(imageData.GetPointer());
+  scene->AddNode(volumeNode.GetPointer());
+
+  // Deep copies duplicate the voxels by default
+  vtkNew<vtkMRMLScalarVolumeNode> volumeCopy;
+  volumeCopy->CopyContent(volumeNode.GetPointer());
+  CHECK_BOOL(volumeNode->IsBulkDataShared(), false);
+  CHECK_BOOL(volumeCopy->IsBulkDataShared(), false);
+  CHECK_BOOL(volumeCopy->DetachSharedBulkData(), false);
+
+  // Copy-on-write: voxels are shared until detached
+  scene->CopyOnWriteBulkDataOn();
+  volumeCopy->CopyContent(volumeNode.GetPointer());
+  CHECK_BOOL(volumeCopy->GetImageData() != volumeNode->GetImageData(), true);
+  CHECK_POINTER(volumeCopy->GetImageData()->GetPointData()->GetScalars(),
+    volumeNode->GetImageData()->GetPointData()->GetScalars());
+  CHECK_BOOL(volumeNode->IsBulkDataShared(), true);
+  CHECK_BOOL(volumeCopy->IsBulkDataShared(), true);
+
+  vtkImageData* copiedImageData = volumeCopy->GetImageData();
+  CHECK_BOOL(volumeCopy->DetachSharedBulkData(), true);
+  CHECK_POINTER(volumeCopy->GetImageData(), copiedImageData);
+  CHECK_BOOL(volumeCopy->GetImageData()->GetPointData()->GetScalars()
+    != volumeNode->GetImageData()->GetPointData()->GetScalars(), true);
+  CHECK_BOOL(volumeNode->IsBulkDataShared(), false);
+  CHECK_BOOL(volumeCopy->IsBulkDataShared(), false);
+  CHECK_BOOL(volumeCopy->GetImageData()->GetScalarComponentAsDouble(5, 5, 5, 0) == 1.0, true);
+
+  // Modifying the private copy does not change the original
+  volumeCopy->GetImageData()->GetPointData()->GetScalars()->FillComponent(0, 2.0);
+  CHECK_BOOL(volumeNode->GetImageData()->GetScalarComponentAsDouble(5, 5, 5, 0) == 1.0, true);
+
+  // Models
+  vtkNew<vtkPoints> points;
+  points->InsertNextPoint(0.0, 0.0, 0.0);
+  points->InsertNextPoint(1.0, 0.0, 0.0);
+  points->InsertNextPoint(0.0, 1.0, 0.0);
+  vtkNew<vtkCellArray> polys;
+  vtkIdType triangle[3] = { 0, 1, 2 };
+  polys->InsertNextCell(3, triangle);
+  vtkNew<vtkPolyData> polyData;
+  polyData->SetPoints(points.GetPointer());
+  polyData->SetPolys(polys.GetPointer());
+  vtkNew<vtkMRMLModelNode> modelNode;
+  modelNode->SetAndObservePolyData(polyData.GetPointer());
+  scene->AddNode(modelNode.GetPointer());
+  vtkNew<vtkMRMLModelNode> modelCopy;
+  modelCopy->CopyContent(modelNode.GetPointer());
+  CHECK_POINTER(modelCopy->GetPolyData()->GetPoints(), modelNode->GetPolyData()->GetPoints());
+  CHECK_BOOL(modelNode->IsBulkDataShared(), true);
+  CHECK_BOOL(modelNode->DetachSharedBulkData(), true);
+  CHECK_BOOL(modelCopy->GetPolyData()->GetPoints() != modelNode->GetPolyData()->GetPoints(), true);
+  CHECK_BOOL(modelCopy->IsBulkDataShared(), false);
+  CHECK_INT(modelNode->GetPolyData()->GetNumberOfPoints(), modelCopy->GetPolyData()->GetNumberOfPoints());
+
+  return EXIT_SUCCESS;
+}
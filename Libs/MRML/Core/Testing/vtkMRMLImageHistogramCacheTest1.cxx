@@ -0,0 +1,223 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2005 Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Program:   3D Slicer
+
+=========================================================================auto=*/
+
+// MRML includes
+#include "vtkMRMLCoreTestingMacros.h"
+#include "vtkMRMLImageHistogramCache.h"
+#include "vtkMRMLScalarVolumeDisplayNode.h"
+#include "vtkMRMLScalarVolumeNode.h"
+#include "vtkMRMLScene.h"
+
+// VTK includes
+#include <vtkDataArray.h>
+#include <vtkIdTypeArray.h>
+#include <vtkImageData.h>
+#include <vtkImageHistogramStatistics.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+
+// STD includes
+#include <cmath>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+void CreateRampImage(vtkImageData* imageData, int size)
+{
+  imageData->SetDimensions(size, size, size);
+  imageData->AllocateScalars(VTK_SHORT, 1);
+  short* ptr = static_cast<short*>(imageData->GetScalarPointer());
+  vtkIdType numberOfPoints = imageData->GetNumberOfPoints();
+  for (vtkIdType i = 0; i < numberOfPoints; ++i)
+    {
+    ptr[i] = static_cast<short>(i % 1000);
+    }
+}
+
+//----------------------------------------------------------------------------
+void CreateNoiseImage(vtkImageData* imageData, int size)
+{
+  imageData->SetDimensions(size, size, size);
+  imageData->AllocateScalars(VTK_SHORT, 1);
+  short* ptr = static_cast<short*>(imageData->GetScalarPointer());
+  for (int k = 0; k < size; ++k)
+    {
+    for (int j = 0; j < size; ++j)
+      {
+      for (int i = 0; i < size; ++i, ++ptr)
+        {
+        // pseudo-random values in [0, 999], evenly distributed in strided samples as well
+        *ptr = static_cast<short>((i * 7919 + j * 104729 + k * 1299709) % 1000);
+        }
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+int TestCaching()
+{
+  vtkMRMLImageHistogramCache* cache = vtkMRMLImageHistogramCache::GetInstance();
+  cache->Clear();
+  vtkNew<vtkImageData> imageData;
+  CreateRampImage(imageData.GetPointer(), 40);
+
+  vtkNew<vtkImageHistogramStatistics> referenceStatistics;
+  referenceStatistics->SetAutoRangePercentiles(0.1, 99.9);
+  referenceStatistics->SetAutoRangeExpansionFactors(0.0, 0.0);
+  referenceStatistics->SetInputData(imageData.GetPointer());
+  referenceStatistics->Update();
+
+  int numberOfComputations = cache->GetNumberOfComputations();
+  double range[2] = { 0.0, 0.0 };
+  CHECK_BOOL(cache->GetAutoRange(imageData.GetPointer(), range), true);
+  CHECK_DOUBLE(range[0], referenceStatistics->GetAutoRange()[0]);
+  CHECK_DOUBLE(range[1], referenceStatistics->GetAutoRange()[1]);
+  CHECK_INT(cache->GetNumberOfComputations(), numberOfComputations + 1);
+  CHECK_INT(cache->GetSampleRate(imageData.GetPointer()), 1);
+
+  // Other statistics are returned from the cache
+  double minimum = 0.0;
+  double maximum = 0.0;
+  double mean = 0.0;
+  double median = 0.0;
+  double standardDeviation = 0.0;
+  CHECK_BOOL(cache->GetStatistics(imageData.GetPointer(), minimum, maximum, mean, median, standardDeviation), true);
+  CHECK_DOUBLE(minimum, 0.0);
+  CHECK_DOUBLE(maximum, 999.0);
+  CHECK_DOUBLE(mean, referenceStatistics->GetMean());
+  double percentile = 0.0;
+  CHECK_BOOL(cache->GetPercentile(imageData.GetPointer(), 50.0, percentile), true);
+  CHECK_BOOL(std::fabs(percentile - median) <= referenceStatistics->GetBinSpacing(), true);
+  vtkNew<vtkIdTypeArray> histogram;
+  double binOrigin = 0.0;
+  double binSpacing = 0.0;
+  CHECK_BOOL(cache->GetHistogram(imageData.GetPointer(), histogram.GetPointer(), binOrigin, binSpacing), true);
+  CHECK_INT(histogram->GetNumberOfTuples(), referenceStatistics->GetHistogram()->GetNumberOfTuples());
+  CHECK_INT(cache->GetNumberOfComputations(), numberOfComputations + 1);
+
+  // Modifying the scalars invalidates the cached statistics
+  static_cast<short*>(imageData->GetScalarPointer())[0] = 5000;
+  imageData->GetPointData()->GetScalars()->Modified();
+  CHECK_BOOL(cache->GetStatistics(imageData.GetPointer(), minimum, maximum, mean, median, standardDeviation), true);
+  CHECK_DOUBLE(maximum, 5000.0);
+  CHECK_INT(cache->GetNumberOfComputations(), numberOfComputations + 2);
+
+  // Image without scalars
+  vtkNew<vtkImageData> emptyImageData;
+  CHECK_BOOL(cache->GetAutoRange(emptyImageData.GetPointer(), range), false);
+  CHECK_BOOL(cache->GetAutoRange(nullptr, range), false);
+
+  cache->RemoveImage(imageData.GetPointer());
+  CHECK_INT(cache->GetNumberOfEntries(), 0);
+  return EXIT_SUCCESS;
+}
+
+//----------------------------------------------------------------------------
+int TestSampling()
+{
+  vtkMRMLImageHistogramCache* cache = vtkMRMLImageHistogramCache::GetInstance();
+  cache->Clear();
+  vtkNew<vtkImageData> imageData;
+  CreateNoiseImage(imageData.GetPointer(), 100);
+
+  double exactRange[2] = { 0.0, 0.0 };
+  CHECK_BOOL(cache->GetAutoRange(imageData.GetPointer(), exactRange), true);
+
+  int numberOfComputations = cache->GetNumberOfComputations();
+  cache->SetMaximumNumberOfSamples(10000);
+  double sampledRange[2] = { 0.0, 0.0 };
+  CHECK_BOOL(cache->GetAutoRange(imageData.GetPointer(), sampledRange), true);
+  CHECK_INT(cache->GetNumberOfComputations(), numberOfComputations + 1);
+  CHECK_INT(cache->GetSampleRate(imageData.GetPointer()), 5);
+  // estimate is close to the exact range
+  CHECK_BOOL(std::fabs(sampledRange[0] - exactRange[0]) < 20.0, true);
+  CHECK_BOOL(std::fabs(sampledRange[1] - exactRange[1]) < 20.0, true);
+
+  cache->SetMaximumNumberOfSamples(0);
+  CHECK_INT(cache->GetSampleRate(imageData.GetPointer()), 1);
+  cache->Clear();
+  return EXIT_SUCCESS;
+}
+
+//----------------------------------------------------------------------------
+int TestEntries()
+{
+  vtkMRMLImageHistogramCache* cache = vtkMRMLImageHistogramCache::GetInstance();
+  cache->Clear();
+  cache->SetMaximumNumberOfEntries(2);
+  double range[2] = { 0.0, 0.0 };
+  {
+    vtkNew<vtkImageData> imageData1;
+    CreateRampImage(imageData1.GetPointer(), 10);
+    vtkNew<vtkImageData> imageData2;
+    CreateRampImage(imageData2.GetPointer(), 10);
+    vtkNew<vtkImageData> imageData3;
+    CreateRampImage(imageData3.GetPointer(), 10);
+    CHECK_BOOL(cache->GetAutoRange(imageData1.GetPointer(), range), true);
+    CHECK_BOOL(cache->GetAutoRange(imageData2.GetPointer(), range), true);
+    CHECK_BOOL(cache->GetAutoRange(imageData1.GetPointer(), range), true);
+    // least recently used entry (imageData2) is removed
+    CHECK_BOOL(cache->GetAutoRange(imageData3.GetPointer(), range), true);
+    CHECK_INT(cache->GetNumberOfEntries(), 2);
+    int numberOfComputations = cache->GetNumberOfComputations();
+    CHECK_BOOL(cache->GetAutoRange(imageData1.GetPointer(), range), true);
+    CHECK_INT(cache->GetNumberOfComputations(), numberOfComputations);
+  }
+  // entries of deleted images are removed when a new entry is added
+  vtkNew<vtkImageData> imageData4;
+  CreateRampImage(imageData4.GetPointer(), 10);
+  CHECK_BOOL(cache->GetAutoRange(imageData4.GetPointer(), range), true);
+  CHECK_INT(cache->GetNumberOfEntries(), 1);
+  cache->SetMaximumNumberOfEntries(20);
+  cache->Clear();
+  return EXIT_SUCCESS;
+}
+
+//----------------------------------------------------------------------------
+int TestSharedBetweenDisplayNodes()
+{
+  vtkMRMLImageHistogramCache* cache = vtkMRMLImageHistogramCache::GetInstance();
+  cache->Clear();
+  vtkNew<vtkMRMLScene> scene;
+  vtkNew<vtkImageData> imageData;
+  CreateRampImage(imageData.GetPointer(), 40);
+  vtkNew<vtkMRMLScalarVolumeNode> volumeNode;
+  volumeNode->SetAndObserveImageData(imageData.GetPointer());
+  scene->AddNode(volumeNode.GetPointer());
+
+  int numberOfComputations = cache->GetNumberOfComputations();
+  for (int i = 0; i < 3; ++i)
+    {
+    vtkNew<vtkMRMLScalarVolumeDisplayNode> displayNode;
+    scene->AddNode(displayNode.GetPointer());
+    volumeNode->AddAndObserveDisplayNodeID(displayNode->GetID());
+    displayNode->AutoWindowLevelOn();
+    displayNode->Modified();
+    CHECK_BOOL(displayNode->GetWindow() > 0.0, true);
+    }
+  // histogram was computed once for all display nodes
+  CHECK_INT(cache->GetNumberOfComputations(), numberOfComputations + 1);
+  cache->Clear();
+  return EXIT_SUCCESS;
+}
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+int vtkMRMLImageHistogramCacheTest1(int , char * [] )
+{
+  CHECK_EXIT_SUCCESS(TestCaching());
+  CHECK_EXIT_SUCCESS(TestSampling());
+  CHECK_EXIT_SUCCESS(TestEntries());
+  CHECK_EXIT_SUCCESS(TestSharedBetweenDisplayNodes());
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,429 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2017 Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Program:   3D Slicer
+
+=========================================================================auto=*/
+
+// MRML includes
+#include "vtkBinaryMeshReader.h"
+#include "vtkBinaryMeshWriter.h"
+#include "vtkMRMLCoreTestingMacros.h"
+#include "vtkMRMLModelNode.h"
+#include "vtkMRMLModelStorageNode.h"
+#include "vtkMRMLScene.h"
+
+// VTK includes
+#include <vtkCellArray.h>
+#include <vtkCellData.h>
+#include <vtkFloatArray.h>
+#include <vtkIdList.h>
+#include <vtkIntArray.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkPolyData.h>
+#include <vtkSphereSource.h>
+#include <vtkTimerLog.h>
+
+// VTKSYS includes
+#include <vtksys/SystemTools.hxx>
+
+// STD includes
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+namespace
+{
+
+int TestWriteRead(const std::string& tempDir, bool useCompression);
+int TestCorruptedFiles(const std::string& tempDir);
+int TestStorageNode(const std::string& tempDir);
+int TestPerformance(const std::string& tempDir, int resolution);
+
+} // end of anonymous namespace
+
+//---------------------------------------------------------------------------
+int vtkMRMLModelStorageNodeBinaryMeshTest(int argc, char * argv[])
+{
+  if (argc != 2)
+    {
+    std::cerr << "Usage: " << argv[0] << " /path/to/temp" << std::endl;
+    return EXIT_FAILURE;
+    }
+  std::string tempDir = argv[1];
+  CHECK_EXIT_SUCCESS(TestWriteRead(tempDir, true));
+  CHECK_EXIT_SUCCESS(TestWriteRead(tempDir, false));
+  CHECK_EXIT_SUCCESS(TestCorruptedFiles(tempDir));
+  CHECK_EXIT_SUCCESS(TestStorageNode(tempDir));
+  CHECK_EXIT_SUCCESS(TestPerformance(tempDir, 500));
+  return EXIT_SUCCESS;
+}
+
+namespace
+{
+
+//---------------------------------------------------------------------------
+vtkSmartPointer<vtkPolyData> CreateMesh(int resolution)
+{
+  vtkNew<vtkSphereSource> sphere;
+  sphere->SetThetaResolution(resolution);
+  sphere->SetPhiResolution(resolution);
+  sphere->Update();
+  vtkSmartPointer<vtkPolyData> mesh = sphere->GetOutput();
+
+  vtkNew<vtkFloatArray> pointScalars;
+  pointScalars->SetName("Distance");
+  pointScalars->SetNumberOfTuples(mesh->GetNumberOfPoints());
+  for (vtkIdType i = 0; i < mesh->GetNumberOfPoints(); ++i)
+    {
+    pointScalars->SetValue(i, static_cast<float>(mesh->GetPoint(i)[2]));
+    }
+  mesh->GetPointData()->SetScalars(pointScalars.GetPointer());
+
+  vtkNew<vtkIntArray> cellLabels;
+  cellLabels->SetName("Label");
+  cellLabels->SetNumberOfTuples(mesh->GetNumberOfCells());
+  for (vtkIdType i = 0; i < mesh->GetNumberOfCells(); ++i)
+    {
+    cellLabels->SetValue(i, static_cast<int>(i % 7));
+    }
+  mesh->GetCellData()->AddArray(cellLabels.GetPointer());
+
+  // a few lines in addition to the polygons
+  vtkNew<vtkCellArray> lines;
+  vtkIdType line[3] = { 0, 1, 2 };
+  lines->InsertNextCell(3, line);
+  lines->InsertNextCell(2, line);
+  mesh->SetLines(lines.GetPointer());
+  return mesh;
+}
+
+//---------------------------------------------------------------------------
+bool HaveSameCells(vtkCellArray* cells1, vtkCellArray* cells2)
+{
+  if (cells1->GetNumberOfCells() != cells2->GetNumberOfCells())
+    {
+    return false;
+    }
+  vtkNew<vtkIdList> pts1;
+  vtkNew<vtkIdList> pts2;
+  cells1->InitTraversal();
+  cells2->InitTraversal();
+  while (cells1->GetNextCell(pts1.GetPointer()))
+    {
+    if (!cells2->GetNextCell(pts2.GetPointer()) || pts1->GetNumberOfIds() != pts2->GetNumberOfIds())
+      {
+      return false;
+      }
+    for (vtkIdType i = 0; i < pts1->GetNumberOfIds(); ++i)
+      {
+      if (pts1->GetId(i) != pts2->GetId(i))
+        {
+        return false;
+        }
+      }
+    }
+  return true;
+}
+
+//---------------------------------------------------------------------------
+int CheckSameMesh(vtkPolyData* expected, vtkPolyData* actual, double tolerance)
+{
+  CHECK_NOT_NULL(actual);
+  CHECK_INT(actual->GetNumberOfPoints(), expected->GetNumberOfPoints());
+  for (vtkIdType i = 0; i < expected->GetNumberOfPoints(); ++i)
+    {
+    double expectedPoint[3] = { 0.0, 0.0, 0.0 };
+    double actualPoint[3] = { 0.0, 0.0, 0.0 };
+    expected->GetPoint(i, expectedPoint);
+    actual->GetPoint(i, actualPoint);
+    // first two axes may be flipped by RAS to LPS conversion
+    if (fabs(fabs(expectedPoint[0]) - fabs(actualPoint[0])) > tolerance
+      || fabs(fabs(expectedPoint[1]) - fabs(actualPoint[1])) > tolerance
+      || fabs(expectedPoint[2] - actualPoint[2]) > tolerance)
+      {
+      std::cerr << "Line " << __LINE__ << ": point mismatch at " << i << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+  CHECK_BOOL(HaveSameCells(expected->GetPolys(), actual->GetPolys()), true);
+  CHECK_BOOL(HaveSameCells(expected->GetLines(), actual->GetLines()), true);
+  CHECK_INT(actual->GetVerts()->GetNumberOfCells(), 0);
+
+  CHECK_NOT_NULL(actual->GetPointData()->GetNormals());
+  CHECK_NOT_NULL(actual->GetPointData()->GetScalars());
+  CHECK_STD_STRING(actual->GetPointData()->GetScalars()->GetName(), "Distance");
+  vtkIntArray* labels = vtkIntArray::SafeDownCast(actual->GetCellData()->GetArray("Label"));
+  CHECK_NOT_NULL(labels);
+  CHECK_INT(labels->GetNumberOfTuples(), expected->GetNumberOfCells());
+  for (vtkIdType i = 0; i < labels->GetNumberOfTuples(); ++i)
+    {
+    CHECK_INT(labels->GetValue(i), static_cast<int>(i % 7));
+    }
+  return EXIT_SUCCESS;
+}
+
+//---------------------------------------------------------------------------
+int TestWriteRead(const std::string& tempDir, bool useCompression)
+{
+  vtkSmartPointer<vtkPolyData> mesh = CreateMesh(40);
+  std::string fileName = tempDir + "/vtkMRMLModelStorageNodeBinaryMeshTest.bmesh";
+  vtksys::SystemTools::RemoveFile(fileName);
+
+  vtkNew<vtkBinaryMeshWriter> writer;
+  writer->SetFileName(fileName.c_str());
+  writer->SetHeader("SPACE=RAS");
+  writer->SetUseCompression(useCompression);
+  writer->SetInputData(mesh);
+  writer->Write();
+  CHECK_BOOL(writer->GetWriteError(), false);
+  CHECK_BOOL(vtkBinaryMeshReader::CanReadFile(fileName.c_str()), true);
+
+  vtkNew<vtkBinaryMeshReader> reader;
+  reader->SetFileName(fileName.c_str());
+  reader->Update();
+  CHECK_STD_STRING(reader->GetHeader(), "SPACE=RAS");
+  CHECK_EXIT_SUCCESS(CheckSameMesh(mesh, reader->GetOutput(), 0.0));
+
+  // Files of other formats are rejected
+  std::string textFileName = tempDir + "/vtkMRMLModelStorageNodeBinaryMeshTest.txt";
+  vtksys::SystemTools::RemoveFile(textFileName);
+  {
+  std::ofstream textFile(textFileName.c_str());
+  textFile << "not a mesh" << std::endl;
+  }
+  CHECK_BOOL(vtkBinaryMeshReader::CanReadFile(textFileName.c_str()), false);
+  TESTING_OUTPUT_ASSERT_ERRORS_BEGIN();
+  reader->SetFileName(textFileName.c_str());
+  reader->Update();
+  TESTING_OUTPUT_ASSERT_ERRORS_END();
+  CHECK_INT(reader->GetOutput()->GetNumberOfPoints(), 0);
+  return EXIT_SUCCESS;
+}
+
+//---------------------------------------------------------------------------
+std::string ReadFileContent(const std::string& fileName)
+{
+  std::ifstream file(fileName.c_str(), std::ios::in | std::ios::binary);
+  std::stringstream content;
+  content << file.rdbuf();
+  return content.str();
+}
+
+//---------------------------------------------------------------------------
+void WriteFileContent(const std::string& fileName, const std::string& content)
+{
+  std::ofstream file(fileName.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+  file.write(content.data(), static_cast<std::streamsize>(content.size()));
+}
+
+//---------------------------------------------------------------------------
+/// Return the position of the description of the section with \a role, 0 if not found.
+size_t FindSectionDescription(const std::string& content, vtkTypeUInt32 role)
+{
+  vtkTypeUInt32 numberOfSections = 0;
+  memcpy(&numberOfSections, content.data() + 16, sizeof(numberOfSections));
+  for (vtkTypeUInt32 i = 0; i < numberOfSections; ++i)
+    {
+    size_t position = (i + 1) * vtkBinaryMeshReader::BlockSize;
+    vtkTypeUInt32 sectionRole = 0;
+    memcpy(&sectionRole, content.data() + position, sizeof(sectionRole));
+    if (sectionRole == role)
+      {
+      return position;
+      }
+    }
+  return 0;
+}
+
+//---------------------------------------------------------------------------
+/// Overwrite the value of a cell array section (stored without compression).
+void SetCellArrayValue(std::string& content, size_t descriptionPosition, vtkTypeUInt64 valueIndex, vtkTypeInt64 value)
+{
+  vtkTypeInt32 dataType = 0;
+  vtkTypeUInt64 dataOffset = 0;
+  memcpy(&dataType, content.data() + descriptionPosition + 4, sizeof(dataType));
+  memcpy(&dataOffset, content.data() + descriptionPosition + 40, sizeof(dataOffset));
+  if (dataType == VTK_TYPE_INT32)
+    {
+    vtkTypeInt32 value32 = static_cast<vtkTypeInt32>(value);
+    memcpy(&content[static_cast<size_t>(dataOffset + valueIndex * sizeof(value32))], &value32, sizeof(value32));
+    }
+  else
+    {
+    memcpy(&content[static_cast<size_t>(dataOffset + valueIndex * sizeof(value))], &value, sizeof(value));
+    }
+}
+
+//---------------------------------------------------------------------------
+/// Return EXIT_SUCCESS if \a content is rejected by the reader.
+int CheckReadFails(const std::string& fileName, const std::string& content)
+{
+  WriteFileContent(fileName, content);
+  vtkNew<vtkBinaryMeshReader> reader;
+  reader->SetFileName(fileName.c_str());
+  TESTING_OUTPUT_ASSERT_ERRORS_BEGIN();
+  reader->Update();
+  TESTING_OUTPUT_ASSERT_ERRORS_END();
+  CHECK_INT(reader->GetOutput()->GetNumberOfPoints(), 0);
+  CHECK_INT(reader->GetOutput()->GetNumberOfCells(), 0);
+  return EXIT_SUCCESS;
+}
+
+//---------------------------------------------------------------------------
+int TestCorruptedFiles(const std::string& tempDir)
+{
+  vtkSmartPointer<vtkPolyData> mesh = CreateMesh(20);
+  std::string fileName = tempDir + "/vtkMRMLModelStorageNodeBinaryMeshTestCorrupted.bmesh";
+  std::string validContent[2];
+  for (int useCompression = 0; useCompression < 2; ++useCompression)
+    {
+    vtksys::SystemTools::RemoveFile(fileName);
+    vtkNew<vtkBinaryMeshWriter> writer;
+    writer->SetFileName(fileName.c_str());
+    writer->SetUseCompression(useCompression != 0);
+    writer->SetInputData(mesh);
+    writer->Write();
+    CHECK_BOOL(writer->GetWriteError(), false);
+    validContent[useCompression] = ReadFileContent(fileName);
+    CHECK_BOOL(validContent[useCompression].size() > 4 * vtkBinaryMeshReader::BlockSize, true);
+    }
+
+  for (int useCompression = 0; useCompression < 2; ++useCompression)
+    {
+    const std::string& content = validContent[useCompression];
+    // Truncated files
+    CHECK_EXIT_SUCCESS(CheckReadFails(fileName, content.substr(0, content.size() / 2)));
+    CHECK_EXIT_SUCCESS(CheckReadFails(fileName, content.substr(0, content.size() - 1)));
+    CHECK_EXIT_SUCCESS(CheckReadFails(fileName, content.substr(0, 2 * vtkBinaryMeshReader::BlockSize)));
+
+    // Number of tuples that does not match the stored size, or that overflows the size computation
+    size_t pointsDescription = FindSectionDescription(content, vtkBinaryMeshReader::Points);
+    CHECK_BOOL(pointsDescription > 0, true);
+    const vtkTypeUInt64 numberOfTuplesValues[3] =
+      { static_cast<vtkTypeUInt64>(mesh->GetNumberOfPoints() + 1), 0x4000000000000001ull, 0xFFFFFFFFFFFFFFFFull };
+    for (int i = 0; i < 3; ++i)
+      {
+      std::string corrupted = content;
+      memcpy(&corrupted[pointsDescription + 32], &numberOfTuplesValues[i], sizeof(vtkTypeUInt64));
+      CHECK_EXIT_SUCCESS(CheckReadFails(fileName, corrupted));
+      }
+
+    // Name beyond the end of the file
+    std::string corruptedName = content;
+    vtkTypeUInt32 nameLength = 0xFFFFFFFFu;
+    memcpy(&corruptedName[pointsDescription + 20], &nameLength, sizeof(nameLength));
+    CHECK_EXIT_SUCCESS(CheckReadFails(fileName, corruptedName));
+    }
+
+  // Cell arrays are checked after decoding, use the uncompressed file to edit them
+  const std::string& content = validContent[0];
+  size_t offsetsDescription = FindSectionDescription(content, vtkBinaryMeshReader::PolysOffsets);
+  size_t connectivityDescription = FindSectionDescription(content, vtkBinaryMeshReader::PolysConnectivity);
+  CHECK_BOOL(offsetsDescription > 0, true);
+  CHECK_BOOL(connectivityDescription > 0, true);
+
+  std::string corruptedConnectivity = content;
+  SetCellArrayValue(corruptedConnectivity, connectivityDescription, 0, mesh->GetNumberOfPoints());
+  CHECK_EXIT_SUCCESS(CheckReadFails(fileName, corruptedConnectivity));
+  SetCellArrayValue(corruptedConnectivity, connectivityDescription, 0, -1);
+  CHECK_EXIT_SUCCESS(CheckReadFails(fileName, corruptedConnectivity));
+
+  std::string corruptedOffsets = content;
+  // offsets[2] < offsets[1]
+  SetCellArrayValue(corruptedOffsets, offsetsDescription, 1, 5);
+  SetCellArrayValue(corruptedOffsets, offsetsDescription, 2, 4);
+  CHECK_EXIT_SUCCESS(CheckReadFails(fileName, corruptedOffsets));
+  corruptedOffsets = content;
+  SetCellArrayValue(corruptedOffsets, offsetsDescription, 0, 1);
+  CHECK_EXIT_SUCCESS(CheckReadFails(fileName, corruptedOffsets));
+
+  // The unmodified content is still read
+  WriteFileContent(fileName, content);
+  vtkNew<vtkBinaryMeshReader> reader;
+  reader->SetFileName(fileName.c_str());
+  reader->Update();
+  CHECK_INT(reader->GetOutput()->GetNumberOfPoints(), mesh->GetNumberOfPoints());
+  CHECK_INT(reader->GetOutput()->GetNumberOfCells(), mesh->GetNumberOfCells());
+  return EXIT_SUCCESS;
+}
+
+//---------------------------------------------------------------------------
+int TestStorageNode(const std::string& tempDir)
+{
+  vtkNew<vtkMRMLScene> scene;
+  vtkSmartPointer<vtkPolyData> mesh = CreateMesh(40);
+  vtkNew<vtkMRMLModelNode> modelNode;
+  modelNode->SetAndObservePolyData(mesh);
+  scene->AddNode(modelNode.GetPointer());
+
+  vtkNew<vtkMRMLModelStorageNode> storageNode;
+  scene->AddNode(storageNode.GetPointer());
+  CHECK_BOOL(storageNode->SupportedFileType("model.bmesh") != 0, true);
+  std::string fileName = tempDir + "/vtkMRMLModelStorageNodeBinaryMeshTestModel.bmesh";
+  vtksys::SystemTools::RemoveFile(fileName);
+  storageNode->SetFileName(fileName.c_str());
+  CHECK_BOOL(storageNode->WriteData(modelNode.GetPointer()) != 0, true);
+
+  vtkNew<vtkMRMLModelNode> readModelNode;
+  scene->AddNode(readModelNode.GetPointer());
+  vtkNew<vtkMRMLModelStorageNode> readStorageNode;
+  scene->AddNode(readStorageNode.GetPointer());
+  readStorageNode->SetFileName(fileName.c_str());
+  // LPS coordinate system is read from the header
+  readStorageNode->SetCoordinateSystem(vtkMRMLStorageNode::CoordinateSystemRAS);
+  CHECK_BOOL(readStorageNode->ReadData(readModelNode.GetPointer()) != 0, true);
+  CHECK_INT(readStorageNode->GetCoordinateSystem(), vtkMRMLStorageNode::CoordinateSystemLPS);
+  CHECK_EXIT_SUCCESS(CheckSameMesh(mesh, readModelNode->GetPolyData(), 1e-6));
+  return EXIT_SUCCESS;
+}
+
+//---------------------------------------------------------------------------
+int TestPerformance(const std::string& tempDir, int resolution)
+{
+  vtkSmartPointer<vtkPolyData> mesh = CreateMesh(resolution);
+  std::cout << "Mesh with " << mesh->GetNumberOfPoints() << " points and "
+    << mesh->GetNumberOfCells() << " cells" << std::endl;
+
+  vtkNew<vtkMRMLScene> scene;
+  vtkNew<vtkMRMLModelNode> modelNode;
+  modelNode->SetAndObservePolyData(mesh);
+  scene->AddNode(modelNode.GetPointer());
+  vtkNew<vtkMRMLModelNode> readModelNode;
+  scene->AddNode(readModelNode.GetPointer());
+
+  const char* extensions[] = { ".bmesh", ".vtp", ".stl" };
+  vtkNew<vtkTimerLog> timer;
+  for (int formatIndex = 0; formatIndex < 3; ++formatIndex)
+    {
+    std::string fileName = tempDir + "/vtkMRMLModelStorageNodeBinaryMeshTestPerformance" + extensions[formatIndex];
+    vtksys::SystemTools::RemoveFile(fileName);
+    vtkNew<vtkMRMLModelStorageNode> storageNode;
+    scene->AddNode(storageNode.GetPointer());
+    storageNode->SetFileName(fileName.c_str());
+
+    timer->StartTimer();
+    CHECK_BOOL(storageNode->WriteData(modelNode.GetPointer()) != 0, true);
+    timer->StopTimer();
+    double writeTime = timer->GetElapsedTime();
+
+    timer->StartTimer();
+    CHECK_BOOL(storageNode->ReadData(readModelNode.GetPointer()) != 0, true);
+    timer->StopTimer();
+    double readTime = timer->GetElapsedTime();
+    CHECK_BOOL(readModelNode->GetPolyData()->GetNumberOfPoints() > 0, true);
+
+    std::cout << extensions[formatIndex] << ": write " << writeTime << " s, read " << readTime << " s, size "
+      << vtksys::SystemTools::FileLength(fileName) << " bytes" << std::endl;
+    scene->RemoveNode(storageNode.GetPointer());
+    }
+  return EXIT_SUCCESS;
+}
+
+} // end of anonymous namespace
@@ -1436,7 +1436,25 @@ bool TestRemoveReferencingNode()
   referencingNode->AddAndObserveNodeReferenceID(role1.c_str(), referencedNode2->GetID());
   referencingNode->AddAndObserveNodeReferenceID(role1.c_str(), referencedNode3->GetID());
 
+  vtkSmartPointer<vtkCollection> referencedNodeCollection = vtkSmartPointer<vtkCollection>::Take(
+    scene->GetReferencedNodes(referencingNode.GetPointer()));
+  if (referencedNodeCollection->GetNumberOfItems() != 4)
+    {
+    std::cerr << "Line " << __LINE__ << ": GetReferencedNodes failed" << std::endl;
+    return false;
+    }
+
   scene->RemoveNode(referencingNode.GetPointer());
+
+  // The scene must not keep track of the references of the removed node
+  std::vector<vtkMRMLNode*> referencingNodes;
+  scene->GetReferencingNodes(referencedNode1.GetPointer(), referencingNodes);
+  if (scene->GetNumberOfNodeReferences() != 0 || !referencingNodes.empty())
+    {
+    std::cerr << "Line " << __LINE__ << ": RemoveNode failed to remove the scene node references" << std::endl;
+    return false;
+    }
+
   // Removing the scene from the  node clear the cached referenced
   // nodes.
   vtkMRMLNode* referencedNode = referencingNode->GetNthNodeReference(role1.c_str(), 0);
@@ -144,6 +144,14 @@ int testTransformConsistencyAndCopy(const char *filename, const char* nodeId, co
 
   CHECK_EXIT_SUCCESS(testTransformConsistency(xfp, xtp, testPoints, transformedPoints.GetPointer(), transformedPointsBackToTest.GetPointer()));
 
+  // Test if multi-threaded point transform gives the same results
+  vtkNew<vtkPoints> transformedPointsMultiThreaded;
+  vtkMRMLTransformNode::TransformPoints(xfp, testPoints, transformedPointsMultiThreaded.GetPointer());
+  CHECK_INT(transformedPointsMultiThreaded->GetNumberOfPoints(), testPoints->GetNumberOfPoints());
+  CHECK_BOOL(isSamePointPositions(transformedPointsMultiThreaded.GetPointer(), transformedPoints.GetPointer()), true);
+  vtkMRMLTransformNode::TransformPoints(xtp, transformedPoints.GetPointer(), transformedPointsMultiThreaded.GetPointer());
+  CHECK_BOOL(isSamePointPositions(transformedPointsMultiThreaded.GetPointer(), transformedPointsBackToTest.GetPointer()), true);
+
   // Test if node copy creates an independent copy
   vtkNew<vtkMRMLTransformNode> transformNodeCopy;
   transformNodeCopy->Copy(transformNode);
@@ -0,0 +1,131 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2005 Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Program:   3D Slicer
+
+=========================================================================auto=*/
+
+// MRML includes
+#include "vtkMRMLCoreTestingMacros.h"
+#include "vtkMRMLModelNode.h"
+#include "vtkMRMLScene.h"
+#include "vtkMRMLSceneEventRecorder.h"
+#include "vtkMRMLScriptedModuleNode.h"
+
+// VTK includes
+#include <vtkNew.h>
+#include <vtkSmartPointer.h>
+#include <vtkWeakPointer.h>
+
+// STD includes
+#include <vector>
+
+//---------------------------------------------------------------------------
+int vtkMRMLSceneBulkClearTest(int vtkNotUsed(argc), char * vtkNotUsed(argv) [])
+{
+  vtkNew<vtkMRMLScene> scene;
+  CHECK_BOOL(scene->GetBulkClear(), false);
+  scene->BulkClearOn();
+
+  vtkNew<vtkMRMLScriptedModuleNode> singletonNode;
+  singletonNode->SetSingletonTag("Singleton");
+  scene->AddNode(singletonNode.GetPointer());
+
+  const int numberOfNodes = 100;
+  std::vector< vtkWeakPointer<vtkMRMLNode> > removedNodes;
+  std::vector<std::string> removedNodeIDs;
+  for (int i = 0; i < numberOfNodes; ++i)
+    {
+    vtkSmartPointer<vtkMRMLNode> node;
+    if (i % 2)
+      {
+      node = vtkSmartPointer<vtkMRMLModelNode>::New();
+      }
+    else
+      {
+      node = vtkSmartPointer<vtkMRMLScriptedModuleNode>::New();
+      }
+    node->SetName("Node");
+    scene->AddNode(node);
+    if (i > 0)
+      {
+      node->SetNodeReferenceID("previous", removedNodeIDs.back().c_str());
+      }
+    removedNodes.push_back(node.GetPointer());
+    removedNodeIDs.push_back(node->GetID());
+    }
+  // a removed node refers to the kept singleton node
+  removedNodes.back()->SetNodeReferenceID("singleton", singletonNode->GetID());
+  // the kept singleton node refers to a removed node
+  singletonNode->SetNodeReferenceID("removed", removedNodeIDs[0].c_str());
+  CHECK_POINTER(singletonNode->GetNodeReference("removed"), removedNodes[0].GetPointer());
+
+  // singleton node that is only owned by the scene
+  vtkWeakPointer<vtkMRMLNode> sceneOwnedSingletonNode;
+  {
+    vtkNew<vtkMRMLScriptedModuleNode> node;
+    node->SetSingletonTag("SceneOwnedSingleton");
+    scene->AddNode(node.GetPointer());
+    node->SetNodeReferenceID("removed", removedNodeIDs[1].c_str());
+    sceneOwnedSingletonNode = node.GetPointer();
+  }
+  CHECK_NOT_NULL(sceneOwnedSingletonNode.GetPointer());
+  std::string sceneOwnedSingletonNodeID = sceneOwnedSingletonNode->GetID();
+  CHECK_INT(scene->GetNumberOfNodes(), numberOfNodes + 2);
+
+  vtkNew<vtkMRMLSceneEventRecorder> callback;
+  scene->AddObserver(vtkCommand::AnyEvent, callback.GetPointer());
+
+  // Clear keeping the singletons
+  scene->Clear(0);
+  CHECK_INT(callback->CalledEvents[vtkMRMLScene::StartCloseEvent], 1);
+  CHECK_INT(callback->CalledEvents[vtkMRMLScene::EndCloseEvent], 1);
+  CHECK_INT(callback->CalledEvents[vtkMRMLScene::NodeAboutToBeRemovedEvent], 0);
+  CHECK_INT(callback->CalledEvents[vtkMRMLScene::NodeRemovedEvent], 0);
+  callback->CalledEvents.clear();
+
+  // removed nodes are deleted and not found anymore
+  CHECK_INT(scene->GetNumberOfNodes(), 2);
+  for (int i = 0; i < numberOfNodes; ++i)
+    {
+    CHECK_NULL(removedNodes[i].GetPointer());
+    CHECK_NULL(scene->GetNodeByID(removedNodeIDs[i]));
+    }
+  CHECK_POINTER(scene->GetNodeByID(singletonNode->GetID()), singletonNode.GetPointer());
+  // kept singleton nodes do not refer to removed nodes anymore
+  CHECK_NULL(singletonNode->GetNodeReference("removed"));
+  CHECK_NULL(singletonNode->GetNodeReferenceID("removed"));
+  // singleton node owned only by the scene is kept alive
+  CHECK_NOT_NULL(sceneOwnedSingletonNode.GetPointer());
+  CHECK_POINTER(scene->GetNodeByID(sceneOwnedSingletonNodeID), sceneOwnedSingletonNode.GetPointer());
+  CHECK_POINTER(scene->GetSingletonNode("SceneOwnedSingleton", "vtkMRMLScriptedModuleNode"), sceneOwnedSingletonNode.GetPointer());
+  CHECK_NULL(sceneOwnedSingletonNode->GetNodeReference("removed"));
+  CHECK_POINTER(sceneOwnedSingletonNode->GetScene(), scene.GetPointer());
+  CHECK_INT(scene->GetNumberOfNodesByClass("vtkMRMLScriptedModuleNode"), 2);
+  CHECK_INT(scene->GetNumberOfNodesByClass("vtkMRMLModelNode"), 0);
+  vtkSmartPointer<vtkCollection> namedNodes = vtkSmartPointer<vtkCollection>::Take(scene->GetNodesByName("Node"));
+  CHECK_INT(namedNodes->GetNumberOfItems(), 0);
+  CHECK_BOOL(scene->IsNodeReferencingNodeID(singletonNode.GetPointer(), removedNodeIDs[0].c_str()), false);
+
+  // the scene can be used as before
+  vtkNew<vtkMRMLModelNode> newNode;
+  scene->AddNode(newNode.GetPointer());
+  newNode->SetNodeReferenceID("singleton", singletonNode->GetID());
+  CHECK_POINTER(newNode->GetNodeReference("singleton"), singletonNode.GetPointer());
+  CHECK_INT(scene->GetNumberOfNodesByClass("vtkMRMLModelNode"), 1);
+  CHECK_INT(callback->CalledEvents[vtkMRMLScene::NodeAddedEvent], 1);
+
+  // Clear removing singletons as well
+  scene->Clear(1);
+  CHECK_INT(scene->GetNumberOfNodes(), 0);
+  CHECK_NULL(sceneOwnedSingletonNode.GetPointer());
+  CHECK_NULL(scene->GetNodeByID(singletonNode->GetID()));
+  CHECK_NULL(singletonNode->GetScene());
+  CHECK_INT(callback->CalledEvents[vtkMRMLScene::NodeRemovedEvent], 0);
+
+  return EXIT_SUCCESS;
+}
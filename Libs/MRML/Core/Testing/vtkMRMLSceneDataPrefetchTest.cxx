@@ -0,0 +1,111 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2016 Brigham and Women's Hospital (BWH)
+  All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Program:   3D Slicer
+
+=========================================================================auto=*/
+
+// MRML includes
+#include "vtkMRMLCoreTestingMacros.h"
+#include "vtkMRMLModelNode.h"
+#include "vtkMRMLModelStorageNode.h"
+#include "vtkMRMLScene.h"
+
+// VTK includes
+#include <vtkCellArray.h>
+#include <vtkNew.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+
+// STD includes
+#include <sstream>
+
+//---------------------------------------------------------------------------
+int vtkMRMLSceneDataPrefetchTest(int argc, char * argv[])
+{
+  if (argc != 2)
+    {
+    std::cerr << "Line " << __LINE__
+              << " - Missing parameters !\n"
+              << "Usage: " << argv[0] << " /path/to/temp"
+              << std::endl;
+    return EXIT_FAILURE;
+    }
+  const char* tempDir = argv[1];
+  std::string sceneFileName = std::string(tempDir) + "/vtkMRMLSceneDataPrefetchTest.mrml";
+
+  vtkNew<vtkMRMLScene> scene;
+  CHECK_INT(scene->GetNumberOfDataReadThreads(), 1);
+  scene->SetNumberOfDataReadThreads(0);
+  CHECK_INT(scene->GetNumberOfDataReadThreads(), 1);
+  scene->SetRootDirectory(tempDir);
+
+  // Save models with a different number of points each
+  const int numberOfModels = 8;
+  for (int modelIndex = 0; modelIndex < numberOfModels; ++modelIndex)
+    {
+    vtkNew<vtkPoints> points;
+    vtkNew<vtkCellArray> vertices;
+    for (vtkIdType pointIndex = 0; pointIndex < modelIndex + 1; ++pointIndex)
+      {
+      points->InsertNextPoint(pointIndex, modelIndex, 0.0);
+      vertices->InsertNextCell(1, &pointIndex);
+      }
+    vtkNew<vtkPolyData> polyData;
+    polyData->SetPoints(points.GetPointer());
+    polyData->SetVerts(vertices.GetPointer());
+
+    vtkNew<vtkMRMLModelNode> modelNode;
+    std::stringstream name;
+    name << "Model" << modelIndex;
+    modelNode->SetName(name.str().c_str());
+    modelNode->SetAndObservePolyData(polyData.GetPointer());
+    scene->AddNode(modelNode.GetPointer());
+
+    vtkNew<vtkMRMLModelStorageNode> storageNode;
+    scene->AddNode(storageNode.GetPointer());
+    std::string fileName = std::string(tempDir) + "/vtkMRMLSceneDataPrefetchTest_" + name.str() + ".vtk";
+    storageNode->SetFileName(fileName.c_str());
+    CHECK_INT(storageNode->WriteData(modelNode.GetPointer()), 1);
+    modelNode->SetAndObserveStorageNodeID(storageNode->GetID());
+    }
+  scene->SetURL(sceneFileName.c_str());
+  CHECK_INT(scene->Commit(), 1);
+
+  // Load the scene, reading the model files in parallel
+  vtkNew<vtkMRMLScene> loadedScene;
+  loadedScene->SetNumberOfDataReadThreads(4);
+  CHECK_INT(loadedScene->GetNumberOfDataReadThreads(), 4);
+  loadedScene->SetURL(sceneFileName.c_str());
+  CHECK_INT(loadedScene->Connect(), 1);
+  CHECK_INT(loadedScene->GetErrorCode(), 0);
+
+  CHECK_INT(loadedScene->GetNumberOfNodesByClass("vtkMRMLModelNode"), numberOfModels);
+  for (int modelIndex = 0; modelIndex < numberOfModels; ++modelIndex)
+    {
+    std::stringstream name;
+    name << "Model" << modelIndex;
+    vtkMRMLModelNode* modelNode = vtkMRMLModelNode::SafeDownCast(
+      loadedScene->GetFirstNode(name.str().c_str(), "vtkMRMLModelNode"));
+    CHECK_NOT_NULL(modelNode);
+    CHECK_NOT_NULL(modelNode->GetPolyData());
+    CHECK_INT(modelNode->GetPolyData()->GetNumberOfPoints(), modelIndex + 1);
+    }
+
+  // Prefetched data is released when not used
+  vtkNew<vtkMRMLModelNode> modelNode;
+  vtkNew<vtkMRMLModelStorageNode> storageNode;
+  loadedScene->AddNode(storageNode.GetPointer());
+  storageNode->SetFileName((std::string(tempDir) + "/vtkMRMLSceneDataPrefetchTest_Model3.vtk").c_str());
+  CHECK_BOOL(storageNode->PrefetchData(modelNode.GetPointer()), true);
+  storageNode->ClearPrefetchedData();
+  CHECK_INT(storageNode->ReadData(modelNode.GetPointer()), 1);
+  CHECK_INT(modelNode->GetPolyData()->GetNumberOfPoints(), 4);
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,120 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2016 Brigham and Women's Hospital (BWH)
+  All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Program:   3D Slicer
+
+=========================================================================auto=*/
+
+#include "vtkMRMLScene.h"
+#include "vtkMRMLScriptedModuleNode.h"
+
+// VTK includes
+#include <vtkTimerLog.h>
+
+#include "vtkMRMLCoreTestingMacros.h"
+
+// STD includes
+#include <vector>
+
+namespace
+{
+
+int TestIDChanges();
+int TestGetNodeByIDPerformance(int numberOfNodes);
+
+} // end of anonymous namespace
+
+//------------------------------------------------------------------------------
+int vtkMRMLSceneGetNodeByIDPerformanceTest(int , char * [] )
+{
+  CHECK_EXIT_SUCCESS(TestIDChanges());
+  CHECK_EXIT_SUCCESS(TestGetNodeByIDPerformance(1000));
+  CHECK_EXIT_SUCCESS(TestGetNodeByIDPerformance(10000));
+  CHECK_EXIT_SUCCESS(TestGetNodeByIDPerformance(100000));
+  return EXIT_SUCCESS;
+}
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+int TestIDChanges()
+{
+  vtkNew<vtkMRMLScene> scene;
+  vtkNew<vtkMRMLScriptedModuleNode> node1;
+  scene->AddNode(node1.GetPointer());
+  vtkNew<vtkMRMLScriptedModuleNode> node2;
+  scene->AddNode(node2.GetPointer());
+  std::string node1ID = node1->GetID();
+
+  // The index must follow ID changes of nodes in the scene
+  node1->SetID("vtkMRMLScriptedModuleNodeRenamed");
+  CHECK_NULL(scene->GetNodeByID(node1ID));
+  CHECK_POINTER(scene->GetNodeByID("vtkMRMLScriptedModuleNodeRenamed"), node1.GetPointer());
+  CHECK_POINTER(scene->GetNodeByID(node2->GetID()), node2.GetPointer());
+
+  // Nodes that are not in the scene must not be indexed
+  scene->RemoveNode(node1.GetPointer());
+  CHECK_NULL(scene->GetNodeByID("vtkMRMLScriptedModuleNodeRenamed"));
+  node1->SetID(node1ID.c_str());
+  CHECK_NULL(scene->GetNodeByID(node1ID));
+
+  // Adding many nodes must keep all the nodes reachable
+  std::vector< vtkSmartPointer<vtkMRMLScriptedModuleNode> > nodes;
+  for (int i = 0; i < 500; ++i)
+    {
+    vtkNew<vtkMRMLScriptedModuleNode> node;
+    scene->AddNode(node.GetPointer());
+    nodes.push_back(node.GetPointer());
+    if (i % 3 == 0)
+      {
+      scene->RemoveNode(nodes[i / 2]);
+      }
+    }
+  for (int i = 0; i < 500; ++i)
+    {
+    vtkMRMLNode* expectedNode = scene->IsNodePresent(nodes[i]) ? nodes[i].GetPointer() : nullptr;
+    CHECK_POINTER(scene->GetNodeByID(nodes[i]->GetID()), expectedNode);
+    }
+  return EXIT_SUCCESS;
+}
+
+//----------------------------------------------------------------------------
+int TestGetNodeByIDPerformance(int numberOfNodes)
+{
+  vtkNew<vtkMRMLScene> scene;
+  std::vector<std::string> nodeIDs;
+  for (int i = 0; i < numberOfNodes; ++i)
+    {
+    vtkNew<vtkMRMLScriptedModuleNode> node;
+    scene->AddNode(node.GetPointer());
+    nodeIDs.emplace_back(node->GetID());
+    }
+
+  const int numberOfLookups = 1000000;
+  vtkNew<vtkTimerLog> timer;
+  timer->StartTimer();
+  for (int i = 0; i < numberOfLookups; ++i)
+    {
+    if (!scene->GetNodeByID(nodeIDs[i % numberOfNodes]))
+      {
+      std::cerr << "Line " << __LINE__ << " - Node " << nodeIDs[i % numberOfNodes] << " not found" << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+  timer->StopTimer();
+
+  std::cout<< "<DartMeasurement name=\"vtkMRMLScene-GetNodeByID-" << numberOfNodes
+           << "-nanoseconds-per-lookup\" type=\"numeric/double\">"
+           << timer->GetElapsedTime() * 1.0e9 / numberOfLookups << "</DartMeasurement>" << std::endl;
+
+  scene->Clear(1);
+  return EXIT_SUCCESS;
+}
+
+} // end of anonymous namespace
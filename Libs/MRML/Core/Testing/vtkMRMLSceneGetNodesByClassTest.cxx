@@ -0,0 +1,94 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2016 Brigham and Women's Hospital (BWH)
+  All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Program:   3D Slicer
+
+=========================================================================auto=*/
+
+#include "vtkMRMLLabelMapVolumeNode.h"
+#include "vtkMRMLModelNode.h"
+#include "vtkMRMLScalarVolumeNode.h"
+#include "vtkMRMLScene.h"
+
+// VTK includes
+#include <vtkCollection.h>
+
+#include "vtkMRMLCoreTestingMacros.h"
+
+//------------------------------------------------------------------------------
+int vtkMRMLSceneGetNodesByClassTest(int , char * [] )
+{
+  vtkNew<vtkMRMLScene> scene;
+
+  CHECK_INT(scene->GetNumberOfNodesByClass("vtkMRMLVolumeNode"), 0);
+  CHECK_NULL(scene->GetFirstNodeByClass("vtkMRMLVolumeNode"));
+
+  vtkNew<vtkMRMLScalarVolumeNode> scalarVolumeNode;
+  scene->AddNode(scalarVolumeNode.GetPointer());
+  vtkNew<vtkMRMLModelNode> modelNode;
+  scene->AddNode(modelNode.GetPointer());
+  vtkNew<vtkMRMLLabelMapVolumeNode> labelMapVolumeNode;
+  scene->AddNode(labelMapVolumeNode.GetPointer());
+
+  // Classes that have already been queried must be kept up-to-date
+  CHECK_INT(scene->GetNumberOfNodesByClass("vtkMRMLVolumeNode"), 2);
+  CHECK_POINTER(scene->GetNthNodeByClass(0, "vtkMRMLVolumeNode"), scalarVolumeNode.GetPointer());
+  CHECK_POINTER(scene->GetNthNodeByClass(1, "vtkMRMLVolumeNode"), labelMapVolumeNode.GetPointer());
+  CHECK_NULL(scene->GetNthNodeByClass(2, "vtkMRMLVolumeNode"));
+
+  // Query a class for the first time, and subclasses
+  CHECK_INT(scene->GetNumberOfNodesByClass("vtkMRMLNode"), 3);
+  CHECK_INT(scene->GetNumberOfNodesByClass("vtkMRMLScalarVolumeNode"), 2);
+  CHECK_INT(scene->GetNumberOfNodesByClass("vtkMRMLLabelMapVolumeNode"), 1);
+  CHECK_INT(scene->GetNumberOfNodesByClass("vtkMRMLModelNode"), 1);
+  CHECK_INT(scene->GetNumberOfNodesByClass("vtkMRMLNonExistingNode"), 0);
+
+  // Add nodes after classes have been indexed
+  vtkNew<vtkMRMLScalarVolumeNode> scalarVolumeNode2;
+  scene->AddNode(scalarVolumeNode2.GetPointer());
+  CHECK_INT(scene->GetNumberOfNodesByClass("vtkMRMLNode"), 4);
+  CHECK_INT(scene->GetNumberOfNodesByClass("vtkMRMLVolumeNode"), 3);
+  CHECK_POINTER(scene->GetNthNodeByClass(2, "vtkMRMLScalarVolumeNode"), scalarVolumeNode2.GetPointer());
+  CHECK_INT(scene->GetNumberOfNodesByClass("vtkMRMLLabelMapVolumeNode"), 1);
+
+  // Remove nodes
+  scene->RemoveNode(labelMapVolumeNode.GetPointer());
+  CHECK_INT(scene->GetNumberOfNodesByClass("vtkMRMLVolumeNode"), 2);
+  CHECK_POINTER(scene->GetNthNodeByClass(1, "vtkMRMLVolumeNode"), scalarVolumeNode2.GetPointer());
+  CHECK_INT(scene->GetNumberOfNodesByClass("vtkMRMLLabelMapVolumeNode"), 0);
+  CHECK_POINTER(scene->GetFirstNodeByClass("vtkMRMLNode"), scalarVolumeNode.GetPointer());
+
+  // Insert a node in the middle of the scene, it must keep the scene order
+  vtkNew<vtkMRMLScalarVolumeNode> scalarVolumeNode3;
+  scene->InsertBeforeNode(scalarVolumeNode2.GetPointer(), scalarVolumeNode3.GetPointer());
+  std::vector<vtkMRMLNode*> volumeNodes;
+  CHECK_INT(scene->GetNodesByClass("vtkMRMLVolumeNode", volumeNodes), 3);
+  CHECK_POINTER(volumeNodes[0], scalarVolumeNode.GetPointer());
+  CHECK_POINTER(volumeNodes[1], scalarVolumeNode3.GetPointer());
+  CHECK_POINTER(volumeNodes[2], scalarVolumeNode2.GetPointer());
+
+  vtkSmartPointer<vtkCollection> volumeNodeCollection =
+    vtkSmartPointer<vtkCollection>::Take(scene->GetNodesByClass("vtkMRMLVolumeNode"));
+  CHECK_INT(volumeNodeCollection->GetNumberOfItems(), 3);
+  CHECK_POINTER(volumeNodeCollection->GetItemAsObject(1), scalarVolumeNode3.GetPointer());
+
+  // Filtered queries
+  scalarVolumeNode3->SetName("MyVolume");
+  CHECK_POINTER(scene->GetFirstNode("MyVolume", "vtkMRMLVolumeNode"), scalarVolumeNode3.GetPointer());
+  CHECK_NULL(scene->GetFirstNode("MyVolume", "vtkMRMLModelNode"));
+  vtkSmartPointer<vtkCollection> namedNodes =
+    vtkSmartPointer<vtkCollection>::Take(scene->GetNodesByClassByName("vtkMRMLScalarVolumeNode", "MyVolume"));
+  CHECK_INT(namedNodes->GetNumberOfItems(), 1);
+
+  // Clear the scene
+  scene->Clear(1);
+  CHECK_INT(scene->GetNumberOfNodesByClass("vtkMRMLNode"), 0);
+  CHECK_INT(scene->GetNumberOfNodesByClass("vtkMRMLVolumeNode"), 0);
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,77 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2016 Brigham and Women's Hospital (BWH)
+  All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Program:   3D Slicer
+
+=========================================================================auto=*/
+
+#include "vtkMRMLModelNode.h"
+#include "vtkMRMLScalarVolumeNode.h"
+#include "vtkMRMLScene.h"
+
+// VTK includes
+#include <vtkCollection.h>
+
+#include "vtkMRMLCoreTestingMacros.h"
+
+//------------------------------------------------------------------------------
+int vtkMRMLSceneGetNodesByNameTest(int , char * [] )
+{
+  vtkNew<vtkMRMLScene> scene;
+
+  vtkNew<vtkMRMLScalarVolumeNode> volumeNode1;
+  volumeNode1->SetName("Volume");
+  scene->AddNode(volumeNode1.GetPointer());
+  vtkNew<vtkMRMLModelNode> modelNode;
+  modelNode->SetName("Model");
+  scene->AddNode(modelNode.GetPointer());
+  vtkNew<vtkMRMLScalarVolumeNode> volumeNode2;
+  volumeNode2->SetName("Volume");
+  scene->AddNode(volumeNode2.GetPointer());
+
+  CHECK_POINTER(scene->GetFirstNodeByName("Volume"), volumeNode1.GetPointer());
+  CHECK_POINTER(scene->GetFirstNodeByName("Model"), modelNode.GetPointer());
+  CHECK_NULL(scene->GetFirstNodeByName("NonExistingName"));
+  vtkSmartPointer<vtkCollection> nodes =
+    vtkSmartPointer<vtkCollection>::Take(scene->GetNodesByName("Volume"));
+  CHECK_INT(nodes->GetNumberOfItems(), 2);
+
+  // Renamed nodes must be found by their new name, in scene order
+  modelNode->SetName("Volume");
+  CHECK_NULL(scene->GetFirstNodeByName("Model"));
+  nodes = vtkSmartPointer<vtkCollection>::Take(scene->GetNodesByName("Volume"));
+  CHECK_INT(nodes->GetNumberOfItems(), 3);
+  CHECK_POINTER(nodes->GetItemAsObject(1), modelNode.GetPointer());
+  volumeNode1->SetName("FirstVolume");
+  CHECK_POINTER(scene->GetFirstNodeByName("Volume"), modelNode.GetPointer());
+  CHECK_POINTER(scene->GetFirstNodeByName("FirstVolume"), volumeNode1.GetPointer());
+  nodes = vtkSmartPointer<vtkCollection>::Take(scene->GetNodesByClassByName("vtkMRMLVolumeNode", "Volume"));
+  CHECK_INT(nodes->GetNumberOfItems(), 1);
+  CHECK_POINTER(nodes->GetItemAsObject(0), volumeNode2.GetPointer());
+
+  // Unique names
+  CHECK_STD_STRING(scene->GenerateUniqueName("Volume"), "Volume_1");
+  vtkNew<vtkMRMLScalarVolumeNode> volumeNode3;
+  volumeNode3->SetName("Volume_2");
+  scene->AddNode(volumeNode3.GetPointer());
+  CHECK_STD_STRING(scene->GenerateUniqueName("Volume"), "Volume_3");
+
+  // Removed nodes
+  scene->RemoveNode(modelNode.GetPointer());
+  nodes = vtkSmartPointer<vtkCollection>::Take(scene->GetNodesByName("Volume"));
+  CHECK_INT(nodes->GetNumberOfItems(), 1);
+  // Nodes that are not in the scene anymore must not be indexed
+  modelNode->SetName("Model");
+  CHECK_NULL(scene->GetFirstNodeByName("Model"));
+
+  scene->Clear(1);
+  CHECK_NULL(scene->GetFirstNodeByName("Volume"));
+  CHECK_NULL(scene->GetFirstNodeByName("FirstVolume"));
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,91 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2016 Brigham and Women's Hospital (BWH)
+  All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Program:   3D Slicer
+
+=========================================================================auto=*/
+
+// MRML includes
+#include "vtkMRMLCoreTestingMacros.h"
+#include "vtkMRMLModelDisplayNode.h"
+#include "vtkMRMLModelNode.h"
+#include "vtkMRMLModelStorageNode.h"
+#include "vtkMRMLScene.h"
+
+// VTK includes
+#include <vtkNew.h>
+
+// STD includes
+#include <sstream>
+
+//---------------------------------------------------------------------------
+int vtkMRMLSceneParallelImportTest(int vtkNotUsed(argc), char * vtkNotUsed(argv) [])
+{
+  std::stringstream sceneXML;
+  sceneXML << "<MRML  version=\"Slicer4.4.0\" userTags=\"\">";
+  const int numberOfModels = 50;
+  for (int i = 1; i <= numberOfModels; ++i)
+    {
+    sceneXML
+      << "<Model id=\"vtkMRMLModelNode" << i << "\" name=\"Model" << i << "\""
+      << " displayNodeRef=\"vtkMRMLModelDisplayNode" << i << "\""
+      << " storageNodeRef=\"vtkMRMLModelStorageNode" << i << "\" ></Model>"
+      << "<ModelDisplay id=\"vtkMRMLModelDisplayNode" << i << "\" name=\"Display" << i << "\""
+      << " opacity=\"0.5\" ></ModelDisplay>"
+      << "<ModelStorage id=\"vtkMRMLModelStorageNode" << i << "\" name=\"Storage" << i << "\""
+      << " fileName=\"model" << i << ".vtk\" ></ModelStorage>";
+    }
+  sceneXML << "</MRML>";
+
+  vtkNew<vtkMRMLScene> serialScene;
+  serialScene->SetSceneXMLString(sceneXML.str());
+  serialScene->SetLoadFromXMLString(1);
+  CHECK_BOOL(serialScene->GetParallelNodeInstantiation(), false);
+  serialScene->Import();
+
+  vtkNew<vtkMRMLScene> parallelScene;
+  parallelScene->SetSceneXMLString(sceneXML.str());
+  parallelScene->SetLoadFromXMLString(1);
+  parallelScene->ParallelNodeInstantiationOn();
+  parallelScene->Import();
+
+  // Nodes must be added in the same order, with the same content
+  CHECK_INT(parallelScene->GetNumberOfNodes(), serialScene->GetNumberOfNodes());
+  for (int i = 0; i < serialScene->GetNumberOfNodes(); ++i)
+    {
+    vtkMRMLNode* serialNode = serialScene->GetNthNode(i);
+    vtkMRMLNode* parallelNode = parallelScene->GetNthNode(i);
+    CHECK_NOT_NULL(parallelNode);
+    CHECK_STRING(parallelNode->GetClassName(), serialNode->GetClassName());
+    CHECK_STRING(parallelNode->GetID(), serialNode->GetID());
+    if (serialNode->GetName())
+      {
+      CHECK_STRING(parallelNode->GetName(), serialNode->GetName());
+      }
+    }
+
+  // References are resolved
+  vtkMRMLModelNode* modelNode = vtkMRMLModelNode::SafeDownCast(
+    parallelScene->GetNodeByID("vtkMRMLModelNode7"));
+  CHECK_NOT_NULL(modelNode);
+  CHECK_STRING(modelNode->GetName(), "Model7");
+  CHECK_POINTER(modelNode->GetDisplayNode(), parallelScene->GetNodeByID("vtkMRMLModelDisplayNode7"));
+  CHECK_POINTER(modelNode->GetStorageNode(), parallelScene->GetNodeByID("vtkMRMLModelStorageNode7"));
+  CHECK_BOOL(modelNode->GetDisplayNode()->GetOpacity() == 0.5, true);
+
+  // Storage nodes read their attributes with the scene set
+  vtkMRMLModelStorageNode* serialStorageNode = vtkMRMLModelStorageNode::SafeDownCast(
+    serialScene->GetNodeByID("vtkMRMLModelStorageNode7"));
+  vtkMRMLModelStorageNode* parallelStorageNode = vtkMRMLModelStorageNode::SafeDownCast(
+    parallelScene->GetNodeByID("vtkMRMLModelStorageNode7"));
+  CHECK_NOT_NULL(serialStorageNode);
+  CHECK_NOT_NULL(parallelStorageNode);
+  CHECK_STRING(parallelStorageNode->GetFileName(), serialStorageNode->GetFileName());
+
+  return EXIT_SUCCESS;
+}
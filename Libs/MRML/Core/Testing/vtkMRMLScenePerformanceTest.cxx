@@ -0,0 +1,335 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2016 Brigham and Women's Hospital (BWH)
+  All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Program:   3D Slicer
+
+=========================================================================auto=*/
+
+// MRML includes
+#include "vtkEventBroker.h"
+#include "vtkMRMLScene.h"
+#include "vtkMRMLScriptedModuleNode.h"
+
+// VTK includes
+#include <vtkCallbackCommand.h>
+#include <vtkCollection.h>
+#include <vtkNew.h>
+#include <vtkSmartPointer.h>
+#include <vtkTimerLog.h>
+
+#include "vtkMRMLCoreTestingMacros.h"
+#include "vtkMRMLCoreTestingUtilities.h"
+
+// STD includes
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Measures the time of the scene operations that are the most frequently used
+// by the application, on scenes of increasing size.
+//
+// Each measurement is reported as a DartMeasurement, so that its history is
+// tracked on the dashboard, and it is written into
+// <temp>/vtkMRMLScenePerformanceTest.json as {"name": value, ...}.
+// If a baseline file (a previous output of this test) is specified as second
+// argument then the test fails if a measurement is larger than
+// baseline * (1 + tolerance), see vtkMRMLCoreTestingUtilities::PerformanceMeasurements.
+//
+// Usage: vtkMRMLScenePerformanceTest /path/to/temp [/path/to/baseline.json]
+
+namespace
+{
+
+typedef vtkMRMLCoreTestingUtilities::PerformanceMeasurements MeasurementsType;
+
+//----------------------------------------------------------------------------
+void ReportMeasurement(MeasurementsType& measurements, const std::string& name,
+                       int numberOfNodes, double elapsedTime, int numberOfOperations)
+{
+  std::stringstream ss;
+  ss << "vtkMRMLScene-" << name << "-" << numberOfNodes << "-microseconds-per-operation";
+  measurements.Report(ss.str(), elapsedTime * 1.0e6 / numberOfOperations);
+}
+
+//----------------------------------------------------------------------------
+void AddNodes(vtkMRMLScene* scene, int numberOfNodes,
+              std::vector< vtkSmartPointer<vtkMRMLScriptedModuleNode> >& nodes)
+{
+  for (int i = 0; i < numberOfNodes; ++i)
+    {
+    vtkNew<vtkMRMLScriptedModuleNode> node;
+    node->SetUndoEnabled(true);
+    scene->AddNode(node.GetPointer());
+    nodes.push_back(node.GetPointer());
+    }
+}
+
+//----------------------------------------------------------------------------
+int TestAddRemoveNodes(MeasurementsType& measurements, int numberOfNodes)
+{
+  vtkNew<vtkMRMLScene> scene;
+  std::vector< vtkSmartPointer<vtkMRMLScriptedModuleNode> > nodes;
+  vtkNew<vtkTimerLog> timer;
+
+  timer->StartTimer();
+  AddNodes(scene.GetPointer(), numberOfNodes, nodes);
+  timer->StopTimer();
+  CHECK_INT(scene->GetNumberOfNodes(), numberOfNodes);
+  ReportMeasurement(measurements, "AddNode", numberOfNodes, timer->GetElapsedTime(), numberOfNodes);
+
+  timer->StartTimer();
+  // remove in reverse order of addition, as when a scene is closed
+  for (int i = numberOfNodes - 1; i >= 0; --i)
+    {
+    scene->RemoveNode(nodes[i]);
+    }
+  timer->StopTimer();
+  CHECK_INT(scene->GetNumberOfNodes(), 0);
+  ReportMeasurement(measurements, "RemoveNode", numberOfNodes, timer->GetElapsedTime(), numberOfNodes);
+
+  nodes.clear();
+  AddNodes(scene.GetPointer(), numberOfNodes, nodes);
+  nodes.clear();
+  timer->StartTimer();
+  scene->Clear(1);
+  timer->StopTimer();
+  CHECK_INT(scene->GetNumberOfNodes(), 0);
+  ReportMeasurement(measurements, "Clear", numberOfNodes, timer->GetElapsedTime(), numberOfNodes);
+
+  scene->BulkClearOn();
+  AddNodes(scene.GetPointer(), numberOfNodes, nodes);
+  nodes.clear();
+  timer->StartTimer();
+  scene->Clear(1);
+  timer->StopTimer();
+  CHECK_INT(scene->GetNumberOfNodes(), 0);
+  ReportMeasurement(measurements, "BulkClear", numberOfNodes, timer->GetElapsedTime(), numberOfNodes);
+
+  return EXIT_SUCCESS;
+}
+
+//----------------------------------------------------------------------------
+int TestGetNodes(MeasurementsType& measurements, int numberOfNodes)
+{
+  vtkNew<vtkMRMLScene> scene;
+  std::vector< vtkSmartPointer<vtkMRMLScriptedModuleNode> > nodes;
+  AddNodes(scene.GetPointer(), numberOfNodes, nodes);
+  vtkNew<vtkTimerLog> timer;
+
+  const int numberOfLookups = 100000;
+  timer->StartTimer();
+  for (int i = 0; i < numberOfLookups; ++i)
+    {
+    if (scene->GetNodeByID(nodes[i % numberOfNodes]->GetID()) != nodes[i % numberOfNodes])
+      {
+      std::cerr << "Line " << __LINE__ << " - GetNodeByID failed" << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+  timer->StopTimer();
+  ReportMeasurement(measurements, "GetNodeByID", numberOfNodes, timer->GetElapsedTime(), numberOfLookups);
+
+  const int numberOfClassLookups = 100;
+  timer->StartTimer();
+  for (int i = 0; i < numberOfClassLookups; ++i)
+    {
+    vtkSmartPointer<vtkCollection> collection = vtkSmartPointer<vtkCollection>::Take(
+      scene->GetNodesByClass("vtkMRMLScriptedModuleNode"));
+    if (collection->GetNumberOfItems() != numberOfNodes)
+      {
+      std::cerr << "Line " << __LINE__ << " - GetNodesByClass failed" << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+  timer->StopTimer();
+  ReportMeasurement(measurements, "GetNodesByClass", numberOfNodes, timer->GetElapsedTime(), numberOfClassLookups);
+
+  return EXIT_SUCCESS;
+}
+
+//----------------------------------------------------------------------------
+int TestImportCommit(MeasurementsType& measurements, int numberOfNodes)
+{
+  vtkNew<vtkMRMLScene> scene;
+  std::vector< vtkSmartPointer<vtkMRMLScriptedModuleNode> > nodes;
+  AddNodes(scene.GetPointer(), numberOfNodes, nodes);
+  vtkNew<vtkTimerLog> timer;
+
+  scene->SetSaveToXMLString(1);
+  timer->StartTimer();
+  CHECK_BOOL(scene->Commit() != 0, true);
+  timer->StopTimer();
+  ReportMeasurement(measurements, "Commit", numberOfNodes, timer->GetElapsedTime(), numberOfNodes);
+
+  vtkNew<vtkMRMLScene> importedScene;
+  importedScene->SetLoadFromXMLString(1);
+  importedScene->SetSceneXMLString(scene->GetSceneXMLString());
+  timer->StartTimer();
+  CHECK_BOOL(importedScene->Import() != 0, true);
+  timer->StopTimer();
+  CHECK_INT(importedScene->GetNumberOfNodesByClass("vtkMRMLScriptedModuleNode"), numberOfNodes);
+  ReportMeasurement(measurements, "Import", numberOfNodes, timer->GetElapsedTime(), numberOfNodes);
+
+  return EXIT_SUCCESS;
+}
+
+//----------------------------------------------------------------------------
+int TestUndo(MeasurementsType& measurements, int numberOfNodes)
+{
+  vtkNew<vtkMRMLScene> scene;
+  scene->SetUndoOn();
+  std::vector< vtkSmartPointer<vtkMRMLScriptedModuleNode> > nodes;
+  AddNodes(scene.GetPointer(), numberOfNodes, nodes);
+  vtkNew<vtkTimerLog> timer;
+
+  const int numberOfUndoLevels = 10;
+  timer->StartTimer();
+  for (int i = 0; i < numberOfUndoLevels; ++i)
+    {
+    scene->SaveStateForUndo();
+    nodes[i % numberOfNodes]->SetParameter("Level", std::to_string(i));
+    }
+  timer->StopTimer();
+  ReportMeasurement(measurements, "SaveStateForUndo", numberOfNodes, timer->GetElapsedTime(), numberOfUndoLevels);
+
+  timer->StartTimer();
+  for (int i = 0; i < numberOfUndoLevels; ++i)
+    {
+    scene->Undo();
+    }
+  timer->StopTimer();
+  CHECK_INT(scene->GetNumberOfUndoLevels(), 0);
+  CHECK_STD_STRING(nodes[0]->GetParameter("Level"), "");
+  ReportMeasurement(measurements, "Undo", numberOfNodes, timer->GetElapsedTime(), numberOfUndoLevels);
+
+  return EXIT_SUCCESS;
+}
+
+//----------------------------------------------------------------------------
+int TestNodeReferences(MeasurementsType& measurements, int numberOfNodes)
+{
+  vtkNew<vtkMRMLScene> scene;
+  std::vector< vtkSmartPointer<vtkMRMLScriptedModuleNode> > nodes;
+  AddNodes(scene.GetPointer(), numberOfNodes, nodes);
+  vtkNew<vtkTimerLog> timer;
+
+  // each node references the next one
+  timer->StartTimer();
+  for (int i = 0; i < numberOfNodes; ++i)
+    {
+    nodes[i]->SetNodeReferenceID("next", nodes[(i + 1) % numberOfNodes]->GetID());
+    }
+  timer->StopTimer();
+  ReportMeasurement(measurements, "SetNodeReferenceID", numberOfNodes, timer->GetElapsedTime(), numberOfNodes);
+
+  timer->StartTimer();
+  for (int i = 0; i < numberOfNodes; ++i)
+    {
+    if (nodes[i]->GetNodeReference("next") != nodes[(i + 1) % numberOfNodes])
+      {
+      std::cerr << "Line " << __LINE__ << " - GetNodeReference failed" << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+  timer->StopTimer();
+  ReportMeasurement(measurements, "GetNodeReference", numberOfNodes, timer->GetElapsedTime(), numberOfNodes);
+
+  // removing a node updates the references of the referencing node
+  const int numberOfRemovedNodes = std::min(numberOfNodes, 100);
+  timer->StartTimer();
+  for (int i = 0; i < numberOfRemovedNodes; ++i)
+    {
+    scene->RemoveNode(nodes[i]);
+    }
+  timer->StopTimer();
+  CHECK_NULL(nodes[numberOfNodes - 1]->GetNodeReference("next"));
+  ReportMeasurement(measurements, "RemoveReferencedNode", numberOfNodes, timer->GetElapsedTime(), numberOfRemovedNodes);
+
+  return EXIT_SUCCESS;
+}
+
+//----------------------------------------------------------------------------
+void CountEvent(vtkObject* vtkNotUsed(caller), unsigned long vtkNotUsed(eid),
+                void* clientData, void* vtkNotUsed(callData))
+{
+  ++(*reinterpret_cast<int*>(clientData));
+}
+
+//----------------------------------------------------------------------------
+int TestEventBroker(MeasurementsType& measurements, int numberOfNodes)
+{
+  vtkEventBroker* broker = vtkEventBroker::GetInstance();
+  vtkNew<vtkMRMLScene> scene;
+  std::vector< vtkSmartPointer<vtkMRMLScriptedModuleNode> > nodes;
+  AddNodes(scene.GetPointer(), numberOfNodes, nodes);
+  vtkNew<vtkTimerLog> timer;
+
+  int numberOfEvents = 0;
+  vtkNew<vtkCallbackCommand> callback;
+  callback->SetCallback(CountEvent);
+  callback->SetClientData(&numberOfEvents);
+  vtkNew<vtkMRMLScriptedModuleNode> observer;
+
+  timer->StartTimer();
+  for (int i = 0; i < numberOfNodes; ++i)
+    {
+    broker->AddObservation(nodes[i], vtkCommand::ModifiedEvent, observer.GetPointer(), callback.GetPointer());
+    }
+  timer->StopTimer();
+  ReportMeasurement(measurements, "AddObservation", numberOfNodes, timer->GetElapsedTime(), numberOfNodes);
+
+  const int numberOfModifiedEvents = 100000;
+  timer->StartTimer();
+  for (int i = 0; i < numberOfModifiedEvents; ++i)
+    {
+    nodes[i % numberOfNodes]->Modified();
+    }
+  timer->StopTimer();
+  CHECK_INT(numberOfEvents, numberOfModifiedEvents);
+  ReportMeasurement(measurements, "InvokeObservedEvent", numberOfNodes, timer->GetElapsedTime(), numberOfModifiedEvents);
+
+  timer->StartTimer();
+  broker->RemoveObservations(observer.GetPointer());
+  timer->StopTimer();
+  ReportMeasurement(measurements, "RemoveObservations", numberOfNodes, timer->GetElapsedTime(), numberOfNodes);
+
+  return EXIT_SUCCESS;
+}
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+int vtkMRMLScenePerformanceTest(int argc, char * argv[] )
+{
+  if (argc < 2)
+    {
+    std::cerr << "Line " << __LINE__
+              << " - Missing parameters !\n"
+              << "Usage: " << argv[0] << " /path/to/temp [/path/to/baseline.json]"
+              << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  MeasurementsType measurements;
+  const int numbersOfNodes[] = { 100, 1000, 10000 };
+  for (int numberOfNodes : numbersOfNodes)
+    {
+    CHECK_EXIT_SUCCESS(TestAddRemoveNodes(measurements, numberOfNodes));
+    CHECK_EXIT_SUCCESS(TestGetNodes(measurements, numberOfNodes));
+    CHECK_EXIT_SUCCESS(TestImportCommit(measurements, numberOfNodes));
+    CHECK_EXIT_SUCCESS(TestUndo(measurements, numberOfNodes));
+    CHECK_EXIT_SUCCESS(TestNodeReferences(measurements, numberOfNodes));
+    CHECK_EXIT_SUCCESS(TestEventBroker(measurements, numberOfNodes));
+    }
+
+  CHECK_EXIT_SUCCESS(measurements.WriteAndCompare(
+    std::string(argv[1]) + "/vtkMRMLScenePerformanceTest.json", argc > 2 ? argv[2] : ""));
+
+  return EXIT_SUCCESS;
+}
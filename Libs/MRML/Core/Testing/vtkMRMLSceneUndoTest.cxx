@@ -0,0 +1,106 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2016 Brigham and Women's Hospital (BWH)
+  All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Program:   3D Slicer
+
+=========================================================================auto=*/
+
+#include "vtkMRMLScalarVolumeNode.h"
+#include "vtkMRMLScene.h"
+#include "vtkMRMLScriptedModuleNode.h"
+
+// VTK includes
+#include <vtkImageData.h>
+
+#include "vtkMRMLCoreTestingMacros.h"
+
+//------------------------------------------------------------------------------
+int vtkMRMLSceneUndoTest(int , char * [] )
+{
+  vtkNew<vtkMRMLScene> scene;
+  scene->SetUndoOn();
+
+  vtkNew<vtkImageData> imageData;
+  imageData->SetDimensions(64, 64, 64);
+  imageData->AllocateScalars(VTK_UNSIGNED_CHAR, 1);
+  vtkNew<vtkMRMLScalarVolumeNode> volumeNode;
+  volumeNode->SetUndoEnabled(true);
+  volumeNode->SetName("A");
+  volumeNode->SetAndObserveImageData(imageData.GetPointer());
+  scene->AddNode(volumeNode.GetPointer());
+  const unsigned long volumeSize = volumeNode->GetContentMemorySize();
+  CHECK_BOOL(volumeSize >= 256, true);
+  CHECK_BOOL(scene->GetNodesMemorySize() >= volumeSize, true);
+
+  // Unmodified nodes share their copy between undo states
+  scene->SaveStateForUndo();
+  unsigned long undoSize = scene->GetUndoStackMemorySize();
+  CHECK_BOOL(undoSize >= volumeSize, true);
+  scene->SaveStateForUndo();
+  CHECK_INT(scene->GetNumberOfUndoLevels(), 2);
+  CHECK_INT(static_cast<int>(scene->GetUndoStackMemorySize()), static_cast<int>(undoSize));
+
+  // Modified nodes are copied
+  volumeNode->SetName("B");
+  scene->SaveStateForUndo();
+  CHECK_INT(scene->GetNumberOfUndoLevels(), 3);
+  CHECK_INT(static_cast<int>(scene->GetUndoStackMemorySize()), static_cast<int>(2 * undoSize));
+  // Bulk data modified in-place must not reuse the last copy
+  imageData->Modified();
+  scene->SaveStateForUndo();
+  CHECK_INT(static_cast<int>(scene->GetUndoStackMemorySize()), static_cast<int>(3 * undoSize));
+
+  volumeNode->SetName("C");
+  scene->Undo();
+  CHECK_STRING(volumeNode->GetName(), "B");
+  scene->Undo();
+  CHECK_STRING(volumeNode->GetName(), "B");
+  scene->Undo();
+  CHECK_STRING(volumeNode->GetName(), "A");
+  scene->Redo();
+  CHECK_STRING(volumeNode->GetName(), "B");
+
+  // Memory limit removes the oldest states but keeps the most recent one
+  scene->ClearUndoStack();
+  scene->ClearRedoStack();
+  scene->SetMaximumUndoStackMemorySize(static_cast<unsigned long>(undoSize * 1.5));
+  scene->SaveStateForUndo();
+  volumeNode->SetName("D");
+  scene->SaveStateForUndo();
+  CHECK_INT(scene->GetNumberOfUndoLevels(), 1);
+  scene->SetMaximumUndoStackMemorySize(0);
+  scene->SaveStateForUndo();
+  CHECK_INT(scene->GetNumberOfUndoLevels(), 2);
+  volumeNode->SetName("E");
+  scene->Undo();
+  CHECK_STRING(volumeNode->GetName(), "D");
+
+  // Nodes removed after a state was saved are restored
+  scene->SaveStateForUndo();
+  scene->RemoveNode(volumeNode.GetPointer());
+  CHECK_NULL(scene->GetFirstNodeByName("D"));
+  scene->Undo();
+  CHECK_NOT_NULL(scene->GetFirstNodeByName("D"));
+
+  // Nodes that do not track their content modification time are copied in
+  // every undo state, as their content may change without modifying them.
+  vtkNew<vtkMRMLScene> untrackedScene;
+  untrackedScene->SetUndoOn();
+  vtkNew<vtkMRMLScriptedModuleNode> scriptedNode;
+  scriptedNode->SetUndoEnabled(true);
+  CHECK_BOOL(scriptedNode->IsContentMTimeTracked(), false);
+  CHECK_BOOL(volumeNode->IsContentMTimeTracked(), true);
+  untrackedScene->AddNode(scriptedNode.GetPointer());
+  untrackedScene->SaveStateForUndo();
+  const unsigned long untrackedUndoSize = untrackedScene->GetUndoStackMemorySize();
+  CHECK_BOOL(untrackedUndoSize > 0, true);
+  untrackedScene->SaveStateForUndo();
+  CHECK_INT(static_cast<int>(untrackedScene->GetUndoStackMemorySize()), static_cast<int>(2 * untrackedUndoSize));
+
+  return EXIT_SUCCESS;
+}
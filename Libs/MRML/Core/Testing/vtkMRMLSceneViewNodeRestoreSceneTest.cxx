@@ -35,6 +35,7 @@ namespace
 vtkMRMLScene* createScene();
 int restoreEditAndRestore();
 int removeRestoreEditAndRestore();
+int restoreUnchangedNodes();
 
 } // end of anonymous namespace
 
@@ -44,6 +45,7 @@ int vtkMRMLSceneViewNodeRestoreSceneTest(int vtkNotUsed(argc),
 {
   CHECK_EXIT_SUCCESS(restoreEditAndRestore());
   CHECK_EXIT_SUCCESS(removeRestoreEditAndRestore());
+  CHECK_EXIT_SUCCESS(restoreUnchangedNodes());
   return EXIT_SUCCESS;
 }
 
@@ -125,4 +127,36 @@ int removeRestoreEditAndRestore()
   return EXIT_SUCCESS;
 }
 
+//---------------------------------------------------------------------------
+int restoreUnchangedNodes()
+{
+  vtkSmartPointer<vtkMRMLScene> scene;
+  scene.TakeReference(createScene());
+
+  vtkNew<vtkMRMLSceneViewNode> sceneViewNode;
+  scene->AddNode(sceneViewNode.GetPointer());
+
+  sceneViewNode->StoreScene();
+
+  vtkMRMLScalarVolumeNode* volumeNode = vtkMRMLScalarVolumeNode::SafeDownCast(
+    scene->GetNodeByID("vtkMRMLScalarVolumeNode1"));
+  vtkMRMLScalarVolumeDisplayNode* displayNode = vtkMRMLScalarVolumeDisplayNode::SafeDownCast(
+    scene->GetNodeByID("vtkMRMLScalarVolumeDisplayNode1"));
+  displayNode->SetWindowLevel(100., 50.);
+  vtkMTimeType volumeMTime = volumeNode->GetMTime();
+
+  sceneViewNode->RestoreScene();
+
+  // Only the modified node is restored
+  CHECK_BOOL(volumeNode->GetMTime() == volumeMTime, true);
+  CHECK_BOOL(displayNode->GetWindow() != 100., true);
+
+  // Nodes restored from the scene view are not copied again
+  vtkMTimeType displayMTime = displayNode->GetMTime();
+  sceneViewNode->RestoreScene();
+  CHECK_BOOL(displayNode->GetMTime() == displayMTime, true);
+
+  return EXIT_SUCCESS;
+}
+
 } // end of anonymous namespace
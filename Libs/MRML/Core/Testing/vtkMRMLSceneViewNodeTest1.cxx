@@ -14,12 +14,51 @@
 #include "vtkMRMLCoreTestingMacros.h"
 #include "vtkMRMLScene.h"
 #include "vtkMRMLSceneViewNode.h"
+#include "vtkMRMLScriptedModuleNode.h"
 
 // VTK includes
 #include <vtkCollection.h>
 #include <vtkImageData.h>
 #include <vtkNew.h>
 
+//----------------------------------------------------------------------------
+namespace
+{
+
+//----------------------------------------------------------------------------
+int TestCopyThenClearSource()
+{
+  vtkNew<vtkMRMLScene> scene;
+  vtkNew<vtkMRMLScriptedModuleNode> scriptedNode;
+  scene->AddNode(scriptedNode.GetPointer());
+  std::string scriptedNodeID = scriptedNode->GetID();
+
+  vtkNew<vtkMRMLSceneViewNode> sourceSceneView;
+  scene->AddNode(sourceSceneView.GetPointer());
+  sourceSceneView->StoreScene();
+  CHECK_NOT_NULL(sourceSceneView->GetStoredScene());
+  CHECK_NOT_NULL(sourceSceneView->GetStoredScene()->GetNodeByID(scriptedNodeID.c_str()));
+
+  vtkNew<vtkMRMLSceneViewNode> copiedSceneView;
+  copiedSceneView->Copy(sourceSceneView.GetPointer());
+  CHECK_NOT_NULL(copiedSceneView->GetStoredScene());
+
+  // The copied scene view shares the snapshot nodes of the source scene view,
+  // they must stay valid after the source snapshot is cleared.
+  sourceSceneView->GetStoredScene()->Clear(1);
+  CHECK_NULL(sourceSceneView->GetStoredScene()->GetNodeByID(scriptedNodeID.c_str()));
+
+  vtkMRMLNode* copiedNode = copiedSceneView->GetStoredScene()->GetNodeByID(scriptedNodeID.c_str());
+  CHECK_NOT_NULL(copiedNode);
+  CHECK_STRING(copiedNode->GetID(), scriptedNodeID.c_str());
+  CHECK_STRING(copiedNode->GetClassName(), "vtkMRMLScriptedModuleNode");
+
+  return EXIT_SUCCESS;
+}
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
 int vtkMRMLSceneViewNodeTest1(int , char * [] )
 {
   vtkNew<vtkMRMLSceneViewNode> node1;
@@ -60,5 +99,7 @@ int vtkMRMLSceneViewNodeTest1(int , char * [] )
   col->RemoveAllItems();
   col->Delete();
 
+  CHECK_EXIT_SUCCESS(TestCopyThenClearSource());
+
   return EXIT_SUCCESS;
 }
@@ -0,0 +1,179 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2016 Brigham and Women's Hospital (BWH)
+  All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Program:   3D Slicer
+
+=========================================================================auto=*/
+
+// MRML includes
+#include "vtkMRMLCoreTestingMacros.h"
+#include "vtkMRMLCoreTestingUtilities.h"
+#include "vtkMRMLScene.h"
+#include "vtkMRMLSegmentationNode.h"
+#include "vtkMRMLSegmentationStorageNode.h"
+
+// SegmentationCore includes
+#include <vtkOrientedImageData.h>
+#include <vtkSegmentation.h>
+#include <vtkSegmentationConverter.h>
+
+// VTK includes
+#include <vtkNew.h>
+#include <vtkSmartPointer.h>
+#include <vtkTimerLog.h>
+
+// STD includes
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Measures the time of segmentation node operations on large labelmaps:
+// adding segments, merging them into a single labelmap, copying the node (as for
+// undo or sequence recording) and writing/reading the segmentation file.
+//
+// Each segment is a sphere, so that segments overlap and shared labelmap layers
+// have to be computed as in real segmentations.
+//
+// Measurements are written into <temp>/vtkMRMLSegmentationPerformanceTest.json.
+// If a baseline file is specified as second argument then the test fails if a
+// measurement is larger than baseline * (1 + tolerance),
+// see vtkMRMLCoreTestingUtilities::PerformanceMeasurements.
+//
+// Usage: vtkMRMLSegmentationPerformanceTest /path/to/temp [/path/to/baseline.json]
+
+namespace
+{
+
+typedef vtkMRMLCoreTestingUtilities::PerformanceMeasurements MeasurementsType;
+
+//----------------------------------------------------------------------------
+void ReportMeasurement(MeasurementsType& measurements, const std::string& name,
+                       int imageSize, int numberOfSegments, double elapsedTime)
+{
+  std::stringstream ss;
+  ss << "vtkMRMLSegmentationNode-" << name << "-" << imageSize << "-" << numberOfSegments << "-milliseconds";
+  measurements.Report(ss.str(), elapsedTime * 1000.0);
+}
+
+//----------------------------------------------------------------------------
+void CreateSphereLabelmap(vtkOrientedImageData* image, int imageSize, int segmentIndex, int numberOfSegments)
+{
+  image->SetExtent(0, imageSize - 1, 0, imageSize - 1, 0, imageSize - 1);
+  image->AllocateScalars(VTK_UNSIGNED_CHAR, 1);
+  // spheres are placed along the diagonal of the image, neighbors overlap
+  double radius = imageSize * 0.2;
+  double position = radius + (imageSize - 1 - 2.0 * radius) * segmentIndex / std::max(numberOfSegments - 1, 1);
+  unsigned char* ptr = static_cast<unsigned char*>(image->GetScalarPointer());
+  for (int k = 0; k < imageSize; ++k)
+    {
+    for (int j = 0; j < imageSize; ++j)
+      {
+      for (int i = 0; i < imageSize; ++i, ++ptr)
+        {
+        double distance2 = (i - position) * (i - position)
+          + (j - position) * (j - position) + (k - position) * (k - position);
+        *ptr = (distance2 <= radius * radius ? 1 : 0);
+        }
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+int TestSegmentationNode(MeasurementsType& measurements, const std::string& tempDir,
+                         int imageSize, int numberOfSegments)
+{
+  vtkNew<vtkMRMLScene> scene;
+  vtkNew<vtkMRMLSegmentationNode> segmentationNode;
+  scene->AddNode(segmentationNode.GetPointer());
+  CHECK_BOOL(segmentationNode->SetMasterRepresentationToBinaryLabelmap(), true);
+
+  std::vector< vtkSmartPointer<vtkOrientedImageData> > labelmaps;
+  for (int i = 0; i < numberOfSegments; ++i)
+    {
+    vtkSmartPointer<vtkOrientedImageData> labelmap = vtkSmartPointer<vtkOrientedImageData>::New();
+    CreateSphereLabelmap(labelmap, imageSize, i, numberOfSegments);
+    labelmaps.push_back(labelmap);
+    }
+  vtkNew<vtkTimerLog> timer;
+
+  timer->StartTimer();
+  for (int i = 0; i < numberOfSegments; ++i)
+    {
+    CHECK_BOOL(segmentationNode->AddSegmentFromBinaryLabelmapRepresentation(labelmaps[i]).empty(), false);
+    }
+  timer->StopTimer();
+  CHECK_INT(segmentationNode->GetSegmentation()->GetNumberOfSegments(), numberOfSegments);
+  ReportMeasurement(measurements, "AddSegmentFromBinaryLabelmap", imageSize, numberOfSegments, timer->GetElapsedTime());
+
+  timer->StartTimer();
+  segmentationNode->GetSegmentation()->CollapseBinaryLabelmaps(false);
+  timer->StopTimer();
+  ReportMeasurement(measurements, "CollapseBinaryLabelmaps", imageSize, numberOfSegments, timer->GetElapsedTime());
+
+  vtkNew<vtkOrientedImageData> mergedLabelmap;
+  timer->StartTimer();
+  CHECK_BOOL(segmentationNode->GenerateMergedLabelmapForAllSegments(mergedLabelmap.GetPointer(),
+    vtkSegmentation::EXTENT_UNION_OF_SEGMENTS), true);
+  timer->StopTimer();
+  ReportMeasurement(measurements, "GenerateMergedLabelmapForAllSegments", imageSize, numberOfSegments,
+    timer->GetElapsedTime());
+
+  vtkNew<vtkMRMLSegmentationNode> segmentationNodeCopy;
+  timer->StartTimer();
+  segmentationNodeCopy->Copy(segmentationNode.GetPointer());
+  timer->StopTimer();
+  CHECK_INT(segmentationNodeCopy->GetSegmentation()->GetNumberOfSegments(), numberOfSegments);
+  ReportMeasurement(measurements, "Copy", imageSize, numberOfSegments, timer->GetElapsedTime());
+
+  std::stringstream fileName;
+  fileName << tempDir << "/vtkMRMLSegmentationPerformanceTest-" << imageSize << "-" << numberOfSegments << ".seg.nrrd";
+  vtkNew<vtkMRMLSegmentationStorageNode> storageNode;
+  scene->AddNode(storageNode.GetPointer());
+  storageNode->SetFileName(fileName.str().c_str());
+  timer->StartTimer();
+  CHECK_INT(storageNode->WriteData(segmentationNode.GetPointer()), 1);
+  timer->StopTimer();
+  ReportMeasurement(measurements, "WriteData", imageSize, numberOfSegments, timer->GetElapsedTime());
+
+  vtkNew<vtkMRMLSegmentationNode> readSegmentationNode;
+  scene->AddNode(readSegmentationNode.GetPointer());
+  timer->StartTimer();
+  CHECK_INT(storageNode->ReadData(readSegmentationNode.GetPointer()), 1);
+  timer->StopTimer();
+  CHECK_INT(readSegmentationNode->GetSegmentation()->GetNumberOfSegments(), numberOfSegments);
+  ReportMeasurement(measurements, "ReadData", imageSize, numberOfSegments, timer->GetElapsedTime());
+
+  return EXIT_SUCCESS;
+}
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+int vtkMRMLSegmentationPerformanceTest(int argc, char * argv[] )
+{
+  if (argc < 2)
+    {
+    std::cerr << "Line " << __LINE__
+              << " - Missing parameters !\n"
+              << "Usage: " << argv[0] << " /path/to/temp [/path/to/baseline.json]"
+              << std::endl;
+    return EXIT_FAILURE;
+    }
+  std::string tempDir = argv[1];
+
+  MeasurementsType measurements;
+  CHECK_EXIT_SUCCESS(TestSegmentationNode(measurements, tempDir, 128, 10));
+  CHECK_EXIT_SUCCESS(TestSegmentationNode(measurements, tempDir, 256, 10));
+  CHECK_EXIT_SUCCESS(TestSegmentationNode(measurements, tempDir, 256, 50));
+
+  CHECK_EXIT_SUCCESS(measurements.WriteAndCompare(
+    tempDir + "/vtkMRMLSegmentationPerformanceTest.json", argc > 2 ? argv[2] : ""));
+
+  return EXIT_SUCCESS;
+}
@@ -20,9 +20,11 @@ Care Ontario.
 
 // MRML includes
 #include "vtkMRMLCoreTestingMacros.h"
+#include "vtkMRMLLabelMapVolumeNode.h"
 #include "vtkMRMLScene.h"
 #include "vtkMRMLSegmentationNode.h"
 #include "vtkMRMLSegmentationStorageNode.h"
+#include "vtkMRMLVolumeArchetypeStorageNode.h"
 #include "vtkSegmentationConverterFactory.h"
 
 // Converter rules
@@ -32,6 +34,30 @@ Care Ontario.
 #include "vtkFractionalLabelmapToClosedSurfaceConversionRule.h"
 #include "vtkClosedSurfaceToFractionalLabelmapConversionRule.h"
 
+// VTK includes
+#include <vtkDataArray.h>
+#include <vtkImageData.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+
+namespace
+{
+//---------------------------------------------------------------------------
+void FillBox(vtkImageData* imageData, const int box[6], unsigned char value)
+{
+  for (int k = box[4]; k <= box[5]; ++k)
+    {
+    for (int j = box[2]; j <= box[3]; ++j)
+      {
+      for (int i = box[0]; i <= box[1]; ++i)
+        {
+        *static_cast<unsigned char*>(imageData->GetScalarPointer(i, j, k)) = value;
+        }
+      }
+    }
+}
+}
+
 int vtkMRMLSegmentationStorageNodeTest1(int argc, char * argv[] )
 {
   vtkNew<vtkMRMLSegmentationStorageNode> node1;
@@ -39,11 +65,11 @@ int vtkMRMLSegmentationStorageNodeTest1(int argc, char * argv[] )
   scene->AddNode(node1.GetPointer());
   EXERCISE_ALL_BASIC_MRML_METHODS(node1.GetPointer());
 
-  if (argc != 4)
+  if (argc != 5)
     {
     std::cerr << "Line " << __LINE__
               << " - Missing parameters !\n"
-              << "Usage: " << argv[0] << " /path/to/ITKSnapSegmentation.nii.gz /path/to/OldSlicerSegmentation.seg.nrrd /path/to/SlicerSegmentation.seg.nrrd"
+              << "Usage: " << argv[0] << " /path/to/ITKSnapSegmentation.nii.gz /path/to/OldSlicerSegmentation.seg.nrrd /path/to/SlicerSegmentation.seg.nrrd /path/to/temp"
               << std::endl;
     return EXIT_FAILURE;
     }
@@ -57,6 +83,7 @@ int vtkMRMLSegmentationStorageNodeTest1(int argc, char * argv[] )
   const char* itkSnapSegmentationFilename = argv[1]; // ITKSnapSegmentation.nii.gz
   const char* oldSlicerSegmentationFilename = argv[2]; // OldSlicerSegmentation.seg.nrrd: Segmentation before shared labelmaps implemented.
   const char* slicerSegmentationFilename = argv[3]; // SlicerSegmentation.seg.nrrd: Segmentation with shared labelmaps.
+  const char* tempDirectory = argv[4];
 
   // Test segmentation exported from ITK-SNAP
   std::cout << "Testing ITK-SNAP segmentation" << std::endl;
@@ -114,5 +141,56 @@ int vtkMRMLSegmentationStorageNodeTest1(int argc, char * argv[] )
     CHECK_INT(numberOfLayers, 2);
   }
 
+  // Test labelmap volume with several labels, each label is expected to become
+  // a segment and all the segments to share the same labelmap
+  std::cout << "Testing labelmap volume" << std::endl;
+  {
+    vtkNew<vtkImageData> imageData;
+    imageData->SetDimensions(30, 20, 10);
+    imageData->AllocateScalars(VTK_UNSIGNED_CHAR, 1);
+    imageData->GetPointData()->GetScalars()->Fill(0);
+    const int box1[6] = { 2, 5, 3, 6, 4, 7 };
+    FillBox(imageData, box1, 1);
+    const int box2[6] = { 10, 12, 10, 15, 1, 2 };
+    FillBox(imageData, box2, 7);
+    const int box3[6] = { 29, 29, 19, 19, 9, 9 };
+    FillBox(imageData, box3, 150);
+
+    vtkNew<vtkMRMLLabelMapVolumeNode> labelmapNode;
+    labelmapNode->SetAndObserveImageData(imageData);
+    scene->AddNode(labelmapNode);
+    vtkNew<vtkMRMLVolumeArchetypeStorageNode> volumeStorageNode;
+    scene->AddNode(volumeStorageNode);
+    std::string labelmapFilename = std::string(tempDirectory) + "/vtkMRMLSegmentationStorageNodeTest1_labelmap.nrrd";
+    volumeStorageNode->SetFileName(labelmapFilename.c_str());
+    CHECK_BOOL(volumeStorageNode->WriteData(labelmapNode) != 0, true);
+
+    vtkNew<vtkMRMLSegmentationNode> segmentationNode;
+    scene->AddNode(segmentationNode);
+    vtkNew<vtkMRMLSegmentationStorageNode> segmentationStorageNode;
+    scene->AddNode(segmentationStorageNode);
+    segmentationStorageNode->SetFileName(labelmapFilename.c_str());
+    CHECK_BOOL(segmentationStorageNode->ReadData(segmentationNode) != 0, true);
+    vtkSegmentation* segmentation = segmentationNode->GetSegmentation();
+    CHECK_INT(segmentation->GetNumberOfSegments(), 3);
+    CHECK_INT(segmentation->GetNumberOfLayers(vtkSegmentationConverter::GetBinaryLabelmapRepresentationName()), 1);
+    CHECK_INT(segmentation->GetNthSegment(0)->GetLabelValue(), 1);
+    CHECK_INT(segmentation->GetNthSegment(1)->GetLabelValue(), 7);
+    CHECK_INT(segmentation->GetNthSegment(2)->GetLabelValue(), 150);
+
+    // Segmentation written with shared labelmaps is read back with the same layers and labels
+    std::string segmentationFilename = std::string(tempDirectory) + "/vtkMRMLSegmentationStorageNodeTest1.seg.nrrd";
+    segmentationStorageNode->SetFileName(segmentationFilename.c_str());
+    CHECK_BOOL(segmentationStorageNode->WriteData(segmentationNode) != 0, true);
+
+    vtkNew<vtkMRMLSegmentationNode> readSegmentationNode;
+    scene->AddNode(readSegmentationNode);
+    CHECK_BOOL(segmentationStorageNode->ReadData(readSegmentationNode) != 0, true);
+    vtkSegmentation* readSegmentation = readSegmentationNode->GetSegmentation();
+    CHECK_INT(readSegmentation->GetNumberOfSegments(), 3);
+    CHECK_INT(readSegmentation->GetNumberOfLayers(vtkSegmentationConverter::GetBinaryLabelmapRepresentationName()), 1);
+    CHECK_INT(readSegmentation->GetNthSegment(2)->GetLabelValue(), 150);
+  }
+
   return EXIT_SUCCESS;
 }
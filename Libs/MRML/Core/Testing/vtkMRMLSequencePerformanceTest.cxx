@@ -0,0 +1,227 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2016 Brigham and Women's Hospital (BWH)
+  All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Program:   3D Slicer
+
+=========================================================================auto=*/
+
+// MRML includes
+#include "vtkMRMLCoreTestingMacros.h"
+#include "vtkMRMLCoreTestingUtilities.h"
+#include "vtkMRMLScalarVolumeNode.h"
+#include "vtkMRMLScene.h"
+#include "vtkMRMLScriptedModuleNode.h"
+#include "vtkMRMLSequenceNode.h"
+
+// VTK includes
+#include <vtkDataArray.h>
+#include <vtkImageData.h>
+#include <vtkMatrix4x4.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkTimerLog.h>
+
+// STD includes
+#include <sstream>
+#include <string>
+
+// Measures the time of sequence operations on sequences of increasing length:
+// recording of parameter nodes, linear transforms and volumes, and lookup of
+// items by index value (as when the sequence browser replays the sequence).
+//
+// Measurements are written into <temp>/vtkMRMLSequencePerformanceTest.json.
+// If a baseline file is specified as second argument then the test fails if a
+// measurement is larger than baseline * (1 + tolerance),
+// see vtkMRMLCoreTestingUtilities::PerformanceMeasurements.
+//
+// Usage: vtkMRMLSequencePerformanceTest /path/to/temp [/path/to/baseline.json]
+
+namespace
+{
+
+typedef vtkMRMLCoreTestingUtilities::PerformanceMeasurements MeasurementsType;
+
+//----------------------------------------------------------------------------
+void ReportMeasurement(MeasurementsType& measurements, const std::string& name,
+                       int numberOfItems, double elapsedTime, int numberOfOperations)
+{
+  std::stringstream ss;
+  ss << "vtkMRMLSequenceNode-" << name << "-" << numberOfItems << "-microseconds-per-operation";
+  measurements.Report(ss.str(), elapsedTime * 1.0e6 / numberOfOperations);
+}
+
+//----------------------------------------------------------------------------
+int TestDataNodes(MeasurementsType& measurements, int numberOfItems)
+{
+  vtkNew<vtkMRMLScene> scene;
+  vtkNew<vtkMRMLSequenceNode> sequenceNode;
+  scene->AddNode(sequenceNode.GetPointer());
+  sequenceNode->SetIndexType(vtkMRMLSequenceNode::NumericIndex);
+  vtkNew<vtkMRMLScriptedModuleNode> parameterNode;
+  vtkNew<vtkTimerLog> timer;
+
+  timer->StartTimer();
+  for (int i = 0; i < numberOfItems; ++i)
+    {
+    parameterNode->SetParameter("Value", std::to_string(i));
+    sequenceNode->SetDataNodeAtValue(parameterNode.GetPointer(), std::to_string(i));
+    }
+  timer->StopTimer();
+  CHECK_INT(sequenceNode->GetNumberOfDataNodes(), numberOfItems);
+  ReportMeasurement(measurements, "SetDataNodeAtValue", numberOfItems, timer->GetElapsedTime(), numberOfItems);
+
+  const int numberOfLookups = 10000;
+  timer->StartTimer();
+  for (int i = 0; i < numberOfLookups; ++i)
+    {
+    if (!sequenceNode->GetDataNodeAtValue(std::to_string(i % numberOfItems)))
+      {
+      std::cerr << "Line " << __LINE__ << " - GetDataNodeAtValue failed" << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+  timer->StopTimer();
+  ReportMeasurement(measurements, "GetDataNodeAtValue", numberOfItems, timer->GetElapsedTime(), numberOfLookups);
+
+  // non-exact match, as when the browser is synchronized with another sequence
+  timer->StartTimer();
+  for (int i = 0; i < numberOfLookups; ++i)
+    {
+    if (sequenceNode->GetItemNumberFromNumericIndexValue((i % numberOfItems) + 0.5, false) != i % numberOfItems)
+      {
+      std::cerr << "Line " << __LINE__ << " - GetItemNumberFromNumericIndexValue failed" << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+  timer->StopTimer();
+  ReportMeasurement(measurements, "GetItemNumberFromNumericIndexValue", numberOfItems,
+    timer->GetElapsedTime(), numberOfLookups);
+
+  timer->StartTimer();
+  for (int i = numberOfItems - 1; i >= 0; --i)
+    {
+    sequenceNode->RemoveDataNodeAtValue(std::to_string(i));
+    }
+  timer->StopTimer();
+  CHECK_INT(sequenceNode->GetNumberOfDataNodes(), 0);
+  ReportMeasurement(measurements, "RemoveDataNodeAtValue", numberOfItems, timer->GetElapsedTime(), numberOfItems);
+
+  return EXIT_SUCCESS;
+}
+
+//----------------------------------------------------------------------------
+int TestMatrices(MeasurementsType& measurements, int numberOfItems)
+{
+  vtkNew<vtkMRMLScene> scene;
+  vtkNew<vtkMRMLSequenceNode> sequenceNode;
+  scene->AddNode(sequenceNode.GetPointer());
+  sequenceNode->SetIndexType(vtkMRMLSequenceNode::NumericIndex);
+  vtkNew<vtkMatrix4x4> matrix;
+  vtkNew<vtkTimerLog> timer;
+
+  timer->StartTimer();
+  for (int i = 0; i < numberOfItems; ++i)
+    {
+    matrix->SetElement(0, 3, i);
+    sequenceNode->SetMatrixAtValue(matrix.GetPointer(), std::to_string(i));
+    }
+  timer->StopTimer();
+  CHECK_INT(sequenceNode->GetNumberOfDataNodes(), numberOfItems);
+  ReportMeasurement(measurements, "SetMatrixAtValue", numberOfItems, timer->GetElapsedTime(), numberOfItems);
+
+  const int numberOfLookups = 10000;
+  timer->StartTimer();
+  for (int i = 0; i < numberOfLookups; ++i)
+    {
+    CHECK_BOOL(sequenceNode->GetNthMatrix(i % numberOfItems, matrix.GetPointer()), true);
+    }
+  timer->StopTimer();
+  CHECK_DOUBLE(matrix->GetElement(0, 3), (numberOfLookups - 1) % numberOfItems);
+  ReportMeasurement(measurements, "GetNthMatrix", numberOfItems, timer->GetElapsedTime(), numberOfLookups);
+
+  // replay creates transform nodes on demand
+  timer->StartTimer();
+  for (int i = 0; i < numberOfItems; ++i)
+    {
+    CHECK_NOT_NULL(sequenceNode->GetNthDataNode(i));
+    }
+  timer->StopTimer();
+  ReportMeasurement(measurements, "GetNthDataNodeFromMatrix", numberOfItems, timer->GetElapsedTime(), numberOfItems);
+
+  return EXIT_SUCCESS;
+}
+
+//----------------------------------------------------------------------------
+int TestVolumes(MeasurementsType& measurements, int numberOfItems)
+{
+  vtkNew<vtkMRMLScene> scene;
+  vtkNew<vtkMRMLSequenceNode> sequenceNode;
+  scene->AddNode(sequenceNode.GetPointer());
+  sequenceNode->SetIndexType(vtkMRMLSequenceNode::NumericIndex);
+
+  const int volumeSize = 64;
+  vtkNew<vtkImageData> imageData;
+  imageData->SetDimensions(volumeSize, volumeSize, volumeSize);
+  imageData->AllocateScalars(VTK_SHORT, 1);
+  imageData->GetPointData()->GetScalars()->FillComponent(0, 0.0);
+  vtkNew<vtkMRMLScalarVolumeNode> volumeNode;
+  volumeNode->SetAndObserveImageData(imageData.GetPointer());
+  vtkNew<vtkTimerLog> timer;
+
+  timer->StartTimer();
+  for (int i = 0; i < numberOfItems; ++i)
+    {
+    imageData->Modified();
+    sequenceNode->SetDataNodeAtValue(volumeNode.GetPointer(), std::to_string(i));
+    }
+  timer->StopTimer();
+  CHECK_INT(sequenceNode->GetNumberOfDataNodes(), numberOfItems);
+  ReportMeasurement(measurements, "SetVolumeAtValue", numberOfItems, timer->GetElapsedTime(), numberOfItems);
+
+  vtkNew<vtkMRMLScalarVolumeNode> proxyNode;
+  timer->StartTimer();
+  for (int i = 0; i < numberOfItems; ++i)
+    {
+    // same as the proxy node update of the sequence browser
+    proxyNode->CopyContent(sequenceNode->GetNthDataNode(i), true);
+    }
+  timer->StopTimer();
+  CHECK_NOT_NULL(proxyNode->GetImageData());
+  ReportMeasurement(measurements, "UpdateVolumeProxyNode", numberOfItems, timer->GetElapsedTime(), numberOfItems);
+
+  return EXIT_SUCCESS;
+}
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+int vtkMRMLSequencePerformanceTest(int argc, char * argv[] )
+{
+  if (argc < 2)
+    {
+    std::cerr << "Line " << __LINE__
+              << " - Missing parameters !\n"
+              << "Usage: " << argv[0] << " /path/to/temp [/path/to/baseline.json]"
+              << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  MeasurementsType measurements;
+  const int numbersOfItems[] = { 100, 1000, 10000 };
+  for (int numberOfItems : numbersOfItems)
+    {
+    CHECK_EXIT_SUCCESS(TestDataNodes(measurements, numberOfItems));
+    CHECK_EXIT_SUCCESS(TestMatrices(measurements, numberOfItems));
+    }
+  CHECK_EXIT_SUCCESS(TestVolumes(measurements, 100));
+
+  CHECK_EXIT_SUCCESS(measurements.WriteAndCompare(
+    std::string(argv[1]) + "/vtkMRMLSequencePerformanceTest.json", argc > 2 ? argv[2] : ""));
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,124 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2017 Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Program:   3D Slicer
+
+=========================================================================auto=*/
+
+// MRML includes
+#include "vtkDataIOManager.h"
+#include "vtkDataTransfer.h"
+#include "vtkMRMLCoreTestingMacros.h"
+#include "vtkMRMLModelNode.h"
+#include "vtkMRMLModelStorageNode.h"
+#include "vtkMRMLScalarVolumeNode.h"
+#include "vtkMRMLScene.h"
+#include "vtkMRMLVolumeArchetypeStorageNode.h"
+
+// VTK includes
+#include <vtkImageData.h>
+#include <vtkNew.h>
+#include <vtkSphereSource.h>
+
+// VTKSYS includes
+#include <vtksys/SystemTools.hxx>
+
+// STD includes
+#include <cmath>
+
+//---------------------------------------------------------------------------
+int vtkMRMLStorageNodeBackgroundWriteTest(int argc, char * argv[])
+{
+  if (argc != 2)
+    {
+    std::cerr << "Usage: " << argv[0] << " /path/to/temp" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  vtkNew<vtkMRMLScene> scene;
+  scene->SetRootDirectory(argv[1]);
+  vtkNew<vtkDataIOManager> dataIOManager;
+  scene->SetDataIOManager(dataIOManager);
+  CHECK_INT(dataIOManager->GetNumberOfWriteThreads(), 2);
+
+  vtkNew<vtkImageData> imageData;
+  imageData->SetDimensions(64, 64, 64);
+  imageData->AllocateScalars(VTK_SHORT, 1);
+  short* voxels = static_cast<short*>(imageData->GetScalarPointer());
+  for (vtkIdType i = 0; i < 64 * 64 * 64; ++i)
+    {
+    voxels[i] = static_cast<short>(i % 1000);
+    }
+  vtkNew<vtkMRMLScalarVolumeNode> volumeNode;
+  volumeNode->SetAndObserveImageData(imageData);
+  volumeNode->SetOrigin(10.0, 20.0, 30.0);
+  scene->AddNode(volumeNode);
+  vtkNew<vtkMRMLVolumeArchetypeStorageNode> storageNode;
+  scene->AddNode(storageNode);
+  volumeNode->SetAndObserveStorageNodeID(storageNode->GetID());
+  std::string fileName = std::string(argv[1]) + "/vtkMRMLStorageNodeBackgroundWriteTest.nrrd";
+  vtksys::SystemTools::RemoveFile(fileName);
+  storageNode->SetFileName(fileName.c_str());
+
+  // Modifying the node while it is written does not change the written data
+  // and the node remains modified since read
+  vtkDataTransfer* transfer = dataIOManager->WriteDataInBackground(volumeNode, storageNode);
+  CHECK_NOT_NULL(transfer);
+  CHECK_INT(transfer->GetTransferType(), vtkDataTransfer::LocalSave);
+  volumeNode->SetOrigin(-10.0, -20.0, -30.0);
+  dataIOManager->WaitForBackgroundWrites();
+  CHECK_INT(dataIOManager->GetNumberOfPendingBackgroundWrites(), 0);
+  CHECK_INT(transfer->GetTransferStatus(), vtkDataTransfer::Completed);
+  CHECK_INT(transfer->GetProgress(), 100);
+  CHECK_BOOL(vtksys::SystemTools::FileExists(fileName, true), true);
+  CHECK_BOOL(volumeNode->GetModifiedSinceRead(), true);
+
+  vtkNew<vtkMRMLScalarVolumeNode> readVolumeNode;
+  scene->AddNode(readVolumeNode);
+  vtkNew<vtkMRMLVolumeArchetypeStorageNode> readStorageNode;
+  scene->AddNode(readStorageNode);
+  readStorageNode->SetFileName(fileName.c_str());
+  CHECK_BOOL(readStorageNode->ReadData(readVolumeNode) != 0, true);
+  double readOrigin[3] = { 0.0, 0.0, 0.0 };
+  readVolumeNode->GetOrigin(readOrigin);
+  if (fabs(readOrigin[0] - 10.0) > 1e-6 || fabs(readOrigin[2] - 30.0) > 1e-6)
+    {
+    std::cerr << "Line " << __LINE__ << ": the volume was not written from the snapshot" << std::endl;
+    return EXIT_FAILURE;
+    }
+  short* readVoxels = static_cast<short*>(readVolumeNode->GetImageData()->GetScalarPointer());
+  for (vtkIdType i = 0; i < 64 * 64 * 64; ++i)
+    {
+    if (readVoxels[i] != voxels[i])
+      {
+      std::cerr << "Line " << __LINE__ << ": voxel mismatch at " << i << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  // Writing again without modification makes the node unmodified
+  CHECK_NOT_NULL(dataIOManager->WriteDataInBackground(volumeNode, storageNode));
+  dataIOManager->WaitForBackgroundWrites();
+  CHECK_BOOL(volumeNode->GetModifiedSinceRead(), false);
+
+  // OBJ files are written from the main thread only
+  vtkNew<vtkSphereSource> sphere;
+  sphere->Update();
+  vtkNew<vtkMRMLModelNode> modelNode;
+  modelNode->SetAndObservePolyData(sphere->GetOutput());
+  scene->AddNode(modelNode);
+  vtkNew<vtkMRMLModelStorageNode> modelStorageNode;
+  scene->AddNode(modelStorageNode);
+  modelStorageNode->SetFileName((std::string(argv[1]) + "/vtkMRMLStorageNodeBackgroundWriteTest.obj").c_str());
+  CHECK_NULL(dataIOManager->WriteDataInBackground(modelNode, modelStorageNode));
+  modelStorageNode->SetFileName((std::string(argv[1]) + "/vtkMRMLStorageNodeBackgroundWriteTest.vtk").c_str());
+  CHECK_NOT_NULL(dataIOManager->WriteDataInBackground(modelNode, modelStorageNode));
+  dataIOManager->WaitForBackgroundWrites();
+  CHECK_BOOL(modelNode->GetModifiedSinceRead(), false);
+
+  return EXIT_SUCCESS;
+}
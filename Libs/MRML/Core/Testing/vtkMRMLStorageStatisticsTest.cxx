@@ -0,0 +1,105 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2017 Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Program:   3D Slicer
+
+=========================================================================auto=*/
+
+// MRML includes
+#include "vtkMRMLCoreTestingMacros.h"
+#include "vtkMRMLModelNode.h"
+#include "vtkMRMLModelStorageNode.h"
+#include "vtkMRMLScene.h"
+
+// VTK includes
+#include <vtkNew.h>
+#include <vtkPolyData.h>
+#include <vtkSphereSource.h>
+
+// VTKSYS includes
+#include <vtksys/SystemTools.hxx>
+
+//---------------------------------------------------------------------------
+int vtkMRMLStorageStatisticsTest(int argc, char * argv[])
+{
+  if (argc != 2)
+    {
+    std::cerr << "Usage: " << argv[0] << " /path/to/temp" << std::endl;
+    return EXIT_FAILURE;
+    }
+  std::string tempDir = argv[1];
+
+  vtkNew<vtkMRMLScene> scene;
+  CHECK_INT(scene->GetStorageStatisticsNumberOfReads(), 0);
+  CHECK_INT(scene->GetStorageStatisticsNumberOfWrites(), 0);
+
+  vtkNew<vtkSphereSource> sphere;
+  sphere->SetThetaResolution(50);
+  sphere->SetPhiResolution(50);
+  sphere->Update();
+  vtkMRMLModelNode* modelNode = vtkMRMLModelNode::SafeDownCast(scene->AddNewNodeByClass("vtkMRMLModelNode"));
+  modelNode->SetAndObservePolyData(sphere->GetOutput());
+
+  const char* extensions[2] = { ".vtk", ".bmesh" };
+  vtkTypeInt64 totalFileSize = 0;
+  for (const char* extension : extensions)
+    {
+    std::string fileName = tempDir + "/vtkMRMLStorageStatisticsTest" + extension;
+    vtksys::SystemTools::RemoveFile(fileName);
+
+    vtkMRMLModelStorageNode* writer = vtkMRMLModelStorageNode::SafeDownCast(
+      scene->AddNewNodeByClass("vtkMRMLModelStorageNode"));
+    writer->SetFileName(fileName.c_str());
+    CHECK_INT(writer->WriteData(modelNode), 1);
+    vtkTypeInt64 fileSize = static_cast<vtkTypeInt64>(vtksys::SystemTools::FileLength(fileName));
+    CHECK_BOOL(fileSize > 0, true);
+    CHECK_BOOL(writer->GetLastIOFileSize() == fileSize, true);
+    CHECK_STD_STRING(writer->GetLastIOFileFormat(), extension);
+    CHECK_BOOL(writer->GetLastIOTime() >= 0.0, true);
+    totalFileSize += fileSize;
+
+    // Read into a new node
+    vtkMRMLModelNode* readModelNode = vtkMRMLModelNode::SafeDownCast(scene->AddNewNodeByClass("vtkMRMLModelNode"));
+    vtkMRMLModelStorageNode* reader = vtkMRMLModelStorageNode::SafeDownCast(
+      scene->AddNewNodeByClass("vtkMRMLModelStorageNode"));
+    reader->SetFileName(fileName.c_str());
+    CHECK_INT(reader->ReadData(readModelNode), 1);
+    CHECK_BOOL(reader->GetLastIOFileSize() == fileSize, true);
+    CHECK_STD_STRING(reader->GetLastIOFileFormat(), extension);
+    CHECK_BOOL(reader->GetLastIODecompressionTime() >= 0.0, true);
+    CHECK_BOOL(reader->GetLastIODecompressionTime() <= reader->GetLastIOTime(), true);
+    }
+
+  CHECK_INT(scene->GetStorageStatisticsNumberOfReads(), 2);
+  CHECK_INT(scene->GetStorageStatisticsNumberOfWrites(), 2);
+  CHECK_BOOL(scene->GetStorageStatisticsBytesRead() == totalFileSize, true);
+  CHECK_BOOL(scene->GetStorageStatisticsBytesWritten() == totalFileSize, true);
+  CHECK_BOOL(scene->GetStorageStatisticsReadTime() >= scene->GetStorageStatisticsDecompressionTime(), true);
+
+  std::string report = scene->GetStorageStatisticsReport();
+  std::cout << report << std::endl;
+  CHECK_BOOL(report.find(".vtk\t1\t") != std::string::npos, true);
+  CHECK_BOOL(report.find(".bmesh\t1\t") != std::string::npos, true);
+  CHECK_BOOL(report.find("Total\t2\t") != std::string::npos, true);
+
+  // Failed read is recorded as well
+  vtkMRMLModelStorageNode* invalidReader = vtkMRMLModelStorageNode::SafeDownCast(
+    scene->AddNewNodeByClass("vtkMRMLModelStorageNode"));
+  invalidReader->SetFileName((tempDir + "/vtkMRMLStorageStatisticsTest-nonexistent.vtk").c_str());
+  TESTING_OUTPUT_ASSERT_ERRORS_BEGIN();
+  CHECK_INT(invalidReader->ReadData(modelNode), 0);
+  TESTING_OUTPUT_ASSERT_ERRORS_END();
+  CHECK_INT(scene->GetStorageStatisticsNumberOfReads(), 3);
+  CHECK_BOOL(invalidReader->GetLastIOFileSize() == 0, true);
+
+  scene->ResetStorageStatistics();
+  CHECK_INT(scene->GetStorageStatisticsNumberOfReads(), 0);
+  CHECK_BOOL(scene->GetStorageStatisticsBytesWritten() == 0, true);
+
+  std::cout << "Success." << std::endl;
+  return EXIT_SUCCESS;
+}
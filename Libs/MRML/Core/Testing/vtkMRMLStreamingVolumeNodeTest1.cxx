@@ -23,6 +23,56 @@ Care Ontario.
 #include "vtkMRMLScene.h"
 #include "vtkMRMLStreamingVolumeNode.h"
 
+// STD includes
+#include <vector>
+
+//----------------------------------------------------------------------------
+int TestDeltaDeflateCodec()
+{
+  int width = 64;
+  int height = 48;
+  vtkNew<vtkImageData> image;
+  image->SetDimensions(width, height, 1);
+  image->AllocateScalars(VTK_SHORT, 1);
+  short* imagePointer = static_cast<short*>(image->GetScalarPointer());
+  for (int i = 0; i < width * height; ++i)
+    {
+    imagePointer[i] = static_cast<short>(i % 1000 - 500);
+    }
+
+  vtkNew<vtkMRMLStreamingVolumeNode> encoderNode;
+  encoderNode->SetCodecFourCC("ZDLT");
+  CHECK_NOT_NULL(encoderNode->GetCodec());
+  encoderNode->SetCodecParameterString("KeyFrameInterval:3");
+
+  // Encode frames with a small moving region, only the first and fourth frames are key frames
+  std::vector< vtkSmartPointer<vtkStreamingVolumeFrame> > frames;
+  for (int frameIndex = 0; frameIndex < 4; ++frameIndex)
+    {
+    imagePointer[frameIndex * 10] = static_cast<short>(1000 + frameIndex);
+    image->Modified();
+    encoderNode->SetAndObserveImageData(image);
+    CHECK_BOOL(encoderNode->EncodeImageData(), true);
+    frames.push_back(encoderNode->GetFrame());
+    CHECK_BOOL(encoderNode->IsKeyFrame(), frameIndex % 3 == 0);
+    }
+  CHECK_BOOL(frames[1]->GetFrameData()->GetNumberOfValues() < frames[0]->GetFrameData()->GetNumberOfValues(), true);
+
+  // Decoding a delta frame decodes the previous frames
+  vtkNew<vtkMRMLStreamingVolumeNode> decoderNode;
+  decoderNode->SetAndObserveFrame(frames[2]);
+  vtkImageData* decodedImage = decoderNode->GetImageData();
+  CHECK_NOT_NULL(decodedImage);
+  short* decodedPointer = static_cast<short*>(decodedImage->GetScalarPointer());
+  CHECK_INT(decodedPointer[0], 1000);
+  CHECK_INT(decodedPointer[20], 1002);
+  CHECK_INT(decodedPointer[30], 30 % 1000 - 500);
+  CHECK_INT(decodedPointer[width * height - 1], (width * height - 1) % 1000 - 500);
+
+  return EXIT_SUCCESS;
+}
+
+//----------------------------------------------------------------------------
 int vtkMRMLStreamingVolumeNodeTest1(int , char * [] )
 {
   vtkNew<vtkMRMLStreamingVolumeNode> node1;
@@ -98,5 +148,7 @@ int vtkMRMLStreamingVolumeNodeTest1(int , char * [] )
       }
     }
 
+  CHECK_EXIT_SUCCESS(TestDeltaDeflateCodec());
+
   return EXIT_SUCCESS;
 }
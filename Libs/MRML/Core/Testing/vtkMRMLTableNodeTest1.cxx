@@ -24,6 +24,7 @@
 #include "vtkMRMLTableNode.h"
 #include "vtkMRMLTableStorageNode.h"
 
+#include "vtkDoubleArray.h"
 #include "vtkStringArray.h"
 #include "vtkTable.h"
 #include "vtkTestErrorObserver.h"
@@ -174,6 +175,53 @@ int vtkMRMLTableNodeTest1(int , char * [] )
   TESTING_OUTPUT_ASSERT_ERRORS_END();
   CHECK_STD_STRING(node2->GetColumnProperty(0, "type"), "string");
 
+  // Test bulk row and column methods
+  vtkNew<vtkMRMLTableNode> node3;
+  scene->AddNode(node3.GetPointer());
+  vtkNew<vtkDoubleArray> doubleArray;
+  doubleArray->SetName("Values");
+  CHECK_NOT_NULL(node3->AddColumn(doubleArray.GetPointer()));
+  CHECK_NOT_NULL(node3->AddColumn());
+  node3->SetColumnNullValue("Values", "-1");
+  node3->SetColumnNullValue("Column 1", "none");
+
+  vtkNew<vtkMRMLCoreTestingUtilities::vtkMRMLNodeCallback> callback;
+  node3->AddObserver(vtkCommand::AnyEvent, callback.GetPointer());
+  CHECK_INT(node3->AddEmptyRows(1000), 0);
+  CHECK_INT(callback->GetNumberOfModified(), 1);
+  CHECK_INT(node3->AddEmptyRows(10), 1000);
+  CHECK_INT(node3->GetNumberOfRows(), 1010);
+  CHECK_DOUBLE(node3->GetCellValue(1009, 0).ToDouble(), -1.0);
+  CHECK_STD_STRING(node3->GetCellText(500, 1), "none");
+  TESTING_OUTPUT_ASSERT_ERRORS_BEGIN();
+  CHECK_INT(node3->AddEmptyRows(0), -1);
+  TESTING_OUTPUT_ASSERT_ERRORS_END();
+
+  // Typed cell access
+  CHECK_BOOL(node3->SetCellValue(3, 0, vtkVariant(2.5)), true);
+  CHECK_DOUBLE(doubleArray->GetValue(3), 2.5);
+  CHECK_BOOL(node3->GetCellValue(3, 0).IsDouble(), true);
+  TESTING_OUTPUT_ASSERT_ERRORS_BEGIN();
+  CHECK_BOOL(node3->GetCellValue(3, 5).IsValid(), false);
+  TESTING_OUTPUT_ASSERT_ERRORS_END();
+
+  // Replace a column without copying values
+  vtkNew<vtkDoubleArray> newValues;
+  newValues->SetNumberOfValues(1010);
+  newValues->FillComponent(0, 7.0);
+  callback->ResetNumberOfEvents();
+  CHECK_BOOL(node3->SetColumn(0, newValues.GetPointer()), true);
+  CHECK_INT(callback->GetNumberOfModified(), 1);
+  CHECK_POINTER(node3->GetTable()->GetColumn(0), newValues.GetPointer());
+  CHECK_STD_STRING(node3->GetColumnName(0), "Values");
+  CHECK_STD_STRING(node3->GetColumnNullValue("Values"), "-1");
+  CHECK_INT(node3->GetNumberOfColumns(), 2);
+  vtkNew<vtkDoubleArray> shortValues;
+  shortValues->SetNumberOfValues(3);
+  TESTING_OUTPUT_ASSERT_ERRORS_BEGIN();
+  CHECK_BOOL(node3->SetColumn(0, shortValues.GetPointer()), false);
+  TESTING_OUTPUT_ASSERT_ERRORS_END();
+
   std::cout << "vtkMRMLTableNodeTest1 completed successfully" << std::endl;
   return EXIT_SUCCESS;
 }
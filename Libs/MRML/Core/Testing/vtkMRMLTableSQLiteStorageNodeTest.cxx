@@ -25,6 +25,8 @@
 #include "vtkMRMLTableSQLiteStorageNode.h"
 
 #include "vtkFloatArray.h"
+#include "vtkIntArray.h"
+#include "vtkStringArray.h"
 #include "vtkTable.h"
 #include "vtkTestErrorObserver.h"
 
@@ -66,6 +68,12 @@ int vtkMRMLTableSQLiteStorageNodeTest(int , char * [] )
   vtkNew<vtkFloatArray> arrS;
   arrS->SetName("Sine");
   table->AddColumn(arrS.GetPointer());
+  vtkNew<vtkIntArray> arrIndex;
+  arrIndex->SetName("Index");
+  table->AddColumn(arrIndex.GetPointer());
+  vtkNew<vtkStringArray> arrLabel;
+  arrLabel->SetName("Point label");
+  table->AddColumn(arrLabel.GetPointer());
 
   // add few  points...
   int numPoints = 29;
@@ -76,6 +84,8 @@ int vtkMRMLTableSQLiteStorageNodeTest(int , char * [] )
     table->SetValue(i, 0, i * inc);
     table->SetValue(i, 1, cos(i * inc) + 0.0);
     table->SetValue(i, 2, sin(i * inc) + 0.0);
+    table->SetValue(i, 3, i);
+    table->SetValue(i, 4, vtkVariant(std::string("P'") + vtkVariant(i).ToString()));
     }
 
   tableNode->SetAndObserveTable(table.GetPointer());
@@ -97,7 +107,7 @@ int vtkMRMLTableSQLiteStorageNodeTest(int , char * [] )
   // read table from the database
   storageNode->ReadData(tableNode.GetPointer());
 
-  if (tableNode->GetNumberOfColumns() != 3)
+  if (tableNode->GetNumberOfColumns() != 5)
     {
     std::cerr << "Unable to read table columns from the database " << storageNode->GetFileName() <<std::endl;
     removeFile(storageNode->GetFileName());
@@ -111,6 +121,20 @@ int vtkMRMLTableSQLiteStorageNodeTest(int , char * [] )
     return EXIT_FAILURE;
     }
 
+  // column types are preserved
+  CHECK_INT(tableNode->GetTable()->GetColumn(0)->GetDataType(), VTK_FLOAT);
+  CHECK_INT(tableNode->GetTable()->GetColumn(3)->GetDataType(), VTK_INT);
+  CHECK_INT(tableNode->GetTable()->GetColumn(4)->GetDataType(), VTK_STRING);
+  CHECK_STD_STRING(tableNode->GetColumnName(4), "Point label");
+  CHECK_INT(tableNode->GetTable()->GetValue(12, 3).ToInt(), 12);
+  CHECK_STD_STRING(tableNode->GetCellText(12, 4), "P'12");
+
+  // read a subset of the rows
+  storageNode->SetWhereClause("\"Index\" >= 20");
+  CHECK_INT(storageNode->ReadData(tableNode.GetPointer()), 1);
+  CHECK_INT(tableNode->GetNumberOfRows(), numPoints - 20);
+  CHECK_INT(tableNode->GetTable()->GetValue(0, 3).ToInt(), 20);
+
   // clean up
   removeFile(storageNode->GetFileName());
 
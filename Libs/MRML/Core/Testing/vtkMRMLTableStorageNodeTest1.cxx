@@ -25,15 +25,22 @@
 #include "vtkMRMLTableNode.h"
 #include "vtkMRMLTableStorageNode.h"
 #include "vtkDoubleArray.h"
+#include "vtkIntArray.h"
 #include "vtkStringArray.h"
 #include "vtkTable.h"
 
 #include <vtksys/SystemTools.hxx>
 
+// STD includes
+#include <cmath>
+#include <fstream>
+
 //---------------------------------------------------------------------------
 int TestReadWriteWithoutSchema(vtkMRMLScene* scene);
 int TestReadWriteWithSchema(vtkMRMLScene* scene);
 int TestReadWriteData(vtkMRMLScene* scene, const char *extension, vtkTable* table, bool schemaExpected);
+int TestReadDetectColumnTypes(vtkMRMLScene* scene);
+int TestReadMaximumNumberOfRows(vtkMRMLScene* scene);
 
 int vtkMRMLTableStorageNodeTest1(int argc, char * argv[])
 {
@@ -52,6 +59,8 @@ int vtkMRMLTableStorageNodeTest1(int argc, char * argv[])
 
   CHECK_EXIT_SUCCESS(TestReadWriteWithoutSchema(scene.GetPointer()));
   CHECK_EXIT_SUCCESS(TestReadWriteWithSchema(scene.GetPointer()));
+  CHECK_EXIT_SUCCESS(TestReadDetectColumnTypes(scene.GetPointer()));
+  CHECK_EXIT_SUCCESS(TestReadMaximumNumberOfRows(scene.GetPointer()));
 
   std::cout << "Test passed." << std::endl;
   return EXIT_SUCCESS;
@@ -186,3 +195,104 @@ int TestReadWriteData(vtkMRMLScene* scene, const char *extension, vtkTable* tabl
     }
   return EXIT_SUCCESS;
 }
+
+//---------------------------------------------------------------------------
+int TestReadDetectColumnTypes(vtkMRMLScene* scene)
+{
+  std::string fileName = std::string(scene->GetRootDirectory()) + "/vtkMRMLTableStorageNodeTest1Detect.csv";
+  vtksys::SystemTools::RemoveFile(fileName);
+  // enough rows for parsing on multiple threads, a value in the last row
+  // does not match the type detected from the first rows
+  const int numberOfRows = 5000;
+  {
+  std::ofstream file(fileName.c_str());
+  file << "id,value,label,\"quoted, name\",mixed\r\n";
+  for (int row = 0; row < numberOfRows; ++row)
+    {
+    file << row << "," << row * 0.5 << ",\"a \"\"" << row << "\"\"\",x," << (row < numberOfRows - 1 ? "1" : "1.5") << "\r\n";
+    }
+  }
+
+  vtkNew<vtkMRMLTableNode> tableNode;
+  scene->AddNode(tableNode.GetPointer());
+  vtkNew<vtkMRMLTableStorageNode> storageNode;
+  scene->AddNode(storageNode.GetPointer());
+  storageNode->SetFileName(fileName.c_str());
+  storageNode->SetNumberOfReadThreads(4);
+
+  // Without type detection all columns are strings
+  CHECK_BOOL(storageNode->GetAutoDetectColumnTypes(), false);
+  CHECK_BOOL(storageNode->ReadData(tableNode.GetPointer()) != 0, true);
+  vtkTable* table = tableNode->GetTable();
+  CHECK_INT(table->GetNumberOfColumns(), 5);
+  CHECK_INT(table->GetNumberOfRows(), numberOfRows);
+  CHECK_NOT_NULL(vtkStringArray::SafeDownCast(table->GetColumnByName("id")));
+  CHECK_STD_STRING(vtkStringArray::SafeDownCast(table->GetColumnByName("label"))->GetValue(12), "a \"12\"");
+  CHECK_NOT_NULL(table->GetColumnByName("quoted, name"));
+
+  storageNode->AutoDetectColumnTypesOn();
+  CHECK_BOOL(storageNode->ReadData(tableNode.GetPointer()) != 0, true);
+  table = tableNode->GetTable();
+  CHECK_INT(table->GetNumberOfRows(), numberOfRows);
+  vtkIntArray* idColumn = vtkIntArray::SafeDownCast(table->GetColumnByName("id"));
+  CHECK_NOT_NULL(idColumn);
+  vtkDoubleArray* valueColumn = vtkDoubleArray::SafeDownCast(table->GetColumnByName("value"));
+  CHECK_NOT_NULL(valueColumn);
+  for (int row = 0; row < numberOfRows; ++row)
+    {
+    CHECK_INT(idColumn->GetValue(row), row);
+    if (fabs(valueColumn->GetValue(row) - row * 0.5) > 1e-6)
+      {
+      std::cerr << "Line " << __LINE__ << ": unexpected value in row " << row << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+  CHECK_NOT_NULL(vtkStringArray::SafeDownCast(table->GetColumnByName("label")));
+  CHECK_NOT_NULL(vtkStringArray::SafeDownCast(table->GetColumnByName("quoted, name")));
+  vtkDoubleArray* mixedColumn = vtkDoubleArray::SafeDownCast(table->GetColumnByName("mixed"));
+  CHECK_NOT_NULL(mixedColumn);
+  CHECK_BOOL(mixedColumn->GetValue(numberOfRows - 1) == 1.5, true);
+  return EXIT_SUCCESS;
+}
+
+//---------------------------------------------------------------------------
+int TestReadMaximumNumberOfRows(vtkMRMLScene* scene)
+{
+  std::string fileName = std::string(scene->GetRootDirectory()) + "/vtkMRMLTableStorageNodeTest1Preview.tsv";
+  std::string otherFileName = std::string(scene->GetRootDirectory()) + "/vtkMRMLTableStorageNodeTest1PreviewSaved.tsv";
+  vtksys::SystemTools::RemoveFile(fileName);
+  vtksys::SystemTools::RemoveFile(otherFileName);
+  {
+  std::ofstream file(fileName.c_str());
+  file << "name\tvalue\n";
+  for (int row = 0; row < 100; ++row)
+    {
+    file << "row" << row << "\t" << row << "\n";
+    }
+  }
+
+  vtkNew<vtkMRMLTableNode> tableNode;
+  scene->AddNode(tableNode.GetPointer());
+  vtkNew<vtkMRMLTableStorageNode> storageNode;
+  scene->AddNode(storageNode.GetPointer());
+  storageNode->SetFileName(fileName.c_str());
+  storageNode->SetMaximumNumberOfRows(10);
+  CHECK_BOOL(storageNode->ReadData(tableNode.GetPointer()) != 0, true);
+  CHECK_INT(tableNode->GetTable()->GetNumberOfRows(), 10);
+  CHECK_STD_STRING(vtkStringArray::SafeDownCast(tableNode->GetTable()->GetColumnByName("name"))->GetValue(9), "row9");
+
+  // The partially read table must not overwrite the original file
+  TESTING_OUTPUT_ASSERT_ERRORS_BEGIN();
+  CHECK_BOOL(storageNode->WriteData(tableNode.GetPointer()) != 0, false);
+  TESTING_OUTPUT_ASSERT_ERRORS_END();
+  storageNode->SetFileName(otherFileName.c_str());
+  CHECK_BOOL(storageNode->WriteData(tableNode.GetPointer()) != 0, true);
+
+  // All rows are read if the limit is not reached
+  storageNode->SetFileName(fileName.c_str());
+  storageNode->SetMaximumNumberOfRows(100);
+  CHECK_BOOL(storageNode->ReadData(tableNode.GetPointer()) != 0, true);
+  CHECK_INT(tableNode->GetTable()->GetNumberOfRows(), 100);
+  CHECK_BOOL(storageNode->WriteData(tableNode.GetPointer()) != 0, true);
+  return EXIT_SUCCESS;
+}
@@ -36,6 +36,26 @@ int vtkMRMLTextNodeTest1(int , char * [] )
   textNode->SetText(basicString);
   CHECK_STD_STRING(textNode->GetText(), basicString);
 
+  // Append and replace parts of the text
+  vtkNew<vtkMRMLCoreTestingUtilities::vtkMRMLNodeCallback> callback;
+  textNode->AddObserver(vtkMRMLTextNode::TextModifiedEvent, callback.GetPointer());
+  textNode->AppendText(" Bye!");
+  CHECK_STD_STRING(textNode->GetText(), "Hello world! Bye!");
+  CHECK_INT(callback->GetNumberOfEvents(vtkMRMLTextNode::TextModifiedEvent), 1);
+  textNode->AppendText("");
+  CHECK_INT(callback->GetNumberOfEvents(vtkMRMLTextNode::TextModifiedEvent), 1);
+  textNode->ReplaceText(6, 5, "there");
+  CHECK_STD_STRING(textNode->GetText(), "Hello there! Bye!");
+  CHECK_INT(callback->GetNumberOfEvents(vtkMRMLTextNode::TextModifiedEvent), 2);
+  textNode->ReplaceText(6, 5, "there");
+  CHECK_INT(callback->GetNumberOfEvents(vtkMRMLTextNode::TextModifiedEvent), 2);
+  textNode->ReplaceText(12, 100, "");
+  CHECK_STD_STRING(textNode->GetText(), "Hello there!");
+  textNode->ReplaceText(100, 1, "!");
+  CHECK_STD_STRING(textNode->GetText(), "Hello there!!");
+  CHECK_INT(callback->GetNumberOfEvents(vtkMRMLTextNode::TextModifiedEvent), 4);
+  textNode->RemoveObserver(callback.GetPointer());
+
   std::string emptyString = "";
   textNode->SetText(emptyString);
   CHECK_STD_STRING(textNode->GetText(), emptyString);
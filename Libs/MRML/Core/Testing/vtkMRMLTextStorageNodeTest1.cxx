@@ -82,5 +82,13 @@ int TestReadWriteData(vtkMRMLScene* scene, const char *extension, std::string te
   CHECK_BOOL(storageNode->ReadData(textNode.GetPointer()), true);
   CHECK_STD_STRING(textNode->GetText(), text);
 
+  // Writing unchanged text and then changed text
+  CHECK_BOOL(storageNode->WriteData(textNode.GetPointer()), true);
+  textNode->AppendText(" (appended)");
+  CHECK_BOOL(storageNode->WriteData(textNode.GetPointer()), true);
+  textNode->SetText("");
+  CHECK_BOOL(storageNode->ReadData(textNode.GetPointer()), true);
+  CHECK_STD_STRING(textNode->GetText(), text + " (appended)");
+
   return EXIT_SUCCESS;
 }
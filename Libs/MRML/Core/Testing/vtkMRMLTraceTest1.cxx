@@ -0,0 +1,89 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2005 Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Program:   3D Slicer
+
+=========================================================================auto=*/
+
+// MRML includes
+#include "vtkMRMLCoreTestingMacros.h"
+#include "vtkMRMLModelNode.h"
+#include "vtkMRMLScene.h"
+#include "vtkMRMLTrace.h"
+
+// VTK includes
+#include <vtkNew.h>
+
+// VTKsys includes
+#include <vtksys/SystemTools.hxx>
+
+// STD includes
+#include <string>
+
+//---------------------------------------------------------------------------
+int vtkMRMLTraceTest1(int argc, char * argv[] )
+{
+  if (argc != 2)
+    {
+    std::cerr << "Usage: " << argv[0] << " /path/to/temp" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  vtkMRMLTrace* trace = vtkMRMLTrace::GetInstance();
+  trace->SetEnabled(false);
+  trace->Clear();
+
+  // Nothing is recorded while disabled
+  {
+    vtkMRMLTraceScope scope("Test", "DisabledScope");
+  }
+  CHECK_INT(trace->GetNumberOfEvents(), 0);
+
+  trace->SetEnabled(true);
+  CHECK_BOOL(vtkMRMLTrace::IsEnabled(), true);
+  {
+    vtkMRMLTraceScope scope("Test", "EnabledScope", "detail with \"quotes\"");
+  }
+  CHECK_INT(trace->GetNumberOfEvents(), 1);
+
+  double startTime = vtkMRMLTrace::GetTime();
+  trace->AddEvent("Test", "ManualEvent", nullptr, startTime, startTime + 10.0);
+  CHECK_INT(trace->GetNumberOfEvents(), 2);
+
+#ifdef MRML_USE_TRACING
+  // Scene operations are instrumented
+  vtkNew<vtkMRMLScene> scene;
+  vtkNew<vtkMRMLModelNode> modelNode;
+  scene->AddNode(modelNode.GetPointer());
+  CHECK_BOOL(trace->GetNumberOfEvents() > 2, true);
+#endif
+
+  std::string traceJSON = trace->GetChromeTraceAsString();
+  CHECK_BOOL(traceJSON.find("\"traceEvents\"") != std::string::npos, true);
+  CHECK_BOOL(traceJSON.find("\"name\":\"EnabledScope\"") != std::string::npos, true);
+  CHECK_BOOL(traceJSON.find("\"detail\":\"detail with \\\"quotes\\\"\"") != std::string::npos, true);
+  CHECK_BOOL(traceJSON.find("DisabledScope") == std::string::npos, true);
+
+  std::string fileName = std::string(argv[1]) + "/vtkMRMLTraceTest1.json";
+  CHECK_BOOL(trace->WriteChromeTrace(fileName.c_str()), true);
+  CHECK_BOOL(vtksys::SystemTools::FileExists(fileName), true);
+
+  // Maximum number of events limits memory usage
+  trace->Clear();
+  trace->SetMaximumNumberOfEvents(3);
+  for (int i = 0; i < 10; ++i)
+    {
+    vtkMRMLTraceScope scope("Test", "LimitedScope");
+    }
+  CHECK_INT(trace->GetNumberOfEvents(), 3);
+
+  trace->SetEnabled(false);
+  trace->SetMaximumNumberOfEvents(1000000);
+  trace->Clear();
+
+  return EXIT_SUCCESS;
+}
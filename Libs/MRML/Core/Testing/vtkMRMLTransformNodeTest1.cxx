@@ -150,6 +150,48 @@ int vtkMRMLTransformNodeTest1(int , char * [] )
   eTransform->GetMatrixTransformToWorld(test_mx.GetPointer());
   CHECK_BOOL(vtkAddonMathUtilities::MatrixAreEqual(w_from_e_mx.GetPointer(), test_mx.GetPointer()), true);
 
+  // Cached transform to world is updated when a parent transform is modified
+  vtkSmartPointer<vtkMatrix4x4> b_from_c_modified_mx = vtkSmartPointer<vtkMatrix4x4>::Take(CreateTransformMatrix(5, -6, 7, 18, 9, -10));
+  cTransform->SetMatrixTransformToParent(b_from_c_modified_mx.GetPointer());
+  vtkNew<vtkMatrix4x4> expected_mx;
+  vtkMatrix4x4::Multiply4x4(b_from_c_modified_mx.GetPointer(), c_from_e_mx.GetPointer(), expected_mx.GetPointer());
+  vtkMatrix4x4::Multiply4x4(w_from_b_mx.GetPointer(), expected_mx.GetPointer(), expected_mx.GetPointer());
+  eTransform->GetMatrixTransformToWorld(test_mx.GetPointer());
+  CHECK_BOOL(vtkAddonMathUtilities::MatrixAreEqual(expected_mx.GetPointer(), test_mx.GetPointer()), true);
+
+  // ... when a parent transform is inverted
+  cTransform->Inverse();
+  vtkNew<vtkMatrix4x4> c_from_b_modified_mx;
+  vtkMatrix4x4::Invert(b_from_c_modified_mx.GetPointer(), c_from_b_modified_mx.GetPointer());
+  vtkMatrix4x4::Multiply4x4(c_from_b_modified_mx.GetPointer(), c_from_e_mx.GetPointer(), expected_mx.GetPointer());
+  vtkMatrix4x4::Multiply4x4(w_from_b_mx.GetPointer(), expected_mx.GetPointer(), expected_mx.GetPointer());
+  eTransform->GetMatrixTransformToWorld(test_mx.GetPointer());
+  CHECK_BOOL(vtkAddonMathUtilities::MatrixAreEqual(expected_mx.GetPointer(), test_mx.GetPointer()), true);
+  cTransform->Inverse();
+  cTransform->SetMatrixTransformToParent(b_from_c_mx.GetPointer());
+
+  // ... and when a parent transform node is changed
+  cTransform->SetAndObserveTransformNodeID(nullptr);
+  eTransform->GetMatrixTransformToWorld(test_mx.GetPointer());
+  CHECK_BOOL(vtkAddonMathUtilities::MatrixAreEqual(b_from_e_mx.GetPointer(), test_mx.GetPointer()), true);
+  eTransform->GetMatrixTransformFromWorld(test_mx.GetPointer());
+  test_mx->Invert();
+  CHECK_BOOL(vtkAddonMathUtilities::MatrixAreEqual(b_from_e_mx.GetPointer(), test_mx.GetPointer()), true);
+  cTransform->SetAndObserveTransformNodeID(bTransform->GetID());
+  vtkNew<vtkGeneralTransform> e_to_w_transform;
+  eTransform->GetTransformToWorld(e_to_w_transform.GetPointer());
+  const double e_point[3] = { 12.0, -3.0, 25.0 };
+  double w_point[4] = { 0.0, 0.0, 0.0, 1.0 };
+  e_to_w_transform->TransformPoint(e_point, w_point);
+  double expected_w_point[4] = { e_point[0], e_point[1], e_point[2], 1.0 };
+  w_from_e_mx->MultiplyPoint(expected_w_point, expected_w_point);
+  for (int i = 0; i < 3; ++i)
+    {
+    CHECK_DOUBLE_TOLERANCE(w_point[i], expected_w_point[i], 1e-6);
+    }
+  eTransform->GetMatrixTransformToWorld(test_mx.GetPointer());
+  CHECK_BOOL(vtkAddonMathUtilities::MatrixAreEqual(w_from_e_mx.GetPointer(), test_mx.GetPointer()), true);
+
   // GetMatrixTransformToNode: target node is in different branch
   rTransform->GetMatrixTransformToNode(cTransform.GetPointer(), test_mx.GetPointer());
   CHECK_BOOL(vtkAddonMathUtilities::MatrixAreEqual(c_from_r_mx.GetPointer(), test_mx.GetPointer()), true);
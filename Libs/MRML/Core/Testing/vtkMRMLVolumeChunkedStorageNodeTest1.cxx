@@ -0,0 +1,240 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2017 Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Program:   3D Slicer
+
+=========================================================================auto=*/
+
+// MRML includes
+#include "vtkMRMLCoreTestingMacros.h"
+#include "vtkMRMLScalarVolumeNode.h"
+#include "vtkMRMLScene.h"
+#include "vtkMRMLVolumeChunkedStorageNode.h"
+#include "vtkOMEZarrImageReader.h"
+
+// VTK includes
+#include <vtkImageData.h>
+#include <vtkMatrix4x4.h>
+#include <vtkNew.h>
+
+// VTKSYS includes
+#include <vtksys/SystemTools.hxx>
+
+// STD includes
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+
+namespace
+{
+//---------------------------------------------------------------------------
+short VoxelValue(int i, int j, int k)
+{
+  return static_cast<short>(i + 2 * j + 3 * k + 1);
+}
+
+//---------------------------------------------------------------------------
+bool CheckVoxels(vtkImageData* imageData, int offsetI, int offsetJ, int offsetK)
+{
+  int* dimensions = imageData->GetDimensions();
+  for (int k = 0; k < dimensions[2]; ++k)
+    {
+    for (int j = 0; j < dimensions[1]; ++j)
+      {
+      for (int i = 0; i < dimensions[0]; ++i)
+        {
+        short value = *static_cast<short*>(imageData->GetScalarPointer(i, j, k));
+        if (value != VoxelValue(i + offsetI, j + offsetJ, k + offsetK))
+          {
+          std::cerr << "Unexpected voxel value at " << i << ", " << j << ", " << k << ": " << value << std::endl;
+          return false;
+          }
+        }
+      }
+    }
+  return true;
+}
+
+//---------------------------------------------------------------------------
+/// Write an OME-Zarr directory with the given metadata and check that the
+/// reader rejects it with an error instead of crashing.
+int TestMalformedMetaData(const std::string& directory, const std::string& zattrs, const std::string& zarray)
+{
+  vtksys::SystemTools::MakeDirectory(directory + "/0");
+  {
+  std::ofstream zattrsFile((directory + "/.zattrs").c_str());
+  zattrsFile << zattrs;
+  std::ofstream zarrayFile((directory + "/0/.zarray").c_str());
+  zarrayFile << zarray;
+  }
+  vtkNew<vtkOMEZarrImageReader> reader;
+  reader->SetFileName(directory.c_str());
+  TESTING_OUTPUT_ASSERT_ERRORS_BEGIN();
+  reader->UpdateInformation();
+  TESTING_OUTPUT_ASSERT_ERRORS_END();
+  CHECK_INT(reader->GetNumberOfResolutionLevels(), 0);
+  return EXIT_SUCCESS;
+}
+}
+
+//---------------------------------------------------------------------------
+int vtkMRMLVolumeChunkedStorageNodeTest1(int argc, char * argv[])
+{
+  if (argc != 2)
+    {
+    std::cerr << "Usage: " << argv[0] << " /path/to/temp" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  vtkNew<vtkMRMLVolumeChunkedStorageNode> node1;
+  EXERCISE_ALL_BASIC_MRML_METHODS(node1.GetPointer());
+
+  vtkNew<vtkMRMLScene> scene;
+  scene->SetRootDirectory(argv[1]);
+  std::string fileName = std::string(argv[1]) + "/vtkMRMLVolumeChunkedStorageNodeTest1.ome.zarr";
+
+  // Volume of 4x3x2 chunks of 32 voxels
+  vtkNew<vtkImageData> imageData;
+  imageData->SetDimensions(100, 70, 50);
+  imageData->AllocateScalars(VTK_SHORT, 1);
+  for (int k = 0; k < 50; ++k)
+    {
+    for (int j = 0; j < 70; ++j)
+      {
+      for (int i = 0; i < 100; ++i)
+        {
+        *static_cast<short*>(imageData->GetScalarPointer(i, j, k)) = VoxelValue(i, j, k);
+        }
+      }
+    }
+  vtkNew<vtkMRMLScalarVolumeNode> volumeNode;
+  volumeNode->SetAndObserveImageData(imageData);
+  volumeNode->SetSpacing(0.5, 1.0, 2.0);
+  volumeNode->SetOrigin(10.0, 20.0, 30.0);
+  double ijkToRASDirections[3][3] = { { -1.0, 0.0, 0.0 }, { 0.0, -1.0, 0.0 }, { 0.0, 0.0, 1.0 } };
+  volumeNode->SetIJKToRASDirections(ijkToRASDirections);
+  scene->AddNode(volumeNode);
+
+  vtkNew<vtkMRMLVolumeChunkedStorageNode> storageNode;
+  scene->AddNode(storageNode);
+  storageNode->SetFileName(fileName.c_str());
+  storageNode->SetChunkSize(32);
+  CHECK_BOOL(storageNode->WriteData(volumeNode) != 0, true);
+  // 100x70x50, 50x35x25, 25x17x12: the coarsest level fits in one chunk
+  CHECK_INT(storageNode->GetNumberOfResolutionLevelsInFile(), 3);
+
+  vtkNew<vtkMatrix4x4> ijkToRAS;
+  volumeNode->GetIJKToRASMatrix(ijkToRAS);
+
+  // Full resolution
+  vtkNew<vtkMRMLScalarVolumeNode> fullResolutionVolumeNode;
+  scene->AddNode(fullResolutionVolumeNode);
+  storageNode->SetResolutionLevel(0);
+  CHECK_BOOL(storageNode->ReadData(fullResolutionVolumeNode) != 0, true);
+  CHECK_INT(storageNode->GetLoadedResolutionLevel(), 0);
+  CHECK_INT(storageNode->GetReader()->GetNumberOfChunksRead(), 24);
+  CHECK_NOT_NULL(fullResolutionVolumeNode->GetImageData());
+  CHECK_INT(fullResolutionVolumeNode->GetImageData()->GetDimensions()[0], 100);
+  CHECK_INT(fullResolutionVolumeNode->GetImageData()->GetDimensions()[1], 70);
+  CHECK_INT(fullResolutionVolumeNode->GetImageData()->GetDimensions()[2], 50);
+  CHECK_BOOL(CheckVoxels(fullResolutionVolumeNode->GetImageData(), 0, 0, 0), true);
+  vtkNew<vtkMatrix4x4> readIJKToRAS;
+  fullResolutionVolumeNode->GetIJKToRASMatrix(readIJKToRAS);
+  for (int i = 0; i < 16; ++i)
+    {
+    if (fabs(readIJKToRAS->GetElement(i / 4, i % 4) - ijkToRAS->GetElement(i / 4, i % 4)) > 1e-6)
+      {
+      std::cerr << "Line " << __LINE__ << ": IJK to RAS matrix mismatch" << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  // Finest level that fits in memory, here the coarsest one
+  vtkNew<vtkMRMLScalarVolumeNode> lowResolutionVolumeNode;
+  scene->AddNode(lowResolutionVolumeNode);
+  storageNode->SetResolutionLevel(-1);
+  storageNode->SetMaximumMemorySizeMB(0);
+  CHECK_BOOL(storageNode->ReadData(lowResolutionVolumeNode) != 0, true);
+  CHECK_INT(storageNode->GetLoadedResolutionLevel(), 2);
+  CHECK_INT(lowResolutionVolumeNode->GetImageData()->GetDimensions()[0], 25);
+  CHECK_INT(lowResolutionVolumeNode->GetImageData()->GetDimensions()[1], 17);
+  CHECK_INT(lowResolutionVolumeNode->GetImageData()->GetDimensions()[2], 12);
+  double lowResolutionSpacing[3] = { 0.0, 0.0, 0.0 };
+  lowResolutionVolumeNode->GetSpacing(lowResolutionSpacing);
+  if (fabs(lowResolutionSpacing[0] - 2.0) > 1e-6 || fabs(lowResolutionSpacing[2] - 8.0) > 1e-6)
+    {
+    std::cerr << "Line " << __LINE__ << ": unexpected spacing of the coarsest level" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Region within a single chunk, read with a new storage node to start with an empty cache
+  vtkNew<vtkMRMLVolumeChunkedStorageNode> regionStorageNode;
+  scene->AddNode(regionStorageNode);
+  regionStorageNode->SetFileName(fileName.c_str());
+  double regionStartIJK[4] = { 40.0, 10.0, 5.0, 1.0 };
+  double regionEndIJK[4] = { 50.0, 20.0, 8.0, 1.0 };
+  double regionStartRAS[4] = { 0.0, 0.0, 0.0, 1.0 };
+  double regionEndRAS[4] = { 0.0, 0.0, 0.0, 1.0 };
+  ijkToRAS->MultiplyPoint(regionStartIJK, regionStartRAS);
+  ijkToRAS->MultiplyPoint(regionEndIJK, regionEndRAS);
+  // shrink the bounds to make sure that rounding does not include neighbor voxels
+  double regionBoundsRAS[6];
+  for (int i = 0; i < 3; ++i)
+    {
+    regionBoundsRAS[2 * i] = std::min(regionStartRAS[i], regionEndRAS[i]) + 1e-3;
+    regionBoundsRAS[2 * i + 1] = std::max(regionStartRAS[i], regionEndRAS[i]) - 1e-3;
+    }
+  vtkNew<vtkMRMLScalarVolumeNode> regionVolumeNode;
+  scene->AddNode(regionVolumeNode);
+  CHECK_BOOL(regionStorageNode->ReadRegion(regionVolumeNode, regionBoundsRAS, 0) != 0, true);
+  CHECK_INT(regionStorageNode->GetReader()->GetNumberOfChunksRead(), 1);
+  CHECK_INT(regionVolumeNode->GetImageData()->GetExtent()[0], 0);
+  CHECK_INT(regionVolumeNode->GetImageData()->GetDimensions()[0], 11);
+  CHECK_INT(regionVolumeNode->GetImageData()->GetDimensions()[1], 11);
+  CHECK_INT(regionVolumeNode->GetImageData()->GetDimensions()[2], 4);
+  CHECK_BOOL(CheckVoxels(regionVolumeNode->GetImageData(), 40, 10, 5), true);
+  double regionOrigin[3] = { 0.0, 0.0, 0.0 };
+  regionVolumeNode->GetOrigin(regionOrigin);
+  if (fabs(regionOrigin[0] - regionStartRAS[0]) > 1e-6
+    || fabs(regionOrigin[1] - regionStartRAS[1]) > 1e-6
+    || fabs(regionOrigin[2] - regionStartRAS[2]) > 1e-6)
+    {
+    std::cerr << "Line " << __LINE__ << ": unexpected origin of the region" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Reading the same region again uses cached chunks
+  CHECK_BOOL(regionStorageNode->ReadRegion(regionVolumeNode, regionBoundsRAS, 0) != 0, true);
+  CHECK_INT(regionStorageNode->GetReader()->GetNumberOfChunksRead(), 0);
+
+  // Malformed metadata is rejected
+  const std::string validZAttrs = "{\"multiscales\": [{\"datasets\": [{\"path\": \"0\"}]}]}";
+  const std::string validZArray = "{\"shape\": [2, 3, 4], \"chunks\": [2, 3, 4], \"dtype\": \"<i2\"}";
+  std::string malformedPrefix = std::string(argv[1]) + "/vtkMRMLVolumeChunkedStorageNodeTest1Malformed";
+  CHECK_EXIT_SUCCESS(TestMalformedMetaData(malformedPrefix + "1.ome.zarr",
+    "{\"multiscales\": [1]}", validZArray));
+  CHECK_EXIT_SUCCESS(TestMalformedMetaData(malformedPrefix + "2.ome.zarr",
+    "{\"multiscales\": [{\"datasets\": [\"0\"]}]}", validZArray));
+  CHECK_EXIT_SUCCESS(TestMalformedMetaData(malformedPrefix + "3.ome.zarr",
+    validZAttrs, "{\"shape\": [2, \"3\", 4], \"chunks\": [2, 3, 4], \"dtype\": \"<i2\"}"));
+  CHECK_EXIT_SUCCESS(TestMalformedMetaData(malformedPrefix + "4.ome.zarr",
+    validZAttrs, "{\"shape\": [2, 3], \"chunks\": [2, 3, 4], \"dtype\": \"<i2\"}"));
+  CHECK_EXIT_SUCCESS(TestMalformedMetaData(malformedPrefix + "5.ome.zarr",
+    validZAttrs, "{\"shape\": [2, 3, 4], \"chunks\": [2, 3, 4.5], \"dtype\": \"<i2\"}"));
+  CHECK_EXIT_SUCCESS(TestMalformedMetaData(malformedPrefix + "6.ome.zarr",
+    validZAttrs, "{\"shape\": [2, 3, 4], \"chunks\": [2, 3, 4], \"dtype\": \"<i2\", \"dimension_separator\": \"\"}"));
+  CHECK_EXIT_SUCCESS(TestMalformedMetaData(malformedPrefix + "7.ome.zarr",
+    "{\"multiscales\": [{\"datasets\": [{\"path\": \"0\", \"coordinateTransformations\": "
+    "[{\"type\": \"scale\", \"scale\": [1.0, \"2.0\", 1.0]}]}]}]}", validZArray));
+  CHECK_EXIT_SUCCESS(TestMalformedMetaData(malformedPrefix + "8.ome.zarr",
+    "{\"multiscales\": [{\"datasets\": [{\"path\": \"0\", \"coordinateTransformations\": "
+    "[{\"type\": \"translation\", \"translation\": 2.0}]}]}]}", validZArray));
+  CHECK_EXIT_SUCCESS(TestMalformedMetaData(malformedPrefix + "9.ome.zarr",
+    "{\"multiscales\": [{\"datasets\": [{\"path\": \"0\"}]}], \"slicer\": {\"ijkToRAS\": [[1, 0, 0]]}}", validZArray));
+
+  return EXIT_SUCCESS;
+}
@@ -23,6 +23,7 @@
 #include "vtkMRMLVolumeNode.h"
 
 // VTK includes
+#include <vtkAlgorithmOutput.h>
 #include <vtkImageData.h>
 #include <vtkNew.h>
 #include <vtkObjectFactory.h>
@@ -157,9 +158,19 @@ int vtkMRMLVolumeNodeEventsTest(int , char * [] )
   callback->ResetNumberOfEvents();
 
   // Set new image data
+  vtkAlgorithmOutput* imageDataConnection = volumeNode->GetImageDataConnection();
   vtkNew<vtkImageData> imageData2;
   volumeNode->SetAndObserveImageData(imageData2.GetPointer());
 
+  // The image is swapped in the producer, the connection is kept
+  if (volumeNode->GetImageDataConnection() != imageDataConnection ||
+      volumeNode->GetImageData() != imageData2.GetPointer())
+    {
+    std::cerr << __LINE__ << ": vtkMRMLVolumeNode::SetAndObserveImageData failed: "
+              << "image data connection is expected to be kept" << std::endl;
+    return EXIT_FAILURE;
+    }
+
   if (!callback->GetErrorString().empty() ||
       callback->GetNumberOfEvents(vtkCommand::ModifiedEvent) != 1 ||
       callback->GetNumberOfEvents(vtkMRMLVolumeNode::ImageDataModifiedEvent) != 1)
@@ -22,6 +22,7 @@ or http://www.slicer.org/copyright/copyright.txt for details.
 #include <iostream>
 
 // VTK include
+#include <vtkNew.h>
 #include <vtkObjectFactory.h>
 
 vtkStandardNewMacro(vtkArchive);
@@ -225,12 +226,19 @@ long copy_data(struct archive *ar, struct archive *aw)
 vtkArchive::vtkArchive() = default;
 
 //----------------------------------------------------------------------------
-vtkArchive::~vtkArchive() = default;
+vtkArchive::~vtkArchive()
+{
+  if (this->ZipArchive)
+    {
+    this->CloseZip();
+    }
+}
 
 //----------------------------------------------------------------------------
 void vtkArchive::PrintSelf(ostream& os, vtkIndent indent)
 {
   Superclass::PrintSelf(os,indent);
+  os << indent << "CompressionLevel: " << this->CompressionLevel << "\n";
 }
 
 //-----------------------------------------------------------------------------
@@ -367,25 +375,148 @@ bool vtkArchive::Zip(const char* zipFileName, const char* directoryToZip)
 
   //
   // to make a zip file:
-  // - check that libarchive supports zip writing
   // - check arguments
-  // - get a list of files using vtksys Glob
   // - create the archive
-  // -- go file-by-file and add chunks of data to the archive
+  // - add the directory content file-by-file (see AddDirectoryContentToZip)
   // - close up and return success
   //
 
+  if ( !zipFileName || !directoryToZip )
+    {
+    vtkArchiveTools::Error("Zip:", "Invalid zipfile or directory");
+    return false;
+    }
+
+  vtkNew<vtkArchive> zipArchive;
+  if (!zipArchive->OpenZip(zipFileName))
+    {
+    return false;
+    }
+  bool success = zipArchive->AddDirectoryContentToZip(directoryToZip);
+  success = zipArchive->CloseZip() && success;
+  return success;
+}
+
+//-----------------------------------------------------------------------------
+bool vtkArchive::OpenZip(const char* zipFileName)
+{
 // only support the libarchive version 3.0 +
 #if !defined(ARCHIVE_VERSION_NUMBER) || ARCHIVE_VERSION_NUMBER < 3000000
   return false;
 #endif
 
-  if ( !zipFileName || !directoryToZip )
+  if (!zipFileName)
     {
-    vtkArchiveTools::Error("Zip:", "Invalid zipfile or directory");
+    vtkArchiveTools::Error("Zip:", "Invalid zipfile");
+    return false;
+    }
+  if (this->ZipArchive)
+    {
+    this->CloseZip();
+    }
+
+  this->ZipArchive = archive_write_new();
+
+  // create a zip archive
+#ifdef HAVE_ZLIB_H
+  std::string compression_type = "deflate";
+#else
+  std::string compression_type = "store";
+#endif
+
+  archive_write_set_format_zip(this->ZipArchive);
+
+  archive_write_set_format_option(this->ZipArchive, "zip", "compression", compression_type.c_str());
+  // compression-level is not supported by older libarchive versions, a warning is
+  // returned in this case and the default level is used
+  std::string compression_level = std::to_string(this->CompressionLevel);
+  archive_write_set_format_option(this->ZipArchive, "zip", "compression-level", compression_level.c_str());
+
+  if (archive_write_open_filename(this->ZipArchive, zipFileName) != ARCHIVE_OK)
+    {
+    vtkArchiveTools::Error("Zip: cannot open:", zipFileName);
+    archive_write_free(this->ZipArchive);
+    this->ZipArchive = nullptr;
     return false;
     }
+  return true;
+}
 
+//-----------------------------------------------------------------------------
+bool vtkArchive::AddDirectoryToZip(const char* entryName)
+{
+  if (!this->ZipArchive || !entryName)
+    {
+    vtkArchiveTools::Error("Zip:", "Zip file is not open");
+    return false;
+    }
+  struct archive_entry* dirEntry = archive_entry_new();
+  archive_entry_set_mtime(dirEntry, 11, 110);
+  archive_entry_copy_pathname(dirEntry, entryName);
+  archive_entry_set_mode(dirEntry, S_IFDIR | 0755);
+  archive_entry_set_size(dirEntry, 512);
+  int result = archive_write_header(this->ZipArchive, dirEntry);
+  archive_entry_free(dirEntry);
+  return (result == ARCHIVE_OK);
+}
+
+//-----------------------------------------------------------------------------
+bool vtkArchive::AddFileToZip(const char* fileName, const char* entryName)
+{
+  if (!this->ZipArchive || !fileName || !entryName)
+    {
+    vtkArchiveTools::Error("Zip:", "Zip file is not open");
+    return false;
+    }
+
+  // have to read the contents of the file to add it to the archive
+  FILE* fd = fopen(fileName, "rb");
+  if (!fd)
+    {
+    vtkArchiveTools::Error("Zip: cannot open:", fileName);
+    return false;
+    }
+
+  //
+  // add an entry for this file
+  //
+  struct archive_entry* entry = archive_entry_new();
+  archive_entry_set_pathname(entry, entryName);
+  // size is required, for now use the vtksys call though it uses struct stat
+  // and may not be portable
+  unsigned long fileLength = vtksys::SystemTools::FileLength(fileName);
+  archive_entry_set_size(entry, fileLength);
+  archive_entry_set_filetype(entry, AE_IFREG);
+  archive_entry_set_perm(entry, 0644);
+  bool success = (archive_write_header(this->ZipArchive, entry) == ARCHIVE_OK);
+
+  //
+  // add the data for this entry
+  //
+  std::vector<char> buff(64 * 1024);
+  size_t len = fread(buff.data(), sizeof(char), buff.size(), fd);
+  while (success && len > 0)
+    {
+    success = (archive_write_data(this->ZipArchive, buff.data(), len) >= 0);
+    len = fread(buff.data(), sizeof(char), buff.size(), fd);
+    }
+  fclose(fd);
+  archive_entry_free(entry);
+  if (!success)
+    {
+    vtkArchiveTools::Error("Zip: failed to add:", fileName);
+    }
+  return success;
+}
+
+//-----------------------------------------------------------------------------
+bool vtkArchive::AddDirectoryContentToZip(const char* directoryToZip, bool removeAddedFiles/*=false*/)
+{
+  if (!this->ZipArchive || !directoryToZip)
+    {
+    vtkArchiveTools::Error("Zip:", "Invalid zipfile or directory");
+    return false;
+    }
 
 #if VTK_MAJOR_VERSION >= 9 || (VTK_MAJOR_VERSION >= 8 && VTK_MINOR_VERSION >= 90)
   std::vector<std::string> directoryParts;
@@ -406,89 +537,43 @@ bool vtkArchive::Zip(const char* zipFileName, const char* directoryToZip)
     }
   std::vector<std::string> files = glob.GetFiles();
 
-  // now zip it up using LibArchive
-  struct archive *zipArchive;
-  struct archive_entry *entry, *dirEntry;
-  char buff[BUFSIZ];
-  size_t len;
-  // have to read the contents of the files to add them to the archive
-  FILE *fd;
-
-  zipArchive = archive_write_new();
-
-  // create a zip archive
-#ifdef HAVE_ZLIB_H
-  std::string compression_type = "deflate";
-#else
-  std::string compression_type = "store";
-#endif
-
-  archive_write_set_format_zip(zipArchive);
-
-  archive_write_set_format_option(zipArchive, "zip", "compression", compression_type.c_str());
-
-  archive_write_open_filename(zipArchive, zipFileName);
-
   // add the data directory
-  dirEntry = archive_entry_new();
-  archive_entry_set_mtime(dirEntry, 11, 110);
-  archive_entry_copy_pathname(dirEntry, directoryName.c_str());
-  archive_entry_set_mode(dirEntry, S_IFDIR | 0755);
-  archive_entry_set_size(dirEntry, 512);
-  archive_write_header(zipArchive, dirEntry);
-  archive_entry_free(dirEntry);
+  this->AddDirectoryToZip(directoryName.c_str());
 
   // add the files
-  std::vector<std::string>::const_iterator sit;
-  sit = files.begin();
-  while (sit != files.end())
+  bool success = true;
+  for (std::vector<std::string>::const_iterator sit = files.begin(); sit != files.end(); ++sit)
     {
     vtkArchiveTools::Message("Zip: adding:", (*sit).c_str());
-    const char *fileName = (*sit).c_str();
-    ++sit;
-
-    //
-    // add an entry for this file
-    //
-    entry = archive_entry_new();
     // use a relative path for the entry file name, including the top
     // directory so it unzips into a directory of it's own
     std::string relFileName = vtksys::SystemTools::RelativePath(
               vtksys::SystemTools::GetParentDirectory(directoryToZip).c_str(),
-              fileName);
+              *sit);
     vtkArchiveTools::Message("Zip: adding rel:", relFileName.c_str());
-    archive_entry_set_pathname(entry, relFileName.c_str());
-    // size is required, for now use the vtksys call though it uses struct stat
-    // and may not be portable
-    unsigned long fileLength = vtksys::SystemTools::FileLength(fileName);
-    archive_entry_set_size(entry, fileLength);
-    archive_entry_set_filetype(entry, AE_IFREG);
-    archive_entry_set_perm(entry, 0644);
-    archive_write_header(zipArchive, entry);
-
-    //
-    // add the data for this entry
-    //
-    fd = fopen(fileName, "rb");
-    if (!fd)
+    if (!this->AddFileToZip((*sit).c_str(), relFileName.c_str()))
       {
-      vtkArchiveTools::Error("Zip: cannot open:", (*sit).c_str());
+      success = false;
+      continue;
       }
-    else
+    if (removeAddedFiles)
       {
-      len = fread(buff, sizeof(char), sizeof(buff), fd);
-      while ( len > 0 )
-        {
-        archive_write_data(zipArchive, buff, len);
-        len = fread(buff, sizeof(char), sizeof(buff), fd);
-        }
-      fclose(fd);
+      vtksys::SystemTools::RemoveFile(*sit);
       }
-    archive_entry_free(entry);
     }
+  return success;
+}
 
-  archive_write_close(zipArchive);
-  int retval = archive_write_free(zipArchive);
+//-----------------------------------------------------------------------------
+bool vtkArchive::CloseZip()
+{
+  if (!this->ZipArchive)
+    {
+    return false;
+    }
+  archive_write_close(this->ZipArchive);
+  int retval = archive_write_free(this->ZipArchive);
+  this->ZipArchive = nullptr;
   if (retval != ARCHIVE_OK)
     {
     vtkArchiveTools::Error("Zip:", "error on close!");
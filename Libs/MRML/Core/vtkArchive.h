@@ -20,6 +20,8 @@ or http://www.slicer.org/copyright/copyright.txt for details.
 #include <string>
 #include <vector>
 
+struct archive;
+
 /// \brief Simple class for manipulating archive files
 ///
 class VTK_MRML_EXPORT vtkArchive : public vtkObject
@@ -43,11 +45,42 @@ public:
   // (internally this supports many formats of archive, not just zip)
   static bool UnZip(const char* zipFileName, const char *destinationDirectory);
 
+  /// Create a zip file that entries are added to one at a time, as they are
+  /// produced, instead of creating it from a complete directory.
+  /// The zip file is finalized by CloseZip().
+  bool OpenZip(const char* zipFileName);
+
+  /// Add the content of \a fileName as the zip entry \a entryName.
+  /// The file is read in blocks, it is never fully loaded into memory.
+  bool AddFileToZip(const char* fileName, const char* entryName);
+
+  /// Add a directory entry to the zip file.
+  bool AddDirectoryToZip(const char* entryName);
+
+  /// Add all the files of \a directoryToZip (recursively) to the zip file,
+  /// entries include the relative path including the tail of \a directoryToZip.
+  /// If \a removeAddedFiles is true then each file is deleted as soon as it is
+  /// added, so that the directory and the zip file do not need to fit on the disk
+  /// at the same time.
+  bool AddDirectoryContentToZip(const char* directoryToZip, bool removeAddedFiles = false);
+
+  /// Finalize the zip file opened by OpenZip().
+  bool CloseZip();
+
+  /// Deflate compression level used for the zip files created by OpenZip(),
+  /// from 0 (fastest) to 9 (smallest). Default is 6.
+  /// Only used if libarchive supports setting the compression level.
+  vtkSetClampMacro(CompressionLevel, int, 0, 9);
+  vtkGetMacro(CompressionLevel, int);
+
 protected:
   vtkArchive();
   ~vtkArchive() override;
   vtkArchive(const vtkArchive&);
   void operator=(const vtkArchive&);
+
+  int CompressionLevel{6};
+  struct archive* ZipArchive{nullptr};
 };
 
 #endif
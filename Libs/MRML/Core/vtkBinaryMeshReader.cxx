@@ -0,0 +1,497 @@
+/*=auto=========================================================================
+
+Portions (c) Copyright 2017 Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+See COPYRIGHT.txt
+or http://www.slicer.org/copyright/copyright.txt for details.
+
+=========================================================================auto=*/
+
+// MRML includes
+#include "vtkBinaryMeshReader.h"
+
+// VTK includes
+#include <vtkCellArray.h>
+#include <vtkCellData.h>
+#include <vtkIdTypeArray.h>
+#include <vtkInformation.h>
+#include <vtkInformationVector.h>
+#include <vtkNew.h>
+#include <vtkObjectFactory.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkSmartPointer.h>
+#include <vtkTimerLog.h>
+#include <vtkTypeInt32Array.h>
+#include <vtkTypeInt64Array.h>
+#include <vtkVersion.h>
+#include <vtk_zlib.h>
+
+// STD includes
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <vector>
+
+//----------------------------------------------------------------------------
+namespace
+{
+/// Upper bound of the deflate compression ratio, used to reject compressed
+/// sections that claim more values than their stored size can hold.
+const vtkTypeUInt64 MaximumZlibCompressionRatio = 1032;
+
+//----------------------------------------------------------------------------
+struct MeshSectionDescription
+{
+  vtkTypeUInt32 Role;
+  vtkTypeInt32 DataType;
+  vtkTypeInt32 NumberOfComponents;
+  vtkTypeInt32 Encoding;
+  vtkTypeInt32 AttributeType;
+  vtkTypeUInt32 NameLength;
+  vtkTypeUInt64 NameOffset;
+  vtkTypeUInt64 NumberOfTuples;
+  vtkTypeUInt64 DataOffset;
+  vtkTypeUInt64 StoredSize;
+};
+
+//----------------------------------------------------------------------------
+template <class T>
+T GetValue(const char* block, size_t offset)
+{
+  T value;
+  memcpy(&value, block + offset, sizeof(T));
+  return value;
+}
+
+//----------------------------------------------------------------------------
+template <class T>
+void DeltaDecode(unsigned char* values, size_t numberOfValues)
+{
+  T previous = 0;
+  for (size_t i = 0; i < numberOfValues; ++i)
+    {
+    T delta;
+    memcpy(&delta, values + i * sizeof(T), sizeof(T));
+    previous = static_cast<T>(previous + delta);
+    memcpy(values + i * sizeof(T), &previous, sizeof(T));
+    }
+}
+
+//----------------------------------------------------------------------------
+bool ReadString(std::ifstream& file, vtkTypeUInt64 fileSize, vtkTypeUInt64 offset, vtkTypeUInt32 length,
+  std::string& value)
+{
+  value.clear();
+  if (length == 0)
+    {
+    return true;
+    }
+  if (offset > fileSize || length > fileSize - offset)
+    {
+    return false;
+    }
+  value.assign(length, '\0');
+  file.seekg(static_cast<std::streamoff>(offset));
+  file.read(&value[0], length);
+  return file.good();
+}
+
+//----------------------------------------------------------------------------
+/// Compute the number of values and the size in bytes of the section values.
+/// Return false if the size cannot be represented (corrupted section).
+bool GetSectionSize(const MeshSectionDescription& section, size_t valueSize,
+  size_t& numberOfValues, size_t& size)
+{
+  if (valueSize == 0 || section.NumberOfComponents < 1)
+    {
+    return false;
+    }
+  vtkTypeUInt64 numberOfComponents = static_cast<vtkTypeUInt64>(section.NumberOfComponents);
+  if (section.NumberOfTuples > static_cast<vtkTypeUInt64>(std::numeric_limits<vtkIdType>::max()) / numberOfComponents)
+    {
+    return false;
+    }
+  vtkTypeUInt64 values = section.NumberOfTuples * numberOfComponents;
+  if (values > static_cast<vtkTypeUInt64>(std::numeric_limits<size_t>::max() / valueSize))
+    {
+    return false;
+    }
+  numberOfValues = static_cast<size_t>(values);
+  size = numberOfValues * valueSize;
+  return true;
+}
+
+//----------------------------------------------------------------------------
+/// Check that the offsets start at 0, never decrease and end at the size of
+/// the connectivity, and that all point IDs are smaller than \a numberOfPoints.
+template <class T>
+bool AreCellsValid(vtkDataArray* offsetsArray, vtkDataArray* connectivityArray, vtkIdType numberOfPoints)
+{
+  const T* offsets = static_cast<const T*>(offsetsArray->GetVoidPointer(0));
+  const T* connectivity = static_cast<const T*>(connectivityArray->GetVoidPointer(0));
+  vtkIdType numberOfOffsets = offsetsArray->GetNumberOfTuples();
+  vtkIdType connectivitySize = connectivityArray->GetNumberOfTuples();
+  if (numberOfOffsets < 1 || offsets[0] != 0
+    || static_cast<vtkTypeInt64>(offsets[numberOfOffsets - 1]) != static_cast<vtkTypeInt64>(connectivitySize))
+    {
+    return false;
+    }
+  for (vtkIdType i = 1; i < numberOfOffsets; ++i)
+    {
+    if (offsets[i] < offsets[i - 1])
+      {
+      return false;
+      }
+    }
+  for (vtkIdType i = 0; i < connectivitySize; ++i)
+    {
+    if (connectivity[i] < 0 || static_cast<vtkTypeInt64>(connectivity[i]) >= static_cast<vtkTypeInt64>(numberOfPoints))
+      {
+      return false;
+      }
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+/// Read the values of the section in the already allocated \a array.
+/// Time spent decoding compressed values is added to \a decompressionTime.
+bool ReadArrayValues(std::ifstream& file, const MeshSectionDescription& section, vtkDataArray* array,
+  double& decompressionTime)
+{
+  // array was allocated from the validated section size, this cannot overflow
+  size_t valueSize = static_cast<size_t>(array->GetDataTypeSize());
+  size_t numberOfValues = static_cast<size_t>(array->GetNumberOfValues());
+  size_t size = valueSize * numberOfValues;
+  if (size == 0)
+    {
+    return true;
+    }
+  unsigned char* values = static_cast<unsigned char*>(array->GetVoidPointer(0));
+  file.seekg(static_cast<std::streamoff>(section.DataOffset));
+  if (section.Encoding == vtkBinaryMeshReader::Raw)
+    {
+    if (section.StoredSize != size)
+      {
+      return false;
+      }
+    file.read(reinterpret_cast<char*>(values), static_cast<std::streamsize>(size));
+    return file.good();
+    }
+
+  if (size > static_cast<size_t>(std::numeric_limits<uLong>::max())
+    || section.StoredSize > static_cast<vtkTypeUInt64>(std::numeric_limits<uLong>::max()))
+    {
+    return false;
+    }
+  std::vector<char> compressed(static_cast<size_t>(section.StoredSize));
+  file.read(compressed.data(), static_cast<std::streamsize>(compressed.size()));
+  if (!file.good())
+    {
+    return false;
+    }
+  double decompressionStartTime = vtkTimerLog::GetUniversalTime();
+  std::vector<unsigned char> shuffled(size);
+  uLongf uncompressedSize = static_cast<uLongf>(size);
+  if (uncompress(shuffled.data(), &uncompressedSize, reinterpret_cast<const Bytef*>(compressed.data()),
+    static_cast<uLong>(compressed.size())) != Z_OK || uncompressedSize != size)
+    {
+    return false;
+    }
+  compressed.clear();
+  compressed.shrink_to_fit();
+
+  for (size_t byteIndex = 0; byteIndex < valueSize; ++byteIndex)
+    {
+    const unsigned char* shuffledBytes = shuffled.data() + byteIndex * numberOfValues;
+    unsigned char* valueBytes = values + byteIndex;
+    for (size_t i = 0; i < numberOfValues; ++i)
+      {
+      valueBytes[i * valueSize] = shuffledBytes[i];
+      }
+    }
+
+  if (section.Encoding == vtkBinaryMeshReader::DeltaShuffledZlib)
+    {
+    if (valueSize == 4)
+      {
+      DeltaDecode<vtkTypeUInt32>(values, numberOfValues);
+      }
+    else if (valueSize == 8)
+      {
+      DeltaDecode<vtkTypeUInt64>(values, numberOfValues);
+      }
+    else
+      {
+      return false;
+      }
+    }
+  decompressionTime += vtkTimerLog::GetUniversalTime() - decompressionStartTime;
+  return true;
+}
+
+#if VTK_MAJOR_VERSION < 9
+//----------------------------------------------------------------------------
+/// Build a cell array in the legacy layout from offsets and connectivity
+void SetLegacyCells(vtkCellArray* cells, vtkDataArray* offsets, vtkDataArray* connectivity)
+{
+  vtkIdType numberOfCells = offsets->GetNumberOfTuples() - 1;
+  vtkNew<vtkIdTypeArray> legacyCells;
+  legacyCells->SetNumberOfValues(numberOfCells + connectivity->GetNumberOfTuples());
+  vtkIdType legacyIndex = 0;
+  for (vtkIdType cellIndex = 0; cellIndex < numberOfCells; ++cellIndex)
+    {
+    vtkIdType begin = static_cast<vtkIdType>(offsets->GetTuple1(cellIndex));
+    vtkIdType end = static_cast<vtkIdType>(offsets->GetTuple1(cellIndex + 1));
+    legacyCells->SetValue(legacyIndex++, end - begin);
+    for (vtkIdType i = begin; i < end; ++i)
+      {
+      legacyCells->SetValue(legacyIndex++, static_cast<vtkIdType>(connectivity->GetTuple1(i)));
+      }
+    }
+  cells->SetCells(numberOfCells, legacyCells.GetPointer());
+}
+#endif
+}
+
+//----------------------------------------------------------------------------
+vtkStandardNewMacro(vtkBinaryMeshReader);
+
+//----------------------------------------------------------------------------
+vtkBinaryMeshReader::vtkBinaryMeshReader()
+{
+  this->FileName = nullptr;
+  this->SetNumberOfInputPorts(0);
+}
+
+//----------------------------------------------------------------------------
+vtkBinaryMeshReader::~vtkBinaryMeshReader()
+{
+  this->SetFileName(nullptr);
+}
+
+//----------------------------------------------------------------------------
+void vtkBinaryMeshReader::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "FileName: " << (this->FileName ? this->FileName : "(none)") << "\n";
+  os << indent << "Header: " << this->Header << "\n";
+  os << indent << "DecompressionTime: " << this->DecompressionTime << "\n";
+}
+
+//----------------------------------------------------------------------------
+bool vtkBinaryMeshReader::CanReadFile(const char* fileName)
+{
+  if (!fileName)
+    {
+    return false;
+    }
+  std::ifstream file(fileName, std::ios::in | std::ios::binary);
+  char magic[8] = { 0 };
+  file.read(magic, 8);
+  return file.good() && memcmp(magic, "SLCRMESH", 8) == 0;
+}
+
+//----------------------------------------------------------------------------
+int vtkBinaryMeshReader::RequestData(vtkInformation* vtkNotUsed(request),
+  vtkInformationVector** vtkNotUsed(inputVector), vtkInformationVector* outputVector)
+{
+  this->Header.clear();
+  this->DecompressionTime = 0.0;
+  vtkPolyData* output = vtkPolyData::GetData(outputVector);
+  if (!this->FileName)
+    {
+    vtkErrorMacro("RequestData: file name is not set");
+    return 0;
+    }
+  std::ifstream file(this->FileName, std::ios::in | std::ios::binary);
+  if (!file.is_open())
+    {
+    vtkErrorMacro("RequestData: failed to open file " << this->FileName);
+    return 0;
+    }
+  file.seekg(0, std::ios::end);
+  vtkTypeUInt64 fileSize = static_cast<vtkTypeUInt64>(file.tellg());
+  file.seekg(0, std::ios::beg);
+
+  char fileHeader[BlockSize];
+  file.read(fileHeader, BlockSize);
+  if (!file.good() || memcmp(fileHeader, "SLCRMESH", 8) != 0)
+    {
+    vtkErrorMacro("RequestData: " << this->FileName << " is not a binary mesh file");
+    return 0;
+    }
+  vtkTypeUInt32 version = GetValue<vtkTypeUInt32>(fileHeader, 8);
+  if (version > FormatVersion)
+    {
+    vtkErrorMacro("RequestData: " << this->FileName << " has format version " << version
+      << ", only versions up to " << FormatVersion << " are supported");
+    return 0;
+    }
+  if (GetValue<vtkTypeUInt32>(fileHeader, 12) != 0x01020304)
+    {
+    vtkErrorMacro("RequestData: " << this->FileName << " was written with a different byte order");
+    return 0;
+    }
+  vtkTypeUInt32 numberOfSections = GetValue<vtkTypeUInt32>(fileHeader, 16);
+  if ((static_cast<vtkTypeUInt64>(numberOfSections) + 1) * BlockSize > fileSize)
+    {
+    vtkErrorMacro("RequestData: " << this->FileName << " is truncated");
+    return 0;
+    }
+  std::vector<char> table(static_cast<size_t>(numberOfSections) * BlockSize);
+  file.read(table.data(), static_cast<std::streamsize>(table.size()));
+  if (!file.good()
+    || !ReadString(file, fileSize, GetValue<vtkTypeUInt64>(fileHeader, 24), GetValue<vtkTypeUInt32>(fileHeader, 20),
+      this->Header))
+    {
+    vtkErrorMacro("RequestData: failed to read " << this->FileName);
+    return 0;
+    }
+
+  vtkNew<vtkPolyData> polyData;
+  vtkSmartPointer<vtkDataArray> cellArrays[4][2];
+  for (vtkTypeUInt32 sectionIndex = 0; sectionIndex < numberOfSections; ++sectionIndex)
+    {
+    const char* description = table.data() + static_cast<size_t>(sectionIndex) * BlockSize;
+    MeshSectionDescription section;
+    section.Role = GetValue<vtkTypeUInt32>(description, 0);
+    section.DataType = GetValue<vtkTypeInt32>(description, 4);
+    section.NumberOfComponents = GetValue<vtkTypeInt32>(description, 8);
+    section.Encoding = GetValue<vtkTypeInt32>(description, 12);
+    section.AttributeType = GetValue<vtkTypeInt32>(description, 16);
+    section.NameLength = GetValue<vtkTypeUInt32>(description, 20);
+    section.NameOffset = GetValue<vtkTypeUInt64>(description, 24);
+    section.NumberOfTuples = GetValue<vtkTypeUInt64>(description, 32);
+    section.DataOffset = GetValue<vtkTypeUInt64>(description, 40);
+    section.StoredSize = GetValue<vtkTypeUInt64>(description, 48);
+    if (section.NumberOfComponents < 1 || section.DataOffset > fileSize
+      || section.StoredSize > fileSize - section.DataOffset
+      || section.Encoding < Raw || section.Encoding > DeltaShuffledZlib)
+      {
+      vtkErrorMacro("RequestData: invalid section " << sectionIndex << " in " << this->FileName);
+      return 0;
+      }
+    if (section.Role < Points || section.Role > CellDataArray)
+      {
+      // section added by a later version of the format
+      continue;
+      }
+
+    bool isCellArray = (section.Role >= VertsOffsets && section.Role <= StripsConnectivity);
+    vtkSmartPointer<vtkDataArray> array;
+    if (isCellArray)
+      {
+      if (section.DataType == VTK_TYPE_INT32)
+        {
+        array = vtkSmartPointer<vtkTypeInt32Array>::New();
+        }
+      else if (section.DataType == VTK_TYPE_INT64)
+        {
+        array = vtkSmartPointer<vtkTypeInt64Array>::New();
+        }
+      }
+    else
+      {
+      array = vtkSmartPointer<vtkDataArray>::Take(vtkDataArray::CreateDataArray(section.DataType));
+      }
+    std::string name;
+    size_t numberOfValues = 0;
+    size_t size = 0;
+    if (!array || (isCellArray && section.NumberOfComponents != 1)
+      || !ReadString(file, fileSize, section.NameOffset, section.NameLength, name)
+      || !GetSectionSize(section, static_cast<size_t>(array->GetDataTypeSize()), numberOfValues, size))
+      {
+      vtkErrorMacro("RequestData: invalid section " << sectionIndex << " in " << this->FileName);
+      return 0;
+      }
+    // Check the stored size before allocating, so that a corrupted size
+    // cannot cause a huge allocation
+    if ((section.Encoding == Raw && section.StoredSize != size)
+      || (section.Encoding != Raw && size / MaximumZlibCompressionRatio > section.StoredSize))
+      {
+      vtkErrorMacro("RequestData: size of section " << sectionIndex << " does not match its stored size in "
+        << this->FileName << " (truncated or corrupted file)");
+      return 0;
+      }
+    if (!name.empty())
+      {
+      array->SetName(name.c_str());
+      }
+    array->SetNumberOfComponents(section.NumberOfComponents);
+    array->SetNumberOfTuples(static_cast<vtkIdType>(section.NumberOfTuples));
+    if (static_cast<size_t>(array->GetNumberOfValues()) != numberOfValues)
+      {
+      vtkErrorMacro("RequestData: failed to allocate section " << sectionIndex << " of " << this->FileName);
+      return 0;
+      }
+    if (!ReadArrayValues(file, section, array, this->DecompressionTime))
+      {
+      vtkErrorMacro("RequestData: failed to read section " << sectionIndex << " of " << this->FileName);
+      return 0;
+      }
+
+    if (section.Role == Points)
+      {
+      vtkNew<vtkPoints> points;
+      points->SetData(array);
+      polyData->SetPoints(points.GetPointer());
+      }
+    else if (isCellArray)
+      {
+      unsigned int cellArrayIndex = section.Role - VertsOffsets;
+      cellArrays[cellArrayIndex / 2][cellArrayIndex % 2] = array;
+      }
+    else
+      {
+      vtkDataSetAttributes* attributes = (section.Role == PointDataArray)
+        ? static_cast<vtkDataSetAttributes*>(polyData->GetPointData())
+        : static_cast<vtkDataSetAttributes*>(polyData->GetCellData());
+      attributes->AddArray(array);
+      if (section.AttributeType >= 0 && section.AttributeType < vtkDataSetAttributes::NUM_ATTRIBUTES && !name.empty())
+        {
+        attributes->SetActiveAttribute(name.c_str(), section.AttributeType);
+        }
+      }
+    }
+
+  for (int cellType = 0; cellType < 4; ++cellType)
+    {
+    vtkDataArray* offsets = cellArrays[cellType][0];
+    vtkDataArray* connectivity = cellArrays[cellType][1];
+    if (!offsets || !connectivity)
+      {
+      continue;
+      }
+    bool valid = false;
+    if (offsets->GetDataType() == connectivity->GetDataType())
+      {
+      valid = (offsets->GetDataType() == VTK_TYPE_INT32)
+        ? AreCellsValid<vtkTypeInt32>(offsets, connectivity, polyData->GetNumberOfPoints())
+        : AreCellsValid<vtkTypeInt64>(offsets, connectivity, polyData->GetNumberOfPoints());
+      }
+    if (!valid)
+      {
+      vtkErrorMacro("RequestData: inconsistent cells in " << this->FileName);
+      return 0;
+      }
+    vtkNew<vtkCellArray> cells;
+#if VTK_MAJOR_VERSION >= 9
+    cells->SetData(offsets, connectivity);
+#else
+    SetLegacyCells(cells.GetPointer(), offsets, connectivity);
+#endif
+    switch (cellType)
+      {
+      case 0: polyData->SetVerts(cells.GetPointer()); break;
+      case 1: polyData->SetLines(cells.GetPointer()); break;
+      case 2: polyData->SetPolys(cells.GetPointer()); break;
+      default: polyData->SetStrips(cells.GetPointer()); break;
+      }
+    }
+
+  output->ShallowCopy(polyData.GetPointer());
+  return 1;
+}
@@ -0,0 +1,117 @@
+/*=auto=========================================================================
+
+Portions (c) Copyright 2017 Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+See COPYRIGHT.txt
+or http://www.slicer.org/copyright/copyright.txt for details.
+
+=========================================================================auto=*/
+
+#ifndef __vtkBinaryMeshReader_h
+#define __vtkBinaryMeshReader_h
+
+// MRML includes
+#include "vtkMRML.h"
+
+// VTK includes
+#include <vtkPolyDataAlgorithm.h>
+
+// STD includes
+#include <string>
+
+/// \brief Read polydata stored in the Slicer binary mesh format (.bmesh).
+///
+/// The format is a flat container of arrays designed to be read with one
+/// read per array and without parsing:
+/// - a 64-byte file header: magic "SLCRMESH", format version, byte order
+///   mark (files are stored in the byte order of the writing machine),
+///   number of sections and location of the header text;
+/// - a table of 64-byte section descriptions (role, VTK data type, number of
+///   components and tuples, encoding, active attribute type, location of the
+///   array name and of the data);
+/// - the array names and data, each starting at a 64-byte aligned offset,
+///   so that raw sections can be read in place or memory-mapped.
+///
+/// Points are stored in their original precision. Cell arrays (vertices,
+/// lines, polygons, triangle strips) are stored as offsets and connectivity
+/// arrays of 32-bit integers when possible, 64-bit otherwise, which is the
+/// in-memory layout of vtkCellArray. Point and cell data arrays are stored
+/// with their active attribute.
+///
+/// Compressed sections are zlib streams of byte-shuffled values (the bytes
+/// of equal significance of all the values are stored together).
+/// Offsets and connectivity are delta-encoded before shuffling, which
+/// makes the indices of meshes with good vertex locality compress well.
+///
+/// Files are validated before any data is trusted: section sizes are
+/// checked against the file length before allocation, offsets must start
+/// at 0 and never decrease, and connectivity must only refer to existing
+/// points. Invalid files are reported as errors and produce an empty output.
+/// \sa vtkBinaryMeshWriter
+class VTK_MRML_EXPORT vtkBinaryMeshReader : public vtkPolyDataAlgorithm
+{
+public:
+  static vtkBinaryMeshReader *New();
+  vtkTypeMacro(vtkBinaryMeshReader, vtkPolyDataAlgorithm);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  /// Name of the file to read
+  vtkSetStringMacro(FileName);
+  vtkGetStringMacro(FileName);
+
+  /// Header text of the last read file
+  const char* GetHeader() { return this->Header.c_str(); }
+
+  /// Time spent decoding the compressed sections of the last read file, in seconds
+  vtkGetMacro(DecompressionTime, double);
+
+  /// Return true if \a fileName starts with the binary mesh magic
+  static bool CanReadFile(const char* fileName);
+
+  /// Role of a section in the file
+  enum SectionRole
+    {
+    Points = 1,
+    VertsOffsets,
+    VertsConnectivity,
+    LinesOffsets,
+    LinesConnectivity,
+    PolysOffsets,
+    PolysConnectivity,
+    StripsOffsets,
+    StripsConnectivity,
+    PointDataArray,
+    CellDataArray
+    };
+
+  /// Encoding of the values of a section
+  enum SectionEncoding
+    {
+    Raw = 0,
+    ShuffledZlib,
+    DeltaShuffledZlib
+    };
+
+  /// Format version written by vtkBinaryMeshWriter
+  static const unsigned int FormatVersion = 1;
+  /// Size in bytes of the file header, of a section description,
+  /// and alignment of the sections
+  static const unsigned int BlockSize = 64;
+
+protected:
+  vtkBinaryMeshReader();
+  ~vtkBinaryMeshReader() override;
+
+  int RequestData(vtkInformation* request, vtkInformationVector** inputVector,
+    vtkInformationVector* outputVector) override;
+
+  char* FileName;
+  std::string Header;
+  double DecompressionTime{0.0};
+
+private:
+  vtkBinaryMeshReader(const vtkBinaryMeshReader&) = delete;
+  void operator=(const vtkBinaryMeshReader&) = delete;
+};
+
+#endif
@@ -0,0 +1,400 @@
+/*=auto=========================================================================
+
+Portions (c) Copyright 2017 Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+See COPYRIGHT.txt
+or http://www.slicer.org/copyright/copyright.txt for details.
+
+=========================================================================auto=*/
+
+// MRML includes
+#include "vtkBinaryMeshReader.h"
+#include "vtkBinaryMeshWriter.h"
+
+// VTK includes
+#include <vtkCellArray.h>
+#include <vtkCellData.h>
+#include <vtkInformation.h>
+#include <vtkNew.h>
+#include <vtkObjectFactory.h>
+#include <vtkPointData.h>
+#include <vtkPolyData.h>
+#include <vtkSmartPointer.h>
+#include <vtkTypeInt32Array.h>
+#include <vtkTypeInt64Array.h>
+#include <vtkVersion.h>
+#include <vtk_zlib.h>
+
+// STD includes
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <vector>
+
+//----------------------------------------------------------------------------
+namespace
+{
+//----------------------------------------------------------------------------
+struct MeshSection
+{
+  unsigned int Role;
+  vtkSmartPointer<vtkDataArray> Array;
+  int AttributeType;
+};
+
+//----------------------------------------------------------------------------
+template <class T>
+void PutValue(char* block, size_t offset, T value)
+{
+  memcpy(block + offset, &value, sizeof(T));
+}
+
+//----------------------------------------------------------------------------
+/// Replace each value by its difference with the previous one.
+/// Unsigned arithmetic makes the encoding reversible for any value.
+template <class T>
+void DeltaEncode(const unsigned char* values, unsigned char* deltas, size_t numberOfValues)
+{
+  T previous = 0;
+  for (size_t i = 0; i < numberOfValues; ++i)
+    {
+    T value;
+    memcpy(&value, values + i * sizeof(T), sizeof(T));
+    T delta = static_cast<T>(value - previous);
+    memcpy(deltas + i * sizeof(T), &delta, sizeof(T));
+    previous = value;
+    }
+}
+
+//----------------------------------------------------------------------------
+/// Compress the values of \a array in \a encoded.
+/// Return false if the array should be stored raw.
+bool EncodeArray(vtkDataArray* array, bool delta, int compressionLevel, std::vector<char>& encoded)
+{
+  size_t valueSize = static_cast<size_t>(array->GetDataTypeSize());
+  size_t numberOfValues = static_cast<size_t>(array->GetNumberOfTuples()) * array->GetNumberOfComponents();
+  size_t size = valueSize * numberOfValues;
+  if (size == 0 || size > static_cast<size_t>(std::numeric_limits<uLong>::max()))
+    {
+    return false;
+    }
+  const unsigned char* values = static_cast<const unsigned char*>(array->GetVoidPointer(0));
+
+  std::vector<unsigned char> deltas;
+  if (delta)
+    {
+    deltas.resize(size);
+    if (valueSize == 4)
+      {
+      DeltaEncode<vtkTypeUInt32>(values, deltas.data(), numberOfValues);
+      }
+    else
+      {
+      DeltaEncode<vtkTypeUInt64>(values, deltas.data(), numberOfValues);
+      }
+    values = deltas.data();
+    }
+
+  // group the bytes of equal significance, which are similar in neighbor values
+  std::vector<unsigned char> shuffled(size);
+  for (size_t byteIndex = 0; byteIndex < valueSize; ++byteIndex)
+    {
+    unsigned char* shuffledBytes = shuffled.data() + byteIndex * numberOfValues;
+    const unsigned char* valueBytes = values + byteIndex;
+    for (size_t i = 0; i < numberOfValues; ++i)
+      {
+      shuffledBytes[i] = valueBytes[i * valueSize];
+      }
+    }
+  deltas.clear();
+  deltas.shrink_to_fit();
+
+  uLongf compressedSize = compressBound(static_cast<uLong>(size));
+  encoded.resize(compressedSize);
+  if (compress2(reinterpret_cast<Bytef*>(encoded.data()), &compressedSize,
+    shuffled.data(), static_cast<uLong>(size), compressionLevel) != Z_OK
+    || compressedSize >= size)
+    {
+    return false;
+    }
+  encoded.resize(compressedSize);
+  return true;
+}
+
+//----------------------------------------------------------------------------
+template <class T, class ArrayType>
+void CopyIds(vtkDataArray* source, ArrayType* target)
+{
+  vtkIdType numberOfValues = source->GetNumberOfTuples();
+  target->SetNumberOfValues(numberOfValues);
+  const T* sourceValues = static_cast<const T*>(source->GetVoidPointer(0));
+  for (vtkIdType i = 0; i < numberOfValues; ++i)
+    {
+    target->SetValue(i, sourceValues[i]);
+    }
+}
+
+//----------------------------------------------------------------------------
+/// Get the offsets and connectivity arrays of \a cells, 32-bit if possible.
+void GetCellArrays(vtkCellArray* cells, vtkIdType numberOfPoints,
+  vtkSmartPointer<vtkDataArray>& offsets, vtkSmartPointer<vtkDataArray>& connectivity)
+{
+#if VTK_MAJOR_VERSION >= 9
+  bool fitsIn32Bit = numberOfPoints < VTK_TYPE_INT32_MAX
+    && cells->GetNumberOfConnectivityIds() < VTK_TYPE_INT32_MAX;
+  if (!cells->IsStorage64Bit() || !fitsIn32Bit)
+    {
+    offsets = cells->GetOffsetsArray();
+    connectivity = cells->GetConnectivityArray();
+    return;
+    }
+  vtkNew<vtkTypeInt32Array> offsets32;
+  CopyIds<vtkTypeInt64>(cells->GetOffsetsArray(), offsets32.GetPointer());
+  vtkNew<vtkTypeInt32Array> connectivity32;
+  CopyIds<vtkTypeInt64>(cells->GetConnectivityArray(), connectivity32.GetPointer());
+  offsets = offsets32.GetPointer();
+  connectivity = connectivity32.GetPointer();
+#else
+  // legacy layout: number of points of the cell followed by its point ids
+  vtkIdType numberOfCells = cells->GetNumberOfCells();
+  vtkIdType connectivitySize = cells->GetNumberOfConnectivityEntries() - numberOfCells;
+  if (numberOfPoints < VTK_TYPE_INT32_MAX && connectivitySize < VTK_TYPE_INT32_MAX)
+    {
+    offsets = vtkSmartPointer<vtkTypeInt32Array>::New();
+    connectivity = vtkSmartPointer<vtkTypeInt32Array>::New();
+    }
+  else
+    {
+    offsets = vtkSmartPointer<vtkTypeInt64Array>::New();
+    connectivity = vtkSmartPointer<vtkTypeInt64Array>::New();
+    }
+  offsets->SetNumberOfTuples(numberOfCells + 1);
+  connectivity->SetNumberOfTuples(connectivitySize);
+  vtkIdType offset = 0;
+  vtkIdType cellIndex = 0;
+  vtkIdType npts = 0;
+  vtkIdType* pts = nullptr;
+  for (cells->InitTraversal(); cells->GetNextCell(npts, pts); ++cellIndex)
+    {
+    offsets->SetTuple1(cellIndex, offset);
+    for (vtkIdType i = 0; i < npts; ++i)
+      {
+      connectivity->SetTuple1(offset + i, pts[i]);
+      }
+    offset += npts;
+    }
+  offsets->SetTuple1(numberOfCells, offset);
+#endif
+}
+
+//----------------------------------------------------------------------------
+void AddAttributeSections(vtkDataSetAttributes* attributes, unsigned int role, std::vector<MeshSection>& sections)
+{
+  for (int i = 0; i < attributes->GetNumberOfArrays(); ++i)
+    {
+    vtkDataArray* array = attributes->GetArray(i);
+    if (!array)
+      {
+      // not a numeric array
+      continue;
+      }
+    MeshSection section = { role, array, attributes->IsArrayAnAttribute(i) };
+    sections.push_back(section);
+    }
+}
+
+//----------------------------------------------------------------------------
+bool WritePadding(std::ofstream& file, vtkTypeUInt64& position)
+{
+  static const char zeros[vtkBinaryMeshReader::BlockSize] = { 0 };
+  vtkTypeUInt64 padding = (vtkBinaryMeshReader::BlockSize - position % vtkBinaryMeshReader::BlockSize) % vtkBinaryMeshReader::BlockSize;
+  file.write(zeros, static_cast<std::streamsize>(padding));
+  position += padding;
+  return file.good();
+}
+}
+
+//----------------------------------------------------------------------------
+vtkStandardNewMacro(vtkBinaryMeshWriter);
+
+//----------------------------------------------------------------------------
+vtkBinaryMeshWriter::vtkBinaryMeshWriter()
+{
+  this->FileName = nullptr;
+  this->Header = nullptr;
+  this->UseCompression = true;
+  this->CompressionLevel = 1;
+  this->WriteError = false;
+}
+
+//----------------------------------------------------------------------------
+vtkBinaryMeshWriter::~vtkBinaryMeshWriter()
+{
+  this->SetFileName(nullptr);
+  this->SetHeader(nullptr);
+}
+
+//----------------------------------------------------------------------------
+void vtkBinaryMeshWriter::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "FileName: " << (this->FileName ? this->FileName : "(none)") << "\n";
+  os << indent << "Header: " << (this->Header ? this->Header : "(none)") << "\n";
+  os << indent << "UseCompression: " << this->UseCompression << "\n";
+  os << indent << "CompressionLevel: " << this->CompressionLevel << "\n";
+}
+
+//----------------------------------------------------------------------------
+vtkPolyData* vtkBinaryMeshWriter::GetInput()
+{
+  return vtkPolyData::SafeDownCast(this->Superclass::GetInput());
+}
+
+//----------------------------------------------------------------------------
+int vtkBinaryMeshWriter::FillInputPortInformation(int vtkNotUsed(port), vtkInformation *info)
+{
+  info->Set(vtkAlgorithm::INPUT_REQUIRED_DATA_TYPE(), "vtkPolyData");
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+void vtkBinaryMeshWriter::WriteData()
+{
+  this->WriteError = true;
+  vtkPolyData* input = this->GetInput();
+  if (!input)
+    {
+    vtkErrorMacro("WriteData: no input polydata");
+    return;
+    }
+  if (!this->FileName)
+    {
+    vtkErrorMacro("WriteData: file name is not set");
+    return;
+    }
+
+  std::vector<MeshSection> sections;
+  vtkIdType numberOfPoints = input->GetNumberOfPoints();
+  if (input->GetPoints())
+    {
+    MeshSection section = { vtkBinaryMeshReader::Points, input->GetPoints()->GetData(), -1 };
+    sections.push_back(section);
+    }
+  vtkCellArray* cellArrays[4] = { input->GetVerts(), input->GetLines(), input->GetPolys(), input->GetStrips() };
+  const unsigned int offsetsRoles[4] = { vtkBinaryMeshReader::VertsOffsets, vtkBinaryMeshReader::LinesOffsets,
+    vtkBinaryMeshReader::PolysOffsets, vtkBinaryMeshReader::StripsOffsets };
+  for (int cellType = 0; cellType < 4; ++cellType)
+    {
+    if (!cellArrays[cellType] || cellArrays[cellType]->GetNumberOfCells() == 0)
+      {
+      continue;
+      }
+    vtkSmartPointer<vtkDataArray> offsets;
+    vtkSmartPointer<vtkDataArray> connectivity;
+    GetCellArrays(cellArrays[cellType], numberOfPoints, offsets, connectivity);
+    // connectivity role immediately follows the offsets role
+    MeshSection offsetsSection = { offsetsRoles[cellType], offsets, -1 };
+    MeshSection connectivitySection = { offsetsRoles[cellType] + 1, connectivity, -1 };
+    sections.push_back(offsetsSection);
+    sections.push_back(connectivitySection);
+    }
+  AddAttributeSections(input->GetPointData(), vtkBinaryMeshReader::PointDataArray, sections);
+  AddAttributeSections(input->GetCellData(), vtkBinaryMeshReader::CellDataArray, sections);
+
+  std::ofstream file(this->FileName, std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!file.is_open())
+    {
+    vtkErrorMacro("WriteData: failed to open file " << this->FileName);
+    return;
+    }
+
+  // header and section table are written last, once all locations are known
+  const size_t blockSize = vtkBinaryMeshReader::BlockSize;
+  std::vector<char> table(blockSize * (sections.size() + 1), 0);
+  file.write(table.data(), static_cast<std::streamsize>(table.size()));
+  vtkTypeUInt64 position = table.size();
+
+  std::string header = this->Header ? this->Header : "";
+  vtkTypeUInt64 headerOffset = position;
+  file.write(header.c_str(), static_cast<std::streamsize>(header.size()));
+  position += header.size();
+
+  std::vector<char> encoded;
+  for (size_t sectionIndex = 0; sectionIndex < sections.size(); ++sectionIndex)
+    {
+    const MeshSection& section = sections[sectionIndex];
+    vtkDataArray* array = section.Array;
+    std::string name = array->GetName() ? array->GetName() : "";
+
+    WritePadding(file, position);
+    vtkTypeUInt64 nameOffset = position;
+    file.write(name.c_str(), static_cast<std::streamsize>(name.size()));
+    position += name.size();
+
+    bool isCellArray = (section.Role >= vtkBinaryMeshReader::VertsOffsets
+      && section.Role <= vtkBinaryMeshReader::StripsConnectivity);
+    int encoding = vtkBinaryMeshReader::Raw;
+    if (this->UseCompression && EncodeArray(array, isCellArray, this->CompressionLevel, encoded))
+      {
+      encoding = isCellArray ? vtkBinaryMeshReader::DeltaShuffledZlib : vtkBinaryMeshReader::ShuffledZlib;
+      }
+
+    WritePadding(file, position);
+    vtkTypeUInt64 dataOffset = position;
+    vtkTypeUInt64 storedSize = 0;
+    if (encoding == vtkBinaryMeshReader::Raw)
+      {
+      storedSize = static_cast<vtkTypeUInt64>(array->GetNumberOfTuples())
+        * array->GetNumberOfComponents() * array->GetDataTypeSize();
+      if (storedSize > 0)
+        {
+        file.write(static_cast<const char*>(array->GetVoidPointer(0)), static_cast<std::streamsize>(storedSize));
+        }
+      }
+    else
+      {
+      storedSize = encoded.size();
+      file.write(encoded.data(), static_cast<std::streamsize>(storedSize));
+      }
+    position += storedSize;
+    if (!file.good())
+      {
+      vtkErrorMacro("WriteData: failed to write file " << this->FileName);
+      return;
+      }
+
+    int dataType = array->GetDataType();
+    if (isCellArray)
+      {
+      dataType = (array->GetDataTypeSize() == 4 ? VTK_TYPE_INT32 : VTK_TYPE_INT64);
+      }
+    char* description = table.data() + blockSize * (sectionIndex + 1);
+    PutValue<vtkTypeUInt32>(description, 0, section.Role);
+    PutValue<vtkTypeInt32>(description, 4, dataType);
+    PutValue<vtkTypeInt32>(description, 8, array->GetNumberOfComponents());
+    PutValue<vtkTypeInt32>(description, 12, encoding);
+    PutValue<vtkTypeInt32>(description, 16, section.AttributeType);
+    PutValue<vtkTypeUInt32>(description, 20, static_cast<vtkTypeUInt32>(name.size()));
+    PutValue<vtkTypeUInt64>(description, 24, nameOffset);
+    PutValue<vtkTypeUInt64>(description, 32, static_cast<vtkTypeUInt64>(array->GetNumberOfTuples()));
+    PutValue<vtkTypeUInt64>(description, 40, dataOffset);
+    PutValue<vtkTypeUInt64>(description, 48, storedSize);
+    }
+
+  char* fileHeader = table.data();
+  memcpy(fileHeader, "SLCRMESH", 8);
+  PutValue<vtkTypeUInt32>(fileHeader, 8, vtkBinaryMeshReader::FormatVersion);
+  PutValue<vtkTypeUInt32>(fileHeader, 12, 0x01020304);
+  PutValue<vtkTypeUInt32>(fileHeader, 16, static_cast<vtkTypeUInt32>(sections.size()));
+  PutValue<vtkTypeUInt32>(fileHeader, 20, static_cast<vtkTypeUInt32>(header.size()));
+  PutValue<vtkTypeUInt64>(fileHeader, 24, headerOffset);
+  file.seekp(0);
+  file.write(table.data(), static_cast<std::streamsize>(table.size()));
+  file.close();
+  if (file.fail())
+    {
+    vtkErrorMacro("WriteData: failed to write file " << this->FileName);
+    return;
+    }
+  this->WriteError = false;
+}
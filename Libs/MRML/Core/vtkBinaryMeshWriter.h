@@ -0,0 +1,81 @@
+/*=auto=========================================================================
+
+Portions (c) Copyright 2017 Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+See COPYRIGHT.txt
+or http://www.slicer.org/copyright/copyright.txt for details.
+
+=========================================================================auto=*/
+
+#ifndef __vtkBinaryMeshWriter_h
+#define __vtkBinaryMeshWriter_h
+
+// MRML includes
+#include "vtkMRML.h"
+
+// VTK includes
+#include <vtkWriter.h>
+
+class vtkPolyData;
+
+/// \brief Write polydata in the Slicer binary mesh format (.bmesh).
+///
+/// Points, cells, and numeric point and cell data arrays are written as
+/// contiguous binary sections, which makes writing and reading large
+/// surfaces much faster than with the legacy and XML VTK formats.
+/// See vtkBinaryMeshReader for a description of the format.
+/// Non-numeric arrays (such as string arrays) are not written.
+/// \sa vtkBinaryMeshReader
+class VTK_MRML_EXPORT vtkBinaryMeshWriter : public vtkWriter
+{
+public:
+  static vtkBinaryMeshWriter *New();
+  vtkTypeMacro(vtkBinaryMeshWriter, vtkWriter);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  /// Get the input to this writer.
+  vtkPolyData* GetInput();
+
+  /// Name of the file to write
+  vtkSetStringMacro(FileName);
+  vtkGetStringMacro(FileName);
+
+  /// Text stored in the file, for example to specify the coordinate system.
+  vtkSetStringMacro(Header);
+  vtkGetStringMacro(Header);
+
+  /// Compress the sections with zlib, after byte-shuffling the values and
+  /// delta-encoding the cell indices. Default is on.
+  vtkSetMacro(UseCompression, bool);
+  vtkGetMacro(UseCompression, bool);
+  vtkBooleanMacro(UseCompression, bool);
+
+  /// zlib compression level. Default is 1, which gives most of the size
+  /// reduction at a fraction of the time of higher levels.
+  vtkSetClampMacro(CompressionLevel, int, 0, 9);
+  vtkGetMacro(CompressionLevel, int);
+
+  /// Flag that is set by WriteData() if writing fails.
+  vtkGetMacro(WriteError, bool);
+
+protected:
+  vtkBinaryMeshWriter();
+  ~vtkBinaryMeshWriter() override;
+
+  int FillInputPortInformation(int port, vtkInformation *info) override;
+
+  /// Write method. It is called by vtkWriter::Write();
+  void WriteData() override;
+
+  char* FileName;
+  char* Header;
+  bool UseCompression;
+  int CompressionLevel;
+  bool WriteError;
+
+private:
+  vtkBinaryMeshWriter(const vtkBinaryMeshWriter&) = delete;
+  void operator=(const vtkBinaryMeshWriter&) = delete;
+};
+
+#endif
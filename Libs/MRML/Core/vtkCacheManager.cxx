@@ -10,10 +10,77 @@
 #include <vtkCallbackCommand.h>
 #include <vtkObjectFactory.h>
 
+// STD includes
+#include <algorithm>
+#include <fstream>
+#include <mutex>
+#include <set>
+#include <sstream>
+
 vtkStandardNewMacro ( vtkCacheManager );
 
 #define MB 1000000.0
 
+namespace
+{
+//----------------------------------------------------------------------------
+/// Record of a cached file in the cache index
+struct vtkCacheIndexEntry
+{
+  std::string URI;
+  vtkTypeInt64 Size{0};
+  /// Milliseconds since the epoch
+  vtkTypeInt64 LastAccessTime{0};
+  std::string ETag;
+  std::string LastModified;
+};
+
+//----------------------------------------------------------------------------
+vtkTypeInt64 GetCurrentTimeInMilliseconds()
+{
+  return static_cast<vtkTypeInt64>(vtksys::SystemTools::GetTime() * 1000.0);
+}
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+class vtkCacheManager::vtkInternal
+{
+public:
+  /// Returns the path of the file relative to the cache directory,
+  /// or an empty string if the file is not in the cache directory.
+  std::string GetRelativeFileName(const std::string& cacheDirectory, const char* filename) const;
+
+  std::mutex Mutex;
+  /// Cached files, the key is the file path relative to the cache directory
+  std::map<std::string, vtkCacheIndexEntry> Index;
+  /// Sum of the file sizes in the index, in bytes
+  vtkTypeInt64 IndexSize{0};
+};
+
+//----------------------------------------------------------------------------
+std::string vtkCacheManager::vtkInternal::GetRelativeFileName(const std::string& cacheDirectory, const char* filename) const
+{
+  if (filename == nullptr || cacheDirectory.empty())
+    {
+    return std::string();
+    }
+  std::string name = filename;
+  vtksys::SystemTools::ConvertToUnixSlashes(name);
+  std::string directory = cacheDirectory;
+  vtksys::SystemTools::ConvertToUnixSlashes(directory);
+  directory += "/";
+  if (name.compare(0, directory.size(), directory) == 0)
+    {
+    return name.substr(directory.size());
+    }
+  if (!vtksys::SystemTools::FileIsFullPath(name))
+    {
+    return name;
+    }
+  return std::string();
+}
+
 //----------------------------------------------------------------------------
 vtkCacheManager::vtkCacheManager()
 {
@@ -25,9 +92,11 @@ vtkCacheManager::vtkCacheManager()
   this->RemoteCacheFreeBufferSize = 10;
   this->CurrentCacheSize = 0;
   this->EnableForceRedownload = 0;
+  this->EnableLeastRecentlyUsedRemoval = 1;
   this->InsufficientFreeBufferNotificationFlag = 0;
   // this->EnableRemoteCacheOverwriting = 1;
   this->uriMap.clear();
+  this->Internal = new vtkInternal;
 }
 
 
@@ -48,6 +117,7 @@ vtkCacheManager::~vtkCacheManager()
   this->EnableForceRedownload = 0;
   this->InsufficientFreeBufferNotificationFlag = 0;
 //  this->EnableRemoteCacheOverwriting = 1;
+  delete this->Internal;
 }
 
 
@@ -133,7 +203,12 @@ void vtkCacheManager::SetRemoteCacheDirectory (const char *dir )
     {
     vtksys::SystemTools::MakeDirectory(this->RemoteCacheDirectory.c_str());
     }
-  // scan files in cache, it calls Modified
+  if ( this->ReadCacheIndex() )
+    {
+    this->Modified();
+    return;
+    }
+  //--- no index yet: scan files in cache, it calls Modified
   this->UpdateCacheInformation();
 }
 
@@ -254,6 +329,9 @@ void vtkCacheManager::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "RemoteCacheFreeBufferSize: " << this->GetRemoteCacheFreeBufferSize() << "\n";
   //os << indent << "EnableRemoteCacheOverwriting: " << this->GetEnableRemoteCacheOverwriting() << "\n";
   os << indent << "EnableForceRedownload: " << this->GetEnableForceRedownload() << "\n";
+  os << indent << "EnableLeastRecentlyUsedRemoval: " << this->GetEnableLeastRecentlyUsedRemoval() << "\n";
+  std::lock_guard<std::mutex> lock(this->Internal->Mutex);
+  os << indent << "NumberOfIndexedFiles: " << this->Internal->Index.size() << "\n";
 }
 
 
@@ -269,7 +347,15 @@ std::vector< std::string > vtkCacheManager::GetAllCachedFiles ( )
 //----------------------------------------------------------------------------
 std::vector< std::string > vtkCacheManager::GetCachedFiles ( ) const
 {
-  return this->CachedFileList;
+  //--- the index is kept up to date with every download,
+  //--- there is no need to scan the cache directory.
+  std::vector< std::string > cachedFiles;
+  std::lock_guard<std::mutex> lock(this->Internal->Mutex);
+  for ( const auto& entry : this->Internal->Index )
+    {
+    cachedFiles.push_back ( vtksys::SystemTools::GetFilenameName ( entry.first ) );
+    }
+  return cachedFiles;
 }
 
 //----------------------------------------------------------------------------
@@ -307,7 +393,7 @@ int vtkCacheManager::GetCachedFileList ( const char *dirname )
               return (0);
               }
             }
-          else
+          else if ( strcmp(dir.GetFile(static_cast<unsigned long>(fileNum)), vtkCacheManager::GetCacheIndexFileName()) )
             {
             this->CachedFileList.emplace_back(dir.GetFile(static_cast<unsigned long>(fileNum)));
             }
@@ -517,9 +603,317 @@ void vtkCacheManager::UpdateCacheInformation ( )
   //--- and refresh list of cached files.
   this->CachedFileList.clear();
   this->GetCachedFileList ( this->GetRemoteCacheDirectory() );
+
+  //--- and make the index consistent with the files on disk.
+    {
+    std::lock_guard<std::mutex> lock(this->Internal->Mutex);
+    for ( auto it = this->Internal->Index.begin(); it != this->Internal->Index.end(); )
+      {
+      std::string fileName = this->RemoteCacheDirectory + "/" + it->first;
+      if ( vtksys::SystemTools::FileExists ( fileName.c_str(), true ) )
+        {
+        ++it;
+        }
+      else
+        {
+        this->Internal->IndexSize -= it->second.Size;
+        it = this->Internal->Index.erase ( it );
+        }
+      }
+    if ( !this->RemoteCacheDirectory.empty() &&
+         vtksys::SystemTools::FileIsDirectory ( this->RemoteCacheDirectory ) )
+      {
+      this->AddDirectoryToCacheIndex ( this->RemoteCacheDirectory );
+      this->WriteCacheIndex();
+      }
+    }
   this->Modified();
 }
 
+//----------------------------------------------------------------------------
+const char* vtkCacheManager::GetCacheIndexFileName ( )
+{
+  return "SlicerCacheIndex.txt";
+}
+
+//----------------------------------------------------------------------------
+bool vtkCacheManager::ReadCacheIndex()
+{
+  std::lock_guard<std::mutex> lock(this->Internal->Mutex);
+  this->Internal->Index.clear();
+  this->Internal->IndexSize = 0;
+  std::string indexFileName = this->RemoteCacheDirectory + "/" + vtkCacheManager::GetCacheIndexFileName();
+  std::ifstream indexFile ( indexFileName.c_str() );
+  if ( !indexFile.is_open() )
+    {
+    return false;
+    }
+  //--- one line per file:
+  //--- last access time, size, ETag, Last-Modified, file name, uri (tab separated)
+  std::string line;
+  while ( std::getline ( indexFile, line ) )
+    {
+    if ( line.empty() || line[0] == '#' )
+      {
+      continue;
+      }
+    std::vector<std::string> fields;
+    std::string::size_type begin = 0;
+    while ( fields.size() < 5 )
+      {
+      std::string::size_type end = line.find ( '\t', begin );
+      if ( end == std::string::npos )
+        {
+        break;
+        }
+      fields.push_back ( line.substr ( begin, end - begin ) );
+      begin = end + 1;
+      }
+    if ( fields.size() < 5 )
+      {
+      vtkWarningMacro ( "ReadCacheIndex: ignoring invalid line in " << indexFileName << ": " << line );
+      continue;
+      }
+    std::string fileName = this->RemoteCacheDirectory + "/" + fields[4];
+    if ( !vtksys::SystemTools::FileExists ( fileName.c_str(), true ) )
+      {
+      //--- removed since the index was saved
+      continue;
+      }
+    vtkCacheIndexEntry entry;
+    entry.LastAccessTime = atoll ( fields[0].c_str() );
+    entry.Size = atoll ( fields[1].c_str() );
+    entry.ETag = fields[2];
+    entry.LastModified = fields[3];
+    entry.URI = line.substr ( begin );
+    this->Internal->IndexSize += entry.Size;
+    this->Internal->Index[fields[4]] = entry;
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+void vtkCacheManager::WriteCacheIndex()
+{
+  if ( this->RemoteCacheDirectory.empty() )
+    {
+    return;
+    }
+  //--- write a temporary file first, so that the index
+  //--- is not lost if writing is interrupted.
+  std::string indexFileName = this->RemoteCacheDirectory + "/" + vtkCacheManager::GetCacheIndexFileName();
+  std::string temporaryFileName = indexFileName + ".tmp";
+    {
+    std::ofstream indexFile ( temporaryFileName.c_str() );
+    if ( !indexFile.is_open() )
+      {
+      vtkWarningMacro ( "WriteCacheIndex: unable to write cache index " << temporaryFileName );
+      return;
+      }
+    indexFile << "# Slicer cache index: last access time (ms), size (bytes), ETag, Last-Modified, file name, URI\n";
+    for ( const auto& item : this->Internal->Index )
+      {
+      const vtkCacheIndexEntry& entry = item.second;
+      indexFile << entry.LastAccessTime << "\t" << entry.Size << "\t"
+                << entry.ETag << "\t" << entry.LastModified << "\t"
+                << item.first << "\t" << entry.URI << "\n";
+      }
+    }
+  if ( !vtksys::SystemTools::RenameFile ( temporaryFileName, indexFileName ) )
+    {
+    vtkWarningMacro ( "WriteCacheIndex: unable to replace cache index " << indexFileName );
+    vtksys::SystemTools::RemoveFile ( temporaryFileName );
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkCacheManager::AddDirectoryToCacheIndex(const std::string& dirname)
+{
+  vtksys::Directory dir;
+  dir.Load( dirname );
+  for ( unsigned long fileNum = 0; fileNum < dir.GetNumberOfFiles(); ++fileNum )
+    {
+    const char* name = dir.GetFile ( fileNum );
+    if ( !strcmp ( name, "." ) || !strcmp ( name, ".." ) )
+      {
+      continue;
+      }
+    std::string fullName = dirname + "/" + name;
+    if ( vtksys::SystemTools::FileIsDirectory ( fullName ) )
+      {
+      this->AddDirectoryToCacheIndex ( fullName );
+      continue;
+      }
+    std::string relativeName = this->Internal->GetRelativeFileName ( this->RemoteCacheDirectory, fullName.c_str() );
+    if ( relativeName.empty() || this->Internal->Index.count ( relativeName ) ||
+         relativeName.compare ( 0, strlen ( vtkCacheManager::GetCacheIndexFileName() ),
+                                vtkCacheManager::GetCacheIndexFileName() ) == 0 )
+      {
+      continue;
+      }
+    if ( vtksys::SystemTools::GetFilenameLastExtension ( relativeName ) == ".part" )
+      {
+      //--- download in progress (or interrupted), it is added when completed
+      continue;
+      }
+    //--- file of unknown origin: the modification time is the best guess of the last access
+    vtkCacheIndexEntry entry;
+    entry.Size = static_cast<vtkTypeInt64>( vtksys::SystemTools::FileLength ( fullName ) );
+    entry.LastAccessTime = static_cast<vtkTypeInt64>( vtksys::SystemTools::ModifiedTime ( fullName ) ) * 1000;
+    this->Internal->IndexSize += entry.Size;
+    this->Internal->Index[relativeName] = entry;
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkCacheManager::AddToCacheIndex ( const char *uri, const char *filename,
+                                        const char *eTag, const char *lastModified )
+{
+  if ( filename == nullptr || !vtksys::SystemTools::FileExists ( filename, true ) )
+    {
+    vtkDebugMacro ( "AddToCacheIndex: file does not exist: " << ( filename ? filename : "(null)" ) );
+    return;
+    }
+  std::lock_guard<std::mutex> lock(this->Internal->Mutex);
+  std::string relativeName = this->Internal->GetRelativeFileName ( this->RemoteCacheDirectory, filename );
+  if ( relativeName.empty() )
+    {
+    vtkDebugMacro ( "AddToCacheIndex: file is not in the cache directory: " << filename );
+    return;
+    }
+  vtkCacheIndexEntry& entry = this->Internal->Index[relativeName];
+  this->Internal->IndexSize -= entry.Size;
+  entry.Size = static_cast<vtkTypeInt64>( vtksys::SystemTools::FileLength ( filename ) );
+  this->Internal->IndexSize += entry.Size;
+  entry.LastAccessTime = GetCurrentTimeInMilliseconds();
+  if ( uri != nullptr )
+    {
+    entry.URI = uri;
+    }
+  entry.ETag = eTag ? eTag : "";
+  entry.LastModified = lastModified ? lastModified : "";
+  this->WriteCacheIndex();
+}
+
+//----------------------------------------------------------------------------
+void vtkCacheManager::MarkCachedFileAccessed ( const char *filename )
+{
+  std::lock_guard<std::mutex> lock(this->Internal->Mutex);
+  std::string relativeName = this->Internal->GetRelativeFileName ( this->RemoteCacheDirectory, filename );
+  auto it = this->Internal->Index.find ( relativeName );
+  if ( it == this->Internal->Index.end() )
+    {
+    return;
+    }
+  it->second.LastAccessTime = GetCurrentTimeInMilliseconds();
+  this->WriteCacheIndex();
+}
+
+//----------------------------------------------------------------------------
+std::string vtkCacheManager::GetCachedFileETag ( const char *uri )
+{
+  std::lock_guard<std::mutex> lock(this->Internal->Mutex);
+  for ( const auto& item : this->Internal->Index )
+    {
+    if ( uri != nullptr && item.second.URI == uri )
+      {
+      return item.second.ETag;
+      }
+    }
+  return std::string();
+}
+
+//----------------------------------------------------------------------------
+std::string vtkCacheManager::GetCachedFileLastModified ( const char *uri )
+{
+  std::lock_guard<std::mutex> lock(this->Internal->Mutex);
+  for ( const auto& item : this->Internal->Index )
+    {
+    if ( uri != nullptr && item.second.URI == uri )
+      {
+      return item.second.LastModified;
+      }
+    }
+  return std::string();
+}
+
+//----------------------------------------------------------------------------
+int vtkCacheManager::RemoveLeastRecentlyUsedFiles ( )
+{
+  //--- files of loaded nodes are kept
+  std::set<std::string> filesInUse;
+  if ( this->MRMLScene != nullptr )
+    {
+    int nnodes = this->MRMLScene->GetNumberOfNodesByClass ( "vtkMRMLStorageNode" );
+    for ( int n = 0; n < nnodes; n++ )
+      {
+      vtkMRMLStorageNode *storageNode = vtkMRMLStorageNode::SafeDownCast (
+        this->MRMLScene->GetNthNodeByClass ( n, "vtkMRMLStorageNode" ) );
+      if ( storageNode == nullptr )
+        {
+        continue;
+        }
+      filesInUse.insert ( this->Internal->GetRelativeFileName (
+        this->RemoteCacheDirectory, storageNode->GetFullNameFromFileName().c_str() ) );
+      for ( int i = 0; i < storageNode->GetNumberOfFileNames(); i++ )
+        {
+        filesInUse.insert ( this->Internal->GetRelativeFileName (
+          this->RemoteCacheDirectory, storageNode->GetFullNameFromNthFileName(i).c_str() ) );
+        }
+      }
+    }
+
+  int numberOfRemovedFiles = 0;
+    {
+    std::lock_guard<std::mutex> lock(this->Internal->Mutex);
+    const vtkTypeInt64 maximumSize = static_cast<vtkTypeInt64>(
+      ( this->RemoteCacheLimit - this->RemoteCacheFreeBufferSize ) * MB );
+    if ( this->Internal->IndexSize <= maximumSize )
+      {
+      return 0;
+      }
+    std::vector< std::pair<vtkTypeInt64, std::string> > filesByAccessTime;
+    for ( const auto& item : this->Internal->Index )
+      {
+      if ( !filesInUse.count ( item.first ) )
+        {
+        filesByAccessTime.emplace_back ( item.second.LastAccessTime, item.first );
+        }
+      }
+    std::sort ( filesByAccessTime.begin(), filesByAccessTime.end() );
+    for ( const auto& file : filesByAccessTime )
+      {
+      if ( this->Internal->IndexSize <= maximumSize )
+        {
+        break;
+        }
+      std::string fileName = this->RemoteCacheDirectory + "/" + file.second;
+      vtkDebugMacro ( "RemoveLeastRecentlyUsedFiles: removing " << fileName );
+      if ( vtksys::SystemTools::FileExists ( fileName.c_str(), true ) &&
+           !vtksys::SystemTools::RemoveFile ( fileName ) )
+        {
+        vtkWarningMacro ( "RemoveLeastRecentlyUsedFiles: unable to remove cached file " << fileName << " from disk." );
+        continue;
+        }
+      auto it = this->Internal->Index.find ( file.second );
+      this->Internal->IndexSize -= it->second.Size;
+      this->Internal->Index.erase ( it );
+      this->DeleteFromCachedFileList ( vtksys::SystemTools::GetFilenameName ( file.second ).c_str() );
+      ++numberOfRemovedFiles;
+      }
+    if ( numberOfRemovedFiles > 0 )
+      {
+      this->WriteCacheIndex();
+      }
+    }
+  if ( numberOfRemovedFiles > 0 )
+    {
+    this->Modified();
+    this->InvokeEvent ( vtkCacheManager::CacheDeleteEvent );
+    }
+  return numberOfRemovedFiles;
+}
+
 
 
 
@@ -642,6 +1036,9 @@ int vtkCacheManager::ClearCache()
     {
     this->MarkNodesBeforeDeletingDataFromCache ( this->RemoteCacheDirectory.c_str() );
     vtksys::SystemTools::RemoveADirectory ( this->RemoteCacheDirectory.c_str() );
+    std::lock_guard<std::mutex> lock(this->Internal->Mutex);
+    this->Internal->Index.clear();
+    this->Internal->IndexSize = 0;
     }
   if ( vtksys::SystemTools::MakeDirectory ( this->RemoteCacheDirectory.c_str() ) == false )
     {
@@ -658,11 +1055,16 @@ int vtkCacheManager::ClearCache()
 //----------------------------------------------------------------------------
 float vtkCacheManager::GetCurrentCacheSize ()
 {
-  if ( this->RemoteCacheDirectory.c_str() == nullptr )
+  if ( this->RemoteCacheDirectory.empty() )
     {
     return (0.0);
     }
-  float size = this->ComputeCacheSize ( this->RemoteCacheDirectory.c_str(), 0 );
+  //--- sum of the sizes in the index, instead of traversing the cache directory.
+  float size = 0.0;
+    {
+    std::lock_guard<std::mutex> lock(this->Internal->Mutex);
+    size = static_cast<float>( this->Internal->IndexSize / MB );
+    }
   this->SetCurrentCacheSize ( size );
   return ( this->CurrentCacheSize );
 
@@ -830,8 +1232,13 @@ float vtkCacheManager::ComputeCacheSize( const char *dirName, unsigned long sz )
 void vtkCacheManager::CacheSizeCheck()
 {
 
+  //--- Make room for new downloads
+  if ( this->EnableLeastRecentlyUsedRemoval )
+    {
+    this->RemoveLeastRecentlyUsedFiles();
+    }
   //--- Compute size of the current cache
-  this->ComputeCacheSize(this->RemoteCacheDirectory.c_str(), 0);
+  this->GetCurrentCacheSize();
   //--- Invoke an event if cache size is exceeded.
   if ( this->CurrentCacheSize > (float) (this->RemoteCacheLimit) )
     {
@@ -844,7 +1251,7 @@ void vtkCacheManager::CacheSizeCheck()
 float vtkCacheManager::GetFreeCacheSpaceRemaining()
 {
 
-  float cachesize = this->ComputeCacheSize(this->RemoteCacheDirectory.c_str(), 0);
+  float cachesize = this->GetCurrentCacheSize();
   // cache limit - current cache size = total space left in cache.
   // total space in cache - free buffer size = amount that can be used.
   float diff = ( float (this->RemoteCacheLimit) - cachesize );
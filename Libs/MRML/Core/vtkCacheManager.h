@@ -42,8 +42,41 @@ class VTK_MRML_EXPORT vtkCacheManager : public vtkObject
   const char *GetRemoteCacheDirectory ();
 
   ///
-  /// Called when a file is loaded or removed from the cache.
+  /// Rescans the cache directory: refreshes the list of cached files
+  /// and adds files not yet known to the cache index (and removes
+  /// the index entries of files that are not on disk anymore).
+  /// Downloads are recorded in the index by AddToCacheIndex, therefore
+  /// this method does not need be called after each download.
   void UpdateCacheInformation ( );
+
+  ///
+  /// Records a file downloaded from \a uri into the cache in the cache index:
+  /// its size, the time of the access, and the validators (ETag and Last-Modified
+  /// HTTP response headers) that allow checking if the remote file has changed.
+  /// The index is saved in the cache directory, so that the content of the cache
+  /// is known without scanning the directory.
+  /// Does not invoke Modified, therefore it can be called from the networking thread.
+  void AddToCacheIndex ( const char *uri, const char *filename,
+                         const char *eTag=nullptr, const char *lastModified=nullptr );
+  ///
+  /// Updates the last access time of a cached file that is loaded
+  /// without being downloaded again. The least recently accessed
+  /// files are removed first when the cache is full.
+  void MarkCachedFileAccessed ( const char *filename );
+  ///
+  /// Returns the validators recorded for the cached copy of \a uri,
+  /// empty if the uri is not in the cache index.
+  std::string GetCachedFileETag ( const char *uri );
+  std::string GetCachedFileLastModified ( const char *uri );
+  ///
+  /// Removes the least recently accessed files from the cache until the
+  /// size of the cache leaves the free buffer below RemoteCacheLimit.
+  /// Files that are referenced by storage nodes of the scene are kept.
+  /// Returns the number of removed files.
+  int RemoveLeastRecentlyUsedFiles ( );
+  ///
+  /// Name of the cache index file in the remote cache directory.
+  static const char* GetCacheIndexFileName ( );
   ///
   /// Removes a target from the list of locally cached files and directories
   void DeleteFromCachedFileList ( const char * target );
@@ -124,6 +157,12 @@ class VTK_MRML_EXPORT vtkCacheManager : public vtkObject
   vtkSetMacro ( RemoteCacheFreeBufferSize, int );
   vtkGetMacro ( EnableForceRedownload, int );
   vtkSetMacro ( EnableForceRedownload, int );
+  ///
+  /// If enabled (default), CacheSizeCheck removes the least recently
+  /// used files when the cache is full (\sa RemoveLeastRecentlyUsedFiles).
+  vtkGetMacro ( EnableLeastRecentlyUsedRemoval, int );
+  vtkSetMacro ( EnableLeastRecentlyUsedRemoval, int );
+  vtkBooleanMacro ( EnableLeastRecentlyUsedRemoval, int );
   //vtkGetMacro ( EnableRemoteCacheOverwriting, int );
   //vtkSetMacro ( EnableRemoteCacheOverwriting, int );
   void SetMRMLScene ( vtkMRMLScene *scene )
@@ -160,6 +199,7 @@ class VTK_MRML_EXPORT vtkCacheManager : public vtkObject
   float CurrentCacheSize;
   int RemoteCacheFreeBufferSize;
   int EnableForceRedownload;
+  int EnableLeastRecentlyUsedRemoval;
   //int EnableRemoteCacheOverwriting;
   vtkMRMLScene *MRMLScene;
 
@@ -172,6 +212,16 @@ class VTK_MRML_EXPORT vtkCacheManager : public vtkObject
   /// with every download, remove from cache, and clearcache call.
   std::vector< std::string > CachedFileList;
 
+  /// Cache index, protected by a mutex (downloads are recorded from the networking thread)
+  class vtkInternal;
+  vtkInternal* Internal;
+  /// Read the index from the cache directory, returns false if there is no index file
+  bool ReadCacheIndex();
+  /// Save the index to the cache directory. The mutex must be locked.
+  void WriteCacheIndex();
+  /// Add the files under dirname that are not in the index. The mutex must be locked.
+  void AddDirectoryToCacheIndex(const std::string& dirname);
+
  protected:
   vtkCacheManager();
   ~vtkCacheManager() override;
@@ -9,15 +9,125 @@
 // VTK includes
 #include <vtkCallbackCommand.h>
 #include <vtkCollection.h>
+#include <vtkNew.h>
 #include <vtkObjectFactory.h>
+#include <vtkSmartPointer.h>
+#include <vtkTimeStamp.h>
+#include <vtkWeakPointer.h>
 
 // STD includes
+#include <condition_variable>
+#include <deque>
+#include <list>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 vtkStandardNewMacro ( vtkDataIOManager );
 vtkCxxSetObjectMacro(vtkDataIOManager, CacheManager, vtkCacheManager);
 vtkCxxSetObjectMacro(vtkDataIOManager, DataTransferCollection, vtkCollection);
 vtkCxxSetObjectMacro(vtkDataIOManager, FileFormatHelper, vtkDataFileFormatHelper);
 
+//----------------------------------------------------------------------------
+class vtkDataIOManager::vtkInternal
+{
+public:
+  struct BackgroundWrite
+  {
+    vtkSmartPointer<vtkDataTransfer> Transfer;
+    vtkWeakPointer<vtkMRMLNode> Node;
+    vtkWeakPointer<vtkMRMLStorageNode> StorageNode;
+    /// Storage node and node content used by the worker thread
+    vtkSmartPointer<vtkMRMLStorageNode> Writer;
+    vtkSmartPointer<vtkMRMLNode> Snapshot;
+    vtkTimeStamp SnapshotTime;
+    /// vtkDataTransfer status, only accessed with Mutex locked
+    int Status;
+    int Result;
+  };
+
+  void StartWorkers(int numberOfThreads);
+  void JoinWorkers();
+  void Work();
+
+  std::mutex Mutex;
+  std::condition_variable WriteCompleted;
+  /// Background writes that are not processed yet, in queuing order
+  std::list<BackgroundWrite> Writes;
+  /// Background writes that are not started yet
+  std::deque<BackgroundWrite*> Queue;
+  std::vector<std::thread> Workers;
+  int NumberOfActiveWorkers = 0;
+};
+
+//----------------------------------------------------------------------------
+void vtkDataIOManager::vtkInternal::StartWorkers(int numberOfThreads)
+{
+  std::unique_lock<std::mutex> lock(this->Mutex);
+  if (this->NumberOfActiveWorkers == 0 && !this->Workers.empty())
+    {
+    // all workers returned or are about to return
+    lock.unlock();
+    this->JoinWorkers();
+    lock.lock();
+    }
+  while (this->NumberOfActiveWorkers < numberOfThreads
+    && this->NumberOfActiveWorkers < static_cast<int>(this->Queue.size()))
+    {
+    ++this->NumberOfActiveWorkers;
+    this->Workers.push_back(std::thread(&vtkDataIOManager::vtkInternal::Work, this));
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkDataIOManager::vtkInternal::JoinWorkers()
+{
+  for (std::vector<std::thread>::iterator workerIt = this->Workers.begin(); workerIt != this->Workers.end(); ++workerIt)
+    {
+    workerIt->join();
+    }
+  this->Workers.clear();
+}
+
+//----------------------------------------------------------------------------
+void vtkDataIOManager::vtkInternal::Work()
+{
+  while (true)
+    {
+    BackgroundWrite* write = nullptr;
+      {
+      std::lock_guard<std::mutex> lock(this->Mutex);
+      if (this->Queue.empty())
+        {
+        --this->NumberOfActiveWorkers;
+        return;
+        }
+      write = this->Queue.front();
+      this->Queue.pop_front();
+      write->Status = vtkDataTransfer::Running;
+      }
+
+    // The writer and the snapshot are not in the scene and not accessed
+    // by the main thread until the status is updated.
+    int result = 0;
+    try
+      {
+      result = write->Writer->WriteData(write->Snapshot);
+      }
+    catch (...)
+      {
+      result = 0;
+      }
+
+      {
+      std::lock_guard<std::mutex> lock(this->Mutex);
+      write->Result = result;
+      write->Status = (result ? vtkDataTransfer::Completed : vtkDataTransfer::CompletedWithErrors);
+      }
+    this->WriteCompleted.notify_all();
+    }
+}
+
 
 //----------------------------------------------------------------------------
 vtkDataIOManager::vtkDataIOManager()
@@ -33,11 +143,19 @@ vtkDataIOManager::vtkDataIOManager()
   this->InUpdateCallbackFlag = 0;
 
   this->FileFormatHelper = nullptr;
+
+  this->NumberOfWriteThreads = 2;
+  this->Internal = new vtkInternal;
 }
 
 //----------------------------------------------------------------------------
 vtkDataIOManager::~vtkDataIOManager()
 {
+  // files must be complete, but nodes may already be deleted:
+  // do not process the writes
+  this->Internal->JoinWorkers();
+  delete this->Internal;
+  this->Internal = nullptr;
 
   if ( this->TransferUpdateCommand )
     {
@@ -100,6 +218,7 @@ void vtkDataIOManager::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "DataTransferCollection: " << this->GetDataTransferCollection() << "\n";
   os << indent << "CacheManager: " << this->GetCacheManager() << "\n";
   os << indent << "EnableAsynchronousIO: " << this->GetEnableAsynchronousIO() << "\n";
+  os << indent << "NumberOfWriteThreads: " << this->GetNumberOfWriteThreads() << "\n";
 
 }
 
@@ -314,6 +433,137 @@ void vtkDataIOManager::SetEnableAsynchronousIO ( int val )
 }
 
 
+//----------------------------------------------------------------------------
+vtkDataTransfer* vtkDataIOManager::WriteDataInBackground(vtkMRMLStorableNode* node, vtkMRMLStorageNode* storageNode)
+{
+  if (node == nullptr || storageNode == nullptr)
+    {
+    vtkErrorMacro("WriteDataInBackground: invalid node or storage node");
+    return nullptr;
+    }
+  vtkSmartPointer<vtkMRMLNode> snapshot = vtkSmartPointer<vtkMRMLNode>::Take(
+    storageNode->CreateWriteDataSnapshot(node));
+  if (snapshot == nullptr)
+    {
+    return nullptr;
+    }
+  vtkSmartPointer<vtkMRMLStorageNode> writer = vtkSmartPointer<vtkMRMLStorageNode>::Take(
+    storageNode->CreateBackgroundWriteStorageNode());
+  if (writer == nullptr)
+    {
+    return nullptr;
+    }
+
+  vtkNew<vtkDataTransfer> transfer;
+  transfer->SetTransferID ( this->GetUniqueTransferID() );
+  transfer->SetTransferNodeID ( node->GetID() );
+  transfer->SetDestinationURI ( writer->GetFileName() );
+  transfer->SetTransferType ( vtkDataTransfer::LocalSave );
+  transfer->SetTransferStatus ( vtkDataTransfer::Pending );
+  transfer->SetProgress ( 0 );
+  transfer->SetCancelRequested ( 0 );
+
+  vtkInternal::BackgroundWrite write;
+  write.Transfer = transfer.GetPointer();
+  write.Node = node;
+  write.StorageNode = storageNode;
+  write.Writer = writer;
+  write.Snapshot = snapshot;
+  // changes of the node after this point are not written
+  write.SnapshotTime.Modified();
+  write.Status = vtkDataTransfer::Pending;
+  write.Result = 0;
+  storageNode->SetWriteStateScheduled();
+    {
+    std::lock_guard<std::mutex> lock(this->Internal->Mutex);
+    this->Internal->Writes.push_back(write);
+    this->Internal->Queue.push_back(&this->Internal->Writes.back());
+    }
+  this->Internal->StartWorkers(this->NumberOfWriteThreads);
+
+  this->AddNewDataTransfer ( transfer.GetPointer(), node );
+  return transfer.GetPointer();
+}
+
+//----------------------------------------------------------------------------
+int vtkDataIOManager::ProcessBackgroundWrites()
+{
+  std::vector<vtkInternal::BackgroundWrite> completedWrites;
+  std::vector<std::pair<vtkDataTransfer*, int> > statuses;
+    {
+    std::lock_guard<std::mutex> lock(this->Internal->Mutex);
+    std::list<vtkInternal::BackgroundWrite>::iterator writeIt = this->Internal->Writes.begin();
+    while (writeIt != this->Internal->Writes.end())
+      {
+      if (writeIt->Status == vtkDataTransfer::Completed
+        || writeIt->Status == vtkDataTransfer::CompletedWithErrors)
+        {
+        completedWrites.push_back(*writeIt);
+        writeIt = this->Internal->Writes.erase(writeIt);
+        }
+      else
+        {
+        statuses.emplace_back(writeIt->Transfer.GetPointer(), writeIt->Status);
+        ++writeIt;
+        }
+      }
+    }
+
+  // transfer and node events are invoked without the lock
+  for (std::vector<std::pair<vtkDataTransfer*, int> >::iterator statusIt = statuses.begin();
+    statusIt != statuses.end(); ++statusIt)
+    {
+    this->SetTransferStatus(statusIt->first, statusIt->second);
+    }
+  for (std::vector<vtkInternal::BackgroundWrite>::iterator writeIt = completedWrites.begin();
+    writeIt != completedWrites.end(); ++writeIt)
+    {
+    if (writeIt->StorageNode)
+      {
+      writeIt->StorageNode->FinishBackgroundWrite(writeIt->Node, writeIt->Writer,
+        writeIt->Result, writeIt->SnapshotTime);
+      }
+    writeIt->Transfer->SetProgress(100);
+    this->SetTransferStatus(writeIt->Transfer, writeIt->Status);
+    }
+  return static_cast<int>(completedWrites.size());
+}
+
+//----------------------------------------------------------------------------
+void vtkDataIOManager::WaitForBackgroundWrites()
+{
+    {
+    std::unique_lock<std::mutex> lock(this->Internal->Mutex);
+    while (true)
+      {
+      bool allCompleted = true;
+      for (std::list<vtkInternal::BackgroundWrite>::iterator writeIt = this->Internal->Writes.begin();
+        writeIt != this->Internal->Writes.end(); ++writeIt)
+        {
+        if (writeIt->Status != vtkDataTransfer::Completed
+          && writeIt->Status != vtkDataTransfer::CompletedWithErrors)
+          {
+          allCompleted = false;
+          break;
+          }
+        }
+      if (allCompleted)
+        {
+        break;
+        }
+      this->Internal->WriteCompleted.wait(lock);
+      }
+    }
+  this->ProcessBackgroundWrites();
+}
+
+//----------------------------------------------------------------------------
+int vtkDataIOManager::GetNumberOfPendingBackgroundWrites()
+{
+  std::lock_guard<std::mutex> lock(this->Internal->Mutex);
+  return static_cast<int>(this->Internal->Writes.size());
+}
+
 //----------------------------------------------------------------------------
 void vtkDataIOManager::QueueRead ( vtkMRMLNode *node )
 {
@@ -376,8 +626,12 @@ void vtkDataIOManager::QueueRead ( vtkMRMLNode *node )
     //--- check to see if RemoteCacheLimit is exceeded
     //--- check to see if FreeBufferSize is exceeded.
 
-    //--- if force redownload is enabled, remove the old file from cache.
-    if (cm->GetEnableForceRedownload () )
+    //--- if force redownload is enabled, remove the old file from cache,
+    //--- unless it can be validated by the server (then it is only
+    //--- downloaded again if the remote file has changed).
+    if (cm->GetEnableForceRedownload () &&
+        cm->GetCachedFileETag(source).empty() &&
+        cm->GetCachedFileLastModified(source).empty())
       {
       vtkDebugMacro("QueueRead: Calling remove from cache");
       this->GetCacheManager()->DeleteFromCache ( dest );
@@ -396,6 +650,11 @@ void vtkDataIOManager::QueueRead ( vtkMRMLNode *node )
     //--- a large scene that consists of multiple datasets.
     //--- ***The risk with this implementation  is that they may
     //--- forget to adjust the cache size, but aren't notified again...
+    //--- Least recently used files are removed first to make room.
+    if ( cm->GetEnableLeastRecentlyUsedRemoval() )
+      {
+      cm->RemoveLeastRecentlyUsedFiles();
+      }
     float bufsize = (cm->GetRemoteCacheLimit() * 1000000.0) -  (cm->GetRemoteCacheFreeBufferSize() * 1000000.0);
     if ( (cm->GetCurrentCacheSize()*1000000.0) >= bufsize )
       {
@@ -424,8 +683,8 @@ void vtkDataIOManager::QueueRead ( vtkMRMLNode *node )
       //--- trigger logic to download, if there's cache space.
       //--- and signal this remote read event to Logic and GUI.
       vtkDebugMacro("QueueRead: invoking a remote read event on the data io manager");
+      //--- (the cache index is updated when the download is completed)
       this->InvokeEvent ( vtkDataIOManager::RemoteReadEvent, node);
-      cm->UpdateCacheInformation();
       }
     }
   else
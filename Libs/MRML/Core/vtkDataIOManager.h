@@ -7,6 +7,8 @@ class vtkCacheManager;
 class vtkDataFileFormatHelper;
 class vtkDataTransfer;
 class vtkMRMLNode;
+class vtkMRMLStorableNode;
+class vtkMRMLStorageNode;
 
 // VTK includes
 #include <vtkObject.h>
@@ -76,6 +78,37 @@ class VTK_MRML_EXPORT vtkDataIOManager : public vtkObject
   /// so that logic can take care of scheduling and applying it
   void QueueWrite ( vtkMRMLNode *node );
 
+  ///
+  /// Write \a node with \a storageNode on a worker thread.
+  /// A snapshot of the node content is taken before returning (see
+  /// vtkMRMLStorageNode::CreateWriteDataSnapshot()), therefore the node can be
+  /// modified while it is written. The returned LocalSave data transfer is
+  /// added to the collection and reports the status of the write.
+  /// ProcessBackgroundWrites() must then be called on the main thread, for
+  /// example from a timer, to update the transfer and the storage node.
+  /// Returns nullptr if the storage node cannot write \a node in the
+  /// background, in which case vtkMRMLStorageNode::WriteData() should be used.
+  vtkDataTransfer* WriteDataInBackground(vtkMRMLStorableNode* node, vtkMRMLStorageNode* storageNode);
+
+  ///
+  /// Update the data transfers of the background writes and, for the completed
+  /// ones, their storage node (see vtkMRMLStorageNode::FinishBackgroundWrite()).
+  /// Must be called on the main thread. Returns the number of completed writes.
+  int ProcessBackgroundWrites();
+
+  ///
+  /// Block until all background writes are completed, then process them.
+  void WaitForBackgroundWrites();
+
+  ///
+  /// Number of background writes that are not processed yet.
+  int GetNumberOfPendingBackgroundWrites();
+
+  ///
+  /// Maximum number of threads writing data in the background. Default is 2.
+  vtkSetClampMacro(NumberOfWriteThreads, int, 1, 64);
+  vtkGetMacro(NumberOfWriteThreads, int);
+
   ///
   /// Set the status of a data transfer (Idle, Scheduled, Cancelled Running,
   /// Completed).  The "modify" parameter indicates whether the object
@@ -112,9 +145,13 @@ class VTK_MRML_EXPORT vtkDataIOManager : public vtkObject
   vtkCollection *DataTransferCollection;
   vtkCacheManager *CacheManager;
   int EnableAsynchronousIO;
+  int NumberOfWriteThreads;
 
   vtkDataFileFormatHelper* FileFormatHelper;
 
+  class vtkInternal;
+  vtkInternal* Internal;
+
  protected:
   vtkDataIOManager();
   ~vtkDataIOManager() override;
@@ -19,6 +19,8 @@ vtkDataTransfer::vtkDataTransfer()
   this->TransferID = -1;
   this->TransferType = vtkDataTransfer::Unspecified;
   this->TransferNodeID = nullptr;
+  this->ETag = nullptr;
+  this->LastModified = nullptr;
   this->Progress = 0;
   this->CancelRequested = 0;
   this->TransferCached = 0;
@@ -40,6 +42,8 @@ vtkDataTransfer::~vtkDataTransfer()
   this->TransferID = -1;
   this->TransferType = vtkDataTransfer::Unspecified;
   this->TransferNodeID = nullptr;
+  this->SetETag ( nullptr );
+  this->SetLastModified ( nullptr );
   this->Progress = 0;
   this->CancelRequested = 0;
   this->TransferCached = 0;
@@ -47,6 +51,27 @@ vtkDataTransfer::~vtkDataTransfer()
 }
 
 
+//----------------------------------------------------------------------------
+void vtkDataTransfer::SetValidatorsNoModify ( const char *eTag, const char *lastModified )
+{
+  //--- same as vtkSetStringMacro, without Modified
+  delete [] this->ETag;
+  this->ETag = nullptr;
+  if ( eTag != nullptr )
+    {
+    this->ETag = new char[strlen(eTag) + 1];
+    strcpy ( this->ETag, eTag );
+    }
+  delete [] this->LastModified;
+  this->LastModified = nullptr;
+  if ( lastModified != nullptr )
+    {
+    this->LastModified = new char[strlen(lastModified) + 1];
+    strcpy ( this->LastModified, lastModified );
+    }
+}
+
+
 //----------------------------------------------------------------------------
 void vtkDataTransfer::PrintSelf(ostream& os, vtkIndent indent)
 {
@@ -62,6 +87,10 @@ void vtkDataTransfer::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "TransferID: " << this->GetTransferID() << "\n";
   os << indent << "TransferType: " << this->GetTransferType() << "\n";
   os << indent << "TransferNodeID: " << this->GetTransferNodeID() << "\n";
+  os << indent << "ETag: " <<
+    ( this->ETag ? this->ETag : "(none)") << "\n";
+  os << indent << "LastModified: " <<
+    ( this->LastModified ? this->LastModified : "(none)") << "\n";
   os << indent << "Progress: " << this->GetProgress() << "\n";
   os << indent << "SizeOnDisk: " << this->GetSizeOnDisk() << "\n";
 }
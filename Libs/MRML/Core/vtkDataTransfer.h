@@ -41,11 +41,32 @@ class VTK_MRML_EXPORT vtkDataTransfer : public vtkObject
   vtkGetMacro (TransferCached, int );
   vtkSetMacro (TransferCached, int );
 
+  ///
+  /// Validators of the cached copy of the source (ETag and Last-Modified
+  /// HTTP response headers). If they are set when the transfer starts, the handler
+  /// checks if the remote file has changed before downloading it again,
+  /// and replaces them by the validators of the downloaded file.
+  vtkGetStringMacro ( ETag );
+  vtkSetStringMacro ( ETag );
+  vtkGetStringMacro ( LastModified );
+  vtkSetStringMacro ( LastModified );
+
   void SetTransferStatusNoModify ( int val)
       {
       this->TransferStatus = val;
       }
 
+  /// Set the progress (in percent) without invoking Modified, for use
+  /// by URI handlers that run in a networking thread.
+  void SetProgressNoModify ( int val)
+      {
+      this->Progress = val;
+      }
+
+  /// Set the validators without invoking Modified, for use
+  /// by URI handlers that run in a networking thread.
+  void SetValidatorsNoModify ( const char *eTag, const char *lastModified );
+
   const char* GetTransferStatusString( ) {
     switch (this->TransferStatus)
       {
@@ -118,6 +139,8 @@ class VTK_MRML_EXPORT vtkDataTransfer : public vtkObject
   int TransferCached;
   int SizeOnDisk;
   char* TransferNodeID;
+  char* ETag;
+  char* LastModified;
   int Progress;
   int CancelRequested;
 
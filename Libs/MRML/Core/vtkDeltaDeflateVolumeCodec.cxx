@@ -0,0 +1,280 @@
+/*==============================================================================
+
+Copyright (c) Laboratory for Percutaneous Surgery (PerkLab)
+Queen's University, Kingston, ON, Canada. All Rights Reserved.
+
+See COPYRIGHT.txt
+or http://www.slicer.org/copyright/copyright.txt for details.
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+==============================================================================*/
+
+// MRML includes
+#include "vtkDeltaDeflateVolumeCodec.h"
+
+// vtkAddon includes
+#include <vtkStreamingVolumeFrame.h>
+
+// VTK includes
+#include <vtkImageData.h>
+#include <vtkNew.h>
+#include <vtkObjectFactory.h>
+#include <vtkPointData.h>
+#include <vtkUnsignedCharArray.h>
+#include <vtk_zlib.h>
+
+// STD includes
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+
+//----------------------------------------------------------------------------
+vtkStandardNewMacro(vtkDeltaDeflateVolumeCodec);
+
+//----------------------------------------------------------------------------
+vtkDeltaDeflateVolumeCodec::vtkDeltaDeflateVolumeCodec()
+{
+  this->AvailableParameterNames.push_back(vtkDeltaDeflateVolumeCodec::GetKeyFrameIntervalParameter());
+  this->ParameterDescriptions[vtkDeltaDeflateVolumeCodec::GetKeyFrameIntervalParameter()] =
+    "Number of frames between key frames. Larger value results in smaller size but slower seeking.";
+  this->AvailableParameterNames.push_back(vtkDeltaDeflateVolumeCodec::GetCompressionLevelParameter());
+  this->ParameterDescriptions[vtkDeltaDeflateVolumeCodec::GetCompressionLevelParameter()] =
+    "Zlib compression level from 1 (fastest) to 9 (smallest).";
+}
+
+//----------------------------------------------------------------------------
+vtkDeltaDeflateVolumeCodec::~vtkDeltaDeflateVolumeCodec() = default;
+
+//----------------------------------------------------------------------------
+vtkStreamingVolumeCodec* vtkDeltaDeflateVolumeCodec::CreateCodecInstance()
+{
+  return vtkDeltaDeflateVolumeCodec::New();
+}
+
+//----------------------------------------------------------------------------
+void vtkDeltaDeflateVolumeCodec::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "KeyFrameInterval: " << this->KeyFrameInterval << "\n";
+  os << indent << "CompressionLevel: " << this->CompressionLevel << "\n";
+}
+
+//----------------------------------------------------------------------------
+bool vtkDeltaDeflateVolumeCodec::SetParameterInternal(std::string parameterName, std::string parameterValue)
+{
+  std::stringstream ss(parameterValue);
+  int value = 0;
+  if (!(ss >> value))
+    {
+    return false;
+    }
+  if (parameterName == vtkDeltaDeflateVolumeCodec::GetKeyFrameIntervalParameter())
+    {
+    this->KeyFrameInterval = std::max(1, value);
+    return true;
+    }
+  if (parameterName == vtkDeltaDeflateVolumeCodec::GetCompressionLevelParameter())
+    {
+    this->CompressionLevel = std::min(std::max(1, value), 9);
+    return true;
+    }
+  return false;
+}
+
+//----------------------------------------------------------------------------
+bool vtkDeltaDeflateVolumeCodec::GetParameterInternal(std::string parameterName, std::string& parameterValue)
+{
+  std::stringstream ss;
+  if (parameterName == vtkDeltaDeflateVolumeCodec::GetKeyFrameIntervalParameter())
+    {
+    ss << this->KeyFrameInterval;
+    }
+  else if (parameterName == vtkDeltaDeflateVolumeCodec::GetCompressionLevelParameter())
+    {
+    ss << this->CompressionLevel;
+    }
+  else
+    {
+    return false;
+    }
+  parameterValue = ss.str();
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkDeltaDeflateVolumeCodec::EncodeImageDataInternal(vtkImageData* inputImageData, vtkStreamingVolumeFrame* outputFrame, bool forceKeyFrame)
+{
+  if (!inputImageData || !inputImageData->GetPointData() || !inputImageData->GetPointData()->GetScalars() || !outputFrame)
+    {
+    vtkErrorMacro("EncodeImageDataInternal: invalid input image or output frame");
+    return false;
+    }
+
+  int dimensions[3] = { 0, 0, 0 };
+  inputImageData->GetDimensions(dimensions);
+  size_t imageSize = static_cast<size_t>(dimensions[0]) * dimensions[1] * dimensions[2]
+    * inputImageData->GetNumberOfScalarComponents() * inputImageData->GetScalarSize();
+  const unsigned char* imagePointer = static_cast<const unsigned char*>(inputImageData->GetScalarPointer());
+
+  bool keyFrame = forceKeyFrame
+    || !this->LastEncodedFrame
+    || this->EncoderReferenceImage.size() != imageSize
+    || this->NumberOfFramesSinceKeyFrame + 1 >= this->KeyFrameInterval;
+  if (!keyFrame)
+    {
+    int lastDimensions[3] = { 0, 0, 0 };
+    this->LastEncodedFrame->GetDimensions(lastDimensions);
+    keyFrame = !std::equal(dimensions, dimensions + 3, lastDimensions)
+      || this->LastEncodedFrame->GetVTKScalarType() != inputImageData->GetScalarType()
+      || this->LastEncodedFrame->GetNumberOfComponents() != inputImageData->GetNumberOfScalarComponents();
+    }
+
+  // Delta frames store the bitwise difference, which is zero where the image has not changed.
+  // The reference image is updated to the current image at the same time.
+  std::vector<unsigned char> frameVoxels(imagePointer, imagePointer + imageSize);
+  if (keyFrame)
+    {
+    this->EncoderReferenceImage = frameVoxels;
+    }
+  else
+    {
+    for (size_t i = 0; i < imageSize; ++i)
+      {
+      frameVoxels[i] ^= this->EncoderReferenceImage[i];
+      this->EncoderReferenceImage[i] = imagePointer[i];
+      }
+    }
+
+  uLongf compressedSize = compressBound(static_cast<uLong>(imageSize));
+  vtkNew<vtkUnsignedCharArray> frameData;
+  frameData->SetNumberOfValues(compressedSize);
+  if (compress2(frameData->GetPointer(0), &compressedSize, frameVoxels.data(),
+    static_cast<uLong>(imageSize), this->CompressionLevel) != Z_OK)
+    {
+    vtkErrorMacro("EncodeImageDataInternal: failed to compress frame");
+    this->LastEncodedFrame = nullptr;
+    return false;
+    }
+  frameData->Resize(compressedSize);
+  frameData->SetNumberOfValues(compressedSize);
+
+  outputFrame->SetFrameData(frameData);
+  outputFrame->SetDimensions(dimensions);
+  outputFrame->SetVTKScalarType(inputImageData->GetScalarType());
+  outputFrame->SetNumberOfComponents(inputImageData->GetNumberOfScalarComponents());
+  outputFrame->SetCodecFourCC(this->GetFourCC());
+  if (keyFrame)
+    {
+    outputFrame->SetFrameType(vtkStreamingVolumeFrame::IFrame);
+    outputFrame->SetPreviousFrame(nullptr);
+    this->NumberOfFramesSinceKeyFrame = 0;
+    }
+  else
+    {
+    outputFrame->SetFrameType(vtkStreamingVolumeFrame::PFrame);
+    outputFrame->SetPreviousFrame(this->LastEncodedFrame);
+    ++this->NumberOfFramesSinceKeyFrame;
+    }
+  this->LastEncodedFrame = outputFrame;
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkDeltaDeflateVolumeCodec::DecodeFrameInternal(vtkStreamingVolumeFrame* inputFrame, vtkImageData* outputImageData, bool saveDecodedImage/*=true*/)
+{
+  if (!inputFrame || !inputFrame->GetFrameData())
+    {
+    vtkErrorMacro("DecodeFrameInternal: invalid input frame");
+    return false;
+    }
+
+  if (inputFrame != this->LastDecodedFrame)
+    {
+    int dimensions[3] = { 0, 0, 0 };
+    inputFrame->GetDimensions(dimensions);
+    int scalarSize = 0;
+    switch (inputFrame->GetVTKScalarType())
+      {
+      vtkTemplateMacro(scalarSize = sizeof(VTK_TT));
+      default:
+        vtkErrorMacro("DecodeFrameInternal: unsupported scalar type " << inputFrame->GetVTKScalarType());
+        return false;
+      }
+    size_t imageSize = static_cast<size_t>(dimensions[0]) * dimensions[1] * dimensions[2]
+      * inputFrame->GetNumberOfComponents() * scalarSize;
+
+    if (!inputFrame->IsKeyFrame())
+      {
+      // Delta frame is added to the previous frame, which must be decoded first
+      vtkStreamingVolumeFrame* previousFrame = inputFrame->GetPreviousFrame();
+      if (!previousFrame)
+        {
+        vtkErrorMacro("DecodeFrameInternal: previous frame is not available for decoding a delta frame");
+        return false;
+        }
+      if (previousFrame != this->LastDecodedFrame && !this->DecodeFrameInternal(previousFrame, outputImageData, false))
+        {
+        return false;
+        }
+      if (this->DecoderReferenceImage.size() != imageSize)
+        {
+        vtkErrorMacro("DecodeFrameInternal: size of the previous frame does not match");
+        return false;
+        }
+      }
+
+    std::vector<unsigned char> frameVoxels(imageSize);
+    uLongf uncompressedSize = static_cast<uLongf>(imageSize);
+    vtkUnsignedCharArray* frameData = inputFrame->GetFrameData();
+    if (uncompress(frameVoxels.data(), &uncompressedSize, frameData->GetPointer(0),
+      static_cast<uLong>(frameData->GetNumberOfValues())) != Z_OK || uncompressedSize != imageSize)
+      {
+      vtkErrorMacro("DecodeFrameInternal: failed to uncompress frame");
+      this->LastDecodedFrame = nullptr;
+      return false;
+      }
+
+    if (inputFrame->IsKeyFrame())
+      {
+      this->DecoderReferenceImage.swap(frameVoxels);
+      }
+    else
+      {
+      for (size_t i = 0; i < imageSize; ++i)
+        {
+        this->DecoderReferenceImage[i] ^= frameVoxels[i];
+        }
+      }
+    this->LastDecodedFrame = inputFrame;
+    }
+
+  if (!saveDecodedImage)
+    {
+    return true;
+    }
+  if (!outputImageData)
+    {
+    vtkErrorMacro("DecodeFrameInternal: invalid output image");
+    return false;
+    }
+  int dimensions[3] = { 0, 0, 0 };
+  inputFrame->GetDimensions(dimensions);
+  int outputDimensions[3] = { 0, 0, 0 };
+  outputImageData->GetDimensions(outputDimensions);
+  if (!std::equal(dimensions, dimensions + 3, outputDimensions)
+    || !outputImageData->GetPointData()->GetScalars()
+    || outputImageData->GetScalarType() != inputFrame->GetVTKScalarType()
+    || outputImageData->GetNumberOfScalarComponents() != inputFrame->GetNumberOfComponents())
+    {
+    outputImageData->SetDimensions(dimensions);
+    outputImageData->AllocateScalars(inputFrame->GetVTKScalarType(), inputFrame->GetNumberOfComponents());
+    }
+  memcpy(outputImageData->GetScalarPointer(), this->DecoderReferenceImage.data(), this->DecoderReferenceImage.size());
+  outputImageData->Modified();
+  return true;
+}
@@ -0,0 +1,91 @@
+/*==============================================================================
+
+Copyright (c) Laboratory for Percutaneous Surgery (PerkLab)
+Queen's University, Kingston, ON, Canada. All Rights Reserved.
+
+See COPYRIGHT.txt
+or http://www.slicer.org/copyright/copyright.txt for details.
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+==============================================================================*/
+
+#ifndef __vtkDeltaDeflateVolumeCodec_h
+#define __vtkDeltaDeflateVolumeCodec_h
+
+// MRML includes
+#include "vtkMRML.h"
+
+// vtkAddon includes
+#include "vtkStreamingVolumeCodec.h"
+
+// VTK includes
+#include <vtkSmartPointer.h>
+
+// STD includes
+#include <vector>
+
+/// \brief Lossless codec for streaming volumes that is available without external libraries.
+///
+/// Key frames contain the voxels of the image compressed by zlib (deflate).
+/// Other frames contain the bitwise difference (XOR) from the previous frame,
+/// compressed by zlib. Regions of the image that do not change between frames
+/// (background, static overlays of ultrasound images) compress to almost nothing.
+/// Any scalar type and number of components is supported.
+///
+/// The codec is registered in vtkStreamingVolumeCodecFactory by vtkMRMLStreamingVolumeNode
+/// with the FourCC "ZDLT".
+///
+/// Parameters:
+/// - KeyFrameInterval: a key frame is written after this many frames (default: 30).
+/// - CompressionLevel: zlib compression level, 1 (fastest) to 9 (smallest) (default: 1).
+class VTK_MRML_EXPORT vtkDeltaDeflateVolumeCodec : public vtkStreamingVolumeCodec
+{
+public:
+  static vtkDeltaDeflateVolumeCodec *New();
+  vtkStreamingVolumeCodec* CreateCodecInstance() override;
+  vtkTypeMacro(vtkDeltaDeflateVolumeCodec, vtkStreamingVolumeCodec);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  /// Return the codec FourCC
+  std::string GetFourCC() override { return "ZDLT"; };
+
+  /// Parameter names
+  static std::string GetKeyFrameIntervalParameter() { return "KeyFrameInterval"; };
+  static std::string GetCompressionLevelParameter() { return "CompressionLevel"; };
+
+protected:
+  vtkDeltaDeflateVolumeCodec();
+  ~vtkDeltaDeflateVolumeCodec() override;
+
+  /// Decode a frame and store its contents in a vtkImageData
+  bool DecodeFrameInternal(vtkStreamingVolumeFrame* inputFrame, vtkImageData* outputImageData, bool saveDecodedImage = true) override;
+
+  /// Encode an image into a frame
+  bool EncodeImageDataInternal(vtkImageData* inputImageData, vtkStreamingVolumeFrame* outputFrame, bool forceKeyFrame) override;
+
+  bool SetParameterInternal(std::string parameterName, std::string parameterValue) override;
+  bool GetParameterInternal(std::string parameterName, std::string& parameterValue) override;
+
+  int KeyFrameInterval{30};
+  int CompressionLevel{1};
+
+  /// Voxels of the last encoded image, delta frames are computed from it
+  std::vector<unsigned char> EncoderReferenceImage;
+  vtkSmartPointer<vtkStreamingVolumeFrame> LastEncodedFrame;
+  int NumberOfFramesSinceKeyFrame{0};
+
+  /// Voxels of the last decoded frame, delta frames are added to it
+  std::vector<unsigned char> DecoderReferenceImage;
+  vtkSmartPointer<vtkStreamingVolumeFrame> LastDecodedFrame;
+
+private:
+  vtkDeltaDeflateVolumeCodec(const vtkDeltaDeflateVolumeCodec&) = delete;
+  void operator=(const vtkDeltaDeflateVolumeCodec&) = delete;
+};
+
+#endif
@@ -14,6 +14,7 @@
 
 // MRML includes
 #include "vtkEventBroker.h"
+#include "vtkMRMLTrace.h"
 #include "vtkObservation.h"
 
 // VTK includes
@@ -22,6 +23,10 @@
 #include <vtkObjectFactory.h>
 #include <vtkTimerLog.h>
 
+// STD includes
+#include <algorithm>
+#include <sstream>
+
 vtkCxxSetObjectMacro(vtkEventBroker, TimerLog, vtkTimerLog);
 
 //----------------------------------------------------------------------------
@@ -92,6 +97,7 @@ vtkEventBroker::vtkEventBroker()
 {
   this->EventMode = vtkEventBroker::Synchronous;
   this->EventLogging = 0;
+  this->EventProfiling = 0;
   this->EventNestingLevel = 0;
   this->TimerLog = vtkTimerLog::New();
   this->CompressCallData = 0;
@@ -571,6 +577,191 @@ int vtkEventBroker::GenerateGraphFile ( const char *graphFile )
   return 0;
 }
 
+//----------------------------------------------------------------------------
+void vtkEventBroker::ResetEventProfile()
+{
+  this->EventProfile.clear();
+  this->EventProfileStack.clear();
+  this->EventProfileInvokedObservations.clear();
+}
+
+//----------------------------------------------------------------------------
+void vtkEventBroker::ProfileInvocationStart(vtkObservation *observation, unsigned long eid)
+{
+  EventProfileFrame frame;
+  frame.Key.SubjectClass = (observation->GetSubject() ? observation->GetSubject()->GetClassName() : "(none)");
+  frame.Key.Event = eid;
+  frame.Key.ObserverClass = (observation->GetObserver() ? observation->GetObserver()->GetClassName() : "(script)");
+  frame.ChildrenTime = 0.0;
+
+  if (this->EventProfileStack.empty())
+    {
+    // new top-level invocation
+    this->EventProfileInvokedObservations.clear();
+    }
+  else
+    {
+    this->EventProfile[this->EventProfileStack.back().Key].Cascades[frame.Key]++;
+    }
+  EventProfileEntry& entry = this->EventProfile[frame.Key];
+  if (!this->EventProfileInvokedObservations.insert(std::make_pair(observation, eid)).second)
+    {
+    entry.RedundantCount++;
+    }
+  this->EventProfileStack.push_back(frame);
+}
+
+//----------------------------------------------------------------------------
+void vtkEventBroker::ProfileInvocationEnd(double elapsedTime)
+{
+  if (this->EventProfileStack.empty())
+    {
+    // profile has been reset during the invocation
+    return;
+    }
+  EventProfileFrame frame = this->EventProfileStack.back();
+  this->EventProfileStack.pop_back();
+  EventProfileEntry& entry = this->EventProfile[frame.Key];
+  entry.InvocationCount++;
+  entry.TotalTime += elapsedTime;
+  entry.SelfTime += std::max(elapsedTime - frame.ChildrenTime, 0.0);
+  if (!this->EventProfileStack.empty())
+    {
+    this->EventProfileStack.back().ChildrenTime += elapsedTime;
+    }
+}
+
+//----------------------------------------------------------------------------
+std::string vtkEventBroker::GetEventProfileKeyAsString(const EventProfileKey& key)
+{
+  std::stringstream ss;
+  ss << key.SubjectClass << " ";
+  if (key.Event > vtkCommand::UserEvent)
+    {
+    ss << "UserEvent+" << key.Event - vtkCommand::UserEvent;
+    }
+  else
+    {
+    ss << vtkCommand::GetStringFromEventId(key.Event);
+    }
+  ss << " -> " << key.ObserverClass;
+  return ss.str();
+}
+
+namespace
+{
+//----------------------------------------------------------------------------
+template<typename T>
+bool CompareProfileItems(const std::pair<T, std::string>& a, const std::pair<T, std::string>& b)
+{
+  return a.first > b.first;
+}
+}
+
+//----------------------------------------------------------------------------
+std::string vtkEventBroker::GetEventProfileReport(int maxNumberOfEntries)
+{
+  std::vector< std::pair<double, std::string> > byTotalTime;
+  std::vector< std::pair<int, std::string> > byRedundantCount;
+  std::vector< std::pair<int, std::string> > byCascadeCount;
+  for (std::map<EventProfileKey, EventProfileEntry>::iterator it = this->EventProfile.begin();
+    it != this->EventProfile.end(); ++it)
+    {
+    std::string keyString = GetEventProfileKeyAsString(it->first);
+    std::stringstream ss;
+    ss << keyString << ": " << it->second.InvocationCount << " invocations, "
+       << it->second.TotalTime * 1000.0 << " ms total, "
+       << it->second.SelfTime * 1000.0 << " ms self";
+    byTotalTime.push_back(std::make_pair(it->second.TotalTime, ss.str()));
+    if (it->second.RedundantCount > 0)
+      {
+      std::stringstream redundantSS;
+      redundantSS << keyString << ": " << it->second.RedundantCount << " redundant of "
+                  << it->second.InvocationCount << " invocations";
+      byRedundantCount.push_back(std::make_pair(it->second.RedundantCount, redundantSS.str()));
+      }
+    for (std::map<EventProfileKey, int>::iterator cascadeIt = it->second.Cascades.begin();
+      cascadeIt != it->second.Cascades.end(); ++cascadeIt)
+      {
+      std::stringstream cascadeSS;
+      cascadeSS << keyString << " => " << GetEventProfileKeyAsString(cascadeIt->first)
+                << ": " << cascadeIt->second << " invocations";
+      byCascadeCount.push_back(std::make_pair(cascadeIt->second, cascadeSS.str()));
+      }
+    }
+  std::stable_sort(byTotalTime.begin(), byTotalTime.end(), CompareProfileItems<double>);
+  std::stable_sort(byRedundantCount.begin(), byRedundantCount.end(), CompareProfileItems<int>);
+  std::stable_sort(byCascadeCount.begin(), byCascadeCount.end(), CompareProfileItems<int>);
+
+  size_t maxEntries = static_cast<size_t>(std::max(maxNumberOfEntries, 0));
+  std::stringstream report;
+  report << "Observations by total time:\n";
+  for (size_t i = 0; i < std::min(maxEntries, byTotalTime.size()); ++i)
+    {
+    report << "  " << byTotalTime[i].second << "\n";
+    }
+  report << "Redundant invocations (same observation and event within one top-level event):\n";
+  for (size_t i = 0; i < std::min(maxEntries, byRedundantCount.size()); ++i)
+    {
+    report << "  " << byRedundantCount[i].second << "\n";
+    }
+  report << "Cascades (invocations triggered by another invocation):\n";
+  for (size_t i = 0; i < std::min(maxEntries, byCascadeCount.size()); ++i)
+    {
+    report << "  " << byCascadeCount[i].second << "\n";
+    }
+  return report.str();
+}
+
+//----------------------------------------------------------------------------
+int vtkEventBroker::GetEventProfileInvocationCount(const char* subjectClass, unsigned long event, const char* observerClass)
+{
+  EventProfileKey key = { subjectClass ? subjectClass : "", event, observerClass ? observerClass : "" };
+  std::map<EventProfileKey, EventProfileEntry>::iterator it = this->EventProfile.find(key);
+  return (it != this->EventProfile.end() ? it->second.InvocationCount : 0);
+}
+
+//----------------------------------------------------------------------------
+int vtkEventBroker::GetEventProfileRedundantCount(const char* subjectClass, unsigned long event, const char* observerClass)
+{
+  EventProfileKey key = { subjectClass ? subjectClass : "", event, observerClass ? observerClass : "" };
+  std::map<EventProfileKey, EventProfileEntry>::iterator it = this->EventProfile.find(key);
+  return (it != this->EventProfile.end() ? it->second.RedundantCount : 0);
+}
+
+//----------------------------------------------------------------------------
+double vtkEventBroker::GetEventProfileTotalTime(const char* subjectClass, unsigned long event, const char* observerClass)
+{
+  EventProfileKey key = { subjectClass ? subjectClass : "", event, observerClass ? observerClass : "" };
+  std::map<EventProfileKey, EventProfileEntry>::iterator it = this->EventProfile.find(key);
+  return (it != this->EventProfile.end() ? it->second.TotalTime : 0.0);
+}
+
+//----------------------------------------------------------------------------
+double vtkEventBroker::GetEventProfileSelfTime(const char* subjectClass, unsigned long event, const char* observerClass)
+{
+  EventProfileKey key = { subjectClass ? subjectClass : "", event, observerClass ? observerClass : "" };
+  std::map<EventProfileKey, EventProfileEntry>::iterator it = this->EventProfile.find(key);
+  return (it != this->EventProfile.end() ? it->second.SelfTime : 0.0);
+}
+
+//----------------------------------------------------------------------------
+int vtkEventBroker::GetEventProfileCascadeCount(
+  const char* parentSubjectClass, unsigned long parentEvent, const char* parentObserverClass,
+  const char* subjectClass, unsigned long event, const char* observerClass)
+{
+  EventProfileKey parentKey = { parentSubjectClass ? parentSubjectClass : "", parentEvent,
+    parentObserverClass ? parentObserverClass : "" };
+  std::map<EventProfileKey, EventProfileEntry>::iterator it = this->EventProfile.find(parentKey);
+  if (it == this->EventProfile.end())
+    {
+    return 0;
+    }
+  EventProfileKey key = { subjectClass ? subjectClass : "", event, observerClass ? observerClass : "" };
+  std::map<EventProfileKey, int>::iterator cascadeIt = it->second.Cascades.find(key);
+  return (cascadeIt != it->second.Cascades.end() ? cascadeIt->second : 0);
+}
+
 //----------------------------------------------------------------------------
 void vtkEventBroker::OpenLogFile ()
 {
@@ -678,14 +869,20 @@ void vtkEventBroker::ProcessEvent ( vtkObservation *observation, vtkObject *call
   //   be a delete event that the event broker asked for)
   // - if the observer did ask to observe delete events, pass them through
   //   right away even in async mode - this way things can clean up
+  // - in coalesced mode, events with call data (e.g. the node of a
+  //   NodeAddedEvent) are passed through right away too: each of them must be
+  //   delivered, and the call data may not be valid anymore when the queue is
+  //   processed
   //
   if ( eid == observation->GetEvent() || observation->GetEvent() == vtkCommand::AnyEvent )
     {
-    if ( this->EventMode == vtkEventBroker::Synchronous || eid == vtkCommand::DeleteEvent )
+    if ( this->EventMode == vtkEventBroker::Synchronous || eid == vtkCommand::DeleteEvent ||
+         (this->EventMode == vtkEventBroker::Coalesced && callData != nullptr) )
       {
       this->InvokeObservation( observation, eid, callData );
       }
-    else if ( this->EventMode == vtkEventBroker::Asynchronous )
+    else if ( this->EventMode == vtkEventBroker::Asynchronous ||
+              this->EventMode == vtkEventBroker::Coalesced )
       {
       this->QueueObservation( observation, eid, callData );
       }
@@ -748,10 +945,13 @@ void vtkEventBroker::QueueObservation ( vtkObservation *observation,
   //    one unique entry for each
   // it it's not there, add the current call data to the list so that each unique combination
   // can be invoked.
+  // In Coalesced mode, only events without call data are queued (see ProcessEvent)
+  // and each event ID is kept once per observation, even for observations of AnyEvent.
   // If the event is not currently in the queue, add it and keep a flag.
   //
   vtkObservation::CallType call(eid, callData);
-  if ( this->GetCompressCallData() &&
+  if ( this->EventMode != vtkEventBroker::Coalesced &&
+       this->GetCompressCallData() &&
        observation->GetEvent() != vtkCommand::AnyEvent)
     {
     observation->GetCallDataList()->clear();
@@ -776,7 +976,24 @@ void vtkEventBroker::QueueObservation ( vtkObservation *observation,
 
   if ( !observation->GetInEventQueue() )
     {
-    this->EventQueue.push_back( observation );
+    if ( this->EventMode == vtkEventBroker::Coalesced )
+      {
+      // Keep the queue sorted by decreasing priority (first come first served
+      // for equal priorities). The front of the queue is never displaced as it
+      // may be the observation currently processed by ProcessEventQueue.
+      std::deque< vtkObservation *>::iterator queueIter = this->EventQueue.end();
+      while ( queueIter != this->EventQueue.begin() &&
+              queueIter - 1 != this->EventQueue.begin() &&
+              (*(queueIter - 1))->GetPriority() < observation->GetPriority() )
+        {
+        --queueIter;
+        }
+      this->EventQueue.insert( queueIter, observation );
+      }
+    else
+      {
+      this->EventQueue.push_back( observation );
+      }
     observation->SetInEventQueue(1);
     }
 }
@@ -814,6 +1031,15 @@ void vtkEventBroker::InvokeObservation ( vtkObservation *observation,
 
   double startTime = this->TimerLog->GetUniversalTime();
 
+  bool profiled = (this->EventProfiling != 0);
+  if (profiled)
+    {
+    this->ProfileInvocationStart(observation, eid);
+    }
+
+  vtkMRMLTraceScopeMacro("MRML", vtkCommand::GetStringFromEventId(eid),
+    observation->GetObserver() ? observation->GetObserver()->GetClassName() : nullptr);
+
   // Register so observation won't be deleted while callback is running
   observation->Register(this);
 
@@ -842,6 +1068,10 @@ void vtkEventBroker::InvokeObservation ( vtkObservation *observation,
   observation->SetTotalElapsedTime (observation->GetTotalElapsedTime() + elapsedTime);
   observation->SetLastElapsedTime (elapsedTime);
   this->LogEvent (observation);
+  if (profiled)
+    {
+    this->ProfileInvocationEnd(elapsedTime);
+    }
 
   // clear reference to observation (may cause delete)
   observation->Delete();
@@ -891,6 +1121,7 @@ void vtkEventBroker::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "NumberOfQueueObservations: " << this->GetNumberOfQueuedObservations() << "\n";
   os << indent << "EventMode: " << this->GetEventModeAsString() << "\n";
   os << indent << "EventLogging: " << this->EventLogging << "\n";
+  os << indent << "EventProfiling: " << this->EventProfiling << "\n";
   os << indent << "EventNestingLevel: " << this->EventNestingLevel << "\n";
   os << indent << "LogFileName: " <<
     (this->LogFileName ? this->LogFileName : "(none)") << "\n";
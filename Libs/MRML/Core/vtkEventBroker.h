@@ -28,6 +28,7 @@ class vtkTimerLog;
 #include <set>
 #include <map>
 #include <fstream>
+#include <string>
 
 class vtkCollection;
 class vtkCallbackCommand;
@@ -173,15 +174,60 @@ public:
   /// Write out the current list of observations in graphviz format (.dot)
   int GenerateGraphFile ( const char *graphFile );
 
+  /// Event Profiling
+  ///
+  /// When event profiling is on, the number of invocations and the time spent
+  /// in the callbacks are accumulated for each (subject class, event, observer class)
+  /// combination. Invocations that happen while another observation is being
+  /// invoked are recorded as cascades of the invoking combination.
+  /// Invocations of the same observation with the same event more than once
+  /// within one top-level event (e.g., Modified storms) are counted as redundant.
+  /// Profiling is off by default.
+  /// \sa GetEventProfileReport, ResetEventProfile
+  vtkBooleanMacro (EventProfiling, int);
+  vtkSetMacro (EventProfiling, int);
+  vtkGetMacro (EventProfiling, int);
+
+  ///
+  /// Remove all accumulated profiling information.
+  void ResetEventProfile();
+
+  ///
+  /// Accessors for the accumulated profile of a (subject class, event, observer class)
+  /// combination. Observer class name is "(script)" for scripted observations.
+  /// Times are in seconds. Self time does not include the time of cascaded invocations.
+  int GetEventProfileInvocationCount(const char* subjectClass, unsigned long event, const char* observerClass);
+  int GetEventProfileRedundantCount(const char* subjectClass, unsigned long event, const char* observerClass);
+  double GetEventProfileTotalTime(const char* subjectClass, unsigned long event, const char* observerClass);
+  double GetEventProfileSelfTime(const char* subjectClass, unsigned long event, const char* observerClass);
+  int GetEventProfileCascadeCount(const char* parentSubjectClass, unsigned long parentEvent, const char* parentObserverClass,
+    const char* subjectClass, unsigned long event, const char* observerClass);
+
+  ///
+  /// Human-readable list of the top offenders: combinations with the largest
+  /// total time, the largest number of redundant invocations, and the most
+  /// frequent cascades. At most maxNumberOfEntries are listed in each section.
+  std::string GetEventProfileReport(int maxNumberOfEntries = 20);
+
 
   /// Event Queue processing modes
   ///
   /// In synchronous mode, observations are invoked immediately when the
   /// event takes place.  In asynchronous mode, observations are added
   /// to the event queue for later invocation.
+  /// Coalesced mode is an asynchronous mode where an observation is
+  /// queued at most once per event ID (regardless of CompressCallData) and
+  /// the queue is kept sorted by decreasing observation priority, so that a
+  /// burst of identical events results in a single invocation per observer
+  /// when the queue is flushed. Only events without call data are coalesced:
+  /// events with call data (e.g. vtkMRMLScene::NodeAddedEvent and its node)
+  /// are processed synchronously.
+  /// DeleteEvent is always processed synchronously.
+  /// \sa ProcessEventQueue, vtkMRMLScene::SetCoalesceEventsDuringBatchProcess
   enum EventMode {
     Synchronous,
-    Asynchronous
+    Asynchronous,
+    Coalesced
   };
   vtkGetMacro(EventMode, int);
   void SetEventMode(int eventMode)
@@ -196,9 +242,11 @@ public:
 
   void SetEventModeToSynchronous() {this->SetEventMode(vtkEventBroker::Synchronous);};
   void SetEventModeToAsynchronous() {this->SetEventMode(vtkEventBroker::Asynchronous);};
+  void SetEventModeToCoalesced() {this->SetEventMode(vtkEventBroker::Coalesced);};
   const char * GetEventModeAsString() {
     if (this->EventMode == vtkEventBroker::Synchronous) return ("Synchronous");
     if (this->EventMode == vtkEventBroker::Asynchronous) return ("Asynchronous");
+    if (this->EventMode == vtkEventBroker::Coalesced) return ("Coalesced");
     return "Undefined";
   }
 
@@ -287,6 +335,52 @@ protected:
   int CompressCallData;
 
   std::ofstream LogFile;
+
+  /// Profiling of observation invocations
+  struct EventProfileKey
+    {
+    std::string SubjectClass;
+    unsigned long Event;
+    std::string ObserverClass;
+    bool operator<(const EventProfileKey& other) const
+      {
+      if (this->Event != other.Event)
+        {
+        return this->Event < other.Event;
+        }
+      if (this->SubjectClass != other.SubjectClass)
+        {
+        return this->SubjectClass < other.SubjectClass;
+        }
+      return this->ObserverClass < other.ObserverClass;
+      }
+    };
+  struct EventProfileEntry
+    {
+    int InvocationCount{0};
+    int RedundantCount{0};
+    double TotalTime{0.0};
+    double SelfTime{0.0};
+    /// Number of invocations of each combination triggered by this combination
+    std::map<EventProfileKey, int> Cascades;
+    };
+  struct EventProfileFrame
+    {
+    EventProfileKey Key;
+    double ChildrenTime;
+    };
+
+  void ProfileInvocationStart(vtkObservation *observation, unsigned long eid);
+  void ProfileInvocationEnd(double elapsedTime);
+  static std::string GetEventProfileKeyAsString(const EventProfileKey& key);
+
+  int EventProfiling;
+  std::map<EventProfileKey, EventProfileEntry> EventProfile;
+  /// Observations being invoked, from top-level to the current one
+  std::vector<EventProfileFrame> EventProfileStack;
+  /// Observations invoked since the start of the current top-level invocation
+  std::set< std::pair<vtkObservation*, unsigned long> > EventProfileInvokedObservations;
+
 private:
   /// DetachObservations is a fast (but dangerous) method to delete all the
   /// observations. It leaves the event broker in an inconsistent state:
@@ -41,6 +41,14 @@
 #include <vtkTestErrorObserver.h>
 #include <vtkURIHandler.h>
 
+// VTKsys includes
+#include <vtksys/SystemTools.hxx>
+
+// STD includes
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+
 namespace vtkMRMLCoreTestingUtilities
 {
 
@@ -591,6 +599,165 @@ int ExerciseSceneLoadingMethods(const char * sceneFilePath, vtkMRMLScene* inputS
   return EXIT_SUCCESS;
 }
 
+//---------------------------------------------------------------------------
+void PerformanceMeasurements::Report(const std::string& name, double value)
+{
+  std::cout << "<DartMeasurement name=\"" << name << "\" type=\"numeric/double\">"
+            << value << "</DartMeasurement>" << std::endl;
+  this->Measurements.emplace_back(name, value);
+}
+
+//---------------------------------------------------------------------------
+int PerformanceMeasurements::Write(const std::string& fileName) const
+{
+  std::ofstream file(fileName.c_str());
+  file << "{" << std::endl;
+  for (MeasurementsType::const_iterator it = this->Measurements.begin(); it != this->Measurements.end(); ++it)
+    {
+    file << "  \"" << it->first << "\": " << it->second
+         << (it + 1 != this->Measurements.end() ? "," : "") << std::endl;
+    }
+  file << "}" << std::endl;
+  file.close();
+  if (file.fail())
+    {
+    std::cerr << "Failed to write performance measurements into " << fileName << std::endl;
+    return EXIT_FAILURE;
+    }
+  return EXIT_SUCCESS;
+}
+
+//---------------------------------------------------------------------------
+int PerformanceMeasurements::Read(const std::string& fileName, std::map<std::string, double>& measurements)
+{
+  std::ifstream file(fileName.c_str());
+  if (!file.is_open())
+    {
+    std::cerr << "Failed to read performance measurements from " << fileName << std::endl;
+    return EXIT_FAILURE;
+    }
+  // file is written by Write(), with one "name": value pair per line
+  std::string line;
+  while (std::getline(file, line))
+    {
+    std::string::size_type nameStart = line.find('"');
+    if (nameStart == std::string::npos)
+      {
+      continue;
+      }
+    std::string::size_type nameEnd = line.find('"', nameStart + 1);
+    if (nameEnd == std::string::npos)
+      {
+      continue;
+      }
+    std::string::size_type valueStart = line.find(':', nameEnd);
+    if (valueStart == std::string::npos)
+      {
+      continue;
+      }
+    std::stringstream valueStream(line.substr(valueStart + 1));
+    double value = 0.0;
+    if (valueStream >> value)
+      {
+      measurements[line.substr(nameStart + 1, nameEnd - nameStart - 1)] = value;
+      }
+    }
+  return EXIT_SUCCESS;
+}
+
+//---------------------------------------------------------------------------
+int PerformanceMeasurements::CompareWithBaseline(const std::string& baselineFileName, double tolerance) const
+{
+  if (!vtksys::SystemTools::FileExists(baselineFileName, true))
+    {
+    std::cout << "Performance test: no baseline, comparison skipped (" << baselineFileName << " not found)."
+              << " Configure with Slicer_PERFORMANCE_TEST_GENERATE_BASELINES=ON and run the test"
+              << " on the reference machine to generate it." << std::endl;
+    return EXIT_SUCCESS;
+    }
+  std::map<std::string, double> baseline;
+  if (PerformanceMeasurements::Read(baselineFileName, baseline) != EXIT_SUCCESS)
+    {
+    return EXIT_FAILURE;
+    }
+  int numberOfRegressions = 0;
+  for (MeasurementsType::const_iterator it = this->Measurements.begin(); it != this->Measurements.end(); ++it)
+    {
+    std::map<std::string, double>::const_iterator baselineIt = baseline.find(it->first);
+    if (baselineIt == baseline.end())
+      {
+      continue;
+      }
+    if (it->second > baselineIt->second * (1.0 + tolerance))
+      {
+      std::cerr << "Performance regression: " << it->first << " = " << it->second
+                << " (baseline: " << baselineIt->second << ", tolerance: " << tolerance << ")" << std::endl;
+      ++numberOfRegressions;
+      }
+    }
+  if (numberOfRegressions > 0)
+    {
+    std::cerr << numberOfRegressions << " performance regression(s) compared to " << baselineFileName << std::endl;
+    return EXIT_FAILURE;
+    }
+  return EXIT_SUCCESS;
+}
+
+//---------------------------------------------------------------------------
+int PerformanceMeasurements::WriteAndCompare(const std::string& outputFileName, const std::string& baselineFileName) const
+{
+  if (this->Write(outputFileName) != EXIT_SUCCESS)
+    {
+    return EXIT_FAILURE;
+    }
+  if (baselineFileName.empty())
+    {
+    return EXIT_SUCCESS;
+    }
+  if (PerformanceMeasurements::GetGenerateBaseline())
+    {
+    std::string baselineDirectory = vtksys::SystemTools::GetFilenamePath(baselineFileName);
+    if (!baselineDirectory.empty() && !vtksys::SystemTools::MakeDirectory(baselineDirectory))
+      {
+      std::cerr << "Failed to create performance baseline directory " << baselineDirectory << std::endl;
+      return EXIT_FAILURE;
+      }
+    if (this->Write(baselineFileName) != EXIT_SUCCESS)
+      {
+      return EXIT_FAILURE;
+      }
+    std::cout << "Performance baseline written to " << baselineFileName << std::endl;
+    return EXIT_SUCCESS;
+    }
+  return this->CompareWithBaseline(baselineFileName, PerformanceMeasurements::GetTolerance());
+}
+
+//---------------------------------------------------------------------------
+double PerformanceMeasurements::GetTolerance(double defaultTolerance/*=1.0*/)
+{
+  std::string toleranceStr;
+  if (!vtksys::SystemTools::GetEnv("SLICER_PERFORMANCE_TEST_TOLERANCE", toleranceStr) || toleranceStr.empty())
+    {
+    return defaultTolerance;
+    }
+  std::stringstream toleranceStream(toleranceStr);
+  double tolerance = defaultTolerance;
+  if (!(toleranceStream >> tolerance) || tolerance < 0.0)
+    {
+    std::cerr << "Invalid SLICER_PERFORMANCE_TEST_TOLERANCE value: " << toleranceStr << std::endl;
+    return defaultTolerance;
+    }
+  return tolerance;
+}
+
+//---------------------------------------------------------------------------
+bool PerformanceMeasurements::GetGenerateBaseline()
+{
+  std::string generateStr;
+  return vtksys::SystemTools::GetEnv("SLICER_PERFORMANCE_TEST_GENERATE_BASELINE", generateStr)
+    && !generateStr.empty() && generateStr != "0";
+}
+
 //---------------------------------------------------------------------------
 vtkMRMLNodeCallback::vtkMRMLNodeCallback()
 {
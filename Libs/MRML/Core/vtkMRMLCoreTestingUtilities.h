@@ -29,6 +29,8 @@
 
 // STD includes
 #include <sstream>
+#include <string>
+#include <utility>
 #include <vector>
 #include <map>
 
@@ -112,6 +114,64 @@ int ExerciseBasicTransformMRMLMethods(vtkMRMLTransformNode* node);
 VTK_MRML_EXPORT
 int ExerciseSceneLoadingMethods(const char * sceneFilePath, vtkMRMLScene* inputScene = nullptr);
 
+//---------------------------------------------------------------------------
+/// \brief Measurements of a performance test, compared against a baseline.
+///
+/// Each measurement is printed as a DartMeasurement, so that its history is
+/// tracked on the dashboard. Measurements are written into a JSON file
+/// ({"name": value, ...}), which can be copied into the source tree to be used
+/// as baseline of the test (see slicer_add_performance_test CMake macro).
+/// Measurements are expected to be "lower is better" values (typically times).
+///
+/// Typical use:
+/// \code
+/// vtkMRMLCoreTestingUtilities::PerformanceMeasurements measurements;
+/// measurements.Report("vtkMRMLScene-AddNode-1000-microseconds-per-operation", value);
+/// CHECK_EXIT_SUCCESS(measurements.WriteAndCompare(tempDir + "/myTest.json", argv[2]));
+/// \endcode
+class VTK_MRML_EXPORT PerformanceMeasurements
+{
+public:
+  typedef std::vector< std::pair<std::string, double> > MeasurementsType;
+
+  /// Add a measurement and print it as a DartMeasurement.
+  void Report(const std::string& name, double value);
+
+  /// Measurements, in the order they were reported.
+  const MeasurementsType& GetMeasurements() const { return this->Measurements; }
+
+  /// Write measurements into a JSON file.
+  int Write(const std::string& fileName) const;
+
+  /// Read measurements written by Write().
+  static int Read(const std::string& fileName, std::map<std::string, double>& measurements);
+
+  /// Compare measurements with the baseline file.
+  /// Returns EXIT_FAILURE if any measurement is larger than baseline * (1 + tolerance).
+  /// Measurements that are not in the baseline are ignored. If the baseline file does not
+  /// exist then "no baseline, comparison skipped" is printed and EXIT_SUCCESS is returned,
+  /// so that new tests can be added before their baseline is recorded (tests added by
+  /// slicer_add_performance_test() are then reported as skipped by CTest).
+  int CompareWithBaseline(const std::string& baselineFileName, double tolerance) const;
+
+  /// Write measurements into outputFileName then compare them with baselineFileName
+  /// (if not empty), using the tolerance returned by GetTolerance().
+  /// If GetGenerateBaseline() is true, the measurements are written into baselineFileName
+  /// instead of being compared.
+  int WriteAndCompare(const std::string& outputFileName, const std::string& baselineFileName) const;
+
+  /// Tolerance set in SLICER_PERFORMANCE_TEST_TOLERANCE environment variable,
+  /// or defaultTolerance if not set.
+  static double GetTolerance(double defaultTolerance = 1.0);
+
+  /// True if SLICER_PERFORMANCE_TEST_GENERATE_BASELINE environment variable is set
+  /// (and not 0), see Slicer_PERFORMANCE_TEST_GENERATE_BASELINES CMake option.
+  static bool GetGenerateBaseline();
+
+protected:
+  MeasurementsType Measurements;
+};
+
 //---------------------------------------------------------------------------
 class VTK_MRML_EXPORT vtkMRMLNodeCallback : public vtkCallbackCommand
 {
@@ -0,0 +1,391 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2005 Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Program:   3D Slicer
+
+=========================================================================auto=*/
+
+// MRML includes
+#include "vtkMRMLImageHistogramCache.h"
+
+// VTK includes
+#include <vtkDataArray.h>
+#include <vtkExtractVOI.h>
+#include <vtkIdTypeArray.h>
+#include <vtkImageData.h>
+#include <vtkImageHistogramStatistics.h>
+#include <vtkNew.h>
+#include <vtkObjectFactory.h>
+#include <vtkPointData.h>
+
+// STD includes
+#include <algorithm>
+
+//----------------------------------------------------------------------------
+// The cache singleton.
+// This MUST be default initialized to zero by the compiler and is
+// therefore not initialized here. The ClassInitialize and
+// ClassFinalize methods handle this instance.
+static vtkMRMLImageHistogramCache* vtkMRMLImageHistogramCacheInstance;
+
+//----------------------------------------------------------------------------
+// Must NOT be initialized. Default initialization to zero is necessary.
+unsigned int vtkMRMLImageHistogramCacheInitialize::Count;
+
+//----------------------------------------------------------------------------
+// Implementation of vtkMRMLImageHistogramCacheInitialize class.
+//----------------------------------------------------------------------------
+vtkMRMLImageHistogramCacheInitialize::vtkMRMLImageHistogramCacheInitialize()
+{
+  if (++Self::Count == 1)
+    {
+    vtkMRMLImageHistogramCache::classInitialize();
+    }
+}
+
+//----------------------------------------------------------------------------
+vtkMRMLImageHistogramCacheInitialize::~vtkMRMLImageHistogramCacheInitialize()
+{
+  if (--Self::Count == 0)
+    {
+    vtkMRMLImageHistogramCache::classFinalize();
+    }
+}
+
+//----------------------------------------------------------------------------
+// Up the reference count so it behaves like New
+vtkMRMLImageHistogramCache* vtkMRMLImageHistogramCache::New()
+{
+  vtkMRMLImageHistogramCache* ret = vtkMRMLImageHistogramCache::GetInstance();
+  ret->Register(nullptr);
+  return ret;
+}
+
+//----------------------------------------------------------------------------
+// Return the single instance of the vtkMRMLImageHistogramCache
+vtkMRMLImageHistogramCache* vtkMRMLImageHistogramCache::GetInstance()
+{
+  if (!vtkMRMLImageHistogramCacheInstance)
+    {
+    // Try the factory first
+    vtkMRMLImageHistogramCacheInstance = (vtkMRMLImageHistogramCache*)
+      vtkObjectFactory::CreateInstance("vtkMRMLImageHistogramCache");
+    // if the factory did not provide one, then create it here
+    if (!vtkMRMLImageHistogramCacheInstance)
+      {
+      vtkMRMLImageHistogramCacheInstance = new vtkMRMLImageHistogramCache;
+#ifdef VTK_HAS_INITIALIZE_OBJECT_BASE
+      vtkMRMLImageHistogramCacheInstance->InitializeObjectBase();
+#endif
+      }
+    }
+  // return the instance
+  return vtkMRMLImageHistogramCacheInstance;
+}
+
+//----------------------------------------------------------------------------
+vtkMRMLImageHistogramCache::vtkMRMLImageHistogramCache()
+{
+  this->MaximumNumberOfSamples = 0;
+  this->MaximumNumberOfEntries = 20;
+  this->NumberOfComputations = 0;
+  this->AccessCounter = 0;
+}
+
+//----------------------------------------------------------------------------
+vtkMRMLImageHistogramCache::~vtkMRMLImageHistogramCache() = default;
+
+//----------------------------------------------------------------------------
+void vtkMRMLImageHistogramCache::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "MaximumNumberOfSamples: " << this->MaximumNumberOfSamples << "\n";
+  os << indent << "MaximumNumberOfEntries: " << this->MaximumNumberOfEntries << "\n";
+  os << indent << "NumberOfEntries: " << this->GetNumberOfEntries() << "\n";
+  os << indent << "NumberOfComputations: " << this->NumberOfComputations << "\n";
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLImageHistogramCache::SetMaximumNumberOfSamples(vtkIdType maximumNumberOfSamples)
+{
+  if (this->MaximumNumberOfSamples == maximumNumberOfSamples)
+    {
+    return;
+    }
+  // entries are recomputed with the new sample rate when they are accessed
+  this->MaximumNumberOfSamples = maximumNumberOfSamples;
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLImageHistogramCache::GetAutoRange(vtkImageData* imageData, double range[2])
+{
+  std::lock_guard<std::mutex> lock(this->EntriesMutex);
+  HistogramEntry* entry = this->GetUpToDateEntry(imageData);
+  if (!entry)
+    {
+    return false;
+    }
+  range[0] = entry->AutoRange[0];
+  range[1] = entry->AutoRange[1];
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLImageHistogramCache::GetPercentile(vtkImageData* imageData, double percentile, double& value)
+{
+  std::lock_guard<std::mutex> lock(this->EntriesMutex);
+  HistogramEntry* entry = this->GetUpToDateEntry(imageData);
+  if (!entry || entry->Histogram.empty())
+    {
+    return false;
+    }
+  double targetCount = entry->TotalCount * std::min(std::max(percentile, 0.0), 100.0) / 100.0;
+  vtkIdType cumulativeCount = 0;
+  size_t binIndex = 0;
+  for (; binIndex < entry->Histogram.size() - 1; ++binIndex)
+    {
+    cumulativeCount += entry->Histogram[binIndex];
+    if (cumulativeCount >= targetCount && cumulativeCount > 0)
+      {
+      break;
+      }
+    }
+  value = entry->BinOrigin + binIndex * entry->BinSpacing;
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLImageHistogramCache::GetStatistics(vtkImageData* imageData, double& minimum, double& maximum,
+  double& mean, double& median, double& standardDeviation)
+{
+  std::lock_guard<std::mutex> lock(this->EntriesMutex);
+  HistogramEntry* entry = this->GetUpToDateEntry(imageData);
+  if (!entry)
+    {
+    return false;
+    }
+  minimum = entry->Minimum;
+  maximum = entry->Maximum;
+  mean = entry->Mean;
+  median = entry->Median;
+  standardDeviation = entry->StandardDeviation;
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLImageHistogramCache::GetHistogram(vtkImageData* imageData, vtkIdTypeArray* histogram,
+  double& binOrigin, double& binSpacing)
+{
+  if (!histogram)
+    {
+    vtkErrorMacro("GetHistogram failed: invalid histogram array");
+    return false;
+    }
+  std::lock_guard<std::mutex> lock(this->EntriesMutex);
+  HistogramEntry* entry = this->GetUpToDateEntry(imageData);
+  if (!entry)
+    {
+    return false;
+    }
+  histogram->SetNumberOfComponents(1);
+  histogram->SetNumberOfTuples(static_cast<vtkIdType>(entry->Histogram.size()));
+  std::copy(entry->Histogram.begin(), entry->Histogram.end(), histogram->GetPointer(0));
+  binOrigin = entry->BinOrigin;
+  binSpacing = entry->BinSpacing;
+  return true;
+}
+
+//----------------------------------------------------------------------------
+int vtkMRMLImageHistogramCache::GetSampleRate(vtkImageData* imageData)
+{
+  std::lock_guard<std::mutex> lock(this->EntriesMutex);
+  HistogramEntry* entry = this->GetUpToDateEntry(imageData);
+  return entry ? entry->SampleRate : 0;
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLImageHistogramCache::RemoveImage(vtkImageData* imageData)
+{
+  std::lock_guard<std::mutex> lock(this->EntriesMutex);
+  this->Entries.erase(imageData);
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLImageHistogramCache::Clear()
+{
+  std::lock_guard<std::mutex> lock(this->EntriesMutex);
+  this->Entries.clear();
+}
+
+//----------------------------------------------------------------------------
+int vtkMRMLImageHistogramCache::GetNumberOfEntries()
+{
+  std::lock_guard<std::mutex> lock(this->EntriesMutex);
+  return static_cast<int>(this->Entries.size());
+}
+
+//----------------------------------------------------------------------------
+vtkMRMLImageHistogramCache::HistogramEntry* vtkMRMLImageHistogramCache::GetUpToDateEntry(vtkImageData* imageData)
+{
+  if (!imageData || !imageData->GetPointData() || !imageData->GetPointData()->GetScalars()
+    || imageData->GetNumberOfPoints() == 0)
+    {
+    // vtkImageHistogramStatistics crashes if there are no scalars
+    return nullptr;
+    }
+  // Scalars may be modified in place (e.g., by segment editor effects), without modifying the image
+  vtkMTimeType mtime = std::max(imageData->GetMTime(), imageData->GetPointData()->GetScalars()->GetMTime());
+  int sampleRate = this->ComputeSampleRate(imageData);
+
+  std::map<vtkImageData*, HistogramEntry>::iterator entryIt = this->Entries.find(imageData);
+  if (entryIt != this->Entries.end()
+    && (entryIt->second.ImageData.GetPointer() != imageData
+      || entryIt->second.MTime != mtime
+      || entryIt->second.SampleRate != sampleRate))
+    {
+    // Image was modified or a deleted image was at the same address
+    this->Entries.erase(entryIt);
+    entryIt = this->Entries.end();
+    }
+  if (entryIt == this->Entries.end())
+    {
+    this->PruneEntries();
+    HistogramEntry& entry = this->Entries[imageData];
+    entry.ImageData = imageData;
+    entry.MTime = mtime;
+    entry.SampleRate = sampleRate;
+    this->ComputeEntry(imageData, entry);
+    entryIt = this->Entries.find(imageData);
+    }
+  entryIt->second.LastAccess = ++this->AccessCounter;
+  return &entryIt->second;
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLImageHistogramCache::ComputeEntry(vtkImageData* imageData, HistogramEntry& entry)
+{
+  vtkNew<vtkImageHistogramStatistics> histogramStatistics;
+
+  // Set automatic window/level to include the entire intensity range
+  // (except top/bottom 0.1%, to not let a very thin tail of the intensity
+  // distribution to decrease the image contrast too much).
+  // While in CT and sometimes in MRI, there may be a large empty area
+  // outside the reconstructed image, which could be suppressed
+  // by a larger lower percentile value, it would make the method
+  // too specific to particular imaging modalities and could lead to
+  // suboptimal results for other types of images.
+  // Therefore, we choose small, symmetric percentile values here
+  // and maybe add modality-specific methods later (e.g., for CT
+  // images we could set lower value to -1000HU).
+  histogramStatistics->SetAutoRangePercentiles(0.1, 99.9);
+
+  // Percentiles are very low (0.1%), so there is no need for
+  // range expansion.
+  histogramStatistics->SetAutoRangeExpansionFactors(0.0, 0.0);
+
+  vtkNew<vtkExtractVOI> sampler;
+  if (entry.SampleRate > 1)
+    {
+    sampler->SetInputData(imageData);
+    sampler->SetVOI(imageData->GetExtent());
+    sampler->SetSampleRate(entry.SampleRate, entry.SampleRate, entry.SampleRate);
+    histogramStatistics->SetInputConnection(sampler->GetOutputPort());
+    }
+  else
+    {
+    histogramStatistics->SetInputData(imageData);
+    }
+  histogramStatistics->Update();
+  ++this->NumberOfComputations;
+
+  double* autoRange = histogramStatistics->GetAutoRange();
+  entry.AutoRange[0] = autoRange[0];
+  entry.AutoRange[1] = autoRange[1];
+  entry.Minimum = histogramStatistics->GetMinimum();
+  entry.Maximum = histogramStatistics->GetMaximum();
+  entry.Mean = histogramStatistics->GetMean();
+  entry.Median = histogramStatistics->GetMedian();
+  entry.StandardDeviation = histogramStatistics->GetStandardDeviation();
+  entry.BinOrigin = histogramStatistics->GetBinOrigin();
+  entry.BinSpacing = histogramStatistics->GetBinSpacing();
+  entry.TotalCount = histogramStatistics->GetTotal();
+  vtkIdTypeArray* histogram = histogramStatistics->GetHistogram();
+  entry.Histogram.clear();
+  if (histogram)
+    {
+    entry.Histogram.assign(histogram->GetPointer(0), histogram->GetPointer(0) + histogram->GetNumberOfTuples());
+    }
+}
+
+//----------------------------------------------------------------------------
+int vtkMRMLImageHistogramCache::ComputeSampleRate(vtkImageData* imageData)
+{
+  if (this->MaximumNumberOfSamples <= 0 || imageData->GetNumberOfPoints() <= this->MaximumNumberOfSamples)
+    {
+    return 1;
+    }
+  int dimensions[3] = { 1, 1, 1 };
+  imageData->GetDimensions(dimensions);
+  int maximumDimension = std::max(dimensions[0], std::max(dimensions[1], dimensions[2]));
+  for (int sampleRate = 2; sampleRate < maximumDimension; ++sampleRate)
+    {
+    vtkIdType numberOfSamples = 1;
+    for (int i = 0; i < 3; ++i)
+      {
+      numberOfSamples *= (dimensions[i] + sampleRate - 1) / sampleRate;
+      }
+    if (numberOfSamples <= this->MaximumNumberOfSamples)
+      {
+      return sampleRate;
+      }
+    }
+  return std::max(maximumDimension, 1);
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLImageHistogramCache::PruneEntries()
+{
+  for (std::map<vtkImageData*, HistogramEntry>::iterator entryIt = this->Entries.begin(); entryIt != this->Entries.end();)
+    {
+    if (!entryIt->second.ImageData)
+      {
+      entryIt = this->Entries.erase(entryIt);
+      }
+    else
+      {
+      ++entryIt;
+      }
+    }
+  // make room for a new entry
+  while (!this->Entries.empty() && static_cast<int>(this->Entries.size()) >= std::max(this->MaximumNumberOfEntries, 1))
+    {
+    std::map<vtkImageData*, HistogramEntry>::iterator leastRecentlyUsedIt = this->Entries.begin();
+    for (std::map<vtkImageData*, HistogramEntry>::iterator entryIt = this->Entries.begin(); entryIt != this->Entries.end(); ++entryIt)
+      {
+      if (entryIt->second.LastAccess < leastRecentlyUsedIt->second.LastAccess)
+        {
+        leastRecentlyUsedIt = entryIt;
+        }
+      }
+    this->Entries.erase(leastRecentlyUsedIt);
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLImageHistogramCache::classInitialize()
+{
+  // Allocate the singleton
+  vtkMRMLImageHistogramCacheInstance = vtkMRMLImageHistogramCache::GetInstance();
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLImageHistogramCache::classFinalize()
+{
+  vtkMRMLImageHistogramCacheInstance->Delete();
+  vtkMRMLImageHistogramCacheInstance = nullptr;
+}
@@ -0,0 +1,178 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2005 Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Program:   3D Slicer
+
+=========================================================================auto=*/
+
+#ifndef __vtkMRMLImageHistogramCache_h
+#define __vtkMRMLImageHistogramCache_h
+
+// MRML includes
+#include "vtkMRML.h"
+
+// VTK includes
+#include <vtkObject.h>
+#include <vtkWeakPointer.h>
+
+// STD includes
+#include <map>
+#include <mutex>
+#include <vector>
+
+class vtkIdTypeArray;
+class vtkImageData;
+
+/// \brief Histogram and intensity statistics of images, computed once per image modification.
+///
+/// Statistics are computed by vtkImageHistogramStatistics the first time they are requested
+/// for an image, then they are returned from the cache until the image or its scalars are
+/// modified. The cache is shared by all users: automatic window/level of all display nodes
+/// (including the copies used by slice logics) of a volume, volume rendering, segment editor
+/// effects, etc. require a single histogram computation.
+///
+/// Images with more voxels than MaximumNumberOfSamples are sampled with a constant stride
+/// along each axis, so that statistics of very large volumes are estimated in milliseconds.
+/// Sampling is disabled by default.
+///
+/// Typical use:
+/// \code
+/// double range[2] = { 0.0, 0.0 };
+/// vtkMRMLImageHistogramCache::GetInstance()->GetAutoRange(imageData, range);
+/// \endcode
+class VTK_MRML_EXPORT vtkMRMLImageHistogramCache : public vtkObject
+{
+public:
+  vtkTypeMacro(vtkMRMLImageHistogramCache, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  /// Return the singleton instance with no reference counting.
+  static vtkMRMLImageHistogramCache* GetInstance();
+
+  /// This is a singleton pattern New. There will only be ONE
+  /// reference to a vtkMRMLImageHistogramCache object per process. Clients that
+  /// call this must call Delete on the object so that the reference
+  /// counting will work. The single instance will be unreferenced when
+  /// the program exits.
+  static vtkMRMLImageHistogramCache* New();
+
+  /// Maximum number of voxels that are used for computing the histogram of an image.
+  /// If the image has more voxels then it is sampled with a constant stride along each axis.
+  /// 0 (default) means that all voxels are used.
+  void SetMaximumNumberOfSamples(vtkIdType maximumNumberOfSamples);
+  vtkGetMacro(MaximumNumberOfSamples, vtkIdType);
+
+  /// Maximum number of images that are kept in the cache. Entries of deleted images are
+  /// removed automatically, if more images are cached then the least recently used ones
+  /// are removed. Default is 20.
+  vtkSetMacro(MaximumNumberOfEntries, int);
+  vtkGetMacro(MaximumNumberOfEntries, int);
+
+  /// Intensity range between the 0.1 and 99.9 percentiles, as used by automatic window/level.
+  /// Returns false if the image has no scalars.
+  bool GetAutoRange(vtkImageData* imageData, double range[2]);
+
+  /// Intensity value at the specified percentile (between 0 and 100), computed from the histogram.
+  /// Returns false if the image has no scalars.
+  bool GetPercentile(vtkImageData* imageData, double percentile, double& value);
+
+  /// Minimum, maximum, mean, median and standard deviation of the intensity values.
+  /// Returns false if the image has no scalars.
+  bool GetStatistics(vtkImageData* imageData, double& minimum, double& maximum,
+    double& mean, double& median, double& standardDeviation);
+
+  /// Histogram of the intensity values. Value of the i-th bin is binOrigin + i * binSpacing.
+  /// Returns false if the image has no scalars.
+  bool GetHistogram(vtkImageData* imageData, vtkIdTypeArray* histogram, double& binOrigin, double& binSpacing);
+
+  /// Stride along each axis that is used for sampling the image (1 if all voxels are used).
+  /// Returns 0 if the image has no scalars.
+  int GetSampleRate(vtkImageData* imageData);
+
+  /// Remove cached statistics of an image.
+  void RemoveImage(vtkImageData* imageData);
+
+  /// Remove all cached statistics.
+  void Clear();
+
+  /// Number of cached images.
+  int GetNumberOfEntries();
+
+  /// Number of histogram computations since the cache was created.
+  /// Useful for checking that the statistics are not recomputed unnecessarily.
+  vtkGetMacro(NumberOfComputations, int);
+
+protected:
+  vtkMRMLImageHistogramCache();
+  ~vtkMRMLImageHistogramCache() override;
+  vtkMRMLImageHistogramCache(const vtkMRMLImageHistogramCache&);
+  void operator=(const vtkMRMLImageHistogramCache&);
+
+  friend class vtkMRMLImageHistogramCacheInitialize;
+  typedef vtkMRMLImageHistogramCache Self;
+
+  /// Singleton management functions.
+  static void classInitialize();
+  static void classFinalize();
+
+  struct HistogramEntry
+    {
+    vtkWeakPointer<vtkImageData> ImageData;
+    vtkMTimeType MTime{0};
+    int SampleRate{1};
+    unsigned long LastAccess{0};
+    double AutoRange[2]{0.0, 0.0};
+    double Minimum{0.0};
+    double Maximum{0.0};
+    double Mean{0.0};
+    double Median{0.0};
+    double StandardDeviation{0.0};
+    double BinOrigin{0.0};
+    double BinSpacing{1.0};
+    vtkIdType TotalCount{0};
+    std::vector<vtkIdType> Histogram;
+    };
+
+  /// Return up-to-date statistics of the image, compute them if needed.
+  /// Must be called with EntriesMutex locked. Returns nullptr if the image has no scalars.
+  HistogramEntry* GetUpToDateEntry(vtkImageData* imageData);
+
+  /// Compute histogram and statistics of the image into the entry.
+  void ComputeEntry(vtkImageData* imageData, HistogramEntry& entry);
+
+  /// Stride that reduces the number of voxels of the image to MaximumNumberOfSamples.
+  int ComputeSampleRate(vtkImageData* imageData);
+
+  /// Remove entries of deleted images and least recently used entries.
+  void PruneEntries();
+
+  vtkIdType MaximumNumberOfSamples;
+  int MaximumNumberOfEntries;
+  int NumberOfComputations;
+  unsigned long AccessCounter;
+  std::map<vtkImageData*, HistogramEntry> Entries;
+  std::mutex EntriesMutex;
+};
+
+/// Utility class to make sure vtkMRMLImageHistogramCache is initialized before it is used.
+class VTK_MRML_EXPORT vtkMRMLImageHistogramCacheInitialize
+{
+public:
+  typedef vtkMRMLImageHistogramCacheInitialize Self;
+
+  vtkMRMLImageHistogramCacheInitialize();
+  ~vtkMRMLImageHistogramCacheInitialize();
+private:
+  static unsigned int Count;
+};
+
+/// This instance will show up in any translation unit that uses
+/// vtkMRMLImageHistogramCache. It will make sure vtkMRMLImageHistogramCache is initialized
+/// before it is used.
+static vtkMRMLImageHistogramCacheInitialize vtkMRMLImageHistogramCacheInitializer;
+
+#endif
@@ -20,6 +20,8 @@ or http://www.slicer.org/copyright/copyright.txt for details.
 #include "vtkMRMLLinearTransformNode.h"
 #include "vtkMRMLScene.h"
 #include "vtkMRMLSequenceNode.h"
+#include "vtkTeemNRRDReader.h"
+#include "vtkTeemNRRDWriter.h"
 
 #include "vtkObjectFactory.h"
 #include "vtkImageAppendComponents.h"
@@ -36,6 +38,18 @@ static const int MAX_LINE_LENGTH = 1000;
 static std::string SEQMETA_FIELD_FRAME_FIELD_PREFIX = "Seq_Frame";
 static std::string SEQMETA_FIELD_IMG_STATUS = "ImageStatus";
 
+// Matrix array files store 16 matrix elements (row-major order) as components of each voxel,
+// one voxel for each sequence item along axis 1 (axis 0 is the matrix element axis)
+static std::string MATRIX_ARRAY_FILE_EXTENSION = ".tfm.seq.nrrd";
+static std::string MATRIX_ARRAY_FIELD_INDEX_TYPE = "axis 1 index type";
+static std::string MATRIX_ARRAY_FIELD_INDEX_VALUES = "axis 1 index values";
+
+//----------------------------------------------------------------------------
+inline bool IsMatrixArrayFileName(const std::string& fileName)
+{
+  return vtksys::SystemTools::StringEndsWith(vtksys::SystemTools::LowerCase(fileName), MATRIX_ARRAY_FILE_EXTENSION.c_str());
+}
+
 // Constants for creating nodes
 static const char NODE_BASE_NAME_SEPARATOR[] = "-";
 
@@ -100,10 +114,15 @@ int vtkMRMLLinearTransformSequenceStorageNode::ReadSequenceFileTransforms(const
 
   frameNumberToIndexValueMap.clear();
 
-  // This structure contains all the transform nodes that are read from the file.
-  // The nodes are not added immediately to the scene to allow them properly named, using the timestamp index value.
-  // Maps the frame number to a vector of transform nodes that belong to that frame.
-  std::map<int, std::vector<vtkMRMLLinearTransformNode*> > importedTransformNodes;
+  // This structure contains all the transforms that are read from the file.
+  // The transforms are not added immediately to the sequences because the timestamp index value may be read later.
+  // Maps the frame number to a vector of transform names and matrices that belong to that frame.
+  struct ImportedTransformType
+    {
+    std::string Name;
+    double MatrixElements[16];
+    };
+  std::map<int, std::vector<ImportedTransformType> > importedTransforms;
 
   // It contains the largest frame number. It will be used to iterate through all the frame numbers from 0 to lastFrameNumber
   int lastFrameNumber = -1;
@@ -215,11 +234,10 @@ int vtkMRMLLinearTransformSequenceStorageNode::ReadSequenceFileTransforms(const
         {
         continue;
         }
-      vtkMRMLLinearTransformNode* currentTransform = vtkMRMLLinearTransformNode::New(); // will be deleted when added to the scene
-      currentTransform->SetMatrixTransformToParent(matrix.GetPointer());
-      // Generating a unique name is important because that will be used to generate the filename by default
-      currentTransform->SetName(frameFieldName.c_str());
-      importedTransformNodes[frameNumber].push_back(currentTransform);
+      ImportedTransformType currentTransform;
+      currentTransform.Name = frameFieldName;
+      std::copy(&matrix->Element[0][0], &matrix->Element[0][0] + 16, currentTransform.MatrixElements);
+      importedTransforms[frameNumber].push_back(currentTransform);
       }
 
     if (frameFieldName.compare("Timestamp") == 0)
@@ -245,25 +263,27 @@ int vtkMRMLLinearTransformSequenceStorageNode::ReadSequenceFileTransforms(const
     }
   fclose(stream);
 
-  // Now add all the nodes to the scene
+  // Now add all the transforms to the sequences
 
   std::map< std::string, vtkMRMLSequenceNode* > transformSequenceNodes;
+  // Sequence nodes are only modified once, when all transforms are added
+  std::map< vtkMRMLSequenceNode*, int > transformSequenceNodesWasModified;
+  vtkNew<vtkMatrix4x4> matrix;
 
   for (int currentFrameNumber = 0; currentFrameNumber <= lastFrameNumber; currentFrameNumber++)
     {
-    std::map<int, std::vector<vtkMRMLLinearTransformNode*> >::iterator transformsForCurrentFrame = importedTransformNodes.find(currentFrameNumber);
-    if (transformsForCurrentFrame == importedTransformNodes.end())
+    std::map<int, std::vector<ImportedTransformType> >::iterator transformsForCurrentFrame = importedTransforms.find(currentFrameNumber);
+    if (transformsForCurrentFrame == importedTransforms.end())
       {
       // no transforms for this frame
       continue;
       }
     std::string paramValueString = frameNumberToIndexValueMap[currentFrameNumber];
-    for (std::vector<vtkMRMLLinearTransformNode*>::iterator transformIt = transformsForCurrentFrame->second.begin();
+    for (std::vector<ImportedTransformType>::iterator transformIt = transformsForCurrentFrame->second.begin();
       transformIt != transformsForCurrentFrame->second.end(); ++transformIt)
       {
-      vtkMRMLLinearTransformNode* transform = (*transformIt);
       vtkMRMLSequenceNode* transformsSequenceNode = nullptr;
-      if (transformSequenceNodes.find(transform->GetName()) == transformSequenceNodes.end())
+      if (transformSequenceNodes.find(transformIt->Name) == transformSequenceNodes.end())
         {
         // Setup hierarchy structure
         vtkSmartPointer<vtkMRMLSequenceNode> newTransformsSequenceNode;
@@ -281,9 +301,10 @@ int vtkMRMLLinearTransformSequenceStorageNode::ReadSequenceFileTransforms(const
           }
         numberOfCreatedNodes++;
         transformsSequenceNode = newTransformsSequenceNode;
+        transformSequenceNodesWasModified[transformsSequenceNode] = transformsSequenceNode->StartModify();
         transformsSequenceNode->SetIndexName("time");
         transformsSequenceNode->SetIndexUnit("s");
-        std::string transformName = transform->GetName();
+        std::string transformName = transformIt->Name;
         // Strip "Transform" from the end of the transform name
         std::string transformPostfix = "Transform";
         if (transformName.length() > transformPostfix.length() &&
@@ -298,21 +319,22 @@ int vtkMRMLLinearTransformSequenceStorageNode::ReadSequenceFileTransforms(const
         // find a transform by matching the original the transform name.
         transformsSequenceNode->SetAttribute("Sequences.Source", transformName.c_str());
 
-        transformSequenceNodes[transform->GetName()] = transformsSequenceNode;
+        transformSequenceNodes[transformIt->Name] = transformsSequenceNode;
         }
       else
         {
-        transformsSequenceNode = transformSequenceNodes[transform->GetName()];
+        transformsSequenceNode = transformSequenceNodes[transformIt->Name];
         }
-      transform->SetHideFromEditors(false);
-      // Generating a unique name is important because that will be used to generate the filename by default
-      std::ostringstream nameStr;
-      nameStr << transform->GetName() << "_" << std::setw(4) << std::setfill('0') << currentFrameNumber << std::ends;
-      transform->SetName(nameStr.str().c_str());
-      transformsSequenceNode->SetDataNodeAtValue(transform, paramValueString.c_str());
-      transform->Delete(); // ownership transferred to the sequence node
+      // Transform nodes are only created when the transforms are accessed
+      matrix->DeepCopy(transformIt->MatrixElements);
+      transformsSequenceNode->SetMatrixAtValue(matrix, paramValueString);
       }
     }
+  for (std::map< vtkMRMLSequenceNode*, int >::iterator wasModifiedIt = transformSequenceNodesWasModified.begin();
+    wasModifiedIt != transformSequenceNodesWasModified.end(); ++wasModifiedIt)
+    {
+    wasModifiedIt->first->EndModify(wasModifiedIt->second);
+    }
 
   // Add to scene and set name and storage node
   std::string fileNameName = vtksys::SystemTools::GetFilenameName(fileName);
@@ -444,11 +466,11 @@ bool vtkMRMLLinearTransformSequenceStorageNode::WriteSequenceMetafileTransforms(
 
       std::string transformValue = "1 0 0 0 0 1 0 0 0 0 1 0 0 0 0 1"; // Identity
       std::string transformStatus = "INVALID";
-      vtkMRMLTransformNode* transformNode = vtkMRMLTransformNode::SafeDownCast(currSequenceNode->GetDataNodeAtValue(indexValue.c_str()));
-      if (transformNode != nullptr && transformNode->IsLinear())
+      // Get the matrix without creating a transform node for each item
+      int itemNumber = currSequenceNode->GetItemNumberFromIndexValue(indexValue);
+      vtkNew<vtkMatrix4x4> matrix;
+      if (itemNumber >= 0 && currSequenceNode->GetNthMatrix(itemNumber, matrix.GetPointer()))
         {
-        vtkNew<vtkMatrix4x4> matrix;
-        transformNode->GetMatrixTransformToParent(matrix.GetPointer());
         transformValue = vtkAddonMathUtilities::ToString(matrix.GetPointer());
         transformStatus = "OK";
         }
@@ -505,6 +527,11 @@ int vtkMRMLLinearTransformSequenceStorageNode::ReadDataInternal(vtkMRMLNode* ref
     return 0;
     }
 
+  if (IsMatrixArrayFileName(fullName))
+    {
+    return this->ReadMatrixArrayFile(fullName, seqNode);
+    }
+
   std::deque< vtkSmartPointer<vtkMRMLSequenceNode> > createdTransformNodes;
   createdTransformNodes.push_back(seqNode);
   std::map< int, std::string > frameNumberToIndexValueMap;
@@ -540,10 +567,11 @@ bool vtkMRMLLinearTransformSequenceStorageNode::CanWriteFromReferenceNode(vtkMRM
     return false;
     }
   int numberOfFrameVolumes = sequenceNode->GetNumberOfDataNodes();
+  vtkNew<vtkMatrix4x4> matrix;
   for (int frameIndex = 0; frameIndex < numberOfFrameVolumes; frameIndex++)
     {
-    vtkMRMLTransformNode* transform = vtkMRMLTransformNode::SafeDownCast(sequenceNode->GetNthDataNode(frameIndex));
-    if (transform == NULL || !transform->IsLinear())
+    // Check the matrix without creating a transform node for each item
+    if (!sequenceNode->GetNthMatrix(frameIndex, matrix.GetPointer()))
       {
       vtkDebugMacro("vtkMRMLLinearTransformSequenceStorageNode::CanWriteFromReferenceNode:"
         << " only linear transform nodes can be written (frame " << frameIndex << ")");
@@ -572,6 +600,16 @@ int vtkMRMLLinearTransformSequenceStorageNode::WriteDataInternal(vtkMRMLNode *re
     return 0;
     }
 
+  if (IsMatrixArrayFileName(fullName))
+    {
+    if (!this->WriteMatrixArrayFile(fullName, sequenceNode))
+      {
+      return 0;
+      }
+    this->StageWriteData(refNode);
+    return 1;
+    }
+
   std::deque< vtkMRMLSequenceNode* > transformSequenceNodes;
   transformSequenceNodes.push_back(sequenceNode);
   std::deque< std::string > transformNames;
@@ -602,6 +640,7 @@ void vtkMRMLLinearTransformSequenceStorageNode::InitializeSupportedReadFileTypes
   this->SupportedReadFileTypes->InsertNextValue("Linear transform sequence (.seq.mha)");
   this->SupportedReadFileTypes->InsertNextValue("Linear transform sequence (.mha)");
   this->SupportedReadFileTypes->InsertNextValue("Linear transform sequence (.mhd)");
+  this->SupportedReadFileTypes->InsertNextValue("Linear transform sequence (.tfm.seq.nrrd)");
 }
 
 //----------------------------------------------------------------------------
@@ -611,6 +650,7 @@ void vtkMRMLLinearTransformSequenceStorageNode::InitializeSupportedWriteFileType
   this->SupportedWriteFileTypes->InsertNextValue("Linear transform sequence (.seq.mha)");
   this->SupportedWriteFileTypes->InsertNextValue("Linear transform sequence (.mhd)");
   this->SupportedWriteFileTypes->InsertNextValue("Linear transform sequence (.mha)");
+  this->SupportedWriteFileTypes->InsertNextValue("Linear transform sequence (.tfm.seq.nrrd)");
 }
 
 //----------------------------------------------------------------------------
@@ -618,3 +658,130 @@ const char* vtkMRMLLinearTransformSequenceStorageNode::GetDefaultWriteFileExtens
 {
   return "seq.mha";
 }
+
+//----------------------------------------------------------------------------
+int vtkMRMLLinearTransformSequenceStorageNode::ReadMatrixArrayFile(const std::string& fileName, vtkMRMLSequenceNode* sequenceNode)
+{
+  vtkNew<vtkTeemNRRDReader> reader;
+  reader->SetFileName(fileName.c_str());
+  if (!reader->CanReadFile(fileName.c_str()))
+    {
+    vtkErrorMacro("ReadMatrixArrayFile: cannot read file " << fileName);
+    return 0;
+    }
+  reader->UpdateInformation();
+
+  int wasModified = sequenceNode->StartModify();
+  sequenceNode->RemoveAllDataNodes();
+
+  std::vector< std::string > indexValues;
+  std::vector<std::string> keys = reader->GetHeaderKeysVector();
+  for (std::vector<std::string>::iterator kit = keys.begin(); kit != keys.end(); ++kit)
+    {
+    if (*kit == MATRIX_ARRAY_FIELD_INDEX_TYPE)
+      {
+      sequenceNode->SetIndexTypeFromString(reader->GetHeaderValue((*kit).c_str()));
+      }
+    else if (*kit == MATRIX_ARRAY_FIELD_INDEX_VALUES)
+      {
+      std::string indexValue;
+      for (std::istringstream indexValueList(reader->GetHeaderValue((*kit).c_str()));
+        indexValueList >> indexValue;)
+        {
+        indexValues.push_back(vtkMRMLNode::URLDecodeString(indexValue.c_str()));
+        }
+      }
+    else
+      {
+      sequenceNode->SetAttribute((*kit).c_str(), reader->GetHeaderValue((*kit).c_str()));
+      }
+    }
+  const char* indexName = reader->GetAxisLabel(1);
+  sequenceNode->SetIndexName(indexName ? indexName : "time");
+  const char* indexUnit = reader->GetAxisUnit(1);
+  sequenceNode->SetIndexUnit(indexUnit ? indexUnit : "");
+
+  reader->Update();
+  vtkImageData* matrixArray = reader->GetOutput();
+  int numberOfItems = static_cast<int>(indexValues.size());
+  if (!matrixArray || matrixArray->GetScalarType() != VTK_DOUBLE || matrixArray->GetNumberOfScalarComponents() != 16
+    || matrixArray->GetNumberOfPoints() != numberOfItems)
+    {
+    vtkErrorMacro("ReadMatrixArrayFile: invalid matrix array in file " << fileName);
+    sequenceNode->EndModify(wasModified);
+    return 0;
+    }
+
+  const double* matrixElements = static_cast<double*>(matrixArray->GetScalarPointer());
+  vtkNew<vtkMatrix4x4> matrix;
+  for (int itemNumber = 0; itemNumber < numberOfItems; ++itemNumber)
+    {
+    matrix->DeepCopy(matrixElements + 16 * itemNumber);
+    sequenceNode->SetMatrixAtValue(matrix, indexValues[itemNumber]);
+    }
+  sequenceNode->EndModify(wasModified);
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkMRMLLinearTransformSequenceStorageNode::WriteMatrixArrayFile(const std::string& fileName, vtkMRMLSequenceNode* sequenceNode)
+{
+  int numberOfItems = sequenceNode->GetNumberOfDataNodes();
+  if (numberOfItems == 0)
+    {
+    this->GetUserMessages()->AddMessage(vtkCommand::ErrorEvent, std::string("Cannot write empty transform sequence."));
+    return 0;
+    }
+
+  vtkNew<vtkImageData> matrixArray;
+  matrixArray->SetDimensions(numberOfItems, 1, 1);
+  matrixArray->AllocateScalars(VTK_DOUBLE, 16);
+  double* matrixElements = static_cast<double*>(matrixArray->GetScalarPointer());
+  vtkNew<vtkMatrix4x4> matrix;
+  std::stringstream ssIndexValues;
+  for (int itemNumber = 0; itemNumber < numberOfItems; ++itemNumber)
+    {
+    if (!sequenceNode->GetNthMatrix(itemNumber, matrix.GetPointer()))
+      {
+      this->GetUserMessages()->AddMessage(vtkCommand::ErrorEvent, std::string("Only linear transform nodes can be written in this format."));
+      return 0;
+      }
+    std::copy(&matrix->Element[0][0], &matrix->Element[0][0] + 16, matrixElements + 16 * itemNumber);
+    if (itemNumber > 0)
+      {
+      ssIndexValues << " ";
+      }
+    // Encode string to make sure there are no spaces in the serialized index value (space is used as separator)
+    ssIndexValues << vtkMRMLNode::URLEncodeString(sequenceNode->GetNthIndexValue(itemNumber).c_str());
+    }
+
+  vtkNew<vtkTeemNRRDWriter> writer;
+  writer->SetFileName(fileName.c_str());
+  writer->SetInputData(matrixArray);
+  writer->SetVectorAxisKind(nrrdKindList);
+  writer->SetUseCompression(this->GetUseCompression());
+  if (!sequenceNode->GetIndexName().empty())
+    {
+    writer->SetAxisLabel(1, sequenceNode->GetIndexName().c_str());
+    }
+  if (!sequenceNode->GetIndexUnit().empty())
+    {
+    writer->SetAxisUnit(1, sequenceNode->GetIndexUnit().c_str());
+    }
+  writer->SetAttribute(MATRIX_ARRAY_FIELD_INDEX_TYPE, sequenceNode->GetIndexTypeAsString());
+  writer->SetAttribute(MATRIX_ARRAY_FIELD_INDEX_VALUES, ssIndexValues.str());
+  // pass down all MRML attributes to NRRD
+  std::vector<std::string> attributeNames = sequenceNode->GetAttributeNames();
+  for (std::vector<std::string>::iterator ait = attributeNames.begin(); ait != attributeNames.end(); ++ait)
+    {
+    writer->SetAttribute((*ait), sequenceNode->GetAttribute((*ait).c_str()));
+    }
+  writer->Write();
+  if (writer->GetWriteError())
+    {
+    vtkDebugMacro("ERROR writing NRRD file " << fileName);
+    this->GetUserMessages()->AddMessage(vtkCommand::ErrorEvent, std::string("Failed to write NRRD file."));
+    return 0;
+    }
+  return 1;
+}
@@ -9,6 +9,11 @@
 ///  vtkMRMLLinearTransformSequenceStorageNode - MRML node that can read/write
 ///  a Sequence node containing linear transforms in a single nrrd or mha file
 ///
+///  Transforms are stored in the header of sequence metafiles (.seq.mha, .seq.mhd)
+///  or as a binary array of matrices in a NRRD file (.tfm.seq.nrrd), which is much faster
+///  to read and write for long recordings. Transforms are read into the sequence node
+///  as matrices (see vtkMRMLSequenceNode::SetMatrixAtValue).
+///
 
 #ifndef __vtkMRMLLinearTransformSequenceStorageNode_h
 #define __vtkMRMLLinearTransformSequenceStorageNode_h
@@ -81,6 +86,14 @@ protected:
 
   /// Initialize all the supported write file types
   void InitializeSupportedWriteFileTypes() override;
+
+  /// Read all transforms from a NRRD file that stores the matrices of all items in a single array.
+  /// Returns 1 on success, 0 otherwise.
+  int ReadMatrixArrayFile(const std::string& fileName, vtkMRMLSequenceNode* sequenceNode);
+
+  /// Write all transforms to a NRRD file that stores the matrices of all items in a single array.
+  /// Returns 1 on success, 0 otherwise.
+  int WriteMatrixArrayFile(const std::string& fileName, vtkMRMLSequenceNode* sequenceNode);
 };
 
 #endif
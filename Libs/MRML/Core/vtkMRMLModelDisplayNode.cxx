@@ -43,6 +43,7 @@ vtkMRMLModelDisplayNode::vtkMRMLModelDisplayNode()
 {
   this->PassThrough = vtkPassThrough::New();
   this->AssignAttribute = vtkAssignAttribute::New();
+  this->AssignedAttributeLocation = -2; // indicates not assigned yet
   this->ThresholdFilter = vtkThreshold::New();
   this->ThresholdFilter->ThresholdBetween(0.0, -1.0); // indicates uninitialized
   this->ThresholdRangeTemp[0] = 0.0;
@@ -403,18 +404,25 @@ void vtkMRMLModelDisplayNode::SetActiveAttributeLocation(int location)
 //---------------------------------------------------------------------------
 void vtkMRMLModelDisplayNode::UpdateAssignedAttribute()
 {
-  this->AssignAttribute->Assign(
-    this->GetActiveScalarName(),
-    vtkDataSetAttributes::SCALARS,
-    this->GetActiveAttributeLocation() >= 0 ? this->GetActiveAttributeLocation() : vtkAssignAttribute::POINT_DATA);
-
-  if (this->GetActiveAttributeLocation() == vtkAssignAttribute::POINT_DATA)
-    {
-    this->ThresholdFilter->SetInputArrayToProcess(0, 0, 0, vtkDataObject::FIELD_ASSOCIATION_POINTS, vtkDataSetAttributes::SCALARS);
-    }
-  else if (this->GetActiveAttributeLocation() == vtkAssignAttribute::CELL_DATA)
+  std::string activeScalarName = (this->GetActiveScalarName() ? this->GetActiveScalarName() : "");
+  if (this->AssignedAttributeLocation != this->GetActiveAttributeLocation()
+    || this->AssignedScalarName != activeScalarName)
     {
-    this->ThresholdFilter->SetInputArrayToProcess(0, 0, 0, vtkDataObject::FIELD_ASSOCIATION_CELLS, vtkDataSetAttributes::SCALARS);
+    this->AssignAttribute->Assign(
+      this->GetActiveScalarName(),
+      vtkDataSetAttributes::SCALARS,
+      this->GetActiveAttributeLocation() >= 0 ? this->GetActiveAttributeLocation() : vtkAssignAttribute::POINT_DATA);
+
+    if (this->GetActiveAttributeLocation() == vtkAssignAttribute::POINT_DATA)
+      {
+      this->ThresholdFilter->SetInputArrayToProcess(0, 0, 0, vtkDataObject::FIELD_ASSOCIATION_POINTS, vtkDataSetAttributes::SCALARS);
+      }
+    else if (this->GetActiveAttributeLocation() == vtkAssignAttribute::CELL_DATA)
+      {
+      this->ThresholdFilter->SetInputArrayToProcess(0, 0, 0, vtkDataObject::FIELD_ASSOCIATION_CELLS, vtkDataSetAttributes::SCALARS);
+      }
+    this->AssignedScalarName = activeScalarName;
+    this->AssignedAttributeLocation = this->GetActiveAttributeLocation();
     }
 
   this->UpdateScalarRange();
@@ -190,6 +190,11 @@ protected:
   /// This can be useful to specify what field array is the color array that
   /// needs to be used by the VTK mappers.
   vtkAssignAttribute* AssignAttribute;
+  /// Scalar name and attribute location that AssignAttribute was last updated with.
+  /// Used for not modifying the mesh pipeline (and re-executing thresholding and
+  /// surface extraction) when the active scalar did not change.
+  std::string AssignedScalarName;
+  int AssignedAttributeLocation;
 
   /// Default filter when assign attribute is not used, e.g ActiveScalarName is
   /// null.
@@ -30,10 +30,12 @@ Version:   $Revision: 1.3 $
 #include <vtkEventForwarderCommand.h>
 #include <vtkFloatArray.h>
 #include <vtkGeneralTransform.h>
+#include <vtkLinearTransform.h>
 #include <vtkMatrix4x4.h>
 #include <vtkNew.h>
 #include <vtkObjectFactory.h>
 #include <vtkPointData.h>
+#include <vtkPoints.h>
 #include <vtkPolyData.h>
 #include <vtkSmartPointer.h>
 #include <vtkTransformFilter.h>
@@ -86,15 +88,31 @@ void vtkMRMLModelNode::CopyContent(vtkMRMLNode* anode, bool deepCopy/*=true*/)
     {
     if (node->GetMesh())
       {
+      // points and cells are shared until DetachSharedBulkData() is called
+      bool shareMesh = this->GetCopyOnWriteBulkData(node);
       if (this->GetMesh() && strcmp(this->GetMesh()->GetClassName(), node->GetMesh()->GetClassName())==0)
         {
-        this->GetMesh()->DeepCopy(node->GetMesh());
+        if (shareMesh)
+          {
+          this->GetMesh()->ShallowCopy(node->GetMesh());
+          }
+        else
+          {
+          this->GetMesh()->DeepCopy(node->GetMesh());
+          }
         }
       else
         {
         vtkSmartPointer<vtkPointSet> newMesh
           = vtkSmartPointer<vtkPointSet>::Take(node->GetMesh()->NewInstance());
-        newMesh->DeepCopy(node->GetMesh());
+        if (shareMesh)
+          {
+          newMesh->ShallowCopy(node->GetMesh());
+          }
+        else
+          {
+          newMesh->DeepCopy(node->GetMesh());
+          }
         this->SetAndObserveMesh(newMesh);
         }
       }
@@ -191,8 +209,21 @@ void vtkMRMLModelNode::SetAndObserveMesh(vtkPointSet *mesh)
         vtkCommand::ModifiedEvent, this->DataEventForwarder);
       }
 
+    if (oldProducer && oldProducer == this->MeshProducer && this->DataEventForwarder
+      && oldProducer->GetOutputDataObject(0)
+      && strcmp(oldProducer->GetOutputDataObject(0)->GetClassName(), mesh->GetClassName()) == 0)
+      {
+      // Only swap the mesh in the producer, so that the mesh connection is kept.
+      // MeshModifiedEvent is invoked because the producer is modified.
+      mesh->AddObserver(vtkCommand::ModifiedEvent, this->DataEventForwarder);
+      oldProducer->SetOutput(mesh);
+      this->Modified();
+      return;
+      }
+
     vtkNew<vtkTrivialProducer> tp;
     tp->SetOutput(mesh);
+    this->MeshProducer = tp.GetPointer();
     // Propagate ModifiedEvent onto the trivial producer to make sure
     // MeshModifiedEvent is triggered.
     if (!this->DataEventForwarder)
@@ -715,13 +746,37 @@ void vtkMRMLModelNode::ApplyTransform(vtkAbstractTransform* transform)
     return;
     }
 
+  bool isInPipeline = !vtkTrivialProducer::SafeDownCast(
+     this->MeshConnection ? this->MeshConnection->GetProducer() : nullptr);
+
+  // Non-linear transforms are slow to evaluate, transform points (and normals)
+  // of the data object in parallel if there are no other vectors to transform.
+  vtkPointSet* mesh = this->GetMesh();
+  if (!isInPipeline && !vtkLinearTransform::SafeDownCast(transform) && mesh->GetPoints()
+    && !mesh->GetPointData()->GetVectors() && !mesh->GetCellData()->GetNormals() && !mesh->GetCellData()->GetVectors())
+    {
+    vtkNew<vtkPoints> transformedPoints;
+    transformedPoints->SetDataType(mesh->GetPoints()->GetDataType());
+    vtkDataArray* normals = mesh->GetPointData()->GetNormals();
+    vtkSmartPointer<vtkDataArray> transformedNormals;
+    if (normals)
+      {
+      transformedNormals = vtkSmartPointer<vtkDataArray>::Take(normals->NewInstance());
+      transformedNormals->SetName(normals->GetName());
+      }
+    vtkMRMLTransformNode::TransformPoints(transform, mesh->GetPoints(), transformedPoints, normals, transformedNormals);
+    mesh->SetPoints(transformedPoints);
+    if (normals)
+      {
+      mesh->GetPointData()->SetNormals(transformedNormals);
+      }
+    return;
+    }
+
   vtkTransformFilter* transformFilter = vtkTransformFilter::New();
   transformFilter->SetInputConnection(this->MeshConnection);
   transformFilter->SetTransform(transform);
 
-  bool isInPipeline = !vtkTrivialProducer::SafeDownCast(
-     this->MeshConnection ? this->MeshConnection->GetProducer() : nullptr);
-
   // If mesh was set through pipeline (SetMeshConnection), append
   // transform filter to that pipeline
   if (isInPipeline)
@@ -734,7 +789,6 @@ void vtkMRMLModelNode::ApplyTransform(vtkAbstractTransform* transform)
   else
     {
     transformFilter->Update();
-    vtkPointSet * mesh = this->GetMesh();
     mesh->DeepCopy(transformFilter->GetOutput());
     }
   transformFilter->Delete();
@@ -931,3 +985,43 @@ bool vtkMRMLModelNode::GetModifiedSinceRead()
   return this->Superclass::GetModifiedSinceRead() ||
     (this->GetMesh() && this->GetMesh()->GetMTime() > this->GetStoredTime());
 }
+
+//---------------------------------------------------------------------------
+vtkMTimeType vtkMRMLModelNode::GetContentMTime()
+{
+  vtkMTimeType mTime = this->Superclass::GetContentMTime();
+  if (this->GetMesh() && this->GetMesh()->GetMTime() > mTime)
+    {
+    mTime = this->GetMesh()->GetMTime();
+    }
+  return mTime;
+}
+
+//---------------------------------------------------------------------------
+bool vtkMRMLModelNode::IsContentMTimeTracked()
+{
+  return true;
+}
+
+//---------------------------------------------------------------------------
+unsigned long vtkMRMLModelNode::GetContentMemorySize()
+{
+  unsigned long size = this->Superclass::GetContentMemorySize();
+  if (this->GetMesh())
+    {
+    size += this->GetMesh()->GetActualMemorySize();
+    }
+  return size;
+}
+
+//---------------------------------------------------------------------------
+bool vtkMRMLModelNode::IsBulkDataShared()
+{
+  return vtkMRMLNode::IsDataObjectShared(this->GetMesh());
+}
+
+//---------------------------------------------------------------------------
+bool vtkMRMLModelNode::DetachSharedBulkData()
+{
+  return vtkMRMLNode::DetachSharedDataObject(this->GetMesh());
+}
@@ -21,6 +21,7 @@ class vtkMRMLModelDisplayNode;
 class vtkMRMLStorageNode;
 
 // VTK includes
+#include <vtkWeakPointer.h>
 class vtkAlgorithmOutput;
 class vtkAssignAttributes;
 class vtkEventForwarderCommand;
@@ -28,6 +29,7 @@ class vtkDataArray;
 class vtkPointSet;
 class vtkPolyData;
 class vtkTransformFilter;
+class vtkTrivialProducer;
 class vtkUnstructuredGrid;
 class vtkMRMLDisplayNode;
 
@@ -68,6 +70,9 @@ public:
   vtkMRMLModelDisplayNode* GetModelDisplayNode();
 
   /// Set and observe mesh for this model.
+  /// If the current mesh was also set by this method and it is of the same type then
+  /// only the output of the producer is replaced: the mesh connection does not change,
+  /// therefore downstream pipelines are not reconnected, they just get new input data.
   /// \sa GetMesh()
   virtual void SetAndObserveMesh(vtkPointSet *Mesh);
 
@@ -251,6 +256,16 @@ public:
   /// \sa vtkMRMLStorableNode::GetModifiedSinceRead()
   bool GetModifiedSinceRead() override;
 
+  /// Take into account the mesh modification time and size.
+  vtkMTimeType GetContentMTime() override;
+  bool IsContentMTimeTracked() override;
+  unsigned long GetContentMemorySize() override;
+
+  /// Check and detach mesh arrays shared with deep copies.
+  /// \sa vtkMRMLScene::SetCopyOnWriteBulkData
+  bool IsBulkDataShared() override;
+  bool DetachSharedBulkData() override;
+
 protected:
   vtkMRMLModelNode();
   ~vtkMRMLModelNode() override;
@@ -284,6 +299,8 @@ protected:
   /// Data
   vtkAlgorithmOutput* MeshConnection;
   vtkEventForwarderCommand* DataEventForwarder;
+  /// Producer created by SetAndObserveMesh, its output can be replaced
+  vtkWeakPointer<vtkTrivialProducer> MeshProducer;
   MeshTypeHint MeshType;
 };
 
@@ -12,6 +12,8 @@
 
 =========================================================================auto=*/
 
+#include "vtkBinaryMeshReader.h"
+#include "vtkBinaryMeshWriter.h"
 #include "vtkMRMLDisplayNode.h"
 #include "vtkMRMLModelNode.h"
 #include "vtkMRMLModelStorageNode.h"
@@ -95,6 +97,7 @@ vtkMRMLModelStorageNode::vtkMRMLModelStorageNode()
 {
   this->DefaultWriteFileExtension = "vtk";
   this->CoordinateSystem = vtkMRMLStorageNode::CoordinateSystemLPS;
+  this->PrefetchedCoordinateSystem = -1;
 }
 
 //----------------------------------------------------------------------------
@@ -150,6 +153,21 @@ bool vtkMRMLModelStorageNode::CanReadInReferenceNode(vtkMRMLNode *refNode)
   return refNode->IsA("vtkMRMLModelNode");
 }
 
+//----------------------------------------------------------------------------
+vtkMRMLNode* vtkMRMLModelStorageNode::CreateWriteDataSnapshot(vtkMRMLNode* refNode)
+{
+  if (!this->CanWriteFromReferenceNode(refNode))
+    {
+    return nullptr;
+    }
+  std::string extension = vtkMRMLStorageNode::GetLowercaseExtensionFromFileName(this->GetFileName() ? this->GetFileName() : "");
+  if (extension == ".obj")
+    {
+    return nullptr;
+    }
+  return this->CreateContentSnapshot(refNode);
+}
+
 //----------------------------------------------------------------------------
 int vtkMRMLModelStorageNode::ReadDataInternal(vtkMRMLNode *refNode)
 {
@@ -192,6 +210,83 @@ int vtkMRMLModelStorageNode::ReadDataInternal(vtkMRMLNode *refNode)
 
   int coordinateSystemInFileHeader = -1;
   vtkSmartPointer<vtkPointSet> meshFromFile;
+  if (this->PrefetchedMesh && this->PrefetchedFileName == fullName)
+    {
+    // the mesh was already read by PrefetchData()
+    meshFromFile = this->PrefetchedMesh;
+    coordinateSystemInFileHeader = this->PrefetchedCoordinateSystem;
+    this->LastIODecompressionTime += this->PrefetchedDecompressionTime;
+    this->ClearPrefetchedData();
+    }
+  else
+    {
+    this->ClearPrefetchedData();
+    if (!this->ReadMeshFromFile(fullName, extension, meshFromFile, coordinateSystemInFileHeader))
+      {
+      return 0;
+      }
+    }
+
+  if (coordinateSystemInFileHeader >= 0)
+    {
+    // coordinate system specified in the file, use it (regardless oassumingf what was the preferred coordinate system in the node)
+    this->CoordinateSystem = coordinateSystemInFileHeader;
+    }
+  else
+    {
+    // no coordinate system in the file, use the currently set coordinate system
+    vtkInfoMacro("ReadDataInternal (" << (this->ID ? this->ID : "(unknown)") << "): File "
+      << fullName.c_str() << " does not contain coordinate system information. Assuming "
+      << vtkMRMLStorageNode::GetCoordinateSystemTypeAsString(this->CoordinateSystem) << ".");
+    }
+
+  vtkSmartPointer<vtkPointSet> meshToSetInNode;
+  if (this->CoordinateSystem == vtkMRMLStorageNode::CoordinateSystemRAS)
+    {
+    // no flip of first two axes
+    meshToSetInNode = meshFromFile;
+    }
+  else
+    {
+    // transform from RAS to LPS
+    if (meshFromFile->IsA("vtkPolyData"))
+      {
+      meshToSetInNode = vtkSmartPointer<vtkPolyData>::New();
+      }
+    else
+      {
+      meshToSetInNode = vtkSmartPointer<vtkUnstructuredGrid>::New();
+      }
+    vtkMRMLModelStorageNode::ConvertBetweenRASAndLPS(meshFromFile, meshToSetInNode);
+    }
+  modelNode->SetAndObserveMesh(meshToSetInNode);
+
+  if (modelNode->GetMesh() != nullptr)
+    {
+    for (int i=0; i<modelNode->GetNumberOfDisplayNodes(); ++i)
+      {
+      vtkMRMLDisplayNode* displayNode = modelNode->GetNthDisplayNode(i);
+      // is there an active scalar array?
+      if (displayNode && displayNode->GetScalarRangeFlag() == vtkMRMLDisplayNode::UseDataScalarRange)
+        {
+        double *scalarRange = modelNode->GetMesh()->GetScalarRange();
+        if (scalarRange)
+          {
+          vtkDebugMacro("ReadDataInternal (" << (this->ID ? this->ID : "(unknown)") << "): setting scalar range " << scalarRange[0] << ", " << scalarRange[1]);
+          displayNode->SetScalarRange(scalarRange);
+          }
+        }
+      } // For all display nodes
+    }
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkMRMLModelStorageNode::ReadMeshFromFile(const std::string& fullName, const std::string& extension,
+  vtkSmartPointer<vtkPointSet>& meshFromFile, int& coordinateSystemInFileHeader)
+{
+  coordinateSystemInFileHeader = -1;
+  meshFromFile = nullptr;
   try
     {
     if (extension == std::string(".g") || extension == std::string(".byu"))
@@ -262,6 +357,15 @@ int vtkMRMLModelStorageNode::ReadDataInternal(vtkMRMLNode *refNode)
       meshFromFile = reader->GetOutput();
       coordinateSystemInFileHeader = vtkMRMLModelStorageNode::GetCoordinateSystemFromFieldData(meshFromFile);
       }
+    else if (extension == std::string(".bmesh"))
+      {
+      vtkNew<vtkBinaryMeshReader> reader;
+      reader->SetFileName(fullName.c_str());
+      reader->Update();
+      meshFromFile = reader->GetOutput();
+      coordinateSystemInFileHeader = vtkMRMLModelStorageNode::GetCoordinateSystemFromFileHeader(reader->GetHeader());
+      this->LastIODecompressionTime += reader->GetDecompressionTime();
+      }
     else if (extension == std::string(".stl"))
       {
       vtkNew<vtkSTLReader> reader;
@@ -366,59 +470,49 @@ int vtkMRMLModelStorageNode::ReadDataInternal(vtkMRMLNode *refNode)
     vtkErrorMacro("ReadDataInternal (" << (this->ID ? this->ID : "(unknown)") << "): unknown exception while trying to read file: " << fullName.c_str());
     return 0;
     }
+  return 1;
+}
 
-  if (coordinateSystemInFileHeader >= 0)
+//----------------------------------------------------------------------------
+bool vtkMRMLModelStorageNode::PrefetchData(vtkMRMLNode* refNode)
+{
+  this->ClearPrefetchedData();
+  if (!refNode || !this->CanReadInReferenceNode(refNode)
+    || this->GetWriteState() == SkippedNoData)
     {
-    // coordinate system specified in the file, use it (regardless oassumingf what was the preferred coordinate system in the node)
-    this->CoordinateSystem = coordinateSystemInFileHeader;
+    return false;
     }
-  else
+  std::string fullName = this->GetFullNameFromFileName();
+  if (fullName.empty() || !vtksys::SystemTools::FileExists(fullName.c_str()))
     {
-    // no coordinate system in the file, use the currently set coordinate system
-    vtkInfoMacro("ReadDataInternal (" << (this->ID ? this->ID : "(unknown)") << "): File "
-      << fullName.c_str() << " does not contain coordinate system information. Assuming "
-      << vtkMRMLStorageNode::GetCoordinateSystemTypeAsString(this->CoordinateSystem) << ".");
+    return false;
     }
-
-  vtkSmartPointer<vtkPointSet> meshToSetInNode;
-  if (this->CoordinateSystem == vtkMRMLStorageNode::CoordinateSystemRAS)
+  std::string extension = vtkMRMLStorageNode::GetLowercaseExtensionFromFileName(fullName);
+  if (extension.empty())
     {
-    // no flip of first two axes
-    meshToSetInNode = meshFromFile;
+    return false;
     }
-  else
+  vtkSmartPointer<vtkPointSet> mesh;
+  int coordinateSystemInFileHeader = -1;
+  this->LastIODecompressionTime = 0.0;
+  if (!this->ReadMeshFromFile(fullName, extension, mesh, coordinateSystemInFileHeader) || !mesh)
     {
-    // transform from RAS to LPS
-    if (meshFromFile->IsA("vtkPolyData"))
-      {
-      meshToSetInNode = vtkSmartPointer<vtkPolyData>::New();
-      }
-    else
-      {
-      meshToSetInNode = vtkSmartPointer<vtkUnstructuredGrid>::New();
-      }
-    vtkMRMLModelStorageNode::ConvertBetweenRASAndLPS(meshFromFile, meshToSetInNode);
+    return false;
     }
-  modelNode->SetAndObserveMesh(meshToSetInNode);
+  this->PrefetchedDecompressionTime = this->LastIODecompressionTime;
+  this->PrefetchedFileName = fullName;
+  this->PrefetchedMesh = mesh;
+  this->PrefetchedCoordinateSystem = coordinateSystemInFileHeader;
+  return true;
+}
 
-  if (modelNode->GetMesh() != nullptr)
-    {
-    for (int i=0; i<modelNode->GetNumberOfDisplayNodes(); ++i)
-      {
-      vtkMRMLDisplayNode* displayNode = modelNode->GetNthDisplayNode(i);
-      // is there an active scalar array?
-      if (displayNode && displayNode->GetScalarRangeFlag() == vtkMRMLDisplayNode::UseDataScalarRange)
-        {
-        double *scalarRange = modelNode->GetMesh()->GetScalarRange();
-        if (scalarRange)
-          {
-          vtkDebugMacro("ReadDataInternal (" << (this->ID ? this->ID : "(unknown)") << "): setting scalar range " << scalarRange[0] << ", " << scalarRange[1]);
-          displayNode->SetScalarRange(scalarRange);
-          }
-        }
-      } // For all display nodes
-    }
-  return 1;
+//----------------------------------------------------------------------------
+void vtkMRMLModelStorageNode::ClearPrefetchedData()
+{
+  this->PrefetchedFileName.clear();
+  this->PrefetchedMesh = nullptr;
+  this->PrefetchedCoordinateSystem = -1;
+  this->PrefetchedDecompressionTime = 0.0;
 }
 
 //----------------------------------------------------------------------------
@@ -557,6 +651,24 @@ int vtkMRMLModelStorageNode::WriteDataInternal(vtkMRMLNode *refNode)
       }
 
     }
+  else if (extension == ".bmesh" && modelNode->GetMeshType() == vtkMRMLModelNode::PolyDataMeshType)
+    {
+    vtkNew<vtkBinaryMeshWriter> writer;
+    writer->SetFileName(fullName.c_str());
+    writer->SetUseCompression(this->GetUseCompression());
+    writer->SetInputData(meshToWrite);
+    std::string header = std::string("3D Slicer output. ") + coordinateSytemSpecification;
+    writer->SetHeader(header.c_str());
+    try
+      {
+      writer->Write();
+      result = (writer->GetWriteError() ? 0 : 1);
+      }
+    catch (...)
+      {
+      result = 0;
+      }
+    }
   else if (extension == ".stl")
     {
     vtkNew<vtkTriangleFilter> triangulator;
@@ -664,6 +776,7 @@ void vtkMRMLModelStorageNode::InitializeSupportedReadFileTypes()
   this->SupportedReadFileTypes->InsertNextValue("PLY (.ply)");
   this->SupportedReadFileTypes->InsertNextValue("UCD (.ucd)");
   this->SupportedReadFileTypes->InsertNextValue("Wavefront OBJ (.obj)");
+  this->SupportedReadFileTypes->InsertNextValue("Slicer Binary Mesh (.bmesh)");
 }
 
 //----------------------------------------------------------------------------
@@ -681,6 +794,7 @@ void vtkMRMLModelStorageNode::InitializeSupportedWriteFileTypes()
     this->SupportedWriteFileTypes->InsertNextValue("STL (.stl)");
     this->SupportedWriteFileTypes->InsertNextValue("PLY (.ply)");
     this->SupportedWriteFileTypes->InsertNextValue("Wavefront OBJ (.obj)");
+    this->SupportedWriteFileTypes->InsertNextValue("Slicer Binary Mesh (.bmesh)");
     }
   if (!modelNode || modelNode->GetMeshType() == vtkMRMLModelNode::UnstructuredGridMeshType)
     {
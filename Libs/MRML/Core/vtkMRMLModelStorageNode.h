@@ -51,6 +51,14 @@ public:
   static const char* GetCoordinateSystemAsString(int id);
   static int GetCoordinateSystemFromString(const char* name);
 
+  /// Read the mesh from file, it is set in the model node by the next ReadData() call.
+  bool PrefetchData(vtkMRMLNode* refNode) override;
+  void ClearPrefetchedData() override;
+
+  /// Models can be written in the background from a copy of the model node,
+  /// except in OBJ format, which reads material properties from the display node.
+  vtkMRMLNode* CreateWriteDataSnapshot(vtkMRMLNode* refNode) override;
+
 protected:
   vtkMRMLModelStorageNode();
   ~vtkMRMLModelStorageNode() override;
@@ -78,7 +86,19 @@ protected:
 
   static int GetCoordinateSystemFromFieldData(vtkPointSet* mesh);
 
+  /// Read the mesh from a file, without modifying the MRML state.
+  /// coordinateSystemInFileHeader is set to -1 if the file does not specify it.
+  /// Return 1 on success, 0 on failure.
+  int ReadMeshFromFile(const std::string& fullName, const std::string& extension,
+                       vtkSmartPointer<vtkPointSet>& meshFromFile, int& coordinateSystemInFileHeader);
+
   int CoordinateSystem;
+
+  /// Content read by PrefetchData()
+  std::string PrefetchedFileName;
+  vtkSmartPointer<vtkPointSet> PrefetchedMesh;
+  int PrefetchedCoordinateSystem;
+  double PrefetchedDecompressionTime{0.0};
 };
 
 #endif
@@ -18,9 +18,15 @@ Version:   $Revision: 1.11 $
 
 // VTK includes
 #include <vtkCallbackCommand.h>
+#include <vtkCellArray.h>
+#include <vtkCellData.h>
 #include <vtkNew.h>
 #include <vtkObjectFactory.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
 #include <vtkStringArray.h>
+#include <vtkUnstructuredGrid.h>
 
 // VTKSYS includes
 #include <vtksys/SystemTools.hxx>
@@ -920,11 +926,43 @@ void vtkMRMLNode::SetID (const char* _arg)
     {
     this->ID = nullptr;
     }
+  if (this->Scene)
+    {
+    this->Scene->NodeIDChanged(this, oldID);
+    }
   this->InvokeEvent(vtkMRMLNode::IDChangedEvent, oldID);
   if (oldID) { delete [] oldID; }
   this->Modified();
 }
 
+//----------------------------------------------------------------------------
+void vtkMRMLNode::SetName(const char* _arg)
+{
+  // Mostly copied from vtkSetStringMacro() in vtkSetGet.cxx
+  vtkDebugMacro(<< this->GetClassName() << " (" << this << "): setting Name to " << (_arg?_arg:"(null)") );
+  if ( this->Name == nullptr && _arg == nullptr) { return;}
+  if ( this->Name && _arg && (!strcmp(this->Name,_arg))) { return;}
+  char* oldName = this->Name;
+  if (_arg)
+    {
+    size_t n = strlen(_arg) + 1;
+    char *cp1 =  new char[n];
+    const char *cp2 = (_arg);
+    this->Name = cp1;
+    do { *cp1++ = *cp2++; } while ( --n );
+    }
+   else
+    {
+    this->Name = nullptr;
+    }
+  if (this->Scene)
+    {
+    this->Scene->NodeNameChanged(this, oldName);
+    }
+  if (oldName) { delete [] oldName; }
+  this->Modified();
+}
+
 //----------------------------------------------------------------------------
 const char * vtkMRMLNode::URLEncodeString(const char *inString)
 {
@@ -1776,3 +1814,112 @@ bool vtkMRMLNode::HasCopyContent() const
   // in the header.
   return strcmp("vtkMRMLNode", this->GetClassNameInternal()) == 0;
 }
+
+//----------------------------------------------------------------------------
+vtkMTimeType vtkMRMLNode::GetContentMTime()
+{
+  return this->GetMTime();
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLNode::IsContentMTimeTracked()
+{
+  return false;
+}
+
+//----------------------------------------------------------------------------
+unsigned long vtkMRMLNode::GetContentMemorySize()
+{
+  // attributes, references and other small properties
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLNode::IsBulkDataShared()
+{
+  return false;
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLNode::DetachSharedBulkData()
+{
+  return false;
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLNode::GetCopyOnWriteBulkData(vtkMRMLNode* sourceNode)
+{
+  return (this->Scene && this->Scene->GetCopyOnWriteBulkData())
+    || (sourceNode && sourceNode->GetScene() && sourceNode->GetScene()->GetCopyOnWriteBulkData());
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLNode::IsDataObjectShared(vtkDataObject* dataObject)
+{
+  if (!dataObject)
+    {
+    return false;
+    }
+  // Data objects made by ShallowCopy reference the same arrays, points and cells
+  std::vector<vtkObjectBase*> contents;
+  vtkDataSet* dataSet = vtkDataSet::SafeDownCast(dataObject);
+  vtkFieldData* fieldDatas[3] = { dataObject->GetFieldData(),
+    dataSet ? dataSet->GetPointData() : nullptr, dataSet ? dataSet->GetCellData() : nullptr };
+  for (int fieldDataIndex = 0; fieldDataIndex < 3; ++fieldDataIndex)
+    {
+    vtkFieldData* fieldData = fieldDatas[fieldDataIndex];
+    for (int arrayIndex = 0; fieldData && arrayIndex < fieldData->GetNumberOfArrays(); ++arrayIndex)
+      {
+      contents.push_back(fieldData->GetAbstractArray(arrayIndex));
+      }
+    }
+  vtkPointSet* pointSet = vtkPointSet::SafeDownCast(dataObject);
+  if (pointSet && pointSet->GetPoints())
+    {
+    contents.push_back(pointSet->GetPoints()->GetData());
+    }
+  std::vector<vtkCellArray*> cellArrays;
+  vtkPolyData* polyData = vtkPolyData::SafeDownCast(dataObject);
+  if (polyData)
+    {
+    cellArrays.push_back(polyData->GetVerts());
+    cellArrays.push_back(polyData->GetLines());
+    cellArrays.push_back(polyData->GetPolys());
+    cellArrays.push_back(polyData->GetStrips());
+    }
+  vtkUnstructuredGrid* unstructuredGrid = vtkUnstructuredGrid::SafeDownCast(dataObject);
+  if (unstructuredGrid)
+    {
+    cellArrays.push_back(unstructuredGrid->GetCells());
+    }
+  for (std::vector<vtkCellArray*>::iterator cellArrayIt = cellArrays.begin(); cellArrayIt != cellArrays.end(); ++cellArrayIt)
+    {
+    // empty cell arrays may be a dummy instance shared by all data sets
+    if (*cellArrayIt && (*cellArrayIt)->GetNumberOfCells() > 0)
+      {
+      contents.push_back(*cellArrayIt);
+      }
+    }
+  for (std::vector<vtkObjectBase*>::iterator contentIt = contents.begin(); contentIt != contents.end(); ++contentIt)
+    {
+    if (*contentIt && (*contentIt)->GetReferenceCount() > 1)
+      {
+      return true;
+      }
+    }
+  return false;
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLNode::DetachSharedDataObject(vtkDataObject* dataObject)
+{
+  if (!vtkMRMLNode::IsDataObjectShared(dataObject))
+    {
+    return false;
+    }
+  vtkSmartPointer<vtkDataObject> privateCopy = vtkSmartPointer<vtkDataObject>::Take(dataObject->NewInstance());
+  privateCopy->DeepCopy(dataObject);
+  // keep the same data object so that observers and pipelines are preserved
+  dataObject->ShallowCopy(privateCopy);
+  return true;
+}
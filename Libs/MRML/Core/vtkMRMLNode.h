@@ -23,6 +23,7 @@
 
 class vtkMRMLScene;
 class vtkStringArray;
+class vtkDataObject;
 
 // VTK includes
 #include <vtkObject.h>
@@ -375,6 +376,49 @@ public:
   vtkSetMacro(UndoEnabled, bool);
   vtkBooleanMacro(UndoEnabled, bool);
 
+  /// \brief Get the last time the node or its content was modified.
+  ///
+  /// The content includes bulk data (image, mesh...) that may be modified
+  /// without modifying the node. It is used by the scene to share a copy of
+  /// the node between undo states if the node has not changed in-between.
+  /// Subclasses storing bulk data should reimplement it.
+  /// \sa IsContentMTimeTracked()
+  virtual vtkMTimeType GetContentMTime();
+
+  /// \brief Return true if GetContentMTime() accounts for all the content
+  /// copied by Copy().
+  ///
+  /// The node MTime alone may miss content modified in place (arrays, lookup
+  /// tables, internal objects...). The scene only shares a copy of the node
+  /// between undo states if this returns true. Subclasses that reimplement
+  /// GetContentMTime() to cover all their content should return true.
+  /// Returns false by default.
+  virtual bool IsContentMTimeTracked();
+
+  /// \brief Approximate size of the node content in kibibytes (1024 bytes).
+  ///
+  /// It is used by the scene to limit the amount of memory used by the undo
+  /// stack. Subclasses storing bulk data should reimplement it.
+  /// \sa vtkMRMLScene::SetMaximumUndoStackMemorySize()
+  virtual unsigned long GetContentMemorySize();
+
+  /// \brief Return true if bulk data of this node is shared with another node.
+  ///
+  /// If vtkMRMLScene::CopyOnWriteBulkData is enabled, deep copies of bulk
+  /// data (image, mesh, segment representations) share the data arrays with
+  /// the source node until DetachSharedBulkData() is called.
+  /// Subclasses storing bulk data should reimplement it.
+  virtual bool IsBulkDataShared();
+
+  /// \brief Make sure bulk data of this node is not shared with another node.
+  ///
+  /// Must be called before modifying bulk data arrays in place (replacing the
+  /// data object is always safe). Shared arrays are copied into the existing
+  /// data objects, therefore observers and pipeline connections are kept.
+  /// Returns true if any data was copied.
+  /// Subclasses storing bulk data should reimplement it.
+  virtual bool DetachSharedBulkData();
+
   /// Propagate events generated in mrml.
   virtual void ProcessMRMLEvents ( vtkObject *caller, unsigned long event, void *callData );
 
@@ -391,8 +435,12 @@ public:
   vtkSetStringMacro(Description);
   vtkGetStringMacro(Description);
 
-  /// Name of this node, to be set by the user
-  vtkSetStringMacro(Name);
+  /// \brief Name of this node, to be set by the user
+  ///
+  /// The scene the node belongs to is notified of the change to keep
+  /// its name index up-to-date.
+  /// \sa vtkMRMLScene::NodeNameChanged()
+  virtual void SetName(const char* name);
   vtkGetStringMacro(Name);
 
   /// ID use by other nodes to reference this node in XML.
@@ -832,6 +880,19 @@ protected:
   static void MRMLCallback( vtkObject *caller,
                             unsigned long eid, void *clientData, void *callData );
 
+  /// Return true if a deep copy of \a sourceNode bulk data made by CopyContent
+  /// may share the data arrays instead of duplicating them.
+  /// \sa vtkMRMLScene::SetCopyOnWriteBulkData, DetachSharedBulkData
+  bool GetCopyOnWriteBulkData(vtkMRMLNode* sourceNode);
+
+  /// Return true if any data array of \a dataObject is referenced
+  /// by another data object.
+  static bool IsDataObjectShared(vtkDataObject* dataObject);
+
+  /// Replace the shared data arrays of \a dataObject by private copies.
+  /// Returns true if the data was copied.
+  static bool DetachSharedDataObject(vtkDataObject* dataObject);
+
   /// \brief Get/Set the string used to manage encoding/decoding of strings/URLs
   /// with special characters.
   vtkSetStringMacro( TempURLString );
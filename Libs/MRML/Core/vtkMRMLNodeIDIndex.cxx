@@ -0,0 +1,222 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2005 Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Program:   3D Slicer
+
+=========================================================================auto=*/
+
+// MRML includes
+#include "vtkMRMLNode.h"
+#include "vtkMRMLNodeIDIndex.h"
+
+// STD includes
+#include <cstring>
+
+namespace
+{
+/// Initial number of slots, must be a power of 2
+const size_t MinimumNumberOfSlots = 64;
+}
+
+//----------------------------------------------------------------------------
+vtkMRMLNodeIDIndex::vtkMRMLNodeIDIndex()
+  : NumberOfNodes(0)
+  , NumberOfRemovedSlots(0)
+{
+}
+
+//----------------------------------------------------------------------------
+vtkMRMLNodeIDIndex::~vtkMRMLNodeIDIndex()
+{
+  this->Clear();
+}
+
+//----------------------------------------------------------------------------
+size_t vtkMRMLNodeIDIndex::Hash(const char* id)
+{
+  // FNV-1a hash
+  size_t hash = static_cast<size_t>(2166136261u);
+  for (const unsigned char* c = reinterpret_cast<const unsigned char*>(id); *c; ++c)
+    {
+    hash ^= static_cast<size_t>(*c);
+    hash *= static_cast<size_t>(16777619u);
+    }
+  return hash;
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLNodeIDIndex::AddNode(vtkMRMLNode* node)
+{
+  if (!node || !node->GetID())
+    {
+    return;
+    }
+  // Keep the load factor (including removed slots) below 1/2
+  if ((this->NumberOfNodes + this->NumberOfRemovedSlots + 1) * 2 > this->Slots.size())
+    {
+    size_t numberOfSlots = this->Slots.empty() ? MinimumNumberOfSlots : this->Slots.size();
+    while ((this->NumberOfNodes + 1) * 2 > numberOfSlots)
+      {
+      numberOfSlots *= 2;
+      }
+    this->Rehash(numberOfSlots);
+    }
+
+  const char* id = node->GetID();
+  size_t hash = vtkMRMLNodeIDIndex::Hash(id);
+  size_t mask = this->Slots.size() - 1;
+  Slot* freeSlot = nullptr;
+  for (size_t i = hash & mask; ; i = (i + 1) & mask)
+    {
+    Slot& slot = this->Slots[i];
+    if (slot.Node)
+      {
+      if (slot.Hash == hash && (slot.Node == node || !strcmp(slot.Node->GetID(), id)))
+        {
+        // replace the node that has the same ID
+        if (slot.Node != node)
+          {
+          vtkMRMLNode* replacedNode = slot.Node;
+          node->Register(nullptr);
+          slot.Node = node;
+          replacedNode->UnRegister(nullptr);
+          }
+        return;
+        }
+      }
+    else if (slot.Removed)
+      {
+      if (!freeSlot)
+        {
+        freeSlot = &slot;
+        }
+      }
+    else
+      {
+      if (!freeSlot)
+        {
+        freeSlot = &slot;
+        }
+      break;
+      }
+    }
+  if (freeSlot->Removed)
+    {
+    --this->NumberOfRemovedSlots;
+    }
+  node->Register(nullptr);
+  freeSlot->Hash = hash;
+  freeSlot->Node = node;
+  freeSlot->Removed = false;
+  ++this->NumberOfNodes;
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLNodeIDIndex::RemoveNode(vtkMRMLNode* node, const char* id)
+{
+  if (!node || !id || this->NumberOfNodes == 0)
+    {
+    return false;
+    }
+  size_t hash = vtkMRMLNodeIDIndex::Hash(id);
+  size_t mask = this->Slots.size() - 1;
+  for (size_t i = hash & mask; ; i = (i + 1) & mask)
+    {
+    Slot& slot = this->Slots[i];
+    if (slot.Node == node && slot.Hash == hash)
+      {
+      slot.Node = nullptr;
+      slot.Removed = true;
+      --this->NumberOfNodes;
+      ++this->NumberOfRemovedSlots;
+      node->UnRegister(nullptr);
+      return true;
+      }
+    if (!slot.Node && !slot.Removed)
+      {
+      return false;
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+vtkMRMLNode* vtkMRMLNodeIDIndex::GetNode(const char* id)const
+{
+  if (!id || this->NumberOfNodes == 0)
+    {
+    return nullptr;
+    }
+  const Slot* slot = this->FindSlot(id, vtkMRMLNodeIDIndex::Hash(id));
+  return slot ? slot->Node : nullptr;
+}
+
+//----------------------------------------------------------------------------
+const vtkMRMLNodeIDIndex::Slot* vtkMRMLNodeIDIndex::FindSlot(const char* id, size_t hash)const
+{
+  size_t mask = this->Slots.size() - 1;
+  for (size_t i = hash & mask; ; i = (i + 1) & mask)
+    {
+    const Slot& slot = this->Slots[i];
+    if (slot.Node)
+      {
+      if (slot.Hash == hash && !strcmp(slot.Node->GetID(), id))
+        {
+        return &slot;
+        }
+      }
+    else if (!slot.Removed)
+      {
+      return nullptr;
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLNodeIDIndex::Clear()
+{
+  // Release the references after the table is reset, in case a node
+  // deletion accesses the index.
+  std::vector<Slot> slots;
+  slots.swap(this->Slots);
+  this->NumberOfNodes = 0;
+  this->NumberOfRemovedSlots = 0;
+  for (std::vector<Slot>::const_iterator slotIt = slots.begin(); slotIt != slots.end(); ++slotIt)
+    {
+    if (slotIt->Node)
+      {
+      slotIt->Node->UnRegister(nullptr);
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+size_t vtkMRMLNodeIDIndex::GetNumberOfNodes()const
+{
+  return this->NumberOfNodes;
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLNodeIDIndex::Rehash(size_t numberOfSlots)
+{
+  std::vector<Slot> oldSlots(numberOfSlots);
+  oldSlots.swap(this->Slots);
+  this->NumberOfRemovedSlots = 0;
+  size_t mask = numberOfSlots - 1;
+  for (std::vector<Slot>::const_iterator oldSlotIt = oldSlots.begin(); oldSlotIt != oldSlots.end(); ++oldSlotIt)
+    {
+    if (!oldSlotIt->Node)
+      {
+      continue;
+      }
+    size_t i = oldSlotIt->Hash & mask;
+    while (this->Slots[i].Node)
+      {
+      i = (i + 1) & mask;
+      }
+    this->Slots[i] = *oldSlotIt;
+    }
+}
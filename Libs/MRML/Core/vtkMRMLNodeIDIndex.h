@@ -0,0 +1,94 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2005 Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Program:   3D Slicer
+
+=========================================================================auto=*/
+
+#ifndef __vtkMRMLNodeIDIndex_h
+#define __vtkMRMLNodeIDIndex_h
+
+// MRML includes
+#include "vtkMRML.h"
+
+// STD includes
+#include <cstddef>
+#include <vector>
+
+class vtkMRMLNode;
+
+/// \brief Hash table used by vtkMRMLScene to find nodes by ID.
+///
+/// The table uses open addressing with linear probing. IDs are not copied:
+/// each slot keeps the hash of the ID and a pointer to the node, the ID string
+/// owned by the node is used as the key. Therefore the index must be notified
+/// (RemoveNode() then AddNode()) when the ID of an indexed node is changed.
+///
+/// Indexed nodes are referenced by the index (as the std::map of smart
+/// pointers used before), so an entry never points to a deleted node even if
+/// the node is indexed without being in the scene collection (e.g. nodes
+/// shared by scene view snapshot scenes).
+class VTK_MRML_EXPORT vtkMRMLNodeIDIndex
+{
+public:
+  vtkMRMLNodeIDIndex();
+  ~vtkMRMLNodeIDIndex();
+
+  /// Index \a node by its current ID. If a node is already indexed with the
+  /// same ID, it is replaced by \a node.
+  /// Nodes without ID are ignored.
+  void AddNode(vtkMRMLNode* node);
+
+  /// Remove \a node from the index. \a id is the ID the node was indexed with,
+  /// it may be different from the current ID of the node.
+  /// Returns true if the node was found in the index.
+  /// The reference held by the index is released, the node may be deleted
+  /// if the caller does not keep a reference.
+  bool RemoveNode(vtkMRMLNode* node, const char* id);
+
+  /// Return the node indexed with \a id, nullptr if none.
+  vtkMRMLNode* GetNode(const char* id)const;
+
+  /// Remove all the nodes from the index.
+  void Clear();
+
+  /// Number of nodes in the index.
+  size_t GetNumberOfNodes()const;
+
+  /// Hash function used for the IDs.
+  static size_t Hash(const char* id);
+
+protected:
+  vtkMRMLNodeIDIndex(const vtkMRMLNodeIDIndex&) = delete;
+  void operator=(const vtkMRMLNodeIDIndex&) = delete;
+
+  struct Slot
+  {
+    Slot() : Hash(0), Node(nullptr), Removed(false) {}
+    size_t Hash;
+    /// nullptr if the slot is empty or removed, referenced otherwise
+    vtkMRMLNode* Node;
+    /// true if a node has been removed from the slot, the slot
+    /// can be reused but probing must continue after it.
+    bool Removed;
+  };
+
+  /// Return the slot containing \a id or nullptr if not found.
+  const Slot* FindSlot(const char* id, size_t hash)const;
+
+  /// Resize the table to \a numberOfSlots (must be a power of 2) and
+  /// re-insert all the nodes. Removed slots are discarded.
+  void Rehash(size_t numberOfSlots);
+
+  std::vector<Slot> Slots;
+  /// Number of slots containing a node
+  size_t NumberOfNodes;
+  /// Number of slots marked as removed
+  size_t NumberOfRemovedSlots;
+};
+
+#endif
@@ -25,6 +25,7 @@ Version:   $Revision: 1.8 $
 // VTK includes
 #include <vtkCollection.h>
 #include <vtkObjectFactory.h>
+#include <vtkSMPTools.h>
 #include <vtkStdString.h>
 
 // STD includes
@@ -33,8 +34,44 @@ Version:   $Revision: 1.8 $
 //------------------------------------------------------------------------------
 vtkStandardNewMacro(vtkMRMLParser);
 
+namespace
+{
+//------------------------------------------------------------------------------
+/// Build a null-terminated attribute array pointing into \a attributes.
+void GetAttributePointers(const std::vector<std::string>& attributes,
+                          std::vector<const char*>& atts)
+{
+  atts.clear();
+  atts.reserve(attributes.size() + 1);
+  for (std::vector<std::string>::const_iterator it = attributes.begin(); it != attributes.end(); ++it)
+    {
+    atts.push_back(it->c_str());
+    }
+  atts.push_back(nullptr);
+}
+}
+
 //------------------------------------------------------------------------------
 void vtkMRMLParser::StartElement(const char* tagName, const char** atts)
+{
+  if (this->DeferNodeCreation)
+    {
+    DeferredElement element;
+    element.Start = true;
+    element.TagName = tagName;
+    while (atts && *atts != nullptr)
+      {
+      element.Attributes.push_back(*(atts++));
+      }
+    this->DeferredElements.push_back(element);
+    return;
+    }
+  this->ProcessStartElement(tagName, atts);
+}
+
+//------------------------------------------------------------------------------
+void vtkMRMLParser::ProcessStartElement(const char* tagName, const char** atts,
+                                        vtkMRMLNode* node, bool attributesRead)
 {
   if (!strcmp(tagName, "MRML"))
     {
@@ -114,37 +151,29 @@ void vtkMRMLParser::StartElement(const char* tagName, const char** atts)
     return;
     }
 
-  const char* tmp = this->MRMLScene->GetClassNameByTag(tagName);
-  std::string className = tmp ? tmp : "";
-
-  // CreateNodeByClass should have a chance to instantiate non-registered node
-  if (className.empty())
+  if (!node)
     {
-    className = "vtkMRML";
-    className += tagName;
-    // Append 'Node' prefix only if required
-    if (className.find("Node") != className.size() - 4)
+    std::string className = this->GetNodeClassNameByTag(tagName);
+    node = this->MRMLScene->CreateNodeByClass( className.c_str() );
+    if (!node)
       {
-      className += "Node";
+      vtkWarningMacro(<< "Failed to CreateNodeByClass: " << className);
+      return;
       }
     }
 
-  vtkMRMLNode* node = this->MRMLScene->CreateNodeByClass( className.c_str() );
-  if (!node)
+  if (!attributesRead)
     {
-    vtkWarningMacro(<< "Failed to CreateNodeByClass: " << className);
-    return;
-    }
+    // It is needed to have the scene set before ReadXMLAttributes is
+    // called on storage nodes.
+    if (vtkMRMLStorageNode::SafeDownCast(node) != nullptr)
+      {
+      node->SetScene(this->GetMRMLScene());
+      }
 
-  // It is needed to have the scene set before ReadXMLAttributes is
-  // called on storage nodes.
-  if (vtkMRMLStorageNode::SafeDownCast(node) != nullptr)
-    {
-    node->SetScene(this->GetMRMLScene());
+    node->ReadXMLAttributes(atts);
     }
 
-  node->ReadXMLAttributes(atts);
-
   // Slicer3 snap shot nodes were hidden by default, show them so that
   // they show up in the tree views
 #if MRML_SUPPORT_VERSION < 0x040000
@@ -216,9 +245,43 @@ void vtkMRMLParser::StartElement(const char* tagName, const char** atts)
   node->Delete();
 }
 
+//------------------------------------------------------------------------------
+std::string vtkMRMLParser::GetNodeClassNameByTag(const char* tagName)
+{
+  const char* tmp = this->MRMLScene->GetClassNameByTag(tagName);
+  std::string className = tmp ? tmp : "";
+
+  // CreateNodeByClass should have a chance to instantiate non-registered node
+  if (className.empty())
+    {
+    className = "vtkMRML";
+    className += tagName;
+    // Append 'Node' prefix only if required
+    if (className.find("Node") != className.size() - 4)
+      {
+      className += "Node";
+      }
+    }
+  return className;
+}
+
 //-----------------------------------------------------------------------------
 
 void vtkMRMLParser::EndElement(const char *name)
+{
+  if (this->DeferNodeCreation)
+    {
+    DeferredElement element;
+    element.Start = false;
+    element.TagName = name;
+    this->DeferredElements.push_back(element);
+    return;
+    }
+  this->ProcessEndElement(name);
+}
+
+//-----------------------------------------------------------------------------
+void vtkMRMLParser::ProcessEndElement(const char *name)
 {
   if ( !strcmp(name, "MRML") || this->NodeStack.empty() )
     {
@@ -245,3 +308,83 @@ void vtkMRMLParser::EndElement(const char *name)
 
   this->NodeStack.pop();
 }
+
+//-----------------------------------------------------------------------------
+void vtkMRMLParser::ProcessDeferredElements()
+{
+  if (this->DeferredElements.empty())
+    {
+    return;
+    }
+  if (!this->MRMLScene)
+    {
+    vtkErrorMacro("ProcessDeferredElements: no scene");
+    this->DeferredElements.clear();
+    return;
+    }
+
+  // Collect the elements that describe a node. Class names are resolved here
+  // so that worker threads only query the scene for node instantiation.
+  std::vector<DeferredElement*> nodeElements;
+  for (std::vector<DeferredElement>::iterator it = this->DeferredElements.begin();
+       it != this->DeferredElements.end(); ++it)
+    {
+    if (!it->Start
+      || it->TagName == "MRML"
+      || it->TagName == "SubjectHierarchyItem")
+      {
+      continue;
+      }
+    it->ClassName = this->GetNodeClassNameByTag(it->TagName.c_str());
+    nodeElements.push_back(&(*it));
+    }
+
+  // Nodes are not in the scene yet and have no scene set: they can be
+  // instantiated and read their attributes independently of each other.
+  vtkMRMLScene* scene = this->MRMLScene;
+  auto createNodes = [scene, &nodeElements](vtkIdType begin, vtkIdType end)
+    {
+    std::vector<const char*> atts;
+    for (vtkIdType i = begin; i < end; ++i)
+      {
+      DeferredElement* element = nodeElements[i];
+      element->Node = scene->CreateNodeByClass(element->ClassName.c_str());
+      if (!element->Node || vtkMRMLStorageNode::SafeDownCast(element->Node) != nullptr)
+        {
+        continue;
+        }
+      GetAttributePointers(element->Attributes, atts);
+      element->Node->ReadXMLAttributes(&atts[0]);
+      element->AttributesRead = true;
+      }
+    };
+  vtkSMPTools::For(0, static_cast<vtkIdType>(nodeElements.size()), createNodes);
+
+  // Add the nodes in document order on the calling thread.
+  std::vector<const char*> atts;
+  for (std::vector<DeferredElement>::iterator it = this->DeferredElements.begin();
+       it != this->DeferredElements.end(); ++it)
+    {
+    if (!it->Start)
+      {
+      this->ProcessEndElement(it->TagName.c_str());
+      continue;
+      }
+    GetAttributePointers(it->Attributes, atts);
+    if (it->Node)
+      {
+      this->ProcessStartElement(it->TagName.c_str(), &atts[0], it->Node, it->AttributesRead);
+      it->Node = nullptr;
+      }
+    else if (it->ClassName.empty())
+      {
+      // MRML or SubjectHierarchyItem element
+      this->ProcessStartElement(it->TagName.c_str(), &atts[0]);
+      }
+    else
+      {
+      vtkWarningMacro(<< "Failed to CreateNodeByClass: " << it->ClassName);
+      }
+    }
+  this->DeferredElements.clear();
+}
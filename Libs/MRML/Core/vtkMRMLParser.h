@@ -20,6 +20,8 @@ class vtkCollection;
 
 // STD includes
 #include <stack>
+#include <string>
+#include <vector>
 
 /// \brief Parse XML scene file.
 class VTK_MRML_EXPORT vtkMRMLParser : public vtkXMLParser
@@ -34,6 +36,23 @@ public:
   vtkCollection* GetNodeCollection() {return this->NodeCollection;};
   void SetNodeCollection(vtkCollection* scene) {this->NodeCollection = scene;};
 
+  /// If enabled, elements are only recorded while parsing and nodes are
+  /// created when ProcessDeferredElements() is called. Node instantiation
+  /// and ReadXMLAttributes then run in parallel (using vtkSMPTools), while
+  /// the nodes are still added to the scene in document order on the
+  /// calling thread, so observers see the same sequence of events.
+  /// Storage nodes need the scene to read their attributes, they are
+  /// always read on the calling thread.
+  /// Disabled by default.
+  vtkSetMacro(DeferNodeCreation, bool);
+  vtkGetMacro(DeferNodeCreation, bool);
+  vtkBooleanMacro(DeferNodeCreation, bool);
+
+  /// Create the nodes of all the elements recorded since the last call
+  /// and add them to the scene (or node collection).
+  /// Only needed when DeferNodeCreation is enabled.
+  void ProcessDeferredElements();
+
 protected:
   vtkMRMLParser() = default;;
   ~vtkMRMLParser() override  = default;
@@ -43,10 +62,32 @@ protected:
   void StartElement(const char* name, const char** atts) override;
   void EndElement (const char *name) override;
 
+  /// Process an element start. If \a node is not null, it is used instead of
+  /// creating a new node from the tag name, and its ownership is transferred.
+  /// If \a attributesRead is true, ReadXMLAttributes is not called on \a node.
+  void ProcessStartElement(const char* tagName, const char** atts,
+                           vtkMRMLNode* node = nullptr, bool attributesRead = false);
+  void ProcessEndElement(const char* tagName);
+
+  /// Return the name of the node class to instantiate for an element tag.
+  std::string GetNodeClassNameByTag(const char* tagName);
+
+  struct DeferredElement
+    {
+    bool Start{true};
+    std::string TagName;
+    std::vector<std::string> Attributes;
+    std::string ClassName;
+    vtkMRMLNode* Node{nullptr};
+    bool AttributesRead{false};
+    };
+
 private:
   vtkMRMLScene* MRMLScene{nullptr};
   vtkCollection* NodeCollection{nullptr};
   std::stack< vtkMRMLNode *> NodeStack;
+  bool DeferNodeCreation{false};
+  std::vector<DeferredElement> DeferredElements;
 };
 
 #endif
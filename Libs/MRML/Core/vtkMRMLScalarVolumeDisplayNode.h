@@ -21,7 +21,6 @@
 // VTK includes
 class vtkImageAlgorithm;
 class vtkImageAppendComponents;
-class vtkImageHistogramStatistics;
 class vtkImageCast;
 class vtkImageLogic;
 class vtkImageMapToColors;
@@ -239,9 +238,6 @@ protected:
   /// window level presets
   std::vector<WindowLevelPreset> WindowLevelPresets;
 
-  ///
-  /// Used internally in CalculateScalarAutoLevels and CalculateStatisticsAutoLevels
-  vtkImageHistogramStatistics *HistogramStatistics;
   bool IsInCalculateAutoLevels;
 };
 
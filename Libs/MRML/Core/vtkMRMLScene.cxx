@@ -63,18 +63,21 @@ Version:   $Revision: 1.18 $
 #include "vtkMRMLSliceCompositeNode.h"
 #include "vtkMRMLSliceNode.h"
 #include "vtkMRMLSnapshotClipNode.h"
+#include "vtkMRMLStorableNode.h"
 #include "vtkMRMLSubjectHierarchyNode.h"
 #include "vtkMRMLTableNode.h"
 #include "vtkMRMLTableStorageNode.h"
 #include "vtkMRMLTableViewNode.h"
 #include "vtkMRMLTextNode.h"
 #include "vtkMRMLTextStorageNode.h"
+#include "vtkMRMLTrace.h"
 #include "vtkMRMLTransformDisplayNode.h"
 #include "vtkMRMLTransformNode.h"
 #include "vtkMRMLTransformStorageNode.h"
 #include "vtkMRMLVectorVolumeDisplayNode.h"
 #include "vtkMRMLViewNode.h"
 #include "vtkMRMLVolumeArchetypeStorageNode.h"
+#include "vtkMRMLVolumeChunkedStorageNode.h"
 #include "vtkMRMLVolumeSequenceStorageNode.h"
 #include "vtkURIHandler.h"
 
@@ -87,14 +90,18 @@ Version:   $Revision: 1.18 $
 #include "vtkMRMLVectorVolumeNode.h"
 #endif
 
+#include "vtkEventBroker.h"
+
 // VTK includes
 #include <vtkCallbackCommand.h>
 #include <vtkCollection.h>
 #include <vtkDebugLeaks.h>
 #include <vtkErrorCode.h>
+#include <vtkNew.h>
 #include <vtkObjectFactory.h>
 #include <vtkPNGWriter.h>
 #include <vtkSmartPointer.h>
+#include <vtkTimerLog.h>
 
 // VTKSYS includes
 #include <vtksys/RegularExpression.hxx>
@@ -103,7 +110,11 @@ Version:   $Revision: 1.18 $
 
 // STD includes
 #include <algorithm>
+#include <atomic>
+#include <iomanip>
 #include <numeric>
+#include <sstream>
+#include <thread>
 
 //#define MRMLSCENE_VERBOSE
 
@@ -121,7 +132,8 @@ vtkMRMLScene::vtkMRMLScene()
 {
   this->RandomGenerator.seed(std::random_device{}());
 
-  this->NodeIDsMTime = 0;
+  this->NextNodeOrderKey = 0;
+  this->NodeClassIndexValid = true;
 
   this->RegisteredNodeClasses.clear();
   this->UniqueIDs.clear();
@@ -129,9 +141,18 @@ vtkMRMLScene::vtkMRMLScene()
 
   this->Nodes =  vtkCollection::New();
   this->MaximumNumberOfSavedUndoStates = 20;
+  this->MaximumUndoStackMemorySize = 0;
   this->UndoFlag = false;
 
+  this->CoalesceEventsDuringBatchProcess = false;
+  this->CopyOnWriteBulkData = false;
+  this->ParallelNodeInstantiation = false;
+  this->BulkClear = false;
+  this->NumberOfDataReadThreads = 1;
+  this->EventModeBeforeBatchProcess = -1;
+
   this->NodeReferences.clear();
+  this->ReferencedIDsByReferencingID.clear();
   this->ReferencedIDChanges.clear();
 
   this->CacheManager = nullptr;
@@ -186,6 +207,7 @@ vtkMRMLScene::vtkMRMLScene()
   this->RegisterNodeClass( vtkSmartPointer< vtkMRMLSelectionNode >::New() );
   this->RegisterNodeClass( vtkSmartPointer< vtkMRMLSliceNode >::New() );
   this->RegisterNodeClass( vtkSmartPointer< vtkMRMLVolumeArchetypeStorageNode >::New() );
+  this->RegisterNodeClass( vtkSmartPointer< vtkMRMLVolumeChunkedStorageNode >::New() );
   this->RegisterNodeClass( vtkSmartPointer< vtkMRMLScalarVolumeDisplayNode >::New() );
   this->RegisterNodeClass( vtkSmartPointer< vtkMRMLLabelMapVolumeDisplayNode >::New() );
   this->RegisterNodeClass( vtkSmartPointer< vtkMRMLLabelMapVolumeNode >::New() );
@@ -252,6 +274,7 @@ vtkMRMLScene::~vtkMRMLScene()
     if (this->Nodes->GetNumberOfItems() > 0)
       {
       vtkDebugMacro("CurrentScene should have already been cleared in DeleteEvent callback: ");
+      this->ClearNodeIDs();
       this->Nodes->RemoveAllItems ( );
       }
     this->Nodes->Delete();
@@ -313,6 +336,7 @@ void vtkMRMLScene::SceneCallback( vtkObject *vtkNotUsed(caller),
 //------------------------------------------------------------------------------
 void vtkMRMLScene::Clear(int removeSingletons)
 {
+  vtkMRMLTraceScopeMacro("MRML", "vtkMRMLScene::Clear", nullptr);
 #ifdef MRMLSCENE_VERBOSE
   vtkTimerLog* timer = vtkTimerLog::New();
   timer->StartTimer();
@@ -321,8 +345,16 @@ void vtkMRMLScene::Clear(int removeSingletons)
   this->SetUndoOff();
   this->StartState(vtkMRMLScene::CloseState);
 
-  this->RemoveAllNodes(removeSingletons);
+  if (this->BulkClear)
+    {
+    this->RemoveAllNodesBulk(removeSingletons);
+    }
+  else
+    {
+    this->RemoveAllNodes(removeSingletons);
+    }
   this->NodeReferences.clear();
+  this->ReferencedIDsByReferencingID.clear();
   this->ReferencedIDChanges.clear();
   this->ResetNodes();
 
@@ -382,6 +414,81 @@ void vtkMRMLScene::RemoveAllNodes(bool removeSingletons)
     }
 }
 
+//------------------------------------------------------------------------------
+void vtkMRMLScene::RemoveAllNodesBulk(bool removeSingletons)
+{
+  vtkMRMLTraceScopeMacro("MRML", "vtkMRMLScene::RemoveAllNodesBulk", nullptr);
+  // Keep the removed nodes alive until all the indices are updated
+  std::vector< vtkSmartPointer<vtkMRMLNode> > removedNodes;
+  // Kept nodes may be owned only by the scene, they must stay alive while the collection is rebuilt
+  std::vector< vtkSmartPointer<vtkMRMLNode> > keptNodes;
+  vtkMRMLNode *node = nullptr;
+  vtkCollectionSimpleIterator it;
+  for (this->Nodes->InitTraversal(it);
+    (node = (vtkMRMLNode*)this->Nodes->GetNextItemAsObject(it));)
+    {
+    if (removeSingletons || node->GetSingletonTag() == nullptr)
+      {
+      removedNodes.emplace_back(node);
+      }
+    else
+      {
+      keptNodes.emplace_back(node);
+      }
+    }
+  if (removedNodes.empty())
+    {
+    return;
+    }
+
+  if (keptNodes.empty())
+    {
+    this->ClearNodeIDs();
+    this->NodesByName.clear();
+    }
+  else
+    {
+    for (std::vector< vtkSmartPointer<vtkMRMLNode> >::iterator nodeIt = removedNodes.begin();
+      nodeIt != removedNodes.end(); ++nodeIt)
+      {
+      this->RemoveNodeID(*nodeIt);
+      this->RemoveNodeFromNameIndex(*nodeIt, (*nodeIt)->GetName());
+      }
+    }
+  // Nodes are not removed one by one from the collection (and from the class index),
+  // the collection is rebuilt with the kept nodes instead.
+  this->Nodes->RemoveAllItems();
+  this->InvalidateNodeClassIndex();
+  for (std::vector< vtkSmartPointer<vtkMRMLNode> >::iterator nodeIt = keptNodes.begin(); nodeIt != keptNodes.end(); ++nodeIt)
+    {
+    this->Nodes->vtkCollection::AddItem(*nodeIt);
+    }
+
+  // Kept nodes must not refer to removed nodes anymore (removed node IDs are not found in the scene now),
+  // otherwise the removed nodes would be kept alive by the references.
+  for (std::vector< vtkSmartPointer<vtkMRMLNode> >::iterator nodeIt = keptNodes.begin(); nodeIt != keptNodes.end(); ++nodeIt)
+    {
+    (*nodeIt)->UpdateReferences();
+    }
+
+  for (std::vector< vtkSmartPointer<vtkMRMLNode> >::iterator nodeIt = removedNodes.begin();
+    nodeIt != removedNodes.end(); ++nodeIt)
+    {
+    if ((*nodeIt)->GetScene() == this)
+      {
+      (*nodeIt)->SetScene(nullptr);
+      }
+    }
+
+  // Release nodes in reverse order of addition, so that nodes are typically
+  // deleted before the nodes they refer to
+  while (!removedNodes.empty())
+    {
+    removedNodes.pop_back();
+    }
+  this->Modified();
+}
+
 //------------------------------------------------------------------------------
 void vtkMRMLScene::ResetNodes()
 {
@@ -669,6 +776,12 @@ void vtkMRMLScene::StartState(unsigned long state, int anticipatedMaxProgress)
   this->States.push_back(state);
   if (this->IsBatchProcessing() && !wasBatchProcessing)
     {
+    if (this->CoalesceEventsDuringBatchProcess)
+      {
+      vtkEventBroker* broker = vtkEventBroker::GetInstance();
+      this->EventModeBeforeBatchProcess = broker->GetEventMode();
+      broker->SetEventModeToCoalesced();
+      }
     this->InvokeEvent( StateEvent | StartEvent | BatchProcessState);
     }
   if (state != vtkMRMLScene::BatchProcessState &&
@@ -682,6 +795,7 @@ void vtkMRMLScene::StartState(unsigned long state, int anticipatedMaxProgress)
 //------------------------------------------------------------------------------
 void vtkMRMLScene::EndState(unsigned long state)
 {
+  vtkMRMLTraceScopeMacro("MRML", "vtkMRMLScene::EndState", nullptr);
   if (this->States.empty())
   {
     vtkErrorMacro("vtkMRMLScene::EndState failed: there was no previous state");
@@ -704,6 +818,13 @@ void vtkMRMLScene::EndState(unsigned long state)
   if ((state & vtkMRMLScene::BatchProcessState) &&
       !this->IsBatchProcessing())
     {
+    if (this->EventModeBeforeBatchProcess != -1)
+      {
+      // Restoring the event mode flushes the coalesced events
+      int eventMode = this->EventModeBeforeBatchProcess;
+      this->EventModeBeforeBatchProcess = -1;
+      vtkEventBroker::GetInstance()->SetEventMode(eventMode);
+      }
     this->InvokeEvent( StateEvent | EndEvent |
                        vtkMRMLScene::BatchProcessState );
     }
@@ -758,6 +879,8 @@ int vtkMRMLScene::Connect()
 //------------------------------------------------------------------------------
 int vtkMRMLScene::Import()
 {
+  vtkMRMLTraceScopeMacro("MRML", "vtkMRMLScene::Import", this->GetURL());
+  double importStartTime = vtkTimerLog::GetUniversalTime();
 #ifdef MRMLSCENE_VERBOSE
   vtkTimerLog* addNodesTimer = vtkTimerLog::New();
   vtkTimerLog* updateSceneTimer = vtkTimerLog::New();
@@ -815,6 +938,10 @@ int vtkMRMLScene::Import()
 
     this->InvokeEvent(vtkMRMLScene::NewSceneEvent, nullptr);
 
+    // Read bulk data files in parallel, UpdateScene then only sets the
+    // prefetched data in the nodes
+    this->PrefetchStorableNodesData(addedNodes);
+
     // Notify the imported nodes about that all nodes are created
     // (so the observers can be attached to referenced nodes, etc.)
     // by calling UpdateScene on each node
@@ -839,6 +966,21 @@ int vtkMRMLScene::Import()
         }
       }
 
+    // Release prefetched data that was not used by UpdateScene
+    this->StoragePrefetchTimes.clear();
+    if (this->NumberOfDataReadThreads > 1)
+      {
+      for (addedNodes->InitTraversal(it);
+           (node = (vtkMRMLNode*)addedNodes->GetNextItemAsObject(it)) ;)
+        {
+        vtkMRMLStorageNode* storageNode = vtkMRMLStorageNode::SafeDownCast(node);
+        if (storageNode)
+          {
+          storageNode->ClearPrefetchedData();
+          }
+        }
+      }
+
     this->Modified();
     this->RemoveUnusedNodeReferences();
 #ifdef MRMLSCENE_VERBOSE
@@ -885,6 +1027,11 @@ int vtkMRMLScene::Import()
   // Once the import is finished, give the SH a chance to ensure consistency
   this->SetSubjectHierarchyNode(vtkMRMLSubjectHierarchyNode::ResolveSubjectHierarchy(this));
 
+  if (this->LogStorageStatistics)
+    {
+    this->LogStorageStatisticsSinceLastLog("Import", vtkTimerLog::GetUniversalTime() - importStartTime);
+    }
+
   return returnCode;
 }
 
@@ -941,6 +1088,7 @@ int vtkMRMLScene::LoadIntoScene(vtkCollection* nodeCollection)
     {
     parser->SetNodeCollection(nodeCollection);
     }
+  parser->SetDeferNodeCreation(this->ParallelNodeInstantiation);
 
   int result = 0; // 0 means failure
   if (this->GetLoadFromXMLString())
@@ -953,6 +1101,7 @@ int vtkMRMLScene::LoadIntoScene(vtkCollection* nodeCollection)
     parser->SetFileName(URL.c_str());
     result = parser->Parse();
    }
+  parser->ProcessDeferredElements();
 
   parser->Delete();
 
@@ -963,6 +1112,12 @@ int vtkMRMLScene::LoadIntoScene(vtkCollection* nodeCollection)
 //------------------------------------------------------------------------------
 int vtkMRMLScene::Commit(const char* url)
 {
+  vtkMRMLTraceScopeMacro("MRML", "vtkMRMLScene::Commit", url);
+  if (this->LogStorageStatistics)
+    {
+    // storable nodes write their data before the scene is committed
+    this->LogStorageStatisticsSinceLastLog("Commit", -1.0);
+    }
   if (url == nullptr)
     {
     if (this->URL != "")
@@ -1206,6 +1361,8 @@ vtkMRMLNode* vtkMRMLScene::AddNodeNoNotify(vtkMRMLNode *n)
 
   // cache the node so the whole scene cache stays up-to date
   this->AddNodeID(n);
+  this->AddNodeToClassIndex(n);
+  this->AddNodeToNameIndex(n);
 
   // Keep the SH up-to-date
   if (vtkMRMLSubjectHierarchyNode::SafeDownCast(n) != nullptr &&
@@ -1222,6 +1379,7 @@ vtkMRMLNode* vtkMRMLScene::AddNodeNoNotify(vtkMRMLNode *n)
 //------------------------------------------------------------------------------
 vtkMRMLNode* vtkMRMLScene::AddNode(vtkMRMLNode *n)
 {
+  vtkMRMLTraceScopeMacro("MRML", "vtkMRMLScene::AddNode", n ? n->GetClassName() : nullptr);
   if (!n)
     {
     vtkErrorMacro("AddNode: unable to add a null node to the scene");
@@ -1334,7 +1492,7 @@ vtkMRMLNode* vtkMRMLScene::AddNewNodeByClassWithID(std::string className, std::s
     return nullptr;
     }
 
-  if (this->NodeIDs.find(nodeID) != this->NodeIDs.end())
+  if (this->NodeIDs.GetNode(nodeID.c_str()) != nullptr)
     {
     vtkErrorMacro("AddNewNodeByClassWithID: node already exists with ID - " << nodeID);
     return nullptr;
@@ -1387,6 +1545,7 @@ vtkMRMLNode* vtkMRMLScene::CopyNode(vtkMRMLNode *n)
 //------------------------------------------------------------------------------
 void vtkMRMLScene::RemoveNode(vtkMRMLNode *n)
 {
+  vtkMRMLTraceScopeMacro("MRML", "vtkMRMLScene::RemoveNode", n ? n->GetClassName() : nullptr);
   if (n == nullptr)
     {
     vtkDebugMacro("RemoveNode: unable to remove null node");
@@ -1422,7 +1581,9 @@ void vtkMRMLScene::RemoveNode(vtkMRMLNode *n)
   this->Nodes->vtkCollection::RemoveItem((vtkObject *)n);
 
   std::string nid = (n->GetID() ? n->GetID() : "");
-  this->RemoveNodeID(n->GetID());
+  this->RemoveNodeID(n);
+  this->RemoveNodeFromClassIndex(n);
+  this->RemoveNodeFromNameIndex(n, n->GetName());
 
   this->InvokeEvent(vtkMRMLScene::NodeRemovedEvent, n);
 
@@ -1478,6 +1639,22 @@ void vtkMRMLScene::RemoveReferencedNodeID(const char *id, vtkMRMLNode *referenci
     return;
     }
   referenceIt->second.erase(referencingNode->GetID());
+  this->RemoveReferencedIDFromReferencingID(id, referencingNode->GetID());
+}
+
+//------------------------------------------------------------------------------
+void vtkMRMLScene::RemoveReferencedIDFromReferencingID(const std::string& referencedID, const std::string& referencingID)
+{
+  NodeReferencesType::iterator referencedIDsIt = this->ReferencedIDsByReferencingID.find(referencingID);
+  if (referencedIDsIt == this->ReferencedIDsByReferencingID.end())
+    {
+    return;
+    }
+  referencedIDsIt->second.erase(referencedID);
+  if (referencedIDsIt->second.empty())
+    {
+    this->ReferencedIDsByReferencingID.erase(referencedIDsIt);
+    }
 }
 
 //------------------------------------------------------------------------------
@@ -1495,18 +1672,24 @@ void vtkMRMLScene::RemoveNodeReferences(vtkMRMLNode *n)
     }
   std::string nid=n->GetID();
 
-  NodeReferencesType::value_type::second_type::iterator referringNodesIt;
-  for (NodeReferencesType::iterator referenceIt = this->NodeReferences.begin();
-    referenceIt != this->NodeReferences.end();
-    ++referenceIt)
+  NodeReferencesType::iterator referencedIDsIt = this->ReferencedIDsByReferencingID.find(nid);
+  if (referencedIDsIt == this->ReferencedIDsByReferencingID.end())
+    {
+    // the node does not reference any node
+    return;
+    }
+  for (NodeReferencesType::value_type::second_type::iterator referencedIDIt = referencedIDsIt->second.begin();
+    referencedIDIt != referencedIDsIt->second.end();
+    ++referencedIDIt)
     {
-    referringNodesIt=referenceIt->second.find(nid);
-    if (referringNodesIt!=referenceIt->second.end())
+    NodeReferencesType::iterator referenceIt = this->NodeReferences.find(*referencedIDIt);
+    if (referenceIt != this->NodeReferences.end())
       {
       // observation has been deleted, so remove it from the index
-      referenceIt->second.erase(referringNodesIt);
+      referenceIt->second.erase(nid);
       }
     }
+  this->ReferencedIDsByReferencingID.erase(referencedIDsIt);
 }
 
 //------------------------------------------------------------------------------
@@ -1534,6 +1717,19 @@ void vtkMRMLScene::RemoveUnusedNodeReferences()
       ++referringNodesIt;
       }
     }
+  for (NodeReferencesType::iterator referencedIDsIt = this->ReferencedIDsByReferencingID.begin();
+    referencedIDsIt != this->ReferencedIDsByReferencingID.end();
+    /*upon deletion the increment is done already, so don't increment here*/)
+    {
+    if (this->GetNodeByID(referencedIDsIt->first) == nullptr)
+      {
+      NodeReferencesType::iterator referencedIDsItToRemove = referencedIDsIt;
+      ++referencedIDsIt;
+      this->ReferencedIDsByReferencingID.erase(referencedIDsItToRemove);
+      continue;
+      }
+    ++referencedIDsIt;
+    }
 
   // Remove Referenced node IDs that are no longer in the scene
   for (NodeReferencesType::iterator referenceIt = this->NodeReferences.begin();
@@ -1547,6 +1743,12 @@ void vtkMRMLScene::RemoveUnusedNodeReferences()
       // the referenced ID is no longer in the scene (or no more references), so remove all related references
       NodeReferencesType::iterator referenceItToBeRemoved = referenceIt;
       ++referenceIt;
+      for (NodeReferencesType::value_type::second_type::iterator referringNodesIt = referenceItToBeRemoved->second.begin();
+        referringNodesIt != referenceItToBeRemoved->second.end();
+        ++referringNodesIt)
+        {
+        this->RemoveReferencedIDFromReferencingID(referenceItToBeRemoved->first, *referringNodesIt);
+        }
       this->NodeReferences.erase(referenceItToBeRemoved);
       continue;
       }
@@ -1563,7 +1765,18 @@ void vtkMRMLScene::RemoveReferencesToNode(vtkMRMLNode *n)
     vtkErrorMacro("RemoveReferencesToNode: node is null or has null id, can't remove refs");
     return;
     }
-  this->NodeReferences.erase(n->GetID());
+  NodeReferencesType::iterator referenceIt = this->NodeReferences.find(n->GetID());
+  if (referenceIt == this->NodeReferences.end())
+    {
+    return;
+    }
+  for (NodeReferencesType::value_type::second_type::iterator referringNodesIt = referenceIt->second.begin();
+    referringNodesIt != referenceIt->second.end();
+    ++referringNodesIt)
+    {
+    this->RemoveReferencedIDFromReferencingID(referenceIt->first, *referringNodesIt);
+    }
+  this->NodeReferences.erase(referenceIt);
 }
 
 //------------------------------------------------------------------------------
@@ -1600,18 +1813,7 @@ int vtkMRMLScene::GetNumberOfNodesByClass(const char *className)
     vtkErrorMacro("GetNumberOfNodesByClass: class name is null.");
     return 0;
     }
-  int num=0;
-  vtkMRMLNode *node;
-  vtkCollectionSimpleIterator it;
-  for (this->Nodes->InitTraversal(it);
-       (node = (vtkMRMLNode*)this->Nodes->GetNextItemAsObject(it)) ;)
-    {
-    if (node->IsA(className))
-      {
-      num++;
-      }
-    }
-  return num;
+  return static_cast<int>(this->GetNodesByClassFromIndex(className).size());
 }
 
 //------------------------------------------------------------------------------
@@ -1623,16 +1825,7 @@ int vtkMRMLScene::GetNodesByClass(const char *className, std::vector<vtkMRMLNode
     vtkErrorMacro("GetNodesByClass: class name is null.");
     return 0;
     }
-  vtkMRMLNode *node;
-  vtkCollectionSimpleIterator it;
-  for (this->Nodes->InitTraversal(it);
-       (node = (vtkMRMLNode*)this->Nodes->GetNextItemAsObject(it)) ;)
-    {
-    if (node->IsA(className))
-      {
-      nodes.push_back(node);
-      }
-    }
+  nodes = this->GetNodesByClassFromIndex(className);
   return static_cast<int>(nodes.size());
 }
 
@@ -1645,15 +1838,10 @@ vtkCollection* vtkMRMLScene::GetNodesByClass(const char *className)
     return nullptr;
     }
   vtkCollection* nodes = vtkCollection::New();
-  vtkMRMLNode *node;
-  vtkCollectionSimpleIterator it;
-  for (this->Nodes->InitTraversal(it);
-       (node = (vtkMRMLNode*)this->Nodes->GetNextItemAsObject(it)) ;)
+  const std::vector<vtkMRMLNode*>& classNodes = this->GetNodesByClassFromIndex(className);
+  for (std::vector<vtkMRMLNode*>::const_iterator nodeIt = classNodes.begin(); nodeIt != classNodes.end(); ++nodeIt)
     {
-    if (node->IsA(className))
-      {
-      nodes->AddItem(node);
-      }
+    nodes->AddItem(*nodeIt);
     }
   return nodes;
 }
@@ -1714,13 +1902,11 @@ vtkMRMLNode* vtkMRMLScene::GetSingletonNode(const char* singletonTag, const char
     return nullptr;
     }
 
-  vtkCollectionSimpleIterator it;
-  vtkMRMLNode* node = nullptr;
-  for (this->Nodes->InitTraversal(it);
-       (node = (vtkMRMLNode*)this->Nodes->GetNextItemAsObject(it)) ;)
+  const std::vector<vtkMRMLNode*>& classNodes = this->GetNodesByClassFromIndex(className);
+  for (std::vector<vtkMRMLNode*>::const_iterator nodeIt = classNodes.begin(); nodeIt != classNodes.end(); ++nodeIt)
     {
-    if (node->IsA(className) &&
-        node->GetSingletonTag() != nullptr &&
+    vtkMRMLNode* node = *nodeIt;
+    if (node->GetSingletonTag() != nullptr &&
         strcmp(node->GetSingletonTag(), singletonTag) == 0)
       {
       return node;
@@ -1790,22 +1976,12 @@ vtkMRMLNode* vtkMRMLScene::GetNthNodeByClass(int n, const char *className)
     return nullptr;
     }
 
-  int num=0;
-  vtkMRMLNode *node;
-  vtkCollectionSimpleIterator it;
-  for (this->Nodes->InitTraversal(it);
-       (node = (vtkMRMLNode*)this->Nodes->GetNextItemAsObject(it)) ;)
+  const std::vector<vtkMRMLNode*>& classNodes = this->GetNodesByClassFromIndex(className);
+  if (n >= static_cast<int>(classNodes.size()))
     {
-    if (node->IsA(className))
-      {
-      if (num == n)
-        {
-        return node;
-        }
-      num++;
-      }
+    return nullptr;
     }
-  return nullptr;
+  return classNodes[n];
 }
 
 //------------------------------------------------------------------------------
@@ -1825,50 +2001,71 @@ vtkCollection* vtkMRMLScene::GetNodesByName(const char* name)
     return nodes;
     }
 
-  vtkMRMLNode *node;
-  vtkCollectionSimpleIterator it;
-  for (this->Nodes->InitTraversal(it);
-       (node = (vtkMRMLNode*)this->Nodes->GetNextItemAsObject(it)) ;)
+  const std::vector<vtkMRMLNode*>* namedNodes = this->GetNodesByNameFromIndex(name);
+  if (!namedNodes)
     {
-    if (node->GetName() != nullptr && !strcmp(node->GetName(), name))
-      {
-      nodes->AddItem(node);
-      }
+    return nodes;
+    }
+  for (std::vector<vtkMRMLNode*>::const_iterator nodeIt = namedNodes->begin(); nodeIt != namedNodes->end(); ++nodeIt)
+    {
+    nodes->AddItem(*nodeIt);
     }
   return nodes;
 }
 
+//-----------------------------------------------------------------------------
+namespace
+{
+bool IsNodeMatchingFilter(vtkMRMLNode* node, const char* byName,
+                          const int* byHideFromEditors, bool exactNameMatch)
+{
+  if (exactNameMatch && byName &&
+      node->GetName() != nullptr && strcmp(node->GetName(), byName) != 0)
+    {
+    return false;
+    }
+  if (!exactNameMatch && byName &&
+      node->GetName() != nullptr && !vtksys::RegularExpression(byName).find(node->GetName()))
+    {
+    return false;
+    }
+  if (byHideFromEditors && node->GetHideFromEditors() != *byHideFromEditors)
+    {
+    return false;
+    }
+  return true;
+}
+}
+
 //-----------------------------------------------------------------------------
 vtkMRMLNode* vtkMRMLScene::GetFirstNode(const char* byName,
                                         const char* byClass,
                                         const int* byHideFromEditors,
                                         bool exactNameMatch)
 {
+  if (byClass)
+    {
+    // Only nodes of the requested class need to be checked
+    const std::vector<vtkMRMLNode*>& classNodes = this->GetNodesByClassFromIndex(byClass);
+    for (std::vector<vtkMRMLNode*>::const_iterator nodeIt = classNodes.begin(); nodeIt != classNodes.end(); ++nodeIt)
+      {
+      if (IsNodeMatchingFilter(*nodeIt, byName, byHideFromEditors, exactNameMatch))
+        {
+        return *nodeIt;
+        }
+      }
+    return nullptr;
+    }
   vtkCollectionSimpleIterator it;
   vtkMRMLNode* node;
   for (this->Nodes->InitTraversal(it);
        (node= vtkMRMLNode::SafeDownCast(
           this->Nodes->GetNextItemAsObject(it))) ;)
     {
-    if (exactNameMatch && byName &&
-        node->GetName() != nullptr && strcmp(node->GetName(), byName) != 0)
-      {
-      continue;
-      }
-    if (!exactNameMatch && byName &&
-        node->GetName() != nullptr && !vtksys::RegularExpression(byName).find(node->GetName()))
-      {
-      continue;
-      }
-    if (byClass && !node->IsA(byClass))
+    if (IsNodeMatchingFilter(node, byName, byHideFromEditors, exactNameMatch))
       {
-      continue;
-      }
-    if (byHideFromEditors && node->GetHideFromEditors() != *byHideFromEditors)
-      {
-      continue;
+      return node;
       }
-    return node;
     }
   return nullptr;
 }
@@ -1883,16 +2080,12 @@ vtkMRMLNode* vtkMRMLScene::GetFirstNodeByName(const char* name)
     return node;
     }
 
-  vtkCollectionSimpleIterator it;
-  for (this->Nodes->InitTraversal(it);
-       (node = (vtkMRMLNode*)this->Nodes->GetNextItemAsObject(it)) ;)
+  const std::vector<vtkMRMLNode*>* namedNodes = this->GetNodesByNameFromIndex(name);
+  if (!namedNodes)
     {
-    if (node->GetName() != nullptr && !strcmp(node->GetName(), name))
-      {
-      return node;
-      }
+    return nullptr;
     }
-  return nullptr;
+  return namedNodes->front();
 }
 
 //------------------------------------------------------------------------------
@@ -1910,15 +2103,9 @@ vtkMRMLNode* vtkMRMLScene::GetNodeByID(const char* id)
     return nullptr;
     }
 
-  vtkMRMLNode *node = nullptr;
-  this->UpdateNodeIDs();
-  std::map< std::string, vtkSmartPointer<vtkMRMLNode> >::iterator it = this->NodeIDs.find(std::string(id));
-  if (it != this->NodeIDs.end())
-    {
-    node = it->second;
-    }
+  vtkMRMLNode *node = this->NodeIDs.GetNode(id);
 #ifndef NDEBUG
-  else
+  if (!node)
     {
     // Ensure the node can't be found, and there is no error with the cache
     // mechanism.
@@ -1952,13 +2139,17 @@ vtkCollection* vtkMRMLScene::GetNodesByClassByName(const char* className, const
     return nodes;
     }
 
-  vtkMRMLNode *node;
-  for (int n=0; n < this->Nodes->GetNumberOfItems(); n++)
+  // There are usually much fewer nodes with the same name than nodes of the same class
+  const std::vector<vtkMRMLNode*>* namedNodes = this->GetNodesByNameFromIndex(name);
+  if (!namedNodes)
     {
-    node = (vtkMRMLNode*)this->Nodes->GetItemAsObject(n);
-    if (node->GetName() != nullptr && !strcmp(node->GetName(), name) && node->IsA(className))
+    return nodes;
+    }
+  for (std::vector<vtkMRMLNode*>::const_iterator nodeIt = namedNodes->begin(); nodeIt != namedNodes->end(); ++nodeIt)
+    {
+    if ((*nodeIt)->IsA(className))
       {
-      nodes->AddItem(node);
+      nodes->AddItem(*nodeIt);
       }
     }
 
@@ -2051,6 +2242,9 @@ vtkMRMLNode* vtkMRMLScene::InsertAfterNode(vtkMRMLNode *item, vtkMRMLNode *n)
     }
   // cache the node so the whole scene cache stays up-to-date
   this->AddNodeID(n);
+  // the node may not be at the end of the collection
+  this->InvalidateNodeClassIndex();
+  this->AddNodeToNameIndex(n);
 
   n->SetDisableModifiedEvent(modifyStatus);
 
@@ -2149,6 +2343,9 @@ vtkMRMLNode* vtkMRMLScene::InsertBeforeNode(vtkMRMLNode *item, vtkMRMLNode *n)
     }
   // cache the node so the whole scene cache stays up-todate
   this->AddNodeID(n);
+  // the node may not be at the end of the collection
+  this->InvalidateNodeClassIndex();
+  this->AddNodeToNameIndex(n);
 
   n->SetDisableModifiedEvent(modifyStatus);
 
@@ -2434,8 +2631,8 @@ int vtkMRMLScene::GetUniqueNameIndex(const std::string& baseName)
     }
   bool isUnique = false;
   int index = lastNameIndex;
-  // keep looping until you find a name that isn't yet in the scene
-  // TODO: this could be speeded up if it becomes a bottleneck
+  // keep looping until you find a name that isn't yet in the scene,
+  // each lookup is done in the name index.
   for (; !isUnique; )
     {
     ++index;
@@ -2513,6 +2710,7 @@ void vtkMRMLScene::SaveStateForUndo (vtkMRMLNode *node)
   if (node)
     {
     this->CopyNodeInUndoStack(node);
+    this->TrimUndoStack();
     }
 }
 
@@ -2545,6 +2743,8 @@ void vtkMRMLScene::SaveStateForUndo (std::vector<vtkMRMLNode *> nodes)
       this->CopyNodeInUndoStack(node);
       }
     }
+  // Copies may have exceeded the memory limit
+  this->TrimUndoStack();
 }
 
 //------------------------------------------------------------------------------
@@ -2584,6 +2784,8 @@ void vtkMRMLScene::SaveStateForUndo (vtkCollection* nodes)
       this->CopyNodeInUndoStack(node);
       }
     }
+  // Copies may have exceeded the memory limit
+  this->TrimUndoStack();
 }
 
 //------------------------------------------------------------------------------
@@ -2670,10 +2872,40 @@ void vtkMRMLScene::CopyNodeInUndoStack(vtkMRMLNode *copyNode)
     return;
     }
 
-  vtkMRMLNode *snode = copyNode->CreateNodeInstance();
-  if (snode != nullptr)
+  vtkSmartPointer<vtkMRMLNode> snode;
+  vtkMTimeType contentMTime = copyNode->GetContentMTime();
+  std::map< std::string, UndoNodeCopy >::iterator lastCopyIt = this->LastUndoNodeCopies.end();
+  // Only nodes that track all their content modifications can share copies
+  bool canShareCopy = copyNode->IsContentMTimeTracked();
+  if (copyNode->GetID() && canShareCopy)
+    {
+    lastCopyIt = this->LastUndoNodeCopies.find(copyNode->GetID());
+    }
+  if (lastCopyIt != this->LastUndoNodeCopies.end()
+    && lastCopyIt->second.Copy != nullptr
+    && lastCopyIt->second.Copy != copyNode
+    && lastCopyIt->second.ContentMTime >= contentMTime
+    && !strcmp(lastCopyIt->second.Copy->GetClassName(), copyNode->GetClassName()))
+    {
+    // The node has not been modified since its last copy, share the copy
+    // between undo states instead of duplicating its content.
+    snode = lastCopyIt->second.Copy.GetPointer();
+    }
+  else
     {
+    snode = vtkSmartPointer<vtkMRMLNode>::Take(copyNode->CreateNodeInstance());
+    if (snode == nullptr)
+      {
+      vtkErrorMacro("CopyNodeInUndoStack: failed to create a copy of " << copyNode->GetClassName());
+      return;
+      }
     snode->CopyWithScene(copyNode);
+    if (copyNode->GetID() && canShareCopy)
+      {
+      UndoNodeCopy& lastCopy = this->LastUndoNodeCopies[copyNode->GetID()];
+      lastCopy.Copy = snode;
+      lastCopy.ContentMTime = contentMTime;
+      }
     }
 
   vtkCollection* undoScene = this->UndoStack.back();
@@ -2687,7 +2919,6 @@ void vtkMRMLScene::CopyNodeInUndoStack(vtkMRMLNode *copyNode)
       break;
       }
     }
-  snode->Delete();
 }
 
 //------------------------------------------------------------------------------
@@ -2744,24 +2975,23 @@ void vtkMRMLScene::Undo()
   this->PushIntoRedoStack();
 
   vtkCollection* currentScene = this->Nodes;
-  // We use 2 vectors instead of a map in order to keep the ordering of the
-  // nodes.
-  std::vector<std::string> currentIDs;
+  // Vectors keep the ordering of the nodes, maps are used for lookup.
   std::vector<vtkMRMLNode*> currentNodes;
+  std::map<std::string, vtkMRMLNode*> currentNodesByID;
   nnodes = currentScene->GetNumberOfItems();
   for (n=0; n<nnodes; n++)
     {
     vtkMRMLNode *node  = vtkMRMLNode::SafeDownCast(currentScene->GetItemAsObject(n));
     if (node && node->GetUndoEnabled())
       {
-      currentIDs.emplace_back(node->GetID());
       currentNodes.push_back(node);
+      currentNodesByID[node->GetID()] = node;
       }
     }
 
   vtkCollection* undoScene = nullptr;
-  std::vector<std::string> undoIDs;
   std::vector<vtkMRMLNode*> undoNodes;
+  std::set<std::string> undoIDs;
 
   if (!this->UndoStack.empty())
     {
@@ -2772,45 +3002,46 @@ void vtkMRMLScene::Undo()
       vtkMRMLNode *node  = vtkMRMLNode::SafeDownCast(undoScene->GetItemAsObject(n));
       if (node && node->GetUndoEnabled())
         {
-        undoIDs.emplace_back(node->GetID());
         undoNodes.push_back(node);
+        undoIDs.insert(node->GetID());
         }
       }
     }
 
-  std::vector<std::string>::iterator iterID;
-  std::vector<vtkMRMLNode*>::iterator iterNode;
-  std::vector<std::string>::iterator curIterID;
-  std::vector<vtkMRMLNode*>::iterator curIterNode;
-
   // copy back changes and add deleted nodes to the current scene
-  std::vector<vtkMRMLNode*> addNodes;
-
-  for(iterID=undoIDs.begin(), iterNode = undoNodes.begin(); iterID != undoIDs.end(); iterID++, iterNode++)
+  std::vector<vtkSmartPointer<vtkMRMLNode> > addNodes;
+  std::vector<vtkMRMLNode*>::iterator iterNode;
+  for (iterNode = undoNodes.begin(); iterNode != undoNodes.end(); ++iterNode)
     {
-    curIterID = std::find(currentIDs.begin(), currentIDs.end(), *iterID);
-    curIterNode = currentNodes.begin() + std::distance(currentIDs.begin(), curIterID);
-    if ( curIterID == currentIDs.end() )
+    std::map<std::string, vtkMRMLNode*>::iterator curIter = currentNodesByID.find((*iterNode)->GetID());
+    if (curIter == currentNodesByID.end())
       {
       // the node was deleted, add Node back to the current scene
-      addNodes.push_back(*iterNode);
+      vtkSmartPointer<vtkMRMLNode> nodeToAdd = *iterNode;
+      if (this->IsNodeInUndoStack(nodeToAdd, undoScene))
+        {
+        // the copy is shared with other undo states, it must not be modified
+        nodeToAdd = vtkSmartPointer<vtkMRMLNode>::Take((*iterNode)->CreateNodeInstance());
+        nodeToAdd->CopyWithScene(*iterNode);
+        }
+      addNodes.push_back(nodeToAdd);
       }
-    else if (*iterNode != *curIterNode)
+    else if (*iterNode != curIter->second)
       {
       // nodes differ, copy from undo to current scene
       // but before create a copy in redo stack from current
-      this->CopyNodeInRedoStack(*curIterNode);
-      (*curIterNode)->CopyWithScene(*iterNode);
+      this->CopyNodeInRedoStack(curIter->second);
+      curIter->second->CopyWithScene(*iterNode);
       }
     }
 
   // remove new nodes created before Undo
   std::vector<vtkMRMLNode*> removeNodes;
-  for(curIterID=currentIDs.begin(), curIterNode = currentNodes.begin(); curIterID != currentIDs.end(); curIterID++, curIterNode++)
+  std::vector<vtkMRMLNode*>::iterator curIterNode;
+  for (curIterNode = currentNodes.begin(); curIterNode != currentNodes.end(); ++curIterNode)
     {
-    iterID = std::find(undoIDs.begin(),undoIDs.end(), *curIterID);
     // Remove only if the node is not present in the previous state.
-    if ( iterID == undoIDs.end() )
+    if (undoIDs.find((*curIterNode)->GetID()) == undoIDs.end())
       {
       removeNodes.push_back(*curIterNode);
       }
@@ -2983,6 +3214,7 @@ void vtkMRMLScene::ClearUndoStack()
     (*iter)->Delete();
     }
   this->UndoStack.clear();
+  this->LastUndoNodeCopies.clear();
 }
 
 //------------------------------------------------------------------------------
@@ -3026,6 +3258,7 @@ void vtkMRMLScene::AddReferencedNodeID(const char *id, vtkMRMLNode *referencingN
     return;
     }
   this->NodeReferences[id].insert(referencingNode->GetID());
+  this->ReferencedIDsByReferencingID[referencingNode->GetID()].insert(id);
 }
 
 //------------------------------------------------------------------------------
@@ -3131,45 +3364,312 @@ void vtkMRMLScene::UpdateNodeReferences(vtkCollection* checkNodes/*=nullptr*/)
 }
 
 //------------------------------------------------------------------------------
-void vtkMRMLScene::AddReferencedNodes(vtkMRMLNode *node, vtkCollection *refNodes, bool recursive/*=true*/)
+void vtkMRMLScene::PrefetchStorableNodesData(vtkCollection* nodes)
 {
-  if (!node || !node->GetID() || !refNodes)
+  if (this->NumberOfDataReadThreads <= 1 || !this->ReadDataOnLoad || !nodes)
     {
-    vtkErrorMacro("AddReferencedNodes: null node or reference nodes");
     return;
     }
 
-  std::deque<vtkMRMLNode*> newFoundReferencedNodes;
-
-  for (NodeReferencesType::iterator referenceIt = this->NodeReferences.begin();
-    referenceIt != this->NodeReferences.end();
-    ++referenceIt)
+  // Collect the storage nodes to read from. A storage node shared by several
+  // storable nodes is not prefetched, as it would be read concurrently.
+  std::vector<std::pair<vtkMRMLStorageNode*, vtkMRMLStorableNode*> > readRequests;
+  std::map<vtkMRMLStorageNode*, int> storageNodeUseCount;
+  vtkCollectionSimpleIterator it;
+  vtkMRMLNode* node;
+  for (nodes->InitTraversal(it); (node = vtkMRMLNode::SafeDownCast(nodes->GetNextItemAsObject(it))) ;)
     {
-    NodeReferencesType::value_type::second_type::iterator referringNodesIt = referenceIt->second.find(node->GetID());
-    if (referringNodesIt!=referenceIt->second.end())
+    vtkMRMLStorableNode* storableNode = vtkMRMLStorableNode::SafeDownCast(node);
+    if (!storableNode || !storableNode->GetAddToScene())
       {
-      // this ID is referenced by this node
-      vtkMRMLNode *referencedNode = this->GetNodeByID(referenceIt->first);
-      if (referencedNode!=nullptr && !refNodes->IsItemPresent(referencedNode))
+      continue;
+      }
+    for (int i = 0; i < storableNode->GetNumberOfStorageNodes(); ++i)
+      {
+      vtkMRMLStorageNode* storageNode = storableNode->GetNthStorageNode(i);
+      if (!storageNode || !storageNode->GetFileName())
         {
-        // this ID is not yet in the list of reference nodes, so add it
-        refNodes->AddItem(referencedNode);
-        newFoundReferencedNodes.push_back(referencedNode);
+        continue;
+        }
+      if (++storageNodeUseCount[storageNode] == 1)
+        {
+        readRequests.push_back(std::make_pair(storageNode, storableNode));
         }
       }
     }
+  if (readRequests.size() < 2)
+    {
+    return;
+    }
 
-  if (recursive)
+  std::atomic<size_t> nextRequest(0);
+  // Time of each prefetch, added to the read time in the storage statistics (negative if not prefetched)
+  std::vector<double> prefetchTimes(readRequests.size(), -1.0);
+  auto readWorker = [&readRequests, &storageNodeUseCount, &nextRequest, &prefetchTimes]()
     {
-    // recursively add all the referenced nodes' referenced nodes
-    for (std::deque<vtkMRMLNode*>::iterator newReferencedNodeIt=newFoundReferencedNodes.begin();
-      newReferencedNodeIt!=newFoundReferencedNodes.end();
-      ++newReferencedNodeIt)
+    for (size_t i = nextRequest++; i < readRequests.size(); i = nextRequest++)
       {
-      this->AddReferencedNodes(*newReferencedNodeIt, refNodes);
+      vtkMRMLStorageNode* storageNode = readRequests[i].first;
+      if (storageNodeUseCount.find(storageNode)->second == 1)
+        {
+        double startTime = vtkTimerLog::GetUniversalTime();
+        if (storageNode->PrefetchData(readRequests[i].second))
+          {
+          prefetchTimes[i] = vtkTimerLog::GetUniversalTime() - startTime;
+          }
+        }
       }
+    };
+  size_t numberOfThreads = std::min(readRequests.size(),
+    static_cast<size_t>(this->NumberOfDataReadThreads));
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < numberOfThreads; ++i)
+    {
+    threads.push_back(std::thread(readWorker));
     }
-}
+  for (std::vector<std::thread>::iterator threadIt = threads.begin(); threadIt != threads.end(); ++threadIt)
+    {
+    threadIt->join();
+    }
+  for (size_t i = 0; i < readRequests.size(); ++i)
+    {
+    if (prefetchTimes[i] >= 0.0)
+      {
+      this->StoragePrefetchTimes[readRequests[i].first] = prefetchTimes[i];
+      }
+    }
+}
+
+//------------------------------------------------------------------------------
+void vtkMRMLScene::RecordStorageOperation(vtkMRMLStorageNode* storageNode, bool write, bool success)
+{
+  if (!storageNode)
+    {
+    return;
+    }
+  StorageOperation operation;
+  operation.Write = write;
+  operation.Success = success;
+  operation.FileFormat = storageNode->GetLastIOFileFormat();
+  operation.FileSize = storageNode->GetLastIOFileSize();
+  operation.Time = storageNode->GetLastIOTime();
+  operation.DecompressionTime = storageNode->GetLastIODecompressionTime();
+  if (!write)
+    {
+    // Data may have been read by a worker thread before ReadData() was called
+    std::map<vtkMRMLStorageNode*, double>::iterator prefetchIt = this->StoragePrefetchTimes.find(storageNode);
+    if (prefetchIt != this->StoragePrefetchTimes.end())
+      {
+      operation.Time += prefetchIt->second;
+      storageNode->LastIOTime = operation.Time;
+      this->StoragePrefetchTimes.erase(prefetchIt);
+      }
+    }
+  this->StorageOperations.push_back(operation);
+}
+
+//------------------------------------------------------------------------------
+void vtkMRMLScene::ResetStorageStatistics()
+{
+  this->StorageOperations.clear();
+  this->NumberOfLoggedStorageOperations = 0;
+}
+
+//------------------------------------------------------------------------------
+int vtkMRMLScene::GetStorageStatisticsNumberOfReads()
+{
+  return static_cast<int>(std::count_if(this->StorageOperations.begin(), this->StorageOperations.end(),
+    [](const StorageOperation& operation) { return !operation.Write; }));
+}
+
+//------------------------------------------------------------------------------
+int vtkMRMLScene::GetStorageStatisticsNumberOfWrites()
+{
+  return static_cast<int>(std::count_if(this->StorageOperations.begin(), this->StorageOperations.end(),
+    [](const StorageOperation& operation) { return operation.Write; }));
+}
+
+//------------------------------------------------------------------------------
+vtkTypeInt64 vtkMRMLScene::GetStorageStatisticsBytesRead()
+{
+  vtkTypeInt64 bytes = 0;
+  for (const StorageOperation& operation : this->StorageOperations)
+    {
+    bytes += (operation.Write ? 0 : operation.FileSize);
+    }
+  return bytes;
+}
+
+//------------------------------------------------------------------------------
+vtkTypeInt64 vtkMRMLScene::GetStorageStatisticsBytesWritten()
+{
+  vtkTypeInt64 bytes = 0;
+  for (const StorageOperation& operation : this->StorageOperations)
+    {
+    bytes += (operation.Write ? operation.FileSize : 0);
+    }
+  return bytes;
+}
+
+//------------------------------------------------------------------------------
+double vtkMRMLScene::GetStorageStatisticsReadTime()
+{
+  double time = 0.0;
+  for (const StorageOperation& operation : this->StorageOperations)
+    {
+    time += (operation.Write ? 0.0 : operation.Time);
+    }
+  return time;
+}
+
+//------------------------------------------------------------------------------
+double vtkMRMLScene::GetStorageStatisticsWriteTime()
+{
+  double time = 0.0;
+  for (const StorageOperation& operation : this->StorageOperations)
+    {
+    time += (operation.Write ? operation.Time : 0.0);
+    }
+  return time;
+}
+
+//------------------------------------------------------------------------------
+double vtkMRMLScene::GetStorageStatisticsDecompressionTime()
+{
+  double time = 0.0;
+  for (const StorageOperation& operation : this->StorageOperations)
+    {
+    time += operation.DecompressionTime;
+    }
+  return time;
+}
+
+//------------------------------------------------------------------------------
+std::string vtkMRMLScene::GetStorageStatisticsReport()
+{
+  return this->GetStorageStatisticsReportSince(0);
+}
+
+//------------------------------------------------------------------------------
+std::string vtkMRMLScene::GetStorageStatisticsReportSince(size_t firstOperation)
+{
+  struct FormatSummary
+    {
+    int Reads{0};
+    int Writes{0};
+    int Failures{0};
+    vtkTypeInt64 BytesRead{0};
+    vtkTypeInt64 BytesWritten{0};
+    double ReadTime{0.0};
+    double WriteTime{0.0};
+    double DecompressionTime{0.0};
+    };
+  std::map<std::string, FormatSummary> summaries;
+  FormatSummary total;
+  for (size_t i = firstOperation; i < this->StorageOperations.size(); ++i)
+    {
+    const StorageOperation& operation = this->StorageOperations[i];
+    FormatSummary& summary = summaries[operation.FileFormat.empty() ? "(unknown)" : operation.FileFormat];
+    for (FormatSummary* s : { &summary, &total })
+      {
+      if (operation.Write)
+        {
+        s->Writes++;
+        s->BytesWritten += operation.FileSize;
+        s->WriteTime += operation.Time;
+        }
+      else
+        {
+        s->Reads++;
+        s->BytesRead += operation.FileSize;
+        s->ReadTime += operation.Time;
+        }
+      s->DecompressionTime += operation.DecompressionTime;
+      s->Failures += (operation.Success ? 0 : 1);
+      }
+    }
+  std::stringstream ss;
+  ss << std::fixed << std::setprecision(3);
+  ss << "Format\tReads\tReadMB\tReadSeconds\tDecompressionSeconds\tWrites\tWriteMB\tWriteSeconds\tFailures\n";
+  const double megabyte = 1024.0 * 1024.0;
+  summaries["Total"] = total;
+  for (std::map<std::string, FormatSummary>::iterator summaryIt = summaries.begin(); summaryIt != summaries.end(); ++summaryIt)
+    {
+    if (summaryIt->first == "Total")
+      {
+      continue;
+      }
+    const FormatSummary& s = summaryIt->second;
+    ss << summaryIt->first << "\t" << s.Reads << "\t" << s.BytesRead / megabyte << "\t" << s.ReadTime
+       << "\t" << s.DecompressionTime << "\t" << s.Writes << "\t" << s.BytesWritten / megabyte
+       << "\t" << s.WriteTime << "\t" << s.Failures << "\n";
+    }
+  ss << "Total\t" << total.Reads << "\t" << total.BytesRead / megabyte << "\t" << total.ReadTime
+     << "\t" << total.DecompressionTime << "\t" << total.Writes << "\t" << total.BytesWritten / megabyte
+     << "\t" << total.WriteTime << "\t" << total.Failures << "\n";
+  return ss.str();
+}
+
+//------------------------------------------------------------------------------
+void vtkMRMLScene::LogStorageStatisticsSinceLastLog(const std::string& title, double elapsedTime)
+{
+  double storageTime = 0.0;
+  for (size_t i = this->NumberOfLoggedStorageOperations; i < this->StorageOperations.size(); ++i)
+    {
+    storageTime += this->StorageOperations[i].Time;
+    }
+  std::stringstream ss;
+  ss << title << " (" << (this->GetURL() ? this->GetURL() : "") << "): ";
+  if (elapsedTime >= 0.0)
+    {
+    // storage time may exceed elapsed time if data was read by multiple threads
+    ss << elapsedTime << " seconds, of which ";
+    }
+  ss << "reading/writing data: " << storageTime << " seconds\n";
+  vtkInfoMacro(<< ss.str() << this->GetStorageStatisticsReportSince(this->NumberOfLoggedStorageOperations));
+  this->NumberOfLoggedStorageOperations = this->StorageOperations.size();
+}
+
+//------------------------------------------------------------------------------
+void vtkMRMLScene::AddReferencedNodes(vtkMRMLNode *node, vtkCollection *refNodes, bool recursive/*=true*/)
+{
+  if (!node || !node->GetID() || !refNodes)
+    {
+    vtkErrorMacro("AddReferencedNodes: null node or reference nodes");
+    return;
+    }
+
+  std::deque<vtkMRMLNode*> newFoundReferencedNodes;
+
+  NodeReferencesType::iterator referencedIDsIt = this->ReferencedIDsByReferencingID.find(node->GetID());
+  if (referencedIDsIt != this->ReferencedIDsByReferencingID.end())
+    {
+    for (NodeReferencesType::value_type::second_type::iterator referencedIDIt = referencedIDsIt->second.begin();
+      referencedIDIt != referencedIDsIt->second.end();
+      ++referencedIDIt)
+      {
+      // this ID is referenced by this node
+      vtkMRMLNode *referencedNode = this->GetNodeByID(*referencedIDIt);
+      if (referencedNode!=nullptr && !refNodes->IsItemPresent(referencedNode))
+        {
+        // this ID is not yet in the list of reference nodes, so add it
+        refNodes->AddItem(referencedNode);
+        newFoundReferencedNodes.push_back(referencedNode);
+        }
+      }
+    }
+
+  if (recursive)
+    {
+    // recursively add all the referenced nodes' referenced nodes
+    for (std::deque<vtkMRMLNode*>::iterator newReferencedNodeIt=newFoundReferencedNodes.begin();
+      newReferencedNodeIt!=newFoundReferencedNodes.end();
+      ++newReferencedNodeIt)
+      {
+      this->AddReferencedNodes(*newReferencedNodeIt, refNodes);
+      }
+    }
+}
 
 //------------------------------------------------------------------------------
 vtkCollection* vtkMRMLScene::GetReferencedNodes(vtkMRMLNode *node, bool recursive/*=true*/)
@@ -3224,6 +3724,7 @@ void vtkMRMLScene::CopyNodeReferences(vtkMRMLScene *scene)
 
   //assuming the nodes exist in this scene
   this->NodeReferences=scene->NodeReferences;
+  this->ReferencedIDsByReferencingID=scene->ReferencedIDsByReferencingID;
 }
 
 //------------------------------------------------------------------------------
@@ -3254,72 +3755,290 @@ void vtkMRMLScene::UpdateNodeChangedIDs()
         }
       }
     }
-  this->NodeIDsMTime = 0;
-  this->UpdateNodeIDs();
 }
 
-//------------------------------------------------------------------------------
-void vtkMRMLScene::UpdateNodeIDs()
+//-----------------------------------------------------------------------------
+void vtkMRMLScene::AddNodeID(vtkMRMLNode *node)
 {
-  if (this->Nodes->GetNumberOfItems() == 0)
+  if (this->Nodes && node && node->GetID())
     {
-    this->ClearNodeIDs();
+    this->NodeIDs.AddNode(node);
     }
-  else if (this->Nodes->GetMTime() > this->NodeIDsMTime)
+}
+
+//-----------------------------------------------------------------------------
+void vtkMRMLScene::RemoveNodeID(vtkMRMLNode *node)
+{
+  if (this->Nodes && node && node->GetID())
     {
-    if (this->NodeIDsMTime > 0)
+    this->NodeIDs.RemoveNode(node, node->GetID());
+    }
+}
+
+//-----------------------------------------------------------------------------
+void vtkMRMLScene::ClearNodeIDs()
+{
+  if (this->Nodes)
+    {
+    this->NodeIDs.Clear();
+  }
+}
+
+//-----------------------------------------------------------------------------
+void vtkMRMLScene::NodeIDChanged(vtkMRMLNode* node, const char* oldID)
+{
+  if (!node || node->GetScene() != this)
+    {
+    return;
+    }
+  // Only nodes that are indexed are re-indexed, nodes that have their scene
+  // set but are not in the scene (e.g. nodes in the undo stack) are ignored.
+  // The index may hold the only reference to the node.
+  vtkSmartPointer<vtkMRMLNode> nodeRef = node;
+  if (oldID && this->NodeIDs.RemoveNode(node, oldID))
+    {
+    this->NodeIDs.AddNode(node);
+    }
+}
+
+//-----------------------------------------------------------------------------
+void vtkMRMLScene::AddNodeToClassIndex(vtkMRMLNode* node)
+{
+  if (!node || !this->NodeClassIndexValid)
+    {
+    // the whole index will be rebuilt next time it is used
+    return;
+    }
+  vtkTypeUInt64 orderKey = this->NextNodeOrderKey++;
+  this->NodeOrderKeys[node] = orderKey;
+  if (this->NodeClassIndex.empty())
+    {
+    return;
+    }
+  std::vector<NodeClassIndexEntry*>& entries = this->GetNodeClassIndexEntries(node);
+  for (std::vector<NodeClassIndexEntry*>::iterator entryIt = entries.begin(); entryIt != entries.end(); ++entryIt)
+    {
+    (*entryIt)->OrderKeys.push_back(orderKey);
+    (*entryIt)->Nodes.push_back(node);
+    }
+}
+
+//-----------------------------------------------------------------------------
+void vtkMRMLScene::RemoveNodeFromClassIndex(vtkMRMLNode* node)
+{
+  if (!node || !this->NodeClassIndexValid)
+    {
+    return;
+    }
+  std::map<vtkMRMLNode*, vtkTypeUInt64>::iterator orderKeyIt = this->NodeOrderKeys.find(node);
+  if (orderKeyIt == this->NodeOrderKeys.end())
+    {
+    return;
+    }
+  vtkTypeUInt64 orderKey = orderKeyIt->second;
+  this->NodeOrderKeys.erase(orderKeyIt);
+  if (this->NodeClassIndex.empty())
+    {
+    return;
+    }
+  std::vector<NodeClassIndexEntry*>& entries = this->GetNodeClassIndexEntries(node);
+  for (std::vector<NodeClassIndexEntry*>::iterator entryIt = entries.begin(); entryIt != entries.end(); ++entryIt)
+    {
+    NodeClassIndexEntry* entry = *entryIt;
+    // Order keys are sorted, therefore the node can be found by binary search.
+    // The node is not erased from the vector yet to avoid moving all the
+    // subsequent elements at each removal (e.g. when the scene is cleared).
+    std::vector<vtkTypeUInt64>::iterator keyIt =
+      std::lower_bound(entry->OrderKeys.begin(), entry->OrderKeys.end(), orderKey);
+    if (keyIt != entry->OrderKeys.end() && *keyIt == orderKey)
       {
-      // TODO: we should get rid of NodeIDsMTime: the map should always be up
-      // to date.
-      vtkWarningMacro("There is a danger here. What if AddNode or RemoveNode"
-                      " were called prior, the NodeIDsMTime would be in sync"
-                      " without having the map in sync.");
+      entry->Nodes[keyIt - entry->OrderKeys.begin()] = nullptr;
+      entry->NumberOfRemovedNodes++;
       }
-    this->ClearNodeIDs();
-#ifdef MRMLSCENE_VERBOSE
-    std::cerr << "Recompute node id cache..." << std::endl;
-#endif
-    vtkMRMLNode *node;
+    }
+}
+
+//-----------------------------------------------------------------------------
+void vtkMRMLScene::InvalidateNodeClassIndex()
+{
+  this->NodeClassIndex.clear();
+  this->NodeClassIndexEntriesByClassName.clear();
+  this->NodeOrderKeys.clear();
+  this->NodeClassIndexValid = false;
+}
+
+//-----------------------------------------------------------------------------
+std::vector<vtkMRMLScene::NodeClassIndexEntry*>& vtkMRMLScene::GetNodeClassIndexEntries(vtkMRMLNode* node)
+{
+  std::map< std::string, std::vector<NodeClassIndexEntry*> >::iterator entriesIt =
+    this->NodeClassIndexEntriesByClassName.find(node->GetClassName());
+  if (entriesIt != this->NodeClassIndexEntriesByClassName.end())
+    {
+    return entriesIt->second;
+    }
+  // First node of this class since the last time a new class was indexed,
+  // find all the indexed classes this class derives from.
+  std::vector<NodeClassIndexEntry*>& entries = this->NodeClassIndexEntriesByClassName[node->GetClassName()];
+  for (std::map< std::string, NodeClassIndexEntry >::iterator indexIt = this->NodeClassIndex.begin();
+    indexIt != this->NodeClassIndex.end(); ++indexIt)
+    {
+    if (node->IsA(indexIt->first.c_str()))
+      {
+      entries.push_back(&(indexIt->second));
+      }
+    }
+  return entries;
+}
+
+//-----------------------------------------------------------------------------
+void vtkMRMLScene::UpdateNodeOrderKeys()
+{
+  if (this->NodeClassIndexValid)
+    {
+    return;
+    }
+  // Assign new order keys to all the nodes
+  this->NodeOrderKeys.clear();
+  vtkMRMLNode *node = nullptr;
+  vtkCollectionSimpleIterator it;
+  for (this->Nodes->InitTraversal(it);
+       (node = (vtkMRMLNode*)this->Nodes->GetNextItemAsObject(it)) ;)
+    {
+    this->NodeOrderKeys[node] = this->NextNodeOrderKey++;
+    }
+  this->NodeClassIndexValid = true;
+}
+
+//-----------------------------------------------------------------------------
+const std::vector<vtkMRMLNode*>& vtkMRMLScene::GetNodesByClassFromIndex(const char* className)
+{
+  this->UpdateNodeOrderKeys();
+
+  std::map< std::string, NodeClassIndexEntry >::iterator indexIt = this->NodeClassIndex.find(className);
+  if (indexIt == this->NodeClassIndex.end())
+    {
+    // This class has not been queried before, index it now
+    indexIt = this->NodeClassIndex.insert(std::make_pair(std::string(className), NodeClassIndexEntry())).first;
+    NodeClassIndexEntry& newEntry = indexIt->second;
+    vtkMRMLNode *node = nullptr;
     vtkCollectionSimpleIterator it;
     for (this->Nodes->InitTraversal(it);
          (node = (vtkMRMLNode*)this->Nodes->GetNextItemAsObject(it)) ;)
       {
-      if (node->GetID())
+      if (node->IsA(className))
         {
-        this->AddNodeID(node);
+        newEntry.OrderKeys.push_back(this->NodeOrderKeys[node]);
+        newEntry.Nodes.push_back(node);
         }
       }
+    // Nodes added later may derive from this class
+    this->NodeClassIndexEntriesByClassName.clear();
     }
+
+  NodeClassIndexEntry& entry = indexIt->second;
+  if (entry.NumberOfRemovedNodes > 0)
+    {
+    // Compact the entry by erasing removed nodes
+    size_t validNodeIndex = 0;
+    for (size_t nodeIndex = 0; nodeIndex < entry.Nodes.size(); ++nodeIndex)
+      {
+      if (entry.Nodes[nodeIndex] == nullptr)
+        {
+        continue;
+        }
+      entry.Nodes[validNodeIndex] = entry.Nodes[nodeIndex];
+      entry.OrderKeys[validNodeIndex] = entry.OrderKeys[nodeIndex];
+      ++validNodeIndex;
+      }
+    entry.Nodes.resize(validNodeIndex);
+    entry.OrderKeys.resize(validNodeIndex);
+    entry.NumberOfRemovedNodes = 0;
+    }
+  return entry.Nodes;
 }
 
 //-----------------------------------------------------------------------------
-void vtkMRMLScene::AddNodeID(vtkMRMLNode *node)
+void vtkMRMLScene::AddNodeToNameIndex(vtkMRMLNode* node)
 {
-  if (this->Nodes && node && node->GetID())
+  if (!node || !node->GetName())
+    {
+    return;
+    }
+  this->NodesByName[node->GetName()].push_back(node);
+}
+
+//-----------------------------------------------------------------------------
+void vtkMRMLScene::RemoveNodeFromNameIndex(vtkMRMLNode* node, const char* name)
+{
+  if (!node || !name)
+    {
+    return;
+    }
+  std::map< std::string, std::vector<vtkMRMLNode*> >::iterator namedNodesIt = this->NodesByName.find(name);
+  if (namedNodesIt == this->NodesByName.end())
+    {
+    return;
+    }
+  std::vector<vtkMRMLNode*>& namedNodes = namedNodesIt->second;
+  std::vector<vtkMRMLNode*>::iterator nodeIt = std::find(namedNodes.begin(), namedNodes.end(), node);
+  if (nodeIt == namedNodes.end())
+    {
+    return;
+    }
+  namedNodes.erase(nodeIt);
+  if (namedNodes.empty())
     {
-    this->NodeIDs[std::string(node->GetID())] = node;
-    this->NodeIDsMTime = this->Nodes->GetMTime();
+    this->NodesByName.erase(namedNodesIt);
     }
 }
 
 //-----------------------------------------------------------------------------
-void vtkMRMLScene::RemoveNodeID(char *nodeID)
+void vtkMRMLScene::NodeNameChanged(vtkMRMLNode* node, const char* oldName)
 {
-  if (this->Nodes && nodeID)
+  if (!node || node->GetScene() != this)
+    {
+    return;
+    }
+  // Nodes that have their scene set but are not in the scene (e.g. nodes in
+  // the undo stack) must not be indexed.
+  std::map< std::string, std::vector<vtkMRMLNode*> >::iterator namedNodesIt =
+    this->NodesByName.find(oldName ? oldName : "");
+  if (oldName)
     {
-    this->NodeIDs.erase(std::string(nodeID));
-    this->NodeIDsMTime = this->Nodes->GetMTime();
+    if (namedNodesIt == this->NodesByName.end() ||
+        std::find(namedNodesIt->second.begin(), namedNodesIt->second.end(), node) == namedNodesIt->second.end())
+      {
+      return;
+      }
+    this->RemoveNodeFromNameIndex(node, oldName);
+    }
+  else if (!this->IsNodePresent(node))
+    {
+    return;
     }
+  this->AddNodeToNameIndex(node);
 }
 
 //-----------------------------------------------------------------------------
-void vtkMRMLScene::ClearNodeIDs()
+const std::vector<vtkMRMLNode*>* vtkMRMLScene::GetNodesByNameFromIndex(const char* name)
 {
-  if (this->Nodes)
+  std::map< std::string, std::vector<vtkMRMLNode*> >::iterator namedNodesIt = this->NodesByName.find(name);
+  if (namedNodesIt == this->NodesByName.end())
     {
-    this->NodeIDs.clear();
-    this->NodeIDsMTime = this->Nodes->GetMTime();
-  }
+    return nullptr;
+    }
+  std::vector<vtkMRMLNode*>& namedNodes = namedNodesIt->second;
+  if (namedNodes.size() > 1)
+    {
+    // Renamed or inserted nodes may not be in scene order
+    this->UpdateNodeOrderKeys();
+    std::map<vtkMRMLNode*, vtkTypeUInt64>& orderKeys = this->NodeOrderKeys;
+    std::sort(namedNodes.begin(), namedNodes.end(), [&orderKeys](vtkMRMLNode* node1, vtkMRMLNode* node2)
+      {
+      return orderKeys[node1] < orderKeys[node2];
+      });
+    }
+  return &namedNodes;
 }
 
 //------------------------------------------------------------------------------
@@ -3692,12 +4411,94 @@ void vtkMRMLScene::SetMaximumNumberOfSavedUndoStates(int stackSize)
 //-----------------------------------------------------------------------------
 void vtkMRMLScene::TrimUndoStack()
 {
+  // Removed states are deleted when the function returns
   std::list<vtkSmartPointer<vtkCollection> > removedStacks;
   while(static_cast<int>(this->UndoStack.size()) > this->MaximumNumberOfSavedUndoStates)
     {
-    removedStacks.emplace_back(this->UndoStack.front());
+    removedStacks.push_back(vtkSmartPointer<vtkCollection>::Take(this->UndoStack.front()));
+    this->UndoStack.pop_front();
+    }
+  if (this->MaximumUndoStackMemorySize == 0)
+    {
+    return;
+    }
+  // The most recent state is always kept
+  while (this->UndoStack.size() > 1
+    && this->GetUndoStackMemorySize() > this->MaximumUndoStackMemorySize)
+    {
+    // Copies shared with more recent states stay referenced by those states
+    vtkCollection* removedStack = this->UndoStack.front();
     this->UndoStack.pop_front();
+    removedStack->RemoveAllItems();
+    removedStack->Delete();
+    }
+}
+
+//-----------------------------------------------------------------------------
+void vtkMRMLScene::SetMaximumUndoStackMemorySize(unsigned long size)
+{
+  if (size == this->MaximumUndoStackMemorySize)
+    {
+    return;
+    }
+  this->MaximumUndoStackMemorySize = size;
+  this->TrimUndoStack();
+  this->Modified();
+}
+
+//-----------------------------------------------------------------------------
+unsigned long vtkMRMLScene::GetNodesMemorySize()
+{
+  unsigned long size = 0;
+  vtkMRMLNode* node = nullptr;
+  vtkCollectionSimpleIterator it;
+  for (this->Nodes->InitTraversal(it);
+       (node = (vtkMRMLNode*)this->Nodes->GetNextItemAsObject(it)) ;)
+    {
+    size += node->GetContentMemorySize();
     }
+  return size;
+}
+
+//-----------------------------------------------------------------------------
+unsigned long vtkMRMLScene::GetUndoStackMemorySize()
+{
+  unsigned long size = 0;
+  std::set<vtkMRMLNode*> countedNodes;
+  std::list<vtkCollection*>::const_iterator undoStackIt;
+  for (undoStackIt = this->UndoStack.begin(); undoStackIt != this->UndoStack.end(); ++undoStackIt)
+    {
+    vtkMRMLNode* node = nullptr;
+    vtkCollectionSimpleIterator it;
+    for ((*undoStackIt)->InitTraversal(it);
+         (node = (vtkMRMLNode*)(*undoStackIt)->GetNextItemAsObject(it)) ;)
+      {
+      // Nodes of the scene are not copies, they do not use extra memory
+      if (this->GetNodeByID(node->GetID()) == node)
+        {
+        continue;
+        }
+      if (countedNodes.insert(node).second)
+        {
+        size += node->GetContentMemorySize();
+        }
+      }
+    }
+  return size;
+}
+
+//-----------------------------------------------------------------------------
+bool vtkMRMLScene::IsNodeInUndoStack(vtkMRMLNode* node, vtkCollection* excludedState) const
+{
+  std::list<vtkCollection*>::const_iterator undoStackIt;
+  for (undoStackIt = this->UndoStack.begin(); undoStackIt != this->UndoStack.end(); ++undoStackIt)
+    {
+    if (*undoStackIt != excludedState && (*undoStackIt)->IsItemPresent(node))
+      {
+      return true;
+      }
+    }
+  return false;
 }
 
 //----------------------------------------------------------------------------
@@ -3749,7 +4550,13 @@ bool vtkMRMLScene::WriteToMRB(const char* filename, vtkImageData* thumbnail/*=nu
     }
 
   vtkDebugMacro("Zipping to " << mrbFilePath);
-  if (!vtkArchive::Zip(mrbFilePath.c_str(), bundleDir.c_str()))
+  // Files are removed from the bundle directory as soon as they are added to the
+  // archive, so that the peak disk usage is not twice the size of the scene.
+  vtkNew<vtkArchive> archive;
+  bool zipped = archive->OpenZip(mrbFilePath.c_str());
+  zipped = zipped && archive->AddDirectoryContentToZip(bundleDir.c_str(), /* removeAddedFiles= */ true);
+  zipped = archive->CloseZip() && zipped;
+  if (!zipped)
     {
     vtkErrorMacro("Failed to save " << filename << ": Could not compress bundle");
     return false;
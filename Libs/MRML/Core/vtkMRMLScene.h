@@ -21,6 +21,7 @@ Version:   $Revision: 1.18 $
 
 // MRML includes
 #include "vtkMRML.h"
+#include "vtkMRMLNodeIDIndex.h"
 
 // VTK includes
 #include <vtkObject.h>
@@ -61,7 +62,7 @@ class VTK_MRML_EXPORT vtkMRMLScene : public vtkObject
 {
   ///
   /// make the vtkMRMLSceneViewNode a friend since it has internal vtkMRMLScene
-  /// so that it can call protected methods, for example UpdateNodeIDs()
+  /// so that it can call protected methods, for example AddNodeID()
   /// but that's the only class that is allowed to do so
   friend class vtkMRMLSceneViewNode;
 
@@ -262,6 +263,16 @@ public:
   vtkCollection *GetNodesByName(const char* name);
   vtkMRMLNode *GetFirstNodeByName(const char* name);
 
+  /// \brief Update the name index after the name of \a node changed.
+  ///
+  /// It is called by vtkMRMLNode::SetName(), there is no need to call it directly.
+  void NodeNameChanged(vtkMRMLNode* node, const char* oldName);
+
+  /// \brief Update the ID index after the ID of \a node changed.
+  ///
+  /// It is called by vtkMRMLNode::SetID(), there is no need to call it directly.
+  void NodeIDChanged(vtkMRMLNode* node, const char* oldID);
+
   /// \brief Return the first node in the scene that matches the filtering
   /// criteria if specified.
   ///
@@ -650,6 +661,21 @@ public:
   /// EndState() internally pops the state out of the stack.
   void EndState(unsigned long state);
 
+  /// \brief Coalesce observer notifications while the scene is batch processing.
+  ///
+  /// If enabled, the event broker is switched to
+  /// \link vtkEventBroker::Coalesced Coalesced \endlink mode when the scene
+  /// enters \link vtkMRMLScene::BatchProcessState BatchProcessState \endlink:
+  /// repeated events of the same subject are delivered only once per observer.
+  /// Events with call data (e.g. NodeAddedEvent) are still delivered immediately.
+  /// The queued events are flushed by decreasing observation priority right
+  /// before EndBatchProcessEvent is fired, then the previous event mode is restored.
+  /// Disabled by default.
+  /// \sa vtkEventBroker::SetEventMode, StartState, EndState
+  vtkSetMacro(CoalesceEventsDuringBatchProcess, bool);
+  vtkGetMacro(CoalesceEventsDuringBatchProcess, bool);
+  vtkBooleanMacro(CoalesceEventsDuringBatchProcess, bool);
+
   /// TODO: Report progress of the current state.
   void ProgressState(unsigned long state, int progress = 0);
 
@@ -743,11 +769,117 @@ public:
   /// and call StorableModified() on them.
   static void SetStorableNodesModifiedSinceRead(vtkCollection* storableNodes);
 
+  /// \brief Share bulk data arrays between deep copies of nodes (copy-on-write).
+  ///
+  /// If enabled, vtkMRMLNode::CopyContent(deepCopy=true) of volume, model and
+  /// segmentation nodes of this scene shares the image, mesh and segment
+  /// representation arrays instead of duplicating them. This makes scene
+  /// views, sequence snapshots and undo states cost only metadata.
+  /// Code modifying bulk data arrays in place must then call
+  /// vtkMRMLNode::DetachSharedBulkData() first.
+  /// Disabled by default.
+  vtkSetMacro(CopyOnWriteBulkData, bool);
+  vtkGetMacro(CopyOnWriteBulkData, bool);
+  vtkBooleanMacro(CopyOnWriteBulkData, bool);
+
+  /// \brief Instantiate nodes and read their attributes in parallel when
+  /// loading or importing a scene.
+  ///
+  /// If enabled, the scene file is parsed first, then CreateNodeByClass() and
+  /// vtkMRMLNode::ReadXMLAttributes() run on multiple threads. Nodes are
+  /// still added to the scene in file order on the calling thread.
+  /// \sa vtkMRMLParser::SetDeferNodeCreation()
+  /// Disabled by default.
+  vtkSetMacro(ParallelNodeInstantiation, bool);
+  vtkGetMacro(ParallelNodeInstantiation, bool);
+  vtkBooleanMacro(ParallelNodeInstantiation, bool);
+
+  /// \brief Remove all nodes at once when the scene is cleared.
+  ///
+  /// If enabled, Clear() does not invoke NodeAboutToBeRemovedEvent and
+  /// NodeRemovedEvent for each removed node: the node ID, class and name indices
+  /// and node references are cleared wholesale, then the nodes are released
+  /// (in reverse order of addition) before EndCloseEvent is invoked.
+  /// Observers must drop all their node pointers and observations in response to
+  /// StartCloseEvent and must not expect per-node removal events while the scene is closing.
+  /// This makes closing a scene of many thousands of nodes a linear-time operation.
+  /// Disabled by default.
+  /// \sa Clear(), StartCloseEvent, EndCloseEvent
+  vtkSetMacro(BulkClear, bool);
+  vtkGetMacro(BulkClear, bool);
+  vtkBooleanMacro(BulkClear, bool);
+
+  /// \brief Maximum number of threads reading bulk data when importing a scene.
+  ///
+  /// If larger than 1, the files of the imported storable nodes are read
+  /// concurrently by up to this number of worker threads using
+  /// vtkMRMLStorageNode::PrefetchData(), before vtkMRMLNode::UpdateScene()
+  /// sets the data in the nodes and invokes events on the calling thread.
+  /// Only storage nodes that implement PrefetchData() benefit from it.
+  /// Default is 1 (files are read one at a time on the calling thread).
+  vtkSetClampMacro(NumberOfDataReadThreads, int, 1, 256);
+  vtkGetMacro(NumberOfDataReadThreads, int);
+
   /// \brief Sets the maximum number of saved undo states and removes the oldest saved states so that the number of saved
   /// states is less than the new maximum
   void SetMaximumNumberOfSavedUndoStates(int stackSize);
   vtkGetMacro(MaximumNumberOfSavedUndoStates, int);
 
+  /// \brief Sets the maximum amount of memory (in kibibytes) used by the node copies of the undo stack.
+  ///
+  /// The oldest saved states are removed when the limit is exceeded, the most
+  /// recent state is always kept. 0 (default) means no memory limit.
+  /// \sa GetUndoStackMemorySize(), vtkMRMLNode::GetContentMemorySize()
+  void SetMaximumUndoStackMemorySize(unsigned long size);
+  vtkGetMacro(MaximumUndoStackMemorySize, unsigned long);
+
+  /// \brief Approximate memory (in kibibytes) used by the node copies of the undo stack.
+  ///
+  /// Copies shared between multiple undo states are counted once.
+  unsigned long GetUndoStackMemorySize();
+
+  /// \brief Approximate memory (in kibibytes) used by the content of the nodes of the scene.
+  ///
+  /// Bulk data shared between nodes is counted for each node.
+  /// Memory used by the undo stack is not included.
+  /// \sa vtkMRMLNode::GetContentMemorySize(), GetUndoStackMemorySize()
+  unsigned long GetNodesMemorySize();
+
+  /// \brief Record a vtkMRMLStorageNode::ReadData() or WriteData() call in the storage statistics.
+  ///
+  /// Called by storage nodes of the scene after reading or writing their data.
+  /// \sa GetStorageStatisticsReport()
+  void RecordStorageOperation(vtkMRMLStorageNode* storageNode, bool write, bool success);
+
+  /// \brief Remove all recorded storage operations.
+  void ResetStorageStatistics();
+
+  /// \brief Storage statistics: number of data reads and writes, total size of the read
+  /// and written files (in bytes), wall time of reading and writing (in seconds,
+  /// including the time spent in worker threads to prefetch the data), and time
+  /// of decompression (in seconds, for readers that measure it).
+  ///
+  /// Comparing the read time with the import time of a scene tells if loading is
+  /// limited by file reading and decompression or by node updates and event processing.
+  /// \sa vtkMRMLStorageNode::GetLastIOTime(), vtkEventBroker::SetEventProfiling()
+  int GetStorageStatisticsNumberOfReads();
+  int GetStorageStatisticsNumberOfWrites();
+  vtkTypeInt64 GetStorageStatisticsBytesRead();
+  vtkTypeInt64 GetStorageStatisticsBytesWritten();
+  double GetStorageStatisticsReadTime();
+  double GetStorageStatisticsWriteTime();
+  double GetStorageStatisticsDecompressionTime();
+
+  /// \brief Table of the recorded storage operations summarized by file format.
+  std::string GetStorageStatisticsReport();
+
+  /// \brief Log storage statistics at the end of each scene import and commit.
+  ///
+  /// Only operations since the previous log are included. Disabled by default.
+  vtkSetMacro(LogStorageStatistics, bool);
+  vtkGetMacro(LogStorageStatistics, bool);
+  vtkBooleanMacro(LogStorageStatistics, bool);
+
   /// \brief Write the scene to a MRML scene bundle (.mrb) file.
   /// If thumbnail image is provided then it is saved in the scene's root folder.
   /// Returns false if the save failed
@@ -791,6 +923,16 @@ protected:
 
   typedef std::map< std::string, std::set<std::string> > NodeReferencesType;
 
+  /// Nodes of a class (and of its subclasses), sorted by order key.
+  struct NodeClassIndexEntry
+    {
+    NodeClassIndexEntry() : NumberOfRemovedNodes(0) {}
+    std::vector<vtkTypeUInt64> OrderKeys;
+    /// Removed nodes are set to nullptr until the entry is compacted.
+    std::vector<vtkMRMLNode*> Nodes;
+    int NumberOfRemovedNodes;
+    };
+
   vtkMRMLScene();
   ~vtkMRMLScene() override;
 
@@ -810,6 +952,11 @@ protected:
   ///   only directly referenced nodes if false. Default is true.
   void AddReferencedNodes(vtkMRMLNode *node, vtkCollection *refNodes, bool recursive=true);
 
+  /// Read the files of the storable nodes in \a nodes using
+  /// NumberOfDataReadThreads worker threads.
+  /// \sa SetNumberOfDataReadThreads(), vtkMRMLStorageNode::PrefetchData()
+  void PrefetchStorableNodesData(vtkCollection* nodes);
+
   /// Handle vtkMRMLScene::DeleteEvent: clear the scene.
   static void SceneCallback(vtkObject *caller, unsigned long eid, void *clientData, void *callData);
 
@@ -831,25 +978,72 @@ protected:
   /// Combine a basename and an index to produce a full name.
   std::string BuildName(const std::string& baseName, int nameIndex)const;
 
-  /// \brief Synchronize NodeIDs map used to speedup GetByID() method with the
-  /// \a Nodes collection.
-  void UpdateNodeIDs();
-
-  /// Add node to \a NodeIDs map used to speedup GetByID() method.
+  /// Add node to \a NodeIDs index used to speedup GetByID() method.
   void AddNodeID(vtkMRMLNode *node);
 
-  /// Remove node from \a NodeIDs map used to speedup GetByID() method.
-  void RemoveNodeID(char *nodeID);
+  /// Remove node from \a NodeIDs index used to speedup GetByID() method.
+  void RemoveNodeID(vtkMRMLNode *node);
 
-  /// Clear NodeIDs map used to speedup GetByID() method.
+  /// Clear NodeIDs index used to speedup GetByID() method.
   void ClearNodeIDs();
 
+  /// \brief Add node to the per-class index used to speedup GetNodesByClass()
+  /// and related methods.
+  ///
+  /// The node must have been appended to the end of the \a Nodes collection.
+  /// \sa InvalidateNodeClassIndex()
+  void AddNodeToClassIndex(vtkMRMLNode* node);
+
+  /// Remove node from the per-class index.
+  void RemoveNodeFromClassIndex(vtkMRMLNode* node);
+
+  /// \brief Discard the per-class index.
+  ///
+  /// It must be called when the \a Nodes collection is modified in a way
+  /// other than appending nodes at the end (e.g. InsertAfterNode()).
+  /// The index is rebuilt the next time nodes are queried by class.
+  void InvalidateNodeClassIndex();
+
+  /// \brief Get nodes of class \a className (or any of its subclasses) in the
+  /// same order as in the \a Nodes collection.
+  ///
+  /// The first query of a class requires a full traversal of the scene,
+  /// subsequent queries cost time proportional to the number of returned nodes.
+  /// \warning The returned vector is invalidated by any scene modification.
+  const std::vector<vtkMRMLNode*>& GetNodesByClassFromIndex(const char* className);
+
+  /// Get the per-class index entries that \a node belongs to.
+  std::vector<NodeClassIndexEntry*>& GetNodeClassIndexEntries(vtkMRMLNode* node);
+
+  /// Assign order keys to all the nodes if the per-class index has been invalidated.
+  void UpdateNodeOrderKeys();
+
+  /// Add node to \a NodesByName map used to speedup GetNodesByName() and related methods.
+  void AddNodeToNameIndex(vtkMRMLNode* node);
+
+  /// Remove node from \a NodesByName map, \a name is the name the node is indexed with.
+  void RemoveNodeFromNameIndex(vtkMRMLNode* node, const char* name);
+
+  /// \brief Get nodes named \a name in the same order as in the \a Nodes collection.
+  ///
+  /// Returns nullptr if no node has that name.
+  /// \warning The returned vector is invalidated by any scene modification.
+  const std::vector<vtkMRMLNode*>* GetNodesByNameFromIndex(const char* name);
+
+  /// Remove \a referencedID from the IDs referenced by \a referencingID in
+  /// \a ReferencedIDsByReferencingID.
+  void RemoveReferencedIDFromReferencingID(const std::string& referencedID, const std::string& referencingID);
+
   /// Get a NodeReferences iterator for a node reference.
   NodeReferencesType::iterator FindNodeReference(const char* referencedId, vtkMRMLNode* referencingNode);
 
   /// Clean up elements of the undo/redo stack beyond the maximum size
+  /// and the maximum memory size.
   void TrimUndoStack();
 
+  /// Returns true if \a node is in any undo state other than \a excludedState.
+  bool IsNodeInUndoStack(vtkMRMLNode* node, vtkCollection* excludedState) const;
+
   /// Reserve all node reference ids for a node
   void ReserveNodeReferenceIDs(vtkMRMLNode* node);
 
@@ -877,12 +1071,55 @@ protected:
 
   std::vector<unsigned long> States;
 
+  bool CoalesceEventsDuringBatchProcess;
+  bool CopyOnWriteBulkData;
+  bool ParallelNodeInstantiation;
+  bool BulkClear;
+  int NumberOfDataReadThreads;
+
+  /// Storage operation recorded by RecordStorageOperation()
+  struct StorageOperation
+    {
+    bool Write;
+    bool Success;
+    std::string FileFormat;
+    vtkTypeInt64 FileSize;
+    double Time;
+    double DecompressionTime;
+    };
+  std::vector<StorageOperation> StorageOperations;
+  /// Time spent in PrefetchData() by storage nodes whose ReadData() is not recorded yet
+  std::map<vtkMRMLStorageNode*, double> StoragePrefetchTimes;
+  bool LogStorageStatistics{false};
+  /// Number of operations already included in the log
+  size_t NumberOfLoggedStorageOperations{0};
+  /// Summarize operations starting from \a firstOperation
+  std::string GetStorageStatisticsReportSince(size_t firstOperation);
+  void LogStorageStatisticsSinceLastLog(const std::string& title, double elapsedTime);
+
+  /// Event broker mode to restore at the end of batch processing,
+  /// -1 if the event mode was not changed.
+  int EventModeBeforeBatchProcess;
+
   int  MaximumNumberOfSavedUndoStates;
+  unsigned long MaximumUndoStackMemorySize;
   bool UndoFlag;
 
   std::list< vtkCollection* >  UndoStack;
   std::list< vtkCollection* >  RedoStack;
 
+  /// Latest copy made in the undo stack for a node.
+  struct UndoNodeCopy
+  {
+    UndoNodeCopy() : ContentMTime(0) {}
+    vtkWeakPointer<vtkMRMLNode> Copy;
+    /// Content modification time of the node when the copy was made
+    vtkMTimeType ContentMTime;
+  };
+  /// Latest undo copies by node ID. A copy is shared by the next undo states
+  /// as long as the content of the node does not change.
+  std::map< std::string, UndoNodeCopy > LastUndoNodeCopies;
+
   std::string                 URL;
   std::string                 RootDirectory;
 
@@ -894,8 +1131,26 @@ protected:
   std::vector< std::string >  RegisteredNodeTags;
 
   NodeReferencesType NodeReferences; // ReferencedIDs (string), ReferencingNodes (node pointer)
+  /// Same references as \a NodeReferences indexed by the referencing node ID,
+  /// so that the references of a node can be found without visiting all the
+  /// referenced IDs.
+  NodeReferencesType ReferencedIDsByReferencingID; // ReferencingIDs (string), ReferencedIDs (string)
   std::map< std::string, std::string > ReferencedIDChanges;
-  std::map< std::string, vtkSmartPointer<vtkMRMLNode> > NodeIDs;
+  /// Nodes in the scene by ID, kept up-to-date when nodes are added, removed
+  /// or when their ID changes.
+  vtkMRMLNodeIDIndex NodeIDs;
+
+  /// Per-class node index. Only the classes that have been queried are indexed.
+  std::map< std::string, NodeClassIndexEntry > NodeClassIndex;
+  /// Index entries that nodes of a given class (GetClassName()) belong to.
+  std::map< std::string, std::vector<NodeClassIndexEntry*> > NodeClassIndexEntriesByClassName;
+  /// Position of the nodes in the \a Nodes collection, in increasing order.
+  std::map< vtkMRMLNode*, vtkTypeUInt64 > NodeOrderKeys;
+  vtkTypeUInt64 NextNodeOrderKey;
+  bool NodeClassIndexValid;
+
+  /// Nodes in the scene by name
+  std::map< std::string, std::vector<vtkMRMLNode*> > NodesByName;
 
   // Stores default nodes. If a class is created or reset (using CreateNodeByClass or Clear) and
   // a default node is defined for it then the content of the default node will be used to initialize
@@ -912,10 +1167,11 @@ protected:
 
   int ReadDataOnLoad;
 
-  vtkMTimeType  NodeIDsMTime;
-
   void RemoveAllNodes(bool removeSingletons);
 
+  /// Remove nodes without invoking per-node events, used by Clear() if BulkClear is enabled.
+  void RemoveAllNodesBulk(bool removeSingletons);
+
   char * Version;
   char * LastLoadedVersion;
 
@@ -212,8 +212,14 @@ void vtkMRMLSceneViewNode::ProcessChildNode(vtkMRMLNode *node)
     this->SnapshotScene = vtkMRMLScene::New();
     }
   this->SnapshotScene->GetNodes()->vtkCollection::AddItem((vtkObject *)node);
+  if (node->GetID())
+    {
+    this->SynchronizedNodeMTimes.erase(node->GetID());
+    }
 
   this->SnapshotScene->AddNodeID(node);
+  this->SnapshotScene->AddNodeToClassIndex(node);
+  this->SnapshotScene->AddNodeToNameIndex(node);
 
   node->SetScene(this->SnapshotScene);
 
@@ -234,6 +240,7 @@ void vtkMRMLSceneViewNode::Copy(vtkMRMLNode *anode)
   this->SetScreenShotType(vtkMRMLSceneViewNode::SafeDownCast(anode)->GetScreenShotType());
   this->SetSceneViewDescription(vtkMRMLSceneViewNode::SafeDownCast(anode)->GetSceneViewDescription());
 
+  this->SynchronizedNodeMTimes.clear();
   if (this->SnapshotScene == nullptr)
     {
     this->SnapshotScene = vtkMRMLScene::New();
@@ -242,6 +249,8 @@ void vtkMRMLSceneViewNode::Copy(vtkMRMLNode *anode)
     {
     this->SnapshotScene->GetNodes()->RemoveAllItems();
     this->SnapshotScene->ClearNodeIDs();
+    this->SnapshotScene->InvalidateNodeClassIndex();
+    this->SnapshotScene->NodesByName.clear();
     }
   vtkMRMLNode *node = nullptr;
   if ( snode->SnapshotScene != nullptr )
@@ -345,6 +354,7 @@ void vtkMRMLSceneViewNode::StoreScene()
     return;
     }
 
+  this->SynchronizedNodeMTimes.clear();
   if (this->SnapshotScene == nullptr)
     {
     this->SnapshotScene = vtkMRMLScene::New();
@@ -411,6 +421,7 @@ void vtkMRMLSceneViewNode::StoreScene()
       newNode->SetAddToSceneNoModify(1);
       this->SnapshotScene->AddNode(newNode);
       newNode->SetAddToSceneNoModify(0);
+      this->SetNodeSynchronized(node, newNode);
 
       // sanity check
       assert(newNode->GetScene() == this->SnapshotScene);
@@ -482,6 +493,7 @@ void vtkMRMLSceneViewNode::AddMissingNodes()
       newNode->SetAddToSceneNoModify(1);
       this->SnapshotScene->AddNode(newNode);
       newNode->SetAddToSceneNoModify(0);
+      this->SetNodeSynchronized(node, newNode);
 
       // sanity check
       assert(newNode->GetScene() == this->SnapshotScene);
@@ -589,6 +601,8 @@ void vtkMRMLSceneViewNode::RestoreScene(bool removeNodes)
     }
 
   std::vector<vtkMRMLNode *> addedNodes;
+  // pairs of scene node and stored node that have been restored
+  std::vector<std::pair<vtkMRMLNode*, vtkMRMLNode*> > restoredNodes;
   for (n=0; n < numNodesInSceneView; n++)
     {
     node = vtkMRMLNode::SafeDownCast(this->SnapshotScene->GetNodes()->GetItemAsObject(n));
@@ -599,8 +613,14 @@ void vtkMRMLSceneViewNode::RestoreScene(bool removeNodes)
         {
         vtkMRMLNode *snode = this->Scene->GetNodeByID(node->GetID());
 
+        if (snode && this->IsNodeSynchronized(snode, node))
+          {
+          // the node in the scene is the same as in the scene view
+          continue;
+          }
         if (snode)
           {
+          restoredNodes.push_back(std::make_pair(snode, node));
           snode->SetScene(this->Scene);
           // to prevent copying of default info if not stored in snapshot
           MRMLNodeModifyBlocker blocker(snode);
@@ -614,6 +634,7 @@ void vtkMRMLSceneViewNode::RestoreScene(bool removeNodes)
           newNode->CopyWithScene(node);
 
           addedNodes.push_back(newNode);
+          restoredNodes.push_back(std::make_pair(newNode, node));
           newNode->SetAddToSceneNoModify(1);
           this->Scene->AddNode(newNode);
           newNode->Delete();
@@ -626,16 +647,16 @@ void vtkMRMLSceneViewNode::RestoreScene(bool removeNodes)
       }
     }
 
-  // update all nodes in the scene
+  // update the restored nodes (unchanged nodes are already up-to-date)
 
   //this->Scene->UpdateNodeReferences(this->Nodes);
 
-  for (sceneNodes->InitTraversal(it);
-       (node = vtkMRMLNode::SafeDownCast(sceneNodes->GetNextItemAsObject(it))) ;)
+  for (std::vector<std::pair<vtkMRMLNode*, vtkMRMLNode*> >::iterator restoredIt = restoredNodes.begin();
+       restoredIt != restoredNodes.end(); ++restoredIt)
     {
-    if (this->IncludeNodeInSceneView(node) && node->GetSaveWithScene())
+    if (restoredIt->first->GetScene() == this->Scene && restoredIt->first->GetSaveWithScene())
       {
-      node->UpdateScene(this->Scene);
+      restoredIt->first->UpdateScene(this->Scene);
       }
     }
 
@@ -648,6 +669,15 @@ void vtkMRMLSceneViewNode::RestoreScene(bool removeNodes)
 
   this->Scene->EndState(vtkMRMLScene::RestoreState);
 
+  for (std::vector<std::pair<vtkMRMLNode*, vtkMRMLNode*> >::iterator restoredIt = restoredNodes.begin();
+       restoredIt != restoredNodes.end(); ++restoredIt)
+    {
+    if (restoredIt->first->GetScene() == this->Scene)
+      {
+      this->SetNodeSynchronized(restoredIt->first, restoredIt->second);
+      }
+    }
+
 #ifndef NDEBUG
   // sanity checks
   for (sceneNodes->InitTraversal(it);
@@ -658,6 +688,41 @@ void vtkMRMLSceneViewNode::RestoreScene(bool removeNodes)
 #endif
 }
 
+//----------------------------------------------------------------------------
+void vtkMRMLSceneViewNode::SetNodeSynchronized(vtkMRMLNode* sceneNode, vtkMRMLNode* storedNode)
+{
+  if (!sceneNode || !storedNode || !storedNode->GetID())
+    {
+    return;
+    }
+  // Content modified in place would not be detected, these nodes are always restored
+  if (!sceneNode->IsContentMTimeTracked() || !storedNode->IsContentMTimeTracked())
+    {
+    this->SynchronizedNodeMTimes.erase(storedNode->GetID());
+    return;
+    }
+  this->SynchronizedNodeMTimes[storedNode->GetID()] =
+    std::make_pair(sceneNode->GetContentMTime(), storedNode->GetContentMTime());
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLSceneViewNode::IsNodeSynchronized(vtkMRMLNode* sceneNode, vtkMRMLNode* storedNode)
+{
+  if (!sceneNode || !storedNode || !storedNode->GetID()
+    || !sceneNode->IsContentMTimeTracked() || !storedNode->IsContentMTimeTracked())
+    {
+    return false;
+    }
+  std::map<std::string, std::pair<vtkMTimeType, vtkMTimeType> >::iterator it =
+    this->SynchronizedNodeMTimes.find(storedNode->GetID());
+  if (it == this->SynchronizedNodeMTimes.end())
+    {
+    return false;
+    }
+  return sceneNode->GetContentMTime() <= it->second.first
+    && storedNode->GetContentMTime() <= it->second.second;
+}
+
 //----------------------------------------------------------------------------
 vtkMRMLScene* vtkMRMLSceneViewNode::GetStoredScene()
 {
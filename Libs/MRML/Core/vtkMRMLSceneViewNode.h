@@ -20,6 +20,11 @@
 // VTK includes
 #include <vtkStdString.h>
 class vtkCollection;
+
+// STD includes
+#include <map>
+#include <utility>
+
 class vtkImageData;
 
 class vtkMRMLStorageNode;
@@ -83,6 +88,11 @@ class VTK_MRML_EXPORT vtkMRMLSceneViewNode : public vtkMRMLStorableNode
   /// do no appear in the scene view. If it is false, and nodes are found that will be
   /// deleted, don't remove them, print a warning, set the scene error code to 1, save
   /// the warning to the scene error message, and return.
+  /// Only the nodes that differ from the scene view are copied and updated: nodes
+  /// of the main scene that have not been modified since they were stored in
+  /// (or restored from) this scene view are left untouched.
+  /// If vtkMRMLScene::CopyOnWriteBulkData is enabled, the stored nodes share their
+  /// bulk data (images, meshes, segments) with the nodes of the main scene.
   /// \sa GetStoredScene() StoreScene() AddMissingNodes()
   void RestoreScene(bool removeNodes = true);
 
@@ -137,6 +147,17 @@ protected:
 
   vtkMRMLScene* SnapshotScene;
 
+  /// Record that the scene node and the stored node have the same content.
+  /// Only nodes that track their content modification time are recorded.
+  /// \sa vtkMRMLNode::IsContentMTimeTracked()
+  void SetNodeSynchronized(vtkMRMLNode* sceneNode, vtkMRMLNode* storedNode);
+  /// Return true if neither node was modified since SetNodeSynchronized().
+  bool IsNodeSynchronized(vtkMRMLNode* sceneNode, vtkMRMLNode* storedNode);
+
+  /// Content modification time of the scene node and of the stored node
+  /// when they were last synchronized, by node ID.
+  std::map<std::string, std::pair<vtkMTimeType, vtkMTimeType> > SynchronizedNodeMTimes;
+
   /// The associated Description
   vtkStdString SceneViewDescription;
 
@@ -58,6 +58,7 @@
 
 // STD includes
 #include <algorithm>
+#include <set>
 
 //----------------------------------------------------------------------------
 vtkMRMLNodeNewMacro(vtkMRMLSegmentationNode);
@@ -152,16 +153,23 @@ void vtkMRMLSegmentationNode::CopyContent(vtkMRMLNode* anode, bool deepCopy/*=tr
     {
     if (node->GetSegmentation())
       {
-      if (this->GetSegmentation())
+      vtkSmartPointer<vtkSegmentation> targetSegmentation = this->GetSegmentation();
+      if (!targetSegmentation)
         {
-        this->GetSegmentation()->DeepCopy(node->GetSegmentation());
+        targetSegmentation = vtkSmartPointer<vtkSegmentation>::Take(node->GetSegmentation()->NewInstance());
+        }
+      if (this->GetCopyOnWriteBulkData(node))
+        {
+        // representation data is shared until DetachSharedBulkData() is called
+        targetSegmentation->CopyWithSharedRepresentationData(node->GetSegmentation());
         }
       else
         {
-        vtkSmartPointer<vtkSegmentation> newSegmentation
-          = vtkSmartPointer<vtkSegmentation>::Take(node->GetSegmentation()->NewInstance());
-        newSegmentation->DeepCopy(node->GetSegmentation());
-        this->SetAndObserveSegmentation(newSegmentation);
+        targetSegmentation->DeepCopy(node->GetSegmentation());
+        }
+      if (targetSegmentation != this->GetSegmentation())
+        {
+        this->SetAndObserveSegmentation(targetSegmentation);
         }
       }
     else
@@ -439,6 +447,106 @@ void vtkMRMLSegmentationNode::CreateDefaultDisplayNodes()
   this->SetAndObserveDisplayNodeID(displayNode->GetID());
 }
 
+//----------------------------------------------------------------------------
+vtkMTimeType vtkMRMLSegmentationNode::GetContentMTime()
+{
+  vtkMTimeType mTime = this->Superclass::GetContentMTime();
+  if (!this->Segmentation)
+    {
+    return mTime;
+    }
+  mTime = std::max(mTime, this->Segmentation->GetMTime());
+  for (int segmentIndex = 0; segmentIndex < this->Segmentation->GetNumberOfSegments(); ++segmentIndex)
+    {
+    vtkSegment* segment = this->Segmentation->GetNthSegment(segmentIndex);
+    mTime = std::max(mTime, segment->GetMTime());
+    std::vector<std::string> representationNames;
+    segment->GetContainedRepresentationNames(representationNames);
+    for (std::vector<std::string>::iterator nameIt = representationNames.begin(); nameIt != representationNames.end(); ++nameIt)
+      {
+      vtkDataObject* representation = segment->GetRepresentation(*nameIt);
+      if (representation)
+        {
+        mTime = std::max(mTime, representation->GetMTime());
+        }
+      }
+    }
+  return mTime;
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLSegmentationNode::IsContentMTimeTracked()
+{
+  return true;
+}
+
+//----------------------------------------------------------------------------
+unsigned long vtkMRMLSegmentationNode::GetContentMemorySize()
+{
+  unsigned long size = this->Superclass::GetContentMemorySize();
+  // Representations may be shared between segments, count them only once
+  std::vector<vtkDataObject*> representations;
+  this->GetUniqueRepresentations(representations);
+  for (std::vector<vtkDataObject*>::iterator representationIt = representations.begin(); representationIt != representations.end(); ++representationIt)
+    {
+    size += (*representationIt)->GetActualMemorySize();
+    }
+  return size;
+}
+
+//---------------------------------------------------------------------------
+void vtkMRMLSegmentationNode::GetUniqueRepresentations(std::vector<vtkDataObject*>& representations)
+{
+  representations.clear();
+  if (!this->Segmentation)
+    {
+    return;
+    }
+  std::set<vtkDataObject*> visitedRepresentations;
+  for (int segmentIndex = 0; segmentIndex < this->Segmentation->GetNumberOfSegments(); ++segmentIndex)
+    {
+    vtkSegment* segment = this->Segmentation->GetNthSegment(segmentIndex);
+    std::vector<std::string> representationNames;
+    segment->GetContainedRepresentationNames(representationNames);
+    for (std::vector<std::string>::iterator nameIt = representationNames.begin(); nameIt != representationNames.end(); ++nameIt)
+      {
+      vtkDataObject* representation = segment->GetRepresentation(*nameIt);
+      if (representation && visitedRepresentations.insert(representation).second)
+        {
+        representations.push_back(representation);
+        }
+      }
+    }
+}
+
+//---------------------------------------------------------------------------
+bool vtkMRMLSegmentationNode::IsBulkDataShared()
+{
+  std::vector<vtkDataObject*> representations;
+  this->GetUniqueRepresentations(representations);
+  for (std::vector<vtkDataObject*>::iterator representationIt = representations.begin(); representationIt != representations.end(); ++representationIt)
+    {
+    if (vtkMRMLNode::IsDataObjectShared(*representationIt))
+      {
+      return true;
+      }
+    }
+  return false;
+}
+
+//---------------------------------------------------------------------------
+bool vtkMRMLSegmentationNode::DetachSharedBulkData()
+{
+  std::vector<vtkDataObject*> representations;
+  this->GetUniqueRepresentations(representations);
+  bool detached = false;
+  for (std::vector<vtkDataObject*>::iterator representationIt = representations.begin(); representationIt != representations.end(); ++representationIt)
+    {
+    detached = vtkMRMLNode::DetachSharedDataObject(*representationIt) || detached;
+    }
+  return detached;
+}
+
 //---------------------------------------------------------------------------
 void vtkMRMLSegmentationNode::ApplyTransformMatrix(vtkMatrix4x4* transformMatrix)
 {
@@ -105,6 +105,16 @@ public:
   /// Create and observe a segmentation display node
   void CreateDefaultDisplayNodes() override;
 
+  /// Take into account the modification time and size of the segment representations.
+  vtkMTimeType GetContentMTime() override;
+  bool IsContentMTimeTracked() override;
+  unsigned long GetContentMemorySize() override;
+
+  /// Check and detach segment representation arrays shared with deep copies.
+  /// \sa vtkMRMLScene::SetCopyOnWriteBulkData
+  bool IsBulkDataShared() override;
+  bool DetachSharedBulkData() override;
+
   /// Function called from segmentation logic when UID is added in a subject hierarchy node.
   /// In case the newly added UID is a volume node referenced from this segmentation,
   /// its geometry will be set as image geometry conversion parameter.
@@ -300,6 +310,10 @@ protected:
   /// Set segmentation object
   vtkSetObjectMacro(Segmentation, vtkSegmentation);
 
+  /// Get all representation objects of the segmentation.
+  /// Representations shared between segments are listed only once.
+  void GetUniqueRepresentations(std::vector<vtkDataObject*>& representations);
+
   /// Callback function for all events from the segmentation object.
   static void SegmentationModifiedCallback(vtkObject* caller, unsigned long eid, void* clientData, void* callData);
 
@@ -36,11 +36,8 @@
 #include <vtkDoubleArray.h>
 #include <vtkErrorCode.h>
 #include <vtkFieldData.h>
-#include <vtkImageAccumulate.h>
 #include <vtkImageAppendComponents.h>
 #include <vtkImageCast.h>
-#include <vtkImageConstantPad.h>
-#include <vtkImageExtractComponents.h>
 #include <vtkInformation.h>
 #include <vtkInformationIntegerVectorKey.h>
 #include <vtkInformationStringKey.h>
@@ -68,7 +65,9 @@
 #endif
 
 // STL & C++ includes
+#include <algorithm>
 #include <iterator>
+#include <map>
 #include <sstream>
 
 //----------------------------------------------------------------------------
@@ -89,6 +88,152 @@ static const std::string KEY_SEGMENTATION_REFERENCE_IMAGE_EXTENT_OFFSET = "Refer
 static const std::string KEY_SEGMENTATION_CONTAINED_REPRESENTATION_NAMES = "ContainedRepresentationNames";
 
 static const int SINGLE_SEGMENT_INDEX = -1; // used as segment index when there is only a single segment
+
+namespace
+{
+/// Effective extent (voxels with the label) of each label value
+typedef std::map<vtkIdType, std::vector<int> > LabelExtentMap;
+
+//----------------------------------------------------------------------------
+template <class T>
+void ComputeLabelExtentsGeneric(vtkImageData* image, int component, LabelExtentMap& labelExtents)
+{
+  int* extent = image->GetExtent();
+  int numberOfComponents = image->GetNumberOfScalarComponents();
+  T* voxelPtr = static_cast<T*>(image->GetScalarPointer()) + component;
+  // Voxels of the same label usually follow each other, so the map is only searched when the label changes
+  vtkIdType lastLabel = 0;
+  std::vector<int>* lastLabelExtent = nullptr;
+  for (int k = extent[4]; k <= extent[5]; ++k)
+    {
+    for (int j = extent[2]; j <= extent[3]; ++j)
+      {
+      for (int i = extent[0]; i <= extent[1]; ++i, voxelPtr += numberOfComponents)
+        {
+        vtkIdType label = static_cast<vtkIdType>(*voxelPtr);
+        if (label == 0)
+          {
+          continue;
+          }
+        if (!lastLabelExtent || label != lastLabel)
+          {
+          LabelExtentMap::iterator labelIt = labelExtents.find(label);
+          if (labelIt == labelExtents.end())
+            {
+            int voxelExtent[6] = { i, i, j, j, k, k };
+            labelIt = labelExtents.insert(LabelExtentMap::value_type(label, std::vector<int>(voxelExtent, voxelExtent + 6))).first;
+            }
+          lastLabel = label;
+          lastLabelExtent = &(labelIt->second);
+          }
+        std::vector<int>& labelExtent = *lastLabelExtent;
+        if (i < labelExtent[0]) { labelExtent[0] = i; }
+        if (i > labelExtent[1]) { labelExtent[1] = i; }
+        if (j < labelExtent[2]) { labelExtent[2] = j; }
+        if (j > labelExtent[3]) { labelExtent[3] = j; }
+        if (k < labelExtent[4]) { labelExtent[4] = k; }
+        if (k > labelExtent[5]) { labelExtent[5] = k; }
+        }
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+/// Find all non-zero label values in a component of the image and their extent, in one pass over the voxels
+void ComputeLabelExtents(vtkImageData* image, int component, LabelExtentMap& labelExtents)
+{
+  labelExtents.clear();
+  if (!image->GetPointData()->GetScalars())
+    {
+    return;
+    }
+  switch (image->GetScalarType())
+    {
+    vtkTemplateMacro(ComputeLabelExtentsGeneric<VTK_TT>(image, component, labelExtents));
+    default:
+      break;
+    }
+}
+
+//----------------------------------------------------------------------------
+void MergeExtent(int extent[6], const int extentToAdd[6])
+{
+  if (extentToAdd[0] > extentToAdd[1] || extentToAdd[2] > extentToAdd[3] || extentToAdd[4] > extentToAdd[5])
+    {
+    return;
+    }
+  if (extent[0] > extent[1] || extent[2] > extent[3] || extent[4] > extent[5])
+    {
+    std::copy(extentToAdd, extentToAdd + 6, extent);
+    return;
+    }
+  for (int i = 0; i < 3; ++i)
+    {
+    extent[2 * i] = std::min(extent[2 * i], extentToAdd[2 * i]);
+    extent[2 * i + 1] = std::max(extent[2 * i + 1], extentToAdd[2 * i + 1]);
+    }
+}
+
+//----------------------------------------------------------------------------
+template <class T>
+void ExtractLabelmapComponentGeneric(vtkImageData* image, int component, const int copyExtent[6], vtkImageData* labelmap)
+{
+  int numberOfComponents = image->GetNumberOfScalarComponents();
+  for (int k = copyExtent[4]; k <= copyExtent[5]; ++k)
+    {
+    for (int j = copyExtent[2]; j <= copyExtent[3]; ++j)
+      {
+      T* inputPtr = static_cast<T*>(image->GetScalarPointer(copyExtent[0], j, k)) + component;
+      T* outputPtr = static_cast<T*>(labelmap->GetScalarPointer(copyExtent[0], j, k));
+      for (int i = copyExtent[0]; i <= copyExtent[1]; ++i, inputPtr += numberOfComponents)
+        {
+        *(outputPtr++) = *inputPtr;
+        }
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+/// Copy a component of the image into the labelmap, cropped or padded with 0 to the specified extent.
+/// The image buffer is shared if no cropping, padding or component extraction is needed.
+void ExtractLabelmapComponent(vtkImageData* image, int component, const int extent[6], vtkOrientedImageData* labelmap)
+{
+  int* imageExtent = image->GetExtent();
+  if (image->GetNumberOfScalarComponents() == 1 && std::equal(extent, extent + 6, imageExtent))
+    {
+    labelmap->ShallowCopy(image);
+    return;
+    }
+
+  int labelmapExtent[6] = { extent[0], extent[1], extent[2], extent[3], extent[4], extent[5] };
+  labelmap->SetExtent(labelmapExtent);
+  labelmap->AllocateScalars(image->GetScalarType(), 1);
+
+  int copyExtent[6] = { 0, -1, 0, -1, 0, -1 };
+  bool padding = false;
+  for (int i = 0; i < 3; ++i)
+    {
+    copyExtent[2 * i] = std::max(extent[2 * i], imageExtent[2 * i]);
+    copyExtent[2 * i + 1] = std::min(extent[2 * i + 1], imageExtent[2 * i + 1]);
+    padding = padding || copyExtent[2 * i] != extent[2 * i] || copyExtent[2 * i + 1] != extent[2 * i + 1];
+    }
+  if (padding)
+    {
+    vtkOrientedImageDataResample::FillImage(labelmap, 0);
+    }
+  if (copyExtent[0] > copyExtent[1] || copyExtent[2] > copyExtent[3] || copyExtent[4] > copyExtent[5])
+    {
+    return;
+    }
+  switch (image->GetScalarType())
+    {
+    vtkTemplateMacro(ExtractLabelmapComponentGeneric<VTK_TT>(image, component, copyExtent, labelmap));
+    default:
+      break;
+    }
+}
+}
+
 //----------------------------------------------------------------------------
 vtkMRMLNodeNewMacro(vtkMRMLSegmentationStorageNode);
 
@@ -642,65 +787,42 @@ int vtkMRMLSegmentationStorageNode::ReadBinaryLabelmapRepresentation(vtkMRMLSegm
   vtkMatrix4x4::Invert(rasToIjk.GetPointer(), imageToWorldMatrix.GetPointer());
 
   imageData->SetExtent(commonGeometryExtent);
-  vtkNew<vtkImageExtractComponents> extractComponents;
-  extractComponents->SetInputData(imageData);
-
-  vtkNew<vtkImageConstantPad> padder;
-  padder->SetInputConnection(extractComponents->GetOutputPort());
 
   // Get metadata for current segment
   itk::MetaDataDictionary dictionary = archetypeImageReader->GetMetaDataDictionary();
 
   std::vector<vtkSmartPointer<vtkSegment> > segments(numberOfSegments);
-  std::map<int, vtkSmartPointer<vtkOrientedImageData> > layerToImage;
   for (int frameIndex = 0; frameIndex < numberOfFrames; ++frameIndex)
     {
-    // Create binary labelmap volume
-    vtkSmartPointer<vtkOrientedImageData> currentBinaryLabelmap = nullptr;
-
     if (numberOfSegments == 0)
       {
-      currentBinaryLabelmap = vtkSmartPointer<vtkOrientedImageData>::New();
-      extractComponents->SetComponents(frameIndex);
-      padder->SetOutputWholeExtent(imageExtentInFile);
-      padder->Update();
-      currentBinaryLabelmap->ShallowCopy(padder->GetOutput());
-
-      double scalarRange[2] = { 0 };
-      currentBinaryLabelmap->GetScalarRange(scalarRange);
-      vtkIdType lowLabel = (vtkIdType)(floor(scalarRange[0]));
-      vtkIdType highLabel = (vtkIdType)(ceil(scalarRange[1]));
-
-      vtkSmartPointer<vtkImageAccumulate> imageAccumulate = vtkSmartPointer<vtkImageAccumulate>::New();
-      imageAccumulate->SetInputData(currentBinaryLabelmap);
-      imageAccumulate->IgnoreZeroOn(); // Ignore background value
-      imageAccumulate->SetComponentExtent(lowLabel, highLabel, 0, 0, 0, 0);
-      imageAccumulate->SetComponentOrigin(0, 0, 0);
-      imageAccumulate->SetComponentSpacing(1, 1, 1);
-      imageAccumulate->Update();
-
-      std::vector<vtkIdType> labelValues;
-      for (vtkIdType labelValue = lowLabel; labelValue <= highLabel; ++labelValue)
+      // Each label value becomes a segment. Label values are collected in a single sweep
+      // and all the segments share the labelmap of the frame.
+      LabelExtentMap labelExtents;
+      ComputeLabelExtents(imageData, frameIndex, labelExtents);
+      if (labelExtents.empty())
+        {
+        continue;
+        }
+      vtkSmartPointer<vtkOrientedImageData> currentBinaryLabelmap = vtkSmartPointer<vtkOrientedImageData>::New();
+      ExtractLabelmapComponent(imageData, frameIndex, commonGeometryExtent, currentBinaryLabelmap);
+      currentBinaryLabelmap->SetImageToWorldMatrix(imageToWorldMatrix.GetPointer());
+      for (LabelExtentMap::iterator labelIt = labelExtents.begin(); labelIt != labelExtents.end(); ++labelIt)
         {
-        if (labelValue == 0)
-          {
-          continue;
-          }
-        double frequency = imageAccumulate->GetOutput()->GetPointData()->GetScalars()->GetTuple1(labelValue - lowLabel);
-        if (frequency == 0.0)
-          {
-          continue;
-          }
         vtkSmartPointer<vtkSegment> currentSegment = vtkSmartPointer<vtkSegment>::New();
-        currentSegment->SetLabelValue(labelValue);
-        currentBinaryLabelmap->SetImageToWorldMatrix(imageToWorldMatrix.GetPointer());
+        currentSegment->SetLabelValue(labelIt->first);
         currentSegment->AddRepresentation(vtkSegmentationConverter::GetBinaryLabelmapRepresentationName(), currentBinaryLabelmap);
         segments.push_back(currentSegment);
         }
       }
     else
       {
-      for (int segmentIndex : segmentIndexInLayer[frameIndex])
+      // The shared labelmap of the layer covers the extent of all the segments in it
+      int layerExtent[6] = { 0, -1, 0, -1, 0, -1 };
+      LabelExtentMap labelExtents;
+      bool labelExtentsComputed = false;
+      const std::vector<int>& layerSegmentIndices = segmentIndexInLayer[frameIndex];
+      for (int segmentIndex : layerSegmentIndices)
         {
         // Create segment
         vtkSmartPointer<vtkSegment> currentSegment = vtkSmartPointer<vtkSegment>::New();
@@ -746,59 +868,60 @@ int vtkMRMLSegmentationStorageNode::ReadBinaryLabelmapRepresentation(vtkMRMLSegm
           currentSegment->SetLabelValue(vtkVariant(labelValue).ToInt());
           }
 
-        if (currentBinaryLabelmap == nullptr)
+        // Extent
+        int currentSegmentExtent[6] = { 0, -1, 0, -1, 0, -1 };
+        std::string currentExtentString;
+        if (this->GetSegmentMetaDataFromDicitionary(currentExtentString, dictionary, segmentIndex, KEY_SEGMENT_EXTENT))
           {
-          currentBinaryLabelmap = vtkSmartPointer<vtkOrientedImageData>::New();
-
-          // Extent
-          int currentSegmentExtent[6] = { 0, -1, 0, -1, 0, -1 };
-          std::string currentExtentString;
-          if (this->GetSegmentMetaDataFromDicitionary(currentExtentString, dictionary, segmentIndex, KEY_SEGMENT_EXTENT))
-            {
-            GetImageExtentFromString(currentSegmentExtent, currentExtentString);
-            }
-          else
-            {
-            vtkWarningMacro("Segment extent is missing for segment " << segmentIndex);
-            for (int i = 0; i < 6; i++)
-              {
-              currentSegmentExtent[i] = imageExtentInFile[i];
-              }
-            }
+          GetImageExtentFromString(currentSegmentExtent, currentExtentString);
           for (int i = 0; i < 3; i++)
             {
             currentSegmentExtent[i * 2] += referenceImageExtentOffset[i];
             currentSegmentExtent[i * 2 + 1] += referenceImageExtentOffset[i];
             }
-          // Copy with clipping to specified extent
-          if (currentSegmentExtent[0] <= currentSegmentExtent[1]
-            && currentSegmentExtent[2] <= currentSegmentExtent[3]
-            && currentSegmentExtent[4] <= currentSegmentExtent[5])
+          }
+        else
+          {
+          vtkWarningMacro("Segment extent is missing for segment " << segmentIndex);
+          // Use the effective extent of the label, the extents of all labels of the layer are computed at once
+          if (!labelExtentsComputed)
             {
-            // non-empty segment
-            extractComponents->SetComponents(frameIndex);
-            padder->SetOutputWholeExtent(currentSegmentExtent);
-            padder->Update();
-            currentBinaryLabelmap->DeepCopy(padder->GetOutput());
+            ComputeLabelExtents(imageData, frameIndex, labelExtents);
+            labelExtentsComputed = true;
             }
-          else
+          LabelExtentMap::iterator labelIt = labelExtents.find(currentSegment->GetLabelValue());
+          if (labelIt != labelExtents.end())
             {
-            // empty segment
-            for (int i = 0; i < 3; ++i)
-              {
-              currentSegmentExtent[2 * i] = 0;
-              currentSegmentExtent[2 * i + 1] = -1;
-              }
-            currentBinaryLabelmap->SetExtent(currentSegmentExtent);
-            currentBinaryLabelmap->AllocateScalars(VTK_UNSIGNED_CHAR, 1);
+            std::copy(labelIt->second.begin(), labelIt->second.end(), currentSegmentExtent);
             }
-          currentBinaryLabelmap->SetImageToWorldMatrix(imageToWorldMatrix.GetPointer());
           }
+        MergeExtent(layerExtent, currentSegmentExtent);
 
-        // Set loaded binary labelmap to segment
-        currentSegment->AddRepresentation(vtkSegmentationConverter::GetSegmentationBinaryLabelmapRepresentationName(), currentBinaryLabelmap);
         segments[segmentIndex] = currentSegment;
         }
+
+      // Create the binary labelmap shared by the segments of the layer
+      vtkSmartPointer<vtkOrientedImageData> currentBinaryLabelmap = vtkSmartPointer<vtkOrientedImageData>::New();
+      if (layerExtent[0] <= layerExtent[1]
+        && layerExtent[2] <= layerExtent[3]
+        && layerExtent[4] <= layerExtent[5])
+        {
+        // non-empty layer, copy with clipping to the layer extent
+        ExtractLabelmapComponent(imageData, frameIndex, layerExtent, currentBinaryLabelmap);
+        }
+      else
+        {
+        // empty layer
+        currentBinaryLabelmap->SetExtent(layerExtent);
+        currentBinaryLabelmap->AllocateScalars(VTK_UNSIGNED_CHAR, 1);
+        }
+      currentBinaryLabelmap->SetImageToWorldMatrix(imageToWorldMatrix.GetPointer());
+
+      // Set loaded binary labelmap to segments
+      for (int segmentIndex : layerSegmentIndices)
+        {
+        segments[segmentIndex]->AddRepresentation(vtkSegmentationConverter::GetSegmentationBinaryLabelmapRepresentationName(), currentBinaryLabelmap);
+        }
       }
     }
 
@@ -824,9 +947,8 @@ int vtkMRMLSegmentationStorageNode::ReadBinaryLabelmapRepresentation(vtkMRMLSegm
         // We consider a segmentation empty if it has only one scalar component that is empty.
         if (numberOfFrames == 1)
           {
-          extractComponents->SetComponents(segmentIndex);
-          extractComponents->Update();
-          vtkImageData* labelmap = extractComponents->GetOutput();
+          vtkImageData* labelmap = vtkImageData::SafeDownCast(
+            currentSegment->GetRepresentation(vtkSegmentationConverter::GetSegmentationBinaryLabelmapRepresentationName()));
           double* scalarRange = labelmap->GetScalarRange();
           if (scalarRange[0] >= scalarRange[1])
             {
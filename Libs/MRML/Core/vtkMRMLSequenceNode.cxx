@@ -22,17 +22,21 @@
 #include "vtkMRMLStorableNode.h"
 
 // MRML includes
+#include <vtkMRMLLinearTransformNode.h>
 #include <vtkMRMLScene.h>
 
 // VTK includes
 #include <vtkNew.h>
 #include <vtkCollection.h>
+#include <vtkMatrix4x4.h>
 #include <vtkNew.h>
 #include <vtkObjectFactory.h>
 #include <vtkSmartPointer.h>
 #include <vtkTimerLog.h>
 
 // STD includes
+#include <algorithm>
+#include <iomanip>
 #include <sstream>
 
 #define SAFE_CHAR_POINTER(unsafeString) ( unsafeString==nullptr?"":unsafeString )
@@ -80,6 +84,9 @@ vtkMRMLSequenceNode::~vtkMRMLSequenceNode()
 void vtkMRMLSequenceNode::RemoveAllDataNodes()
 {
   this->IndexEntries.clear();
+  this->TextIndexItemNumbersValid = false;
+  this->MatrixElements.clear();
+  this->DataNodesFromMatrices.clear();
   if (!this->SequenceScene)
     {
     return;
@@ -122,6 +129,11 @@ void vtkMRMLSequenceNode::WriteXML(ostream& of, int nIndent)
         // this is normal when sequence node is in scene view
         of << indexIt->DataNodeID << ":" << indexIt->IndexValue;
         }
+      else if (indexIt->MatrixOffset >= 0)
+        {
+        // item is stored as a matrix, it is restored from the sequence file
+        of << "matrix:" << indexIt->IndexValue;
+        }
       else
         {
         vtkErrorMacro("Error while writing node "<<(this->GetID()?this->GetID():"(unknown)")
@@ -191,6 +203,7 @@ void vtkMRMLSequenceNode::ReadIndexValues(const std::string& indexText)
     this->IndexEntries.clear();
     modified = true;
     }
+  this->TextIndexItemNumbersValid = false;
 
   std::stringstream ss(indexText);
   std::string nodeId_indexValue;
@@ -204,6 +217,7 @@ void vtkMRMLSequenceNode::ReadIndexValues(const std::string& indexText)
 
       IndexEntryType indexEntry;
       indexEntry.IndexValue=indexValue;
+      indexEntry.NumericIndexValue = atof(indexValue.c_str());
       // The nodes are not read yet, so we can only store the node ID and get the pointer to the node later (in UpdateScene())
       indexEntry.DataNodeID=nodeId;
       indexEntry.DataNode=nullptr;
@@ -245,6 +259,16 @@ void vtkMRMLSequenceNode::Copy(vtkMRMLNode *anode)
     }
   this->SequenceScene=vtkMRMLScene::New();
 
+  // Items that are stored as matrices are copied as matrices, without their transform nodes
+  std::set<vtkMRMLNode*> dataNodesFromMatrices;
+  for (std::deque< IndexEntryType >::iterator sourceIndexIt = snode->IndexEntries.begin(); sourceIndexIt != snode->IndexEntries.end(); ++sourceIndexIt)
+    {
+    if (sourceIndexIt->MatrixOffset >= 0 && sourceIndexIt->DataNode != nullptr)
+      {
+      dataNodesFromMatrices.insert(sourceIndexIt->DataNode);
+      }
+    }
+
   if (snode->SequenceScene)
     {
     for (int n = 0; n < snode->SequenceScene->GetNodes()->GetNumberOfItems(); n++)
@@ -255,16 +279,36 @@ void vtkMRMLSequenceNode::Copy(vtkMRMLNode *anode)
         vtkErrorMacro("Invalid node in vtkMRMLSequenceNode");
         continue;
         }
+      if (dataNodesFromMatrices.find(node) != dataNodesFromMatrices.end())
+        {
+        continue;
+        }
       this->DeepCopyNodeToScene(node, this->SequenceScene);
       }
     }
 
   this->IndexEntries.clear();
+  this->TextIndexItemNumbersValid = false;
+  this->MatrixElements = snode->MatrixElements;
+  this->DataNodesFromMatrices.clear();
+  vtkNew<vtkMatrix4x4> matrix;
   for(std::deque< IndexEntryType >::iterator sourceIndexIt=snode->IndexEntries.begin(); sourceIndexIt!=snode->IndexEntries.end(); ++sourceIndexIt)
     {
     IndexEntryType seqItem;
     seqItem.IndexValue=sourceIndexIt->IndexValue;
+    seqItem.NumericIndexValue = sourceIndexIt->NumericIndexValue;
     seqItem.DataNode = nullptr;
+    if (sourceIndexIt->MatrixOffset >= 0)
+      {
+      // The transform node of the item may have been modified, so get the current matrix
+      seqItem.MatrixOffset = sourceIndexIt->MatrixOffset;
+      if (snode->GetNthMatrix(static_cast<int>(sourceIndexIt - snode->IndexEntries.begin()), matrix))
+        {
+        std::copy(&matrix->Element[0][0], &matrix->Element[0][0] + 16, this->MatrixElements.begin() + seqItem.MatrixOffset);
+        }
+      this->IndexEntries.push_back(seqItem);
+      continue;
+      }
     if (sourceIndexIt->DataNode!=nullptr)
       {
       seqItem.DataNode=this->SequenceScene->GetNodeByID(sourceIndexIt->DataNode->GetID());
@@ -299,10 +343,12 @@ void vtkMRMLSequenceNode::CopySequenceIndex(vtkMRMLNode *anode)
   if (this->IndexEntries.size() > 0 || snode->IndexEntries.size() > 0)
     {
     this->IndexEntries.clear();
+    this->TextIndexItemNumbersValid = false;
     for (std::deque< IndexEntryType >::iterator sourceIndexIt = snode->IndexEntries.begin(); sourceIndexIt != snode->IndexEntries.end(); ++sourceIndexIt)
       {
       IndexEntryType seqItem;
       seqItem.IndexValue = sourceIndexIt->IndexValue;
+      seqItem.NumericIndexValue = sourceIndexIt->NumericIndexValue;
       if (sourceIndexIt->DataNode != nullptr)
         {
         seqItem.DataNodeID = sourceIndexIt->DataNode->GetID();
@@ -374,9 +420,9 @@ int vtkMRMLSequenceNode::GetInsertPosition(const std::string& indexValue)
   int insertPosition = this->IndexEntries.size();
   if (this->IndexType == vtkMRMLSequenceNode::NumericIndex && !this->IndexEntries.empty())
     {
-    int itemNumber = this->GetItemNumberFromIndexValue(indexValue, false);
     double numericIndexValue = atof(indexValue.c_str());
-    double foundNumericIndexValue = atof(this->IndexEntries[itemNumber].IndexValue.c_str());
+    int itemNumber = this->GetItemNumberFromNumericIndexValue(numericIndexValue, false);
+    double foundNumericIndexValue = this->IndexEntries[itemNumber].NumericIndexValue;
     if (numericIndexValue < foundNumericIndexValue) // Deals with case of index value being smaller than any in the sequence and numeric tolerances
       {
       insertPosition = itemNumber;
@@ -390,7 +436,30 @@ int vtkMRMLSequenceNode::GetInsertPosition(const std::string& indexValue)
 }
 
 //----------------------------------------------------------------------------
-vtkMRMLNode* vtkMRMLSequenceNode::SetDataNodeAtValue(vtkMRMLNode* node, const std::string& indexValue)
+int vtkMRMLSequenceNode::InsertIndexEntry(const std::string& indexValue)
+{
+  int seqItemIndex = this->GetInsertPosition(indexValue);
+  IndexEntryType seqItem;
+  seqItem.IndexValue = indexValue;
+  seqItem.NumericIndexValue = atof(indexValue.c_str());
+  this->IndexEntries.insert(this->IndexEntries.begin() + seqItemIndex, seqItem);
+  if (seqItemIndex == static_cast<int>(this->IndexEntries.size()) - 1)
+    {
+    // Appending does not change item number of other items, so the text index can be kept up-to-date
+    if (this->TextIndexItemNumbersValid)
+      {
+      this->TextIndexItemNumbers.emplace(indexValue, seqItemIndex);
+      }
+    }
+  else
+    {
+    this->TextIndexItemNumbersValid = false;
+    }
+  return seqItemIndex;
+}
+
+//----------------------------------------------------------------------------
+vtkMRMLNode* vtkMRMLSequenceNode::SetDataNodeAtValue(vtkMRMLNode* node, const std::string& indexValue, bool shallowCopy /* = false */)
 {
   if (node == nullptr)
     {
@@ -400,19 +469,16 @@ vtkMRMLNode* vtkMRMLSequenceNode::SetDataNodeAtValue(vtkMRMLNode* node, const st
   // Make sure the sequence scene is created
   this->GetSequenceScene();
   // Add a copy of the node to the sequence's scene
-  vtkMRMLNode* newNode = this->DeepCopyNodeToScene(node, this->SequenceScene);
+  vtkMRMLNode* newNode = this->DeepCopyNodeToScene(node, this->SequenceScene, shallowCopy);
   int seqItemIndex = this->GetItemNumberFromIndexValue(indexValue);
   if (seqItemIndex<0)
     {
     // The sequence item doesn't exist yet
-    seqItemIndex = GetInsertPosition(indexValue);
-    // Create new item
-    IndexEntryType seqItem;
-    seqItem.IndexValue = indexValue;
-    this->IndexEntries.insert(this->IndexEntries.begin() + seqItemIndex, seqItem);
+    seqItemIndex = this->InsertIndexEntry(indexValue);
     }
   this->IndexEntries[seqItemIndex].DataNode = newNode;
   this->IndexEntries[seqItemIndex].DataNodeID.clear();
+  this->IndexEntries[seqItemIndex].MatrixOffset = -1;
   this->Modified();
   this->StorableModifiedTime.Modified();
   return newNode;
@@ -427,14 +493,19 @@ void vtkMRMLSequenceNode::RemoveDataNodeAtValue(const std::string& indexValue)
     vtkWarningMacro("vtkMRMLSequenceNode::RemoveDataNodeAtValue: node was not found at index value "<<indexValue);
     return;
     }
-  if (!this->SequenceScene)
+  vtkMRMLNode* dataNode = this->IndexEntries[seqItemIndex].DataNode;
+  if (dataNode)
     {
-    vtkWarningMacro("vtkMRMLSequenceNode::RemoveDataNodeAtValue: internal scene is already empty");
-    return;
+    if (!this->SequenceScene)
+      {
+      vtkWarningMacro("vtkMRMLSequenceNode::RemoveDataNodeAtValue: internal scene is already empty");
+      return;
+      }
+    // TODO: remove associated nodes as well (such as storage node)?
+    this->SequenceScene->RemoveNode(dataNode);
     }
-  // TODO: remove associated nodes as well (such as storage node)?
-  this->SequenceScene->RemoveNode(this->IndexEntries[seqItemIndex].DataNode);
   this->IndexEntries.erase(this->IndexEntries.begin()+seqItemIndex);
+  this->TextIndexItemNumbersValid = false;
   this->Modified();
   this->StorableModifiedTime.Modified();
 }
@@ -442,8 +513,7 @@ void vtkMRMLSequenceNode::RemoveDataNodeAtValue(const std::string& indexValue)
 //---------------------------------------------------------------------------
 int vtkMRMLSequenceNode::GetItemNumberFromIndexValue(const std::string& indexValue, bool exactMatchRequired /* =true */)
 {
-  int numberOfSeqItems=this->IndexEntries.size();
-  if (numberOfSeqItems == 0)
+  if (this->IndexEntries.empty())
     {
     return -1;
     }
@@ -451,76 +521,97 @@ int vtkMRMLSequenceNode::GetItemNumberFromIndexValue(const std::string& indexVal
   // Binary search will be faster for numeric index
   if (this->IndexType == NumericIndex)
     {
-    int lowerBound = 0;
-    int upperBound = numberOfSeqItems-1;
+    return this->GetItemNumberFromNumericIndexValue(atof(indexValue.c_str()), exactMatchRequired);
+    }
 
-    // Deal with index values not within the range of index values in the Sequence
-    double numericIndexValue = atof(indexValue.c_str());
-    double lowerNumericIndexValue = atof(this->IndexEntries[lowerBound].IndexValue.c_str());
-    double upperNumericIndexValue = atof(this->IndexEntries[upperBound].IndexValue.c_str());
-    if (numericIndexValue <= lowerNumericIndexValue + this->NumericIndexValueTolerance)
-      {
-      if (numericIndexValue < lowerNumericIndexValue - this->NumericIndexValueTolerance && exactMatchRequired)
-        {
-        return -1;
-        }
-      else
-        {
-        return lowerBound;
-        }
-      }
-    if (numericIndexValue >= upperNumericIndexValue - this->NumericIndexValueTolerance)
+  // Hash lookup for non-numeric index
+  if (!this->TextIndexItemNumbersValid)
+    {
+    this->TextIndexItemNumbers.clear();
+    int numberOfSeqItems = static_cast<int>(this->IndexEntries.size());
+    for (int i = 0; i < numberOfSeqItems; i++)
       {
-      if (numericIndexValue > upperNumericIndexValue + this->NumericIndexValueTolerance && exactMatchRequired)
-        {
-        return -1;
-        }
-      else
-        {
-        return upperBound;
-        }
+      // if an index value is not unique then the first item is found
+      this->TextIndexItemNumbers.emplace(this->IndexEntries[i].IndexValue, i);
       }
+    this->TextIndexItemNumbersValid = true;
+    }
+  std::unordered_map<std::string, int>::iterator itemNumberIt = this->TextIndexItemNumbers.find(indexValue);
+  if (itemNumberIt == this->TextIndexItemNumbers.end())
+    {
+    return -1;
+    }
+  return itemNumberIt->second;
+}
+
+//---------------------------------------------------------------------------
+int vtkMRMLSequenceNode::GetItemNumberFromNumericIndexValue(double numericIndexValue, bool exactMatchRequired /* =true */)
+{
+  int numberOfSeqItems=this->IndexEntries.size();
+  if (numberOfSeqItems == 0)
+    {
+    return -1;
+    }
 
-    while (upperBound - lowerBound > 1)
+  int lowerBound = 0;
+  int upperBound = numberOfSeqItems-1;
+
+  // Deal with index values not within the range of index values in the Sequence
+  double lowerNumericIndexValue = this->IndexEntries[lowerBound].NumericIndexValue;
+  double upperNumericIndexValue = this->IndexEntries[upperBound].NumericIndexValue;
+  if (numericIndexValue <= lowerNumericIndexValue + this->NumericIndexValueTolerance)
+    {
+    if (numericIndexValue < lowerNumericIndexValue - this->NumericIndexValueTolerance && exactMatchRequired)
       {
-      // Note that if middle is equal to either lowerBound or upperBound then upperBound - lowerBound <= 1
-      int middle = int((lowerBound + upperBound)/2);
-      double middleNumericIndexValue = atof(this->IndexEntries[middle].IndexValue.c_str());
-      if (fabs(numericIndexValue - middleNumericIndexValue) <= this->NumericIndexValueTolerance)
-        {
-        return middle;
-        }
-      if (numericIndexValue > middleNumericIndexValue)
-        {
-        lowerBound = middle;
-        }
-      if (numericIndexValue < middleNumericIndexValue)
-        {
-        upperBound = middle;
-        }
+      return -1;
       }
-    if (!exactMatchRequired)
+    else
       {
       return lowerBound;
       }
     }
-
-  // Need linear search for non-numeric index
-  for (int i=0; i<numberOfSeqItems; i++)
+  if (numericIndexValue >= upperNumericIndexValue - this->NumericIndexValueTolerance)
     {
-    if (this->IndexEntries[i].IndexValue.compare(indexValue)==0)
+    if (numericIndexValue > upperNumericIndexValue + this->NumericIndexValueTolerance && exactMatchRequired)
       {
-      return i;
+      return -1;
+      }
+    else
+      {
+      return upperBound;
       }
     }
 
+  while (upperBound - lowerBound > 1)
+    {
+    // Note that if middle is equal to either lowerBound or upperBound then upperBound - lowerBound <= 1
+    int middle = int((lowerBound + upperBound)/2);
+    double middleNumericIndexValue = this->IndexEntries[middle].NumericIndexValue;
+    if (fabs(numericIndexValue - middleNumericIndexValue) <= this->NumericIndexValueTolerance)
+      {
+      return middle;
+      }
+    if (numericIndexValue > middleNumericIndexValue)
+      {
+      lowerBound = middle;
+      }
+    if (numericIndexValue < middleNumericIndexValue)
+      {
+      upperBound = middle;
+      }
+    }
+  if (!exactMatchRequired)
+    {
+    return lowerBound;
+    }
+  // Items are sorted by numeric index value, so there is no item within tolerance
   return -1;
 }
 
 //---------------------------------------------------------------------------
 vtkMRMLNode* vtkMRMLSequenceNode::GetDataNodeAtValue(const std::string& indexValue, bool exactMatchRequired /* =true */)
 {
-  if (!this->SequenceScene)
+  if (!this->SequenceScene && this->MatrixElements.empty())
     {
     // no data nodes are stored
     return nullptr;
@@ -531,7 +622,7 @@ vtkMRMLNode* vtkMRMLSequenceNode::GetDataNodeAtValue(const std::string& indexVal
     // not found
     return nullptr;
     }
-  return this->IndexEntries[seqItemIndex].DataNode;
+  return this->GetNthDataNode(seqItemIndex);
 }
 
 //---------------------------------------------------------------------------
@@ -572,6 +663,8 @@ bool vtkMRMLSequenceNode::UpdateIndexValue(const std::string& oldIndexValue, con
     }
   // Update the index value
   this->IndexEntries[oldSeqItemIndex].IndexValue = newIndexValue;
+  this->IndexEntries[oldSeqItemIndex].NumericIndexValue = atof(newIndexValue.c_str());
+  this->TextIndexItemNumbersValid = false;
   if (this->IndexType == vtkMRMLSequenceNode::NumericIndex)
     {
     IndexEntryType movingEntry = this->IndexEntries[oldSeqItemIndex];
@@ -594,7 +687,7 @@ std::string vtkMRMLSequenceNode::GetDataNodeClassName()
     return "";
     }
   // All the nodes should be of the same class, so just get the class from the first one
-  vtkMRMLNode* node=this->IndexEntries[0].DataNode;
+  vtkMRMLNode* node=this->GetNthDataNode(0);
   if (node==nullptr)
     {
     vtkErrorMacro("vtkMRMLSequenceNode::GetDataNodeClassName node is invalid");
@@ -613,7 +706,7 @@ std::string vtkMRMLSequenceNode::GetDataNodeTagName()
     return undefinedReturn;
     }
   // All the nodes should be of the same class, so just get the class from the first one
-  vtkMRMLNode* node=this->IndexEntries[0].DataNode;
+  vtkMRMLNode* node=this->GetNthDataNode(0);
   if (node==nullptr)
     {
     vtkErrorMacro("vtkMRMLSequenceNode::GetDataNodeClassName node is invalid");
@@ -635,9 +728,157 @@ vtkMRMLNode* vtkMRMLSequenceNode::GetNthDataNode(int itemNumber)
     vtkErrorMacro("vtkMRMLSequenceNode::GetNthDataNode failed: itemNumber "<<itemNumber<<" is out of range");
     return nullptr;
     }
+  if (!this->IndexEntries[itemNumber].DataNode && this->IndexEntries[itemNumber].MatrixOffset >= 0)
+    {
+    return this->CreateDataNodeFromMatrix(itemNumber);
+    }
   return this->IndexEntries[itemNumber].DataNode;
 }
 
+//-----------------------------------------------------------------------------
+void vtkMRMLSequenceNode::SetMatrixAtValue(vtkMatrix4x4* matrixToParent, const std::string& indexValue)
+{
+  if (matrixToParent == nullptr)
+    {
+    vtkErrorMacro("vtkMRMLSequenceNode::SetMatrixAtValue failed, invalid matrix");
+    return;
+    }
+  int seqItemIndex = this->GetItemNumberFromIndexValue(indexValue);
+  if (seqItemIndex < 0)
+    {
+    // The sequence item doesn't exist yet
+    seqItemIndex = this->InsertIndexEntry(indexValue);
+    }
+  IndexEntryType& seqItem = this->IndexEntries[seqItemIndex];
+  if (seqItem.DataNode)
+    {
+    // The matrix replaces the previous data node
+    this->SequenceScene->RemoveNode(seqItem.DataNode);
+    seqItem.DataNode = nullptr;
+    }
+  seqItem.DataNodeID.clear();
+  if (seqItem.MatrixOffset < 0)
+    {
+    seqItem.MatrixOffset = static_cast<int>(this->MatrixElements.size());
+    this->MatrixElements.resize(this->MatrixElements.size() + 16);
+    }
+  std::copy(&matrixToParent->Element[0][0], &matrixToParent->Element[0][0] + 16, this->MatrixElements.begin() + seqItem.MatrixOffset);
+  this->Modified();
+  this->StorableModifiedTime.Modified();
+}
+
+//-----------------------------------------------------------------------------
+bool vtkMRMLSequenceNode::GetNthMatrix(int itemNumber, vtkMatrix4x4* matrixToParent)
+{
+  if (itemNumber < 0 || itemNumber >= static_cast<int>(this->IndexEntries.size()) || !matrixToParent)
+    {
+    vtkErrorMacro("vtkMRMLSequenceNode::GetNthMatrix failed: itemNumber " << itemNumber << " is out of range");
+    return false;
+    }
+  const IndexEntryType& seqItem = this->IndexEntries[itemNumber];
+  if (seqItem.DataNode)
+    {
+    // The transform node may have been modified, therefore it is the most up-to-date
+    vtkMRMLTransformNode* transformNode = vtkMRMLTransformNode::SafeDownCast(seqItem.DataNode);
+    if (!transformNode || !transformNode->IsLinear())
+      {
+      return false;
+      }
+    transformNode->GetMatrixTransformToParent(matrixToParent);
+    return true;
+    }
+  if (seqItem.MatrixOffset < 0)
+    {
+    return false;
+    }
+  matrixToParent->DeepCopy(&this->MatrixElements[seqItem.MatrixOffset]);
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+void vtkMRMLSequenceNode::ConvertMatricesToDataNodes()
+{
+  if (this->MatrixElements.empty())
+    {
+    return;
+    }
+  int numberOfItems = static_cast<int>(this->IndexEntries.size());
+  // Prevent releasing the newly created nodes
+  int maximumNumberOfDataNodesFromMatrices = this->MaximumNumberOfDataNodesFromMatrices;
+  this->MaximumNumberOfDataNodesFromMatrices = numberOfItems + 1;
+  for (int itemNumber = 0; itemNumber < numberOfItems; ++itemNumber)
+    {
+    this->GetNthDataNode(itemNumber);
+    this->IndexEntries[itemNumber].MatrixOffset = -1;
+    }
+  this->MatrixElements.clear();
+  this->DataNodesFromMatrices.clear();
+  this->MaximumNumberOfDataNodesFromMatrices = maximumNumberOfDataNodesFromMatrices;
+}
+
+//-----------------------------------------------------------------------------
+vtkMRMLNode* vtkMRMLSequenceNode::CreateDataNodeFromMatrix(int itemNumber)
+{
+  IndexEntryType& seqItem = this->IndexEntries[itemNumber];
+  std::string baseName = "Transform";
+  if (this->GetAttribute("Sequences.Source"))
+    {
+    baseName = this->GetAttribute("Sequences.Source");
+    }
+  else if (this->GetName())
+    {
+    baseName = this->GetName();
+    }
+  std::ostringstream nameStr;
+  nameStr << baseName << "_" << std::setw(4) << std::setfill('0') << itemNumber;
+
+  vtkNew<vtkMatrix4x4> matrix;
+  matrix->DeepCopy(&this->MatrixElements[seqItem.MatrixOffset]);
+  vtkNew<vtkMRMLLinearTransformNode> transformNode;
+  transformNode->SetMatrixTransformToParent(matrix);
+  transformNode->SetName(nameStr.str().c_str());
+  transformNode->SetAttribute("Sequences.BaseName", baseName.c_str());
+  seqItem.DataNode = this->GetSequenceScene()->AddNode(transformNode);
+
+  this->DataNodesFromMatrices.push_back(std::make_pair(seqItem.IndexValue, seqItem.DataNode));
+  vtkMRMLNode* dataNode = seqItem.DataNode;
+  this->ReleaseDataNodesFromMatrices();
+  return dataNode;
+}
+
+//-----------------------------------------------------------------------------
+void vtkMRMLSequenceNode::ReleaseDataNodesFromMatrices()
+{
+  vtkNew<vtkMatrix4x4> matrix;
+  while (static_cast<int>(this->DataNodesFromMatrices.size()) > this->MaximumNumberOfDataNodesFromMatrices)
+    {
+    std::pair<std::string, vtkMRMLNode*> dataNodeFromMatrix = this->DataNodesFromMatrices.front();
+    this->DataNodesFromMatrices.pop_front();
+    int itemNumber = this->GetItemNumberFromIndexValue(dataNodeFromMatrix.first);
+    if (itemNumber < 0)
+      {
+      // item has been removed
+      continue;
+      }
+    IndexEntryType& seqItem = this->IndexEntries[itemNumber];
+    if (seqItem.DataNode != dataNodeFromMatrix.second || seqItem.MatrixOffset < 0)
+      {
+      // item has been replaced
+      continue;
+      }
+    if (!this->GetNthMatrix(itemNumber, matrix))
+      {
+      // transform is not linear anymore, keep it as a regular data node
+      seqItem.MatrixOffset = -1;
+      continue;
+      }
+    // Keep changes that were made by modifying the transform node
+    std::copy(&matrix->Element[0][0], &matrix->Element[0][0] + 16, this->MatrixElements.begin() + seqItem.MatrixOffset);
+    this->SequenceScene->RemoveNode(seqItem.DataNode);
+    seqItem.DataNode = nullptr;
+    }
+}
+
 //-----------------------------------------------------------------------------
 vtkMRMLScene* vtkMRMLSequenceNode::GetSequenceScene(bool autoCreate/*=true*/)
 {
@@ -648,6 +889,21 @@ vtkMRMLScene* vtkMRMLSequenceNode::GetSequenceScene(bool autoCreate/*=true*/)
   return this->SequenceScene;
 }
 
+//-----------------------------------------------------------------------------
+unsigned long vtkMRMLSequenceNode::GetContentMemorySize()
+{
+  unsigned long size = this->Superclass::GetContentMemorySize();
+  for (std::deque< IndexEntryType >::iterator indexIt = this->IndexEntries.begin(); indexIt != this->IndexEntries.end(); ++indexIt)
+    {
+    if (indexIt->DataNode)
+      {
+      size += indexIt->DataNode->GetContentMemorySize();
+      }
+    }
+  size += static_cast<unsigned long>(this->MatrixElements.size() * sizeof(double) / 1024);
+  return size;
+}
+
 //-----------------------------------------------------------------------------
 vtkMRMLStorageNode* vtkMRMLSequenceNode::CreateDefaultStorageNode()
 {
@@ -666,7 +922,8 @@ vtkMRMLStorageNode* vtkMRMLSequenceNode::CreateDefaultStorageNode()
 std::string vtkMRMLSequenceNode::GetDefaultStorageNodeClassName(const char* filename /* =nullptr */)
 {
   // No need to create storage node if there are no nodes to store
-  if (this->GetSequenceScene() == nullptr || this->GetSequenceScene()->GetNumberOfNodes() == 0)
+  if ((this->GetSequenceScene() == nullptr || this->GetSequenceScene()->GetNumberOfNodes() == 0)
+    && this->MatrixElements.empty())
     {
     return "";
     }
@@ -764,7 +1021,7 @@ int vtkMRMLSequenceNode::GetIndexTypeFromString(const std::string& indexTypeStri
   return -1;
 }
 
-vtkMRMLNode* vtkMRMLSequenceNode::DeepCopyNodeToScene(vtkMRMLNode* source, vtkMRMLScene* scene)
+vtkMRMLNode* vtkMRMLSequenceNode::DeepCopyNodeToScene(vtkMRMLNode* source, vtkMRMLScene* scene, bool shallowCopy /* = false */)
 {
   if (source == nullptr)
     {
@@ -783,7 +1040,7 @@ vtkMRMLNode* vtkMRMLSequenceNode::DeepCopyNodeToScene(vtkMRMLNode* source, vtkMR
   std::string newNodeName = baseName;
 
   vtkSmartPointer<vtkMRMLNode> target = vtkSmartPointer<vtkMRMLNode>::Take(source->CreateNodeInstance());
-  target->CopyContent(source); // deep-copy
+  target->CopyContent(source, !shallowCopy);
 
   // Generating unique node names is slow, and makes adding many nodes to a sequence too slow
   // We will instead ensure that all file names for storable nodes are unique when saving
@@ -25,6 +25,10 @@
 // std includes
 #include <deque>
 #include <set>
+#include <unordered_map>
+#include <vector>
+
+class vtkMatrix4x4;
 
 
 /// \brief MRML node for representing a sequence of MRML nodes
@@ -99,9 +103,27 @@ public:
 
   /// Add a copy of the provided node to this sequence as a data node.
   /// If a sequence item is not found by that index, a new item is added.
-  /// Always performs deep-copy.
+  /// Performs deep-copy by default. Shallow copy may be used if the provided node
+  /// is not used anymore by the caller (e.g., it is a temporary copy of a proxy node).
   /// Returns the data node copy that has just been created.
-  vtkMRMLNode* SetDataNodeAtValue(vtkMRMLNode* node, const std::string& indexValue);
+  vtkMRMLNode* SetDataNodeAtValue(vtkMRMLNode* node, const std::string& indexValue, bool shallowCopy = false);
+
+  /// Add a linear transform to this sequence, stored as a matrix instead of a data node.
+  /// Matrices are stored in a single contiguous array, which makes sequences of many
+  /// linear transforms (such as tracking recordings) much faster to create, load, and copy.
+  /// Transform nodes are created only for items that are accessed by GetDataNodeAtValue
+  /// or GetNthDataNode. If many transform nodes are created then the least recently created
+  /// ones are released (their matrix is stored in the array).
+  /// If a sequence item is not found by that index, a new item is added.
+  void SetMatrixAtValue(vtkMatrix4x4* matrixToParent, const std::string& indexValue);
+
+  /// Get the matrix of the n-th item without creating a data node.
+  /// Returns false if the item is not a linear transform.
+  bool GetNthMatrix(int itemNumber, vtkMatrix4x4* matrixToParent);
+
+  /// Create data nodes for all items that are stored as matrices.
+  /// After this all items are stored as regular data nodes.
+  void ConvertMatricesToDataNodes();
 
   /// Update an existing data node.
   /// Return true if a data node was found by that index.
@@ -127,6 +149,11 @@ public:
   /// If the sequences has numeric index, uses data node just before the index value in the case of non-exact match
   int GetItemNumberFromIndexValue(const std::string& indexValue, bool exactMatchRequired = true);
 
+  /// Get item number from a numeric index value. Faster than GetItemNumberFromIndexValue
+  /// if the same index value is looked up in many sequences, as the value has to be parsed only once.
+  /// Uses binary search in the sorted numeric index values. Only valid for sequences with numeric index.
+  int GetItemNumberFromNumericIndexValue(double numericIndexValue, bool exactMatchRequired = true);
+
   /// Change index value of an existing data node.
   bool UpdateIndexValue(const std::string& oldIndexValue, const std::string& newIndexValue);
 
@@ -156,6 +183,10 @@ public:
   /// Update node IDs in case of node ID conflicts on scene import
   void UpdateScene(vtkMRMLScene *scene) override;
 
+  /// Approximate size of the data nodes and matrices of all items in kibibytes.
+  /// Data nodes are not created for items that are stored as matrices.
+  unsigned long GetContentMemorySize() override;
+
   /// Type of the index. Controls the behavior of sorting, finding, etc.
   /// Additional types may be added in the future, such as tag cloud, two-dimensional index, ...
   enum IndexTypes
@@ -175,15 +206,28 @@ protected:
   /// If numeric index then insert it by respecting sorting order, otherwise insert to the end.
   int GetInsertPosition(const std::string& indexValue);
 
+  /// Insert a new item with the specified index value (at the position returned by GetInsertPosition).
+  /// Returns the item number of the new item.
+  int InsertIndexEntry(const std::string& indexValue);
+
   void ReadIndexValues(const std::string& indexText);
 
-  vtkMRMLNode* DeepCopyNodeToScene(vtkMRMLNode* source, vtkMRMLScene* scene);
+  vtkMRMLNode* DeepCopyNodeToScene(vtkMRMLNode* source, vtkMRMLScene* scene, bool shallowCopy = false);
+
+  /// Create a transform node in the sequence scene for an item that is stored as a matrix
+  vtkMRMLNode* CreateDataNodeFromMatrix(int itemNumber);
+
+  /// Remove the least recently created transform nodes of items that are stored as matrices
+  /// if there are more than MaximumNumberOfDataNodesFromMatrices.
+  void ReleaseDataNodesFromMatrices();
 
   struct IndexEntryType
     {
     std::string IndexValue;
-    vtkMRMLNode* DataNode;
+    double NumericIndexValue{0.0}; // IndexValue converted to number, to avoid parsing strings during search
+    vtkMRMLNode* DataNode{nullptr};
     std::string DataNodeID; // only used temporarily, during scene load
+    int MatrixOffset{-1}; // position of the item in MatrixElements, -1 if the item is not stored as a matrix
     };
 
 protected:
@@ -200,6 +244,19 @@ protected:
 
   /// List of data items (the scene may contain some more nodes, such as storage nodes)
   std::deque< IndexEntryType > IndexEntries;
+
+  /// Item number of text index values for fast lookup.
+  /// Updated when an item is appended, rebuilt on next lookup when items are removed or reordered.
+  std::unordered_map<std::string, int> TextIndexItemNumbers;
+  bool TextIndexItemNumbersValid{false};
+
+  /// Matrix elements (16 values in row-major order) of items that are stored as matrices
+  std::vector<double> MatrixElements;
+
+  /// Index value and transform node of items that are stored as matrices and
+  /// have a transform node created, in the order of creation
+  std::deque< std::pair<std::string, vtkMRMLNode*> > DataNodesFromMatrices;
+  int MaximumNumberOfDataNodesFromMatrices{32};
 };
 
 #endif
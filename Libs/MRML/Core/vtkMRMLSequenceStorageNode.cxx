@@ -140,6 +140,9 @@ int vtkMRMLSequenceStorageNode::WriteDataInternal(vtkMRMLNode *refNode)
 {
   vtkMRMLSequenceNode *sequenceNode = vtkMRMLSequenceNode::SafeDownCast(refNode);
 
+  // All items are written from the sequence scene, therefore they must be stored as data nodes
+  sequenceNode->ConvertMatricesToDataNodes();
+
   // Custom nodes (such as vtkMRMLSceneView node) must be registered in the sequence scene,
   // otherwise we could not create default storage nodes.
   if (this->GetScene() && sequenceNode->GetSequenceScene())
@@ -229,6 +232,7 @@ std::string vtkMRMLSequenceStorageNode::GetSequenceBaseName(const std::string& f
   recognizedExtensions.push_back(std::string(NODE_BASE_NAME_SEPARATOR) + "Seq.seq.mhd");
   recognizedExtensions.push_back(std::string(NODE_BASE_NAME_SEPARATOR) + "Seq.seq.nrrd");
   recognizedExtensions.push_back(std::string(NODE_BASE_NAME_SEPARATOR) + "Seq.seq.nhdr");
+  recognizedExtensions.push_back(".tfm.seq.nrrd");
   recognizedExtensions.push_back(".seq.mrb");
   recognizedExtensions.push_back(".seq.mha");
   recognizedExtensions.push_back(".seq.mhd");
@@ -27,6 +27,7 @@ Version:   $Revision: 1.1.1.1 $
 #include <vtkCommand.h>
 #include <vtkNew.h>
 #include <vtkStringArray.h>
+#include <vtkTimerLog.h>
 #include <vtkURIHandler.h>
 
 // VTKSYS includes
@@ -34,6 +35,7 @@ Version:   $Revision: 1.1.1.1 $
 
 // STD includes
 #include <algorithm>
+#include <set>
 #include <sstream>
 
 //----------------------------------------------------------------------------
@@ -394,6 +396,10 @@ void vtkMRMLStorageNode::PrintSelf(ostream& os, vtkIndent indent)
 
   os << indent << "ReadState:  " << this->GetReadStateAsString() << "\n";
   os << indent << "WriteState: " << this->GetWriteStateAsString() << "\n";
+  os << indent << "LastIOFileSize: " << this->LastIOFileSize << "\n";
+  os << indent << "LastIOTime: " << this->LastIOTime << "\n";
+  os << indent << "LastIODecompressionTime: " << this->LastIODecompressionTime << "\n";
+  os << indent << "LastIOFileFormat: " << this->LastIOFileFormat << "\n";
   os << indent << "SupportedWriteFileTypes: \n";
   for(int i=0; i<this->SupportedWriteFileTypes->GetNumberOfTuples(); i++)
     {
@@ -1270,7 +1276,10 @@ int vtkMRMLStorageNode::ReadData(vtkMRMLNode* refNode, bool temporary)
   vtkDebugMacro("ReadData: read state is ready, "
     <<  "URI = " << (this->GetURI() == nullptr ? "null" : this->GetURI()) << ", "
     << "filename = " << (this->GetFileName() == nullptr ? "null" : this->GetFileName()));
+  this->LastIODecompressionTime = 0.0;
+  double startTime = vtkTimerLog::GetUniversalTime();
   int res = this->ReadDataInternal(refNode);
+  this->UpdateIOCounters(startTime, false, res != 0);
   if (res)
     {
     vtkMRMLStorableNode* storableNode = vtkMRMLStorableNode::SafeDownCast(refNode);
@@ -1287,6 +1296,17 @@ int vtkMRMLStorageNode::ReadData(vtkMRMLNode* refNode, bool temporary)
   return res;
 }
 
+//------------------------------------------------------------------------------
+bool vtkMRMLStorageNode::PrefetchData(vtkMRMLNode* vtkNotUsed(refNode))
+{
+  return false;
+}
+
+//------------------------------------------------------------------------------
+void vtkMRMLStorageNode::ClearPrefetchedData()
+{
+}
+
 //------------------------------------------------------------------------------
 int vtkMRMLStorageNode::WriteData(vtkMRMLNode* refNode)
 {
@@ -1305,7 +1325,10 @@ int vtkMRMLStorageNode::WriteData(vtkMRMLNode* refNode)
     return 0;
     }
 
+  this->LastIODecompressionTime = 0.0;
+  double startTime = vtkTimerLog::GetUniversalTime();
   int res = this->WriteDataInternal(refNode);
+  this->UpdateIOCounters(startTime, true, res != 0);
 
   if (res)
     {
@@ -1316,6 +1339,124 @@ int vtkMRMLStorageNode::WriteData(vtkMRMLNode* refNode)
   return res;
 }
 
+//------------------------------------------------------------------------------
+vtkMRMLNode* vtkMRMLStorageNode::CreateWriteDataSnapshot(vtkMRMLNode* vtkNotUsed(refNode))
+{
+  return nullptr;
+}
+
+//------------------------------------------------------------------------------
+vtkMRMLNode* vtkMRMLStorageNode::CreateContentSnapshot(vtkMRMLNode* refNode)
+{
+  if (refNode == nullptr || !refNode->HasCopyContent())
+    {
+    return nullptr;
+    }
+  vtkMRMLNode* snapshot = refNode->CreateNodeInstance();
+  snapshot->CopyContent(refNode, true);
+  return snapshot;
+}
+
+//------------------------------------------------------------------------------
+vtkMRMLStorageNode* vtkMRMLStorageNode::CreateBackgroundWriteStorageNode()
+{
+  vtkMRMLStorageNode* writer = vtkMRMLStorageNode::SafeDownCast(this->CreateNodeInstance());
+  if (writer == nullptr)
+    {
+    return nullptr;
+    }
+  writer->Copy(this);
+  writer->SetWriteFileFormat(this->GetWriteFileFormat());
+  // remote files are uploaded from the main thread by FinishBackgroundWrite()
+  writer->SetURI(nullptr);
+  writer->ResetURIList();
+  writer->SetFileName(this->GetFullNameFromFileName().c_str());
+  writer->ResetFileNameList();
+  for (int i = 0; i < this->GetNumberOfFileNames(); ++i)
+    {
+    writer->AddFileName(this->GetFullNameFromNthFileName(i).c_str());
+    }
+  return writer;
+}
+
+//------------------------------------------------------------------------------
+void vtkMRMLStorageNode::FinishBackgroundWrite(vtkMRMLNode* refNode, vtkMRMLStorageNode* writer,
+  int result, const vtkTimeStamp& snapshotTime)
+{
+  if (writer == nullptr)
+    {
+    vtkErrorMacro("FinishBackgroundWrite: invalid writer");
+    return;
+    }
+  for (int i = 0; i < writer->GetUserMessages()->GetNumberOfMessages(); ++i)
+    {
+    this->GetUserMessages()->AddMessage(writer->GetUserMessages()->GetNthMessageType(i),
+      writer->GetUserMessages()->GetNthMessageText(i));
+    }
+  // the writer is not in the scene, record its operation here
+  this->LastIOFileSize = writer->LastIOFileSize;
+  this->LastIOTime = writer->LastIOTime;
+  this->LastIODecompressionTime = writer->LastIODecompressionTime;
+  this->LastIOFileFormat = writer->LastIOFileFormat;
+  if (this->GetScene())
+    {
+    this->GetScene()->RecordStorageOperation(this, true, result != 0);
+    }
+  if (!result)
+    {
+    this->SetWriteState(writer->GetWriteState());
+    return;
+    }
+
+  // writers may have updated the file list, resolve its relative names
+  // against the directory of the written file
+  int wasModifying = this->StartModify();
+  std::string writtenDirectory = vtksys::SystemTools::GetParentDirectory(writer->GetFileName() ? writer->GetFileName() : "");
+  this->ResetFileNameList();
+  for (int i = 0; i < writer->GetNumberOfFileNames(); ++i)
+    {
+    std::string fileName = writer->GetNthFileName(i);
+    if (!vtksys::SystemTools::FileIsFullPath(fileName))
+      {
+      fileName = vtksys::SystemTools::CollapseFullPath(fileName, writtenDirectory);
+      }
+    this->AddFileName(fileName.c_str());
+    }
+  this->WriteState = writer->GetWriteState() == SkippedNoData ? SkippedNoData : Idle;
+  this->StageWriteData(refNode);
+  *this->StoredTime = snapshotTime;
+  this->EndModify(wasModifying);
+}
+
+//------------------------------------------------------------------------------
+void vtkMRMLStorageNode::UpdateIOCounters(double startTime, bool write, bool success)
+{
+  this->LastIOTime = vtkTimerLog::GetUniversalTime() - startTime;
+  std::string fullName = this->GetFullNameFromFileName();
+  this->LastIOFileFormat = fullName.empty() ? std::string() : this->GetLowercaseExtensionFromFileName(fullName);
+  this->LastIOFileSize = 0;
+  std::set<std::string> fileNames;
+  if (!fullName.empty())
+    {
+    fileNames.insert(fullName);
+    }
+  for (int i = 0; i < this->GetNumberOfFileNames(); ++i)
+    {
+    fileNames.insert(this->GetFullNameFromNthFileName(i));
+    }
+  for (const std::string& fileName : fileNames)
+    {
+    if (vtksys::SystemTools::FileExists(fileName, true))
+      {
+      this->LastIOFileSize += static_cast<vtkTypeInt64>(vtksys::SystemTools::FileLength(fileName));
+      }
+    }
+  if (this->GetScene())
+    {
+    this->GetScene()->RecordStorageOperation(this, write, success);
+    }
+}
+
 //------------------------------------------------------------------------------
 int vtkMRMLStorageNode::ReadDataInternal(vtkMRMLNode* vtkNotUsed(refNode))
 {
@@ -59,12 +59,53 @@ public:
   /// \sa SetFileName(), ReadDataInternal(), GetStoredTime()
   virtual int ReadData(vtkMRMLNode *refNode, bool temporaryFile = false);
 
+  ///
+  /// Read the file content into memory without setting it in the referenced node.
+  /// This is the part of ReadData() that can run on a worker thread: it must not
+  /// modify the MRML state of this node or of \a refNode, nor invoke events.
+  /// The content is kept until the next ReadData() call, which then only has to
+  /// set it in \a refNode, or until ClearPrefetchedData() is called.
+  /// Return true if content was prefetched. The default implementation does
+  /// nothing and returns false.
+  /// \sa vtkMRMLScene::SetNumberOfDataReadThreads()
+  virtual bool PrefetchData(vtkMRMLNode* refNode);
+
+  ///
+  /// Release the content read by PrefetchData() that has not been used by ReadData().
+  virtual void ClearPrefetchedData();
+
   ///
   /// Write data from a  referenced node
   /// Return 1 on success, 0 on failure.
   /// NOTE: Subclasses should implement this method
   virtual int WriteData(vtkMRMLNode *refNode);
 
+  ///
+  /// Create a copy of the content of \a refNode that can be written on a worker
+  /// thread by the node returned by CreateBackgroundWriteStorageNode(), while
+  /// \a refNode keeps being modified. Bulk data is shared with \a refNode if
+  /// vtkMRMLScene::CopyOnWriteBulkData is enabled and duplicated otherwise.
+  /// Return nullptr if \a refNode cannot be written in the background, which is
+  /// the default. The caller is responsible for deleting the returned node.
+  /// \sa vtkDataIOManager::WriteDataInBackground()
+  virtual vtkMRMLNode* CreateWriteDataSnapshot(vtkMRMLNode* refNode);
+
+  ///
+  /// Create a storage node that writes the same files as this node, with absolute
+  /// file names and without a scene, so that its WriteData() can run on a worker
+  /// thread. The caller is responsible for deleting the returned node.
+  virtual vtkMRMLStorageNode* CreateBackgroundWriteStorageNode();
+
+  ///
+  /// Update this node once \a writer (created by CreateBackgroundWriteStorageNode())
+  /// has written the snapshot of \a refNode taken at \a snapshotTime, \a result
+  /// being the return value of its WriteData(). File list, write state and user
+  /// messages are copied from \a writer. The stored time is set to \a snapshotTime
+  /// so that \a refNode remains modified since read if it changed during the write.
+  /// Must be called on the main thread.
+  virtual void FinishBackgroundWrite(vtkMRMLNode* refNode, vtkMRMLStorageNode* writer,
+    int result, const vtkTimeStamp& snapshotTime);
+
   ///
   /// Write this node's information to a MRML file in XML format.
   void WriteXML(ostream& of, int indent) override;
@@ -374,6 +415,20 @@ public:
   const vtkMRMLMessageCollection *GetUserMessages() const { return this->UserMessages; }
   vtkMRMLMessageCollection *GetUserMessages() { return this->UserMessages; }
 
+  ///
+  /// Performance counters of the last ReadData() or WriteData() call.
+  /// Total size of the read or written files, in bytes.
+  /// \sa vtkMRMLScene::GetStorageStatisticsReport()
+  vtkGetMacro(LastIOFileSize, vtkTypeInt64);
+  /// Wall time of reading or writing the data (without remote file transfer), in seconds.
+  /// It includes decompression and conversion of the data.
+  vtkGetMacro(LastIOTime, double);
+  /// Time spent decompressing the data, in seconds. Only readers that can measure it separately
+  /// from file reading report it, it is 0 for other readers.
+  vtkGetMacro(LastIODecompressionTime, double);
+  /// File format of the last read or written file (lowercase file extension, such as ".nrrd" or ".nii.gz").
+  vtkGetMacro(LastIOFileFormat, std::string);
+
 protected:
   vtkMRMLStorageNode();
   ~vtkMRMLStorageNode() override;
@@ -390,16 +445,28 @@ protected:
   /// To be reimplemented in subclass.
   virtual int WriteDataInternal(vtkMRMLNode* refNode);
 
+  /// Return a new node of the same class as \a refNode with a deep copy of its content.
+  /// Helper for subclasses implementing CreateWriteDataSnapshot().
+  vtkMRMLNode* CreateContentSnapshot(vtkMRMLNode* refNode);
+
   ///
   /// If the URI is not null, fetch it and save it to the node's FileName location or
   /// load directly into the reference node.
-  void StageReadData ( vtkMRMLNode *refNode );
+  /// Subclasses that read remote data on demand may skip the download.
+  virtual void StageReadData ( vtkMRMLNode *refNode );
 
   ///
   /// Copy data from the local file location (node->FileName) or node to the remote
   /// location specified by the URI
   void StageWriteData ( vtkMRMLNode *refNode );
 
+  ///
+  /// Update the performance counters after reading or writing the data
+  /// that started at \a startTime (vtkTimerLog::GetUniversalTime()) and record the operation in the scene.
+  /// Subclasses that can measure decompression time add it to LastIODecompressionTime in
+  /// ReadDataInternal().
+  void UpdateIOCounters(double startTime, bool write, bool success);
+
   char *FileName;
   char *TempFileName;
   char *URI;
@@ -448,6 +515,14 @@ protected:
   // Record warnings and errors associated with this
   // vtkMRMLStorableNode.
   vtkMRMLMessageCollection *UserMessages;
+
+  /// Performance counters of the last read or write
+  vtkTypeInt64 LastIOFileSize{0};
+  double LastIOTime{0.0};
+  double LastIODecompressionTime{0.0};
+  std::string LastIOFileFormat;
+
+  friend class vtkMRMLScene;
 };
 
 #endif
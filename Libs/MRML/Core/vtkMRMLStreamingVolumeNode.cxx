@@ -19,6 +19,7 @@ Care Ontario.
 ==============================================================================*/
 
 // MRML includes
+#include "vtkDeltaDeflateVolumeCodec.h"
 #include "vtkMRMLStreamingVolumeNode.h"
 
 // VTK includes
@@ -37,6 +38,19 @@ vtkMRMLNodeNewMacro(vtkMRMLStreamingVolumeNode);
 const int NUMBER_OF_INTERNAL_IMAGEDATACONNECTION_OBSERVERS = 1;
 const int NUMBER_OF_INTERNAL_IMAGEDATA_OBSERVERS = 2;
 
+//----------------------------------------------------------------------------
+// Codecs that are implemented in MRML are registered when a codec is first requested
+static void RegisterMRMLStreamingVolumeCodecs()
+{
+  static bool registered = false;
+  if (registered)
+    {
+    return;
+    }
+  registered = true;
+  vtkStreamingVolumeCodecFactory::GetInstance()->RegisterStreamingCodec(vtkSmartPointer<vtkDeltaDeflateVolumeCodec>::New());
+}
+
 //----------------------------------------------------------------------------
 // vtkMRMLStreamingVolumeNode methods
 
@@ -152,6 +166,7 @@ vtkStreamingVolumeCodec* vtkMRMLStreamingVolumeNode::GetCodec()
       (this->Codec &&
        this->Codec->GetFourCC() != this->GetCodecFourCC()))
     {
+    RegisterMRMLStreamingVolumeCodecs();
     this->Codec = vtkSmartPointer<vtkStreamingVolumeCodec>::Take(vtkStreamingVolumeCodecFactory::GetInstance()->CreateCodecByFourCC(this->GetCodecFourCC()));
     }
   return this->Codec;
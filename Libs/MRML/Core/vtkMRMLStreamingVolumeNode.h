@@ -41,7 +41,9 @@ Care Ontario.
 /// \brief MRML node for representing a single compressed video frame that can be decoded to an image representation
 /// In this context, a frame is considered to be a compressed image that may require additional frames to decode to an image,
 /// and an image is the uncompressed pixel based representation.
-/// A video codec can be used to decode and encode between frame and image representations
+/// A video codec can be used to decode and encode between frame and image representations.
+/// Codecs are created by FourCC using vtkStreamingVolumeCodecFactory. The lossless
+/// vtkDeltaDeflateVolumeCodec ("ZDLT") is always available.
 class  VTK_MRML_EXPORT vtkMRMLStreamingVolumeNode : public vtkMRMLVectorVolumeNode
 {
 public:
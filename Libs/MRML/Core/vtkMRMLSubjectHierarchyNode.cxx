@@ -41,6 +41,8 @@
 #include <sstream>
 #include <set>
 #include <map>
+#include <unordered_map>
+#include <unordered_set>
 #include <algorithm>
 
 //----------------------------------------------------------------------------
@@ -105,8 +107,35 @@ public:
 
   /// Item and data node cache to speed up lookups that are needed many times.
   /// It can be static as the item IDs are unique in one application session.
-  static std::map<vtkIdType, vtkSubjectHierarchyItem*> ItemCache;
-  static std::map<vtkMRMLNode*, vtkSubjectHierarchyItem*> DataNodeCache;
+  /// Hash maps are used because the caches are only used for lookup by key.
+  typedef std::unordered_map<vtkIdType, vtkSubjectHierarchyItem*> ItemCacheType;
+  typedef std::unordered_map<vtkMRMLNode*, vtkSubjectHierarchyItem*> DataNodeCacheType;
+  static ItemCacheType ItemCache;
+  static DataNodeCacheType DataNodeCache;
+
+  /// UID index to speed up finding items by UID: UID name -> UID value -> IDs of the items with that UID.
+  /// UID lists (such as instance UIDs) are also indexed by each UID in the list.
+  /// Attribute index: attribute name -> IDs of the items that have the attribute.
+  /// Only items that are in the tree are indexed (added in AddToTree, removed in RemoveChild).
+  typedef std::unordered_map<std::string, std::unordered_multimap<std::string, vtkIdType> > UIDCacheType;
+  typedef std::unordered_map<std::string, std::unordered_set<vtkIdType> > AttributeCacheType;
+  static UIDCacheType UIDCache;
+  static AttributeCacheType AttributeCache;
+
+// Index functions
+public:
+  /// Add UID of this item to the UID index
+  void AddUIDToCache(const std::string& uidName, const std::string& uidValue);
+  /// Remove UID of this item from the UID index
+  void RemoveUIDFromCache(const std::string& uidName, const std::string& uidValue);
+  /// Add all UIDs and attribute names of this item to the indices. Called when the item is added to the tree
+  void AddToCaches();
+  /// Remove all UIDs and attribute names of this item from the indices. Called when the item is removed from the tree
+  void RemoveFromCaches();
+  /// Get items in the branch of this item that have the given value (or an element of the UID list
+  /// that is the given value) for the given UID name according to the UID index
+  void FindChildrenInUIDCache(const std::string& uidName, const std::string& uidValue, bool recursive,
+                              std::vector<vtkSubjectHierarchyItem*>& foundItems);
 
 // Get/set functions
 public:
@@ -184,6 +213,8 @@ public:
                            bool contains=false, bool recursive=true );
   /// Get data nodes (of a certain type) associated to items in the branch of this item
   void GetDataNodesInBranch(vtkCollection *children, const char* childClass=nullptr);
+  /// Determine whether this item is in the branch of the given item (is the item or any of its descendants)
+  bool IsInBranchOf(vtkSubjectHierarchyItem* ancestorItem);
   /// Get IDs of all children in the branch recursively
   void GetAllChildren(std::vector<vtkIdType> &childIDs);
   /// Get list of IDs of all direct children of this item
@@ -246,8 +277,10 @@ vtkStandardNewMacro(vtkSubjectHierarchyItem);
 
 vtkIdType vtkSubjectHierarchyItem::NextSubjectHierarchyItemID = vtkMRMLSubjectHierarchyNode::INVALID_ITEM_ID + 1;
 
-std::map<vtkIdType, vtkSubjectHierarchyItem*> vtkSubjectHierarchyItem::ItemCache = std::map<vtkIdType, vtkSubjectHierarchyItem*>();
-std::map<vtkMRMLNode*, vtkSubjectHierarchyItem*> vtkSubjectHierarchyItem::DataNodeCache = std::map<vtkMRMLNode*, vtkSubjectHierarchyItem*>();
+vtkSubjectHierarchyItem::ItemCacheType vtkSubjectHierarchyItem::ItemCache = vtkSubjectHierarchyItem::ItemCacheType();
+vtkSubjectHierarchyItem::DataNodeCacheType vtkSubjectHierarchyItem::DataNodeCache = vtkSubjectHierarchyItem::DataNodeCacheType();
+vtkSubjectHierarchyItem::UIDCacheType vtkSubjectHierarchyItem::UIDCache = vtkSubjectHierarchyItem::UIDCacheType();
+vtkSubjectHierarchyItem::AttributeCacheType vtkSubjectHierarchyItem::AttributeCache = vtkSubjectHierarchyItem::AttributeCacheType();
 
 //---------------------------------------------------------------------------
 // vtkSubjectHierarchyItem methods
@@ -305,6 +338,8 @@ vtkIdType vtkSubjectHierarchyItem::AddToTree(vtkSubjectHierarchyItem* parent, vt
       {
       vtkSubjectHierarchyItem::DataNodeCache[dataNode] = this;
       }
+    // Items resolved after scene import already have UIDs and attributes
+    this->AddToCaches();
     }
   else
     {
@@ -342,6 +377,7 @@ vtkIdType vtkSubjectHierarchyItem::AddToTree(vtkSubjectHierarchyItem* parent, st
 
     // Add to cache (DataNode is nullptr, so no need to add to node cache)
     vtkSubjectHierarchyItem::ItemCache[this->ID] = this;
+    this->AddToCaches();
     }
   else if (! ( (!name.compare("Scene") && !level.compare("Scene"))
             || (!name.compare("UnresolvedItems") && !level.compare("UnresolvedItems")) ) )
@@ -677,6 +713,126 @@ void vtkSubjectHierarchyItem::DeepCopy(vtkSubjectHierarchyItem* item, bool copyC
     }
 }
 
+//---------------------------------------------------------------------------
+void vtkSubjectHierarchyItem::AddUIDToCache(const std::string& uidName, const std::string& uidValue)
+{
+  if (this->ID == vtkMRMLSubjectHierarchyNode::INVALID_ITEM_ID || !this->Parent || uidValue.empty())
+    {
+    // Only items in the tree are indexed
+    return;
+    }
+  std::vector<std::string> keys;
+  vtkMRMLSubjectHierarchyNode::DeserializeUIDList(uidValue, keys);
+  if (keys.size() != 1 || keys[0] != uidValue)
+    {
+    keys.push_back(uidValue);
+    }
+  std::unordered_multimap<std::string, vtkIdType>& uidValueCache = vtkSubjectHierarchyItem::UIDCache[uidName];
+  for (std::vector<std::string>::iterator keyIt = keys.begin(); keyIt != keys.end(); ++keyIt)
+    {
+    auto range = uidValueCache.equal_range(*keyIt);
+    bool alreadyAdded = false;
+    for (auto it = range.first; it != range.second; ++it)
+      {
+      if (it->second == this->ID)
+        {
+        alreadyAdded = true;
+        break;
+        }
+      }
+    if (!alreadyAdded)
+      {
+      uidValueCache.insert(std::make_pair(*keyIt, this->ID));
+      }
+    }
+}
+
+//---------------------------------------------------------------------------
+void vtkSubjectHierarchyItem::RemoveUIDFromCache(const std::string& uidName, const std::string& uidValue)
+{
+  UIDCacheType::iterator uidNameIt = vtkSubjectHierarchyItem::UIDCache.find(uidName);
+  if (uidNameIt == vtkSubjectHierarchyItem::UIDCache.end() || uidValue.empty())
+    {
+    return;
+    }
+  std::vector<std::string> keys;
+  vtkMRMLSubjectHierarchyNode::DeserializeUIDList(uidValue, keys);
+  keys.push_back(uidValue);
+  for (std::vector<std::string>::iterator keyIt = keys.begin(); keyIt != keys.end(); ++keyIt)
+    {
+    auto range = uidNameIt->second.equal_range(*keyIt);
+    for (auto it = range.first; it != range.second; ++it)
+      {
+      if (it->second == this->ID)
+        {
+        uidNameIt->second.erase(it);
+        break;
+        }
+      }
+    }
+}
+
+//---------------------------------------------------------------------------
+void vtkSubjectHierarchyItem::AddToCaches()
+{
+  for (std::map<std::string, std::string>::iterator uidIt = this->UIDs.begin(); uidIt != this->UIDs.end(); ++uidIt)
+    {
+    this->AddUIDToCache(uidIt->first, uidIt->second);
+    }
+  if (this->ID == vtkMRMLSubjectHierarchyNode::INVALID_ITEM_ID || !this->Parent)
+    {
+    return;
+    }
+  for (std::map<std::string, std::string>::iterator attIt = this->Attributes.begin(); attIt != this->Attributes.end(); ++attIt)
+    {
+    vtkSubjectHierarchyItem::AttributeCache[attIt->first].insert(this->ID);
+    }
+}
+
+//---------------------------------------------------------------------------
+void vtkSubjectHierarchyItem::RemoveFromCaches()
+{
+  for (std::map<std::string, std::string>::iterator uidIt = this->UIDs.begin(); uidIt != this->UIDs.end(); ++uidIt)
+    {
+    this->RemoveUIDFromCache(uidIt->first, uidIt->second);
+    }
+  for (std::map<std::string, std::string>::iterator attIt = this->Attributes.begin(); attIt != this->Attributes.end(); ++attIt)
+    {
+    AttributeCacheType::iterator attributeCacheIt = vtkSubjectHierarchyItem::AttributeCache.find(attIt->first);
+    if (attributeCacheIt != vtkSubjectHierarchyItem::AttributeCache.end())
+      {
+      attributeCacheIt->second.erase(this->ID);
+      }
+    }
+}
+
+//---------------------------------------------------------------------------
+void vtkSubjectHierarchyItem::FindChildrenInUIDCache(const std::string& uidName, const std::string& uidValue, bool recursive,
+                                                     std::vector<vtkSubjectHierarchyItem*>& foundItems)
+{
+  foundItems.clear();
+  UIDCacheType::iterator uidNameIt = vtkSubjectHierarchyItem::UIDCache.find(uidName);
+  if (uidNameIt == vtkSubjectHierarchyItem::UIDCache.end())
+    {
+    return;
+    }
+  auto range = uidNameIt->second.equal_range(uidValue);
+  for (auto it = range.first; it != range.second; ++it)
+    {
+    ItemCacheType::iterator itemIt = vtkSubjectHierarchyItem::ItemCache.find(it->second);
+    if (itemIt == vtkSubjectHierarchyItem::ItemCache.end() || !itemIt->second)
+      {
+      continue;
+      }
+    vtkSubjectHierarchyItem* currentItem = itemIt->second;
+    // The index is shared by all subject hierarchy nodes, so only keep the items in this branch
+    if (currentItem != this && (recursive ? currentItem->IsInBranchOf(this) : currentItem->Parent == this))
+      {
+      foundItems.push_back(currentItem);
+      }
+    }
+}
+
 //---------------------------------------------------------------------------
 std::string vtkSubjectHierarchyItem::GetName()
 {
@@ -710,7 +866,7 @@ vtkSubjectHierarchyItem* vtkSubjectHierarchyItem::FindChildByID(vtkIdType itemID
     }
 
   // Try to find item in cache
-  std::map<vtkIdType, vtkSubjectHierarchyItem*>::iterator itemIt = vtkSubjectHierarchyItem::ItemCache.find(itemID);
+  ItemCacheType::iterator itemIt = vtkSubjectHierarchyItem::ItemCache.find(itemID);
   if (itemIt != vtkSubjectHierarchyItem::ItemCache.end())
     {
     return itemIt->second;
@@ -741,7 +897,7 @@ vtkSubjectHierarchyItem* vtkSubjectHierarchyItem::FindChildByID(vtkIdType itemID
     }
   if (foundItem)
     {
-    vtkSubjectHierarchyItem::ItemCache[itemID] = this;
+    vtkSubjectHierarchyItem::ItemCache[itemID] = foundItem;
     }
 
   return foundItem;
@@ -755,6 +911,19 @@ vtkSubjectHierarchyItem* vtkSubjectHierarchyItem::FindChildByDataNode(vtkMRMLNod
     return nullptr;
     }
 
+  // Try to find item in cache, and only check whether it is in the branch
+  DataNodeCacheType::iterator itemIt = vtkSubjectHierarchyItem::DataNodeCache.find(dataNode);
+  if (itemIt != vtkSubjectHierarchyItem::DataNodeCache.end() && itemIt->second
+    && itemIt->second->DataNode.GetPointer() == dataNode)
+    {
+    vtkSubjectHierarchyItem* cachedItem = itemIt->second;
+    if (cachedItem != this && (recursive ? cachedItem->IsInBranchOf(this) : cachedItem->Parent == this))
+      {
+      return cachedItem;
+      }
+    }
+
+  // On failure to look up in cache, traverse tree to find item
   ChildVector::iterator childIt;
   for (childIt=this->Children.begin(); childIt!=this->Children.end(); ++childIt)
     {
@@ -782,6 +951,18 @@ vtkSubjectHierarchyItem* vtkSubjectHierarchyItem::FindChildByUID(std::string uid
     {
     return nullptr;
     }
+
+  // All items in the tree are indexed, so the tree only needs to be traversed if there are
+  // multiple matches (to return the first one in the tree)
+  std::vector<vtkSubjectHierarchyItem*> foundItems;
+  this->FindChildrenInUIDCache(uidName, uidValue, recursive, foundItems);
+  foundItems.erase(std::remove_if(foundItems.begin(), foundItems.end(),
+    [&](vtkSubjectHierarchyItem* item) { return item->GetUID(uidName) != uidValue; }), foundItems.end());
+  if (foundItems.size() <= 1)
+    {
+    return (foundItems.empty() ? nullptr : foundItems[0]);
+    }
+
   ChildVector::iterator childIt;
   for (childIt=this->Children.begin(); childIt!=this->Children.end(); ++childIt)
     {
@@ -809,6 +990,17 @@ vtkSubjectHierarchyItem* vtkSubjectHierarchyItem::FindChildByUIDList(std::string
     {
     return nullptr;
     }
+
+  // Look up the UID in the index of UID list elements. The tree is traversed if there are multiple
+  // matches (to return the first one in the tree), or if there is no match, because the value may
+  // be only part of a UID
+  std::vector<vtkSubjectHierarchyItem*> foundItems;
+  this->FindChildrenInUIDCache(uidName, uidValue, recursive, foundItems);
+  if (foundItems.size() == 1)
+    {
+    return foundItems[0];
+    }
+
   ChildVector::iterator childIt;
   for (childIt=this->Children.begin(); childIt!=this->Children.end(); ++childIt)
     {
@@ -837,31 +1029,44 @@ void vtkSubjectHierarchyItem::FindChildrenByName(std::string name, std::vector<v
     std::transform(name.begin(), name.end(), name.begin(), ::tolower); // Make it lowercase for case-insensitive comparison
     }
 
-  ChildVector::iterator childIt;
-  for (childIt=this->Children.begin(); childIt!=this->Children.end(); ++childIt)
+  // Traverse the branch depth first without recursion. Children are pushed to the stack
+  // in reverse order so that the items are found in the same order as they are in the tree.
+  std::vector<vtkSubjectHierarchyItem*> itemsToVisit;
+  for (ChildVector::reverse_iterator childIt=this->Children.rbegin(); childIt!=this->Children.rend(); ++childIt)
     {
-    vtkSubjectHierarchyItem* currentItem = childIt->GetPointer();
-    std::string currentName = currentItem->GetName();
+    itemsToVisit.push_back(childIt->GetPointer());
+    }
+  while (!itemsToVisit.empty())
+    {
+    vtkSubjectHierarchyItem* currentItem = itemsToVisit.back();
+    itemsToVisit.pop_back();
     if (name.empty())
       {
       // If given name is empty (e.g. GetAllChildrenIDs is called), then it is quicker not to do the unnecessary string operations
       foundItemIDs.push_back(currentItem->ID);
       }
-    else if (contains)
+    else
       {
-      std::transform(currentName.begin(), currentName.end(), currentName.begin(), ::tolower); // Make it lowercase for case-insensitive comparison
-      if (currentName.find(name) != std::string::npos)
+      std::string currentName = currentItem->GetName();
+      if (contains)
+        {
+        std::transform(currentName.begin(), currentName.end(), currentName.begin(), ::tolower); // Make it lowercase for case-insensitive comparison
+        if (currentName.find(name) != std::string::npos)
+          {
+          foundItemIDs.push_back(currentItem->ID);
+          }
+        }
+      else if (!currentName.compare(name))
         {
         foundItemIDs.push_back(currentItem->ID);
         }
       }
-    else if (!currentName.compare(name))
-      {
-      foundItemIDs.push_back(currentItem->ID);
-      }
     if (recursive)
       {
-      currentItem->FindChildrenByName(name, foundItemIDs, contains);
+      for (ChildVector::reverse_iterator childIt=currentItem->Children.rbegin(); childIt!=currentItem->Children.rend(); ++childIt)
+        {
+        itemsToVisit.push_back(childIt->GetPointer());
+        }
       }
     }
 }
@@ -899,6 +1104,19 @@ void vtkSubjectHierarchyItem::GetDataNodesInBranch(vtkCollection* dataNodeCollec
     }
 }
 
+//---------------------------------------------------------------------------
+bool vtkSubjectHierarchyItem::IsInBranchOf(vtkSubjectHierarchyItem* ancestorItem)
+{
+  for (vtkSubjectHierarchyItem* currentItem = this; currentItem; currentItem = currentItem->Parent)
+    {
+    if (currentItem == ancestorItem)
+      {
+      return true;
+      }
+    }
+  return false;
+}
+
 //---------------------------------------------------------------------------
 void vtkSubjectHierarchyItem::GetAllChildren(std::vector<vtkIdType> &childIDs)
 {
@@ -1124,6 +1342,7 @@ bool vtkSubjectHierarchyItem::RemoveChild(vtkSubjectHierarchyItem* item)
   removedItem->ReparentChildrenToParent();
 
   // Remove from cache
+  removedItem->RemoveFromCaches();
   vtkSubjectHierarchyItem::ItemCache.erase(removedItem->ID);
   if (removedItem->DataNode)
     {
@@ -1172,6 +1391,7 @@ bool vtkSubjectHierarchyItem::RemoveChild(vtkIdType itemID)
   removedItem->ReparentChildrenToParent();
 
   // Remove from cache
+  removedItem->RemoveFromCaches();
   vtkSubjectHierarchyItem::ItemCache.erase(removedItem->ID);
   if (removedItem->DataNode)
     {
@@ -1263,6 +1483,7 @@ void vtkSubjectHierarchyItem::SetUID(std::string uidName, std::string uidValue)
       {
       vtkWarningMacro( "SetUID: UID with name '" << uidName << "' already exists in subject hierarchy item '" << this->GetName()
         << "' with value '" << this->UIDs[uidName] << "'. Replacing it with value '" << uidValue << "'" );
+      this->RemoveUIDFromCache(uidName, this->UIDs[uidName]);
       }
     else
       {
@@ -1270,6 +1491,7 @@ void vtkSubjectHierarchyItem::SetUID(std::string uidName, std::string uidValue)
       }
     }
   this->UIDs[uidName] = uidValue;
+  this->AddUIDToCache(uidName, uidValue);
   this->InvokeEvent(vtkMRMLSubjectHierarchyNode::SubjectHierarchyItemUIDAddedEvent, this);
   this->Modified();
 }
@@ -1300,6 +1522,10 @@ void vtkSubjectHierarchyItem::SetAttribute(std::string attributeName, std::strin
     return; // Attribute to set is same as original value, nothing to do
     }
   this->Attributes[attributeName] = attributeValue;
+  if (this->ID != vtkMRMLSubjectHierarchyNode::INVALID_ITEM_ID && this->Parent)
+    {
+    vtkSubjectHierarchyItem::AttributeCache[attributeName].insert(this->ID);
+    }
   this->InvokeEvent(vtkMRMLSubjectHierarchyNode::SubjectHierarchyItemOwnerPluginSearchRequested, this);
   this->Modified();
 }
@@ -1316,6 +1542,11 @@ bool vtkSubjectHierarchyItem::RemoveAttribute(std::string attributeName)
   if (this->Attributes.find(attributeName) != this->Attributes.end())
     {
     this->Attributes.erase(attributeName);
+    AttributeCacheType::iterator attributeCacheIt = vtkSubjectHierarchyItem::AttributeCache.find(attributeName);
+    if (attributeCacheIt != vtkSubjectHierarchyItem::AttributeCache.end())
+      {
+      attributeCacheIt->second.erase(this->ID);
+      }
     this->InvokeEvent(vtkMRMLSubjectHierarchyNode::SubjectHierarchyItemOwnerPluginSearchRequested, this);
     this->Modified();
     return true;
@@ -3427,12 +3658,24 @@ std::vector<vtkIdType> vtkMRMLSubjectHierarchyNode::GetItemsReferencingItemByDIC
   std::vector<std::string> uidVector;
   this->DeserializeUIDList(uidsString, uidVector);
 
-  // Find subject hierarchy items containing first SOP instance UID in referenced UIDs attribute
-  std::vector<vtkIdType> allItemIDs;
-  this->Internal->SceneItem->GetAllChildren(allItemIDs);
-  for (std::vector<vtkIdType>::iterator itemIt=allItemIDs.begin(); itemIt!=allItemIDs.end(); ++itemIt)
+  // Find subject hierarchy items containing first SOP instance UID in referenced UIDs attribute.
+  // Only the items that have the attribute are checked (in the order they were added to the hierarchy).
+  std::vector<vtkIdType> candidateItemIDs;
+  vtkSubjectHierarchyItem::AttributeCacheType::iterator attributeCacheIt = vtkSubjectHierarchyItem::AttributeCache.find(
+    vtkMRMLSubjectHierarchyConstants::GetDICOMReferencedInstanceUIDsAttributeName() );
+  if (attributeCacheIt != vtkSubjectHierarchyItem::AttributeCache.end())
+    {
+    candidateItemIDs.assign(attributeCacheIt->second.begin(), attributeCacheIt->second.end());
+    std::sort(candidateItemIDs.begin(), candidateItemIDs.end());
+    }
+  for (std::vector<vtkIdType>::iterator itemIt=candidateItemIDs.begin(); itemIt!=candidateItemIDs.end(); ++itemIt)
     {
-    vtkSubjectHierarchyItem* currentItem =this->Internal->SceneItem->FindChildByID(*itemIt);
+    vtkSubjectHierarchyItem* currentItem = this->Internal->SceneItem->FindChildByID(*itemIt);
+    if (!currentItem || !currentItem->IsInBranchOf(this->Internal->SceneItem))
+      {
+      // Item of another subject hierarchy
+      continue;
+      }
     std::string referencedUids = currentItem->GetAttribute(vtkMRMLSubjectHierarchyConstants::GetDICOMReferencedInstanceUIDsAttributeName());
     bool referencesUid = false;
     for (std::vector<std::string>::iterator uidIt=uidVector.begin(); uidIt!=uidVector.end(); ++uidIt)
@@ -29,6 +29,8 @@
 #include <vtkBitArray.h>
 #include <vtkCharArray.h>
 #include <vtkCommand.h>
+#include <vtkDataArray.h>
+#include <vtkDataSetAttributes.h>
 #include <vtkNew.h>
 #include <vtkObjectFactory.h>
 #include <vtkSignedCharArray.h>
@@ -238,6 +240,21 @@ void vtkMRMLTableNode::PrintSelf(ostream& os, vtkIndent indent)
     }
 }
 
+//---------------------------------------------------------------------------
+unsigned long vtkMRMLTableNode::GetContentMemorySize()
+{
+  unsigned long size = this->Superclass::GetContentMemorySize();
+  if (this->Table)
+    {
+    size += this->Table->GetActualMemorySize();
+    }
+  if (this->Schema)
+    {
+    size += this->Schema->GetActualMemorySize();
+    }
+  return size;
+}
+
 //---------------------------------------------------------------------------
 vtkMRMLStorageNode* vtkMRMLTableNode::CreateDefaultStorageNode()
 {
@@ -591,6 +608,101 @@ int vtkMRMLTableNode::AddEmptyRow()
   return rowIndex;
 }
 
+//----------------------------------------------------------------------------
+int vtkMRMLTableNode::AddEmptyRows(int numberOfRows)
+{
+  if (!this->Table)
+    {
+    vtkErrorMacro("vtkMRMLTableNode::AddEmptyRows failed: invalid table");
+    return -1;
+    }
+  if (numberOfRows < 1)
+    {
+    vtkErrorMacro("vtkMRMLTableNode::AddEmptyRows failed: invalid number of rows: " << numberOfRows);
+    return -1;
+    }
+  int tableWasModified = this->StartModify();
+  if (this->Table->GetNumberOfColumns()==0)
+    {
+    vtkDebugMacro("vtkMRMLTableNode::AddEmptyRows called for an empty table. Add an empty column first.");
+    this->AddColumn();
+    }
+  vtkIdType firstRowIndex = this->Table->GetNumberOfRows();
+  vtkIdType newNumberOfRows = firstRowIndex + numberOfRows;
+  for (int columnIndex = 0; columnIndex < this->Table->GetNumberOfColumns(); ++columnIndex)
+    {
+    vtkAbstractArray* column = this->Table->GetColumn(columnIndex);
+    if (column == nullptr)
+      {
+      continue;
+      }
+    // Null value is looked up once per column (not for each cell)
+    vtkVariant nullValue(this->GetColumnProperty(columnIndex, SCHEMA_COLUMN_NULL_VALUE));
+    int numberOfComponents = column->GetNumberOfComponents();
+    column->SetNumberOfTuples(newNumberOfRows);
+    vtkDataArray* dataArray = vtkDataArray::SafeDownCast(column);
+    if (dataArray)
+      {
+      bool valid = false;
+      double nullNumber = nullValue.ToDouble(&valid);
+      if (!valid)
+        {
+        nullNumber = 0.0;
+        }
+      for (int componentIndex = 0; componentIndex < numberOfComponents; ++componentIndex)
+        {
+        for (vtkIdType rowIndex = firstRowIndex; rowIndex < newNumberOfRows; ++rowIndex)
+          {
+          dataArray->SetComponent(rowIndex, componentIndex, nullNumber);
+          }
+        }
+      }
+    else
+      {
+      for (vtkIdType valueIndex = firstRowIndex * numberOfComponents; valueIndex < newNumberOfRows * numberOfComponents; ++valueIndex)
+        {
+        column->SetVariantValue(valueIndex, nullValue);
+        }
+      }
+    column->Modified();
+    }
+  this->Table->Modified();
+  this->EndModify(tableWasModified);
+  return static_cast<int>(firstRowIndex);
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLTableNode::SetColumn(int columnIndex, vtkAbstractArray* column)
+{
+  if (!this->Table)
+    {
+    vtkErrorMacro("vtkMRMLTableNode::SetColumn failed: invalid table");
+    return false;
+    }
+  if (!column)
+    {
+    vtkErrorMacro("vtkMRMLTableNode::SetColumn failed: invalid column");
+    return false;
+    }
+  if (columnIndex<0 || columnIndex>=this->Table->GetNumberOfColumns())
+    {
+    vtkErrorMacro("vtkMRMLTableNode::SetColumn failed: invalid column index "<<columnIndex);
+    return false;
+    }
+  if (this->Table->GetNumberOfColumns() > 1 && column->GetNumberOfTuples() != this->Table->GetNumberOfRows())
+    {
+    vtkErrorMacro("vtkMRMLTableNode::SetColumn failed: number of tuples (" << column->GetNumberOfTuples()
+      << ") does not match the number of rows of the table (" << this->Table->GetNumberOfRows() << ")");
+    return false;
+    }
+  std::string columnName = this->GetColumnName(columnIndex);
+  column->SetName(columnName.c_str());
+  // The row data replaces the existing array of the same name, at the same column index
+  this->Table->GetRowData()->AddArray(column);
+  this->Table->Modified();
+  return true;
+}
+
 //----------------------------------------------------------------------------
 bool vtkMRMLTableNode::RemoveRow(int rowIndex)
 {
@@ -658,6 +770,50 @@ bool vtkMRMLTableNode::SetCellText(int rowIndex, int columnIndex, const char* te
   return true;
 }
 
+//----------------------------------------------------------------------------
+vtkVariant vtkMRMLTableNode::GetCellValue(int rowIndex, int columnIndex)
+{
+  if (!this->Table)
+    {
+    vtkErrorMacro("vtkMRMLTableNode::GetCellValue failed: invalid table");
+    return vtkVariant();
+    }
+  if (columnIndex<0 || columnIndex>=this->Table->GetNumberOfColumns())
+    {
+    vtkErrorMacro("vtkMRMLTableNode::GetCellValue failed: invalid column index "<<columnIndex);
+    return vtkVariant();
+    }
+  if (rowIndex<0 || rowIndex>=this->Table->GetNumberOfRows())
+    {
+    vtkErrorMacro("vtkMRMLTableNode::GetCellValue failed: invalid row index: "<<rowIndex);
+    return vtkVariant();
+    }
+  return this->Table->GetValue(rowIndex, columnIndex);
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLTableNode::SetCellValue(int rowIndex, int columnIndex, const vtkVariant& value)
+{
+  if (!this->Table)
+    {
+    vtkErrorMacro("vtkMRMLTableNode::SetCellValue failed: invalid table");
+    return false;
+    }
+  if (columnIndex<0 || columnIndex>=this->Table->GetNumberOfColumns())
+    {
+    vtkErrorMacro("vtkMRMLTableNode::SetCellValue failed: invalid column index "<<columnIndex);
+    return false;
+    }
+  if (rowIndex<0 || rowIndex>=this->Table->GetNumberOfRows())
+    {
+    vtkErrorMacro("vtkMRMLTableNode::SetCellValue failed: invalid row index: "<<rowIndex);
+    return false;
+    }
+  this->Table->SetValue(rowIndex, columnIndex, value);
+  this->Table->Modified();
+  return true;
+}
+
 //----------------------------------------------------------------------------
 int vtkMRMLTableNode::GetNumberOfRows()
 {
@@ -32,6 +32,7 @@
 class vtkMRMLStorageNode;
 
 // VTK Includes
+#include <vtkVariant.h>
 class vtkTable;
 
 /// \brief MRML node to represent a table object
@@ -121,6 +122,10 @@ public:
   /// Create default storage node or nullptr if does not have one
   vtkMRMLStorageNode* CreateDefaultStorageNode() override;
 
+  ///
+  /// Approximate size of the table and schema in kibibytes.
+  unsigned long GetContentMemorySize() override;
+
   ///
   /// Add an array to the table as a new column.
   /// If no column is provided then an empty column is added.
@@ -153,6 +158,24 @@ public:
   /// Returns the index of the inserted row or -1 on failure.
   int AddEmptyRow();
 
+  ///
+  /// Add numberOfRows empty rows at the end of the table.
+  /// Cells are initialized with the null value of their column.
+  /// The node is modified only once, therefore this is much faster than
+  /// calling AddEmptyRow() repeatedly.
+  /// Returns the index of the first inserted row or -1 on failure.
+  int AddEmptyRows(int numberOfRows);
+
+  ///
+  /// Replace the array of an existing column.
+  /// The array is used directly, its values are not copied, therefore it is
+  /// a fast way of setting all the values of a column (for example from a
+  /// numpy array). The column name and column properties are kept.
+  /// The number of tuples of the array must match the number of rows of the table,
+  /// unless it is the only column of the table.
+  /// Returns with true on success.
+  bool SetColumn(int columnIndex, vtkAbstractArray* column);
+
   ///
   /// Remove row from the table
   /// Returns with true on success.
@@ -171,6 +194,17 @@ public:
   /// GetTable() method and manipulate that directly.
   bool SetCellText(int rowIndex, int columnIndex, const char* text);
 
+  ///
+  /// Convenience method for getting a single value in the table, in the type of the column.
+  /// Returns an invalid vtkVariant if failed to get value.
+  vtkVariant GetCellValue(int rowIndex, int columnIndex);
+
+  ///
+  /// Convenience method for setting a single value in the table, without conversion to text.
+  /// Returns true if the setting was successful.
+  /// Similarly to SetCellText, this updates the node immediately.
+  bool SetCellValue(int rowIndex, int columnIndex, const vtkVariant& value);
+
   ///
   /// Get column index of the first column by the specified name.
   /// Returns -1 if no such column is found.
@@ -26,20 +26,40 @@
 #include "vtkMRMLScene.h"
 
 // VTK includes
-#include <vtkObjectFactory.h>
-#include <vtkTable.h>
-#include <vtkStringArray.h>
 #include <vtkBitArray.h>
+#include <vtkDataArray.h>
+#include <vtkDoubleArray.h>
+#include <vtkFloatArray.h>
+#include <vtkIntArray.h>
 #include <vtkNew.h>
-#include <vtkSQLQuery.h>
-#include <vtkRowQueryToTable.h>
-#include <vtkSQLDatabase.h>
+#include <vtkObjectFactory.h>
+#include <vtkSmartPointer.h>
 #include <vtkSQLiteDatabase.h>
 #include <vtkSQLiteQuery.h>
-#include <vtkSmartPointer.h>
+#include <vtkStringArray.h>
+#include <vtkTable.h>
 
 #include <vtksys/SystemTools.hxx>
 
+// STD includes
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <vector>
+
+namespace
+{
+// Maximum number of parameters in a single SQLite statement (SQLITE_MAX_VARIABLE_NUMBER default)
+const vtkIdType MAXIMUM_NUMBER_OF_STATEMENT_PARAMETERS = 999;
+
+enum ColumnBindingType
+{
+  BindInteger,
+  BindReal,
+  BindText
+};
+}
+
 //------------------------------------------------------------------------------
 vtkMRMLNodeNewMacro(vtkMRMLTableSQLiteStorageNode);
 
@@ -48,16 +68,24 @@ vtkMRMLTableSQLiteStorageNode::vtkMRMLTableSQLiteStorageNode()
 {
   this->TableName = nullptr;
   this->Password = nullptr;
+  this->WhereClause = nullptr;
   this->DefaultWriteFileExtension = "sqlite3";
 }
 
 //----------------------------------------------------------------------------
-vtkMRMLTableSQLiteStorageNode::~vtkMRMLTableSQLiteStorageNode() = default;
+vtkMRMLTableSQLiteStorageNode::~vtkMRMLTableSQLiteStorageNode()
+{
+  this->SetTableName(nullptr);
+  this->SetPassword(nullptr);
+  this->SetWhereClause(nullptr);
+}
 
 //----------------------------------------------------------------------------
 void vtkMRMLTableSQLiteStorageNode::PrintSelf(ostream& os, vtkIndent indent)
 {
   vtkMRMLStorageNode::PrintSelf(os,indent);
+  os << indent << "TableName: " << (this->TableName ? this->TableName : "(none)") << "\n";
+  os << indent << "WhereClause: " << (this->WhereClause ? this->WhereClause : "(none)") << "\n";
 }
 
 //----------------------------------------------------------------------------
@@ -66,6 +94,73 @@ bool vtkMRMLTableSQLiteStorageNode::CanReadInReferenceNode(vtkMRMLNode *refNode)
   return refNode->IsA("vtkMRMLTableNode");
 }
 
+//----------------------------------------------------------------------------
+std::string vtkMRMLTableSQLiteStorageNode::QuoteIdentifier(const std::string& name)
+{
+  std::string quotedName = "\"";
+  for (std::string::const_iterator it = name.begin(); it != name.end(); ++it)
+    {
+    if (*it == '"')
+      {
+      quotedName += '"';
+      }
+    quotedName += *it;
+    }
+  quotedName += "\"";
+  return quotedName;
+}
+
+//----------------------------------------------------------------------------
+std::string vtkMRMLTableSQLiteStorageNode::GetSQLiteColumnType(vtkAbstractArray* column)
+{
+  if (!column || !column->IsNumeric() || column->GetNumberOfComponents() != 1)
+    {
+    // multi-component values are written as text
+    return "TEXT";
+    }
+  switch (column->GetDataType())
+    {
+    case VTK_BIT:
+      return "BOOLEAN";
+    case VTK_FLOAT:
+      return "FLOAT";
+    case VTK_DOUBLE:
+      return "REAL";
+    default:
+      return "INTEGER";
+    }
+}
+
+//----------------------------------------------------------------------------
+vtkAbstractArray* vtkMRMLTableSQLiteStorageNode::CreateColumnForSQLiteType(const std::string& sqliteType)
+{
+  // Column affinity is determined as described in https://www.sqlite.org/datatype3.html
+  std::string type = vtksys::SystemTools::UpperCase(sqliteType);
+  if (type == "BOOLEAN")
+    {
+    return vtkBitArray::New();
+    }
+  if (type.find("INT") != std::string::npos)
+    {
+    return vtkIntArray::New();
+    }
+  if (type.find("CHAR") != std::string::npos || type.find("CLOB") != std::string::npos
+    || type.find("TEXT") != std::string::npos || type.empty())
+    {
+    return vtkStringArray::New();
+    }
+  if (type == "FLOAT")
+    {
+    return vtkFloatArray::New();
+    }
+  if (type.find("REAL") != std::string::npos || type.find("FLOA") != std::string::npos
+    || type.find("DOUB") != std::string::npos)
+    {
+    return vtkDoubleArray::New();
+    }
+  return vtkStringArray::New();
+}
+
 //----------------------------------------------------------------------------
 int vtkMRMLTableSQLiteStorageNode::ReadDataInternal(vtkMRMLNode *refNode)
 {
@@ -82,6 +177,11 @@ int vtkMRMLTableSQLiteStorageNode::ReadDataInternal(vtkMRMLNode *refNode)
     vtkErrorMacro("ReadData: unable to cast input node " << refNode->GetID() << " to a table node");
     return 0;
     }
+  if (!this->TableName || std::string(this->TableName).empty())
+    {
+    vtkErrorMacro("ReadData: no table name specified");
+    return 0;
+    }
 
   // Check that the file exists
   if (vtksys::SystemTools::FileExists(fullName) == false)
@@ -102,16 +202,74 @@ int vtkMRMLTableSQLiteStorageNode::ReadDataInternal(vtkMRMLNode *refNode)
 
   vtkSmartPointer<vtkSQLiteQuery> query = vtkSmartPointer<vtkSQLiteQuery>::Take(
                    vtkSQLiteQuery::SafeDownCast( database->GetQueryInstance()));
-  std::string queryString("select * from ");
-  queryString += std::string(this->TableName);
+
+  // Get declared column types
+  std::map<std::string, std::string> declaredColumnTypes;
+  std::string tableInfoQuery = std::string("PRAGMA table_info(") + QuoteIdentifier(this->TableName) + ")";
+  query->SetQuery(tableInfoQuery.c_str());
+  if (query->Execute())
+    {
+    while (query->NextRow())
+      {
+      // table_info columns: cid, name, type, notnull, dflt_value, pk
+      declaredColumnTypes[query->DataValue(1).ToString()] = query->DataValue(2).ToString();
+      }
+    }
+
+  std::string queryString("SELECT * FROM ");
+  queryString += QuoteIdentifier(this->TableName);
+  if (this->WhereClause && strlen(this->WhereClause) > 0)
+    {
+    queryString += std::string(" WHERE ") + this->WhereClause;
+    }
   query->SetQuery(queryString.c_str());
-  query->Execute();
+  if (!query->Execute())
+    {
+    vtkErrorMacro("ReadData: failed to read table '" << this->TableName << "' from database file '" << fullName
+      << "': " << (query->GetLastErrorText() ? query->GetLastErrorText() : ""));
+    return 0;
+    }
 
-  vtkSmartPointer<vtkRowQueryToTable> queryToTable = vtkSmartPointer<vtkRowQueryToTable>::New();
-  queryToTable->SetQuery(query);
-  queryToTable->Update();
+  // Create typed columns
+  vtkNew<vtkTable> table;
+  int numberOfFields = query->GetNumberOfFields();
+  std::vector<vtkAbstractArray*> columns;
+  std::vector<vtkDataArray*> dataColumns;
+  std::vector<vtkStringArray*> stringColumns;
+  for (int fieldIndex = 0; fieldIndex < numberOfFields; ++fieldIndex)
+    {
+    std::string columnName = query->GetFieldName(fieldIndex);
+    vtkSmartPointer<vtkAbstractArray> column = vtkSmartPointer<vtkAbstractArray>::Take(
+      CreateColumnForSQLiteType(declaredColumnTypes[columnName]));
+    column->SetName(columnName.c_str());
+    table->AddColumn(column);
+    columns.push_back(column);
+    dataColumns.push_back(vtkDataArray::SafeDownCast(column));
+    stringColumns.push_back(vtkStringArray::SafeDownCast(column));
+    }
 
-  vtkSmartPointer<vtkTable> table = queryToTable->GetOutput();
+  // Fill the columns directly, values of numeric columns are not converted to text
+  while (query->NextRow())
+    {
+    for (int fieldIndex = 0; fieldIndex < numberOfFields; ++fieldIndex)
+      {
+      vtkVariant value = query->DataValue(fieldIndex);
+      if (dataColumns[fieldIndex])
+        {
+        bool valid = false;
+        double numericValue = value.ToDouble(&valid);
+        dataColumns[fieldIndex]->InsertNextTuple1(valid ? numericValue : 0.0);
+        }
+      else if (stringColumns[fieldIndex])
+        {
+        stringColumns[fieldIndex]->InsertNextValue(value.IsValid() ? value.ToString() : vtkStdString());
+        }
+      else
+        {
+        columns[fieldIndex]->InsertVariantValue(columns[fieldIndex]->GetNumberOfValues(), value);
+        }
+      }
+    }
 
   tableNode->SetAndObserveTable(table);
 
@@ -147,27 +305,20 @@ int vtkMRMLTableSQLiteStorageNode::WriteDataInternal(vtkMRMLNode *refNode)
     return 0;
     }
 
-  std::string dbname = std::string("sqlite://") + fullName;
-
-  //vtkSmartPointer<vtkSQLiteDatabase> database = vtkSmartPointer<vtkSQLiteDatabase>::Take(vtkSQLiteDatabase::SafeDownCast( vtkSQLiteDatabase::CreateFromURL(dbname.c_str())));
-  vtkSQLiteDatabase *database = vtkSQLiteDatabase::SafeDownCast( vtkSQLiteDatabase::CreateFromURL(dbname.c_str()));
-
-  if (!database || !database->Open(this->GetPassword(), vtkSQLiteDatabase::USE_EXISTING_OR_CREATE))
-    {
-    vtkErrorMacro("ReadData: database file '" << fullName << "cannot be opened");
-    return 0;
-    }
-
   vtkTable *table = tableNode->GetTable();
   if (!table)
     {
-    vtkErrorMacro("ReadData: no table to write for the node '" << std::string(tableNode->GetName()));
+    vtkErrorMacro("WriteData: no table to write for the node '" << std::string(tableNode->GetName()));
     return 0;
     }
 
-  if (!this->TableName || std::string(this->TableName).empty())
+  std::string dbname = std::string("sqlite://") + fullName;
+  vtkSmartPointer<vtkSQLiteDatabase> database = vtkSmartPointer<vtkSQLiteDatabase>::Take(
+                   vtkSQLiteDatabase::SafeDownCast( vtkSQLiteDatabase::CreateFromURL(dbname.c_str())));
+
+  if (!database.GetPointer() || !database->Open(this->GetPassword(), vtkSQLiteDatabase::USE_EXISTING_OR_CREATE))
     {
-    vtkErrorMacro("ReadData: no table name for the node '" << std::string(tableNode->GetName()));
+    vtkErrorMacro("WriteData: database file '" << fullName << "cannot be opened");
     return 0;
     }
 
@@ -176,95 +327,139 @@ int vtkMRMLTableSQLiteStorageNode::WriteDataInternal(vtkMRMLNode *refNode)
 
   //converting this table to SQLite will require two queries: one to create
   //the table, and another to populate its rows with data.
-  std::string createTableQuery = "CREATE TABLE IF NOT EXISTS ";
-  createTableQuery += this->TableName;
-  createTableQuery += "(";
-
-  std::string insertPreamble = "INSERT into ";
-  insertPreamble += this->TableName;
-  insertPreamble += "(";
+  std::string quotedTableName = QuoteIdentifier(this->TableName);
+  std::string createTableQuery = "CREATE TABLE IF NOT EXISTS " + quotedTableName + " (";
+  std::string insertPreamble = "INSERT INTO " + quotedTableName + " (";
+  std::string rowParameters = "(";
 
   //get the columns from the vtkTable to finish the query
   vtkIdType numColumns = table->GetNumberOfColumns();
+  std::vector<int> columnBindingTypes;
+  std::vector<vtkAbstractArray*> columns;
+  std::vector<vtkDataArray*> dataColumns;
   for(vtkIdType i = 0; i < numColumns; i++)
     {
-    //get this column's name
-    std::string columnName = table->GetColumn(i)->GetName();
-    createTableQuery += columnName;
-    insertPreamble += "'" + columnName + "'";
-
-    //figure out what type of data is stored in this column
-    std::string columnType = table->GetColumn(i)->GetClassName();
-
-    if( (columnType.find("String") != std::string::npos) ||
-        (columnType.find("Data") != std::string::npos) ||
-        (columnType.find("Variant") != std::string::npos) )
+    vtkAbstractArray* column = table->GetColumn(i);
+    columns.push_back(column);
+    dataColumns.push_back(vtkDataArray::SafeDownCast(column));
+    std::string quotedColumnName = QuoteIdentifier(column->GetName() ? column->GetName() : "");
+    std::string columnType = GetSQLiteColumnType(column);
+    createTableQuery += quotedColumnName + " " + columnType;
+    insertPreamble += quotedColumnName;
+    rowParameters += "?";
+    if (columnType == "TEXT")
       {
-      createTableQuery += " TEXT";
+      columnBindingTypes.push_back(BindText);
       }
-    else if( (columnType.find("Double") != std::string::npos) ||
-             (columnType.find("Float") != std::string::npos) )
+    else if (columnType == "REAL" || columnType == "FLOAT")
       {
-      createTableQuery += " REAL";
+      columnBindingTypes.push_back(BindReal);
       }
     else
       {
-      createTableQuery += " INTEGER";
-      }
-    if(i == numColumns - 1)
-      {
-      createTableQuery += ");";
-      insertPreamble += ") VALUES (";
+      columnBindingTypes.push_back(BindInteger);
       }
-    else
+    if (i < numColumns - 1)
       {
       createTableQuery += ", ";
       insertPreamble += ", ";
+      rowParameters += ", ";
       }
     }
+  createTableQuery += ");";
+  insertPreamble += ") VALUES ";
+  rowParameters += ")";
 
   //perform the create table query
-  vtkSQLiteQuery *query =
-    static_cast<vtkSQLiteQuery*>(database->GetQueryInstance());
-
+  vtkSmartPointer<vtkSQLiteQuery> query = vtkSmartPointer<vtkSQLiteQuery>::Take(
+                   vtkSQLiteQuery::SafeDownCast( database->GetQueryInstance()));
   query->SetQuery(createTableQuery.c_str());
-  cout << "creating the table" << endl;
+  vtkDebugMacro("WriteData: creating the table " << this->TableName);
   if(!query->Execute())
     {
-    vtkErrorMacro(<<"Error performing 'create table' query");
+    vtkErrorMacro(<<"Error performing 'create table' query: " << (query->GetLastErrorText() ? query->GetLastErrorText() : ""));
+    return 0;
     }
 
-  //iterate over the rows of the vtkTable to complete the insert query
   vtkIdType numRows = table->GetNumberOfRows();
-  for(vtkIdType i = 0; i < numRows; i++)
+  if (numColumns == 0 || numRows == 0)
+    {
+    return 1;
+    }
+
+  // Multiple rows are inserted by each execution of the prepared statement. All the insertions
+  // are done in a single transaction, otherwise each insertion would be committed to the file.
+  vtkIdType rowsPerStatement = std::max<vtkIdType>(1, MAXIMUM_NUMBER_OF_STATEMENT_PARAMETERS / numColumns);
+  vtkIdType preparedStatementRows = 0;
+  if (!query->BeginTransaction())
+    {
+    vtkErrorMacro(<<"Error starting transaction: " << (query->GetLastErrorText() ? query->GetLastErrorText() : ""));
+    return 0;
+    }
+  for (vtkIdType firstRow = 0; firstRow < numRows; firstRow += rowsPerStatement)
     {
-    std::string insertQuery = insertPreamble;
-    for (vtkIdType j = 0; j < numColumns; j++)
+    vtkIdType statementRows = std::min(rowsPerStatement, numRows - firstRow);
+    if (statementRows != preparedStatementRows)
+      {
+      // this happens at most twice: for the full batches and for the last batch
+      std::string insertQuery = insertPreamble;
+      for (vtkIdType row = 0; row < statementRows; row++)
+        {
+        insertQuery += (row > 0 ? ", " : "") + rowParameters;
+        }
+      insertQuery += ";";
+      if (!query->SetQuery(insertQuery.c_str()))
+        {
+        vtkErrorMacro(<<"Error preparing 'insert' query: " << (query->GetLastErrorText() ? query->GetLastErrorText() : ""));
+        query->RollbackTransaction();
+        return 0;
+        }
+      preparedStatementRows = statementRows;
+      }
+    int parameterIndex = 0;
+    for (vtkIdType i = firstRow; i < firstRow + statementRows; i++)
       {
-      insertQuery += "'" + table->GetValue(i, j).ToString() + "'";
-      if(j < numColumns - 1)
+      for (vtkIdType j = 0; j < numColumns; j++)
         {
-        insertQuery += ", ";
+        switch (columnBindingTypes[j])
+          {
+          case BindInteger:
+            query->BindParameter(parameterIndex, columns[j]->GetVariantValue(i).ToTypeInt64());
+            break;
+          case BindReal:
+            query->BindParameter(parameterIndex, dataColumns[j]->GetComponent(i, 0));
+            break;
+          default:
+            {
+            std::string text = table->GetValue(i, j).ToString();
+            query->BindParameter(parameterIndex, text.c_str(), text.size());
+            }
+          }
+        parameterIndex++;
         }
       }
-    insertQuery += ");";
-    //perform the insert query for this row
-    query->SetQuery(insertQuery.c_str());
     if(!query->Execute())
       {
-      vtkErrorMacro(<<"Error performing 'insert' query");
+      vtkErrorMacro(<<"Error performing 'insert' query: " << (query->GetLastErrorText() ? query->GetLastErrorText() : ""));
+      query->RollbackTransaction();
+      return 0;
       }
     }
+  if (!query->CommitTransaction())
+    {
+    vtkErrorMacro(<<"Error committing transaction: " << (query->GetLastErrorText() ? query->GetLastErrorText() : ""));
+    return 0;
+    }
 
   //cleanup and return
-  query->Delete();
+  query = nullptr;
   database->Close();
-  database->Delete();
 
   vtkDebugMacro("WriteData: successfully wrote table to database: " << fullName);
   return 1;
 }
 
+//----------------------------------------------------------------------------
 int vtkMRMLTableSQLiteStorageNode::DropTable(char *tableName, vtkSQLiteDatabase* database)
 {
   if(!tableName || std::string(tableName).empty())
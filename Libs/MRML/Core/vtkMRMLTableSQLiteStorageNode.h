@@ -30,8 +30,12 @@
 /// vtkMRMLTableSQLiteStorageNode allows reading/writing of table node from
 /// SQLight database.
 ///
-///
+/// Rows are written with a prepared insert statement (multiple rows per statement)
+/// inside a single transaction. The declared type of each database column is
+/// set from the type of the table column, and columns are read into arrays of the
+/// corresponding type.
 
+class vtkAbstractArray;
 class vtkSQLiteDatabase;
 
 class VTK_MRML_EXPORT vtkMRMLTableSQLiteStorageNode : public vtkMRMLStorageNode
@@ -57,6 +61,12 @@ public:
   vtkSetStringMacro(TableName);
   vtkGetStringMacro(TableName);
 
+  /// Optional SQL condition (without the WHERE keyword) that selects
+  /// the rows that are read from the database table.
+  /// If empty (default) then all rows are read.
+  vtkSetStringMacro(WhereClause);
+  vtkGetStringMacro(WhereClause);
+
   /// Drop a specified table from the database
   static int DropTable(char *tableName, vtkSQLiteDatabase* database);
 
@@ -78,8 +88,18 @@ protected:
   /// Write data from a  referenced node. Returns 0 on failure.
   int WriteDataInternal(vtkMRMLNode *refNode) override;
 
+  /// Get declared SQLite column type (INTEGER, BOOLEAN, FLOAT, REAL, TEXT) for a table column
+  static std::string GetSQLiteColumnType(vtkAbstractArray* column);
+
+  /// Create an empty table column that can store values of a declared SQLite column type
+  static vtkAbstractArray* CreateColumnForSQLiteType(const std::string& sqliteType);
+
+  /// Quote a table or column name for use in a SQL statement
+  static std::string QuoteIdentifier(const std::string& name);
+
   char *TableName;
   char *Password;
+  char *WhereClause;
 };
 
 #endif
@@ -36,16 +36,535 @@
 #include <vtkNew.h>
 #include <vtksys/SystemTools.hxx>
 
+// STD includes
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <thread>
+#include <type_traits>
+
 //------------------------------------------------------------------------------
 vtkMRMLNodeNewMacro(vtkMRMLTableStorageNode);
 
 const char* COMPONENT_SEPERATOR = "_";
 
+//----------------------------------------------------------------------------
+namespace
+{
+/// Number of rows used for detecting column types
+const size_t COLUMN_TYPE_DETECTION_ROWS = 1000;
+/// Minimum number of rows parsed by each thread
+const size_t ROWS_PER_THREAD = 1024;
+
+enum ParseStatus
+{
+  ValueValid,
+  ValueEmpty,
+  ValueInvalid
+};
+
+//----------------------------------------------------------------------------
+bool IsTrailingSpace(const char* text)
+{
+  while (*text == ' ' || *text == '\t' || *text == '\r')
+    {
+    ++text;
+    }
+  return *text == '\0';
+}
+
+//----------------------------------------------------------------------------
+template <class T>
+typename std::enable_if<std::is_integral<T>::value && std::is_signed<T>::value, bool>::type
+ParseValue(const char* begin, char** end, T& value)
+{
+  errno = 0;
+  long long parsed = strtoll(begin, end, 10);
+  if (errno == ERANGE
+    || parsed < static_cast<long long>(std::numeric_limits<T>::lowest())
+    || parsed > static_cast<long long>(std::numeric_limits<T>::max()))
+    {
+    return false;
+    }
+  value = static_cast<T>(parsed);
+  return true;
+}
+
+//----------------------------------------------------------------------------
+template <class T>
+typename std::enable_if<std::is_integral<T>::value && !std::is_signed<T>::value, bool>::type
+ParseValue(const char* begin, char** end, T& value)
+{
+  if (strchr(begin, '-'))
+    {
+    // strtoull accepts negative values
+    return false;
+    }
+  errno = 0;
+  unsigned long long parsed = strtoull(begin, end, 10);
+  if (errno == ERANGE || parsed > static_cast<unsigned long long>(std::numeric_limits<T>::max()))
+    {
+    return false;
+    }
+  value = static_cast<T>(parsed);
+  return true;
+}
+
+//----------------------------------------------------------------------------
+template <class T>
+typename std::enable_if<std::is_floating_point<T>::value, bool>::type
+ParseValue(const char* begin, char** end, T& value)
+{
+  value = static_cast<T>(strtod(begin, end));
+  return true;
+}
+
+//----------------------------------------------------------------------------
+/// Parse the whole text as a number of type T. Returns false if the text
+/// is not a number or it is out of the range of T.
+template <class T>
+bool ParseNumber(const std::string& text, T& value)
+{
+  const char* begin = text.c_str();
+  char* end = nullptr;
+  return ParseValue(begin, &end, value) && end != begin && IsTrailingSpace(end);
+}
+
+//----------------------------------------------------------------------------
+template <class T>
+int SetNumericValue(void* values, vtkIdType index, const std::string& text, double nullValue)
+{
+  T* value = static_cast<T*>(values) + index;
+  if (text.empty())
+    {
+    *value = static_cast<T>(nullValue);
+    return ValueEmpty;
+    }
+  if (!ParseNumber(text, *value))
+    {
+    *value = static_cast<T>(nullValue);
+    return ValueInvalid;
+    }
+  return ValueValid;
+}
+
+//----------------------------------------------------------------------------
+/// Split a row into fields and call fieldFunction(columnIndex, value) for each of them.
+/// Fields may be enclosed in quotation marks (then they may contain delimiter and
+/// newline characters), a pair of quotation marks in a quoted field is a quotation mark.
+/// Returns the number of fields.
+template <class FieldFunction>
+int ParseRow(const char* begin, const char* end, char delimiter, std::string& field, FieldFunction fieldFunction)
+{
+  int columnIndex = 0;
+  bool inQuotes = false;
+  bool atFieldStart = true;
+  bool afterClosingQuote = false;
+  field.clear();
+  for (const char* c = begin; c < end; ++c)
+    {
+    if (inQuotes)
+      {
+      if (*c == '"')
+        {
+        inQuotes = false;
+        afterClosingQuote = true;
+        }
+      else
+        {
+        field.push_back(*c);
+        }
+      continue;
+      }
+    if (*c == delimiter)
+      {
+      fieldFunction(columnIndex++, field);
+      field.clear();
+      atFieldStart = true;
+      afterClosingQuote = false;
+      continue;
+      }
+    if (*c == '"' && (atFieldStart || afterClosingQuote))
+      {
+      if (afterClosingQuote)
+        {
+        field.push_back('"');
+        }
+      inQuotes = true;
+      atFieldStart = false;
+      afterClosingQuote = false;
+      continue;
+      }
+    field.push_back(*c);
+    atFieldStart = false;
+    afterClosingQuote = false;
+    }
+  fieldFunction(columnIndex++, field);
+  return columnIndex;
+}
+
+//----------------------------------------------------------------------------
+/// Parses delimited text files directly into typed arrays
+class DelimitedTextParser
+{
+public:
+  struct Row
+  {
+    size_t Begin;
+    size_t End;
+  };
+
+  struct Column
+  {
+    std::string Name;
+    vtkSmartPointer<vtkAbstractArray> Array;
+    int DataType = VTK_STRING;
+    double NullValue = 0.0;
+    bool DetectType = false;
+  };
+
+  char Delimiter = ',';
+  std::vector<char> Buffer;
+  /// Data rows (the header row is not included)
+  std::vector<Row> Rows;
+  std::vector<Column> Columns;
+  bool Truncated = false;
+
+  //----------------------------------------------------------------------------
+  /// Read the file content and find the rows.
+  /// Only the first maximumNumberOfRows data rows are read if it is not negative.
+  bool ReadRows(const std::string& fileName, vtkIdType maximumNumberOfRows)
+  {
+    const size_t blockSize = 16 * 1024 * 1024;
+    std::ifstream file(fileName.c_str(), std::ios::in | std::ios::binary);
+    if (!file.is_open())
+      {
+      return false;
+      }
+    if (maximumNumberOfRows < 0)
+      {
+      this->Buffer.reserve(static_cast<size_t>(vtksys::SystemTools::FileLength(fileName)) + blockSize);
+      }
+    // header row is included in the row count until parsing
+    size_t maximumNumberOfFileRows = (maximumNumberOfRows < 0
+      ? std::numeric_limits<size_t>::max() : static_cast<size_t>(maximumNumberOfRows) + 1);
+    bool inQuotes = false;
+    bool atFieldStart = true;
+    bool afterClosingQuote = false;
+    size_t rowBegin = 0;
+    size_t position = 0;
+    bool endOfFile = false;
+    while (!endOfFile)
+      {
+      size_t previousSize = this->Buffer.size();
+      this->Buffer.resize(previousSize + blockSize);
+      file.read(this->Buffer.data() + previousSize, static_cast<std::streamsize>(blockSize));
+      size_t readSize = static_cast<size_t>(file.gcount());
+      this->Buffer.resize(previousSize + readSize);
+      endOfFile = (readSize < blockSize);
+      // skip UTF-8 byte order mark
+      if (previousSize == 0 && readSize >= 3 && memcmp(this->Buffer.data(), "\xEF\xBB\xBF", 3) == 0)
+        {
+        rowBegin = position = 3;
+        }
+      for (; position < this->Buffer.size(); ++position)
+        {
+        // same quoting rules as in ParseRow
+        char c = this->Buffer[position];
+        if (inQuotes)
+          {
+          if (c == '"')
+            {
+            inQuotes = false;
+            afterClosingQuote = true;
+            }
+          continue;
+          }
+        if (c == '"' && (atFieldStart || afterClosingQuote))
+          {
+          inQuotes = true;
+          atFieldStart = false;
+          afterClosingQuote = false;
+          continue;
+          }
+        atFieldStart = (c == this->Delimiter || c == '\n');
+        afterClosingQuote = false;
+        if (c == '\n')
+          {
+          this->AddRow(rowBegin, position);
+          rowBegin = position + 1;
+          if (this->Rows.size() >= maximumNumberOfFileRows)
+            {
+            this->Truncated = !endOfFile
+              || std::find_if(this->Buffer.begin() + rowBegin, this->Buffer.end(),
+                [](char remaining) { return remaining != '\r' && remaining != '\n'; }) != this->Buffer.end();
+            this->Buffer.resize(rowBegin);
+            return true;
+            }
+          }
+        }
+      }
+    this->AddRow(rowBegin, this->Buffer.size());
+    return true;
+  }
+
+  //----------------------------------------------------------------------------
+  void AddRow(size_t begin, size_t end)
+  {
+    if (end > begin && this->Buffer[end - 1] == '\r')
+      {
+      --end;
+      }
+    if (end == begin)
+      {
+      // skip empty lines
+      return;
+      }
+    Row row = { begin, end };
+    this->Rows.push_back(row);
+  }
+
+  //----------------------------------------------------------------------------
+  /// Get column names from the first row and remove it from the data rows
+  bool ReadHeader()
+  {
+    if (this->Rows.empty())
+      {
+      return false;
+      }
+    std::vector<std::string> names;
+    std::string field;
+    ParseRow(this->Buffer.data() + this->Rows[0].Begin, this->Buffer.data() + this->Rows[0].End, this->Delimiter, field,
+      [&names](int, const std::string& value) { names.push_back(value); });
+    this->Rows.erase(this->Rows.begin());
+    this->Columns.resize(names.size());
+    for (size_t columnIndex = 0; columnIndex < names.size(); ++columnIndex)
+      {
+      this->Columns[columnIndex].Name = names[columnIndex];
+      }
+    return true;
+  }
+
+  //----------------------------------------------------------------------------
+  /// Choose integer, floating-point, or string type for the columns that have DetectType enabled,
+  /// from the first rows of the table.
+  void DetectColumnTypes()
+  {
+    std::vector<int> detectedTypes(this->Columns.size(), VTK_VOID);
+    std::vector<bool> hasEmptyValues(this->Columns.size(), false);
+    std::string field;
+    size_t numberOfRows = std::min(this->Rows.size(), COLUMN_TYPE_DETECTION_ROWS);
+    for (size_t rowIndex = 0; rowIndex < numberOfRows; ++rowIndex)
+      {
+      const Row& row = this->Rows[rowIndex];
+      int numberOfFields = ParseRow(this->Buffer.data() + row.Begin, this->Buffer.data() + row.End, this->Delimiter, field,
+        [&](int columnIndex, const std::string& value)
+        {
+          if (columnIndex >= static_cast<int>(this->Columns.size()) || !this->Columns[columnIndex].DetectType)
+            {
+            return;
+            }
+          int& detectedType = detectedTypes[columnIndex];
+          if (value.empty())
+            {
+            hasEmptyValues[columnIndex] = true;
+            return;
+            }
+          int intValue = 0;
+          double doubleValue = 0.0;
+          if ((detectedType == VTK_VOID || detectedType == VTK_INT) && ParseNumber(value, intValue))
+            {
+            detectedType = VTK_INT;
+            }
+          else if (detectedType != VTK_STRING && ParseNumber(value, doubleValue))
+            {
+            detectedType = VTK_DOUBLE;
+            }
+          else
+            {
+            detectedType = VTK_STRING;
+            }
+        });
+      for (int columnIndex = numberOfFields; columnIndex < static_cast<int>(this->Columns.size()); ++columnIndex)
+        {
+        hasEmptyValues[columnIndex] = true;
+        }
+      }
+    for (size_t columnIndex = 0; columnIndex < this->Columns.size(); ++columnIndex)
+      {
+      Column& column = this->Columns[columnIndex];
+      if (!column.DetectType)
+        {
+        continue;
+        }
+      column.DataType = detectedTypes[columnIndex];
+      if (column.DataType == VTK_VOID)
+        {
+        // no values
+        column.DataType = VTK_STRING;
+        }
+      if (column.DataType == VTK_INT && hasEmptyValues[columnIndex])
+        {
+        // integer columns have no value for representing missing values
+        column.DataType = VTK_DOUBLE;
+        }
+      column.NullValue = (column.DataType == VTK_DOUBLE ? std::numeric_limits<double>::quiet_NaN() : 0.0);
+      }
+  }
+
+  //----------------------------------------------------------------------------
+  void AllocateColumn(Column& column)
+  {
+    if (column.DataType == VTK_STRING)
+      {
+      column.Array = vtkSmartPointer<vtkStringArray>::New();
+      }
+    else
+      {
+      column.Array = vtkSmartPointer<vtkAbstractArray>::Take(vtkAbstractArray::CreateArray(column.DataType));
+      }
+    column.Array->SetName(column.Name.c_str());
+    column.Array->SetNumberOfComponents(1);
+    column.Array->SetNumberOfTuples(static_cast<vtkIdType>(this->Rows.size()));
+  }
+
+  //----------------------------------------------------------------------------
+  /// Parse the selected columns of rows [firstRow, lastRow).
+  /// Sets failed[columnIndex] if a value could not be stored in the column.
+  void ParseRows(size_t firstRow, size_t lastRow, const std::vector<char>& selectedColumns, std::vector<char>& failed)
+  {
+    size_t numberOfColumns = this->Columns.size();
+    std::vector<void*> values(numberOfColumns, nullptr);
+    for (size_t columnIndex = 0; columnIndex < numberOfColumns; ++columnIndex)
+      {
+      if (selectedColumns[columnIndex] && this->Columns[columnIndex].DataType != VTK_STRING)
+        {
+        values[columnIndex] = this->Columns[columnIndex].Array->GetVoidPointer(0);
+        }
+      }
+    vtkIdType rowIndex = 0;
+    auto setValue = [&](int columnIndex, const std::string& value)
+      {
+      if (columnIndex >= static_cast<int>(numberOfColumns) || !selectedColumns[columnIndex])
+        {
+        return;
+        }
+      const Column& column = this->Columns[columnIndex];
+      if (column.DataType == VTK_STRING)
+        {
+        static_cast<vtkStringArray*>(column.Array.GetPointer())->GetPointer(rowIndex)->assign(value);
+        return;
+        }
+      int status = ValueValid;
+      switch (column.DataType)
+        {
+        vtkTemplateMacro(status = SetNumericValue<VTK_TT>(values[columnIndex], rowIndex, value, column.NullValue));
+        }
+      if (status == ValueInvalid || (status == ValueEmpty && column.DetectType && column.DataType != VTK_DOUBLE))
+        {
+        failed[columnIndex] = 1;
+        }
+      };
+    std::string field;
+    const std::string emptyField;
+    for (size_t row = firstRow; row < lastRow; ++row)
+      {
+      rowIndex = static_cast<vtkIdType>(row);
+      int numberOfFields = ParseRow(this->Buffer.data() + this->Rows[row].Begin, this->Buffer.data() + this->Rows[row].End,
+        this->Delimiter, field, setValue);
+      for (int columnIndex = numberOfFields; columnIndex < static_cast<int>(numberOfColumns); ++columnIndex)
+        {
+        setValue(columnIndex, emptyField);
+        }
+      }
+  }
+
+  //----------------------------------------------------------------------------
+  /// Allocate and parse the selected columns, splitting the rows between threads
+  void ParseColumns(const std::vector<char>& selectedColumns, int numberOfThreads, std::vector<char>& failed)
+  {
+    for (size_t columnIndex = 0; columnIndex < this->Columns.size(); ++columnIndex)
+      {
+      if (selectedColumns[columnIndex])
+        {
+        this->AllocateColumn(this->Columns[columnIndex]);
+        }
+      }
+    size_t numberOfRows = this->Rows.size();
+    numberOfThreads = static_cast<int>(std::max<size_t>(1,
+      std::min<size_t>(static_cast<size_t>(numberOfThreads), numberOfRows / ROWS_PER_THREAD)));
+    std::vector<std::vector<char> > threadFailed(numberOfThreads, std::vector<char>(this->Columns.size(), 0));
+    std::vector<std::thread> threads;
+    size_t rowsPerThread = (numberOfRows + numberOfThreads - 1) / numberOfThreads;
+    for (int threadIndex = 1; threadIndex < numberOfThreads; ++threadIndex)
+      {
+      size_t firstRow = std::min(numberOfRows, threadIndex * rowsPerThread);
+      size_t lastRow = std::min(numberOfRows, firstRow + rowsPerThread);
+      threads.push_back(std::thread(&DelimitedTextParser::ParseRows, this, firstRow, lastRow,
+        std::cref(selectedColumns), std::ref(threadFailed[threadIndex])));
+      }
+    this->ParseRows(0, std::min(numberOfRows, rowsPerThread), selectedColumns, threadFailed[0]);
+    for (std::vector<std::thread>::iterator threadIt = threads.begin(); threadIt != threads.end(); ++threadIt)
+      {
+      threadIt->join();
+      }
+    failed.assign(this->Columns.size(), 0);
+    for (int threadIndex = 0; threadIndex < numberOfThreads; ++threadIndex)
+      {
+      for (size_t columnIndex = 0; columnIndex < this->Columns.size(); ++columnIndex)
+        {
+        failed[columnIndex] |= threadFailed[threadIndex][columnIndex];
+        }
+      }
+  }
+
+  //----------------------------------------------------------------------------
+  /// Parse all columns. Columns with a detected type that turns out to be wrong
+  /// for some of the rows are parsed again with a more general type.
+  void Parse(int numberOfThreads)
+  {
+    std::vector<char> selectedColumns(this->Columns.size(), 1);
+    std::vector<char> failed;
+    this->ParseColumns(selectedColumns, numberOfThreads, failed);
+    while (true)
+      {
+      bool reparse = false;
+      for (size_t columnIndex = 0; columnIndex < this->Columns.size(); ++columnIndex)
+        {
+        Column& column = this->Columns[columnIndex];
+        // invalid values of columns with a type defined in the schema are replaced by the null value
+        selectedColumns[columnIndex] = (failed[columnIndex] && column.DetectType);
+        if (!selectedColumns[columnIndex])
+          {
+          continue;
+          }
+        column.DataType = (column.DataType == VTK_DOUBLE ? VTK_STRING : VTK_DOUBLE);
+        column.NullValue = std::numeric_limits<double>::quiet_NaN();
+        reparse = true;
+        }
+      if (!reparse)
+        {
+        break;
+        }
+      this->ParseColumns(selectedColumns, numberOfThreads, failed);
+      }
+  }
+};
+}
+
 //----------------------------------------------------------------------------
 vtkMRMLTableStorageNode::vtkMRMLTableStorageNode()
 {
   this->DefaultWriteFileExtension = "tsv";
   this->AutoFindSchema = true;
+  this->AutoDetectColumnTypes = false;
+  this->MaximumNumberOfRows = -1;
+  this->NumberOfReadThreads = std::min(64, std::max(1, static_cast<int>(std::thread::hardware_concurrency())));
 }
 
 //----------------------------------------------------------------------------
@@ -55,6 +574,10 @@ vtkMRMLTableStorageNode::~vtkMRMLTableStorageNode() = default;
 void vtkMRMLTableStorageNode::PrintSelf(ostream& os, vtkIndent indent)
 {
   vtkMRMLStorageNode::PrintSelf(os,indent);
+  os << indent << "AutoFindSchema: " << this->AutoFindSchema << "\n";
+  os << indent << "AutoDetectColumnTypes: " << this->AutoDetectColumnTypes << "\n";
+  os << indent << "MaximumNumberOfRows: " << this->MaximumNumberOfRows << "\n";
+  os << indent << "NumberOfReadThreads: " << this->NumberOfReadThreads << "\n";
 }
 
 //----------------------------------------------------------------------------
@@ -132,6 +655,14 @@ int vtkMRMLTableStorageNode::WriteDataInternal(vtkMRMLNode *refNode)
     return 0;
     }
 
+  if (!this->TruncatedFileName.empty()
+    && vtksys::SystemTools::ComparePath(this->TruncatedFileName, fullName))
+    {
+    vtkErrorMacro("WriteData: table node " << refNode->GetID() << " contains only the first "
+      << this->MaximumNumberOfRows << " rows of " << fullName << ", it is not written to the same file");
+    return 0;
+    }
+
   if (!this->WriteTable(fullName, tableNode))
     {
     vtkErrorMacro("WriteData: failed to write table node " << refNode->GetID() << " to file " << fullName);
@@ -333,7 +864,7 @@ std::vector<vtkMRMLTableStorageNode::ColumnInfo> vtkMRMLTableStorageNode::GetCol
     for (int col = 0; col < rawTable->GetNumberOfColumns(); ++col)
       {
       vtkMRMLTableStorageNode::ColumnInfo columnInfo;
-      vtkStringArray* column = vtkStringArray::SafeDownCast(rawTable->GetColumn(col));
+      vtkAbstractArray* column = rawTable->GetColumn(col);
       if (column == nullptr)
         {
         vtkWarningMacro("vtkMRMLTableStorageNode::GetColumnInfo: invalid column - " << col);
@@ -346,6 +877,11 @@ std::vector<vtkMRMLTableStorageNode::ColumnInfo> vtkMRMLTableStorageNode::GetCol
         }
       columnInfo.ColumnName = column->GetName();
       columnInfo.ScalarType = tableNode->GetColumnValueTypeFromSchema(columnInfo.ColumnName);
+      if (columnInfo.ScalarType == VTK_VOID)
+        {
+        // type was detected when the column was read
+        columnInfo.ScalarType = column->GetDataType();
+        }
       columnInfo.RawComponentArrays.push_back(column);
       columnInfo.NullValueString = tableNode->GetColumnProperty(columnInfo.ColumnName, "nullValue");
       columnDetails.push_back(columnInfo);
@@ -471,24 +1007,30 @@ void vtkMRMLTableStorageNode::AddColumnToTable(vtkTable* table, vtkMRMLTableStor
     vtkIdType componentIndex = 0;
     for (vtkAbstractArray* componentArray : rawComponentArrays)
       {
-      vtkSmartPointer<vtkStringArray> rawComponentArray = vtkStringArray::SafeDownCast(componentArray);
-      if (rawComponentArray == nullptr)
+      // Single-component array for a potentially multi-component column
+      vtkSmartPointer<vtkDataArray> typedComponentArray = vtkDataArray::SafeDownCast(componentArray);
+      if (typedComponentArray == nullptr
+        || typedComponentArray->GetDataType() != valueTypeId
+        || typedComponentArray->GetNumberOfTuples() != numberOfTuples)
         {
-        vtkWarningMacro("vtkMRMLTableStorageNode::ReadTable: Failed to read component for column " << columnName);
-        // Add an empty default array for components that are not found
-        rawComponentArray = vtkSmartPointer<vtkStringArray>::New();
-        rawComponentArray->SetNumberOfComponents(1);
-        rawComponentArray->SetNumberOfTuples(numberOfTuples);
-        }
+        vtkSmartPointer<vtkStringArray> rawComponentArray = vtkStringArray::SafeDownCast(componentArray);
+        if (rawComponentArray == nullptr)
+          {
+          vtkWarningMacro("vtkMRMLTableStorageNode::ReadTable: Failed to read component for column " << columnName);
+          // Add an empty default array for components that are not found
+          rawComponentArray = vtkSmartPointer<vtkStringArray>::New();
+          rawComponentArray->SetNumberOfComponents(1);
+          rawComponentArray->SetNumberOfTuples(numberOfTuples);
+          }
 
-      // Single-component array for a potentially multi-component column
-      vtkSmartPointer<vtkDataArray> typedComponentArray = vtkSmartPointer<vtkDataArray>::Take(vtkDataArray::CreateDataArray(valueTypeId));
-      typedComponentArray->SetName(rawComponentArray->GetName());
-      typedComponentArray->SetNumberOfComponents(1);
-      typedComponentArray->SetNumberOfTuples(numberOfTuples);
+        typedComponentArray = vtkSmartPointer<vtkDataArray>::Take(vtkDataArray::CreateDataArray(valueTypeId));
+        typedComponentArray->SetName(rawComponentArray->GetName());
+        typedComponentArray->SetNumberOfComponents(1);
+        typedComponentArray->SetNumberOfTuples(numberOfTuples);
 
-      /// Fill the component array with the correct values of the correct type
-      this->FillDataFromStringArray(rawComponentArray, typedComponentArray, nullValueString);
+        /// Fill the component array with the correct values of the correct type
+        this->FillDataFromStringArray(rawComponentArray, typedComponentArray, nullValueString);
+        }
 
       if (rawComponentArrays.size() > 1)
         {
@@ -562,25 +1104,98 @@ bool vtkMRMLTableStorageNode::ReadSchema(std::string filename, vtkMRMLTableNode*
 }
 
 //----------------------------------------------------------------------------
-bool vtkMRMLTableStorageNode::ReadTable(std::string filename, vtkMRMLTableNode* tableNode)
+vtkSmartPointer<vtkTable> vtkMRMLTableStorageNode::ReadRawTable(const std::string& filename, vtkMRMLTableNode* tableNode)
 {
-  vtkNew<vtkDelimitedTextReader> reader;
-  reader->SetFileName(filename.c_str());
-  reader->SetHaveHeaders(true);
-  reader->SetFieldDelimiterCharacters(this->GetFieldDelimiterCharacters(filename).c_str());
-  // Make sure string delimiter characters are removed (somebody may have written a tsv with string delimiters)
-  reader->SetUseStringDelimiter(true);
-  // File contents is preserved better if we don't try to detect numeric columns
-  reader->DetectNumericColumnsOff();
+  std::string delimiter = this->GetFieldDelimiterCharacters(filename);
+  if (delimiter.empty())
+    {
+    return nullptr;
+    }
+  DelimitedTextParser parser;
+  parser.Delimiter = delimiter[0];
+  if (!parser.ReadRows(filename, this->MaximumNumberOfRows))
+    {
+    vtkErrorMacro("vtkMRMLTableStorageNode::ReadRawTable: failed to read table file: " << filename);
+    return nullptr;
+    }
+  vtkSmartPointer<vtkTable> rawTable = vtkSmartPointer<vtkTable>::New();
+  if (!parser.ReadHeader())
+    {
+    // empty file
+    return rawTable;
+    }
+  if (parser.Truncated)
+    {
+    this->TruncatedFileName = filename;
+    }
 
-  // Read table
-  vtkTable* rawTable = nullptr;
-  try
+  // Column types and null values defined in the schema, for each column of the file
+  // (components of multi-component columns are stored in separate columns).
+  std::map<std::string, std::pair<int, std::string> > schemaColumnTypes;
+  vtkTable* schema = tableNode->GetSchema();
+  vtkStringArray* schemaColumnNameArray = (schema ? vtkStringArray::SafeDownCast(schema->GetColumnByName("columnName")) : nullptr);
+  vtkStringArray* schemaComponentNamesArray = (schema ? vtkStringArray::SafeDownCast(schema->GetColumnByName("componentNames")) : nullptr);
+  for (vtkIdType schemaRowIndex = 0; schemaColumnNameArray && schemaRowIndex < schemaColumnNameArray->GetNumberOfValues(); ++schemaRowIndex)
     {
-    reader->Update();
-    rawTable = reader->GetOutput();
+    std::string columnName = schemaColumnNameArray->GetValue(schemaRowIndex);
+    std::pair<int, std::string> columnType(tableNode->GetColumnValueTypeFromSchema(columnName),
+      tableNode->GetColumnProperty(columnName, "nullValue"));
+    std::string componentNamesStr = (schemaComponentNamesArray ? schemaComponentNamesArray->GetValue(schemaRowIndex) : "");
+    if (componentNamesStr.empty())
+      {
+      schemaColumnTypes[columnName] = columnType;
+      continue;
+      }
+    std::stringstream ss(componentNamesStr);
+    std::string componentName;
+    while (std::getline(ss, componentName, '|'))
+      {
+      schemaColumnTypes[columnName + COMPONENT_SEPERATOR + componentName] = columnType;
+      }
     }
-  catch (...)
+
+  for (DelimitedTextParser::Column& column : parser.Columns)
+    {
+    std::map<std::string, std::pair<int, std::string> >::iterator schemaColumnIt = schemaColumnTypes.find(column.Name);
+    int valueTypeId = VTK_VOID;
+    if (schemaColumnIt != schemaColumnTypes.end())
+      {
+      valueTypeId = schemaColumnIt->second.first;
+      if (!schemaColumnIt->second.second.empty())
+        {
+        column.NullValue = vtkVariant(schemaColumnIt->second.second).ToDouble();
+        }
+      }
+    else
+      {
+      valueTypeId = tableNode->GetColumnValueTypeFromSchema(column.Name);
+      }
+    if (valueTypeId == VTK_VOID)
+      {
+      column.DetectType = this->AutoDetectColumnTypes;
+      }
+    else if (valueTypeId != VTK_STRING && valueTypeId != VTK_BIT && vtkDataArray::GetDataTypeSize(valueTypeId) > 0)
+      {
+      // bit columns are converted from strings later
+      column.DataType = valueTypeId;
+      }
+    }
+  parser.DetectColumnTypes();
+  parser.Parse(this->NumberOfReadThreads);
+
+  for (DelimitedTextParser::Column& column : parser.Columns)
+    {
+    rawTable->AddColumn(column.Array);
+    }
+  return rawTable;
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLTableStorageNode::ReadTable(std::string filename, vtkMRMLTableNode* tableNode)
+{
+  this->TruncatedFileName.clear();
+  vtkSmartPointer<vtkTable> rawTable = this->ReadRawTable(filename, tableNode);
+  if (rawTable == nullptr)
     {
     vtkErrorMacro("vtkMRMLTableStorageNode::ReadTable: failed to read table file: " << filename);
     return false;
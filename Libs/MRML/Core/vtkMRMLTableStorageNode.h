@@ -25,6 +25,9 @@
 
 #include "vtkMRMLStorageNode.h"
 
+// VTK includes
+#include <vtkSmartPointer.h>
+
 class vtkMRMLTableNode;
 class vtkTable;
 
@@ -41,6 +44,10 @@ class vtkTable;
 /// Values in comma-separated files may not contain quotation marks but may contain
 /// any other characters (including commas and tabs).
 ///
+/// Tables are parsed in a single pass, directly into arrays of the column types
+/// defined in the schema, and rows are parsed on multiple threads.
+/// Column types of tables without schema can be detected from the values.
+///
 class VTK_MRML_EXPORT vtkMRMLTableStorageNode : public vtkMRMLStorageNode
 {
 public:
@@ -69,6 +76,24 @@ public:
   vtkGetMacro(AutoFindSchema, bool);
   vtkBooleanMacro(AutoFindSchema, bool);
 
+  /// If enabled then the type of columns that are not defined in the schema
+  /// is detected from the values (integer, floating-point, or string).
+  /// Disabled by default, which reads these columns as strings, preserving
+  /// the file content (such as leading zeros).
+  vtkSetMacro(AutoDetectColumnTypes, bool);
+  vtkGetMacro(AutoDetectColumnTypes, bool);
+  vtkBooleanMacro(AutoDetectColumnTypes, bool);
+
+  /// Maximum number of rows to read, for previewing large tables.
+  /// Negative value (default) reads all the rows.
+  /// A table that is read partially cannot be written to the file it was read from.
+  vtkSetMacro(MaximumNumberOfRows, vtkIdType);
+  vtkGetMacro(MaximumNumberOfRows, vtkIdType);
+
+  /// Number of threads used for parsing the rows. Default is the number of cores.
+  vtkSetClampMacro(NumberOfReadThreads, int, 1, 64);
+  vtkGetMacro(NumberOfReadThreads, int);
+
 protected:
   vtkMRMLTableStorageNode();
   ~vtkMRMLTableStorageNode() override;
@@ -107,6 +132,11 @@ protected:
   /// and the names of the components.
   std::vector<ColumnInfo> GetColumnInfo(vtkMRMLTableNode* tableNode, vtkTable* rawTable);
 
+  /// Parses the delimited text file into a table that has a column for each column of the file.
+  /// Columns that have a numeric type in the schema of the table node (or a detected numeric
+  /// type) are stored in arrays of that type, all other columns in string arrays.
+  vtkSmartPointer<vtkTable> ReadRawTable(const std::string& filename, vtkMRMLTableNode* tableNode);
+
   /// Casts the data in the string array to the correct type and stores it in the data array
   void FillDataFromStringArray(vtkStringArray* stringComponentArray, vtkDataArray* dataArray, std::string nullValueString="");
 
@@ -121,6 +151,12 @@ protected:
   bool WriteSchema(std::string filename, vtkMRMLTableNode* tableNode);
 
   bool AutoFindSchema;
+  bool AutoDetectColumnTypes;
+  vtkIdType MaximumNumberOfRows;
+  int NumberOfReadThreads;
+
+  /// Full path of the last file that was read partially because of MaximumNumberOfRows
+  std::string TruncatedFileName;
 };
 
 #endif
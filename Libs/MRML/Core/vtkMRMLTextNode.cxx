@@ -23,6 +23,9 @@
 #include "vtkObjectFactory.h"
 #include "vtkXMLUtilities.h"
 
+// STD includes
+#include <algorithm>
+
 const int MAX_STRING_LENGTH_FOR_SAVE_WITHOUT_STORAGE_NODE = 256;
 
 //----------------------------------------------------------------------------
@@ -56,6 +59,43 @@ void vtkMRMLTextNode::SetText(const std::string &text, int encoding/*-1*/)
     return;
     }
   this->Text = text;
+  this->TextModified();
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLTextNode::AppendText(const std::string &text)
+{
+  if (text.empty())
+    {
+    return;
+    }
+  MRMLNodeModifyBlocker blocker(this);
+  this->Text.append(text);
+  this->TextModified();
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLTextNode::ReplaceText(size_t position, size_t length, const std::string &text)
+{
+  if (position >= this->Text.size())
+    {
+    this->AppendText(text);
+    return;
+    }
+  length = std::min(length, this->Text.size() - position);
+  if (this->Text.compare(position, length, text) == 0)
+    {
+    // no change
+    return;
+    }
+  MRMLNodeModifyBlocker blocker(this);
+  this->Text.replace(position, length, text);
+  this->TextModified();
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLTextNode::TextModified()
+{
   // this indicates that the text (that is stored in a separate file) is modified
   // and therefore the object will be marked as changed for file saving
   this->StorableModifiedTime.Modified();
@@ -184,6 +224,12 @@ std::string vtkMRMLTextNode::GetDefaultStorageNodeClassName(const char* vtkNotUs
   return "vtkMRMLTextStorageNode";
 }
 
+//---------------------------------------------------------------------------
+unsigned long vtkMRMLTextNode::GetContentMemorySize()
+{
+  return this->Superclass::GetContentMemorySize() + static_cast<unsigned long>(this->Text.size() / 1024);
+}
+
 //---------------------------------------------------------------------------
 vtkMRMLStorageNode* vtkMRMLTextNode::CreateDefaultStorageNode()
 {
@@ -55,7 +55,21 @@ public:
   /// If the encoding is not specified, then it will not be changed from the current value.
   /// \sa SetEncoding()
   void SetText(const std::string &text, int encoding=-1);
-  vtkGetMacro(Text, std::string);
+  /// Get text node contents.
+  /// The returned reference is valid until the text is modified, it can be used
+  /// for reading large texts without copying them.
+  const std::string& GetText() const { return this->Text; }
+
+  /// Append text at the end of the current text, without copying the current text.
+  /// TextModifiedEvent and Modified event are invoked if text is not empty.
+  void AppendText(const std::string &text);
+
+  /// Replace the specified range of the current text by the new text, without
+  /// copying the rest of the current text. If position is past the end of the text then
+  /// the new text is appended. The length is clamped to the end of the text.
+  /// TextModifiedEvent and Modified event are invoked if the text is changed.
+  /// \sa AppendText()
+  void ReplaceText(size_t position, size_t length, const std::string &text);
 
   ///
   /// Set encoding of the text
@@ -83,6 +97,9 @@ public:
   /// provided file name and node content.
   std::string GetDefaultStorageNodeClassName(const char* filename=nullptr) override;
 
+  /// Approximate size of the text in kibibytes.
+  unsigned long GetContentMemorySize() override;
+
   enum
   {
     TextModifiedEvent = 51000, // Invoked if the text OR encoding is changed with SetText() and SetEncoding() methods and is not invoked
@@ -95,6 +112,9 @@ protected:
   vtkMRMLTextNode(const vtkMRMLTextNode&);
   void operator=(const vtkMRMLTextNode&);
 
+  /// Mark the text as changed for file saving and invoke the modified events.
+  void TextModified();
+
   std::string Text;
   int Encoding{VTK_ENCODING_US_ASCII};
   int ForceCreateStorageNode{CreateStorageNodeAuto};
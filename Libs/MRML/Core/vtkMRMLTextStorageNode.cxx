@@ -20,6 +20,7 @@
 
 // STD includes
 #include <algorithm>
+#include <functional>
 #include <sstream>
 
 #include "vtkMRMLMessageCollection.h"
@@ -94,8 +95,10 @@ int vtkMRMLTextStorageNode::ReadDataInternal(vtkMRMLNode * refNode)
 
   std::stringstream ss;
   ss << inputFile.rdbuf();
+  inputFile.close();
   std::string inputString = ss.str();
-  textNode->SetText(inputString.c_str());
+  textNode->SetText(inputString);
+  this->SetStoredFileState(fullName, inputString);
 
   // success
   return 1;
@@ -130,6 +133,14 @@ int vtkMRMLTextStorageNode::WriteDataInternal(vtkMRMLNode * refNode)
     return 0;
     }
 
+  const std::string& text = textNode->GetText();
+  if (this->IsStoredFileUpToDate(fullName, text))
+    {
+    vtkDebugMacro("WriteData: text is not changed since file " << fullName << " was last read or written");
+    this->StageWriteData(refNode);
+    return true;
+    }
+
   // check if the file exists
   if (vtksys::SystemTools::FileExists(fullName.c_str()))
     {
@@ -141,11 +152,46 @@ int vtkMRMLTextStorageNode::WriteDataInternal(vtkMRMLNode * refNode)
 
   std::ofstream file;
   file.open(fullName);
-  file << textNode->GetText();
+  file << text;
+  file.close();
+  if (file.fail())
+    {
+    vtkErrorMacro("WriteData: Could not write file " << fullName);
+    this->StoredFileName.clear();
+    return 0;
+    }
+  this->SetStoredFileState(fullName, text);
   this->StageWriteData(refNode);
   return true;
 }
 
+//----------------------------------------------------------------------------
+void vtkMRMLTextStorageNode::SetStoredFileState(const std::string& fullName, const std::string& text)
+{
+  this->StoredFileName = fullName;
+  this->StoredTextHash = std::hash<std::string>()(text);
+  this->StoredTextLength = text.size();
+  this->StoredFileModifiedTime = vtksys::SystemTools::ModifiedTime(fullName);
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLTextStorageNode::IsStoredFileUpToDate(const std::string& fullName, const std::string& text)
+{
+  if (this->StoredFileName.empty() || this->StoredFileName != fullName)
+    {
+    return false;
+    }
+  if (!vtksys::SystemTools::FileExists(fullName)
+    || vtksys::SystemTools::ModifiedTime(fullName) != this->StoredFileModifiedTime)
+    {
+    // file has been changed or removed since it was last read or written
+    return false;
+    }
+  // compare length first to avoid computing the hash of texts that are obviously different
+  return text.size() == this->StoredTextLength
+    && std::hash<std::string>()(text) == this->StoredTextHash;
+}
+
 //----------------------------------------------------------------------------
 void vtkMRMLTextStorageNode::InitializeSupportedReadFileTypes()
 {
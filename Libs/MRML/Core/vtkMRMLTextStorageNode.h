@@ -42,6 +42,9 @@ public:
 
   /// Return true if the node can be written by using thie writer.
   bool CanWriteFromReferenceNode(vtkMRMLNode* refNode) override;
+  /// Write the text into the file.
+  /// The file is not written again if it was last read or written by this storage node,
+  /// it has not been changed since then, and the text is the same (has the same hash).
   int WriteDataInternal(vtkMRMLNode* refNode) override;
 
   /// Return a default file extension for writting
@@ -64,6 +67,16 @@ protected:
 
   /// Initialize all the supported write file types
   void InitializeSupportedWriteFileTypes() override;
+
+  /// Remember the file that was last read or written and the hash of its content,
+  /// to avoid writing the same text again.
+  void SetStoredFileState(const std::string& fullName, const std::string& text);
+  bool IsStoredFileUpToDate(const std::string& fullName, const std::string& text);
+
+  std::string StoredFileName;
+  size_t StoredTextHash{0};
+  size_t StoredTextLength{0};
+  long StoredFileModifiedTime{0};
 };
 
 #endif
@@ -0,0 +1,290 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2005 Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Program:   3D Slicer
+
+=========================================================================auto=*/
+
+// MRML includes
+#include "vtkMRMLTrace.h"
+
+// VTK includes
+#include <vtkObjectFactory.h>
+
+// VTKsys includes
+#include <vtksys/SystemTools.hxx>
+
+// STD includes
+#include <chrono>
+#include <functional>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+//----------------------------------------------------------------------------
+// The trace singleton.
+// This MUST be default initialized to zero by the compiler and is
+// therefore not initialized here. The ClassInitialize and
+// ClassFinalize methods handle this instance.
+static vtkMRMLTrace* vtkMRMLTraceInstance;
+
+//----------------------------------------------------------------------------
+// Must NOT be initialized. Default initialization to zero is necessary.
+unsigned int vtkMRMLTraceInitialize::Count;
+
+//----------------------------------------------------------------------------
+std::atomic<bool> vtkMRMLTrace::EnabledFlag(false);
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+std::chrono::steady_clock::time_point GetTraceStartTime()
+{
+  static const std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+  return startTime;
+}
+
+//----------------------------------------------------------------------------
+void WriteJSONString(std::ostream& os, const std::string& str)
+{
+  os << '"';
+  for (std::string::const_iterator it = str.begin(); it != str.end(); ++it)
+    {
+    switch (*it)
+      {
+      case '"': os << "\\\""; break;
+      case '\\': os << "\\\\"; break;
+      case '\n': os << "\\n"; break;
+      case '\r': os << "\\r"; break;
+      case '\t': os << "\\t"; break;
+      default:
+        if (static_cast<unsigned char>(*it) < 0x20)
+          {
+          os << ' ';
+          }
+        else
+          {
+          os << *it;
+          }
+      }
+    }
+  os << '"';
+}
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+// Implementation of vtkMRMLTraceInitialize class.
+//----------------------------------------------------------------------------
+vtkMRMLTraceInitialize::vtkMRMLTraceInitialize()
+{
+  if (++Self::Count == 1)
+    {
+    vtkMRMLTrace::classInitialize();
+    }
+}
+
+//----------------------------------------------------------------------------
+vtkMRMLTraceInitialize::~vtkMRMLTraceInitialize()
+{
+  if (--Self::Count == 0)
+    {
+    vtkMRMLTrace::classFinalize();
+    }
+}
+
+//----------------------------------------------------------------------------
+// Up the reference count so it behaves like New
+vtkMRMLTrace* vtkMRMLTrace::New()
+{
+  vtkMRMLTrace* ret = vtkMRMLTrace::GetInstance();
+  ret->Register(nullptr);
+  return ret;
+}
+
+//----------------------------------------------------------------------------
+// Return the single instance of the vtkMRMLTrace
+vtkMRMLTrace* vtkMRMLTrace::GetInstance()
+{
+  if (!vtkMRMLTraceInstance)
+    {
+    // Try the factory first
+    vtkMRMLTraceInstance = (vtkMRMLTrace*)vtkObjectFactory::CreateInstance("vtkMRMLTrace");
+    // if the factory did not provide one, then create it here
+    if (!vtkMRMLTraceInstance)
+      {
+      vtkMRMLTraceInstance = new vtkMRMLTrace;
+#ifdef VTK_HAS_INITIALIZE_OBJECT_BASE
+      vtkMRMLTraceInstance->InitializeObjectBase();
+#endif
+      }
+    }
+  // return the instance
+  return vtkMRMLTraceInstance;
+}
+
+//----------------------------------------------------------------------------
+vtkMRMLTrace::vtkMRMLTrace()
+{
+  this->MaximumNumberOfEvents = 1000000;
+  // Initialize the time base
+  GetTraceStartTime();
+  std::string traceEnv;
+  if (vtksys::SystemTools::GetEnv("MRML_TRACE", traceEnv) && traceEnv == "1")
+    {
+    vtkMRMLTrace::EnabledFlag = true;
+    }
+}
+
+//----------------------------------------------------------------------------
+vtkMRMLTrace::~vtkMRMLTrace() = default;
+
+//----------------------------------------------------------------------------
+void vtkMRMLTrace::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "Enabled: " << this->GetEnabled() << "\n";
+  os << indent << "MaximumNumberOfEvents: " << this->MaximumNumberOfEvents << "\n";
+  os << indent << "NumberOfEvents: " << this->GetNumberOfEvents() << "\n";
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLTrace::SetEnabled(bool enabled)
+{
+  if (vtkMRMLTrace::EnabledFlag == enabled)
+    {
+    return;
+    }
+  vtkMRMLTrace::EnabledFlag = enabled;
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLTrace::GetEnabled()
+{
+  return vtkMRMLTrace::EnabledFlag;
+}
+
+//----------------------------------------------------------------------------
+int vtkMRMLTrace::GetNumberOfEvents()
+{
+  std::lock_guard<std::mutex> lock(this->EventsMutex);
+  return static_cast<int>(this->Events.size());
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLTrace::Clear()
+{
+  std::lock_guard<std::mutex> lock(this->EventsMutex);
+  this->Events.clear();
+}
+
+//----------------------------------------------------------------------------
+double vtkMRMLTrace::GetTime()
+{
+  return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - GetTraceStartTime()).count();
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLTrace::AddEvent(const char* category, const char* name, const char* detail,
+  double startTime, double endTime)
+{
+  if (!vtkMRMLTrace::IsEnabled())
+    {
+    return;
+    }
+  TraceEvent event;
+  event.Category = (category ? category : "");
+  event.Name = (name ? name : "");
+  event.Detail = (detail ? detail : "");
+  event.StartTime = startTime;
+  event.Duration = endTime - startTime;
+  event.ThreadID = std::hash<std::thread::id>()(std::this_thread::get_id());
+  std::lock_guard<std::mutex> lock(this->EventsMutex);
+  if (static_cast<int>(this->Events.size()) >= this->MaximumNumberOfEvents)
+    {
+    return;
+    }
+  this->Events.push_back(event);
+}
+
+//----------------------------------------------------------------------------
+std::string vtkMRMLTrace::GetChromeTraceAsString()
+{
+  std::stringstream ss;
+  ss.precision(3);
+  ss << std::fixed;
+  ss << "{\"traceEvents\":[";
+  std::lock_guard<std::mutex> lock(this->EventsMutex);
+  // thread IDs are hashed, map them to small numbers for readability
+  std::vector<size_t> threadIDs;
+  for (std::vector<TraceEvent>::const_iterator it = this->Events.begin(); it != this->Events.end(); ++it)
+    {
+    size_t threadIndex = 0;
+    for (; threadIndex < threadIDs.size(); ++threadIndex)
+      {
+      if (threadIDs[threadIndex] == it->ThreadID)
+        {
+        break;
+        }
+      }
+    if (threadIndex == threadIDs.size())
+      {
+      threadIDs.push_back(it->ThreadID);
+      }
+    ss << (it == this->Events.begin() ? "\n" : ",\n");
+    ss << "{\"name\":";
+    WriteJSONString(ss, it->Name);
+    ss << ",\"cat\":";
+    WriteJSONString(ss, it->Category);
+    ss << ",\"ph\":\"X\",\"ts\":" << it->StartTime << ",\"dur\":" << it->Duration
+       << ",\"pid\":1,\"tid\":" << threadIndex + 1;
+    if (!it->Detail.empty())
+      {
+      ss << ",\"args\":{\"detail\":";
+      WriteJSONString(ss, it->Detail);
+      ss << "}";
+      }
+    ss << "}";
+    }
+  ss << "\n],\"displayTimeUnit\":\"ms\"}\n";
+  return ss.str();
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLTrace::WriteChromeTrace(const char* fileName)
+{
+  if (!fileName)
+    {
+    vtkErrorMacro("vtkMRMLTrace::WriteChromeTrace failed: invalid file name");
+    return false;
+    }
+  std::ofstream file(fileName);
+  file << this->GetChromeTraceAsString();
+  file.close();
+  if (file.fail())
+    {
+    vtkErrorMacro("vtkMRMLTrace::WriteChromeTrace failed: cannot write file " << fileName);
+    return false;
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLTrace::classInitialize()
+{
+  // Allocate the singleton
+  vtkMRMLTraceInstance = vtkMRMLTrace::GetInstance();
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLTrace::classFinalize()
+{
+  vtkMRMLTraceInstance->Delete();
+  vtkMRMLTraceInstance = nullptr;
+}
@@ -0,0 +1,191 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2005 Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Program:   3D Slicer
+
+=========================================================================auto=*/
+
+#ifndef __vtkMRMLTrace_h
+#define __vtkMRMLTrace_h
+
+// MRML includes
+#include "vtkMRML.h"
+
+// VTK includes
+#include <vtkObject.h>
+
+// STD includes
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/// \brief Record the time spent in instrumented code sections.
+///
+/// Code sections are instrumented by vtkMRMLTraceScopeMacro (for the duration of a scope)
+/// or by calling AddEvent. Recorded events can be written into a file in the Chrome trace
+/// event format (JSON), which can be opened in chrome://tracing or in the Perfetto UI
+/// (https://ui.perfetto.dev) to see where the time of an interaction goes.
+///
+/// Tracing is disabled by default at runtime, it can be enabled by SetEnabled(true) or
+/// by setting the MRML_TRACE environment variable to 1 before the application starts.
+/// While disabled, the cost of an instrumented section is the check of an atomic flag.
+/// Instrumentation can be removed from the build by turning off MRML_USE_TRACING.
+///
+/// Typical use:
+/// \code
+/// vtkMRMLTrace::GetInstance()->SetEnabled(true);
+/// // ... interact with the application
+/// vtkMRMLTrace::GetInstance()->WriteChromeTrace("/tmp/trace.json");
+/// \endcode
+/// \sa vtkMRMLTraceScope
+class VTK_MRML_EXPORT vtkMRMLTrace : public vtkObject
+{
+public:
+  vtkTypeMacro(vtkMRMLTrace, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  /// Return the singleton instance with no reference counting.
+  static vtkMRMLTrace* GetInstance();
+
+  /// This is a singleton pattern New. There will only be ONE
+  /// reference to a vtkMRMLTrace object per process. Clients that
+  /// call this must call Delete on the object so that the reference
+  /// counting will work. The single instance will be unreferenced when
+  /// the program exits.
+  static vtkMRMLTrace* New();
+
+  /// Enable/disable recording of events. Disabled by default.
+  void SetEnabled(bool enabled);
+  bool GetEnabled();
+  void EnabledOn() { this->SetEnabled(true); }
+  void EnabledOff() { this->SetEnabled(false); }
+
+  /// Maximum number of recorded events. Events are not recorded
+  /// when the maximum is reached, to limit memory usage. Default is 1000000.
+  vtkSetMacro(MaximumNumberOfEvents, int);
+  vtkGetMacro(MaximumNumberOfEvents, int);
+
+  /// Number of recorded events.
+  int GetNumberOfEvents();
+
+  /// Remove all recorded events.
+  void Clear();
+
+  /// Current time in microseconds, in the time base of the recorded events.
+  static double GetTime();
+
+  /// Record an event that started at startTime and ended at endTime (as returned by GetTime).
+  /// Category is used for filtering events in the trace viewers (e.g., "MRML", "Logic", "Rendering").
+  /// Detail is displayed as argument of the event (e.g., class name of the observer).
+  void AddEvent(const char* category, const char* name, const char* detail,
+    double startTime, double endTime);
+
+  /// Write recorded events in Chrome trace event format (JSON).
+  /// Returns false if the file cannot be written.
+  bool WriteChromeTrace(const char* fileName);
+
+  /// Get recorded events in Chrome trace event format (JSON).
+  std::string GetChromeTraceAsString();
+
+#ifndef __VTK_WRAP__
+  /// Fast check of the enabled state, for instrumented code sections.
+  static bool IsEnabled() { return vtkMRMLTrace::EnabledFlag.load(std::memory_order_relaxed); }
+#endif
+
+protected:
+  vtkMRMLTrace();
+  ~vtkMRMLTrace() override;
+  vtkMRMLTrace(const vtkMRMLTrace&);
+  void operator=(const vtkMRMLTrace&);
+
+  friend class vtkMRMLTraceInitialize;
+  typedef vtkMRMLTrace Self;
+
+  /// Singleton management functions.
+  static void classInitialize();
+  static void classFinalize();
+
+  struct TraceEvent
+    {
+    std::string Category;
+    std::string Name;
+    std::string Detail;
+    double StartTime;
+    double Duration;
+    size_t ThreadID;
+    };
+
+  static std::atomic<bool> EnabledFlag;
+
+  int MaximumNumberOfEvents;
+  std::vector<TraceEvent> Events;
+  std::mutex EventsMutex;
+};
+
+/// Utility class to make sure vtkMRMLTrace is initialized before it is used.
+class VTK_MRML_EXPORT vtkMRMLTraceInitialize
+{
+public:
+  typedef vtkMRMLTraceInitialize Self;
+
+  vtkMRMLTraceInitialize();
+  ~vtkMRMLTraceInitialize();
+private:
+  static unsigned int Count;
+};
+
+/// This instance will show up in any translation unit that uses
+/// vtkMRMLTrace. It will make sure vtkMRMLTrace is initialized
+/// before it is used.
+static vtkMRMLTraceInitialize vtkMRMLTraceInitializer;
+
+#ifndef __VTK_WRAP__
+/// \brief Record the time spent in the current scope as a trace event.
+///
+/// Name and category must be string literals (or outlive the scope), detail is
+/// only copied when the event is recorded.
+/// \sa vtkMRMLTraceScopeMacro
+class vtkMRMLTraceScope
+{
+public:
+  vtkMRMLTraceScope(const char* category, const char* name, const char* detail = nullptr)
+    : Category(category), Name(name), Detail(detail), StartTime(-1.0)
+    {
+    if (vtkMRMLTrace::IsEnabled())
+      {
+      this->StartTime = vtkMRMLTrace::GetTime();
+      }
+    }
+  ~vtkMRMLTraceScope()
+    {
+    if (this->StartTime >= 0.0)
+      {
+      vtkMRMLTrace::GetInstance()->AddEvent(this->Category, this->Name, this->Detail,
+        this->StartTime, vtkMRMLTrace::GetTime());
+      }
+    }
+private:
+  vtkMRMLTraceScope(const vtkMRMLTraceScope&) = delete;
+  void operator=(const vtkMRMLTraceScope&) = delete;
+  const char* Category;
+  const char* Name;
+  const char* Detail;
+  double StartTime;
+};
+
+/// Record the time spent in the current scope, if MRML_USE_TRACING is enabled.
+/// Example: vtkMRMLTraceScopeMacro("Logic", "vtkMRMLSliceLogic::UpdatePipeline", this->GetName());
+#ifdef MRML_USE_TRACING
+# define vtkMRMLTraceScopeMacro(category, name, detail) \
+  vtkMRMLTraceScope vtkMRMLTraceScopeInstance(category, name, detail)
+#else
+# define vtkMRMLTraceScopeMacro(category, name, detail)
+#endif
+#endif // __VTK_WRAP__
+
+#endif
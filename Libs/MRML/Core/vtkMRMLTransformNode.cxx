@@ -34,14 +34,17 @@ Version:   $Revision: 1.14 $
 #include <vtkImageData.h>
 #include <vtkLinearTransform.h>
 #include <vtkHomogeneousTransform.h>
+#include <vtkMath.h>
 #include <vtkNew.h>
 #include <vtkObjectFactory.h>
 #include <vtkPoints.h>
+#include <vtkSMPTools.h>
 #include <vtkThinPlateSplineTransform.h>
 #include <vtkTransform.h>
 #include <vtksys/SystemTools.hxx>
 
 // STD includes
+#include <algorithm>
 #include <sstream>
 #include <stack>
 
@@ -57,6 +60,8 @@ vtkMRMLTransformNode::vtkMRMLTransformNode()
 
   this->CachedMatrixTransformToParent=vtkMatrix4x4::New();
   this->CachedMatrixTransformFromParent=vtkMatrix4x4::New();
+  this->CachedMatrixTransformToWorld = vtkSmartPointer<vtkMatrix4x4>::New();
+  this->TransformModifiedTime.Modified();
 
   this->ContentModifiedEvents->InsertNextValue(vtkMRMLTransformableNode::TransformModifiedEvent);
 }
@@ -525,7 +530,23 @@ void vtkMRMLTransformNode::GetTransformBetweenNodes(vtkMRMLTransformNode* source
     return;
     }
 
-  if (sourceNode != nullptr && sourceNode->IsTransformNodeMyParent(targetNode))
+  if (targetNode == nullptr || sourceNode == nullptr)
+    {
+    // transform to or from world is available from the cache
+    vtkMRMLTransformNode* node = (targetNode == nullptr ? sourceNode : targetNode);
+    node->UpdateCachedTransformToWorld();
+    for (vtkAbstractTransform* transformToParent : node->CachedTransformsToWorld)
+      {
+      transformSourceToTarget->Concatenate(transformToParent);
+      }
+    if (sourceNode == nullptr)
+      {
+      transformSourceToTarget->Inverse();
+      }
+    return;
+    }
+
+  if (sourceNode->IsTransformNodeMyParent(targetNode))
     {
     // traverse the transform tree from bottom to top, from sourceNode to targetNode
     for (vtkMRMLTransformNode* current = sourceNode; current != targetNode; current = current->GetParentTransformNode())
@@ -566,6 +587,90 @@ void vtkMRMLTransformNode::GetTransformBetweenNodes(vtkMRMLTransformNode* source
     }
 }
 
+//----------------------------------------------------------------------------
+void vtkMRMLTransformNode::TransformPoints(vtkAbstractTransform* transform, vtkPoints* inputPoints, vtkPoints* outputPoints,
+  vtkDataArray* inputNormals/*=nullptr*/, vtkDataArray* outputNormals/*=nullptr*/)
+{
+  vtkMRMLTransformNode::TransformPoints(transform, inputPoints, outputPoints, inputNormals, outputNormals,
+    std::function<bool(double)>());
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLTransformNode::TransformPoints(vtkAbstractTransform* transform, vtkPoints* inputPoints, vtkPoints* outputPoints,
+  vtkDataArray* inputNormals, vtkDataArray* outputNormals, const std::function<bool(double)>& progressCallback)
+{
+  if (!transform || !inputPoints || !outputPoints)
+    {
+    vtkGenericWarningMacro("vtkMRMLTransformNode::TransformPoints failed: invalid transform or points");
+    return false;
+    }
+  vtkIdType numberOfPoints = inputPoints->GetNumberOfPoints();
+  bool transformNormals = (inputNormals && outputNormals);
+  if (transformNormals && (inputNormals->GetNumberOfComponents() != 3 || inputNormals->GetNumberOfTuples() != numberOfPoints))
+    {
+    vtkGenericWarningMacro("vtkMRMLTransformNode::TransformPoints: normals are not transformed, number of normals does not match number of points");
+    transformNormals = false;
+    }
+  if (outputPoints != inputPoints)
+    {
+    outputPoints->SetNumberOfPoints(numberOfPoints);
+    }
+  if (transformNormals && outputNormals != inputNormals)
+    {
+    outputNormals->SetNumberOfComponents(3);
+    outputNormals->SetNumberOfTuples(numberOfPoints);
+    }
+
+  // InternalTransformPoint does not update the transform, which makes it safe to use from multiple threads
+  transform->Update();
+  auto transformPointRange = [&](vtkIdType beginPointId, vtkIdType endPointId)
+    {
+    double point[3] = { 0.0, 0.0, 0.0 };
+    double transformedPoint[3] = { 0.0, 0.0, 0.0 };
+    double derivative[3][3];
+    double normal[3] = { 0.0, 0.0, 0.0 };
+    for (vtkIdType pointId = beginPointId; pointId < endPointId; ++pointId)
+      {
+      inputPoints->GetPoint(pointId, point);
+      if (transformNormals)
+        {
+        // Normals are transformed by the inverse transpose of the Jacobian (as in vtkAbstractTransform)
+        transform->InternalTransformDerivative(point, transformedPoint, derivative);
+        inputNormals->GetTuple(pointId, normal);
+        vtkMath::Transpose3x3(derivative, derivative);
+        vtkMath::LinearSolve3x3(derivative, normal, normal);
+        vtkMath::Normalize(normal);
+        outputNormals->SetTuple(pointId, normal);
+        }
+      else
+        {
+        transform->InternalTransformPoint(point, transformedPoint);
+        }
+      outputPoints->SetPoint(pointId, transformedPoint);
+      }
+    };
+
+  // Without progress reporting all points are processed at once, otherwise in about 100 blocks
+  const vtkIdType blockSize = progressCallback ? std::max<vtkIdType>(numberOfPoints / 100, 10000) : numberOfPoints;
+  bool completed = true;
+  for (vtkIdType beginPointId = 0; beginPointId < numberOfPoints; beginPointId += blockSize)
+    {
+    vtkIdType endPointId = std::min(beginPointId + blockSize, numberOfPoints);
+    vtkSMPTools::For(beginPointId, endPointId, transformPointRange);
+    if (progressCallback && !progressCallback(static_cast<double>(endPointId) / numberOfPoints))
+      {
+      completed = false;
+      break;
+      }
+    }
+  outputPoints->Modified();
+  if (transformNormals)
+    {
+    outputNormals->Modified();
+    }
+  return completed;
+}
+
 //----------------------------------------------------------------------------
 int vtkMRMLTransformNode::IsTransformNodeMyParent(vtkMRMLTransformNode* node)
 {
@@ -915,7 +1020,29 @@ int  vtkMRMLTransformNode::GetMatrixTransformBetweenNodes(vtkMRMLTransformNode*
     return 1;
     }
 
-  if (sourceNode && sourceNode->IsTransformNodeMyParent(targetNode))
+  if (targetNode == nullptr || sourceNode == nullptr)
+    {
+    // transform to or from world is available from the cache
+    vtkMRMLTransformNode* node = (targetNode == nullptr ? sourceNode : targetNode);
+    node->UpdateCachedTransformToWorld();
+    if (!node->CachedTransformToWorldLinear)
+      {
+      vtkGenericWarningMacro("vtkMRMLTransformNode::GetMatrixTransformBetweenNodes failed: expected linear transforms between nodes");
+      transformSourceToTarget->Identity();
+      return 0;
+      }
+    if (sourceNode == nullptr)
+      {
+      vtkMatrix4x4::Invert(node->CachedMatrixTransformToWorld, transformSourceToTarget);
+      }
+    else
+      {
+      transformSourceToTarget->DeepCopy(node->CachedMatrixTransformToWorld);
+      }
+    return 1;
+    }
+
+  if (sourceNode->IsTransformNodeMyParent(targetNode))
     {
     transformSourceToTarget->Identity();
     // traverse the transform tree from bottom to top, from sourceNode to target
@@ -1213,9 +1340,9 @@ void vtkMRMLTransformNode::InverseName()
 //----------------------------------------------------------------------------
 vtkMTimeType vtkMRMLTransformNode::GetTransformToWorldMTime()
 {
-  vtkMTimeType latestMTime=0;
+  vtkMTimeType latestMTime=this->TransformModifiedTime.GetMTime();
   vtkAbstractTransform* transformToParent=this->GetTransformToParent();
-  if (transformToParent!=nullptr)
+  if (transformToParent!=nullptr && transformToParent->GetMTime()>latestMTime)
     {
     latestMTime=transformToParent->GetMTime();
     }
@@ -1232,6 +1359,50 @@ vtkMTimeType vtkMRMLTransformNode::GetTransformToWorldMTime()
   return latestMTime;
 }
 
+//----------------------------------------------------------------------------
+void vtkMRMLTransformNode::OnTransformNodeReferenceChanged(vtkMRMLTransformNode* transformNode)
+{
+  this->TransformModifiedTime.Modified();
+  Superclass::OnTransformNodeReferenceChanged(transformNode);
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLTransformNode::UpdateCachedTransformToWorld()
+{
+  vtkMTimeType transformToWorldMTime = this->GetTransformToWorldMTime();
+  if (this->CachedTransformToWorldValid && transformToWorldMTime == this->CachedTransformToWorldMTime)
+    {
+    return;
+    }
+
+  this->CachedTransformsToWorld.clear();
+  this->CachedTransformToWorldLinear = true;
+  this->CachedMatrixTransformToWorld->Identity();
+  vtkNew<vtkMatrix4x4> toParentMatrix;
+  for (vtkMRMLTransformNode* current = this; current != nullptr; current = current->GetParentTransformNode())
+    {
+    vtkAbstractTransform* transformToParent = current->GetTransformToParent();
+    if (transformToParent)
+      {
+      this->CachedTransformsToWorld.push_back(transformToParent);
+      }
+    if (this->CachedTransformToWorldLinear)
+      {
+      if (current->IsLinear() && current->GetMatrixTransformToParent(toParentMatrix.GetPointer()))
+        {
+        vtkMatrix4x4::Multiply4x4(toParentMatrix.GetPointer(), this->CachedMatrixTransformToWorld, this->CachedMatrixTransformToWorld);
+        }
+      else
+        {
+        this->CachedTransformToWorldLinear = false;
+        this->CachedMatrixTransformToWorld->Identity();
+        }
+      }
+    }
+  this->CachedTransformToWorldMTime = transformToWorldMTime;
+  this->CachedTransformToWorldValid = true;
+}
+
 //----------------------------------------------------------------------------
 const char* vtkMRMLTransformNode::GetTransformToParentInfo()
 {
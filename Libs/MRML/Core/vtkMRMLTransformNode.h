@@ -17,7 +17,16 @@
 
 #include "vtkMRMLDisplayableNode.h"
 
+// VTK includes
+#include <vtkSmartPointer.h>
+
+// STD includes
+#include <functional>
+#include <vector>
+
 class vtkCollection;
+class vtkDataArray;
+class vtkPoints;
 class vtkAbstractTransform;
 class vtkGeneralTransform;
 class vtkMatrix4x4;
@@ -277,6 +286,7 @@ public:
   /// and then re-enable transform modified events to invoke any pending notifications.
   virtual void TransformModified()
     {
+    this->TransformModifiedTime.Modified();
     this->InvokeCustomModifiedEvent(vtkMRMLTransformableNode::TransformModifiedEvent);
     }
 
@@ -344,6 +354,26 @@ public:
   /// Returns nonzero on success.
   static int DeepCopyTransform(vtkAbstractTransform* dst, vtkAbstractTransform* src);
 
+  ///
+  /// Transform points (and optionally point normals) using multiple threads.
+  /// Non-linear transforms are evaluated point by point (inverse grid and b-spline transforms
+  /// by iterative inversion), therefore transforming many points in parallel is much faster
+  /// than vtkAbstractTransform::TransformPoints.
+  /// Output points and normals may be the same objects as the input.
+  static void TransformPoints(vtkAbstractTransform* transform, vtkPoints* inputPoints, vtkPoints* outputPoints,
+    vtkDataArray* inputNormals = nullptr, vtkDataArray* outputNormals = nullptr);
+
+#ifndef __VTK_WRAP__
+  ///
+  /// Transform points the same way as TransformPoints but in blocks of points.
+  /// After each block, progressCallback is called from the calling thread with the fraction
+  /// of points that are already transformed (0..1). If it returns false then processing stops,
+  /// the method returns false, and output points and normals are incomplete.
+  /// Returns true if all points were transformed.
+  static bool TransformPoints(vtkAbstractTransform* transform, vtkPoints* inputPoints, vtkPoints* outputPoints,
+    vtkDataArray* inputNormals, vtkDataArray* outputNormals, const std::function<bool(double)>& progressCallback);
+#endif
+
   ///
   /// Invert the transform.
   /// Internally it does not perform any actual computation just switches ToParent and FromParent.
@@ -353,7 +383,9 @@ public:
   /// Inversion is implemented by adding/removing " (-)" suffix.
   virtual void InverseName();
 
-  /// Get the latest modification time of the stored transform
+  /// Get the latest modification time of the stored transform.
+  /// Takes into account changes of the transforms of the parent transform nodes
+  /// and changes of the parent transform nodes themselves.
   vtkMTimeType GetTransformToWorldMTime();
 
   /// Get a human-readable description of the transformation
@@ -384,6 +416,13 @@ protected:
   /// Sets and observes a transform and deletes the inverse (so that the inverse will be computed automatically)
   virtual void SetAndObserveTransform(vtkAbstractTransform** originalTransformPtr, vtkAbstractTransform** inverseTransformPtr, vtkAbstractTransform *transform);
 
+  /// Update the modification time when the parent transform node is changed
+  void OnTransformNodeReferenceChanged(vtkMRMLTransformNode* transformNode) override;
+
+  /// Update the cached transform to world if the transform of this node
+  /// or any of its parents has been modified since it was last computed.
+  void UpdateCachedTransformToWorld();
+
   ///
   /// These transforms store the transforms that were set externally.
   /// We use the capability of generic transforms for concatenating and inverting the same
@@ -403,6 +442,19 @@ protected:
   /// GetMatrixTransformToParent and GetMatrixFromParent methods
   vtkMatrix4x4* CachedMatrixTransformToParent;
   vtkMatrix4x4* CachedMatrixTransformFromParent;
+
+  /// Time of the last TransformModified call (transform replaced, inverted, or modified)
+  /// or parent transform node change.
+  vtkTimeStamp TransformModifiedTime;
+
+  /// Transforms to parent from this node to the top of the hierarchy, used by GetTransformToWorld
+  /// and GetTransformBetweenNodes. Valid if CachedTransformToWorldMTime is the same as GetTransformToWorldMTime().
+  std::vector< vtkSmartPointer<vtkAbstractTransform> > CachedTransformsToWorld;
+  /// Composed transform to world matrix, only set if CachedTransformToWorldLinear is true
+  vtkSmartPointer<vtkMatrix4x4> CachedMatrixTransformToWorld;
+  bool CachedTransformToWorldLinear{false};
+  bool CachedTransformToWorldValid{false};
+  vtkMTimeType CachedTransformToWorldMTime{0};
 };
 
 #endif
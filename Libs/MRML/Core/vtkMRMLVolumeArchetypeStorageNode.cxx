@@ -30,6 +30,11 @@ Version:   $Revision: 1.6 $
 #include "vtkITKArchetypeImageSeriesVectorReaderSeries.h"
 #include "vtkITKImageWriter.h"
 
+#ifdef MRML_USE_vtkTeem
+// vtkTeem includes
+#include <vtkTeemNRRDReader.h>
+#endif
+
 // VTKsys includes
 #include <vtksys/SystemTools.hxx>
 
@@ -59,6 +64,7 @@ vtkMRMLVolumeArchetypeStorageNode::vtkMRMLVolumeArchetypeStorageNode()
   this->CenterImage = 0;
   this->SingleFile  = 0;
   this->UseOrientationFromFile = 1;
+  this->UseMemoryMapping = 0;
   this->DefaultWriteFileExtension = "nrrd";
 }
 
@@ -79,6 +85,10 @@ void vtkMRMLVolumeArchetypeStorageNode::WriteXML(ostream& of, int nIndent)
   ss << this->UseOrientationFromFile;
   of << " UseOrientationFromFile=\"" << ss.str() << "\"";
   }
+  if (this->UseMemoryMapping)
+    {
+    of << " UseMemoryMapping=\"" << this->UseMemoryMapping << "\"";
+    }
   // SingleFile attribute is not written to file. GetNumberOfFileNames()
   // is used to determine if reader should read from single/multiple files.
 }
@@ -108,6 +118,12 @@ void vtkMRMLVolumeArchetypeStorageNode::ReadXMLAttributes(const char** atts)
       ss << attValue;
       ss >> this->UseOrientationFromFile;
       }
+    if (!strcmp(attName, "UseMemoryMapping"))
+      {
+      std::stringstream ss;
+      ss << attValue;
+      ss >> this->UseMemoryMapping;
+      }
     }
 
   // SingleFile attribute used to be read from the scene, but often
@@ -132,6 +148,7 @@ void vtkMRMLVolumeArchetypeStorageNode::Copy(vtkMRMLNode *anode)
   this->SetCenterImage(node->CenterImage);
   this->SetSingleFile(node->SingleFile);
   this->SetUseOrientationFromFile(node->UseOrientationFromFile);
+  this->SetUseMemoryMapping(node->UseMemoryMapping);
 
   this->EndModify(disabledModify);
 }
@@ -143,6 +160,7 @@ void vtkMRMLVolumeArchetypeStorageNode::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "CenterImage:   " << this->CenterImage << "\n";
   os << indent << "SingleFile:   " << this->SingleFile << "\n";
   os << indent << "UseOrientationFromFile:   " << this->UseOrientationFromFile << "\n";
+  os << indent << "UseMemoryMapping:   " << this->UseMemoryMapping << "\n";
 }
 
 //----------------------------------------------------------------------------
@@ -258,47 +276,10 @@ void ApplyImageSeriesReaderWorkaround(vtkMRMLVolumeArchetypeStorageNode * storag
 } // end of anonymous namespace
 
 //----------------------------------------------------------------------------
-int vtkMRMLVolumeArchetypeStorageNode::ReadDataInternal(vtkMRMLNode *refNode)
+vtkITKArchetypeImageSeriesReader* vtkMRMLVolumeArchetypeStorageNode::ReadImageFile(
+  vtkMRMLNode* refNode, const std::string& fullName, bool observeProgress,
+  bool& readingWorked, std::string& errorMessage)
 {
-  // Skip file loading for empty volume, for which no file was saved
-  if (this->GetWriteState() == SkippedNoData)
-    {
-    vtkDebugMacro("ReadDataInternal: Empty volume file was not saved, ignore loading");
-    return 1;
-    }
-
-  std::string fullName = this->GetFullNameFromFileName();
-  vtkDebugMacro("ReadData: got full archetype name " << fullName);
-
-  if (fullName.empty())
-    {
-    vtkErrorMacro("ReadData: File name not specified");
-    return 0;
-    }
-
-  //
-  // vtkMRMLVolumeNode
-  //   |
-  //   |--vtkMRMLScalarVolumeNode
-  //         |
-  //         |----vtkMRMLDiffusionWeightedVolumeNode
-  //         |
-  //         |----vtkMRMLTensorVolumeNode
-  //                  |
-  //                  |---vtkMRMLDiffusionImageVolumeNode
-  //                  |       |
-  //                  |       |---vtkMRMLDiffusionTensorVolumeNode
-  //                  |
-  //                  |---vtkMRMLVectorVolumeNode
-  //
-
-  vtkMRMLScalarVolumeNode * volNode = vtkMRMLScalarVolumeNode::SafeDownCast(refNode);
-  if (volNode == nullptr)
-    {
-    vtkErrorMacro("ReadDataInternal: Reference node is expected to be a vtkMRMLScalarVolumeNode");
-    return 0;
-    }
-
   vtkSmartPointer<vtkITKArchetypeImageSeriesReader> reader;
 
   if (refNode->IsA("vtkMRMLVectorVolumeNode"))
@@ -320,15 +301,12 @@ int vtkMRMLVolumeArchetypeStorageNode::ReadDataInternal(vtkMRMLNode *refNode)
 
   if (reader.GetPointer() == nullptr)
     {
-    vtkErrorMacro("ReadDataInternal: Failed to instantiate a file reader");
-    return 0;
+    return nullptr;
     }
 
-  reader->AddObserver( vtkCommand::ProgressEvent,  this->MRMLCallbackCommand);
-
-  if (volNode->GetImageData())
+  if (observeProgress)
     {
-    volNode->SetAndObserveImageData(nullptr);
+    reader->AddObserver( vtkCommand::ProgressEvent,  this->MRMLCallbackCommand);
     }
 
   // Set the list of file names on the reader
@@ -350,8 +328,8 @@ int vtkMRMLVolumeArchetypeStorageNode::ReadDataInternal(vtkMRMLNode *refNode)
     reader->SetUseNativeOriginOn();
     }
 
-  bool readingWorked = true;
-  std::string errorMessage = "";
+  readingWorked = true;
+  errorMessage = "";
   try
     {
     vtkDebugMacro("ReadDataInternal: right before reader update, reader num files = " << reader->GetNumberOfFileNames());
@@ -368,6 +346,177 @@ int vtkMRMLVolumeArchetypeStorageNode::ReadDataInternal(vtkMRMLNode *refNode)
     errorMessage = std::string("ITK exception info: error in ") + e.GetLocation() + "\n"
                                                 + e.GetDescription() + "\n";
     }
+  reader->Register(nullptr);
+  return reader;
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLVolumeArchetypeStorageNode::PrefetchData(vtkMRMLNode* refNode)
+{
+  this->ClearPrefetchedData();
+  if (!refNode || !this->CanReadInReferenceNode(refNode)
+    || this->GetWriteState() == SkippedNoData)
+    {
+    return false;
+    }
+  std::string fullName = this->GetFullNameFromFileName();
+  if (fullName.empty())
+    {
+    return false;
+    }
+  if (this->UseMemoryMapping)
+    {
+    // mapping a file is cheap, it is done by ReadData()
+    return false;
+    }
+  bool readingWorked = false;
+  std::string errorMessage;
+  vtkSmartPointer<vtkITKArchetypeImageSeriesReader> reader;
+  reader.TakeReference(this->ReadImageFile(refNode, fullName, false, readingWorked, errorMessage));
+  if (reader.GetPointer() == nullptr || !readingWorked)
+    {
+    // errors are reported when ReadData() reads the file again
+    return false;
+    }
+  this->PrefetchedFileName = fullName;
+  this->PrefetchedReader = reader;
+  return true;
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLVolumeArchetypeStorageNode::ClearPrefetchedData()
+{
+  this->PrefetchedFileName.clear();
+  this->PrefetchedReader = nullptr;
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLVolumeArchetypeStorageNode::ReadMemoryMappedData(vtkMRMLScalarVolumeNode* volNode,
+                                                             const std::string& fullName)
+{
+#ifdef MRML_USE_vtkTeem
+  std::string extension = vtkMRMLStorageNode::GetLowercaseExtensionFromFileName(fullName);
+  if ((extension != ".nrrd" && extension != ".nhdr")
+    || !this->UseOrientationFromFile
+    || volNode->IsA("vtkMRMLVectorVolumeNode")
+    || volNode->IsA("vtkMRMLDiffusionTensorVolumeNode"))
+    {
+    return false;
+    }
+
+  vtkNew<vtkTeemNRRDReader> reader;
+  reader->SetFileName(fullName.c_str());
+  reader->UseMemoryMappingOn();
+  if (this->CenterImage)
+    {
+    reader->SetUseNativeOriginOff();
+    }
+  else
+    {
+    reader->SetUseNativeOriginOn();
+    }
+  reader->Update();
+  if (!reader->GetMemoryMapped() || reader->GetReadStatus() != 0
+    || reader->GetNumberOfComponents() != 1
+    || reader->GetOutput()->GetPointData()->GetScalars() == nullptr)
+    {
+    vtkDebugMacro("ReadMemoryMappedData: " << fullName << " cannot be memory-mapped, read it instead");
+    return false;
+    }
+
+  vtkNew<vtkImageChangeInformation> ici;
+  ici->SetInputConnection(reader->GetOutputPort());
+  ici->SetOutputSpacing( 1, 1, 1 );
+  ici->SetOutputOrigin( 0, 0, 0 );
+  ici->Update();
+
+  vtkNew<vtkImageData> iciOutputCopy;
+  iciOutputCopy->ShallowCopy(ici->GetOutput());
+  volNode->SetAndObserveImageData(iciOutputCopy.GetPointer());
+  volNode->SetRASToIJKMatrix(reader->GetRasToIjkMatrix());
+
+  vtkInfoMacro(<<"Memory-mapped volume from file: "<<fullName \
+    <<". Dimensions: "<<iciOutputCopy->GetDimensions()[0]<<"x"<<iciOutputCopy->GetDimensions()[1]<<"x"<<iciOutputCopy->GetDimensions()[2] \
+    <<". Pixel type: "<<vtkImageScalarTypeNameMacro(iciOutputCopy->GetScalarType())<<".");
+  return true;
+#else
+  (void)volNode;
+  (void)fullName;
+  return false;
+#endif
+}
+
+//----------------------------------------------------------------------------
+int vtkMRMLVolumeArchetypeStorageNode::ReadDataInternal(vtkMRMLNode *refNode)
+{
+  // Skip file loading for empty volume, for which no file was saved
+  if (this->GetWriteState() == SkippedNoData)
+    {
+    vtkDebugMacro("ReadDataInternal: Empty volume file was not saved, ignore loading");
+    return 1;
+    }
+
+  std::string fullName = this->GetFullNameFromFileName();
+  vtkDebugMacro("ReadData: got full archetype name " << fullName);
+
+  if (fullName.empty())
+    {
+    vtkErrorMacro("ReadData: File name not specified");
+    return 0;
+    }
+
+  //
+  // vtkMRMLVolumeNode
+  //   |
+  //   |--vtkMRMLScalarVolumeNode
+  //         |
+  //         |----vtkMRMLDiffusionWeightedVolumeNode
+  //         |
+  //         |----vtkMRMLTensorVolumeNode
+  //                  |
+  //                  |---vtkMRMLDiffusionImageVolumeNode
+  //                  |       |
+  //                  |       |---vtkMRMLDiffusionTensorVolumeNode
+  //                  |
+  //                  |---vtkMRMLVectorVolumeNode
+  //
+
+  vtkMRMLScalarVolumeNode * volNode = vtkMRMLScalarVolumeNode::SafeDownCast(refNode);
+  if (volNode == nullptr)
+    {
+    vtkErrorMacro("ReadDataInternal: Reference node is expected to be a vtkMRMLScalarVolumeNode");
+    return 0;
+    }
+
+  if (volNode->GetImageData())
+    {
+    volNode->SetAndObserveImageData(nullptr);
+    }
+
+  if (this->UseMemoryMapping && this->ReadMemoryMappedData(volNode, fullName))
+    {
+    return 1;
+    }
+
+  vtkSmartPointer<vtkITKArchetypeImageSeriesReader> reader;
+  bool readingWorked = true;
+  std::string errorMessage = "";
+  if (this->PrefetchedReader && this->PrefetchedFileName == fullName)
+    {
+    // the file was already read by PrefetchData()
+    reader = this->PrefetchedReader;
+    this->ClearPrefetchedData();
+    }
+  else
+    {
+    this->ClearPrefetchedData();
+    reader.TakeReference(this->ReadImageFile(refNode, fullName, true, readingWorked, errorMessage));
+    if (reader.GetPointer() == nullptr)
+      {
+      vtkErrorMacro("ReadDataInternal: Failed to instantiate a file reader");
+      return 0;
+      }
+    }
   if (!readingWorked)
     {
     std::string reader0thFileName;
@@ -588,11 +737,10 @@ int vtkMRMLVolumeArchetypeStorageNode::WriteDataInternal(vtkMRMLNode *refNode)
 
     writer->SetInputConnection( volNode->GetImageDataConnection() );
     writer->SetUseCompression(this->GetUseCompression());
-    if(this->WriteFileFormat)
+    std::string imageIOClassName = this->GetWriteImageIOClassName();
+    if (!imageIOClassName.empty())
       {
-      writer->SetImageIOClassName(
-                                  this->GetScene()->GetDataIOManager()->GetFileFormatHelper()->
-                                  GetClassNameFromFormatString(this->WriteFileFormat));
+      writer->SetImageIOClassName(imageIOClassName.c_str());
       }
 
     // set volume attributes
@@ -642,6 +790,50 @@ int vtkMRMLVolumeArchetypeStorageNode::WriteDataInternal(vtkMRMLNode *refNode)
   return result;
 }
 
+//----------------------------------------------------------------------------
+std::string vtkMRMLVolumeArchetypeStorageNode::GetWriteImageIOClassName()
+{
+  if (!this->WriteFileFormat)
+    {
+    return std::string();
+    }
+  if (!this->WriteImageIOClassName.empty())
+    {
+    return this->WriteImageIOClassName;
+    }
+  if (!this->GetScene() ||
+      !this->GetScene()->GetDataIOManager() ||
+      !this->GetScene()->GetDataIOManager()->GetFileFormatHelper())
+    {
+    return std::string();
+    }
+  const char* className = this->GetScene()->GetDataIOManager()->GetFileFormatHelper()->
+    GetClassNameFromFormatString(this->WriteFileFormat);
+  return className ? className : "";
+}
+
+//----------------------------------------------------------------------------
+vtkMRMLNode* vtkMRMLVolumeArchetypeStorageNode::CreateWriteDataSnapshot(vtkMRMLNode* refNode)
+{
+  if (!this->CanWriteFromReferenceNode(refNode))
+    {
+    return nullptr;
+    }
+  return this->CreateContentSnapshot(refNode);
+}
+
+//----------------------------------------------------------------------------
+vtkMRMLStorageNode* vtkMRMLVolumeArchetypeStorageNode::CreateBackgroundWriteStorageNode()
+{
+  vtkMRMLVolumeArchetypeStorageNode* writer =
+    vtkMRMLVolumeArchetypeStorageNode::SafeDownCast(Superclass::CreateBackgroundWriteStorageNode());
+  if (writer)
+    {
+    writer->WriteImageIOClassName = this->GetWriteImageIOClassName();
+    }
+  return writer;
+}
+
 //----------------------------------------------------------------------------
 void vtkMRMLVolumeArchetypeStorageNode::InitializeSupportedWriteFileTypes()
 {
@@ -742,15 +934,10 @@ std::string vtkMRMLVolumeArchetypeStorageNode::UpdateFileList(vtkMRMLNode *refNo
   writer->SetFileName(tempName.c_str());
   writer->SetInputData( volNode->GetImageData() );
   writer->SetUseCompression(this->GetUseCompression());
-  if(this->WriteFileFormat)
+  std::string imageIOClassName = this->GetWriteImageIOClassName();
+  if (!imageIOClassName.empty())
     {
-    if (this->GetScene() &&
-        this->GetScene()->GetDataIOManager() &&
-        this->GetScene()->GetDataIOManager()->GetFileFormatHelper())
-      {
-      writer->SetImageIOClassName(this->GetScene()->GetDataIOManager()->GetFileFormatHelper()->
-                                  GetClassNameFromFormatString(this->WriteFileFormat));
-      }
+    writer->SetImageIOClassName(imageIOClassName.c_str());
     }
 
   // set volume attributes
@@ -19,6 +19,7 @@
 
 class vtkImageData;
 class vtkITKArchetypeImageSeriesReader;
+class vtkMRMLScalarVolumeNode;
 class vtkMRMLVolumeNode;
 
 /// \brief MRML node for representing a volume storage.
@@ -73,6 +74,16 @@ public:
   vtkSetMacro(UseOrientationFromFile, int);
   vtkGetMacro(UseOrientationFromFile, int);
 
+  ///
+  /// Map uncompressed NRRD scalar volume files in memory instead of reading them.
+  /// Loading is then almost instantaneous and voxels are only read from disk
+  /// when they are accessed. The mapping is copy-on-write: modifying the
+  /// voxels never modifies the file.
+  /// Files that cannot be mapped are read normally. Default is off.
+  vtkSetMacro(UseMemoryMapping, int);
+  vtkGetMacro(UseMemoryMapping, int);
+  vtkBooleanMacro(UseMemoryMapping, int);
+
   /// Return true if the reference node is supported by the storage node
   bool CanReadInReferenceNode(vtkMRMLNode* refNode) override;
   bool CanWriteFromReferenceNode(vtkMRMLNode* refNode) override;
@@ -90,6 +101,16 @@ public:
   /// using only wrapped types.
   static void SetMetaDataDictionaryFromReader(vtkMRMLVolumeNode*, vtkITKArchetypeImageSeriesReader*);
 
+  /// Read the image from file, it is set in the volume node by the next ReadData() call.
+  bool PrefetchData(vtkMRMLNode* refNode) override;
+  void ClearPrefetchedData() override;
+
+  /// Volumes can be written in the background from a copy of the volume node.
+  vtkMRMLNode* CreateWriteDataSnapshot(vtkMRMLNode* refNode) override;
+  /// The ITK image IO of WriteFileFormat is resolved using the scene before
+  /// it is removed.
+  vtkMRMLStorageNode* CreateBackgroundWriteStorageNode() override;
+
 protected:
   vtkMRMLVolumeArchetypeStorageNode();
   ~vtkMRMLVolumeArchetypeStorageNode() override;
@@ -101,15 +122,38 @@ protected:
 
   vtkITKArchetypeImageSeriesReader* InstantiateVectorVolumeReader(const std::string &fullName);
 
+  /// Instantiate a reader suitable for \a refNode and update it, without
+  /// modifying the MRML state. Returns nullptr if no reader could be
+  /// instantiated, the caller is responsible for deleting the returned reader.
+  vtkITKArchetypeImageSeriesReader* ReadImageFile(vtkMRMLNode* refNode, const std::string& fullName,
+    bool observeProgress, bool& readingWorked, std::string& errorMessage);
+
+  /// Map the NRRD file \a fullName in memory and set it in \a volNode.
+  /// Returns false if the file cannot be mapped.
+  bool ReadMemoryMappedData(vtkMRMLScalarVolumeNode* volNode, const std::string& fullName);
+
   /// Read data and set it in the referenced node
   int ReadDataInternal(vtkMRMLNode *refNode) override;
 
   /// Write data from a referenced node
   int WriteDataInternal(vtkMRMLNode *refNode) override;
 
+  /// Return the ITK image IO class name of WriteFileFormat, empty if it is
+  /// not set or cannot be resolved.
+  std::string GetWriteImageIOClassName();
+
   int CenterImage;
   int SingleFile;
   int UseOrientationFromFile;
+  int UseMemoryMapping;
+
+  /// Content read by PrefetchData()
+  std::string PrefetchedFileName;
+  vtkSmartPointer<vtkITKArchetypeImageSeriesReader> PrefetchedReader;
+
+  /// Image IO class name used instead of the one of WriteFileFormat
+  /// when the node is not in a scene.
+  std::string WriteImageIOClassName;
 
 };
 
@@ -0,0 +1,417 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2017 Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+=========================================================================auto=*/
+
+// MRML includes
+#include "vtkCacheManager.h"
+#include "vtkMRMLScalarVolumeNode.h"
+#include "vtkMRMLScene.h"
+#include "vtkMRMLVolumeChunkedStorageNode.h"
+#include "vtkOMEZarrImageReader.h"
+#include "vtkOMEZarrImageWriter.h"
+#include "vtkURIHandler.h"
+
+// VTK includes
+#include <vtkImageData.h>
+#include <vtkMatrix4x4.h>
+#include <vtkNew.h>
+#include <vtkObjectFactory.h>
+#include <vtkPointData.h>
+#include <vtkStringArray.h>
+
+// VTKsys includes
+#include <vtksys/SystemTools.hxx>
+
+// STD includes
+#include <algorithm>
+#include <cmath>
+
+//----------------------------------------------------------------------------
+vtkMRMLNodeNewMacro(vtkMRMLVolumeChunkedStorageNode);
+
+//----------------------------------------------------------------------------
+vtkMRMLVolumeChunkedStorageNode::vtkMRMLVolumeChunkedStorageNode()
+{
+  this->ResolutionLevel = -1;
+  this->MaximumMemorySizeMB = 1024;
+  this->LoadedResolutionLevel = -1;
+  this->ChunkSize = 64;
+  this->NumberOfResolutionLevels = 0;
+  this->DefaultWriteFileExtension = "ome.zarr";
+}
+
+//----------------------------------------------------------------------------
+vtkMRMLVolumeChunkedStorageNode::~vtkMRMLVolumeChunkedStorageNode() = default;
+
+//----------------------------------------------------------------------------
+void vtkMRMLVolumeChunkedStorageNode::WriteXML(ostream& of, int nIndent)
+{
+  this->Superclass::WriteXML(of, nIndent);
+
+  vtkMRMLWriteXMLBeginMacro(of);
+  vtkMRMLWriteXMLIntMacro(resolutionLevel, ResolutionLevel);
+  vtkMRMLWriteXMLIntMacro(maximumMemorySizeMB, MaximumMemorySizeMB);
+  vtkMRMLWriteXMLIntMacro(chunkSize, ChunkSize);
+  vtkMRMLWriteXMLIntMacro(numberOfResolutionLevels, NumberOfResolutionLevels);
+  vtkMRMLWriteXMLEndMacro();
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLVolumeChunkedStorageNode::ReadXMLAttributes(const char** atts)
+{
+  int disabledModify = this->StartModify();
+
+  this->Superclass::ReadXMLAttributes(atts);
+
+  vtkMRMLReadXMLBeginMacro(atts);
+  vtkMRMLReadXMLIntMacro(resolutionLevel, ResolutionLevel);
+  vtkMRMLReadXMLIntMacro(maximumMemorySizeMB, MaximumMemorySizeMB);
+  vtkMRMLReadXMLIntMacro(chunkSize, ChunkSize);
+  vtkMRMLReadXMLIntMacro(numberOfResolutionLevels, NumberOfResolutionLevels);
+  vtkMRMLReadXMLEndMacro();
+
+  this->EndModify(disabledModify);
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLVolumeChunkedStorageNode::Copy(vtkMRMLNode *anode)
+{
+  int disabledModify = this->StartModify();
+
+  this->Superclass::Copy(anode);
+
+  vtkMRMLCopyBeginMacro(anode);
+  vtkMRMLCopyIntMacro(ResolutionLevel);
+  vtkMRMLCopyIntMacro(MaximumMemorySizeMB);
+  vtkMRMLCopyIntMacro(ChunkSize);
+  vtkMRMLCopyIntMacro(NumberOfResolutionLevels);
+  vtkMRMLCopyEndMacro();
+
+  this->EndModify(disabledModify);
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLVolumeChunkedStorageNode::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+
+  vtkMRMLPrintBeginMacro(os, indent);
+  vtkMRMLPrintIntMacro(ResolutionLevel);
+  vtkMRMLPrintIntMacro(MaximumMemorySizeMB);
+  vtkMRMLPrintIntMacro(LoadedResolutionLevel);
+  vtkMRMLPrintIntMacro(ChunkSize);
+  vtkMRMLPrintIntMacro(NumberOfResolutionLevels);
+  vtkMRMLPrintEndMacro();
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLVolumeChunkedStorageNode::CanReadInReferenceNode(vtkMRMLNode *refNode)
+{
+  return refNode->IsA("vtkMRMLScalarVolumeNode")
+    && !refNode->IsA("vtkMRMLTensorVolumeNode")
+    && !refNode->IsA("vtkMRMLDiffusionWeightedVolumeNode");
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLVolumeChunkedStorageNode::CanWriteFromReferenceNode(vtkMRMLNode *refNode)
+{
+  vtkMRMLScalarVolumeNode* volumeNode = vtkMRMLScalarVolumeNode::SafeDownCast(refNode);
+  if (!volumeNode || !this->CanReadInReferenceNode(refNode))
+    {
+    this->GetUserMessages()->AddMessage(vtkCommand::ErrorEvent,
+      std::string("Only scalar volumes can be written in chunked volume format."));
+    return false;
+    }
+  if (volumeNode->GetImageData() && volumeNode->GetImageData()->GetNumberOfScalarComponents() != 1)
+    {
+    this->GetUserMessages()->AddMessage(vtkCommand::ErrorEvent,
+      std::string("Only single-component volumes can be written in chunked volume format."));
+    return false;
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLVolumeChunkedStorageNode::InitializeSupportedReadFileTypes()
+{
+  this->SupportedReadFileTypes->InsertNextValue("OME-Zarr chunked volume (.ome.zarr)");
+  this->SupportedReadFileTypes->InsertNextValue("Zarr chunked volume (.zarr)");
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLVolumeChunkedStorageNode::InitializeSupportedWriteFileTypes()
+{
+  this->SupportedWriteFileTypes->InsertNextValue("OME-Zarr chunked volume (.ome.zarr)");
+}
+
+//----------------------------------------------------------------------------
+const char* vtkMRMLVolumeChunkedStorageNode::GetDefaultWriteFileExtension()
+{
+  return "ome.zarr";
+}
+
+//----------------------------------------------------------------------------
+vtkOMEZarrImageReader* vtkMRMLVolumeChunkedStorageNode::GetReader()
+{
+  if (!this->Reader)
+    {
+    this->Reader = vtkSmartPointer<vtkOMEZarrImageReader>::New();
+    }
+  return this->Reader;
+}
+
+//----------------------------------------------------------------------------
+vtkURIHandler* vtkMRMLVolumeChunkedStorageNode::GetStreamingURIHandler()
+{
+  if (!this->GetURI() || strlen(this->GetURI()) == 0 || !this->GetScene()
+    || !this->GetScene()->GetCacheManager()
+    || !this->GetScene()->GetCacheManager()->IsRemoteReference(this->GetURI()))
+    {
+    return nullptr;
+    }
+  if (this->URIHandler == nullptr)
+    {
+    this->SetURIHandler(this->GetScene()->FindURIHandler(this->GetURI()));
+    }
+  if (this->URIHandler == nullptr || !this->URIHandler->CanReadToMemory())
+    {
+    return nullptr;
+    }
+  return this->URIHandler;
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLVolumeChunkedStorageNode::StageReadData(vtkMRMLNode* refNode)
+{
+  if (refNode && this->GetAddToScene() && refNode->GetAddToScene()
+    && this->GetStreamingURIHandler())
+    {
+    vtkDebugMacro("StageReadData: chunks of " << this->GetURI() << " are read on demand, setting state to transfer done");
+    this->SetReadStateTransferDone();
+    return;
+    }
+  this->Superclass::StageReadData(refNode);
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLVolumeChunkedStorageNode::UpdateReader()
+{
+  vtkOMEZarrImageReader* reader = this->GetReader();
+  vtkURIHandler* uriHandler = this->GetStreamingURIHandler();
+  if (uriHandler)
+    {
+    reader->SetURIHandler(uriHandler);
+    reader->SetFileName(this->GetURI());
+    reader->UpdateInformation();
+    return reader->GetNumberOfResolutionLevels() > 0;
+    }
+  std::string fullName = this->GetFullNameFromFileName();
+  if (fullName.empty())
+    {
+    vtkErrorMacro("UpdateReader: File name not specified");
+    return false;
+    }
+  if (!vtksys::SystemTools::FileIsDirectory(fullName))
+    {
+    vtkErrorMacro("UpdateReader: chunked volume directory '" << fullName << "' not found.");
+    return false;
+    }
+  reader->SetURIHandler(nullptr);
+  reader->SetFileName(fullName.c_str());
+  reader->UpdateInformation();
+  return reader->GetNumberOfResolutionLevels() > 0;
+}
+
+//----------------------------------------------------------------------------
+int vtkMRMLVolumeChunkedStorageNode::GetNumberOfResolutionLevelsInFile()
+{
+  if (!this->UpdateReader())
+    {
+    return 0;
+    }
+  return this->Reader->GetNumberOfResolutionLevels();
+}
+
+//----------------------------------------------------------------------------
+int vtkMRMLVolumeChunkedStorageNode::ReadDataInternal(vtkMRMLNode *refNode)
+{
+  vtkMRMLScalarVolumeNode* volumeNode = vtkMRMLScalarVolumeNode::SafeDownCast(refNode);
+  if (!volumeNode)
+    {
+    vtkErrorMacro("ReadDataInternal: Reference node is expected to be a vtkMRMLScalarVolumeNode");
+    return 0;
+    }
+  if (!this->UpdateReader())
+    {
+    return 0;
+    }
+
+  int numberOfLevels = this->Reader->GetNumberOfResolutionLevels();
+  int level = std::min(this->ResolutionLevel, numberOfLevels - 1);
+  if (level < 0)
+    {
+    // finest level that fits in memory, or the coarsest level
+    double maximumMemorySize = static_cast<double>(this->MaximumMemorySizeMB) * 1024.0 * 1024.0;
+    for (level = 0; level < numberOfLevels - 1; ++level)
+      {
+      int dimensions[3] = { 0, 0, 0 };
+      this->Reader->GetLevelDimensions(level, dimensions);
+      double levelSize = double(dimensions[0]) * dimensions[1] * dimensions[2]
+        * this->Reader->GetLevelScalarSize(level);
+      if (levelSize <= maximumMemorySize)
+        {
+        break;
+        }
+      }
+    }
+  return this->ReadLevel(volumeNode, level, nullptr);
+}
+
+//----------------------------------------------------------------------------
+int vtkMRMLVolumeChunkedStorageNode::ReadRegion(vtkMRMLNode* refNode, const double regionBoundsRAS[6], int resolutionLevel)
+{
+  vtkMRMLScalarVolumeNode* volumeNode = vtkMRMLScalarVolumeNode::SafeDownCast(refNode);
+  if (!volumeNode || !this->CanReadInReferenceNode(refNode))
+    {
+    vtkErrorMacro("ReadRegion: Reference node is expected to be a vtkMRMLScalarVolumeNode");
+    return 0;
+    }
+  if (!this->UpdateReader())
+    {
+    return 0;
+    }
+  if (resolutionLevel < 0 || resolutionLevel >= this->Reader->GetNumberOfResolutionLevels())
+    {
+    vtkErrorMacro("ReadRegion: invalid resolution level " << resolutionLevel);
+    return 0;
+    }
+
+  vtkNew<vtkMatrix4x4> rasToIJK;
+  this->Reader->GetLevelIJKToRASMatrix(resolutionLevel, rasToIJK);
+  rasToIJK->Invert();
+  int dimensions[3] = { 0, 0, 0 };
+  this->Reader->GetLevelDimensions(resolutionLevel, dimensions);
+
+  // IJK bounding box of the region corners
+  double boundsIJK[6] = { VTK_DOUBLE_MAX, VTK_DOUBLE_MIN, VTK_DOUBLE_MAX, VTK_DOUBLE_MIN, VTK_DOUBLE_MAX, VTK_DOUBLE_MIN };
+  for (int corner = 0; corner < 8; ++corner)
+    {
+    double cornerRAS[4] = {
+      regionBoundsRAS[(corner & 1) ? 1 : 0],
+      regionBoundsRAS[(corner & 2) ? 3 : 2],
+      regionBoundsRAS[(corner & 4) ? 5 : 4],
+      1.0 };
+    double cornerIJK[4] = { 0.0, 0.0, 0.0, 1.0 };
+    rasToIJK->MultiplyPoint(cornerRAS, cornerIJK);
+    for (int i = 0; i < 3; ++i)
+      {
+      boundsIJK[2 * i] = std::min(boundsIJK[2 * i], cornerIJK[i]);
+      boundsIJK[2 * i + 1] = std::max(boundsIJK[2 * i + 1], cornerIJK[i]);
+      }
+    }
+  int extent[6];
+  for (int i = 0; i < 3; ++i)
+    {
+    extent[2 * i] = std::max(0, static_cast<int>(floor(boundsIJK[2 * i])));
+    extent[2 * i + 1] = std::min(dimensions[i] - 1, static_cast<int>(ceil(boundsIJK[2 * i + 1])));
+    if (extent[2 * i] > extent[2 * i + 1])
+      {
+      vtkErrorMacro("ReadRegion: region does not intersect the volume");
+      return 0;
+      }
+    }
+  return this->ReadLevel(volumeNode, resolutionLevel, extent);
+}
+
+//----------------------------------------------------------------------------
+int vtkMRMLVolumeChunkedStorageNode::ReadLevel(vtkMRMLScalarVolumeNode* volumeNode, int level, const int* extent)
+{
+  int wholeExtent[6] = { 0, -1, 0, -1, 0, -1 };
+  int dimensions[3] = { 0, 0, 0 };
+  this->Reader->GetLevelDimensions(level, dimensions);
+  for (int i = 0; i < 3; ++i)
+    {
+    wholeExtent[2 * i + 1] = dimensions[i] - 1;
+    }
+  this->Reader->SetResolutionLevel(level);
+  this->Reader->ResetNumberOfChunksRead();
+  // the pipeline would not execute for a region that is inside the previously read region,
+  // chunks are cached by the reader so executing it again is cheap
+  this->Reader->Modified();
+  this->Reader->UpdateInformation();
+  if (!this->Reader->UpdateExtent(extent ? extent : wholeExtent))
+    {
+    vtkErrorMacro("ReadLevel: failed to read resolution level " << level << " of " << this->Reader->GetFileName());
+    return 0;
+    }
+
+  vtkNew<vtkImageData> imageData;
+  imageData->ShallowCopy(this->Reader->GetOutput());
+  if (!imageData->GetPointData()->GetScalars())
+    {
+    vtkErrorMacro("ReadLevel: Unable to read data from file: " << this->Reader->GetFileName());
+    return 0;
+    }
+
+  int wasModified = volumeNode->StartModify();
+  volumeNode->SetIJKToRASMatrix(this->Reader->GetIJKToRASMatrix());
+  volumeNode->SetAndObserveImageData(imageData);
+  // loaded regions start at the region origin
+  volumeNode->ShiftImageDataExtentToZeroStart();
+  volumeNode->EndModify(wasModified);
+  this->LoadedResolutionLevel = level;
+
+  vtkInfoMacro(<<"Loaded resolution level "<<level<<" of chunked volume: "<<this->Reader->GetFileName() \
+    <<". Dimensions: "<<imageData->GetDimensions()[0]<<"x"<<imageData->GetDimensions()[1]<<"x"<<imageData->GetDimensions()[2] \
+    <<". Chunks read: "<<this->Reader->GetNumberOfChunksRead()<<".");
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkMRMLVolumeChunkedStorageNode::WriteDataInternal(vtkMRMLNode *refNode)
+{
+  vtkMRMLScalarVolumeNode* volumeNode = vtkMRMLScalarVolumeNode::SafeDownCast(refNode);
+  if (!volumeNode)
+    {
+    vtkErrorMacro("WriteDataInternal: Reference node is expected to be a vtkMRMLScalarVolumeNode");
+    return 0;
+    }
+  if (!volumeNode->GetImageData())
+    {
+    vtkErrorMacro("WriteDataInternal: Cannot write volume without image data");
+    return 0;
+    }
+  std::string fullName = this->GetFullNameFromFileName();
+  if (fullName.empty())
+    {
+    vtkErrorMacro("WriteDataInternal: File name not specified");
+    return 0;
+    }
+
+  vtkNew<vtkMatrix4x4> ijkToRAS;
+  volumeNode->GetIJKToRASMatrix(ijkToRAS);
+  vtkNew<vtkOMEZarrImageWriter> writer;
+  writer->SetInputData(volumeNode->GetImageData());
+  writer->SetFileName(fullName.c_str());
+  writer->SetIJKToRASMatrix(ijkToRAS);
+  writer->SetChunkSize(this->ChunkSize, this->ChunkSize, this->ChunkSize);
+  writer->SetNumberOfResolutionLevels(this->NumberOfResolutionLevels);
+  writer->SetUseCompression(this->GetUseCompression() != 0);
+  // averaging would create labels that do not exist
+  writer->SetDownsampleByAveraging(!volumeNode->IsA("vtkMRMLLabelMapVolumeNode"));
+  writer->Write();
+
+  // metadata and chunks of the previous file content must not be used
+  this->Reader = nullptr;
+  if (writer->GetWriteError())
+    {
+    vtkErrorMacro("WriteDataInternal: failed to write " << fullName);
+    return 0;
+    }
+  return 1;
+}
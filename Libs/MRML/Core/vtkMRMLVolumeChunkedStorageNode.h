@@ -0,0 +1,141 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2017 Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+=========================================================================auto=*/
+
+#ifndef __vtkMRMLVolumeChunkedStorageNode_h
+#define __vtkMRMLVolumeChunkedStorageNode_h
+
+// MRML includes
+#include "vtkMRMLStorageNode.h"
+
+// VTK includes
+#include <vtkSmartPointer.h>
+
+class vtkMRMLScalarVolumeNode;
+class vtkOMEZarrImageReader;
+class vtkURIHandler;
+
+/// \brief MRML node for representing a chunked, multiresolution volume storage.
+///
+/// Volumes are stored as OME-Zarr directories: the full resolution image and
+/// downsampled versions of it are split in chunks stored in separate files.
+///
+/// Reading loads a single resolution level, by default the finest one that
+/// fits in MaximumMemorySizeMB. ReadRegion() loads only the chunks that
+/// intersect a region (for example the bounds of the slice views or of the
+/// volume rendering ROI) at any level, which allows inspecting volumes
+/// larger than the available memory at full resolution.
+/// Chunks remain cached between ReadRegion() calls.
+///
+/// If the URI is a remote reference and its URI handler can read into memory
+/// (e.g. HTTP), the volume is not downloaded to the cache: the metadata and
+/// the chunks needed by ReadData() or ReadRegion() are fetched directly.
+///
+/// Only single-component scalar volumes (including label maps) are supported.
+class VTK_MRML_EXPORT vtkMRMLVolumeChunkedStorageNode : public vtkMRMLStorageNode
+{
+public:
+  static vtkMRMLVolumeChunkedStorageNode *New();
+  vtkTypeMacro(vtkMRMLVolumeChunkedStorageNode, vtkMRMLStorageNode);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  vtkMRMLNode* CreateNodeInstance() override;
+
+  void ReadXMLAttributes(const char** atts) override;
+  void WriteXML(ostream& of, int indent) override;
+  void Copy(vtkMRMLNode *node) override;
+
+  /// Get node XML tag name (like Storage, Model)
+  const char* GetNodeTagName() override {return "VolumeChunkedStorage";}
+
+  /// Resolution level loaded by ReadData(), 0 is the full resolution.
+  /// -1 loads the finest level that fits in MaximumMemorySizeMB.
+  /// Default is -1.
+  vtkSetMacro(ResolutionLevel, int);
+  vtkGetMacro(ResolutionLevel, int);
+
+  /// Maximum size of the voxels loaded by ReadData() when ResolutionLevel is -1.
+  /// Default is 1024.
+  vtkSetMacro(MaximumMemorySizeMB, int);
+  vtkGetMacro(MaximumMemorySizeMB, int);
+
+  /// Resolution level loaded by the last ReadData() or ReadRegion() call.
+  vtkGetMacro(LoadedResolutionLevel, int);
+
+  /// Number of voxels of a chunk along each axis when writing. Default is 64.
+  vtkSetMacro(ChunkSize, int);
+  vtkGetMacro(ChunkSize, int);
+
+  /// Number of resolution levels to write, including the full resolution.
+  /// 0 adds levels until the coarsest level fits in one chunk. Default is 0.
+  vtkSetMacro(NumberOfResolutionLevels, int);
+  vtkGetMacro(NumberOfResolutionLevels, int);
+
+  /// Load in \a refNode the part of the volume that is within \a regionBoundsRAS
+  /// (xmin, xmax, ymin, ymax, zmin, zmax in the volume's RAS coordinate system)
+  /// at \a resolutionLevel. Only chunks intersecting the region are read.
+  /// Returns 1 on success, 0 otherwise.
+  int ReadRegion(vtkMRMLNode* refNode, const double regionBoundsRAS[6], int resolutionLevel);
+
+  /// Number of resolution levels in the file, 0 if it cannot be read.
+  int GetNumberOfResolutionLevelsInFile();
+
+  /// Reader used to access the chunks, created on first use.
+  /// vtkOMEZarrImageReader::GetNumberOfChunksRead() returns the number of
+  /// chunk files read by the last ReadData() or ReadRegion() call.
+  vtkOMEZarrImageReader* GetReader();
+
+  /// Return true if the reference node can be read in
+  bool CanReadInReferenceNode(vtkMRMLNode *refNode) override;
+  /// Return true if the reference node can be written from
+  bool CanWriteFromReferenceNode(vtkMRMLNode *refNode) override;
+
+  /// Return a default file extension for writing
+  const char* GetDefaultWriteFileExtension() override;
+
+  /// Skip the download of remote volumes that can be streamed
+  void StageReadData(vtkMRMLNode* refNode) override;
+
+protected:
+  vtkMRMLVolumeChunkedStorageNode();
+  ~vtkMRMLVolumeChunkedStorageNode() override;
+  vtkMRMLVolumeChunkedStorageNode(const vtkMRMLVolumeChunkedStorageNode&);
+  void operator=(const vtkMRMLVolumeChunkedStorageNode&);
+
+  /// Initialize all the supported read file types
+  void InitializeSupportedReadFileTypes() override;
+
+  /// Initialize all the supported write file types
+  void InitializeSupportedWriteFileTypes() override;
+
+  /// Read data and set it in the referenced node
+  int ReadDataInternal(vtkMRMLNode *refNode) override;
+
+  /// Write data from a referenced node
+  int WriteDataInternal(vtkMRMLNode *refNode) override;
+
+  /// Read \a extent (whole level if nullptr) of \a level and set it in \a volumeNode
+  int ReadLevel(vtkMRMLScalarVolumeNode* volumeNode, int level, const int* extent);
+
+  /// Make the reader use the current file, return false if it cannot be read
+  bool UpdateReader();
+
+  /// Return the URI handler that reads the chunks of the remote URI,
+  /// or nullptr if the volume must be read from a local file
+  vtkURIHandler* GetStreamingURIHandler();
+
+  int ResolutionLevel;
+  int MaximumMemorySizeMB;
+  int LoadedResolutionLevel;
+  int ChunkSize;
+  int NumberOfResolutionLevels;
+
+  vtkSmartPointer<vtkOMEZarrImageReader> Reader;
+};
+
+#endif
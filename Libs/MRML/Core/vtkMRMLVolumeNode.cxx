@@ -32,6 +32,7 @@ Version:   $Revision: 1.14 $
 #include <vtkImageData.h>
 #include <vtkImageDataGeometryFilter.h>
 #include <vtkImageReslice.h>
+#include <vtkImageShrink3D.h>
 #include <vtkMathUtilities.h>
 #include <vtkMatrix4x4.h>
 #include <vtkNew.h>
@@ -70,6 +71,7 @@ vtkMRMLVolumeNode::vtkMRMLVolumeNode()
 
   this->ImageDataConnection = nullptr;
   this->DataEventForwarder = nullptr;
+  this->DownsampledImageDataSourceMTime = 0;
 
   this->ContentModifiedEvents->InsertNextValue(vtkMRMLVolumeNode::ImageDataModifiedEvent);
 }
@@ -188,7 +190,15 @@ void vtkMRMLVolumeNode::CopyContent(vtkMRMLNode* anode, bool deepCopy/*=true*/)
     if (targetImageData.GetPointer() != nullptr)
       {
       targetImageData = vtkSmartPointer<vtkImageData>::Take(node->GetImageData()->NewInstance());
-      targetImageData->DeepCopy(node->GetImageData());
+      if (this->GetCopyOnWriteBulkData(node))
+        {
+        // voxels are shared until DetachSharedBulkData() is called
+        targetImageData->ShallowCopy(node->GetImageData());
+        }
+      else
+        {
+        targetImageData->DeepCopy(node->GetImageData());
+        }
       }
     this->SetAndObserveImageData(targetImageData); // invokes vtkMRMLVolumeNode::ImageDataModifiedEvent, which is not masked by StartModify
     }
@@ -720,8 +730,21 @@ void vtkMRMLVolumeNode::SetAndObserveImageData(vtkImageData *imageData)
       oldProducer->GetOutputDataObject(0)->RemoveObservers(
         vtkCommand::ModifiedEvent, this->DataEventForwarder);
       }
+    if (oldProducer && oldProducer == this->ImageDataProducer && this->DataEventForwarder
+      && oldProducer->GetOutputDataObject(0)
+      && strcmp(oldProducer->GetOutputDataObject(0)->GetClassName(), imageData->GetClassName()) == 0)
+      {
+      // Only swap the image in the producer, so that the image data connection is kept.
+      // ImageDataModifiedEvent is invoked because the producer is modified.
+      imageData->AddObserver(vtkCommand::ModifiedEvent, this->DataEventForwarder);
+      oldProducer->SetOutput(imageData);
+      this->StorableModifiedTime.Modified();
+      this->Modified();
+      return;
+      }
     vtkNew<vtkTrivialProducer> tp;
     tp->SetOutput(imageData);
+    this->ImageDataProducer = tp.GetPointer();
     // Propagate ModifiedEvent onto the trivial producer to make sure
     // ImageDataModifiedEvent is triggered.
     if (!this->DataEventForwarder)
@@ -1005,6 +1028,75 @@ bool vtkMRMLVolumeNode::GetModifiedSinceRead()
     (this->GetImageData() && this->GetImageData()->GetMTime() > this->GetStoredTime());
 }
 
+//---------------------------------------------------------------------------
+vtkMTimeType vtkMRMLVolumeNode::GetContentMTime()
+{
+  vtkMTimeType mTime = this->Superclass::GetContentMTime();
+  if (this->GetImageData() && this->GetImageData()->GetMTime() > mTime)
+    {
+    mTime = this->GetImageData()->GetMTime();
+    }
+  return mTime;
+}
+
+//---------------------------------------------------------------------------
+bool vtkMRMLVolumeNode::IsContentMTimeTracked()
+{
+  return true;
+}
+
+//---------------------------------------------------------------------------
+unsigned long vtkMRMLVolumeNode::GetContentMemorySize()
+{
+  unsigned long size = this->Superclass::GetContentMemorySize();
+  if (this->GetImageData())
+    {
+    size += this->GetImageData()->GetActualMemorySize();
+    }
+  return size;
+}
+
+//---------------------------------------------------------------------------
+vtkImageData* vtkMRMLVolumeNode::GetDownsampledImageData()
+{
+  vtkImageData* imageData = this->GetImageData();
+  if (!imageData)
+    {
+    this->DownsampledImageData = nullptr;
+    return nullptr;
+    }
+  if (this->DownsampledImageData && this->DownsampledImageDataSourceMTime == imageData->GetMTime())
+    {
+    return this->DownsampledImageData;
+    }
+
+  int dimensions[3] = { 0, 0, 0 };
+  imageData->GetDimensions(dimensions);
+  vtkNew<vtkImageShrink3D> shrink;
+  shrink->SetInputData(imageData);
+  shrink->SetShrinkFactors(dimensions[0] > 1 ? 2 : 1, dimensions[1] > 1 ? 2 : 1, dimensions[2] > 1 ? 2 : 1);
+  // Subsample instead of averaging, so that label values are preserved
+  shrink->AveragingOff();
+  shrink->Update();
+
+  this->DownsampledImageData = vtkSmartPointer<vtkImageData>::New();
+  this->DownsampledImageData->ShallowCopy(shrink->GetOutput());
+  this->DownsampledImageDataSourceMTime = imageData->GetMTime();
+  return this->DownsampledImageData;
+}
+
+//---------------------------------------------------------------------------
+bool vtkMRMLVolumeNode::IsBulkDataShared()
+{
+  return vtkMRMLNode::IsDataObjectShared(this->GetImageData());
+}
+
+//---------------------------------------------------------------------------
+bool vtkMRMLVolumeNode::DetachSharedBulkData()
+{
+  return vtkMRMLNode::DetachSharedDataObject(this->GetImageData());
+}
+
 //---------------------------------------------------------------------------
 bool vtkMRMLVolumeNode::CanApplyNonLinearTransforms()const
 {
@@ -20,10 +20,13 @@
 class vtkMRMLVolumeDisplayNode;
 
 // VTK includes
+#include <vtkSmartPointer.h>
+#include <vtkWeakPointer.h>
 class vtkAlgorithmOutput;
 class vtkEventForwarderCommand;
 class vtkImageData;
 class vtkMatrix4x4;
+class vtkTrivialProducer;
 
 // ITK includes
 #include "itkMetaDataDictionary.h"
@@ -171,6 +174,9 @@ public:
   /// Instead of storing some information in vtkImageData and some outside, the decision was
   /// made to store all information in the MRML node (vtkMRMLVolumeNode::Origin,
   /// vtkMRMLVolumeNode::Spacing, and vtkMRMLVolumeNode::IJKToRASDirections).
+  /// If the current image was also set by this method and it is of the same type then
+  /// only the output of the producer is replaced: the image data connection does not change,
+  /// therefore downstream pipelines are not reconnected, they just get new input data.
   /// \sa GetImageData(), SetImageDataConnection()
   virtual void SetAndObserveImageData(vtkImageData *ImageData);
   virtual vtkImageData* GetImageData();
@@ -214,12 +220,31 @@ public:
 
   bool GetModifiedSinceRead() override;
 
+  /// Take into account the image data modification time and size.
+  vtkMTimeType GetContentMTime() override;
+  bool IsContentMTimeTracked() override;
+  unsigned long GetContentMemorySize() override;
+
+  /// Check and detach image data arrays shared with deep copies.
+  /// \sa vtkMRMLScene::SetCopyOnWriteBulkData
+  bool IsBulkDataShared() override;
+  bool DetachSharedBulkData() override;
+
   ///
   /// Get background voxel value of the image. It can be used for assigning
   /// intensity value to "empty" voxels when the image is transformed.
   /// It is computed as median value of the 8 corner voxels.
   virtual double GetImageBackgroundScalarComponentAsDouble(int component);
 
+  /// Get a downsampled version of the image data for fast approximate display,
+  /// for example for reslicing while the user interacts with a slice view.
+  /// Every second voxel is kept along each axis that has more than one voxel.
+  /// Spacing of the returned image is the downsampling factor, therefore it can be used
+  /// in place of the image data in the same IJK coordinate system.
+  /// The image is computed at the first request and cached until the image data is modified.
+  /// Returns nullptr if there is no image data.
+  vtkImageData* GetDownsampledImageData();
+
   /// Creates the most appropriate display node class for storing a sequence of these nodes.
   void CreateDefaultSequenceDisplayNodes() override;
 
@@ -272,6 +297,13 @@ protected:
 
   vtkAlgorithmOutput* ImageDataConnection;
   vtkEventForwarderCommand* DataEventForwarder;
+  /// Producer created by SetAndObserveImageData, its output can be replaced
+  vtkWeakPointer<vtkTrivialProducer> ImageDataProducer;
+
+  /// Cache of GetDownsampledImageData()
+  vtkSmartPointer<vtkImageData> DownsampledImageData;
+  /// Modification time of the image data that DownsampledImageData was computed from
+  vtkMTimeType DownsampledImageDataSourceMTime;
 
   itk::MetaDataDictionary Dictionary;
 };
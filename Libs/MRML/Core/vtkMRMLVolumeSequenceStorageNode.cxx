@@ -8,10 +8,17 @@ or http://www.slicer.org/copyright/copyright.txt for details.
 =========================================================================auto=*/
 
 #include <algorithm>
+#include <condition_variable>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <type_traits>
 
 #include <vtkAddonMathUtilities.h>
 
 #include "vtkMRMLMessageCollection.h"
+#include "vtkMRMLNodePropertyMacros.h"
 #include "vtkMRMLVolumeSequenceStorageNode.h"
 
 #include "vtkMRMLScalarVolumeNode.h"
@@ -22,15 +29,206 @@ or http://www.slicer.org/copyright/copyright.txt for details.
 #include "vtkTeemNRRDReader.h"
 #include "vtkTeemNRRDWriter.h"
 #include "vtkObjectFactory.h"
+#include "vtkDataArray.h"
+#include "vtkFieldData.h"
 #include "vtkImageData.h"
 #ifndef NRRD_CHUNK_IO_AVAILABLE
 #include "vtkImageAppendComponents.h"
 #endif
 #include "vtkImageExtractComponents.h"
 #include "vtkNew.h"
+#include "vtkPointData.h"
 #include "vtkStringArray.h"
 #include "vtksys/SystemTools.hxx"
 
+namespace
+{
+
+/// Header field that stores the key frame interval of delta-encoded files
+const char* DeltaEncodingKeyFrameIntervalKey = "delta encoding key frame interval";
+
+//----------------------------------------------------------------------------
+template <class T>
+void AddFrameVoxelsTemplate(T* voxels, const T* otherVoxels, vtkIdType numberOfValues, bool subtract)
+{
+  // Integers are added with wrap-around, which makes decoding of the difference exact
+  typedef typename std::conditional<std::is_integral<T>::value,
+    std::make_unsigned<T>, std::common_type<T> >::type::type ValueType;
+  for (vtkIdType valueIndex = 0; valueIndex < numberOfValues; ++valueIndex)
+    {
+    ValueType value = static_cast<ValueType>(voxels[valueIndex]);
+    ValueType otherValue = static_cast<ValueType>(otherVoxels[valueIndex]);
+    voxels[valueIndex] = static_cast<T>(subtract ? value - otherValue : value + otherValue);
+    }
+}
+
+//----------------------------------------------------------------------------
+/// Add (or subtract) voxels of another frame of the same size and scalar type.
+/// Used for decoding (or computing) delta frames.
+bool AddFrameVoxels(vtkImageData* voxels, vtkImageData* otherVoxels, bool subtract)
+{
+  vtkDataArray* scalars = voxels ? voxels->GetPointData()->GetScalars() : nullptr;
+  vtkDataArray* otherScalars = otherVoxels ? otherVoxels->GetPointData()->GetScalars() : nullptr;
+  if (!scalars || !otherScalars || scalars->GetDataType() != otherScalars->GetDataType()
+    || scalars->GetNumberOfValues() != otherScalars->GetNumberOfValues())
+    {
+    return false;
+    }
+  vtkIdType numberOfValues = scalars->GetNumberOfValues();
+  switch (scalars->GetDataType())
+    {
+    vtkTemplateMacro(AddFrameVoxelsTemplate(static_cast<VTK_TT*>(scalars->GetVoidPointer(0)),
+      static_cast<VTK_TT*>(otherScalars->GetVoidPointer(0)), numberOfValues, subtract));
+    default:
+      return false;
+    }
+  scalars->Modified();
+  return true;
+}
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+/// Reads frames of a NRRD file by its own reader in a background thread.
+/// Read images are kept in a buffer until they are taken or they are not requested anymore.
+class vtkMRMLVolumeSequenceStorageNode::vtkFramePrefetcher
+{
+public:
+  vtkFramePrefetcher(const std::string& fileName, bool useNativeOrigin)
+    : FileName(fileName)
+    , UseNativeOrigin(useNativeOrigin)
+  {
+    this->Thread = std::thread(&vtkFramePrefetcher::Run, this);
+  }
+
+  ~vtkFramePrefetcher()
+  {
+    {
+    std::lock_guard<std::mutex> lock(this->Mutex);
+    this->StopRequested = true;
+    }
+    this->Condition.notify_all();
+    this->Thread.join();
+  }
+
+  /// Set frames that will be needed soon, in order of priority.
+  /// Buffered frames that are not in the list are discarded.
+  void SetRequestedFrames(const std::vector<int>& frameIndices)
+  {
+    {
+    std::lock_guard<std::mutex> lock(this->Mutex);
+    this->RequestedFrames = frameIndices;
+    for (std::map<int, vtkSmartPointer<vtkImageData> >::iterator bufferIt = this->Buffer.begin(); bufferIt != this->Buffer.end(); )
+      {
+      if (std::find(frameIndices.begin(), frameIndices.end(), bufferIt->first) == frameIndices.end())
+        {
+        bufferIt = this->Buffer.erase(bufferIt);
+        }
+      else
+        {
+        ++bufferIt;
+        }
+      }
+    }
+    this->Condition.notify_all();
+  }
+
+  /// Remove the frame from the buffer. Returns nullptr if the frame has not been read.
+  vtkSmartPointer<vtkImageData> TakeFrame(int frameIndex)
+  {
+    std::lock_guard<std::mutex> lock(this->Mutex);
+    std::map<int, vtkSmartPointer<vtkImageData> >::iterator bufferIt = this->Buffer.find(frameIndex);
+    if (bufferIt == this->Buffer.end())
+      {
+      return nullptr;
+      }
+    vtkSmartPointer<vtkImageData> frameVoxels = bufferIt->second;
+    this->Buffer.erase(bufferIt);
+    // Do not read it again
+    this->RequestedFrames.erase(std::remove(this->RequestedFrames.begin(), this->RequestedFrames.end(), frameIndex),
+      this->RequestedFrames.end());
+    return frameVoxels;
+  }
+
+protected:
+  /// Get the first requested frame that is not read yet. Must be called with locked mutex.
+  int GetNextFrameToRead()
+  {
+    for (int frameIndex : this->RequestedFrames)
+      {
+      if (this->Buffer.find(frameIndex) == this->Buffer.end())
+        {
+        return frameIndex;
+        }
+      }
+    return -1;
+  }
+
+  void Run()
+  {
+#ifdef NRRD_CHUNK_IO_AVAILABLE
+    vtkNew<vtkTeemNRRDReader> reader;
+    reader->SetFileName(this->FileName.c_str());
+    reader->ReadImageListAsMultipleImagesOn();
+    if (this->UseNativeOrigin)
+      {
+      reader->SetUseNativeOriginOn();
+      }
+    else
+      {
+      reader->SetUseNativeOriginOff();
+      }
+    reader->UpdateInformation();
+#endif
+    std::unique_lock<std::mutex> lock(this->Mutex);
+    while (!this->StopRequested)
+      {
+      int frameIndex = this->GetNextFrameToRead();
+      if (frameIndex < 0)
+        {
+        this->Condition.wait(lock);
+        continue;
+        }
+      lock.unlock();
+      vtkSmartPointer<vtkImageData> frameVoxels;
+#ifdef NRRD_CHUNK_IO_AVAILABLE
+      reader->SetCurrentImageIndex(frameIndex);
+      reader->Update();
+      vtkImageData* readVoxels = reader->GetOutput();
+      if (readVoxels != nullptr && readVoxels->GetPointData() != nullptr && readVoxels->GetPointData()->GetScalars() != nullptr)
+        {
+        frameVoxels = vtkSmartPointer<vtkImageData>::New();
+        frameVoxels->DeepCopy(readVoxels);
+        // Slicer expects normalized image position and spacing
+        frameVoxels->SetOrigin(0, 0, 0);
+        frameVoxels->SetSpacing(1, 1, 1);
+        }
+#endif
+      lock.lock();
+      if (!frameVoxels)
+        {
+        // Failed to read, the frame will be read on the main thread when needed
+        this->RequestedFrames.erase(std::remove(this->RequestedFrames.begin(), this->RequestedFrames.end(), frameIndex),
+          this->RequestedFrames.end());
+        continue;
+        }
+      if (std::find(this->RequestedFrames.begin(), this->RequestedFrames.end(), frameIndex) != this->RequestedFrames.end())
+        {
+        this->Buffer[frameIndex] = frameVoxels;
+        }
+      }
+  }
+
+  std::string FileName;
+  bool UseNativeOrigin;
+  std::thread Thread;
+  std::mutex Mutex;
+  std::condition_variable Condition;
+  bool StopRequested{false};
+  std::vector<int> RequestedFrames;
+  std::map<int, vtkSmartPointer<vtkImageData> > Buffer;
+};
+
 //----------------------------------------------------------------------------
 vtkMRMLNodeNewMacro(vtkMRMLVolumeSequenceStorageNode);
 
@@ -38,7 +236,75 @@ vtkMRMLNodeNewMacro(vtkMRMLVolumeSequenceStorageNode);
 vtkMRMLVolumeSequenceStorageNode::vtkMRMLVolumeSequenceStorageNode() = default;
 
 //----------------------------------------------------------------------------
-vtkMRMLVolumeSequenceStorageNode::~vtkMRMLVolumeSequenceStorageNode() = default;
+vtkMRMLVolumeSequenceStorageNode::~vtkMRMLVolumeSequenceStorageNode()
+{
+  delete this->Prefetcher;
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLVolumeSequenceStorageNode::WriteXML(ostream& of, int nIndent)
+{
+  Superclass::WriteXML(of, nIndent);
+  vtkMRMLWriteXMLBeginMacro(of);
+  vtkMRMLWriteXMLBooleanMacro(lazyLoading, LazyLoading);
+  vtkMRMLWriteXMLIntMacro(numberOfPrefetchedFrames, NumberOfPrefetchedFrames);
+  vtkMRMLWriteXMLBooleanMacro(backgroundPrefetch, BackgroundPrefetch);
+  vtkMRMLWriteXMLIntMacro(numberOfRetainedFrames, NumberOfRetainedFrames);
+  vtkMRMLWriteXMLBooleanMacro(deltaEncoding, DeltaEncoding);
+  vtkMRMLWriteXMLIntMacro(keyFrameInterval, KeyFrameInterval);
+  vtkMRMLWriteXMLBooleanMacro(contiguousFrameBuffer, ContiguousFrameBuffer);
+  vtkMRMLWriteXMLEndMacro();
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLVolumeSequenceStorageNode::ReadXMLAttributes(const char** atts)
+{
+  int disabledModify = this->StartModify();
+  Superclass::ReadXMLAttributes(atts);
+  vtkMRMLReadXMLBeginMacro(atts);
+  vtkMRMLReadXMLBooleanMacro(lazyLoading, LazyLoading);
+  vtkMRMLReadXMLIntMacro(numberOfPrefetchedFrames, NumberOfPrefetchedFrames);
+  vtkMRMLReadXMLBooleanMacro(backgroundPrefetch, BackgroundPrefetch);
+  vtkMRMLReadXMLIntMacro(numberOfRetainedFrames, NumberOfRetainedFrames);
+  vtkMRMLReadXMLBooleanMacro(deltaEncoding, DeltaEncoding);
+  vtkMRMLReadXMLIntMacro(keyFrameInterval, KeyFrameInterval);
+  vtkMRMLReadXMLBooleanMacro(contiguousFrameBuffer, ContiguousFrameBuffer);
+  vtkMRMLReadXMLEndMacro();
+  this->EndModify(disabledModify);
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLVolumeSequenceStorageNode::Copy(vtkMRMLNode *anode)
+{
+  int disabledModify = this->StartModify();
+  Superclass::Copy(anode);
+  vtkMRMLCopyBeginMacro(anode);
+  vtkMRMLCopyBooleanMacro(LazyLoading);
+  vtkMRMLCopyIntMacro(NumberOfPrefetchedFrames);
+  vtkMRMLCopyBooleanMacro(BackgroundPrefetch);
+  vtkMRMLCopyIntMacro(NumberOfRetainedFrames);
+  vtkMRMLCopyBooleanMacro(DeltaEncoding);
+  vtkMRMLCopyIntMacro(KeyFrameInterval);
+  vtkMRMLCopyBooleanMacro(ContiguousFrameBuffer);
+  vtkMRMLCopyEndMacro();
+  this->EndModify(disabledModify);
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLVolumeSequenceStorageNode::PrintSelf(ostream& os, vtkIndent indent)
+{
+  Superclass::PrintSelf(os,indent);
+  vtkMRMLPrintBeginMacro(os, indent);
+  vtkMRMLPrintBooleanMacro(LazyLoading);
+  vtkMRMLPrintIntMacro(NumberOfPrefetchedFrames);
+  vtkMRMLPrintBooleanMacro(BackgroundPrefetch);
+  vtkMRMLPrintIntMacro(NumberOfRetainedFrames);
+  vtkMRMLPrintBooleanMacro(DeltaEncoding);
+  vtkMRMLPrintIntMacro(KeyFrameInterval);
+  vtkMRMLPrintBooleanMacro(ContiguousFrameBuffer);
+  vtkMRMLPrintEndMacro();
+  os << indent << "Number of loaded frames: " << this->LoadedFrameIndices.size() << "\n";
+}
 
 //----------------------------------------------------------------------------
 bool vtkMRMLVolumeSequenceStorageNode::CanReadInReferenceNode(vtkMRMLNode *refNode)
@@ -61,6 +327,16 @@ int vtkMRMLVolumeSequenceStorageNode::ReadDataInternal(vtkMRMLNode* refNode)
     return 0;
     }
 
+  // Forget frames of previous reads
+  delete this->Prefetcher;
+  this->Prefetcher = nullptr;
+  this->LastRequestedFrameIndex = -1;
+  this->PrefetchStep = 1;
+  this->FrameReader = nullptr;
+  this->FrameStructure = nullptr;
+  this->Frames.clear();
+  this->LoadedFrameIndices.clear();
+
   std::string fullName = this->GetFullNameFromFileName();
   if (fullName == std::string(""))
     {
@@ -83,6 +359,8 @@ int vtkMRMLVolumeSequenceStorageNode::ReadDataInternal(vtkMRMLNode* refNode)
   // If the data are compressed, this will return false and
   // the data will be read as a single multi-component image
   bool readAsMultipleImagesOn = reader->ReadImageListAsMultipleImagesOn();
+  // Frames can only be read on demand if they can be read separately
+  bool lazyLoading = this->LazyLoading && readAsMultipleImagesOn;
 #endif
 
   // Set up reader
@@ -104,6 +382,8 @@ int vtkMRMLVolumeSequenceStorageNode::ReadDataInternal(vtkMRMLNode* refNode)
   typedef std::vector<std::string> KeyVector;
   KeyVector keys = reader->GetHeaderKeysVector();
   int frameAxis = 0;
+  // Non-zero if frames are delta encoded
+  int keyFrameInterval = 0;
   for ( KeyVector::iterator kit = keys.begin(); kit != keys.end(); ++kit)
     {
 #ifdef NRRD_CHUNK_IO_AVAILABLE
@@ -142,11 +422,23 @@ int vtkMRMLVolumeSequenceStorageNode::ReadDataInternal(vtkMRMLNode* refNode)
         }
 #endif
       }
+    else if (*kit == DeltaEncodingKeyFrameIntervalKey)
+      {
+      keyFrameInterval = std::max(0, atoi(reader->GetHeaderValue((*kit).c_str())));
+      }
     else
       {
       volSequenceNode->SetAttribute((*kit).c_str(), reader->GetHeaderValue((*kit).c_str()));
       }
     }
+#ifdef NRRD_CHUNK_IO_AVAILABLE
+  if (keyFrameInterval > 0 || this->ContiguousFrameBuffer)
+    {
+    // Delta frames can only be decoded from the previous frame
+    // and the frame buffer can only be filled if all frames are read
+    lazyLoading = false;
+    }
+#endif
 
   const char* sequenceAxisLabel = reader->GetAxisLabel(frameAxis);
   volSequenceNode->SetIndexName(sequenceAxisLabel ? sequenceAxisLabel : "frame");
@@ -186,12 +478,21 @@ int vtkMRMLVolumeSequenceStorageNode::ReadDataInternal(vtkMRMLNode* refNode)
 #endif
 
   vtkDebugMacro(<< " vtkMRMLVolumeSequenceStorageNode::ReadDataInternal: Starting reading sequence. ");
+  vtkImageData* previousFrameVoxels = nullptr;
+  std::vector<vtkImageData*> storedFrameVoxels;
   for (int frameIndex = 0; frameIndex < numberOfFrames; ++frameIndex)
     {
     vtkDebugMacro(<< " reading frame : "<<frameIndex);
 #ifdef NRRD_CHUNK_IO_AVAILABLE
     vtkImageData *frameVoxels = nullptr;
-    if (readAsMultipleImagesOn)
+    vtkNew<vtkImageData> notLoadedFrameVoxels;
+    if (lazyLoading && frameIndex > 0)
+      {
+      // Only geometry is set now, voxels are read when the frame is requested
+      notLoadedFrameVoxels->CopyStructure(this->FrameStructure);
+      frameVoxels = notLoadedFrameVoxels;
+      }
+    else if (readAsMultipleImagesOn)
       {
       reader->SetCurrentImageIndex(frameIndex);
       reader->Update();
@@ -214,6 +515,13 @@ int vtkMRMLVolumeSequenceStorageNode::ReadDataInternal(vtkMRMLNode* refNode)
     // Slicer expects normalized image position and spacing
     frameVoxels->SetOrigin(0, 0, 0);
     frameVoxels->SetSpacing(1, 1, 1);
+#ifdef NRRD_CHUNK_IO_AVAILABLE
+    if (lazyLoading && frameIndex == 0)
+      {
+      this->FrameStructure = vtkSmartPointer<vtkImageData>::New();
+      this->FrameStructure->CopyStructure(frameVoxels);
+      }
+#endif
     vtkNew<vtkMRMLScalarVolumeNode> frameVolume;
 #ifdef NRRD_CHUNK_IO_AVAILABLE
     frameVolume->SetAndObserveImageData(frameVoxels);
@@ -221,6 +529,12 @@ int vtkMRMLVolumeSequenceStorageNode::ReadDataInternal(vtkMRMLNode* refNode)
     frameVolume->SetAndObserveImageData(frameVoxels.GetPointer());
 #endif
     frameVolume->SetRASToIJKMatrix(reader->GetRasToIjkMatrix());
+    if (keyFrameInterval > 0 && frameIndex % keyFrameInterval != 0
+      && !AddFrameVoxels(frameVolume->GetImageData(), previousFrameVoxels, false))
+      {
+      vtkErrorMacro("vtkMRMLVolumeSequenceStorageNode::ReadDataInternal: failed to decode delta frame " << frameIndex);
+      return 0;
+      }
 
     std::ostringstream indexStr;
     if (static_cast<int>(indexValues.size()) > frameIndex)
@@ -235,7 +549,39 @@ int vtkMRMLVolumeSequenceStorageNode::ReadDataInternal(vtkMRMLNode* refNode)
     std::ostringstream nameStr;
     nameStr << refNode->GetName() << "_" << std::setw(4) << std::setfill('0') << frameIndex << std::ends;
     frameVolume->SetName( nameStr.str().c_str() );
-    volSequenceNode->SetDataNodeAtValue(frameVolume.GetPointer(), indexStr.str().c_str() );
+    vtkMRMLNode* addedFrameVolume = volSequenceNode->SetDataNodeAtValue(frameVolume.GetPointer(), indexStr.str().c_str() );
+    // Decoded voxels of the stored frame are needed for decoding the next frame
+    previousFrameVoxels = vtkMRMLVolumeNode::SafeDownCast(addedFrameVolume) ?
+      vtkMRMLVolumeNode::SafeDownCast(addedFrameVolume)->GetImageData() : nullptr;
+    storedFrameVoxels.push_back(previousFrameVoxels);
+#ifdef NRRD_CHUNK_IO_AVAILABLE
+    if (lazyLoading)
+      {
+      FrameInfo frame;
+      frame.VolumeNode = vtkMRMLVolumeNode::SafeDownCast(addedFrameVolume);
+      if (frameIndex == 0 && frame.VolumeNode && frame.VolumeNode->GetImageData())
+        {
+        frame.Loaded = true;
+        frame.LoadedImageMTime = frame.VolumeNode->GetImageData()->GetMTime();
+        this->LoadedFrameIndices.push_back(frameIndex);
+        }
+      this->Frames.push_back(frame);
+      }
+#endif
+    }
+
+#ifdef NRRD_CHUNK_IO_AVAILABLE
+  if (lazyLoading)
+    {
+    // Keep the reader for reading the other frames later
+    this->FrameReader = reader.GetPointer();
+    }
+#endif
+
+  if (this->ContiguousFrameBuffer && !this->MoveFramesToContiguousBuffer(storedFrameVoxels))
+    {
+    vtkWarningMacro("vtkMRMLVolumeSequenceStorageNode::ReadDataInternal: frames are not stored in a contiguous buffer"
+      " because their size or scalar type is different");
     }
 
   vtkDebugMacro(<< " vtkMRMLVolumeSequenceStorageNode::ReadDataInternal: sequence successfully read. ");
@@ -278,6 +624,10 @@ bool vtkMRMLVolumeSequenceStorageNode::CanWriteFromReferenceNode(vtkMRMLNode *re
   vtkNew<vtkMatrix4x4> firstVolumeIjkToRas;
   firstFrameVolume->GetIJKToRASMatrix(firstVolumeIjkToRas.GetPointer());
 
+  // Frames that are not loaded yet only have geometry, their voxels will be read from the same file
+  vtkMRMLVolumeSequenceStorageNode* lazyStorageNode =
+    vtkMRMLVolumeSequenceStorageNode::SafeDownCast(volSequenceNode->GetStorageNode());
+
   int numberOfFrameVolumes = volSequenceNode->GetNumberOfDataNodes();
   for (int frameIndex = 1; frameIndex<numberOfFrameVolumes; frameIndex++)
     {
@@ -304,8 +654,16 @@ bool vtkMRMLVolumeSequenceStorageNode::CanWriteFromReferenceNode(vtkMRMLNode *re
     if (currentFrameVolume->GetImageData())
       {
       currentFrameVolume->GetImageData()->GetExtent(currentFrameVolumeExtent);
-      currentFrameVolumeScalarType = currentFrameVolume->GetImageData()->GetScalarType();
-      currentFrameVolumeNumberOfComponents = currentFrameVolume->GetImageData()->GetNumberOfScalarComponents();
+      if (lazyStorageNode && !lazyStorageNode->IsFrameLoaded(currentFrameVolume))
+        {
+        currentFrameVolumeScalarType = firstFrameVolumeScalarType;
+        currentFrameVolumeNumberOfComponents = firstFrameVolumeNumberOfComponents;
+        }
+      else
+        {
+        currentFrameVolumeScalarType = currentFrameVolume->GetImageData()->GetScalarType();
+        currentFrameVolumeNumberOfComponents = currentFrameVolume->GetImageData()->GetNumberOfScalarComponents();
+        }
       }
     for (int i = 0; i < 6; i++)
       {
@@ -344,6 +702,15 @@ int vtkMRMLVolumeSequenceStorageNode::WriteDataInternal(vtkMRMLNode *refNode)
     return 0;
     }
 
+  // Read frames that have not been loaded yet, they must be written, too
+  vtkMRMLVolumeSequenceStorageNode* lazyStorageNode =
+    vtkMRMLVolumeSequenceStorageNode::SafeDownCast(volSequenceNode->GetStorageNode());
+  if (lazyStorageNode && !lazyStorageNode->LoadAllFrames())
+    {
+    this->GetUserMessages()->AddMessage(vtkCommand::ErrorEvent, std::string("Failed to read all frames of the sequence."));
+    return 0;
+    }
+
   vtkNew<vtkMatrix4x4> firstVolumeIjkToRas;
   int frameVolumeDimensions[3] = {0};
   int frameVolumeScalarType = VTK_VOID;
@@ -364,8 +731,19 @@ int vtkMRMLVolumeSequenceStorageNode::WriteDataInternal(vtkMRMLNode *refNode)
       }
     }
 
+  // Non-zero if frames are delta encoded. Floating point voxels are not,
+  // as their differences could not be decoded exactly.
+  int keyFrameInterval = 0;
+  if (this->DeltaEncoding && this->KeyFrameInterval > 1 && numberOfFrameVolumes > 1
+    && frameVolumeScalarType != VTK_VOID && frameVolumeScalarType != VTK_FLOAT && frameVolumeScalarType != VTK_DOUBLE)
+    {
+    keyFrameInterval = this->KeyFrameInterval;
+    }
+  vtkImageData* previousFrameVoxels = nullptr;
+
 #ifndef NRRD_CHUNK_IO_AVAILABLE
   vtkNew<vtkImageAppendComponents> appender;
+  std::vector<vtkSmartPointer<vtkImageData> > deltaFramesVoxels;
   for (int frameIndex=0; frameIndex<numberOfFrameVolumes; frameIndex++)
     {
     vtkMRMLVolumeNode* frameVolume = vtkMRMLVolumeNode::SafeDownCast(volSequenceNode->GetNthDataNode(frameIndex));
@@ -409,9 +787,19 @@ int vtkMRMLVolumeSequenceStorageNode::WriteDataInternal(vtkMRMLNode *refNode)
       this->GetUserMessages()->AddMessage(vtkCommand::ErrorEvent, std::string("Size and scalar type of all volumes in the sequence must be the same."));
       return 0;
      }
-    if (frameVolume->GetImageData())
+    vtkImageData* frameVoxels = frameVolume->GetImageData();
+    if (frameVoxels && keyFrameInterval > 0 && frameIndex % keyFrameInterval != 0)
       {
-      appender->AddInputData(frameVolume->GetImageData());
+      vtkSmartPointer<vtkImageData> deltaFrameVoxels = vtkSmartPointer<vtkImageData>::New();
+      deltaFrameVoxels->DeepCopy(frameVoxels);
+      AddFrameVoxels(deltaFrameVoxels, previousFrameVoxels, true);
+      deltaFramesVoxels.push_back(deltaFrameVoxels);
+      frameVoxels = deltaFrameVoxels;
+      }
+    previousFrameVoxels = frameVolume->GetImageData();
+    if (frameVoxels)
+      {
+      appender->AddInputData(frameVoxels);
       }
   }
 #endif
@@ -487,12 +875,24 @@ int vtkMRMLVolumeSequenceStorageNode::WriteDataInternal(vtkMRMLNode *refNode)
   std::vector<std::string>::iterator ait = attributeNames.begin();
   for (; ait != attributeNames.end(); ++ait)
     {
+    if (*ait == DeltaEncodingKeyFrameIntervalKey)
+      {
+      // reserved for the encoding of this file
+      continue;
+      }
     writer->SetAttribute((*ait), volSequenceNode->GetAttribute((*ait).c_str()));
     }
+  if (keyFrameInterval > 0)
+    {
+    std::ostringstream keyFrameIntervalStr;
+    keyFrameIntervalStr << keyFrameInterval;
+    writer->SetAttribute(DeltaEncodingKeyFrameIntervalKey, keyFrameIntervalStr.str());
+    }
 
 #ifdef NRRD_CHUNK_IO_AVAILABLE
   writer->SetNumberOfImages(numberOfFrameVolumes);
   int writeFlag = 1;
+  vtkNew<vtkImageData> deltaFrameVoxels;
   vtkDebugMacro(<< " vtkMRMLVolumeSequenceStorageNode::WriteDataInternal: Starting writing sequence. ");
   for (int frameIndex = 0; frameIndex < numberOfFrameVolumes; ++frameIndex)
     {
@@ -546,7 +946,17 @@ int vtkMRMLVolumeSequenceStorageNode::WriteDataInternal(vtkMRMLNode *refNode)
       return 0;
       }
 
-    writer->SetInputDataObject(frameVolume->GetImageData());
+    vtkImageData* frameVoxels = frameVolume->GetImageData();
+    if (keyFrameInterval > 0 && frameIndex % keyFrameInterval != 0)
+      {
+      // Write difference from the previous frame
+      deltaFrameVoxels->DeepCopy(frameVoxels);
+      AddFrameVoxels(deltaFrameVoxels, previousFrameVoxels, true);
+      frameVoxels = deltaFrameVoxels;
+      }
+    previousFrameVoxels = frameVolume->GetImageData();
+
+    writer->SetInputDataObject(frameVoxels);
     writer->SetCurrentImageIndex(frameIndex);
 
     writer->Write();
@@ -585,6 +995,301 @@ int vtkMRMLVolumeSequenceStorageNode::WriteDataInternal(vtkMRMLNode *refNode)
   return writeFlag;
 }
 
+//----------------------------------------------------------------------------
+int vtkMRMLVolumeSequenceStorageNode::GetFrameIndex(vtkMRMLNode* dataNode)
+{
+  if (!dataNode)
+    {
+    return -1;
+    }
+  for (int frameIndex = 0; frameIndex < static_cast<int>(this->Frames.size()); ++frameIndex)
+    {
+    if (this->Frames[frameIndex].VolumeNode.GetPointer() == dataNode)
+      {
+      return frameIndex;
+      }
+    }
+  return -1;
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLVolumeSequenceStorageNode::IsFrameLoaded(vtkMRMLNode* dataNode)
+{
+  int frameIndex = this->GetFrameIndex(dataNode);
+  if (frameIndex < 0)
+    {
+    // not managed by this storage node, voxels are in memory
+    return true;
+    }
+  return this->Frames[frameIndex].Loaded;
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLVolumeSequenceStorageNode::LoadFrame(vtkMRMLNode* dataNode)
+{
+  int frameIndex = this->GetFrameIndex(dataNode);
+  if (frameIndex < 0)
+    {
+    return true;
+    }
+  std::vector<int> prefetchedFrameIndices;
+  this->GetFramesToPrefetch(frameIndex, prefetchedFrameIndices);
+
+  std::vector<int> requestedFrameIndices;
+  bool success = this->ReadFrame(frameIndex);
+  requestedFrameIndices.push_back(frameIndex);
+  if (this->BackgroundPrefetch && this->FrameReader && this->FrameReader->GetFileName())
+    {
+    if (!this->Prefetcher)
+      {
+      this->Prefetcher = new vtkFramePrefetcher(this->FrameReader->GetFileName(), !this->CenterImage);
+      }
+    std::vector<int> notLoadedFrameIndices;
+    for (int prefetchedFrameIndex : prefetchedFrameIndices)
+      {
+      if (!this->Frames[prefetchedFrameIndex].Loaded)
+        {
+        notLoadedFrameIndices.push_back(prefetchedFrameIndex);
+        }
+      }
+    this->Prefetcher->SetRequestedFrames(notLoadedFrameIndices);
+    }
+  else
+    {
+    for (int prefetchedFrameIndex : prefetchedFrameIndices)
+      {
+      this->ReadFrame(prefetchedFrameIndex);
+      requestedFrameIndices.push_back(prefetchedFrameIndex);
+      }
+    }
+  this->ReleaseFrames(requestedFrameIndices);
+  return success;
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLVolumeSequenceStorageNode::GetFramesToPrefetch(int frameIndex, std::vector<int>& prefetchedFrameIndices)
+{
+  prefetchedFrameIndices.clear();
+  int numberOfFrames = static_cast<int>(this->Frames.size());
+  if (numberOfFrames < 2)
+    {
+    return;
+    }
+  if (this->LastRequestedFrameIndex >= 0 && frameIndex != this->LastRequestedFrameIndex)
+    {
+    int step = frameIndex - this->LastRequestedFrameIndex;
+    // Jump from the end to the beginning (or the other way) is a step of looped playback
+    if (step > numberOfFrames / 2)
+      {
+      step -= numberOfFrames;
+      }
+    else if (step < -numberOfFrames / 2)
+      {
+      step += numberOfFrames;
+      }
+    if (step != 0)
+      {
+      this->PrefetchStep = step;
+      }
+    }
+  this->LastRequestedFrameIndex = frameIndex;
+
+  for (int prefetchCount = 1; prefetchCount <= this->NumberOfPrefetchedFrames; ++prefetchCount)
+    {
+    int prefetchedFrameIndex = ((frameIndex + prefetchCount * this->PrefetchStep) % numberOfFrames + numberOfFrames) % numberOfFrames;
+    if (prefetchedFrameIndex == frameIndex
+      || std::find(prefetchedFrameIndices.begin(), prefetchedFrameIndices.end(), prefetchedFrameIndex) != prefetchedFrameIndices.end())
+      {
+      // all frames are prefetched already
+      break;
+      }
+    prefetchedFrameIndices.push_back(prefetchedFrameIndex);
+    }
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLVolumeSequenceStorageNode::LoadAllFrames()
+{
+  bool success = true;
+  for (int frameIndex = 0; frameIndex < static_cast<int>(this->Frames.size()); ++frameIndex)
+    {
+    if (!this->Frames[frameIndex].Loaded && this->Frames[frameIndex].VolumeNode)
+      {
+      success = this->ReadFrame(frameIndex) && success;
+      }
+    }
+  return success;
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLVolumeSequenceStorageNode::ReadFrame(int frameIndex)
+{
+  FrameInfo& frame = this->Frames[frameIndex];
+  if (!frame.VolumeNode)
+    {
+    // frame has been removed from the sequence
+    return false;
+    }
+  if (!frame.Loaded)
+    {
+#ifdef NRRD_CHUNK_IO_AVAILABLE
+    if (!this->FrameReader)
+      {
+      return false;
+      }
+    // Use the frame that was read in the background if available, then only the image pointer has to be swapped
+    vtkSmartPointer<vtkImageData> frameVoxels;
+    if (this->Prefetcher)
+      {
+      frameVoxels = this->Prefetcher->TakeFrame(frameIndex);
+      }
+    if (!frameVoxels)
+      {
+      this->FrameReader->SetCurrentImageIndex(frameIndex);
+      this->FrameReader->Update();
+      vtkImageData* readVoxels = this->FrameReader->GetOutput();
+      if (readVoxels == nullptr || readVoxels->GetPointData() == nullptr || readVoxels->GetPointData()->GetScalars() == nullptr)
+        {
+        vtkErrorMacro("vtkMRMLVolumeSequenceStorageNode::ReadFrame: failed to read frame " << frameIndex
+          << " from " << (this->FrameReader->GetFileName() ? this->FrameReader->GetFileName() : "(none)"));
+        return false;
+        }
+      frameVoxels = vtkSmartPointer<vtkImageData>::New();
+      frameVoxels->DeepCopy(readVoxels);
+      // Slicer expects normalized image position and spacing
+      frameVoxels->SetOrigin(0, 0, 0);
+      frameVoxels->SetSpacing(1, 1, 1);
+      }
+    frame.VolumeNode->SetAndObserveImageData(frameVoxels);
+    frame.Loaded = true;
+    frame.LoadedImageMTime = frameVoxels->GetMTime();
+#else
+    return false;
+#endif
+    }
+  else if (frame.Modified)
+    {
+    // not in the recently used list anymore, never released
+    return true;
+    }
+
+  // Move to the end of the recently used list
+  std::deque<int>::iterator loadedFrameIt = std::find(this->LoadedFrameIndices.begin(), this->LoadedFrameIndices.end(), frameIndex);
+  if (loadedFrameIt != this->LoadedFrameIndices.end())
+    {
+    this->LoadedFrameIndices.erase(loadedFrameIt);
+    }
+  this->LoadedFrameIndices.push_back(frameIndex);
+  return true;
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLVolumeSequenceStorageNode::ReleaseFrames(const std::vector<int>& protectedFrameIndices)
+{
+  std::deque<int>::iterator loadedFrameIt = this->LoadedFrameIndices.begin();
+  while (static_cast<int>(this->LoadedFrameIndices.size()) > this->NumberOfRetainedFrames
+    && loadedFrameIt != this->LoadedFrameIndices.end())
+    {
+    int frameIndex = *loadedFrameIt;
+    FrameInfo& frame = this->Frames[frameIndex];
+    vtkImageData* frameVoxels = frame.VolumeNode ? frame.VolumeNode->GetImageData() : nullptr;
+    if (frameVoxels && frameVoxels->GetMTime() != frame.LoadedImageMTime)
+      {
+      // voxels have been modified, keep them
+      frame.Modified = true;
+      loadedFrameIt = this->LoadedFrameIndices.erase(loadedFrameIt);
+      continue;
+      }
+    if (frameIndex == 0 || std::find(protectedFrameIndices.begin(), protectedFrameIndices.end(), frameIndex) != protectedFrameIndices.end())
+      {
+      // first frame is kept as reference for scalar type, requested frames are in use
+      ++loadedFrameIt;
+      continue;
+      }
+    if (frame.VolumeNode)
+      {
+      vtkNew<vtkImageData> notLoadedFrameVoxels;
+      notLoadedFrameVoxels->CopyStructure(this->FrameStructure);
+      frame.VolumeNode->SetAndObserveImageData(notLoadedFrameVoxels);
+      frame.LoadedImageMTime = 0;
+      }
+    frame.Loaded = false;
+    loadedFrameIt = this->LoadedFrameIndices.erase(loadedFrameIt);
+    }
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLVolumeSequenceStorageNode::MoveFramesToContiguousBuffer(const std::vector<vtkImageData*>& frameImages)
+{
+  if (frameImages.empty() || !frameImages[0] || !frameImages[0]->GetPointData()->GetScalars())
+    {
+    return false;
+    }
+  vtkDataArray* firstScalars = frameImages[0]->GetPointData()->GetScalars();
+  vtkIdType numberOfTuplesPerFrame = firstScalars->GetNumberOfTuples();
+  for (vtkImageData* frameImage : frameImages)
+    {
+    vtkDataArray* scalars = frameImage ? frameImage->GetPointData()->GetScalars() : nullptr;
+    if (!scalars || scalars->GetDataType() != firstScalars->GetDataType()
+      || scalars->GetNumberOfComponents() != firstScalars->GetNumberOfComponents()
+      || scalars->GetNumberOfTuples() != numberOfTuplesPerFrame)
+      {
+      return false;
+      }
+    }
+
+  vtkSmartPointer<vtkDataArray> frameBuffer = vtkSmartPointer<vtkDataArray>::Take(
+    vtkDataArray::CreateDataArray(firstScalars->GetDataType()));
+  frameBuffer->SetName(vtkMRMLVolumeSequenceStorageNode::GetFrameBufferArrayName());
+  frameBuffer->SetNumberOfComponents(firstScalars->GetNumberOfComponents());
+  frameBuffer->SetNumberOfTuples(numberOfTuplesPerFrame * static_cast<vtkIdType>(frameImages.size()));
+  vtkIdType numberOfValuesPerFrame = firstScalars->GetNumberOfValues();
+  size_t frameSizeInBytes = static_cast<size_t>(numberOfValuesPerFrame) * firstScalars->GetDataTypeSize();
+
+  for (size_t frameIndex = 0; frameIndex < frameImages.size(); ++frameIndex)
+    {
+    vtkImageData* frameImage = frameImages[frameIndex];
+    vtkDataArray* scalars = frameImage->GetPointData()->GetScalars();
+    void* frameVoxels = frameBuffer->GetVoidPointer(static_cast<vtkIdType>(frameIndex) * numberOfValuesPerFrame);
+    memcpy(frameVoxels, scalars->GetVoidPointer(0), frameSizeInBytes);
+
+    // The frame scalars do not own their memory, the buffer is kept alive by the field data
+    // of the image (which is shared by shallow copies, such as the proxy node's image).
+    vtkSmartPointer<vtkDataArray> frameScalars = vtkSmartPointer<vtkDataArray>::Take(scalars->NewInstance());
+    frameScalars->SetName(scalars->GetName());
+    frameScalars->SetNumberOfComponents(scalars->GetNumberOfComponents());
+    frameScalars->SetVoidArray(frameVoxels, numberOfValuesPerFrame, 1);
+    frameImage->GetPointData()->SetScalars(frameScalars);
+    frameImage->GetFieldData()->RemoveArray(vtkMRMLVolumeSequenceStorageNode::GetFrameBufferArrayName());
+    frameImage->GetFieldData()->AddArray(frameBuffer);
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+vtkDataArray* vtkMRMLVolumeSequenceStorageNode::GetFrameBuffer(vtkImageData* frameImage)
+{
+  if (!frameImage || !frameImage->GetFieldData() || !frameImage->GetPointData()->GetScalars())
+    {
+    return nullptr;
+    }
+  vtkDataArray* frameBuffer = frameImage->GetFieldData()->GetArray(vtkMRMLVolumeSequenceStorageNode::GetFrameBufferArrayName());
+  if (!frameBuffer)
+    {
+    return nullptr;
+    }
+  // Make sure that the scalars still refer to the buffer
+  vtkDataArray* scalars = frameImage->GetPointData()->GetScalars();
+  const char* bufferBegin = static_cast<const char*>(frameBuffer->GetVoidPointer(0));
+  const char* bufferEnd = bufferBegin + static_cast<size_t>(frameBuffer->GetNumberOfValues()) * frameBuffer->GetDataTypeSize();
+  const char* scalarsBegin = static_cast<const char*>(scalars->GetVoidPointer(0));
+  if (scalars->GetDataType() != frameBuffer->GetDataType() || scalarsBegin < bufferBegin || scalarsBegin >= bufferEnd)
+    {
+    return nullptr;
+    }
+  return frameBuffer;
+}
+
 //----------------------------------------------------------------------------
 void vtkMRMLVolumeSequenceStorageNode::InitializeSupportedReadFileTypes()
 {
@@ -16,7 +16,20 @@
 #include "vtkMRML.h"
 
 #include "vtkMRMLNRRDStorageNode.h"
+
+// VTK includes
+#include <vtkSmartPointer.h>
+#include <vtkWeakPointer.h>
+
+// STD includes
+#include <deque>
 #include <string>
+#include <vector>
+
+class vtkDataArray;
+class vtkImageData;
+class vtkMRMLVolumeNode;
+class vtkTeemNRRDReader;
 
 /// \ingroup Slicer_QtModules_Sequences
 class VTK_MRML_EXPORT vtkMRMLVolumeSequenceStorageNode : public vtkMRMLNRRDStorageNode
@@ -28,6 +41,17 @@ class VTK_MRML_EXPORT vtkMRMLVolumeSequenceStorageNode : public vtkMRMLNRRDStora
 
   vtkMRMLNode* CreateNodeInstance() override;
 
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  /// Read node attributes from XML file
+  void ReadXMLAttributes( const char** atts) override;
+
+  /// Write this node's information to a MRML file in XML format.
+  void WriteXML(ostream& of, int indent) override;
+
+  /// Copy the node's attributes to this object
+  void Copy(vtkMRMLNode *node) override;
+
   ///
   /// Get node XML tag name (like Storage, Model)
   const char* GetNodeTagName() override {return "VolumeSequenceStorage";};
@@ -55,6 +79,91 @@ class VTK_MRML_EXPORT vtkMRMLVolumeSequenceStorageNode : public vtkMRMLNRRDStora
   /// Return a default file extension for writting
   const char* GetDefaultWriteFileExtension() override;
 
+  /// If enabled then voxels of frames are only read from file when they are requested
+  /// by LoadFrame (typically when a sequence browser selects the frame).
+  /// Only the first frame is read when the sequence is loaded, the other frames are
+  /// empty images with the correct geometry until they are loaded.
+  /// Only used if the file allows reading frames separately (uncompressed, frame axis is the last),
+  /// otherwise all frames are read.
+  /// Default is off.
+  vtkSetMacro(LazyLoading, bool);
+  vtkGetMacro(LazyLoading, bool);
+  vtkBooleanMacro(LazyLoading, bool);
+
+  /// Number of frames following the requested frame that are read along with it.
+  /// Frames are followed in the direction and with the step size of the last two
+  /// requests (the direction and item skipping of the playback) and wrap around
+  /// at the end of the sequence.
+  /// Default is 0.
+  vtkSetClampMacro(NumberOfPrefetchedFrames, int, 0, VTK_INT_MAX);
+  vtkGetMacro(NumberOfPrefetchedFrames, int);
+
+  /// If enabled then prefetched frames are read by a background thread into a buffer
+  /// and they are only swapped into the frame volume nodes when they are requested.
+  /// This avoids reading files on the main thread during playback.
+  /// If disabled then prefetched frames are read along with the requested frame.
+  /// Default is off.
+  vtkSetMacro(BackgroundPrefetch, bool);
+  vtkGetMacro(BackgroundPrefetch, bool);
+  vtkBooleanMacro(BackgroundPrefetch, bool);
+
+  /// Maximum number of lazily loaded frames that are kept in memory.
+  /// Least recently requested frames are released when the limit is exceeded.
+  /// The first frame and frames that have been modified since they were read are never released.
+  /// Default is 10.
+  vtkSetClampMacro(NumberOfRetainedFrames, int, 1, VTK_INT_MAX);
+  vtkGetMacro(NumberOfRetainedFrames, int);
+
+  /// If enabled then frames are written as key frames and delta frames:
+  /// every KeyFrameInterval-th frame is written as is, the others as the voxelwise
+  /// difference from the previous frame. Delta frames of slowly changing sequences
+  /// (such as segmentations over time) are mostly zero and compress very well.
+  /// Delta-encoded files are decoded when read (such files are always read completely,
+  /// regardless of LazyLoading). Only integer voxel types are delta encoded, as decoding
+  /// must restore the exact voxel values.
+  /// Default is off.
+  vtkSetMacro(DeltaEncoding, bool);
+  vtkGetMacro(DeltaEncoding, bool);
+  vtkBooleanMacro(DeltaEncoding, bool);
+
+  /// Number of frames from one key frame to the next when DeltaEncoding is enabled.
+  /// Default is 10.
+  vtkSetClampMacro(KeyFrameInterval, int, 1, VTK_INT_MAX);
+  vtkGetMacro(KeyFrameInterval, int);
+
+  /// If enabled then voxels of all frames are stored in a single contiguous buffer
+  /// after reading, one frame after the other, and the image of each frame volume
+  /// refers to its part of the buffer. This allows computing voxel time curves
+  /// with sequential memory access. The buffer can be retrieved from any of the
+  /// frame images by GetFrameBuffer.
+  /// Frames are always read completely if enabled (LazyLoading is ignored).
+  /// Only used if all frames have the same size and scalar type.
+  /// Default is off.
+  vtkSetMacro(ContiguousFrameBuffer, bool);
+  vtkGetMacro(ContiguousFrameBuffer, bool);
+  vtkBooleanMacro(ContiguousFrameBuffer, bool);
+
+  /// Get the buffer that stores voxels of all frames, if the image is a frame
+  /// that was read with ContiguousFrameBuffer enabled. Values of frame i start at
+  /// i * (number of values of the image). Returns nullptr if the image does not
+  /// refer to a frame buffer (for example, because its scalars have been replaced).
+  static vtkDataArray* GetFrameBuffer(vtkImageData* frameImage);
+
+  /// Name of the field data array of frame images that keeps the frame buffer.
+  static const char* GetFrameBufferArrayName() { return "SequenceFrameBuffer"; };
+
+  /// Make sure that voxels of the data node are loaded.
+  /// No-op if the node was not lazily loaded by this storage node.
+  /// Returns false if reading failed.
+  bool LoadFrame(vtkMRMLNode* dataNode);
+
+  /// Read all frames that have not been loaded yet.
+  /// Returns false if reading any of the frames failed.
+  bool LoadAllFrames();
+
+  /// Return true if voxels of the data node are loaded.
+  bool IsFrameLoaded(vtkMRMLNode* dataNode);
+
 protected:
   vtkMRMLVolumeSequenceStorageNode();
   ~vtkMRMLVolumeSequenceStorageNode() override;
@@ -80,6 +189,59 @@ protected:
 
   /// Initialize all the supported write file types
   void InitializeSupportedWriteFileTypes() override;
+
+  /// Get index of the frame in the file that is stored in the data node.
+  /// Returns -1 if the node is not lazily loaded.
+  int GetFrameIndex(vtkMRMLNode* dataNode);
+
+  /// Read voxels of a frame from the file and move it to the end of the recently used list.
+  bool ReadFrame(int frameIndex);
+
+  /// Release least recently used frames until the number of loaded frames is within the limit.
+  /// Frames in \a protectedFrameIndices are not released.
+  void ReleaseFrames(const std::vector<int>& protectedFrameIndices);
+
+  /// Get frames that should be prefetched after the requested frame.
+  void GetFramesToPrefetch(int frameIndex, std::vector<int>& prefetchedFrameIndices);
+
+  /// Move voxels of the frames into a single buffer and make the frame images refer to it.
+  /// Returns false if the frames are not compatible (size or scalar type differs).
+  bool MoveFramesToContiguousBuffer(const std::vector<vtkImageData*>& frameImages);
+
+  bool LazyLoading{false};
+  int NumberOfPrefetchedFrames{0};
+  bool BackgroundPrefetch{false};
+  int NumberOfRetainedFrames{10};
+  bool DeltaEncoding{false};
+  int KeyFrameInterval{10};
+  bool ContiguousFrameBuffer{false};
+
+  struct FrameInfo
+    {
+    vtkWeakPointer<vtkMRMLVolumeNode> VolumeNode;
+    bool Loaded{false};
+    /// Image was changed after it was read, therefore it must not be released
+    bool Modified{false};
+    /// Modification time of the image right after it was read,
+    /// used for detecting if the image was changed since then.
+    vtkMTimeType LoadedImageMTime{0};
+    };
+
+  /// Reader of the lazily loaded file, kept open for reading frames on demand
+  vtkSmartPointer<vtkTeemNRRDReader> FrameReader;
+  /// Empty image with the geometry of the frames, used for frames that are not loaded
+  vtkSmartPointer<vtkImageData> FrameStructure;
+  /// Frames in the order of the file
+  std::vector<FrameInfo> Frames;
+  /// Indices of loaded frames, most recently requested is the last
+  std::deque<int> LoadedFrameIndices;
+  /// Last requested frame and difference from the one before, for predicting the next requests
+  int LastRequestedFrameIndex{-1};
+  int PrefetchStep{1};
+
+  /// Reads frames in a background thread
+  class vtkFramePrefetcher;
+  vtkFramePrefetcher* Prefetcher{nullptr};
 };
 
 #endif
@@ -0,0 +1,880 @@
+/*=auto=========================================================================
+
+Portions (c) Copyright 2017 Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+See COPYRIGHT.txt
+or http://www.slicer.org/copyright/copyright.txt for details.
+
+=========================================================================auto=*/
+
+// MRML includes
+#include "vtkOMEZarrImageReader.h"
+#include "vtkURIHandler.h"
+
+// VTK includes
+#include <vtkByteSwap.h>
+#include <vtkDataArray.h>
+#include <vtkImageData.h>
+#include <vtkInformation.h>
+#include <vtkInformationVector.h>
+#include <vtkMatrix4x4.h>
+#include <vtkNew.h>
+#include <vtkObjectFactory.h>
+#include <vtkSMPTools.h>
+#include <vtkSmartPointer.h>
+#include <vtkStreamingDemandDrivenPipeline.h>
+#include <vtk_zlib.h>
+#include <vtksys/SystemTools.hxx>
+
+// RapidJSON includes
+#include "rapidjson/document.h"
+
+// STD includes
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <list>
+#include <map>
+#include <sstream>
+#include <vector>
+
+//----------------------------------------------------------------------------
+namespace
+{
+struct ResolutionLevelInfo
+{
+  std::string Path;
+  int Dimensions[3];
+  int ChunkSize[3];
+  int ScalarType;
+  int ScalarSize;
+  bool SwapBytes;
+  bool Compressed;
+  char DimensionSeparator;
+  /// One voxel of fill value, used for chunks that are not stored
+  std::vector<char> FillValue;
+  double IJKToRAS[16];
+};
+
+//----------------------------------------------------------------------------
+bool ParseJSON(const std::vector<char>& content, rapidjson::Document& document)
+{
+  document.Parse(content.data(), content.size());
+  return !document.HasParseError() && document.IsObject();
+}
+
+//----------------------------------------------------------------------------
+bool ReadJSONFile(const std::string& fileName, rapidjson::Document& document)
+{
+  std::ifstream file(fileName.c_str(), std::ios::in | std::ios::binary);
+  if (!file)
+    {
+    return false;
+    }
+  std::vector<char> content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+  return ParseJSON(content, document);
+}
+
+//----------------------------------------------------------------------------
+/// Return member \a name of \a object, nullptr if \a object is not an object
+/// or has no such member.
+const rapidjson::Value* GetMember(const rapidjson::Value& object, const char* name)
+{
+  if (!object.IsObject())
+    {
+    return nullptr;
+    }
+  rapidjson::Value::ConstMemberIterator member = object.FindMember(name);
+  return member != object.MemberEnd() ? &member->value : nullptr;
+}
+
+//----------------------------------------------------------------------------
+/// Get the \a size integers of \a array.
+/// Return false if it is not an array of \a size integers.
+bool GetIntArray(const rapidjson::Value* array, rapidjson::SizeType size, int* values)
+{
+  if (!array || !array->IsArray() || array->Size() != size)
+    {
+    return false;
+    }
+  for (rapidjson::SizeType i = 0; i < size; ++i)
+    {
+    if (!(*array)[i].IsInt())
+      {
+      return false;
+      }
+    values[i] = (*array)[i].GetInt();
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+/// Get the \a size numbers of \a array.
+/// Return false if it is not an array of \a size numbers.
+bool GetDoubleArray(const rapidjson::Value* array, rapidjson::SizeType size, double* values)
+{
+  if (!array || !array->IsArray() || array->Size() != size)
+    {
+    return false;
+    }
+  for (rapidjson::SizeType i = 0; i < size; ++i)
+    {
+    if (!(*array)[i].IsNumber())
+      {
+      return false;
+      }
+    values[i] = (*array)[i].GetDouble();
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+/// Parse a NumPy type string (such as "<i2") into a VTK scalar type
+bool ParseDataType(const std::string& dtype, int& scalarType, int& scalarSize, bool& swapBytes)
+{
+  if (dtype.size() < 3)
+    {
+    return false;
+    }
+  char byteOrder = dtype[0];
+  char kind = dtype[1];
+  scalarSize = atoi(dtype.c_str() + 2);
+  scalarType = VTK_VOID;
+  if (kind == 'i')
+    {
+    switch (scalarSize)
+      {
+      case 1: scalarType = VTK_SIGNED_CHAR; break;
+      case 2: scalarType = VTK_SHORT; break;
+      case 4: scalarType = VTK_INT; break;
+      case 8: scalarType = VTK_LONG_LONG; break;
+      }
+    }
+  else if (kind == 'u')
+    {
+    switch (scalarSize)
+      {
+      case 1: scalarType = VTK_UNSIGNED_CHAR; break;
+      case 2: scalarType = VTK_UNSIGNED_SHORT; break;
+      case 4: scalarType = VTK_UNSIGNED_INT; break;
+      case 8: scalarType = VTK_UNSIGNED_LONG_LONG; break;
+      }
+    }
+  else if (kind == 'f')
+    {
+    switch (scalarSize)
+      {
+      case 4: scalarType = VTK_FLOAT; break;
+      case 8: scalarType = VTK_DOUBLE; break;
+      }
+    }
+  if (scalarType == VTK_VOID)
+    {
+    return false;
+    }
+#ifdef VTK_WORDS_BIGENDIAN
+  swapBytes = (scalarSize > 1 && byteOrder == '<');
+#else
+  swapBytes = (scalarSize > 1 && byteOrder == '>');
+#endif
+  return true;
+}
+}
+
+//----------------------------------------------------------------------------
+class vtkOMEZarrImageReader::vtkInternal
+{
+public:
+  std::string MetaDataFileName;
+  long MetaDataModifiedTime = 0;
+  std::vector<ResolutionLevelInfo> Levels;
+
+  /// Decoded chunks, the most recently used first
+  struct CachedChunk
+  {
+    std::vector<char> Data;
+    std::list<std::string>::iterator UsageIterator;
+  };
+  std::map<std::string, CachedChunk> ChunkCache;
+  std::list<std::string> ChunkUsage;
+  size_t ChunkCacheSize = 0;
+
+  /// File content of remote chunks fetched by PrefetchChunks and not decoded yet
+  struct PrefetchedChunk
+  {
+    std::vector<char> Content;
+    int Status = vtkURIHandler::ReadFailed;
+  };
+  std::map<std::string, PrefetchedChunk> PrefetchedChunks;
+
+  /// Read a file of the OME-Zarr directory (\a name is relative to the directory),
+  /// locally or with the URI handler. \a notFound is set if the file does not exist.
+  bool ReadFile(vtkOMEZarrImageReader* self, const std::string& name, std::vector<char>& content, bool& notFound);
+  bool ReadJSON(vtkOMEZarrImageReader* self, const std::string& name, rapidjson::Document& document);
+
+  /// Name of the chunk file, relative to the OME-Zarr directory
+  std::string GetChunkName(const ResolutionLevelInfo& level, const int chunkIndex[3]);
+
+  /// Return the decoded chunk, or nullptr if it is not stored in a file
+  /// (then it contains only the fill value).
+  const std::vector<char>* GetChunk(vtkOMEZarrImageReader* self, const ResolutionLevelInfo& level,
+    int chunkIndex[3], bool& error);
+  /// Fetch concurrently the remote chunks of the range that are not in the cache,
+  /// so that the latency of the requests does not add up
+  void PrefetchChunks(vtkOMEZarrImageReader* self, const ResolutionLevelInfo& level,
+    const int firstChunk[3], const int lastChunk[3]);
+  void LimitChunkCacheSize(size_t maximumSize);
+};
+
+//----------------------------------------------------------------------------
+bool vtkOMEZarrImageReader::vtkInternal::ReadFile(
+  vtkOMEZarrImageReader* self, const std::string& name, std::vector<char>& content, bool& notFound)
+{
+  notFound = false;
+  content.clear();
+  std::string fileName = std::string(self->FileName) + "/" + name;
+  if (self->IsRemote())
+    {
+    int status = self->URIHandler->ReadToMemory(fileName.c_str(), content);
+    notFound = (status == vtkURIHandler::ReadNotFound);
+    return status == vtkURIHandler::ReadSucceeded;
+    }
+  std::ifstream file(fileName.c_str(), std::ios::in | std::ios::binary);
+  if (!file)
+    {
+    notFound = true;
+    return false;
+    }
+  content.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkOMEZarrImageReader::vtkInternal::ReadJSON(
+  vtkOMEZarrImageReader* self, const std::string& name, rapidjson::Document& document)
+{
+  std::vector<char> content;
+  bool notFound = false;
+  return this->ReadFile(self, name, content, notFound) && ParseJSON(content, document);
+}
+
+//----------------------------------------------------------------------------
+std::string vtkOMEZarrImageReader::vtkInternal::GetChunkName(const ResolutionLevelInfo& level, const int chunkIndex[3])
+{
+  // Zarr chunk keys are in z, y, x order
+  std::stringstream keyStream;
+  keyStream << level.Path << "/"
+    << chunkIndex[2] << level.DimensionSeparator << chunkIndex[1] << level.DimensionSeparator << chunkIndex[0];
+  return keyStream.str();
+}
+
+//----------------------------------------------------------------------------
+void vtkOMEZarrImageReader::vtkInternal::PrefetchChunks(vtkOMEZarrImageReader* self,
+  const ResolutionLevelInfo& level, const int firstChunk[3], const int lastChunk[3])
+{
+  std::vector<std::string> chunkNames;
+  int chunkIndex[3];
+  for (chunkIndex[2] = firstChunk[2]; chunkIndex[2] <= lastChunk[2]; ++chunkIndex[2])
+    {
+    for (chunkIndex[1] = firstChunk[1]; chunkIndex[1] <= lastChunk[1]; ++chunkIndex[1])
+      {
+      for (chunkIndex[0] = firstChunk[0]; chunkIndex[0] <= lastChunk[0]; ++chunkIndex[0])
+        {
+        std::string chunkName = this->GetChunkName(level, chunkIndex);
+        if (this->ChunkCache.find(std::string(self->FileName) + "/" + chunkName) == this->ChunkCache.end()
+          && this->PrefetchedChunks.find(chunkName) == this->PrefetchedChunks.end())
+          {
+          chunkNames.push_back(chunkName);
+          }
+        }
+      }
+    }
+  if (chunkNames.empty())
+    {
+    return;
+    }
+  std::vector<PrefetchedChunk> chunks(chunkNames.size());
+  const std::string directory = self->FileName;
+  vtkURIHandler* uriHandler = self->URIHandler;
+  vtkSMPTools::For(0, static_cast<vtkIdType>(chunkNames.size()),
+    [&](vtkIdType begin, vtkIdType end)
+    {
+    for (vtkIdType i = begin; i < end; ++i)
+      {
+      std::string url = directory + "/" + chunkNames[i];
+      chunks[i].Status = uriHandler->ReadToMemory(url.c_str(), chunks[i].Content);
+      }
+    });
+  for (size_t i = 0; i < chunkNames.size(); ++i)
+    {
+    this->PrefetchedChunks[chunkNames[i]].Content.swap(chunks[i].Content);
+    this->PrefetchedChunks[chunkNames[i]].Status = chunks[i].Status;
+    }
+}
+
+//----------------------------------------------------------------------------
+const std::vector<char>* vtkOMEZarrImageReader::vtkInternal::GetChunk(
+  vtkOMEZarrImageReader* self, const ResolutionLevelInfo& level, int chunkIndex[3], bool& error)
+{
+  error = false;
+  std::string chunkName = this->GetChunkName(level, chunkIndex);
+  std::string chunkFileName = std::string(self->FileName) + "/" + chunkName;
+
+  std::map<std::string, CachedChunk>::iterator cachedChunkIt = this->ChunkCache.find(chunkFileName);
+  if (cachedChunkIt != this->ChunkCache.end())
+    {
+    this->ChunkUsage.splice(this->ChunkUsage.begin(), this->ChunkUsage, cachedChunkIt->second.UsageIterator);
+    return &cachedChunkIt->second.Data;
+    }
+
+  std::vector<char> fileContent;
+  bool notFound = false;
+  bool success = false;
+  std::map<std::string, PrefetchedChunk>::iterator prefetchedChunkIt = this->PrefetchedChunks.find(chunkName);
+  if (prefetchedChunkIt != this->PrefetchedChunks.end())
+    {
+    fileContent.swap(prefetchedChunkIt->second.Content);
+    notFound = (prefetchedChunkIt->second.Status == vtkURIHandler::ReadNotFound);
+    success = (prefetchedChunkIt->second.Status == vtkURIHandler::ReadSucceeded);
+    this->PrefetchedChunks.erase(prefetchedChunkIt);
+    }
+  else
+    {
+    success = this->ReadFile(self, chunkName, fileContent, notFound);
+    }
+  if (notFound)
+    {
+    // chunks that only contain the fill value are not stored
+    return nullptr;
+    }
+  if (!success)
+    {
+    vtkErrorWithObjectMacro(self, "GetChunk: failed to read chunk " << chunkFileName);
+    error = true;
+    return nullptr;
+    }
+  self->NumberOfChunksRead++;
+
+  size_t chunkSize = static_cast<size_t>(level.ChunkSize[0]) * level.ChunkSize[1] * level.ChunkSize[2] * level.ScalarSize;
+  std::vector<char> chunk;
+  if (level.Compressed)
+    {
+    chunk.resize(chunkSize);
+    uLongf decompressedSize = static_cast<uLongf>(chunkSize);
+    if (uncompress(reinterpret_cast<Bytef*>(chunk.data()), &decompressedSize,
+      reinterpret_cast<const Bytef*>(fileContent.data()), static_cast<uLong>(fileContent.size())) != Z_OK
+      || decompressedSize != chunkSize)
+      {
+      vtkErrorWithObjectMacro(self, "GetChunk: failed to decompress chunk " << chunkFileName);
+      error = true;
+      return nullptr;
+      }
+    }
+  else
+    {
+    if (fileContent.size() != chunkSize)
+      {
+      vtkErrorWithObjectMacro(self, "GetChunk: unexpected size of chunk " << chunkFileName);
+      error = true;
+      return nullptr;
+      }
+    chunk.swap(fileContent);
+    }
+  if (level.SwapBytes)
+    {
+    vtkByteSwap::SwapVoidRange(chunk.data(), static_cast<size_t>(chunkSize / level.ScalarSize), level.ScalarSize);
+    }
+
+  size_t maximumCacheSize = static_cast<size_t>(self->ChunkCacheSizeMB) * 1024 * 1024;
+  this->LimitChunkCacheSize(maximumCacheSize > chunkSize ? maximumCacheSize - chunkSize : 0);
+  this->ChunkUsage.push_front(chunkFileName);
+  CachedChunk& cachedChunk = this->ChunkCache[chunkFileName];
+  cachedChunk.Data.swap(chunk);
+  cachedChunk.UsageIterator = this->ChunkUsage.begin();
+  this->ChunkCacheSize += chunkSize;
+  return &cachedChunk.Data;
+}
+
+//----------------------------------------------------------------------------
+void vtkOMEZarrImageReader::vtkInternal::LimitChunkCacheSize(size_t maximumSize)
+{
+  while (this->ChunkCacheSize > maximumSize && !this->ChunkUsage.empty())
+    {
+    std::map<std::string, CachedChunk>::iterator leastRecentlyUsedIt = this->ChunkCache.find(this->ChunkUsage.back());
+    this->ChunkCacheSize -= leastRecentlyUsedIt->second.Data.size();
+    this->ChunkCache.erase(leastRecentlyUsedIt);
+    this->ChunkUsage.pop_back();
+    }
+}
+
+//----------------------------------------------------------------------------
+vtkStandardNewMacro(vtkOMEZarrImageReader);
+vtkCxxSetObjectMacro(vtkOMEZarrImageReader, URIHandler, vtkURIHandler);
+
+//----------------------------------------------------------------------------
+vtkOMEZarrImageReader::vtkOMEZarrImageReader()
+{
+  this->FileName = nullptr;
+  this->URIHandler = nullptr;
+  this->ResolutionLevel = 0;
+  this->ChunkCacheSizeMB = 256;
+  this->NumberOfChunksRead = 0;
+  this->IJKToRASMatrix = vtkMatrix4x4::New();
+  this->Internal = new vtkInternal;
+  this->SetNumberOfInputPorts(0);
+}
+
+//----------------------------------------------------------------------------
+vtkOMEZarrImageReader::~vtkOMEZarrImageReader()
+{
+  this->SetFileName(nullptr);
+  this->SetURIHandler(nullptr);
+  this->IJKToRASMatrix->Delete();
+  delete this->Internal;
+}
+
+//----------------------------------------------------------------------------
+void vtkOMEZarrImageReader::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "FileName: " << (this->FileName ? this->FileName : "(none)") << "\n";
+  os << indent << "URIHandler: " << this->URIHandler << "\n";
+  os << indent << "ResolutionLevel: " << this->ResolutionLevel << "\n";
+  os << indent << "ChunkCacheSizeMB: " << this->ChunkCacheSizeMB << "\n";
+  os << indent << "NumberOfChunksRead: " << this->NumberOfChunksRead << "\n";
+  os << indent << "NumberOfResolutionLevels: " << this->Internal->Levels.size() << "\n";
+}
+
+//----------------------------------------------------------------------------
+bool vtkOMEZarrImageReader::CanReadFile(const char* fileName)
+{
+  if (!fileName || !vtksys::SystemTools::FileIsDirectory(fileName))
+    {
+    return false;
+    }
+  rapidjson::Document attributes;
+  if (!ReadJSONFile(std::string(fileName) + "/.zattrs", attributes))
+    {
+    return false;
+    }
+  return attributes.HasMember("multiscales") && attributes["multiscales"].IsArray();
+}
+
+//----------------------------------------------------------------------------
+bool vtkOMEZarrImageReader::IsRemote()
+{
+  if (!this->FileName || !this->URIHandler)
+    {
+    return false;
+    }
+  std::string fileName = this->FileName;
+  return fileName.find("://") != std::string::npos && fileName.compare(0, 7, "file://") != 0;
+}
+
+//----------------------------------------------------------------------------
+int vtkOMEZarrImageReader::GetNumberOfResolutionLevels()
+{
+  return static_cast<int>(this->Internal->Levels.size());
+}
+
+//----------------------------------------------------------------------------
+bool vtkOMEZarrImageReader::GetLevelDimensions(int level, int dimensions[3])
+{
+  if (level < 0 || level >= this->GetNumberOfResolutionLevels())
+    {
+    return false;
+    }
+  for (int i = 0; i < 3; ++i)
+    {
+    dimensions[i] = this->Internal->Levels[level].Dimensions[i];
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+int vtkOMEZarrImageReader::GetLevelScalarType(int level)
+{
+  if (level < 0 || level >= this->GetNumberOfResolutionLevels())
+    {
+    return VTK_VOID;
+    }
+  return this->Internal->Levels[level].ScalarType;
+}
+
+//----------------------------------------------------------------------------
+int vtkOMEZarrImageReader::GetLevelScalarSize(int level)
+{
+  if (level < 0 || level >= this->GetNumberOfResolutionLevels())
+    {
+    return 0;
+    }
+  return this->Internal->Levels[level].ScalarSize;
+}
+
+//----------------------------------------------------------------------------
+bool vtkOMEZarrImageReader::GetLevelIJKToRASMatrix(int level, vtkMatrix4x4* ijkToRAS)
+{
+  if (!ijkToRAS || level < 0 || level >= this->GetNumberOfResolutionLevels())
+    {
+    return false;
+    }
+  ijkToRAS->DeepCopy(this->Internal->Levels[level].IJKToRAS);
+  return true;
+}
+
+//----------------------------------------------------------------------------
+void vtkOMEZarrImageReader::ResetNumberOfChunksRead()
+{
+  this->NumberOfChunksRead = 0;
+}
+
+//----------------------------------------------------------------------------
+void vtkOMEZarrImageReader::ClearChunkCache()
+{
+  this->Internal->LimitChunkCacheSize(0);
+  this->Internal->PrefetchedChunks.clear();
+}
+
+//----------------------------------------------------------------------------
+bool vtkOMEZarrImageReader::ReadMetaData()
+{
+  if (!this->FileName)
+    {
+    vtkErrorMacro("ReadMetaData: file name is not specified");
+    return false;
+    }
+  std::string directory = this->FileName;
+  // remote metadata is read once
+  long modifiedTime = this->IsRemote() ? 0 : vtksys::SystemTools::ModifiedTime(directory + "/.zattrs");
+  if (this->Internal->MetaDataFileName == directory && this->Internal->MetaDataModifiedTime == modifiedTime
+    && !this->Internal->Levels.empty())
+    {
+    return true;
+    }
+  this->Internal->Levels.clear();
+  this->ClearChunkCache();
+  this->Internal->MetaDataFileName.clear();
+
+  rapidjson::Document attributes;
+  const rapidjson::Value* multiscales = nullptr;
+  if (this->Internal->ReadJSON(this, ".zattrs", attributes))
+    {
+    multiscales = GetMember(attributes, "multiscales");
+    }
+  if (!multiscales || !multiscales->IsArray() || multiscales->Empty() || !(*multiscales)[0].IsObject())
+    {
+    vtkErrorMacro("ReadMetaData: no multiscales metadata found in " << directory);
+    return false;
+    }
+  const rapidjson::Value& multiscale = (*multiscales)[0];
+  const rapidjson::Value* axes = GetMember(multiscale, "axes");
+  if (axes && (!axes->IsArray() || axes->Size() != 3))
+    {
+    vtkErrorMacro("ReadMetaData: only volumes with z, y, x axes are supported, " << directory
+      << " has " << (axes->IsArray() ? axes->Size() : 0) << " axes");
+    return false;
+    }
+  const rapidjson::Value* datasets = GetMember(multiscale, "datasets");
+  if (!datasets || !datasets->IsArray() || datasets->Empty())
+    {
+    vtkErrorMacro("ReadMetaData: no datasets found in " << directory);
+    return false;
+    }
+  // Full orientation of each level, not part of OME-NGFF
+  const rapidjson::Value* slicerIJKToRAS = nullptr;
+  const rapidjson::Value* slicerAttributes = GetMember(attributes, "slicer");
+  if (slicerAttributes)
+    {
+    slicerIJKToRAS = GetMember(*slicerAttributes, "ijkToRAS");
+    if (slicerIJKToRAS && !slicerIJKToRAS->IsArray())
+      {
+      vtkErrorMacro("ReadMetaData: invalid slicer ijkToRAS metadata in " << directory);
+      return false;
+      }
+    }
+
+  for (rapidjson::SizeType levelIndex = 0; levelIndex < datasets->Size(); ++levelIndex)
+    {
+    const rapidjson::Value& dataset = (*datasets)[levelIndex];
+    const rapidjson::Value* path = GetMember(dataset, "path");
+    if (!path || !path->IsString())
+      {
+      vtkErrorMacro("ReadMetaData: dataset " << levelIndex << " has no path in " << directory);
+      return false;
+      }
+    ResolutionLevelInfo level;
+    level.Path = path->GetString();
+
+    rapidjson::Document array;
+    std::string arrayFileName = directory + "/" + level.Path + "/.zarray";
+    if (!this->Internal->ReadJSON(this, level.Path + "/.zarray", array))
+      {
+      vtkErrorMacro("ReadMetaData: invalid array metadata " << arrayFileName);
+      return false;
+      }
+    // shape and chunks are in z, y, x order
+    int shape[3] = { 0, 0, 0 };
+    int chunks[3] = { 0, 0, 0 };
+    if (!GetIntArray(GetMember(array, "shape"), 3, shape) || !GetIntArray(GetMember(array, "chunks"), 3, chunks))
+      {
+      vtkErrorMacro("ReadMetaData: invalid shape or chunks in " << arrayFileName);
+      return false;
+      }
+    for (int i = 0; i < 3; ++i)
+      {
+      level.Dimensions[i] = shape[2 - i];
+      level.ChunkSize[i] = chunks[2 - i];
+      if (level.Dimensions[i] <= 0 || level.ChunkSize[i] <= 0)
+        {
+        vtkErrorMacro("ReadMetaData: invalid shape or chunks in " << arrayFileName);
+        return false;
+        }
+      }
+    const rapidjson::Value* dtype = GetMember(array, "dtype");
+    if (!dtype || !dtype->IsString())
+      {
+      vtkErrorMacro("ReadMetaData: missing data type in " << arrayFileName);
+      return false;
+      }
+    if (!ParseDataType(dtype->GetString(), level.ScalarType, level.ScalarSize, level.SwapBytes))
+      {
+      vtkErrorMacro("ReadMetaData: unsupported data type " << dtype->GetString() << " in " << arrayFileName);
+      return false;
+      }
+    const rapidjson::Value* order = GetMember(array, "order");
+    if (order && (!order->IsString() || std::string(order->GetString()) != "C"))
+      {
+      vtkErrorMacro("ReadMetaData: only C order arrays are supported " << arrayFileName);
+      return false;
+      }
+    const rapidjson::Value* filters = GetMember(array, "filters");
+    if (filters && !filters->IsNull())
+      {
+      vtkErrorMacro("ReadMetaData: array filters are not supported " << arrayFileName);
+      return false;
+      }
+    level.Compressed = false;
+    const rapidjson::Value* compressor = GetMember(array, "compressor");
+    if (compressor && !compressor->IsNull())
+      {
+      const rapidjson::Value* compressorId = GetMember(*compressor, "id");
+      if (!compressorId || !compressorId->IsString() || std::string(compressorId->GetString()) != "zlib")
+        {
+        vtkErrorMacro("ReadMetaData: only zlib compression is supported " << arrayFileName);
+        return false;
+        }
+      level.Compressed = true;
+      }
+    level.DimensionSeparator = '.';
+    const rapidjson::Value* dimensionSeparator = GetMember(array, "dimension_separator");
+    if (dimensionSeparator)
+      {
+      std::string separator = dimensionSeparator->IsString() ? dimensionSeparator->GetString() : "";
+      if (separator != "." && separator != "/")
+        {
+        vtkErrorMacro("ReadMetaData: invalid dimension separator in " << arrayFileName);
+        return false;
+        }
+      level.DimensionSeparator = separator[0];
+      }
+    double fillValue = 0.0;
+    const rapidjson::Value* fillValueMember = GetMember(array, "fill_value");
+    if (fillValueMember && fillValueMember->IsNumber())
+      {
+      fillValue = fillValueMember->GetDouble();
+      }
+    vtkSmartPointer<vtkDataArray> fillValueArray = vtkSmartPointer<vtkDataArray>::Take(
+      vtkDataArray::CreateDataArray(level.ScalarType));
+    fillValueArray->SetNumberOfTuples(1);
+    fillValueArray->SetTuple1(0, fillValue);
+    const char* fillValueBytes = static_cast<const char*>(fillValueArray->GetVoidPointer(0));
+    level.FillValue.assign(fillValueBytes, fillValueBytes + level.ScalarSize);
+
+    vtkNew<vtkMatrix4x4> ijkToRAS;
+    const rapidjson::Value* transforms = GetMember(dataset, "coordinateTransformations");
+    if (slicerIJKToRAS && levelIndex < slicerIJKToRAS->Size())
+      {
+      double elements[16] = { 0.0 };
+      if (!GetDoubleArray(&(*slicerIJKToRAS)[levelIndex], 16, elements))
+        {
+        vtkErrorMacro("ReadMetaData: invalid slicer ijkToRAS of dataset " << levelIndex << " in " << directory);
+        return false;
+        }
+      ijkToRAS->DeepCopy(elements);
+      }
+    else if (transforms)
+      {
+      if (!transforms->IsArray())
+        {
+        vtkErrorMacro("ReadMetaData: invalid coordinate transformations of dataset " << levelIndex << " in " << directory);
+        return false;
+        }
+      // OME-NGFF scale and translation, in z, y, x order
+      for (rapidjson::SizeType transformIndex = 0; transformIndex < transforms->Size(); ++transformIndex)
+        {
+        const rapidjson::Value& transform = (*transforms)[transformIndex];
+        const rapidjson::Value* type = GetMember(transform, "type");
+        if (!type || !type->IsString())
+          {
+          vtkErrorMacro("ReadMetaData: invalid coordinate transformation of dataset " << levelIndex << " in " << directory);
+          return false;
+          }
+        std::string typeName = type->GetString();
+        if (typeName != "scale" && typeName != "translation")
+          {
+          // identity or a transformation that is not supported yet
+          continue;
+          }
+        double values[3] = { 0.0, 0.0, 0.0 };
+        if (!GetDoubleArray(GetMember(transform, typeName.c_str()), 3, values))
+          {
+          vtkErrorMacro("ReadMetaData: invalid " << typeName << " of dataset " << levelIndex << " in " << directory);
+          return false;
+          }
+        for (int i = 0; i < 3; ++i)
+          {
+          if (typeName == "scale")
+            {
+            ijkToRAS->SetElement(i, i, values[2 - i]);
+            }
+          else
+            {
+            ijkToRAS->SetElement(i, 3, values[2 - i]);
+            }
+          }
+        }
+      }
+    for (int i = 0; i < 16; ++i)
+      {
+      level.IJKToRAS[i] = ijkToRAS->GetElement(i / 4, i % 4);
+      }
+    this->Internal->Levels.push_back(level);
+    }
+
+  this->Internal->MetaDataFileName = directory;
+  this->Internal->MetaDataModifiedTime = modifiedTime;
+  return true;
+}
+
+//----------------------------------------------------------------------------
+int vtkOMEZarrImageReader::RequestInformation(vtkInformation* vtkNotUsed(request),
+  vtkInformationVector** vtkNotUsed(inputVector), vtkInformationVector* outputVector)
+{
+  if (!this->ReadMetaData())
+    {
+    return 0;
+    }
+  if (this->ResolutionLevel < 0 || this->ResolutionLevel >= this->GetNumberOfResolutionLevels())
+    {
+    vtkErrorMacro("RequestInformation: invalid resolution level " << this->ResolutionLevel
+      << ", " << this->FileName << " has " << this->GetNumberOfResolutionLevels() << " levels");
+    return 0;
+    }
+  const ResolutionLevelInfo& level = this->Internal->Levels[this->ResolutionLevel];
+  this->IJKToRASMatrix->DeepCopy(level.IJKToRAS);
+
+  vtkInformation* outInfo = outputVector->GetInformationObject(0);
+  int wholeExtent[6] = { 0, level.Dimensions[0] - 1, 0, level.Dimensions[1] - 1, 0, level.Dimensions[2] - 1 };
+  double spacing[3] = { 1.0, 1.0, 1.0 };
+  double origin[3] = { 0.0, 0.0, 0.0 };
+  outInfo->Set(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT(), wholeExtent, 6);
+  outInfo->Set(vtkDataObject::SPACING(), spacing, 3);
+  outInfo->Set(vtkDataObject::ORIGIN(), origin, 3);
+  outInfo->Set(vtkAlgorithm::CAN_PRODUCE_SUB_EXTENT(), 1);
+  vtkDataObject::SetPointDataActiveScalarInfo(outInfo, level.ScalarType, 1);
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkOMEZarrImageReader::RequestData(vtkInformation* vtkNotUsed(request),
+  vtkInformationVector** vtkNotUsed(inputVector), vtkInformationVector* outputVector)
+{
+  vtkInformation* outInfo = outputVector->GetInformationObject(0);
+  vtkImageData* output = vtkImageData::SafeDownCast(outInfo->Get(vtkDataObject::DATA_OBJECT()));
+  if (!output || this->ResolutionLevel < 0 || this->ResolutionLevel >= this->GetNumberOfResolutionLevels())
+    {
+    return 0;
+    }
+  const ResolutionLevelInfo& level = this->Internal->Levels[this->ResolutionLevel];
+
+  int extent[6] = { 0, -1, 0, -1, 0, -1 };
+  outInfo->Get(vtkStreamingDemandDrivenPipeline::UPDATE_EXTENT(), extent);
+  output->SetExtent(extent);
+  output->AllocateScalars(level.ScalarType, 1);
+  if (extent[0] > extent[1] || extent[2] > extent[3] || extent[4] > extent[5])
+    {
+    return 1;
+    }
+  char* outputPtr = static_cast<char*>(output->GetScalarPointer());
+  const size_t scalarSize = level.ScalarSize;
+  const size_t outputRowSize = static_cast<size_t>(extent[1] - extent[0] + 1) * scalarSize;
+  const size_t outputSliceSize = outputRowSize * (extent[3] - extent[2] + 1);
+  const size_t chunkRowSize = static_cast<size_t>(level.ChunkSize[0]) * scalarSize;
+  const size_t chunkSliceSize = chunkRowSize * level.ChunkSize[1];
+
+  int firstChunk[3];
+  int lastChunk[3];
+  for (int i = 0; i < 3; ++i)
+    {
+    firstChunk[i] = extent[2 * i] / level.ChunkSize[i];
+    lastChunk[i] = extent[2 * i + 1] / level.ChunkSize[i];
+    }
+  const bool remote = this->IsRemote();
+  int chunkIndex[3];
+  for (chunkIndex[2] = firstChunk[2]; chunkIndex[2] <= lastChunk[2]; ++chunkIndex[2])
+    {
+    if (remote)
+      {
+      // fetch a slab of chunks at a time, to limit the memory used by undecoded chunks
+      int slabFirstChunk[3] = { firstChunk[0], firstChunk[1], chunkIndex[2] };
+      int slabLastChunk[3] = { lastChunk[0], lastChunk[1], chunkIndex[2] };
+      this->Internal->PrefetchChunks(this, level, slabFirstChunk, slabLastChunk);
+      }
+    for (chunkIndex[1] = firstChunk[1]; chunkIndex[1] <= lastChunk[1]; ++chunkIndex[1])
+      {
+      for (chunkIndex[0] = firstChunk[0]; chunkIndex[0] <= lastChunk[0]; ++chunkIndex[0])
+        {
+        // region of the chunk that is in the output extent
+        int copyExtent[6];
+        for (int i = 0; i < 3; ++i)
+          {
+          copyExtent[2 * i] = std::max(extent[2 * i], chunkIndex[i] * level.ChunkSize[i]);
+          copyExtent[2 * i + 1] = std::min(extent[2 * i + 1], (chunkIndex[i] + 1) * level.ChunkSize[i] - 1);
+          }
+        bool error = false;
+        const std::vector<char>* chunk = this->Internal->GetChunk(this, level, chunkIndex, error);
+        if (error)
+          {
+          this->Internal->PrefetchedChunks.clear();
+          return 0;
+          }
+        size_t copyRowSize = static_cast<size_t>(copyExtent[1] - copyExtent[0] + 1) * scalarSize;
+        for (int z = copyExtent[4]; z <= copyExtent[5]; ++z)
+          {
+          for (int y = copyExtent[2]; y <= copyExtent[3]; ++y)
+            {
+            char* outputRowPtr = outputPtr + (z - extent[4]) * outputSliceSize
+              + (y - extent[2]) * outputRowSize + (copyExtent[0] - extent[0]) * scalarSize;
+            if (chunk)
+              {
+              const char* chunkRowPtr = chunk->data()
+                + (z - chunkIndex[2] * level.ChunkSize[2]) * chunkSliceSize
+                + (y - chunkIndex[1] * level.ChunkSize[1]) * chunkRowSize
+                + (copyExtent[0] - chunkIndex[0] * level.ChunkSize[0]) * scalarSize;
+              memcpy(outputRowPtr, chunkRowPtr, copyRowSize);
+              }
+            else
+              {
+              for (size_t offset = 0; offset < copyRowSize; offset += scalarSize)
+                {
+                memcpy(outputRowPtr + offset, level.FillValue.data(), scalarSize);
+                }
+              }
+            }
+          }
+        }
+      }
+    }
+  return 1;
+}
@@ -0,0 +1,132 @@
+/*=auto=========================================================================
+
+Portions (c) Copyright 2017 Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+See COPYRIGHT.txt
+or http://www.slicer.org/copyright/copyright.txt for details.
+
+=========================================================================auto=*/
+
+#ifndef __vtkOMEZarrImageReader_h
+#define __vtkOMEZarrImageReader_h
+
+// MRML includes
+#include "vtkMRML.h"
+
+// VTK includes
+#include <vtkImageAlgorithm.h>
+
+class vtkMatrix4x4;
+class vtkURIHandler;
+
+/// \brief Read chunked, multiresolution volumes stored as OME-Zarr.
+///
+/// The volume is a directory containing a Zarr (version 2) group with
+/// OME-NGFF "multiscales" metadata. Each resolution level is a Zarr array of
+/// "z", "y", "x" axes, split in chunks that are stored in separate files,
+/// optionally compressed with zlib.
+///
+/// The reader supports streaming: only the chunks intersecting the requested
+/// update extent are read. Decoded chunks are kept in a cache so that
+/// subsequent requests of nearby regions do not read the files again.
+///
+/// The file name may also be the URL of a remote OME-Zarr directory. The metadata
+/// and the chunks are then read with the URI handler (\sa SetURIHandler) when they
+/// are needed, without downloading the volume, and the chunks of a requested
+/// extent are fetched concurrently.
+///
+/// As other Slicer volume readers, the output has unit spacing and zero
+/// origin, the geometry of the selected resolution level is available in
+/// GetIJKToRASMatrix().
+///
+/// Only single-component volumes are supported.
+/// \sa vtkOMEZarrImageWriter
+class VTK_MRML_EXPORT vtkOMEZarrImageReader : public vtkImageAlgorithm
+{
+public:
+  static vtkOMEZarrImageReader *New();
+  vtkTypeMacro(vtkOMEZarrImageReader, vtkImageAlgorithm);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  /// Path of the OME-Zarr directory, or its URL if it is read with a URI handler
+  vtkSetStringMacro(FileName);
+  vtkGetStringMacro(FileName);
+
+  /// Handler used for reading the files if FileName is a remote URL.
+  /// It must support vtkURIHandler::ReadToMemory.
+  virtual void SetURIHandler(vtkURIHandler* uriHandler);
+  vtkGetObjectMacro(URIHandler, vtkURIHandler);
+
+  /// Return true if the file name is a URL that is read with the URI handler
+  bool IsRemote();
+
+  /// Resolution level to read, 0 is the full resolution.
+  /// Levels are numbered in the order of the multiscales datasets.
+  vtkSetMacro(ResolutionLevel, int);
+  vtkGetMacro(ResolutionLevel, int);
+
+  /// Maximum size of the decoded chunk cache in megabytes.
+  /// Default is 256.
+  vtkSetClampMacro(ChunkCacheSizeMB, int, 0, VTK_INT_MAX);
+  vtkGetMacro(ChunkCacheSizeMB, int);
+
+  /// Number of resolution levels in the file.
+  /// Valid after UpdateInformation().
+  int GetNumberOfResolutionLevels();
+
+  /// Dimensions (x, y, z) of a resolution level.
+  /// Valid after UpdateInformation().
+  bool GetLevelDimensions(int level, int dimensions[3]);
+
+  /// VTK scalar type and size in bytes of the voxels of a resolution level.
+  /// Valid after UpdateInformation().
+  int GetLevelScalarType(int level);
+  int GetLevelScalarSize(int level);
+
+  /// Get the IJK to RAS matrix of a resolution level.
+  /// Valid after UpdateInformation().
+  bool GetLevelIJKToRASMatrix(int level, vtkMatrix4x4* ijkToRAS);
+
+  /// IJK to RAS matrix of the current resolution level.
+  /// Valid after UpdateInformation().
+  vtkGetObjectMacro(IJKToRASMatrix, vtkMatrix4x4);
+
+  /// Number of chunk files read since the last call to ResetNumberOfChunksRead().
+  /// Chunks found in the cache are not counted.
+  vtkGetMacro(NumberOfChunksRead, int);
+  void ResetNumberOfChunksRead();
+
+  /// Remove all chunks from the cache
+  void ClearChunkCache();
+
+  /// Return true if \a fileName is a directory containing OME-Zarr multiscales metadata
+  static bool CanReadFile(const char* fileName);
+
+protected:
+  vtkOMEZarrImageReader();
+  ~vtkOMEZarrImageReader() override;
+
+  int RequestInformation(vtkInformation* request,
+    vtkInformationVector** inputVector, vtkInformationVector* outputVector) override;
+  int RequestData(vtkInformation* request,
+    vtkInformationVector** inputVector, vtkInformationVector* outputVector) override;
+
+  /// Read the metadata of all resolution levels if the file name changed
+  bool ReadMetaData();
+
+  char* FileName;
+  vtkURIHandler* URIHandler;
+  int ResolutionLevel;
+  int ChunkCacheSizeMB;
+  int NumberOfChunksRead;
+  vtkMatrix4x4* IJKToRASMatrix;
+
+  class vtkInternal;
+  vtkInternal* Internal;
+
+private:
+  vtkOMEZarrImageReader(const vtkOMEZarrImageReader&) = delete;
+  void operator=(const vtkOMEZarrImageReader&) = delete;
+};
+
+#endif
@@ -0,0 +1,547 @@
+/*=auto=========================================================================
+
+Portions (c) Copyright 2017 Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+See COPYRIGHT.txt
+or http://www.slicer.org/copyright/copyright.txt for details.
+
+=========================================================================auto=*/
+
+// MRML includes
+#include "vtkOMEZarrImageWriter.h"
+
+// VTK includes
+#include <vtkImageData.h>
+#include <vtkImageShrink3D.h>
+#include <vtkInformation.h>
+#include <vtkMatrix4x4.h>
+#include <vtkNew.h>
+#include <vtkObjectFactory.h>
+#include <vtkPointData.h>
+#include <vtkSmartPointer.h>
+#include <vtk_zlib.h>
+#include <vtksys/SystemTools.hxx>
+
+// RapidJSON includes
+#include "rapidjson/prettywriter.h"
+#include "rapidjson/stringbuffer.h"
+
+// STD includes
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+//----------------------------------------------------------------------------
+namespace
+{
+//----------------------------------------------------------------------------
+/// Return the NumPy type string (such as "<i2") of a VTK scalar type,
+/// or an empty string if the type is not supported.
+std::string GetDataTypeString(int scalarType, int scalarSize)
+{
+  char kind = 0;
+  switch (scalarType)
+    {
+    case VTK_CHAR:
+    case VTK_SIGNED_CHAR:
+    case VTK_SHORT:
+    case VTK_INT:
+    case VTK_LONG:
+    case VTK_LONG_LONG:
+    case VTK_ID_TYPE:
+      kind = 'i';
+      break;
+    case VTK_UNSIGNED_CHAR:
+    case VTK_UNSIGNED_SHORT:
+    case VTK_UNSIGNED_INT:
+    case VTK_UNSIGNED_LONG:
+    case VTK_UNSIGNED_LONG_LONG:
+      kind = 'u';
+      break;
+    case VTK_FLOAT:
+    case VTK_DOUBLE:
+      kind = 'f';
+      break;
+    default:
+      return std::string();
+    }
+  std::stringstream dtype;
+#ifdef VTK_WORDS_BIGENDIAN
+  dtype << (scalarSize == 1 ? '|' : '>');
+#else
+  dtype << (scalarSize == 1 ? '|' : '<');
+#endif
+  dtype << kind << scalarSize;
+  return dtype.str();
+}
+
+//----------------------------------------------------------------------------
+bool WriteStringToFile(const std::string& fileName, const std::string& content)
+{
+  std::ofstream file(fileName.c_str(), std::ios::out | std::ios::binary);
+  if (!file)
+    {
+    return false;
+    }
+  file.write(content.data(), static_cast<std::streamsize>(content.size()));
+  return !file.fail();
+}
+}
+
+//----------------------------------------------------------------------------
+vtkStandardNewMacro(vtkOMEZarrImageWriter);
+
+//----------------------------------------------------------------------------
+vtkOMEZarrImageWriter::vtkOMEZarrImageWriter()
+{
+  this->FileName = nullptr;
+  this->IJKToRASMatrix = nullptr;
+  this->ChunkSize[0] = 64;
+  this->ChunkSize[1] = 64;
+  this->ChunkSize[2] = 64;
+  this->NumberOfResolutionLevels = 0;
+  this->DownsampleByAveraging = true;
+  this->UseCompression = true;
+  this->CompressionLevel = 1;
+  this->WriteError = false;
+}
+
+//----------------------------------------------------------------------------
+vtkOMEZarrImageWriter::~vtkOMEZarrImageWriter()
+{
+  this->SetFileName(nullptr);
+  this->SetIJKToRASMatrix(nullptr);
+}
+
+//----------------------------------------------------------------------------
+void vtkOMEZarrImageWriter::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "FileName: " << (this->FileName ? this->FileName : "(none)") << "\n";
+  os << indent << "ChunkSize: " << this->ChunkSize[0] << ", " << this->ChunkSize[1] << ", " << this->ChunkSize[2] << "\n";
+  os << indent << "NumberOfResolutionLevels: " << this->NumberOfResolutionLevels << "\n";
+  os << indent << "DownsampleByAveraging: " << this->DownsampleByAveraging << "\n";
+  os << indent << "UseCompression: " << this->UseCompression << "\n";
+  os << indent << "CompressionLevel: " << this->CompressionLevel << "\n";
+}
+
+//----------------------------------------------------------------------------
+vtkImageData* vtkOMEZarrImageWriter::GetInput()
+{
+  return vtkImageData::SafeDownCast(this->Superclass::GetInput());
+}
+
+//----------------------------------------------------------------------------
+int vtkOMEZarrImageWriter::FillInputPortInformation(int vtkNotUsed(port), vtkInformation *info)
+{
+  info->Set(vtkAlgorithm::INPUT_REQUIRED_DATA_TYPE(), "vtkImageData");
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+void vtkOMEZarrImageWriter::WriteData()
+{
+  this->WriteError = true;
+  vtkImageData* input = this->GetInput();
+  if (!input || !input->GetPointData()->GetScalars())
+    {
+    vtkErrorMacro("WriteData: no input image");
+    return;
+    }
+  if (!this->FileName)
+    {
+    vtkErrorMacro("WriteData: file name is not specified");
+    return;
+    }
+  if (input->GetNumberOfScalarComponents() != 1)
+    {
+    vtkErrorMacro("WriteData: only single-component images can be written, input has "
+      << input->GetNumberOfScalarComponents() << " components");
+    return;
+    }
+  if (GetDataTypeString(input->GetScalarType(), input->GetScalarSize()).empty())
+    {
+    vtkErrorMacro("WriteData: unsupported scalar type " << input->GetScalarTypeAsString());
+    return;
+    }
+  for (int i = 0; i < 3; ++i)
+    {
+    if (this->ChunkSize[i] <= 0)
+      {
+      vtkErrorMacro("WriteData: invalid chunk size");
+      return;
+      }
+    }
+
+  std::string directory = this->FileName;
+  if (vtksys::SystemTools::FileExists(directory))
+    {
+    // only replace previously written OME-Zarr volumes
+    if (!vtksys::SystemTools::FileIsDirectory(directory)
+      || !vtksys::SystemTools::FileExists(directory + "/.zgroup", true))
+      {
+      vtkErrorMacro("WriteData: " << directory << " exists and is not an OME-Zarr directory");
+      return;
+      }
+    if (!vtksys::SystemTools::RemoveADirectory(directory))
+      {
+      vtkErrorMacro("WriteData: failed to remove existing " << directory);
+      return;
+      }
+    }
+  if (!vtksys::SystemTools::MakeDirectory(directory))
+    {
+    vtkErrorMacro("WriteData: failed to create directory " << directory);
+    return;
+    }
+
+  vtkNew<vtkMatrix4x4> ijkToRAS;
+  if (this->IJKToRASMatrix)
+    {
+    ijkToRAS->DeepCopy(this->IJKToRASMatrix);
+    }
+
+  // Levels are written with zero-based extent, geometry is in the IJK to RAS matrices
+  vtkSmartPointer<vtkImageData> levelImage = vtkSmartPointer<vtkImageData>::New();
+  levelImage->ShallowCopy(input);
+  int* inputExtent = input->GetExtent();
+  if (inputExtent[0] != 0 || inputExtent[2] != 0 || inputExtent[4] != 0)
+    {
+    double shiftIJK[4] = { double(inputExtent[0]), double(inputExtent[2]), double(inputExtent[4]), 1.0 };
+    double shiftRAS[4] = { 0.0, 0.0, 0.0, 1.0 };
+    ijkToRAS->MultiplyPoint(shiftIJK, shiftRAS);
+    for (int i = 0; i < 3; ++i)
+      {
+      ijkToRAS->SetElement(i, 3, shiftRAS[i]);
+      }
+    int* dimensions = input->GetDimensions();
+    levelImage->SetExtent(0, dimensions[0] - 1, 0, dimensions[1] - 1, 0, dimensions[2] - 1);
+    }
+  levelImage->SetOrigin(0.0, 0.0, 0.0);
+  levelImage->SetSpacing(1.0, 1.0, 1.0);
+
+  std::vector<std::vector<double> > levelIJKToRASMatrices;
+  for (int levelIndex = 0; ; ++levelIndex)
+    {
+    std::stringstream levelPath;
+    levelPath << levelIndex;
+    if (!this->WriteLevel(levelImage, directory + "/" + levelPath.str()))
+      {
+      return;
+      }
+    std::vector<double> levelIJKToRAS(16);
+    for (int i = 0; i < 16; ++i)
+      {
+      levelIJKToRAS[i] = ijkToRAS->GetElement(i / 4, i % 4);
+      }
+    levelIJKToRASMatrices.push_back(levelIJKToRAS);
+
+    int* dimensions = levelImage->GetDimensions();
+    int shrinkFactors[3] = { 1, 1, 1 };
+    bool fitsInOneChunk = true;
+    for (int i = 0; i < 3; ++i)
+      {
+      if (dimensions[i] > 1)
+        {
+        shrinkFactors[i] = 2;
+        }
+      if (dimensions[i] > this->ChunkSize[i])
+        {
+        fitsInOneChunk = false;
+        }
+      }
+    bool lastLevel = (this->NumberOfResolutionLevels > 0)
+      ? (levelIndex + 1 >= this->NumberOfResolutionLevels)
+      : (fitsInOneChunk || levelIndex + 1 >= 16);
+    if (lastLevel || (shrinkFactors[0] == 1 && shrinkFactors[1] == 1 && shrinkFactors[2] == 1))
+      {
+      break;
+      }
+
+    vtkNew<vtkImageShrink3D> shrink;
+    shrink->SetInputData(levelImage);
+    shrink->SetShrinkFactors(shrinkFactors);
+    shrink->SetAveraging(this->DownsampleByAveraging ? 1 : 0);
+    shrink->Update();
+    levelImage = vtkSmartPointer<vtkImageData>::New();
+    levelImage->ShallowCopy(shrink->GetOutput());
+    int* shrunkDimensions = levelImage->GetDimensions();
+    levelImage->SetExtent(0, shrunkDimensions[0] - 1, 0, shrunkDimensions[1] - 1, 0, shrunkDimensions[2] - 1);
+    levelImage->SetOrigin(0.0, 0.0, 0.0);
+    levelImage->SetSpacing(1.0, 1.0, 1.0);
+
+    // Voxel i of the downsampled level covers voxels [f*i, f*i+f-1] of the previous level
+    vtkNew<vtkMatrix4x4> levelToPreviousLevel;
+    for (int i = 0; i < 3; ++i)
+      {
+      levelToPreviousLevel->SetElement(i, i, shrinkFactors[i]);
+      levelToPreviousLevel->SetElement(i, 3, this->DownsampleByAveraging ? (shrinkFactors[i] - 1) * 0.5 : 0.0);
+      }
+    vtkMatrix4x4::Multiply4x4(ijkToRAS, levelToPreviousLevel, ijkToRAS);
+    }
+
+  // Group and multiscales metadata
+  if (!WriteStringToFile(directory + "/.zgroup", "{\n    \"zarr_format\": 2\n}\n"))
+    {
+    vtkErrorMacro("WriteData: failed to write " << directory << "/.zgroup");
+    return;
+    }
+  rapidjson::StringBuffer buffer;
+  rapidjson::PrettyWriter<rapidjson::StringBuffer> writer(buffer);
+  writer.StartObject();
+  writer.Key("multiscales");
+  writer.StartArray();
+  writer.StartObject();
+  writer.Key("version");
+  writer.String("0.4");
+  writer.Key("name");
+  writer.String(vtksys::SystemTools::GetFilenameWithoutExtension(directory).c_str());
+  writer.Key("axes");
+  writer.StartArray();
+  const char* axisNames[3] = { "z", "y", "x" };
+  for (int i = 0; i < 3; ++i)
+    {
+    writer.StartObject();
+    writer.Key("name");
+    writer.String(axisNames[i]);
+    writer.Key("type");
+    writer.String("space");
+    writer.Key("unit");
+    writer.String("millimeter");
+    writer.EndObject();
+    }
+  writer.EndArray();
+  writer.Key("datasets");
+  writer.StartArray();
+  for (size_t levelIndex = 0; levelIndex < levelIJKToRASMatrices.size(); ++levelIndex)
+    {
+    const std::vector<double>& levelIJKToRAS = levelIJKToRASMatrices[levelIndex];
+    std::stringstream levelPath;
+    levelPath << levelIndex;
+    writer.StartObject();
+    writer.Key("path");
+    writer.String(levelPath.str().c_str());
+    // OME-NGFF cannot describe axis directions, only spacing and origin are stored
+    writer.Key("coordinateTransformations");
+    writer.StartArray();
+    writer.StartObject();
+    writer.Key("type");
+    writer.String("scale");
+    writer.Key("scale");
+    writer.StartArray();
+    for (int axis = 2; axis >= 0; --axis)
+      {
+      writer.Double(sqrt(levelIJKToRAS[axis] * levelIJKToRAS[axis]
+        + levelIJKToRAS[4 + axis] * levelIJKToRAS[4 + axis]
+        + levelIJKToRAS[8 + axis] * levelIJKToRAS[8 + axis]));
+      }
+    writer.EndArray();
+    writer.EndObject();
+    writer.StartObject();
+    writer.Key("type");
+    writer.String("translation");
+    writer.Key("translation");
+    writer.StartArray();
+    for (int axis = 2; axis >= 0; --axis)
+      {
+      writer.Double(levelIJKToRAS[axis * 4 + 3]);
+      }
+    writer.EndArray();
+    writer.EndObject();
+    writer.EndArray();
+    writer.EndObject();
+    }
+  writer.EndArray();
+  writer.EndObject();
+  writer.EndArray();
+  // Full geometry of each level
+  writer.Key("slicer");
+  writer.StartObject();
+  writer.Key("ijkToRAS");
+  writer.StartArray();
+  for (size_t levelIndex = 0; levelIndex < levelIJKToRASMatrices.size(); ++levelIndex)
+    {
+    writer.StartArray();
+    for (int i = 0; i < 16; ++i)
+      {
+      writer.Double(levelIJKToRASMatrices[levelIndex][i]);
+      }
+    writer.EndArray();
+    }
+  writer.EndArray();
+  writer.EndObject();
+  writer.EndObject();
+  if (!WriteStringToFile(directory + "/.zattrs", std::string(buffer.GetString()) + "\n"))
+    {
+    vtkErrorMacro("WriteData: failed to write " << directory << "/.zattrs");
+    return;
+    }
+
+  this->WriteError = false;
+}
+
+//----------------------------------------------------------------------------
+bool vtkOMEZarrImageWriter::WriteLevel(vtkImageData* image, const std::string& levelDirectory)
+{
+  if (!vtksys::SystemTools::MakeDirectory(levelDirectory))
+    {
+    vtkErrorMacro("WriteLevel: failed to create directory " << levelDirectory);
+    return false;
+    }
+  int* dimensions = image->GetDimensions();
+  const size_t scalarSize = image->GetScalarSize();
+  std::string dtype = GetDataTypeString(image->GetScalarType(), image->GetScalarSize());
+
+  // Array metadata, shape and chunks are in z, y, x order
+  rapidjson::StringBuffer buffer;
+  rapidjson::PrettyWriter<rapidjson::StringBuffer> writer(buffer);
+  writer.StartObject();
+  writer.Key("zarr_format");
+  writer.Int(2);
+  writer.Key("shape");
+  writer.StartArray();
+  for (int i = 2; i >= 0; --i)
+    {
+    writer.Int(dimensions[i]);
+    }
+  writer.EndArray();
+  writer.Key("chunks");
+  writer.StartArray();
+  for (int i = 2; i >= 0; --i)
+    {
+    writer.Int(this->ChunkSize[i]);
+    }
+  writer.EndArray();
+  writer.Key("dtype");
+  writer.String(dtype.c_str());
+  writer.Key("compressor");
+  if (this->UseCompression)
+    {
+    writer.StartObject();
+    writer.Key("id");
+    writer.String("zlib");
+    writer.Key("level");
+    writer.Int(this->CompressionLevel);
+    writer.EndObject();
+    }
+  else
+    {
+    writer.Null();
+    }
+  writer.Key("fill_value");
+  writer.Int(0);
+  writer.Key("order");
+  writer.String("C");
+  writer.Key("filters");
+  writer.Null();
+  writer.Key("dimension_separator");
+  writer.String("/");
+  writer.EndObject();
+  if (!WriteStringToFile(levelDirectory + "/.zarray", std::string(buffer.GetString()) + "\n"))
+    {
+    vtkErrorMacro("WriteLevel: failed to write " << levelDirectory << "/.zarray");
+    return false;
+    }
+
+  const char* imagePtr = static_cast<const char*>(image->GetScalarPointer());
+  const size_t imageRowSize = static_cast<size_t>(dimensions[0]) * scalarSize;
+  const size_t imageSliceSize = imageRowSize * dimensions[1];
+  const size_t chunkRowSize = static_cast<size_t>(this->ChunkSize[0]) * scalarSize;
+  const size_t chunkSliceSize = chunkRowSize * this->ChunkSize[1];
+  const size_t chunkSize = chunkSliceSize * this->ChunkSize[2];
+  std::vector<char> chunk(chunkSize);
+  std::vector<char> compressedChunk(this->UseCompression ? compressBound(static_cast<uLong>(chunkSize)) : 0);
+
+  int numberOfChunks[3];
+  for (int i = 0; i < 3; ++i)
+    {
+    numberOfChunks[i] = (dimensions[i] + this->ChunkSize[i] - 1) / this->ChunkSize[i];
+    }
+  int chunkIndex[3];
+  for (chunkIndex[2] = 0; chunkIndex[2] < numberOfChunks[2]; ++chunkIndex[2])
+    {
+    for (chunkIndex[1] = 0; chunkIndex[1] < numberOfChunks[1]; ++chunkIndex[1])
+      {
+      std::stringstream chunkDirectory;
+      chunkDirectory << levelDirectory << "/" << chunkIndex[2] << "/" << chunkIndex[1];
+      bool chunkDirectoryCreated = false;
+      for (chunkIndex[0] = 0; chunkIndex[0] < numberOfChunks[0]; ++chunkIndex[0])
+        {
+        // Edge chunks are padded with the fill value
+        int start[3];
+        int size[3];
+        for (int i = 0; i < 3; ++i)
+          {
+          start[i] = chunkIndex[i] * this->ChunkSize[i];
+          size[i] = std::min(this->ChunkSize[i], dimensions[i] - start[i]);
+          }
+        std::fill(chunk.begin(), chunk.end(), 0);
+        bool empty = true;
+        for (int z = 0; z < size[2]; ++z)
+          {
+          for (int y = 0; y < size[1]; ++y)
+            {
+            const char* imageRowPtr = imagePtr + (start[2] + z) * imageSliceSize
+              + (start[1] + y) * imageRowSize + start[0] * scalarSize;
+            char* chunkRowPtr = chunk.data() + z * chunkSliceSize + y * chunkRowSize;
+            size_t rowSize = static_cast<size_t>(size[0]) * scalarSize;
+            memcpy(chunkRowPtr, imageRowPtr, rowSize);
+            if (empty)
+              {
+              for (size_t i = 0; i < rowSize; ++i)
+                {
+                if (chunkRowPtr[i] != 0)
+                  {
+                  empty = false;
+                  break;
+                  }
+                }
+              }
+            }
+          }
+        if (empty)
+          {
+          // chunks that only contain the fill value are not stored
+          continue;
+          }
+
+        if (!chunkDirectoryCreated)
+          {
+          if (!vtksys::SystemTools::MakeDirectory(chunkDirectory.str()))
+            {
+            vtkErrorMacro("WriteLevel: failed to create directory " << chunkDirectory.str());
+            return false;
+            }
+          chunkDirectoryCreated = true;
+          }
+        std::stringstream chunkFileName;
+        chunkFileName << chunkDirectory.str() << "/" << chunkIndex[0];
+        std::ofstream file(chunkFileName.str().c_str(), std::ios::out | std::ios::binary);
+        if (this->UseCompression)
+          {
+          uLongf compressedSize = static_cast<uLongf>(compressedChunk.size());
+          if (compress2(reinterpret_cast<Bytef*>(compressedChunk.data()), &compressedSize,
+            reinterpret_cast<const Bytef*>(chunk.data()), static_cast<uLong>(chunkSize), this->CompressionLevel) != Z_OK)
+            {
+            vtkErrorMacro("WriteLevel: failed to compress chunk " << chunkFileName.str());
+            return false;
+            }
+          file.write(compressedChunk.data(), static_cast<std::streamsize>(compressedSize));
+          }
+        else
+          {
+          file.write(chunk.data(), static_cast<std::streamsize>(chunkSize));
+          }
+        if (file.fail())
+          {
+          vtkErrorMacro("WriteLevel: failed to write chunk " << chunkFileName.str());
+          return false;
+          }
+        }
+      }
+    }
+  return true;
+}
@@ -0,0 +1,107 @@
+/*=auto=========================================================================
+
+Portions (c) Copyright 2017 Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+See COPYRIGHT.txt
+or http://www.slicer.org/copyright/copyright.txt for details.
+
+=========================================================================auto=*/
+
+#ifndef __vtkOMEZarrImageWriter_h
+#define __vtkOMEZarrImageWriter_h
+
+// MRML includes
+#include "vtkMRML.h"
+
+// VTK includes
+#include <vtkWriter.h>
+
+class vtkImageData;
+class vtkMatrix4x4;
+
+/// \brief Write volumes as chunked, multiresolution OME-Zarr.
+///
+/// The input image is written as the full resolution level of a Zarr
+/// (version 2) group with OME-NGFF "multiscales" metadata, followed by
+/// levels downsampled by a factor of 2 along each axis.
+/// Each level is split in chunks of ChunkSize voxels stored in separate
+/// files. Chunks that only contain zeros are not written.
+///
+/// Only single-component images are supported.
+/// \sa vtkOMEZarrImageReader
+class VTK_MRML_EXPORT vtkOMEZarrImageWriter : public vtkWriter
+{
+public:
+  static vtkOMEZarrImageWriter *New();
+  vtkTypeMacro(vtkOMEZarrImageWriter, vtkWriter);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  /// Get the input to this writer.
+  vtkImageData* GetInput();
+
+  /// Path of the OME-Zarr directory to write. An existing OME-Zarr directory
+  /// is replaced.
+  vtkSetStringMacro(FileName);
+  vtkGetStringMacro(FileName);
+
+  /// IJK to RAS matrix of the input image.
+  /// Identity is used if not set.
+  vtkSetObjectMacro(IJKToRASMatrix, vtkMatrix4x4);
+  vtkGetObjectMacro(IJKToRASMatrix, vtkMatrix4x4);
+
+  /// Number of voxels of a chunk along each axis. Default is 64, 64, 64.
+  vtkSetVector3Macro(ChunkSize, int);
+  vtkGetVector3Macro(ChunkSize, int);
+
+  /// Number of resolution levels to write, including the full resolution.
+  /// 0 means levels are added until the coarsest level fits in one chunk.
+  /// Default is 0.
+  vtkSetClampMacro(NumberOfResolutionLevels, int, 0, 16);
+  vtkGetMacro(NumberOfResolutionLevels, int);
+
+  /// Compute downsampled voxels as the average of the voxels they cover
+  /// (suited for intensity images), or pick one of them (suited for label maps).
+  /// Default is on.
+  vtkSetMacro(DownsampleByAveraging, bool);
+  vtkGetMacro(DownsampleByAveraging, bool);
+  vtkBooleanMacro(DownsampleByAveraging, bool);
+
+  /// Compress chunks with zlib. Default is on.
+  vtkSetMacro(UseCompression, bool);
+  vtkGetMacro(UseCompression, bool);
+  vtkBooleanMacro(UseCompression, bool);
+
+  vtkSetClampMacro(CompressionLevel, int, 0, 9);
+  vtkGetMacro(CompressionLevel, int);
+
+  /// Flag that is set by WriteData() if writing fails.
+  vtkSetMacro(WriteError, bool);
+  vtkGetMacro(WriteError, bool);
+
+protected:
+  vtkOMEZarrImageWriter();
+  ~vtkOMEZarrImageWriter() override;
+
+  int FillInputPortInformation(int port, vtkInformation *info) override;
+
+  /// Write method. It is called by vtkWriter::Write();
+  void WriteData() override;
+
+  /// Write the chunks and array metadata of one resolution level
+  bool WriteLevel(vtkImageData* image, const std::string& levelDirectory);
+
+  char* FileName;
+  vtkMatrix4x4* IJKToRASMatrix;
+  int ChunkSize[3];
+  int NumberOfResolutionLevels;
+  bool DownsampleByAveraging;
+  bool UseCompression;
+  int CompressionLevel;
+  bool WriteError;
+
+private:
+  vtkOMEZarrImageWriter(const vtkOMEZarrImageWriter&) = delete;
+  void operator=(const vtkOMEZarrImageWriter&) = delete;
+};
+
+#endif
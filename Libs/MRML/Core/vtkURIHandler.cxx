@@ -111,6 +111,20 @@ void vtkURIHandler::StageFileWrite ( const char * vtkNotUsed( source ), const ch
 {
 }
 
+//----------------------------------------------------------------------------
+void vtkURIHandler::StageFileRead ( const char * source, const char * destination,
+                                    vtkDataTransfer * vtkNotUsed( transfer ))
+{
+  this->StageFileRead(source, destination);
+}
+
+//----------------------------------------------------------------------------
+int vtkURIHandler::ReadToMemory ( const char * vtkNotUsed( uri ), std::vector<char>& content )
+{
+  content.clear();
+  return vtkURIHandler::ReadFailed;
+}
+
 //----------------------------------------------------------------------------
 void vtkURIHandler::StageFileRead(const char * vtkNotUsed( source ),
                              const char * vtkNotUsed( destination ),
@@ -3,11 +3,15 @@
 
 // MRML includes
 #include "vtkMRML.h"
+class vtkDataTransfer;
 class vtkPermissionPrompter;
 
 // VTK includes
 #include <vtkObject.h>
 
+// STD includes
+#include <vector>
+
 class VTK_MRML_EXPORT vtkURIHandler : public vtkObject
 {
 public:
@@ -26,6 +30,34 @@ public:
   virtual void StageFileRead ( const char *source, const char * destination );
   virtual void StageFileWrite ( const char *source, const char * destination );
 
+  ///
+  /// Read the file and report the progress of the download in \a transfer:
+  /// its progress is set (see vtkDataTransfer::SetProgressNoModify()) and
+  /// vtkCommand::ProgressEvent is invoked on it, in the calling thread.
+  /// The default implementation calls StageFileRead(source, destination).
+  virtual void StageFileRead ( const char *source, const char * destination, vtkDataTransfer* transfer );
+
+  /// Status returned by ReadToMemory
+  enum
+    {
+    ReadFailed = 0,
+    ReadSucceeded,
+    ReadNotFound
+    };
+
+  ///
+  /// Read the resource at \a uri into \a content without writing it to the cache.
+  /// Used for reading parts of large datasets (e.g. chunks of a chunked volume)
+  /// on demand, instead of downloading the whole dataset.
+  /// Returns ReadSucceeded, ReadNotFound if the resource does not exist,
+  /// ReadFailed otherwise. Implementations must be thread-safe, so that
+  /// multiple resources can be read concurrently.
+  /// The default implementation returns ReadFailed.
+  virtual int ReadToMemory ( const char *uri, std::vector<char>& content );
+  ///
+  /// Return true if the handler implements ReadToMemory.
+  virtual bool CanReadToMemory ( ) { return false; }
+
   ///
   /// various Read/Write method footprints useful to redefine in specific handlers.
   virtual void StageFileRead(const char * source,
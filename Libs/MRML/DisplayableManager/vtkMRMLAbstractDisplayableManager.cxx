@@ -31,6 +31,7 @@
 #include <vtkMRMLInteractionNode.h>
 #include <vtkMRMLScene.h>
 #include <vtkMRMLSelectionNode.h>
+#include <vtkMRMLTrace.h>
 
 // VTK includes
 #include <vtkCallbackCommand.h>
@@ -848,6 +849,7 @@ void vtkMRMLAbstractDisplayableManager::RequestRender()
 
   if (this->Internal->UpdateFromMRMLRequested)
     {
+    vtkMRMLTraceScopeMacro("DisplayableManager", "UpdateFromMRML", this->GetClassName());
     this->UpdateFromMRML();
     }
 
@@ -1012,6 +1014,12 @@ int vtkMRMLAbstractDisplayableManager::GetMouseCursor()
   return VTK_CURSOR_DEFAULT;
 }
 
+//----------------------------------------------------------------------------
+unsigned long vtkMRMLAbstractDisplayableManager::GetGraphicsMemorySize()
+{
+  return 0;
+}
+
 //----------------------------------------------------------------------------
 void vtkMRMLAbstractDisplayableManager::SetMouseCursor(int cursor)
 {
@@ -114,6 +114,11 @@ public:
 
   void SetMouseCursor(int cursor);
 
+  /// Estimated graphics memory (in kibibytes) used by the displayable manager for
+  /// rendering nodes of the scene (e.g., textures of volume rendering).
+  /// Returns 0 by default.
+  virtual unsigned long GetGraphicsMemorySize();
+
 protected:
 
   vtkMRMLAbstractDisplayableManager();
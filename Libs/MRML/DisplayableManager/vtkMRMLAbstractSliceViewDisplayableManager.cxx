@@ -33,6 +33,7 @@
 #include <vtkRenderWindowInteractor.h>
 
 // STD includes
+#include <algorithm>
 #include <cassert>
 
 //---------------------------------------------------------------------------
@@ -173,3 +174,31 @@ void vtkMRMLAbstractSliceViewDisplayableManager::ConvertXYZToRAS(
   sliceNode->GetXYToRAS()->MultiplyPoint(xyzw, rasw);
   ras[0] = rasw[0]/rasw[3]; ras[1] = rasw[1]/rasw[3]; ras[2] = rasw[2]/rasw[3];
 }
+
+//---------------------------------------------------------------------------
+bool vtkMRMLAbstractSliceViewDisplayableManager::IsBoundingBoxIntersectingSlicePlane(
+    const double boundsRAS[6], vtkMatrix4x4* xyToRAS)
+{
+  if (!xyToRAS || boundsRAS[0] > boundsRAS[1] || boundsRAS[2] > boundsRAS[3] || boundsRAS[4] > boundsRAS[5])
+    {
+    return false;
+    }
+  // Slice plane normal is the Z axis of the XY coordinate system
+  double normal[3] = { xyToRAS->GetElement(0, 2), xyToRAS->GetElement(1, 2), xyToRAS->GetElement(2, 2) };
+  double origin[3] = { xyToRAS->GetElement(0, 3), xyToRAS->GetElement(1, 3), xyToRAS->GetElement(2, 3) };
+  // The box intersects the plane if its corners are not all on the same side of the plane
+  double minDistance = VTK_DOUBLE_MAX;
+  double maxDistance = VTK_DOUBLE_MIN;
+  for (int corner = 0; corner < 8; ++corner)
+    {
+    double distance = 0.0;
+    for (int axis = 0; axis < 3; ++axis)
+      {
+      double position = boundsRAS[2 * axis + ((corner >> axis) & 1)];
+      distance += normal[axis] * (position - origin[axis]);
+      }
+    minDistance = std::min(minDistance, distance);
+    maxDistance = std::max(maxDistance, distance);
+    }
+  return minDistance <= 0.0 && maxDistance >= 0.0;
+}
@@ -26,6 +26,7 @@
 
 #include "vtkMRMLDisplayableManagerExport.h"
 
+class vtkMatrix4x4;
 class vtkMRMLSliceNode;
 
 /// \brief Superclass for displayable manager classes.
@@ -81,6 +82,12 @@ public:
   /// Parameters \a ras and \a xyz are double[3]. \a xyz[2] is the lightbox id.
   static void ConvertXYZToRAS(vtkMRMLSliceNode * sliceNode, double xyz[3], double ras[3]);
 
+  /// Returns true if the axis-aligned bounding box \a boundsRAS (xmin, xmax, ymin, ymax, zmin, zmax)
+  /// intersects the slice plane defined by \a xyToRAS.
+  /// This is a cheap test that allows skipping cutting of objects that are not visible in the slice view.
+  /// Returns false for invalid (empty) bounds.
+  static bool IsBoundingBoxIntersectingSlicePlane(const double boundsRAS[6], vtkMatrix4x4* xyToRAS);
+
 protected:
 
   vtkMRMLAbstractSliceViewDisplayableManager();
@@ -30,6 +30,7 @@
 
 // MRML includes
 #include <vtkMRMLNode.h>
+#include <vtkMRMLTrace.h>
 
 // VTK includes
 #include <vtkCallbackCommand.h>
@@ -54,6 +55,9 @@ class vtkMRMLDisplayableManagerGroup::vtkInternal
 public:
   vtkInternal();
 
+  /// Record the rendering time of the renderer as trace event
+  static void RenderTraceCallback(vtkObject* caller, unsigned long eid, void* clientData, void* callData);
+
   // Collection of Displayable Managers
   std::vector<vtkMRMLAbstractDisplayableManager *> DisplayableManagers;
 
@@ -72,6 +76,9 @@ public:
   vtkMRMLNode*                          MRMLDisplayableNode;
   vtkRenderer*                          Renderer;
   vtkWeakPointer<vtkMRMLLightBoxRendererManagerProxy> LightBoxRendererManagerProxy;
+
+  vtkSmartPointer<vtkCallbackCommand>   RenderTraceCommand;
+  double                                RenderStartTime;
 };
 
 //----------------------------------------------------------------------------
@@ -85,6 +92,28 @@ vtkMRMLDisplayableManagerGroup::vtkInternal::vtkInternal()
   this->CallBackCommand = vtkSmartPointer<vtkCallbackCommand>::New();
   this->DisplayableManagerFactory = nullptr;
   this->LightBoxRendererManagerProxy = nullptr;
+  this->RenderTraceCommand = vtkSmartPointer<vtkCallbackCommand>::New();
+  this->RenderTraceCommand->SetCallback(vtkInternal::RenderTraceCallback);
+  this->RenderTraceCommand->SetClientData(this);
+  this->RenderStartTime = -1.0;
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLDisplayableManagerGroup::vtkInternal::RenderTraceCallback(
+  vtkObject* vtkNotUsed(caller), unsigned long eid, void* clientData, void* vtkNotUsed(callData))
+{
+  vtkInternal* self = reinterpret_cast<vtkInternal*>(clientData);
+  if (eid == vtkCommand::StartEvent)
+    {
+    self->RenderStartTime = (vtkMRMLTrace::IsEnabled() ? vtkMRMLTrace::GetTime() : -1.0);
+    }
+  else if (eid == vtkCommand::EndEvent && self->RenderStartTime >= 0.0)
+    {
+    vtkMRMLTrace::GetInstance()->AddEvent("Rendering", "vtkRenderer::Render",
+      self->MRMLDisplayableNode ? self->MRMLDisplayableNode->GetID() : nullptr,
+      self->RenderStartTime, vtkMRMLTrace::GetTime());
+    self->RenderStartTime = -1.0;
+    }
 }
 
 //----------------------------------------------------------------------------
@@ -111,6 +140,7 @@ vtkMRMLDisplayableManagerGroup::~vtkMRMLDisplayableManagerGroup()
 
   if (this->Internal->Renderer)
     {
+    this->Internal->Renderer->RemoveObserver(this->Internal->RenderTraceCommand);
     this->Internal->Renderer->UnRegister(this);
     }
 
@@ -315,6 +345,7 @@ void vtkMRMLDisplayableManagerGroup::SetRenderer(vtkRenderer* newRenderer)
 
   if (this->Internal->Renderer)
     {
+    this->Internal->Renderer->RemoveObserver(this->Internal->RenderTraceCommand);
     this->Internal->Renderer->Delete();
     }
 
@@ -323,6 +354,10 @@ void vtkMRMLDisplayableManagerGroup::SetRenderer(vtkRenderer* newRenderer)
   if (this->Internal->Renderer)
     {
     this->Internal->Renderer->Register(this);
+#ifdef MRML_USE_TRACING
+    this->Internal->Renderer->AddObserver(vtkCommand::StartEvent, this->Internal->RenderTraceCommand);
+    this->Internal->Renderer->AddObserver(vtkCommand::EndEvent, this->Internal->RenderTraceCommand);
+#endif
     }
 
   vtkDebugMacro(<< this->GetClassName() << " (" << this << "): "
@@ -36,15 +36,22 @@
 #include <vtkAlgorithmOutput.h>
 #include <vtkAssignAttribute.h>
 #include <vtkCallbackCommand.h>
+#include <vtkCamera.h>
+#include <vtkCell.h>
 #include <vtkCellArray.h>
+#include <vtkCellData.h>
 #include <vtkClipDataSet.h>
 #include <vtkClipPolyData.h>
 #include <vtkColorTransferFunction.h>
 #include <vtkDataSetAttributes.h>
 #include <vtkDataSetMapper.h>
+#include <vtkDataSetSurfaceFilter.h>
+#include <vtkDecimatePro.h>
 #include <vtkExtractGeometry.h>
 #include <vtkExtractPolyDataGeometry.h>
 #include <vtkGeneralTransform.h>
+#include <vtkHardwareSelector.h>
+#include <vtkIdTypeArray.h>
 #include <vtkImageActor.h>
 #include <vtkImageData.h>
 #include <vtkImageMapper3D.h>
@@ -54,15 +61,19 @@
 #include <vtkNew.h>
 #include <vtkObjectFactory.h>
 #include <vtkPlane.h>
+#include <vtkPlaneCollection.h>
 #include <vtkPointData.h>
 #include <vtkPointSet.h>
+#include <vtkPolyData.h>
 #include <vtkPolyDataMapper.h>
 #include <vtkProp3DCollection.h>
 #include <vtkProperty.h>
 #include <vtkRenderWindowInteractor.h>
+#include <vtkRenderer.h>
 #include <vtkSmartPointer.h>
 #include <vtkTexture.h>
 #include <vtkTransformFilter.h>
+#include <vtkTriangleFilter.h>
 #include <vtkVersion.h>
 #include <vtkWeakPointer.h>
 // For picking
@@ -72,6 +83,34 @@
 #include <vtkRendererCollection.h>
 #include <vtkWorldPointPicker.h>
 
+// STD includes
+#include <algorithm>
+#include <chrono>
+#include <future>
+#include <vector>
+
+namespace
+{
+
+//---------------------------------------------------------------------------
+/// Reduce the number of triangles of a mesh. Point data of retained points is preserved.
+/// Called from a background thread, therefore it must only use its input.
+vtkSmartPointer<vtkPolyData> DecimateMesh(vtkSmartPointer<vtkPolyData> mesh, double targetReduction)
+{
+  vtkNew<vtkTriangleFilter> triangulator;
+  triangulator->SetInputData(mesh);
+  vtkNew<vtkDecimatePro> decimator;
+  decimator->SetInputConnection(triangulator->GetOutputPort());
+  decimator->SetTargetReduction(targetReduction);
+  decimator->PreserveTopologyOff();
+  decimator->BoundaryVertexDeletionOn();
+  decimator->Update();
+  vtkSmartPointer<vtkPolyData> decimatedMesh = decimator->GetOutput();
+  return decimatedMesh;
+}
+
+} // end of anonymous namespace
+
 //---------------------------------------------------------------------------
 vtkStandardNewMacro (vtkMRMLModelDisplayableManager );
 
@@ -83,11 +122,21 @@ public:
   ~vtkInternal();
 
   void CreateClipSlices();
+  /// Return true if clipping of a mesh of this type can be done by the mapper
+  /// (using OpenGL clip planes) instead of clipping the mesh geometry.
+  bool IsHardwareClippingApplicable(vtkMRMLModelNode::MeshTypeHint meshType);
+  /// Return true if any displayed model is clipped by clipping its mesh geometry.
+  bool HasSoftwareClippedModels();
 
   /// Reset all the pick vars
   void ResetPick();
   /// Find picked node from mesh and set PickedNodeID in Internal
   void FindPickedDisplayNodeFromMesh(vtkPointSet* mesh, double pickedPoint[3]);
+  /// Get the filter that extracts the outer surface of an unstructured grid model for rendering
+  vtkDataSetSurfaceFilter* GetSurfaceExtractor(const std::string& displayNodeID);
+  /// Convert a cell ID of a rendered mesh to the cell ID in the output mesh of the display node.
+  /// Only the extracted surface of unstructured grids have different cell IDs.
+  vtkIdType GetDisplayNodeMeshCellID(const std::string& displayNodeID, vtkDataSet* renderedMesh, vtkIdType cellID);
   /// Find node in scene from imageData and set PickedNodeID in Internal
   void FindDisplayNodeFromImageData(vtkMRMLScene* scene, vtkImageData* imageData);
   /// Find picked point index in mesh and picked cell (PickedCellID) and set PickedPointID in Internal
@@ -95,15 +144,33 @@ public:
   /// Find first picked node from prop3Ds in cell picker and set PickedNodeID in Internal
   void FindFirstPickedDisplayNodeFromPickerProp3Ds();
 
+  /// Show decimated proxies instead of large models if \a interacting is true,
+  /// and start computing missing or outdated proxies
+  void UpdateLevelOfDetail(bool interacting);
+  void RemoveLevelOfDetailProxy(const std::string& displayNodeID);
+
+  /// Pick using the ID buffer of the hardware selector, capturing the buffer if the view changed.
+  /// \return False if the pick could not be performed and the cell picker should be used instead.
+  bool HardwarePick(vtkRenderer* renderer, double displayPosition[2], double pickPoint[3],
+    vtkPointSet*& pickedMesh, vtkIdType& pickedCellId);
+  /// Latest modification time of the camera and the visible props of the renderer,
+  /// or 0 if the renderer contains visible volumes that the hardware selector cannot pick.
+  vtkMTimeType GetHardwareSelectionMTime(vtkRenderer* renderer);
+
 public:
   vtkMRMLModelDisplayableManager* External;
 
   std::map<std::string, vtkProp3D*>                DisplayedActors;
   std::map<std::string, vtkMRMLDisplayNode*>       DisplayedNodes;
+  /// Clip state of displayed models: 0 = not clipped, 1 = mesh geometry is clipped,
+  /// 2 = clipped by the mapper using HardwareClippingPlanes
   std::map<std::string, int>                       DisplayedClipState;
   std::map<std::string, vtkMRMLDisplayableNode*>   DisplayableNodes;
   std::map<std::string, int>                       RegisteredModelHierarchies;
   std::map<std::string, vtkTransformFilter*>       DisplayNodeTransformFilters;
+  /// Outer surface of unstructured grid models. Surface is only extracted again
+  /// when the mesh is modified, not when the actor or mapper is updated.
+  std::map<std::string, vtkSmartPointer<vtkDataSetSurfaceFilter> > DisplayNodeSurfaceExtractors;
 
   vtkMRMLSliceNode* RedSliceNode;
   vtkMRMLSliceNode* GreenSliceNode;
@@ -113,6 +180,11 @@ public:
   vtkSmartPointer<vtkPlane>           RedSlicePlane;
   vtkSmartPointer<vtkPlane>           GreenSlicePlane;
   vtkSmartPointer<vtkPlane>           YellowSlicePlane;
+  /// Slice planes that clip models, shared by the mappers of hardware clipped models.
+  /// Mappers use the current plane positions at each render, therefore moving a slice
+  /// does not require updating the models.
+  vtkSmartPointer<vtkPlaneCollection> HardwareClippingPlanes;
+  bool UseHardwareClipping{true};
 
   vtkMRMLClipModelsNode*  ClipModelsNode;
   int                     ClipType;
@@ -138,6 +210,30 @@ public:
   // Used for caching the node pointer so that we do not have to search in the scene each time.
   // We do not add an observer therefore we can let the selection node deleted without our knowledge.
   vtkWeakPointer<vtkMRMLSelectionNode> SelectionNode;
+
+  /// Decimated copy of a displayed model, rendered instead of it during interaction
+  struct LevelOfDetailProxy
+  {
+    vtkSmartPointer<vtkActor> Actor;
+    vtkSmartPointer<vtkPolyData> Mesh;
+    /// Full resolution mesh and its modification time that Mesh was computed from
+    vtkWeakPointer<vtkPolyData> Source;
+    vtkMTimeType SourceMTime{0};
+    /// Decimation running in a background thread
+    std::future<vtkSmartPointer<vtkPolyData> > PendingMesh;
+    vtkWeakPointer<vtkPolyData> PendingSource;
+    vtkMTimeType PendingSourceMTime{0};
+    /// Proxy is shown and the full resolution actor is hidden
+    bool Active{false};
+  };
+  std::map<std::string, LevelOfDetailProxy> LevelOfDetailProxies;
+  vtkIdType LevelOfDetailPolygonThreshold{1000000};
+
+  bool UseHardwarePicking{false};
+  vtkSmartPointer<vtkHardwareSelector> HardwareSelector;
+  /// Modification time and size of the view when the selection buffers were captured
+  vtkMTimeType HardwareSelectionBuffersMTime{0};
+  int HardwareSelectionBuffersSize[2] = { 0, 0 };
 };
 
 //---------------------------------------------------------------------------
@@ -175,6 +271,7 @@ void vtkMRMLModelDisplayableManager::vtkInternal::CreateClipSlices()
   this->RedSlicePlane = vtkSmartPointer<vtkPlane>::New();
   this->GreenSlicePlane = vtkSmartPointer<vtkPlane>::New();
   this->YellowSlicePlane = vtkSmartPointer<vtkPlane>::New();
+  this->HardwareClippingPlanes = vtkSmartPointer<vtkPlaneCollection>::New();
 
   this->ClipType = vtkMRMLClipModelsNode::ClipIntersection;
 
@@ -186,6 +283,36 @@ void vtkMRMLModelDisplayableManager::vtkInternal::CreateClipSlices()
   this->ClippingOn = false;
 }
 
+//---------------------------------------------------------------------------
+bool vtkMRMLModelDisplayableManager::vtkInternal::IsHardwareClippingApplicable(vtkMRMLModelNode::MeshTypeHint meshType)
+{
+  // Mapper clip planes only cut through surfaces: whole cell extraction and clipping
+  // of volumetric cells (that exposes internal faces) require clipping the geometry.
+  if (!this->UseHardwareClipping
+    || this->ClippingMethod != vtkMRMLClipModelsNode::Straight
+    || meshType != vtkMRMLModelNode::PolyDataMeshType)
+    {
+    return false;
+    }
+  // A fragment is kept by the mapper if it is on the positive side of all the planes,
+  // which is the union clip type. The intersection clip type only matches it for a single plane.
+  return this->ClipType == vtkMRMLClipModelsNode::ClipUnion
+    || this->HardwareClippingPlanes->GetNumberOfItems() <= 1;
+}
+
+//---------------------------------------------------------------------------
+bool vtkMRMLModelDisplayableManager::vtkInternal::HasSoftwareClippedModels()
+{
+  for (std::map<std::string, int>::iterator it = this->DisplayedClipState.begin(); it != this->DisplayedClipState.end(); ++it)
+    {
+    if (it->second == 1)
+      {
+      return true;
+      }
+    }
+  return false;
+}
+
 //---------------------------------------------------------------------------
 void vtkMRMLModelDisplayableManager::vtkInternal::ResetPick()
 {
@@ -219,6 +346,50 @@ void vtkMRMLModelDisplayableManager::vtkInternal::FindPickedDisplayNodeFromMesh(
         }
       }
     }
+
+  std::map<std::string, vtkSmartPointer<vtkDataSetSurfaceFilter> >::iterator extractorIt;
+  for (extractorIt = this->DisplayNodeSurfaceExtractors.begin(); extractorIt != this->DisplayNodeSurfaceExtractors.end(); ++extractorIt)
+    {
+    if (extractorIt->second->GetOutput() == mesh)
+      {
+      this->PickedDisplayNodeID = extractorIt->first;
+      this->PickedCellID = this->GetDisplayNodeMeshCellID(extractorIt->first, mesh, this->PickedCellID);
+      return; // Display node found
+      }
+    }
+}
+
+//---------------------------------------------------------------------------
+vtkDataSetSurfaceFilter* vtkMRMLModelDisplayableManager::vtkInternal::GetSurfaceExtractor(const std::string& displayNodeID)
+{
+  vtkSmartPointer<vtkDataSetSurfaceFilter>& surfaceExtractor = this->DisplayNodeSurfaceExtractors[displayNodeID];
+  if (!surfaceExtractor)
+    {
+    surfaceExtractor = vtkSmartPointer<vtkDataSetSurfaceFilter>::New();
+    // Keep track of the volumetric cell of each surface cell, for picking
+    surfaceExtractor->PassThroughCellIdsOn();
+    }
+  return surfaceExtractor;
+}
+
+//---------------------------------------------------------------------------
+vtkIdType vtkMRMLModelDisplayableManager::vtkInternal::GetDisplayNodeMeshCellID(
+  const std::string& displayNodeID, vtkDataSet* renderedMesh, vtkIdType cellID)
+{
+  std::map<std::string, vtkSmartPointer<vtkDataSetSurfaceFilter> >::iterator extractorIt =
+    this->DisplayNodeSurfaceExtractors.find(displayNodeID);
+  if (!renderedMesh || cellID < 0 || extractorIt == this->DisplayNodeSurfaceExtractors.end()
+    || extractorIt->second->GetOutput() != renderedMesh)
+    {
+    return cellID;
+    }
+  vtkIdTypeArray* originalCellIds = vtkIdTypeArray::SafeDownCast(
+    renderedMesh->GetCellData()->GetArray("vtkOriginalCellIds"));
+  if (!originalCellIds || cellID >= originalCellIds->GetNumberOfTuples())
+    {
+    return cellID;
+    }
+  return originalCellIds->GetValue(cellID);
 }
 //
 //---------------------------------------------------------------------------
@@ -323,6 +494,254 @@ void vtkMRMLModelDisplayableManager::vtkInternal::FindFirstPickedDisplayNodeFrom
 }
 
 
+//---------------------------------------------------------------------------
+void vtkMRMLModelDisplayableManager::vtkInternal::UpdateLevelOfDetail(bool interacting)
+{
+  if (!this->External->GetRenderer())
+    {
+    return;
+    }
+  std::vector<std::string> removedIDs;
+  for (const auto& proxyIt : this->LevelOfDetailProxies)
+    {
+    if (this->DisplayedActors.find(proxyIt.first) == this->DisplayedActors.end())
+      {
+      removedIDs.push_back(proxyIt.first);
+      }
+    }
+  for (const std::string& id : removedIDs)
+    {
+    this->RemoveLevelOfDetailProxy(id);
+    }
+
+  for (const auto& actorIt : this->DisplayedActors)
+    {
+    const std::string& id = actorIt.first;
+    vtkActor* actor = vtkActor::SafeDownCast(actorIt.second);
+    vtkPolyDataMapper* mapper = actor ? vtkPolyDataMapper::SafeDownCast(actor->GetMapper()) : nullptr;
+    vtkPolyData* mesh = mapper ? mapper->GetInput() : nullptr;
+    std::map<std::string, vtkMRMLDisplayNode*>::iterator displayNodeIt = this->DisplayedNodes.find(id);
+    vtkMRMLDisplayNode* displayNode = (displayNodeIt != this->DisplayedNodes.end() ? displayNodeIt->second : nullptr);
+    // Decimation only keeps triangles and point data
+    bool useProxy = this->LevelOfDetailPolygonThreshold > 0 && mesh
+      && mesh->GetNumberOfPolys() + mesh->GetNumberOfStrips() >= this->LevelOfDetailPolygonThreshold
+      && mesh->GetNumberOfLines() == 0 && mesh->GetNumberOfVerts() == 0
+      && !(displayNode && displayNode->GetScalarVisibility() && vtkMRMLModelDisplayableManager::IsCellScalarsActive(displayNode));
+    if (!useProxy)
+      {
+      if (this->LevelOfDetailProxies.find(id) != this->LevelOfDetailProxies.end())
+        {
+        this->RemoveLevelOfDetailProxy(id);
+        }
+      continue;
+      }
+
+    LevelOfDetailProxy& proxy = this->LevelOfDetailProxies[id];
+    if (!proxy.Actor)
+      {
+      proxy.Actor = vtkSmartPointer<vtkActor>::New();
+      vtkNew<vtkPolyDataMapper> proxyMapper;
+      proxy.Actor->SetMapper(proxyMapper.GetPointer());
+      proxy.Actor->SetPickable(false);
+      proxy.Actor->SetVisibility(false);
+      this->External->GetRenderer()->AddViewProp(proxy.Actor);
+      }
+
+    if (proxy.PendingMesh.valid()
+      && proxy.PendingMesh.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+      {
+      proxy.Mesh = proxy.PendingMesh.get();
+      proxy.Source = proxy.PendingSource;
+      proxy.SourceMTime = proxy.PendingSourceMTime;
+      vtkPolyDataMapper::SafeDownCast(proxy.Actor->GetMapper())->SetInputData(proxy.Mesh);
+      }
+    bool upToDate = (proxy.Mesh && proxy.Source == mesh && proxy.SourceMTime == mesh->GetMTime());
+    if (!upToDate && !proxy.PendingMesh.valid())
+      {
+      // The background thread works on its own copy of the mesh object (sharing the arrays)
+      vtkSmartPointer<vtkPolyData> meshCopy = vtkSmartPointer<vtkPolyData>::New();
+      meshCopy->ShallowCopy(mesh);
+      double targetNumberOfPolygons = this->LevelOfDetailPolygonThreshold / 4.0;
+      double targetReduction = 1.0 - targetNumberOfPolygons / (mesh->GetNumberOfPolys() + mesh->GetNumberOfStrips());
+      proxy.PendingMesh = std::async(std::launch::async, DecimateMesh, meshCopy, targetReduction);
+      proxy.PendingSource = mesh;
+      proxy.PendingSourceMTime = mesh->GetMTime();
+      }
+
+    if (interacting && upToDate)
+      {
+      if (!proxy.Active && actor->GetVisibility())
+        {
+        // Render with the same appearance and position as the full resolution model
+        vtkPolyDataMapper* proxyMapper = vtkPolyDataMapper::SafeDownCast(proxy.Actor->GetMapper());
+        proxyMapper->ShallowCopy(mapper);
+        proxyMapper->SetInputData(proxy.Mesh);
+        proxy.Actor->SetProperty(actor->GetProperty());
+        proxy.Actor->SetBackfaceProperty(actor->GetBackfaceProperty());
+        proxy.Actor->SetTexture(actor->GetTexture());
+        proxy.Actor->SetUserMatrix(actor->GetUserMatrix());
+        proxy.Actor->SetVisibility(true);
+        actor->SetVisibility(false);
+        proxy.Active = true;
+        }
+      }
+    else if (proxy.Active)
+      {
+      actor->SetVisibility(true);
+      proxy.Actor->SetVisibility(false);
+      proxy.Active = false;
+      }
+    }
+}
+
+//---------------------------------------------------------------------------
+void vtkMRMLModelDisplayableManager::vtkInternal::RemoveLevelOfDetailProxy(const std::string& displayNodeID)
+{
+  std::map<std::string, LevelOfDetailProxy>::iterator proxyIt = this->LevelOfDetailProxies.find(displayNodeID);
+  if (proxyIt == this->LevelOfDetailProxies.end())
+    {
+    return;
+    }
+  if (proxyIt->second.Active)
+    {
+    std::map<std::string, vtkProp3D*>::iterator actorIt = this->DisplayedActors.find(displayNodeID);
+    if (actorIt != this->DisplayedActors.end())
+      {
+      actorIt->second->SetVisibility(true);
+      }
+    }
+  if (proxyIt->second.Actor && this->External->GetRenderer())
+    {
+    this->External->GetRenderer()->RemoveViewProp(proxyIt->second.Actor);
+    }
+  // Waits for the decimation to complete if it is still running
+  this->LevelOfDetailProxies.erase(proxyIt);
+}
+
+//---------------------------------------------------------------------------
+vtkMTimeType vtkMRMLModelDisplayableManager::vtkInternal::GetHardwareSelectionMTime(vtkRenderer* renderer)
+{
+  vtkPropCollection* props = renderer->GetViewProps();
+  vtkMTimeType mtime = props->GetMTime();
+  if (renderer->GetActiveCamera())
+    {
+    mtime = std::max(mtime, renderer->GetActiveCamera()->GetMTime());
+    }
+  vtkCollectionSimpleIterator it;
+  props->InitTraversal(it);
+  while (vtkProp* prop = props->GetNextProp(it))
+    {
+    if (!prop->GetVisibility())
+      {
+      continue;
+      }
+    if (prop->IsA("vtkVolume"))
+      {
+      return 0;
+      }
+    // Redraw time includes changes in the mapper and the rendered data
+    mtime = std::max(mtime, prop->GetRedrawMTime());
+    }
+  return mtime;
+}
+
+//---------------------------------------------------------------------------
+bool vtkMRMLModelDisplayableManager::vtkInternal::HardwarePick(vtkRenderer* renderer, double displayPosition[2],
+  double pickPoint[3], vtkPointSet*& pickedMesh, vtkIdType& pickedCellId)
+{
+  pickedMesh = nullptr;
+  pickedCellId = -1;
+  int* size = renderer->GetSize();
+  if (displayPosition[0] < 0 || displayPosition[1] < 0 || displayPosition[0] >= size[0] || displayPosition[1] >= size[1])
+    {
+    return false;
+    }
+  vtkMTimeType selectionMTime = this->GetHardwareSelectionMTime(renderer);
+  if (selectionMTime == 0)
+    {
+    return false;
+    }
+
+  if (!this->HardwareSelector)
+    {
+    this->HardwareSelector = vtkSmartPointer<vtkHardwareSelector>::New();
+    this->HardwareSelector->SetFieldAssociation(vtkDataObject::FIELD_ASSOCIATION_CELLS);
+    }
+  if (selectionMTime != this->HardwareSelectionBuffersMTime
+    || size[0] != this->HardwareSelectionBuffersSize[0] || size[1] != this->HardwareSelectionBuffersSize[1])
+    {
+    int* origin = renderer->GetOrigin();
+    this->HardwareSelector->SetRenderer(renderer);
+    this->HardwareSelector->SetArea(origin[0], origin[1], origin[0] + size[0] - 1, origin[1] + size[1] - 1);
+    if (!this->HardwareSelector->CaptureBuffers())
+      {
+      this->HardwareSelectionBuffersMTime = 0;
+      return false;
+      }
+    // Rendering the selection passes may modify the camera (clipping range)
+    this->HardwareSelectionBuffersMTime = this->GetHardwareSelectionMTime(renderer);
+    this->HardwareSelectionBuffersSize[0] = size[0];
+    this->HardwareSelectionBuffersSize[1] = size[1];
+    }
+
+  unsigned int bufferPosition[2] =
+    {
+    static_cast<unsigned int>(renderer->GetOrigin()[0] + displayPosition[0]),
+    static_cast<unsigned int>(renderer->GetOrigin()[1] + displayPosition[1])
+    };
+  vtkHardwareSelector::PixelInformation pixelInformation = this->HardwareSelector->GetPixelInformation(bufferPosition);
+  vtkActor* actor = pixelInformation.Valid ? vtkActor::SafeDownCast(pixelInformation.Prop) : nullptr;
+  vtkPointSet* mesh = (actor && actor->GetMapper()) ? vtkPointSet::SafeDownCast(actor->GetMapper()->GetInput()) : nullptr;
+  if (!mesh || pixelInformation.AttributeID < 0 || pixelInformation.AttributeID >= mesh->GetNumberOfCells())
+    {
+    return false;
+    }
+
+  // Get exact position by intersecting the pick ray with the picked cell in mesh coordinates
+  vtkNew<vtkMatrix4x4> worldToMesh;
+  worldToMesh->DeepCopy(actor->GetMatrix());
+  worldToMesh->Invert();
+  double rayPoints[2][4] = { { 0.0, 0.0, 0.0, 1.0 }, { 0.0, 0.0, 0.0, 1.0 } };
+  for (int rayPointIndex = 0; rayPointIndex < 2; ++rayPointIndex)
+    {
+    double worldPoint[4] = { 0.0, 0.0, 0.0, 1.0 };
+    renderer->SetDisplayPoint(displayPosition[0], displayPosition[1], rayPointIndex);
+    renderer->DisplayToWorld();
+    renderer->GetWorldPoint(worldPoint);
+    if (worldPoint[3] == 0.0)
+      {
+      return false;
+      }
+    for (int i = 0; i < 3; ++i)
+      {
+      worldPoint[i] /= worldPoint[3];
+      }
+    worldPoint[3] = 1.0;
+    worldToMesh->MultiplyPoint(worldPoint, rayPoints[rayPointIndex]);
+    }
+  vtkCell* cell = mesh->GetCell(pixelInformation.AttributeID);
+  double t = 0.0;
+  double meshPoint[4] = { 0.0, 0.0, 0.0, 1.0 };
+  double pcoords[3] = { 0.0, 0.0, 0.0 };
+  int subId = 0;
+  if (!cell->IntersectWithLine(rayPoints[0], rayPoints[1], 0.0, t, meshPoint, pcoords, subId))
+    {
+    // The ray through the pixel center may just miss the cell that covers most of the pixel
+    std::vector<double> weights(std::max(cell->GetNumberOfPoints(), vtkIdType(1)));
+    subId = cell->GetParametricCenter(pcoords);
+    cell->EvaluateLocation(subId, pcoords, meshPoint, weights.data());
+    }
+  double worldPoint[4] = { 0.0, 0.0, 0.0, 1.0 };
+  actor->GetMatrix()->MultiplyPoint(meshPoint, worldPoint);
+  for (int i = 0; i < 3; ++i)
+    {
+    pickPoint[i] = worldPoint[i];
+    }
+  pickedMesh = mesh;
+  pickedCellId = pixelInformation.AttributeID;
+  return true;
+}
+
 //---------------------------------------------------------------------------
 // vtkMRMLModelDisplayableManager methods
 
@@ -332,6 +751,10 @@ vtkMRMLModelDisplayableManager::vtkMRMLModelDisplayableManager()
   this->Internal = new vtkInternal(this);
 
   this->Internal->CreateClipSlices();
+
+  this->AddInteractorStyleObservableEvent(vtkCommand::StartInteractionEvent);
+  this->AddInteractorStyleObservableEvent(vtkCommand::InteractionEvent);
+  this->AddInteractorStyleObservableEvent(vtkCommand::EndInteractionEvent);
 }
 
 //---------------------------------------------------------------------------
@@ -537,6 +960,20 @@ int vtkMRMLModelDisplayableManager::UpdateClipSlicesFromMRML()
     this->Internal->ClippingMethod = this->Internal->ClipModelsNode->GetClippingMethod();
     }
 
+  this->Internal->HardwareClippingPlanes->RemoveAllItems();
+  if (this->Internal->RedSliceClipState != vtkMRMLClipModelsNode::ClipOff)
+    {
+    this->Internal->HardwareClippingPlanes->AddItem(this->Internal->RedSlicePlane);
+    }
+  if (this->Internal->GreenSliceClipState != vtkMRMLClipModelsNode::ClipOff)
+    {
+    this->Internal->HardwareClippingPlanes->AddItem(this->Internal->GreenSlicePlane);
+    }
+  if (this->Internal->YellowSliceClipState != vtkMRMLClipModelsNode::ClipOff)
+    {
+    this->Internal->HardwareClippingPlanes->AddItem(this->Internal->YellowSlicePlane);
+    }
+
   // compute clipping on/off
   if (this->Internal->ClipModelsNode->GetRedSliceClipState() == vtkMRMLClipModelsNode::ClipOff &&
       this->Internal->ClipModelsNode->GetGreenSliceClipState() == vtkMRMLClipModelsNode::ClipOff &&
@@ -650,10 +1087,16 @@ void vtkMRMLModelDisplayableManager::ProcessMRMLNodesEvents(vtkObject *caller,
     bool requestRender = true;
     if (event == vtkCommand::ModifiedEvent)
       {
-      if (this->UpdateClipSlicesFromMRML() || this->Internal->ClippingOn)
+      if (this->UpdateClipSlicesFromMRML()
+        || (this->Internal->ClippingOn && this->Internal->HasSoftwareClippedModels()))
         {
         this->SetUpdateFromMRMLRequested(true);
         }
+      else if (this->Internal->ClippingOn)
+        {
+        // Slice planes are updated, hardware clipped models only need to be rendered
+        requestRender = true;
+        }
       else
         {
         requestRender = vtkMRMLSliceNode::SafeDownCast(caller)->GetSliceVisible() == 1;
@@ -956,6 +1399,7 @@ void vtkMRMLModelDisplayableManager::UpdateModelsFromMRML()
     this->Internal->DisplayedNodes.clear();
     this->Internal->DisplayedClipState.clear();
     this->Internal->DisplayNodeTransformFilters.clear();
+    this->Internal->DisplayNodeSurfaceExtractors.clear();
     }
 
   // render slices first
@@ -1127,8 +1571,9 @@ void vtkMRMLModelDisplayableManager::UpdateModelMesh(vtkMRMLDisplayableNode *dis
         {
         cit = this->Internal->DisplayedClipState.find(modelDisplayNode->GetID());
         }
-      if (cit != this->Internal->DisplayedClipState.end() && cit->second == clipping )
+      if (cit != this->Internal->DisplayedClipState.end() && (cit->second != 0) == (clipping != 0))
         {
+        bool hardwareClipped = (cit->second == 2);
         // make sure that we are looking at the current mesh (most of the code in here
         // assumes a display node will never change what mesh it wants to view and hence
         // caches information to skip steps if the display node has already rendered. but we
@@ -1138,16 +1583,33 @@ void vtkMRMLModelDisplayableManager::UpdateModelMesh(vtkMRMLDisplayableNode *dis
         if (actor && actor->GetMapper())
           {
           vtkMapper *mapper = actor->GetMapper();
+          vtkAlgorithmOutput* mapperInput = nullptr;
           if (transformFilter)
             {
-            mapper->SetInputConnection(transformFilter->GetOutputPort());
+            mapperInput = transformFilter->GetOutputPort();
+            }
+          else if (mapper && (!(this->Internal->ClippingOn && clipping) || hardwareClipped))
+            {
+            mapperInput = meshConnection;
             }
-          else if (mapper && !(this->Internal->ClippingOn && clipping))
+          // geometry clipped unstructured grids are rendered by vtkDataSetMapper
+          bool surfaceExtracted = (meshType == vtkMRMLModelNode::UnstructuredGridMeshType && cit->second != 1);
+          if (mapperInput)
             {
-            mapper->SetInputConnection(meshConnection);
+            if (surfaceExtracted)
+              {
+              vtkDataSetSurfaceFilter* surfaceExtractor = this->Internal->GetSurfaceExtractor(displayNode->GetID());
+              surfaceExtractor->SetInputConnection(mapperInput);
+              mapperInput = surfaceExtractor->GetOutputPort();
+              }
+            else
+              {
+              this->Internal->DisplayNodeSurfaceExtractors.erase(displayNode->GetID());
+              }
+            mapper->SetInputConnection(mapperInput);
             }
-          if ((meshType == vtkMRMLModelNode::UnstructuredGridMeshType && mapper->IsA("vtkDataSetMapper"))
-            || (meshType == vtkMRMLModelNode::PolyDataMeshType && mapper->IsA("vtkPolyDataMapper")))
+          if ((meshType == vtkMRMLModelNode::UnstructuredGridMeshType && !surfaceExtracted && mapper->IsA("vtkDataSetMapper"))
+            || ((meshType == vtkMRMLModelNode::PolyDataMeshType || surfaceExtracted) && mapper->IsA("vtkPolyDataMapper")))
             {
             mapperUpdateNeeded = false;
             }
@@ -1155,7 +1617,8 @@ void vtkMRMLModelDisplayableManager::UpdateModelMesh(vtkMRMLDisplayableNode *dis
         vtkMRMLTransformNode* tnode = displayableNode->GetParentTransformNode();
         // clipped model could be transformed
         // TODO: handle non-linear transforms
-        if ((clipping == 0 || tnode == nullptr || !tnode->IsTransformToWorldLinear()) && !mapperUpdateNeeded)
+        // hardware clip planes are defined in world coordinates, they do not depend on the transform
+        if ((clipping == 0 || hardwareClipped || tnode == nullptr || !tnode->IsTransformToWorldLinear()) && !mapperUpdateNeeded)
           {
           continue;
           }
@@ -1164,15 +1627,25 @@ void vtkMRMLModelDisplayableManager::UpdateModelMesh(vtkMRMLDisplayableNode *dis
 
     vtkActor *actor = vtkActor::SafeDownCast(prop);
     vtkAlgorithm *clipper = nullptr;
+    bool hardwareClipping = false;
     if(actor)
       {
       if (this->Internal->ClippingOn && modelDisplayNode != nullptr && clipping)
         {
-        clipper = this->CreateTransformedClipper(modelNode->GetParentTransformNode(), meshType);
+        hardwareClipping = this->Internal->IsHardwareClippingApplicable(meshType);
+        if (!hardwareClipping)
+          {
+          clipper = this->CreateTransformedClipper(modelNode->GetParentTransformNode(), meshType);
+          }
         }
 
+      // Unstructured grids are rendered by their outer surface, which is cached in a surface
+      // extractor filter (vtkDataSetMapper would extract the surface again for each new mapper).
+      // Geometry clipped unstructured grids are rendered by vtkDataSetMapper, as clipping
+      // reveals internal cells.
+      bool surfaceExtracted = (meshType == vtkMRMLModelNode::UnstructuredGridMeshType && !clipper);
       vtkMapper *mapper = nullptr;
-      if (meshType == vtkMRMLModelNode::UnstructuredGridMeshType)
+      if (meshType == vtkMRMLModelNode::UnstructuredGridMeshType && !surfaceExtracted)
         {
         mapper = vtkDataSetMapper::New();
         }
@@ -1181,19 +1654,26 @@ void vtkMRMLModelDisplayableManager::UpdateModelMesh(vtkMRMLDisplayableNode *dis
         mapper = vtkPolyDataMapper::New();
         }
 
+      vtkAlgorithmOutput* mapperInput = (transformFilter ? transformFilter->GetOutputPort() : meshConnection);
       if (clipper)
         {
-        if (transformFilter) clipper->SetInputConnection(transformFilter->GetOutputPort());
-        else clipper->SetInputConnection(meshConnection);
-        mapper->SetInputConnection(clipper->GetOutputPort());
+        clipper->SetInputConnection(mapperInput);
+        mapperInput = clipper->GetOutputPort();
         }
-      else if (transformFilter)
+      if (surfaceExtracted)
         {
-        mapper->SetInputConnection(transformFilter->GetOutputPort());
+        vtkDataSetSurfaceFilter* surfaceExtractor = this->Internal->GetSurfaceExtractor(displayNode->GetID());
+        surfaceExtractor->SetInputConnection(mapperInput);
+        mapperInput = surfaceExtractor->GetOutputPort();
         }
       else
         {
-        mapper->SetInputConnection(meshConnection);
+        this->Internal->DisplayNodeSurfaceExtractors.erase(displayNode->GetID());
+        }
+      mapper->SetInputConnection(mapperInput);
+      if (hardwareClipping)
+        {
+        mapper->SetClippingPlanes(this->Internal->HardwareClippingPlanes);
         }
 
       actor->SetMapper(mapper);
@@ -1213,7 +1693,7 @@ void vtkMRMLModelDisplayableManager::UpdateModelMesh(vtkMRMLDisplayableNode *dis
         }
       else
         {
-        this->Internal->DisplayedClipState[modelDisplayNode->GetID()] = 0;
+        this->Internal->DisplayedClipState[modelDisplayNode->GetID()] = (hardwareClipping ? 2 : 0);
         }
       prop->Delete();
       }
@@ -1230,7 +1710,7 @@ void vtkMRMLModelDisplayableManager::UpdateModelMesh(vtkMRMLDisplayableNode *dis
         }
       else
         {
-        this->Internal->DisplayedClipState[modelDisplayNode->GetID()] = 0;
+        this->Internal->DisplayedClipState[modelDisplayNode->GetID()] = (hardwareClipping ? 2 : 0);
         }
       }
     }
@@ -1345,8 +1825,10 @@ void vtkMRMLModelDisplayableManager::RemoveDisplayable(vtkMRMLDisplayableNode* m
 void vtkMRMLModelDisplayableManager::RemoveDispalyedID(std::string &id)
 {
   std::map<std::string, vtkMRMLDisplayNode *>::iterator modelIter;
+  this->Internal->RemoveLevelOfDetailProxy(id);
   this->Internal->DisplayedActors.erase(id);
   this->Internal->DisplayedClipState.erase(id);
+  this->Internal->DisplayNodeSurfaceExtractors.erase(id);
   modelIter = this->Internal->DisplayedNodes.find(id);
   if (modelIter != this->Internal->DisplayedNodes.end())
     {
@@ -1799,7 +2281,15 @@ int vtkMRMLModelDisplayableManager::Pick(int x, int y)
   displayPoint[1] = renSize[1] - y;
   displayPoint[2] = 0.0;
 
-  if (this->Internal->CellPicker->Pick(displayPoint[0], displayPoint[1], displayPoint[2], ren))
+  vtkPointSet* hardwarePickedMesh = nullptr;
+  vtkIdType hardwarePickedCellId = -1;
+  if (this->Internal->UseHardwarePicking
+    && this->Internal->HardwarePick(ren, displayPoint, pickPoint, hardwarePickedMesh, hardwarePickedCellId))
+    {
+    this->SetPickedCellID(hardwarePickedCellId);
+    this->Internal->FindPickedDisplayNodeFromMesh(hardwarePickedMesh, pickPoint);
+    }
+  else if (this->Internal->CellPicker->Pick(displayPoint[0], displayPoint[1], displayPoint[2], ren))
     {
     this->Internal->CellPicker->GetPickPosition(pickPoint);
     this->SetPickedCellID(this->Internal->CellPicker->GetCellId());
@@ -1862,6 +2352,8 @@ int vtkMRMLModelDisplayableManager::Pick3D(double ras[3])
     // Note: Getting the mesh using GetDataSet is not a good solution as the dataset is the first
     //   one that is picked and it may be of different type (volume, segmentation, etc.)
     this->Internal->FindFirstPickedDisplayNodeFromPickerProp3Ds();
+    this->SetPickedCellID(this->Internal->GetDisplayNodeMeshCellID(this->Internal->PickedDisplayNodeID,
+      this->Internal->CellPicker->GetDataSet(), this->Internal->PickedCellID));
     // Find picked point in mesh
     vtkMRMLModelDisplayNode* displayNode = vtkMRMLModelDisplayNode::SafeDownCast(
       this->GetMRMLScene()->GetNodeByID(this->Internal->PickedDisplayNodeID.c_str()) );
@@ -1933,6 +2425,67 @@ vtkIdType vtkMRMLModelDisplayableManager::GetPickedPointID()
   return this->Internal->PickedPointID;
 }
 
+//---------------------------------------------------------------------------
+void vtkMRMLModelDisplayableManager::SetUseHardwarePicking(bool use)
+{
+  if (this->Internal->UseHardwarePicking == use)
+    {
+    return;
+    }
+  this->Internal->UseHardwarePicking = use;
+  if (!use)
+    {
+    // Release selection buffers
+    this->Internal->HardwareSelector = nullptr;
+    this->Internal->HardwareSelectionBuffersMTime = 0;
+    }
+  this->Modified();
+}
+
+//---------------------------------------------------------------------------
+bool vtkMRMLModelDisplayableManager::GetUseHardwarePicking()
+{
+  return this->Internal->UseHardwarePicking;
+}
+
+//---------------------------------------------------------------------------
+void vtkMRMLModelDisplayableManager::SetUseHardwareClipping(bool use)
+{
+  if (this->Internal->UseHardwareClipping == use)
+    {
+    return;
+    }
+  this->Internal->UseHardwareClipping = use;
+  // Clipped models are recreated with the new clipping mode
+  this->SetUpdateFromMRMLRequested(true);
+  this->RequestRender();
+  this->Modified();
+}
+
+//---------------------------------------------------------------------------
+bool vtkMRMLModelDisplayableManager::GetUseHardwareClipping()
+{
+  return this->Internal->UseHardwareClipping;
+}
+
+//---------------------------------------------------------------------------
+void vtkMRMLModelDisplayableManager::SetLevelOfDetailPolygonThreshold(vtkIdType numberOfPolygons)
+{
+  if (this->Internal->LevelOfDetailPolygonThreshold == numberOfPolygons)
+    {
+    return;
+    }
+  this->Internal->LevelOfDetailPolygonThreshold = numberOfPolygons;
+  this->Internal->UpdateLevelOfDetail(false);
+  this->Modified();
+}
+
+//---------------------------------------------------------------------------
+vtkIdType vtkMRMLModelDisplayableManager::GetLevelOfDetailPolygonThreshold()
+{
+  return this->Internal->LevelOfDetailPolygonThreshold;
+}
+
 //---------------------------------------------------------------------------
 void vtkMRMLModelDisplayableManager::SetPickedPointID(vtkIdType newPointID)
 {
@@ -2058,6 +2611,19 @@ vtkAlgorithm* vtkMRMLModelDisplayableManager
 //---------------------------------------------------------------------------
 void vtkMRMLModelDisplayableManager::OnInteractorStyleEvent(int eventid)
 {
+  if (eventid == vtkCommand::StartInteractionEvent || eventid == vtkCommand::InteractionEvent)
+    {
+    // Also switches to proxies whose decimation completed since the interaction started
+    this->Internal->UpdateLevelOfDetail(true);
+    return;
+    }
+  else if (eventid == vtkCommand::EndInteractionEvent)
+    {
+    this->Internal->UpdateLevelOfDetail(false);
+    this->RequestRender();
+    return;
+    }
+
   bool keyPressed = false;
   char *keySym = this->GetInteractor()->GetKeySym();
   if (keySym && strcmp(keySym, "i") == 0)
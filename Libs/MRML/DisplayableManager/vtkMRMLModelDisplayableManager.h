@@ -85,6 +85,24 @@ public:
   /// Set tolerance for Pick() method. It will call vtkCellPicker.SetTolerance()
   void SetPickTolerance(double tolerance);
 
+  /// Use the graphics hardware for Pick(): the view is rendered into an ID buffer
+  /// once after each camera or scene change and picks are answered by looking up the
+  /// prop and cell at the position in the buffer, which is much faster than casting
+  /// a ray against all cells of large meshes.
+  /// Picking in empty space and in views that contain volume rendering uses the cell picker.
+  /// Disabled by default.
+  void SetUseHardwarePicking(bool use);
+  bool GetUseHardwarePicking();
+
+  /// Clip models by slice planes (see vtkMRMLClipModelsNode) in the mapper, using
+  /// graphics hardware clip planes, instead of clipping the mesh geometry.
+  /// Moving a slice then only requires rendering the view. Used for the straight
+  /// clipping method of surface models, if clipped by a single plane or by the union
+  /// of planes. Mesh geometry is clipped for all other clipping configurations.
+  /// Enabled by default.
+  void SetUseHardwareClipping(bool use);
+  bool GetUseHardwareClipping();
+
   /// Get the MRML ID of the picked node, returns empty string if no pick
   const char* GetPickedNodeID() override;
 
@@ -118,6 +136,14 @@ public:
   ///   False otherwise.
   static bool IsCellScalarsActive(vtkMRMLDisplayNode* displayNode, vtkMRMLModelNode* model = nullptr);
 
+  /// Models with at least this many polygons are rendered using a decimated copy
+  /// while the view is being interacted with (rotated, zoomed, etc.).
+  /// Decimated copies are computed in background threads, a model is rendered at
+  /// full resolution until its copy is available.
+  /// 0 disables level of detail. Default is 1000000.
+  void SetLevelOfDetailPolygonThreshold(vtkIdType numberOfPolygons);
+  vtkIdType GetLevelOfDetailPolygonThreshold();
+
 protected:
   int ActiveInteractionModes() override;
 
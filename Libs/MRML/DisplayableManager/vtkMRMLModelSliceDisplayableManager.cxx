@@ -56,6 +56,7 @@
 #include <vtkTransform.h>
 #include <vtkTransformFilter.h>
 #include <vtkTransformPolyDataFilter.h>
+#include <vtkUnstructuredGrid.h>
 #include <vtkWeakPointer.h>
 
 // VTK includes: customization
@@ -493,6 +494,18 @@ void vtkMRMLModelSliceDisplayableManager::vtkInternal
   else
     {
     // show intersection in the slice view
+
+    // Skip cutting if the model does not intersect the slice plane.
+    // Bounds of the transformed model are only recomputed when the mesh or its transform changes.
+    pipeline->ModelWarper->Update();
+    double modelBoundsRAS[6];
+    pipeline->ModelWarper->GetOutput()->GetBounds(modelBoundsRAS);
+    if (!vtkMRMLAbstractSliceViewDisplayableManager::IsBoundingBoxIntersectingSlicePlane(modelBoundsRAS, this->SliceXYToRAS))
+      {
+      pipeline->Actor->SetVisibility(false);
+      return;
+      }
+
     // include clipper in the pipeline
 #if VTK_MAJOR_VERSION >= 9 || (VTK_MAJOR_VERSION >= 8 && VTK_MINOR_VERSION >= 2)
     pipeline->Transformer->SetInputConnection(pipeline->GeometryFilter->GetOutputPort());
@@ -513,6 +526,11 @@ void vtkMRMLModelSliceDisplayableManager::vtkInternal
     pipeline->Cutter->SetInputConnection(pipeline->ModelWarper->GetOutputPort());
 
 #if VTK_MAJOR_VERSION >= 9 || (VTK_MAJOR_VERSION >= 8 && VTK_MINOR_VERSION >= 2)
+    // The sphere tree of volumetric meshes is only built again when the mesh or its transform changes,
+    // therefore moving the slice does not require visiting all the cells of the mesh.
+    // It is not used for surface meshes, as the cutter crashes for complex surfaces if the tree is built.
+    pipeline->Cutter->SetBuildTree(vtkUnstructuredGrid::SafeDownCast(pointSet) != nullptr);
+
     // If there is no input or if the input has no points, the vtkTransformPolyDataFilter will display an error message
     // on every update: "No input data".
     // To prevent the error, if the input is empty then the actor should not be visible since there is nothing to display.
@@ -32,6 +32,7 @@
 // STD includes
 #include <sstream>
 #include <string>
+#include <vector>
 
 
 //-----------------------------------------------------------------------------
@@ -39,6 +40,7 @@ int SliceLogicsTest();
 int SliceOrientationPresetInitializationTest();
 int TemporaryPathTest();
 int CreateUniqueFileNameTest(std::string tempDir);
+int MemoryBudgetTest();
 
 //-----------------------------------------------------------------------------
 int vtkMRMLApplicationLogicTest1(int argc, char *argv [])
@@ -57,6 +59,7 @@ int vtkMRMLApplicationLogicTest1(int argc, char *argv [])
   CHECK_EXIT_SUCCESS(SliceOrientationPresetInitializationTest());
   CHECK_EXIT_SUCCESS(TemporaryPathTest());
   CHECK_EXIT_SUCCESS(CreateUniqueFileNameTest(tempDir));
+  CHECK_EXIT_SUCCESS(MemoryBudgetTest());
   return EXIT_SUCCESS;
 }
 
@@ -239,3 +242,76 @@ int CreateUniqueFileNameTest(std::string tempDir)
 
   return EXIT_SUCCESS;
 }
+
+//-----------------------------------------------------------------------------
+int MemoryBudgetTest()
+{
+  vtkNew<vtkMRMLApplicationLogic> appLogic;
+  vtkNew<vtkMRMLScene> scene;
+  appLogic->SetMRMLScene(scene);
+
+  // Undo stack is registered by default
+  CHECK_INT(appLogic->GetNumberOfMemoryCaches(), 1);
+  CHECK_INT(appLogic->GetMemoryBudget(), 0);
+
+  unsigned long cheapCacheSize = 100;
+  unsigned long expensiveCacheSize = 200;
+  std::vector<std::string> releasedCaches;
+
+  vtkMRMLApplicationLogic::MemoryCacheType expensiveCache;
+  expensiveCache.Name = "Expensive";
+  expensiveCache.RegenerationCost = 5.0;
+  expensiveCache.GetMemorySize = [&]() { return expensiveCacheSize; };
+  expensiveCache.Release = [&]() { expensiveCacheSize = 0; releasedCaches.push_back("Expensive"); };
+  int expensiveCacheId = appLogic->AddMemoryCache(expensiveCache);
+
+  vtkMRMLApplicationLogic::MemoryCacheType cheapCache;
+  cheapCache.Name = "Cheap";
+  cheapCache.RegenerationCost = 1.0;
+  cheapCache.GetMemorySize = [&]() { return cheapCacheSize; };
+  cheapCache.Release = [&]() { cheapCacheSize = 0; releasedCaches.push_back("Cheap"); };
+  int cheapCacheId = appLogic->AddMemoryCache(cheapCache);
+
+  CHECK_INT(appLogic->GetNumberOfMemoryCaches(), 3);
+  CHECK_BOOL(cheapCacheId != expensiveCacheId, true);
+  CHECK_INT(appLogic->GetMemoryUsage(), 300);
+
+  // No budget, nothing is released
+  CHECK_INT(appLogic->EnforceMemoryBudget(), 0);
+  CHECK_INT(static_cast<int>(releasedCaches.size()), 0);
+
+  // Releasing the cheap cache is enough to fit in the budget
+  appLogic->SetMemoryBudget(250);
+  CHECK_INT(static_cast<int>(releasedCaches.size()), 1);
+  CHECK_STD_STRING(releasedCaches[0], "Cheap");
+  CHECK_INT(appLogic->GetMemoryUsage(), 200);
+
+  // Caches of the same cost are released in least recently used order
+  cheapCacheSize = 100;
+  releasedCaches.clear();
+  vtkMRMLApplicationLogic::MemoryCacheType otherCheapCache = cheapCache;
+  otherCheapCache.Name = "OtherCheap";
+  unsigned long otherCheapCacheSize = 150;
+  otherCheapCache.GetMemorySize = [&]() { return otherCheapCacheSize; };
+  otherCheapCache.Release = [&]() { otherCheapCacheSize = 0; releasedCaches.push_back("OtherCheap"); };
+  int otherCheapCacheId = appLogic->AddMemoryCache(otherCheapCache);
+  appLogic->SetMemoryCacheUsed(otherCheapCacheId);
+  appLogic->SetMemoryCacheUsed(cheapCacheId);
+  CHECK_INT(appLogic->EnforceMemoryBudget(), 150);
+  CHECK_INT(static_cast<int>(releasedCaches.size()), 1);
+  CHECK_STD_STRING(releasedCaches[0], "OtherCheap");
+
+  // Removed caches are not released
+  appLogic->RemoveMemoryCache(cheapCacheId);
+  appLogic->RemoveMemoryCache(otherCheapCacheId);
+  CHECK_INT(appLogic->GetNumberOfMemoryCaches(), 2);
+  releasedCaches.clear();
+  appLogic->SetMemoryBudget(50);
+  CHECK_INT(static_cast<int>(releasedCaches.size()), 1);
+  CHECK_STD_STRING(releasedCaches[0], "Expensive");
+  CHECK_INT(appLogic->GetMemoryUsage(), 0);
+
+  appLogic->RemoveMemoryCache(expensiveCacheId);
+  appLogic->SetMRMLScene(nullptr);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,214 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2005 Brigham and Women's Hospital (BWH)
+  All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Program:   3D Slicer
+
+=========================================================================auto=*/
+
+// MRMLLogic includes
+#include "vtkMRMLSliceLogic.h"
+#include "vtkMRMLSliceLayerLogic.h"
+
+// MRML includes
+#include <vtkMRMLScalarVolumeDisplayNode.h>
+#include <vtkMRMLScalarVolumeNode.h>
+#include <vtkMRMLScene.h>
+#include <vtkMRMLSegmentationDisplayNode.h>
+#include <vtkMRMLSegmentationNode.h>
+#include <vtkMRMLSliceCompositeNode.h>
+#include <vtkMRMLSliceNode.h>
+
+// SegmentationCore includes
+#include <vtkOrientedImageData.h>
+#include <vtkSegment.h>
+#include <vtkSegmentation.h>
+#include <vtkSegmentationConverter.h>
+
+// VTK includes
+#include <vtkDoubleArray.h>
+#include <vtkImageData.h>
+#include <vtkIntArray.h>
+#include <vtkMath.h>
+#include <vtkMatrix4x4.h>
+#include <vtkNew.h>
+#include <vtkStringArray.h>
+
+// STD includes
+#include <sstream>
+
+#include "vtkMRMLCoreTestingMacros.h"
+
+namespace
+{
+
+const int NUMBER_OF_SEGMENTS = 200;
+
+//----------------------------------------------------------------------------
+void RASToXYZ(vtkMRMLSliceNode* sliceNode, const double ras[3], double xyz[3])
+{
+  vtkNew<vtkMatrix4x4> rasToXY;
+  vtkMatrix4x4::Invert(sliceNode->GetXYToRAS(), rasToXY.GetPointer());
+  double rasw[4] = { ras[0], ras[1], ras[2], 1.0 };
+  double xyzw[4] = { 0.0, 0.0, 0.0, 1.0 };
+  rasToXY->MultiplyPoint(rasw, xyzw);
+  xyz[0] = xyzw[0];
+  xyz[1] = xyzw[1];
+  xyz[2] = xyzw[2];
+}
+
+//----------------------------------------------------------------------------
+vtkMRMLScalarVolumeNode* AddVolume(vtkMRMLScene* scene)
+{
+  vtkNew<vtkImageData> imageData;
+  imageData->SetDimensions(10, 10, 10);
+  imageData->AllocateScalars(VTK_SHORT, 1);
+  for (int k = 0; k < 10; ++k)
+    {
+    for (int j = 0; j < 10; ++j)
+      {
+      for (int i = 0; i < 10; ++i)
+        {
+        imageData->SetScalarComponentFromDouble(i, j, k, 0, i + 10 * j + 100 * k);
+        }
+      }
+    }
+  vtkMRMLScalarVolumeNode* volumeNode = vtkMRMLScalarVolumeNode::SafeDownCast(
+    scene->AddNewNodeByClass("vtkMRMLScalarVolumeNode"));
+  volumeNode->SetAndObserveImageData(imageData.GetPointer());
+  vtkMRMLScalarVolumeDisplayNode* displayNode = vtkMRMLScalarVolumeDisplayNode::SafeDownCast(
+    scene->AddNewNodeByClass("vtkMRMLScalarVolumeDisplayNode"));
+  volumeNode->SetAndObserveDisplayNodeID(displayNode->GetID());
+  return volumeNode;
+}
+
+//----------------------------------------------------------------------------
+/// All segments share the same labelmap, voxel value is 1 + (i + 10 * j) % NUMBER_OF_SEGMENTS
+vtkMRMLSegmentationNode* AddSegmentation(vtkMRMLScene* scene)
+{
+  const std::string labelmapName = vtkSegmentationConverter::GetBinaryLabelmapRepresentationName();
+  vtkNew<vtkOrientedImageData> labelmap;
+  labelmap->SetDimensions(10, 10, 10);
+  labelmap->AllocateScalars(VTK_UNSIGNED_CHAR, 1);
+  for (int k = 0; k < 10; ++k)
+    {
+    for (int j = 0; j < 10; ++j)
+      {
+      for (int i = 0; i < 10; ++i)
+        {
+        labelmap->SetScalarComponentFromDouble(i, j, k, 0, 1 + (i + 10 * j) % NUMBER_OF_SEGMENTS);
+        }
+      }
+    }
+
+  vtkMRMLSegmentationNode* segmentationNode = vtkMRMLSegmentationNode::SafeDownCast(
+    scene->AddNewNodeByClass("vtkMRMLSegmentationNode"));
+  vtkSegmentation* segmentation = segmentationNode->GetSegmentation();
+  segmentation->SetMasterRepresentationName(labelmapName);
+  for (int segmentIndex = 0; segmentIndex < NUMBER_OF_SEGMENTS; ++segmentIndex)
+    {
+    vtkNew<vtkSegment> segment;
+    std::stringstream segmentID;
+    segmentID << "Segment_" << segmentIndex + 1;
+    segment->SetName(segmentID.str().c_str());
+    segment->SetLabelValue(segmentIndex + 1);
+    segment->AddRepresentation(labelmapName, labelmap.GetPointer());
+    segmentation->AddSegment(segment.GetPointer(), segmentID.str());
+    }
+  segmentationNode->CreateDefaultDisplayNodes();
+  return segmentationNode;
+}
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+int vtkMRMLSliceLogicProbeTest(int , char * [] )
+{
+  vtkNew<vtkMRMLScene> scene;
+  vtkMRMLSliceNode::AddDefaultSliceOrientationPresets(scene.GetPointer());
+
+  vtkNew<vtkMRMLSliceLogic> sliceLogic;
+  sliceLogic->SetName("Red");
+  sliceLogic->SetMRMLScene(scene.GetPointer());
+  vtkNew<vtkMRMLSliceLayerLogic> backgroundLayer;
+  sliceLogic->SetBackgroundLayer(backgroundLayer.GetPointer());
+  vtkNew<vtkMRMLSliceLayerLogic> foregroundLayer;
+  sliceLogic->SetForegroundLayer(foregroundLayer.GetPointer());
+  vtkNew<vtkMRMLSliceLayerLogic> labelLayer;
+  sliceLogic->SetLabelLayer(labelLayer.GetPointer());
+  vtkMRMLSliceNode* sliceNode = sliceLogic->GetSliceNode();
+  CHECK_NOT_NULL(sliceNode);
+
+  vtkMRMLScalarVolumeNode* volumeNode = AddVolume(scene.GetPointer());
+  sliceLogic->GetSliceCompositeNode()->SetBackgroundVolumeID(volumeNode->GetID());
+  backgroundLayer->UpdateTransforms();
+  CHECK_POINTER(backgroundLayer->GetVolumeNode(), volumeNode);
+
+  vtkMRMLSegmentationNode* segmentationNode = AddSegmentation(scene.GetPointer());
+
+  vtkNew<vtkIntArray> layerIJKs;
+  vtkNew<vtkDoubleArray> layerValues;
+  vtkNew<vtkStringArray> segmentationNodeIDs;
+  vtkNew<vtkStringArray> segmentIDs;
+
+  // Inside the volume and the segmentation
+  double ras[3] = { 2.0, 3.0, 4.0 };
+  double xyz[3] = { 0.0, 0.0, 0.0 };
+  RASToXYZ(sliceNode, ras, xyz);
+  sliceLogic->ProbePosition(xyz, layerIJKs.GetPointer(), layerValues.GetPointer(),
+    segmentationNodeIDs.GetPointer(), segmentIDs.GetPointer());
+
+  CHECK_INT(layerIJKs->GetNumberOfTuples(), 3);
+  CHECK_INT(layerIJKs->GetNumberOfComponents(), 3);
+  CHECK_INT(layerIJKs->GetValue(vtkMRMLSliceLogic::LayerBackground * 3 + 0), 2);
+  CHECK_INT(layerIJKs->GetValue(vtkMRMLSliceLogic::LayerBackground * 3 + 1), 3);
+  CHECK_INT(layerIJKs->GetValue(vtkMRMLSliceLogic::LayerBackground * 3 + 2), 4);
+  CHECK_INT(layerValues->GetNumberOfTuples(), 3);
+  CHECK_INT(layerValues->GetNumberOfComponents(), vtkMRMLSliceLogic::PROBE_MAXIMUM_NUMBER_OF_COMPONENTS);
+  CHECK_DOUBLE(layerValues->GetComponent(vtkMRMLSliceLogic::LayerBackground, 0), 432.0);
+  CHECK_BOOL(vtkMath::IsNan(layerValues->GetComponent(vtkMRMLSliceLogic::LayerBackground, 1)), true);
+  // No volume in foreground and label layers
+  CHECK_INT(layerIJKs->GetValue(vtkMRMLSliceLogic::LayerForeground * 3 + 0), 0);
+  CHECK_BOOL(vtkMath::IsNan(layerValues->GetComponent(vtkMRMLSliceLogic::LayerForeground, 0)), true);
+  CHECK_BOOL(vtkMath::IsNan(layerValues->GetComponent(vtkMRMLSliceLogic::LayerLabel, 0)), true);
+
+  CHECK_INT(segmentIDs->GetNumberOfValues(), 1);
+  CHECK_INT(segmentationNodeIDs->GetNumberOfValues(), 1);
+  CHECK_STD_STRING(segmentIDs->GetValue(0), "Segment_33");
+  CHECK_STD_STRING(segmentationNodeIDs->GetValue(0), segmentationNode->GetID());
+
+  // Segment is not reported if it is hidden
+  vtkMRMLSegmentationDisplayNode* segmentationDisplayNode =
+    vtkMRMLSegmentationDisplayNode::SafeDownCast(segmentationNode->GetDisplayNode());
+  CHECK_NOT_NULL(segmentationDisplayNode);
+  segmentationDisplayNode->SetSegmentVisibility("Segment_33", false);
+  sliceLogic->GetVisibleSegmentsAtPosition(ras, segmentationNodeIDs.GetPointer(), segmentIDs.GetPointer());
+  CHECK_INT(segmentIDs->GetNumberOfValues(), 0);
+  segmentationDisplayNode->SetSegmentVisibility("Segment_33", true);
+  segmentationDisplayNode->SetVisibility2D(false);
+  sliceLogic->GetVisibleSegmentsAtPosition(ras, segmentationNodeIDs.GetPointer(), segmentIDs.GetPointer());
+  CHECK_INT(segmentIDs->GetNumberOfValues(), 0);
+  segmentationDisplayNode->SetVisibility2D(true);
+  sliceLogic->GetVisibleSegmentsAtPosition(ras, segmentationNodeIDs.GetPointer(), segmentIDs.GetPointer());
+  CHECK_INT(segmentIDs->GetNumberOfValues(), 1);
+
+  // Outside the volume and the segmentation
+  double outsideRas[3] = { 20.0, 3.0, 4.0 };
+  RASToXYZ(sliceNode, outsideRas, xyz);
+  sliceLogic->ProbePosition(xyz, layerIJKs.GetPointer(), layerValues.GetPointer(),
+    segmentationNodeIDs.GetPointer(), segmentIDs.GetPointer());
+  CHECK_INT(layerIJKs->GetValue(vtkMRMLSliceLogic::LayerBackground * 3 + 0), 20);
+  CHECK_BOOL(vtkMath::IsNan(layerValues->GetComponent(vtkMRMLSliceLogic::LayerBackground, 0)), true);
+  CHECK_INT(segmentIDs->GetNumberOfValues(), 0);
+  CHECK_INT(segmentationNodeIDs->GetNumberOfValues(), 0);
+
+  // Output arrays are optional
+  sliceLogic->ProbePosition(xyz, nullptr, layerValues.GetPointer(), nullptr, nullptr);
+  sliceLogic->ProbePosition(xyz, layerIJKs.GetPointer(), nullptr, nullptr, nullptr);
+
+  return EXIT_SUCCESS;
+}
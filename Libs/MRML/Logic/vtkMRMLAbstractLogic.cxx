@@ -19,6 +19,7 @@
 // MRML includes
 #include "vtkMRMLNode.h"
 #include "vtkMRMLScene.h"
+#include "vtkMRMLTrace.h"
 
 // VTK includes
 #include <vtkCallbackCommand.h>
@@ -165,6 +166,7 @@ void vtkMRMLAbstractLogic::MRMLSceneCallback(vtkObject*caller, unsigned long eid
     }
 
   vtkDebugWithObjectMacro(self, "In vtkMRMLAbstractLogic MRMLSceneCallback");
+  vtkMRMLTraceScopeMacro("Logic", "ProcessMRMLSceneEvents", self->GetClassName());
 
   self->SetInMRMLSceneCallbackFlag(self->GetInMRMLSceneCallbackFlag() + 1);
   int oldProcessingEvent = self->GetProcessingMRMLSceneEvent();
@@ -193,6 +195,7 @@ void vtkMRMLAbstractLogic::MRMLNodesCallback(vtkObject* caller, unsigned long ei
     return;
     }
   vtkDebugWithObjectMacro(self, "In vtkMRMLAbstractLogic MRMLNodesCallback");
+  vtkMRMLTraceScopeMacro("Logic", "ProcessMRMLNodesEvents", self->GetClassName());
 
   self->SetInMRMLNodesCallbackFlag(self->GetInMRMLNodesCallbackFlag() + 1);
   self->ProcessMRMLNodesEvents(caller, eid, callData);
@@ -217,6 +220,7 @@ void vtkMRMLAbstractLogic
     return;
     }
   vtkDebugWithObjectMacro(self, "In vtkMRMLAbstractLogic MRMLLogicsCallback");
+  vtkMRMLTraceScopeMacro("Logic", "ProcessMRMLLogicsEvents", self->GetClassName());
 
   self->SetInMRMLLogicsCallbackFlag(self->GetInMRMLLogicsCallbackFlag() + 1);
   self->ProcessMRMLLogicsEvents(caller, eid, callData);
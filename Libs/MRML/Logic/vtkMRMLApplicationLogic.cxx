@@ -46,6 +46,7 @@
 #include <vtkCallbackCommand.h>
 #include <vtkCollection.h>
 #include <vtkImageData.h>
+#include <vtkIntArray.h>
 #include <vtkNew.h>
 #include <vtkObjectFactory.h>
 #include <vtkSmartPointer.h>
@@ -55,7 +56,9 @@
 #include <vtksys/Glob.hxx>
 
 // STD includes
+#include <algorithm>
 #include <cassert>
+#include <map>
 #include <sstream>
 
 // For LoadDefaultParameterSets
@@ -87,6 +90,16 @@ public:
   vtkSmartPointer<vtkMRMLColorLogic> ColorLogic;
   std::string TemporaryPath;
 
+  struct MemoryCacheInfo
+    {
+    MemoryCacheType Cache;
+    unsigned long LastUsed{0};
+    };
+  std::map<int, MemoryCacheInfo> MemoryCaches;
+  int NextMemoryCacheId{1};
+  unsigned long MemoryCacheUseCounter{0};
+  unsigned long MemoryBudget{0};
+  bool EnforcingMemoryBudget{false};
 };
 
 //----------------------------------------------------------------------------
@@ -99,6 +112,25 @@ vtkMRMLApplicationLogic::vtkInternal::vtkInternal(vtkMRMLApplicationLogic* exter
   this->SliceLinkLogic = vtkSmartPointer<vtkMRMLSliceLinkLogic>::New();
   this->ViewLinkLogic = vtkSmartPointer<vtkMRMLViewLinkLogic>::New();
   this->ColorLogic = vtkSmartPointer<vtkMRMLColorLogic>::New();
+
+  // Undo states cannot be regenerated, release them only as a last resort
+  MemoryCacheType undoStackCache;
+  undoStackCache.Name = "Undo stack";
+  undoStackCache.RegenerationCost = 1000.0;
+  undoStackCache.GetMemorySize = [external]()
+    {
+    return external->GetMRMLScene() ? external->GetMRMLScene()->GetUndoStackMemorySize() : 0;
+    };
+  undoStackCache.Release = [external]()
+    {
+    if (external->GetMRMLScene())
+      {
+      external->GetMRMLScene()->ClearUndoStack();
+      }
+    };
+  MemoryCacheInfo undoStackCacheInfo;
+  undoStackCacheInfo.Cache = undoStackCache;
+  this->MemoryCaches[this->NextMemoryCacheId++] = undoStackCacheInfo;
 }
 
 //----------------------------------------------------------------------------
@@ -167,6 +199,8 @@ vtkMRMLApplicationLogic::~vtkMRMLApplicationLogic()
 void vtkMRMLApplicationLogic::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
+  os << indent << "MemoryBudget: " << this->Internal->MemoryBudget << "\n";
+  os << indent << "NumberOfMemoryCaches: " << this->Internal->MemoryCaches.size() << "\n";
 }
 
 //----------------------------------------------------------------------------
@@ -395,7 +429,12 @@ void vtkMRMLApplicationLogic::SetMRMLSceneInternal(vtkMRMLScene* newScene)
   // Add default slice orientation presets
   vtkMRMLSliceNode::AddDefaultSliceOrientationPresets(newScene);
 
-  this->Superclass::SetMRMLSceneInternal(newScene);
+  // Observe the scene for enforcing the memory budget
+  vtkNew<vtkIntArray> events;
+  events->InsertNextValue(vtkMRMLScene::NodeAddedEvent);
+  events->InsertNextValue(vtkMRMLScene::EndImportEvent);
+  events->InsertNextValue(vtkMRMLScene::EndBatchProcessEvent);
+  this->SetAndObserveMRMLSceneEventsInternal(newScene, events.GetPointer());
 
   this->Internal->SliceLinkLogic->SetMRMLScene(newScene);
   this->Internal->ViewLinkLogic->SetMRMLScene(newScene);
@@ -817,6 +856,152 @@ void vtkMRMLApplicationLogic::ProcessMRMLNodesEvents(vtkObject* caller, unsigned
     }
 }
 
+//----------------------------------------------------------------------------
+void vtkMRMLApplicationLogic::OnMRMLSceneNodeAdded(vtkMRMLNode* vtkNotUsed(node))
+{
+  if (this->GetMRMLScene() && !this->GetMRMLScene()->IsBatchProcessing())
+    {
+    this->EnforceMemoryBudget();
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLApplicationLogic::OnMRMLSceneEndImport()
+{
+  this->EnforceMemoryBudget();
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLApplicationLogic::OnMRMLSceneEndBatchProcess()
+{
+  this->EnforceMemoryBudget();
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLApplicationLogic::SetMemoryBudget(unsigned long budget)
+{
+  if (this->Internal->MemoryBudget == budget)
+    {
+    return;
+    }
+  this->Internal->MemoryBudget = budget;
+  this->Modified();
+  this->EnforceMemoryBudget();
+}
+
+//----------------------------------------------------------------------------
+unsigned long vtkMRMLApplicationLogic::GetMemoryBudget()
+{
+  return this->Internal->MemoryBudget;
+}
+
+//----------------------------------------------------------------------------
+unsigned long vtkMRMLApplicationLogic::GetMemoryUsage()
+{
+  unsigned long usage = (this->GetMRMLScene() ? this->GetMRMLScene()->GetNodesMemorySize() : 0);
+  for (std::map<int, vtkInternal::MemoryCacheInfo>::iterator cacheIt = this->Internal->MemoryCaches.begin();
+    cacheIt != this->Internal->MemoryCaches.end(); ++cacheIt)
+    {
+    if (!cacheIt->second.Cache.IncludedInNodesMemorySize && cacheIt->second.Cache.GetMemorySize)
+      {
+      usage += cacheIt->second.Cache.GetMemorySize();
+      }
+    }
+  return usage;
+}
+
+//----------------------------------------------------------------------------
+unsigned long vtkMRMLApplicationLogic::EnforceMemoryBudget()
+{
+  if (this->Internal->MemoryBudget == 0 || this->Internal->EnforcingMemoryBudget)
+    {
+    return 0;
+    }
+  unsigned long usage = this->GetMemoryUsage();
+  if (usage <= this->Internal->MemoryBudget)
+    {
+    return 0;
+    }
+  // Releasing caches may trigger scene events, prevent recursive enforcement
+  this->Internal->EnforcingMemoryBudget = true;
+
+  // Order of release: lowest regeneration cost first, then least recently used
+  std::vector<std::pair<std::pair<double, unsigned long>, int> > releaseOrder;
+  for (std::map<int, vtkInternal::MemoryCacheInfo>::iterator cacheIt = this->Internal->MemoryCaches.begin();
+    cacheIt != this->Internal->MemoryCaches.end(); ++cacheIt)
+    {
+    releaseOrder.push_back(std::make_pair(std::make_pair(
+      cacheIt->second.Cache.RegenerationCost, cacheIt->second.LastUsed), cacheIt->first));
+    }
+  std::sort(releaseOrder.begin(), releaseOrder.end());
+
+  unsigned long releasedMemory = 0;
+  for (size_t releaseIndex = 0; releaseIndex < releaseOrder.size() && usage > this->Internal->MemoryBudget; ++releaseIndex)
+    {
+    std::map<int, vtkInternal::MemoryCacheInfo>::iterator cacheIt =
+      this->Internal->MemoryCaches.find(releaseOrder[releaseIndex].second);
+    if (cacheIt == this->Internal->MemoryCaches.end()
+      || !cacheIt->second.Cache.GetMemorySize || !cacheIt->second.Cache.Release)
+      {
+      continue;
+      }
+    unsigned long sizeBefore = cacheIt->second.Cache.GetMemorySize();
+    if (sizeBefore == 0)
+      {
+      continue;
+      }
+    // copy, as the cache may be unregistered while it is released
+    MemoryCacheType cache = cacheIt->second.Cache;
+    cache.Release();
+    unsigned long sizeAfter = cache.GetMemorySize();
+    unsigned long released = (sizeBefore > sizeAfter ? sizeBefore - sizeAfter : 0);
+    vtkDebugMacro("EnforceMemoryBudget: released " << released << " KiB from " << cache.Name);
+    releasedMemory += released;
+    usage = (usage > released ? usage - released : 0);
+    }
+
+  this->Internal->EnforcingMemoryBudget = false;
+  if (usage > this->Internal->MemoryBudget)
+    {
+    vtkWarningMacro("EnforceMemoryBudget: memory usage (" << usage / 1024 << " MiB) exceeds the memory budget ("
+      << this->Internal->MemoryBudget / 1024 << " MiB) after releasing all memory caches");
+    }
+  return releasedMemory;
+}
+
+//----------------------------------------------------------------------------
+int vtkMRMLApplicationLogic::AddMemoryCache(const MemoryCacheType& cache)
+{
+  int cacheId = this->Internal->NextMemoryCacheId++;
+  vtkInternal::MemoryCacheInfo cacheInfo;
+  cacheInfo.Cache = cache;
+  cacheInfo.LastUsed = ++this->Internal->MemoryCacheUseCounter;
+  this->Internal->MemoryCaches[cacheId] = cacheInfo;
+  return cacheId;
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLApplicationLogic::RemoveMemoryCache(int cacheId)
+{
+  this->Internal->MemoryCaches.erase(cacheId);
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLApplicationLogic::SetMemoryCacheUsed(int cacheId)
+{
+  std::map<int, vtkInternal::MemoryCacheInfo>::iterator cacheIt = this->Internal->MemoryCaches.find(cacheId);
+  if (cacheIt != this->Internal->MemoryCaches.end())
+    {
+    cacheIt->second.LastUsed = ++this->Internal->MemoryCacheUseCounter;
+    }
+}
+
+//----------------------------------------------------------------------------
+int vtkMRMLApplicationLogic::GetNumberOfMemoryCaches()
+{
+  return static_cast<int>(this->Internal->MemoryCaches.size());
+}
+
 //----------------------------------------------------------------------------
 void vtkMRMLApplicationLogic::EditNode(vtkMRMLNode* node)
 {
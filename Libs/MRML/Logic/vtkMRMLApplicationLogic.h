@@ -42,6 +42,8 @@ class vtkCollection;
 class vtkImageData;
 
 // STD includes
+#include <functional>
+#include <string>
 #include <vector>
 
 class VTK_MRML_LOGIC_EXPORT vtkMRMLApplicationLogic
@@ -235,6 +237,58 @@ public:
   /// Requests the application to show user interface for editing a node.
   virtual void EditNode(vtkMRMLNode* node);
 
+  /// Maximum memory (in kibibytes) that the scene nodes, the undo stack and the
+  /// registered memory caches may use. When the budget is exceeded, data of the registered
+  /// caches is released (it is regenerated on demand) until memory usage fits in the budget.
+  /// The budget is enforced when nodes are added, after import and batch processing, and when
+  /// EnforceMemoryBudget() is called. 0 (default) means no budget.
+  /// \sa AddMemoryCache(), GetMemoryUsage()
+  void SetMemoryBudget(unsigned long budget);
+  unsigned long GetMemoryBudget();
+
+  /// Approximate memory (in kibibytes) used by the content of the scene nodes
+  /// and by the registered memory caches.
+  /// \sa vtkMRMLScene::GetNodesMemorySize()
+  unsigned long GetMemoryUsage();
+
+  /// Release data of registered memory caches until memory usage fits in the budget.
+  /// Caches with the lowest regeneration cost are released first, and among caches
+  /// of the same cost the least recently used ones.
+  /// Returns the amount of released memory (in kibibytes).
+  unsigned long EnforceMemoryBudget();
+
+#ifndef __VTK_WRAP__
+  /// Description of a cache of derived data that can be released under memory pressure.
+  struct MemoryCacheType
+    {
+    /// Name displayed in messages
+    std::string Name;
+    /// Relative cost of regenerating the released data. Caches of lower cost are released first.
+    double RegenerationCost{1.0};
+    /// True if the data is part of the content of scene nodes (and therefore already
+    /// counted in vtkMRMLScene::GetNodesMemorySize()).
+    bool IncludedInNodesMemorySize{false};
+    /// Returns the memory (in kibibytes) that can be released
+    std::function<unsigned long()> GetMemorySize;
+    /// Releases the data of the cache
+    std::function<void()> Release;
+    };
+
+  /// Register a cache that is released when the memory budget is exceeded.
+  /// Returns an identifier that can be used for unregistering the cache.
+  /// \sa SetMemoryBudget(), RemoveMemoryCache()
+  int AddMemoryCache(const MemoryCacheType& cache);
+#endif
+
+  /// Unregister a memory cache. Must be called before the cache is deleted.
+  void RemoveMemoryCache(int cacheId);
+
+  /// Notify that data of the cache was accessed, so that least recently used caches are released first.
+  void SetMemoryCacheUsed(int cacheId);
+
+  /// Number of registered memory caches. The undo stack is registered by default.
+  int GetNumberOfMemoryCaches();
+
 protected:
 
   vtkMRMLApplicationLogic();
@@ -247,6 +301,11 @@ protected:
 
   void ProcessMRMLNodesEvents(vtkObject* caller, unsigned long event, void* callData) override;
 
+  /// Enforce memory budget when data is added to the scene
+  void OnMRMLSceneNodeAdded(vtkMRMLNode* node) override;
+  void OnMRMLSceneEndImport() override;
+  void OnMRMLSceneEndBatchProcess() override;
+
 private:
 
   vtkMRMLApplicationLogic(const vtkMRMLApplicationLogic&) = delete;
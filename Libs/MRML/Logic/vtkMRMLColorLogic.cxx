@@ -740,10 +740,69 @@ vtkMRMLProceduralColorNode* vtkMRMLColorLogic::CreateProceduralFileNode(const ch
   return cpnode;
 }
 
+//----------------------------------------------------------------------------------------
+std::string vtkMRMLColorLogic::GetColorFileCacheKey(const std::string& fileName)
+{
+  std::stringstream key;
+  key << "File:" << fileName << ":" << vtksys::SystemTools::ModifiedTime(fileName);
+  return key.str();
+}
+
+//----------------------------------------------------------------------------------------
+vtkMRMLColorNode* vtkMRMLColorLogic::CreateColorNodeFromCache(const std::string& cacheKey)
+{
+  std::map<std::string, CachedColorNode>::iterator cachedIt = this->DefaultColorNodeCache.find(cacheKey);
+  if (cachedIt == this->DefaultColorNodeCache.end())
+    {
+    return nullptr;
+    }
+  vtkMRMLColorNode* cachedNode = cachedIt->second.Node;
+  vtkMRMLColorNode* node = vtkMRMLColorNode::SafeDownCast(cachedNode->CreateNodeInstance());
+  node->Copy(cachedNode);
+  // Not copied by Copy()
+  node->SetSaveWithScene(cachedNode->GetSaveWithScene());
+  if (!cachedIt->second.FileName.empty() && this->GetMRMLScene())
+    {
+    // Same storage node as the one created in CreateFileNode()
+    node->SetScene(this->GetMRMLScene());
+    vtkNew<vtkMRMLColorTableStorageNode> colorStorageNode;
+    colorStorageNode->SaveWithSceneOff();
+    colorStorageNode->SetFileName(cachedIt->second.FileName.c_str());
+    this->GetMRMLScene()->AddNode(colorStorageNode.GetPointer());
+    node->SetAndObserveStorageNodeID(colorStorageNode->GetID());
+    }
+  return node;
+}
+
+//----------------------------------------------------------------------------------------
+void vtkMRMLColorLogic::AddColorNodeToCache(const std::string& cacheKey, vtkMRMLColorNode* node)
+{
+  if (!node)
+    {
+    return;
+    }
+  CachedColorNode cachedNode;
+  cachedNode.Node.TakeReference(vtkMRMLColorNode::SafeDownCast(node->CreateNodeInstance()));
+  cachedNode.Node->Copy(node);
+  cachedNode.Node->SetSaveWithScene(node->GetSaveWithScene());
+  // The storage node is in the scene, it is created again for each copy
+  if (node->GetStorageNode() && node->GetStorageNode()->GetFileName())
+    {
+    cachedNode.FileName = node->GetStorageNode()->GetFileName();
+    }
+  cachedNode.Node->SetAndObserveStorageNodeID(nullptr);
+  this->DefaultColorNodeCache[cacheKey] = cachedNode;
+}
+
 //----------------------------------------------------------------------------------------
 void vtkMRMLColorLogic::AddLabelsNode()
 {
-  vtkMRMLColorTableNode* labelsNode = this->CreateLabelsNode();
+  vtkMRMLColorNode* labelsNode = this->CreateColorNodeFromCache("Labels");
+  if (!labelsNode)
+    {
+    labelsNode = this->CreateLabelsNode();
+    this->AddColorNodeToCache("Labels", labelsNode);
+    }
   //if (this->GetMRMLScene()->GetNodeByID(labelsNode->GetSingletonTag()) == nullptr)
     {
     //this->GetMRMLScene()->RequestNodeID(labelsNode, labelsNode->GetSingletonTag());
@@ -755,7 +814,14 @@ void vtkMRMLColorLogic::AddLabelsNode()
 //----------------------------------------------------------------------------------------
 void vtkMRMLColorLogic::AddDefaultTableNode(int i)
 {
-  vtkMRMLColorTableNode* node = this->CreateDefaultTableNode(i);
+  std::stringstream cacheKey;
+  cacheKey << "Table:" << i;
+  vtkMRMLColorNode* node = this->CreateColorNodeFromCache(cacheKey.str());
+  if (!node)
+    {
+    node = this->CreateDefaultTableNode(i);
+    this->AddColorNodeToCache(cacheKey.str(), node);
+    }
   //if (node->GetSingletonTag())
     {
     //if (this->GetMRMLScene()->GetNodeByID(node->GetSingletonTag()) == nullptr)
@@ -777,12 +843,22 @@ void vtkMRMLColorLogic::AddDefaultTableNode(int i)
 void vtkMRMLColorLogic::AddDefaultProceduralNodes()
 {
   // random one
-  vtkMRMLProceduralColorNode* randomNode = this->CreateRandomNode();
+  vtkMRMLColorNode* randomNode = this->CreateColorNodeFromCache("RandomIntegers");
+  if (!randomNode)
+    {
+    randomNode = this->CreateRandomNode();
+    this->AddColorNodeToCache("RandomIntegers", randomNode);
+    }
   this->GetMRMLScene()->AddNode(randomNode);
   randomNode->Delete();
 
   // red green blue one
-  vtkMRMLProceduralColorNode* rgbNode = this->CreateRedGreenBlueNode();
+  vtkMRMLColorNode* rgbNode = this->CreateColorNodeFromCache("RedGreenBlue");
+  if (!rgbNode)
+    {
+    rgbNode = this->CreateRedGreenBlueNode();
+    this->AddColorNodeToCache("RedGreenBlue", rgbNode);
+    }
   this->GetMRMLScene()->AddNode(rgbNode);
   rgbNode->Delete();
 }
@@ -791,7 +867,14 @@ void vtkMRMLColorLogic::AddDefaultProceduralNodes()
 void vtkMRMLColorLogic::AddPETNode(int type)
 {
   vtkDebugMacro("AddDefaultColorNodes: adding PET nodes");
-  vtkMRMLPETProceduralColorNode *nodepcn = this->CreatePETColorNode(type);
+  std::stringstream cacheKey;
+  cacheKey << "PET:" << type;
+  vtkMRMLColorNode* nodepcn = this->CreateColorNodeFromCache(cacheKey.str());
+  if (!nodepcn)
+    {
+    nodepcn = this->CreatePETColorNode(type);
+    this->AddColorNodeToCache(cacheKey.str(), nodepcn);
+    }
   //if (this->GetMRMLScene()->GetNodeByID( nodepcn->GetSingletonTag() ) == nullptr)
     {
     //this->GetMRMLScene()->RequestNodeID(nodepcn, nodepcn->GetSingletonTag() );
@@ -804,7 +887,14 @@ void vtkMRMLColorLogic::AddPETNode(int type)
 void vtkMRMLColorLogic::AddDGEMRICNode(int type)
 {
   vtkDebugMacro("AddDefaultColorNodes: adding dGEMRIC nodes");
-  vtkMRMLdGEMRICProceduralColorNode *pcnode = this->CreatedGEMRICColorNode(type);
+  std::stringstream cacheKey;
+  cacheKey << "dGEMRIC:" << type;
+  vtkMRMLColorNode* pcnode = this->CreateColorNodeFromCache(cacheKey.str());
+  if (!pcnode)
+    {
+    pcnode = this->CreatedGEMRICColorNode(type);
+    this->AddColorNodeToCache(cacheKey.str(), pcnode);
+    }
   //if (this->GetMRMLScene()->GetNodeByID(pcnode->GetSingletonTag()) == nullptr)
     {
     //this->GetMRMLScene()->RequestNodeID(pcnode, pcnode->GetSingletonTag());
@@ -816,7 +906,13 @@ void vtkMRMLColorLogic::AddDGEMRICNode(int type)
 //----------------------------------------------------------------------------------------
 void vtkMRMLColorLogic::AddDefaultFileNode(int i)
 {
-  vtkMRMLColorTableNode* ctnode =  this->CreateDefaultFileNode(this->ColorFiles[i]);
+  const std::string cacheKey = vtkMRMLColorLogic::GetColorFileCacheKey(this->ColorFiles[i]);
+  vtkMRMLColorNode* ctnode = this->CreateColorNodeFromCache(cacheKey);
+  if (!ctnode)
+    {
+    ctnode = this->CreateDefaultFileNode(this->ColorFiles[i]);
+    this->AddColorNodeToCache(cacheKey, ctnode);
+    }
   if (ctnode)
     {
     //if (this->GetMRMLScene()->GetNodeByID(ctnode->GetSingletonTag()) == nullptr)
@@ -840,7 +936,13 @@ void vtkMRMLColorLogic::AddDefaultFileNode(int i)
 //----------------------------------------------------------------------------------------
 void vtkMRMLColorLogic::AddUserFileNode(int i)
 {
-  vtkMRMLColorTableNode* ctnode = this->CreateUserFileNode(this->UserColorFiles[i]);
+  const std::string cacheKey = "User" + vtkMRMLColorLogic::GetColorFileCacheKey(this->UserColorFiles[i]);
+  vtkMRMLColorNode* ctnode = this->CreateColorNodeFromCache(cacheKey);
+  if (!ctnode)
+    {
+    ctnode = this->CreateUserFileNode(this->UserColorFiles[i]);
+    this->AddColorNodeToCache(cacheKey, ctnode);
+    }
   if (ctnode)
     {
     //if (this->GetMRMLScene()->GetNodeByID(ctnode->GetSingletonTag()) == nullptr)
@@ -853,12 +955,12 @@ void vtkMRMLColorLogic::AddUserFileNode(int i)
     //  {
     //  vtkDebugMacro("AddDefaultColorFiles: node " << ctnode->GetSingletonTag() << " already in scene");
     //  }
+    ctnode->Delete();
     }
   else
     {
     vtkWarningMacro("Unable to read user color file " << this->UserColorFiles[i].c_str());
     }
-  ctnode->Delete();
 }
 
 //----------------------------------------------------------------------------------------
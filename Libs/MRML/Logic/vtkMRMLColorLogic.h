@@ -22,8 +22,13 @@ class vtkMRMLPETProceduralColorNode;
 class vtkMRMLdGEMRICProceduralColorNode;
 class vtkMRMLColorTableNode;
 
+// VTK includes
+#include <vtkSmartPointer.h>
+
 // STD includes
 #include <cstdlib>
+#include <map>
+#include <string>
 #include <vector>
 
 /// \brief MRML logic class for color manipulation.
@@ -248,6 +253,18 @@ protected:
   virtual std::vector<std::string> FindDefaultColorFiles();
   virtual std::vector<std::string> FindUserColorFiles();
 
+  /// Return a new copy of the default color node stored with \a cacheKey
+  /// by AddColorNodeToCache(), nullptr if no node is stored with that key.
+  /// A storage node is added to the scene for file based color nodes.
+  vtkMRMLColorNode* CreateColorNodeFromCache(const std::string& cacheKey);
+  /// Store a copy of a newly created default color node, so that next time
+  /// (when a new scene is created) the node does not need to be built (or
+  /// read from file) again.
+  void AddColorNodeToCache(const std::string& cacheKey, vtkMRMLColorNode* node);
+  /// Key of color nodes read from files. Modification time is included so
+  /// that the file is read again if it has been changed.
+  static std::string GetColorFileCacheKey(const std::string& fileName);
+
   /// Return the ID of a node that doesn't belong to a scene.
   /// It is the concatenation of the node class name and its type.
   static const char * GetColorNodeID(vtkMRMLColorNode* colorNode);
@@ -268,6 +285,16 @@ protected:
 
   static std::string TempColorNodeID;
 
+  struct CachedColorNode
+    {
+    vtkSmartPointer<vtkMRMLColorNode> Node;
+    /// File name of the storage node (for file based color nodes)
+    std::string FileName;
+    };
+  /// Copies of the default color nodes, which are added to each new scene.
+  /// The nodes are not in the scene.
+  std::map<std::string, CachedColorNode> DefaultColorNodeCache;
+
   std::string RemoveLeadAndTrailSpaces(std::string);
 };
 
@@ -32,13 +32,16 @@
 #include <vtkDiffusionTensorMathematics.h>
 #include <vtkFloatArray.h>
 #include <vtkGeneralTransform.h>
+#include <vtkGridTransform.h>
 #include <vtkImageData.h>
 #include <vtkImageReslice.h>
+#include <vtkImageStencilData.h>
 #include <vtkInformation.h>
 #include <vtkInformationVector.h>
 #include <vtkNew.h>
 #include <vtkObjectFactory.h>
 #include <vtkPointData.h>
+#include <vtkSMPTools.h>
 #include <vtkTrivialProducer.h>
 #include <vtkTransform.h>
 #include <vtkVersion.h>
@@ -49,10 +52,27 @@
 
 // STD includes
 #include <algorithm>
+#include <atomic>
+#include <set>
+#include <thread>
+#include <utility>
 
 //----------------------------------------------------------------------------
 vtkStandardNewMacro(vtkMRMLSliceLayerLogic);
 
+namespace
+{
+//----------------------------------------------------------------------------
+/// All slice layer logic instances, for finding layers that can share reslice output
+std::set<vtkMRMLSliceLayerLogic*>& GetAllSliceLayerLogics()
+{
+  static std::set<vtkMRMLSliceLayerLogic*> sliceLayerLogics;
+  return sliceLayerLogics;
+}
+
+bool ResliceSharingUpdateInProgress = false;
+}
+
 bool AreMatricesEqual(const vtkMatrix4x4* first, const vtkMatrix4x4* second)
 {
   return vtkAddonMathUtilities::MatrixAreEqual(first, second);
@@ -99,6 +119,153 @@ void SnapToPermuteMatrix(vtkTransform* transform)
   }
 }
 
+//----------------------------------------------------------------------------
+// Set a linear reslice transform, unless the current one has exactly the same matrix.
+// Setting a new transform invalidates the reslice output, so all slices (all light box
+// tiles) would be resliced again, even when only the display (e.g., window/level) changed.
+void SetLinearResliceTransform(vtkImageReslice* reslice, vtkTransform* transform)
+{
+  vtkTransform* currentTransform = vtkTransform::SafeDownCast(reslice->GetResliceTransform());
+  if (currentTransform)
+    {
+    const double* currentElements = currentTransform->GetMatrix()->GetData();
+    const double* newElements = transform->GetMatrix()->GetData();
+    if (std::equal(currentElements, currentElements + 16, newElements))
+      {
+      return;
+      }
+    }
+  reslice->SetResliceTransform(transform);
+}
+
+//----------------------------------------------------------------------------
+// Get the latest modification time of the transforms between the transform node and world.
+vtkMTimeType GetTransformToWorldMTime(vtkMRMLTransformNode* transformNode)
+{
+  vtkMTimeType mtime = 0;
+  for (; transformNode; transformNode = transformNode->GetParentTransformNode())
+    {
+    mtime = std::max(mtime, transformNode->GetMTime());
+    vtkAbstractTransform* transformToParent = transformNode->GetTransformToParent();
+    if (transformToParent)
+      {
+      mtime = std::max(mtime, transformToParent->GetMTime());
+      }
+    }
+  return mtime;
+}
+
+//----------------------------------------------------------------------------
+/// Reslicing on a worker thread, see vtkMRMLSliceLayerLogic::SetAsynchronousReslicing.
+/// The worker reslices a shallow copy of the input image with a copy of the reslice
+/// parameters, so the main pipeline can be modified while the worker runs.
+/// Results are published to the output producers in the main thread.
+struct AsynchronousReslice
+{
+  /// Modification time of the reslice filter and of its input image
+  typedef std::pair<vtkMTimeType, vtkMTimeType> RequestType;
+
+  AsynchronousReslice()
+  {
+    // Output is empty until the first result is published
+    vtkNew<vtkImageData> output;
+    this->OutputProducer->SetOutput(output.GetPointer());
+    vtkNew<vtkImageStencilData> stencilOutput;
+    this->StencilOutputProducer->SetOutput(stencilOutput.GetPointer());
+  }
+
+  ~AsynchronousReslice()
+  {
+    this->Cancel();
+    if (this->Worker.joinable())
+      {
+      this->Worker.join();
+      }
+  }
+
+  bool IsRunning()
+  {
+    return this->Worker.joinable();
+  }
+
+  void Cancel()
+  {
+    if (this->WorkerReslice)
+      {
+      this->Canceled = true;
+      this->WorkerReslice->SetAbortExecute(1);
+      }
+  }
+
+  /// Reslice with a copy of the current parameters of the reslice filter.
+  /// If synchronous is true then the result is computed and published immediately.
+  void Start(vtkImageReslice* reslice, vtkImageData* input, const RequestType& request, bool synchronous)
+  {
+    vtkNew<vtkImageData> inputCopy;
+    inputCopy->ShallowCopy(input);
+    this->WorkerReslice = vtkSmartPointer<vtkImageReslice>::New();
+    vtkImageReslice* workerReslice = this->WorkerReslice;
+    workerReslice->SetInputData(inputCopy.GetPointer());
+    vtkAbstractTransform* resliceTransform = reslice->GetResliceTransform();
+    if (resliceTransform)
+      {
+      vtkSmartPointer<vtkAbstractTransform> transformCopy =
+        vtkSmartPointer<vtkAbstractTransform>::Take(resliceTransform->MakeTransform());
+      transformCopy->DeepCopy(resliceTransform);
+      workerReslice->SetResliceTransform(transformCopy);
+      }
+    workerReslice->SetOutputExtent(reslice->GetOutputExtent());
+    workerReslice->SetOutputOrigin(reslice->GetOutputOrigin());
+    workerReslice->SetOutputSpacing(reslice->GetOutputSpacing());
+    workerReslice->SetOutputDimensionality(reslice->GetOutputDimensionality());
+    workerReslice->SetInterpolationMode(reslice->GetInterpolationMode());
+    workerReslice->SetBackgroundColor(reslice->GetBackgroundColor());
+    workerReslice->SetAutoCropOutput(reslice->GetAutoCropOutput());
+    workerReslice->SetOptimization(reslice->GetOptimization());
+    workerReslice->SetGenerateStencilOutput(reslice->GetGenerateStencilOutput());
+
+    this->WorkerRequest = request;
+    this->Canceled = false;
+    this->Finished = false;
+    if (synchronous)
+      {
+      workerReslice->Update();
+      this->Publish();
+      return;
+      }
+    this->Worker = std::thread([this]()
+      {
+      this->WorkerReslice->Update();
+      this->Finished = true;
+      });
+  }
+
+  /// Make the result of the worker the output
+  void Publish()
+  {
+    vtkNew<vtkImageData> output;
+    output->ShallowCopy(this->WorkerReslice->GetOutput());
+    this->OutputProducer->SetOutput(output.GetPointer());
+    vtkNew<vtkImageStencilData> stencilOutput;
+    stencilOutput->DeepCopy(this->WorkerReslice->GetStencilOutput());
+    this->StencilOutputProducer->SetOutput(stencilOutput.GetPointer());
+    this->PublishedRequest = this->WorkerRequest;
+    this->HasPublishedOutput = true;
+    this->WorkerReslice = nullptr;
+  }
+
+  std::thread Worker;
+  std::atomic<bool> Finished{ false };
+  std::atomic<bool> Canceled{ false };
+  vtkSmartPointer<vtkImageReslice> WorkerReslice;
+  RequestType WorkerRequest;
+
+  bool HasPublishedOutput{ false };
+  RequestType PublishedRequest;
+  vtkNew<vtkTrivialProducer> OutputProducer;
+  vtkNew<vtkTrivialProducer> StencilOutputProducer;
+};
+
 //----------------------------------------------------------------------------
 vtkMRMLSliceLayerLogic::vtkMRMLSliceLayerLogic()
 {
@@ -148,11 +315,35 @@ vtkMRMLSliceLayerLogic::vtkMRMLSliceLayerLogic()
   this->UpdatingTransforms = 0;
 
   this->InterpolationMode = VTK_RESLICE_LINEAR;
+
+  this->Interacting = false;
+  this->InteractiveDownsampling = true;
+  this->InteractiveDownsamplingMinimumNumberOfVoxels = 32 * 1024 * 1024;
+
+  this->NonLinearTransformSamplingSpacing = 0;
+  this->SampledXYToIJKTransform = vtkGridTransform::New();
+  this->SampledXYToIJKTransform->SetInterpolationModeToLinear();
+
+  this->ResliceSharing = true;
+  this->SharedResliceLogic = nullptr;
+  GetAllSliceLayerLogics().insert(this);
+
+  this->AsyncReslice = nullptr;
 }
 
 //----------------------------------------------------------------------------
 vtkMRMLSliceLayerLogic::~vtkMRMLSliceLayerLogic()
 {
+  // Layers that use the reslice output of this layer must switch to their own
+  GetAllSliceLayerLogics().erase(this);
+  for (vtkMRMLSliceLayerLogic* layer : GetAllSliceLayerLogics())
+    {
+    if (layer->SharedResliceLogic == this)
+      {
+      layer->UpdateImageDisplay();
+      }
+    }
+
   if ( this->SliceNode )
     {
     vtkSetAndObserveMRMLNodeMacro(this->SliceNode, 0 );
@@ -168,8 +359,11 @@ vtkMRMLSliceLayerLogic::~vtkMRMLSliceLayerLogic()
 
   this->SetSliceNode(nullptr);
   this->SetVolumeNode(nullptr);
+  delete this->AsyncReslice;
+  this->AsyncReslice = nullptr;
   this->XYToIJKTransform->Delete();
   this->UVWToIJKTransform->Delete();
+  this->SampledXYToIJKTransform->Delete();
 
   this->Reslice->SetInputConnection( nullptr );
   this->ResliceUVW->SetInputConnection( nullptr );
@@ -540,17 +734,17 @@ void vtkMRMLSliceLayerLogic::UpdateTransforms()
     if (vtkMRMLTransformNode::IsGeneralTransformLinear(this->XYToIJKTransform, linearXYToIJKTransform))
       {
       SnapToPermuteMatrix(linearXYToIJKTransform);
-      this->Reslice->SetResliceTransform(linearXYToIJKTransform);
+      SetLinearResliceTransform(this->Reslice, linearXYToIJKTransform);
       }
     else
       {
-      this->Reslice->SetResliceTransform(this->XYToIJKTransform);
+      this->Reslice->SetResliceTransform(this->GetNonLinearResliceTransform(dimensions));
       }
     vtkSmartPointer<vtkTransform> linearUVWToIJKTransform = vtkSmartPointer<vtkTransform>::New();
     if (vtkMRMLTransformNode::IsGeneralTransformLinear(this->UVWToIJKTransform, linearUVWToIJKTransform))
       {
       SnapToPermuteMatrix(linearUVWToIJKTransform);
-      this->ResliceUVW->SetResliceTransform( linearUVWToIJKTransform );
+      SetLinearResliceTransform(this->ResliceUVW, linearUVWToIJKTransform);
       }
     else
       {
@@ -633,6 +827,96 @@ vtkAlgorithmOutput* vtkMRMLSliceLayerLogic::GetImageDataConnectionUVW()
   return this->GetVolumeDisplayNodeUVW()->GetOutputImageDataConnection();
 }
 
+//----------------------------------------------------------------------------
+void vtkMRMLSliceLayerLogic::SetNonLinearTransformSamplingSpacing(int spacing)
+{
+  spacing = std::max(spacing, 0);
+  if (this->NonLinearTransformSamplingSpacing == spacing)
+    {
+    return;
+    }
+  this->NonLinearTransformSamplingSpacing = spacing;
+  this->UpdateTransforms();
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+vtkAbstractTransform* vtkMRMLSliceLayerLogic::GetNonLinearResliceTransform(const int dimensions[3])
+{
+  const int spacing = this->NonLinearTransformSamplingSpacing;
+  if (spacing <= 0 || !this->SliceNode || !this->VolumeNode)
+    {
+    return this->XYToIJKTransform;
+    }
+
+  // Reuse the sampled transform if neither the geometry nor the transform has changed
+  std::vector<double> samplingKey;
+  const double* xyToRAS = this->SliceNode->GetXYToRAS()->GetData();
+  samplingKey.insert(samplingKey.end(), xyToRAS, xyToRAS + 16);
+  vtkNew<vtkMatrix4x4> rasToIJK;
+  this->VolumeNode->GetRASToIJKMatrix(rasToIJK.GetPointer());
+  samplingKey.insert(samplingKey.end(), rasToIJK->GetData(), rasToIJK->GetData() + 16);
+  samplingKey.insert(samplingKey.end(), dimensions, dimensions + 3);
+  samplingKey.push_back(spacing);
+  samplingKey.push_back(static_cast<double>(GetTransformToWorldMTime(this->VolumeNode->GetParentTransformNode())));
+  if (samplingKey == this->SampledXYToIJKTransformKey)
+    {
+    return this->SampledXYToIJKTransform;
+    }
+
+  // Sample displacements on a grid that covers all pixels of all slices (light box tiles)
+  int gridDimensions[3] =
+    {
+    (dimensions[0] + spacing - 2) / spacing + 1,
+    (dimensions[1] + spacing - 2) / spacing + 1,
+    std::max(dimensions[2], 1)
+    };
+  vtkNew<vtkImageData> displacementGrid;
+  displacementGrid->SetDimensions(gridDimensions);
+  displacementGrid->SetSpacing(spacing, spacing, 1.0);
+  displacementGrid->SetOrigin(0.0, 0.0, 0.0);
+  displacementGrid->AllocateScalars(VTK_DOUBLE, 3);
+  double* displacements = static_cast<double*>(displacementGrid->GetScalarPointer());
+
+  vtkGeneralTransform* xyToIJKTransform = this->XYToIJKTransform;
+  xyToIJKTransform->Update();
+  vtkSMPTools::For(0, static_cast<vtkIdType>(gridDimensions[1]) * gridDimensions[2],
+    [&](vtkIdType beginRow, vtkIdType endRow)
+    {
+    for (vtkIdType row = beginRow; row < endRow; ++row)
+      {
+      double xy[3] = { 0.0, static_cast<double>((row % gridDimensions[1]) * spacing),
+        static_cast<double>(row / gridDimensions[1]) };
+      double* displacement = displacements + 3 * row * gridDimensions[0];
+      for (int i = 0; i < gridDimensions[0]; ++i, displacement += 3)
+        {
+        xy[0] = i * spacing;
+        double ijk[3];
+        xyToIJKTransform->TransformPoint(xy, ijk);
+        displacement[0] = ijk[0] - xy[0];
+        displacement[1] = ijk[1] - xy[1];
+        displacement[2] = ijk[2] - xy[2];
+        }
+      }
+    });
+
+  this->SampledXYToIJKTransform->SetDisplacementGridData(displacementGrid.GetPointer());
+  this->SampledXYToIJKTransformKey = samplingKey;
+  return this->SampledXYToIJKTransform;
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLSliceLayerLogic::SetInteracting(bool interacting)
+{
+  if (this->Interacting == interacting)
+    {
+    return;
+    }
+  this->Interacting = interacting;
+  // Switch reslice input between downsampled and full resolution image
+  this->UpdateImageDisplay();
+}
+
 //----------------------------------------------------------------------------
 void vtkMRMLSliceLayerLogic::UpdateImageDisplay()
 {
@@ -642,8 +926,13 @@ void vtkMRMLSliceLayerLogic::UpdateImageDisplay()
   vtkMRMLScalarVolumeDisplayNode *scalarVolumeDisplayNode = vtkMRMLScalarVolumeDisplayNode::SafeDownCast(this->VolumeDisplayNode);
   vtkMRMLVolumeNode *volumeNode = vtkMRMLVolumeNode::SafeDownCast (this->VolumeNode);
 
+  // Reslice sharing is determined after the reslice filter is set up
+  vtkMRMLSliceLayerLogic* oldSharedResliceLogic = this->SharedResliceLogic;
+  this->SharedResliceLogic = nullptr;
+
   if (this->VolumeNode == nullptr)
     {
+    this->UpdateResliceSharingOfOtherLayers();
     return;
     }
 
@@ -749,8 +1038,17 @@ void vtkMRMLSliceLayerLogic::UpdateImageDisplay()
 //      {
 //      volumeNode->GetImageData()->Print(std::cout);
 //      }
-    this->Reslice->SetInputData(volumeNode->GetImageData());
+    vtkImageData* resliceInputImageData = volumeNode->GetImageData();
+    if (this->Interacting && this->InteractiveDownsampling && resliceInputImageData
+      && resliceInputImageData->GetNumberOfPoints() >= this->InteractiveDownsamplingMinimumNumberOfVoxels)
+      {
+      // Reslice a downsampled image during interaction for faster update.
+      // The downsampled image is in the same IJK coordinate system, therefore transforms are not changed.
+      resliceInputImageData = volumeNode->GetDownsampledImageData();
+      }
+    this->Reslice->SetInputData(resliceInputImageData);
     this->ResliceUVW->SetInputData(volumeNode->GetImageData());
+    this->SharedResliceLogic = this->FindSharedResliceLogic();
     // use the label outline if we have a label map volume, this is the label
     // layer (turned on in slice logic when the label layer is instantiated)
     // and the slice node is set to use it.
@@ -759,7 +1057,7 @@ void vtkMRMLSliceLayerLogic::UpdateImageDisplay()
         this->SliceNode && this->SliceNode->GetUseLabelOutline() )
       {
       vtkDebugMacro("UpdateImageDisplay: volume node (not diff tensor), using label outline");
-      this->LabelOutline->SetInputConnection( this->Reslice->GetOutputPort() );
+      this->LabelOutline->SetInputConnection( this->GetResliceOutputPort() );
       int outlineThickness = labelMapVolumeDisplayNode->GetSliceIntersectionThickness();
       this->LabelOutline->SetOutline(outlineThickness);
       // don't activate 3D UVW reslice pipeline if we use single 2D reslice pipeline
@@ -784,7 +1082,7 @@ void vtkMRMLSliceLayerLogic::UpdateImageDisplay()
     if (volumeNode != nullptr && volumeNode->GetImageData() != nullptr)
       {
       volumeDisplayNode->SetInputImageDataConnection(this->GetSliceImageDataConnection());
-      volumeDisplayNode->SetBackgroundImageStencilDataConnection(this->Reslice->GetOutputPort(1));
+      volumeDisplayNode->SetBackgroundImageStencilDataConnection(this->GetResliceOutputPort(1));
       }
     }
   if (volumeDisplayNodeUVW)
@@ -805,11 +1103,246 @@ void vtkMRMLSliceLayerLogic::UpdateImageDisplay()
        oldLabelUVW != this->LabelOutlineUVW->GetMTime() ||
        (volumeNode != nullptr && (volumeNode->GetMTime() > oldReSliceMTime)) ||
        (volumeDisplayNode != nullptr && (volumeDisplayNode->GetMTime() > oldReSliceMTime)) ||
-       (volumeDisplayNodeUVW != nullptr && (volumeDisplayNodeUVW->GetMTime() > oldReSliceUVWMTime))
+       (volumeDisplayNodeUVW != nullptr && (volumeDisplayNodeUVW->GetMTime() > oldReSliceUVWMTime)) ||
+       this->SharedResliceLogic != oldSharedResliceLogic
        )
     {
     this->Modified();
     }
+
+  this->UpdateResliceSharingOfOtherLayers();
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLSliceLayerLogic::SetResliceSharing(bool sharing)
+{
+  if (this->ResliceSharing == sharing)
+    {
+    return;
+    }
+  this->ResliceSharing = sharing;
+  this->UpdateImageDisplay();
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLSliceLayerLogic::CanShareResliceWith(vtkMRMLSliceLayerLogic* otherLayer)
+{
+  // Only share with layers that use their own reslice output, to avoid chains
+  if (!otherLayer || otherLayer == this || !this->ResliceSharing || !otherLayer->ResliceSharing
+    || otherLayer->SharedResliceLogic != nullptr)
+    {
+    return false;
+    }
+  // Asynchronous reslice output is updated only by the layer that owns it
+  if (this->AsyncReslice || otherLayer->AsyncReslice)
+    {
+    return false;
+    }
+  // Tensor volumes use a different pipeline
+  if (!this->VolumeNode || this->VolumeNode != otherLayer->VolumeNode
+    || this->VolumeNode->IsA("vtkMRMLDiffusionTensorVolumeNode"))
+    {
+    return false;
+    }
+  vtkDataObject* input = this->Reslice->GetInput();
+  if (!input || input != otherLayer->Reslice->GetInput())
+    {
+    return false;
+    }
+  if (this->Reslice->GetInterpolationMode() != otherLayer->Reslice->GetInterpolationMode())
+    {
+    return false;
+    }
+  int* outputExtent = this->Reslice->GetOutputExtent();
+  int* otherOutputExtent = otherLayer->Reslice->GetOutputExtent();
+  if (!std::equal(outputExtent, outputExtent + 6, otherOutputExtent))
+    {
+    return false;
+    }
+  // Only linear transforms can be compared
+  vtkHomogeneousTransform* resliceTransform = vtkHomogeneousTransform::SafeDownCast(this->Reslice->GetResliceTransform());
+  vtkHomogeneousTransform* otherResliceTransform = vtkHomogeneousTransform::SafeDownCast(otherLayer->Reslice->GetResliceTransform());
+  if (!resliceTransform || !otherResliceTransform)
+    {
+    return false;
+    }
+  vtkMatrix4x4* resliceMatrix = resliceTransform->GetMatrix();
+  vtkMatrix4x4* otherResliceMatrix = otherResliceTransform->GetMatrix();
+  for (int row = 0; row < 4; ++row)
+    {
+    for (int column = 0; column < 4; ++column)
+      {
+      if (resliceMatrix->GetElement(row, column) != otherResliceMatrix->GetElement(row, column))
+        {
+        return false;
+        }
+      }
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+vtkMRMLSliceLayerLogic* vtkMRMLSliceLayerLogic::FindSharedResliceLogic()
+{
+  if (!this->ResliceSharing)
+    {
+    return nullptr;
+    }
+  for (vtkMRMLSliceLayerLogic* layer : GetAllSliceLayerLogics())
+    {
+    if (this->CanShareResliceWith(layer))
+      {
+      return layer;
+      }
+    }
+  return nullptr;
+}
+
+//----------------------------------------------------------------------------
+vtkAlgorithmOutput* vtkMRMLSliceLayerLogic::GetResliceOutputPort(int port/*=0*/)
+{
+  if (this->SharedResliceLogic)
+    {
+    return this->SharedResliceLogic->GetReslice()->GetOutputPort(port);
+    }
+  if (this->IsAsynchronousResliceActive())
+    {
+    return port == 0 ? this->AsyncReslice->OutputProducer->GetOutputPort()
+      : this->AsyncReslice->StencilOutputProducer->GetOutputPort();
+    }
+  return this->Reslice->GetOutputPort(port);
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLSliceLayerLogic::SetAsynchronousReslicing(bool asynchronous)
+{
+  if (asynchronous == this->GetAsynchronousReslicing())
+    {
+    return;
+    }
+  if (asynchronous)
+    {
+    this->AsyncReslice = new AsynchronousReslice;
+    }
+  else
+    {
+    delete this->AsyncReslice;
+    this->AsyncReslice = nullptr;
+    }
+  this->UpdateImageDisplay();
+  // Reslice sharing is not possible between asynchronous layers
+  this->UpdateResliceSharingOfOtherLayers();
+  if (this->AsyncReslice)
+    {
+    // Compute the first result synchronously so that the view is not empty
+    this->UpdateAsynchronousReslice();
+    }
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLSliceLayerLogic::GetAsynchronousReslicing()
+{
+  return this->AsyncReslice != nullptr;
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLSliceLayerLogic::IsAsynchronousResliceActive()
+{
+  return this->AsyncReslice && this->VolumeNode && this->VolumeNode->GetImageData()
+    && !this->VolumeNode->IsA("vtkMRMLDiffusionTensorVolumeNode");
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLSliceLayerLogic::UpdateAsynchronousReslice()
+{
+  vtkImageData* input = vtkImageData::SafeDownCast(this->Reslice->GetInput());
+  if (!this->IsAsynchronousResliceActive() || !input)
+    {
+    return false;
+    }
+  AsynchronousReslice* async = this->AsyncReslice;
+  AsynchronousReslice::RequestType request(this->Reslice->GetMTime(), input->GetMTime());
+
+  bool outputModified = false;
+  if (async->IsRunning())
+    {
+    if (!async->Finished)
+      {
+      if (async->WorkerRequest != request)
+        {
+        // Stale request, the current one is started when the worker has stopped
+        async->Cancel();
+        }
+      return false;
+      }
+    async->Worker.join();
+    if (async->Canceled || async->WorkerRequest != request)
+      {
+      // Discard result of a stale request
+      async->WorkerReslice = nullptr;
+      }
+    else
+      {
+      async->Publish();
+      outputModified = true;
+      }
+    }
+
+  if (async->HasPublishedOutput && async->PublishedRequest == request)
+    {
+    return outputModified;
+    }
+  // Without a previous result the output is computed immediately
+  bool synchronous = !async->HasPublishedOutput;
+  async->Start(this->Reslice, input, request, synchronous);
+  return outputModified || synchronous;
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLSliceLayerLogic::IsAsynchronousReslicePending()
+{
+  vtkImageData* input = vtkImageData::SafeDownCast(this->Reslice->GetInput());
+  if (!this->IsAsynchronousResliceActive() || !input)
+    {
+    return false;
+    }
+  if (this->AsyncReslice->IsRunning())
+    {
+    return true;
+    }
+  AsynchronousReslice::RequestType request(this->Reslice->GetMTime(), input->GetMTime());
+  return !this->AsyncReslice->HasPublishedOutput || this->AsyncReslice->PublishedRequest != request;
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLSliceLayerLogic::UpdateResliceSharingOfOtherLayers()
+{
+  if (ResliceSharingUpdateInProgress)
+    {
+    return;
+    }
+  ResliceSharingUpdateInProgress = true;
+  std::set<vtkMRMLSliceLayerLogic*>& layers = GetAllSliceLayerLogics();
+  // Repeat until there are no more changes, as starting or stopping sharing
+  // in one layer may allow or prevent sharing in another
+  for (size_t iteration = 0; iteration < layers.size(); ++iteration)
+    {
+    bool changed = false;
+    for (vtkMRMLSliceLayerLogic* layer : layers)
+      {
+      if (layer != this && layer->FindSharedResliceLogic() != layer->SharedResliceLogic)
+        {
+        layer->UpdateImageDisplay();
+        changed = true;
+        }
+      }
+    if (!changed)
+      {
+      break;
+      }
+    }
+  ResliceSharingUpdateInProgress = false;
 }
 
 //----------------------------------------------------------------------------
@@ -825,7 +1358,7 @@ vtkAlgorithmOutput* vtkMRMLSliceLayerLogic::GetSliceImageDataConnection()
     {
     return this->AssignAttributeScalarsToTensors->GetOutputPort();
     }
-  return this->Reslice->GetOutputPort();
+  return this->GetResliceOutputPort();
 }
 
 //----------------------------------------------------------------------------
@@ -920,6 +1453,11 @@ void vtkMRMLSliceLayerLogic::PrintSelf(ostream& os, vtkIndent indent)
   nextIndent = indent.GetNextIndent();
 
   os << indent << "SlicerSliceLayerLogic:             " << this->GetClassName() << "\n";
+  os << indent << "Interacting: " << (this->Interacting ? "true" : "false") << "\n";
+  os << indent << "InteractiveDownsampling: " << (this->InteractiveDownsampling ? "true" : "false") << "\n";
+  os << indent << "InteractiveDownsamplingMinimumNumberOfVoxels: " << this->InteractiveDownsamplingMinimumNumberOfVoxels << "\n";
+  os << indent << "NonLinearTransformSamplingSpacing: " << this->NonLinearTransformSamplingSpacing << "\n";
+  os << indent << "AsynchronousReslicing: " << (this->AsyncReslice ? "true" : "false") << "\n";
 
   if (this->VolumeNode)
     {
@@ -47,12 +47,16 @@
 #include <vtkImageExtractComponents.h>
 #include <vtkVersion.h>
 
+class vtkAbstractTransform;
 class vtkAssignAttribute;
 class vtkImageReslice;
 class vtkGeneralTransform;
+class vtkGridTransform;
+struct AsynchronousReslice;
 
 // STL includes
 //#include <cstdlib>
+#include <vector>
 
 class vtkImageLabelOutline;
 class vtkTransform;
@@ -135,6 +139,71 @@ public:
   vtkGetMacro(InterpolationMode, int);
   vtkSetMacro(InterpolationMode, int);
 
+  ///
+  /// Set to true while the user interacts with the slice view (the slice logic sets it between
+  /// StartSliceNodeInteraction and EndSliceNodeInteraction). During interaction large volumes are
+  /// resliced from a downsampled image (see vtkMRMLVolumeNode::GetDownsampledImageData) to keep
+  /// the display responsive. Full resolution reslicing is restored when interaction ends.
+  void SetInteracting(bool interacting);
+  vtkGetMacro(Interacting, bool);
+
+  ///
+  /// Enable reslicing of a downsampled image during interaction. Enabled by default.
+  vtkSetMacro(InteractiveDownsampling, bool);
+  vtkGetMacro(InteractiveDownsampling, bool);
+  vtkBooleanMacro(InteractiveDownsampling, bool);
+
+  ///
+  /// Minimum number of voxels in a volume to use a downsampled image during interaction.
+  /// Smaller volumes are resliced fast enough at full resolution. Default is 32M voxels.
+  vtkSetMacro(InteractiveDownsamplingMinimumNumberOfVoxels, vtkIdType);
+  vtkGetMacro(InteractiveDownsamplingMinimumNumberOfVoxels, vtkIdType);
+
+  ///
+  /// Approximate non-linear (e.g., grid or b-spline) volume transforms by a displacement
+  /// field that is sampled on the slice planes with the given spacing (in slice view pixels)
+  /// and linearly interpolated during reslicing. Evaluating the full transform (which may
+  /// require iterative inversion) at each pixel is slow, while the sampled field is only
+  /// recomputed when the transform or the slice geometry changes.
+  /// 0 disables the approximation. Default is 0.
+  void SetNonLinearTransformSamplingSpacing(int spacing);
+  vtkGetMacro(NonLinearTransformSamplingSpacing, int);
+
+  ///
+  /// Allow using the reslice output of another slice layer logic that reslices the same
+  /// image with identical geometry, output extent, and interpolation mode (for example
+  /// linked or compare views with the same field of view and size), instead of reslicing
+  /// the image again. Enabled by default.
+  void SetResliceSharing(bool sharing);
+  vtkGetMacro(ResliceSharing, bool);
+  vtkBooleanMacro(ResliceSharing, bool);
+
+  ///
+  /// Get the layer logic whose reslice output is used by this layer.
+  /// Returns nullptr if the layer uses its own reslice output.
+  vtkMRMLSliceLayerLogic* GetSharedResliceLogic() { return this->SharedResliceLogic; };
+
+  ///
+  /// Reslice on a worker thread so that the application does not block while large
+  /// volumes are resliced. The layer output shows the last completed reslice result
+  /// until the result of the current slice geometry is available. Results of requests
+  /// that became stale in the meantime (for example, while the user keeps scrolling)
+  /// are discarded. Reslicing must be driven by calling UpdateAsynchronousReslice
+  /// periodically while IsAsynchronousReslicePending() returns true.
+  /// Tensor volumes are always resliced synchronously. Disabled by default.
+  void SetAsynchronousReslicing(bool asynchronous);
+  bool GetAsynchronousReslicing();
+
+  ///
+  /// Publish the completed result of the worker thread and start reslicing with the
+  /// current parameters if they have changed. Must be called from the main thread.
+  /// Returns true if the layer output has changed (the view must be rendered).
+  bool UpdateAsynchronousReslice();
+
+  ///
+  /// Returns true if asynchronous reslicing is running or has to be started.
+  bool IsAsynchronousReslicePending();
+
 protected:
   vtkMRMLSliceLayerLogic();
   ~vtkMRMLSliceLayerLogic() override;
@@ -161,6 +230,22 @@ protected:
   // Copy VolumeDisplayNodeObserved into VolumeDisplayNode
   void UpdateVolumeDisplayNode();
 
+  /// Returns true if the reslice output of the other layer can be used by this layer
+  bool CanShareResliceWith(vtkMRMLSliceLayerLogic* otherLayer);
+  /// Find a layer that this layer can share the reslice output with, nullptr if there is none
+  vtkMRMLSliceLayerLogic* FindSharedResliceLogic();
+  /// Output of the reslice filter used in the pipeline (of this or the shared layer)
+  vtkAlgorithmOutput* GetResliceOutputPort(int port = 0);
+  /// Update reslice sharing in other layers, as changes in this layer may allow or prevent sharing
+  void UpdateResliceSharingOfOtherLayers();
+
+  /// Get reslice transform for the current non-linear XYToIJK transform: XYToIJKTransform
+  /// or, if NonLinearTransformSamplingSpacing is set, the sampled approximation of it.
+  vtkAbstractTransform* GetNonLinearResliceTransform(const int dimensions[3]);
+
+  /// Returns true if the reslice output is computed on a worker thread
+  bool IsAsynchronousResliceActive();
+
   ///
   /// the MRML Nodes that define this Logic's parameters
   vtkMRMLVolumeNode *VolumeNode;
@@ -189,6 +274,23 @@ protected:
   int UpdatingTransforms;
 
   int InterpolationMode;
+
+  bool Interacting;
+  bool InteractiveDownsampling;
+  vtkIdType InteractiveDownsamplingMinimumNumberOfVoxels;
+
+  int NonLinearTransformSamplingSpacing;
+  /// Approximation of XYToIJKTransform by a displacement field sampled on the slice planes
+  vtkGridTransform* SampledXYToIJKTransform;
+  /// Slice geometry, volume geometry, sampling spacing, and transform modification time
+  /// that SampledXYToIJKTransform was computed for
+  std::vector<double> SampledXYToIJKTransformKey;
+
+  bool ResliceSharing;
+  vtkMRMLSliceLayerLogic* SharedResliceLogic;
+
+  /// Set if asynchronous reslicing is enabled
+  AsynchronousReslice* AsyncReslice;
 };
 
 #endif
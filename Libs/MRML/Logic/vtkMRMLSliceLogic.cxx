@@ -27,12 +27,19 @@
 #include <vtkMRMLProceduralColorNode.h>
 #include <vtkMRMLScalarVolumeDisplayNode.h>
 #include <vtkMRMLScene.h>
+#include <vtkMRMLSegmentationDisplayNode.h>
+#include <vtkMRMLSegmentationNode.h>
 #include <vtkMRMLSliceCompositeNode.h>
+#include <vtkMRMLTrace.h>
 
 // VTK includes
+#include <vtkAlgorithm.h>
 #include <vtkAlgorithmOutput.h>
 #include <vtkCallbackCommand.h>
 #include <vtkCollection.h>
+#include <vtkDoubleArray.h>
+#include <vtkGeneralTransform.h>
+#include <vtkIdTypeArray.h>
 #include <vtkImageAppendComponents.h>
 #include <vtkImageBlend.h>
 #include <vtkImageResample.h>
@@ -42,26 +49,42 @@
 #include <vtkImageReslice.h>
 #include <vtkImageThreshold.h>
 #include <vtkInformation.h>
+#include <vtkIntArray.h>
 #include <vtkMath.h>
+#include <vtkMatrix4x4.h>
 #include <vtkNew.h>
 #include <vtkObjectFactory.h>
 #include <vtkPlaneSource.h>
+#include <vtkPointData.h>
 #include <vtkPolyDataCollection.h>
 #include <vtkSmartPointer.h>
 #include <vtkStringArray.h>
+#include <vtkTable.h>
+#include <vtkTimerLog.h>
 #include <vtkTransform.h>
 #include <vtkVersion.h>
+#include <vtkWeakPointer.h>
 
 // VTKAddon includes
 #include <vtkAddonMathUtilities.h>
 
+// SegmentationCore includes
+#include <vtkOrientedImageData.h>
+#include <vtkSegment.h>
+#include <vtkSegmentation.h>
+#include <vtkSegmentationConverter.h>
+
 // STD includes
 #include <algorithm>
+#include <limits>
+#include <map>
+#include <string>
 
 //----------------------------------------------------------------------------
 const int vtkMRMLSliceLogic::SLICE_INDEX_ROTATED=-1;
 const int vtkMRMLSliceLogic::SLICE_INDEX_OUT_OF_VOLUME=-2;
 const int vtkMRMLSliceLogic::SLICE_INDEX_NO_VOLUME=-3;
+const int vtkMRMLSliceLogic::PROBE_MAXIMUM_NUMBER_OF_COMPONENTS=4;
 const std::string vtkMRMLSliceLogic::SLICE_MODEL_NODE_NAME_SUFFIX = std::string("Volume Slice");
 
 //----------------------------------------------------------------------------
@@ -191,6 +214,164 @@ struct BlendPipeline
   vtkNew<vtkImageAppendComponents> AddSubAppendRGBA;
   vtkNew<vtkImageCast> AddSubOutputCast;
   vtkNew<vtkImageBlend> Blend;
+
+  /// Output of the blending pipeline.
+  /// With a single layer vtkImageBlend would just copy its input, therefore
+  /// the layer is used directly to save a full copy of the slice image at each render.
+  vtkAlgorithmOutput* GetOutputPort()
+  {
+    if (this->Blend->GetNumberOfInputConnections(0) == 1)
+      {
+      return this->Blend->GetInputConnection(0, 0);
+      }
+    return this->Blend->GetOutputPort();
+  }
+};
+
+//----------------------------------------------------------------------------
+struct PipelineStageTiming
+{
+  std::string Name;
+  vtkWeakPointer<vtkAlgorithm> Algorithm;
+  unsigned long StartObserverTag{0};
+  unsigned long EndObserverTag{0};
+  double StartTime{0.0};
+  double TotalTime{0.0};
+  int NumberOfExecutions{0};
+  vtkIdType OutputVoxels{0};
+};
+
+//----------------------------------------------------------------------------
+struct PipelineTiming
+{
+  PipelineTiming()
+  {
+    this->Callback->SetCallback(PipelineTiming::AlgorithmCallback);
+    this->Callback->SetClientData(this);
+  }
+
+  ~PipelineTiming()
+  {
+    this->RemoveObservers();
+  }
+
+  static void AlgorithmCallback(vtkObject* caller, unsigned long eid, void* clientData, void* vtkNotUsed(callData))
+  {
+    PipelineTiming* self = reinterpret_cast<PipelineTiming*>(clientData);
+    PipelineStageTiming* stage = self->FindStage(vtkAlgorithm::SafeDownCast(caller));
+    if (!stage)
+      {
+      return;
+      }
+    if (eid == vtkCommand::StartEvent)
+      {
+      stage->StartTime = vtkTimerLog::GetUniversalTime();
+      }
+    else if (eid == vtkCommand::EndEvent)
+      {
+      stage->TotalTime += vtkTimerLog::GetUniversalTime() - stage->StartTime;
+      stage->NumberOfExecutions++;
+      vtkImageData* outputImage = vtkImageData::SafeDownCast(stage->Algorithm->GetOutputDataObject(0));
+      stage->OutputVoxels = outputImage ? outputImage->GetNumberOfPoints() : 0;
+      }
+  }
+
+  PipelineStageTiming* FindStage(vtkAlgorithm* algorithm)
+  {
+    if (!algorithm)
+      {
+      return nullptr;
+      }
+    for (PipelineStageTiming& stage : this->Stages)
+      {
+      if (stage.Algorithm.GetPointer() == algorithm)
+        {
+        return &stage;
+        }
+      }
+    return nullptr;
+  }
+
+  /// Add timing observers to the producer of the port and all filters upstream.
+  /// Filters upstream of a reslice filter process the full volume, they get a "Volume/" prefix.
+  void AddUpstreamStages(vtkAlgorithmOutput* port, const std::string& prefix)
+  {
+    vtkAlgorithm* algorithm = port ? port->GetProducer() : nullptr;
+    if (!algorithm || algorithm->IsA("vtkTrivialProducer") || this->FindStage(algorithm))
+      {
+      return;
+      }
+
+    // Make stage name unique, a pipeline may contain the same filter type multiple times
+    std::string baseName = prefix + algorithm->GetClassName();
+    std::string name = baseName;
+    for (int index = 2; this->HasStageName(name); ++index)
+      {
+      name = baseName + " " + std::to_string(index);
+      }
+
+    PipelineStageTiming stage;
+    stage.Name = name;
+    stage.Algorithm = algorithm;
+    stage.StartObserverTag = algorithm->AddObserver(vtkCommand::StartEvent, this->Callback);
+    stage.EndObserverTag = algorithm->AddObserver(vtkCommand::EndEvent, this->Callback);
+    this->Stages.push_back(stage);
+
+    std::string inputPrefix = algorithm->IsA("vtkImageReslice") ? prefix + "Volume/" : prefix;
+    for (int inputPort = 0; inputPort < algorithm->GetNumberOfInputPorts(); ++inputPort)
+      {
+      for (int connection = 0; connection < algorithm->GetNumberOfInputConnections(inputPort); ++connection)
+        {
+        this->AddUpstreamStages(algorithm->GetInputConnection(inputPort, connection), inputPrefix);
+        }
+      }
+  }
+
+  bool HasStageName(const std::string& name)
+  {
+    for (const PipelineStageTiming& stage : this->Stages)
+      {
+      if (stage.Name == name)
+        {
+        return true;
+        }
+      }
+    return false;
+  }
+
+  void RemoveObservers()
+  {
+    for (PipelineStageTiming& stage : this->Stages)
+      {
+      if (stage.Algorithm)
+        {
+        stage.Algorithm->RemoveObserver(stage.StartObserverTag);
+        stage.Algorithm->RemoveObserver(stage.EndObserverTag);
+        }
+      }
+    this->Stages.clear();
+  }
+
+  void Reset()
+  {
+    // Forget about filters that have been removed from the pipeline
+    std::vector<PipelineStageTiming> stages;
+    for (PipelineStageTiming& stage : this->Stages)
+      {
+      if (!stage.Algorithm)
+        {
+        continue;
+        }
+      stage.TotalTime = 0.0;
+      stage.NumberOfExecutions = 0;
+      stage.OutputVoxels = 0;
+      stages.push_back(stage);
+      }
+    this->Stages = stages;
+  }
+
+  std::vector<PipelineStageTiming> Stages;
+  vtkNew<vtkCallbackCommand> Callback;
 };
 
 //----------------------------------------------------------------------------
@@ -209,10 +390,12 @@ vtkMRMLSliceLogic::vtkMRMLSliceLogic()
 
   this->Pipeline = new BlendPipeline;
   this->PipelineUVW = new BlendPipeline;
+  this->PipelineTimings = nullptr;
+  this->AsynchronousReslicing = false;
 
   this->ExtractModelTexture = vtkImageReslice::New();
   this->ExtractModelTexture->SetOutputDimensionality (2);
-  this->ExtractModelTexture->SetInputConnection(this->PipelineUVW->Blend->GetOutputPort());
+  this->ExtractModelTexture->SetInputConnection(this->PipelineUVW->GetOutputPort());
 
   this->SliceModelNode = nullptr;
   this->SliceModelTransformNode = nullptr;
@@ -235,6 +418,7 @@ vtkMRMLSliceLogic::~vtkMRMLSliceLogic()
     this->ImageDataConnection = nullptr;
     }
 
+  delete this->PipelineTimings;
   delete this->Pipeline;
   delete this->PipelineUVW;
 
@@ -587,11 +771,13 @@ void vtkMRMLSliceLogic::ProcessMRMLLogicsEvents()
   if ( this->BackgroundLayer == nullptr )
     {
     vtkNew<vtkMRMLSliceLayerLogic> layer;
+    layer->SetAsynchronousReslicing(this->AsynchronousReslicing);
     this->SetBackgroundLayer(layer.GetPointer());
     }
   if ( this->ForegroundLayer == nullptr )
     {
     vtkNew<vtkMRMLSliceLayerLogic> layer;
+    layer->SetAsynchronousReslicing(this->AsynchronousReslicing);
     this->SetForegroundLayer(layer.GetPointer());
     }
   if ( this->LabelLayer == nullptr )
@@ -599,6 +785,7 @@ void vtkMRMLSliceLogic::ProcessMRMLLogicsEvents()
     vtkNew<vtkMRMLSliceLayerLogic> layer;
     // turn on using the label outline only in this layer
     layer->IsLabelLayerOn();
+    layer->SetAsynchronousReslicing(this->AsynchronousReslicing);
     this->SetLabelLayer(layer.GetPointer());
     }
   // Update slice plane geometry
@@ -933,12 +1120,12 @@ void vtkMRMLSliceLogic::UpdateImageData ()
 {
   if (this->SliceNode->GetSliceResolutionMode() == vtkMRMLSliceNode::SliceResolutionMatch2DView)
     {
-    this->ExtractModelTexture->SetInputConnection( this->Pipeline->Blend->GetOutputPort() );
-    this->ImageDataConnection = this->Pipeline->Blend->GetOutputPort();
+    this->ExtractModelTexture->SetInputConnection( this->Pipeline->GetOutputPort() );
+    this->ImageDataConnection = this->Pipeline->GetOutputPort();
     }
   else
     {
-    this->ExtractModelTexture->SetInputConnection( this->PipelineUVW->Blend->GetOutputPort() );
+    this->ExtractModelTexture->SetInputConnection( this->PipelineUVW->GetOutputPort() );
     }
   // It seems very strange that the imagedata can be null.
   // It should probably be always a valid imagedata with invalid bounds if needed
@@ -947,9 +1134,9 @@ void vtkMRMLSliceLogic::UpdateImageData ()
        (this->GetForegroundLayer() != nullptr && this->GetForegroundLayer()->GetImageDataConnection() != nullptr) ||
        (this->GetLabelLayer() != nullptr && this->GetLabelLayer()->GetImageDataConnection() != nullptr) )
     {
-    if (this->ImageDataConnection == nullptr || this->Pipeline->Blend->GetOutputPort()->GetMTime() > this->ImageDataConnection->GetMTime())
+    if (this->ImageDataConnection != this->Pipeline->GetOutputPort())
       {
-      this->ImageDataConnection = this->Pipeline->Blend->GetOutputPort();
+      this->ImageDataConnection = this->Pipeline->GetOutputPort();
       }
     }
   else
@@ -961,7 +1148,7 @@ void vtkMRMLSliceLogic::UpdateImageData ()
       }
     else
       {
-      this->ExtractModelTexture->SetInputConnection(this->PipelineUVW->Blend->GetOutputPort());
+      this->ExtractModelTexture->SetInputConnection(this->PipelineUVW->GetOutputPort());
       }
     }
 }
@@ -1016,6 +1203,7 @@ bool vtkMRMLSliceLogic::UpdateBlendLayers(vtkImageBlend* blend, const std::deque
 //----------------------------------------------------------------------------
 void vtkMRMLSliceLogic::UpdatePipeline()
 {
+  vtkMRMLTraceScopeMacro("Logic", "vtkMRMLSliceLogic::UpdatePipeline", this->GetName());
   int modified = 0;
   if ( this->SliceCompositeNode )
     {
@@ -1161,6 +1349,293 @@ void vtkMRMLSliceLogic::UpdatePipeline()
       this->Modified();
       }
     }
+  if (this->PipelineTimings)
+    {
+    this->UpdatePipelineTimingObservers();
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLSliceLogic::SetPipelineTimingEnabled(bool enabled)
+{
+  if (enabled == this->GetPipelineTimingEnabled())
+    {
+    return;
+    }
+  if (enabled)
+    {
+    this->PipelineTimings = new PipelineTiming;
+    this->UpdatePipelineTimingObservers();
+    }
+  else
+    {
+    delete this->PipelineTimings;
+    this->PipelineTimings = nullptr;
+    }
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLSliceLogic::GetPipelineTimingEnabled()
+{
+  return this->PipelineTimings != nullptr;
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLSliceLogic::ResetPipelineTimings()
+{
+  if (this->PipelineTimings)
+    {
+    this->PipelineTimings->Reset();
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLSliceLogic::UpdatePipelineTimingObservers()
+{
+  if (!this->PipelineTimings)
+    {
+    return;
+    }
+  // Layers are added first so that their filters are named after the layer,
+  // then the remaining filters of the blending pipeline.
+  this->PipelineTimings->AddUpstreamStages(
+    this->BackgroundLayer ? this->BackgroundLayer->GetImageDataConnection() : nullptr, "Background/");
+  this->PipelineTimings->AddUpstreamStages(
+    this->ForegroundLayer ? this->ForegroundLayer->GetImageDataConnection() : nullptr, "Foreground/");
+  this->PipelineTimings->AddUpstreamStages(
+    this->LabelLayer ? this->LabelLayer->GetImageDataConnection() : nullptr, "Label/");
+  this->PipelineTimings->AddUpstreamStages(this->Pipeline->Blend->GetOutputPort(), "Blend/");
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLSliceLogic::GetPipelineTimings(vtkTable* table)
+{
+  if (!table)
+    {
+    vtkErrorMacro("GetPipelineTimings: invalid table");
+    return;
+    }
+  table->Initialize();
+
+  vtkNew<vtkStringArray> stageArray;
+  stageArray->SetName("Stage");
+  vtkNew<vtkIntArray> numberOfExecutionsArray;
+  numberOfExecutionsArray->SetName("NumberOfExecutions");
+  vtkNew<vtkDoubleArray> totalTimeArray;
+  totalTimeArray->SetName("TotalTime");
+  vtkNew<vtkDoubleArray> averageTimeArray;
+  averageTimeArray->SetName("AverageTime");
+  vtkNew<vtkIdTypeArray> outputVoxelsArray;
+  outputVoxelsArray->SetName("OutputVoxels");
+
+  if (this->PipelineTimings)
+    {
+    for (const PipelineStageTiming& stage : this->PipelineTimings->Stages)
+      {
+      stageArray->InsertNextValue(stage.Name);
+      numberOfExecutionsArray->InsertNextValue(stage.NumberOfExecutions);
+      totalTimeArray->InsertNextValue(stage.TotalTime);
+      averageTimeArray->InsertNextValue(stage.NumberOfExecutions > 0 ? stage.TotalTime / stage.NumberOfExecutions : 0.0);
+      outputVoxelsArray->InsertNextValue(stage.OutputVoxels);
+      }
+    }
+
+  table->AddColumn(stageArray.GetPointer());
+  table->AddColumn(numberOfExecutionsArray.GetPointer());
+  table->AddColumn(totalTimeArray.GetPointer());
+  table->AddColumn(averageTimeArray.GetPointer());
+  table->AddColumn(outputVoxelsArray.GetPointer());
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLSliceLogic::ProbePosition(double xyz[3], vtkIntArray* layerIJKs, vtkDoubleArray* layerValues,
+  vtkStringArray* segmentationNodeIDs, vtkStringArray* segmentIDs)
+{
+  vtkMRMLSliceLayerLogic* layerLogics[3] = { this->BackgroundLayer, this->ForegroundLayer, this->LabelLayer };
+  if (layerIJKs)
+    {
+    layerIJKs->SetNumberOfComponents(3);
+    layerIJKs->SetNumberOfTuples(3);
+    }
+  if (layerValues)
+    {
+    layerValues->SetNumberOfComponents(PROBE_MAXIMUM_NUMBER_OF_COMPONENTS);
+    layerValues->SetNumberOfTuples(3);
+    for (vtkIdType valueIndex = 0; valueIndex < layerValues->GetNumberOfValues(); ++valueIndex)
+      {
+      layerValues->SetValue(valueIndex, std::numeric_limits<double>::quiet_NaN());
+      }
+    }
+
+  for (int layer = LayerBackground; layer <= LayerLabel; ++layer)
+    {
+    int ijk[3] = { 0, 0, 0 };
+    vtkMRMLSliceLayerLogic* layerLogic = layerLogics[layer];
+    vtkMRMLVolumeNode* volumeNode = layerLogic ? layerLogic->GetVolumeNode() : nullptr;
+    if (volumeNode && layerLogic->GetXYToIJKTransform())
+      {
+      double ijkDouble[3] = { 0.0, 0.0, 0.0 };
+      layerLogic->GetXYToIJKTransform()->TransformPoint(xyz, ijkDouble);
+      for (int i = 0; i < 3; ++i)
+        {
+        ijk[i] = vtkMath::Floor(ijkDouble[i] + 0.5);
+        }
+      }
+    if (layerIJKs)
+      {
+      layerIJKs->SetTuple3(layer, ijk[0], ijk[1], ijk[2]);
+      }
+
+    vtkImageData* imageData = volumeNode ? volumeNode->GetImageData() : nullptr;
+    if (!layerValues || !imageData || !imageData->GetPointData() || !imageData->GetPointData()->GetScalars())
+      {
+      continue;
+      }
+    int* extent = imageData->GetExtent();
+    if (ijk[0] < extent[0] || ijk[0] > extent[1]
+      || ijk[1] < extent[2] || ijk[1] > extent[3]
+      || ijk[2] < extent[4] || ijk[2] > extent[5])
+      {
+      continue;
+      }
+    int numberOfComponents = std::min(imageData->GetNumberOfScalarComponents(), PROBE_MAXIMUM_NUMBER_OF_COMPONENTS);
+    for (int component = 0; component < numberOfComponents; ++component)
+      {
+      layerValues->SetComponent(layer, component,
+        imageData->GetScalarComponentAsDouble(ijk[0], ijk[1], ijk[2], component));
+      }
+    }
+
+  if (segmentationNodeIDs && segmentIDs)
+    {
+    vtkMRMLSliceNode* sliceNode = this->GetSliceNode();
+    if (!sliceNode)
+      {
+      segmentationNodeIDs->Reset();
+      segmentIDs->Reset();
+      return;
+      }
+    double xyzw[4] = { xyz[0], xyz[1], xyz[2], 1.0 };
+    double rasw[4] = { 0.0, 0.0, 0.0, 1.0 };
+    sliceNode->GetXYToRAS()->MultiplyPoint(xyzw, rasw);
+    this->GetVisibleSegmentsAtPosition(rasw, segmentationNodeIDs, segmentIDs);
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLSliceLogic::GetVisibleSegmentsAtPosition(double ras[3], vtkStringArray* segmentationNodeIDs,
+  vtkStringArray* segmentIDs)
+{
+  if (!segmentationNodeIDs || !segmentIDs)
+    {
+    vtkErrorMacro("GetVisibleSegmentsAtPosition failed: invalid output arrays");
+    return;
+    }
+  segmentationNodeIDs->Reset();
+  segmentIDs->Reset();
+  vtkMRMLSliceNode* sliceNode = this->GetSliceNode();
+  if (!sliceNode || !this->GetMRMLScene())
+    {
+    return;
+    }
+
+  const std::string labelmapRepresentationName = vtkSegmentationConverter::GetBinaryLabelmapRepresentationName();
+  std::vector<vtkMRMLNode*> segmentationNodes;
+  this->GetMRMLScene()->GetNodesByClass("vtkMRMLSegmentationNode", segmentationNodes);
+  for (vtkMRMLNode* node : segmentationNodes)
+    {
+    vtkMRMLSegmentationNode* segmentationNode = vtkMRMLSegmentationNode::SafeDownCast(node);
+    vtkSegmentation* segmentation = segmentationNode ? segmentationNode->GetSegmentation() : nullptr;
+    if (!segmentation || !segmentation->ContainsRepresentation(labelmapRepresentationName))
+      {
+      continue;
+      }
+
+    std::vector<vtkMRMLSegmentationDisplayNode*> displayNodes;
+    for (int displayNodeIndex = 0; displayNodeIndex < segmentationNode->GetNumberOfDisplayNodes(); ++displayNodeIndex)
+      {
+      vtkMRMLSegmentationDisplayNode* displayNode = vtkMRMLSegmentationDisplayNode::SafeDownCast(
+        segmentationNode->GetNthDisplayNode(displayNodeIndex));
+      if (displayNode && displayNode->GetVisibility(sliceNode->GetID()) && displayNode->GetVisibility2D()
+        && displayNode->GetDisplayRepresentationName2D() == labelmapRepresentationName)
+        {
+        displayNodes.push_back(displayNode);
+        }
+      }
+    if (displayNodes.empty())
+      {
+      continue;
+      }
+
+    // Position in the segmentation node coordinate system
+    double nodePosition[4] = { ras[0], ras[1], ras[2], 1.0 };
+    if (segmentationNode->GetParentTransformNode())
+      {
+      vtkNew<vtkGeneralTransform> worldToNodeTransform;
+      vtkMRMLTransformNode::GetTransformBetweenNodes(nullptr, segmentationNode->GetParentTransformNode(),
+        worldToNodeTransform.GetPointer());
+      worldToNodeTransform->TransformPoint(ras, nodePosition);
+      }
+
+    // Read one voxel in each layer
+    std::map<vtkDataObject*, int> layerLabelValues;
+    vtkNew<vtkCollection> layerObjects;
+    segmentation->GetLayerObjects(layerObjects.GetPointer(), labelmapRepresentationName);
+    for (int layer = 0; layer < layerObjects->GetNumberOfItems(); ++layer)
+      {
+      vtkOrientedImageData* layerImage = vtkOrientedImageData::SafeDownCast(layerObjects->GetItemAsObject(layer));
+      if (!layerImage || !layerImage->GetPointData() || !layerImage->GetPointData()->GetScalars())
+        {
+        continue;
+        }
+      vtkNew<vtkMatrix4x4> nodeToIJKMatrix;
+      layerImage->GetWorldToImageMatrix(nodeToIJKMatrix.GetPointer());
+      double ijkDouble[4] = { 0.0, 0.0, 0.0, 1.0 };
+      nodeToIJKMatrix->MultiplyPoint(nodePosition, ijkDouble);
+      int ijk[3] = { vtkMath::Floor(ijkDouble[0] + 0.5), vtkMath::Floor(ijkDouble[1] + 0.5), vtkMath::Floor(ijkDouble[2] + 0.5) };
+      int* extent = layerImage->GetExtent();
+      if (ijk[0] < extent[0] || ijk[0] > extent[1]
+        || ijk[1] < extent[2] || ijk[1] > extent[3]
+        || ijk[2] < extent[4] || ijk[2] > extent[5])
+        {
+        continue;
+        }
+      int labelValue = static_cast<int>(layerImage->GetScalarComponentAsDouble(ijk[0], ijk[1], ijk[2], 0));
+      if (labelValue != 0)
+        {
+        layerLabelValues[layerImage] = labelValue;
+        }
+      }
+    if (layerLabelValues.empty())
+      {
+      continue;
+      }
+
+    // Find the segments of the voxel label values
+    std::vector<std::string> allSegmentIDs;
+    segmentation->GetSegmentIDs(allSegmentIDs);
+    for (const std::string& segmentID : allSegmentIDs)
+      {
+      vtkSegment* segment = segmentation->GetSegment(segmentID);
+      std::map<vtkDataObject*, int>::iterator labelValueIt =
+        layerLabelValues.find(segment->GetRepresentation(labelmapRepresentationName));
+      if (labelValueIt == layerLabelValues.end() || labelValueIt->second != segment->GetLabelValue())
+        {
+        continue;
+        }
+      for (vtkMRMLSegmentationDisplayNode* displayNode : displayNodes)
+        {
+        if (displayNode->GetSegmentVisibility(segmentID)
+          && (displayNode->GetSegmentVisibility2DFill(segmentID) || displayNode->GetSegmentVisibility2DOutline(segmentID)))
+          {
+          segmentationNodeIDs->InsertNextValue(segmentationNode->GetID());
+          segmentIDs->InsertNextValue(segmentID);
+          break;
+          }
+        }
+      }
+    }
 }
 
 //----------------------------------------------------------------------------
@@ -1244,6 +1719,8 @@ void vtkMRMLSliceLogic::PrintSelf(ostream& os, vtkIndent indent)
     os << indent << "BlendUVW: (none)\n";
     }
 
+  os << indent << "AsynchronousReslicing: " << (this->AsynchronousReslicing ? "true" : "false") << "\n";
+  os << indent << "PipelineTimingEnabled: " << (this->GetPipelineTimingEnabled() ? "true" : "false") << "\n";
   os << indent << "SLICE_MODEL_NODE_NAME_SUFFIX: " << this->SLICE_MODEL_NODE_NAME_SUFFIX << "\n";
 
 }
@@ -2036,6 +2513,9 @@ void vtkMRMLSliceLogic::StartSliceNodeInteraction(unsigned int parameters)
   // to this this outside the conditional on HotLinkedControl and LinkedControl
   this->SliceNode->SetInteractionFlags(parameters);
 
+  // Reslice large volumes at reduced resolution while interacting
+  this->SetLayersInteracting(true);
+
   // If we have hot linked controls, then we want to broadcast changes
   if ((this->SliceCompositeNode->GetHotLinkedControl() || parameters == vtkMRMLSliceNode::MultiplanarReformatFlag)
       && this->SliceCompositeNode->GetLinkedControl())
@@ -2148,6 +2628,9 @@ void vtkMRMLSliceLogic::EndSliceNodeInteraction()
     return;
     }
 
+  // Refine to full resolution
+  this->SetLayersInteracting(false);
+
   // If we have linked controls, then we want to broadcast changes
   if (this->SliceCompositeNode->GetLinkedControl())
     {
@@ -2160,6 +2643,67 @@ void vtkMRMLSliceLogic::EndSliceNodeInteraction()
     }
 }
 
+//----------------------------------------------------------------------------
+void vtkMRMLSliceLogic::SetLayersInteracting(bool interacting)
+{
+  vtkMRMLSliceLayerLogic* layers[3] = { this->BackgroundLayer, this->ForegroundLayer, this->LabelLayer };
+  for (vtkMRMLSliceLayerLogic* layer : layers)
+    {
+    if (layer)
+      {
+      layer->SetInteracting(interacting);
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLSliceLogic::SetAsynchronousReslicing(bool asynchronous)
+{
+  if (this->AsynchronousReslicing == asynchronous)
+    {
+    return;
+    }
+  this->AsynchronousReslicing = asynchronous;
+  vtkMRMLSliceLayerLogic* layers[3] = { this->BackgroundLayer, this->ForegroundLayer, this->LabelLayer };
+  for (vtkMRMLSliceLayerLogic* layer : layers)
+    {
+    if (layer)
+      {
+      layer->SetAsynchronousReslicing(asynchronous);
+      }
+    }
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLSliceLogic::UpdateAsynchronousReslice()
+{
+  bool outputModified = false;
+  vtkMRMLSliceLayerLogic* layers[3] = { this->BackgroundLayer, this->ForegroundLayer, this->LabelLayer };
+  for (vtkMRMLSliceLayerLogic* layer : layers)
+    {
+    if (layer && layer->UpdateAsynchronousReslice())
+      {
+      outputModified = true;
+      }
+    }
+  return outputModified;
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLSliceLogic::IsAsynchronousReslicePending()
+{
+  vtkMRMLSliceLayerLogic* layers[3] = { this->BackgroundLayer, this->ForegroundLayer, this->LabelLayer };
+  for (vtkMRMLSliceLayerLogic* layer : layers)
+    {
+    if (layer && layer->IsAsynchronousReslicePending())
+      {
+      return true;
+      }
+    }
+  return false;
+}
+
 //----------------------------------------------------------------------------
 void vtkMRMLSliceLogic::StartSliceOffsetInteraction()
 {
@@ -33,14 +33,19 @@ class vtkMRMLVolumeNode;
 
 class vtkAlgorithmOutput;
 class vtkCollection;
+class vtkDoubleArray;
 class vtkImageBlend;
 class vtkTransform;
 class vtkImageData;
 class vtkImageReslice;
+class vtkIntArray;
+class vtkStringArray;
+class vtkTable;
 class vtkTransform;
 
 struct SliceLayerInfo;
 struct BlendPipeline;
+struct PipelineTiming;
 
 /// \brief Slicer logic class for slice manipulation.
 ///
@@ -54,6 +59,11 @@ struct BlendPipeline;
 /// which can be used by the vtkSlicerSliceGUI class to display the resulting
 /// composite image or it can be used as a texture map in a vtkSlicerView.
 /// This class can also be used for resampling volumes for further computation.
+///
+/// Each layer reslices its volume first and all voxel-wise display operations
+/// (window/level, color mapping, thresholding, label outline, blending) are applied
+/// on the resliced 2D image only, so their cost does not depend on the volume size.
+/// This can be verified by enabling pipeline timing (\sa SetPipelineTimingEnabled).
 class VTK_MRML_LOGIC_EXPORT vtkMRMLSliceLogic : public vtkMRMLAbstractLogic
 {
 public:
@@ -157,6 +167,8 @@ public:
   ///
   /// The compositing filter
   /// TODO: this will eventually be generalized to a per-layer compositing function
+  /// Note that if only one layer is displayed then the blend filter is bypassed,
+  /// GetImageDataConnection() returns the layer output directly.
   vtkImageBlend* GetBlend();
   vtkImageBlend* GetBlendUVW();
 
@@ -302,6 +314,68 @@ public:
   /// Indicate an interaction with the slice node has been completed
   void EndSliceNodeInteraction();
 
+  /// Set interaction state of all layers. During interaction large volumes
+  /// are resliced at reduced resolution. \sa vtkMRMLSliceLayerLogic::SetInteracting
+  void SetLayersInteracting(bool interacting);
+
+  /// Reslice all layers on worker threads so that the application does not block
+  /// while large volumes are resliced. The application must call
+  /// UpdateAsynchronousReslice periodically while IsAsynchronousReslicePending()
+  /// returns true. Disabled by default.
+  /// \sa vtkMRMLSliceLayerLogic::SetAsynchronousReslicing
+  void SetAsynchronousReslicing(bool asynchronous);
+  vtkGetMacro(AsynchronousReslicing, bool);
+
+  /// Publish completed asynchronous reslice results and start reslicing of
+  /// layers whose parameters have changed.
+  /// Returns true if the slice image has changed and the view must be rendered.
+  bool UpdateAsynchronousReslice();
+
+  /// Returns true if reslicing of any layer is running or has to be started.
+  bool IsAsynchronousReslicePending();
+
+  /// Measure execution time of each filter of the slice image pipeline.
+  /// Disabled by default, as it adds observers to all filters of the pipeline.
+  /// \sa GetPipelineTimings
+  void SetPipelineTimingEnabled(bool enabled);
+  bool GetPipelineTimingEnabled();
+
+  /// Clear execution times measured so far
+  void ResetPipelineTimings();
+
+  /// Get execution times measured since timing was enabled or last reset.
+  /// One row is added for each filter, with columns:
+  /// Stage, NumberOfExecutions, TotalTime, AverageTime (in seconds), OutputVoxels
+  /// (number of voxels of the output image at the last execution).
+  /// Stage names are prefixed by the layer name (Background, Foreground, Label) or Blend.
+  /// Filters that process the full volume (upstream of the layer's reslice filter)
+  /// are prefixed by "<layer>/Volume/".
+  void GetPipelineTimings(vtkTable* table);
+
+  /// Maximum number of voxel components returned for each layer by ProbePosition.
+  static const int PROBE_MAXIMUM_NUMBER_OF_COMPONENTS;
+
+  /// Get voxel index and value of all layers, and the segments visible
+  /// at a slice view XYZ position, in one call (e.g., for the data probe).
+  /// Any of the output arrays may be nullptr if that information is not needed.
+  /// layerIJKs is set to 3 tuples of 3 components: voxel index in the volume of
+  /// each layer (LayerBackground, LayerForeground, LayerLabel), (0,0,0) if there
+  /// is no volume in the layer. The index is set even if it is outside the volume.
+  /// layerValues is set to 3 tuples of PROBE_MAXIMUM_NUMBER_OF_COMPONENTS components:
+  /// voxel value of each layer, unused components and layers without volume or
+  /// outside the volume are set to NaN.
+  /// segmentationNodeIDs and segmentIDs are set as in GetVisibleSegmentsAtPosition.
+  void ProbePosition(double xyz[3], vtkIntArray* layerIJKs, vtkDoubleArray* layerValues,
+    vtkStringArray* segmentationNodeIDs, vtkStringArray* segmentIDs);
+
+  /// Get segments that are displayed as binary labelmap in this slice view and contain
+  /// the RAS position. segmentationNodeIDs and segmentIDs are set to the same number of
+  /// values, one pair for each segment.
+  /// Only one voxel is read for each labelmap layer, regardless of the number of
+  /// segments sharing the layer.
+  void GetVisibleSegmentsAtPosition(double ras[3], vtkStringArray* segmentationNodeIDs,
+    vtkStringArray* segmentIDs);
+
   /// Indicate an interaction with the slice composite node is
   /// beginning. The parameters of the slice node being manipulated
   /// are passed as a bitmask. See vtkMRMLSliceNode::InteractionFlagType.
@@ -410,6 +484,10 @@ protected:
   /// is a relatively expensive operation.
   bool UpdateBlendLayers(vtkImageBlend* blend, const std::deque<SliceLayerInfo> &layers);
 
+  /// Add timing observers to filters of the current pipeline.
+  /// Called whenever the pipeline may have changed while timing is enabled.
+  void UpdatePipelineTimingObservers();
+
   bool                        AddingSliceModelNodes;
   bool                        Initialized;
 
@@ -422,6 +500,8 @@ protected:
 
   BlendPipeline* Pipeline;
   BlendPipeline* PipelineUVW;
+  PipelineTiming* PipelineTimings;
+  bool AsynchronousReslicing;
   vtkImageReslice * ExtractModelTexture;
   vtkAlgorithmOutput *    ImageDataConnection;
   vtkTransform *    ActiveSliceTransform;
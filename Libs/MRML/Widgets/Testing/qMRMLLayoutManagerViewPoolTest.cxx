@@ -0,0 +1,140 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Copyright (c) Kitware Inc.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// Qt includes
+#include <QApplication>
+#include <QPointer>
+#include <QWidget>
+
+// Slicer includes
+#include "qMRMLLayoutManager.h"
+#include "qMRMLLayoutViewFactory.h"
+#include "qMRMLSliceWidget.h"
+#include "vtkSlicerConfigure.h"
+
+// MRML includes
+#include <vtkMRMLApplicationLogic.h>
+#include <vtkMRMLCoreTestingMacros.h>
+#include <vtkMRMLLayoutNode.h>
+#include <vtkMRMLScene.h>
+#include <vtkMRMLSliceNode.h>
+#include <vtkMRMLSliceViewDisplayableManagerFactory.h>
+
+// VTK includes
+#include <vtkNew.h>
+#include "qMRMLWidget.h"
+
+// Common test driver includes
+#include "qMRMLLayoutManagerTestHelper.cxx"
+
+int qMRMLLayoutManagerViewPoolTest(int argc, char * argv[] )
+{
+  qMRMLWidget::preInitializeApplication();
+  QApplication app(argc, argv);
+  qMRMLWidget::postInitializeApplication();
+
+  QWidget w;
+  w.show();
+
+  qMRMLLayoutManager layoutManager(&w, &w);
+
+  vtkNew<vtkMRMLApplicationLogic> applicationLogic;
+  vtkMRMLSliceViewDisplayableManagerFactory::GetInstance()->SetMRMLApplicationLogic(applicationLogic);
+
+  vtkNew<vtkMRMLScene> scene;
+  vtkNew<vtkMRMLLayoutNode> layoutNode;
+  scene->AddNode(layoutNode.GetPointer());
+  applicationLogic->SetMRMLScene(scene.GetPointer());
+  layoutManager.setMRMLScene(scene.GetPointer());
+
+  qMRMLLayoutViewFactory* sliceViewFactory = layoutManager.mrmlViewFactory("vtkMRMLSliceNode");
+  qMRMLLayoutViewFactory* threeDViewFactory = layoutManager.mrmlViewFactory("vtkMRMLViewNode");
+  CHECK_NOT_NULL(sliceViewFactory);
+  CHECK_NOT_NULL(threeDViewFactory);
+
+  layoutManager.setLayout(vtkMRMLLayoutNode::SlicerLayoutOneUpRedSliceView);
+
+  // Pools are filled when the application is idle
+  qApp->processEvents();
+  CHECK_INT(sliceViewFactory->pooledViewCount(), sliceViewFactory->viewPoolSize());
+  CHECK_INT(threeDViewFactory->pooledViewCount(), threeDViewFactory->viewPoolSize());
+  CHECK_BOOL(sliceViewFactory->viewPoolSize() > 0, true);
+
+  // Switching to a layout with more views uses the pooled widgets first
+  int sliceViewPoolSize = sliceViewFactory->viewPoolSize();
+  int sliceViewCount = sliceViewFactory->viewCount();
+  layoutManager.setLayout(vtkMRMLLayoutNode::SlicerLayoutThreeByThreeSliceView);
+  if (!checkViewArrangement(__LINE__, &layoutManager, layoutNode.GetPointer(),
+                            vtkMRMLLayoutNode::SlicerLayoutThreeByThreeSliceView))
+    {
+    return EXIT_FAILURE;
+    }
+  int numberOfNewSliceViews = sliceViewFactory->viewCount() - sliceViewCount;
+  CHECK_BOOL(numberOfNewSliceViews > 0, true);
+  CHECK_INT(sliceViewFactory->pooledViewCount(), qMax(sliceViewPoolSize - numberOfNewSliceViews, 0));
+  qMRMLSliceWidget* slice4Widget = layoutManager.sliceWidget("Slice4");
+  CHECK_NOT_NULL(slice4Widget);
+  CHECK_NOT_NULL(slice4Widget->mrmlSliceNode());
+
+  qApp->processEvents();
+  CHECK_INT(sliceViewFactory->pooledViewCount(), sliceViewPoolSize);
+
+  // Widget of a removed view node is kept in the pool if the pool is not full
+  layoutManager.setLayout(vtkMRMLLayoutNode::SlicerLayoutOneUpRedSliceView);
+  sliceViewFactory->setViewPoolSize(sliceViewPoolSize + 1);
+  QPointer<qMRMLSliceWidget> slice4WidgetPointer(slice4Widget);
+  vtkMRMLNode* slice4Node = scene->GetSingletonNode("Slice4", "vtkMRMLSliceNode");
+  CHECK_NOT_NULL(slice4Node);
+  scene->RemoveNode(slice4Node);
+  CHECK_NULL(layoutManager.sliceWidget("Slice4"));
+  CHECK_INT(sliceViewFactory->pooledViewCount(), sliceViewPoolSize + 1);
+  qApp->processEvents();
+  CHECK_BOOL(slice4WidgetPointer.isNull(), false);
+  CHECK_NULL(slice4WidgetPointer->mrmlSliceNode());
+
+  // Widget of a removed view node is deleted if the pool is full
+  sliceViewFactory->setViewPoolSize(0);
+  CHECK_INT(sliceViewFactory->pooledViewCount(), 0);
+  vtkMRMLNode* slice5Node = scene->GetSingletonNode("Slice5", "vtkMRMLSliceNode");
+  CHECK_NOT_NULL(slice5Node);
+  QPointer<qMRMLSliceWidget> slice5WidgetPointer(layoutManager.sliceWidget("Slice5"));
+  CHECK_BOOL(slice5WidgetPointer.isNull(), false);
+  scene->RemoveNode(slice5Node);
+  CHECK_INT(sliceViewFactory->pooledViewCount(), 0);
+  QApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+  CHECK_BOOL(slice4WidgetPointer.isNull(), true);
+  CHECK_BOOL(slice5WidgetPointer.isNull(), true);
+
+  // Views are created without pool
+  layoutManager.setLayout(vtkMRMLLayoutNode::SlicerLayoutThreeByThreeSliceView);
+  if (!checkViewArrangement(__LINE__, &layoutManager, layoutNode.GetPointer(),
+                            vtkMRMLLayoutNode::SlicerLayoutThreeByThreeSliceView))
+    {
+    return EXIT_FAILURE;
+    }
+  CHECK_NOT_NULL(layoutManager.sliceWidget("Slice4"));
+  CHECK_NOT_NULL(layoutManager.sliceWidget("Slice5"));
+
+  if (argc < 2 || QString(argv[1]) != "-I")
+    {
+    return safeApplicationQuit(&app);
+    }
+  else
+    {
+    return app.exec();
+    }
+}
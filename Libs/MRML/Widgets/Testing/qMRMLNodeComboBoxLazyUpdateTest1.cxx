@@ -109,6 +109,31 @@ int qMRMLNodeComboBoxLazyUpdateTest1( int argc, char * argv [] )
     return EXIT_FAILURE;
     }
 
+  // Nodes added and removed during batch processing are applied on the
+  // existing items at the end of the batch processing
+  scene->StartState(vtkMRMLScene::BatchProcessState);
+  vtkNew<vtkMRMLColorTableNode> node2;
+  scene->AddNode(node2.GetPointer());
+  vtkNew<vtkMRMLColorTableNode> node3;
+  scene->AddNode(node3.GetPointer());
+  scene->RemoveNode(node.GetPointer());
+  if (nodeSelector.nodeCount() != 1)
+    {
+    std::cerr << "qMRMLSceneModel::LazyUpdate failed during batch processing"
+              << std::endl;
+    return EXIT_FAILURE;
+    }
+  scene->EndState(vtkMRMLScene::BatchProcessState);
+
+  if (nodeSelector.nodeCount() != 2 ||
+      nodeSelector.nodeFromIndex(0) != node2.GetPointer() ||
+      nodeSelector.nodeFromIndex(1) != node3.GetPointer())
+    {
+    std::cerr << "qMRMLSceneModel::LazyUpdate failed after batch processing"
+              << std::endl;
+    return EXIT_FAILURE;
+    }
+
   nodeSelector.show();
   nodeSelector2.show();
 
@@ -0,0 +1,92 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// Qt includes
+#include <QApplication>
+
+// qMRML includes
+#include "qMRMLRenderScheduler.h"
+#include "qMRMLSliceView.h"
+#include "qMRMLThreeDView.h"
+#include "qMRMLWidget.h"
+
+// STD includes
+#include <iostream>
+
+int qMRMLRenderSchedulerTest1(int argc, char * argv [] )
+{
+  qMRMLWidget::preInitializeApplication();
+  QApplication app(argc, argv);
+  qMRMLWidget::postInitializeApplication();
+
+  qMRMLThreeDView threeDView;
+  threeDView.setMaximumUpdateRate(0.0);
+  threeDView.show();
+  qMRMLSliceView sliceView;
+  sliceView.setMaximumUpdateRate(0.0);
+  sliceView.show();
+
+  qMRMLRenderScheduler* scheduler = qMRMLRenderScheduler::instance();
+  if (!scheduler || scheduler != qMRMLRenderScheduler::instance())
+    {
+    std::cerr << "Line " << __LINE__ << ": Invalid render scheduler instance" << std::endl;
+    return EXIT_FAILURE;
+    }
+  scheduler->renderPendingViews();
+  scheduler->resetStatistics();
+
+  // Multiple requests are coalesced into a single render
+  scheduler->scheduleRender(&threeDView);
+  scheduler->scheduleRender(&sliceView);
+  scheduler->scheduleRender(&threeDView);
+  if (!scheduler->isRenderPending(&threeDView) || !scheduler->isRenderPending(&sliceView))
+    {
+    std::cerr << "Line " << __LINE__ << ": Render is expected to be pending" << std::endl;
+    return EXIT_FAILURE;
+    }
+  scheduler->renderPendingViews();
+  if (scheduler->isRenderPending(&threeDView) || scheduler->isRenderPending(&sliceView)
+    || scheduler->renderCount(&threeDView) != 1 || scheduler->renderCount(&sliceView) != 1)
+    {
+    std::cerr << "Line " << __LINE__ << ": Unexpected render counts: "
+      << scheduler->renderCount(&threeDView) << ", " << scheduler->renderCount(&sliceView) << std::endl;
+    return EXIT_FAILURE;
+    }
+  if (scheduler->lastRenderTime(&threeDView) < 0.0
+    || scheduler->averageRenderTime(&threeDView) != scheduler->lastRenderTime(&threeDView))
+    {
+    std::cerr << "Line " << __LINE__ << ": Invalid render time" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Hidden views are not rendered
+  sliceView.hide();
+  scheduler->scheduleRender(&sliceView);
+  scheduler->renderPendingViews();
+  if (scheduler->renderCount(&sliceView) != 1)
+    {
+    std::cerr << "Line " << __LINE__ << ": Hidden view is not expected to be rendered" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  scheduler->resetStatistics();
+  if (scheduler->renderCount(&threeDView) != 0)
+    {
+    std::cerr << "Line " << __LINE__ << ": Statistics are expected to be reset" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
@@ -34,6 +34,7 @@
 #include "qMRMLTableView.h"
 
 // MRML includes
+#include "vtkMRMLCoreTestingMacros.h"
 #include "vtkMRMLScene.h"
 #include "vtkMRMLTableNode.h"
 
@@ -85,6 +86,27 @@ int qMRMLTableViewTest1( int argc, char * argv [] )
   tableView->setMRMLTableNode(tableNode.GetPointer());
   vbox.addWidget(tableView);
 
+  // Column names are displayed in the first row
+  qMRMLTableModel* tableModel = tableView->tableModel();
+  CHECK_INT(tableModel->rowCount(), numPoints + 1);
+  CHECK_INT(tableModel->columnCount(), 3);
+  CHECK_BOOL(tableModel->data(tableModel->index(0, 0)).toString() == QString("X Axis"), true);
+  CHECK_DOUBLE(tableModel->data(tableModel->index(1, 2), qMRMLTableModel::SortRole).toDouble(), 2.0);
+
+  // Sorting reorders the rows but not the table
+  tableModel->sort(0, Qt::DescendingOrder);
+  CHECK_BOOL(tableModel->data(tableModel->index(0, 0)).toString() == QString("X Axis"), true);
+  CHECK_DOUBLE(tableModel->data(tableModel->index(1, 0), qMRMLTableModel::SortRole).toDouble(), -3.0);
+  CHECK_INT(tableModel->mrmlTableRowIndex(tableModel->index(1, 0)), numPoints - 1);
+  CHECK_BOOL(tableModel->headerData(1, Qt::Vertical).toString() == QString::number(numPoints + 1), true);
+  CHECK_DOUBLE(table->GetValue(0, 0).ToDouble(), -10.0);
+
+  // Editing a sorted row modifies the corresponding table row
+  CHECK_BOOL(tableModel->setData(tableModel->index(1, 1), QString("100")), true);
+  CHECK_DOUBLE(table->GetValue(numPoints - 1, 1).ToDouble(), 100.0);
+  tableModel->sort(-1);
+  CHECK_DOUBLE(tableModel->data(tableModel->index(1, 0), qMRMLTableModel::SortRole).toDouble(), -10.0);
+
   qMRMLTableView* tableViewTransposed = new qMRMLTableView();
   tableViewTransposed->setParent(&parentWidget);
   tableViewTransposed->setTransposed(true);
@@ -0,0 +1,266 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Copyright (c) Kitware Inc.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// Qt includes
+#include <QApplication>
+#include <QStringList>
+
+// qMRML includes
+#include "qMRMLSliceView.h"
+#include "qMRMLSliceWidget.h"
+#include "qMRMLThreeDView.h"
+#include "qMRMLThreeDWidget.h"
+#include "qMRMLWidget.h"
+
+// MRML includes
+#include <vtkMRMLAbstractDisplayableManager.h>
+#include <vtkMRMLApplicationLogic.h>
+#include <vtkMRMLDisplayableManagerFactory.h>
+#include <vtkMRMLScene.h>
+#include <vtkMRMLSliceLogic.h>
+#include <vtkMRMLSliceNode.h>
+#include <vtkMRMLSliceViewDisplayableManagerFactory.h>
+#include <vtkMRMLThreeDViewDisplayableManagerFactory.h>
+#include <vtkMRMLViewNode.h>
+
+// VTK includes
+#include <vtkCamera.h>
+#include <vtkCollection.h>
+#include <vtkNew.h>
+#include <vtkRenderer.h>
+#include <vtkTimerLog.h>
+
+// STD includes
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Measures the frame time of slice and 3D views while slice offset and camera
+// position are changed, as when the user scrolls through slices or rotates the 3D view.
+// Each frame time includes the update of the displayable managers and the rendering.
+//
+// The 50th, 90th and 99th percentiles of the frame times are reported as DartMeasurements
+// with all the displayable managers of the view, then without each of the displayable
+// managers, to estimate the cost of each displayable manager.
+//
+// Usage: qMRMLViewRenderingPerformanceTest1 scene.mrml [numberOfFrames]
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+double GetPercentile(const std::vector<double>& sortedValues, double percentile)
+{
+  if (sortedValues.empty())
+    {
+    return 0.0;
+    }
+  size_t index = static_cast<size_t>(percentile / 100.0 * (sortedValues.size() - 1) + 0.5);
+  return sortedValues[std::min(index, sortedValues.size() - 1)];
+}
+
+//----------------------------------------------------------------------------
+/// Report percentiles of the frame times (in seconds) and return the median, in milliseconds
+double ReportFrameTimes(const std::string& name, std::vector<double> frameTimes)
+{
+  std::sort(frameTimes.begin(), frameTimes.end());
+  const double percentiles[3] = { 50.0, 90.0, 99.0 };
+  for (double percentile : percentiles)
+    {
+    std::cout << "<DartMeasurement name=\"" << name << "-p" << percentile
+              << "-milliseconds\" type=\"numeric/double\">"
+              << GetPercentile(frameTimes, percentile) * 1000.0 << "</DartMeasurement>" << std::endl;
+    }
+  return GetPercentile(frameTimes, 50.0) * 1000.0;
+}
+
+//----------------------------------------------------------------------------
+void MeasureSliceViewFrameTimes(qMRMLSliceWidget* sliceWidget, int numberOfFrames, std::vector<double>& frameTimes)
+{
+  frameTimes.clear();
+  vtkMRMLSliceLogic* sliceLogic = sliceWidget->sliceLogic();
+  double sliceBounds[6] = { 0.0, -1.0, 0.0, -1.0, 0.0, -1.0 };
+  sliceLogic->GetLowestVolumeSliceBounds(sliceBounds);
+  double originalOffset = sliceLogic->GetSliceOffset();
+  vtkNew<vtkTimerLog> timer;
+  for (int frameIndex = 0; frameIndex < numberOfFrames; ++frameIndex)
+    {
+    // scroll through the volume
+    double fraction = static_cast<double>(frameIndex) / std::max(numberOfFrames - 1, 1);
+    timer->StartTimer();
+    sliceLogic->SetSliceOffset(sliceBounds[4] + fraction * (sliceBounds[5] - sliceBounds[4]));
+    sliceWidget->sliceView()->forceRender();
+    timer->StopTimer();
+    frameTimes.push_back(timer->GetElapsedTime());
+    }
+  sliceLogic->SetSliceOffset(originalOffset);
+}
+
+//----------------------------------------------------------------------------
+void MeasureThreeDViewFrameTimes(qMRMLThreeDWidget* threeDWidget, int numberOfFrames, std::vector<double>& frameTimes)
+{
+  frameTimes.clear();
+  qMRMLThreeDView* threeDView = threeDWidget->threeDView();
+  vtkCamera* camera = threeDView->renderer()->GetActiveCamera();
+  vtkNew<vtkTimerLog> timer;
+  for (int frameIndex = 0; frameIndex < numberOfFrames; ++frameIndex)
+    {
+    // full rotation around the scene
+    timer->StartTimer();
+    camera->Azimuth(360.0 / numberOfFrames);
+    threeDView->renderer()->ResetCameraClippingRange();
+    threeDView->forceRender();
+    timer->StopTimer();
+    frameTimes.push_back(timer->GetElapsedTime());
+    }
+}
+
+//----------------------------------------------------------------------------
+QStringList GetDisplayableManagerClassNames(vtkCollection* displayableManagers)
+{
+  QStringList classNames;
+  for (int i = 0; i < displayableManagers->GetNumberOfItems(); ++i)
+    {
+    vtkMRMLAbstractDisplayableManager* displayableManager =
+      vtkMRMLAbstractDisplayableManager::SafeDownCast(displayableManagers->GetItemAsObject(i));
+    if (displayableManager)
+      {
+      classNames << displayableManager->GetClassName();
+      }
+    }
+  return classNames;
+}
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+int qMRMLViewRenderingPerformanceTest1(int argc, char * argv [] )
+{
+  qMRMLWidget::preInitializeApplication();
+  QApplication app(argc, argv);
+  qMRMLWidget::postInitializeApplication();
+  if (argc < 2)
+    {
+    std::cerr << "Error: missing arguments" << std::endl;
+    std::cerr << "Usage: " << std::endl;
+    std::cerr << argv[0] << "  inputURL_scene.mrml [numberOfFrames]" << std::endl;
+    return EXIT_FAILURE;
+    }
+  int numberOfFrames = (argc > 2 ? std::max(atoi(argv[2]), 1) : 100);
+
+  vtkNew<vtkMRMLScene> scene;
+  vtkNew<vtkMRMLApplicationLogic> applicationLogic;
+  vtkMRMLSliceViewDisplayableManagerFactory::GetInstance()->SetMRMLApplicationLogic(applicationLogic);
+  vtkMRMLThreeDViewDisplayableManagerFactory::GetInstance()->SetMRMLApplicationLogic(applicationLogic);
+  applicationLogic->SetMRMLScene(scene.GetPointer());
+  scene->SetURL(argv[1]);
+  scene->Connect();
+  if (scene->GetNumberOfNodes() == 0)
+    {
+    std::cerr << "Can't load scene:" << argv[1] << " error: " << scene->GetErrorMessage() << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  vtkMRMLSliceNode* redSliceNode = nullptr;
+  std::vector<vtkMRMLNode*> sliceNodes;
+  scene->GetNodesByClass("vtkMRMLSliceNode", sliceNodes);
+  for (unsigned int i = 0; i < sliceNodes.size(); ++i)
+    {
+    vtkMRMLSliceNode* sliceNode = vtkMRMLSliceNode::SafeDownCast(sliceNodes[i]);
+    if (sliceNode && sliceNode->GetLayoutName() && !strcmp(sliceNode->GetLayoutName(), "Red"))
+      {
+      redSliceNode = sliceNode;
+      break;
+      }
+    }
+  if (!redSliceNode)
+    {
+    std::cerr << "Scene must contain a Red slice node" << std::endl;
+    return EXIT_FAILURE;
+    }
+  vtkMRMLViewNode* viewNode = vtkMRMLViewNode::SafeDownCast(scene->GetFirstNodeByClass("vtkMRMLViewNode"));
+  if (!viewNode)
+    {
+    vtkNew<vtkMRMLViewNode> newViewNode;
+    viewNode = vtkMRMLViewNode::SafeDownCast(scene->AddNode(newViewNode.GetPointer()));
+    }
+
+  std::vector<double> frameTimes;
+
+  // Slice view
+  {
+    qMRMLSliceWidget sliceWidget;
+    sliceWidget.resize(600, 600);
+    sliceWidget.setMRMLScene(scene.GetPointer());
+    sliceWidget.setMRMLSliceNode(redSliceNode);
+    sliceWidget.show();
+    qApp->processEvents();
+
+    MeasureSliceViewFrameTimes(&sliceWidget, numberOfFrames, frameTimes);
+    double allMedian = ReportFrameTimes("qMRMLSliceView-All", frameTimes);
+
+    vtkNew<vtkCollection> displayableManagers;
+    sliceWidget.sliceView()->getDisplayableManagers(displayableManagers.GetPointer());
+    vtkMRMLDisplayableManagerFactory* factory = vtkMRMLSliceViewDisplayableManagerFactory::GetInstance();
+    foreach(const QString& className, GetDisplayableManagerClassNames(displayableManagers.GetPointer()))
+      {
+      // the displayable manager is removed from the view while it is not registered
+      factory->UnRegisterDisplayableManager(className.toUtf8());
+      MeasureSliceViewFrameTimes(&sliceWidget, numberOfFrames, frameTimes);
+      double median = ReportFrameTimes("qMRMLSliceView-Without-" + className.toStdString(), frameTimes);
+      factory->RegisterDisplayableManager(className.toUtf8());
+      std::cout << "qMRMLSliceView " << className.toStdString() << ": "
+                << allMedian - median << " ms per frame" << std::endl;
+      }
+  }
+
+  // 3D view
+  {
+    qMRMLThreeDWidget threeDWidget;
+    threeDWidget.resize(600, 600);
+    threeDWidget.setMRMLScene(scene.GetPointer());
+    threeDWidget.setMRMLViewNode(viewNode);
+    threeDWidget.show();
+    qApp->processEvents();
+
+    MeasureThreeDViewFrameTimes(&threeDWidget, numberOfFrames, frameTimes);
+    double allMedian = ReportFrameTimes("qMRMLThreeDView-All", frameTimes);
+
+    vtkNew<vtkCollection> displayableManagers;
+    threeDWidget.threeDView()->getDisplayableManagers(displayableManagers.GetPointer());
+    vtkMRMLDisplayableManagerFactory* factory = vtkMRMLThreeDViewDisplayableManagerFactory::GetInstance();
+    foreach(const QString& className, GetDisplayableManagerClassNames(displayableManagers.GetPointer()))
+      {
+      if (className == "vtkMRMLCameraDisplayableManager")
+        {
+        // the view cannot be rendered without camera
+        continue;
+        }
+      factory->UnRegisterDisplayableManager(className.toUtf8());
+      MeasureThreeDViewFrameTimes(&threeDWidget, numberOfFrames, frameTimes);
+      double median = ReportFrameTimes("qMRMLThreeDView-Without-" + className.toStdString(), frameTimes);
+      factory->RegisterDisplayableManager(className.toUtf8());
+      std::cout << "qMRMLThreeDView " << className.toStdString() << ": "
+                << allMedian - median << " ms per frame" << std::endl;
+      }
+  }
+
+  return EXIT_SUCCESS;
+}
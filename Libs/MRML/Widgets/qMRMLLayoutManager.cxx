@@ -129,7 +129,12 @@ QWidget* qMRMLLayoutThreeDViewFactory::createViewFromNode(vtkMRMLAbstractViewNod
   // There must be a unique ThreeDWidget per node
   Q_ASSERT(!this->viewWidget(viewNode));
 
-  qMRMLThreeDWidget* threeDWidget = new qMRMLThreeDWidget(this->layoutManager()->viewport());
+  // Reuse a pooled widget to avoid creating a render window and displayable managers
+  qMRMLThreeDWidget* threeDWidget = qobject_cast<qMRMLThreeDWidget*>(this->takeViewFromPool());
+  if (!threeDWidget)
+    {
+    threeDWidget = new qMRMLThreeDWidget(this->layoutManager()->viewport());
+    }
   threeDWidget->setObjectName(QString("ThreeDWidget%1").arg(viewNode->GetLayoutLabel()));
   threeDWidget->setViewLabel(viewNode->GetLayoutLabel());
   QColor layoutColor = QColor::fromRgbF(viewNode->GetLayoutColor()[0],
@@ -159,6 +164,30 @@ void qMRMLLayoutThreeDViewFactory::deleteView(vtkMRMLAbstractViewNode* viewNode)
   this->Superclass::deleteView(viewNode);
 }
 
+//------------------------------------------------------------------------------
+QWidget* qMRMLLayoutThreeDViewFactory::createPooledView()
+{
+  if (!this->layoutManager() || !this->layoutManager()->viewport())
+    {
+    return nullptr;
+    }
+  qMRMLThreeDWidget* threeDWidget = new qMRMLThreeDWidget(this->layoutManager()->viewport());
+  threeDWidget->setMRMLScene(this->mrmlScene());
+  return threeDWidget;
+}
+
+//------------------------------------------------------------------------------
+bool qMRMLLayoutThreeDViewFactory::detachView(QWidget* view)
+{
+  qMRMLThreeDWidget* threeDWidget = qobject_cast<qMRMLThreeDWidget*>(view);
+  if (!threeDWidget)
+    {
+    return false;
+    }
+  threeDWidget->setMRMLViewNode(nullptr);
+  return true;
+}
+
 //------------------------------------------------------------------------------
 // qMRMLLayoutChartViewFactory
 #ifdef MRML_WIDGETS_HAVE_WEBENGINE_SUPPORT
@@ -364,8 +393,13 @@ QWidget* qMRMLLayoutSliceViewFactory::createViewFromNode(vtkMRMLAbstractViewNode
   // there is a unique slice widget per node
   Q_ASSERT(!this->viewWidget(viewNode));
 
-  qMRMLSliceWidget * sliceWidget = new qMRMLSliceWidget(this->layoutManager()->viewport());
-  sliceWidget->sliceController()->setControllerButtonGroup(this->SliceControllerButtonGroup);
+  // Reuse a pooled widget to avoid creating a render window and displayable managers
+  qMRMLSliceWidget* sliceWidget = qobject_cast<qMRMLSliceWidget*>(this->takeViewFromPool());
+  if (!sliceWidget)
+    {
+    sliceWidget = new qMRMLSliceWidget(this->layoutManager()->viewport());
+    sliceWidget->sliceController()->setControllerButtonGroup(this->SliceControllerButtonGroup);
+    }
   QString sliceLayoutName(viewNode->GetLayoutName());
   QString sliceViewLabel(viewNode->GetLayoutLabel());
   vtkMRMLSliceNode* sliceNode = vtkMRMLSliceNode::SafeDownCast(viewNode);
@@ -398,6 +432,31 @@ void qMRMLLayoutSliceViewFactory::deleteView(vtkMRMLAbstractViewNode* viewNode)
   this->Superclass::deleteView(viewNode);
 }
 
+// --------------------------------------------------------------------------
+QWidget* qMRMLLayoutSliceViewFactory::createPooledView()
+{
+  if (!this->layoutManager() || !this->layoutManager()->viewport())
+    {
+    return nullptr;
+    }
+  qMRMLSliceWidget* sliceWidget = new qMRMLSliceWidget(this->layoutManager()->viewport());
+  sliceWidget->sliceController()->setControllerButtonGroup(this->SliceControllerButtonGroup);
+  sliceWidget->setMRMLScene(this->mrmlScene());
+  return sliceWidget;
+}
+
+// --------------------------------------------------------------------------
+bool qMRMLLayoutSliceViewFactory::detachView(QWidget* view)
+{
+  qMRMLSliceWidget* sliceWidget = qobject_cast<qMRMLSliceWidget*>(view);
+  if (!sliceWidget)
+    {
+    return false;
+    }
+  sliceWidget->setMRMLSliceNode(nullptr);
+  return true;
+}
+
 //------------------------------------------------------------------------------
 // qMRMLLayoutManagerPrivate methods
 
@@ -432,12 +491,17 @@ void qMRMLLayoutManagerPrivate::init()
 
   q->setSpacing(1);
 
+  // Slice and 3D views are expensive to create (render window and displayable
+  // managers), keep a few of them ready so that switching to a layout with
+  // more views does not need to create them.
   qMRMLLayoutThreeDViewFactory* threeDViewFactory =
     new qMRMLLayoutThreeDViewFactory;
+  threeDViewFactory->setViewPoolSize(1);
   q->registerViewFactory(threeDViewFactory);
 
   qMRMLLayoutSliceViewFactory* sliceViewFactory =
     new qMRMLLayoutSliceViewFactory;
+  sliceViewFactory->setViewPoolSize(3);
   q->registerViewFactory(sliceViewFactory);
 
 #ifdef MRML_WIDGETS_HAVE_WEBENGINE_SUPPORT
@@ -173,6 +173,8 @@ public:
 protected:
   QWidget* createViewFromNode(vtkMRMLAbstractViewNode* viewNode) override;
   void deleteView(vtkMRMLAbstractViewNode* viewNode) override;
+  QWidget* createPooledView() override;
+  bool detachView(QWidget* view) override;
 
   vtkCollection* ViewLogics;
 };
@@ -247,6 +249,8 @@ public:
 protected:
   QWidget* createViewFromNode(vtkMRMLAbstractViewNode* viewNode) override;
   void deleteView(vtkMRMLAbstractViewNode* viewNode) override;
+  QWidget* createPooledView() override;
+  bool detachView(QWidget* view) override;
 
   QButtonGroup* SliceControllerButtonGroup;
   vtkCollection* SliceLogics;
@@ -21,6 +21,7 @@
 // Qt includes
 //#include <QDomElement>
 #include <QDebug>
+#include <QTimer>
 
 // CTK includes
 #include <ctkVTKAbstractView.h>
@@ -59,11 +60,17 @@ public:
 
   QList<qMRMLWidget*> mrmlWidgets()const;
 
+  /// Schedule filling of the view pool when the application is idle.
+  void scheduleFillViewPool();
+
 protected:
   qMRMLLayoutViewFactory* q_ptr;
 
   qMRMLLayoutManager* LayoutManager;
   QHash<vtkMRMLAbstractViewNode*, QWidget*> Views;
+  QList<QWidget*> ViewPool;
+  int ViewPoolSize;
+  bool FillViewPoolScheduled;
 
   vtkMRMLScene* MRMLScene;
   vtkMRMLAbstractViewNode* ActiveViewNode;
@@ -73,6 +80,8 @@ protected:
 qMRMLLayoutViewFactoryPrivate::qMRMLLayoutViewFactoryPrivate(qMRMLLayoutViewFactory& object)
   : q_ptr(&object)
   , LayoutManager(nullptr)
+  , ViewPoolSize(0)
+  , FillViewPoolScheduled(false)
   , MRMLScene(nullptr)
   , ActiveViewNode(nullptr)
 {
@@ -177,6 +186,18 @@ QList<qMRMLWidget*> qMRMLLayoutViewFactoryPrivate
   return res;
 }
 
+//------------------------------------------------------------------------------
+void qMRMLLayoutViewFactoryPrivate::scheduleFillViewPool()
+{
+  Q_Q(qMRMLLayoutViewFactory);
+  if (this->FillViewPoolScheduled || this->ViewPool.size() >= this->ViewPoolSize)
+    {
+    return;
+    }
+  this->FillViewPoolScheduled = true;
+  QTimer::singleShot(0, q, SLOT(fillViewPool()));
+}
+
 //------------------------------------------------------------------------------
 // qMRMLLayoutViewFactory methods
 
@@ -193,6 +214,7 @@ qMRMLLayoutViewFactory::qMRMLLayoutViewFactory(QObject* parentObject)
 qMRMLLayoutViewFactory::~qMRMLLayoutViewFactory()
 {
   Q_D(qMRMLLayoutViewFactory);
+  this->setViewPoolSize(0);
   while(this->viewCount())
     {
     this->deleteView(d->Views.keys()[0]);
@@ -267,7 +289,17 @@ void qMRMLLayoutViewFactory::setMRMLScene(vtkMRMLScene* scene)
 
   d->MRMLScene = scene;
 
+  foreach(QWidget* pooledView, d->ViewPool)
+    {
+    qMRMLWidget* mrmlWidget = qobject_cast<qMRMLWidget*>(pooledView);
+    if (mrmlWidget)
+      {
+      mrmlWidget->setMRMLScene(scene);
+      }
+    }
+
   this->onSceneModified();
+  d->scheduleFillViewPool();
 }
 
 //------------------------------------------------------------------------------
@@ -332,6 +364,70 @@ int qMRMLLayoutViewFactory::viewCount()const
   return d->Views.size();
 }
 
+//------------------------------------------------------------------------------
+int qMRMLLayoutViewFactory::viewPoolSize()const
+{
+  Q_D(const qMRMLLayoutViewFactory);
+  return d->ViewPoolSize;
+}
+
+//------------------------------------------------------------------------------
+void qMRMLLayoutViewFactory::setViewPoolSize(int size)
+{
+  Q_D(qMRMLLayoutViewFactory);
+  d->ViewPoolSize = qMax(size, 0);
+  while (d->ViewPool.size() > d->ViewPoolSize)
+    {
+    QWidget* pooledView = d->ViewPool.takeLast();
+    qMRMLWidget* mrmlWidget = qobject_cast<qMRMLWidget*>(pooledView);
+    if (mrmlWidget)
+      {
+      mrmlWidget->setMRMLScene(nullptr);
+      }
+    pooledView->deleteLater();
+    }
+  d->scheduleFillViewPool();
+}
+
+//------------------------------------------------------------------------------
+int qMRMLLayoutViewFactory::pooledViewCount()const
+{
+  Q_D(const qMRMLLayoutViewFactory);
+  return d->ViewPool.size();
+}
+
+//------------------------------------------------------------------------------
+void qMRMLLayoutViewFactory::fillViewPool()
+{
+  Q_D(qMRMLLayoutViewFactory);
+  d->FillViewPoolScheduled = false;
+  while (d->ViewPool.size() < d->ViewPoolSize)
+    {
+    QWidget* pooledView = this->createPooledView();
+    if (!pooledView)
+      {
+      // pooling is not supported or the layout manager is not ready
+      return;
+      }
+    pooledView->setVisible(false);
+    d->ViewPool << pooledView;
+    }
+}
+
+//------------------------------------------------------------------------------
+QWidget* qMRMLLayoutViewFactory::takeViewFromPool()
+{
+  Q_D(qMRMLLayoutViewFactory);
+  if (d->ViewPool.isEmpty())
+    {
+    return nullptr;
+    }
+  QWidget* pooledView = d->ViewPool.takeFirst();
+  // replace the used view when the current layout is set up
+  d->scheduleFillViewPool();
+  return pooledView;
+}
+
 // --------------------------------------------------------------------------
 void qMRMLLayoutViewFactory::beginSetupLayout()
 {
@@ -457,6 +553,19 @@ QWidget* qMRMLLayoutViewFactory::createViewFromNode(vtkMRMLAbstractViewNode* vie
   return nullptr;
 }
 
+// --------------------------------------------------------------------------
+QWidget* qMRMLLayoutViewFactory::createPooledView()
+{
+  return nullptr;
+}
+
+// --------------------------------------------------------------------------
+bool qMRMLLayoutViewFactory::detachView(QWidget* view)
+{
+  Q_UNUSED(view);
+  return false;
+}
+
 // --------------------------------------------------------------------------
 void qMRMLLayoutViewFactory::deleteView(vtkMRMLAbstractViewNode* viewNode)
 {
@@ -472,14 +581,23 @@ void qMRMLLayoutViewFactory::deleteView(vtkMRMLAbstractViewNode* viewNode)
     {
     return;
     }
-  qMRMLWidget* mrmlWidgetToDelete = qobject_cast<qMRMLWidget*>(widgetToDelete);
-  if (mrmlWidgetToDelete)
-    {
-    mrmlWidgetToDelete->setMRMLScene(nullptr);
-    }
   this->unregisterView(widgetToDelete);
   d->Views.remove(viewNode);
-  widgetToDelete->deleteLater();
+  if (d->ViewPool.size() < d->ViewPoolSize && this->detachView(widgetToDelete))
+    {
+    // keep the widget (and its displayable managers) for another view node
+    widgetToDelete->setVisible(false);
+    d->ViewPool << widgetToDelete;
+    }
+  else
+    {
+    qMRMLWidget* mrmlWidgetToDelete = qobject_cast<qMRMLWidget*>(widgetToDelete);
+    if (mrmlWidgetToDelete)
+      {
+      mrmlWidgetToDelete->setMRMLScene(nullptr);
+      }
+    widgetToDelete->deleteLater();
+    }
   if (this->activeViewNode() == viewNode)
     {
     this->setActiveViewNode(nullptr);
@@ -50,6 +50,19 @@ class QMRML_WIDGETS_EXPORT qMRMLLayoutViewFactory : public ctkLayoutViewFactory
   /// The accesssor MUST BE reimplemented in the derived class.
   /// \sa viewClassName(), isElementSupported, isViewNodeSupported
   Q_PROPERTY(QString viewClassName READ viewClassName);
+  /// This property controls the number of view widgets that are kept ready
+  /// for use without any view node.
+  /// When a view node is removed, its widget is detached from the node and
+  /// kept in the pool (instead of being deleted) if the pool is not full.
+  /// When a widget is needed for a new view node (e.g. when switching to a
+  /// layout with more views), a pooled widget is reused instead of creating
+  /// a new one: no render window is created and no displayable manager is
+  /// instantiated, the widget is only associated with the node and reparented.
+  /// The pool is filled when the application is idle.
+  /// Only factories that reimplement createPooledView() and detachView()
+  /// support pooling. 0 by default (no pooling).
+  /// \sa fillViewPool(), pooledViewCount()
+  Q_PROPERTY(int viewPoolSize READ viewPoolSize WRITE setViewPoolSize);
 public:
   /// Superclass typedef
   typedef ctkLayoutViewFactory Superclass;
@@ -91,6 +104,14 @@ public:
   Q_INVOKABLE QWidget* viewWidgetByLayoutLabel(const QString& layoutLabel)const;
   Q_INVOKABLE int viewCount()const;
 
+  /// \sa viewPoolSize
+  int viewPoolSize()const;
+  void setViewPoolSize(int size);
+
+  /// Number of view widgets currently in the pool.
+  /// \sa viewPoolSize
+  Q_INVOKABLE int pooledViewCount()const;
+
   void beginSetupLayout() override;
 
   vtkMRMLAbstractViewNode* viewNode(QWidget* widget)const;
@@ -120,6 +141,12 @@ public Q_SLOTS:
   /// \sa viewFromXML()
   virtual void onSceneModified();
 
+  /// Create pooled view widgets until the pool contains viewPoolSize widgets.
+  /// Called automatically when the application is idle after a pooled view
+  /// is used or the pool size is increased.
+  /// \sa viewPoolSize
+  void fillViewPool();
+
 Q_SIGNALS:
   /// This signal emitted whenever a new view is created.
   void viewCreated(QWidget* createdView);
@@ -148,6 +175,20 @@ protected:
   virtual QWidget* createViewFromNode(vtkMRMLAbstractViewNode* node);
   virtual void deleteView(vtkMRMLAbstractViewNode* node);
 
+  /// Instantiate a QWidget that is not associated with any view node yet,
+  /// to be kept in the view pool. Returns nullptr by default (no pooling).
+  /// \sa viewPoolSize, detachView(), takeViewFromPool()
+  virtual QWidget* createPooledView();
+  /// Dissociate the widget of a removed view node from the node so that it
+  /// can be reused for another node. Returns false if the widget cannot be
+  /// reused, which is the default.
+  /// \sa viewPoolSize, createPooledView()
+  virtual bool detachView(QWidget* view);
+  /// Remove a widget from the view pool and return it, or return nullptr if
+  /// the pool is empty. To be called in createViewFromNode().
+  /// \sa viewPoolSize
+  QWidget* takeViewFromPool();
+
 private:
   Q_DECLARE_PRIVATE(qMRMLLayoutViewFactory);
   Q_DISABLE_COPY(qMRMLLayoutViewFactory);
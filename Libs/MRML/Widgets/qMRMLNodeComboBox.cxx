@@ -60,6 +60,7 @@ qMRMLNodeComboBoxPrivate::qMRMLNodeComboBoxPrivate(qMRMLNodeComboBox& object)
   this->SelectNodeUponCreation = true;
   this->NoneDisplay = qMRMLNodeComboBox::tr("None");
   this->AutoDefaultText = true;
+  this->NodeItemUpdatesSuspended = false;
 }
 
 // --------------------------------------------------------------------------
@@ -1220,6 +1221,33 @@ void qMRMLNodeComboBox::changeEvent(QEvent *event)
   this->Superclass::changeEvent(event);
 }
 
+//--------------------------------------------------------------------------
+void qMRMLNodeComboBox::showEvent(QShowEvent* event)
+{
+  Q_D(qMRMLNodeComboBox);
+  // Catch up with the nodes modified while the combobox was hidden
+  if (d->NodeItemUpdatesSuspended && d->MRMLSceneModel)
+    {
+    d->NodeItemUpdatesSuspended = false;
+    d->MRMLSceneModel->resumeNodeItemUpdates();
+    }
+  this->Superclass::showEvent(event);
+}
+
+//--------------------------------------------------------------------------
+void qMRMLNodeComboBox::hideEvent(QHideEvent* event)
+{
+  Q_D(qMRMLNodeComboBox);
+  // Hidden comboboxes (e.g. in inactive module panels) do not need to update
+  // their items each time a node is modified.
+  if (!d->NodeItemUpdatesSuspended && d->MRMLSceneModel)
+    {
+    d->NodeItemUpdatesSuspended = true;
+    d->MRMLSceneModel->suspendNodeItemUpdates();
+    }
+  this->Superclass::hideEvent(event);
+}
+
 // --------------------------------------------------------------------------
 void qMRMLNodeComboBox::addMenuAction(QAction *newAction)
 {
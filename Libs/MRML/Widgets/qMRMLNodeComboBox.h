@@ -382,6 +382,11 @@ protected:
   QComboBox* comboBox()const;
 
   void changeEvent(QEvent* event) override;
+  /// Node item updates of the scene model are suspended while the combobox
+  /// is hidden and the modified nodes are updated when it is shown again.
+  /// \sa qMRMLSceneModel::suspendNodeItemUpdates()
+  void showEvent(QShowEvent* event) override;
+  void hideEvent(QHideEvent* event) override;
 
 protected slots:
   void activateExtraItem(const QModelIndex& index);
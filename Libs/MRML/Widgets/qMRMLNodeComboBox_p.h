@@ -87,6 +87,10 @@ public:
   vtkWeakPointer<vtkMRMLNode> RequestedNode;
 
   QList<QAction*> UserMenuActions;
+
+  /// True while the node item updates of the scene model are suspended
+  /// because the combobox is hidden.
+  bool NodeItemUpdatesSuspended;
 };
 
 #endif
@@ -27,6 +27,7 @@
 
 // STD includes
 #include <algorithm>
+#include <cmath>
 #include <sstream>
 #include <vector>
 
@@ -55,12 +56,15 @@
 #include <vtkContextMouseEvent.h>
 #include <vtkContextScene.h>
 #include <vtkContextView.h>
+#include <vtkDoubleArray.h>
 #include <vtkGL2PSExporter.h>
+#include <vtkIdTypeArray.h>
 #include <vtkNew.h>
 #include <vtkPen.h>
 #include <vtkPlot.h>
 #include <vtkPlotLine.h>
 #include <vtkPlotBar.h>
+#include <vtkPlotPoints.h>
 #include <vtkRenderer.h>
 #include <vtkRenderWindow.h>
 #include <vtkSelection.h>
@@ -407,6 +411,240 @@ vtkSmartPointer<vtkPlot> qMRMLPlotViewPrivate::updatePlotFromPlotSeriesNode(vtkM
   return newPlot;
 }
 
+// --------------------------------------------------------------------------
+bool qMRMLPlotViewPrivate::updatePlotDecimation(vtkMRMLPlotSeriesNode* plotSeriesNode, vtkPlot* plot)
+{
+  Q_Q(qMRMLPlotView);
+
+  // Decimation only applies to line and scatter plots. Moved points must be
+  // written to the full-resolution table, therefore series are not decimated
+  // while point moving is enabled.
+  vtkPlotPoints* plotPoints = vtkPlotPoints::SafeDownCast(plot);
+  vtkMRMLTableNode* tableNode = plotSeriesNode ? plotSeriesNode->GetTableNode() : nullptr;
+  vtkTable* table = tableNode ? tableNode->GetTable() : nullptr;
+  vtkAxis* xAxis = q->chart()->GetAxis(vtkAxis::BOTTOM);
+  vtkAxis* yAxis = q->chart()->GetAxis(vtkAxis::LEFT);
+  if (!plotPoints || !table || !xAxis || !yAxis
+    || q->chart()->GetDragPointAlongX() || q->chart()->GetDragPointAlongY())
+    {
+    this->DecimatedPlotTables.remove(plot);
+    return false;
+    }
+
+  // One bin per pixel column
+  const int numberOfXBins = std::max(100, q->width());
+  const int numberOfYBins = std::max(100, q->height());
+  const vtkIdType numberOfPoints = table->GetNumberOfRows();
+  if (numberOfPoints <= 4 * numberOfXBins)
+    {
+    this->DecimatedPlotTables.remove(plot);
+    return false;
+    }
+
+  vtkDataArray* yColumn = vtkDataArray::SafeDownCast(table->GetColumnByName(plotSeriesNode->GetYColumnName().c_str()));
+  vtkDataArray* xColumn = nullptr;
+  if (plotSeriesNode->IsXColumnRequired())
+    {
+    xColumn = vtkDataArray::SafeDownCast(table->GetColumnByName(plotSeriesNode->GetXColumnName().c_str()));
+    if (!xColumn)
+      {
+      this->DecimatedPlotTables.remove(plot);
+      return false;
+      }
+    }
+  if (!yColumn)
+    {
+    this->DecimatedPlotTables.remove(plot);
+    return false;
+    }
+  bool connected = (plot->GetPen() && plot->GetPen()->GetLineType() != vtkPen::NO_PEN);
+  if (connected && xColumn)
+    {
+    // Bins would mix points of distant parts of the curve if x is not monotonic
+    bool increasing = true;
+    bool decreasing = true;
+    for (vtkIdType row = 1; row < numberOfPoints && (increasing || decreasing); row++)
+      {
+      double dx = xColumn->GetComponent(row, 0) - xColumn->GetComponent(row - 1, 0);
+      increasing = increasing && dx >= 0;
+      decreasing = decreasing && dx <= 0;
+      }
+    if (!increasing && !decreasing)
+      {
+      this->DecimatedPlotTables.remove(plot);
+      return false;
+      }
+    }
+
+  // Map coordinates to bins of the visible range. Points outside the visible range
+  // go into the bins below the first and above the last bin, so that bounds
+  // of the series are preserved.
+  double xRange[2] = { 0.0, 1.0 };
+  double yRange[2] = { 0.0, 1.0 };
+  xAxis->GetUnscaledRange(xRange);
+  yAxis->GetUnscaledRange(yRange);
+  bool xLogScale = xAxis->GetLogScale();
+  bool yLogScale = yAxis->GetLogScale();
+  if (xLogScale)
+    {
+    xRange[0] = std::log10(std::max(xRange[0], VTK_DBL_MIN));
+    xRange[1] = std::log10(std::max(xRange[1], VTK_DBL_MIN));
+    }
+  if (yLogScale)
+    {
+    yRange[0] = std::log10(std::max(yRange[0], VTK_DBL_MIN));
+    yRange[1] = std::log10(std::max(yRange[1], VTK_DBL_MIN));
+    }
+  double xBinsPerUnit = (xRange[1] != xRange[0]) ? numberOfXBins / (xRange[1] - xRange[0]) : 0.0;
+  double yBinsPerUnit = (yRange[1] != yRange[0]) ? numberOfYBins / (yRange[1] - yRange[0]) : 0.0;
+  auto binIndex = [](double value, bool logScale, double rangeMin, double binsPerUnit, int numberOfBins)
+    {
+    if (logScale)
+      {
+      value = std::log10(std::max(value, VTK_DBL_MIN));
+      }
+    double bin = std::floor((value - rangeMin) * binsPerUnit);
+    if (!(bin >= 0.0))
+      {
+      return 0;
+      }
+    return bin < numberOfBins ? static_cast<int>(bin) + 1 : numberOfBins + 1;
+    };
+
+  std::vector<vtkIdType> keptRows;
+  if (connected)
+    {
+    // Keep the first, minimum, maximum, and last point of each x bin
+    vtkIdType firstRow = 0;
+    vtkIdType minRow = 0;
+    vtkIdType maxRow = 0;
+    int currentBin = -1;
+    for (vtkIdType row = 0; row <= numberOfPoints; row++)
+      {
+      int bin = -1;
+      if (row < numberOfPoints)
+        {
+        double x = xColumn ? xColumn->GetComponent(row, 0) : static_cast<double>(row);
+        bin = binIndex(x, xLogScale, xRange[0], xBinsPerUnit, numberOfXBins);
+        }
+      if (bin == currentBin)
+        {
+        double y = yColumn->GetComponent(row, 0);
+        if (y < yColumn->GetComponent(minRow, 0))
+          {
+          minRow = row;
+          }
+        if (y > yColumn->GetComponent(maxRow, 0))
+          {
+          maxRow = row;
+          }
+        continue;
+        }
+      if (currentBin >= 0)
+        {
+        // Flush points of the previous bin in their original order
+        vtkIdType binRows[4] = { firstRow, std::min(minRow, maxRow), std::max(minRow, maxRow), row - 1 };
+        for (int i = 0; i < 4; i++)
+          {
+          if (keptRows.empty() || keptRows.back() != binRows[i])
+            {
+            keptRows.push_back(binRows[i]);
+            }
+          }
+        }
+      currentBin = bin;
+      firstRow = minRow = maxRow = row;
+      }
+    }
+  else
+    {
+    // Keep one point per pixel and the extreme points
+    std::vector<bool> occupiedCells(static_cast<size_t>(numberOfXBins + 2) * (numberOfYBins + 2), false);
+    vtkIdType extremeRows[4] = { 0, 0, 0, 0 };
+    double extremeValues[4] = { VTK_DOUBLE_MAX, VTK_DOUBLE_MAX, VTK_DOUBLE_MAX, VTK_DOUBLE_MAX };
+    for (vtkIdType row = 0; row < numberOfPoints; row++)
+      {
+      double x = xColumn ? xColumn->GetComponent(row, 0) : static_cast<double>(row);
+      double y = yColumn->GetComponent(row, 0);
+      double values[4] = { x, -x, y, -y };
+      for (int i = 0; i < 4; i++)
+        {
+        if (values[i] < extremeValues[i])
+          {
+          extremeValues[i] = values[i];
+          extremeRows[i] = row;
+          }
+        }
+      size_t cell = static_cast<size_t>(binIndex(x, xLogScale, xRange[0], xBinsPerUnit, numberOfXBins))
+        * (numberOfYBins + 2) + binIndex(y, yLogScale, yRange[0], yBinsPerUnit, numberOfYBins);
+      if (!occupiedCells[cell])
+        {
+        occupiedCells[cell] = true;
+        keptRows.push_back(row);
+        }
+      }
+    keptRows.insert(keptRows.end(), extremeRows, extremeRows + 4);
+    std::sort(keptRows.begin(), keptRows.end());
+    keptRows.erase(std::unique(keptRows.begin(), keptRows.end()), keptRows.end());
+    }
+
+  // Fill the decimated table
+  vtkSmartPointer<vtkTable> decimatedTable = this->DecimatedPlotTables.value(plot);
+  if (!decimatedTable)
+    {
+    decimatedTable = vtkSmartPointer<vtkTable>::New();
+    vtkNew<vtkDoubleArray> decimatedX;
+    decimatedX->SetName("x");
+    decimatedTable->AddColumn(decimatedX.GetPointer());
+    vtkNew<vtkDoubleArray> decimatedY;
+    decimatedY->SetName("y");
+    decimatedTable->AddColumn(decimatedY.GetPointer());
+    vtkNew<vtkIdTypeArray> originalIndices;
+    originalIndices->SetName("index");
+    decimatedTable->AddColumn(originalIndices.GetPointer());
+    this->DecimatedPlotTables[plot] = decimatedTable;
+    }
+  vtkDoubleArray* decimatedX = vtkDoubleArray::SafeDownCast(decimatedTable->GetColumnByName("x"));
+  vtkDoubleArray* decimatedY = vtkDoubleArray::SafeDownCast(decimatedTable->GetColumnByName("y"));
+  vtkIdTypeArray* originalIndices = vtkIdTypeArray::SafeDownCast(decimatedTable->GetColumnByName("index"));
+  vtkIdType numberOfKeptRows = static_cast<vtkIdType>(keptRows.size());
+  decimatedX->SetNumberOfValues(numberOfKeptRows);
+  decimatedY->SetNumberOfValues(numberOfKeptRows);
+  originalIndices->SetNumberOfValues(numberOfKeptRows);
+  for (vtkIdType i = 0; i < numberOfKeptRows; i++)
+    {
+    vtkIdType row = keptRows[i];
+    decimatedX->SetValue(i, xColumn ? xColumn->GetComponent(row, 0) : static_cast<double>(row));
+    decimatedY->SetValue(i, yColumn->GetComponent(row, 0));
+    originalIndices->SetValue(i, row);
+    }
+  decimatedX->Modified();
+  decimatedY->Modified();
+  originalIndices->Modified();
+
+  vtkStringArray* labelArray = nullptr;
+  if (!plotSeriesNode->GetLabelColumnName().empty())
+    {
+    labelArray = vtkStringArray::SafeDownCast(table->GetColumnByName(plotSeriesNode->GetLabelColumnName().c_str()));
+    }
+  if (labelArray && labelArray->GetNumberOfValues() == numberOfPoints)
+    {
+    vtkNew<vtkStringArray> decimatedLabels;
+    decimatedLabels->SetNumberOfValues(numberOfKeptRows);
+    for (vtkIdType i = 0; i < numberOfKeptRows; i++)
+      {
+      decimatedLabels->SetValue(i, labelArray->GetValue(keptRows[i]));
+      }
+    plot->SetIndexedLabels(decimatedLabels.GetPointer());
+    }
+
+  // x values are explicit in the decimated table, even if the series uses row indices
+  plot->SetUseIndexForXSeries(false);
+  plot->SetInputData(decimatedTable, "x", "y");
+  decimatedTable->Modified();
+  return true;
+}
+
 // --------------------------------------------------------------------------
 void qMRMLPlotViewPrivate::startProcessing()
 {
@@ -654,7 +892,24 @@ void qMRMLPlotViewPrivate::emitSelection()
 
     if (selection->GetNumberOfValues() > 0)
       {
-      selectionCol->AddItem(selection);
+      QMap< vtkPlot*, vtkSmartPointer<vtkTable> >::iterator decimatedIt = this->DecimatedPlotTables.find(plot);
+      vtkIdTypeArray* originalIndices = (decimatedIt != this->DecimatedPlotTables.end()) ?
+        vtkIdTypeArray::SafeDownCast(decimatedIt.value()->GetColumnByName("index")) : nullptr;
+      if (originalIndices)
+        {
+        // Selection refers to points of the decimated series, report rows of the plot series table
+        vtkNew<vtkIdTypeArray> originalSelection;
+        originalSelection->SetNumberOfValues(selection->GetNumberOfValues());
+        for (vtkIdType i = 0; i < selection->GetNumberOfValues(); i++)
+          {
+          originalSelection->SetValue(i, originalIndices->GetValue(selection->GetValue(i)));
+          }
+        selectionCol->AddItem(originalSelection.GetPointer());
+        }
+      else
+        {
+        selectionCol->AddItem(selection);
+        }
       vtkMRMLPlotSeriesNode* plotSeriesNode = this->plotSeriesNodeFromPlot(plot);
       if (plotSeriesNode)
         {
@@ -672,6 +927,32 @@ void qMRMLPlotViewPrivate::emitSelection()
   emit q->dataSelected(mrmlPlotSeriesIDs.GetPointer(), selectionCol.GetPointer());
 }
 
+// --------------------------------------------------------------------------
+void qMRMLPlotViewPrivate::updateDecimatedPlots()
+{
+  Q_Q(qMRMLPlotView);
+
+  if (!q->chart())
+    {
+    return;
+    }
+  for (int plotIndex = 0; plotIndex < q->chart()->GetNumberOfPlots(); plotIndex++)
+    {
+    vtkPlot *plot = q->chart()->GetPlot(plotIndex);
+    vtkMRMLPlotSeriesNode* plotSeriesNode = this->plotSeriesNodeFromPlot(plot);
+    if (!plotSeriesNode)
+      {
+      continue;
+      }
+    bool wasDecimated = this->DecimatedPlotTables.contains(plot);
+    if (!this->updatePlotDecimation(plotSeriesNode, plot) && wasDecimated)
+      {
+      // Decimation is not needed anymore, display the full-resolution series
+      this->updatePlotFromPlotSeriesNode(plotSeriesNode, plot);
+      }
+    }
+}
+
 // --------------------------------------------------------------------------
 void qMRMLPlotViewPrivate::updateWidgetFromMRML()
 {
@@ -739,6 +1020,7 @@ void qMRMLPlotViewPrivate::updateWidgetFromMRML()
       q->removePlot(q->chart()->GetPlot(0));
       }
     this->MapPlotToPlotSeriesNodeID.clear();
+    this->DecimatedPlotTables.clear();
     this->UpdatingWidgetFromMRML = false;
     return;
     }
@@ -794,7 +1076,7 @@ void qMRMLPlotViewPrivate::updateWidgetFromMRML()
         }
       else
         {
-        this->MapPlotToPlotSeriesNodeID[plot] = plotSeriesNode->GetID();
+        this->MapPlotToPlotSeriesNodeID[newPlot] = plotSeriesNode->GetID();
         q->addPlot(newPlot);
         }
       }
@@ -813,6 +1095,7 @@ void qMRMLPlotViewPrivate::updateWidgetFromMRML()
 
       q->removePlot(plot);
       this->MapPlotToPlotSeriesNodeID.remove(plot);
+      this->DecimatedPlotTables.remove(plot);
       }
     }
 
@@ -940,6 +1223,9 @@ void qMRMLPlotViewPrivate::updateWidgetFromMRML()
     axis->GetLabelProperties()->SetFontSize(plotChartNode->GetAxisLabelFontSize());
     }
 
+  // Axis ranges are final now, decimate large series for the visible range
+  this->updateDecimatedPlots();
+
   q->scene()->SetDirty(true);
   this->UpdatingWidgetFromMRML = false;
 }
@@ -56,6 +56,7 @@ class vtkMRMLPlotChartNode;
 class vtkObject;
 class vtkPlot;
 class vtkStringArray;
+class vtkTable;
 
 //-----------------------------------------------------------------------------
 class qMRMLPlotViewPrivate: public QObject
@@ -83,6 +84,13 @@ public:
   // Adjust range to make it displayable with logarithmic scale
   void adjustRangeForLogScale(double range[2], double computedLimit[2]);
 
+  // If the series has much more points than what can be displayed then set a decimated
+  // copy of the series as plot input, computed for the current visible range of the axes.
+  // Connected series keep the first, last, minimum, and maximum point of each
+  // pixel column; unconnected series keep one point per pixel.
+  // Returns true if the plot input is decimated.
+  bool updatePlotDecimation(vtkMRMLPlotSeriesNode* plotSeriesNode, vtkPlot* plot);
+
 public slots:
   /// Handle MRML scene event
   void startProcessing();
@@ -96,6 +104,9 @@ public slots:
 
   void emitSelection();
 
+  /// Recompute decimated plots for the current visible range
+  void updateDecimatedPlots();
+
 protected:
 
   vtkWeakPointer<vtkMRMLScene>         MRMLScene;
@@ -108,6 +119,10 @@ protected:
   bool                               UpdatingWidgetFromMRML;
 
   QMap< vtkPlot*, QString > MapPlotToPlotSeriesNodeID;
+
+  // Decimated copy of the series that is used as plot input.
+  // Column "index" contains the row index of each point in the plot series table.
+  QMap< vtkPlot*, vtkSmartPointer<vtkTable> > DecimatedPlotTables;
 };
 
 #endif
@@ -0,0 +1,220 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// Qt includes
+#include <QApplication>
+#include <QCursor>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QList>
+#include <QTimer>
+
+// CTK includes
+#include <ctkVTKAbstractView.h>
+
+// qMRML includes
+#include "qMRMLRenderScheduler.h"
+
+//------------------------------------------------------------------------------
+class qMRMLRenderSchedulerPrivate
+{
+public:
+  struct ViewStatistics
+    {
+    int RenderCount{0};
+    double LastRenderTime{0.0};
+    double TotalRenderTime{0.0};
+    /// Time elapsed since the last render, used for enforcing the maximum update rate
+    QElapsedTimer SinceLastRender;
+    };
+
+  /// Views to render, in the order of the requests
+  QList<ctkVTKAbstractView*> PendingViews;
+  QHash<QObject*, ViewStatistics> Statistics;
+  QTimer RenderTimer;
+};
+
+//------------------------------------------------------------------------------
+qMRMLRenderScheduler::qMRMLRenderScheduler(QObject* _parent)
+  : Superclass(_parent)
+  , d_ptr(new qMRMLRenderSchedulerPrivate)
+{
+  Q_D(qMRMLRenderScheduler);
+  d->RenderTimer.setSingleShot(true);
+  d->RenderTimer.setInterval(0);
+  QObject::connect(&d->RenderTimer, SIGNAL(timeout()), this, SLOT(renderPendingViews()));
+}
+
+//------------------------------------------------------------------------------
+qMRMLRenderScheduler::~qMRMLRenderScheduler() = default;
+
+//------------------------------------------------------------------------------
+qMRMLRenderScheduler* qMRMLRenderScheduler::instance()
+{
+  static qMRMLRenderScheduler* scheduler = nullptr;
+  if (!scheduler)
+    {
+    // Owned by the application so that it is deleted before the views are
+    scheduler = new qMRMLRenderScheduler(QCoreApplication::instance());
+    }
+  return scheduler;
+}
+
+//------------------------------------------------------------------------------
+void qMRMLRenderScheduler::scheduleRender(ctkVTKAbstractView* view)
+{
+  Q_D(qMRMLRenderScheduler);
+  if (!view || d->PendingViews.contains(view))
+    {
+    // Already scheduled, requests are coalesced
+    return;
+    }
+  if (!d->Statistics.contains(view))
+    {
+    QObject::connect(view, SIGNAL(destroyed(QObject*)), this, SLOT(onViewDestroyed(QObject*)));
+    d->Statistics[view] = qMRMLRenderSchedulerPrivate::ViewStatistics();
+    }
+  d->PendingViews << view;
+  if (!d->RenderTimer.isActive())
+    {
+    d->RenderTimer.start(0);
+    }
+}
+
+//------------------------------------------------------------------------------
+void qMRMLRenderScheduler::renderPendingViews()
+{
+  Q_D(qMRMLRenderScheduler);
+  if (d->PendingViews.isEmpty())
+    {
+    return;
+    }
+
+  // Render the view that the user is interacting with first
+  QWidget* widgetUnderMouse = QApplication::widgetAt(QCursor::pos());
+  if (widgetUnderMouse)
+    {
+    for (int viewIndex = 0; viewIndex < d->PendingViews.size(); ++viewIndex)
+      {
+      ctkVTKAbstractView* view = d->PendingViews[viewIndex];
+      if (view == widgetUnderMouse || view->isAncestorOf(widgetUnderMouse))
+        {
+        d->PendingViews.move(viewIndex, 0);
+        break;
+        }
+      }
+    }
+
+  QList<ctkVTKAbstractView*> viewsToRender = d->PendingViews;
+  d->PendingViews.clear();
+  int nextRenderDelayMs = -1;
+  foreach(ctkVTKAbstractView* view, viewsToRender)
+    {
+    qMRMLRenderSchedulerPrivate::ViewStatistics& statistics = d->Statistics[view];
+    if (!view->renderEnabled() || !view->isVisible())
+      {
+      // Views that cannot be rendered now are rendered when they request it again
+      continue;
+      }
+    double maximumUpdateRate = view->maximumUpdateRate();
+    if (maximumUpdateRate > 0.0 && statistics.SinceLastRender.isValid())
+      {
+      int minimumRenderIntervalMs = static_cast<int>(1000.0 / maximumUpdateRate);
+      int remainingMs = minimumRenderIntervalMs - static_cast<int>(statistics.SinceLastRender.elapsed());
+      if (remainingMs > 0)
+        {
+        // Rendered too recently, try again later
+        d->PendingViews << view;
+        nextRenderDelayMs = (nextRenderDelayMs < 0 ? remainingMs : qMin(nextRenderDelayMs, remainingMs));
+        continue;
+        }
+      }
+    QElapsedTimer renderTimer;
+    renderTimer.start();
+    view->forceRender();
+    double renderTimeMs = renderTimer.nsecsElapsed() * 1e-6;
+    statistics.RenderCount++;
+    statistics.LastRenderTime = renderTimeMs;
+    statistics.TotalRenderTime += renderTimeMs;
+    statistics.SinceLastRender.start();
+    emit viewRendered(view, renderTimeMs);
+    }
+
+  if (nextRenderDelayMs >= 0 && !d->RenderTimer.isActive())
+    {
+    d->RenderTimer.start(nextRenderDelayMs);
+    }
+}
+
+//------------------------------------------------------------------------------
+bool qMRMLRenderScheduler::isRenderPending(ctkVTKAbstractView* view)const
+{
+  Q_D(const qMRMLRenderScheduler);
+  return d->PendingViews.contains(view);
+}
+
+//------------------------------------------------------------------------------
+int qMRMLRenderScheduler::renderCount(ctkVTKAbstractView* view)const
+{
+  Q_D(const qMRMLRenderScheduler);
+  return d->Statistics.value(view).RenderCount;
+}
+
+//------------------------------------------------------------------------------
+double qMRMLRenderScheduler::lastRenderTime(ctkVTKAbstractView* view)const
+{
+  Q_D(const qMRMLRenderScheduler);
+  return d->Statistics.value(view).LastRenderTime;
+}
+
+//------------------------------------------------------------------------------
+double qMRMLRenderScheduler::averageRenderTime(ctkVTKAbstractView* view)const
+{
+  Q_D(const qMRMLRenderScheduler);
+  qMRMLRenderSchedulerPrivate::ViewStatistics statistics = d->Statistics.value(view);
+  if (statistics.RenderCount == 0)
+    {
+    return 0.0;
+    }
+  return statistics.TotalRenderTime / statistics.RenderCount;
+}
+
+//------------------------------------------------------------------------------
+void qMRMLRenderScheduler::resetStatistics()
+{
+  Q_D(qMRMLRenderScheduler);
+  for (QHash<QObject*, qMRMLRenderSchedulerPrivate::ViewStatistics>::iterator it = d->Statistics.begin();
+    it != d->Statistics.end(); ++it)
+    {
+    it.value().RenderCount = 0;
+    it.value().LastRenderTime = 0.0;
+    it.value().TotalRenderTime = 0.0;
+    }
+}
+
+//------------------------------------------------------------------------------
+void qMRMLRenderScheduler::onViewDestroyed(QObject* view)
+{
+  Q_D(qMRMLRenderScheduler);
+  // The view is partially destroyed, only compare pointers
+  for (int viewIndex = d->PendingViews.size() - 1; viewIndex >= 0; --viewIndex)
+    {
+    if (static_cast<QObject*>(d->PendingViews[viewIndex]) == view)
+      {
+      d->PendingViews.removeAt(viewIndex);
+      }
+    }
+  d->Statistics.remove(view);
+}
@@ -0,0 +1,89 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#ifndef __qMRMLRenderScheduler_h
+#define __qMRMLRenderScheduler_h
+
+// Qt includes
+#include <QObject>
+
+// CTK includes
+#include <ctkPimpl.h>
+
+#include "qMRMLWidgetsExport.h"
+
+class ctkVTKAbstractView;
+class qMRMLRenderSchedulerPrivate;
+
+/// \brief Render scheduler shared by all the views of the application.
+///
+/// Views request a render when their displayable managers changed something
+/// (vtkMRMLDisplayableManagerGroup::RequestRender). Instead of each view
+/// starting its own render timer, requests are collected and all the views
+/// that were marked as modified are rendered once, at the next event loop
+/// iteration. The view under the mouse cursor is rendered first.
+/// The maximum update rate of each view is respected.
+///
+/// Number and duration of renders are recorded for each view.
+class QMRML_WIDGETS_EXPORT qMRMLRenderScheduler : public QObject
+{
+  Q_OBJECT
+public:
+  typedef QObject Superclass;
+  explicit qMRMLRenderScheduler(QObject* parent = nullptr);
+  ~qMRMLRenderScheduler() override;
+
+  /// Scheduler that is used by the MRML views
+  static qMRMLRenderScheduler* instance();
+
+  /// Return true if a render of the view is requested but not done yet.
+  Q_INVOKABLE bool isRenderPending(ctkVTKAbstractView* view)const;
+
+  /// Number of renders performed by the scheduler for the view.
+  Q_INVOKABLE int renderCount(ctkVTKAbstractView* view)const;
+
+  /// Duration of the last render of the view (in milliseconds).
+  Q_INVOKABLE double lastRenderTime(ctkVTKAbstractView* view)const;
+
+  /// Average duration of renders of the view (in milliseconds).
+  Q_INVOKABLE double averageRenderTime(ctkVTKAbstractView* view)const;
+
+  /// Clear render counts and timing of all views.
+  Q_INVOKABLE void resetStatistics();
+
+public slots:
+  /// Mark the view as modified. It will be rendered at the next event loop iteration,
+  /// along with all the other views that are modified until then.
+  void scheduleRender(ctkVTKAbstractView* view);
+
+  /// Render all the views that are marked as modified now
+  void renderPendingViews();
+
+signals:
+  /// Emitted after the scheduler rendered a view
+  void viewRendered(ctkVTKAbstractView* view, double renderTimeMs);
+
+protected slots:
+  void onViewDestroyed(QObject* view);
+
+protected:
+  QScopedPointer<qMRMLRenderSchedulerPrivate> d_ptr;
+
+private:
+  Q_DECLARE_PRIVATE(qMRMLRenderScheduler);
+  Q_DISABLE_COPY(qMRMLRenderScheduler);
+};
+
+#endif
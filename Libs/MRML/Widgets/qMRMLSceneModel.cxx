@@ -47,6 +47,8 @@ qMRMLSceneModelPrivate::qMRMLSceneModelPrivate(qMRMLSceneModel& object)
   this->LazyUpdate = false;
   this->ListenNodeModifiedEvent = qMRMLSceneModel::NoNodes;
   this->PendingItemModified = -1; // -1 means not updating
+  this->NodeItemUpdatesSuspendCount = 0;
+  this->PendingSceneRebuild = false;
 
   this->NameColumn = -1;
   this->IDColumn = -1;
@@ -118,6 +120,17 @@ QModelIndexList qMRMLSceneModelPrivate::indexes(const QString& nodeID)const
   return nodeIndexes;
 }
 
+//------------------------------------------------------------------------------
+bool qMRMLSceneModelPrivate::isUpdateDeferred()const
+{
+  if (!this->MRMLScene || this->MRMLScene->IsClosing())
+    {
+    // The scene is fully updated when it is closed
+    return false;
+    }
+  return this->MRMLScene->IsImporting() || (this->LazyUpdate && this->MRMLScene->IsBatchProcessing());
+}
+
 //------------------------------------------------------------------------------
 void qMRMLSceneModelPrivate::listenNodeModifiedEvent()
 {
@@ -646,6 +659,61 @@ bool qMRMLSceneModel::lazyUpdate()const
   return d->LazyUpdate;
 }
 
+//------------------------------------------------------------------------------
+void qMRMLSceneModel::suspendNodeItemUpdates()
+{
+  Q_D(qMRMLSceneModel);
+  ++d->NodeItemUpdatesSuspendCount;
+}
+
+//------------------------------------------------------------------------------
+void qMRMLSceneModel::resumeNodeItemUpdates()
+{
+  Q_D(qMRMLSceneModel);
+  if (d->NodeItemUpdatesSuspendCount <= 0)
+    {
+    qWarning() << Q_FUNC_INFO << "failed: node item updates are not suspended";
+    return;
+    }
+  --d->NodeItemUpdatesSuspendCount;
+  if (d->NodeItemUpdatesSuspendCount == 0)
+    {
+    this->updatePendingNodeItems();
+    }
+}
+
+//------------------------------------------------------------------------------
+bool qMRMLSceneModel::nodeItemUpdatesSuspended()const
+{
+  Q_D(const qMRMLSceneModel);
+  return d->NodeItemUpdatesSuspendCount > 0;
+}
+
+//------------------------------------------------------------------------------
+void qMRMLSceneModel::updatePendingNodeItems()
+{
+  Q_D(qMRMLSceneModel);
+  if (d->PendingModifiedNodeIDs.isEmpty())
+    {
+    return;
+    }
+  QSet<QString> pendingNodeIDs;
+  pendingNodeIDs.swap(d->PendingModifiedNodeIDs);
+  if (!d->MRMLScene)
+    {
+    return;
+    }
+  foreach(const QString& nodeID, pendingNodeIDs)
+    {
+    // The node may have been removed since it was modified
+    vtkMRMLNode* node = d->MRMLScene->GetNodeByID(nodeID.toUtf8().constData());
+    if (node && this->indexFromNode(node).isValid())
+      {
+      this->updateNodeItems(node, nodeID);
+      }
+    }
+}
+
 //------------------------------------------------------------------------------
 QMimeData* qMRMLSceneModel::mimeData(const QModelIndexList& indexes)const
 {
@@ -697,6 +765,10 @@ void qMRMLSceneModel::updateScene()
                  this, SLOT(onMRMLNodeIDChanged(vtkObject*,void*)));
 
   d->RowCache.clear();
+  // All the items are recreated from the current scene
+  d->PendingModifiedNodeIDs.clear();
+  d->PendingRemovedNodeIDs.clear();
+  d->PendingSceneRebuild = false;
 
   // Enabled so it can be interacted with
   this->invisibleRootItem()->setFlags(Qt::ItemIsEnabled);
@@ -786,6 +858,60 @@ void qMRMLSceneModel::populateScene()
     }
 }
 
+//------------------------------------------------------------------------------
+void qMRMLSceneModel::updateSceneIncrementally()
+{
+  Q_D(qMRMLSceneModel);
+  if (d->PendingSceneRebuild || !d->MRMLScene || !this->mrmlSceneItem())
+    {
+    this->updateScene();
+    return;
+    }
+
+  // Remove the items of the nodes that have been removed from the scene
+  QStringList removedNodeIDs;
+  removedNodeIDs.swap(d->PendingRemovedNodeIDs);
+  foreach(const QString& nodeID, removedNodeIDs)
+    {
+    QModelIndexList nodeIndexes = d->indexes(nodeID);
+    if (nodeIndexes.isEmpty())
+      {
+      continue;
+      }
+    QStandardItem* item = this->itemFromIndex(nodeIndexes[0]);
+    if (item->rowCount() > this->preItems(item).count() + this->postItems(item).count())
+      {
+      // The children of the removed node would need to be reparented
+      this->updateScene();
+      return;
+      }
+    this->removeRow(nodeIndexes[0].row(), nodeIndexes[0].parent());
+    }
+
+  // Insert the nodes that have been added to the scene, nodes that are
+  // already in the model are skipped.
+  int index = -1;
+  vtkMRMLNode *node = nullptr;
+  vtkCollectionSimpleIterator it;
+  d->MisplacedNodes.clear();
+  for (d->MRMLScene->GetNodes()->InitTraversal(it);
+       (node = (vtkMRMLNode*)d->MRMLScene->GetNodes()->GetNextItemAsObject(it)) ;)
+    {
+    index++;
+    d->insertNode(node, index);
+    }
+  foreach(vtkMRMLNode* misplacedNode, d->MisplacedNodes)
+    {
+    this->onMRMLNodeModified(misplacedNode);
+    }
+
+  // Update the nodes that have been modified
+  if (d->NodeItemUpdatesSuspendCount == 0)
+    {
+    this->updatePendingNodeItems();
+    }
+}
+
 //------------------------------------------------------------------------------
 QStandardItem* qMRMLSceneModel::insertNode(vtkMRMLNode* node)
 {
@@ -1206,10 +1332,19 @@ void qMRMLSceneModel::onMRMLSceneNodeAboutToBeRemoved(vtkMRMLScene* scene, vtkMR
   Q_UNUSED(scene);
   Q_ASSERT(scene == d->MRMLScene);
 
-  if (d->MRMLScene->IsClosing() || (d->LazyUpdate && d->MRMLScene->IsBatchProcessing()))
+  if (d->MRMLScene->IsClosing())
     {
     return;
     }
+  if (d->LazyUpdate && d->MRMLScene->IsBatchProcessing())
+    {
+    // The item is removed at the end of the batch processing
+    if (this->indexFromNode(node).isValid())
+      {
+      d->PendingRemovedNodeIDs << QString(node->GetID());
+      }
+    return;
+    }
 
   int connectionsRemoved =
     qvtkDisconnect(node, vtkCommand::ModifiedEvent,
@@ -1342,14 +1477,27 @@ void qMRMLSceneModel::updateNodeItems()
 //------------------------------------------------------------------------------
 void qMRMLSceneModel::onMRMLNodeModified(vtkObject* node)
 {
+  Q_D(qMRMLSceneModel);
   vtkMRMLNode* modifiedNode = vtkMRMLNode::SafeDownCast(node);
+  if (d->NodeItemUpdatesSuspendCount > 0 || d->isUpdateDeferred())
+    {
+    d->PendingModifiedNodeIDs.insert(QString(modifiedNode->GetID()));
+    return;
+    }
   this->updateNodeItems(modifiedNode, QString(modifiedNode->GetID()));
 }
 
 //------------------------------------------------------------------------------
 void qMRMLSceneModel::onMRMLNodeIDChanged(vtkObject* node, void* callData)
 {
+  Q_D(qMRMLSceneModel);
   char* oldID = reinterpret_cast<char *>(callData);
+  if (d->isUpdateDeferred())
+    {
+    // Items cannot be found by the old ID after the deferred update
+    d->PendingSceneRebuild = true;
+    return;
+    }
   this->updateNodeItems(vtkMRMLNode::SafeDownCast(node), QString(oldID));
 }
 
@@ -1480,9 +1628,14 @@ void qMRMLSceneModel::onMRMLSceneImported(vtkMRMLScene* scene)
 {
   Q_D(qMRMLSceneModel);
   Q_UNUSED(scene);
+  if (d->LazyUpdate && d->MRMLScene->IsBatchProcessing())
+    {
+    // The model is updated once, at the end of the batch processing
+    return;
+    }
   // Node IDs and references are not valid until the import is completed,
   // therefore we must update the model now (see https://issues.slicer.org/view.php?id=4080).
-  this->updateScene();
+  this->updateSceneIncrementally();
   //this->endResetModel();
 }
 
@@ -1518,7 +1671,7 @@ void qMRMLSceneModel::onMRMLSceneEndBatchProcess(vtkMRMLScene* scene)
   Q_UNUSED(scene);
   if (d->LazyUpdate)
     {
-    this->updateScene();
+    this->updateSceneIncrementally();
     emit sceneUpdated();
     }
 }
@@ -151,6 +151,20 @@ public:
   bool lazyUpdate()const;
   void setLazyUpdate(bool lazy);
 
+  /// Stop updating the node items when nodes are modified, for example while
+  /// the views of the model are hidden. The modified nodes are recorded
+  /// and their items are updated in one pass when resumeNodeItemUpdates()
+  /// has been called as many times as suspendNodeItemUpdates(), therefore
+  /// a model shared by multiple widgets is updated when any of them is visible.
+  /// Adding, removing, and renaming node IDs are not suspended.
+  /// \sa resumeNodeItemUpdates(), updatePendingNodeItems()
+  void suspendNodeItemUpdates();
+  void resumeNodeItemUpdates();
+  bool nodeItemUpdatesSuspended()const;
+  /// Update the items of the nodes that have been modified while the node item updates
+  /// are suspended, without resuming updates.
+  void updatePendingNodeItems();
+
   int nameColumn()const;
   void setNameColumn(int column);
 
@@ -265,6 +279,10 @@ protected:
 
   virtual void updateScene();
   virtual void populateScene();
+  /// Update the model after scene import or batch processing: remove the items
+  /// of the removed nodes, insert the added nodes and update the modified nodes.
+  /// Falls back to updateScene() if the changes cannot be applied on the existing items.
+  virtual void updateSceneIncrementally();
   virtual QStandardItem* insertNode(vtkMRMLNode* node);
   virtual QStandardItem* insertNode(vtkMRMLNode* node, QStandardItem* parent, int row = -1);
 
@@ -36,6 +36,7 @@
 class QStandardItemModel;
 #include <QFlags>
 #include <QMap>
+#include <QSet>
 
 // qMRML includes
 #include "qMRMLSceneModel.h"
@@ -62,6 +63,10 @@ public:
 
   QModelIndexList indexes(const QString& nodeID)const;
 
+  /// Return true if the scene is being imported or batch processed and the
+  /// model is updated after the import or the batch processing is completed.
+  bool isUpdateDeferred()const;
+
   QStringList extraItems(QStandardItem* parent, const QString& extraType)const;
   void insertExtraItem(int row, QStandardItem* parent,
                        const QString& text, const QString& extraType,
@@ -81,6 +86,16 @@ public:
   qMRMLSceneModel::NodeTypes ListenNodeModifiedEvent;
   bool LazyUpdate;
   int PendingItemModified;
+  /// Number of suspendNodeItemUpdates() calls not matched by resumeNodeItemUpdates()
+  int NodeItemUpdatesSuspendCount;
+  /// IDs of the nodes modified while the node item updates are suspended
+  /// or deferred after scene import or batch processing
+  QSet<QString> PendingModifiedNodeIDs;
+  /// IDs of the nodes removed from the scene while the update is deferred
+  QStringList PendingRemovedNodeIDs;
+  /// Set if the model cannot be updated incrementally after the deferred
+  /// update (e.g. node IDs have changed)
+  bool PendingSceneRebuild;
 
   int NameColumn;
   int IDColumn;
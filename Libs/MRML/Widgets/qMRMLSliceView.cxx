@@ -35,6 +35,7 @@
 
 // qMRML includes
 #include "qMRMLColors.h"
+#include "qMRMLRenderScheduler.h"
 #include "qMRMLSliceView_p.h"
 #include "qMRMLUtils.h"
 
@@ -206,7 +207,7 @@ void qMRMLSliceViewPrivate::initDisplayableManagers()
       q->lightBoxRendererManager()->GetRenderer(0));
   // Observe displayable manager group to catch RequestRender events
   q->qvtkConnect(this->DisplayableManagerGroup, vtkCommand::UpdateEvent,
-                 q, SLOT(scheduleRender()));
+                 this, SLOT(scheduleRender()));
 
   // pass the lightbox manager proxy onto the display managers
   this->DisplayableManagerGroup->SetLightBoxRendererManagerProxy(this->LightBoxRendererManagerProxy);
@@ -249,6 +250,13 @@ void qMRMLSliceViewPrivate::onSceneEndProcessing()
   q->setRenderEnabled(true);
 }
 
+// --------------------------------------------------------------------------
+void qMRMLSliceViewPrivate::scheduleRender()
+{
+  Q_Q(qMRMLSliceView);
+  qMRMLRenderScheduler::instance()->scheduleRender(q);
+}
+
 // --------------------------------------------------------------------------
 void qMRMLSliceViewPrivate::updateWidgetFromMRML()
 {
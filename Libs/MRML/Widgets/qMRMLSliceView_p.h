@@ -74,6 +74,9 @@ public slots:
 
   void updateWidgetFromMRML();
 
+  /// Request render from the application-wide render scheduler
+  void scheduleRender();
+
 protected:
   void initDisplayableManagers();
 
@@ -31,6 +31,7 @@
 #include <vtkMRMLSliceViewInteractorStyle.h>
 
 // MRML includes
+#include <vtkMRMLSliceLogic.h>
 #include <vtkMRMLSliceNode.h>
 #include <vtkMRMLScene.h>
 
@@ -69,6 +70,48 @@ void qMRMLSliceWidgetPrivate::init()
           this, SLOT(setImageDataConnection(vtkAlgorithmOutput*)));
   connect(this->SliceController, SIGNAL(renderRequested()),
           this->SliceView, SLOT(scheduleRender()), Qt::QueuedConnection);
+
+  // Asynchronous reslice results are polled while reslicing is in progress
+  this->AsynchronousResliceTimer.setInterval(15);
+  connect(&this->AsynchronousResliceTimer, SIGNAL(timeout()),
+          this, SLOT(updateAsynchronousReslice()));
+  connect(this->SliceController, SIGNAL(renderRequested()),
+          this, SLOT(scheduleAsynchronousResliceUpdate()), Qt::QueuedConnection);
+}
+
+// --------------------------------------------------------------------------
+void qMRMLSliceWidgetPrivate::scheduleAsynchronousResliceUpdate()
+{
+  vtkMRMLSliceLogic* sliceLogic = this->SliceController->sliceLogic();
+  if (!sliceLogic || !sliceLogic->GetAsynchronousReslicing()
+    || this->AsynchronousResliceTimer.isActive())
+    {
+    return;
+    }
+  this->updateAsynchronousReslice();
+  if (sliceLogic->IsAsynchronousReslicePending())
+    {
+    this->AsynchronousResliceTimer.start();
+    }
+}
+
+// --------------------------------------------------------------------------
+void qMRMLSliceWidgetPrivate::updateAsynchronousReslice()
+{
+  vtkMRMLSliceLogic* sliceLogic = this->SliceController->sliceLogic();
+  if (!sliceLogic || !sliceLogic->GetAsynchronousReslicing())
+    {
+    this->AsynchronousResliceTimer.stop();
+    return;
+    }
+  if (sliceLogic->UpdateAsynchronousReslice())
+    {
+    this->SliceView->scheduleRender();
+    }
+  if (!sliceLogic->IsAsynchronousReslicePending())
+    {
+    this->AsynchronousResliceTimer.stop();
+    }
 }
 
 // --------------------------------------------------------------------------
@@ -257,6 +300,28 @@ vtkMRMLSliceLogic* qMRMLSliceWidget::sliceLogic()const
   return d->SliceController->sliceLogic();
 }
 
+// --------------------------------------------------------------------------
+bool qMRMLSliceWidget::asynchronousReslicing()const
+{
+  Q_D(const qMRMLSliceWidget);
+  vtkMRMLSliceLogic* sliceLogic = d->SliceController->sliceLogic();
+  return sliceLogic ? sliceLogic->GetAsynchronousReslicing() : false;
+}
+
+// --------------------------------------------------------------------------
+void qMRMLSliceWidget::setAsynchronousReslicing(bool asynchronous)
+{
+  Q_D(qMRMLSliceWidget);
+  vtkMRMLSliceLogic* sliceLogic = d->SliceController->sliceLogic();
+  if (!sliceLogic)
+    {
+    qWarning() << Q_FUNC_INFO << " failed: slice logic is not set";
+    return;
+    }
+  sliceLogic->SetAsynchronousReslicing(asynchronous);
+  d->scheduleAsynchronousResliceUpdate();
+}
+
 // --------------------------------------------------------------------------
 void qMRMLSliceWidget::fitSliceToBackground()
 {
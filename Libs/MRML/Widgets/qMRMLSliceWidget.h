@@ -53,6 +53,7 @@ class QMRML_WIDGETS_EXPORT qMRMLSliceWidget : public qMRMLWidget
   Q_PROPERTY(QString sliceViewName READ sliceViewName WRITE setSliceViewName)
   Q_PROPERTY(QString sliceViewLabel READ sliceViewLabel WRITE setSliceViewLabel)
   Q_PROPERTY(QColor sliceViewColor READ sliceViewColor WRITE setSliceViewColor)
+  Q_PROPERTY(bool asynchronousReslicing READ asynchronousReslicing WRITE setAsynchronousReslicing)
 
 public:
   /// Superclass typedef
@@ -107,6 +108,13 @@ public:
   /// \sa sliceViewColor()
   void setSliceViewColor(const QColor& newSliceViewColor);
 
+  /// Reslice volumes on worker threads, so that the application is not blocked
+  /// while large volumes are resliced. The view shows the previous slice image
+  /// until the new one is available.
+  /// \sa vtkMRMLSliceLogic::SetAsynchronousReslicing
+  bool asynchronousReslicing()const;
+  void setAsynchronousReslicing(bool asynchronous);
+
   /// Returns the interactor style of the view
   /// A const vtkInteractorObserver pointer is returned as you shouldn't
   /// mess too much with it. If you do, be aware that you are probably
@@ -40,6 +40,9 @@
 #include "qMRMLSliceWidget.h"
 #include "ui_qMRMLSliceWidget.h"
 
+// Qt includes
+#include <QTimer>
+
 // VTK include
 #include <vtkSmartPointer.h>
 
@@ -68,7 +71,13 @@ public slots:
   void endProcessing();
   /// Set the image data to the slice view
   void setImageDataConnection(vtkAlgorithmOutput * imageDataConnection);
+  /// Start polling asynchronous reslice results if reslicing is asynchronous
+  void scheduleAsynchronousResliceUpdate();
+  /// Publish asynchronous reslice results and render the view if they changed
+  void updateAsynchronousReslice();
 
+public:
+  QTimer AsynchronousResliceTimer;
 
 };
 
@@ -21,8 +21,7 @@
 ==============================================================================*/
 
 // Qt includes
-#include <QApplication>
-#include <QPalette>
+#include <QFont>
 
 // qMRML includes
 #include "qMRMLUtils.h"
@@ -32,12 +31,16 @@
 #include <vtkMRMLTableNode.h>
 
 // VTK includes
+#include <vtkBitArray.h>
 #include <vtkCallbackCommand.h>
+#include <vtkDataArray.h>
 #include <vtkSmartPointer.h>
 #include <vtkTable.h>
-#include <vtkBitArray.h>
 
-static int UserRoleValueType = Qt::UserRole + 1;
+// STD includes
+#include <algorithm>
+#include <string>
+#include <vector>
 
 //------------------------------------------------------------------------------
 // qMRMLTableModelPrivate
@@ -56,11 +59,34 @@ public:
   static QString columnNameFromIndex(int index);
 
   // Generate tooltip text
-  QString columnTooltipText(int tableCol);
+  QString columnTooltipText(int tableCol)const;
+
+  vtkTable* table()const;
+
+  // Number of model rows and columns for the current table and options
+  void modelSize(int& rowCount, int& columnCount)const;
+
+  // Table row index of a model row or column (if transposed), -1 for the column name row
+  int tableRowIndex(int modelRow)const;
+
+  // Cell text, as displayed in the view
+  static QString cellText(vtkAbstractArray* columnArray, vtkIdType tableRow);
+
+  // Recompute SortedTableRows from SortColumn and SortOrder
+  void updateSortedTableRows();
 
   vtkSmartPointer<vtkCallbackCommand> CallBack;
   vtkSmartPointer<vtkMRMLTableNode>   MRMLTableNode;
   bool Transposed;
+
+  int RowCount;
+  int ColumnCount;
+
+  // Table column the rows are sorted by, -1 if not sorted
+  int SortColumn;
+  Qt::SortOrder SortOrder;
+  // Table row index of each sorted row, empty if not sorted
+  std::vector<vtkIdType> SortedTableRows;
 };
 
 //------------------------------------------------------------------------------
@@ -69,6 +95,10 @@ qMRMLTableModelPrivate::qMRMLTableModelPrivate(qMRMLTableModel& object)
 {
   this->CallBack = vtkSmartPointer<vtkCallbackCommand>::New();
   this->Transposed = false;
+  this->RowCount = 0;
+  this->ColumnCount = 0;
+  this->SortColumn = -1;
+  this->SortOrder = Qt::AscendingOrder;
 }
 
 //------------------------------------------------------------------------------
@@ -86,8 +116,6 @@ void qMRMLTableModelPrivate::init()
   Q_Q(qMRMLTableModel);
   this->CallBack->SetClientData(q);
   this->CallBack->SetCallback(qMRMLTableModel::onMRMLNodeEvent);
-  q->setColumnCount(0);
-  QObject::connect(q, SIGNAL(itemChanged(QStandardItem*)), q, SLOT(onItemChanged(QStandardItem*)), Qt::UniqueConnection);
 }
 
 //------------------------------------------------------------------------------
@@ -104,9 +132,9 @@ QString qMRMLTableModelPrivate::columnNameFromIndex(int index)
 }
 
 //------------------------------------------------------------------------------
-QString qMRMLTableModelPrivate::columnTooltipText(int tableCol)
+QString qMRMLTableModelPrivate::columnTooltipText(int tableCol)const
 {
-  Q_Q(qMRMLTableModel);
+  Q_Q(const qMRMLTableModel);
   vtkMRMLTableNode* tableNode = q->mrmlTableNode();
   if (tableNode == nullptr)
     {
@@ -141,11 +169,118 @@ QString qMRMLTableModelPrivate::columnTooltipText(int tableCol)
   return textLines.join("<p>");
 }
 
+//------------------------------------------------------------------------------
+vtkTable* qMRMLTableModelPrivate::table()const
+{
+  return (this->MRMLTableNode ? this->MRMLTableNode->GetTable() : nullptr);
+}
+
+//------------------------------------------------------------------------------
+void qMRMLTableModelPrivate::modelSize(int& rowCount, int& columnCount)const
+{
+  rowCount = 0;
+  columnCount = 0;
+  vtkTable* table = this->table();
+  if (table==nullptr || table->GetNumberOfColumns()==0)
+    {
+    return;
+    }
+  // offset: modelIndex = mrmlIndex - offset
+  vtkIdType tableColOffset = this->MRMLTableNode->GetUseFirstColumnAsRowHeader() ? 1 : 0;
+  vtkIdType tableRowOffset = this->MRMLTableNode->GetUseColumnNameAsColumnHeader() ? 0 : -1;
+  vtkIdType numberOfTableColumns = table->GetNumberOfColumns();
+  vtkIdType numberOfTableRows = table->GetNumberOfRows();
+  if (this->Transposed)
+    {
+    rowCount = static_cast<int>(numberOfTableColumns-tableColOffset);
+    columnCount = static_cast<int>(numberOfTableRows-tableRowOffset);
+    }
+  else
+    {
+    rowCount = static_cast<int>(numberOfTableRows-tableRowOffset);
+    columnCount = static_cast<int>(numberOfTableColumns-tableColOffset);
+    }
+}
+
+//------------------------------------------------------------------------------
+int qMRMLTableModelPrivate::tableRowIndex(int modelRow)const
+{
+  int tableRow = this->MRMLTableNode->GetUseColumnNameAsColumnHeader() ? modelRow : modelRow-1;
+  if (tableRow >= 0 && tableRow < static_cast<int>(this->SortedTableRows.size()))
+    {
+    tableRow = static_cast<int>(this->SortedTableRows[tableRow]);
+    }
+  return tableRow;
+}
+
+//------------------------------------------------------------------------------
+QString qMRMLTableModelPrivate::cellText(vtkAbstractArray* columnArray, vtkIdType tableRow)
+{
+  vtkVariant variant = columnArray->GetVariantValue(tableRow);
+  int dataType = columnArray->GetDataType();
+  if (dataType == VTK_CHAR || dataType == VTK_UNSIGNED_CHAR || dataType == VTK_SIGNED_CHAR)
+    {
+    // vtkVariant converts char type to string as a single letter, therefore we need to use
+    // custom converter
+    return QString::number(variant.ToInt());
+    }
+  return QString(variant.ToString());
+}
+
+//------------------------------------------------------------------------------
+void qMRMLTableModelPrivate::updateSortedTableRows()
+{
+  this->SortedTableRows.clear();
+  vtkTable* table = this->table();
+  if (!table || this->SortColumn < 0 || this->SortColumn >= table->GetNumberOfColumns())
+    {
+    this->SortColumn = -1;
+    return;
+    }
+  vtkAbstractArray* columnArray = table->GetColumn(this->SortColumn);
+  vtkIdType numberOfTableRows = table->GetNumberOfRows();
+  if (!columnArray || columnArray->GetNumberOfTuples() < numberOfTableRows)
+    {
+    return;
+    }
+  this->SortedTableRows.resize(numberOfTableRows);
+  for (vtkIdType tableRow = 0; tableRow < numberOfTableRows; ++tableRow)
+    {
+    this->SortedTableRows[tableRow] = tableRow;
+    }
+  bool descending = (this->SortOrder == Qt::DescendingOrder);
+
+  // Values are extracted once from the column, comparisons only access the vector
+  vtkDataArray* dataArray = vtkDataArray::SafeDownCast(columnArray);
+  if (dataArray)
+    {
+    std::vector<double> values(numberOfTableRows);
+    for (vtkIdType tableRow = 0; tableRow < numberOfTableRows; ++tableRow)
+      {
+      values[tableRow] = dataArray->GetComponent(tableRow, 0);
+      }
+    std::stable_sort(this->SortedTableRows.begin(), this->SortedTableRows.end(),
+      [&values, descending](vtkIdType a, vtkIdType b)
+      { return descending ? values[b] < values[a] : values[a] < values[b]; });
+    }
+  else
+    {
+    std::vector<std::string> values(numberOfTableRows);
+    for (vtkIdType tableRow = 0; tableRow < numberOfTableRows; ++tableRow)
+      {
+      values[tableRow] = columnArray->GetVariantValue(tableRow).ToString();
+      }
+    std::stable_sort(this->SortedTableRows.begin(), this->SortedTableRows.end(),
+      [&values, descending](vtkIdType a, vtkIdType b)
+      { return descending ? values[b] < values[a] : values[a] < values[b]; });
+    }
+}
+
 //------------------------------------------------------------------------------
 // qMRMLTableModel
 //------------------------------------------------------------------------------
 qMRMLTableModel::qMRMLTableModel(QObject *_parent)
-  : QStandardItemModel(_parent)
+  : QAbstractTableModel(_parent)
   , d_ptr(new qMRMLTableModelPrivate(*this))
 {
   Q_D(qMRMLTableModel);
@@ -154,7 +289,7 @@ qMRMLTableModel::qMRMLTableModel(QObject *_parent)
 
 //------------------------------------------------------------------------------
 qMRMLTableModel::qMRMLTableModel(qMRMLTableModelPrivate* pimpl, QObject *parentObject)
-  : QStandardItemModel(parentObject)
+  : QAbstractTableModel(parentObject)
   , d_ptr(pimpl)
 {
   Q_D(qMRMLTableModel);
@@ -176,8 +311,12 @@ void qMRMLTableModel::setMRMLTableNode(vtkMRMLTableNode* tableNode)
     {
     tableNode->AddObserver(vtkCommand::ModifiedEvent, d->CallBack);
     }
+  this->beginResetModel();
   d->MRMLTableNode = tableNode;
-  this->updateModelFromMRML();
+  d->SortColumn = -1;
+  d->modelSize(d->RowCount, d->ColumnCount);
+  d->updateSortedTableRows();
+  this->endResetModel();
 }
 
 //------------------------------------------------------------------------------
@@ -191,344 +330,331 @@ vtkMRMLTableNode* qMRMLTableModel::mrmlTableNode()const
 void qMRMLTableModel::updateModelFromMRML()
 {
   Q_D(qMRMLTableModel);
-
-  QObject::disconnect(this, SIGNAL(itemChanged(QStandardItem*)), this, SLOT(onItemChanged(QStandardItem*)));
-
-  vtkMRMLTableNode* tableNode = vtkMRMLTableNode::SafeDownCast(d->MRMLTableNode);
-  vtkTable* table = (tableNode ? tableNode->GetTable() : nullptr);
-  if (table==nullptr || table->GetNumberOfColumns()==0)
+  int newRowCount = 0;
+  int newColumnCount = 0;
+  d->modelSize(newRowCount, newColumnCount);
+  if (newRowCount == d->RowCount && newColumnCount == d->ColumnCount)
     {
-    beginResetModel();
-    // setRowCount and setColumnCount to 0 would not be enough, it's necessary to remove the header as well
-    setRowCount(0);
-    setColumnCount(0);
-    endResetModel();
-    QObject::connect(this, SIGNAL(itemChanged(QStandardItem*)), this, SLOT(onItemChanged(QStandardItem*)), Qt::UniqueConnection);
+    // Cells are read from the table on request, it is enough to notify the views
+    d->updateSortedTableRows();
+    if (newRowCount > 0 && newColumnCount > 0)
+      {
+      emit dataChanged(this->index(0, 0), this->index(newRowCount - 1, newColumnCount - 1));
+      emit headerDataChanged(Qt::Horizontal, 0, d->Transposed ? newRowCount - 1 : newColumnCount - 1);
+      emit headerDataChanged(Qt::Vertical, 0, d->Transposed ? newColumnCount - 1 : newRowCount - 1);
+      }
     return;
     }
+  this->beginResetModel();
+  d->RowCount = newRowCount;
+  d->ColumnCount = newColumnCount;
+  d->updateSortedTableRows();
+  this->endResetModel();
+}
 
-  bool tableLocked = tableNode->GetLocked();
-  bool labelInFirstTableColumn = tableNode->GetUseFirstColumnAsRowHeader();
-  bool useColumnNameAsColumnHeader = tableNode->GetUseColumnNameAsColumnHeader();
+//------------------------------------------------------------------------------
+int qMRMLTableModel::rowCount(const QModelIndex& parent)const
+{
+  Q_D(const qMRMLTableModel);
+  return parent.isValid() ? 0 : d->RowCount;
+}
 
-  vtkIdType numberOfTableColumns = table->GetNumberOfColumns();
-  vtkIdType numberOfTableRows = table->GetNumberOfRows();
-  // offset: modelIndex = mrmlIndex - offset
-  vtkIdType tableColOffset = labelInFirstTableColumn ? 1 : 0;
-  vtkIdType tableRowOffset = useColumnNameAsColumnHeader ? 0 : -1;
-  if (d->Transposed)
+//------------------------------------------------------------------------------
+int qMRMLTableModel::columnCount(const QModelIndex& parent)const
+{
+  Q_D(const qMRMLTableModel);
+  return parent.isValid() ? 0 : d->ColumnCount;
+}
+
+//------------------------------------------------------------------------------
+QVariant qMRMLTableModel::data(const QModelIndex& index, int role)const
+{
+  Q_D(const qMRMLTableModel);
+  vtkTable* table = d->table();
+  if (!index.isValid() || table == nullptr)
     {
-    setRowCount(static_cast<int>(numberOfTableColumns-tableColOffset));
-    setColumnCount(static_cast<int>(numberOfTableRows-tableRowOffset));
+    return QVariant();
     }
-  else
+  int tableRow = this->mrmlTableRowIndex(index);
+  int tableCol = this->mrmlTableColumnIndex(index);
+  vtkAbstractArray* columnArray = table->GetColumn(tableCol);
+  if (columnArray == nullptr || tableRow >= columnArray->GetNumberOfTuples())
     {
-    setRowCount(static_cast<int>(numberOfTableRows-tableRowOffset));
-    setColumnCount(static_cast<int>(numberOfTableColumns-tableColOffset));
+    return QVariant();
     }
 
-  // Setup items for each table column
-  for (vtkIdType tableCol = tableColOffset; tableCol < numberOfTableColumns; ++tableCol)
+  if (role == Qt::ToolTipRole)
     {
-    int modelCol = static_cast<int>(tableCol - tableColOffset);
-
-    QString columnName(table->GetColumnName(tableCol));
-    vtkAbstractArray* columnArray = table->GetColumn(tableCol);
+    return d->columnTooltipText(tableCol);
+    }
 
-    if (useColumnNameAsColumnHeader)
+  if (tableRow < 0)
+    {
+    // Column names are displayed in the first row, in bold
+    if (role == Qt::DisplayRole || role == Qt::EditRole || role == qMRMLTableModel::SortRole)
       {
-      setHeaderData(modelCol, d->Transposed ? Qt::Vertical : Qt::Horizontal, columnName);
+      return QString(columnArray->GetName());
       }
-    else
+    if (role == Qt::FontRole)
       {
-      QString autoColumnHeader = d->columnNameFromIndex(modelCol);
-      setHeaderData(modelCol, d->Transposed ? Qt::Vertical : Qt::Horizontal, autoColumnHeader);
+      QFont font;
+      font.setBold(true);
+      return font;
       }
+    return QVariant();
+    }
 
-    // Go through the rows of the current column
-    for (vtkIdType tableRow = tableRowOffset; tableRow < numberOfTableRows; ++tableRow)
+  // Special types are defined to be displayed differently.
+  if (vtkBitArray::SafeDownCast(columnArray))
+    {
+    // Boolean values indicated by a column of vtkBitArray type are displayed as checkboxes,
+    // no text is displayed in the cell
+    int value = columnArray->GetVariantValue(tableRow).ToInt();
+    if (role == Qt::CheckStateRole)
       {
-      int modelRow = static_cast<int>(tableRow - tableRowOffset);
-
-      // Use existing item if already created
-      QStandardItem* existingItem = nullptr;
-      if (d->Transposed)
-        {
-        existingItem = this->item(modelCol, modelRow);
-        }
-      else
-        {
-        existingItem = this->item(modelRow, modelCol);
-        }
-      QStandardItem* item = existingItem;
-      // Create item if did not exist
-      if (item==nullptr)
-        {
-        item = new QStandardItem();
-        }
-
-      // Items in first row use bold font, the others regular
-      if (tableRow>=0)
-        {
-        vtkVariant variant = table->GetValue(tableRow, tableCol);
-        if (tableRow==0)
-          {
-          // the first row might have been bold earlier, make sure
-          // it is reset to non-bold
-          QFont font;
-          item->setData(font, Qt::FontRole);
-          }
-
-        int dataType = columnArray->GetDataType();
-
-        // Set item property for known types.
-        // Special types are defined to be displayed differently, handled by qMRMLTableItemDelegate.
-        // NOTE: The data type itself can be enough, but in future types it will be necessary to define display role
-        //       as well, e.g. double array can be both color and position.
-        if (vtkBitArray::SafeDownCast(columnArray))
-          {
-          // Boolean values indicated by a column of vtkBitArray type are displayed as checkboxes
-          item->setData(VTK_BIT, UserRoleValueType);
-          item->setCheckable(true);
-          item->setCheckState(variant.ToInt() ? Qt::Checked : Qt::Unchecked);
-          item->setText(QString()); // No text is supposed to be in the cell
-          }
-        // Default display as text
-        else
-          {
-          if (dataType == VTK_CHAR || dataType == VTK_UNSIGNED_CHAR || dataType == VTK_SIGNED_CHAR)
-            {
-            // vtkVariant converts char type to string as a single letter, therefore we need to use
-            // custom converter
-            item->setText(QString::number(variant.ToInt()));
-            }
-          else
-            {
-            item->setText(QString(variant.ToString()));
-            }
-          item->setData(QVariant(), UserRoleValueType);
-          item->setCheckable(false);
-          item->setData(QVariant(), Qt::CheckStateRole);
-          }
-        }
-      else
-        {
-        item->setText(columnName);
-        QFont font;
-        font.setBold(true);
-        item->setData(font, Qt::FontRole);
-        }
-
-      // Handle locked flag
-      if (item->isCheckable())
-        {
-        if (tableLocked)
-          {
-          // Item is view-only, clear the ItemIsUserCheckable flag
-          item->setFlags(item->flags() & (~Qt::ItemIsUserCheckable));
-          }
-        else
-          {
-          // Item is editable, set the ItemIsUserCheckable flag
-          item->setFlags(item->flags() | Qt::ItemIsUserCheckable);
-          }
-        // Item text is empty and should not be editable
-        item->setFlags(item->flags() & (~Qt::ItemIsEditable));
-        }
-      else
-        {
-        if (tableLocked)
-          {
-          // Item is view-only, clear the ItemIsEditable flag
-          item->setFlags(item->flags() & (~Qt::ItemIsEditable));
-          }
-        else
-          {
-          // Item is editable, set the ItemIsEditable flag
-          item->setFlags(item->flags() | Qt::ItemIsEditable);
-          }
-        }
-
-      // Add item if just created
-      if (item!=existingItem)
-        {
-        if (d->Transposed)
-          {
-          setItem(modelCol, modelRow, item);
-          }
-        else
-          {
-          setItem(modelRow, modelCol, item);
-          }
-        }
+      return static_cast<int>(value ? Qt::Checked : Qt::Unchecked);
       }
+    if (role == qMRMLTableModel::SortRole)
+      {
+      return value;
+      }
+    return QVariant();
+    }
+
+  // Default display as text
+  if (role == Qt::DisplayRole || role == Qt::EditRole)
+    {
+    return qMRMLTableModelPrivate::cellText(columnArray, tableRow);
     }
-  // Set row label: either simply 1, 2, ... or values of the first column
-  for (vtkIdType tableRow = tableRowOffset; tableRow < numberOfTableRows; ++tableRow)
+  if (role == qMRMLTableModel::SortRole)
     {
-    int modelRow = static_cast<int>(tableRow - tableRowOffset);
-    QString rowLabel;
-    if(labelInFirstTableColumn)
+    vtkDataArray* dataArray = vtkDataArray::SafeDownCast(columnArray);
+    if (dataArray)
       {
-      if (tableRow>=0)
-        {
-        rowLabel = QString(table->GetValue(tableRow, 0).ToString());
-        }
-      else
-        {
-        rowLabel = QString(table->GetColumnName(0));;
-        }
+      return dataArray->GetComponent(tableRow, 0);
       }
-    else
+    return qMRMLTableModelPrivate::cellText(columnArray, tableRow);
+    }
+  return QVariant();
+}
+
+//------------------------------------------------------------------------------
+QVariant qMRMLTableModel::headerData(int section, Qt::Orientation orientation, int role)const
+{
+  Q_D(const qMRMLTableModel);
+  vtkTable* table = d->table();
+  if (role != Qt::DisplayRole || table == nullptr || table->GetNumberOfColumns() == 0)
+    {
+    return this->Superclass::headerData(section, orientation, role);
+    }
+
+  Qt::Orientation columnOrientation = d->Transposed ? Qt::Vertical : Qt::Horizontal;
+  if (orientation == columnOrientation)
+    {
+    if (!d->MRMLTableNode->GetUseColumnNameAsColumnHeader())
       {
-      rowLabel = QString::number(modelRow+1);
+      return qMRMLTableModelPrivate::columnNameFromIndex(section);
       }
-    setHeaderData(modelRow, d->Transposed ? Qt::Horizontal : Qt::Vertical, rowLabel);
+    int tableCol = d->MRMLTableNode->GetUseFirstColumnAsRowHeader() ? section + 1 : section;
+    return QString(table->GetColumnName(tableCol));
     }
 
-  // Add tooltip text
-  for (vtkIdType tableCol = tableColOffset; tableCol < numberOfTableColumns; ++tableCol)
+  // Row label: either simply 1, 2, ... or values of the first column
+  int tableRow = d->tableRowIndex(section);
+  if (d->MRMLTableNode->GetUseFirstColumnAsRowHeader())
     {
-    int modelCol = static_cast<int>(tableCol - tableColOffset);
-    QString tooltipText = d->columnTooltipText(tableCol);
-    for (vtkIdType tableRow = tableRowOffset; tableRow < numberOfTableRows; ++tableRow)
+    if (tableRow < 0)
       {
-      int modelRow = static_cast<int>(tableRow - tableRowOffset);
-      QStandardItem* existingItem = nullptr;
-      if (d->Transposed)
-        {
-        existingItem = this->item(modelCol, modelRow);
-        }
-      else
-        {
-        existingItem = this->item(modelRow, modelCol);
-        }
-      existingItem->setToolTip(tooltipText);
+      return QString(table->GetColumnName(0));
       }
+    return QString(table->GetValue(tableRow, 0).ToString());
     }
+  // row number in the original order (it remains the same when the rows are sorted)
+  int tableRowOffset = d->MRMLTableNode->GetUseColumnNameAsColumnHeader() ? 0 : -1;
+  return QString::number(tableRow - tableRowOffset + 1);
+}
 
-  QObject::connect(this, SIGNAL(itemChanged(QStandardItem*)), this, SLOT(onItemChanged(QStandardItem*)), Qt::UniqueConnection);
+//------------------------------------------------------------------------------
+Qt::ItemFlags qMRMLTableModel::flags(const QModelIndex& index)const
+{
+  Q_D(const qMRMLTableModel);
+  vtkTable* table = d->table();
+  if (!index.isValid() || table == nullptr)
+    {
+    return Qt::NoItemFlags;
+    }
+  Qt::ItemFlags itemFlags = Qt::ItemIsEnabled | Qt::ItemIsSelectable;
+  if (d->MRMLTableNode->GetLocked())
+    {
+    // Item is view-only
+    return itemFlags;
+    }
+  int tableRow = this->mrmlTableRowIndex(index);
+  int tableCol = this->mrmlTableColumnIndex(index);
+  if (tableRow >= 0 && vtkBitArray::SafeDownCast(table->GetColumn(tableCol)))
+    {
+    // Item text is empty and should not be editable
+    return itemFlags | Qt::ItemIsUserCheckable;
+    }
+  return itemFlags | Qt::ItemIsEditable;
 }
 
 //------------------------------------------------------------------------------
-void qMRMLTableModel::updateMRMLFromModel(QStandardItem* item)
+bool qMRMLTableModel::setData(const QModelIndex& index, const QVariant& value, int role)
 {
   Q_D(qMRMLTableModel);
-  if (item == nullptr)
+  if (!index.isValid())
     {
-    qCritical("qMRMLTableModel::updateMRMLFromModel failed: item is invalid");
-    return;
+    qCritical("qMRMLTableModel::setData failed: index is invalid");
+    return false;
     }
   vtkMRMLTableNode* tableNode = vtkMRMLTableNode::SafeDownCast(d->MRMLTableNode);
   if (tableNode==nullptr)
     {
-    qCritical("qMRMLTableModel::updateMRMLFromModel failed: tableNode is invalid");
-    return;
+    qCritical("qMRMLTableModel::setData failed: tableNode is invalid");
+    return false;
     }
   vtkTable* table = tableNode->GetTable();
   if (table==nullptr)
     {
-    qCritical("qMRMLTableModel::updateMRMLFromModel failed: table is invalid");
-    return;
+    qCritical("qMRMLTableModel::setData failed: table is invalid");
+    return false;
     }
 
-  int tableRow = mrmlTableRowIndex(item->index());
-  int tableCol = mrmlTableColumnIndex(item->index());
+  int tableRow = mrmlTableRowIndex(index);
+  int tableCol = mrmlTableColumnIndex(index);
+  vtkAbstractArray* column = table->GetColumn(tableCol);
+  if (column == nullptr)
+    {
+    return false;
+    }
 
-  if (tableRow>=0)
+  if (tableRow < 0)
     {
-    // Get item value according to type
-    int widgetType = item->data(UserRoleValueType).toInt();
-    if (widgetType == VTK_BIT)
+    // Column header changed
+    if (role != Qt::EditRole)
       {
-      // Cell bool value changed
-      int checked = item->checkState();
-      int valueBefore = table->GetValue(tableRow, tableCol).ToInt();
-      if (checked == valueBefore)
-        {
-        // The value is not changed, this means that the table cannot store this value - revert the value in the table
-        this->blockSignals(true);
-        item->setCheckState(valueBefore ? Qt::Checked : Qt::Unchecked);
-        item->setText(QString()); // No text is supposed to be in the cell
-        this->blockSignals(false);
-        }
-      else
+      return false;
+      }
+    QString valueBefore = QString::fromStdString(column->GetName()?column->GetName():"");
+    if (valueBefore!=value.toString())
+      {
+      tableNode->RenameColumn(tableCol, value.toString().toUtf8().constData());
+      }
+    return true;
+    }
+
+  if (vtkBitArray::SafeDownCast(column))
+    {
+    // Cell bool value changed
+    if (role != Qt::CheckStateRole)
+      {
+      return false;
+      }
+    int checked = (value.toInt() == Qt::Checked) ? 1 : 0;
+    int valueBefore = table->GetValue(tableRow, tableCol).ToInt();
+    if (checked == valueBefore)
+      {
+      return false;
+      }
+    table->SetValue(tableRow, tableCol, vtkVariant(checked));
+    column->Modified(); // Enable observation of checked state changed separately
+    emit dataChanged(index, index);
+    table->Modified();
+    return true;
+    }
+
+  // Cell text value changed
+  if (role != Qt::EditRole)
+    {
+    return false;
+    }
+  QString text = value.toString();
+  int dataType = column->GetDataType();
+  if (dataType == VTK_CHAR || dataType == VTK_UNSIGNED_CHAR || dataType == VTK_SIGNED_CHAR)
+    {
+    // vtkVariant would convert char to a letter, so we need custom conversion here
+    bool valid = false;
+    int newValue = text.toInt(&valid);
+    if (dataType == VTK_UNSIGNED_CHAR)
+      {
+      if (newValue < VTK_UNSIGNED_CHAR_MIN || newValue > VTK_UNSIGNED_CHAR_MAX)
         {
-        table->SetValue(tableRow, tableCol, vtkVariant(checked));
-        table->GetColumn(tableCol)->Modified(); // Enable observation of checked state changed separately
-        table->Modified();
+        valid = false;
         }
       }
     else
       {
-      // Cell text value changed
-      int dataType = table->GetColumn(tableCol)->GetDataType();
-      if (dataType == VTK_CHAR || dataType == VTK_UNSIGNED_CHAR || dataType == VTK_SIGNED_CHAR)
-        {
-        // vtkVariant would convert char to a letter, so we need custom conversion here
-        bool valid = false;
-        int newValue = item->text().toInt(&valid);
-        if (dataType == VTK_UNSIGNED_CHAR)
-          {
-          if (newValue < VTK_UNSIGNED_CHAR_MIN || newValue > VTK_UNSIGNED_CHAR_MAX)
-            {
-            valid = false;
-            }
-          }
-        else
-          {
-          if (newValue < VTK_SIGNED_CHAR_MIN || newValue > VTK_SIGNED_CHAR_MAX)
-            {
-            valid = false;
-            }
-          }
-        if (valid)
-          {
-          table->SetValue(tableRow, tableCol, newValue);
-          table->Modified();
-          }
-        else
-          {
-          vtkVariant valueInTableBefore = table->GetValue(tableRow, tableCol); // restore this value if new value is invalid
-          this->blockSignals(true);
-          item->setText(QString::number(valueInTableBefore.ToInt()));
-          this->blockSignals(false);
-          }
-        }
-      else
+      if (newValue < VTK_SIGNED_CHAR_MIN || newValue > VTK_SIGNED_CHAR_MAX)
         {
-        vtkVariant valueInTableBefore = table->GetValue(tableRow, tableCol); // restore this value if new value is invalid
-        vtkVariant itemText(item->text().toUtf8().constData()); // the vtkVariant constructor makes a copy of the input buffer, so using constData is safe
-        table->SetValue(tableRow, tableCol, itemText);
-        vtkVariant valueInTableAfter = table->GetValue(tableRow, tableCol);
-        if (valueInTableBefore == valueInTableAfter)
-          {
-          // The value is not changed then it means it is invalid,
-          // restore previous value
-          this->blockSignals(true);
-          item->setText(QString(valueInTableBefore.ToString()));
-          this->blockSignals(false);
-          }
-        else
-          {
-          table->Modified();
-          }
+        valid = false;
         }
       }
+    if (!valid)
+      {
+      return false;
+      }
+    table->SetValue(tableRow, tableCol, newValue);
     }
   else
     {
-    // Column header changed
-    vtkAbstractArray* column = table->GetColumn(tableCol);
-    if (column)
+    vtkVariant valueInTableBefore = table->GetValue(tableRow, tableCol);
+    vtkVariant itemText(text.toUtf8().constData()); // the vtkVariant constructor makes a copy of the input buffer, so using constData is safe
+    table->SetValue(tableRow, tableCol, itemText);
+    vtkVariant valueInTableAfter = table->GetValue(tableRow, tableCol);
+    if (valueInTableBefore == valueInTableAfter)
       {
-      QString valueBefore = QString::fromStdString(column->GetName()?column->GetName():"");
-      if (valueBefore!=item->text())
-        {
-        tableNode->RenameColumn(tableCol, item->text().toUtf8().constData());
-        }
+      // The value is not changed then it means it is invalid,
+      // the view keeps displaying the value of the table
+      return false;
       }
     }
+  emit dataChanged(index, index);
+  table->Modified();
+  return true;
+}
+
+//------------------------------------------------------------------------------
+void qMRMLTableModel::sort(int column, Qt::SortOrder order)
+{
+  Q_D(qMRMLTableModel);
+  if (d->Transposed || d->table() == nullptr)
+    {
+    return;
+    }
+  int tableColOffset = d->MRMLTableNode->GetUseFirstColumnAsRowHeader() ? 1 : 0;
+  int tableRowOffset = d->MRMLTableNode->GetUseColumnNameAsColumnHeader() ? 0 : -1;
+
+  emit layoutAboutToBeChanged();
+  QModelIndexList oldIndexes = this->persistentIndexList();
+  QVector<int> oldTableRows;
+  foreach (const QModelIndex& oldIndex, oldIndexes)
+    {
+    oldTableRows << this->mrmlTableRowIndex(oldIndex);
+    }
+
+  d->SortColumn = (column >= 0 ? column + tableColOffset : -1);
+  d->SortOrder = order;
+  d->updateSortedTableRows();
+
+  // Move the persistent indexes (selection, current index) with their rows
+  std::vector<int> sortedRowIndices(d->SortedTableRows.size());
+  for (size_t sortedRow = 0; sortedRow < d->SortedTableRows.size(); ++sortedRow)
+    {
+    sortedRowIndices[d->SortedTableRows[sortedRow]] = static_cast<int>(sortedRow);
+    }
+  QModelIndexList newIndexes;
+  for (int i = 0; i < oldIndexes.size(); ++i)
+    {
+    int tableRow = oldTableRows[i];
+    if (tableRow >= 0 && tableRow < static_cast<int>(sortedRowIndices.size()))
+      {
+      tableRow = sortedRowIndices[tableRow];
+      }
+    newIndexes << this->index(tableRow - tableRowOffset, oldIndexes[i].column());
+    }
+  this->changePersistentIndexList(oldIndexes, newIndexes);
+  emit layoutChanged();
 }
 
 //-----------------------------------------------------------------------------
@@ -559,16 +685,6 @@ void qMRMLTableModel::onMRMLTableNodeModified(vtkObject* node)
   this->updateModelFromMRML();
 }
 
-//------------------------------------------------------------------------------
-void qMRMLTableModel::onItemChanged(QStandardItem * item)
-{
-  if (item == this->invisibleRootItem())
-    {
-    return;
-    }
-  this->updateMRMLFromModel(item);
-}
-
 //------------------------------------------------------------------------------
 void qMRMLTableModel::setTransposed(bool transposed)
 {
@@ -577,8 +693,10 @@ void qMRMLTableModel::setTransposed(bool transposed)
     {
     return;
     }
+  this->beginResetModel();
   d->Transposed = transposed;
-  this->updateModelFromMRML();
+  d->modelSize(d->RowCount, d->ColumnCount);
+  this->endResetModel();
 }
 
 //------------------------------------------------------------------------------
@@ -597,14 +715,7 @@ int qMRMLTableModel::mrmlTableRowIndex(QModelIndex modelIndex)const
     qWarning("qMRMLTableModel::mrmlTableRowIndex failed: invalid table node");
     return -1;
     }
-  if (d->Transposed)
-    {
-    return d->MRMLTableNode->GetUseColumnNameAsColumnHeader() ? modelIndex.column() : modelIndex.column()-1;
-    }
-  else
-    {
-    return d->MRMLTableNode->GetUseColumnNameAsColumnHeader() ? modelIndex.row() : modelIndex.row()-1;
-    }
+  return d->tableRowIndex(d->Transposed ? modelIndex.column() : modelIndex.row());
 }
 
 //------------------------------------------------------------------------------
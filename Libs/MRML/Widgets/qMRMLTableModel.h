@@ -24,7 +24,7 @@
 #define __qMRMLTableModel_h
 
 // Qt includes
-#include <QStandardItemModel>
+#include <QAbstractTableModel>
 
 // CTK includes
 #include <ctkPimpl.h>
@@ -40,7 +40,11 @@ class QAction;
 class qMRMLTableModelPrivate;
 
 //------------------------------------------------------------------------------
-class QMRML_WIDGETS_EXPORT qMRMLTableModel : public QStandardItemModel
+/// \brief Item model of the table of a table node.
+/// Cell values are read from the vtkTable columns when the view requests
+/// them, no items are created for the cells. Sorting is done by reordering
+/// the rows through a permutation of the table row indices.
+class QMRML_WIDGETS_EXPORT qMRMLTableModel : public QAbstractTableModel
 {
   Q_OBJECT
   QVTK_OBJECT
@@ -48,11 +52,12 @@ class QMRML_WIDGETS_EXPORT qMRMLTableModel : public QStandardItemModel
   Q_PROPERTY(bool transposed READ transposed WRITE setTransposed)
 
 public:
-  typedef QAbstractItemModel Superclass;
+  typedef QAbstractTableModel Superclass;
   qMRMLTableModel(QObject *parent=nullptr);
   ~qMRMLTableModel() override;
 
   enum ItemDataRole{
+    /// Value of the cell with the type of the table column (number or string)
     SortRole = Qt::UserRole + 1
   };
 
@@ -64,8 +69,20 @@ public:
   void setTransposed(bool transposed);
   bool transposed()const;
 
-  /// Return the VTK table cell associated to the node index.
-  void updateMRMLFromModel(QStandardItem* item);
+  int rowCount(const QModelIndex& parent = QModelIndex())const override;
+  int columnCount(const QModelIndex& parent = QModelIndex())const override;
+  QVariant data(const QModelIndex& index, int role = Qt::DisplayRole)const override;
+  QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole)const override;
+  Qt::ItemFlags flags(const QModelIndex& index)const override;
+
+  /// Set the value of the VTK table cell associated to the model index.
+  /// Text is set with Qt::EditRole, checked state of boolean values with Qt::CheckStateRole.
+  /// Returns false if the table cannot store the value.
+  bool setData(const QModelIndex& index, const QVariant& value, int role = Qt::EditRole) override;
+
+  /// Sort the rows by the values of the column. Column -1 restores the original order.
+  /// Sorting is only available if the table is not transposed.
+  void sort(int column, Qt::SortOrder order = Qt::AscendingOrder) override;
 
   /// Update the entire table from the MRML node
   void updateModelFromMRML();
@@ -84,7 +101,6 @@ public:
 
 protected slots:
   void onMRMLTableNodeModified(vtkObject* node);
-  void onItemChanged(QStandardItem * item);
 
 protected:
 
@@ -32,6 +32,7 @@
 
 // qMRML includes
 #include "qMRMLColors.h"
+#include "qMRMLRenderScheduler.h"
 #include "qMRMLThreeDView_p.h"
 #include "qMRMLUtils.h"
 
@@ -136,7 +137,7 @@ void qMRMLThreeDViewPrivate::initDisplayableManagers()
     = factory->InstantiateDisplayableManagers(q->renderer());
   // Observe displayable manager group to catch RequestRender events
   this->qvtkConnect(this->DisplayableManagerGroup, vtkCommand::UpdateEvent,
-                    q, SLOT(scheduleRender()));
+                    this, SLOT(scheduleRender()));
 }
 
 //---------------------------------------------------------------------------
@@ -202,6 +203,13 @@ void qMRMLThreeDViewPrivate::onSceneEndProcessing()
   q->setRenderEnabled(true);
 }
 
+// --------------------------------------------------------------------------
+void qMRMLThreeDViewPrivate::scheduleRender()
+{
+  Q_Q(qMRMLThreeDView);
+  qMRMLRenderScheduler::instance()->scheduleRender(q);
+}
+
 // --------------------------------------------------------------------------
 void qMRMLThreeDViewPrivate::updateWidgetFromMRML()
 {
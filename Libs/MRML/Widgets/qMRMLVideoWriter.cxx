@@ -0,0 +1,407 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// Qt includes
+#include <QDebug>
+#include <QProcess>
+
+// qMRML includes
+#include "qMRMLVideoWriter.h"
+
+// VTK includes
+#include <vtkImageData.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkRenderWindow.h>
+#include <vtkUnsignedCharArray.h>
+
+// STD includes
+#include <algorithm>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace
+{
+/// Only the end of the encoder output is kept, it contains the error messages
+const int MAXIMUM_ERROR_OUTPUT_LENGTH = 10000;
+}
+
+//------------------------------------------------------------------------------
+class qMRMLVideoWriterPrivate
+{
+public:
+  typedef std::vector<unsigned char> FrameBuffer;
+
+  /// Start the encoder for frames of the given size (rounded down to even values).
+  bool startEncoder(int width, int height);
+  /// Convert bottom-up pixels (as stored in VTK) with 1, 3 or 4 components
+  /// into a top-down RGB frame and queue it for the encoder.
+  bool queueFrame(const unsigned char* pixels, int width, int height, int numberOfComponents);
+  /// Run by the worker thread: write the queued frames into the encoder process.
+  void encode(QString program, QStringList arguments);
+  void appendErrorOutput(const QString& output);
+  bool hasFailed();
+
+  QString FFmpegPath;
+  double FrameRate{25.0};
+  QString OutputFileName;
+  QStringList ExtraOptions;
+  int MaximumNumberOfQueuedFrames{4};
+
+  bool Encoding{false};
+  int Width{0};
+  int Height{0};
+  int NumberOfFrames{0};
+
+  std::thread Worker;
+  /// Protects all the members below
+  std::mutex Mutex;
+  std::condition_variable QueueChanged;
+  std::deque<FrameBuffer> QueuedFrames;
+  /// Buffers of encoded frames, reused for the next frames to avoid reallocation
+  std::vector<FrameBuffer> UnusedFrames;
+  bool InputComplete{false};
+  bool Failed{false};
+  QString ErrorOutput;
+
+  /// Reused for reading back the render window
+  vtkNew<vtkUnsignedCharArray> PixelData;
+};
+
+//------------------------------------------------------------------------------
+bool qMRMLVideoWriterPrivate::startEncoder(int width, int height)
+{
+  this->Width = width - (width % 2);
+  this->Height = height - (height % 2);
+  if (this->Width <= 0 || this->Height <= 0)
+    {
+    this->appendErrorOutput(QString("Invalid frame size: %1x%2\n").arg(width).arg(height));
+    return false;
+    }
+  if (this->FFmpegPath.isEmpty() || this->OutputFileName.isEmpty())
+    {
+    this->appendErrorOutput("ffmpeg path or output file name is not set\n");
+    return false;
+    }
+  QStringList arguments;
+  arguments << "-y"
+    << "-f" << "rawvideo" << "-pix_fmt" << "rgb24"
+    << "-s" << QString("%1x%2").arg(this->Width).arg(this->Height)
+    << "-r" << QString::number(this->FrameRate)
+    // frames are read from the standard input
+    << "-i" << "-";
+  arguments << this->ExtraOptions;
+  arguments << this->OutputFileName;
+
+  this->NumberOfFrames = 0;
+  this->QueuedFrames.clear();
+  this->InputComplete = false;
+  this->Failed = false;
+  this->ErrorOutput.clear();
+  this->Encoding = true;
+  this->Worker = std::thread(&qMRMLVideoWriterPrivate::encode, this, this->FFmpegPath, arguments);
+  return true;
+}
+
+//------------------------------------------------------------------------------
+bool qMRMLVideoWriterPrivate::queueFrame(const unsigned char* pixels, int width, int height, int numberOfComponents)
+{
+  if (!this->Encoding && !this->startEncoder(width, height))
+    {
+    return false;
+    }
+  if (width < this->Width || height < this->Height)
+    {
+    this->appendErrorOutput(QString("Frame size %1x%2 is smaller than video size %3x%4\n")
+      .arg(width).arg(height).arg(this->Width).arg(this->Height));
+    return false;
+    }
+  FrameBuffer frame;
+  {
+    // wait for the encoder if too many frames are waiting already
+    std::unique_lock<std::mutex> lock(this->Mutex);
+    this->QueueChanged.wait(lock, [this] {
+      return this->Failed || static_cast<int>(this->QueuedFrames.size()) < this->MaximumNumberOfQueuedFrames; });
+    if (this->Failed)
+      {
+      return false;
+      }
+    if (!this->UnusedFrames.empty())
+      {
+      frame.swap(this->UnusedFrames.back());
+      this->UnusedFrames.pop_back();
+      }
+  }
+  frame.resize(static_cast<size_t>(this->Width) * this->Height * 3);
+  // VTK images are stored bottom row first, video frames top row first
+  for (int row = 0; row < this->Height; ++row)
+    {
+    const unsigned char* source = pixels + static_cast<size_t>(this->Height - 1 - row) * width * numberOfComponents;
+    unsigned char* destination = frame.data() + static_cast<size_t>(row) * this->Width * 3;
+    if (numberOfComponents == 3)
+      {
+      memcpy(destination, source, static_cast<size_t>(this->Width) * 3);
+      continue;
+      }
+    for (int column = 0; column < this->Width; ++column, source += numberOfComponents, destination += 3)
+      {
+      destination[0] = source[0];
+      destination[1] = source[numberOfComponents >= 3 ? 1 : 0];
+      destination[2] = source[numberOfComponents >= 3 ? 2 : 0];
+      }
+    }
+  {
+    std::lock_guard<std::mutex> lock(this->Mutex);
+    this->QueuedFrames.push_back(std::move(frame));
+  }
+  this->QueueChanged.notify_all();
+  ++this->NumberOfFrames;
+  return true;
+}
+
+//------------------------------------------------------------------------------
+void qMRMLVideoWriterPrivate::encode(QString program, QStringList arguments)
+{
+  QProcess process;
+  process.setStandardOutputFile(QProcess::nullDevice());
+  process.start(program, arguments);
+  bool success = process.waitForStarted();
+  if (!success)
+    {
+    this->appendErrorOutput(QString("Failed to start %1: %2\n").arg(program).arg(process.errorString()));
+    }
+  while (success)
+    {
+    FrameBuffer frame;
+    {
+      std::unique_lock<std::mutex> lock(this->Mutex);
+      this->QueueChanged.wait(lock, [this] { return this->InputComplete || !this->QueuedFrames.empty(); });
+      if (this->QueuedFrames.empty())
+        {
+        break;
+        }
+      frame.swap(this->QueuedFrames.front());
+      this->QueuedFrames.pop_front();
+    }
+    // the frame is freed from the queue, capture of the next frame can start
+    this->QueueChanged.notify_all();
+
+    const char* data = reinterpret_cast<const char*>(frame.data());
+    qint64 remainingSize = static_cast<qint64>(frame.size());
+    while (success && remainingSize > 0)
+      {
+      qint64 writtenSize = process.write(data, remainingSize);
+      success = (writtenSize >= 0);
+      data += writtenSize;
+      remainingSize -= writtenSize;
+      }
+    while (success && process.bytesToWrite() > 0)
+      {
+      success = process.waitForBytesWritten(-1);
+      }
+    // keep the pipe of the error output from filling up
+    this->appendErrorOutput(QString::fromLocal8Bit(process.readAllStandardError()));
+    if (!success)
+      {
+      this->appendErrorOutput(QString("Failed to write frame to encoder: %1\n").arg(process.errorString()));
+      }
+    std::lock_guard<std::mutex> lock(this->Mutex);
+    this->UnusedFrames.push_back(std::move(frame));
+    }
+
+  if (process.state() != QProcess::NotRunning)
+    {
+    process.closeWriteChannel();
+    process.waitForFinished(-1);
+    this->appendErrorOutput(QString::fromLocal8Bit(process.readAllStandardError()));
+    if (process.exitStatus() != QProcess::NormalExit || process.exitCode() != 0)
+      {
+      this->appendErrorOutput(QString("Encoder exited with code %1\n").arg(process.exitCode()));
+      success = false;
+      }
+    }
+  {
+    std::lock_guard<std::mutex> lock(this->Mutex);
+    this->Failed = !success;
+    this->QueuedFrames.clear();
+  }
+  this->QueueChanged.notify_all();
+}
+
+//------------------------------------------------------------------------------
+void qMRMLVideoWriterPrivate::appendErrorOutput(const QString& output)
+{
+  if (output.isEmpty())
+    {
+    return;
+    }
+  std::lock_guard<std::mutex> lock(this->Mutex);
+  this->ErrorOutput += output;
+  if (this->ErrorOutput.size() > MAXIMUM_ERROR_OUTPUT_LENGTH)
+    {
+    this->ErrorOutput = this->ErrorOutput.right(MAXIMUM_ERROR_OUTPUT_LENGTH);
+    }
+}
+
+//------------------------------------------------------------------------------
+bool qMRMLVideoWriterPrivate::hasFailed()
+{
+  std::lock_guard<std::mutex> lock(this->Mutex);
+  return this->Failed;
+}
+
+//------------------------------------------------------------------------------
+qMRMLVideoWriter::qMRMLVideoWriter(QObject* _parent)
+  : Superclass(_parent)
+  , d_ptr(new qMRMLVideoWriterPrivate)
+{
+}
+
+//------------------------------------------------------------------------------
+qMRMLVideoWriter::~qMRMLVideoWriter()
+{
+  // the worker thread must not outlive the queue
+  this->finish();
+}
+
+//------------------------------------------------------------------------------
+CTK_GET_CPP(qMRMLVideoWriter, QString, ffmpegPath, FFmpegPath);
+CTK_GET_CPP(qMRMLVideoWriter, double, frameRate, FrameRate);
+CTK_GET_CPP(qMRMLVideoWriter, QString, outputFileName, OutputFileName);
+CTK_GET_CPP(qMRMLVideoWriter, QStringList, extraOptions, ExtraOptions);
+CTK_GET_CPP(qMRMLVideoWriter, int, maximumNumberOfQueuedFrames, MaximumNumberOfQueuedFrames);
+CTK_GET_CPP(qMRMLVideoWriter, int, numberOfFrames, NumberOfFrames);
+CTK_GET_CPP(qMRMLVideoWriter, bool, isEncoding, Encoding);
+
+//------------------------------------------------------------------------------
+void qMRMLVideoWriter::setFFmpegPath(const QString& path)
+{
+  Q_D(qMRMLVideoWriter);
+  if (d->Encoding)
+    {
+    qWarning() << Q_FUNC_INFO << "failed: ffmpeg path cannot be changed while encoding";
+    return;
+    }
+  d->FFmpegPath = path;
+}
+
+//------------------------------------------------------------------------------
+void qMRMLVideoWriter::setFrameRate(double framesPerSecond)
+{
+  Q_D(qMRMLVideoWriter);
+  if (d->Encoding)
+    {
+    qWarning() << Q_FUNC_INFO << "failed: frame rate cannot be changed while encoding";
+    return;
+    }
+  d->FrameRate = framesPerSecond;
+}
+
+//------------------------------------------------------------------------------
+void qMRMLVideoWriter::setOutputFileName(const QString& fileName)
+{
+  Q_D(qMRMLVideoWriter);
+  if (d->Encoding)
+    {
+    qWarning() << Q_FUNC_INFO << "failed: output file name cannot be changed while encoding";
+    return;
+    }
+  d->OutputFileName = fileName;
+}
+
+//------------------------------------------------------------------------------
+void qMRMLVideoWriter::setExtraOptions(const QStringList& options)
+{
+  Q_D(qMRMLVideoWriter);
+  if (d->Encoding)
+    {
+    qWarning() << Q_FUNC_INFO << "failed: options cannot be changed while encoding";
+    return;
+    }
+  d->ExtraOptions = options;
+}
+
+//------------------------------------------------------------------------------
+void qMRMLVideoWriter::setMaximumNumberOfQueuedFrames(int maximumNumberOfFrames)
+{
+  Q_D(qMRMLVideoWriter);
+  std::lock_guard<std::mutex> lock(d->Mutex);
+  d->MaximumNumberOfQueuedFrames = std::max(1, maximumNumberOfFrames);
+}
+
+//------------------------------------------------------------------------------
+QString qMRMLVideoWriter::errorOutput()const
+{
+  Q_D(const qMRMLVideoWriter);
+  std::lock_guard<std::mutex> lock(const_cast<qMRMLVideoWriterPrivate*>(d)->Mutex);
+  return d->ErrorOutput;
+}
+
+//------------------------------------------------------------------------------
+bool qMRMLVideoWriter::addFrameFromRenderWindow(vtkRenderWindow* renderWindow)
+{
+  Q_D(qMRMLVideoWriter);
+  if (!renderWindow)
+    {
+    qWarning() << Q_FUNC_INFO << "failed: invalid render window";
+    return false;
+    }
+  int* size = renderWindow->GetSize();
+  int width = size[0];
+  int height = size[1];
+  // read the front buffer, as vtkWindowToImageFilter does by default
+  if (renderWindow->GetPixelData(0, 0, width - 1, height - 1, 1, d->PixelData.GetPointer()) == VTK_ERROR)
+    {
+    qWarning() << Q_FUNC_INFO << "failed: cannot read pixels of the render window";
+    return false;
+    }
+  return d->queueFrame(d->PixelData->GetPointer(0), width, height, d->PixelData->GetNumberOfComponents());
+}
+
+//------------------------------------------------------------------------------
+bool qMRMLVideoWriter::addFrameFromImage(vtkImageData* image)
+{
+  Q_D(qMRMLVideoWriter);
+  if (!image || image->GetScalarType() != VTK_UNSIGNED_CHAR || !image->GetPointData()->GetScalars())
+    {
+    qWarning() << Q_FUNC_INFO << "failed: image must have unsigned char scalars";
+    return false;
+    }
+  int* dimensions = image->GetDimensions();
+  return d->queueFrame(static_cast<unsigned char*>(image->GetScalarPointer()),
+    dimensions[0], dimensions[1], image->GetNumberOfScalarComponents());
+}
+
+//------------------------------------------------------------------------------
+bool qMRMLVideoWriter::finish()
+{
+  Q_D(qMRMLVideoWriter);
+  if (!d->Encoding)
+    {
+    return false;
+    }
+  {
+    std::lock_guard<std::mutex> lock(d->Mutex);
+    d->InputComplete = true;
+  }
+  d->QueueChanged.notify_all();
+  d->Worker.join();
+  d->Encoding = false;
+  return !d->hasFailed();
+}
@@ -0,0 +1,122 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#ifndef __qMRMLVideoWriter_h
+#define __qMRMLVideoWriter_h
+
+// Qt includes
+#include <QObject>
+#include <QStringList>
+
+// CTK includes
+#include <ctkPimpl.h>
+
+#include "qMRMLWidgetsExport.h"
+
+class qMRMLVideoWriterPrivate;
+class vtkImageData;
+class vtkRenderWindow;
+
+/// \brief Encode captured frames into a video file while they are captured.
+///
+/// Frames are read back from the render window into a reused buffer and queued.
+/// A worker thread streams the queued frames as raw RGB images to the standard
+/// input of an ffmpeg process, therefore capture of the next frame and encoding of
+/// the previous frames overlap and no intermediate image files are written.
+/// If the queue is full (see maximumNumberOfQueuedFrames) then adding a frame waits until
+/// the encoder has consumed a frame, so capture is paced by the encoder.
+///
+/// The ffmpeg process is started when the first frame is added, its size sets the size
+/// of the video. Width and height are rounded down to even values, as required by most codecs.
+///
+/// Typical use:
+/// \code
+/// qMRMLVideoWriter writer;
+/// writer.setFFmpegPath("/usr/bin/ffmpeg");
+/// writer.setOutputFileName("/tmp/sweep.mp4");
+/// writer.setExtraOptions(QStringList() << "-codec" << "libx264" << "-pix_fmt" << "yuv420p");
+/// for (...)
+///   {
+///   // ... update and render the view
+///   writer.addFrameFromRenderWindow(renderWindow);
+///   }
+/// bool success = writer.finish();
+/// \endcode
+class QMRML_WIDGETS_EXPORT qMRMLVideoWriter : public QObject
+{
+  Q_OBJECT
+  /// Path of the ffmpeg executable.
+  Q_PROPERTY(QString ffmpegPath READ ffmpegPath WRITE setFFmpegPath)
+  /// Number of frames per second of the video. Default is 25.
+  Q_PROPERTY(double frameRate READ frameRate WRITE setFrameRate)
+  /// Output video file. It is overwritten if it already exists.
+  Q_PROPERTY(QString outputFileName READ outputFileName WRITE setOutputFileName)
+  /// Encoding options, inserted in the ffmpeg command line between the input and the output
+  /// file (for example "-codec libx264 -preset slower -pix_fmt yuv420p").
+  Q_PROPERTY(QStringList extraOptions READ extraOptions WRITE setExtraOptions)
+  /// Maximum number of frames waiting for the encoder. Default is 4.
+  Q_PROPERTY(int maximumNumberOfQueuedFrames READ maximumNumberOfQueuedFrames WRITE setMaximumNumberOfQueuedFrames)
+  /// Number of frames added since the encoder was started.
+  Q_PROPERTY(int numberOfFrames READ numberOfFrames)
+  /// True between the first added frame and finish().
+  Q_PROPERTY(bool encoding READ isEncoding)
+public:
+  typedef QObject Superclass;
+  explicit qMRMLVideoWriter(QObject* parent = nullptr);
+  ~qMRMLVideoWriter() override;
+
+  QString ffmpegPath()const;
+  void setFFmpegPath(const QString& path);
+
+  double frameRate()const;
+  void setFrameRate(double framesPerSecond);
+
+  QString outputFileName()const;
+  void setOutputFileName(const QString& fileName);
+
+  QStringList extraOptions()const;
+  void setExtraOptions(const QStringList& options);
+
+  int maximumNumberOfQueuedFrames()const;
+  void setMaximumNumberOfQueuedFrames(int maximumNumberOfFrames);
+
+  int numberOfFrames()const;
+  bool isEncoding()const;
+
+  /// Messages of the encoder (ffmpeg standard error output) and errors of the writer.
+  Q_INVOKABLE QString errorOutput()const;
+
+  /// Add the current content of the render window as next frame.
+  /// The window is not rendered, the caller must render it before.
+  /// Returns false if the encoder could not be started or has failed.
+  Q_INVOKABLE bool addFrameFromRenderWindow(vtkRenderWindow* renderWindow);
+
+  /// Add an RGB or RGBA unsigned char image as next frame (alpha is ignored).
+  /// Returns false if the encoder could not be started or has failed.
+  Q_INVOKABLE bool addFrameFromImage(vtkImageData* image);
+
+  /// Wait until all the queued frames are encoded and the video file is written.
+  /// Returns true if the video was successfully written.
+  Q_INVOKABLE bool finish();
+
+protected:
+  QScopedPointer<qMRMLVideoWriterPrivate> d_ptr;
+
+private:
+  Q_DECLARE_PRIVATE(qMRMLVideoWriter);
+  Q_DISABLE_COPY(qMRMLVideoWriter);
+};
+
+#endif
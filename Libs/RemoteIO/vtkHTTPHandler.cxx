@@ -3,15 +3,154 @@
 #include "vtkHTTPHandler.h"
 
 // MRML includes
+#include <vtkDataTransfer.h>
 #include <vtkPermissionPrompter.h>
 
+// VTK includes
+#include <vtkCommand.h>
+
+// VTKsys includes
+#include <vtksys/SystemTools.hxx>
+
 // CURL includes
 #include <curl/curl.h>
 
+// STD includes
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <vector>
+
 #if defined(_MSC_VER)
 #pragma warning ( disable : 4786 )
 #endif
 
+// 64-bit file positions, for files larger than 2GB
+#if defined(_WIN32)
+# define vtkHTTPHandlerSeek _fseeki64
+# define vtkHTTPHandlerTell _ftelli64
+#else
+# define vtkHTTPHandlerSeek fseeko
+# define vtkHTTPHandlerTell ftello
+#endif
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+/// Byte range of a file downloaded by one connection
+struct vtkHTTPHandlerChunk
+{
+  CURL* Handle{nullptr};
+  FILE* File{nullptr};
+  /// First byte of the range
+  curl_off_t Begin{0};
+  /// Next byte to receive
+  curl_off_t Position{0};
+  /// Last byte of the range (inclusive), -1 if the whole file is requested
+  curl_off_t End{-1};
+  /// Position when the current attempt started
+  curl_off_t AttemptBegin{0};
+  int NumberOfRetries{0};
+  bool ResponseChecked{false};
+  bool RangeNotSupported{false};
+};
+
+//----------------------------------------------------------------------------
+size_t ChunkWriteCallback(char* ptr, size_t size, size_t nmemb, void* userData)
+{
+  vtkHTTPHandlerChunk* chunk = static_cast<vtkHTTPHandlerChunk*>(userData);
+  if (!chunk->ResponseChecked)
+    {
+    chunk->ResponseChecked = true;
+    long responseCode = 0;
+    curl_easy_getinfo(chunk->Handle, CURLINFO_RESPONSE_CODE, &responseCode);
+    if (chunk->End >= 0 && responseCode != 206)
+      {
+      // The server sends the whole file instead of the requested range,
+      // writing it at the range position would corrupt the file.
+      chunk->RangeNotSupported = true;
+      return 0;
+      }
+    }
+  size_t written = fwrite(ptr, 1, size * nmemb, chunk->File);
+  chunk->Position += static_cast<curl_off_t>(written);
+  return written;
+}
+
+//----------------------------------------------------------------------------
+/// Properties of the remote file, from the response headers
+struct vtkHTTPHandlerFileInfo
+{
+  curl_off_t Size{-1};
+  bool AcceptRanges{false};
+  /// The cached copy is up to date (the server responded 304 Not Modified)
+  bool NotModified{false};
+  std::string ETag;
+  std::string LastModified;
+};
+
+//----------------------------------------------------------------------------
+std::string GetHeaderValue(const std::string& header)
+{
+  std::string::size_type begin = header.find(':') + 1;
+  std::string::size_type end = header.find_last_not_of(" \t\r\n");
+  begin = header.find_first_not_of(" \t", begin);
+  if (begin == std::string::npos || end == std::string::npos || end < begin)
+    {
+    return std::string();
+    }
+  return header.substr(begin, end - begin + 1);
+}
+
+//----------------------------------------------------------------------------
+size_t FileInfoHeaderCallback(char* buffer, size_t size, size_t nitems, void* userData)
+{
+  vtkHTTPHandlerFileInfo* info = static_cast<vtkHTTPHandlerFileInfo*>(userData);
+  std::string header(buffer, size * nitems);
+  std::string lowerCaseHeader = vtksys::SystemTools::LowerCase(header);
+  if (lowerCaseHeader.find("http/") == 0)
+    {
+    // Status line: headers of a previous response (redirection) do not apply
+    info->AcceptRanges = false;
+    info->ETag.clear();
+    info->LastModified.clear();
+    }
+  else if (lowerCaseHeader.find("accept-ranges:") == 0 && lowerCaseHeader.find("bytes") != std::string::npos)
+    {
+    info->AcceptRanges = true;
+    }
+  else if (lowerCaseHeader.find("etag:") == 0)
+    {
+    info->ETag = GetHeaderValue(header);
+    }
+  else if (lowerCaseHeader.find("last-modified:") == 0)
+    {
+    info->LastModified = GetHeaderValue(header);
+    }
+  return size * nitems;
+}
+
+//----------------------------------------------------------------------------
+size_t MemoryWriteCallback(char* ptr, size_t size, size_t nmemb, void* userData)
+{
+  std::vector<char>* content = static_cast<std::vector<char>*>(userData);
+  content->insert(content->end(), ptr, ptr + size * nmemb);
+  return size * nmemb;
+}
+
+//----------------------------------------------------------------------------
+bool IsTransientError(CURLcode result)
+{
+  return result == CURLE_PARTIAL_FILE
+    || result == CURLE_RECV_ERROR
+    || result == CURLE_SEND_ERROR
+    || result == CURLE_GOT_NOTHING
+    || result == CURLE_OPERATION_TIMEDOUT;
+}
+
+} // end of anonymous namespace
+
 //----------------------------------------------------------------------------
 class vtkHTTPHandler::vtkInternal
 {
@@ -19,9 +158,30 @@ public:
   vtkInternal(vtkHTTPHandler* external);
   ~vtkInternal();
 
+  /// Set the options that are common to all the requests
+  void SetCommonOptions(CURL* handle, const char* url);
+
+  /// Get the size and validators of the file and check if byte ranges can be requested.
+  /// If the validators of a cached copy are given, the server is asked whether
+  /// the file has changed since (info.NotModified is set if not).
+  /// Returns the error of the request.
+  CURLcode QueryFile(const char* source, const char* eTag, const char* lastModified,
+    vtkHTTPHandlerFileInfo& info);
+
+  /// Download the chunks concurrently. Interrupted chunks are resumed.
+  /// Returns false and sets result if any of the chunks cannot be completed.
+  bool Download(const char* source, std::vector<vtkHTTPHandlerChunk>& chunks,
+    curl_off_t fileSize, vtkDataTransfer* transfer, CURLcode& result);
+
+  /// Create and add the handle of the chunk to the multi handle
+  bool StartChunk(CURLM* multiHandle, const char* source, vtkHTTPHandlerChunk& chunk);
+
   vtkHTTPHandler* External;
   CURL* CurlHandle;
   int ForbidReuse;
+  int NumberOfConnections;
+  vtkTypeInt64 ParallelDownloadMinimumFileSize;
+  int MaximumNumberOfRetries;
 };
 
 //----------------------------------------------------------------------------
@@ -32,6 +192,9 @@ vtkHTTPHandler::vtkInternal::vtkInternal(vtkHTTPHandler* external):External(exte
 {
   this->CurlHandle = nullptr;
   this->ForbidReuse = 0;
+  this->NumberOfConnections = 4;
+  this->ParallelDownloadMinimumFileSize = 64 * 1024 * 1024;
+  this->MaximumNumberOfRetries = 3;
 }
 
 //-----------------------------------------------------------------------------
@@ -40,6 +203,204 @@ vtkHTTPHandler::vtkInternal::~vtkInternal()
   this->CurlHandle = nullptr;
 }
 
+//----------------------------------------------------------------------------
+void vtkHTTPHandler::vtkInternal::SetCommonOptions(CURL* handle, const char* url)
+{
+  if (this->ForbidReuse)
+    {
+    curl_easy_setopt(handle, CURLOPT_FORBID_REUSE, 1L);
+    }
+  curl_easy_setopt(handle, CURLOPT_URL, url);
+  curl_easy_setopt(handle, CURLOPT_FOLLOWLOCATION, 1L);
+  // quick timeout during connection phase if URL is not accessible (e.g. blocked by a firewall)
+  curl_easy_setopt(handle, CURLOPT_CONNECTTIMEOUT, 3L); // in seconds (type long)
+  // abort stalled transfers (less than 1 byte/s for 60 seconds), they are resumed
+  curl_easy_setopt(handle, CURLOPT_LOW_SPEED_LIMIT, 1L);
+  curl_easy_setopt(handle, CURLOPT_LOW_SPEED_TIME, 60L);
+  curl_easy_setopt(handle, CURLOPT_NOSIGNAL, 1L);
+}
+
+//----------------------------------------------------------------------------
+CURLcode vtkHTTPHandler::vtkInternal::QueryFile(const char* source, const char* eTag, const char* lastModified,
+  vtkHTTPHandlerFileInfo& info)
+{
+  info = vtkHTTPHandlerFileInfo();
+  CURL* handle = curl_easy_init();
+  if (handle == nullptr)
+    {
+    return CURLE_FAILED_INIT;
+    }
+  this->SetCommonOptions(handle, source);
+  curl_easy_setopt(handle, CURLOPT_NOBODY, 1L);
+  curl_easy_setopt(handle, CURLOPT_HEADERFUNCTION, FileInfoHeaderCallback);
+  curl_easy_setopt(handle, CURLOPT_HEADERDATA, &info);
+  struct curl_slist* conditionHeaders = nullptr;
+  if (eTag && *eTag)
+    {
+    conditionHeaders = curl_slist_append(conditionHeaders, (std::string("If-None-Match: ") + eTag).c_str());
+    }
+  else if (lastModified && *lastModified)
+    {
+    conditionHeaders = curl_slist_append(conditionHeaders, (std::string("If-Modified-Since: ") + lastModified).c_str());
+    }
+  curl_easy_setopt(handle, CURLOPT_HTTPHEADER, conditionHeaders);
+  CURLcode result = curl_easy_perform(handle);
+  long responseCode = 0;
+  curl_easy_getinfo(handle, CURLINFO_RESPONSE_CODE, &responseCode);
+  if (result == CURLE_OK && responseCode == 304)
+    {
+    info.NotModified = true;
+    }
+  else if (result == CURLE_OK && responseCode >= 200 && responseCode < 300)
+    {
+    curl_easy_getinfo(handle, CURLINFO_CONTENT_LENGTH_DOWNLOAD_T, &info.Size);
+    }
+  else
+    {
+    // Some servers (e.g. object stores with signed URLs) only accept GET requests,
+    // the file is then downloaded with a single connection.
+    info.AcceptRanges = false;
+    info.ETag.clear();
+    info.LastModified.clear();
+    }
+  curl_easy_cleanup(handle);
+  curl_slist_free_all(conditionHeaders);
+  return result;
+}
+
+//----------------------------------------------------------------------------
+bool vtkHTTPHandler::vtkInternal::StartChunk(CURLM* multiHandle, const char* source, vtkHTTPHandlerChunk& chunk)
+{
+  chunk.Handle = curl_easy_init();
+  if (chunk.Handle == nullptr)
+    {
+    return false;
+    }
+  chunk.AttemptBegin = chunk.Position;
+  chunk.ResponseChecked = false;
+  this->SetCommonOptions(chunk.Handle, source);
+  curl_easy_setopt(chunk.Handle, CURLOPT_HTTPGET, 1L);
+  curl_easy_setopt(chunk.Handle, CURLOPT_WRITEFUNCTION, ChunkWriteCallback);
+  curl_easy_setopt(chunk.Handle, CURLOPT_WRITEDATA, &chunk);
+  curl_easy_setopt(chunk.Handle, CURLOPT_PRIVATE, &chunk);
+  curl_easy_setopt(chunk.Handle, CURLOPT_FAILONERROR, 1L);
+  if (chunk.End >= 0)
+    {
+    std::string range = std::to_string(static_cast<long long>(chunk.Position))
+      + "-" + std::to_string(static_cast<long long>(chunk.End));
+    curl_easy_setopt(chunk.Handle, CURLOPT_RANGE, range.c_str()); // the string is copied
+    }
+  else if (chunk.Position > 0)
+    {
+    curl_easy_setopt(chunk.Handle, CURLOPT_RESUME_FROM_LARGE, chunk.Position);
+    }
+  curl_multi_add_handle(multiHandle, chunk.Handle);
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkHTTPHandler::vtkInternal::Download(const char* source, std::vector<vtkHTTPHandlerChunk>& chunks,
+  curl_off_t fileSize, vtkDataTransfer* transfer, CURLcode& result)
+{
+  result = CURLE_OK;
+  CURLM* multiHandle = curl_multi_init();
+  if (multiHandle == nullptr)
+    {
+    result = CURLE_FAILED_INIT;
+    return false;
+    }
+  int numberOfActiveChunks = 0;
+  for (vtkHTTPHandlerChunk& chunk : chunks)
+    {
+    if (!this->StartChunk(multiHandle, source, chunk))
+      {
+      result = CURLE_FAILED_INIT;
+      break;
+      }
+    ++numberOfActiveChunks;
+    }
+
+  int lastProgress = -1;
+  while (numberOfActiveChunks > 0 && result == CURLE_OK)
+    {
+    int numberOfRunningHandles = 0;
+    curl_multi_perform(multiHandle, &numberOfRunningHandles);
+
+    int numberOfMessages = 0;
+    while (CURLMsg* message = curl_multi_info_read(multiHandle, &numberOfMessages))
+      {
+      if (message->msg != CURLMSG_DONE)
+        {
+        continue;
+        }
+      vtkHTTPHandlerChunk* chunk = nullptr;
+      curl_easy_getinfo(message->easy_handle, CURLINFO_PRIVATE, reinterpret_cast<char**>(&chunk));
+      CURLcode chunkResult = message->data.result;
+      curl_multi_remove_handle(multiHandle, chunk->Handle);
+      curl_easy_cleanup(chunk->Handle);
+      chunk->Handle = nullptr;
+      if (chunkResult == CURLE_OK && chunk->End >= 0 && chunk->Position <= chunk->End)
+        {
+        // Connection closed before the end of the range
+        chunkResult = CURLE_PARTIAL_FILE;
+        }
+      if (chunkResult == CURLE_OK)
+        {
+        --numberOfActiveChunks;
+        }
+      else if (!chunk->RangeNotSupported
+        && chunk->NumberOfRetries < this->MaximumNumberOfRetries
+        && (IsTransientError(chunkResult) || chunk->Position > chunk->AttemptBegin))
+        {
+        // Continue from the last received byte
+        ++chunk->NumberOfRetries;
+        if (!this->StartChunk(multiHandle, source, *chunk))
+          {
+          result = CURLE_FAILED_INIT;
+          }
+        }
+      else
+        {
+        result = chunk->RangeNotSupported ? CURLE_RANGE_ERROR : chunkResult;
+        }
+      }
+
+    if (transfer && fileSize > 0)
+      {
+      curl_off_t receivedSize = 0;
+      for (const vtkHTTPHandlerChunk& chunk : chunks)
+        {
+        receivedSize += chunk.Position - chunk.Begin;
+        }
+      int progress = static_cast<int>(100 * receivedSize / fileSize);
+      if (progress != lastProgress)
+        {
+        lastProgress = progress;
+        transfer->SetProgressNoModify(progress);
+        transfer->InvokeEvent(vtkCommand::ProgressEvent);
+        }
+      }
+
+    if (numberOfActiveChunks > 0 && result == CURLE_OK)
+      {
+      curl_multi_wait(multiHandle, nullptr, 0, 1000, nullptr);
+      }
+    }
+
+  // Abort the remaining transfers after an error
+  for (vtkHTTPHandlerChunk& chunk : chunks)
+    {
+    if (chunk.Handle)
+      {
+      curl_multi_remove_handle(multiHandle, chunk.Handle);
+      curl_easy_cleanup(chunk.Handle);
+      chunk.Handle = nullptr;
+      }
+    }
+  curl_multi_cleanup(multiHandle);
+  return result == CURLE_OK;
+}
+
 //----------------------------------------------------------------------------
 // vtkHTTPHandler methods
 
@@ -94,6 +455,8 @@ size_t ProgressCallback(FILE* vtkNotUsed( outputFile ), double dltotal, double d
 //----------------------------------------------------------------------------
 vtkHTTPHandler::vtkHTTPHandler()
 {
+  // curl_global_init is not thread-safe, call it before any transfer
+  curl_global_init(CURL_GLOBAL_ALL);
   this->Internal = new vtkInternal(this);
 }
 
@@ -107,6 +470,10 @@ vtkHTTPHandler::~vtkHTTPHandler()
 void vtkHTTPHandler::PrintSelf(ostream& os, vtkIndent indent)
 {
   Superclass::PrintSelf ( os, indent );
+  os << indent << "ForbidReuse: " << this->Internal->ForbidReuse << "\n";
+  os << indent << "NumberOfConnections: " << this->Internal->NumberOfConnections << "\n";
+  os << indent << "ParallelDownloadMinimumFileSize: " << this->Internal->ParallelDownloadMinimumFileSize << "\n";
+  os << indent << "MaximumNumberOfRetries: " << this->Internal->MaximumNumberOfRetries << "\n";
 }
 
 //----------------------------------------------------------------------------
@@ -145,6 +512,59 @@ int vtkHTTPHandler::CanHandleURI ( const char *uri )
   return ( 0 );
 }
 
+//----------------------------------------------------------------------------
+void vtkHTTPHandler::SetNumberOfConnections(int value)
+{
+  value = std::max(value, 1);
+  if (this->Internal->NumberOfConnections == value)
+    {
+    return;
+    }
+  this->Internal->NumberOfConnections = value;
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+int vtkHTTPHandler::GetNumberOfConnections()
+{
+  return this->Internal->NumberOfConnections;
+}
+
+//----------------------------------------------------------------------------
+void vtkHTTPHandler::SetParallelDownloadMinimumFileSize(vtkTypeInt64 size)
+{
+  if (this->Internal->ParallelDownloadMinimumFileSize == size)
+    {
+    return;
+    }
+  this->Internal->ParallelDownloadMinimumFileSize = size;
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+vtkTypeInt64 vtkHTTPHandler::GetParallelDownloadMinimumFileSize()
+{
+  return this->Internal->ParallelDownloadMinimumFileSize;
+}
+
+//----------------------------------------------------------------------------
+void vtkHTTPHandler::SetMaximumNumberOfRetries(int value)
+{
+  value = std::max(value, 0);
+  if (this->Internal->MaximumNumberOfRetries == value)
+    {
+    return;
+    }
+  this->Internal->MaximumNumberOfRetries = value;
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+int vtkHTTPHandler::GetMaximumNumberOfRetries()
+{
+  return this->Internal->MaximumNumberOfRetries;
+}
+
 //----------------------------------------------------------------------------
 void vtkHTTPHandler::SetForbidReuse(int value)
 {
@@ -165,7 +585,6 @@ int vtkHTTPHandler::GetForbidReuse()
 //----------------------------------------------------------------------------
 void vtkHTTPHandler::InitTransfer( )
 {
-  curl_global_init(CURL_GLOBAL_ALL);
   vtkDebugMacro("vtkHTTPHandler: InitTransfer: initialising CurlHandle");
   this->Internal->CurlHandle = curl_easy_init();
   if (this->Internal->CurlHandle == nullptr)
@@ -184,53 +603,151 @@ int vtkHTTPHandler::CloseTransfer( )
 
 //----------------------------------------------------------------------------
 void vtkHTTPHandler::StageFileRead(const char * source, const char * destination)
+{
+  this->StageFileRead(source, destination, nullptr);
+}
+
+//----------------------------------------------------------------------------
+void vtkHTTPHandler::StageFileRead(const char * source, const char * destination, vtkDataTransfer* transfer)
 {
   if (source == nullptr || destination == nullptr)
     {
     vtkErrorMacro("StageFileRead: source or dest is null!");
     return;
     }
-  /*
-  if (this->LocalFile)
+
+  // Curl handles and files are local to this call, so that multiple files
+  // can be downloaded concurrently by the same handler.
+  const bool cachedCopyExists = vtksys::SystemTools::FileExists(destination, true);
+  vtkHTTPHandlerFileInfo fileInfo;
+  CURLcode retval = this->Internal->QueryFile(source,
+    (transfer && cachedCopyExists) ? transfer->GetETag() : nullptr,
+    (transfer && cachedCopyExists) ? transfer->GetLastModified() : nullptr,
+    fileInfo);
+  if (retval == CURLE_COULDNT_RESOLVE_HOST || retval == CURLE_COULDNT_CONNECT || retval == CURLE_OPERATION_TIMEDOUT)
     {
-    this->LocalFile->close();
-    delete this->LocalFile;
-    this->LocalFile = nullptr;
+    // The server is not accessible, do not try again
+    vtkErrorMacro("StageFileRead: error running curl: " << curl_easy_strerror(retval));
+    return;
     }
-  this->LocalFile = new std::ofstream(destination, std::ios::binary);
-  */
-  this->InitTransfer( );
+  if (fileInfo.NotModified)
+    {
+    // The cached copy is up to date, the validators of the transfer remain valid
+    vtkDebugMacro("StageFileRead: " << source << " is not modified, using cached file " << destination);
+    transfer->SetProgressNoModify(100);
+    transfer->InvokeEvent(vtkCommand::ProgressEvent);
+    return;
+    }
+  const curl_off_t fileSize = fileInfo.Size;
+  const bool acceptRanges = fileInfo.AcceptRanges;
 
+  const std::string partialFileName = std::string(destination) + ".part";
+  std::vector<vtkHTTPHandlerChunk> chunks;
+  bool success = false;
+  retval = CURLE_OK;
 
-  if ( this->Internal->ForbidReuse )
+  const int numberOfConnections = this->Internal->NumberOfConnections;
+  if (acceptRanges && numberOfConnections > 1 && fileSize > 0
+    && fileSize >= this->Internal->ParallelDownloadMinimumFileSize)
     {
-    curl_easy_setopt(this->Internal->CurlHandle, CURLOPT_FORBID_REUSE, 1);
+    // Download byte ranges concurrently into the same file
+    vtkDebugMacro("StageFileRead: downloading " << fileSize << " bytes with "
+      << numberOfConnections << " connections, source = " << source << ", dest = " << destination);
+    FILE* file = fopen(partialFileName.c_str(), "wb");
+    if (file)
+      {
+      fclose(file);
+      const curl_off_t chunkSize = fileSize / numberOfConnections;
+      chunks.resize(numberOfConnections);
+      for (int chunkIndex = 0; chunkIndex < numberOfConnections; ++chunkIndex)
+        {
+        vtkHTTPHandlerChunk& chunk = chunks[chunkIndex];
+        chunk.Begin = chunkIndex * chunkSize;
+        chunk.Position = chunk.Begin;
+        chunk.End = (chunkIndex == numberOfConnections - 1) ? fileSize - 1 : chunk.Begin + chunkSize - 1;
+        chunk.File = fopen(partialFileName.c_str(), "r+b");
+        if (!chunk.File || vtkHTTPHandlerSeek(chunk.File, chunk.Begin, SEEK_SET) != 0)
+          {
+          retval = CURLE_WRITE_ERROR;
+          }
+        }
+      if (retval == CURLE_OK)
+        {
+        success = this->Internal->Download(source, chunks, fileSize, transfer, retval);
+        }
+      for (vtkHTTPHandlerChunk& chunk : chunks)
+        {
+        if (chunk.File)
+          {
+          fclose(chunk.File);
+          }
+        }
+      chunks.clear();
+      if (!success)
+        {
+        // The partial file has holes, it cannot be resumed
+        vtksys::SystemTools::RemoveFile(partialFileName);
+        vtkDebugMacro("StageFileRead: parallel download failed, downloading with a single connection: "
+          << curl_easy_strerror(retval));
+        }
+      }
     }
-  curl_easy_setopt(this->Internal->CurlHandle, CURLOPT_HTTPGET, 1);
-  curl_easy_setopt(this->Internal->CurlHandle, CURLOPT_URL, source);
-//  curl_easy_setopt(this->Internal->CurlHandle, CURLOPT_NOPROGRESS, false);
-  curl_easy_setopt(this->Internal->CurlHandle, CURLOPT_FOLLOWLOCATION, true);
-  // use the default curl write call back
-  curl_easy_setopt(this->Internal->CurlHandle, CURLOPT_WRITEFUNCTION, nullptr); // write_callback);
-  this->LocalFile = fopen(destination, "wb");
-  // output goes into LocalFile, must be  FILE*
-  curl_easy_setopt(this->Internal->CurlHandle, CURLOPT_WRITEDATA, this->LocalFile);
-//  curl_easy_setopt(this->Internal->CurlHandle, CURLOPT_PROGRESSDATA, nullptr);
-//  curl_easy_setopt(this->Internal->CurlHandle, CURLOPT_PROGRESSFUNCTION, ProgressCallback);
 
-  // quick timeout during connection phase if URL is not accessible (e.g. blocked by a firewall)
-  curl_easy_setopt(this->Internal->CurlHandle, CURLOPT_CONNECTTIMEOUT, 3); // in seconds (type long)
-
-  vtkDebugMacro("StageFileRead: about to do the curl download... source = " << source << ", dest = " << destination);
-  CURLcode retval = curl_easy_perform(this->Internal->CurlHandle);
+  if (!success)
+    {
+    // Download with a single connection, continue the partial file of a previous attempt
+    chunks.resize(1);
+    vtkHTTPHandlerChunk& chunk = chunks[0];
+    chunk.File = fopen(partialFileName.c_str(), "ab");
+    if (chunk.File)
+      {
+      vtkHTTPHandlerSeek(chunk.File, 0, SEEK_END);
+      chunk.Position = static_cast<curl_off_t>(vtkHTTPHandlerTell(chunk.File));
+      vtkDebugMacro("StageFileRead: about to do the curl download... source = " << source
+        << ", dest = " << destination << ", resumed from " << chunk.Position);
+      success = this->Internal->Download(source, chunks, fileSize, transfer, retval);
+      if (!success && chunk.Position > 0 && (retval == CURLE_RANGE_ERROR || retval == CURLE_HTTP_RETURNED_ERROR))
+        {
+        // The server cannot resume the download (or the partial file is obsolete), start from scratch
+        fclose(chunk.File);
+        chunk = vtkHTTPHandlerChunk();
+        chunk.File = fopen(partialFileName.c_str(), "wb");
+        if (chunk.File)
+          {
+          success = this->Internal->Download(source, chunks, fileSize, transfer, retval);
+          }
+        }
+      if (chunk.File)
+        {
+        fclose(chunk.File);
+        }
+      }
+    else
+      {
+      retval = CURLE_WRITE_ERROR;
+      }
+    }
 
-  if (retval == CURLE_OK)
+  if (success)
     {
     vtkDebugMacro("StageFileRead: successful return from curl");
+    vtksys::SystemTools::RemoveFile(destination);
+    if (!vtksys::SystemTools::RenameFile(partialFileName, destination))
+      {
+      vtkErrorMacro("StageFileRead: failed to rename " << partialFileName << " to " << destination);
+      }
+    if (transfer)
+      {
+      transfer->SetValidatorsNoModify(
+        fileInfo.ETag.empty() ? nullptr : fileInfo.ETag.c_str(),
+        fileInfo.LastModified.empty() ? nullptr : fileInfo.LastModified.c_str());
+      transfer->SetProgressNoModify(100);
+      transfer->InvokeEvent(vtkCommand::ProgressEvent);
+      }
     }
   else if (retval == CURLE_BAD_FUNCTION_ARGUMENT)
     {
-    vtkErrorMacro("StageFileRead: bad function argument to curl, did you init CurlHandle?");
+    vtkErrorMacro("StageFileRead: bad function argument to curl");
     }
   else if (retval == CURLE_OUT_OF_MEMORY)
     {
@@ -249,20 +766,58 @@ void vtkHTTPHandler::StageFileRead(const char * source, const char * destination
       this->GetPermissionPrompter()->SetRemember ( 0 );
       }
     }
-  this->CloseTransfer();
+}
 
-  /*
-  this->LocalFile->close();
-  delete this->LocalFile;
-  this->LocalFile = nullptr;
-  */
-  if (this->LocalFile)
+//----------------------------------------------------------------------------
+int vtkHTTPHandler::ReadToMemory(const char* uri, std::vector<char>& content)
+{
+  content.clear();
+  if (uri == nullptr)
     {
-    fclose(this->LocalFile);
+    return vtkURIHandler::ReadFailed;
     }
+  CURLcode result = CURLE_OK;
+  long responseCode = 0;
+  for (int attempt = 0; attempt <= this->Internal->MaximumNumberOfRetries; ++attempt)
+    {
+    CURL* handle = curl_easy_init();
+    if (handle == nullptr)
+      {
+      return vtkURIHandler::ReadFailed;
+      }
+    content.clear();
+    this->Internal->SetCommonOptions(handle, uri);
+    curl_easy_setopt(handle, CURLOPT_HTTPGET, 1L);
+    curl_easy_setopt(handle, CURLOPT_WRITEFUNCTION, MemoryWriteCallback);
+    curl_easy_setopt(handle, CURLOPT_WRITEDATA, &content);
+    result = curl_easy_perform(handle);
+    responseCode = 0;
+    curl_easy_getinfo(handle, CURLINFO_RESPONSE_CODE, &responseCode);
+    curl_easy_cleanup(handle);
+    if (!IsTransientError(result))
+      {
+      break;
+      }
+    }
+  if (result != CURLE_OK)
+    {
+    vtkErrorMacro("ReadToMemory: error reading " << uri << ": " << curl_easy_strerror(result));
+    return vtkURIHandler::ReadFailed;
+    }
+  if (responseCode == 404 || responseCode == 410)
+    {
+    content.clear();
+    return vtkURIHandler::ReadNotFound;
+    }
+  if (responseCode < 200 || responseCode >= 300)
+    {
+    vtkErrorMacro("ReadToMemory: error reading " << uri << ": HTTP response code " << responseCode);
+    content.clear();
+    return vtkURIHandler::ReadFailed;
+    }
+  return vtkURIHandler::ReadSucceeded;
 }
 
-
 //----------------------------------------------------------------------------
 void vtkHTTPHandler::StageFileWrite(const char * source, const char * destination)
 {
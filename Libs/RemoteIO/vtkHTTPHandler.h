@@ -32,9 +32,40 @@ public:
   void SetForbidReuse(int value);
   int GetForbidReuse();
 
+  /// Number of connections used for downloading a large file.
+  /// Files larger than ParallelDownloadMinimumFileSize are split into this
+  /// many byte ranges that are downloaded concurrently, if the server accepts
+  /// range requests. Default is 4.
+  void SetNumberOfConnections(int value);
+  int GetNumberOfConnections();
+
+  /// Minimum size (in bytes) of files that are downloaded with multiple connections.
+  /// Default is 64 MB.
+  void SetParallelDownloadMinimumFileSize(vtkTypeInt64 size);
+  vtkTypeInt64 GetParallelDownloadMinimumFileSize();
+
+  /// Number of times an interrupted download is resumed before giving up.
+  /// Default is 3.
+  void SetMaximumNumberOfRetries(int value);
+  int GetMaximumNumberOfRetries();
+
   /// This function wraps curl functionality to download a specified URL to a specified dir
   void StageFileRead(const char * source, const char * destination) override;
+  /// Download the file into "destination.part" and rename it to destination when completed.
+  /// If the connection is lost, the download is resumed from the last received byte.
+  /// If the download fails, the partial file is kept and the next download of the same
+  /// file continues from its end. Download progress is reported in \a transfer.
+  /// If the destination file exists and \a transfer has the validators (ETag or
+  /// Last-Modified) of it, the file is only downloaded if the remote file has changed.
+  /// The validators of the downloaded file are stored in \a transfer.
+  /// Can be called concurrently from multiple threads.
+  void StageFileRead(const char * source, const char * destination, vtkDataTransfer* transfer) override;
   using vtkURIHandler::StageFileRead;
+  /// Read the resource with a GET request into \a content.
+  /// Returns ReadNotFound if the server responds 404 or 410.
+  /// Can be called concurrently from multiple threads.
+  int ReadToMemory(const char* uri, std::vector<char>& content) override;
+  bool CanReadToMemory() override { return true; }
   void StageFileWrite(const char * source, const char * destination) override;
   using vtkURIHandler::StageFileWrite;
   void InitTransfer () override;
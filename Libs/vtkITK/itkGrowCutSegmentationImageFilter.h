@@ -260,6 +260,19 @@ template<class TInputImage,
   itkGetConstMacro(SetMaxSaturationImage, bool);
   itkBooleanMacro(SetMaxSaturationImage);
 
+  /**Set/Get whether iterations until convergence only update the narrow band
+  * of voxels that have a neighbor (or themselves) modified in the previous
+  * iteration. The band is updated in parallel and iterations stop when no
+  * voxel is modified, therefore the cost of an iteration is proportional to
+  * the size of the moving front instead of the size of the region of interest.
+  * All voxels of the band are updated from the values of the previous iteration.
+  * When disabled, the whole region of interest is processed in each iteration
+  * until the number of saturated voxels stops changing. Default setting is on.
+  **/
+  itkSetMacro(UseNarrowBand, bool);
+  itkGetConstMacro(UseNarrowBand, bool);
+  itkBooleanMacro(UseNarrowBand);
+
  protected:
 
   GrowCutSegmentationImageFilter();
@@ -278,6 +291,15 @@ template<class TInputImage,
 
   void AfterThreadedGenerateData() override;
 
+  /** Run the iterations until convergence on the narrow band of modified voxels.
+   * Labels and weights are updated in the output image and m_WeightImage. **/
+  void GenerateDataNarrowBand(InputImageType* inputImage, OutputImageType* stateImage,
+                              WeightImageType* distanceImage, WeightImageType* maxSaturationImage,
+                              bool converged);
+
+  /** Set the number of labeled, locally saturated, and saturated voxels from the state image **/
+  void CountPixelStates(OutputImageType* stateImage);
+
   void Initialize(OutputImageType* output);
 
   void PrintSelf ( std::ostream& os, Indent indent ) const override;
@@ -314,6 +336,7 @@ template<class TInputImage,
   bool                                       m_SetStateImage;
   bool                                       m_SetDistancesImage;
   bool                                       m_SetMaxSaturationImage;
+  bool                                       m_UseNarrowBand;
 
   unsigned int                               m_MaxIterations;
   unsigned int                               m_ObjectRadius;
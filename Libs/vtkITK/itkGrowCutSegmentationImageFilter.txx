@@ -10,6 +10,9 @@
 #include "itkNeighborhoodAlgorithm.h"
 #include "itkImageRegionIterator.h"
 #include "itkImageRegionConstIterator.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
+#include "itkImageAlgorithm.h"
+#include "itkMultiThreaderBase.h"
 #include "itkConstantBoundaryCondition.h"
 #include "itkNumericTraits.h"
 #include "itkImageFileWriter.h"
@@ -53,6 +56,8 @@ GrowCutSegmentationImageFilter<TInputImage, TOutputImage, TWeightPixelType>
 
   m_SetMaxSaturationImage = false;
 
+  m_UseNarrowBand = true;
+
   m_ConfThresh = 0.2;
 
   m_MaxIterations = 500;
@@ -90,6 +95,7 @@ GrowCutSegmentationImageFilter<TInputImage, TOutputImage, TWeightPixelType>
   //   os << indent << "max enemies for attack T1 : " << m_T1<< std::endl;
   // os << indent << "min enemies for submit T2 : " << m_T2<< std::endl;
   os << indent << "starting seed strength :" <<m_SeedStrength<< std::endl;
+  os << indent << "use narrow band : " << m_UseNarrowBand << std::endl;
   //os << indent << "use Algorithm Speed Slow : " << m_UseSlow<< std::endl;
 }
 
@@ -559,6 +565,16 @@ GrowCutSegmentationImageFilter<TInputImage, TOutputImage, TWeightPixelType>
     maxSaturationImage->FillBuffer( 0 );
     }
 
+  if(m_UseNarrowBand)
+    {
+    OutputImagePointer stateImage = m_SetStateImage ? this->GetStateImage() : pixelStateImage;
+    WeightImagePointer distanceImage = m_SetDistancesImage ? this->GetDistancesImage() : maxDistancesImage;
+    WeightImagePointer saturationImage = m_SetMaxSaturationImage ? this->GetMaxSaturationImage() : maxSaturationImage;
+    this->GenerateDataNarrowBand(inputImage, stateImage, distanceImage, saturationImage, converged);
+    iterate.CompletedStep();
+    return;
+    }
+
   /////////////////////////////////////////////////////////////////
 
   // Filter was configured to run until convergence. We need to delegate a different instance of the filter to run on each iteration.
@@ -1053,18 +1069,312 @@ void GrowCutSegmentationImageFilter<TInputImage, TOutputImage, TWeightPixelType>
 }
 
 
+template <class TInputImage, class TOutputImage, class TWeightPixelType>
+void
+GrowCutSegmentationImageFilter<TInputImage, TOutputImage, TWeightPixelType>
+::GenerateDataNarrowBand(InputImageType* inputImage, OutputImageType* stateImage,
+                         WeightImageType* distanceImage, WeightImageType* maxSaturationImage,
+                         bool converged)
+{
+  OutputImageType* outputImage = this->GetOutput();
+  const OutputImageRegionType bufferedRegion = outputImage->GetBufferedRegion();
+
+  OutputImageType* labelImage = static_cast< OutputImageType*>(this->ProcessObject::GetInput(1));
+  WeightImageType* strengthImage = static_cast< WeightImageType*>(this->ProcessObject::GetInput(2));
+
+  if(inputImage->GetBufferedRegion() != bufferedRegion ||
+     labelImage->GetBufferedRegion() != bufferedRegion ||
+     strengthImage->GetBufferedRegion() != bufferedRegion ||
+     stateImage->GetBufferedRegion() != bufferedRegion ||
+     distanceImage->GetBufferedRegion() != bufferedRegion ||
+     maxSaturationImage->GetBufferedRegion() != bufferedRegion)
+    {
+    itkExceptionMacro(<< "GenerateDataNarrowBand: buffered regions of the input images do not match the output");
+    }
+
+  // The current labels and weights are kept in the output and in the updated strength image
+  ImageAlgorithm::Copy(labelImage, outputImage, bufferedRegion, bufferedRegion);
+  m_WeightImage = WeightImageType::New();
+  m_WeightImage->CopyInformation(outputImage);
+  m_WeightImage->SetRegions(bufferedRegion);
+  m_WeightImage->Allocate();
+  ImageAlgorithm::Copy(strengthImage, m_WeightImage.GetPointer(), bufferedRegion, bufferedRegion);
+
+  const InputPixelType* intensities = inputImage->GetBufferPointer();
+  OutputPixelType* labels = outputImage->GetBufferPointer();
+  WeightPixelType* weights = m_WeightImage->GetBufferPointer();
+  OutputPixelType* states = stateImage->GetBufferPointer();
+  const WeightPixelType* distances = distanceImage->GetBufferPointer();
+  WeightPixelType* maxSaturations = maxSaturationImage->GetBufferPointer();
+
+  // Only voxels of the region of interest are updated, neighbors outside the image are ignored
+  OutputImageRegionType roiRegion;
+  roiRegion.SetIndex(m_RoiStart);
+  OutputSizeType roiSize;
+  for (unsigned d = 0; d < ImageDimension; d++)
+    {
+    roiSize[d] = (m_RoiEnd[d] >= m_RoiStart[d]) ? static_cast< SizeValueType>(m_RoiEnd[d] - m_RoiStart[d] + 1) : 0;
+    }
+  roiRegion.SetSize(roiSize);
+  if(!roiRegion.Crop(bufferedRegion))
+    {
+    converged = true;
+    }
+
+  // Offsets of the 3x3x... neighborhood, including the center voxel
+  typedef Offset< ImageDimension > NeighborOffsetType;
+  std::vector< NeighborOffsetType > neighborIndexOffsets;
+  std::vector< OffsetValueType > neighborBufferOffsets;
+  const OffsetValueType* offsetTable = outputImage->GetOffsetTable();
+  NeighborOffsetType neighborOffset;
+  neighborOffset.Fill(-1);
+  bool allNeighborsAdded = false;
+  while(!allNeighborsAdded)
+    {
+    OffsetValueType bufferOffset = 0;
+    for (unsigned d = 0; d < ImageDimension; d++)
+      {
+      bufferOffset += neighborOffset[d] * offsetTable[d];
+      }
+    neighborIndexOffsets.push_back(neighborOffset);
+    neighborBufferOffsets.push_back(bufferOffset);
+    allNeighborsAdded = true;
+    for (unsigned d = 0; d < ImageDimension && allNeighborsAdded; d++)
+      {
+      if(neighborOffset[d] < 1)
+        {
+        ++neighborOffset[d];
+        allNeighborsAdded = false;
+        }
+      else
+        {
+        neighborOffset[d] = -1;
+        }
+      }
+    }
+  const unsigned int numberOfNeighbors = static_cast< unsigned int>(neighborBufferOffsets.size());
+
+  const InputPixelType minI = NumericTraits< InputPixelType > ::min(InputPixelType());
+  const WeightPixelType minW = NumericTraits< WeightPixelType > ::min(WeightPixelType());
+  const WeightPixelType seedStrength = static_cast< WeightPixelType>(m_SeedStrength);
+  const OutputPixelType unknownLabel = m_UnknownLabel;
+  const IndexType bufferedStart = bufferedRegion.GetIndex();
+  const OutputSizeType bufferedSize = bufferedRegion.GetSize();
+
+  struct VoxelUpdate
+    {
+    OutputPixelType Label;
+    WeightPixelType Weight;
+    OutputPixelType State;
+    WeightPixelType MaxSaturation;
+    };
+
+  // Same update rule as ThreadedGenerateData, but only reads the neighborhood of the voxel,
+  // so that the results can be computed for the voxels of the band in any order.
+  auto computeUpdate = [&](OffsetValueType p, VoxelUpdate& update)
+    {
+    const IndexType index = outputImage->ComputeIndex(p);
+    bool interior = true;
+    for (unsigned d = 0; d < ImageDimension; d++)
+      {
+      if(index[d] <= bufferedStart[d] ||
+         index[d] >= bufferedStart[d] + static_cast< IndexValueType>(bufferedSize[d]) - 1)
+        {
+        interior = false;
+        }
+      }
+
+    const OutputPixelType s_center = states[p];
+    const OutputPixelType l_center = labels[p];
+    const WeightPixelType w_center = weights[p];
+    const InputPixelType f_center = intensities[p];
+    const WeightPixelType maxDist = distances[p];
+
+    OutputPixelType state = s_center;
+    OutputPixelType winnerLabel = l_center;
+    WeightPixelType winnerWeight = w_center;
+    unsigned int countSaturatedLinks = 0;
+    unsigned int countLocalSaturatedLinks = 0;
+    bool modified = false;
+    WeightPixelType maxWt = 0.0;
+    unsigned int nlinks = 0;
+
+    for (unsigned k = 0; k < numberOfNeighbors; k++)
+      {
+      if(!interior && !bufferedRegion.IsInside(index + neighborIndexOffsets[k]))
+        {
+        continue;
+        }
+      const OffsetValueType q = p + neighborBufferOffsets[k];
+      const InputPixelType f = intensities[q];
+      const WeightPixelType w = weights[q];
+      if(f == minI && w == minW)
+        {
+        continue;
+        }
+      const OutputPixelType s = (q == p) ? state : states[q];
+      const OutputPixelType l = labels[q];
+
+      ++nlinks;
+
+      WeightPixelType attackWeight = (f_center - f)*(f_center - f);
+      attackWeight = (maxDist > 0) ? (1.0 - attackWeight/maxDist) : 1.0;
+
+      const WeightPixelType msat = maxSaturations[q];
+      const WeightPixelType maxAttackWeight = (s == UNLABELED) ? 0.0 :
+        ((msat == 0.0) ? (attackWeight * seedStrength) :
+         ((s == SATURATED) ? attackWeight * w : attackWeight*msat ) );
+
+      attackWeight *= w;
+
+      maxWt = (maxWt < maxAttackWeight) ? maxAttackWeight : maxWt;
+
+      if(s_center != UNLABELED)
+        {
+        countSaturatedLinks += (maxAttackWeight <= w_center) ? 1 : 0;
+        countLocalSaturatedLinks += (attackWeight <= w_center) ? 1 : 0;
+        }
+
+      if(s != UNLABELED && attackWeight > winnerWeight)
+        {
+        winnerWeight = attackWeight;
+        winnerLabel = l;
+        modified = true;
+        state = LABELED;
+        }
+      }
+
+    if(nlinks > 0)
+      {
+      if(countSaturatedLinks == nlinks && winnerLabel != unknownLabel)
+        {
+        state = SATURATED;
+        }
+      else if(countLocalSaturatedLinks == nlinks && winnerLabel != unknownLabel)
+        {
+        state = LOCALLY_SATURATED;
+        }
+      else if(state != UNLABELED && !modified)
+        {
+        state = LOCALLY_SATURATED;
+        }
+      }
+
+    update.Label = winnerLabel;
+    update.Weight = winnerWeight;
+    update.State = state;
+    update.MaxSaturation = maxWt;
+    };
+
+  // The first iteration visits all voxels of the region of interest that can still change
+  std::vector< OffsetValueType > activeVoxels;
+  if(!converged)
+    {
+    ImageRegionConstIteratorWithIndex< OutputImageType > stateIt(stateImage, roiRegion);
+    for (stateIt.GoToBegin(); !stateIt.IsAtEnd(); ++stateIt)
+      {
+      if(stateIt.Get() != SATURATED)
+        {
+        activeVoxels.push_back(outputImage->ComputeOffset(stateIt.GetIndex()));
+        }
+      }
+    }
+
+  std::vector< VoxelUpdate > updates;
+  std::vector< unsigned char > modifiedVoxels;
+  std::vector< OffsetValueType > nextActiveVoxels;
+  std::vector< unsigned char > activeMask(bufferedRegion.GetNumberOfPixels(), 0);
+  MultiThreaderBase* multiThreader = this->GetMultiThreader();
+
+  unsigned int iter = 0;
+  while (iter < m_MaxIterations && !activeVoxels.empty())
+    {
+    const SizeValueType numberOfActiveVoxels = activeVoxels.size();
+    updates.resize(numberOfActiveVoxels);
+    modifiedVoxels.resize(numberOfActiveVoxels);
+
+    // Compute all the updates before applying any of them, so that each voxel
+    // of the band sees the values of the previous iteration
+    multiThreader->ParallelizeArray(0, numberOfActiveVoxels,
+      [&](SizeValueType i)
+      {
+      computeUpdate(activeVoxels[i], updates[i]);
+      }, nullptr);
+
+    multiThreader->ParallelizeArray(0, numberOfActiveVoxels,
+      [&](SizeValueType i)
+      {
+      const OffsetValueType p = activeVoxels[i];
+      const VoxelUpdate& update = updates[i];
+      modifiedVoxels[i] = (labels[p] != update.Label || weights[p] != update.Weight ||
+        states[p] != update.State || maxSaturations[p] != update.MaxSaturation) ? 1 : 0;
+      labels[p] = update.Label;
+      weights[p] = update.Weight;
+      states[p] = update.State;
+      maxSaturations[p] = update.MaxSaturation;
+      }, nullptr);
+
+    // Voxels in the neighborhood of the modified voxels form the band of the next iteration
+    nextActiveVoxels.clear();
+    for (SizeValueType i = 0; i < numberOfActiveVoxels; i++)
+      {
+      if(!modifiedVoxels[i])
+        {
+        continue;
+        }
+      const OffsetValueType p = activeVoxels[i];
+      const IndexType index = outputImage->ComputeIndex(p);
+      for (unsigned k = 0; k < numberOfNeighbors; k++)
+        {
+        const OffsetValueType q = p + neighborBufferOffsets[k];
+        if(!roiRegion.IsInside(index + neighborIndexOffsets[k]) || activeMask[q] || states[q] == SATURATED)
+          {
+          continue;
+          }
+        activeMask[q] = 1;
+        nextActiveVoxels.push_back(q);
+        }
+      }
+    for (typename std::vector< OffsetValueType >::const_iterator it = nextActiveVoxels.begin();
+         it != nextActiveVoxels.end(); ++it)
+      {
+      activeMask[*it] = 0;
+      }
+    // Visit the voxels in memory order
+    std::sort(nextActiveVoxels.begin(), nextActiveVoxels.end());
+    activeVoxels.swap(nextActiveVoxels);
+
+    ++iter;
+    this->UpdateProgress(static_cast< float>(iter) / m_MaxIterations);
+    }
+
+  this->CountPixelStates(stateImage);
+
+  this->UpdateProgress(1.0);
+  m_LabelImage = outputImage;
+  this->MaskSegmentedImageByWeight(m_ConfThresh);
+}
+
 template <class TInputImage, class TOutputImage, class TWeightPixelType>
 void
 GrowCutSegmentationImageFilter<TInputImage, TOutputImage, TWeightPixelType>
 ::AfterThreadedGenerateData()
+{
+  typename OutputImageType::Pointer stateImage = OutputImageType::New();
+  stateImage->Graft(static_cast< OutputImageType*>(this->ProcessObject::GetInput(3)) );
+
+  this->CountPixelStates(stateImage);
+}
+
+template <class TInputImage, class TOutputImage, class TWeightPixelType>
+void
+GrowCutSegmentationImageFilter<TInputImage, TOutputImage, TWeightPixelType>
+::CountPixelStates(OutputImageType* stateImage)
 {
   m_Labeled = 0;
   m_LocallySaturated = 0;
   m_Saturated = 0;
 
-  typename OutputImageType::Pointer stateImage = OutputImageType::New();
-  stateImage->Graft(static_cast< OutputImageType*>(this->ProcessObject::GetInput(3)) );
-
   ImageRegionIterator< OutputImageType > state(stateImage, stateImage->GetBufferedRegion());
   ImageRegionIterator< WeightImageType > weight(m_WeightImage, m_WeightImage->GetBufferedRegion());
 
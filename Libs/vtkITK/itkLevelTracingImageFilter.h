@@ -6,6 +6,9 @@
 #include "itkSimpleDataObjectDecorator.h"
 #include "itkChainCodePath.h"
 
+// STD includes
+#include <vector>
+
 namespace itk
 {
 
@@ -24,6 +27,11 @@ namespace itk
  * neighbors.  For ND images, the algorithm traces the boundary using
  * face connected neighbors.
  *
+ * Only the boundary pixels are visited, the traced pixels are available
+ * through GetTracedIndices(). If GenerateOutputImage is disabled then the
+ * output image is not allocated, so that the cost of tracing does not depend
+ * on the image size.
+ *
  */
 
 template <class TInputImage, class TOutputImage>
@@ -83,6 +91,16 @@ public:
   /// Did we move the seed point to put in on a boundary?
   itkGetMacro(MovedSeed, bool);
 
+  /// Allocate the output image and label the traced pixels in it (default: on).
+  /// If disabled, then results are only available in GetTracedIndices()
+  /// and (in 2D) GetPathOutput().
+  itkSetMacro(GenerateOutputImage, bool);
+  itkGetMacro(GenerateOutputImage, bool);
+  itkBooleanMacro(GenerateOutputImage);
+
+  /// Indices of the pixels on the traced level curve/surface
+  const std::vector<IndexType>& GetTracedIndices() const { return m_TracedIndices; }
+
   int GetThreshold();
   InputImagePixelType GetMaxIntensity() {return m_Max;}
   InputImagePixelType GetMinIntensity() {return m_Min;}
@@ -122,6 +140,9 @@ private:
   InputImagePixelType m_Max;
   InputImagePixelType m_Min;
   bool                m_MovedSeed;
+  bool                m_GenerateOutputImage;
+
+  std::vector<IndexType> m_TracedIndices;
 
 };
 
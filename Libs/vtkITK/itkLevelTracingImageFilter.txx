@@ -2,13 +2,15 @@
 #define itkLevelTracingImageFilter_txx
 
 #include "itkLevelTracingImageFilter.h"
-#include "itkFloodFilledImageFunctionConditionalIterator.h"
 #include "itkProgressReporter.h"
 #include "itkConstNeighborhoodIterator.h"
 #include "itkConstantBoundaryCondition.h"
 #include "itkImageFunction.h"
 #include "itkNumericTraits.h"
 
+// STD includes
+#include <unordered_set>
+
 namespace itk
 {
 
@@ -170,6 +172,7 @@ LevelTracingImageFilter<TInputImage, TOutputImage>
 {
   m_Seed.Fill(0);
   m_MovedSeed = false;
+  m_GenerateOutputImage = true;
   m_Min = 0;
   m_Max = 0;
 
@@ -216,6 +219,8 @@ LevelTracingImageFilter<TInputImage, TOutputImage>
   this->Superclass::PrintSelf(os, indent);
   os << indent << "Seed point location: " << m_Seed
      << std::endl;
+  os << indent << "GenerateOutputImage: " << m_GenerateOutputImage
+     << std::endl;
 }
 
 template <class TInputImage, class TOutputImage>
@@ -245,6 +250,22 @@ void
 LevelTracingImageFilter<TInputImage,TOutputImage>
 ::GenerateData()
 {
+  m_TracedIndices.clear();
+
+  OutputImagePointer outputImage = this->GetOutput();
+  if (m_GenerateOutputImage)
+    {
+    // Zero the output
+    outputImage->SetBufferedRegion( outputImage->GetRequestedRegion() );
+    outputImage->Allocate();
+    outputImage->FillBuffer ( NumericTraits<OutputImagePixelType>::ZeroValue() );
+    }
+  else
+    {
+    // Leave the output empty, tracing only visits pixels near the seed
+    outputImage->SetBufferedRegion( OutputImageRegionType() );
+    }
+
   // Delegate to either a version specialized for dimension or a
   // general N-dimensional version
   if (this->GetInput()->GetRequestedRegion().IsInside( m_Seed ))
@@ -283,12 +304,6 @@ LevelTracingImageFilter<TInputImage,TOutputImage>
   // We may move the seed point to the boundary if it is off by a pixel
   m_MovedSeed = false;
 
-  // Zero the output
-  OutputImageRegionType regionOut =  outputImage->GetRequestedRegion();
-  outputImage->SetBufferedRegion( regionOut );
-  outputImage->Allocate();
-  outputImage->FillBuffer ( NumericTraits<OutputImagePixelType>::ZeroValue() );
-
   outputPath->Initialize();
 
   //
@@ -401,7 +416,11 @@ LevelTracingImageFilter<TInputImage,TOutputImage>
 
   // Now we have the seed and the starting neighbor
   outputPath->SetStart(seed);
-  outputImage->SetPixel(pix, NumericTraits<OutputImagePixelType>::OneValue());
+  m_TracedIndices.push_back(pix);
+  if (m_GenerateOutputImage)
+    {
+    outputImage->SetPixel(pix, NumericTraits<OutputImagePixelType>::OneValue());
+    }
   do
     {
     for(int s = 0; s<8; s++)
@@ -416,8 +435,15 @@ LevelTracingImageFilter<TInputImage,TOutputImage>
         if (val >= threshold)
           {
           //condition is satisfied, label the output image and output path
-          outputImage->SetPixel(pixTemp,
-                                NumericTraits<OutputImagePixelType>::OneValue());
+          if (m_GenerateOutputImage)
+            {
+            outputImage->SetPixel(pixTemp,
+                                  NumericTraits<OutputImagePixelType>::OneValue());
+            }
+          if (pixTemp != seed)
+            {
+            m_TracedIndices.push_back(pixTemp);
+            }
           offset[0]=offsetX;
           offset[1]=offsetY;
           outputPath->InsertStep(noOfPixels, offset);
@@ -459,29 +485,57 @@ LevelTracingImageFilter<TInputImage,TOutputImage>
 
   InputImagePixelType threshold = inputImage->GetPixel(m_Seed);
 
-  // Zero the output
-  OutputImageRegionType region =  outputImage->GetRequestedRegion();
-  outputImage->SetBufferedRegion( region );
-  outputImage->Allocate();
-  outputImage->FillBuffer ( NumericTraits<OutputImagePixelType>::ZeroValue() );
-
   typedef LevelTracingImageFunction<InputImageType, double> FunctionType;
-  typedef FloodFilledImageFunctionConditionalIterator<OutputImageType, FunctionType> IteratorType;
-
   typename FunctionType::Pointer function = FunctionType::New();
   function->SetInputImage ( inputImage );
   function->SetThreshold( threshold );
 
-  ProgressReporter progress(this, 0, region.GetNumberOfPixels());
+  if (!function->EvaluateAtIndex(m_Seed))
+    {
+    // not near a boundary, no boundary to trace
+    return;
+    }
 
-  IteratorType it ( outputImage, function, m_Seed );
-  it.GoToBegin();
+  // Flood fill the face connected boundary pixels. Visited pixels are
+  // stored by their buffer offset, so memory usage is proportional to
+  // the size of the traced surface instead of the size of the image.
+  const InputImageRegionType region = inputImage->GetBufferedRegion();
+  std::unordered_set<OffsetValueType> visited;
+  std::vector<IndexType> front;
+  visited.insert(inputImage->ComputeOffset(m_Seed));
+  front.push_back(m_Seed);
 
-  while( !it.IsAtEnd())
+  while (!front.empty())
     {
-    it.Set(NumericTraits<OutputImagePixelType>::OneValue());
-    ++it;
-    progress.CompletedPixel();  // potential exception thrown here
+    IndexType index = front.back();
+    front.pop_back();
+    m_TracedIndices.push_back(index);
+    if (m_GenerateOutputImage)
+      {
+      outputImage->SetPixel(index, NumericTraits<OutputImagePixelType>::OneValue());
+      }
+
+    for (unsigned int dim = 0; dim < ImageDimension; ++dim)
+      {
+      for (int direction = -1; direction <= 1; direction += 2)
+        {
+        IndexType neighbor = index;
+        neighbor[dim] += direction;
+        if (!region.IsInside(neighbor))
+          {
+          continue;
+          }
+        if (!visited.insert(inputImage->ComputeOffset(neighbor)).second)
+          {
+          // already visited
+          continue;
+          }
+        if (function->EvaluateAtIndex(neighbor))
+          {
+          front.push_back(neighbor);
+          }
+        }
+      }
     }
 }
 
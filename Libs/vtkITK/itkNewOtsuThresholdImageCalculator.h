@@ -6,6 +6,9 @@
 #include "itkObjectFactory.h"
 #include "itkNumericTraits.h"
 
+// STD includes
+#include <vector>
+
 namespace itk
 {
 
@@ -19,6 +22,10 @@ namespace itk
  *
  * This class is templated over the input image type.
  *
+ * The histogram is computed in parallel and it is kept until the image
+ * or the number of histogram bins changes, therefore calling Compute()
+ * again with a different Omega does not process the image.
+ *
  * \warning This method assumes that the input image consists of scalar pixel
  * types.
  *
@@ -78,11 +85,23 @@ private:
   NewOtsuThresholdImageCalculator(const Self&) = delete;
   void operator=(const Self&) = delete;
 
+  /** Compute image range and histogram, if not computed yet for the current
+   * image and number of bins. */
+  void ComputeHistogram();
+
   PixelType            m_Threshold;
   unsigned long        m_NumberOfHistogramBins;
   double               m_Omega;
   ImageConstPointer    m_Image;
 
+  /** Cached histogram, with relative frequencies */
+  std::vector<double>  m_RelativeFrequency;
+  PixelType            m_ImageMinimum;
+  PixelType            m_ImageMaximum;
+  const ImageType*     m_HistogramImage;
+  ModifiedTimeType     m_HistogramImageMTime;
+  unsigned long        m_HistogramNumberOfBins;
+
 };
 
 } /// end namespace itk
@@ -18,11 +18,15 @@
 #define itkNewOtsuThresholdImageCalculator_txx
 
 #include "itkNewOtsuThresholdImageCalculator.h"
-#include "itkImageRegionConstIteratorWithIndex.h"
-#include "itkMinimumMaximumImageCalculator.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkMultiThreaderBase.h"
 
 #include "math.h"
 
+// STD includes
+#include <algorithm>
+#include <mutex>
+
 namespace itk
 {
 
@@ -37,6 +41,103 @@ NewOtsuThresholdImageCalculator<TInputImage>
   m_Threshold = NumericTraits<PixelType>::ZeroValue();
   m_NumberOfHistogramBins = 128;
   m_Omega = 2;
+  m_ImageMinimum = NumericTraits<PixelType>::ZeroValue();
+  m_ImageMaximum = NumericTraits<PixelType>::ZeroValue();
+  m_HistogramImage = nullptr;
+  m_HistogramImageMTime = 0;
+  m_HistogramNumberOfBins = 0;
+}
+
+/*
+ * Compute the image range and the histogram
+ */
+template <class TInputImage>
+void NewOtsuThresholdImageCalculator<TInputImage>::ComputeHistogram()
+{
+  if ( m_HistogramImage == m_Image.GetPointer()
+    && m_HistogramImageMTime == m_Image->GetMTime()
+    && m_HistogramNumberOfBins == m_NumberOfHistogramBins )
+    {
+    return;
+    }
+  m_HistogramImage = m_Image.GetPointer();
+  m_HistogramImageMTime = m_Image->GetMTime();
+  m_HistogramNumberOfBins = m_NumberOfHistogramBins;
+
+  typedef typename ImageType::RegionType RegionType;
+  typedef ImageRegionConstIterator<TInputImage> Iterator;
+  const RegionType& bufferedRegion = m_Image->GetBufferedRegion();
+  MultiThreaderBase::Pointer multiThreader = MultiThreaderBase::New();
+  std::mutex mutex;
+
+  // compute image max and min
+  PixelType imageMin = NumericTraits<PixelType>::max();
+  PixelType imageMax = NumericTraits<PixelType>::NonpositiveMin();
+  multiThreader->ParallelizeImageRegion<ImageType::ImageDimension>( bufferedRegion,
+    [&](const RegionType& region)
+    {
+    PixelType regionMin = NumericTraits<PixelType>::max();
+    PixelType regionMax = NumericTraits<PixelType>::NonpositiveMin();
+    for ( Iterator iter( m_Image, region ); !iter.IsAtEnd(); ++iter )
+      {
+      const PixelType value = iter.Get();
+      regionMin = std::min( regionMin, value );
+      regionMax = std::max( regionMax, value );
+      }
+    std::lock_guard<std::mutex> lock( mutex );
+    imageMin = std::min( imageMin, regionMin );
+    imageMax = std::max( imageMax, regionMax );
+    }, nullptr );
+
+  m_ImageMinimum = imageMin;
+  m_ImageMaximum = imageMax;
+  m_RelativeFrequency.assign( m_NumberOfHistogramBins, 0.0 );
+  if ( imageMin >= imageMax )
+    {
+    return;
+    }
+
+  // create a histogram
+  const double binMultiplier = (double) m_NumberOfHistogramBins /
+    (double) ( imageMax - imageMin );
+  const unsigned long numberOfHistogramBins = m_NumberOfHistogramBins;
+  multiThreader->ParallelizeImageRegion<ImageType::ImageDimension>( bufferedRegion,
+    [&](const RegionType& region)
+    {
+    std::vector<SizeValueType> regionFrequency( numberOfHistogramBins, 0 );
+    for ( Iterator iter( m_Image, region ); !iter.IsAtEnd(); ++iter )
+      {
+      unsigned long binNumber;
+      const PixelType value = iter.Get();
+
+      if ( value == imageMin )
+        {
+        binNumber = 0;
+        }
+      else
+        {
+        binNumber = (unsigned long) ceil( (value - imageMin) * binMultiplier ) - 1;
+        if ( binNumber == numberOfHistogramBins ) // in case of rounding errors
+          {
+          binNumber -= 1;
+          }
+        }
+
+      regionFrequency[binNumber] += 1;
+      }
+    std::lock_guard<std::mutex> lock( mutex );
+    for ( unsigned long j = 0; j < numberOfHistogramBins; j++ )
+      {
+      m_RelativeFrequency[j] += (double) regionFrequency[j];
+      }
+    }, nullptr );
+
+  // normalize the frequencies
+  const double totalPixels = (double) bufferedRegion.GetNumberOfPixels();
+  for ( unsigned long j = 0; j < m_NumberOfHistogramBins; j++ )
+    {
+    m_RelativeFrequency[j] /= totalPixels;
+    }
 }
 
 
@@ -54,15 +155,10 @@ void NewOtsuThresholdImageCalculator<TInputImage>::Compute()
   double totalPixels = (double) m_Image->GetBufferedRegion().GetNumberOfPixels();
   if ( totalPixels == 0 ) { return; }
 
+  this->ComputeHistogram();
 
-  // compute image max and min
-  typedef MinimumMaximumImageCalculator<TInputImage> RangeCalculator;
-  typename RangeCalculator::Pointer rangeCalculator = RangeCalculator::New();
-  rangeCalculator->SetImage( m_Image );
-  rangeCalculator->Compute();
-
-  PixelType imageMin = rangeCalculator->GetMinimum();
-  PixelType imageMax = rangeCalculator->GetMaximum();
+  PixelType imageMin = m_ImageMinimum;
+  PixelType imageMax = m_ImageMaximum;
 
   if ( imageMin >= imageMax )
     {
@@ -70,52 +166,16 @@ void NewOtsuThresholdImageCalculator<TInputImage>::Compute()
     return;
     }
 
-  // create a histogram
-  std::vector<double> relativeFrequency;
-  relativeFrequency.resize( m_NumberOfHistogramBins );
-  for ( j = 0; j < m_NumberOfHistogramBins; j++ )
-    {
-    relativeFrequency[j] = 0.0;
-    }
-
+  const std::vector<double>& relativeFrequency = m_RelativeFrequency;
   double binMultiplier = (double) m_NumberOfHistogramBins /
     (double) ( imageMax - imageMin );
 
-  typedef ImageRegionConstIteratorWithIndex<TInputImage> Iterator;
-  Iterator iter( m_Image, m_Image->GetBufferedRegion() );
-
-  while ( !iter.IsAtEnd() )
-    {
-    unsigned int binNumber;
-    PixelType value = iter.Get();
-
-    if ( value == imageMin )
-      {
-      binNumber = 0;
-      }
-    else
-      {
-      binNumber = (unsigned int) ceil( (value - imageMin) * binMultiplier ) - 1;
-      if ( binNumber == m_NumberOfHistogramBins ) // in case of rounding errors
-        {
-        binNumber -= 1;
-        }
-      }
-
-    relativeFrequency[binNumber] += 1.0;
-    ++iter;
-
-    }
-
-  // normalize the frequencies
   double totalMean = 0.0;
   for ( j = 0; j < m_NumberOfHistogramBins; j++ )
     {
-    relativeFrequency[j] /= totalPixels;
     totalMean += (j+1) * relativeFrequency[j];
     }
 
-
   // compute Otsu's threshold by maximizing the between-class
   // variance
   double freqLeft = relativeFrequency[0];
@@ -0,0 +1,110 @@
+#ifndef itkSlidingWindowImageFilter_h
+#define itkSlidingWindowImageFilter_h
+
+#include "itkBoxImageFilter.h"
+
+// STD includes
+#include <algorithm>
+#include <vector>
+
+namespace itk
+{
+
+/** \class SlidingWindowImageFilter
+ * \brief Base class for filters that compute the output of a voxel from the
+ * rectangular neighborhood of the voxel, updating the result of the previous
+ * voxel of the row with the neighborhood column that leaves and the one that enters.
+ *
+ * Neighborhoods are extended by the nearest voxels at the boundaries of the image
+ * (as with ZeroFluxNeumannBoundaryCondition, the default of neighborhood iterators).
+ * Subclasses access the voxels of a neighborhood column through the buffer offsets
+ * of the neighborhood rows (ComputeRowOffsets) and the column offset (GetColumnOffset).
+ *
+ * \ingroup ImageFilters Multithreaded
+ */
+template <class TInputImage, class TOutputImage>
+class SlidingWindowImageFilter : public BoxImageFilter<TInputImage, TOutputImage>
+{
+public:
+  /** Standard class typedefs. */
+  typedef SlidingWindowImageFilter                  Self;
+  typedef BoxImageFilter<TInputImage, TOutputImage> Superclass;
+  typedef SmartPointer<Self>                        Pointer;
+  typedef SmartPointer<const Self>                  ConstPointer;
+
+  /** Runtime information support. */
+  itkTypeMacro(SlidingWindowImageFilter, BoxImageFilter);
+
+  typedef TInputImage                       InputImageType;
+  typedef TOutputImage                      OutputImageType;
+  typedef typename TInputImage::PixelType   InputPixelType;
+  typedef typename TOutputImage::PixelType  OutputPixelType;
+  typedef typename TInputImage::IndexType   InputIndexType;
+  typedef typename TOutputImage::RegionType OutputImageRegionType;
+
+protected:
+  SlidingWindowImageFilter()
+    {
+    this->DynamicMultiThreadingOn();
+    }
+  ~SlidingWindowImageFilter() override = default;
+
+  /** Buffer offsets of the neighborhood rows of the voxel at index. The rows start at the
+   * first buffered voxel along the first axis, indices are clamped to the buffered region. */
+  void ComputeRowOffsets(const InputIndexType& index, std::vector<OffsetValueType>& rowOffsets) const
+    {
+    const InputImageType* input = this->GetInput();
+    const typename InputImageType::RegionType bufferedRegion = input->GetBufferedRegion();
+    const typename Superclass::RadiusType radius = this->GetRadius();
+    const unsigned int dimension = InputImageType::ImageDimension;
+
+    rowOffsets.clear();
+    InputIndexType rowIndex = index;
+    rowIndex[0] = bufferedRegion.GetIndex(0);
+    typename InputImageType::OffsetType offset;
+    offset.Fill(0);
+    for (unsigned int d = 1; d < dimension; ++d)
+      {
+      offset[d] = -static_cast<OffsetValueType>(radius[d]);
+      }
+    while (true)
+      {
+      for (unsigned int d = 1; d < dimension; ++d)
+        {
+        const IndexValueType first = bufferedRegion.GetIndex(d);
+        const IndexValueType last = first + static_cast<IndexValueType>(bufferedRegion.GetSize(d)) - 1;
+        rowIndex[d] = std::min(std::max(index[d] + offset[d], first), last);
+        }
+      rowOffsets.push_back(input->ComputeOffset(rowIndex));
+
+      unsigned int d = 1;
+      while (d < dimension && offset[d] == static_cast<OffsetValueType>(radius[d]))
+        {
+        offset[d] = -static_cast<OffsetValueType>(radius[d]);
+        ++d;
+        }
+      if (d == dimension)
+        {
+        break;
+        }
+      ++offset[d];
+      }
+    }
+
+  /** Offset of the voxel of a row at position x along the first axis, clamped to the buffered region */
+  OffsetValueType GetColumnOffset(IndexValueType x) const
+    {
+    const typename InputImageType::RegionType& bufferedRegion = this->GetInput()->GetBufferedRegion();
+    const IndexValueType first = bufferedRegion.GetIndex(0);
+    const IndexValueType last = first + static_cast<IndexValueType>(bufferedRegion.GetSize(0)) - 1;
+    return std::min(std::max(x, first), last) - first;
+    }
+
+private:
+  SlidingWindowImageFilter(const Self&) = delete;
+  void operator=(const Self&) = delete;
+};
+
+} // end namespace itk
+
+#endif
@@ -0,0 +1,90 @@
+#ifndef itkSlidingWindowMedianImageFilter_h
+#define itkSlidingWindowMedianImageFilter_h
+
+#include "itkSlidingWindowImageFilter.h"
+
+namespace itk
+{
+
+/** \class SlidingWindowMedianImageFilter
+ * \brief Computes the median of the rectangular neighborhood of each voxel
+ * by updating a histogram while the neighborhood slides along the rows.
+ *
+ * The output is the same as the output of MedianImageFilter (the neighborhood
+ * is extended by the nearest voxels at the boundaries of the image), but the cost
+ * of a voxel does not depend on the neighborhood size along the first axis:
+ * when moving to the next voxel of a row, only the voxels of the leaving and the
+ * entering neighborhood column are removed from and added to the histogram,
+ * and the median is found by moving from the median of the previous voxel
+ * (Huang, Yang, Tang: A fast two-dimensional median filtering algorithm, 1979).
+ *
+ * The histogram is used for integer pixel types if the range of the input values
+ * fits in MaximumNumberOfBins bins. Otherwise (e.g., for floating point images)
+ * the median of each neighborhood is selected by partial sorting.
+ *
+ * The median of a binary image is the value of the majority of the voxels of
+ * the neighborhood, therefore this filter can be used for smoothing labelmaps by voting.
+ *
+ * \ingroup IntensityImageFilters Multithreaded
+ */
+template <class TInputImage, class TOutputImage>
+class SlidingWindowMedianImageFilter : public SlidingWindowImageFilter<TInputImage, TOutputImage>
+{
+public:
+  /** Standard class typedefs. */
+  typedef SlidingWindowMedianImageFilter                      Self;
+  typedef SlidingWindowImageFilter<TInputImage, TOutputImage> Superclass;
+  typedef SmartPointer<Self>                                  Pointer;
+  typedef SmartPointer<const Self>                            ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Runtime information support. */
+  itkTypeMacro(SlidingWindowMedianImageFilter, SlidingWindowImageFilter);
+
+  typedef typename Superclass::InputImageType        InputImageType;
+  typedef typename Superclass::OutputImageType       OutputImageType;
+  typedef typename Superclass::InputPixelType        InputPixelType;
+  typedef typename Superclass::OutputPixelType       OutputPixelType;
+  typedef typename Superclass::OutputImageRegionType OutputImageRegionType;
+
+  /** Maximum number of histogram bins (range of input values) for using the histogram.
+   * Default is 65536, which allows using the histogram for any 8 or 16 bit image. */
+  itkSetMacro(MaximumNumberOfBins, SizeValueType);
+  itkGetConstMacro(MaximumNumberOfBins, SizeValueType);
+
+  /** Returns true if the last update used the histogram */
+  itkGetConstMacro(HistogramUsed, bool);
+
+protected:
+  SlidingWindowMedianImageFilter();
+  ~SlidingWindowMedianImageFilter() override = default;
+
+  void PrintSelf(std::ostream& os, Indent indent) const override;
+
+  void BeforeThreadedGenerateData() override;
+  void DynamicThreadedGenerateData(const OutputImageRegionType& outputRegionForThread) override;
+
+  void HistogramThreadedGenerateData(const OutputImageRegionType& outputRegionForThread);
+  void SortThreadedGenerateData(const OutputImageRegionType& outputRegionForThread);
+
+private:
+  SlidingWindowMedianImageFilter(const Self&) = delete;
+  void operator=(const Self&) = delete;
+
+  SizeValueType m_MaximumNumberOfBins;
+
+  /** Set up by BeforeThreadedGenerateData */
+  bool           m_HistogramUsed;
+  InputPixelType m_HistogramMinimum;
+  SizeValueType  m_NumberOfBins;
+};
+
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkSlidingWindowMedianImageFilter.txx"
+#endif
+
+#endif
@@ -0,0 +1,211 @@
+#ifndef itkSlidingWindowMedianImageFilter_txx
+#define itkSlidingWindowMedianImageFilter_txx
+
+#include "itkSlidingWindowMedianImageFilter.h"
+
+#include "itkImageScanlineIterator.h"
+
+// STD includes
+#include <algorithm>
+#include <limits>
+
+namespace itk
+{
+
+//----------------------------------------------------------------------------
+template <class TInputImage, class TOutputImage>
+SlidingWindowMedianImageFilter<TInputImage, TOutputImage>::SlidingWindowMedianImageFilter()
+  : m_MaximumNumberOfBins(65536)
+  , m_HistogramUsed(false)
+  , m_HistogramMinimum(0)
+  , m_NumberOfBins(0)
+{
+}
+
+//----------------------------------------------------------------------------
+template <class TInputImage, class TOutputImage>
+void SlidingWindowMedianImageFilter<TInputImage, TOutputImage>::BeforeThreadedGenerateData()
+{
+  m_HistogramUsed = false;
+  m_HistogramMinimum = 0;
+  m_NumberOfBins = 0;
+  if (!std::numeric_limits<InputPixelType>::is_integer)
+    {
+    return;
+    }
+
+  // The requested region of the input (the output region padded by the radius) is buffered
+  const InputImageType* input = this->GetInput();
+  const InputPixelType* buffer = input->GetBufferPointer();
+  const SizeValueType numberOfPixels = input->GetBufferedRegion().GetNumberOfPixels();
+  if (numberOfPixels == 0)
+    {
+    return;
+    }
+  std::pair<const InputPixelType*, const InputPixelType*> range =
+    std::minmax_element(buffer, buffer + numberOfPixels);
+  const double numberOfBins = static_cast<double>(*range.second) - static_cast<double>(*range.first) + 1.0;
+  if (numberOfBins > static_cast<double>(m_MaximumNumberOfBins))
+    {
+    return;
+    }
+  m_HistogramUsed = true;
+  m_HistogramMinimum = *range.first;
+  m_NumberOfBins = static_cast<SizeValueType>(numberOfBins);
+}
+
+//----------------------------------------------------------------------------
+template <class TInputImage, class TOutputImage>
+void SlidingWindowMedianImageFilter<TInputImage, TOutputImage>::DynamicThreadedGenerateData(
+  const OutputImageRegionType& outputRegionForThread)
+{
+  if (m_HistogramUsed)
+    {
+    this->HistogramThreadedGenerateData(outputRegionForThread);
+    }
+  else
+    {
+    this->SortThreadedGenerateData(outputRegionForThread);
+    }
+}
+
+//----------------------------------------------------------------------------
+template <class TInputImage, class TOutputImage>
+void SlidingWindowMedianImageFilter<TInputImage, TOutputImage>::HistogramThreadedGenerateData(
+  const OutputImageRegionType& outputRegionForThread)
+{
+  const InputImageType* input = this->GetInput();
+  OutputImageType* output = this->GetOutput();
+  const InputPixelType* buffer = input->GetBufferPointer();
+  const IndexValueType radius = static_cast<IndexValueType>(this->GetRadius()[0]);
+  const InputPixelType histogramMinimum = m_HistogramMinimum;
+
+  std::vector<OffsetValueType> rowOffsets;
+  std::vector<SizeValueType> histogram(m_NumberOfBins, 0);
+  // Samples below the median bin are counted, so that the median bin can be
+  // found by moving from the median bin of the previous voxel
+  SizeValueType medianBin = 0;
+  SizeValueType numberOfSamplesBelowMedianBin = 0;
+  SizeValueType medianRank = 0;
+
+  auto addColumn = [&](IndexValueType x)
+    {
+    const OffsetValueType column = this->GetColumnOffset(x);
+    for (OffsetValueType rowOffset : rowOffsets)
+      {
+      const SizeValueType bin = static_cast<SizeValueType>(buffer[rowOffset + column] - histogramMinimum);
+      ++histogram[bin];
+      if (bin < medianBin)
+        {
+        ++numberOfSamplesBelowMedianBin;
+        }
+      }
+    };
+  auto removeColumn = [&](IndexValueType x)
+    {
+    const OffsetValueType column = this->GetColumnOffset(x);
+    for (OffsetValueType rowOffset : rowOffsets)
+      {
+      const SizeValueType bin = static_cast<SizeValueType>(buffer[rowOffset + column] - histogramMinimum);
+      --histogram[bin];
+      if (bin < medianBin)
+        {
+        --numberOfSamplesBelowMedianBin;
+        }
+      }
+    };
+
+  ImageScanlineIterator<OutputImageType> outputIt(output, outputRegionForThread);
+  while (!outputIt.IsAtEnd())
+    {
+    this->ComputeRowOffsets(outputIt.GetIndex(), rowOffsets);
+    // Same selected element as in MedianImageFilter
+    medianRank = (rowOffsets.size() * (2 * radius + 1)) / 2;
+
+    IndexValueType x = outputIt.GetIndex()[0];
+    for (IndexValueType dx = -radius; dx <= radius; ++dx)
+      {
+      addColumn(x + dx);
+      }
+    while (true)
+      {
+      while (numberOfSamplesBelowMedianBin > medianRank)
+        {
+        --medianBin;
+        numberOfSamplesBelowMedianBin -= histogram[medianBin];
+        }
+      while (numberOfSamplesBelowMedianBin + histogram[medianBin] <= medianRank)
+        {
+        numberOfSamplesBelowMedianBin += histogram[medianBin];
+        ++medianBin;
+        }
+      outputIt.Set(static_cast<OutputPixelType>(static_cast<InputPixelType>(histogramMinimum + medianBin)));
+      ++outputIt;
+      if (outputIt.IsAtEndOfLine())
+        {
+        break;
+        }
+      removeColumn(x - radius);
+      addColumn(x + radius + 1);
+      ++x;
+      }
+    // Empty the histogram for the next row (the median bin is kept as starting point)
+    for (IndexValueType dx = -radius; dx <= radius; ++dx)
+      {
+      removeColumn(x + dx);
+      }
+    outputIt.NextLine();
+    }
+}
+
+//----------------------------------------------------------------------------
+template <class TInputImage, class TOutputImage>
+void SlidingWindowMedianImageFilter<TInputImage, TOutputImage>::SortThreadedGenerateData(
+  const OutputImageRegionType& outputRegionForThread)
+{
+  const InputImageType* input = this->GetInput();
+  OutputImageType* output = this->GetOutput();
+  const InputPixelType* buffer = input->GetBufferPointer();
+  const IndexValueType radius = static_cast<IndexValueType>(this->GetRadius()[0]);
+
+  std::vector<OffsetValueType> rowOffsets;
+  std::vector<InputPixelType> values;
+
+  ImageScanlineIterator<OutputImageType> outputIt(output, outputRegionForThread);
+  while (!outputIt.IsAtEnd())
+    {
+    this->ComputeRowOffsets(outputIt.GetIndex(), rowOffsets);
+    values.resize(rowOffsets.size() * (2 * radius + 1));
+    const typename std::vector<InputPixelType>::iterator medianIt = values.begin() + values.size() / 2;
+
+    IndexValueType x = outputIt.GetIndex()[0];
+    for (; !outputIt.IsAtEndOfLine(); ++outputIt, ++x)
+      {
+      typename std::vector<InputPixelType>::iterator valueIt = values.begin();
+      for (IndexValueType dx = -radius; dx <= radius; ++dx)
+        {
+        const OffsetValueType column = this->GetColumnOffset(x + dx);
+        for (OffsetValueType rowOffset : rowOffsets)
+          {
+          *valueIt++ = buffer[rowOffset + column];
+          }
+        }
+      std::nth_element(values.begin(), medianIt, values.end());
+      outputIt.Set(static_cast<OutputPixelType>(*medianIt));
+      }
+    outputIt.NextLine();
+    }
+}
+
+//----------------------------------------------------------------------------
+template <class TInputImage, class TOutputImage>
+void SlidingWindowMedianImageFilter<TInputImage, TOutputImage>::PrintSelf(std::ostream& os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+  os << indent << "MaximumNumberOfBins: " << m_MaximumNumberOfBins << std::endl;
+  os << indent << "HistogramUsed: " << m_HistogramUsed << std::endl;
+}
+
+} // end namespace itk
+
+#endif
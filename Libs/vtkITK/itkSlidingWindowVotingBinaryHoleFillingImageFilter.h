@@ -0,0 +1,93 @@
+#ifndef itkSlidingWindowVotingBinaryHoleFillingImageFilter_h
+#define itkSlidingWindowVotingBinaryHoleFillingImageFilter_h
+
+#include "itkSlidingWindowImageFilter.h"
+
+// STD includes
+#include <atomic>
+
+namespace itk
+{
+
+/** \class SlidingWindowVotingBinaryHoleFillingImageFilter
+ * \brief Fills in holes and cavities by a voting operation on each background voxel,
+ * counting the foreground voxels of the neighborhood while it slides along the rows.
+ *
+ * The output is the same as the output of VotingBinaryHoleFillingImageFilter:
+ * a background voxel becomes foreground if the number of foreground voxels in
+ * its neighborhood is at least half of the neighborhood size (excluding the voxel)
+ * plus MajorityThreshold, other voxels are not modified. The neighborhood is extended
+ * by the nearest voxels at the boundaries of the image.
+ *
+ * The foreground voxels of each neighborhood column are counted once per row position,
+ * therefore the cost of a voxel does not depend on the neighborhood size along the first axis.
+ *
+ * \ingroup ImageFilters Multithreaded
+ */
+template <class TInputImage, class TOutputImage>
+class SlidingWindowVotingBinaryHoleFillingImageFilter : public SlidingWindowImageFilter<TInputImage, TOutputImage>
+{
+public:
+  /** Standard class typedefs. */
+  typedef SlidingWindowVotingBinaryHoleFillingImageFilter     Self;
+  typedef SlidingWindowImageFilter<TInputImage, TOutputImage> Superclass;
+  typedef SmartPointer<Self>                                  Pointer;
+  typedef SmartPointer<const Self>                            ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Runtime information support. */
+  itkTypeMacro(SlidingWindowVotingBinaryHoleFillingImageFilter, SlidingWindowImageFilter);
+
+  typedef typename Superclass::InputImageType        InputImageType;
+  typedef typename Superclass::OutputImageType       OutputImageType;
+  typedef typename Superclass::InputPixelType        InputPixelType;
+  typedef typename Superclass::OutputPixelType       OutputPixelType;
+  typedef typename Superclass::OutputImageRegionType OutputImageRegionType;
+
+  /** Value of the foreground voxels. Default is the maximum of the input pixel type. */
+  itkSetMacro(ForegroundValue, InputPixelType);
+  itkGetConstMacro(ForegroundValue, InputPixelType);
+
+  /** Value of the background voxels. Default is 0. */
+  itkSetMacro(BackgroundValue, InputPixelType);
+  itkGetConstMacro(BackgroundValue, InputPixelType);
+
+  /** Number of foreground voxels over 50% of the neighborhood that makes a
+   * background voxel foreground. Default is 1. */
+  itkSetMacro(MajorityThreshold, unsigned int);
+  itkGetConstMacro(MajorityThreshold, unsigned int);
+
+  /** Number of voxels that were changed from background to foreground by the last update */
+  SizeValueType GetNumberOfPixelsChanged() const;
+
+protected:
+  SlidingWindowVotingBinaryHoleFillingImageFilter();
+  ~SlidingWindowVotingBinaryHoleFillingImageFilter() override = default;
+
+  void PrintSelf(std::ostream& os, Indent indent) const override;
+
+  void BeforeThreadedGenerateData() override;
+  void DynamicThreadedGenerateData(const OutputImageRegionType& outputRegionForThread) override;
+
+private:
+  SlidingWindowVotingBinaryHoleFillingImageFilter(const Self&) = delete;
+  void operator=(const Self&) = delete;
+
+  InputPixelType m_ForegroundValue;
+  InputPixelType m_BackgroundValue;
+  unsigned int   m_MajorityThreshold;
+
+  /** Set up by BeforeThreadedGenerateData */
+  SizeValueType m_BirthThreshold;
+  std::atomic<SizeValueType> m_NumberOfPixelsChanged;
+};
+
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkSlidingWindowVotingBinaryHoleFillingImageFilter.txx"
+#endif
+
+#endif
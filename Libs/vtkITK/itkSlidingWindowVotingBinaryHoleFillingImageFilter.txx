@@ -0,0 +1,127 @@
+#ifndef itkSlidingWindowVotingBinaryHoleFillingImageFilter_txx
+#define itkSlidingWindowVotingBinaryHoleFillingImageFilter_txx
+
+#include "itkSlidingWindowVotingBinaryHoleFillingImageFilter.h"
+
+#include "itkImageScanlineIterator.h"
+#include "itkNumericTraits.h"
+
+namespace itk
+{
+
+//----------------------------------------------------------------------------
+template <class TInputImage, class TOutputImage>
+SlidingWindowVotingBinaryHoleFillingImageFilter<TInputImage, TOutputImage>::SlidingWindowVotingBinaryHoleFillingImageFilter()
+  : m_ForegroundValue(NumericTraits<InputPixelType>::max())
+  , m_BackgroundValue(NumericTraits<InputPixelType>::ZeroValue())
+  , m_MajorityThreshold(1)
+  , m_BirthThreshold(0)
+  , m_NumberOfPixelsChanged(0)
+{
+}
+
+//----------------------------------------------------------------------------
+template <class TInputImage, class TOutputImage>
+SizeValueType SlidingWindowVotingBinaryHoleFillingImageFilter<TInputImage, TOutputImage>::GetNumberOfPixelsChanged() const
+{
+  return m_NumberOfPixelsChanged;
+}
+
+//----------------------------------------------------------------------------
+template <class TInputImage, class TOutputImage>
+void SlidingWindowVotingBinaryHoleFillingImageFilter<TInputImage, TOutputImage>::BeforeThreadedGenerateData()
+{
+  SizeValueType neighborhoodSize = 1;
+  for (unsigned int d = 0; d < InputImageType::ImageDimension; ++d)
+    {
+    neighborhoodSize *= 2 * this->GetRadius()[d] + 1;
+    }
+  // Same threshold as in VotingBinaryHoleFillingImageFilter
+  m_BirthThreshold = (neighborhoodSize - 1) / 2 + m_MajorityThreshold;
+  m_NumberOfPixelsChanged = 0;
+}
+
+//----------------------------------------------------------------------------
+template <class TInputImage, class TOutputImage>
+void SlidingWindowVotingBinaryHoleFillingImageFilter<TInputImage, TOutputImage>::DynamicThreadedGenerateData(
+  const OutputImageRegionType& outputRegionForThread)
+{
+  const InputImageType* input = this->GetInput();
+  OutputImageType* output = this->GetOutput();
+  const InputPixelType* buffer = input->GetBufferPointer();
+  const IndexValueType radius = static_cast<IndexValueType>(this->GetRadius()[0]);
+  const InputPixelType foregroundValue = m_ForegroundValue;
+  const InputPixelType backgroundValue = m_BackgroundValue;
+
+  std::vector<OffsetValueType> rowOffsets;
+  auto countColumn = [&](IndexValueType x)
+    {
+    const OffsetValueType column = this->GetColumnOffset(x);
+    SizeValueType count = 0;
+    for (OffsetValueType rowOffset : rowOffsets)
+      {
+      if (buffer[rowOffset + column] == foregroundValue)
+        {
+        ++count;
+        }
+      }
+    return count;
+    };
+
+  SizeValueType numberOfPixelsChanged = 0;
+  ImageScanlineIterator<OutputImageType> outputIt(output, outputRegionForThread);
+  while (!outputIt.IsAtEnd())
+    {
+    this->ComputeRowOffsets(outputIt.GetIndex(), rowOffsets);
+    const OffsetValueType centerRowOffset = rowOffsets[rowOffsets.size() / 2];
+
+    IndexValueType x = outputIt.GetIndex()[0];
+    SizeValueType count = 0;
+    for (IndexValueType dx = -radius; dx <= radius; ++dx)
+      {
+      count += countColumn(x + dx);
+      }
+    while (true)
+      {
+      const InputPixelType value = buffer[centerRowOffset + this->GetColumnOffset(x)];
+      if (value != backgroundValue)
+        {
+        outputIt.Set(static_cast<OutputPixelType>(value));
+        }
+      else if (count >= m_BirthThreshold)
+        {
+        outputIt.Set(static_cast<OutputPixelType>(foregroundValue));
+        ++numberOfPixelsChanged;
+        }
+      else
+        {
+        outputIt.Set(static_cast<OutputPixelType>(backgroundValue));
+        }
+      ++outputIt;
+      if (outputIt.IsAtEndOfLine())
+        {
+        break;
+        }
+      count -= countColumn(x - radius);
+      count += countColumn(x + radius + 1);
+      ++x;
+      }
+    outputIt.NextLine();
+    }
+  m_NumberOfPixelsChanged += numberOfPixelsChanged;
+}
+
+//----------------------------------------------------------------------------
+template <class TInputImage, class TOutputImage>
+void SlidingWindowVotingBinaryHoleFillingImageFilter<TInputImage, TOutputImage>::PrintSelf(std::ostream& os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+  os << indent << "ForegroundValue: " << static_cast<typename NumericTraits<InputPixelType>::PrintType>(m_ForegroundValue) << std::endl;
+  os << indent << "BackgroundValue: " << static_cast<typename NumericTraits<InputPixelType>::PrintType>(m_BackgroundValue) << std::endl;
+  os << indent << "MajorityThreshold: " << m_MajorityThreshold << std::endl;
+  os << indent << "NumberOfPixelsChanged: " << m_NumberOfPixelsChanged << std::endl;
+}
+
+} // end namespace itk
+
+#endif
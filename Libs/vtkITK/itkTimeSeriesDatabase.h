@@ -7,6 +7,7 @@
 #include <itkImageSource.h>
 #include <iostream>
 #include <fstream>
+#include <mutex>
 #include <itkTimeSeriesDatabaseHelper.h>
 
 #define TimeSeriesBlockSize 16
@@ -24,6 +25,14 @@ namespace itk
  * The main idea behind TimeSeriesDatabase is to have a representation of a 4 dimensional dataset that
  * is larger than main memory, but may still be accessed in a rapid manner.  Though not strictly
  * ITK conforming, this initial pass is strictly 4 dimensional datasets.
+ *
+ * The database files are memory mapped, blocks are accessed directly in the
+ * mapping. The cache keeps track of the most recently used blocks, pages of
+ * blocks that are dropped from the cache are released, so that the memory
+ * used by the mapped files stays within the cache size. Reading the blocks
+ * of the next time point (and of all time points for voxel time series) is
+ * started in the background by the operating system before they are accessed.
+ * Update() and GetVoxelTimeSeries() may be called from multiple threads.
  */
 template <class TPixel> class TimeSeriesDatabase : public ImageSource<Image<TPixel,3> > {
 public:
@@ -101,6 +110,14 @@ public:
    */
   float GetCacheSizeInMiB ();
 
+  /** Start reading the blocks of the next image in the background
+   * when an image is generated, as images are often processed
+   * one after the other (default: on).
+   */
+  itkSetMacro ( PrefetchNextImage, bool );
+  itkGetMacro ( PrefetchNextImage, bool );
+  itkBooleanMacro ( PrefetchNextImage );
+
 
 protected:
   TimeSeriesDatabase();
@@ -116,6 +133,7 @@ protected:
   typename OutputImageType::DirectionType m_OutputDirection;
 
   typedef itk::TimeSeriesDatabaseHelper::counted_ptr<std::fstream> StreamPtr;
+  typedef itk::TimeSeriesDatabaseHelper::counted_ptr<itk::TimeSeriesDatabaseHelper::MappedFile> MappedFilePtr;
 
   static std::streampos CalculatePosition ( unsigned long index, unsigned long BlocksPerFile );
 
@@ -136,17 +154,21 @@ protected:
   std::string  m_Filename;
   unsigned int m_CurrentImage{0};
 
-  std::vector<StreamPtr>   m_DatabaseFiles;
-  std::vector<std::string> m_DatabaseFileNames;
-  unsigned long            m_BlocksPerFile{0};
-
-  /// our cache
-  struct CacheBlock
-  {
-    TPixel data[TimeSeriesBlockSize*TimeSeriesBlockSize*TimeSeriesBlockSize];
-  };
-  TimeSeriesDatabaseHelper::LRUCache<unsigned long, CacheBlock> m_Cache;
-  CacheBlock* GetCacheBlock ( unsigned long index );
+  std::vector<MappedFilePtr> m_DatabaseFiles;
+  std::vector<std::string>   m_DatabaseFileNames;
+  unsigned long              m_BlocksPerFile{0};
+  bool                       m_PrefetchNextImage{true};
+
+  /// Get the voxels of a block in the mapped database files, move it to the
+  /// front of the cache. Throws an exception if the block is not in the files.
+  const TPixel* GetCacheBlock ( unsigned long index );
+  /// Get the mapped file and the byte offset of a block, returns nullptr if the block is not in the files.
+  const TimeSeriesDatabaseHelper::MappedFile* GetBlockLocation ( unsigned long index, size_t& offset ) const;
+  void PrefetchBlock ( unsigned long index ) const;
+
+  /// Most recently used blocks, pointing into the mapped files
+  TimeSeriesDatabaseHelper::LRUCache<unsigned long, const TPixel*> m_Cache;
+  std::mutex m_CacheMutex;
 };
 
 } // end namespace itk
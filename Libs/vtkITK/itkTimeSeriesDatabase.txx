@@ -54,15 +54,20 @@ template <class TPixel>
 bool TimeSeriesDatabase<TPixel>::IsOpen () const
 {
   if ( this->m_DatabaseFiles.size() == 0 ) { return false; }
-  return const_cast<std::fstream*>(this->m_DatabaseFiles[0].get())->is_open();
+  return this->m_DatabaseFiles[0]->IsOpen();
 }
 
 template <class TPixel>
 void TimeSeriesDatabase<TPixel>::Disconnect ()
 {
-  for ( int idx = 0; idx < this->m_DatabaseFiles.size(); idx++ )
+  {
+  std::lock_guard<std::mutex> lock ( this->m_CacheMutex );
+  // cached blocks point into the mapped files
+  this->m_Cache.clear();
+  }
+  for ( ::size_t idx = 0; idx < this->m_DatabaseFiles.size(); idx++ )
     {
-    this->m_DatabaseFiles[idx]->close();
+    this->m_DatabaseFiles[idx]->Close();
     }
   this->m_DatabaseFiles.clear();
   this->m_DatabaseFileNames.clear();
@@ -122,14 +127,21 @@ void TimeSeriesDatabase<TPixel>::Connect ( const char* filename )
   o >> dummy;
   this->m_DatabaseFiles.clear();
   this->m_DatabaseFileNames.clear();
-  // Read and open the files
+  // Read the file names and map the files
   for ( int idx = 0; idx < NumberOfFiles; idx++ )
     {
     std::string Filename;
     o >> Filename;
     // std::cout << "Reading file " << idx << " " << Filename << std::endl;
     this->m_DatabaseFileNames.push_back ( Filename );
-    this->m_DatabaseFiles.push_back ( StreamPtr ( new std::fstream ( Filename.c_str(), ::std::ios::in | ::std::ios::binary ) ) );
+    MappedFilePtr file ( new TimeSeriesDatabaseHelper::MappedFile );
+    if ( !file->Open ( Filename ) )
+      {
+      this->m_DatabaseFiles.clear();
+      this->m_DatabaseFileNames.clear();
+      itkExceptionMacro ( "TimeSeriesDatabase::Connect: failed to map database file " << Filename );
+      }
+    this->m_DatabaseFiles.push_back ( file );
     }
   /*
   std::cout << "ImageSize: " << m_OutputRegion.GetSize() << endl;
@@ -184,42 +196,95 @@ template <class TPixel>
 
 
 template <class TPixel>
-typename TimeSeriesDatabase<TPixel>::CacheBlock* TimeSeriesDatabase<TPixel>::GetCacheBlock ( unsigned long index )
+const TimeSeriesDatabaseHelper::MappedFile* TimeSeriesDatabase<TPixel>::GetBlockLocation ( unsigned long index, size_t& offset ) const
 {
-  CacheBlock* Buffer = this->m_Cache.find ( index );
-  if ( Buffer == nullptr ) {
-    // Fill it in
-    CacheBlock B;
-    int FileIdx = this->CalculateFileIndex ( index );
-
-    this->m_DatabaseFiles[FileIdx]->seekg ( this->CalculatePosition ( index, this->m_BlocksPerFile ) );
-    this->m_DatabaseFiles[FileIdx]->read ( reinterpret_cast<char*> ( B.data ), TimeSeriesVolumeBlockSize * sizeof ( TPixel ) );
-    this->m_Cache.insert ( index, B );
-    Buffer = this->m_Cache.find ( index );
-  }
-  return Buffer;
+  unsigned int FileIdx = CalculateFileIndex ( index, this->m_BlocksPerFile );
+  if ( FileIdx >= this->m_DatabaseFiles.size() )
+    {
+    return nullptr;
+    }
+  const TimeSeriesDatabaseHelper::MappedFile* file = this->m_DatabaseFiles[FileIdx].get();
+  offset = static_cast<size_t> ( this->CalculatePosition ( index, this->m_BlocksPerFile ) );
+  if ( offset + TimeSeriesVolumeBlockSize * sizeof ( TPixel ) > file->GetSize() )
+    {
+    return nullptr;
+    }
+  return file;
+}
+
+
+template <class TPixel>
+void TimeSeriesDatabase<TPixel>::PrefetchBlock ( unsigned long index ) const
+{
+  size_t offset = 0;
+  const TimeSeriesDatabaseHelper::MappedFile* file = this->GetBlockLocation ( index, offset );
+  if ( file )
+    {
+    file->Prefetch ( offset, TimeSeriesVolumeBlockSize * sizeof ( TPixel ) );
+    }
+}
+
+
+template <class TPixel>
+const TPixel* TimeSeriesDatabase<TPixel>::GetCacheBlock ( unsigned long index )
+{
+  std::lock_guard<std::mutex> lock ( this->m_CacheMutex );
+  const TPixel** cached = this->m_Cache.find ( index );
+  if ( cached != nullptr )
+    {
+    return *cached;
+    }
+
+  size_t offset = 0;
+  const TimeSeriesDatabaseHelper::MappedFile* file = this->GetBlockLocation ( index, offset );
+  if ( !file )
+    {
+    itkExceptionMacro ( "TimeSeriesDatabase::GetCacheBlock: block " << index << " is not in the database files" );
+    }
+  const TPixel* block = reinterpret_cast<const TPixel*> ( file->GetData() + offset );
+  unsigned long removedIndex = 0;
+  if ( this->m_Cache.insert ( index, block, &removedIndex ) )
+    {
+    // Let the operating system drop the least recently used block from memory
+    size_t removedOffset = 0;
+    const TimeSeriesDatabaseHelper::MappedFile* removedFile = this->GetBlockLocation ( removedIndex, removedOffset );
+    if ( removedFile )
+      {
+      removedFile->Release ( removedOffset, TimeSeriesVolumeBlockSize * sizeof ( TPixel ) );
+      }
+    }
+  return block;
 }
 
 
 template <class TPixel>
 void TimeSeriesDatabase<TPixel>::GetVoxelTimeSeries ( typename OutputImageType::IndexType idx, ArrayType& array )
 {
+  if ( !this->IsOpen() )
+  {
+    itkExceptionMacro ( "TimeSeriesDatabase::GetVoxelTimeSeries: not open for reading" );
+  }
   // See if the index is inside the volume
   // and figure out which cache block we need
   Size<3> CurrentBlock;
   Size<3> Offset;
   for ( int i = 0; i < 3; i++ ) {
-    if ( idx[i] < 0 || idx[i] > this->m_OutputRegion.Size[i] ) {
-      throw 1;
+    if ( idx[i] < 0 || idx[i] >= static_cast<IndexValueType> ( this->m_OutputRegion.GetSize ( i ) ) ) {
+      itkExceptionMacro ( "TimeSeriesDatabase::GetVoxelTimeSeries: index " << idx << " is outside the image" );
     }
-    CurrentBlock[i] = reinterpret_cast<unsigned long> ( idx[i] / (double)TimeSeriesBlockSize );
+    CurrentBlock[i] = idx[i] / TimeSeriesBlockSize;
     Offset[i] = idx[i] % TimeSeriesBlockSize;
   }
   unsigned long offset = Offset[0] + Offset[1] * TimeSeriesBlockSize + Offset[2] * TimeSeriesBlockSizeP2;
-  array = ArrayType ( this->m_Dimensions[3] );
-  for ( int volume = 0; volume < this->m_Dimensions[3]; volume++ ) {
-    CacheBlock* cache = this->GetCacheBlock ( CurrentBlock, volume );
-    array[volume] = cache->data[offset];
+  unsigned int numberOfVolumes = this->m_Dimensions[3];
+  // Blocks of all the volumes are needed, start reading them all at once
+  for ( unsigned int volume = 0; volume < numberOfVolumes; volume++ ) {
+    this->PrefetchBlock ( this->CalculateIndex ( CurrentBlock, volume ) );
+  }
+  array = ArrayType ( numberOfVolumes );
+  for ( unsigned int volume = 0; volume < numberOfVolumes; volume++ ) {
+    const TPixel* block = this->GetCacheBlock ( this->CalculateIndex ( CurrentBlock, volume ) );
+    array[volume] = block[offset];
   }
 }
 
@@ -264,7 +329,7 @@ void TimeSeriesDatabase<TPixel>::GenerateData()
     }
 
   Size<3> CurrentBlock;
-  // Now, read our data, caching as we go, in future, make this thread safe
+  // Now, read our data, caching as we go
   Size<3> BlockSize = { {TimeSeriesBlockSize, TimeSeriesBlockSize, TimeSeriesBlockSize }};
   ImageRegion<3> BlockRegion;
   BlockRegion.SetSize ( BlockSize );
@@ -275,7 +340,7 @@ void TimeSeriesDatabase<TPixel>::GenerateData()
         typename OutputImageType::RegionType BR, IR;
         if ( print ) {  std::cout << "For Block Index: " << CurrentBlock << std::endl; }
         unsigned long index = this->CalculateIndex ( CurrentBlock, this->m_CurrentImage );
-        CacheBlock* Buffer = this->GetCacheBlock ( index );
+        const TPixel* Buffer = this->GetCacheBlock ( index );
         if ( this->CalculateIntersection ( CurrentBlock, Region, BR, IR ) ) {
           // Just iterate over whole block
           // Good we can use an iterator!
@@ -290,7 +355,7 @@ void TimeSeriesDatabase<TPixel>::GenerateData()
           BlockRegion.SetIndex ( BlockIndex );
           ImageRegionIterator<OutputImageType> it ( output, IR );
           it.GoToBegin();
-          TPixel* ptr = Buffer->data;
+          const TPixel* ptr = Buffer;
           while ( !it.IsAtEnd() ) {
             it.Set ( *ptr );
             ++it;
@@ -305,7 +370,7 @@ void TimeSeriesDatabase<TPixel>::GenerateData()
             std::cout << "Count: " << Count << std::endl;
             std::cout << "Block Region: " << BR;
             std::cout << "Image Region: " << IR;
-            std::cout << "First voxel: " << Buffer->data[0] << std::endl;
+            std::cout << "First voxel: " << Buffer[0] << std::endl;
           }
           unsigned int bx, by, bz, x, y, z;
           for ( z = 0; z < Count[2]; z++ ) {
@@ -325,7 +390,7 @@ void TimeSeriesDatabase<TPixel>::GenerateData()
                 }
                 */
 
-                output->SetPixel ( ImageIndex, Buffer->data[bx + TimeSeriesBlockSize*by + TimeSeriesBlockSize*TimeSeriesBlockSize*bz] );
+                output->SetPixel ( ImageIndex, Buffer[bx + TimeSeriesBlockSize*by + TimeSeriesBlockSize*TimeSeriesBlockSize*bz] );
                 }
               }
             }
@@ -334,7 +399,17 @@ void TimeSeriesDatabase<TPixel>::GenerateData()
       }
     }
 
-  return;
+  // The next image is likely to be requested next, start reading its blocks
+  if ( this->m_PrefetchNextImage && this->m_CurrentImage + 1 < this->m_Dimensions[3] )
+    {
+    for ( CurrentBlock[2] = BlockStart[2]; CurrentBlock[2] < BlockStart[2] + BlockCount[2]; CurrentBlock[2]++ ) {
+      for ( CurrentBlock[1] = BlockStart[1]; CurrentBlock[1] < BlockStart[1] + BlockCount[1]; CurrentBlock[1]++ ) {
+        for ( CurrentBlock[0] = BlockStart[0]; CurrentBlock[0] < BlockStart[0] + BlockCount[0]; CurrentBlock[0]++ ) {
+          this->PrefetchBlock ( this->CalculateIndex ( CurrentBlock, this->m_CurrentImage + 1 ) );
+        }
+      }
+    }
+    }
 }
 
 
@@ -560,6 +635,7 @@ void TimeSeriesDatabase<TPixel>::CreateFromFileArchetype ( const char* TSDFilena
 template <class TPixel>
 float TimeSeriesDatabase<TPixel>::GetCacheSizeInMiB()
 {
+  std::lock_guard<std::mutex> lock ( this->m_CacheMutex );
   unsigned cachesize = this->m_Cache.get_maxsize();
   return (float) cachesize * sizeof ( TPixel ) * TimeSeriesVolumeBlockSize / ( 1024*1024.);
 }
@@ -569,7 +645,8 @@ void TimeSeriesDatabase<TPixel>::SetCacheSizeInMiB ( float sz )
 {
   // How many blocks is this?
   double BlockSizeInMiB = sizeof ( TPixel ) * TimeSeriesVolumeBlockSize / ( 1024*1024.);
-  unsigned long int blocks = (unsigned long int) ceil ( sz * BlockSizeInMiB );
+  unsigned long int blocks = (unsigned long int) TSD_MAX ( 1.0, ceil ( sz / BlockSizeInMiB ) );
+  std::lock_guard<std::mutex> lock ( this->m_CacheMutex );
   this->m_Cache.set_maxsize ( blocks );
 }
 
@@ -584,6 +661,7 @@ TimeSeriesDatabase<TPixel>::TimeSeriesDatabase ()
 template <class TPixel>
 TimeSeriesDatabase<TPixel>::~TimeSeriesDatabase () {
   // m_Cache.statistics ( std::cout );
+  this->Disconnect();
 }
 
 template <class TPixel>
@@ -0,0 +1,173 @@
+/*=========================================================================
+
+  Copyright Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+==========================================================================*/
+
+#include "itkTimeSeriesDatabaseHelper.h"
+
+#ifdef _WIN32
+# include <windows.h>
+#else
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <unistd.h>
+#endif
+
+namespace itk {
+  namespace TimeSeriesDatabaseHelper {
+
+//----------------------------------------------------------------------------
+MappedFile::MappedFile() = default;
+
+//----------------------------------------------------------------------------
+MappedFile::~MappedFile()
+{
+  this->Close();
+}
+
+//----------------------------------------------------------------------------
+bool MappedFile::Open(const std::string& filename)
+{
+  this->Close();
+#ifdef _WIN32
+  HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+    OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (file == INVALID_HANDLE_VALUE)
+    {
+    return false;
+    }
+  LARGE_INTEGER fileSize;
+  if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+    {
+    CloseHandle(file);
+    return false;
+    }
+  HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (!mapping)
+    {
+    CloseHandle(file);
+    return false;
+    }
+  void* address = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+  if (!address)
+    {
+    CloseHandle(mapping);
+    CloseHandle(file);
+    return false;
+    }
+  m_FileHandle = file;
+  m_MappingHandle = mapping;
+  m_Size = static_cast<size_t>(fileSize.QuadPart);
+#else
+  int fileDescriptor = open(filename.c_str(), O_RDONLY);
+  if (fileDescriptor < 0)
+    {
+    return false;
+    }
+  struct stat status;
+  if (fstat(fileDescriptor, &status) != 0 || status.st_size == 0)
+    {
+    close(fileDescriptor);
+    return false;
+    }
+  size_t size = static_cast<size_t>(status.st_size);
+  void* address = mmap(nullptr, size, PROT_READ, MAP_SHARED, fileDescriptor, 0);
+  // the mapping remains valid after the descriptor is closed
+  close(fileDescriptor);
+  if (address == MAP_FAILED)
+    {
+    return false;
+    }
+  m_Size = size;
+#endif
+  m_Data = static_cast<const char*>(address);
+  return true;
+}
+
+//----------------------------------------------------------------------------
+void MappedFile::Close()
+{
+  if (!m_Data)
+    {
+    return;
+    }
+#ifdef _WIN32
+  UnmapViewOfFile(m_Data);
+  CloseHandle(m_MappingHandle);
+  CloseHandle(m_FileHandle);
+  m_MappingHandle = nullptr;
+  m_FileHandle = nullptr;
+#else
+  munmap(const_cast<char*>(m_Data), m_Size);
+#endif
+  m_Data = nullptr;
+  m_Size = 0;
+}
+
+//----------------------------------------------------------------------------
+bool MappedFile::GetPageRange(size_t offset, size_t length, char*& start, size_t& pageLength) const
+{
+  if (!m_Data || offset >= m_Size || length == 0)
+    {
+    return false;
+    }
+  if (length > m_Size - offset)
+    {
+    length = m_Size - offset;
+    }
+#ifdef _WIN32
+  SYSTEM_INFO systemInfo;
+  GetSystemInfo(&systemInfo);
+  size_t pageSize = systemInfo.dwPageSize;
+#else
+  size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#endif
+  size_t pageOffset = offset / pageSize * pageSize;
+  start = const_cast<char*>(m_Data) + pageOffset;
+  pageLength = offset + length - pageOffset;
+  return true;
+}
+
+//----------------------------------------------------------------------------
+void MappedFile::Prefetch(size_t offset, size_t length) const
+{
+  char* start = nullptr;
+  size_t pageLength = 0;
+  if (!this->GetPageRange(offset, length, start, pageLength))
+    {
+    return;
+    }
+#ifdef _WIN32
+  // PrefetchVirtualMemory is not available on all supported Windows versions,
+  // pages are loaded on first access instead.
+  (void)start;
+  (void)pageLength;
+#else
+  madvise(start, pageLength, MADV_WILLNEED);
+#endif
+}
+
+//----------------------------------------------------------------------------
+void MappedFile::Release(size_t offset, size_t length) const
+{
+  char* start = nullptr;
+  size_t pageLength = 0;
+  if (!this->GetPageRange(offset, length, start, pageLength))
+    {
+    return;
+    }
+#ifdef _WIN32
+  // Unlocking pages that are not locked removes them from the working set
+  VirtualUnlock(start, pageLength);
+#else
+  madvise(start, pageLength, MADV_DONTNEED);
+#endif
+}
+
+  }
+}
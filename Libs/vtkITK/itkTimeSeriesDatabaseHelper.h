@@ -6,6 +6,9 @@
 #include <string>
 #include <cstdarg>
 #include <cassert>
+#include <cstddef>
+
+#include "vtkITK.h"
 
 namespace itk {
   namespace TimeSeriesDatabaseHelper {
@@ -68,6 +71,44 @@ namespace itk {
         }
       };
 
+    /// Read-only memory mapping of a file.
+    ///
+    /// Pages are loaded by the operating system when they are first accessed.
+    /// Prefetch() asks the operating system to start loading a range in the
+    /// background, Release() allows it to drop the pages of a range from
+    /// memory (they are loaded again from the file if accessed later).
+    class VTK_ITK_EXPORT MappedFile
+      {
+      public:
+        MappedFile();
+        ~MappedFile();
+
+        /// Map the whole file. Returns false on failure.
+        bool Open(const std::string& filename);
+        void Close();
+        bool IsOpen() const { return m_Data != nullptr; }
+
+        const char* GetData() const { return m_Data; }
+        size_t GetSize() const { return m_Size; }
+
+        void Prefetch(size_t offset, size_t length) const;
+        void Release(size_t offset, size_t length) const;
+
+      private:
+        MappedFile(const MappedFile&) = delete;
+        void operator=(const MappedFile&) = delete;
+
+        /// Expand the range to page boundaries, returns false if it is empty
+        bool GetPageRange(size_t offset, size_t length, char*& start, size_t& pageLength) const;
+
+        const char* m_Data{nullptr};
+        size_t      m_Size{0};
+#ifdef _WIN32
+        void*       m_FileHandle{nullptr};
+        void*       m_MappingHandle{nullptr};
+#endif
+      };
+
     /// LRU Cache
 
     using namespace std;
@@ -149,7 +190,10 @@ namespace itk {
 
       /// Inserts a key/value pair to the cache.
       ///
-      void insert(const KeyType& key, const ValueType& value)
+      /// Returns true if the least recently used element had to be removed
+      /// to make room for the new one, its key is stored in removedKey (if not null).
+      ///
+      bool insert(const KeyType& key, const ValueType& value, KeyType* removedKey = nullptr)
       {
         /// Is the key already in the cache ?
         /// Note: find() is used intentionally - if
@@ -185,8 +229,14 @@ namespace itk {
                 lru_list.pop_back();
 
                 IF_DEBUG(stats.removed++);
+                if (removedKey)
+                  {
+                    *removedKey = lru_key;
+                  }
+                return true;
               }
           }
+        return false;
       }
 
       /// Looks for a key in the cache.
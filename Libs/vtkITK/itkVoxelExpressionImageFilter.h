@@ -0,0 +1,149 @@
+#ifndef itkVoxelExpressionImageFilter_h
+#define itkVoxelExpressionImageFilter_h
+
+#include "itkImageToImageFilter.h"
+#include "itkInterpolateImageFunction.h"
+
+// STD includes
+#include <string>
+#include <vector>
+
+namespace itk
+{
+
+/** \class VoxelExpressionImageFilter
+ * \brief Applies a chain of voxel-wise operations to a set of images in a single pass.
+ *
+ * The value of each output voxel is computed by starting from the value of input 0
+ * and applying the operations in the order they were appended:
+ *
+ * - Add, Subtract, Multiply: combine the value with the voxel of another input.
+ *   The result is constrained to the range of the output pixel type
+ *   (as in ConstrainedValueAdditionImageFilter).
+ * - Mask: replace the value where the voxel of a mask input is not the label.
+ * - Threshold: replace the value if it is outside [lower, upper].
+ * - NegatedThreshold: replace the value if it is inside [lower, upper].
+ *
+ * The output value is cast to the output pixel type, so no operation is needed
+ * to cast an image.
+ *
+ * The output has the geometry of input 0. Other inputs that have the same geometry
+ * are read directly, inputs with a different geometry are interpolated at the
+ * output voxel positions (0 outside of the input), using the interpolator set by
+ * SetInterpolator() (linear by default). Interpolated values are cast to the input
+ * pixel type, as if the input was resampled with ResampleImageFilter.
+ *
+ * Chaining operations with this filter avoids the intermediate images and
+ * passes of a pipeline of single operation filters.
+ *
+ * \ingroup IntensityImageFilters Multithreaded
+ */
+template <class TInputImage, class TOutputImage>
+class VoxelExpressionImageFilter : public ImageToImageFilter<TInputImage, TOutputImage>
+{
+public:
+  /** Standard class typedefs. */
+  typedef VoxelExpressionImageFilter                    Self;
+  typedef ImageToImageFilter<TInputImage, TOutputImage> Superclass;
+  typedef SmartPointer<Self>                            Pointer;
+  typedef SmartPointer<const Self>                      ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Runtime information support. */
+  itkTypeMacro(VoxelExpressionImageFilter, ImageToImageFilter);
+
+  typedef TInputImage                              InputImageType;
+  typedef TOutputImage                             OutputImageType;
+  typedef typename TInputImage::PixelType          InputPixelType;
+  typedef typename TOutputImage::PixelType         OutputPixelType;
+  typedef typename TOutputImage::RegionType        OutputImageRegionType;
+  typedef InterpolateImageFunction<TInputImage, double> InterpolatorType;
+
+  enum OperationType
+    {
+    ADD,
+    SUBTRACT,
+    MULTIPLY,
+    MASK,
+    THRESHOLD,
+    NEGATED_THRESHOLD
+    };
+
+  /** InputIndex is used by Add, Subtract, Multiply and Mask. Lower and Upper
+   * define the kept label range of Mask and the range of the thresholds.
+   * Value replaces the voxel value in Mask and the thresholds. */
+  struct Operation
+    {
+    OperationType Type;
+    unsigned int  InputIndex;
+    double        Lower;
+    double        Upper;
+    double        Value;
+    };
+
+  /** Append operations to the chain */
+  void AppendAdd(unsigned int inputIndex);
+  void AppendSubtract(unsigned int inputIndex);
+  void AppendMultiply(unsigned int inputIndex);
+  void AppendMask(unsigned int maskInputIndex, double label, double replaceValue);
+  void AppendThreshold(double lower, double upper, double outsideValue);
+  void AppendNegatedThreshold(double lower, double upper, double insideValue);
+  void AppendOperation(const Operation& operation);
+
+  /** Append operations described by a string of operations separated by ';'.
+   * Input indices must be integers, other arguments can be "inf" or "-inf", too:
+   *   add(index); subtract(index); multiply(index);
+   *   mask(index, label, replaceValue);
+   *   threshold(lower, upper, outsideValue); negatedthreshold(lower, upper, insideValue)
+   * Returns false and sets errorMessage if the string cannot be parsed. In this case no
+   * operation is appended. */
+  bool AppendOperations(const std::string& operations, std::string& errorMessage);
+
+  void ClearOperations();
+  unsigned int GetNumberOfOperations() const;
+  const Operation& GetOperation(unsigned int index) const;
+
+  /** Interpolator used for an input that does not have the geometry of input 0.
+   * If not set, linear interpolation is used. */
+  void SetInterpolator(unsigned int inputIndex, InterpolatorType* interpolator);
+  InterpolatorType* GetInterpolator(unsigned int inputIndex) const;
+
+protected:
+  VoxelExpressionImageFilter();
+  ~VoxelExpressionImageFilter() override = default;
+
+  void PrintSelf(std::ostream& os, Indent indent) const override;
+
+  /** Inputs that are interpolated do not need to occupy the same physical space */
+  void VerifyInputInformation() ITKv5_CONST override {}
+
+  /** Interpolated inputs are requested entirely */
+  void GenerateInputRequestedRegion() override;
+
+  void BeforeThreadedGenerateData() override;
+  void DynamicThreadedGenerateData(const OutputImageRegionType& outputRegionForThread) override;
+
+  /** Returns true if the voxels of input can be read at the output voxel indices */
+  bool IsInputAligned(const InputImageType* input) const;
+
+private:
+  VoxelExpressionImageFilter(const Self&) = delete;
+  void operator=(const Self&) = delete;
+
+  std::vector<Operation> m_Operations;
+  std::vector<typename InterpolatorType::Pointer> m_Interpolators;
+
+  /** Set up by BeforeThreadedGenerateData for each input */
+  std::vector<bool> m_InputUsed;
+  std::vector<typename InterpolatorType::Pointer> m_ActiveInterpolators;
+};
+
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkVoxelExpressionImageFilter.txx"
+#endif
+
+#endif
@@ -0,0 +1,447 @@
+#ifndef itkVoxelExpressionImageFilter_txx
+#define itkVoxelExpressionImageFilter_txx
+
+#include "itkVoxelExpressionImageFilter.h"
+
+#include "itkImageRegionConstIterator.h"
+#include "itkImageRegionIterator.h"
+#include "itkLinearInterpolateImageFunction.h"
+#include "itkNumericTraits.h"
+
+// STD includes
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <sstream>
+
+namespace itk
+{
+
+//----------------------------------------------------------------------------
+template <class TInputImage, class TOutputImage>
+VoxelExpressionImageFilter<TInputImage, TOutputImage>::VoxelExpressionImageFilter()
+{
+  this->DynamicMultiThreadingOn();
+}
+
+//----------------------------------------------------------------------------
+template <class TInputImage, class TOutputImage>
+void VoxelExpressionImageFilter<TInputImage, TOutputImage>::AppendAdd(unsigned int inputIndex)
+{
+  Operation operation = { ADD, inputIndex, 0.0, 0.0, 0.0 };
+  this->AppendOperation(operation);
+}
+
+//----------------------------------------------------------------------------
+template <class TInputImage, class TOutputImage>
+void VoxelExpressionImageFilter<TInputImage, TOutputImage>::AppendSubtract(unsigned int inputIndex)
+{
+  Operation operation = { SUBTRACT, inputIndex, 0.0, 0.0, 0.0 };
+  this->AppendOperation(operation);
+}
+
+//----------------------------------------------------------------------------
+template <class TInputImage, class TOutputImage>
+void VoxelExpressionImageFilter<TInputImage, TOutputImage>::AppendMultiply(unsigned int inputIndex)
+{
+  Operation operation = { MULTIPLY, inputIndex, 0.0, 0.0, 0.0 };
+  this->AppendOperation(operation);
+}
+
+//----------------------------------------------------------------------------
+template <class TInputImage, class TOutputImage>
+void VoxelExpressionImageFilter<TInputImage, TOutputImage>::AppendMask(
+  unsigned int maskInputIndex, double label, double replaceValue)
+{
+  Operation operation = { MASK, maskInputIndex, label, label, replaceValue };
+  this->AppendOperation(operation);
+}
+
+//----------------------------------------------------------------------------
+template <class TInputImage, class TOutputImage>
+void VoxelExpressionImageFilter<TInputImage, TOutputImage>::AppendThreshold(
+  double lower, double upper, double outsideValue)
+{
+  Operation operation = { THRESHOLD, 0, lower, upper, outsideValue };
+  this->AppendOperation(operation);
+}
+
+//----------------------------------------------------------------------------
+template <class TInputImage, class TOutputImage>
+void VoxelExpressionImageFilter<TInputImage, TOutputImage>::AppendNegatedThreshold(
+  double lower, double upper, double insideValue)
+{
+  Operation operation = { NEGATED_THRESHOLD, 0, lower, upper, insideValue };
+  this->AppendOperation(operation);
+}
+
+//----------------------------------------------------------------------------
+template <class TInputImage, class TOutputImage>
+void VoxelExpressionImageFilter<TInputImage, TOutputImage>::AppendOperation(const Operation& operation)
+{
+  m_Operations.push_back(operation);
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+template <class TInputImage, class TOutputImage>
+bool VoxelExpressionImageFilter<TInputImage, TOutputImage>::AppendOperations(
+  const std::string& operations, std::string& errorMessage)
+{
+  auto trim = [](const std::string& text) -> std::string
+    {
+    const char* whitespace = " \t\r\n";
+    const size_t first = text.find_first_not_of(whitespace);
+    if (first == std::string::npos)
+      {
+      return std::string();
+      }
+    return text.substr(first, text.find_last_not_of(whitespace) - first + 1);
+    };
+
+  std::vector<Operation> parsedOperations;
+  std::istringstream operationsStream(operations);
+  std::string operationText;
+  while (std::getline(operationsStream, operationText, ';'))
+    {
+    operationText = trim(operationText);
+    if (operationText.empty())
+      {
+      continue;
+      }
+    const size_t argumentsStart = operationText.find('(');
+    if (argumentsStart == std::string::npos || operationText[operationText.size() - 1] != ')')
+      {
+      errorMessage = "Invalid operation: " + operationText;
+      return false;
+      }
+    std::string name = trim(operationText.substr(0, argumentsStart));
+    std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+
+    std::vector<double> arguments;
+    std::istringstream argumentsStream(
+      operationText.substr(argumentsStart + 1, operationText.size() - argumentsStart - 2));
+    std::string argumentText;
+    while (std::getline(argumentsStream, argumentText, ','))
+      {
+      argumentText = trim(argumentText);
+      const char* argumentBegin = argumentText.c_str();
+      char* argumentEnd = nullptr;
+      const double argument = std::strtod(argumentBegin, &argumentEnd);
+      if (argumentText.empty() || *argumentEnd != '\0')
+        {
+        errorMessage = "Invalid argument '" + argumentText + "' in operation: " + operationText;
+        return false;
+        }
+      arguments.push_back(argument);
+      }
+
+    Operation operation = { ADD, 0, 0.0, 0.0, 0.0 };
+    size_t expectedNumberOfArguments = 3;
+    bool hasInputIndex = true;
+    if (name == "add" || name == "subtract" || name == "multiply")
+      {
+      operation.Type = (name == "add" ? ADD : (name == "subtract" ? SUBTRACT : MULTIPLY));
+      expectedNumberOfArguments = 1;
+      }
+    else if (name == "mask")
+      {
+      operation.Type = MASK;
+      }
+    else if (name == "threshold" || name == "negatedthreshold")
+      {
+      operation.Type = (name == "threshold" ? THRESHOLD : NEGATED_THRESHOLD);
+      hasInputIndex = false;
+      }
+    else
+      {
+      errorMessage = "Unknown operation: " + operationText;
+      return false;
+      }
+    if (arguments.size() != expectedNumberOfArguments)
+      {
+      std::ostringstream message;
+      message << "Operation " << name << " expects " << expectedNumberOfArguments << " arguments: " << operationText;
+      errorMessage = message.str();
+      return false;
+      }
+    if (hasInputIndex)
+      {
+      if (arguments[0] < 0 || arguments[0] != std::floor(arguments[0]))
+        {
+        errorMessage = "Invalid input index in operation: " + operationText;
+        return false;
+        }
+      operation.InputIndex = static_cast<unsigned int>(arguments[0]);
+      if (operation.Type == MASK)
+        {
+        operation.Lower = arguments[1];
+        operation.Upper = arguments[1];
+        operation.Value = arguments[2];
+        }
+      }
+    else
+      {
+      operation.Lower = arguments[0];
+      operation.Upper = arguments[1];
+      operation.Value = arguments[2];
+      }
+    parsedOperations.push_back(operation);
+    }
+
+  for (const Operation& operation : parsedOperations)
+    {
+    this->AppendOperation(operation);
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+template <class TInputImage, class TOutputImage>
+void VoxelExpressionImageFilter<TInputImage, TOutputImage>::ClearOperations()
+{
+  m_Operations.clear();
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+template <class TInputImage, class TOutputImage>
+unsigned int VoxelExpressionImageFilter<TInputImage, TOutputImage>::GetNumberOfOperations() const
+{
+  return static_cast<unsigned int>(m_Operations.size());
+}
+
+//----------------------------------------------------------------------------
+template <class TInputImage, class TOutputImage>
+const typename VoxelExpressionImageFilter<TInputImage, TOutputImage>::Operation&
+VoxelExpressionImageFilter<TInputImage, TOutputImage>::GetOperation(unsigned int index) const
+{
+  return m_Operations.at(index);
+}
+
+//----------------------------------------------------------------------------
+template <class TInputImage, class TOutputImage>
+void VoxelExpressionImageFilter<TInputImage, TOutputImage>::SetInterpolator(
+  unsigned int inputIndex, InterpolatorType* interpolator)
+{
+  if (inputIndex >= m_Interpolators.size())
+    {
+    m_Interpolators.resize(inputIndex + 1);
+    }
+  m_Interpolators[inputIndex] = interpolator;
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+template <class TInputImage, class TOutputImage>
+typename VoxelExpressionImageFilter<TInputImage, TOutputImage>::InterpolatorType*
+VoxelExpressionImageFilter<TInputImage, TOutputImage>::GetInterpolator(unsigned int inputIndex) const
+{
+  return inputIndex < m_Interpolators.size() ? m_Interpolators[inputIndex].GetPointer() : nullptr;
+}
+
+//----------------------------------------------------------------------------
+template <class TInputImage, class TOutputImage>
+bool VoxelExpressionImageFilter<TInputImage, TOutputImage>::IsInputAligned(const InputImageType* input) const
+{
+  const OutputImageType* output = this->GetOutput();
+  if (!input->GetLargestPossibleRegion().IsInside(output->GetRequestedRegion()))
+    {
+    return false;
+    }
+  const double coordinateTolerance = this->GetCoordinateTolerance();
+  const double directionTolerance = this->GetDirectionTolerance();
+  for (unsigned int i = 0; i < OutputImageType::ImageDimension; ++i)
+    {
+    const double spacing = output->GetSpacing()[i];
+    if (std::abs(input->GetSpacing()[i] - spacing) > coordinateTolerance * spacing
+      || std::abs(input->GetOrigin()[i] - output->GetOrigin()[i]) > coordinateTolerance * spacing)
+      {
+      return false;
+      }
+    for (unsigned int j = 0; j < OutputImageType::ImageDimension; ++j)
+      {
+      if (std::abs(input->GetDirection()[i][j] - output->GetDirection()[i][j]) > directionTolerance)
+        {
+        return false;
+        }
+      }
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+template <class TInputImage, class TOutputImage>
+void VoxelExpressionImageFilter<TInputImage, TOutputImage>::GenerateInputRequestedRegion()
+{
+  Superclass::GenerateInputRequestedRegion();
+  for (unsigned int inputIndex = 1; inputIndex < this->GetNumberOfIndexedInputs(); ++inputIndex)
+    {
+    InputImageType* input = const_cast<InputImageType*>(this->GetInput(inputIndex));
+    if (input && !this->IsInputAligned(input))
+      {
+      input->SetRequestedRegionToLargestPossibleRegion();
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+template <class TInputImage, class TOutputImage>
+void VoxelExpressionImageFilter<TInputImage, TOutputImage>::BeforeThreadedGenerateData()
+{
+  const unsigned int numberOfInputs = this->GetNumberOfIndexedInputs();
+  m_InputUsed.assign(numberOfInputs, false);
+  m_InputUsed[0] = true;
+  for (const Operation& operation : m_Operations)
+    {
+    if (operation.Type == THRESHOLD || operation.Type == NEGATED_THRESHOLD)
+      {
+      continue;
+      }
+    if (operation.InputIndex >= numberOfInputs || !this->GetInput(operation.InputIndex))
+      {
+      itkExceptionMacro("Input " << operation.InputIndex << " is used by an operation but it is not set");
+      }
+    m_InputUsed[operation.InputIndex] = true;
+    }
+
+  m_ActiveInterpolators.assign(numberOfInputs, typename InterpolatorType::Pointer());
+  for (unsigned int inputIndex = 1; inputIndex < numberOfInputs; ++inputIndex)
+    {
+    const InputImageType* input = this->GetInput(inputIndex);
+    if (!m_InputUsed[inputIndex] || this->IsInputAligned(input))
+      {
+      continue;
+      }
+    typename InterpolatorType::Pointer interpolator = this->GetInterpolator(inputIndex);
+    if (interpolator.IsNull())
+      {
+      interpolator = LinearInterpolateImageFunction<InputImageType, double>::New();
+      }
+    // Interpolators may precompute coefficients, therefore they are set up before threading
+    interpolator->SetInputImage(input);
+    m_ActiveInterpolators[inputIndex] = interpolator;
+    }
+}
+
+//----------------------------------------------------------------------------
+template <class TInputImage, class TOutputImage>
+void VoxelExpressionImageFilter<TInputImage, TOutputImage>::DynamicThreadedGenerateData(
+  const OutputImageRegionType& outputRegionForThread)
+{
+  OutputImageType* output = this->GetOutput();
+  const unsigned int numberOfInputs = static_cast<unsigned int>(m_InputUsed.size());
+
+  std::vector<ImageRegionConstIterator<InputImageType> > inputIterators(numberOfInputs);
+  for (unsigned int inputIndex = 0; inputIndex < numberOfInputs; ++inputIndex)
+    {
+    if (m_InputUsed[inputIndex] && m_ActiveInterpolators[inputIndex].IsNull())
+      {
+      inputIterators[inputIndex] =
+        ImageRegionConstIterator<InputImageType>(this->GetInput(inputIndex), outputRegionForThread);
+      }
+    }
+  ImageRegionIterator<OutputImageType> outputIt(output, outputRegionForThread);
+
+  const double outputMinimum = static_cast<double>(NumericTraits<OutputPixelType>::NonpositiveMin());
+  const double outputMaximum = static_cast<double>(NumericTraits<OutputPixelType>::max());
+  const double inputMinimum = static_cast<double>(NumericTraits<InputPixelType>::NonpositiveMin());
+  const double inputMaximum = static_cast<double>(NumericTraits<InputPixelType>::max());
+
+  std::vector<double> inputValues(numberOfInputs, 0.0);
+  typename OutputImageType::PointType point;
+  for (; !outputIt.IsAtEnd(); ++outputIt)
+    {
+    for (unsigned int inputIndex = 0; inputIndex < numberOfInputs; ++inputIndex)
+      {
+      if (!m_InputUsed[inputIndex])
+        {
+        continue;
+        }
+      const InterpolatorType* interpolator = m_ActiveInterpolators[inputIndex];
+      if (!interpolator)
+        {
+        inputValues[inputIndex] = static_cast<double>(inputIterators[inputIndex].Get());
+        ++inputIterators[inputIndex];
+        continue;
+        }
+      output->TransformIndexToPhysicalPoint(outputIt.GetIndex(), point);
+      double value = 0.0;
+      if (interpolator->IsInsideBuffer(point))
+        {
+        value = std::min(std::max(interpolator->Evaluate(point), inputMinimum), inputMaximum);
+        }
+      inputValues[inputIndex] = static_cast<double>(static_cast<InputPixelType>(value));
+      }
+
+    double value = inputValues[0];
+    for (const Operation& operation : m_Operations)
+      {
+      switch (operation.Type)
+        {
+        case ADD:
+          value = std::min(std::max(value + inputValues[operation.InputIndex], outputMinimum), outputMaximum);
+          break;
+        case SUBTRACT:
+          value = std::min(std::max(value - inputValues[operation.InputIndex], outputMinimum), outputMaximum);
+          break;
+        case MULTIPLY:
+          value = std::min(std::max(value * inputValues[operation.InputIndex], outputMinimum), outputMaximum);
+          break;
+        case MASK:
+          {
+          const double maskValue = inputValues[operation.InputIndex];
+          if (maskValue < operation.Lower || maskValue > operation.Upper)
+            {
+            value = operation.Value;
+            }
+          }
+          break;
+        case THRESHOLD:
+          if (value < operation.Lower || value > operation.Upper)
+            {
+            value = operation.Value;
+            }
+          break;
+        case NEGATED_THRESHOLD:
+          if (value >= operation.Lower && value <= operation.Upper)
+            {
+            value = operation.Value;
+            }
+          break;
+        }
+      }
+    outputIt.Set(static_cast<OutputPixelType>(value));
+    }
+}
+
+//----------------------------------------------------------------------------
+template <class TInputImage, class TOutputImage>
+void VoxelExpressionImageFilter<TInputImage, TOutputImage>::PrintSelf(std::ostream& os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+  const char* operationNames[] = { "add", "subtract", "multiply", "mask", "threshold", "negatedthreshold" };
+  os << indent << "Operations: " << m_Operations.size() << std::endl;
+  for (const Operation& operation : m_Operations)
+    {
+    os << indent.GetNextIndent() << operationNames[operation.Type] << "(";
+    if (operation.Type == THRESHOLD || operation.Type == NEGATED_THRESHOLD)
+      {
+      os << operation.Lower << ", " << operation.Upper << ", " << operation.Value;
+      }
+    else if (operation.Type == MASK)
+      {
+      os << operation.InputIndex << ", " << operation.Lower << ", " << operation.Value;
+      }
+    else
+      {
+      os << operation.InputIndex;
+      }
+    os << ")" << std::endl;
+    }
+}
+
+} // end namespace itk
+
+#endif
@@ -39,6 +39,12 @@
 
 // STD includes
 #include <algorithm>
+#include <atomic>
+#include <deque>
+#include <exception>
+#include <map>
+#include <mutex>
+#include <thread>
 #include <vector>
 
 #include "itkArchetypeSeriesFileNames.h"
@@ -52,6 +58,215 @@
 
 vtkStandardNewMacro(vtkITKArchetypeImageSeriesReader);
 
+#ifdef VTKITK_BUILD_DICOM_SUPPORT
+namespace
+{
+/// DICOM tags used for grouping files, in the order they are stored in DICOMHeaderTagValues
+const char* const DICOM_HEADER_TAGS[] =
+  {
+  "0020|000e", // SeriesInstanceUID
+  "0008|0033", // ContentTime
+  "0018|1060", // TriggerTime
+  "0018|0086", // EchoNumbers
+  "0010|9089", // DiffusionGradientOrientation
+  "0020|1041", // SliceLocation
+  "0020|0037", // ImageOrientationPatient
+  "0020|0032"  // ImagePositionPatient
+  };
+const int NUMBER_OF_DICOM_HEADER_TAGS = sizeof(DICOM_HEADER_TAGS) / sizeof(DICOM_HEADER_TAGS[0]);
+typedef std::vector<std::string> DICOMHeaderTagValues;
+
+/// Maximum number of directories kept in the DICOM header cache
+const size_t DICOM_HEADER_CACHE_MAXIMUM_NUMBER_OF_DIRECTORIES = 16;
+
+struct DICOMHeaderCacheEntry
+{
+  long int ModifiedTime;
+  unsigned long FileLength;
+  /// Values of the tags that have been read, by tag
+  std::map<std::string, std::string> TagValues;
+};
+typedef std::map<std::string, DICOMHeaderCacheEntry> DICOMHeaderDirectoryCache;
+
+/// Tag values of the files that have been analyzed, grouped by directory.
+/// Entries are only used if the file has not changed since.
+class DICOMHeaderCache
+{
+public:
+  static DICOMHeaderCache& GetInstance()
+  {
+    static DICOMHeaderCache instance;
+    return instance;
+  }
+
+  /// Returns true if the values of all the tags are cached
+  bool Find(const std::string& fileName, long int modifiedTime, unsigned long fileLength,
+    const std::vector<std::string>& tags, DICOMHeaderTagValues& tagValues)
+  {
+    std::lock_guard<std::mutex> lock(this->Mutex);
+    std::map<std::string, DICOMHeaderDirectoryCache>::iterator directoryIt =
+      this->Directories.find(itksys::SystemTools::GetFilenamePath(fileName));
+    if (directoryIt == this->Directories.end())
+      {
+      return false;
+      }
+    DICOMHeaderDirectoryCache::iterator fileIt = directoryIt->second.find(fileName);
+    if (fileIt == directoryIt->second.end()
+      || fileIt->second.ModifiedTime != modifiedTime
+      || fileIt->second.FileLength != fileLength)
+      {
+      return false;
+      }
+    DICOMHeaderTagValues values(tags.size());
+    for (size_t tagIndex = 0; tagIndex < tags.size(); ++tagIndex)
+      {
+      std::map<std::string, std::string>::iterator valueIt = fileIt->second.TagValues.find(tags[tagIndex]);
+      if (valueIt == fileIt->second.TagValues.end())
+        {
+        return false;
+        }
+      values[tagIndex] = valueIt->second;
+      }
+    tagValues.swap(values);
+    return true;
+  }
+
+  void Add(const std::string& fileName, long int modifiedTime, unsigned long fileLength,
+    const std::vector<std::string>& tags, const DICOMHeaderTagValues& tagValues)
+  {
+    std::lock_guard<std::mutex> lock(this->Mutex);
+    std::string directory = itksys::SystemTools::GetFilenamePath(fileName);
+    if (this->Directories.find(directory) == this->Directories.end())
+      {
+      // Forget the directory that was added first
+      if (this->DirectoryOrder.size() >= DICOM_HEADER_CACHE_MAXIMUM_NUMBER_OF_DIRECTORIES)
+        {
+        this->Directories.erase(this->DirectoryOrder.front());
+        this->DirectoryOrder.pop_front();
+        }
+      this->DirectoryOrder.push_back(directory);
+      }
+    DICOMHeaderCacheEntry& entry = this->Directories[directory][fileName];
+    if (entry.ModifiedTime != modifiedTime || entry.FileLength != fileLength)
+      {
+      // values of other tags are from a previous version of the file
+      entry.TagValues.clear();
+      }
+    entry.ModifiedTime = modifiedTime;
+    entry.FileLength = fileLength;
+    for (size_t tagIndex = 0; tagIndex < tags.size(); ++tagIndex)
+      {
+      entry.TagValues[tags[tagIndex]] = tagValues[tagIndex];
+      }
+  }
+
+  void Clear()
+  {
+    std::lock_guard<std::mutex> lock(this->Mutex);
+    this->Directories.clear();
+    this->DirectoryOrder.clear();
+  }
+
+private:
+  std::mutex Mutex;
+  std::map<std::string, DICOMHeaderDirectoryCache> Directories;
+  std::deque<std::string> DirectoryOrder;
+};
+
+//----------------------------------------------------------------------------
+/// Read the tags of the DICOM files using numberOfThreads threads.
+/// Each thread reads one header at a time, so that the number of concurrent
+/// file accesses is bounded by the number of threads. Headers of files that
+/// have not changed since they were last read are taken from the cache.
+/// If readSucceeded is nullptr then the first error stops reading and its exception
+/// is rethrown, otherwise files that cannot be read are reported in readSucceeded.
+void ReadDICOMHeaderTagValues(const std::vector<std::string>& fileNames, const std::vector<std::string>& tags,
+  int numberOfThreads, std::vector<DICOMHeaderTagValues>& tagValues, std::vector<bool>* readSucceeded)
+{
+  tagValues.assign(fileNames.size(), DICOMHeaderTagValues(tags.size()));
+  if (readSucceeded)
+    {
+    readSucceeded->assign(fileNames.size(), true);
+    }
+  if (fileNames.empty())
+    {
+    return;
+    }
+  numberOfThreads = std::max(1, std::min(numberOfThreads, static_cast<int>(fileNames.size())));
+
+  // ITK objects are created on the calling thread, each thread uses its own image IO
+  std::vector<itk::GDCMImageIO::Pointer> imageIOs;
+  for (int threadIndex = 0; threadIndex < numberOfThreads; ++threadIndex)
+    {
+    imageIOs.push_back(itk::GDCMImageIO::New());
+    }
+
+  std::atomic<size_t> nextFileIndex(0);
+  std::mutex errorMutex;
+  std::exception_ptr error;
+  auto readHeaders = [&](itk::GDCMImageIO* gdcmIO)
+    {
+    for (size_t fileIndex = nextFileIndex++; fileIndex < fileNames.size(); fileIndex = nextFileIndex++)
+      {
+      try
+        {
+        const std::string& fileName = fileNames[fileIndex];
+        long int modifiedTime = itksys::SystemTools::ModifiedTime(fileName);
+        unsigned long fileLength = itksys::SystemTools::FileLength(fileName);
+        if (DICOMHeaderCache::GetInstance().Find(fileName, modifiedTime, fileLength, tags, tagValues[fileIndex]))
+          {
+          continue;
+          }
+        gdcmIO->SetFileName(fileName);
+        gdcmIO->ReadImageInformation();
+        itk::MetaDataDictionary &dict = gdcmIO->GetMetaDataDictionary();
+        for (size_t tagIndex = 0; tagIndex < tags.size(); ++tagIndex)
+          {
+          // GetMetaDataWithoutSpaces removes extra spaces from the DICOM tag, because extra spaces were
+          // found in some DICOM file before/after the multi-value separator backslashes.
+          tagValues[fileIndex][tagIndex] = vtkITKArchetypeImageSeriesReader::GetMetaDataWithoutSpaces(dict, tags[tagIndex]);
+          }
+        DICOMHeaderCache::GetInstance().Add(fileName, modifiedTime, fileLength, tags, tagValues[fileIndex]);
+        }
+      catch (...)
+        {
+        if (readSucceeded)
+          {
+          // elements of vector<bool> share storage, so they are not written concurrently
+          std::lock_guard<std::mutex> lock(errorMutex);
+          (*readSucceeded)[fileIndex] = false;
+          tagValues[fileIndex].assign(tags.size(), std::string());
+          continue;
+          }
+        std::lock_guard<std::mutex> lock(errorMutex);
+        if (!error)
+          {
+          error = std::current_exception();
+          }
+        // stop all threads
+        nextFileIndex = fileNames.size();
+        }
+      }
+    };
+
+  std::vector<std::thread> threads;
+  for (int threadIndex = 1; threadIndex < numberOfThreads; ++threadIndex)
+    {
+    threads.emplace_back(readHeaders, imageIOs[threadIndex].GetPointer());
+    }
+  readHeaders(imageIOs[0].GetPointer());
+  for (std::vector<std::thread>::iterator threadIt = threads.begin(); threadIt != threads.end(); ++threadIt)
+    {
+    threadIt->join();
+    }
+  if (error)
+    {
+    std::rethrow_exception(error);
+    }
+}
+}
+#endif
+
 //----------------------------------------------------------------------------
 vtkITKArchetypeImageSeriesReader::vtkITKArchetypeImageSeriesReader()
 {
@@ -91,6 +306,7 @@ vtkITKArchetypeImageSeriesReader::vtkITKArchetypeImageSeriesReader()
   this->ImageOrientationPatient.resize( 0 );
 
   this->AnalyzeHeader = true;
+  this->NumberOfHeaderReadThreads = 4;
 
   this->GroupingByTags = false;
   this->IsOnlyFile = false;
@@ -180,6 +396,29 @@ void vtkITKArchetypeImageSeriesReader::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "DICOMImageIOApproach: " << this->GetDICOMImageIOApproach();
 #else
   os << indent << "DICOMImageIOApproach: " << "NA";
+#endif
+  os << "\n";
+  os << indent << "NumberOfHeaderReadThreads: " << this->NumberOfHeaderReadThreads << "\n";
+}
+
+//----------------------------------------------------------------------------
+void vtkITKArchetypeImageSeriesReader::ClearDICOMHeaderCache()
+{
+#ifdef VTKITK_BUILD_DICOM_SUPPORT
+  DICOMHeaderCache::GetInstance().Clear();
+#endif
+}
+
+//----------------------------------------------------------------------------
+void vtkITKArchetypeImageSeriesReader::ReadDICOMHeaderTagValues(const std::vector<std::string>& fileNames,
+  const std::vector<std::string>& tags, int numberOfThreads,
+  std::vector<std::vector<std::string> >& tagValues, std::vector<bool>& readSucceeded)
+{
+#ifdef VTKITK_BUILD_DICOM_SUPPORT
+  ::ReadDICOMHeaderTagValues(fileNames, tags, numberOfThreads, tagValues, &readSucceeded);
+#else
+  tagValues.assign(fileNames.size(), std::vector<std::string>(tags.size()));
+  readSucceeded.assign(fileNames.size(), false);
 #endif
 }
 
@@ -1033,6 +1272,16 @@ void vtkITKArchetypeImageSeriesReader::GetScalarRangeMetaDataKeys(itk::ImageIOBa
     }
 }
 
+//----------------------------------------------------------------------------
+void vtkITKArchetypeImageSeriesReader::AllocateOutputScalarsForImport(vtkImageData* data, vtkInformation* outInfo)
+{
+  // Allocate a single voxel to create a scalar array of the requested type and
+  // number of components, its buffer is replaced by the ITK pixel container.
+  data->SetExtent(0,0,0,0,0,0);
+  data->AllocateScalars(outInfo);
+  data->SetExtent(outInfo->Get(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT()));
+}
+
 //----------------------------------------------------------------------------
 void vtkITKArchetypeImageSeriesReader::SetMetaDataScalarRangeToPointDataInfo( vtkImageData* data )
 {
@@ -1315,20 +1564,17 @@ void vtkITKArchetypeImageSeriesReader::AnalyzeDicomHeaders()
     }
 
   // if Archetype is a Dicom File
-  gdcmIO->SetFileName( this->Archetype );
+  // Headers are read in parallel, then inserted in file order so that indices do not depend on thread timing
+  std::vector<DICOMHeaderTagValues> headerTagValues;
+  std::vector<std::string> headerTags(DICOM_HEADER_TAGS, DICOM_HEADER_TAGS + NUMBER_OF_DICOM_HEADER_TAGS);
+  ::ReadDICOMHeaderTagValues(this->AllFileNames, headerTags, this->NumberOfHeaderReadThreads, headerTagValues, nullptr);
   for (int f = 0; f < nFiles; f++)
     {
-    gdcmIO->SetFileName( this->AllFileNames[f] );
-    gdcmIO->ReadImageInformation();
-    itk::MetaDataDictionary &dict = gdcmIO->GetMetaDataDictionary();
+    const DICOMHeaderTagValues& tagValues = headerTagValues[f];
     std::string tagValue;
 
-    // Use vtkITKArchetypeImageSeriesReader::GetMetaDataWithoutSpaces to remove extra spaces
-    // from the DICOM tag, because extra spaces were found in some DICOM file before/after the
-    // multi-value separator backslashes.
-
     // series instance UID
-    tagValue = vtkITKArchetypeImageSeriesReader::GetMetaDataWithoutSpaces(dict, "0020|000e");
+    tagValue = tagValues[0];
     if (!tagValue.empty())
       {
       int idx = InsertSeriesInstanceUIDs( tagValue.c_str() );
@@ -1340,7 +1586,7 @@ void vtkITKArchetypeImageSeriesReader::AnalyzeDicomHeaders()
       }
 
     // content time
-    tagValue = vtkITKArchetypeImageSeriesReader::GetMetaDataWithoutSpaces(dict, "0008|0033");
+    tagValue = tagValues[1];
     if (!tagValue.empty())
       {
       int idx = InsertContentTime( tagValue.c_str() );
@@ -1352,7 +1598,7 @@ void vtkITKArchetypeImageSeriesReader::AnalyzeDicomHeaders()
       }
 
     // trigger time
-    tagValue = vtkITKArchetypeImageSeriesReader::GetMetaDataWithoutSpaces(dict, "0018|1060");
+    tagValue = tagValues[2];
     if (!tagValue.empty())
       {
       int idx = InsertTriggerTime( tagValue.c_str() );
@@ -1364,7 +1610,7 @@ void vtkITKArchetypeImageSeriesReader::AnalyzeDicomHeaders()
       }
 
     // echo numbers
-    tagValue = vtkITKArchetypeImageSeriesReader::GetMetaDataWithoutSpaces(dict, "0018|0086");
+    tagValue = tagValues[3];
     if (!tagValue.empty())
       {
       int idx = InsertEchoNumbers( tagValue.c_str() );
@@ -1376,7 +1622,7 @@ void vtkITKArchetypeImageSeriesReader::AnalyzeDicomHeaders()
       }
 
     // diffision gradient orientation
-    tagValue = vtkITKArchetypeImageSeriesReader::GetMetaDataWithoutSpaces(dict, "0010|9089");
+    tagValue = tagValues[4];
     if (!tagValue.empty())
       {
       float a[3] = { -1 };
@@ -1390,7 +1636,7 @@ void vtkITKArchetypeImageSeriesReader::AnalyzeDicomHeaders()
       }
 
     // slice location
-    tagValue = vtkITKArchetypeImageSeriesReader::GetMetaDataWithoutSpaces(dict, "0020|1041");
+    tagValue = tagValues[5];
     if (!tagValue.empty())
       {
       float a = -1;
@@ -1404,7 +1650,7 @@ void vtkITKArchetypeImageSeriesReader::AnalyzeDicomHeaders()
       }
 
     // image orientation patient
-    tagValue = vtkITKArchetypeImageSeriesReader::GetMetaDataWithoutSpaces(dict, "0020|0037");
+    tagValue = tagValues[6];
     if (!tagValue.empty())
       {
       float a[6] = { -1 };
@@ -1417,7 +1663,7 @@ void vtkITKArchetypeImageSeriesReader::AnalyzeDicomHeaders()
       this->IndexImageOrientationPatient[f] = -1;
       }
     // image position patient
-    tagValue = vtkITKArchetypeImageSeriesReader::GetMetaDataWithoutSpaces(dict, "0020|0032");
+    tagValue = tagValues[7];
     if (!tagValue.empty())
       {
       float a[3] = { -1 };
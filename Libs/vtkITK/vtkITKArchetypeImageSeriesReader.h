@@ -246,6 +246,28 @@ public:
   vtkSetMacro(AnalyzeHeader, bool);
   vtkGetMacro(AnalyzeHeader, bool);
 
+  ///
+  /// Number of threads reading DICOM headers when analyzing the headers.
+  /// It also bounds the number of files accessed at the same time. Default is 4.
+  vtkSetClampMacro(NumberOfHeaderReadThreads, int, 1, 64);
+  vtkGetMacro(NumberOfHeaderReadThreads, int);
+
+  ///
+  /// Forget the DICOM headers read by all the readers.
+  /// Headers are cached per directory and files that have not been modified
+  /// (same modification time and size) are not read again when they are
+  /// analyzed again, for example when a series is reloaded.
+  static void ClearDICOMHeaderCache();
+
+  ///
+  /// Read the values of DICOM \a tags (in "gggg|eeee" format, lowercase) from the
+  /// headers of \a fileNames using \a numberOfThreads threads, through the DICOM header cache.
+  /// tagValues[i][j] is the value of tags[j] in fileNames[i], empty if the tag is missing.
+  /// readSucceeded[i] is false if the header of fileNames[i] could not be read.
+  static void ReadDICOMHeaderTagValues(const std::vector<std::string>& fileNames,
+    const std::vector<std::string>& tags, int numberOfThreads,
+    std::vector<std::vector<std::string> >& tagValues, std::vector<bool>& readSucceeded);
+
   ///
   /// Whether to use orientation from file
   vtkSetMacro(UseOrientationFromFile, int);
@@ -262,6 +284,10 @@ public:
   ///
   /// Return the MetaDataDictionary from the ITK layer
   const itk::MetaDataDictionary &GetMetaDataDictionary() const;
+
+  /// Get MetaData from dictionary, removing all whitespaces from the string.
+  static std::string GetMetaDataWithoutSpaces(const itk::MetaDataDictionary &dict, const std::string& tag);
+
   std::vector<std::string> Tags;
   std::vector<std::string> TagValues;
   void ParseDictionary();
@@ -803,9 +829,6 @@ protected:
   vtkITKArchetypeImageSeriesReader();
   ~vtkITKArchetypeImageSeriesReader() override;
 
-  /// Get MetaData from dictionary, removing all whitespaces from the string.
-  static std::string GetMetaDataWithoutSpaces(const itk::MetaDataDictionary &dict, const std::string& tag);
-
   /// Get the image IO for the specified filename
   itk::ImageIOBase::Pointer GetImageIO(const char* filename);
 
@@ -823,6 +846,13 @@ protected:
                                   std::string range_keys[2]);
   void SetMetaDataScalarRangeToPointDataInfo(vtkImageData* data);
 
+  /// Set the whole extent on the output image and create its scalar array
+  /// without allocating memory for the voxels.
+  /// The scalar array is expected to adopt the pixel container of the ITK
+  /// image (with SetVoidArray), so that voxels are not copied and the
+  /// memory is only allocated once, by ITK.
+  void AllocateOutputScalarsForImport(vtkImageData* data, vtkInformation* outInfo);
+
   double DefaultDataSpacing[3];
   double DefaultDataOrigin[3];
   float ScanAxis[3];
@@ -875,6 +905,7 @@ protected:
 
   std::vector<std::string> AllFileNames;
   bool AnalyzeHeader;
+  int NumberOfHeaderReadThreads;
   bool IsOnlyFile;
   bool ArchetypeIsDICOM;
 
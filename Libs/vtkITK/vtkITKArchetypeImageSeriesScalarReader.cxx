@@ -35,6 +35,13 @@
 #include <itkGDCMImageIO.h>
 #endif
 
+// STD includes
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <thread>
+#include <vector>
+
 vtkStandardNewMacro(vtkITKArchetypeImageSeriesScalarReader);
 
 namespace {
@@ -45,10 +52,130 @@ vtkAOSDataArrayTemplate<T>* DownCast(vtkAbstractArray* a)
   return vtkAOSDataArrayTemplate<T>::FastDownCast(a);
 }
 
+#ifdef VTKITK_BUILD_DICOM_SUPPORT
+//----------------------------------------------------------------------------
+template <class TIn, class TOut>
+void ConvertSlice(const char* input, size_t numberOfPixels, TOut* output)
+{
+  const TIn* in = reinterpret_cast<const TIn*>(input);
+  for (size_t i = 0; i < numberOfPixels; ++i)
+    {
+    output[i] = static_cast<TOut>(in[i]);
+    }
+}
+
+//----------------------------------------------------------------------------
+/// Convert a slice read by the image IO to the output scalar type,
+/// returns false if the component type is not supported
+template <class TOut>
+bool ConvertSlice(itk::ImageIOBase::IOComponentType componentType, const char* input, size_t numberOfPixels, TOut* output)
+{
+  switch (componentType)
+    {
+    case itk::ImageIOBase::UCHAR: ConvertSlice<unsigned char>(input, numberOfPixels, output); return true;
+    case itk::ImageIOBase::CHAR: ConvertSlice<char>(input, numberOfPixels, output); return true;
+    case itk::ImageIOBase::USHORT: ConvertSlice<unsigned short>(input, numberOfPixels, output); return true;
+    case itk::ImageIOBase::SHORT: ConvertSlice<short>(input, numberOfPixels, output); return true;
+    case itk::ImageIOBase::UINT: ConvertSlice<unsigned int>(input, numberOfPixels, output); return true;
+    case itk::ImageIOBase::INT: ConvertSlice<int>(input, numberOfPixels, output); return true;
+    case itk::ImageIOBase::ULONG: ConvertSlice<unsigned long>(input, numberOfPixels, output); return true;
+    case itk::ImageIOBase::LONG: ConvertSlice<long>(input, numberOfPixels, output); return true;
+    case itk::ImageIOBase::FLOAT: ConvertSlice<float>(input, numberOfPixels, output); return true;
+    case itk::ImageIOBase::DOUBLE: ConvertSlice<double>(input, numberOfPixels, output); return true;
+    default: return false;
+    }
+}
+
+//----------------------------------------------------------------------------
+/// Read each file of \a fileNames as slice of \a output using \a numberOfThreads threads.
+/// Slices in the output component type are decoded in place, others are converted
+/// from a per-thread buffer. Returns false if a file is not a single-frame slice
+/// of the expected size or it cannot be read.
+template <class TOut>
+bool ReadDICOMSlices(vtkITKArchetypeImageSeriesScalarReader* self, const std::vector<std::string>& fileNames,
+  const int dimensions[2], int numberOfThreads, TOut* output)
+{
+  const size_t numberOfSlicePixels = static_cast<size_t>(dimensions[0]) * dimensions[1];
+  numberOfThreads = std::max(1, std::min(numberOfThreads, static_cast<int>(fileNames.size())));
+
+  // ITK objects are created on the calling thread, each thread uses its own image IO
+  std::vector<itk::GDCMImageIO::Pointer> imageIOs;
+  for (int threadIndex = 0; threadIndex < numberOfThreads; ++threadIndex)
+    {
+    imageIOs.push_back(itk::GDCMImageIO::New());
+    }
+
+  std::atomic<size_t> nextSlice(0);
+  std::atomic<size_t> numberOfSlicesRead(0);
+  std::atomic<bool> failed(false);
+  auto readSlices = [&](itk::GDCMImageIO* gdcmIO, bool reportProgress)
+    {
+    std::vector<char> buffer;
+    for (size_t slice = nextSlice++; slice < fileNames.size() && !failed; slice = nextSlice++)
+      {
+      try
+        {
+        gdcmIO->SetFileName(fileNames[slice]);
+        gdcmIO->ReadImageInformation();
+        if (gdcmIO->GetNumberOfComponents() != 1
+          || gdcmIO->GetDimensions(0) != static_cast<itk::SizeValueType>(dimensions[0])
+          || gdcmIO->GetDimensions(1) != static_cast<itk::SizeValueType>(dimensions[1])
+          || (gdcmIO->GetNumberOfDimensions() > 2 && gdcmIO->GetDimensions(2) != 1))
+          {
+          failed = true;
+          break;
+          }
+        TOut* sliceOutput = output + slice * numberOfSlicePixels;
+        if (gdcmIO->GetComponentType() == itk::ImageIOBase::MapPixelType<TOut>::CType)
+          {
+          gdcmIO->Read(sliceOutput);
+          }
+        else
+          {
+          buffer.resize(gdcmIO->GetImageSizeInBytes());
+          gdcmIO->Read(buffer.data());
+          if (!ConvertSlice(gdcmIO->GetComponentType(), buffer.data(), numberOfSlicePixels, sliceOutput))
+            {
+            failed = true;
+            break;
+            }
+          }
+        }
+      catch (...)
+        {
+        failed = true;
+        break;
+        }
+      size_t slicesRead = ++numberOfSlicesRead;
+      if (reportProgress)
+        {
+        // events are only invoked from the calling thread
+        self->UpdateProgress(static_cast<double>(slicesRead) / fileNames.size());
+        }
+      }
+    };
+
+  std::vector<std::thread> threads;
+  for (int threadIndex = 1; threadIndex < numberOfThreads; ++threadIndex)
+    {
+    threads.emplace_back(readSlices, imageIOs[threadIndex].GetPointer(), false);
+    }
+  readSlices(imageIOs[0].GetPointer(), true);
+  for (std::vector<std::thread>::iterator threadIt = threads.begin(); threadIt != threads.end(); ++threadIt)
+    {
+    threadIt->join();
+    }
+  return !failed;
+}
+#endif
+
 };
 
 //----------------------------------------------------------------------------
-vtkITKArchetypeImageSeriesScalarReader::vtkITKArchetypeImageSeriesScalarReader() = default;
+vtkITKArchetypeImageSeriesScalarReader::vtkITKArchetypeImageSeriesScalarReader()
+{
+  this->NumberOfSliceReadThreads = 0;
+}
 
 //----------------------------------------------------------------------------
 vtkITKArchetypeImageSeriesScalarReader::~vtkITKArchetypeImageSeriesScalarReader() = default;
@@ -58,6 +185,71 @@ void vtkITKArchetypeImageSeriesScalarReader::PrintSelf(ostream& os, vtkIndent in
 {
   this->Superclass::PrintSelf(os,indent);
   os << indent << "vtk ITK Archetype Image Series Scalar Reader\n";
+  os << indent << "NumberOfSliceReadThreads: " << this->NumberOfSliceReadThreads << "\n";
+}
+
+//----------------------------------------------------------------------------
+bool vtkITKArchetypeImageSeriesScalarReader::ReadDICOMSlicesInParallel(vtkImageData* data, vtkInformation* outInfo)
+{
+#ifdef VTKITK_BUILD_DICOM_SUPPORT
+  if (!this->ArchetypeIsDICOM
+    || this->DICOMImageIOApproach != vtkITKArchetypeImageSeriesReader::GDCM
+    || !this->UseNativeCoordinateOrientation
+    || this->FileNames.size() < 2
+    || this->GetNumberOfComponents() != 1)
+    {
+    return false;
+    }
+  int dimensions[3] = { 0, 0, 0 };
+  data->GetDimensions(dimensions);
+  if (static_cast<size_t>(dimensions[2]) != this->FileNames.size())
+    {
+    // multi-frame files
+    return false;
+    }
+  int numberOfThreads = this->NumberOfSliceReadThreads;
+  if (numberOfThreads == 0)
+    {
+    numberOfThreads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    }
+
+  // the output scalars are the final buffer, slices are decoded into it
+  data->AllocateScalars(outInfo);
+  void* output = data->GetScalarPointer();
+  bool success = false;
+#define vtkITKReadDICOMSlicesCase(typeN, type) \
+    case typeN: \
+      success = ReadDICOMSlices(this, this->FileNames, dimensions, numberOfThreads, static_cast<type*>(output)); \
+      break
+  switch (this->OutputScalarType)
+    {
+    vtkITKReadDICOMSlicesCase(VTK_DOUBLE, double);
+    vtkITKReadDICOMSlicesCase(VTK_FLOAT, float);
+    vtkITKReadDICOMSlicesCase(VTK_LONG, long);
+    vtkITKReadDICOMSlicesCase(VTK_UNSIGNED_LONG, unsigned long);
+    vtkITKReadDICOMSlicesCase(VTK_INT, int);
+    vtkITKReadDICOMSlicesCase(VTK_UNSIGNED_INT, unsigned int);
+    vtkITKReadDICOMSlicesCase(VTK_SHORT, short);
+    vtkITKReadDICOMSlicesCase(VTK_UNSIGNED_SHORT, unsigned short);
+    vtkITKReadDICOMSlicesCase(VTK_CHAR, char);
+    vtkITKReadDICOMSlicesCase(VTK_UNSIGNED_CHAR, unsigned char);
+    default:
+      break;
+    }
+#undef vtkITKReadDICOMSlicesCase
+  if (!success)
+    {
+    // the series reader reports the errors
+    vtkDebugMacro("ReadDICOMSlicesInParallel: series cannot be read directly, using ITK image series reader");
+    this->AllocateOutputScalarsForImport(data, outInfo);
+    }
+  this->SetMetaDataScalarRangeToPointDataInfo(data);
+  return success;
+#else
+  (void)data;
+  (void)outInfo;
+  return false;
+#endif
 }
 
 //----------------------------------------------------------------------------
@@ -82,10 +274,7 @@ int vtkITKArchetypeImageSeriesScalarReader::RequestData(
   // removed UpdateInformation: generates an error message
   //   from VTK and doesn't appear to be needed...
   //data->UpdateInformation();
-  data->SetExtent(0,0,0,0,0,0);
-  data->AllocateScalars(outInfo);
-  data->SetExtent(outInfo->Get(
-    vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT()));
+  this->AllocateOutputScalarsForImport(data, outInfo);
   this->SetMetaDataScalarRangeToPointDataInfo(data);
 
 #ifdef VTKITK_BUILD_DICOM_SUPPORT
@@ -166,6 +355,7 @@ int vtkITKArchetypeImageSeriesScalarReader::RequestData(
       itk::ImageFileReader<image2##typeN>::Pointer reader2##typeN = \
             itk::ImageFileReader<image2##typeN>::New(); \
       reader2##typeN->SetFileName(this->FileNames[0].c_str()); \
+      reader2##typeN->ReleaseDataFlagOn(); \
       vtkITKExecuteDataDeclareDICOMImageIO \
       if (this->ArchetypeIsDICOM) \
         { \
@@ -199,6 +389,10 @@ int vtkITKArchetypeImageSeriesScalarReader::RequestData(
 
   try
     {
+    if (this->ReadDICOMSlicesInParallel(data, outInfo))
+      {
+      return 1;
+      }
     // If there is only one file in the series, just use an image file reader
     if (this->FileNames.size() == 1)
       {
@@ -27,12 +27,29 @@ class VTK_ITK_EXPORT vtkITKArchetypeImageSeriesScalarReader : public vtkITKArche
   vtkTypeMacro(vtkITKArchetypeImageSeriesScalarReader,vtkITKArchetypeImageSeriesReader);
   void PrintSelf(ostream& os, vtkIndent indent) override;
 
+  ///
+  /// Number of threads decoding the slices of DICOM series. 0 uses the number of cores.
+  /// Default is 0.
+  ///
+  /// Single-frame DICOM series read with GDCM in native orientation are decoded
+  /// (including compressed transfer syntaxes) directly into the output scalars
+  /// at the offset of each slice, without assembling an ITK image first.
+  /// Other series, and series that cannot be read that way, are read by itk::ImageSeriesReader.
+  vtkSetClampMacro(NumberOfSliceReadThreads, int, 0, 64);
+  vtkGetMacro(NumberOfSliceReadThreads, int);
+
  protected:
   vtkITKArchetypeImageSeriesScalarReader();
   ~vtkITKArchetypeImageSeriesScalarReader() override;
 
   int RequestData(vtkInformation* request, vtkInformationVector** inputVector, vtkInformationVector* outputVector) override;
   static void ReadProgressCallback(itk::ProcessObject* obj,const itk::ProgressEvent&, void* data);
+
+  /// Decode the DICOM slices in parallel directly into the scalars of \a data.
+  /// Returns false if the series cannot be read this way.
+  bool ReadDICOMSlicesInParallel(vtkImageData* data, vtkInformation* outInfo);
+
+  int NumberOfSliceReadThreads;
   /// private:
 
 private:
@@ -60,6 +60,7 @@ void vtkITKExecuteDataFromFileVector(
   typedef itk::ImageFileReader< image2 > ReaderType;
   typename ReaderType::Pointer reader2 = ReaderType::New();
   reader2->SetFileName(self->GetFileName(0));
+  reader2->ReleaseDataFlagOn();
   if (self->GetUseNativeCoordinateOrientation())
     {
     filter = reader2;
@@ -96,7 +97,9 @@ void vtkITKArchetypeImageSeriesVectorReaderFile::ExecuteDataWithInformation(vtkD
         this->SetErrorCode(vtkErrorCode::NoFileNameError);
         return;
       }
-    vtkImageData *data = this->AllocateOutputData(output, outInfo);
+    vtkImageData *data = vtkImageData::SafeDownCast(output);
+  // Voxels are not allocated here, the scalars adopt the ITK image buffer
+  this->AllocateOutputScalarsForImport(data, outInfo);
 
     // If there is only one file in the series, just use an image file reader
   if (this->FileNames.size() == 1)
@@ -128,7 +128,9 @@ void vtkITKArchetypeImageSeriesVectorReaderSeries::ExecuteDataWithInformation(vt
       this->SetErrorCode(vtkErrorCode::NoFileNameError);
       return;
     }
-  vtkImageData *data = this->AllocateOutputData(output, outInfo);
+  vtkImageData *data = vtkImageData::SafeDownCast(output);
+  // Voxels are not allocated here, the scalars adopt the ITK image buffer
+  this->AllocateOutputScalarsForImport(data, outInfo);
 
     // If there is only one file in the series, just use an image file reader
   if (this->FileNames.size() == 1)
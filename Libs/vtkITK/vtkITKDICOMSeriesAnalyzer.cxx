@@ -0,0 +1,569 @@
+/*=========================================================================
+
+  Copyright Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Program:   vtkITK
+
+==========================================================================*/
+
+// vtkITK includes
+#include "vtkITKArchetypeImageSeriesReader.h"
+#include "vtkITKDICOMSeriesAnalyzer.h"
+
+// VTK includes
+#include <vtkMath.h>
+#include <vtkObjectFactory.h>
+#include <vtkStringArray.h>
+
+// STD includes
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+vtkStandardNewMacro(vtkITKDICOMSeriesAnalyzer);
+
+namespace
+{
+/// Tags read from the headers, in the order of the TagIndex values
+const char* const ANALYZER_TAGS[] =
+  {
+  "0020|000e", // SeriesInstanceUID
+  "0020|0012", // AcquisitionNumber
+  "0008|0008", // ImageType
+  "0020|0037", // ImageOrientationPatient
+  "0018|9089", // DiffusionGradientOrientation
+  "0008|0033", // ContentTime
+  "0018|1060", // TriggerTime
+  "0020|0032", // ImagePositionPatient
+  "0028|0008", // NumberOfFrames
+  "0008|0016", // SOPClassUID
+  "0028|0004", // PhotometricInterpretation
+  "0028|0010"  // Rows
+  };
+enum TagIndex
+{
+  SeriesInstanceUIDTag = 0,
+  AcquisitionNumberTag,
+  ImageTypeTag,
+  ImageOrientationPatientTag,
+  DiffusionGradientOrientationTag,
+  ContentTimeTag,
+  TriggerTimeTag,
+  ImagePositionPatientTag,
+  NumberOfFramesTag,
+  SOPClassUIDTag,
+  PhotometricInterpretationTag,
+  RowsTag,
+  NumberOfTags
+};
+
+/// Names of the tags that split a file list into subseries, as in DICOMScalarVolumePlugin.
+/// The time tags are only used if SplitByTime is enabled.
+const TagIndex SPLIT_TAGS[] = { SeriesInstanceUIDTag, AcquisitionNumberTag, ImageTypeTag,
+  ImageOrientationPatientTag, DiffusionGradientOrientationTag, ContentTimeTag, TriggerTimeTag };
+const char* const SPLIT_TAG_NAMES[] = { "seriesInstanceUID", "acquisitionNumber", "imageType",
+  "imageOrientationPatient", "diffusionGradientOrientation", "contentTime", "triggerTime" };
+const int NUMBER_OF_SPLIT_TAGS_WITHOUT_TIME = 5;
+const int NUMBER_OF_SPLIT_TAGS = sizeof(SPLIT_TAGS) / sizeof(SPLIT_TAGS[0]);
+
+/// SOP classes that are not loaded as scalar volumes
+const char* const EXCLUDED_SOP_CLASS_UIDS[] =
+  {
+  "1.2.840.10008.5.1.4.1.1.66.4", // Segmentation Storage
+  "1.2.840.10008.5.1.4.1.1.481.3" // RT Structure Set Storage
+  };
+
+//----------------------------------------------------------------------------
+/// Parse backslash-separated numbers, returns false if there are less than \a count numbers.
+bool ParseNumbers(const std::string& value, int count, double* numbers)
+{
+  std::stringstream stream(value);
+  std::string item;
+  int index = 0;
+  while (index < count && std::getline(stream, item, '\\'))
+    {
+    char* end = nullptr;
+    numbers[index] = strtod(item.c_str(), &end);
+    if (end == item.c_str())
+      {
+      return false;
+      }
+    ++index;
+    }
+  return index == count;
+}
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+class vtkITKDICOMSeriesAnalyzer::vtkInternal
+{
+public:
+  struct Loadable
+  {
+    int FileListIndex = 0;
+    std::string SplitTag;
+    std::string SplitValue;
+    int SplitValueIndex = 0;
+    /// Indices of the files in the file list
+    std::vector<int> Files;
+    std::string Warning;
+    bool Grayscale = false;
+    bool Selected = true;
+    double Confidence = 0.5;
+  };
+
+  struct FileList
+  {
+    std::vector<std::string> FileNames;
+    /// Offset of the files of this list in the header tag values
+    size_t FirstFile = 0;
+    bool Analyzed = false;
+    std::string ExcludedSOPClassUID;
+  };
+
+  const Loadable* GetLoadable(vtkITKDICOMSeriesAnalyzer* self, int loadableIndex)
+  {
+    if (loadableIndex < 0 || loadableIndex >= static_cast<int>(this->Loadables.size()))
+      {
+      vtkErrorWithObjectMacro(self, "Invalid loadable index: " << loadableIndex);
+      return nullptr;
+      }
+    return &this->Loadables[loadableIndex];
+  }
+
+  const FileList* GetFileList(vtkITKDICOMSeriesAnalyzer* self, int fileListIndex)
+  {
+    if (fileListIndex < 0 || fileListIndex >= static_cast<int>(this->FileLists.size()))
+      {
+      vtkErrorWithObjectMacro(self, "Invalid file list index: " << fileListIndex);
+      return nullptr;
+      }
+    return &this->FileLists[fileListIndex];
+  }
+
+  const std::string& GetTagValue(const FileList& fileList, int file, TagIndex tag)
+  {
+    return this->TagValues[fileList.FirstFile + file][tag];
+  }
+
+  void AnalyzeFileList(vtkITKDICOMSeriesAnalyzer* self, int fileListIndex);
+  /// Sort the files of the loadable along the slice normal and check the spacing
+  void SortFiles(vtkITKDICOMSeriesAnalyzer* self, const FileList& fileList, Loadable& loadable);
+
+  std::vector<FileList> FileLists;
+  std::vector<std::vector<std::string> > TagValues;
+  std::vector<Loadable> Loadables;
+};
+
+//----------------------------------------------------------------------------
+void vtkITKDICOMSeriesAnalyzer::vtkInternal::AnalyzeFileList(vtkITKDICOMSeriesAnalyzer* self, int fileListIndex)
+{
+  FileList& fileList = this->FileLists[fileListIndex];
+  int numberOfFiles = static_cast<int>(fileList.FileNames.size());
+  if (!fileList.Analyzed || numberOfFiles == 0)
+    {
+    return;
+    }
+
+  std::vector<Loadable> loadables;
+
+  // default loadable includes all files of the series
+  Loadable allFilesLoadable;
+  allFilesLoadable.FileListIndex = fileListIndex;
+  for (int file = 0; file < numberOfFiles; ++file)
+    {
+    allFilesLoadable.Files.push_back(file);
+    }
+  loadables.push_back(allFilesLoadable);
+
+  // subseries for tags that have more than one value
+  int numberOfSplitTags = self->SplitByTime ? NUMBER_OF_SPLIT_TAGS : NUMBER_OF_SPLIT_TAGS_WITHOUT_TIME;
+  int subseriesCount = 0;
+  // loadables that look like the full series except a single frame
+  std::vector<size_t> probableLocalizerFreeLoadables;
+  for (int splitTagIndex = 0; splitTagIndex < numberOfSplitTags; ++splitTagIndex)
+    {
+    std::vector<std::string> values;
+    std::map<std::string, std::vector<int> > valueFiles;
+    for (int file = 0; file < numberOfFiles; ++file)
+      {
+      std::string value = this->GetTagValue(fileList, file, SPLIT_TAGS[splitTagIndex]);
+      // commas are removed as in DICOMScalarVolumePlugin
+      std::replace(value.begin(), value.end(), ',', '_');
+      if (valueFiles.find(value) == valueFiles.end())
+        {
+        values.push_back(value);
+        }
+      valueFiles[value].push_back(file);
+      }
+    if (values.size() < 2)
+      {
+      continue;
+      }
+    subseriesCount++;
+    for (size_t valueIndex = 0; valueIndex < values.size(); ++valueIndex)
+      {
+      Loadable loadable;
+      loadable.FileListIndex = fileListIndex;
+      loadable.SplitTag = SPLIT_TAG_NAMES[splitTagIndex];
+      loadable.SplitValue = values[valueIndex];
+      loadable.SplitValueIndex = static_cast<int>(valueIndex);
+      loadable.Files = valueFiles[values[valueIndex]];
+      loadable.Selected = false;
+      if (values.size() == 2 && loadable.Files.size() > 1 && valueFiles[values[1 - valueIndex]].size() == 1)
+        {
+        probableLocalizerFreeLoadables.push_back(loadables.size());
+        }
+      loadables.push_back(loadable);
+      }
+    }
+
+  // keep only files with pixel data, skip segmentation and RT structure set objects
+  std::vector<bool> kept(loadables.size(), true);
+  for (size_t loadableIndex = 0; loadableIndex < loadables.size(); ++loadableIndex)
+    {
+    Loadable& loadable = loadables[loadableIndex];
+    std::vector<int> filesWithPixelData;
+    bool excluded = false;
+    for (int file : loadable.Files)
+      {
+      if (!this->GetTagValue(fileList, file, RowsTag).empty())
+        {
+        filesWithPixelData.push_back(file);
+        }
+      const std::string& sopClassUID = this->GetTagValue(fileList, file, SOPClassUIDTag);
+      for (const char* excludedSOPClassUID : EXCLUDED_SOP_CLASS_UIDS)
+        {
+        if (sopClassUID == excludedSOPClassUID)
+          {
+          excluded = true;
+          fileList.ExcludedSOPClassUID = sopClassUID;
+          }
+        }
+      }
+    if (excluded)
+      {
+      kept[loadableIndex] = false;
+      continue;
+      }
+    if (!filesWithPixelData.empty())
+      {
+      loadable.Files = filesWithPixelData;
+      }
+    else
+      {
+      // they might be secondary capture images that can be read
+      loadable.Warning += "There is no pixel data attribute for the DICOM objects, but they might be readable as secondary capture images.  ";
+      loadable.Confidence = 0.2;
+      }
+    loadable.Grayscale = (this->GetTagValue(fileList, loadable.Files[0], PhotometricInterpretationTag).find("MONOCHROME")
+      != std::string::npos);
+    this->SortFiles(self, fileList, loadable);
+    }
+
+  // select the loadables that are clearly better than all files, otherwise all files
+  std::vector<size_t> loadablesBetterThanAllFiles;
+  if (kept[0] && !loadables[0].Warning.empty())
+    {
+    for (size_t loadableIndex : probableLocalizerFreeLoadables)
+      {
+      if (kept[loadableIndex] && loadables[loadableIndex].Warning.empty())
+        {
+        loadablesBetterThanAllFiles.push_back(loadableIndex);
+        }
+      }
+    if (loadablesBetterThanAllFiles.empty() && subseriesCount == 1)
+      {
+      // sorting warning and only one kind of subseries, the subseries are probably correct
+      for (size_t loadableIndex = 1; loadableIndex < loadables.size(); ++loadableIndex)
+        {
+        if (kept[loadableIndex] && loadables[loadableIndex].Warning.empty())
+          {
+          loadablesBetterThanAllFiles.push_back(loadableIndex);
+          }
+        }
+      }
+    }
+  if (loadablesBetterThanAllFiles.empty())
+    {
+    loadablesBetterThanAllFiles.push_back(0);
+    }
+  for (size_t loadableIndex = 0; loadableIndex < loadables.size(); ++loadableIndex)
+    {
+    if (!kept[loadableIndex])
+      {
+      continue;
+      }
+    Loadable& loadable = loadables[loadableIndex];
+    loadable.Selected = std::find(loadablesBetterThanAllFiles.begin(), loadablesBetterThanAllFiles.end(), loadableIndex)
+      != loadablesBetterThanAllFiles.end();
+    if (!loadable.Selected)
+      {
+      loadable.Confidence = std::min(loadable.Confidence, 0.45);
+      }
+    this->Loadables.push_back(loadable);
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkITKDICOMSeriesAnalyzer::vtkInternal::SortFiles(vtkITKDICOMSeriesAnalyzer* self,
+  const FileList& fileList, Loadable& loadable)
+{
+  // Same checks and warnings as DICOMUtils.getSortedImageFiles
+  if (!this->GetTagValue(fileList, loadable.Files[0], NumberOfFramesTag).empty())
+    {
+    loadable.Warning += "Multi-frame image. If slice orientation or spacing is non-uniform then the image may be displayed incorrectly. Use with caution.\n";
+    }
+
+  double sliceAxes[6] = { 0.0 };
+  double scanOrigin[3] = { 0.0 };
+  if (!ParseNumbers(this->GetTagValue(fileList, loadable.Files[0], ImageOrientationPatientTag), 6, sliceAxes)
+    || !ParseNumbers(this->GetTagValue(fileList, loadable.Files[0], ImagePositionPatientTag), 3, scanOrigin))
+    {
+    loadable.Warning += "Reference image in series does not contain geometry information. Please use caution.\n";
+    return;
+    }
+  double scanAxis[3] = { 0.0 };
+  vtkMath::Cross(sliceAxes, sliceAxes + 3, scanAxis);
+
+  std::vector<std::pair<double, int> > distances;
+  for (int file : loadable.Files)
+    {
+    double position[3] = { 0.0 };
+    double orientation[6] = { 0.0 };
+    if (!ParseNumbers(this->GetTagValue(fileList, file, ImagePositionPatientTag), 3, position)
+      || !ParseNumbers(this->GetTagValue(fileList, file, ImageOrientationPatientTag), 6, orientation))
+      {
+      loadable.Warning += "One or more images is missing geometry information in series. Please use caution.\n";
+      return;
+      }
+    double vec[3] = { position[0] - scanOrigin[0], position[1] - scanOrigin[1], position[2] - scanOrigin[2] };
+    distances.emplace_back(vtkMath::Dot(vec, scanAxis), file);
+    }
+
+  std::stable_sort(distances.begin(), distances.end(),
+    [](const std::pair<double, int>& a, const std::pair<double, int>& b) { return a.first < b.first; });
+  for (size_t i = 0; i < distances.size(); ++i)
+    {
+    loadable.Files[i] = distances[i].second;
+    }
+
+  // confirm equal spacing between slices
+  if (distances.size() > 1)
+    {
+    double spacing0 = distances[1].first - distances[0].first;
+    for (size_t i = 1; i < distances.size(); ++i)
+      {
+      double spaceError = (distances[i].first - distances[i - 1].first) - spacing0;
+      if (fabs(spaceError) > self->SpacingTolerance)
+        {
+        std::stringstream warning;
+        warning << "Images are not equally spaced (a difference of " << spaceError << " vs " << spacing0
+          << " in spacings was detected).";
+        if (self->AcquisitionGeometryRegularization)
+          {
+          warning << "  Slicer will apply a transform to this series trying to regularize the volume. Please use caution.\n";
+          }
+        else
+          {
+          warning << "  If loaded image appears distorted, enable 'Acquisition geometry regularization'"
+            " in Application settings / DICOM / DICOMScalarVolumePlugin. Please use caution.\n";
+          }
+        loadable.Warning += warning.str();
+        break;
+        }
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+vtkITKDICOMSeriesAnalyzer::vtkITKDICOMSeriesAnalyzer()
+{
+  this->SpacingTolerance = 0.01;
+  this->SplitByTime = false;
+  this->AcquisitionGeometryRegularization = false;
+  this->NumberOfHeaderReadThreads = 4;
+  this->Internal = new vtkInternal;
+}
+
+//----------------------------------------------------------------------------
+vtkITKDICOMSeriesAnalyzer::~vtkITKDICOMSeriesAnalyzer()
+{
+  delete this->Internal;
+}
+
+//----------------------------------------------------------------------------
+void vtkITKDICOMSeriesAnalyzer::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "SpacingTolerance: " << this->SpacingTolerance << "\n";
+  os << indent << "SplitByTime: " << this->SplitByTime << "\n";
+  os << indent << "AcquisitionGeometryRegularization: " << this->AcquisitionGeometryRegularization << "\n";
+  os << indent << "NumberOfHeaderReadThreads: " << this->NumberOfHeaderReadThreads << "\n";
+  os << indent << "NumberOfFileLists: " << this->Internal->FileLists.size() << "\n";
+  os << indent << "NumberOfLoadables: " << this->Internal->Loadables.size() << "\n";
+}
+
+//----------------------------------------------------------------------------
+int vtkITKDICOMSeriesAnalyzer::AddFileList(vtkStringArray* fileNames)
+{
+  vtkInternal::FileList fileList;
+  if (fileNames)
+    {
+    for (vtkIdType i = 0; i < fileNames->GetNumberOfValues(); ++i)
+      {
+      fileList.FileNames.push_back(fileNames->GetValue(i));
+      }
+    }
+  this->Internal->FileLists.push_back(fileList);
+  this->Modified();
+  return static_cast<int>(this->Internal->FileLists.size()) - 1;
+}
+
+//----------------------------------------------------------------------------
+void vtkITKDICOMSeriesAnalyzer::RemoveAllFileLists()
+{
+  this->Internal->FileLists.clear();
+  this->Internal->TagValues.clear();
+  this->Internal->Loadables.clear();
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+int vtkITKDICOMSeriesAnalyzer::GetNumberOfFileLists()
+{
+  return static_cast<int>(this->Internal->FileLists.size());
+}
+
+//----------------------------------------------------------------------------
+void vtkITKDICOMSeriesAnalyzer::Update()
+{
+  this->Internal->Loadables.clear();
+
+  // headers of all the file lists are read together so that all threads are busy
+  std::vector<std::string> allFileNames;
+  for (vtkInternal::FileList& fileList : this->Internal->FileLists)
+    {
+    fileList.FirstFile = allFileNames.size();
+    fileList.ExcludedSOPClassUID.clear();
+    allFileNames.insert(allFileNames.end(), fileList.FileNames.begin(), fileList.FileNames.end());
+    }
+  std::vector<std::string> tags(ANALYZER_TAGS, ANALYZER_TAGS + NumberOfTags);
+  std::vector<bool> readSucceeded;
+  vtkITKArchetypeImageSeriesReader::ReadDICOMHeaderTagValues(allFileNames, tags,
+    this->NumberOfHeaderReadThreads, this->Internal->TagValues, readSucceeded);
+
+  for (int fileListIndex = 0; fileListIndex < static_cast<int>(this->Internal->FileLists.size()); ++fileListIndex)
+    {
+    vtkInternal::FileList& fileList = this->Internal->FileLists[fileListIndex];
+    fileList.Analyzed = std::find(readSucceeded.begin() + fileList.FirstFile,
+      readSucceeded.begin() + fileList.FirstFile + fileList.FileNames.size(), false)
+      == readSucceeded.begin() + fileList.FirstFile + fileList.FileNames.size();
+    this->Internal->AnalyzeFileList(this, fileListIndex);
+    }
+}
+
+//----------------------------------------------------------------------------
+bool vtkITKDICOMSeriesAnalyzer::GetFileListAnalyzed(int fileListIndex)
+{
+  const vtkInternal::FileList* fileList = this->Internal->GetFileList(this, fileListIndex);
+  return fileList ? fileList->Analyzed : false;
+}
+
+//----------------------------------------------------------------------------
+const char* vtkITKDICOMSeriesAnalyzer::GetFileListExcludedSOPClassUID(int fileListIndex)
+{
+  const vtkInternal::FileList* fileList = this->Internal->GetFileList(this, fileListIndex);
+  return fileList ? fileList->ExcludedSOPClassUID.c_str() : "";
+}
+
+//----------------------------------------------------------------------------
+int vtkITKDICOMSeriesAnalyzer::GetNumberOfLoadables()
+{
+  return static_cast<int>(this->Internal->Loadables.size());
+}
+
+//----------------------------------------------------------------------------
+int vtkITKDICOMSeriesAnalyzer::GetLoadableFileListIndex(int loadableIndex)
+{
+  const vtkInternal::Loadable* loadable = this->Internal->GetLoadable(this, loadableIndex);
+  return loadable ? loadable->FileListIndex : -1;
+}
+
+//----------------------------------------------------------------------------
+const char* vtkITKDICOMSeriesAnalyzer::GetLoadableSplitTag(int loadableIndex)
+{
+  const vtkInternal::Loadable* loadable = this->Internal->GetLoadable(this, loadableIndex);
+  return loadable ? loadable->SplitTag.c_str() : "";
+}
+
+//----------------------------------------------------------------------------
+const char* vtkITKDICOMSeriesAnalyzer::GetLoadableSplitValue(int loadableIndex)
+{
+  const vtkInternal::Loadable* loadable = this->Internal->GetLoadable(this, loadableIndex);
+  return loadable ? loadable->SplitValue.c_str() : "";
+}
+
+//----------------------------------------------------------------------------
+int vtkITKDICOMSeriesAnalyzer::GetLoadableSplitValueIndex(int loadableIndex)
+{
+  const vtkInternal::Loadable* loadable = this->Internal->GetLoadable(this, loadableIndex);
+  return loadable ? loadable->SplitValueIndex : -1;
+}
+
+//----------------------------------------------------------------------------
+void vtkITKDICOMSeriesAnalyzer::GetLoadableFileNames(int loadableIndex, vtkStringArray* fileNames)
+{
+  if (!fileNames)
+    {
+    vtkErrorMacro("GetLoadableFileNames: invalid fileNames");
+    return;
+    }
+  fileNames->Initialize();
+  const vtkInternal::Loadable* loadable = this->Internal->GetLoadable(this, loadableIndex);
+  if (!loadable)
+    {
+    return;
+    }
+  const vtkInternal::FileList& fileList = this->Internal->FileLists[loadable->FileListIndex];
+  for (int file : loadable->Files)
+    {
+    fileNames->InsertNextValue(fileList.FileNames[file]);
+    }
+}
+
+//----------------------------------------------------------------------------
+const char* vtkITKDICOMSeriesAnalyzer::GetLoadableWarning(int loadableIndex)
+{
+  const vtkInternal::Loadable* loadable = this->Internal->GetLoadable(this, loadableIndex);
+  return loadable ? loadable->Warning.c_str() : "";
+}
+
+//----------------------------------------------------------------------------
+bool vtkITKDICOMSeriesAnalyzer::GetLoadableGrayscale(int loadableIndex)
+{
+  const vtkInternal::Loadable* loadable = this->Internal->GetLoadable(this, loadableIndex);
+  return loadable ? loadable->Grayscale : false;
+}
+
+//----------------------------------------------------------------------------
+bool vtkITKDICOMSeriesAnalyzer::GetLoadableSelected(int loadableIndex)
+{
+  const vtkInternal::Loadable* loadable = this->Internal->GetLoadable(this, loadableIndex);
+  return loadable ? loadable->Selected : false;
+}
+
+//----------------------------------------------------------------------------
+double vtkITKDICOMSeriesAnalyzer::GetLoadableConfidence(int loadableIndex)
+{
+  const vtkInternal::Loadable* loadable = this->Internal->GetLoadable(this, loadableIndex);
+  return loadable ? loadable->Confidence : 0.0;
+}
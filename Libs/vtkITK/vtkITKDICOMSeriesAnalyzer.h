@@ -0,0 +1,117 @@
+/*=========================================================================
+
+  Copyright Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Program:   vtkITK
+
+==========================================================================*/
+
+#ifndef __vtkITKDICOMSeriesAnalyzer_h
+#define __vtkITKDICOMSeriesAnalyzer_h
+
+#include "vtkITK.h"
+
+// VTK includes
+#include <vtkObject.h>
+
+class vtkStringArray;
+
+/// \brief Find the ways of loading DICOM series as scalar volumes.
+///
+/// Each file list (typically the files of a series) is split into subseries
+/// by the values of the tags that distinguish volumes (series instance UID,
+/// acquisition number, image type, image orientation, diffusion gradient
+/// orientation, and optionally content and trigger time), as in
+/// DICOMScalarVolumePlugin. The files of each candidate volume (loadable) are sorted
+/// along the slice normal and the slice spacing is checked for uniformity.
+///
+/// The headers of the files of all the file lists are read in parallel by
+/// vtkITKArchetypeImageSeriesReader::ReadDICOMHeaderTagValues, therefore
+/// examining a whole study costs about one header read per file, and the
+/// headers are not read again when the series are loaded afterwards.
+///
+/// Files that have no Rows attribute are considered to have no pixel data.
+/// File lists with a file that cannot be read are not analyzed
+/// (GetFileListAnalyzed() returns false), so that callers can fall back to
+/// another method for them.
+class VTK_ITK_EXPORT vtkITKDICOMSeriesAnalyzer : public vtkObject
+{
+public:
+  static vtkITKDICOMSeriesAnalyzer *New();
+  vtkTypeMacro(vtkITKDICOMSeriesAnalyzer, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  /// Add a list of files to analyze, returns the index of the file list.
+  int AddFileList(vtkStringArray* fileNames);
+  void RemoveAllFileLists();
+  int GetNumberOfFileLists();
+
+  /// Maximum difference in distance between slices to consider spacing uniform.
+  /// Default is 0.01.
+  vtkSetMacro(SpacingTolerance, double);
+  vtkGetMacro(SpacingTolerance, double);
+
+  /// Offer loading groups of slices acquired at the same content or trigger time.
+  /// Default is off.
+  vtkSetMacro(SplitByTime, bool);
+  vtkGetMacro(SplitByTime, bool);
+  vtkBooleanMacro(SplitByTime, bool);
+
+  /// Whether the acquisition geometry is regularized when the volume is loaded.
+  /// Only used for the text of the non-uniform spacing warning. Default is off.
+  vtkSetMacro(AcquisitionGeometryRegularization, bool);
+  vtkGetMacro(AcquisitionGeometryRegularization, bool);
+  vtkBooleanMacro(AcquisitionGeometryRegularization, bool);
+
+  /// Number of threads reading DICOM headers. Default is 4.
+  vtkSetClampMacro(NumberOfHeaderReadThreads, int, 1, 64);
+  vtkGetMacro(NumberOfHeaderReadThreads, int);
+
+  /// Read the headers and find the loadables of all the file lists.
+  void Update();
+
+  /// Return false if a file of the file list could not be read.
+  /// No loadables are created for such file lists.
+  bool GetFileListAnalyzed(int fileListIndex);
+  /// Segmentation or RT structure set SOP class UID found in the file list, empty if none.
+  /// Loadables containing such files are not created.
+  const char* GetFileListExcludedSOPClassUID(int fileListIndex);
+
+  /// Loadables of all the analyzed file lists, in file list order.
+  int GetNumberOfLoadables();
+  int GetLoadableFileListIndex(int loadableIndex);
+  /// Name of the tag (as in DICOMScalarVolumePlugin, e.g., "acquisitionNumber") that this
+  /// loadable is a subseries of. Empty for the loadable of all the files of the file list.
+  const char* GetLoadableSplitTag(int loadableIndex);
+  /// Value of the split tag (with commas replaced by underscores) and its index
+  /// in the order the values first appear in the file list.
+  const char* GetLoadableSplitValue(int loadableIndex);
+  int GetLoadableSplitValueIndex(int loadableIndex);
+  /// Files of the loadable, sorted along the slice normal.
+  void GetLoadableFileNames(int loadableIndex, vtkStringArray* fileNames);
+  const char* GetLoadableWarning(int loadableIndex);
+  bool GetLoadableGrayscale(int loadableIndex);
+  bool GetLoadableSelected(int loadableIndex);
+  double GetLoadableConfidence(int loadableIndex);
+
+protected:
+  vtkITKDICOMSeriesAnalyzer();
+  ~vtkITKDICOMSeriesAnalyzer() override;
+
+  double SpacingTolerance;
+  bool SplitByTime;
+  bool AcquisitionGeometryRegularization;
+  int NumberOfHeaderReadThreads;
+
+  class vtkInternal;
+  vtkInternal* Internal;
+
+private:
+  vtkITKDICOMSeriesAnalyzer(const vtkITKDICOMSeriesAnalyzer&) = delete;
+  void operator=(const vtkITKDICOMSeriesAnalyzer&) = delete;
+};
+
+#endif
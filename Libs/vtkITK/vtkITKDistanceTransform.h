@@ -11,14 +11,14 @@
 #define __vtkITKDistanceTransform_h
 
 #include "vtkITK.h"
-#include "vtkSimpleImageToImageFilter.h"
+#include "vtkITKSimpleImageToImageFilter.h"
 
 /// \brief Wrapper class around itk::SignedMaurerDistanceMapImageFilter.
-class VTK_ITK_EXPORT vtkITKDistanceTransform : public vtkSimpleImageToImageFilter
+class VTK_ITK_EXPORT vtkITKDistanceTransform : public vtkITKSimpleImageToImageFilter
 {
 public:
   static vtkITKDistanceTransform *New();
-  vtkTypeMacro(vtkITKDistanceTransform, vtkSimpleImageToImageFilter);
+  vtkTypeMacro(vtkITKDistanceTransform, vtkITKSimpleImageToImageFilter);
   void PrintSelf(ostream& os, vtkIndent indent) override;
 
   /// Output volume contains square of distance or actual distance
@@ -44,6 +44,9 @@ protected:
 
   void SimpleExecute(vtkImageData* input, vtkImageData* output) override;
 
+  template <class T>
+  void ExecuteWithScalarType(vtkImageData* input, vtkImageData* output);
+
   int SquaredDistance;
   int InsideIsPositive;
   int UseImageSpacing;
@@ -11,10 +11,96 @@
   Version:   $Revision$
 
 ==========================================================================*/
+
 #include "vtkITKGradientAnisotropicDiffusionImageFilter.h"
 
+// VTK includes
+#include <vtkDataArray.h>
+#include <vtkInformation.h>
+#include <vtkInformationVector.h>
+#include <vtkObjectFactory.h>
+#include <vtkPointData.h>
+
+// ITK includes
+#include <itkGradientAnisotropicDiffusionImageFilter.h>
+
 vtkStandardNewMacro(vtkITKGradientAnisotropicDiffusionImageFilter);
 
+namespace
+{
+typedef itk::Image<float, 3> OutputImageType;
+}
+
+//----------------------------------------------------------------------------
+vtkITKGradientAnisotropicDiffusionImageFilter::vtkITKGradientAnisotropicDiffusionImageFilter()
+{
+  typedef itk::GradientAnisotropicDiffusionImageFilter<OutputImageType, OutputImageType> DefaultFilterType;
+  DefaultFilterType::Pointer defaultFilter = DefaultFilterType::New();
+  this->TimeStep = defaultFilter->GetTimeStep();
+  this->ConductanceParameter = defaultFilter->GetConductanceParameter();
+  this->NumberOfIterations = defaultFilter->GetNumberOfIterations();
+}
+
+//----------------------------------------------------------------------------
+vtkITKGradientAnisotropicDiffusionImageFilter::~vtkITKGradientAnisotropicDiffusionImageFilter() = default;
+
+//----------------------------------------------------------------------------
+void vtkITKGradientAnisotropicDiffusionImageFilter::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "TimeStep: " << this->TimeStep << std::endl;
+  os << indent << "ConductanceParameter: " << this->ConductanceParameter << std::endl;
+  os << indent << "NumberOfIterations: " << this->NumberOfIterations << std::endl;
+}
 
+//----------------------------------------------------------------------------
+int vtkITKGradientAnisotropicDiffusionImageFilter::RequestInformation(vtkInformation* request,
+  vtkInformationVector** inputVector, vtkInformationVector* outputVector)
+{
+  if (!this->Superclass::RequestInformation(request, inputVector, outputVector))
+    {
+    return 0;
+    }
+  vtkInformation* outInfo = outputVector->GetInformationObject(0);
+  vtkDataObject::SetPointDataActiveScalarInfo(outInfo, VTK_FLOAT, 1);
+  return 1;
+}
 
+//----------------------------------------------------------------------------
+template <class T>
+void vtkITKGradientAnisotropicDiffusionImageFilter::ExecuteWithScalarType(vtkImageData* input, vtkImageData* output)
+{
+  typedef itk::Image<T, 3> InputImageType;
+  typedef itk::GradientAnisotropicDiffusionImageFilter<InputImageType, OutputImageType> ImageFilterType;
+  typename ImageFilterType::Pointer filter = ImageFilterType::New();
+  this->ConfigureITKFilter(filter.GetPointer());
+  filter->SetTimeStep(this->TimeStep);
+  filter->SetConductanceParameter(this->ConductanceParameter);
+  filter->SetNumberOfIterations(this->NumberOfIterations);
+  filter->SetInput(this->ImportVTKImage<T>(input));
+  this->UpdateITKOutput(filter.GetPointer(), output);
+}
 
+//----------------------------------------------------------------------------
+void vtkITKGradientAnisotropicDiffusionImageFilter::SimpleExecute(vtkImageData* input, vtkImageData* output)
+{
+  vtkDataArray* inScalars = input->GetPointData()->GetScalars();
+  if (!inScalars)
+    {
+    vtkErrorMacro(<< "Scalars must be defined for gradient anisotropic diffusion");
+    return;
+    }
+  if (inScalars->GetNumberOfComponents() != 1)
+    {
+    vtkErrorMacro(<< "Only single component images supported.");
+    return;
+    }
+  switch (inScalars->GetDataType())
+    {
+    vtkITKTemplateMacro(this->ExecuteWithScalarType<VTK_TT>(input, output));
+    default:
+      {
+      vtkErrorMacro(<< "Incompatible data type for this version of ITK.");
+      }
+    }
+}
@@ -15,54 +15,41 @@
 #ifndef __vtkITKGradientAnisotropicDiffusionImageFilter_h
 #define __vtkITKGradientAnisotropicDiffusionImageFilter_h
 
-#include "vtkITKImageToImageFilterFF.h"
-#include "itkGradientAnisotropicDiffusionImageFilter.h"
+#include "vtkITKSimpleImageToImageFilter.h"
 
 /// \brief Wrapper class around itk::GradientAnisotropicDiffusionImageFilterImageFilter.
 ///
 /// vtkITKGradientAnisotropicDiffusionImageFilter
-class VTK_ITK_EXPORT vtkITKGradientAnisotropicDiffusionImageFilter : public vtkITKImageToImageFilterFF
+/// Output scalar type is float.
+class VTK_ITK_EXPORT vtkITKGradientAnisotropicDiffusionImageFilter : public vtkITKSimpleImageToImageFilter
 {
  public:
   static vtkITKGradientAnisotropicDiffusionImageFilter *New();
-  vtkTypeMacro(vtkITKGradientAnisotropicDiffusionImageFilter, vtkITKImageToImageFilterFF);
+  vtkTypeMacro(vtkITKGradientAnisotropicDiffusionImageFilter, vtkITKSimpleImageToImageFilter);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
 
-  double GetTimeStep ()
-  {
-    DelegateITKOutputMacro(GetTimeStep) ;
-  };
+  /// Parameters of the filter. Default values are the ITK defaults.
+  vtkGetMacro(TimeStep, double);
+  vtkSetMacro(TimeStep, double);
+  vtkGetMacro(ConductanceParameter, double);
+  vtkSetMacro(ConductanceParameter, double);
+  vtkGetMacro(NumberOfIterations, unsigned int);
+  vtkSetMacro(NumberOfIterations, unsigned int);
 
-  double GetConductanceParameter ()
-  {
-    DelegateITKOutputMacro(GetConductanceParameter) ;
-  };
-
-  unsigned int GetNumberOfIterations ()
-  {
-    DelegateITKOutputMacro ( GetNumberOfIterations );
-  };
-
-  void SetNumberOfIterations( unsigned int value )
-  {
-    DelegateITKInputMacro ( SetNumberOfIterations, value );
-  };
-
-  void SetTimeStep ( double value )
-  {
-    DelegateITKInputMacro ( SetTimeStep, value );
-  };
+protected:
+  vtkITKGradientAnisotropicDiffusionImageFilter();
+  ~vtkITKGradientAnisotropicDiffusionImageFilter() override;
 
-  void SetConductanceParameter ( double value )
-  {
-    DelegateITKInputMacro ( SetConductanceParameter, value );
-  };
+  int RequestInformation(vtkInformation* request, vtkInformationVector** inputVector,
+    vtkInformationVector* outputVector) override;
+  void SimpleExecute(vtkImageData* input, vtkImageData* output) override;
 
-protected:
-  typedef itk::GradientAnisotropicDiffusionImageFilter<Superclass::InputImageType,Superclass::InputImageType> ImageFilterType;
-  vtkITKGradientAnisotropicDiffusionImageFilter() : Superclass ( ImageFilterType::New() ){};
-  ~vtkITKGradientAnisotropicDiffusionImageFilter() override  = default;
-  ImageFilterType* GetImageFilterPointer() { return dynamic_cast<ImageFilterType*> ( m_Filter.GetPointer() ); }
+  template <class T>
+  void ExecuteWithScalarType(vtkImageData* input, vtkImageData* output);
 
+  double TimeStep;
+  double ConductanceParameter;
+  unsigned int NumberOfIterations;
 
 private:
   vtkITKGradientAnisotropicDiffusionImageFilter(const vtkITKGradientAnisotropicDiffusionImageFilter&) = delete;
@@ -28,12 +28,19 @@
 #include <vtkMath.h>
 #include <vtkObjectFactory.h>
 #include <vtkPointData.h>
+#include <vtkSMPTools.h>
 
 /// ITK includes
 #include <itkBinaryThresholdImageFilter.h>
 #include <itkCommand.h>
 #include <itkSignedMaurerDistanceMapImageFilter.h>
 
+/// STD includes
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
 vtkStandardNewMacro(vtkITKImageMargin);
 
 //----------------------------------------------------------------------------
@@ -50,96 +57,275 @@ vtkITKImageMargin::~vtkITKImageMargin() = default;
 void vtkITKImageMargin::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os,indent);
+  os << indent << "BackgroundValue: " << this->BackgroundValue << std::endl;
+  os << indent << "CalculateMarginInMM: " << this->CalculateMarginInMM << std::endl;
+  os << indent << "OuterMarginMM: " << this->OuterMarginMM << std::endl;
+  os << indent << "InnerMarginMM: " << this->InnerMarginMM << std::endl;
+  os << indent << "OuterMarginVoxels: " << this->OuterMarginVoxels << std::endl;
+  os << indent << "InnerMarginVoxels: " << this->InnerMarginVoxels << std::endl;
+  os << indent << "UseParallelDistanceTransform: " << this->UseParallelDistanceTransform << std::endl;
 }
 
 //----------------------------------------------------------------------------
-// signed distance field
-// sdf and sdfMargin are based on:
-// https://github.com/KitwareMedical/HASI/blob/fe38e0f08682fd3ba2fd9ec816118b844321fdb8/segmentBonesInMicroCT.cxx#L102-L155
-template <typename InputPixelType, unsigned Dimension>
-itk::SmartPointer<itk::Image<float, Dimension> >
-sdf(itk::SmartPointer<itk::Image<InputPixelType, Dimension> > labelImage, int backgroundValue)
+// Squared Euclidean distance transform of a sampled function along one line
+// (Felzenszwalb and Huttenlocher, Distance Transforms of Sampled Functions, 2012).
+// f contains the input values on input and the squared distances on output.
+// Samples with infinite value are not used as sites.
+// v, z, and d are work buffers with size of at least n, n+1, and n.
+void DistanceTransform1D(float* f, vtkIdType stride, int n, double spacing,
+  std::vector<int>& v, std::vector<double>& z, std::vector<double>& d)
 {
-  using RealImageType = itk::Image<float, Dimension>;
-  using LabelImageType = itk::Image<InputPixelType, Dimension>;
-  using DistanceFieldType = itk::SignedMaurerDistanceMapImageFilter<LabelImageType, RealImageType>;
-
-  typename DistanceFieldType::Pointer distF = DistanceFieldType::New();
-  distF->SetInput(labelImage);
-  distF->SetSquaredDistance(true);
-  distF->SetBackgroundValue(backgroundValue);
-  distF->Update();
-  return distF->GetOutput();
+  const double inf = std::numeric_limits<double>::infinity();
+  int k = -1;
+  for (int q = 0; q < n; q++)
+    {
+    double fq = f[q * stride];
+    if (fq == std::numeric_limits<float>::infinity())
+      {
+      continue;
+      }
+    double position = q * spacing;
+    double s = -inf;
+    while (k >= 0)
+      {
+      double previousPosition = v[k] * spacing;
+      s = ((fq + position * position) - (f[v[k] * stride] + previousPosition * previousPosition))
+        / (2.0 * (position - previousPosition));
+      if (s > z[k])
+        {
+        break;
+        }
+      k--;
+      }
+    k++;
+    v[k] = q;
+    z[k] = (k == 0 ? -inf : s);
+    z[k + 1] = inf;
+    }
+  if (k < 0)
+    {
+    // no sites, distance remains infinite
+    return;
+    }
+  int j = 0;
+  for (int q = 0; q < n; q++)
+    {
+    double position = q * spacing;
+    while (z[j + 1] < position)
+      {
+      j++;
+      }
+    double distance = position - v[j] * spacing;
+    d[q] = distance * distance + f[v[j] * stride];
+    }
+  for (int q = 0; q < n; q++)
+    {
+    f[q * stride] = static_cast<float>(d[q]);
+    }
 }
 
 //----------------------------------------------------------------------------
-template <typename ImageType>
-itk::SmartPointer<ImageType>
-sdfMargin(itk::SmartPointer<ImageType> labelImage, int backgroundValue, double innerMarginMM, double outerMarginMM)
+// Compute margin using an exact separable Euclidean distance transform.
+// Signed squared distance is computed similarly to itk::SignedMaurerDistanceMapImageFilter:
+// distance is zero at the contour of the foreground (foreground voxels that have a background face neighbor),
+// negative inside and positive outside. Only the bounding box of the foreground, expanded by the outer margin
+// and a background layer, is processed, as distances are exact in any box that contains the foreground
+// and voxels outside this box are further from the foreground than the outer margin.
+// Returns false if the margin cannot be computed by this method (and then ITK filter has to be used).
+template <class T>
+bool vtkITKImageMarginParallelExecute(vtkITKImageMargin *self, vtkImageData* input,
+                T* inPtr, T* outPtr, double innerMarginDistance, double outerMarginDistance)
 {
-  innerMarginMM -= std::numeric_limits<double>::epsilon();
-  outerMarginMM += std::numeric_limits<double>::epsilon();
+  int dims[3];
+  input->GetDimensions(dims);
+  double spacing[3] = { 1.0, 1.0, 1.0 };
+  if (self->GetCalculateMarginInMM())
+    {
+    input->GetSpacing(spacing);
+    }
+  const T backgroundValue = static_cast<T>(self->GetBackgroundValue());
+  const vtkIdType dimXY = static_cast<vtkIdType>(dims[0]) * dims[1];
+  const vtkIdType numberOfVoxels = dimXY * dims[2];
 
-  using RealImageType = itk::Image<float, ImageType::ImageDimension>;
-  using FloatThresholdType = itk::BinaryThresholdImageFilter<RealImageType, ImageType>;
-  typename FloatThresholdType::Pointer sdfTh = FloatThresholdType::New();
-  sdfTh->SetInput(sdf<typename ImageType::PixelType, ImageType::ImageDimension>(labelImage, backgroundValue));
-  if (innerMarginMM > vtkMath::NegInf())
+  // Foreground bounding box
+  int foregroundExtent[6] = { dims[0], -1, dims[1], -1, dims[2], -1 };
+  const T* voxelPtr = inPtr;
+  for (int k = 0; k < dims[2]; k++)
     {
-    sdfTh->SetLowerThreshold(innerMarginMM*std::abs(innerMarginMM));
+    for (int j = 0; j < dims[1]; j++)
+      {
+      for (int i = 0; i < dims[0]; i++, voxelPtr++)
+        {
+        if (*voxelPtr != backgroundValue)
+          {
+          foregroundExtent[0] = std::min(foregroundExtent[0], i);
+          foregroundExtent[1] = std::max(foregroundExtent[1], i);
+          foregroundExtent[2] = std::min(foregroundExtent[2], j);
+          foregroundExtent[3] = std::max(foregroundExtent[3], j);
+          foregroundExtent[4] = std::min(foregroundExtent[4], k);
+          foregroundExtent[5] = k;
+          }
+        }
+      }
     }
-  sdfTh->SetUpperThreshold(outerMarginMM*std::abs(outerMarginMM));
-  sdfTh->Update();
-  return sdfTh->GetOutput();
+  if (foregroundExtent[1] < foregroundExtent[0] || std::isinf(outerMarginDistance))
+    {
+    // empty image or unlimited outer margin, let ITK filter handle these special cases
+    return false;
+    }
+
+  // Region to process
+  int region[6] = { 0, -1, 0, -1, 0, -1 };
+  for (int axis = 0; axis < 3; axis++)
+    {
+    int marginVoxels = std::max(0, static_cast<int>(std::ceil(outerMarginDistance / spacing[axis]))) + 1;
+    region[axis * 2] = std::max(0, foregroundExtent[axis * 2] - marginVoxels);
+    region[axis * 2 + 1] = std::min(dims[axis] - 1, foregroundExtent[axis * 2 + 1] + marginVoxels);
+    }
+  const int regionDims[3] = { region[1] - region[0] + 1, region[3] - region[2] + 1, region[5] - region[4] + 1 };
+  const vtkIdType regionDimXY = static_cast<vtkIdType>(regionDims[0]) * regionDims[1];
+  const vtkIdType numberOfRegionVoxels = regionDimXY * regionDims[2];
+
+  // Initialize distance: 0 at the contour, infinite elsewhere
+  const float inf = std::numeric_limits<float>::infinity();
+  std::vector<float> distances(numberOfRegionVoxels, inf);
+  std::vector<unsigned char> contourFoundInSlice(regionDims[2], 0);
+  vtkSMPTools::For(0, regionDims[2], [&](vtkIdType beginZ, vtkIdType endZ)
+    {
+    for (vtkIdType rz = beginZ; rz < endZ; rz++)
+      {
+      int k = static_cast<int>(rz) + region[4];
+      for (int j = region[2]; j <= region[3]; j++)
+        {
+        const T* rowPtr = inPtr + k * dimXY + static_cast<vtkIdType>(j) * dims[0];
+        float* distancePtr = &distances[rz * regionDimXY + static_cast<vtkIdType>(j - region[2]) * regionDims[0]];
+        for (int i = region[0]; i <= region[1]; i++)
+          {
+          if (rowPtr[i] == backgroundValue)
+            {
+            continue;
+            }
+          if ((i > 0 && rowPtr[i - 1] == backgroundValue) || (i < dims[0] - 1 && rowPtr[i + 1] == backgroundValue)
+            || (j > 0 && rowPtr[i - dims[0]] == backgroundValue) || (j < dims[1] - 1 && rowPtr[i + dims[0]] == backgroundValue)
+            || (k > 0 && rowPtr[i - dimXY] == backgroundValue) || (k < dims[2] - 1 && rowPtr[i + dimXY] == backgroundValue))
+            {
+            distancePtr[i - region[0]] = 0.0f;
+            contourFoundInSlice[rz] = 1;
+            }
+          }
+        }
+      }
+    });
+  if (std::find(contourFoundInSlice.begin(), contourFoundInSlice.end(), 1) == contourFoundInSlice.end())
+    {
+    // the entire image is foreground, let ITK filter handle it
+    return false;
+    }
+
+  // Separable distance transform: X, Y, Z passes, each line is processed independently
+  const vtkIdType strides[3] = { 1, regionDims[0], regionDimXY };
+  for (int axis = 0; axis < 3; axis++)
+    {
+    const int lineLength = regionDims[axis];
+    const int otherAxis1 = (axis == 0 ? 1 : 0);
+    const int otherAxis2 = (axis == 2 ? 1 : 2);
+    const vtkIdType numberOfLines = static_cast<vtkIdType>(regionDims[otherAxis1]) * regionDims[otherAxis2];
+    const double lineSpacing = spacing[axis];
+    vtkSMPTools::For(0, numberOfLines, [&](vtkIdType beginLine, vtkIdType endLine)
+      {
+      std::vector<int> v(lineLength);
+      std::vector<double> z(lineLength + 1);
+      std::vector<double> d(lineLength);
+      for (vtkIdType line = beginLine; line < endLine; line++)
+        {
+        vtkIdType index1 = line % regionDims[otherAxis1];
+        vtkIdType index2 = line / regionDims[otherAxis1];
+        float* linePtr = &distances[index1 * strides[otherAxis1] + index2 * strides[otherAxis2]];
+        DistanceTransform1D(linePtr, strides[axis], lineLength, lineSpacing, v, z, d);
+        }
+      });
+    }
+
+  // Threshold signed squared distance (same thresholds as used for ITK distance map)
+  innerMarginDistance -= std::numeric_limits<double>::epsilon();
+  outerMarginDistance += std::numeric_limits<double>::epsilon();
+  const double lowerThreshold = (innerMarginDistance > vtkMath::NegInf() ?
+    innerMarginDistance * std::abs(innerMarginDistance) : vtkMath::NegInf());
+  const double upperThreshold = outerMarginDistance * std::abs(outerMarginDistance);
+  const T insideValue = std::numeric_limits<T>::max();
+  memset(outPtr, 0, numberOfVoxels * sizeof(T));
+  vtkSMPTools::For(0, regionDims[2], [&](vtkIdType beginZ, vtkIdType endZ)
+    {
+    for (vtkIdType rz = beginZ; rz < endZ; rz++)
+      {
+      vtkIdType k = rz + region[4];
+      for (int j = region[2]; j <= region[3]; j++)
+        {
+        const T* inRowPtr = inPtr + k * dimXY + static_cast<vtkIdType>(j) * dims[0] + region[0];
+        T* outRowPtr = outPtr + k * dimXY + static_cast<vtkIdType>(j) * dims[0] + region[0];
+        const float* distancePtr = &distances[rz * regionDimXY + static_cast<vtkIdType>(j - region[2]) * regionDims[0]];
+        for (int i = 0; i < regionDims[0]; i++)
+          {
+          double signedDistance = (inRowPtr[i] == backgroundValue ? distancePtr[i] : -distancePtr[i]);
+          outRowPtr[i] = (signedDistance >= lowerThreshold && signedDistance <= upperThreshold) ? insideValue : 0;
+          }
+        }
+      }
+    });
+  return true;
 }
 
 //----------------------------------------------------------------------------
+// Margin from thresholding the signed distance field
+// based on:
+// https://github.com/KitwareMedical/HASI/blob/fe38e0f08682fd3ba2fd9ec816118b844321fdb8/segmentBonesInMicroCT.cxx#L102-L155
 template <class T>
-void vtkITKImageMarginExecute(vtkITKImageMargin *self, vtkImageData* input,
-                vtkImageData* vtkNotUsed(output),
-                T* inPtr, T* outPtr)
+void vtkITKImageMargin::ExecuteWithScalarType(vtkImageData* input, vtkImageData* output)
 {
-  try
+  double innerMarginDistance = this->GetInnerMarginVoxels();
+  double outerMarginDistance = this->GetOuterMarginVoxels();
+  if (this->GetCalculateMarginInMM())
     {
-    int dims[3];
-    input->GetDimensions(dims);
-    double spacing[3];
-    input->GetSpacing(spacing);
+    innerMarginDistance = this->GetInnerMarginMM();
+    outerMarginDistance = this->GetOuterMarginMM();
+    }
 
-    // Wrap scalars into an ITK image
-    // - mostly rely on defaults for spacing, origin etc for this filter
-    typedef itk::Image<T, 3> ImageType;
-    typename ImageType::Pointer inImage = ImageType::New();
-    typename ImageType::RegionType region;
-    typename ImageType::IndexType index;
-    typename ImageType::SizeType size;
-
-    inImage->GetPixelContainer()->SetImportPointer(inPtr, dims[0] * dims[1] * dims[2], false);
-    index[0] = index[1] = index[2] = 0;
-    region.SetIndex(index);
-    size[0] = dims[0]; size[1] = dims[1]; size[2] = dims[2];
-    region.SetSize(size);
-    inImage->SetLargestPossibleRegion(region);
-    inImage->SetBufferedRegion(region);
-
-    double innerMarginDistance = self->GetInnerMarginVoxels();
-    double outerMarginDistance = self->GetOuterMarginVoxels();
-    if (self->GetCalculateMarginInMM())
-      {
-      inImage->SetSpacing(spacing);
-      innerMarginDistance = self->GetInnerMarginMM();
-      outerMarginDistance = self->GetOuterMarginMM();
-      }
+  if (this->GetUseParallelDistanceTransform()
+    && vtkITKImageMarginParallelExecute<T>(this, input, static_cast<T*>(input->GetScalarPointer()),
+      static_cast<T*>(output->GetScalarPointer()), innerMarginDistance, outerMarginDistance))
+    {
+    return;
+    }
+
+  // Wrap scalars into an ITK image
+  // - mostly rely on defaults for direction for this filter
+  typedef itk::Image<T, 3> ImageType;
+  typename ImageType::Pointer inImage = this->ImportVTKImage<T>(input, this->GetCalculateMarginInMM());
 
-    itk::SmartPointer<ImageType> outputImage;
-    outputImage = sdfMargin<ImageType>(inImage, self->GetBackgroundValue(), innerMarginDistance, outerMarginDistance);
+  using RealImageType = itk::Image<float, 3>;
+  using DistanceFieldType = itk::SignedMaurerDistanceMapImageFilter<ImageType, RealImageType>;
+  typename DistanceFieldType::Pointer distF = DistanceFieldType::New();
+  this->ConfigureITKFilter(distF.GetPointer());
+  distF->SetInput(inImage);
+  distF->SetSquaredDistance(true);
+  distF->SetBackgroundValue(this->GetBackgroundValue());
 
-    // Copy to the output
-    memcpy(outPtr, outputImage->GetBufferPointer(), outputImage->GetBufferedRegion().GetNumberOfPixels() * sizeof(T));
+  innerMarginDistance -= std::numeric_limits<double>::epsilon();
+  outerMarginDistance += std::numeric_limits<double>::epsilon();
+
+  using FloatThresholdType = itk::BinaryThresholdImageFilter<RealImageType, ImageType>;
+  typename FloatThresholdType::Pointer sdfTh = FloatThresholdType::New();
+  this->ConfigureITKFilter(sdfTh.GetPointer());
+  sdfTh->SetInput(distF->GetOutput());
+  if (innerMarginDistance > vtkMath::NegInf())
+    {
+    sdfTh->SetLowerThreshold(innerMarginDistance*std::abs(innerMarginDistance));
     }
-  catch (itk::ExceptionObject & err)
+  sdfTh->SetUpperThreshold(outerMarginDistance*std::abs(outerMarginDistance));
+
+  if (!this->UpdateITKOutput(sdfTh.GetPointer(), output))
     {
-    vtkErrorWithObjectMacro(self, "Failed to compute margin. Details: " << err);
+    vtkErrorMacro("Failed to compute margin.");
     }
 }
 
@@ -172,29 +358,9 @@ void vtkITKImageMargin::SimpleExecute(vtkImageData *input, vtkImageData *output)
 
   if (inScalars->GetNumberOfComponents() == 1)
     {
-
-////////// These types are not defined in itk ////////////
-#undef VTK_TYPE_USE_LONG_LONG
-#undef VTK_TYPE_USE___INT64
-
-#define CALL  vtkITKImageMarginExecute(this, input, output, static_cast<VTK_TT *>(inPtr), static_cast<VTK_TT *>(outPtr));
-
-    void* inPtr = input->GetScalarPointer();
-    void* outPtr = output->GetScalarPointer();
-
     switch (inScalars->GetDataType())
       {
-      vtkTemplateMacroCase(VTK_LONG, long, CALL);                               \
-      vtkTemplateMacroCase(VTK_UNSIGNED_LONG, unsigned long, CALL);             \
-      vtkTemplateMacroCase(VTK_INT, int, CALL);                                 \
-      vtkTemplateMacroCase(VTK_UNSIGNED_INT, unsigned int, CALL);               \
-      vtkTemplateMacroCase(VTK_SHORT, short, CALL);                             \
-      vtkTemplateMacroCase(VTK_UNSIGNED_SHORT, unsigned short, CALL);           \
-      vtkTemplateMacroCase(VTK_CHAR, char, CALL);                               \
-      vtkTemplateMacroCase(VTK_SIGNED_CHAR, signed char, CALL);                 \
-      vtkTemplateMacroCase(VTK_UNSIGNED_CHAR, unsigned char, CALL);             \
-      vtkTemplateMacroCase(VTK_FLOAT, float, CALL);                             \
-      vtkTemplateMacroCase(VTK_DOUBLE, double, CALL);                           \
+      vtkITKTemplateMacro(this->ExecuteWithScalarType<VTK_TT>(input, output));
       default:
         {
         vtkErrorMacro(<< "Incompatible data type for this version of ITK.");
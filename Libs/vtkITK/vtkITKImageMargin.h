@@ -22,17 +22,17 @@
 #define __vtkITKImageMargin_h
 
 #include "vtkITK.h"
-#include "vtkSimpleImageToImageFilter.h"
+#include "vtkITKSimpleImageToImageFilter.h"
 
 /// \brief ITK-based utilities for manipulating connected regions in label maps.
 /// Limitation: The filter does not work correctly with input volume that has
 /// unsigned long scalar type on Linux and MacOSX.
 ///
-class VTK_ITK_EXPORT vtkITKImageMargin : public vtkSimpleImageToImageFilter
+class VTK_ITK_EXPORT vtkITKImageMargin : public vtkITKSimpleImageToImageFilter
 {
  public:
   static vtkITKImageMargin *New();
-  vtkTypeMacro(vtkITKImageMargin, vtkSimpleImageToImageFilter);
+  vtkTypeMacro(vtkITKImageMargin, vtkITKSimpleImageToImageFilter);
   void PrintSelf(ostream& os, vtkIndent indent) override;
 
   /// The background value that is considered "outside" the image.
@@ -69,6 +69,13 @@ class VTK_ITK_EXPORT vtkITKImageMargin : public vtkSimpleImageToImageFilter
   vtkGetMacro(InnerMarginVoxels, double);
   vtkSetMacro(InnerMarginVoxels, double);
 
+  /// If enabled (default), the margin is computed using a parallel exact Euclidean distance transform,
+  /// restricted to the bounding box of the foreground expanded by the outer margin.
+  /// If disabled, ITK signed Maurer distance map is computed for the whole image.
+  vtkGetMacro(UseParallelDistanceTransform, bool);
+  vtkSetMacro(UseParallelDistanceTransform, bool);
+  vtkBooleanMacro(UseParallelDistanceTransform, bool);
+
 protected:
   int BackgroundValue{0};
   bool CalculateMarginInMM{true};
@@ -76,6 +83,7 @@ protected:
   double InnerMarginMM{0.0};
   double OuterMarginVoxels{0.0};
   double InnerMarginVoxels{0.0};
+  bool UseParallelDistanceTransform{true};
 
 protected:
   vtkITKImageMargin();
@@ -83,6 +91,9 @@ protected:
 
   void SimpleExecute(vtkImageData* input, vtkImageData* output) override;
 
+  template <class T>
+  void ExecuteWithScalarType(vtkImageData* input, vtkImageData* output);
+
 private:
   vtkITKImageMargin(const vtkITKImageMargin&) = delete;
   void operator=(const vtkITKImageMargin&) = delete;
@@ -17,12 +17,11 @@
 
 // VTK includes
 #include <vtkDataArray.h>
-#include <vtkImageExport.h>
 #include <vtkInformation.h>
 #include <vtkInformationVector.h>
-#include <vtkITKUtility.h>
-#include <vtkNew.h>
+#include <vtkMath.h>
 #include <vtkPointData.h>
+#include <vtkSMPTools.h>
 #include <vtkStreamingDemandDrivenPipeline.h>
 #include <vtkVersion.h>
 
@@ -32,7 +31,7 @@
 // ITK includes
 #include "itkHistogramThresholdCalculator.h"
 #include "itkHuangThresholdCalculator.h"
-#include "itkImageToHistogramFilter.h"
+#include "itkHistogram.h"
 #include "itkIntermodesThresholdCalculator.h"
 #include "itkIsoDataThresholdCalculator.h"
 #include "itkKittlerIllingworthThresholdCalculator.h"
@@ -43,42 +42,58 @@
 #include "itkRenyiEntropyThresholdCalculator.h"
 #include "itkShanbhagThresholdCalculator.h"
 #include "itkTriangleThresholdCalculator.h"
-#include "itkVTKImageImport.h"
 #include "itkYenThresholdCalculator.h"
 
+// STD includes
+#include <algorithm>
+#include <mutex>
+
 vtkStandardNewMacro(vtkITKImageThresholdCalculator);
 
-// helper function
-template <class TPixelType>
-void ITKComputeThresholdFromVTKImage(vtkITKImageThresholdCalculator *self, vtkImageData *inputImage, double& computedThreshold)
+namespace
 {
-  typedef itk::Image<TPixelType, 3> ImageType;
-  typedef itk::Statistics::ImageToHistogramFilter<ImageType> HistogramGeneratorType;
-  typedef typename HistogramGeneratorType::HistogramType HistogramType;
-  typedef itk::HistogramThresholdCalculator<HistogramType, double> CalculatorType;
-
-  // itk import for input itk images
-  typedef typename itk::VTKImageImport<ImageType> ImageImportType;
-  typename ImageImportType::Pointer itkImporter = ImageImportType::New();
-
-  // vtk export for  vtk image
-  vtkNew<vtkImageExport> vtkExporter;
+typedef itk::Statistics::Histogram<double> HistogramType;
+typedef itk::HistogramThresholdCalculator<HistogramType, double> CalculatorType;
 
-  vtkExporter->SetInputData ( inputImage );
+/// Voxels are processed in blocks of this size, each block accumulates to
+/// its own histogram, which is added to the total when the block is completed.
+const vtkIdType HISTOGRAM_BLOCK_SIZE = 65536;
 
-  ConnectPipelines(vtkExporter.GetPointer(), itkImporter);
-  itkImporter->UpdateLargestPossibleRegion();
-
-  typename HistogramGeneratorType::Pointer histGenerator = HistogramGeneratorType::New();
-  histGenerator->SetInput(itkImporter->GetOutput());
-  typename HistogramGeneratorType::HistogramSizeType hsize(1);
-  hsize[0] = 64;
-  histGenerator->SetHistogramSize( hsize );
-  histGenerator->SetAutoMinimumMaximum( true );
+//----------------------------------------------------------------------------
+template <class TPixelType>
+void ComputeHistogram(const TPixelType* voxels, vtkIdType numberOfVoxels,
+  double minimum, double binWidth, std::vector<double>& frequencies)
+{
+  int numberOfBins = static_cast<int>(frequencies.size());
+  vtkIdType numberOfBlocks = (numberOfVoxels + HISTOGRAM_BLOCK_SIZE - 1) / HISTOGRAM_BLOCK_SIZE;
+  std::mutex frequenciesMutex;
+  vtkSMPTools::For(0, numberOfBlocks, [&](vtkIdType beginBlock, vtkIdType endBlock)
+    {
+    std::vector<vtkIdType> blockFrequencies(numberOfBins, 0);
+    vtkIdType endVoxel = std::min(endBlock * HISTOGRAM_BLOCK_SIZE, numberOfVoxels);
+    for (vtkIdType voxelIndex = beginBlock * HISTOGRAM_BLOCK_SIZE; voxelIndex < endVoxel; voxelIndex++)
+      {
+      double value = static_cast<double>(voxels[voxelIndex]);
+      if (vtkMath::IsNan(value))
+        {
+        continue;
+        }
+      int bin = static_cast<int>((value - minimum) / binWidth);
+      blockFrequencies[std::max(0, std::min(bin, numberOfBins - 1))]++;
+      }
+    std::lock_guard<std::mutex> lock(frequenciesMutex);
+    for (int bin = 0; bin < numberOfBins; bin++)
+      {
+      frequencies[bin] += static_cast<double>(blockFrequencies[bin]);
+      }
+    });
+}
 
-  // Create and initialize the calculator
-  typename CalculatorType::Pointer calculator;
-  switch (self->GetMethod())
+//----------------------------------------------------------------------------
+CalculatorType::Pointer CreateCalculator(int method)
+{
+  CalculatorType::Pointer calculator;
+  switch (method)
     {
     case vtkITKImageThresholdCalculator::METHOD_HUANG: calculator = itk::HuangThresholdCalculator<HistogramType>::New(); break;
     case vtkITKImageThresholdCalculator::METHOD_INTERMODES: calculator = itk::IntermodesThresholdCalculator<HistogramType>::New(); break;
@@ -92,24 +107,10 @@ void ITKComputeThresholdFromVTKImage(vtkITKImageThresholdCalculator *self, vtkIm
     case vtkITKImageThresholdCalculator::METHOD_SHANBHAG: calculator = itk::ShanbhagThresholdCalculator<HistogramType>::New(); break;
     case vtkITKImageThresholdCalculator::METHOD_TRIANGLE: calculator = itk::TriangleThresholdCalculator<HistogramType>::New(); break;
     case vtkITKImageThresholdCalculator::METHOD_YEN: calculator = itk::YenThresholdCalculator<HistogramType>::New(); break;
-    default:
-      vtkErrorWithObjectMacro(self, "ITKComputeThresholdFromVTKImage failed: invalid method: " << self->GetMethod());
-      return;
-    }
-
-  calculator->SetInput( histGenerator->GetOutput() );
-
-  try
-    {
-    calculator->Update();
-    }
-  catch (itk::ExceptionObject &err)
-    {
-    vtkErrorWithObjectMacro(self, "Failed to compute threshold value using method " << self->GetMethodAsString(self->GetMethod())
-      << ". Details: " << err);
+    default: break;
     }
-
-  computedThreshold = calculator->GetThreshold();
+  return calculator;
+}
 }
 
 //----------------------------------------------------------------------------
@@ -117,6 +118,11 @@ vtkITKImageThresholdCalculator::vtkITKImageThresholdCalculator()
 {
   this->Method = METHOD_OTSU;
   this->Threshold = 0.0;
+  this->NumberOfHistogramBins = 64;
+  this->HistogramRange[0] = 0.0;
+  this->HistogramRange[1] = 0.0;
+  this->HistogramScalars = nullptr;
+  this->HistogramNumberOfBins = 0;
 }
 
 //----------------------------------------------------------------------------
@@ -128,6 +134,7 @@ void vtkITKImageThresholdCalculator::PrintSelf(ostream& os, vtkIndent indent)
   this->Superclass::PrintSelf(os,indent);
   os << indent << "Method: " << this->GetMethodAsString(this->Method) << "\n";
   os << indent << "Threshold: " << this->Threshold << "\n";
+  os << indent << "NumberOfHistogramBins: " << this->NumberOfHistogramBins << "\n";
 }
 
 //----------------------------------------------------------------------------
@@ -167,14 +174,98 @@ void vtkITKImageThresholdCalculator::Update()
     return;
     }
 
-  int inputDataType = pointData->GetScalars()->GetDataType();
-  switch (inputDataType)
+  if (!this->UpdateHistogram(pointData->GetScalars()))
+    {
+    return;
+    }
+  if (this->HistogramRange[0] >= this->HistogramRange[1])
+    {
+    // all voxels have the same value
+    this->Threshold = this->HistogramRange[0];
+    return;
+    }
+
+  // Create and initialize the calculator
+  CalculatorType::Pointer calculator = CreateCalculator(this->Method);
+  if (!calculator)
+    {
+    vtkErrorMacro("Update failed: invalid method: " << this->Method);
+    return;
+    }
+
+  HistogramType::Pointer histogram = HistogramType::New();
+  histogram->SetMeasurementVectorSize(1);
+  HistogramType::SizeType histogramSize(1);
+  histogramSize[0] = this->HistogramFrequencies.size();
+  HistogramType::MeasurementVectorType lowerBound(1);
+  lowerBound[0] = this->HistogramRange[0];
+  HistogramType::MeasurementVectorType upperBound(1);
+  upperBound[0] = this->HistogramRange[1];
+  histogram->Initialize(histogramSize, lowerBound, upperBound);
+  for (size_t bin = 0; bin < this->HistogramFrequencies.size(); bin++)
+    {
+    histogram->SetFrequency(bin, this->HistogramFrequencies[bin]);
+    }
+  calculator->SetInput(histogram);
+
+  try
+    {
+    calculator->Update();
+    }
+  catch (itk::ExceptionObject &err)
+    {
+    vtkErrorMacro("Failed to compute threshold value using method " << this->GetMethodAsString(this->Method)
+      << ". Details: " << err);
+    }
+
+  this->Threshold = calculator->GetThreshold();
+}
+
+//----------------------------------------------------------------------------
+bool vtkITKImageThresholdCalculator::UpdateHistogram(vtkDataArray* scalars)
+{
+  if (scalars == this->HistogramScalars
+    && scalars->GetMTime() < this->HistogramComputeTime.GetMTime()
+    && this->HistogramNumberOfBins == this->NumberOfHistogramBins)
+    {
+    return !this->HistogramFrequencies.empty();
+    }
+  this->HistogramScalars = scalars;
+  this->HistogramNumberOfBins = this->NumberOfHistogramBins;
+  this->HistogramFrequencies.clear();
+  this->HistogramComputeTime.Modified();
+
+  // the range is cached in the array, too
+  double range[2] = { 0.0, 0.0 };
+  scalars->GetRange(range, 0);
+  if (range[0] > range[1])
+    {
+    vtkErrorMacro("UpdateHistogram: input image does not contain valid voxel values");
+    return false;
+    }
+  // Same range and bin size as computed by itk::Statistics::ImageToHistogramFilter,
+  // the upper bound is extended so that the maximum value is inside the last bin.
+  double binWidth = (range[1] - range[0]) / this->NumberOfHistogramBins;
+  this->HistogramRange[0] = range[0];
+  this->HistogramRange[1] = range[1] + binWidth / 100.0;
+  binWidth = (this->HistogramRange[1] - this->HistogramRange[0]) / this->NumberOfHistogramBins;
+  this->HistogramFrequencies.resize(this->NumberOfHistogramBins, 0.0);
+  if (binWidth <= 0.0)
+    {
+    this->HistogramFrequencies[0] = static_cast<double>(scalars->GetNumberOfTuples());
+    return true;
+    }
+
+  switch (scalars->GetDataType())
     {
-    vtkTemplateMacro(ITKComputeThresholdFromVTKImage<VTK_TT>(this, inputImage, this->Threshold));
+    vtkTemplateMacro(ComputeHistogram<VTK_TT>(static_cast<VTK_TT*>(scalars->GetVoidPointer(0)),
+      scalars->GetNumberOfTuples(), this->HistogramRange[0], binWidth, this->HistogramFrequencies));
     default:
-      vtkErrorMacro("Execute: Unknown ScalarType" << inputDataType);
-      return;
+      vtkErrorMacro("UpdateHistogram: Unknown ScalarType " << scalars->GetDataType());
+      this->HistogramFrequencies.clear();
+      return false;
     }
+  return true;
 }
 
 //----------------------------------------------------------------------------
@@ -19,12 +19,24 @@
 #include "vtkImageData.h"
 #include "vtkObjectFactory.h"
 #include "vtkMatrix4x4.h"
+#include "vtkTimeStamp.h"
 
 #include "vtkITK.h"
 #include "itkImageIOBase.h"
 
+// STD includes
+#include <vector>
+
+class vtkDataArray;
 class vtkStringArray;
 
+/// \brief Compute a threshold value for an image using a histogram-based method.
+///
+/// The histogram of the input image is computed once and it is reused
+/// as long as the input scalars and the number of histogram bins are not
+/// modified, therefore computing thresholds with different methods for
+/// the same image only costs the threshold computation itself.
+
 class VTK_ITK_EXPORT vtkITKImageThresholdCalculator : public vtkImageAlgorithm
 {
 public:
@@ -75,6 +87,10 @@ public:
   static const char *GetMethodAsString(int method);
   //@}
 
+  /// Number of histogram bins used by the threshold methods (default: 64).
+  vtkSetClampMacro(NumberOfHistogramBins, int, 1, VTK_INT_MAX);
+  vtkGetMacro(NumberOfHistogramBins, int);
+
   /// Bring vtkAlgorithm::Update methods here
   /// to avoid hiding Update override.
   using vtkAlgorithm::Update;
@@ -85,8 +101,21 @@ protected:
   vtkITKImageThresholdCalculator();
   ~vtkITKImageThresholdCalculator() override;
 
+  /// Compute the histogram of the scalars if it has not been computed yet
+  /// for these scalars and number of bins. Returns false if the histogram is empty.
+  bool UpdateHistogram(vtkDataArray* scalars);
+
   int Method;
   double Threshold;
+  int NumberOfHistogramBins;
+
+  /// Cached histogram: voxel count of each bin and the range covered by the bins
+  std::vector<double> HistogramFrequencies;
+  double HistogramRange[2];
+  /// Scalars and number of bins that the cached histogram was computed for
+  vtkDataArray* HistogramScalars;
+  int HistogramNumberOfBins;
+  vtkTimeStamp HistogramComputeTime;
 
 private:
   vtkITKImageThresholdCalculator(const vtkITKImageThresholdCalculator&) = delete;
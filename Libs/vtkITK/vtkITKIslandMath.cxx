@@ -14,12 +14,20 @@
 #include "vtkPointData.h"
 #include "vtkImageData.h"
 #include "vtkAlgorithm.h"
+#include "vtkSMPTools.h"
 #include <vtkVersion.h>
 
 #include "itkConnectedComponentImageFilter.h"
 #include "itkRelabelComponentImageFilter.h"
 #include "itkCommand.h"
 
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+#include <numeric>
+#include <thread>
+#include <vector>
+
 vtkStandardNewMacro(vtkITKIslandMath);
 
 vtkITKIslandMath::vtkITKIslandMath()
@@ -28,6 +36,8 @@ vtkITKIslandMath::vtkITKIslandMath()
   this->SliceBySlice = 0;
   this->MinimumSize = 0;
   this->MaximumSize = VTK_ID_MAX;
+  this->UseParallelLabeling = 1;
+  this->RestrictToForegroundExtent = 1;
   this->NumberOfIslands = 0;
   this->OriginalNumberOfIslands = 0;
 
@@ -43,6 +53,8 @@ void vtkITKIslandMath::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "SliceBySlice: " << SliceBySlice << std::endl;
   os << indent << "MinimumSize: " << MinimumSize << std::endl;
   os << indent << "MaximumSize: " << MaximumSize << std::endl;
+  os << indent << "UseParallelLabeling: " << UseParallelLabeling << std::endl;
+  os << indent << "RestrictToForegroundExtent: " << RestrictToForegroundExtent << std::endl;
   os << indent << "NumberOfIslands: " << NumberOfIslands << std::endl;
   os << indent << "OriginalNumberOfIslands: " << OriginalNumberOfIslands << std::endl;
 }
@@ -120,6 +132,282 @@ void vtkITKIslandMathExecute(vtkITKIslandMath *self, vtkImageData* input,
 }
 
 
+namespace
+{
+const unsigned int BACKGROUND_INDEX = UINT_MAX;
+const int MINIMUM_SLAB_THICKNESS = 16;
+
+//----------------------------------------------------------------------------
+unsigned int FindRoot(std::vector<unsigned int>& parents, unsigned int index)
+{
+  while (parents[index] != index)
+    {
+    // path halving
+    parents[index] = parents[parents[index]];
+    index = parents[index];
+    }
+  return index;
+}
+
+//----------------------------------------------------------------------------
+// Root of the merged set is always the voxel with the lowest index, therefore
+// parent index of each voxel is lower than or equal to the voxel index.
+void MergeSets(std::vector<unsigned int>& parents, unsigned int index1, unsigned int index2)
+{
+  unsigned int root1 = FindRoot(parents, index1);
+  unsigned int root2 = FindRoot(parents, index2);
+  if (root1 < root2)
+    {
+    parents[root2] = root1;
+    }
+  else if (root2 < root1)
+    {
+    parents[root1] = root2;
+    }
+}
+
+//----------------------------------------------------------------------------
+// Voxel offsets (x, y, z) of neighbors that precede the voxel in raster order
+void GetPrecedingNeighbors(bool fullyConnected, std::vector<int>& offsets)
+{
+  offsets.clear();
+  for (int z = -1; z <= 0; z++)
+    {
+    for (int y = -1; y <= 1; y++)
+      {
+      for (int x = -1; x <= 1; x++)
+        {
+        bool preceding = (z < 0 || (z == 0 && (y < 0 || (y == 0 && x < 0))));
+        bool faceConnected = (std::abs(x) + std::abs(y) + std::abs(z) == 1);
+        if (preceding && (fullyConnected || faceConnected))
+          {
+          offsets.push_back(x);
+          offsets.push_back(y);
+          offsets.push_back(z);
+          }
+        }
+      }
+    }
+}
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+// Connected component labeling using union-find.
+// The image is split into slabs along the Z axis, which are labeled in parallel,
+// then sets are merged sequentially at the slab boundaries.
+// Island sizes are accumulated while the final labels are assigned.
+// Output is the same as the output of ITK connected component filter followed by relabeling:
+// islands are sorted by decreasing size (ties are broken by raster order of the first voxel).
+template <class T>
+bool vtkITKIslandMathParallelExecute(vtkITKIslandMath *self, vtkImageData* input, T* inPtr, T* outPtr)
+{
+  int dims[3];
+  input->GetDimensions(dims);
+  vtkIdType numberOfVoxels = static_cast<vtkIdType>(dims[0]) * dims[1] * dims[2];
+  memset(outPtr, 0, numberOfVoxels * sizeof(T));
+
+  // Region to process (voxel index ranges)
+  int region[6] = { 0, dims[0] - 1, 0, dims[1] - 1, 0, dims[2] - 1 };
+  if (self->GetRestrictToForegroundExtent())
+    {
+    region[0] = dims[0];
+    region[1] = -1;
+    region[2] = dims[1];
+    region[3] = -1;
+    region[4] = dims[2];
+    region[5] = -1;
+    const T* voxelPtr = inPtr;
+    for (int z = 0; z < dims[2]; z++)
+      {
+      for (int y = 0; y < dims[1]; y++)
+        {
+        for (int x = 0; x < dims[0]; x++, voxelPtr++)
+          {
+          if (*voxelPtr != 0)
+            {
+            region[0] = std::min(region[0], x);
+            region[1] = std::max(region[1], x);
+            region[2] = std::min(region[2], y);
+            region[3] = std::max(region[3], y);
+            region[4] = std::min(region[4], z);
+            region[5] = z;
+            }
+          }
+        }
+      }
+    if (region[1] < region[0])
+      {
+      self->SetNumberOfIslands(0);
+      self->SetOriginalNumberOfIslands(0);
+      return true;
+      }
+    }
+  const int regionDims[3] = { region[1] - region[0] + 1, region[3] - region[2] + 1, region[5] - region[4] + 1 };
+  const vtkIdType regionSliceSize = static_cast<vtkIdType>(regionDims[0]) * regionDims[1];
+  const vtkIdType numberOfRegionVoxels = regionSliceSize * regionDims[2];
+  if (numberOfRegionVoxels >= static_cast<vtkIdType>(BACKGROUND_INDEX))
+    {
+    // too many voxels for 32-bit indices
+    return false;
+    }
+  std::vector<unsigned int> parents(numberOfRegionVoxels, BACKGROUND_INDEX);
+
+  std::vector<int> neighborOffsets;
+  GetPrecedingNeighbors(self->GetFullyConnected() != 0, neighborOffsets);
+  const int numberOfNeighbors = static_cast<int>(neighborOffsets.size() / 3);
+
+  // Region voxel index of a valid neighbor in the foreground, BACKGROUND_INDEX otherwise
+  auto getForegroundNeighbor = [&](int x, int y, int z, int neighborIndex, int minimumZ) -> unsigned int
+    {
+    int nx = x + neighborOffsets[neighborIndex * 3];
+    int ny = y + neighborOffsets[neighborIndex * 3 + 1];
+    int nz = z + neighborOffsets[neighborIndex * 3 + 2];
+    if (nx < 0 || nx >= regionDims[0] || ny < 0 || ny >= regionDims[1] || nz < minimumZ)
+      {
+      return BACKGROUND_INDEX;
+      }
+    unsigned int neighborRegionIndex = static_cast<unsigned int>(nz * regionSliceSize + ny * regionDims[0] + nx);
+    return parents[neighborRegionIndex] == BACKGROUND_INDEX ? BACKGROUND_INDEX : neighborRegionIndex;
+    };
+
+  int numberOfSlabs = std::max(1, std::min(static_cast<int>(std::thread::hardware_concurrency()),
+    regionDims[2] / MINIMUM_SLAB_THICKNESS));
+  std::vector<int> slabStartZ(numberOfSlabs + 1);
+  for (int slabIndex = 0; slabIndex <= numberOfSlabs; slabIndex++)
+    {
+    slabStartZ[slabIndex] = static_cast<int>(static_cast<vtkIdType>(regionDims[2]) * slabIndex / numberOfSlabs);
+    }
+
+  // Label each slab. Sets only contain voxels of the slab, so slabs can be processed independently.
+  vtkSMPTools::For(0, numberOfSlabs, [&](vtkIdType beginSlab, vtkIdType endSlab)
+    {
+    for (vtkIdType slabIndex = beginSlab; slabIndex < endSlab; slabIndex++)
+      {
+      for (int z = slabStartZ[slabIndex]; z < slabStartZ[slabIndex + 1]; z++)
+        {
+        for (int y = 0; y < regionDims[1]; y++)
+          {
+          const T* rowPtr = inPtr + (static_cast<vtkIdType>(z + region[4]) * dims[1] + y + region[2]) * dims[0] + region[0];
+          unsigned int regionIndex = static_cast<unsigned int>(z * regionSliceSize + y * regionDims[0]);
+          for (int x = 0; x < regionDims[0]; x++, regionIndex++)
+            {
+            if (rowPtr[x] == 0)
+              {
+              continue;
+              }
+            parents[regionIndex] = regionIndex;
+            for (int neighborIndex = 0; neighborIndex < numberOfNeighbors; neighborIndex++)
+              {
+              unsigned int neighborRegionIndex = getForegroundNeighbor(x, y, z, neighborIndex, slabStartZ[slabIndex]);
+              if (neighborRegionIndex != BACKGROUND_INDEX)
+                {
+                MergeSets(parents, regionIndex, neighborRegionIndex);
+                }
+              }
+            }
+          }
+        }
+      }
+    });
+  self->UpdateProgress(0.5);
+
+  // Merge sets at slab boundaries
+  for (int slabIndex = 1; slabIndex < numberOfSlabs; slabIndex++)
+    {
+    int z = slabStartZ[slabIndex];
+    for (int y = 0; y < regionDims[1]; y++)
+      {
+      unsigned int regionIndex = static_cast<unsigned int>(z * regionSliceSize + y * regionDims[0]);
+      for (int x = 0; x < regionDims[0]; x++, regionIndex++)
+        {
+        if (parents[regionIndex] == BACKGROUND_INDEX)
+          {
+          continue;
+          }
+        for (int neighborIndex = 0; neighborIndex < numberOfNeighbors; neighborIndex++)
+          {
+          if (neighborOffsets[neighborIndex * 3 + 2] == 0)
+            {
+            // neighbors within the same slice are already merged
+            continue;
+            }
+          unsigned int neighborRegionIndex = getForegroundNeighbor(x, y, z, neighborIndex, 0);
+          if (neighborRegionIndex != BACKGROUND_INDEX)
+            {
+            MergeSets(parents, regionIndex, neighborRegionIndex);
+            }
+          }
+        }
+      }
+    }
+
+  // Replace parent index by island index and count island sizes.
+  // Parent of each voxel precedes the voxel, therefore when a voxel is visited its parent
+  // already contains the island index. Islands are numbered in raster order of their first voxel.
+  std::vector<vtkIdType> islandSizes;
+  for (unsigned int regionIndex = 0; regionIndex < numberOfRegionVoxels; regionIndex++)
+    {
+    unsigned int parentIndex = parents[regionIndex];
+    if (parentIndex == BACKGROUND_INDEX)
+      {
+      continue;
+      }
+    unsigned int islandIndex = 0;
+    if (parentIndex == regionIndex)
+      {
+      islandIndex = static_cast<unsigned int>(islandSizes.size());
+      islandSizes.push_back(0);
+      }
+    else
+      {
+      islandIndex = parents[parentIndex];
+      }
+    parents[regionIndex] = islandIndex;
+    islandSizes[islandIndex]++;
+    }
+  self->UpdateProgress(0.8);
+
+  // Sort islands by decreasing size and remove small islands
+  std::vector<unsigned int> islandsBySize(islandSizes.size());
+  std::iota(islandsBySize.begin(), islandsBySize.end(), 0);
+  std::stable_sort(islandsBySize.begin(), islandsBySize.end(),
+    [&islandSizes](unsigned int a, unsigned int b) { return islandSizes[a] > islandSizes[b]; });
+  std::vector<T> islandLabels(islandSizes.size(), 0);
+  unsigned long numberOfIslands = 0;
+  for (unsigned int islandIndex : islandsBySize)
+    {
+    if (islandSizes[islandIndex] < self->GetMinimumSize())
+      {
+      break;
+      }
+    islandLabels[islandIndex] = static_cast<T>(++numberOfIslands);
+    }
+  self->SetNumberOfIslands(numberOfIslands);
+  self->SetOriginalNumberOfIslands(static_cast<unsigned long>(islandSizes.size()));
+
+  // Write output
+  vtkSMPTools::For(0, regionDims[2], [&](vtkIdType beginZ, vtkIdType endZ)
+    {
+    for (vtkIdType z = beginZ; z < endZ; z++)
+      {
+      for (int y = 0; y < regionDims[1]; y++)
+        {
+        T* rowPtr = outPtr + ((z + region[4]) * dims[1] + y + region[2]) * dims[0] + region[0];
+        const unsigned int* islandIndexPtr = &parents[z * regionSliceSize + y * regionDims[0]];
+        for (int x = 0; x < regionDims[0]; x++)
+          {
+          if (islandIndexPtr[x] != BACKGROUND_INDEX)
+            {
+            rowPtr[x] = islandLabels[islandIndexPtr[x]];
+            }
+          }
+        }
+      }
+    });
+
+  return true;
+}
 
 //
 //
@@ -152,7 +440,12 @@ void vtkITKIslandMath::SimpleExecute(vtkImageData *input, vtkImageData *output)
 #undef VTK_TYPE_USE_LONG_LONG
 #undef VTK_TYPE_USE___INT64
 
-#define CALL  vtkITKIslandMathExecute(this, input, output, static_cast<VTK_TT *>(inPtr), static_cast<VTK_TT *>(outPtr));
+#define CALL  \
+    if (!this->GetUseParallelLabeling() \
+      || !vtkITKIslandMathParallelExecute(this, input, static_cast<VTK_TT *>(inPtr), static_cast<VTK_TT *>(outPtr))) \
+      { \
+      vtkITKIslandMathExecute(this, input, output, static_cast<VTK_TT *>(inPtr), static_cast<VTK_TT *>(outPtr)); \
+      }
 
     void* inPtr = input->GetScalarPointer();
     void* outPtr = output->GetScalarPointer();
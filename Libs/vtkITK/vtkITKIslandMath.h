@@ -40,6 +40,22 @@ class VTK_ITK_EXPORT vtkITKIslandMath : public vtkSimpleImageToImageFilter
   vtkGetMacro(MaximumSize, vtkIdType);
   vtkSetMacro(MaximumSize, vtkIdType);
 
+  ///
+  /// If non-zero (default), islands are computed by a parallel union-find labeling
+  /// that counts island sizes in the same pass. If zero, ITK connected component
+  /// and relabel filters are used. Islands are sorted by decreasing size in both cases.
+  vtkGetMacro(UseParallelLabeling, int);
+  vtkSetMacro(UseParallelLabeling, int);
+  vtkBooleanMacro(UseParallelLabeling, int);
+
+  ///
+  /// If non-zero (default), parallel labeling only processes the bounding box
+  /// of the non-zero voxels, which reduces memory usage and computation time
+  /// if the islands occupy a small part of the image.
+  vtkGetMacro(RestrictToForegroundExtent, int);
+  vtkSetMacro(RestrictToForegroundExtent, int);
+  vtkBooleanMacro(RestrictToForegroundExtent, int);
+
   ///
   /// TODO: Not yet implemented
   /// If zero, islands are defined by 3D connectivity
@@ -69,6 +85,8 @@ protected:
   int SliceBySlice;
   vtkIdType MinimumSize;
   vtkIdType MaximumSize;
+  int UseParallelLabeling;
+  int RestrictToForegroundExtent;
 
   unsigned long NumberOfIslands;
   unsigned long OriginalNumberOfIslands;
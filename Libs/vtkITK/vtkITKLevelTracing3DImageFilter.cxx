@@ -81,13 +81,20 @@ void vtkITKLevelTracing3DTrace(vtkITKLevelTracing3DImageFilter *vtkNotUsed(self)
   seedIndex[2] = seed[2];
 
   tracing->SetSeed(seedIndex);
+  // Only the traced voxels are labeled in the output, no need for a full size ITK output image
+  tracing->GenerateOutputImageOff();
 
   tracing->SetInput( image );
   tracing->Update();
 
-  // Copy to the output
-  memcpy(oscalars, tracing->GetOutput()->GetBufferPointer(),
-         tracing->GetOutput()->GetBufferedRegion().GetNumberOfPixels());
+  // Label the traced voxels in the output
+  memset(oscalars, 0, region.GetNumberOfPixels());
+  const std::vector<typename ImageType::IndexType>& tracedIndices = tracing->GetTracedIndices();
+  for (typename std::vector<typename ImageType::IndexType>::const_iterator it = tracedIndices.begin();
+    it != tracedIndices.end(); ++it)
+    {
+    oscalars[image->ComputeOffset(*it)] = 1;
+    }
 
 }
 
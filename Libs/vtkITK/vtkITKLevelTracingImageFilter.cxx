@@ -25,7 +25,6 @@ PURPOSE.  See the above copyright notice for more information.
 #include "vtkSmartPointer.h"
 #include "vtkUnsignedCharArray.h"
 
-#include "itkExtractImageFilter.h"
 
 vtkStandardNewMacro(vtkITKLevelTracingImageFilter);
 
@@ -39,88 +38,100 @@ vtkITKLevelTracingImageFilter::vtkITKLevelTracingImageFilter()
   this->Seed[2] = 0;
 
   this->Plane = 2;  // Default to XY plane
+
+  this->SliceInputScalars = nullptr;
+  this->SlicePlane = -1;
+  this->SlicePosition = -1;
 }
 
 vtkITKLevelTracingImageFilter::~vtkITKLevelTracingImageFilter() = default;
 
 
+namespace
+{
+//----------------------------------------------------------------------------
+/// Get the axes of the slice (first, second) and the slice normal
+void GetPlaneAxes(int plane, int sliceAxes[2], int& normalAxis)
+{
+  switch (plane)
+    {
+    case 0: //JK plane
+      sliceAxes[0] = 1;
+      sliceAxes[1] = 2;
+      normalAxis = 0;
+      break;
+    case 1: //IK plane
+      sliceAxes[0] = 0;
+      sliceAxes[1] = 2;
+      normalAxis = 1;
+      break;
+    default:
+    case 2: //IJ plane (axials)
+      sliceAxes[0] = 0;
+      sliceAxes[1] = 1;
+      normalAxis = 2;
+      break;
+    }
+}
+
+//----------------------------------------------------------------------------
 template <class T>
-void vtkITKLevelTracingTrace(vtkITKLevelTracingImageFilter *vtkNotUsed(self), T* scalars,
-                             int dims[3], int extent[6], double origin[3], double spacing[3],
+void vtkITKLevelTracingExtractSlice(const T* inPtr, T* outPtr, int dims[3], int plane, int slicePosition)
+{
+  int sliceAxes[2] = { 0, 1 };
+  int normalAxis = 2;
+  GetPlaneAxes(plane, sliceAxes, normalAxis);
+  vtkIdType increments[3] = { 1, dims[0], static_cast<vtkIdType>(dims[0]) * dims[1] };
+  const T* slicePtr = inPtr + slicePosition * increments[normalAxis];
+  for (int v = 0; v < dims[sliceAxes[1]]; v++)
+    {
+    const T* rowPtr = slicePtr + v * increments[sliceAxes[1]];
+    for (int u = 0; u < dims[sliceAxes[0]]; u++)
+      {
+      *(outPtr++) = rowPtr[u * increments[sliceAxes[0]]];
+      }
+    }
+}
+}
+
+//----------------------------------------------------------------------------
+template <class T>
+void vtkITKLevelTracingTrace(vtkITKLevelTracingImageFilter *vtkNotUsed(self), T* sliceScalars,
+                             int dims[3], int extent[6],
                              vtkPoints *newPoints,
                              vtkCellArray *newPolys,
                              int seed[3], int plane)
 {
+  int sliceAxes[2] = { 0, 1 };
+  int normalAxis = 2;
+  GetPlaneAxes(plane, sliceAxes, normalAxis);
 
-  // Wrap scalars into an ITK image
-  typedef itk::Image<T, 3> ImageType;
-  typename ImageType::Pointer image = ImageType::New();
-  image->GetPixelContainer()->SetImportPointer(scalars, dims[0]*dims[1]*dims[2], false);
-  image->SetOrigin( origin );
-  image->SetSpacing( spacing );
-
-  typename ImageType::RegionType region;
-  typename ImageType::IndexType index;
-  typename ImageType::SizeType size;
-  index[0] = extent[0];
-  index[1] = extent[2];
-  index[2] = extent[4];
+  // Wrap the slice into a 2D ITK image, using the same indices as the input image
+  typedef itk::Image<T,2> Image2DType;
+  typename Image2DType::Pointer image = Image2DType::New();
+  typename Image2DType::RegionType region;
+  typename Image2DType::IndexType index;
+  typename Image2DType::SizeType size;
+  for (int axis = 0; axis < 2; axis++)
+    {
+    index[axis] = extent[2 * sliceAxes[axis]];
+    size[axis] = dims[sliceAxes[axis]];
+    }
   region.SetIndex( index );
-  size[0] = extent[1] - extent[0] + 1;
-  size[1] = extent[3] - extent[2] + 1;
-  size[2] = extent[5] - extent[4] + 1;
   region.SetSize( size );
   image->SetRegions(region);
-
-  // Extract the 2D slice to process
-  typedef itk::Image<T,2> Image2DType;
-  typedef itk::ExtractImageFilter<ImageType, Image2DType> ExtractType;
-  typename ExtractType::Pointer extract = ExtractType::New();
-  extract->SetDirectionCollapseToIdentity(); //If you don't care about resulting image dimension
-
-  typedef typename ExtractType::InputImageRegionType ExtractionRegionType;
-  ExtractionRegionType extractRegion;
-  typename ExtractionRegionType::IndexType extractIndex;
-  typename ExtractionRegionType::SizeType extractSize;
-
-  extractIndex = index;
-  extractSize = size;
-  extract->SetInput( image );
+  image->GetPixelContainer()->SetImportPointer(sliceScalars, region.GetNumberOfPixels(), false);
 
   // Trace the level curve using itk::LevelTracingImageFilter
   typedef itk::LevelTracingImageFilter<Image2DType, Image2DType> LevelTracingType;
   typename LevelTracingType::Pointer tracing = LevelTracingType::New();
+  // Only the path is used, do not allocate the output image
+  tracing->GenerateOutputImageOff();
 
-  itk::Index<2> seed2D = {{0,0}};
-  switch(plane)
-  {
-  case 0: //JK plane
-    seed2D[0] = seed[1];
-    seed2D[1] = seed[2];
-    extractSize[0] = 0;
-    extractIndex[0] = seed[0];
-    break;
-  case 1:  //IK plane
-    seed2D[0] = seed[0];
-    seed2D[1] = seed[2];
-    extractSize[1] = 0;
-    extractIndex[1] = seed[1];
-    break;
-  case 2:  //IJ plane (axials)
-    seed2D[0] = seed[0];
-    seed2D[1] = seed[1];
-    extractSize[2] = 0;
-    extractIndex[2] = seed[2];
-    break;
-  }
-
-  extractRegion.SetIndex( extractIndex );
-  extractRegion.SetSize( extractSize );
-  extract->SetExtractionRegion( extractRegion );
-
+  itk::Index<2> seed2D = {{ seed[sliceAxes[0]], seed[sliceAxes[1]] }};
   tracing->SetSeed(seed2D);
 
-  tracing->SetInput( extract->GetOutput() );
+  tracing->SetInput( image );
   tracing->Update();
 
   // Convert chain code output to points and polys (remember to put
@@ -147,31 +158,15 @@ void vtkITKLevelTracingTrace(vtkITKLevelTracingImageFilter *vtkNotUsed(self), T*
   ptIds = new vtkIdType [numberChain];
 
   unsigned int i=0;
-  typename ImageType::IndexType chain3D;
+  double chain3D[3];
+  chain3D[normalAxis] = seed[normalAxis];
 
   do
     {
-    switch( plane )
-      {
-      default:
-      case 0:  //JK plane
-        chain3D[0] = seed[0];
-        chain3D[1] = chainTemp[0] ;
-        chain3D[2] = chainTemp[1] ;
-        break;
-      case 1:  //IK plane
-        chain3D[1] = seed[1];
-        chain3D[0] = chainTemp[0] ;
-        chain3D[2] = chainTemp[1] ;
-        break;
-      case 2:  //IJ plane
-        chain3D[2] = seed[2];
-        chain3D[0] = chainTemp[0] ;
-        chain3D[1] = chainTemp[1] ;
-        break;
-      }
+    chain3D[sliceAxes[0]] = chainTemp[0];
+    chain3D[sliceAxes[1]] = chainTemp[1];
 
-    newPoints->InsertPoint(i, chain3D[0], chain3D[1], chain3D[2]);
+    newPoints->InsertPoint(i, chain3D);
     ptIds[i] = i;
     offset = chain->IncrementInput(i);
     chainTemp[0] = chainTemp[0] + offset[0];
@@ -209,7 +204,6 @@ int vtkITKLevelTracingImageFilter::RequestData(
   vtkDataArray *inScalars;
   int dims[3], extent[6];
   int estimatedSize;
-  double spacing[3], origin[3];
 
   vtkDebugMacro(<< "Executing level tracing");
 
@@ -230,13 +224,15 @@ int vtkITKLevelTracingImageFilter::RequestData(
   }
 
   input->GetDimensions(dims);
-  input->GetOrigin(origin);
-  input->GetSpacing(spacing);
 
   inInfo->Get(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT(), extent);
 
-  // estimate the number of points from the volume dimensions
-  estimatedSize = (int) pow ((double) (dims[0] * dims[1] * dims[2]), .75);
+  int sliceAxes[2] = { 0, 1 };
+  int normalAxis = 2;
+  GetPlaneAxes(this->Plane, sliceAxes, normalAxis);
+
+  // estimate the number of points from the slice dimensions
+  estimatedSize = (int) pow ((double) (dims[sliceAxes[0]] * dims[sliceAxes[1]]), .75);
   estimatedSize = estimatedSize / 1024 * 1024; //multiple of 1024
   if (estimatedSize < 1024)
   {
@@ -250,6 +246,39 @@ int vtkITKLevelTracingImageFilter::RequestData(
   newPolys = vtkCellArray::New();
   newPolys->Allocate(newPolys->EstimateSize(estimatedSize,2));
 
+  bool seedInside = true;
+  for (int axis = 0; axis < 3; axis++)
+    {
+    if (this->Seed[axis] < extent[2 * axis] || this->Seed[axis] > extent[2 * axis + 1])
+      {
+      seedInside = false;
+      }
+    }
+  int slicePosition = this->Seed[normalAxis] - extent[2 * normalAxis];
+
+  void* sliceScalars = nullptr;
+  int sliceScalarType = VTK_VOID;
+  if (!seedInside)
+    {
+    // nothing to trace
+    }
+  else if (inScalars->GetNumberOfComponents() == 1 && normalAxis == 2)
+    {
+    // IJ slices are contiguous in memory, use the input directly
+    sliceScalars = inScalars->GetVoidPointer(static_cast<vtkIdType>(slicePosition) * dims[0] * dims[1]);
+    sliceScalarType = inScalars->GetDataType();
+    }
+  else if (inScalars->GetNumberOfComponents() == 1 || inScalars->GetNumberOfComponents() == 3)
+    {
+    this->UpdateSliceScalars(inScalars, dims, slicePosition);
+    sliceScalars = this->SliceScalars->GetVoidPointer(0);
+    sliceScalarType = this->SliceScalars->GetDataType();
+    }
+  else
+    {
+    vtkErrorMacro(<< "Can only trace scalar and RGB images.");
+    }
+
 ////////// These types are not defined in itk::NumericTraits ////////////
 #ifdef vtkTemplateMacroCase_ui64
 #undef vtkTemplateMacroCase_ui64
@@ -263,46 +292,18 @@ int vtkITKLevelTracingImageFilter::RequestData(
 #undef vtkTemplateMacroCase_ll
 # define vtkTemplateMacroCase_ll(typeN, type, call)
 #endif
-  if (inScalars->GetNumberOfComponents() == 1 )
+  if (sliceScalars)
   {
-    void* scalars = inScalars->GetVoidPointer(0);
-    switch (inScalars->GetDataType())
+    switch (sliceScalarType)
     {
       vtkTemplateMacro(
-        vtkITKLevelTracingTrace(this, static_cast<VTK_TT*>(scalars),
-        dims,extent,origin,spacing,
+        vtkITKLevelTracingTrace(this, static_cast<VTK_TT*>(sliceScalars),
+        dims,extent,
         newPts,newPolys,this->Seed, this->Plane
         )
         );
     } //switch
   }
-  else if (inScalars->GetNumberOfComponents() == 3)
-    {
-    // RGB - convert for now...
-    vtkSmartPointer<vtkUnsignedCharArray> grayScalars
-      = vtkUnsignedCharArray::New();
-    grayScalars->SetNumberOfTuples( inScalars->GetNumberOfTuples() );
-
-    double in[3];
-    unsigned char out;
-    for (vtkIdType i=0; i < inScalars->GetNumberOfTuples(); ++i)
-      {
-      inScalars->GetTuple(i, in);
-
-      out = static_cast<unsigned char>((2125.0 * in[0] +  7154.0 * in[1] +  0721.0 * in[2]) / 10000.0);
-
-      grayScalars->SetTypedTuple(i, &out);
-      }
-
-    vtkITKLevelTracingTrace(this,
-                            (unsigned char *)grayScalars->GetVoidPointer(0),
-                            dims, extent, origin, spacing,
-                            newPts, newPolys, this->Seed, this->Plane);
-    }
-  else
-    {
-    vtkErrorMacro(<< "Can only trace scalar and RGB images.");
-    }
 
   vtkDebugMacro(<<"Created: "
     << newPts->GetNumberOfPoints() << " points. " );
@@ -324,6 +325,65 @@ int vtkITKLevelTracingImageFilter::RequestData(
 
 
 
+//----------------------------------------------------------------------------
+void vtkITKLevelTracingImageFilter::UpdateSliceScalars(vtkDataArray* inScalars, int dims[3], int slicePosition)
+{
+  if (this->SliceScalars
+    && this->SliceInputScalars == inScalars
+    && this->SlicePlane == this->Plane
+    && this->SlicePosition == slicePosition
+    && inScalars->GetMTime() < this->SliceExtractionTime.GetMTime())
+    {
+    // the slice is already extracted
+    return;
+    }
+  this->SliceInputScalars = inScalars;
+  this->SlicePlane = this->Plane;
+  this->SlicePosition = slicePosition;
+  this->SliceExtractionTime.Modified();
+
+  int sliceAxes[2] = { 0, 1 };
+  int normalAxis = 2;
+  GetPlaneAxes(this->Plane, sliceAxes, normalAxis);
+  vtkIdType numberOfSlicePixels = static_cast<vtkIdType>(dims[sliceAxes[0]]) * dims[sliceAxes[1]];
+
+  if (inScalars->GetNumberOfComponents() == 3)
+    {
+    // RGB - convert for now...
+    vtkSmartPointer<vtkUnsignedCharArray> grayScalars = vtkSmartPointer<vtkUnsignedCharArray>::New();
+    grayScalars->SetNumberOfTuples(numberOfSlicePixels);
+    unsigned char* outPtr = grayScalars->GetPointer(0);
+    vtkIdType increments[3] = { 1, dims[0], static_cast<vtkIdType>(dims[0]) * dims[1] };
+    double in[3];
+    for (int v = 0; v < dims[sliceAxes[1]]; v++)
+      {
+      for (int u = 0; u < dims[sliceAxes[0]]; u++)
+        {
+        inScalars->GetTuple(slicePosition * increments[normalAxis]
+          + v * increments[sliceAxes[1]] + u * increments[sliceAxes[0]], in);
+        *(outPtr++) = static_cast<unsigned char>((2125.0 * in[0] +  7154.0 * in[1] +  0721.0 * in[2]) / 10000.0);
+        }
+      }
+    this->SliceScalars = grayScalars;
+    return;
+    }
+
+  if (!this->SliceScalars || this->SliceScalars->GetDataType() != inScalars->GetDataType())
+    {
+    this->SliceScalars = vtkSmartPointer<vtkDataArray>::Take(inScalars->NewInstance());
+    }
+  this->SliceScalars->SetNumberOfComponents(1);
+  this->SliceScalars->SetNumberOfTuples(numberOfSlicePixels);
+  void* inPtr = inScalars->GetVoidPointer(0);
+  void* outPtr = this->SliceScalars->GetVoidPointer(0);
+  switch (inScalars->GetDataType())
+    {
+    vtkTemplateMacro(vtkITKLevelTracingExtractSlice(static_cast<VTK_TT*>(inPtr), static_cast<VTK_TT*>(outPtr),
+      dims, this->Plane, slicePosition));
+    }
+}
+
+//----------------------------------------------------------------------------
 int vtkITKLevelTracingImageFilter::FillInputPortInformation(int, vtkInformation *info)
 {
   info->Set(vtkAlgorithm::INPUT_REQUIRED_DATA_TYPE(), "vtkImageData");
@@ -5,6 +5,10 @@
 #include "vtkITK.h"
 #include "vtkPolyDataAlgorithm.h"
 #include "vtkObjectFactory.h"
+#include "vtkSmartPointer.h"
+#include "vtkTimeStamp.h"
+
+class vtkDataArray;
 
 /// \brief Wrapper class around itk::LevelTracingImageFilterImageFilter.
 ///
@@ -16,6 +20,11 @@
 /// This filter is specialized to volumes. If you are interested in
 /// contouring other types of data, use the general vtkContourFilter. If you
 /// want to contour an image (i.e., a volume slice), use vtkMarchingSquares.
+///
+/// Only the slice that contains the seed is processed and only the pixels
+/// along the traced curve are visited. Slices that are not contiguous in
+/// memory (IK, JK planes, RGB images) are extracted once and reused while
+/// the seed stays on the same slice of the same input.
 class VTK_ITK_EXPORT vtkITKLevelTracingImageFilter : public vtkPolyDataAlgorithm
 {
 public:
@@ -42,9 +51,20 @@ protected:
   int RequestData(vtkInformation *, vtkInformationVector **, vtkInformationVector *) override;
   int FillInputPortInformation(int port, vtkInformation *info) override;
 
+  /// Extract the slice at slicePosition along the plane normal into SliceScalars,
+  /// unless it is already extracted from the same, unmodified input scalars.
+  void UpdateSliceScalars(vtkDataArray* inScalars, int dims[3], int slicePosition);
+
   int Seed[3];
   int Plane;
 
+  /// Cached slice and the input it was extracted from
+  vtkSmartPointer<vtkDataArray> SliceScalars;
+  vtkDataArray* SliceInputScalars;
+  int SlicePlane;
+  int SlicePosition;
+  vtkTimeStamp SliceExtractionTime;
+
 private:
   vtkITKLevelTracingImageFilter(const vtkITKLevelTracingImageFilter&) = delete;
   void operator=(const vtkITKLevelTracingImageFilter&) = delete;
@@ -0,0 +1,83 @@
+/*=========================================================================
+
+  Copyright Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+==========================================================================*/
+
+#include "vtkITKMedianImageFilter.h"
+
+// VTK includes
+#include <vtkDataArray.h>
+#include <vtkObjectFactory.h>
+#include <vtkPointData.h>
+
+// ITK includes
+#include "itkSlidingWindowMedianImageFilter.h"
+
+// STD includes
+#include <algorithm>
+
+vtkStandardNewMacro(vtkITKMedianImageFilter);
+
+//----------------------------------------------------------------------------
+vtkITKMedianImageFilter::vtkITKMedianImageFilter()
+{
+  this->Radius[0] = 1;
+  this->Radius[1] = 1;
+  this->Radius[2] = 1;
+}
+
+//----------------------------------------------------------------------------
+vtkITKMedianImageFilter::~vtkITKMedianImageFilter() = default;
+
+//----------------------------------------------------------------------------
+void vtkITKMedianImageFilter::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "Radius: " << this->Radius[0] << ", " << this->Radius[1] << ", " << this->Radius[2] << std::endl;
+}
+
+//----------------------------------------------------------------------------
+template <class T>
+void vtkITKMedianImageFilter::ExecuteWithScalarType(vtkImageData* input, vtkImageData* output)
+{
+  typedef itk::Image<T, 3> ImageType;
+  typedef itk::SlidingWindowMedianImageFilter<ImageType, ImageType> MedianFilterType;
+  typename MedianFilterType::Pointer filter = MedianFilterType::New();
+  this->ConfigureITKFilter(filter.GetPointer());
+  typename MedianFilterType::RadiusType radius;
+  for (int i = 0; i < 3; i++)
+    {
+    radius[i] = static_cast<itk::SizeValueType>(std::max(this->Radius[i], 0));
+    }
+  filter->SetRadius(radius);
+  filter->SetInput(this->ImportVTKImage<T>(input));
+  this->UpdateITKOutput(filter.GetPointer(), output);
+}
+
+//----------------------------------------------------------------------------
+void vtkITKMedianImageFilter::SimpleExecute(vtkImageData* input, vtkImageData* output)
+{
+  vtkDataArray* inScalars = input->GetPointData()->GetScalars();
+  if (!inScalars)
+    {
+    vtkErrorMacro(<< "Scalars must be defined for median filtering");
+    return;
+    }
+  if (inScalars->GetNumberOfComponents() != 1)
+    {
+    vtkErrorMacro(<< "Only single component images supported.");
+    return;
+    }
+  switch (inScalars->GetDataType())
+    {
+    vtkITKTemplateMacro(this->ExecuteWithScalarType<VTK_TT>(input, output));
+    default:
+      {
+      vtkErrorMacro(<< "Incompatible data type for this version of ITK.");
+      }
+    }
+}
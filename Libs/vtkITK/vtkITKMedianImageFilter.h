@@ -0,0 +1,50 @@
+/*=========================================================================
+
+  Copyright Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+==========================================================================*/
+
+#ifndef __vtkITKMedianImageFilter_h
+#define __vtkITKMedianImageFilter_h
+
+#include "vtkITKSimpleImageToImageFilter.h"
+
+/// \brief Wrapper class around itk::SlidingWindowMedianImageFilter.
+///
+/// Computes the median of the (2*Radius+1) sized neighborhood of each voxel.
+/// Integer images are processed by updating a histogram of the neighborhood
+/// while it slides along the rows, which is much faster than vtkImageMedian3D
+/// for large kernels. The median of a binary labelmap is the majority vote of
+/// the neighborhood voxels. Output scalar type is the input scalar type.
+class VTK_ITK_EXPORT vtkITKMedianImageFilter : public vtkITKSimpleImageToImageFilter
+{
+ public:
+  static vtkITKMedianImageFilter *New();
+  vtkTypeMacro(vtkITKMedianImageFilter, vtkITKSimpleImageToImageFilter);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  /// Radius of the neighborhood along each axis, in voxels.
+  /// Default is 1, 1, 1 (3x3x3 neighborhood).
+  vtkSetVector3Macro(Radius, int);
+  vtkGetVector3Macro(Radius, int);
+
+protected:
+  vtkITKMedianImageFilter();
+  ~vtkITKMedianImageFilter() override;
+
+  void SimpleExecute(vtkImageData* input, vtkImageData* output) override;
+
+  template <class T>
+  void ExecuteWithScalarType(vtkImageData* input, vtkImageData* output);
+
+  int Radius[3];
+
+private:
+  vtkITKMedianImageFilter(const vtkITKMedianImageFilter&) = delete;
+  void operator=(const vtkITKMedianImageFilter&) = delete;
+};
+
+#endif
@@ -13,9 +13,14 @@
 #include "vtkDataArray.h"
 #include "vtkPointData.h"
 #include "vtkImageData.h"
+#include "vtkSMPTools.h"
 
 #include "itkMorphologicalContourInterpolator.h"
 
+#include <algorithm>
+#include <map>
+#include <vector>
+
 vtkStandardNewMacro(vtkITKMorphologicalContourInterpolator);
 
 vtkITKMorphologicalContourInterpolator::vtkITKMorphologicalContourInterpolator() = default;
@@ -71,6 +76,145 @@ void vtkITKMorphologicalContourInterpolatorExecute(vtkITKMorphologicalContourInt
 
 }
 
+// Interpolate each label separately within its bounding box.
+// Labels are independent from each other, therefore they are processed in parallel.
+template <class T>
+void vtkITKMorphologicalContourInterpolatorExecuteLabelsInParallel(vtkITKMorphologicalContourInterpolator *self,
+                vtkImageData* input, T* inPtr, T* outPtr)
+{
+  int dims[3];
+  input->GetDimensions(dims);
+  double spacing[3];
+  input->GetSpacing(spacing);
+  vtkIdType numberOfVoxels = static_cast<vtkIdType>(dims[0]) * dims[1] * dims[2];
+
+  // Find bounding box of each label (IJK index ranges)
+  typedef std::map<T, std::vector<int> > LabelBoundsMapType;
+  LabelBoundsMapType labelBounds;
+  const T* voxelPtr = inPtr;
+  for (int k = 0; k < dims[2]; k++)
+    {
+    for (int j = 0; j < dims[1]; j++)
+      {
+      for (int i = 0; i < dims[0]; i++, voxelPtr++)
+        {
+        if (*voxelPtr == 0)
+          {
+          continue;
+          }
+        typename LabelBoundsMapType::iterator boundsIt = labelBounds.find(*voxelPtr);
+        if (boundsIt == labelBounds.end())
+          {
+          int bounds[6] = { i, i, j, j, k, k };
+          labelBounds[*voxelPtr] = std::vector<int>(bounds, bounds + 6);
+          continue;
+          }
+        std::vector<int>& bounds = boundsIt->second;
+        bounds[0] = std::min(bounds[0], i);
+        bounds[1] = std::max(bounds[1], i);
+        bounds[2] = std::min(bounds[2], j);
+        bounds[3] = std::max(bounds[3], j);
+        // voxels are visited in increasing k order
+        bounds[5] = k;
+        }
+      }
+    }
+
+  memcpy(outPtr, inPtr, numberOfVoxels * sizeof(T));
+  if (labelBounds.empty())
+    {
+    return;
+    }
+
+  std::vector<T> labels;
+  std::vector<std::vector<int> > bounds;
+  for (typename LabelBoundsMapType::iterator boundsIt = labelBounds.begin(); boundsIt != labelBounds.end(); ++boundsIt)
+    {
+    labels.push_back(boundsIt->first);
+    // Interpolated contours stay between the key slices, but the median contour may extend
+    // slightly beyond the bounding box of the key contours in-plane, so a margin is added.
+    std::vector<int> labelBoundsWithMargin = boundsIt->second;
+    for (int axis = 0; axis < 3; axis++)
+      {
+      labelBoundsWithMargin[axis * 2] = std::max(0, labelBoundsWithMargin[axis * 2] - 1);
+      labelBoundsWithMargin[axis * 2 + 1] = std::min(dims[axis] - 1, labelBoundsWithMargin[axis * 2 + 1] + 1);
+      }
+    bounds.push_back(labelBoundsWithMargin);
+    }
+
+  typedef itk::Image<T, 3> ImageType;
+  typedef itk::MorphologicalContourInterpolator<ImageType> ContourInterpolatorType;
+  std::vector<typename ImageType::Pointer> interpolatedLabelImages(labels.size());
+  vtkSMPTools::For(0, static_cast<vtkIdType>(labels.size()), [&](vtkIdType beginLabelIndex, vtkIdType endLabelIndex)
+    {
+    for (vtkIdType labelIndex = beginLabelIndex; labelIndex < endLabelIndex; labelIndex++)
+      {
+      const std::vector<int>& labelBoundsWithMargin = bounds[labelIndex];
+      T label = labels[labelIndex];
+
+      // Extract the label within its bounding box
+      typename ImageType::Pointer labelImage = ImageType::New();
+      typename ImageType::RegionType region;
+      typename ImageType::IndexType index;
+      typename ImageType::SizeType size;
+      for (int axis = 0; axis < 3; axis++)
+        {
+        index[axis] = 0;
+        size[axis] = labelBoundsWithMargin[axis * 2 + 1] - labelBoundsWithMargin[axis * 2] + 1;
+        }
+      region.SetIndex(index);
+      region.SetSize(size);
+      labelImage->SetRegions(region);
+      labelImage->SetSpacing(spacing);
+      labelImage->Allocate();
+      T* labelPtr = labelImage->GetBufferPointer();
+      for (int k = labelBoundsWithMargin[4]; k <= labelBoundsWithMargin[5]; k++)
+        {
+        for (int j = labelBoundsWithMargin[2]; j <= labelBoundsWithMargin[3]; j++)
+          {
+          const T* rowPtr = inPtr + (static_cast<vtkIdType>(k) * dims[1] + j) * dims[0];
+          for (int i = labelBoundsWithMargin[0]; i <= labelBoundsWithMargin[1]; i++)
+            {
+            *(labelPtr++) = (rowPtr[i] == label ? label : 0);
+            }
+          }
+        }
+
+      typename ContourInterpolatorType::Pointer interpolatorFilter = ContourInterpolatorType::New();
+      interpolatorFilter->SetLabel(label);
+      interpolatorFilter->SetAxis(self->GetAxis());
+      interpolatorFilter->SetHeuristicAlignment(self->GetHeuristicAlignment());
+      interpolatorFilter->SetUseDistanceTransform(self->GetUseDistanceTransform());
+      interpolatorFilter->SetUseBallStructuringElement(self->GetUseBallStructuringElement());
+      interpolatorFilter->SetInput(labelImage);
+      interpolatorFilter->Update();
+      interpolatedLabelImages[labelIndex] = interpolatorFilter->GetOutput();
+      }
+    });
+
+  // Combine results in label order, so that the output does not depend on the order of completion
+  for (size_t labelIndex = 0; labelIndex < labels.size(); labelIndex++)
+    {
+    const std::vector<int>& labelBoundsWithMargin = bounds[labelIndex];
+    T label = labels[labelIndex];
+    const T* labelPtr = interpolatedLabelImages[labelIndex]->GetBufferPointer();
+    for (int k = labelBoundsWithMargin[4]; k <= labelBoundsWithMargin[5]; k++)
+      {
+      for (int j = labelBoundsWithMargin[2]; j <= labelBoundsWithMargin[3]; j++)
+        {
+        T* rowPtr = outPtr + (static_cast<vtkIdType>(k) * dims[1] + j) * dims[0];
+        for (int i = labelBoundsWithMargin[0]; i <= labelBoundsWithMargin[1]; i++, labelPtr++)
+          {
+          if (*labelPtr == label && rowPtr[i] == 0)
+            {
+            rowPtr[i] = label;
+            }
+          }
+        }
+      }
+    }
+}
+
 
 
 
@@ -105,7 +249,15 @@ void vtkITKMorphologicalContourInterpolator::SimpleExecute(vtkImageData *input,
 #undef VTK_TYPE_USE_LONG_LONG
 #undef VTK_TYPE_USE___INT64
 
-#define CALL  vtkITKMorphologicalContourInterpolatorExecute(this, input, output, static_cast<VTK_TT *>(inPtr), static_cast<VTK_TT *>(outPtr));
+#define CALL  \
+    if (this->GetLabel() == 0 && this->GetInterpolateLabelsInParallel()) \
+      { \
+      vtkITKMorphologicalContourInterpolatorExecuteLabelsInParallel(this, input, static_cast<VTK_TT *>(inPtr), static_cast<VTK_TT *>(outPtr)); \
+      } \
+    else \
+      { \
+      vtkITKMorphologicalContourInterpolatorExecute(this, input, output, static_cast<VTK_TT *>(inPtr), static_cast<VTK_TT *>(outPtr)); \
+      }
 
     void* inPtr = input->GetScalarPointer();
     void* outPtr = output->GetScalarPointer();
@@ -137,4 +289,5 @@ void vtkITKMorphologicalContourInterpolator::PrintSelf(ostream& os, vtkIndent in
   os << indent << "HeuristicAlignment: " << HeuristicAlignment << std::endl;
   os << indent << "UseDistanceTransform: " << UseDistanceTransform << std::endl;
   os << indent << "UseBallStructuringElement: " << UseBallStructuringElement << std::endl;
+  os << indent << "InterpolateLabelsInParallel: " << InterpolateLabelsInParallel << std::endl;
 }
@@ -44,6 +44,15 @@ public:
   vtkGetMacro(UseBallStructuringElement, bool);
   vtkSetMacro(UseBallStructuringElement, bool);
 
+  /// If all labels are interpolated (Label is 0) then interpolate each label separately,
+  /// in parallel, only within the bounding box of the label.
+  /// Where interpolated regions of different labels overlap, the lower label value is kept.
+  /// Voxels that are labeled in the input are never changed.
+  /// Default is ON.
+  vtkGetMacro(InterpolateLabelsInParallel, bool);
+  vtkSetMacro(InterpolateLabelsInParallel, bool);
+  vtkBooleanMacro(InterpolateLabelsInParallel, bool);
+
 protected:
   vtkITKMorphologicalContourInterpolator();
   ~vtkITKMorphologicalContourInterpolator() override;
@@ -55,6 +64,7 @@ protected:
   bool HeuristicAlignment{true};
   bool UseDistanceTransform{false};
   bool UseBallStructuringElement{false};
+  bool InterpolateLabelsInParallel{true};
 
 private:
   vtkITKMorphologicalContourInterpolator(const vtkITKMorphologicalContourInterpolator&) = delete;
@@ -0,0 +1,55 @@
+/*=========================================================================
+
+  Copyright Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+==========================================================================*/
+
+#include "vtkITKSimpleImageToImageFilter.h"
+
+// VTK includes
+#include <vtkObjectFactory.h>
+
+//----------------------------------------------------------------------------
+vtkITKSimpleImageToImageFilter::vtkITKSimpleImageToImageFilter()
+{
+  this->ProgressCommand = ProgressCommandType::New();
+  this->ProgressCommand->SetCallbackFunction(this, &vtkITKSimpleImageToImageFilter::OnITKProgress);
+}
+
+//----------------------------------------------------------------------------
+vtkITKSimpleImageToImageFilter::~vtkITKSimpleImageToImageFilter() = default;
+
+//----------------------------------------------------------------------------
+void vtkITKSimpleImageToImageFilter::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "NumberOfWorkUnits: " << this->NumberOfWorkUnits << std::endl;
+  os << indent << "NumberOfStreamDivisions: " << this->NumberOfStreamDivisions << std::endl;
+}
+
+//----------------------------------------------------------------------------
+void vtkITKSimpleImageToImageFilter::ConfigureITKProcessObject(itk::ProcessObject* filter)
+{
+  if (!filter)
+    {
+    return;
+    }
+  if (this->NumberOfWorkUnits > 0)
+    {
+    filter->SetNumberOfWorkUnits(this->NumberOfWorkUnits);
+    }
+  filter->AddObserver(itk::ProgressEvent(), this->ProgressCommand);
+}
+
+//----------------------------------------------------------------------------
+void vtkITKSimpleImageToImageFilter::OnITKProgress(itk::Object* caller, const itk::EventObject& vtkNotUsed(event))
+{
+  itk::ProcessObject* filter = dynamic_cast<itk::ProcessObject*>(caller);
+  if (filter)
+    {
+    this->UpdateProgress(filter->GetProgress());
+    }
+}
@@ -0,0 +1,223 @@
+/*=========================================================================
+
+  Copyright Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+==========================================================================*/
+
+#ifndef __vtkITKSimpleImageToImageFilter_h
+#define __vtkITKSimpleImageToImageFilter_h
+
+#include "vtkITK.h"
+
+// VTK includes
+#include <vtkAOSDataArrayTemplate.h>
+#include <vtkImageData.h>
+#include <vtkPointData.h>
+#include <vtkSimpleImageToImageFilter.h>
+
+// ITK includes
+#include <itkCommand.h>
+#include <itkImage.h>
+#include <itkImportImageFilter.h>
+#include <itkInPlaceImageFilter.h>
+#include <itkStreamingImageFilter.h>
+
+/// Expands to the cases of a switch on VTK scalar type, for the types that
+/// itk::Image supports. The call can use VTK_TT as scalar type, like for vtkTemplateMacro.
+#define vtkITKTemplateMacro(call)                                       \
+  vtkTemplateMacroCase(VTK_DOUBLE, double, call);                       \
+  vtkTemplateMacroCase(VTK_FLOAT, float, call);                         \
+  vtkTemplateMacroCase(VTK_LONG, long, call);                           \
+  vtkTemplateMacroCase(VTK_UNSIGNED_LONG, unsigned long, call);         \
+  vtkTemplateMacroCase(VTK_INT, int, call);                             \
+  vtkTemplateMacroCase(VTK_UNSIGNED_INT, unsigned int, call);           \
+  vtkTemplateMacroCase(VTK_SHORT, short, call);                         \
+  vtkTemplateMacroCase(VTK_UNSIGNED_SHORT, unsigned short, call);       \
+  vtkTemplateMacroCase(VTK_CHAR, char, call);                           \
+  vtkTemplateMacroCase(VTK_SIGNED_CHAR, signed char, call);             \
+  vtkTemplateMacroCase(VTK_UNSIGNED_CHAR, unsigned char, call)
+
+/// \brief Base class for wrapping ITK filters that process a whole image.
+///
+/// Unlike vtkITKImageToImageFilter (that connects the pipelines through
+/// importer/exporter filters and a fixed pixel type), the ITK filters are
+/// instantiated for the scalar type of the input image (see vtkITKTemplateMacro)
+/// and no voxels are copied: the input voxels are used by ITK through
+/// itk::ImportImageFilter and the output voxel array takes over the buffer
+/// allocated by the ITK filter.
+///
+/// Subclasses implement SimpleExecute() by dispatching on the scalar type to a
+/// member template that creates the ITK filters, passes them to ConfigureITKFilter(),
+/// and calls UpdateITKOutput() to generate the output.
+class VTK_ITK_EXPORT vtkITKSimpleImageToImageFilter : public vtkSimpleImageToImageFilter
+{
+public:
+  vtkTypeMacro(vtkITKSimpleImageToImageFilter, vtkSimpleImageToImageFilter);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  /// Number of work units that the ITK filters split the processing into.
+  /// 0 (default) uses the ITK global default.
+  vtkSetClampMacro(NumberOfWorkUnits, int, 0, VTK_INT_MAX);
+  vtkGetMacro(NumberOfWorkUnits, int);
+
+  /// Number of pieces the output is generated in (default: 1).
+  /// Reduces the memory usage of filters that support streaming.
+  vtkSetClampMacro(NumberOfStreamDivisions, int, 1, VTK_INT_MAX);
+  vtkGetMacro(NumberOfStreamDivisions, int);
+
+protected:
+  vtkITKSimpleImageToImageFilter();
+  ~vtkITKSimpleImageToImageFilter() override;
+
+  /// Create an ITK image that uses the voxels of the first scalar component of the VTK image.
+  /// Origin is set from the VTK image, spacing is set only if useSpacing is enabled.
+  template <class TPixel>
+  typename itk::Image<TPixel, 3>::Pointer ImportVTKImage(vtkImageData* image, bool useSpacing = true);
+
+  /// Apply the number of work units to an ITK filter and report its progress
+  /// as progress of this filter. In-place processing is disabled, so that imported
+  /// VTK images are not modified. It must be called for each ITK filter created by the subclass.
+  template <class TFilter>
+  void ConfigureITKFilter(TFilter* filter);
+  void ConfigureITKProcessObject(itk::ProcessObject* filter);
+
+  /// Update an ITK filter (in NumberOfStreamDivisions pieces) and store its output
+  /// in the scalars of output. The scalar type of output must match the output pixel type.
+  /// The output scalar array takes over the buffer of the ITK output image,
+  /// voxels are only copied if the ITK filter does not own its output buffer.
+  /// Returns false if an ITK exception occurred.
+  template <class TFilter>
+  bool UpdateITKOutput(TFilter* filter, vtkImageData* output);
+
+  /// Called on progress events of the ITK filters
+  void OnITKProgress(itk::Object* caller, const itk::EventObject& event);
+
+  int NumberOfWorkUnits{0};
+  int NumberOfStreamDivisions{1};
+
+  typedef itk::MemberCommand<vtkITKSimpleImageToImageFilter> ProgressCommandType;
+  ProgressCommandType::Pointer ProgressCommand;
+
+private:
+  vtkITKSimpleImageToImageFilter(const vtkITKSimpleImageToImageFilter&) = delete;
+  void operator=(const vtkITKSimpleImageToImageFilter&) = delete;
+};
+
+namespace vtkITKSimpleImageToImageFilterHelper
+{
+  /// Filters that could overwrite the imported VTK input in place must not do so
+  template <class TInputImage, class TOutputImage>
+  void DisableInPlace(itk::InPlaceImageFilter<TInputImage, TOutputImage>* filter)
+    {
+    filter->InPlaceOff();
+    }
+  inline void DisableInPlace(...) {}
+}
+
+//----------------------------------------------------------------------------
+template <class TPixel>
+typename itk::Image<TPixel, 3>::Pointer vtkITKSimpleImageToImageFilter::ImportVTKImage(vtkImageData* image, bool useSpacing)
+{
+  typedef itk::ImportImageFilter<TPixel, 3> ImportFilterType;
+  typename ImportFilterType::Pointer importer = ImportFilterType::New();
+
+  int dims[3] = { 0, 0, 0 };
+  image->GetDimensions(dims);
+  typename ImportFilterType::SizeType size;
+  typename ImportFilterType::IndexType start;
+  for (int i = 0; i < 3; i++)
+    {
+    size[i] = dims[i];
+    start[i] = 0;
+    }
+  typename ImportFilterType::RegionType region;
+  region.SetIndex(start);
+  region.SetSize(size);
+  importer->SetRegion(region);
+  importer->SetOrigin(image->GetOrigin());
+  if (useSpacing)
+    {
+    importer->SetSpacing(image->GetSpacing());
+    }
+  // The VTK image keeps the ownership of the voxels
+  importer->SetImportPointer(static_cast<TPixel*>(image->GetScalarPointer()),
+    region.GetNumberOfPixels(), false);
+  importer->Update();
+
+  typename itk::Image<TPixel, 3>::Pointer itkImage = importer->GetOutput();
+  itkImage->DisconnectPipeline();
+  return itkImage;
+}
+
+//----------------------------------------------------------------------------
+template <class TFilter>
+void vtkITKSimpleImageToImageFilter::ConfigureITKFilter(TFilter* filter)
+{
+  vtkITKSimpleImageToImageFilterHelper::DisableInPlace(filter);
+  this->ConfigureITKProcessObject(filter);
+}
+
+//----------------------------------------------------------------------------
+template <class TFilter>
+bool vtkITKSimpleImageToImageFilter::UpdateITKOutput(TFilter* filter, vtkImageData* output)
+{
+  typedef typename TFilter::OutputImageType ImageType;
+  typedef typename ImageType::PixelType PixelType;
+  typedef vtkAOSDataArrayTemplate<PixelType> ArrayType;
+  ArrayType* outputArray = vtkArrayDownCast<ArrayType>(output->GetPointData()->GetScalars());
+  if (!outputArray || outputArray->GetNumberOfComponents() != 1)
+    {
+    vtkErrorMacro("UpdateITKOutput: output scalars do not match the output pixel type of the ITK filter");
+    return false;
+    }
+  vtkIdType numberOfVoxels = outputArray->GetNumberOfTuples();
+
+  typename ImageType::Pointer itkOutput;
+  try
+    {
+    if (this->NumberOfStreamDivisions > 1)
+      {
+      typedef itk::StreamingImageFilter<ImageType, ImageType> StreamerType;
+      typename StreamerType::Pointer streamer = StreamerType::New();
+      streamer->SetInput(filter->GetOutput());
+      streamer->SetNumberOfStreamDivisions(this->NumberOfStreamDivisions);
+      streamer->Update();
+      itkOutput = streamer->GetOutput();
+      }
+    else
+      {
+      filter->Update();
+      itkOutput = filter->GetOutput();
+      }
+    }
+  catch (itk::ExceptionObject& err)
+    {
+    vtkErrorMacro("UpdateITKOutput: ITK filter failed. Details: " << err);
+    return false;
+    }
+
+  typename ImageType::PixelContainer* container = itkOutput->GetPixelContainer();
+  vtkIdType numberOfGeneratedVoxels = static_cast<vtkIdType>(container->Size());
+  if (numberOfGeneratedVoxels != numberOfVoxels)
+    {
+    vtkErrorMacro("UpdateITKOutput: size of ITK output (" << numberOfGeneratedVoxels
+      << ") does not match the output image (" << numberOfVoxels << ")");
+    return false;
+    }
+  if (container->GetContainerManageMemory())
+    {
+    // ITK allocates pixel buffers with new[], the array will delete[] it
+    container->SetContainerManageMemory(false);
+    outputArray->SetArray(container->GetBufferPointer(), numberOfVoxels, 0, ArrayType::VTK_DATA_ARRAY_DELETE);
+    }
+  else
+    {
+    memcpy(outputArray->GetPointer(0), container->GetBufferPointer(), numberOfVoxels * sizeof(PixelType));
+    }
+  return true;
+}
+
+#endif
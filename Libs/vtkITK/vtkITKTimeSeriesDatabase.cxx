@@ -10,10 +10,37 @@
 
 #include <vtkInformation.h>
 #include <vtkInformationVector.h>
+#include <vtkNew.h>
 #include <vtkStreamingDemandDrivenPipeline.h>
-#include <vtkUnsignedLongArray.h>
+#include <vtkShortArray.h>
 
 vtkStandardNewMacro(vtkITKTimeSeriesDatabase);
+
+//----------------------------------------------------------------------------
+bool vtkITKTimeSeriesDatabase::Connect(const char* filename)
+{
+  try
+    {
+    this->m_Filter->Connect(filename);
+    }
+  catch (itk::ExceptionObject& err)
+    {
+    vtkErrorMacro("Connect: failed to open time series database " << (filename ? filename : "(null)")
+      << ". Details: " << err);
+    return false;
+    }
+  this->Modified();
+  return true;
+}
+
+//----------------------------------------------------------------------------
+void vtkITKTimeSeriesDatabase::Disconnect()
+{
+  this->m_Filter->Disconnect();
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
 int vtkITKTimeSeriesDatabase::RequestInformation(
   vtkInformation * vtkNotUsed(request),
   vtkInformationVector ** vtkNotUsed(inputVector),
@@ -42,19 +69,43 @@ int vtkITKTimeSeriesDatabase::RequestInformation(
   outInfo->Set(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT(), extent, 6);
   vtkDataObject::SetPointDataActiveScalarInfo(outInfo, VTK_SHORT, 1);
   return 1;
-};
+}
 
 
-  // defined in the subclasses
+//----------------------------------------------------------------------------
 void vtkITKTimeSeriesDatabase::ExecuteDataWithInformation(vtkDataObject *output, vtkInformation* outInfo)
-  {
-    this->AllocateOutputData(output, outInfo);
-    itk::ImportImageContainer<itk::SizeValueType, OutputImagePixelType>::Pointer PixelContainerShort;
-    PixelContainerShort = this->m_Filter->GetOutput()->GetPixelContainer();
-    void *ptr = static_cast<void *> (PixelContainerShort->GetBufferPointer());
-    vtkUnsignedLongArray::SafeDownCast(
-      vtkImageData::SafeDownCast(output)->GetPointData()->GetScalars())
-      ->SetVoidArray(ptr, PixelContainerShort->Size(), 0,
-                     vtkAOSDataArrayTemplate<unsigned long>::VTK_DATA_ARRAY_DELETE);
-    PixelContainerShort->ContainerManageMemoryOff();
-  };
+{
+  vtkImageData* outputImage = vtkImageData::SafeDownCast(output);
+  if (!outputImage)
+    {
+    return;
+    }
+  try
+    {
+    this->m_Filter->GetOutput()->SetRequestedRegionToLargestPossibleRegion();
+    this->m_Filter->Update();
+    }
+  catch (itk::ExceptionObject& err)
+    {
+    vtkErrorMacro("ExecuteDataWithInformation: failed to read volume " << this->m_Filter->GetCurrentImage()
+      << ". Details: " << err);
+    return;
+    }
+
+  // The output takes over the voxels read by the database, no need to allocate and copy
+  outputImage->SetExtent(outInfo->Get(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT()));
+  SourceType::OutputImageType::PixelContainer* pixelContainer = this->m_Filter->GetOutput()->GetPixelContainer();
+  vtkNew<vtkShortArray> scalars;
+  if (pixelContainer->GetContainerManageMemory())
+    {
+    pixelContainer->ContainerManageMemoryOff();
+    scalars->SetArray(pixelContainer->GetBufferPointer(), pixelContainer->Size(), 0,
+      vtkShortArray::VTK_DATA_ARRAY_DELETE);
+    }
+  else
+    {
+    scalars->SetNumberOfTuples(pixelContainer->Size());
+    memcpy(scalars->GetPointer(0), pixelContainer->GetBufferPointer(), pixelContainer->Size() * sizeof(OutputImagePixelType));
+    }
+  outputImage->GetPointData()->SetScalars(scalars);
+}
@@ -48,9 +48,22 @@ public:
     itk::TimeSeriesDatabase<OutputImagePixelType>::CreateFromFileArchetype ( TSDFilename, ArchetypeFilename );
   };
 
-  /// Connect/Disconnect to a database
-  /// void Connect ( const char* filename ) { this->m_Filter->Connect ( filename ); this->Modified(); };
-  /// void Disconnect() { this->m_Filter->Disconnect(); }
+  /// Connect/Disconnect to a database.
+  /// Connect returns false if the database cannot be opened.
+  bool Connect ( const char* filename );
+  void Disconnect();
+
+  /// Size of the cache of recently accessed blocks, in MiB
+  void SetCacheSizeInMiB ( float size )
+  { DelegateITKInputMacro ( SetCacheSizeInMiB, size ); };
+  float GetCacheSizeInMiB()
+  { DelegateITKOutputMacro ( GetCacheSizeInMiB ); };
+
+  /// Start reading the next volume in the background when a volume is read
+  void SetPrefetchNextImage ( bool prefetch )
+  { DelegateITKInputMacro ( SetPrefetchNextImage, prefetch ); };
+  bool GetPrefetchNextImage()
+  { DelegateITKOutputMacro ( GetPrefetchNextImage ); };
 
   /// Get/Set the current time stamp to read
   void SetCurrentImage ( unsigned int value )
@@ -0,0 +1,177 @@
+/*==============================================================================
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// VTK includes
+#include <vtkIdTypeArray.h>
+#include <vtkNew.h>
+#include <vtkTable.h>
+
+// SegmentationCore includes
+#include "vtkLabelmapStatistics.h"
+#include "vtkOrientedImageData.h"
+#include "vtkOrientedImageDataResample.h"
+
+// STD includes
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+bool IsEqual(double a, double b)
+{
+  return std::abs(a - b) < 1e-6;
+}
+
+//----------------------------------------------------------------------------
+bool TestLabelStatistics()
+{
+  int extent[6] = { 0, 19, 0, 19, 0, 19 };
+  vtkNew<vtkOrientedImageData> labelmap;
+  labelmap->SetExtent(extent);
+  labelmap->SetSpacing(0.5, 1.0, 2.0);
+  labelmap->SetOrigin(10.0, 20.0, 30.0);
+  labelmap->AllocateScalars(VTK_SHORT, 1);
+  vtkOrientedImageDataResample::FillImage(labelmap.GetPointer(), 0);
+
+  // Label 1: 4x4x4 cube, label 2: 2x2x10 bar spanning many slices
+  int cubeExtent[6] = { 2, 5, 2, 5, 2, 5 };
+  vtkOrientedImageDataResample::FillImage(labelmap.GetPointer(), 1, cubeExtent);
+  int barExtent[6] = { 10, 11, 10, 11, 5, 14 };
+  vtkOrientedImageDataResample::FillImage(labelmap.GetPointer(), 2, barExtent);
+
+  // Intensity is the K index of the voxel
+  vtkNew<vtkOrientedImageData> intensityImage;
+  intensityImage->SetExtent(extent);
+  intensityImage->SetSpacing(0.5, 1.0, 2.0);
+  intensityImage->SetOrigin(10.0, 20.0, 30.0);
+  intensityImage->AllocateScalars(VTK_FLOAT, 1);
+  for (int k = extent[4]; k <= extent[5]; ++k)
+    {
+    for (int j = extent[2]; j <= extent[3]; ++j)
+      {
+      for (int i = extent[0]; i <= extent[1]; ++i)
+        {
+        intensityImage->SetScalarComponentFromDouble(i, j, k, 0, k);
+        }
+      }
+    }
+
+  vtkNew<vtkLabelmapStatistics> statisticsCalculator;
+  statisticsCalculator->SetLabelmap(labelmap.GetPointer());
+  statisticsCalculator->SetIntensityImage(intensityImage.GetPointer());
+  if (!statisticsCalculator->Compute())
+    {
+    std::cerr << __LINE__ << ": Failed to compute label statistics" << std::endl;
+    return false;
+    }
+
+  std::vector<int> labelValues;
+  statisticsCalculator->GetLabelValues(labelValues);
+  if (labelValues.size() != 2 || labelValues[0] != 1 || labelValues[1] != 2)
+    {
+    std::cerr << __LINE__ << ": Invalid label values" << std::endl;
+    return false;
+    }
+
+  vtkLabelmapStatistics::LabelStatisticsType cubeStatistics;
+  statisticsCalculator->GetLabelStatistics(1, cubeStatistics);
+  if (cubeStatistics.VoxelCount != 64 || !IsEqual(cubeStatistics.Volume, 64.0)
+    || !std::equal(cubeExtent, cubeExtent + 6, cubeStatistics.Extent))
+    {
+    std::cerr << __LINE__ << ": Invalid cube statistics: " << cubeStatistics.VoxelCount << " voxels, volume "
+      << cubeStatistics.Volume << std::endl;
+    return false;
+    }
+  // Centroid is at IJK (3.5, 3.5, 3.5)
+  if (!IsEqual(cubeStatistics.Centroid[0], 11.75) || !IsEqual(cubeStatistics.Centroid[1], 23.5)
+    || !IsEqual(cubeStatistics.Centroid[2], 37.0))
+    {
+    std::cerr << __LINE__ << ": Invalid cube centroid: " << cubeStatistics.Centroid[0] << ", "
+      << cubeStatistics.Centroid[1] << ", " << cubeStatistics.Centroid[2] << std::endl;
+    return false;
+    }
+  // Intensities are 2, 3, 4, 5 with equal weights
+  if (!IsEqual(cubeStatistics.Minimum, 2.0) || !IsEqual(cubeStatistics.Maximum, 5.0)
+    || !IsEqual(cubeStatistics.Mean, 3.5) || !IsEqual(cubeStatistics.StandardDeviation, std::sqrt(1.25)))
+    {
+    std::cerr << __LINE__ << ": Invalid cube intensity statistics" << std::endl;
+    return false;
+    }
+
+  vtkLabelmapStatistics::LabelStatisticsType barStatistics;
+  statisticsCalculator->GetLabelStatistics(2, barStatistics);
+  if (barStatistics.VoxelCount != 40 || !std::equal(barExtent, barExtent + 6, barStatistics.Extent)
+    || !IsEqual(barStatistics.Mean, 9.5) || !IsEqual(barStatistics.Minimum, 5.0) || !IsEqual(barStatistics.Maximum, 14.0))
+    {
+    std::cerr << __LINE__ << ": Invalid bar statistics" << std::endl;
+    return false;
+    }
+
+  vtkLabelmapStatistics::LabelStatisticsType missingStatistics;
+  if (statisticsCalculator->GetLabelStatistics(3, missingStatistics))
+    {
+    std::cerr << __LINE__ << ": Statistics are not expected for a missing label" << std::endl;
+    return false;
+    }
+
+  vtkNew<vtkTable> table;
+  statisticsCalculator->GetStatisticsTable(table.GetPointer());
+  vtkIdTypeArray* voxelCountArray = vtkIdTypeArray::SafeDownCast(table->GetColumnByName("VoxelCount"));
+  if (table->GetNumberOfRows() != 2 || !voxelCountArray || voxelCountArray->GetValue(1) != 40
+    || !table->GetColumnByName("StandardDeviation"))
+    {
+    std::cerr << __LINE__ << ": Invalid statistics table" << std::endl;
+    return false;
+    }
+
+  // Intensity image with different geometry is rejected
+  intensityImage->SetSpacing(1.0, 1.0, 1.0);
+  if (statisticsCalculator->Compute())
+    {
+    std::cerr << __LINE__ << ": Computation is expected to fail for mismatching intensity image geometry" << std::endl;
+    return false;
+    }
+
+  // Without intensity image only the geometric statistics are computed
+  statisticsCalculator->SetIntensityImage(nullptr);
+  if (!statisticsCalculator->Compute())
+    {
+    std::cerr << __LINE__ << ": Failed to compute label statistics without intensity image" << std::endl;
+    return false;
+    }
+  statisticsCalculator->GetStatisticsTable(table.GetPointer());
+  if (table->GetNumberOfRows() != 2 || table->GetColumnByName("Mean"))
+    {
+    std::cerr << __LINE__ << ": Invalid statistics table without intensity image" << std::endl;
+    return false;
+    }
+
+  return true;
+}
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+int vtkLabelmapStatisticsTest1(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
+{
+  if (!TestLabelStatistics())
+    {
+    return EXIT_FAILURE;
+    }
+
+  std::cout << "Labelmap statistics test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
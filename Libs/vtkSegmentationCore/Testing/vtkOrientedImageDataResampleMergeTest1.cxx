@@ -0,0 +1,215 @@
+/*==============================================================================
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// VTK includes
+#include <vtkImageData.h>
+#include <vtkMath.h>
+#include <vtkNew.h>
+#include <vtkTimerLog.h>
+
+// SegmentationCore includes
+#include "vtkOrientedImageData.h"
+#include "vtkOrientedImageDataResample.h"
+
+// STD includes
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+template <class T>
+void FillRandomImage(vtkOrientedImageData* image, const int extent[6], int scalarType, int maxValue)
+{
+  image->SetExtent(const_cast<int*>(extent));
+  image->AllocateScalars(scalarType, 1);
+  T* ptr = static_cast<T*>(image->GetScalarPointer());
+  vtkIdType numberOfVoxels = image->GetNumberOfPoints();
+  for (vtkIdType i = 0; i < numberOfVoxels; ++i)
+    {
+    // Mostly empty, as typical labelmaps
+    double r = vtkMath::Random();
+    ptr[i] = static_cast<T>(r < 0.7 ? 0 : vtkMath::Round(vtkMath::Random(0.0, maxValue)));
+    }
+}
+
+//----------------------------------------------------------------------------
+/// Straightforward implementation of ModifyImage, as a reference for correctness and speed
+template <class T>
+void ReferenceModifyImage(vtkImageData* baseImage, vtkImageData* modifierImage, int operation, T maskThreshold, T fillValue)
+{
+  int* baseExt = baseImage->GetExtent();
+  int* modifierExt = modifierImage->GetExtent();
+  int updateExt[6] = { 0, -1, 0, -1, 0, -1 };
+  for (int idx = 0; idx < 3; ++idx)
+    {
+    updateExt[idx * 2] = std::max(baseExt[idx * 2], modifierExt[idx * 2]);
+    updateExt[idx * 2 + 1] = std::min(baseExt[idx * 2 + 1], modifierExt[idx * 2 + 1]);
+    }
+  for (int k = updateExt[4]; k <= updateExt[5]; ++k)
+    {
+    for (int j = updateExt[2]; j <= updateExt[3]; ++j)
+      {
+      T* basePtr = static_cast<T*>(baseImage->GetScalarPointer(updateExt[0], j, k));
+      T* modifierPtr = static_cast<T*>(modifierImage->GetScalarPointer(updateExt[0], j, k));
+      for (int i = updateExt[0]; i <= updateExt[1]; ++i, ++basePtr, ++modifierPtr)
+        {
+        if (operation == vtkOrientedImageDataResample::OPERATION_MAXIMUM && *modifierPtr > *basePtr)
+          {
+          *basePtr = *modifierPtr;
+          }
+        else if (operation == vtkOrientedImageDataResample::OPERATION_MINIMUM && *modifierPtr < *basePtr)
+          {
+          *basePtr = *modifierPtr;
+          }
+        else if (operation == vtkOrientedImageDataResample::OPERATION_MASKING && *modifierPtr > maskThreshold)
+          {
+          *basePtr = fillValue;
+          }
+        }
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+template <class T>
+bool TestModifyImage(int scalarType, const char* scalarTypeName, int maxValue)
+{
+  int baseExtent[6] = { 0, 255, 0, 255, 0, 127 };
+  // Modifier is smaller and shifted, to test non-contiguous rows and slices
+  int modifierExtent[6] = { 10, 240, -5, 200, 3, 140 };
+
+  vtkNew<vtkOrientedImageData> baseImage;
+  FillRandomImage<T>(baseImage.GetPointer(), baseExtent, scalarType, maxValue);
+  vtkNew<vtkOrientedImageData> modifierImage;
+  FillRandomImage<T>(modifierImage.GetPointer(), modifierExtent, scalarType, maxValue);
+
+  const int operations[3] = { vtkOrientedImageDataResample::OPERATION_MAXIMUM,
+    vtkOrientedImageDataResample::OPERATION_MINIMUM, vtkOrientedImageDataResample::OPERATION_MASKING };
+  const char* operationNames[3] = { "maximum", "minimum", "masking" };
+  vtkNew<vtkTimerLog> timer;
+  for (int operationIndex = 0; operationIndex < 3; ++operationIndex)
+    {
+    int operation = operations[operationIndex];
+    vtkNew<vtkOrientedImageData> expectedImage;
+    expectedImage->DeepCopy(baseImage.GetPointer());
+    vtkNew<vtkOrientedImageData> actualImage;
+    actualImage->DeepCopy(baseImage.GetPointer());
+
+    timer->StartTimer();
+    ReferenceModifyImage<T>(expectedImage.GetPointer(), modifierImage.GetPointer(), operation, 1, 3);
+    timer->StopTimer();
+    double referenceTime = timer->GetElapsedTime();
+
+    timer->StartTimer();
+    vtkOrientedImageDataResample::ModifyImage(actualImage.GetPointer(), modifierImage.GetPointer(), operation, nullptr, 1, 3);
+    timer->StopTimer();
+    double modifyImageTime = timer->GetElapsedTime();
+
+    std::cout << scalarTypeName << " " << operationNames[operationIndex] << ": reference " << referenceTime * 1000.0
+      << " ms, ModifyImage " << modifyImageTime * 1000.0 << " ms" << std::endl;
+
+    if (memcmp(expectedImage->GetScalarPointer(), actualImage->GetScalarPointer(),
+      expectedImage->GetNumberOfPoints() * expectedImage->GetScalarSize()) != 0)
+      {
+      std::cerr << __LINE__ << ": ModifyImage result mismatch for " << scalarTypeName
+        << " " << operationNames[operationIndex] << std::endl;
+      return false;
+      }
+    }
+
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool TestCalculateEffectiveExtent()
+{
+  int extent[6] = { -3, 60, 0, 50, 2, 40 };
+  vtkNew<vtkOrientedImageData> image;
+  image->SetExtent(extent);
+  image->AllocateScalars(VTK_SHORT, 1);
+  vtkOrientedImageDataResample::FillImage(image.GetPointer(), 0);
+
+  int effectiveExtent[6] = { 0, -1, 0, -1, 0, -1 };
+  if (vtkOrientedImageDataResample::CalculateEffectiveExtent(image.GetPointer(), effectiveExtent))
+    {
+    std::cerr << __LINE__ << ": Effective extent of an empty image is expected to be empty" << std::endl;
+    return false;
+    }
+
+  // Voxels in different slices, each extending the extent in a different direction
+  const int voxels[4][3] = { { 10, 20, 5 }, { -3, 25, 12 }, { 40, 0, 30 }, { 55, 45, 12 } };
+  for (int voxelIndex = 0; voxelIndex < 4; ++voxelIndex)
+    {
+    image->SetScalarComponentFromDouble(voxels[voxelIndex][0], voxels[voxelIndex][1], voxels[voxelIndex][2], 0, 7);
+    }
+  image->Modified();
+  int expectedExtent[6] = { -3, 55, 0, 45, 5, 30 };
+  if (!vtkOrientedImageDataResample::CalculateEffectiveExtent(image.GetPointer(), effectiveExtent)
+    || !std::equal(effectiveExtent, effectiveExtent + 6, expectedExtent))
+    {
+    std::cerr << __LINE__ << ": Effective extent mismatch" << std::endl;
+    return false;
+    }
+
+  // Threshold is taken into account
+  int thresholdedExtent[6] = { 0, -1, 0, -1, 0, -1 };
+  if (vtkOrientedImageDataResample::CalculateEffectiveExtent(image.GetPointer(), thresholdedExtent, 10.0))
+    {
+    std::cerr << __LINE__ << ": Effective extent above threshold is expected to be empty" << std::endl;
+    return false;
+    }
+
+  // Cached value is updated when the image is modified
+  image->SetScalarComponentFromDouble(60, 50, 40, 0, 7);
+  image->Modified();
+  int modifiedExpectedExtent[6] = { -3, 60, 0, 50, 5, 40 };
+  if (!vtkOrientedImageDataResample::CalculateEffectiveExtent(image.GetPointer(), effectiveExtent)
+    || !std::equal(effectiveExtent, effectiveExtent + 6, modifiedExpectedExtent))
+    {
+    std::cerr << __LINE__ << ": Effective extent is not updated after modification" << std::endl;
+    return false;
+    }
+
+  return true;
+}
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+int vtkOrientedImageDataResampleMergeTest1(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
+{
+  vtkMath::RandomSeed(42);
+
+  if (!TestCalculateEffectiveExtent())
+    {
+    return EXIT_FAILURE;
+    }
+
+  if (!TestModifyImage<unsigned char>(VTK_UNSIGNED_CHAR, "unsigned char", 5))
+    {
+    return EXIT_FAILURE;
+    }
+  if (!TestModifyImage<short>(VTK_SHORT, "short", 1000))
+    {
+    return EXIT_FAILURE;
+    }
+  if (!TestModifyImage<int>(VTK_INT, "int", 100000))
+    {
+    return EXIT_FAILURE;
+    }
+
+  std::cout << "Merge test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,339 @@
+/*==============================================================================
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// VTK includes
+#include <vtkMath.h>
+#include <vtkMatrix4x4.h>
+#include <vtkNew.h>
+#include <vtkSmartPointer.h>
+#include <vtkTimerLog.h>
+#include <vtkTransform.h>
+
+// SegmentationCore includes
+#include "vtkBinaryLabelmapToClosedSurfaceConversionRule.h"
+#include "vtkBinaryLabelmapToSparseLabelmapConversionRule.h"
+#include "vtkClosedSurfaceToBinaryLabelmapConversionRule.h"
+#include "vtkClosedSurfaceToFractionalLabelmapConversionRule.h"
+#include "vtkFractionalLabelmapToClosedSurfaceConversionRule.h"
+#include "vtkOrientedImageData.h"
+#include "vtkOrientedImageDataResample.h"
+#include "vtkSegment.h"
+#include "vtkSegmentation.h"
+#include "vtkSegmentationConverter.h"
+#include "vtkSegmentationConverterFactory.h"
+#include "vtkSparseLabelmapToBinaryLabelmapConversionRule.h"
+
+// STD includes
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Measures the time of the most frequently used segmentation operations
+// at several image sizes and numbers of segments.
+// Each measurement is reported as a DartMeasurement, so that its history is
+// tracked on the dashboard.
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+void ReportMeasurement(const std::string& name, int imageSize, int numberOfSegments, double elapsedTime)
+{
+  std::stringstream ss;
+  ss << "vtkSegmentation-" << name << "-" << imageSize << "cube";
+  if (numberOfSegments > 0)
+    {
+    ss << "-" << numberOfSegments << "segments";
+    }
+  ss << "-milliseconds";
+  std::cout << "<DartMeasurement name=\"" << ss.str() << "\" type=\"numeric/double\">"
+            << elapsedTime * 1000.0 << "</DartMeasurement>" << std::endl;
+}
+
+//----------------------------------------------------------------------------
+void CreateSphereLabelmap(vtkOrientedImageData* image, int imageSize, const double center[3], double radius)
+{
+  image->SetExtent(0, imageSize - 1, 0, imageSize - 1, 0, imageSize - 1);
+  image->AllocateScalars(VTK_UNSIGNED_CHAR, 1);
+  unsigned char* ptr = static_cast<unsigned char*>(image->GetScalarPointer());
+  for (int k = 0; k < imageSize; ++k)
+    {
+    for (int j = 0; j < imageSize; ++j)
+      {
+      for (int i = 0; i < imageSize; ++i, ++ptr)
+        {
+        double distance2 = (i - center[0]) * (i - center[0])
+          + (j - center[1]) * (j - center[1]) + (k - center[2]) * (k - center[2]);
+        *ptr = (distance2 <= radius * radius ? 1 : 0);
+        }
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+void CreateRandomSphereLabelmap(vtkOrientedImageData* image, int imageSize)
+{
+  double radius = vtkMath::Random(imageSize * 0.05, imageSize * 0.15);
+  double center[3] = { 0.0, 0.0, 0.0 };
+  for (int i = 0; i < 3; ++i)
+    {
+    center[i] = vtkMath::Random(radius, imageSize - 1 - radius);
+    }
+  CreateSphereLabelmap(image, imageSize, center, radius);
+}
+
+//----------------------------------------------------------------------------
+/// Create a segmentation that has the specified representation of the source
+/// segmentation as master representation.
+void CopySegmentation(vtkSegmentation* source, const std::string& representationName, vtkSegmentation* segmentation)
+{
+  segmentation->SetMasterRepresentationName(representationName);
+  segmentation->SetConversionParameter(vtkSegmentationConverter::GetReferenceImageGeometryParameterName(),
+    source->GetConversionParameter(vtkSegmentationConverter::GetReferenceImageGeometryParameterName()));
+  std::vector<std::string> segmentIDs;
+  source->GetSegmentIDs(segmentIDs);
+  for (std::vector<std::string>::iterator segmentIDIt = segmentIDs.begin(); segmentIDIt != segmentIDs.end(); ++segmentIDIt)
+    {
+    vtkNew<vtkSegment> segment;
+    segment->AddRepresentation(representationName, source->GetSegment(*segmentIDIt)->GetRepresentation(representationName));
+    segmentation->AddSegment(segment.GetPointer(), *segmentIDIt);
+    }
+}
+
+//----------------------------------------------------------------------------
+bool TestResampleOperations(int imageSize)
+{
+  vtkNew<vtkOrientedImageData> image1;
+  CreateRandomSphereLabelmap(image1.GetPointer(), imageSize);
+  vtkNew<vtkOrientedImageData> image2;
+  CreateRandomSphereLabelmap(image2.GetPointer(), imageSize);
+  vtkNew<vtkTimerLog> timer;
+
+  vtkNew<vtkOrientedImageData> mergedImage;
+  timer->StartTimer();
+  if (!vtkOrientedImageDataResample::MergeImage(image1.GetPointer(), image2.GetPointer(), mergedImage.GetPointer(),
+    vtkOrientedImageDataResample::OPERATION_MAXIMUM))
+    {
+    std::cerr << __LINE__ << ": MergeImage failed" << std::endl;
+    return false;
+    }
+  timer->StopTimer();
+  ReportMeasurement("MergeImage", imageSize, 0, timer->GetElapsedTime());
+
+  timer->StartTimer();
+  if (!vtkOrientedImageDataResample::ModifyImage(image1.GetPointer(), image2.GetPointer(),
+    vtkOrientedImageDataResample::OPERATION_MAXIMUM))
+    {
+    std::cerr << __LINE__ << ": ModifyImage failed" << std::endl;
+    return false;
+    }
+  timer->StopTimer();
+  ReportMeasurement("ModifyImage", imageSize, 0, timer->GetElapsedTime());
+
+  int effectiveExtent[6] = { 0, -1, 0, -1, 0, -1 };
+  timer->StartTimer();
+  if (!vtkOrientedImageDataResample::CalculateEffectiveExtent(image1.GetPointer(), effectiveExtent))
+    {
+    std::cerr << __LINE__ << ": CalculateEffectiveExtent failed" << std::endl;
+    return false;
+    }
+  timer->StopTimer();
+  ReportMeasurement("CalculateEffectiveExtent", imageSize, 0, timer->GetElapsedTime());
+
+  // Reference geometry with different spacing and a rotation, as a typical
+  // segmentation geometry that is not aligned with the source volume
+  vtkNew<vtkTransform> referenceTransform;
+  referenceTransform->RotateZ(15.0);
+  referenceTransform->Scale(0.7, 0.7, 0.7);
+  vtkNew<vtkMatrix4x4> referenceMatrix;
+  referenceTransform->GetMatrix(referenceMatrix.GetPointer());
+  vtkNew<vtkOrientedImageData> referenceImage;
+  referenceImage->SetImageToWorldMatrix(referenceMatrix.GetPointer());
+  int referenceSize = static_cast<int>(imageSize / 0.7);
+  referenceImage->SetExtent(0, referenceSize - 1, 0, referenceSize - 1, 0, referenceSize - 1);
+
+  vtkNew<vtkOrientedImageData> resampledImage;
+  timer->StartTimer();
+  if (!vtkOrientedImageDataResample::ResampleOrientedImageToReferenceOrientedImage(
+    image1.GetPointer(), referenceImage.GetPointer(), resampledImage.GetPointer()))
+    {
+    std::cerr << __LINE__ << ": ResampleOrientedImageToReferenceOrientedImage failed" << std::endl;
+    return false;
+    }
+  timer->StopTimer();
+  ReportMeasurement("ResampleOrientedImageToReferenceOrientedImage", imageSize, 0, timer->GetElapsedTime());
+
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool TestSegmentationOperations(int imageSize, int numberOfSegments, bool testConversions)
+{
+  vtkNew<vtkSegmentation> segmentation;
+  segmentation->SetMasterRepresentationName(vtkSegmentationConverter::GetBinaryLabelmapRepresentationName());
+  vtkNew<vtkOrientedImageData> referenceImage;
+  referenceImage->SetExtent(0, imageSize - 1, 0, imageSize - 1, 0, imageSize - 1);
+  segmentation->SetConversionParameter(vtkSegmentationConverter::GetReferenceImageGeometryParameterName(),
+    vtkSegmentationConverter::SerializeImageGeometry(referenceImage.GetPointer()));
+  for (int i = 0; i < numberOfSegments; ++i)
+    {
+    vtkNew<vtkOrientedImageData> labelmap;
+    CreateRandomSphereLabelmap(labelmap.GetPointer(), imageSize);
+    vtkNew<vtkSegment> segment;
+    segment->AddRepresentation(vtkSegmentationConverter::GetBinaryLabelmapRepresentationName(), labelmap.GetPointer());
+    segmentation->AddSegment(segment.GetPointer());
+    }
+  vtkNew<vtkTimerLog> timer;
+
+  vtkNew<vtkOrientedImageData> mergedLabelmap;
+  timer->StartTimer();
+  if (!segmentation->GenerateMergedLabelmap(mergedLabelmap.GetPointer(), vtkSegmentation::EXTENT_UNION_OF_SEGMENTS))
+    {
+    std::cerr << __LINE__ << ": GenerateMergedLabelmap failed" << std::endl;
+    return false;
+    }
+  timer->StopTimer();
+  ReportMeasurement("GenerateMergedLabelmap", imageSize, numberOfSegments, timer->GetElapsedTime());
+
+  timer->StartTimer();
+  segmentation->CollapseBinaryLabelmaps(false);
+  timer->StopTimer();
+  int numberOfLayers = segmentation->GetNumberOfLayers();
+  if (numberOfLayers < 1 || numberOfLayers > numberOfSegments)
+    {
+    std::cerr << __LINE__ << ": Invalid number of layers after collapse " << numberOfLayers << std::endl;
+    return false;
+    }
+  ReportMeasurement("CollapseBinaryLabelmaps", imageSize, numberOfSegments, timer->GetElapsedTime());
+
+  timer->StartTimer();
+  if (!segmentation->GenerateMergedLabelmap(mergedLabelmap.GetPointer(), vtkSegmentation::EXTENT_UNION_OF_SEGMENTS))
+    {
+    std::cerr << __LINE__ << ": GenerateMergedLabelmap failed" << std::endl;
+    return false;
+    }
+  timer->StopTimer();
+  ReportMeasurement("GenerateMergedLabelmapShared", imageSize, numberOfSegments, timer->GetElapsedTime());
+
+  if (!testConversions)
+    {
+    return true;
+    }
+
+  // Binary labelmap to sparse labelmap and back
+  timer->StartTimer();
+  if (!segmentation->CreateRepresentation(vtkSegmentationConverter::GetSparseLabelmapRepresentationName()))
+    {
+    std::cerr << __LINE__ << ": Binary labelmap to sparse labelmap conversion failed" << std::endl;
+    return false;
+    }
+  timer->StopTimer();
+  ReportMeasurement("BinaryLabelmapToSparseLabelmap", imageSize, numberOfSegments, timer->GetElapsedTime());
+
+  vtkNew<vtkSegmentation> sparseSegmentation;
+  CopySegmentation(segmentation.GetPointer(), vtkSegmentationConverter::GetSparseLabelmapRepresentationName(),
+    sparseSegmentation.GetPointer());
+  timer->StartTimer();
+  if (!sparseSegmentation->CreateRepresentation(vtkSegmentationConverter::GetBinaryLabelmapRepresentationName()))
+    {
+    std::cerr << __LINE__ << ": Sparse labelmap to binary labelmap conversion failed" << std::endl;
+    return false;
+    }
+  timer->StopTimer();
+  ReportMeasurement("SparseLabelmapToBinaryLabelmap", imageSize, numberOfSegments, timer->GetElapsedTime());
+
+  // Binary labelmap to closed surface
+  timer->StartTimer();
+  if (!segmentation->CreateRepresentation(vtkSegmentationConverter::GetClosedSurfaceRepresentationName()))
+    {
+    std::cerr << __LINE__ << ": Binary labelmap to closed surface conversion failed" << std::endl;
+    return false;
+    }
+  timer->StopTimer();
+  ReportMeasurement("BinaryLabelmapToClosedSurface", imageSize, numberOfSegments, timer->GetElapsedTime());
+
+  // Closed surface to binary and fractional labelmap
+  vtkNew<vtkSegmentation> surfaceSegmentation;
+  CopySegmentation(segmentation.GetPointer(), vtkSegmentationConverter::GetClosedSurfaceRepresentationName(),
+    surfaceSegmentation.GetPointer());
+  timer->StartTimer();
+  if (!surfaceSegmentation->CreateRepresentation(vtkSegmentationConverter::GetBinaryLabelmapRepresentationName()))
+    {
+    std::cerr << __LINE__ << ": Closed surface to binary labelmap conversion failed" << std::endl;
+    return false;
+    }
+  timer->StopTimer();
+  ReportMeasurement("ClosedSurfaceToBinaryLabelmap", imageSize, numberOfSegments, timer->GetElapsedTime());
+
+  timer->StartTimer();
+  if (!surfaceSegmentation->CreateRepresentation(vtkSegmentationConverter::GetFractionalLabelmapRepresentationName()))
+    {
+    std::cerr << __LINE__ << ": Closed surface to fractional labelmap conversion failed" << std::endl;
+    return false;
+    }
+  timer->StopTimer();
+  ReportMeasurement("ClosedSurfaceToFractionalLabelmap", imageSize, numberOfSegments, timer->GetElapsedTime());
+
+  // Fractional labelmap to closed surface
+  vtkNew<vtkSegmentation> fractionalSegmentation;
+  CopySegmentation(surfaceSegmentation.GetPointer(), vtkSegmentationConverter::GetFractionalLabelmapRepresentationName(),
+    fractionalSegmentation.GetPointer());
+  timer->StartTimer();
+  if (!fractionalSegmentation->CreateRepresentation(vtkSegmentationConverter::GetClosedSurfaceRepresentationName()))
+    {
+    std::cerr << __LINE__ << ": Fractional labelmap to closed surface conversion failed" << std::endl;
+    return false;
+    }
+  timer->StopTimer();
+  ReportMeasurement("FractionalLabelmapToClosedSurface", imageSize, numberOfSegments, timer->GetElapsedTime());
+
+  return true;
+}
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+int vtkSegmentationPerformanceTest1(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
+{
+  vtkSegmentationConverterFactory* converterFactory = vtkSegmentationConverterFactory::GetInstance();
+  converterFactory->RegisterConverterRule(vtkSmartPointer<vtkBinaryLabelmapToClosedSurfaceConversionRule>::New());
+  converterFactory->RegisterConverterRule(vtkSmartPointer<vtkBinaryLabelmapToSparseLabelmapConversionRule>::New());
+  converterFactory->RegisterConverterRule(vtkSmartPointer<vtkClosedSurfaceToBinaryLabelmapConversionRule>::New());
+  converterFactory->RegisterConverterRule(vtkSmartPointer<vtkClosedSurfaceToFractionalLabelmapConversionRule>::New());
+  converterFactory->RegisterConverterRule(vtkSmartPointer<vtkFractionalLabelmapToClosedSurfaceConversionRule>::New());
+  converterFactory->RegisterConverterRule(vtkSmartPointer<vtkSparseLabelmapToBinaryLabelmapConversionRule>::New());
+
+  // Same random images in each run, to make measurements comparable
+  vtkMath::RandomSeed(1234);
+
+  const int imageSizes[] = { 64, 128, 192 };
+  const int numbersOfSegments[] = { 5, 20 };
+  for (int imageSize : imageSizes)
+    {
+    if (!TestResampleOperations(imageSize))
+      {
+      return EXIT_FAILURE;
+      }
+    for (int numberOfSegments : numbersOfSegments)
+      {
+      // Conversions of large images take a long time, they are only measured on smaller images
+      bool testConversions = (imageSize <= 128);
+      if (!TestSegmentationOperations(imageSize, numberOfSegments, testConversions))
+        {
+        return EXIT_FAILURE;
+        }
+      }
+    }
+
+  return EXIT_SUCCESS;
+}
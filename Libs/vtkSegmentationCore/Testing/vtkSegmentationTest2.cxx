@@ -26,6 +26,7 @@
 #include <vtkSphereSource.h>
 #include <vtkMatrix4x4.h>
 #include <vtkImageAccumulate.h>
+#include <vtkMath.h>
 
 // SegmentationCore includes
 #include "vtkSegmentation.h"
@@ -314,6 +315,288 @@ bool TestSharedLabelmapCasting()
   return true;
 }
 
+//----------------------------------------------------------------------------
+bool TestParallelConversion()
+{
+  // Create segmentations with the same content: separate labelmaps and two segments sharing a labelmap
+  vtkNew<vtkSegmentation> serialSegmentation;
+  serialSegmentation->SetNumberOfConversionThreads(1);
+  vtkNew<vtkSegmentation> parallelSegmentation;
+  parallelSegmentation->SetNumberOfConversionThreads(4);
+  // Segments in separate labelmaps are converted one by one, the shared labelmaps are converted in one pass
+  vtkNew<vtkSegmentation> separateSegmentation;
+  vtkSegmentation* segmentations[3] = { serialSegmentation, parallelSegmentation, separateSegmentation };
+  const int numberOfCubes = 6;
+  for (vtkSegmentation* segmentation : segmentations)
+    {
+    segmentation->SetMasterRepresentationName(vtkSegmentationConverter::GetBinaryLabelmapRepresentationName());
+    for (int i = 0; i < numberOfCubes; ++i)
+      {
+      vtkNew<vtkOrientedImageData> cubeImage;
+      int extent[6] = { 3 * i, 3 * i + 2 + i, 0, 2, 0, 2 };
+      CreateCubeLabelmap(cubeImage, extent);
+      vtkNew<vtkSegment> segment;
+      segment->AddRepresentation(vtkSegmentationConverter::GetBinaryLabelmapRepresentationName(), cubeImage);
+      segmentation->AddSegment(segment);
+      }
+    if (segmentation != separateSegmentation.GetPointer())
+      {
+      // Non-overlapping segments are merged into a shared labelmap
+      segmentation->CollapseBinaryLabelmaps(false);
+      }
+    if (!segmentation->CreateRepresentation(vtkSegmentationConverter::GetClosedSurfaceRepresentationName()))
+      {
+      std::cerr << __LINE__ << ": Failed to create closed surface representation" << std::endl;
+      return false;
+      }
+    }
+
+  std::vector<std::string> segmentIDs;
+  serialSegmentation->GetSegmentIDs(segmentIDs);
+  std::vector<std::string> parallelSegmentIDs;
+  parallelSegmentation->GetSegmentIDs(parallelSegmentIDs);
+  std::vector<std::string> separateSegmentIDs;
+  separateSegmentation->GetSegmentIDs(separateSegmentIDs);
+  if (separateSegmentation->GetNumberOfLayers() != numberOfCubes || serialSegmentation->GetNumberOfLayers() >= numberOfCubes)
+    {
+    std::cerr << __LINE__ << ": Invalid number of layers " << separateSegmentation->GetNumberOfLayers()
+      << " and " << serialSegmentation->GetNumberOfLayers() << std::endl;
+    return false;
+    }
+  if (segmentIDs.size() != static_cast<size_t>(numberOfCubes) || parallelSegmentIDs.size() != static_cast<size_t>(numberOfCubes)
+    || separateSegmentIDs.size() != static_cast<size_t>(numberOfCubes))
+    {
+    std::cerr << __LINE__ << ": Invalid number of segments" << std::endl;
+    return false;
+    }
+  for (int i = 0; i < numberOfCubes; ++i)
+    {
+    vtkPolyData* serialSurface = vtkPolyData::SafeDownCast(serialSegmentation->GetSegment(segmentIDs[i])->GetRepresentation(
+      vtkSegmentationConverter::GetClosedSurfaceRepresentationName()));
+    vtkPolyData* parallelSurface = vtkPolyData::SafeDownCast(parallelSegmentation->GetSegment(parallelSegmentIDs[i])->GetRepresentation(
+      vtkSegmentationConverter::GetClosedSurfaceRepresentationName()));
+    vtkPolyData* separateSurface = vtkPolyData::SafeDownCast(separateSegmentation->GetSegment(separateSegmentIDs[i])->GetRepresentation(
+      vtkSegmentationConverter::GetClosedSurfaceRepresentationName()));
+    if (!serialSurface || !parallelSurface || !separateSurface)
+      {
+      std::cerr << __LINE__ << ": Missing closed surface representation in segment " << i << std::endl;
+      return false;
+      }
+    if (serialSurface->GetNumberOfPoints() == 0
+      || serialSurface->GetNumberOfPoints() != parallelSurface->GetNumberOfPoints()
+      || serialSurface->GetNumberOfCells() != parallelSurface->GetNumberOfCells())
+      {
+      std::cerr << __LINE__ << ": Closed surface of segment " << i << " differs between serial and parallel conversion: "
+        << serialSurface->GetNumberOfPoints() << " points, " << serialSurface->GetNumberOfCells() << " cells vs. "
+        << parallelSurface->GetNumberOfPoints() << " points, " << parallelSurface->GetNumberOfCells() << " cells" << std::endl;
+      return false;
+      }
+    if (serialSurface->GetNumberOfPoints() != separateSurface->GetNumberOfPoints()
+      || serialSurface->GetNumberOfCells() != separateSurface->GetNumberOfCells())
+      {
+      std::cerr << __LINE__ << ": Closed surface of segment " << i << " differs between shared and separate labelmaps: "
+        << serialSurface->GetNumberOfPoints() << " points, " << serialSurface->GetNumberOfCells() << " cells vs. "
+        << separateSurface->GetNumberOfPoints() << " points, " << separateSurface->GetNumberOfCells() << " cells" << std::endl;
+      return false;
+      }
+    }
+
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool TestIncrementalSurfaceUpdate()
+{
+  vtkNew<vtkOrientedImageData> labelmap;
+  int extent[6] = { 0, 40, 0, 40, 0, 10 };
+  CreateCubeLabelmap(labelmap, extent);
+
+  vtkNew<vtkSegment> segment;
+  segment->AddRepresentation(vtkSegmentationConverter::GetBinaryLabelmapRepresentationName(), labelmap);
+
+  vtkNew<vtkBinaryLabelmapToClosedSurfaceConversionRule> rule;
+  // First update creates the surface bricks of the whole labelmap
+  if (!rule->ConvertModifiedRegion(segment, extent))
+    {
+    std::cerr << __LINE__ << ": Initial incremental conversion failed" << std::endl;
+    return false;
+    }
+
+  // Cut a hole that crosses the boundary between bricks and update the surface incrementally
+  int modifiedExtent[6] = { 28, 36, 28, 36, 0, 10 };
+  for (int k = modifiedExtent[4]; k <= modifiedExtent[5]; ++k)
+    {
+    for (int j = modifiedExtent[2]; j <= modifiedExtent[3]; ++j)
+      {
+      for (int i = modifiedExtent[0]; i <= modifiedExtent[1]; ++i)
+        {
+        *(static_cast<unsigned char*>(labelmap->GetScalarPointer(i, j, k))) = 0;
+        }
+      }
+    }
+  labelmap->Modified();
+  if (!rule->ConvertModifiedRegion(segment, modifiedExtent))
+    {
+    std::cerr << __LINE__ << ": Incremental conversion failed" << std::endl;
+    return false;
+    }
+
+  // Compare with full conversion
+  vtkNew<vtkSegment> referenceSegment;
+  referenceSegment->AddRepresentation(vtkSegmentationConverter::GetBinaryLabelmapRepresentationName(), labelmap);
+  rule->Convert(referenceSegment);
+
+  vtkPolyData* surface = vtkPolyData::SafeDownCast(segment->GetRepresentation(
+    vtkSegmentationConverter::GetClosedSurfaceRepresentationName()));
+  vtkPolyData* referenceSurface = vtkPolyData::SafeDownCast(referenceSegment->GetRepresentation(
+    vtkSegmentationConverter::GetClosedSurfaceRepresentationName()));
+  if (!surface || !referenceSurface || referenceSurface->GetNumberOfPoints() == 0)
+    {
+    std::cerr << __LINE__ << ": Missing closed surface representation" << std::endl;
+    return false;
+    }
+  if (surface->GetNumberOfPoints() != referenceSurface->GetNumberOfPoints()
+    || surface->GetNumberOfCells() != referenceSurface->GetNumberOfCells())
+    {
+    std::cerr << __LINE__ << ": Incrementally updated surface differs from full conversion: "
+      << surface->GetNumberOfPoints() << " points, " << surface->GetNumberOfCells() << " cells vs. "
+      << referenceSurface->GetNumberOfPoints() << " points, " << referenceSurface->GetNumberOfCells() << " cells" << std::endl;
+    return false;
+    }
+
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool TestMergedLabelmapCache()
+{
+  vtkNew<vtkSegmentation> segmentation;
+  segmentation->SetMasterRepresentationName(vtkSegmentationConverter::GetBinaryLabelmapRepresentationName());
+  int cubeExtents[3][6] = { { 0, 9, 0, 9, 0, 9 }, { 5, 14, 5, 14, 5, 14 }, { 20, 29, 0, 9, 0, 9 } };
+  std::vector<vtkSmartPointer<vtkOrientedImageData> > labelmaps;
+  for (int i = 0; i < 3; ++i)
+    {
+    vtkSmartPointer<vtkOrientedImageData> labelmap = vtkSmartPointer<vtkOrientedImageData>::New();
+    CreateCubeLabelmap(labelmap, cubeExtents[i]);
+    labelmaps.push_back(labelmap);
+    vtkNew<vtkSegment> segment;
+    segment->AddRepresentation(vtkSegmentationConverter::GetBinaryLabelmapRepresentationName(), labelmap);
+    segmentation->AddSegment(segment.GetPointer());
+    }
+
+  vtkNew<vtkOrientedImageData> mergedLabelmap;
+  segmentation->GenerateMergedLabelmap(mergedLabelmap.GetPointer(), vtkSegmentation::EXTENT_UNION_OF_SEGMENTS);
+
+  // Erase the part of the second cube that overlaps the first cube
+  int erasedExtent[6] = { 5, 9, 5, 9, 5, 9 };
+  vtkOrientedImageDataResample::FillImage(labelmaps[1], 0, erasedExtent);
+  labelmaps[1]->Modified();
+
+  // Incrementally updated merged labelmap must be the same as the fully generated one
+  vtkNew<vtkOrientedImageData> updatedLabelmap;
+  segmentation->GenerateMergedLabelmap(updatedLabelmap.GetPointer(), vtkSegmentation::EXTENT_UNION_OF_SEGMENTS);
+  segmentation->SetMergedLabelmapCaching(false);
+  vtkNew<vtkOrientedImageData> expectedLabelmap;
+  segmentation->GenerateMergedLabelmap(expectedLabelmap.GetPointer(), vtkSegmentation::EXTENT_UNION_OF_SEGMENTS);
+
+  if (!vtkOrientedImageDataResample::DoGeometriesMatch(updatedLabelmap, expectedLabelmap)
+    || !vtkOrientedImageDataResample::DoExtentsMatch(updatedLabelmap, expectedLabelmap))
+    {
+    std::cerr << __LINE__ << ": Merged labelmap geometry mismatch" << std::endl;
+    return false;
+    }
+  if (memcmp(updatedLabelmap->GetScalarPointer(), expectedLabelmap->GetScalarPointer(),
+    expectedLabelmap->GetNumberOfPoints() * expectedLabelmap->GetScalarSize()) != 0)
+    {
+    std::cerr << __LINE__ << ": Incrementally updated merged labelmap mismatch" << std::endl;
+    return false;
+    }
+  // The first segment is visible again where the second segment was erased
+  if (updatedLabelmap->GetScalarComponentAsDouble(7, 7, 7, 0) != 1.0
+    || updatedLabelmap->GetScalarComponentAsDouble(12, 12, 12, 0) != 2.0
+    || updatedLabelmap->GetScalarComponentAsDouble(25, 5, 5, 0) != 3.0)
+    {
+    std::cerr << __LINE__ << ": Invalid merged label values after update" << std::endl;
+    return false;
+    }
+
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool TestConversionCache()
+{
+  vtkNew<vtkSegmentation> segmentation;
+  segmentation->SetMasterRepresentationName(vtkSegmentationConverter::GetBinaryLabelmapRepresentationName());
+  int cubeExtent[6] = { 0, 9, 0, 9, 0, 9 };
+  vtkNew<vtkOrientedImageData> labelmap;
+  CreateCubeLabelmap(labelmap.GetPointer(), cubeExtent);
+  vtkNew<vtkSegment> segment;
+  segment->AddRepresentation(vtkSegmentationConverter::GetBinaryLabelmapRepresentationName(), labelmap.GetPointer());
+  segmentation->AddSegment(segment.GetPointer());
+  vtkSegmentationConverter* converter = segmentation->GetConverter();
+  const std::string smoothingFactorName = vtkBinaryLabelmapToClosedSurfaceConversionRule::GetSmoothingFactorParameterName();
+  const char* closedSurfaceName = vtkSegmentationConverter::GetClosedSurfaceRepresentationName();
+
+  segmentation->SetConversionParameter(smoothingFactorName, "0.5");
+  segmentation->CreateRepresentation(closedSurfaceName, true);
+  vtkNew<vtkPolyData> smoothSurface;
+  smoothSurface->DeepCopy(segment->GetRepresentation(closedSurfaceName));
+
+  segmentation->SetConversionParameter(smoothingFactorName, "0.0");
+  segmentation->CreateRepresentation(closedSurfaceName, true);
+  if (converter->GetNumberOfCachedConversionResults() != 2)
+    {
+    std::cerr << __LINE__ << ": Invalid number of cached conversion results " << converter->GetNumberOfCachedConversionResults()
+      << " should be 2" << std::endl;
+    return false;
+    }
+
+  // Switching back to the previous parameter value restores the cached surface
+  segmentation->SetConversionParameter(smoothingFactorName, "0.5");
+  segmentation->CreateRepresentation(closedSurfaceName, true);
+  vtkPolyData* restoredSurface = vtkPolyData::SafeDownCast(segment->GetRepresentation(closedSurfaceName));
+  if (converter->GetNumberOfCachedConversionResults() != 2 || !restoredSurface
+    || restoredSurface->GetNumberOfPoints() != smoothSurface->GetNumberOfPoints()
+    || restoredSurface->GetNumberOfCells() != smoothSurface->GetNumberOfCells())
+    {
+    std::cerr << __LINE__ << ": Cached closed surface was not restored" << std::endl;
+    return false;
+    }
+  for (vtkIdType pointId = 0; pointId < smoothSurface->GetNumberOfPoints(); ++pointId)
+    {
+    double restoredPoint[3] = { 0.0, 0.0, 0.0 };
+    double smoothPoint[3] = { 0.0, 0.0, 0.0 };
+    restoredSurface->GetPoint(pointId, restoredPoint);
+    smoothSurface->GetPoint(pointId, smoothPoint);
+    if (vtkMath::Distance2BetweenPoints(restoredPoint, smoothPoint) > 1e-12)
+      {
+      std::cerr << __LINE__ << ": Restored closed surface differs from the smoothed surface at point " << pointId << std::endl;
+      return false;
+      }
+    }
+
+  // Results of the modified labelmap are removed from the cache
+  labelmap->Modified();
+  segmentation->CreateRepresentation(closedSurfaceName, true);
+  if (converter->GetNumberOfCachedConversionResults() != 1)
+    {
+    std::cerr << __LINE__ << ": Invalid number of cached conversion results after modification "
+      << converter->GetNumberOfCachedConversionResults() << " should be 1" << std::endl;
+    return false;
+    }
+
+  // Disabling the cache removes all results
+  converter->SetConversionCacheMemoryBudget(0);
+  if (converter->GetNumberOfCachedConversionResults() != 0 || converter->GetConversionCacheMemorySize() != 0)
+    {
+    std::cerr << __LINE__ << ": Conversion cache is not empty after disabling it" << std::endl;
+    return false;
+    }
+
+  return true;
+}
+
 //----------------------------------------------------------------------------
 int vtkSegmentationTest2(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
 {
@@ -338,6 +621,26 @@ int vtkSegmentationTest2(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
     return EXIT_FAILURE;
     }
 
+  if (!TestParallelConversion())
+    {
+    return EXIT_FAILURE;
+    }
+
+  if (!TestIncrementalSurfaceUpdate())
+    {
+    return EXIT_FAILURE;
+    }
+
+  if (!TestMergedLabelmapCache())
+    {
+    return EXIT_FAILURE;
+    }
+
+  if (!TestConversionCache())
+    {
+    return EXIT_FAILURE;
+    }
+
   std::cout << "Segmentation test 2 passed." << std::endl;
   return EXIT_SUCCESS;
 }
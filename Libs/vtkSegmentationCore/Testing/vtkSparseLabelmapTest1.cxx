@@ -0,0 +1,384 @@
+/*==============================================================================
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// VTK includes
+#include <vtkDataArray.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkSmartPointer.h>
+
+// SegmentationCore includes
+#include "vtkBinaryLabelmapToSparseLabelmapConversionRule.h"
+#include "vtkOrientedImageData.h"
+#include "vtkOrientedImageDataResample.h"
+#include "vtkSegment.h"
+#include "vtkSegmentation.h"
+#include "vtkSegmentationConverter.h"
+#include "vtkSegmentationConverterFactory.h"
+#include "vtkSparseLabelmap.h"
+#include "vtkSparseLabelmapToBinaryLabelmapConversionRule.h"
+
+// STD includes
+#include <algorithm>
+#include <functional>
+
+namespace
+{
+
+typedef std::function<int(int, int, int)> PatternType;
+
+//----------------------------------------------------------------------------
+int BasePattern(int i, int j, int k)
+{
+  if ((i - 4) * (i - 4) + (j - 4) * (j - 4) + (k - 4) * (k - 4) <= 9)
+    {
+    return 1;
+    }
+  if (i >= 7 && j >= 7)
+    {
+    return 2;
+    }
+  return 0;
+}
+
+//----------------------------------------------------------------------------
+int ModifierPattern(int i, int j, int k)
+{
+  return (i >= 3 && i <= 12 && j >= 2 && j <= 5 && k % 2 == 0) ? 1 : 0;
+}
+
+//----------------------------------------------------------------------------
+void CreatePatternImage(vtkOrientedImageData* image, const int extent[6], const PatternType& pattern)
+{
+  image->SetExtent(const_cast<int*>(extent));
+  image->SetSpacing(0.5, 1.0, 2.0);
+  image->SetOrigin(10.0, 20.0, 30.0);
+  image->AllocateScalars(VTK_UNSIGNED_CHAR, 1);
+  for (int k = extent[4]; k <= extent[5]; ++k)
+    {
+    for (int j = extent[2]; j <= extent[3]; ++j)
+      {
+      for (int i = extent[0]; i <= extent[1]; ++i)
+        {
+        unsigned char* voxel = static_cast<unsigned char*>(image->GetScalarPointer(i, j, k));
+        *voxel = static_cast<unsigned char>(pattern(i, j, k));
+        }
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+int GetPatternLabel(const PatternType& pattern, const int extent[6], int i, int j, int k)
+{
+  if (i < extent[0] || i > extent[1] || j < extent[2] || j > extent[3] || k < extent[4] || k > extent[5])
+    {
+    return 0;
+    }
+  return pattern(i, j, k);
+}
+
+//----------------------------------------------------------------------------
+bool CompareWithExpected(vtkSparseLabelmap* labelmap, const PatternType& expected, int line)
+{
+  vtkIdType expectedNumberOfVoxels = 0;
+  for (int k = -2; k <= 16; ++k)
+    {
+    for (int j = -2; j <= 16; ++j)
+      {
+      for (int i = -2; i <= 16; ++i)
+        {
+        int expectedLabel = expected(i, j, k);
+        if (expectedLabel != 0)
+          {
+          ++expectedNumberOfVoxels;
+          }
+        if (labelmap->GetLabel(i, j, k) != expectedLabel)
+          {
+          std::cerr << line << ": Label mismatch at (" << i << ", " << j << ", " << k << "): "
+            << labelmap->GetLabel(i, j, k) << " != " << expectedLabel << std::endl;
+          return false;
+          }
+        }
+      }
+    }
+  if (labelmap->GetNumberOfVoxels() != expectedNumberOfVoxels)
+    {
+    std::cerr << line << ": Number of voxels mismatch: "
+      << labelmap->GetNumberOfVoxels() << " != " << expectedNumberOfVoxels << std::endl;
+    return false;
+    }
+  return true;
+}
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+bool TestEncodeDecode()
+{
+  int extent[6] = { 0, 11, 0, 11, 0, 11 };
+  vtkNew<vtkOrientedImageData> image;
+  CreatePatternImage(image.GetPointer(), extent, BasePattern);
+
+  vtkNew<vtkSparseLabelmap> labelmap;
+  if (!labelmap->SetFromImage(image.GetPointer()))
+    {
+    std::cerr << __LINE__ << ": Failed to encode image" << std::endl;
+    return false;
+    }
+  PatternType expected = [&](int i, int j, int k) { return GetPatternLabel(BasePattern, extent, i, j, k); };
+  if (!CompareWithExpected(labelmap.GetPointer(), expected, __LINE__))
+    {
+    return false;
+    }
+
+  std::vector<int> labelValues;
+  labelmap->GetLabelValues(labelValues);
+  if (labelValues.size() != 2 || labelValues[0] != 1 || labelValues[1] != 2)
+    {
+    std::cerr << __LINE__ << ": Invalid label values" << std::endl;
+    return false;
+    }
+
+  // Extent is shrunk to the stored voxels
+  int effectiveExtent[6] = { 0, -1, 0, -1, 0, -1 };
+  labelmap->GetExtent(effectiveExtent);
+  int expectedEffectiveExtent[6] = { 1, 11, 1, 11, 0, 11 };
+  if (!std::equal(effectiveExtent, effectiveExtent + 6, expectedEffectiveExtent))
+    {
+    std::cerr << __LINE__ << ": Invalid effective extent" << std::endl;
+    return false;
+    }
+
+  // Encode only one label
+  vtkNew<vtkSparseLabelmap> label2Labelmap;
+  label2Labelmap->SetFromImage(image.GetPointer(), 2);
+  if (label2Labelmap->GetNumberOfVoxels() != labelmap->GetNumberOfVoxels(2))
+    {
+    std::cerr << __LINE__ << ": Number of voxels with label 2 mismatch" << std::endl;
+    return false;
+    }
+
+  // Decode
+  vtkNew<vtkOrientedImageData> decodedImage;
+  labelmap->GetImage(decodedImage.GetPointer());
+  double spacing[3] = { 0.0, 0.0, 0.0 };
+  decodedImage->GetSpacing(spacing);
+  if (spacing[0] != 0.5 || spacing[1] != 1.0 || spacing[2] != 2.0)
+    {
+    std::cerr << __LINE__ << ": Geometry is not preserved" << std::endl;
+    return false;
+    }
+  vtkDataArray* decodedScalars = decodedImage->GetPointData()->GetScalars();
+  int decodedExtent[6] = { 0, -1, 0, -1, 0, -1 };
+  decodedImage->GetExtent(decodedExtent);
+  for (int k = decodedExtent[4]; k <= decodedExtent[5]; ++k)
+    {
+    for (int j = decodedExtent[2]; j <= decodedExtent[3]; ++j)
+      {
+      for (int i = decodedExtent[0]; i <= decodedExtent[1]; ++i)
+        {
+        int decodedLabel = static_cast<int>(decodedImage->GetScalarComponentAsDouble(i, j, k, 0));
+        if (decodedLabel != BasePattern(i, j, k))
+          {
+          std::cerr << __LINE__ << ": Decoded label mismatch at (" << i << ", " << j << ", " << k << ")" << std::endl;
+          return false;
+          }
+        }
+      }
+    }
+  if (!decodedScalars || decodedScalars->GetDataType() != VTK_UNSIGNED_CHAR)
+    {
+    std::cerr << __LINE__ << ": Invalid decoded scalar type" << std::endl;
+    return false;
+    }
+
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool TestMergeAndMask()
+{
+  int baseExtent[6] = { 0, 11, 0, 11, 0, 11 };
+  vtkNew<vtkOrientedImageData> baseImage;
+  CreatePatternImage(baseImage.GetPointer(), baseExtent, BasePattern);
+  int modifierExtent[6] = { 2, 14, 1, 6, 2, 14 };
+  vtkNew<vtkOrientedImageData> modifierImage;
+  CreatePatternImage(modifierImage.GetPointer(), modifierExtent, ModifierPattern);
+
+  vtkNew<vtkSparseLabelmap> modifier;
+  modifier->SetFromImage(modifierImage.GetPointer());
+
+  PatternType base = [&](int i, int j, int k) { return GetPatternLabel(BasePattern, baseExtent, i, j, k); };
+  PatternType mod = [&](int i, int j, int k) { return GetPatternLabel(ModifierPattern, modifierExtent, i, j, k); };
+
+  // Maximum
+  vtkNew<vtkSparseLabelmap> labelmap;
+  labelmap->SetFromImage(baseImage.GetPointer());
+  if (!labelmap->Merge(modifier.GetPointer(), vtkOrientedImageDataResample::OPERATION_MAXIMUM))
+    {
+    std::cerr << __LINE__ << ": Merge failed" << std::endl;
+    return false;
+    }
+  if (!CompareWithExpected(labelmap.GetPointer(),
+    [&](int i, int j, int k) { return std::max(base(i, j, k), mod(i, j, k)); }, __LINE__))
+    {
+    return false;
+    }
+
+  // Masking with fill value
+  labelmap->SetFromImage(baseImage.GetPointer());
+  labelmap->Merge(modifier.GetPointer(), vtkOrientedImageDataResample::OPERATION_MASKING, 3);
+  if (!CompareWithExpected(labelmap.GetPointer(),
+    [&](int i, int j, int k) { return mod(i, j, k) != 0 ? 3 : base(i, j, k); }, __LINE__))
+    {
+    return false;
+    }
+
+  // Erase
+  labelmap->SetFromImage(baseImage.GetPointer());
+  labelmap->Merge(modifier.GetPointer(), vtkOrientedImageDataResample::OPERATION_MASKING, 0);
+  if (!CompareWithExpected(labelmap.GetPointer(),
+    [&](int i, int j, int k) { return mod(i, j, k) != 0 ? 0 : base(i, j, k); }, __LINE__))
+    {
+    return false;
+    }
+
+  // Mask
+  labelmap->SetFromImage(baseImage.GetPointer());
+  labelmap->ApplyMask(modifier.GetPointer());
+  if (!CompareWithExpected(labelmap.GetPointer(),
+    [&](int i, int j, int k) { return mod(i, j, k) != 0 ? base(i, j, k) : 0; }, __LINE__))
+    {
+    return false;
+    }
+
+  // Inverse mask
+  labelmap->SetFromImage(baseImage.GetPointer());
+  labelmap->ApplyMask(modifier.GetPointer(), true);
+  if (!CompareWithExpected(labelmap.GetPointer(),
+    [&](int i, int j, int k) { return mod(i, j, k) != 0 ? 0 : base(i, j, k); }, __LINE__))
+    {
+    return false;
+    }
+
+  // Geometry mismatch
+  vtkNew<vtkSparseLabelmap> shiftedModifier;
+  shiftedModifier->DeepCopy(modifier.GetPointer());
+  shiftedModifier->SetOrigin(0.0, 0.0, 0.0);
+  std::cerr << "Expected error messages start" << std::endl;
+  bool success = labelmap->Merge(shiftedModifier.GetPointer(), vtkOrientedImageDataResample::OPERATION_MAXIMUM);
+  std::cerr << "Expected error messages end" << std::endl;
+  if (success)
+    {
+    std::cerr << __LINE__ << ": Merge with mismatching geometry is expected to fail" << std::endl;
+    return false;
+    }
+
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool TestConversion()
+{
+  int extent[6] = { 0, 11, 0, 11, 0, 11 };
+  vtkNew<vtkOrientedImageData> image;
+  CreatePatternImage(image.GetPointer(), extent, BasePattern);
+
+  // Binary labelmap to sparse labelmap, segments share the labelmap
+  vtkNew<vtkSegmentation> segmentation;
+  segmentation->SetMasterRepresentationName(vtkSegmentationConverter::GetBinaryLabelmapRepresentationName());
+  vtkNew<vtkSegment> segment1;
+  segment1->AddRepresentation(vtkSegmentationConverter::GetBinaryLabelmapRepresentationName(), image.GetPointer());
+  segment1->SetLabelValue(1);
+  segmentation->AddSegment(segment1.GetPointer(), "1");
+  vtkNew<vtkSegment> segment2;
+  segment2->AddRepresentation(vtkSegmentationConverter::GetBinaryLabelmapRepresentationName(), image.GetPointer());
+  segment2->SetLabelValue(2);
+  segmentation->AddSegment(segment2.GetPointer(), "2");
+
+  if (!segmentation->CreateRepresentation(vtkSegmentationConverter::GetSparseLabelmapRepresentationName()))
+    {
+    std::cerr << __LINE__ << ": Failed to convert to sparse labelmap" << std::endl;
+    return false;
+    }
+  vtkSparseLabelmap* sparse1 = vtkSparseLabelmap::SafeDownCast(
+    segment1->GetRepresentation(vtkSegmentationConverter::GetSparseLabelmapRepresentationName()));
+  vtkSparseLabelmap* sparse2 = vtkSparseLabelmap::SafeDownCast(
+    segment2->GetRepresentation(vtkSegmentationConverter::GetSparseLabelmapRepresentationName()));
+  vtkNew<vtkSparseLabelmap> reference;
+  reference->SetFromImage(image.GetPointer());
+  if (!sparse1 || !sparse2
+    || sparse1->GetNumberOfVoxels() != reference->GetNumberOfVoxels(1)
+    || sparse2->GetNumberOfVoxels() != reference->GetNumberOfVoxels(2))
+    {
+    std::cerr << __LINE__ << ": Invalid sparse labelmap representation" << std::endl;
+    return false;
+    }
+
+  // Sparse labelmap to binary labelmap
+  vtkNew<vtkSegmentation> sparseSegmentation;
+  sparseSegmentation->SetMasterRepresentationName(vtkSegmentationConverter::GetSparseLabelmapRepresentationName());
+  vtkNew<vtkSegment> sparseSegment;
+  sparseSegment->AddRepresentation(vtkSegmentationConverter::GetSparseLabelmapRepresentationName(), sparse2);
+  sparseSegmentation->AddSegment(sparseSegment.GetPointer(), "2");
+  if (!sparseSegmentation->CreateRepresentation(vtkSegmentationConverter::GetBinaryLabelmapRepresentationName()))
+    {
+    std::cerr << __LINE__ << ": Failed to convert to binary labelmap" << std::endl;
+    return false;
+    }
+  vtkOrientedImageData* binaryLabelmap = vtkOrientedImageData::SafeDownCast(
+    sparseSegment->GetRepresentation(vtkSegmentationConverter::GetBinaryLabelmapRepresentationName()));
+  if (!binaryLabelmap)
+    {
+    std::cerr << __LINE__ << ": Missing binary labelmap representation" << std::endl;
+    return false;
+    }
+  vtkNew<vtkSparseLabelmap> roundTrip;
+  roundTrip->SetFromImage(binaryLabelmap, sparseSegment->GetLabelValue());
+  if (roundTrip->GetNumberOfVoxels() != sparse2->GetNumberOfVoxels())
+    {
+    std::cerr << __LINE__ << ": Number of voxels mismatch after conversion: "
+      << roundTrip->GetNumberOfVoxels() << " != " << sparse2->GetNumberOfVoxels() << std::endl;
+    return false;
+    }
+
+  return true;
+}
+
+//----------------------------------------------------------------------------
+int vtkSparseLabelmapTest1(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
+{
+  // Register converter rules
+  vtkSegmentationConverterFactory::GetInstance()->RegisterConverterRule(
+    vtkSmartPointer<vtkBinaryLabelmapToSparseLabelmapConversionRule>::New() );
+  vtkSegmentationConverterFactory::GetInstance()->RegisterConverterRule(
+    vtkSmartPointer<vtkSparseLabelmapToBinaryLabelmapConversionRule>::New() );
+
+  if (!TestEncodeDecode())
+    {
+    return EXIT_FAILURE;
+    }
+
+  if (!TestMergeAndMask())
+    {
+    return EXIT_FAILURE;
+    }
+
+  if (!TestConversion())
+    {
+    return EXIT_FAILURE;
+    }
+
+  std::cout << "Sparse labelmap test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
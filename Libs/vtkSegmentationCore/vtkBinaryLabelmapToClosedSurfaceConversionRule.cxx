@@ -28,6 +28,8 @@
 #include <vtkVersion.h> // must precede reference to VTK_MAJOR_VERSION
 #include <vtkCompositeDataGeometryFilter.h>
 #include <vtkCompositeDataIterator.h>
+#include <vtkCellArray.h>
+#include <vtkCellData.h>
 #include <vtkDecimatePro.h>
 #if VTK_MAJOR_VERSION >= 9 || (VTK_MAJOR_VERSION >= 8 && VTK_MINOR_VERSION >= 2)
   #include <vtkDiscreteFlyingEdges3D.h>
@@ -39,12 +41,15 @@
 #include <vtkImageAccumulate.h>
 #include <vtkImageChangeInformation.h>
 #include <vtkImageConstantPad.h>
+#include <vtkImageData.h>
+#include <vtkIdList.h>
 #include <vtkImageThreshold.h>
 #include <vtkMultiBlockDataSet.h>
 #include <vtkMultiThreshold.h>
 #include <vtkNew.h>
 #include <vtkObjectFactory.h>
 #include <vtkPointData.h>
+#include <vtkPoints.h>
 #include <vtkPolyData.h>
 #include <vtkPolyDataMapper.h>
 #include <vtkPolyDataNormals.h>
@@ -68,6 +73,23 @@
 #include <vtkExtractSelection.h>
 #include <vtkSelectionSource.h>
 
+// STD includes
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+
+//----------------------------------------------------------------------------
+// Integer division rounding towards negative infinity (brick indices of negative voxel indices)
+static int FloorDivide(int value, int divisor)
+{
+  int quotient = value / divisor;
+  if ((value % divisor != 0) && ((value < 0) != (divisor < 0)))
+    {
+    --quotient;
+    }
+  return quotient;
+}
+
 //----------------------------------------------------------------------------
 vtkSegmentationConverterRuleNewMacro(vtkBinaryLabelmapToClosedSurfaceConversionRule);
 
@@ -155,72 +177,168 @@ bool vtkBinaryLabelmapToClosedSurfaceConversionRule::Convert(vtkSegment* segment
     return false;
     }
 
-  double smoothingFactor = vtkVariant(this->ConversionParameters[GetSmoothingFactorParameterName()].first).ToDouble();
-  int jointSmoothing = vtkVariant(this->ConversionParameters[GetJointSmoothingParameterName()].first).ToInt();
+  double smoothingFactor = vtkVariant(this->GetConversionParameter(GetSmoothingFactorParameterName())).ToDouble();
+  int jointSmoothing = vtkVariant(this->GetConversionParameter(GetJointSmoothingParameterName())).ToInt();
+  bool jointSmoothingEnabled = (jointSmoothing > 0 && smoothingFactor > 0);
 
-  if (jointSmoothing > 0 && smoothingFactor > 0)
+  if (!jointSmoothingEnabled && !this->IsMultiLabel(orientedBinaryLabelmap))
     {
-    if (this->JointSmoothCache.find(orientedBinaryLabelmap) == this->JointSmoothCache.end())
+    // The labelmap is not shared, extract the segment surface directly
+    std::vector<int> labelValue = { segment->GetLabelValue() };
+    return this->CreateClosedSurface(orientedBinaryLabelmap, closedSurfacePolyData, labelValue);
+    }
+
+  // Surfaces of all segments in the layer are extracted in a single pass when the first segment of the layer
+  // is converted, then split by label value and cached for the other segments.
+  // Segments sharing a labelmap are converted on the same thread, so the lock is only needed
+  // to protect the cache container while segments of other labelmaps are converted.
+  vtkSmartPointer<vtkPolyData> segmentSurface;
+  bool layerExtracted = false;
+    {
+    std::lock_guard<std::mutex> lock(this->JointSmoothCacheMutex);
+    std::map<vtkOrientedImageData*, SurfacesByLabelType>::iterator cacheIt = this->JointSmoothCache.find(orientedBinaryLabelmap);
+    if (cacheIt != this->JointSmoothCache.end())
       {
-      double* scalarRange = orientedBinaryLabelmap->GetScalarRange();
-      int lowLabel = (int)(floor(scalarRange[0]));
-      int highLabel = (int)(ceil(scalarRange[1]));
-
-      vtkNew<vtkImageAccumulate> imageAccumulate;
-      imageAccumulate->SetInputData(orientedBinaryLabelmap);
-      imageAccumulate->IgnoreZeroOn();
-      imageAccumulate->SetComponentOrigin(0, 0, 0);
-      imageAccumulate->SetComponentSpacing(1, 1, 1);
-      imageAccumulate->SetComponentExtent(lowLabel, highLabel, 0, 0, 0, 0);
-      imageAccumulate->Update();
-
-      std::vector<int> labelValues;
-      for (int labelValue = lowLabel; labelValue <= highLabel; ++labelValue)
+      layerExtracted = true;
+      SurfacesByLabelType::iterator surfaceIt = cacheIt->second.find(segment->GetLabelValue());
+      if (surfaceIt != cacheIt->second.end())
         {
-        // Add a new threshold for every level in the labelmap
-        double numberOfVoxels = imageAccumulate->GetOutput()->GetPointData()->GetScalars()->GetTuple1((int)labelValue - lowLabel);
-        if (numberOfVoxels > 0.0)
-          {
-          labelValues.push_back(labelValue);
-          }
+        segmentSurface = surfaceIt->second;
+        cacheIt->second.erase(surfaceIt);
         }
-
-      vtkSmartPointer<vtkPolyData> jointSmoothedSurface = vtkSmartPointer<vtkPolyData>::New();
-      this->CreateClosedSurface(orientedBinaryLabelmap, jointSmoothedSurface, labelValues);
-      this->JointSmoothCache[orientedBinaryLabelmap] = jointSmoothedSurface;
       }
-
-    vtkDataObject* sharedSurface = this->JointSmoothCache[orientedBinaryLabelmap];
-    if (!sharedSurface)
+    }
+  if (!layerExtracted)
+    {
+    std::vector<int> labelValues = this->GetLabelValues(orientedBinaryLabelmap);
+    vtkNew<vtkPolyData> layerSurface;
+    if (jointSmoothingEnabled)
       {
-      vtkErrorMacro("Convert: Could not find cached surface");
-      return false;
+      // Decimate and smooth all surfaces of the layer together
+      this->CreateClosedSurface(orientedBinaryLabelmap, layerSurface, labelValues);
+      }
+    else
+      {
+      // Decimate and smooth each segment surface separately (after it is split from the layer surface)
+      this->ExtractSurface(orientedBinaryLabelmap, layerSurface, labelValues);
       }
+    SurfacesByLabelType surfacesByLabel;
+    this->SplitSurfaceByLabel(layerSurface, surfacesByLabel);
+    SurfacesByLabelType::iterator surfaceIt = surfacesByLabel.find(segment->GetLabelValue());
+    if (surfaceIt != surfacesByLabel.end())
+      {
+      segmentSurface = surfaceIt->second;
+      surfacesByLabel.erase(surfaceIt);
+      }
+    std::lock_guard<std::mutex> lock(this->JointSmoothCacheMutex);
+    this->JointSmoothCache[orientedBinaryLabelmap].swap(surfacesByLabel);
+    }
+
+  if (!segmentSurface)
+    {
+    vtkDebugMacro("Convert: No polygons can be created, probably all voxels of the segment are empty");
+    closedSurfacePolyData->Initialize();
+    return true;
+    }
+
+  if (jointSmoothingEnabled)
+    {
+    closedSurfacePolyData->ShallowCopy(segmentSurface);
+    return true;
+    }
+  return this->ProcessSurface(orientedBinaryLabelmap, segmentSurface, closedSurfacePolyData);
+}
 
-    vtkNew<vtkSelectionSource> selection;
-    selection->SetContentType(vtkSelectionNode::THRESHOLDS);
-    selection->SetFieldType(vtkSelectionNode::POINT);
-    selection->GetContainingCells();
-    selection->AddThreshold(segment->GetLabelValue(), segment->GetLabelValue());
+//----------------------------------------------------------------------------
+bool vtkBinaryLabelmapToClosedSurfaceConversionRule::ConvertModifiedRegion(vtkSegment* segment, const int modifiedExtent[6])
+{
+  double smoothingFactor = vtkVariant(this->GetConversionParameter(GetSmoothingFactorParameterName())).ToDouble();
+  int jointSmoothing = vtkVariant(this->GetConversionParameter(GetJointSmoothingParameterName())).ToInt();
+  if ((jointSmoothing > 0 && smoothingFactor > 0) || !modifiedExtent
+    || modifiedExtent[0] > modifiedExtent[1] || modifiedExtent[2] > modifiedExtent[3] || modifiedExtent[4] > modifiedExtent[5])
+    {
+    return this->Convert(segment);
+    }
+
+  this->CreateTargetRepresentation(segment);
 
-    vtkNew<vtkExtractSelection> threshold;
-    threshold->SetInputData(sharedSurface);
-    threshold->SetSelectionConnection(selection->GetOutputPort());
+  vtkPolyData* closedSurfacePolyData = vtkPolyData::SafeDownCast(
+    segment->GetRepresentation(this->GetTargetRepresentationName()));
+  if (!closedSurfacePolyData)
+    {
+    vtkErrorMacro("ConvertModifiedRegion: Target representation is not poly data");
+    return false;
+    }
+  vtkOrientedImageData* orientedBinaryLabelmap = vtkOrientedImageData::SafeDownCast(
+    segment->GetRepresentation(this->GetSourceRepresentationName()));
+  if (!orientedBinaryLabelmap)
+    {
+    vtkErrorMacro("ConvertModifiedRegion: Source representation is not oriented image data");
+    return false;
+    }
 
-    vtkNew<vtkGeometryFilter> geometry;
-    geometry->SetInputConnection(threshold->GetOutputPort());
-    geometry->Update();
+  int labelValue = segment->GetLabelValue();
+  IncrementalSurfaceType& incrementalSurface = this->IncrementalSurfaces[segment];
+  // The bricks can only be reused if nothing but the modified region has changed since the last update
+  bool bricksValid = (incrementalSurface.Labelmap.GetPointer() == orientedBinaryLabelmap
+    && incrementalSurface.Surface.GetPointer() == closedSurfacePolyData
+    && incrementalSurface.SurfaceMTime == closedSurfacePolyData->GetMTime()
+    && incrementalSurface.LabelValue == labelValue);
+
+  // Marching cubes cell i is between voxels i and i+1, therefore changing a voxel
+  // modifies the cells on both sides of it
+  int brickRange[6] = { 0, -1, 0, -1, 0, -1 };
+  const int* extent = modifiedExtent;
+  if (!bricksValid)
+    {
+    incrementalSurface.Bricks.clear();
+    incrementalSurface.Labelmap = orientedBinaryLabelmap;
+    incrementalSurface.LabelValue = labelValue;
+    extent = orientedBinaryLabelmap->GetExtent();
+    }
+  if (extent[0] <= extent[1] && extent[2] <= extent[3] && extent[4] <= extent[5])
+    {
+    for (int i = 0; i < 3; ++i)
+      {
+      brickRange[2 * i] = FloorDivide(extent[2 * i] - 1, BrickSize);
+      brickRange[2 * i + 1] = FloorDivide(extent[2 * i + 1], BrickSize);
+      }
+    }
+  this->ExtractBricks(orientedBinaryLabelmap, labelValue, brickRange, incrementalSurface.Bricks);
 
-    vtkPolyData* thresholdedSurface = geometry->GetOutput();
-    closedSurfacePolyData->ShallowCopy(thresholdedSurface);
+  vtkNew<vtkPolyData> stitchedSurface;
+  this->StitchBricks(incrementalSurface.Bricks, stitchedSurface);
+  bool success = true;
+  if (stitchedSurface->GetNumberOfPolys() == 0)
+    {
+    vtkDebugMacro("ConvertModifiedRegion: No polygons can be created, probably all voxels are empty");
+    closedSurfacePolyData->Initialize();
     }
   else
     {
-    std::vector<int> labelValue = { segment->GetLabelValue() };
-    this->CreateClosedSurface(orientedBinaryLabelmap, closedSurfacePolyData, labelValue);
+    success = this->ProcessSurface(orientedBinaryLabelmap, stitchedSurface, closedSurfacePolyData);
     }
 
-  return true;
+  incrementalSurface.Surface = closedSurfacePolyData;
+  incrementalSurface.SurfaceMTime = closedSurfacePolyData->GetMTime();
+  incrementalSurface.LastUpdate = ++this->IncrementalUpdateCounter;
+
+  // Limit the memory used by the brick caches
+  while (this->IncrementalSurfaces.size() > static_cast<size_t>(MaximumNumberOfIncrementalSurfaces))
+    {
+    std::map<vtkSegment*, IncrementalSurfaceType>::iterator oldestIt = this->IncrementalSurfaces.begin();
+    for (std::map<vtkSegment*, IncrementalSurfaceType>::iterator surfaceIt = this->IncrementalSurfaces.begin();
+      surfaceIt != this->IncrementalSurfaces.end(); ++surfaceIt)
+      {
+      if (surfaceIt->second.LastUpdate < oldestIt->second.LastUpdate)
+        {
+        oldestIt = surfaceIt;
+        }
+      }
+    this->IncrementalSurfaces.erase(oldestIt);
+    }
+
+  return success;
 }
 
 //----------------------------------------------------------------------------
@@ -233,6 +351,24 @@ bool vtkBinaryLabelmapToClosedSurfaceConversionRule::CreateClosedSurface(vtkOrie
     return false;
     }
 
+  vtkNew<vtkPolyData> extractedSurface;
+  if (!this->ExtractSurface(orientedBinaryLabelmap, extractedSurface, labelValues))
+    {
+    return false;
+    }
+  if (extractedSurface->GetNumberOfPolys() == 0)
+    {
+    closedSurfacePolyData->Initialize();
+    return true;
+    }
+
+  return this->ProcessSurface(orientedBinaryLabelmap, extractedSurface, closedSurfacePolyData);
+}
+
+//----------------------------------------------------------------------------
+bool vtkBinaryLabelmapToClosedSurfaceConversionRule::ExtractSurface(vtkOrientedImageData* orientedBinaryLabelmap,
+  vtkPolyData* extractedSurface, const std::vector<int>& labelValues)
+{
   // Check validity of source and target representation objects
   if (!orientedBinaryLabelmap)
     {
@@ -255,7 +391,7 @@ bool vtkBinaryLabelmapToClosedSurfaceConversionRule::CreateClosedSurface(vtkOrie
     {
     // empty labelmap
     vtkDebugMacro("Convert: No polygons can be created, input image extent is empty");
-    closedSurfacePolyData->Initialize();
+    extractedSurface->Initialize();
     return true;
     }
 
@@ -281,11 +417,6 @@ bool vtkBinaryLabelmapToClosedSurfaceConversionRule::CreateClosedSurface(vtkOrie
   binaryLabelmapWithIdentityGeometry->SetOrigin(0, 0, 0);
   binaryLabelmapWithIdentityGeometry->SetSpacing(1.0, 1.0, 1.0);
 
-  // Get conversion parameters
-  double decimationFactor = vtkVariant(this->ConversionParameters[GetDecimationFactorParameterName()].first).ToDouble();
-  double smoothingFactor = vtkVariant(this->ConversionParameters[GetSmoothingFactorParameterName()].first).ToDouble();
-  int computeSurfaceNormals = vtkVariant(this->ConversionParameters[GetComputeSurfaceNormalsParameterName()].first).ToInt();
-
 #if VTK_MAJOR_VERSION >= 9 || (VTK_MAJOR_VERSION >= 8 && VTK_MINOR_VERSION >= 2)
   vtkNew<vtkDiscreteFlyingEdges3D> marchingCubes;
 #else
@@ -294,7 +425,8 @@ bool vtkBinaryLabelmapToClosedSurfaceConversionRule::CreateClosedSurface(vtkOrie
   marchingCubes->SetInputData(binaryLabelmapWithIdentityGeometry);
   marchingCubes->ComputeGradientsOff();
   marchingCubes->ComputeNormalsOff(); // While computing normals is faster using the flying edges filter,
-  // it results in incorrect normals in meshes from shared labelmaps marchingCubes->ComputeScalarsOn();
+  // it results in incorrect normals in meshes from shared labelmaps
+  marchingCubes->ComputeScalarsOn(); // Label values are used for splitting surfaces of shared labelmaps
 
   int valueIndex = 0;
   for (vtkIdType labelValue : labelValues)
@@ -303,23 +435,31 @@ bool vtkBinaryLabelmapToClosedSurfaceConversionRule::CreateClosedSurface(vtkOrie
     ++valueIndex;
     }
 
-  vtkSmartPointer<vtkPolyData> convertedSegment = vtkSmartPointer<vtkPolyData>::New();
-
   // Run marching cubes
   marchingCubes->Update();
-  vtkSmartPointer<vtkPolyData> processingResult = marchingCubes->GetOutput();
-  if (processingResult->GetNumberOfPolys() == 0)
+  if (marchingCubes->GetOutput()->GetNumberOfPolys() == 0)
     {
     vtkDebugMacro("Convert: No polygons can be created, probably all voxels are empty");
-    convertedSegment = nullptr;
-    closedSurfacePolyData->Initialize();
-    }
-
-  if (!convertedSegment)
-    {
+    extractedSurface->Initialize();
     return true;
     }
 
+  extractedSurface->ShallowCopy(marchingCubes->GetOutput());
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkBinaryLabelmapToClosedSurfaceConversionRule::ProcessSurface(vtkOrientedImageData* orientedBinaryLabelmap,
+  vtkPolyData* extractedSurface, vtkPolyData* closedSurfacePolyData)
+{
+  // Get conversion parameters
+  double decimationFactor = vtkVariant(this->GetConversionParameter(GetDecimationFactorParameterName())).ToDouble();
+  double smoothingFactor = vtkVariant(this->GetConversionParameter(GetSmoothingFactorParameterName())).ToDouble();
+  int computeSurfaceNormals = vtkVariant(this->GetConversionParameter(GetComputeSurfaceNormalsParameterName())).ToInt();
+
+  vtkSmartPointer<vtkPolyData> convertedSegment = vtkSmartPointer<vtkPolyData>::New();
+  vtkSmartPointer<vtkPolyData> processingResult = extractedSurface;
+
   // Decimate
   if (decimationFactor > 0.0)
     {
@@ -385,6 +525,300 @@ bool vtkBinaryLabelmapToClosedSurfaceConversionRule::CreateClosedSurface(vtkOrie
   return true;
 }
 
+//----------------------------------------------------------------------------
+bool vtkBinaryLabelmapToClosedSurfaceConversionRule::IsMultiLabel(vtkOrientedImageData* orientedBinaryLabelmap)
+{
+  double* scalarRange = orientedBinaryLabelmap->GetScalarRange();
+  int lowLabel = (int)(floor(scalarRange[0]));
+  int highLabel = (int)(ceil(scalarRange[1]));
+  // Background voxels do not count as a label
+  int numberOfNonZeroLabelsInRange = highLabel - lowLabel + 1;
+  if (lowLabel <= 0 && highLabel >= 0)
+    {
+    --numberOfNonZeroLabelsInRange;
+    }
+  return numberOfNonZeroLabelsInRange > 1;
+}
+
+//----------------------------------------------------------------------------
+std::vector<int> vtkBinaryLabelmapToClosedSurfaceConversionRule::GetLabelValues(vtkOrientedImageData* orientedBinaryLabelmap)
+{
+  std::vector<int> labelValues;
+  double* scalarRange = orientedBinaryLabelmap->GetScalarRange();
+  int lowLabel = (int)(floor(scalarRange[0]));
+  int highLabel = (int)(ceil(scalarRange[1]));
+
+  vtkNew<vtkImageAccumulate> imageAccumulate;
+  imageAccumulate->SetInputData(orientedBinaryLabelmap);
+  imageAccumulate->IgnoreZeroOn();
+  imageAccumulate->SetComponentOrigin(0, 0, 0);
+  imageAccumulate->SetComponentSpacing(1, 1, 1);
+  imageAccumulate->SetComponentExtent(lowLabel, highLabel, 0, 0, 0, 0);
+  imageAccumulate->Update();
+
+  for (int labelValue = lowLabel; labelValue <= highLabel; ++labelValue)
+    {
+    // Add a new threshold for every level in the labelmap
+    double numberOfVoxels = imageAccumulate->GetOutput()->GetPointData()->GetScalars()->GetTuple1((int)labelValue - lowLabel);
+    if (numberOfVoxels > 0.0)
+      {
+      labelValues.push_back(labelValue);
+      }
+    }
+  return labelValues;
+}
+
+//----------------------------------------------------------------------------
+void vtkBinaryLabelmapToClosedSurfaceConversionRule::SplitSurfaceByLabel(vtkPolyData* surface, SurfacesByLabelType& surfacesByLabel)
+{
+  surfacesByLabel.clear();
+  if (!surface || surface->GetNumberOfPolys() == 0)
+    {
+    return;
+    }
+
+  // Discrete flying edges stores the label value in the point scalars, discrete marching cubes in the cell scalars
+  vtkDataArray* cellLabels = surface->GetCellData()->GetScalars();
+  vtkDataArray* pointLabels = surface->GetPointData()->GetScalars();
+  if (!cellLabels && !pointLabels)
+    {
+    vtkErrorWithObjectMacro(surface, "SplitSurfaceByLabel: Surface has no label values");
+    return;
+    }
+
+  // Group the polygons by label value
+  vtkCellArray* polys = surface->GetPolys();
+  vtkIdType polyOffset = surface->GetNumberOfVerts() + surface->GetNumberOfLines();
+  std::map<int, std::vector<vtkIdType> > polyIdsByLabel;
+  vtkNew<vtkIdList> pointIds;
+  polys->InitTraversal();
+  for (vtkIdType polyId = 0; polys->GetNextCell(pointIds); ++polyId)
+    {
+    if (pointIds->GetNumberOfIds() == 0)
+      {
+      continue;
+      }
+    int label = (int)(cellLabels ? cellLabels->GetTuple1(polyOffset + polyId) : pointLabels->GetTuple1(pointIds->GetId(0)));
+    polyIdsByLabel[label].push_back(polyId);
+    }
+
+  // Copy the polygons of each label into a separate surface.
+  // The point map is reused between labels, only the entries that were set are reset.
+  vtkPoints* points = surface->GetPoints();
+  vtkPointData* pointData = surface->GetPointData();
+  vtkCellData* cellData = surface->GetCellData();
+  std::vector<vtkIdType> pointMap(surface->GetNumberOfPoints(), -1);
+  vtkNew<vtkIdList> labelPointIds;
+  for (std::map<int, std::vector<vtkIdType> >::iterator labelIt = polyIdsByLabel.begin(); labelIt != polyIdsByLabel.end(); ++labelIt)
+    {
+    const std::vector<vtkIdType>& polyIds = labelIt->second;
+
+    vtkNew<vtkPoints> labelPoints;
+    labelPoints->SetDataType(points->GetDataType());
+    vtkNew<vtkCellArray> labelPolys;
+    vtkSmartPointer<vtkPolyData> labelSurface = vtkSmartPointer<vtkPolyData>::New();
+    labelSurface->GetPointData()->CopyAllocate(pointData);
+    labelSurface->GetCellData()->CopyAllocate(cellData, static_cast<vtkIdType>(polyIds.size()));
+
+    std::vector<vtkIdType> mappedPointIds;
+    for (vtkIdType polyId : polyIds)
+      {
+      surface->GetCellPoints(polyOffset + polyId, pointIds);
+      labelPointIds->SetNumberOfIds(pointIds->GetNumberOfIds());
+      for (vtkIdType i = 0; i < pointIds->GetNumberOfIds(); ++i)
+        {
+        vtkIdType pointId = pointIds->GetId(i);
+        if (pointMap[pointId] < 0)
+          {
+          pointMap[pointId] = labelPoints->InsertNextPoint(points->GetPoint(pointId));
+          labelSurface->GetPointData()->CopyData(pointData, pointId, pointMap[pointId]);
+          mappedPointIds.push_back(pointId);
+          }
+        labelPointIds->SetId(i, pointMap[pointId]);
+        }
+      vtkIdType labelPolyId = labelPolys->InsertNextCell(labelPointIds);
+      labelSurface->GetCellData()->CopyData(cellData, polyOffset + polyId, labelPolyId);
+      }
+    for (vtkIdType pointId : mappedPointIds)
+      {
+      pointMap[pointId] = -1;
+      }
+
+    labelSurface->SetPoints(labelPoints);
+    labelSurface->SetPolys(labelPolys);
+    labelSurface->Squeeze();
+    surfacesByLabel[labelIt->first] = labelSurface;
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkBinaryLabelmapToClosedSurfaceConversionRule::ExtractBricks(vtkOrientedImageData* orientedBinaryLabelmap, int labelValue,
+  const int brickRange[6], BrickTrianglesType& bricks)
+{
+  if (brickRange[0] > brickRange[1] || brickRange[2] > brickRange[3] || brickRange[4] > brickRange[5])
+    {
+    return;
+    }
+
+  // Remove previous content of the bricks (bricks that contain no triangles are not stored)
+  for (BrickTrianglesType::iterator brickIt = bricks.begin(); brickIt != bricks.end();)
+    {
+    const BrickIndexType& brickIndex = brickIt->first;
+    if (brickIndex[0] >= brickRange[0] && brickIndex[0] <= brickRange[1]
+      && brickIndex[1] >= brickRange[2] && brickIndex[1] <= brickRange[3]
+      && brickIndex[2] >= brickRange[4] && brickIndex[2] <= brickRange[5])
+      {
+      brickIt = bricks.erase(brickIt);
+      }
+    else
+      {
+      ++brickIt;
+      }
+    }
+
+  // Cells of the bricks need one more voxel after the last cell. One more voxel is added on both sides,
+  // as triangles on the boundary between bricks are assigned to a single brick based on their center.
+  // Voxels outside the labelmap extent are background, so the extent is restricted to the labelmap extent
+  // padded by one voxel (which closes the surface at the labelmap boundary).
+  int* labelmapExtent = orientedBinaryLabelmap->GetExtent();
+  int voxelExtent[6] = { 0, -1, 0, -1, 0, -1 };
+  for (int i = 0; i < 3; ++i)
+    {
+    voxelExtent[2 * i] = std::max(brickRange[2 * i] * BrickSize - 1, labelmapExtent[2 * i] - 1);
+    voxelExtent[2 * i + 1] = std::min((brickRange[2 * i + 1] + 1) * BrickSize + 1, labelmapExtent[2 * i + 1] + 1);
+    if (voxelExtent[2 * i] > voxelExtent[2 * i + 1])
+      {
+      // No labelmap voxels in the bricks
+      return;
+      }
+    }
+
+  vtkNew<vtkImageConstantPad> padder;
+  padder->SetInputData(orientedBinaryLabelmap);
+  padder->SetConstant(0);
+  padder->SetOutputWholeExtent(voxelExtent);
+  padder->Update();
+
+  // IJK coordinates are used, same as in ExtractSurface
+  vtkNew<vtkImageData> brickLabelmap;
+  brickLabelmap->ShallowCopy(padder->GetOutput());
+  brickLabelmap->SetOrigin(0, 0, 0);
+  brickLabelmap->SetSpacing(1.0, 1.0, 1.0);
+
+#if VTK_MAJOR_VERSION >= 9 || (VTK_MAJOR_VERSION >= 8 && VTK_MINOR_VERSION >= 2)
+  vtkNew<vtkDiscreteFlyingEdges3D> marchingCubes;
+#else
+  vtkNew<vtkDiscreteMarchingCubes> marchingCubes;
+#endif
+  marchingCubes->SetInputData(brickLabelmap);
+  marchingCubes->ComputeGradientsOff();
+  marchingCubes->ComputeNormalsOff();
+  marchingCubes->ComputeScalarsOff();
+  marchingCubes->SetValue(0, labelValue);
+  marchingCubes->Update();
+
+  vtkPoints* points = marchingCubes->GetOutput()->GetPoints();
+  vtkCellArray* polys = marchingCubes->GetOutput()->GetPolys();
+  if (!points || !polys)
+    {
+    return;
+    }
+  vtkNew<vtkIdList> pointIds;
+  polys->InitTraversal();
+  while (polys->GetNextCell(pointIds))
+    {
+    if (pointIds->GetNumberOfIds() != 3)
+      {
+      continue;
+      }
+    double trianglePoints[3][3] = { { 0.0, 0.0, 0.0 }, { 0.0, 0.0, 0.0 }, { 0.0, 0.0, 0.0 } };
+    double center[3] = { 0.0, 0.0, 0.0 };
+    for (int j = 0; j < 3; ++j)
+      {
+      points->GetPoint(pointIds->GetId(j), trianglePoints[j]);
+      for (int i = 0; i < 3; ++i)
+        {
+        center[i] += trianglePoints[j][i] / 3.0;
+        }
+      }
+    BrickIndexType brickIndex = { { 0, 0, 0 } };
+    bool inRange = true;
+    for (int i = 0; i < 3; ++i)
+      {
+      brickIndex[i] = FloorDivide(static_cast<int>(floor(center[i])), BrickSize);
+      inRange &= (brickIndex[i] >= brickRange[2 * i] && brickIndex[i] <= brickRange[2 * i + 1]);
+      }
+    if (!inRange)
+      {
+      // Triangle belongs to a neighbor brick that is not updated
+      continue;
+      }
+    std::vector<float>& brickTriangles = bricks[brickIndex];
+    for (int j = 0; j < 3; ++j)
+      {
+      for (int i = 0; i < 3; ++i)
+        {
+        brickTriangles.push_back(static_cast<float>(trianglePoints[j][i]));
+        }
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkBinaryLabelmapToClosedSurfaceConversionRule::StitchBricks(const BrickTrianglesType& bricks, vtkPolyData* outputPolydata)
+{
+  size_t numberOfTriangles = 0;
+  for (BrickTrianglesType::const_iterator brickIt = bricks.begin(); brickIt != bricks.end(); ++brickIt)
+    {
+    numberOfTriangles += brickIt->second.size() / 9;
+    }
+
+  vtkNew<vtkPoints> points;
+  points->SetDataTypeToFloat();
+  vtkNew<vtkCellArray> polys;
+
+  // Discrete marching cubes places the vertices at the midpoint of voxel edges, so doubled coordinates
+  // are integers and can be used as exact keys for merging the vertices of neighbor bricks.
+  // 21 bits are used for each coordinate, which allows labelmap extents up to +/-500000 voxels.
+  const long long keyOffset = 1 << 20;
+  std::unordered_map<long long, vtkIdType> pointIdByPosition;
+  pointIdByPosition.reserve(numberOfTriangles);
+  vtkIdType triangle[3] = { 0, 0, 0 };
+  for (BrickTrianglesType::const_iterator brickIt = bricks.begin(); brickIt != bricks.end(); ++brickIt)
+    {
+    const std::vector<float>& brickTriangles = brickIt->second;
+    for (size_t vertexIndex = 0; vertexIndex + 2 < brickTriangles.size(); vertexIndex += 3)
+      {
+      const float* position = &brickTriangles[vertexIndex];
+      long long key = 0;
+      for (int i = 0; i < 3; ++i)
+        {
+        key = (key << 21) | ((static_cast<long long>(std::lround(2.0 * position[i])) + keyOffset) & 0x1FFFFF);
+        }
+      std::unordered_map<long long, vtkIdType>::iterator pointIt = pointIdByPosition.find(key);
+      vtkIdType pointId = 0;
+      if (pointIt == pointIdByPosition.end())
+        {
+        pointId = points->InsertNextPoint(position[0], position[1], position[2]);
+        pointIdByPosition[key] = pointId;
+        }
+      else
+        {
+        pointId = pointIt->second;
+        }
+      triangle[(vertexIndex / 3) % 3] = pointId;
+      if ((vertexIndex / 3) % 3 == 2)
+        {
+        polys->InsertNextCell(3, triangle);
+        }
+      }
+    }
+
+  outputPolydata->Initialize();
+  outputPolydata->SetPoints(points);
+  outputPolydata->SetPolys(polys);
+}
+
 //----------------------------------------------------------------------------
 bool vtkBinaryLabelmapToClosedSurfaceConversionRule::PostConvert(vtkSegmentation* vtkNotUsed(segmentation))
 {
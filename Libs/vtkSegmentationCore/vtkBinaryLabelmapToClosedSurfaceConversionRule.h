@@ -24,17 +24,24 @@
 // SegmentationCore includes
 #include "vtkSegmentationConverterRule.h"
 #include "vtkSegmentationConverter.h"
+#include "vtkOrientedImageData.h"
 
 #include "vtkSegmentationCoreConfigure.h"
 
 // VTK includes
 #include <vtkPolyData.h>
+#include <vtkWeakPointer.h>
+
+// STD includes
+#include <array>
+#include <mutex>
 
 /// \ingroup SegmentationCore
 /// \brief Convert binary labelmap representation (vtkOrientedImageData type) to
 ///   closed surface representation (vtkPolyData type). The conversion algorithm
 ///   performs a marching cubes operation on the image data followed by an optional
-///   decimation step.
+///   decimation step. Surfaces of all segments of a shared labelmap are extracted in one pass
+///   and then split by label value.
 class vtkSegmentationCore_EXPORT vtkBinaryLabelmapToClosedSurfaceConversionRule
   : public vtkSegmentationConverterRule
 {
@@ -68,13 +75,39 @@ public:
   /// Perform the actual binary labelmap to closed surface conversion
   bool CreateClosedSurface(vtkOrientedImageData* inputImage, vtkPolyData* outputPolydata, std::vector<int> values);
 
+  typedef std::map<int, vtkSmartPointer<vtkPolyData> > SurfacesByLabelType;
+
+  /// Split a surface extracted from a shared labelmap into one surface per label value.
+  /// Label values are taken from the cell scalars if present, otherwise from the point scalars.
+  static void SplitSurfaceByLabel(vtkPolyData* surface, SurfacesByLabelType& surfacesByLabel);
+
   /// Update the target representation based on the source representation
   bool Convert(vtkSegment* segment) override;
 
+  /// Update the closed surface after the binary labelmap of the segment was modified within the given IJK extent.
+  /// The raw (not yet decimated and smoothed) surface of the segment is cached in bricks of BrickSize^3 voxels,
+  /// only the bricks that intersect the modified extent are extracted again, and the bricks are stitched into
+  /// one surface before decimation, smoothing, and normal computation.
+  /// The brick cache is built by the first call for a segment, and it is considered up-to-date only if the source
+  /// labelmap object, the label value and the target surface are the same as after the last call.
+  /// A full conversion is performed if joint smoothing is enabled.
+  /// Must be called from the main thread.
+  bool ConvertModifiedRegion(vtkSegment* segment, const int modifiedExtent[6]) override;
+
+  /// Size of the bricks (in voxels along each axis) used by ConvertModifiedRegion
+  static const int BrickSize = 32;
+
+  /// Maximum number of segments whose brick cache is kept for incremental update.
+  /// The cache of the least recently updated segment is removed when the limit is reached.
+  static const int MaximumNumberOfIncrementalSurfaces = 8;
+
   /// Perform postprocesing steps on the output
   /// Clears the joint smoothing cache
   bool PostConvert(vtkSegmentation* segmentation) override;
 
+  /// Segments that have different source labelmaps can be converted concurrently
+  bool IsThreadSafe() override { return true; };
+
   /// Get the cost of the conversion.
   unsigned int GetConversionCost(vtkDataObject* sourceRepresentation=nullptr, vtkDataObject* targetRepresentation=nullptr) override;
 
@@ -92,14 +125,59 @@ protected:
   /// This function checks whether this is the case.
   bool IsLabelmapPaddingNecessary(vtkImageData* binaryLabelMap);
 
+  /// Run discrete marching cubes on the labelmap for all the given label values in one pass.
+  /// The output surface is in IJK coordinate system, with the label value stored in the scalars.
+  bool ExtractSurface(vtkOrientedImageData* inputImage, vtkPolyData* outputPolydata, const std::vector<int>& values);
+
+  /// Decimate, smooth, transform to world coordinate system and compute normals of an extracted surface
+  bool ProcessSurface(vtkOrientedImageData* inputImage, vtkPolyData* extractedSurface, vtkPolyData* outputPolydata);
+
+  /// Return true if the scalar range of the labelmap allows more than one non-zero label value
+  bool IsMultiLabel(vtkOrientedImageData* inputImage);
+
+  /// Get the non-zero label values that are present in the labelmap
+  std::vector<int> GetLabelValues(vtkOrientedImageData* inputImage);
+
+  typedef std::array<int, 3> BrickIndexType;
+  /// Triangle vertex positions (IJK) of the raw surface in a brick, 9 values per triangle
+  typedef std::map<BrickIndexType, std::vector<float> > BrickTrianglesType;
+
+  /// Extract the raw surface of a label value within a box of bricks (inclusive brick index range)
+  /// and replace the content of these bricks in the brick map.
+  void ExtractBricks(vtkOrientedImageData* inputImage, int labelValue, const int brickRange[6], BrickTrianglesType& bricks);
+
+  /// Merge the triangles of all bricks into a surface, with coincident vertices merged
+  static void StitchBricks(const BrickTrianglesType& bricks, vtkPolyData* outputPolydata);
+
+  /// State of the incremental surface update of a segment
+  struct IncrementalSurfaceType
+    {
+    vtkWeakPointer<vtkOrientedImageData> Labelmap;
+    vtkWeakPointer<vtkPolyData> Surface;
+    vtkMTimeType SurfaceMTime{0};
+    int LabelValue{0};
+    unsigned long LastUpdate{0};
+    BrickTrianglesType Bricks;
+    };
+
 protected:
   vtkBinaryLabelmapToClosedSurfaceConversionRule();
   ~vtkBinaryLabelmapToClosedSurfaceConversionRule() override;
 
 protected:
-  /// Cache for storing merged closed surfaces that have been joint smoothed
-  /// The key used is the binary labelmap representation, which maps to the combined vtkPolyData containing surfaces for all segments in the segmentation
-  std::map<vtkOrientedImageData*, vtkSmartPointer<vtkPolyData> > JointSmoothCache;
+  /// Cache for storing the surfaces of the segments of shared labelmaps.
+  /// The key used is the binary labelmap representation, which maps to the surfaces extracted from the labelmap in one pass,
+  /// split by label value. If joint smoothing is enabled then the surfaces have been decimated and smoothed together,
+  /// otherwise each surface is processed when the corresponding segment is converted.
+  /// Surfaces are removed from the cache when they are assigned to their segment.
+  std::map<vtkOrientedImageData*, SurfacesByLabelType> JointSmoothCache;
+  /// Protects JointSmoothCache when segments are converted concurrently
+  std::mutex JointSmoothCacheMutex;
+
+  /// Brick caches of segments that were updated using ConvertModifiedRegion
+  std::map<vtkSegment*, IncrementalSurfaceType> IncrementalSurfaces;
+  /// Incremented at each incremental update, used for finding the least recently updated segment
+  unsigned long IncrementalUpdateCounter{0};
 
 private:
   vtkBinaryLabelmapToClosedSurfaceConversionRule(const vtkBinaryLabelmapToClosedSurfaceConversionRule&) = delete;
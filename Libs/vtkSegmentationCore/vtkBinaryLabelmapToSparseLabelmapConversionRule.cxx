@@ -0,0 +1,98 @@
+/*==============================================================================
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// SegmentationCore includes
+#include "vtkBinaryLabelmapToSparseLabelmapConversionRule.h"
+#include "vtkOrientedImageData.h"
+#include "vtkSegment.h"
+#include "vtkSparseLabelmap.h"
+
+// VTK includes
+#include <vtkObjectFactory.h>
+
+//----------------------------------------------------------------------------
+vtkSegmentationConverterRuleNewMacro(vtkBinaryLabelmapToSparseLabelmapConversionRule);
+
+//----------------------------------------------------------------------------
+vtkBinaryLabelmapToSparseLabelmapConversionRule::vtkBinaryLabelmapToSparseLabelmapConversionRule() = default;
+
+//----------------------------------------------------------------------------
+vtkBinaryLabelmapToSparseLabelmapConversionRule::~vtkBinaryLabelmapToSparseLabelmapConversionRule() = default;
+
+//----------------------------------------------------------------------------
+unsigned int vtkBinaryLabelmapToSparseLabelmapConversionRule::GetConversionCost(
+  vtkDataObject* vtkNotUsed(sourceRepresentation)/*=nullptr*/,
+  vtkDataObject* vtkNotUsed(targetRepresentation)/*=nullptr*/)
+{
+  // Rough input-independent guess (ms)
+  return 50;
+}
+
+//----------------------------------------------------------------------------
+vtkDataObject* vtkBinaryLabelmapToSparseLabelmapConversionRule::ConstructRepresentationObjectByRepresentation(std::string representationName)
+{
+  if ( !representationName.compare(this->GetSourceRepresentationName()) )
+    {
+    return (vtkDataObject*)vtkOrientedImageData::New();
+    }
+  else if ( !representationName.compare(this->GetTargetRepresentationName()) )
+    {
+    return (vtkDataObject*)vtkSparseLabelmap::New();
+    }
+  else
+    {
+    return nullptr;
+    }
+}
+
+//----------------------------------------------------------------------------
+vtkDataObject* vtkBinaryLabelmapToSparseLabelmapConversionRule::ConstructRepresentationObjectByClass(std::string className)
+{
+  if (!className.compare("vtkOrientedImageData"))
+    {
+    return (vtkDataObject*)vtkOrientedImageData::New();
+    }
+  else if (!className.compare("vtkSparseLabelmap"))
+    {
+    return (vtkDataObject*)vtkSparseLabelmap::New();
+    }
+  else
+    {
+    return nullptr;
+    }
+}
+
+//----------------------------------------------------------------------------
+bool vtkBinaryLabelmapToSparseLabelmapConversionRule::Convert(vtkSegment* segment)
+{
+  this->CreateTargetRepresentation(segment);
+
+  // Check validity of source and target representation objects
+  vtkOrientedImageData* binaryLabelmap = vtkOrientedImageData::SafeDownCast(
+    segment->GetRepresentation(this->GetSourceRepresentationName()));
+  if (!binaryLabelmap)
+    {
+    vtkErrorMacro("Convert: Source representation is not an oriented image data!");
+    return false;
+    }
+  vtkSparseLabelmap* sparseLabelmap = vtkSparseLabelmap::SafeDownCast(
+    segment->GetRepresentation(this->GetTargetRepresentationName()));
+  if (!sparseLabelmap)
+    {
+    vtkErrorMacro("Convert: Target representation is not a sparse labelmap!");
+    return false;
+    }
+
+  // Only store the voxels of this segment, as the binary labelmap may be shared with other segments
+  return sparseLabelmap->SetFromImage(binaryLabelmap, segment->GetLabelValue());
+}
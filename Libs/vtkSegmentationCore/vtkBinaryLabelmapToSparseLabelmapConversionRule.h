@@ -0,0 +1,72 @@
+/*==============================================================================
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#ifndef __vtkBinaryLabelmapToSparseLabelmapConversionRule_h
+#define __vtkBinaryLabelmapToSparseLabelmapConversionRule_h
+
+// SegmentationCore includes
+#include "vtkSegmentationConverterRule.h"
+#include "vtkSegmentationConverter.h"
+
+#include "vtkSegmentationCoreConfigure.h"
+
+/// \ingroup SegmentationCore
+/// \brief Convert binary labelmap representation (vtkOrientedImageData type) to
+///   sparse labelmap representation (vtkSparseLabelmap type). Only the voxels
+///   that have the label value of the segment are stored.
+class vtkSegmentationCore_EXPORT vtkBinaryLabelmapToSparseLabelmapConversionRule
+  : public vtkSegmentationConverterRule
+{
+public:
+  static vtkBinaryLabelmapToSparseLabelmapConversionRule* New();
+  vtkTypeMacro(vtkBinaryLabelmapToSparseLabelmapConversionRule, vtkSegmentationConverterRule);
+  vtkSegmentationConverterRule* CreateRuleInstance() override;
+
+  /// Constructs representation object from representation name for the supported representation classes
+  /// (typically source and target representation VTK classes, subclasses of vtkDataObject)
+  /// Note: Need to take ownership of the created object! For example using vtkSmartPointer<vtkDataObject>::Take
+  vtkDataObject* ConstructRepresentationObjectByRepresentation(std::string representationName) override;
+
+  /// Constructs representation object from class name for the supported representation classes
+  /// (typically source and target representation VTK classes, subclasses of vtkDataObject)
+  /// Note: Need to take ownership of the created object! For example using vtkSmartPointer<vtkDataObject>::Take
+  vtkDataObject* ConstructRepresentationObjectByClass(std::string className) override;
+
+  /// Update the target representation based on the source representation
+  bool Convert(vtkSegment* segment) override;
+
+  /// Encoding only reads the source labelmap
+  bool IsThreadSafe() override { return true; };
+
+  /// Get the cost of the conversion.
+  unsigned int GetConversionCost(vtkDataObject* sourceRepresentation=nullptr, vtkDataObject* targetRepresentation=nullptr) override;
+
+  /// Human-readable name of the converter rule
+  const char* GetName() override { return "Binary labelmap to sparse labelmap (run-length encoding)"; };
+
+  /// Human-readable name of the source representation
+  const char* GetSourceRepresentationName() override { return vtkSegmentationConverter::GetSegmentationBinaryLabelmapRepresentationName(); };
+
+  /// Human-readable name of the target representation
+  const char* GetTargetRepresentationName() override { return vtkSegmentationConverter::GetSegmentationSparseLabelmapRepresentationName(); };
+
+protected:
+  vtkBinaryLabelmapToSparseLabelmapConversionRule();
+  ~vtkBinaryLabelmapToSparseLabelmapConversionRule() override;
+
+private:
+  vtkBinaryLabelmapToSparseLabelmapConversionRule(const vtkBinaryLabelmapToSparseLabelmapConversionRule&) = delete;
+  void operator=(const vtkBinaryLabelmapToSparseLabelmapConversionRule&) = delete;
+};
+
+#endif // __vtkBinaryLabelmapToSparseLabelmapConversionRule_h
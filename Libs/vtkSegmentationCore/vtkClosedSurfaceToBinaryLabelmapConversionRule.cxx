@@ -36,18 +36,26 @@
 #include <vtkPolyData.h>
 #include <vtkTransform.h>
 #include <vtkTransformPolyDataFilter.h>
-#include <vtkImageCast.h>
-#include <vtkImageStencil.h>
+#include <vtkImageStencilData.h>
 #include <vtkPolyDataNormals.h>
 #include <vtkStripper.h>
 #include <vtkTriangleFilter.h>
 #include <vtkPolyDataToImageStencil.h>
+#include <vtkSMPTools.h>
 
 // STD includes
+#include <algorithm>
 #include <sstream>
+#include <thread>
 
 int DEFAULT_LABEL_VALUE = 1;
 
+namespace
+{
+/// Minimum number of slices voxelized by a thread, to keep the cost of copying the surface low compared to voxelization
+const int MINIMUM_VOXELIZATION_SLAB_THICKNESS = 8;
+}
+
 //----------------------------------------------------------------------------
 vtkSegmentationConverterRuleNewMacro(vtkClosedSurfaceToBinaryLabelmapConversionRule);
 
@@ -186,8 +194,36 @@ bool vtkClosedSurfaceToBinaryLabelmapConversionRule::Convert(vtkSegment* segment
     }
 
   // Perform conversion
+  if (!vtkClosedSurfaceToBinaryLabelmapConversionRule::VoxelizeClosedSurface(closedSurfacePolyData, binaryLabelmap, DEFAULT_LABEL_VALUE))
+    {
+    vtkErrorMacro("Convert: Failed to voxelize closed surface!");
+    return false;
+    }
+
+  // Set segment value to 1
+  segment->SetLabelValue(DEFAULT_LABEL_VALUE);
+
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkClosedSurfaceToBinaryLabelmapConversionRule::VoxelizeClosedSurface(vtkPolyData* closedSurfacePolyData,
+  vtkOrientedImageData* binaryLabelmap, unsigned char labelValue)
+{
+  if (!closedSurfacePolyData || !binaryLabelmap)
+    {
+    vtkGenericWarningMacro("vtkClosedSurfaceToBinaryLabelmapConversionRule::VoxelizeClosedSurface: Invalid input");
+    return false;
+    }
+  void* binaryLabelmapVoxelsPointer = binaryLabelmap->GetScalarPointerForExtent(binaryLabelmap->GetExtent());
+  if (!binaryLabelmapVoxelsPointer || binaryLabelmap->GetScalarType() != VTK_UNSIGNED_CHAR
+    || binaryLabelmap->GetNumberOfScalarComponents() != 1)
+    {
+    vtkGenericWarningMacro("vtkClosedSurfaceToBinaryLabelmapConversionRule::VoxelizeClosedSurface: "
+      "Labelmap must have allocated unsigned char scalars");
+    return false;
+    }
 
-  // Now the output labelmap image data contains the right geometry.
   // We need to apply inverse of geometry matrix to the input poly data so that we can perform
   // the conversion in IJK space, because the filters do not support oriented image data.
   vtkSmartPointer<vtkMatrix4x4> outputLabelmapImageToWorldMatrix = vtkSmartPointer<vtkMatrix4x4>::New();
@@ -196,11 +232,6 @@ bool vtkClosedSurfaceToBinaryLabelmapConversionRule::Convert(vtkSegment* segment
   inverseOutputLabelmapGeometryTransform->SetMatrix(outputLabelmapImageToWorldMatrix);
   inverseOutputLabelmapGeometryTransform->Inverse();
 
-  // Set geometry to identity for the volume so that we can perform the stencil operation in IJK space
-  vtkSmartPointer<vtkMatrix4x4> identityMatrix = vtkSmartPointer<vtkMatrix4x4>::New();
-  identityMatrix->Identity();
-  binaryLabelmap->SetGeometryFromImageToWorldMatrix(identityMatrix);
-
   vtkSmartPointer<vtkTransformPolyDataFilter> transformPolyDataFilter =
     vtkSmartPointer<vtkTransformPolyDataFilter>::New();
   transformPolyDataFilter->SetInputData(closedSurfacePolyData);
@@ -219,36 +250,68 @@ bool vtkClosedSurfaceToBinaryLabelmapConversionRule::Convert(vtkSegment* segment
   vtkSmartPointer<vtkStripper> stripper=vtkSmartPointer<vtkStripper>::New();
   stripper->SetInputConnection(triangle->GetOutputPort());
 
-  // Convert polydata to stencil
-  vtkNew<vtkPolyDataToImageStencil> polyDataToImageStencil;
-  polyDataToImageStencil->SetInputConnection(stripper->GetOutputPort());
-  polyDataToImageStencil->SetOutputSpacing(binaryLabelmap->GetSpacing());
-  polyDataToImageStencil->SetOutputOrigin(binaryLabelmap->GetOrigin());
-  polyDataToImageStencil->SetOutputWholeExtent(binaryLabelmap->GetExtent());
-
-  // Convert stencil to image
-  vtkNew<vtkImageStencil> stencil;
-  stencil->SetInputData(binaryLabelmap);
-  stencil->SetStencilConnection(polyDataToImageStencil->GetOutputPort());
-  stencil->ReverseStencilOn();
-  // If the output labelmap was to required to be unsigned char, we could use the segment label value.
-  // To ensure that the label value is < 255, we set it to 1. Collapsing the labelmaps during post-conversion may assign new a value regardless.
-  stencil->SetBackgroundValue(DEFAULT_LABEL_VALUE); // General foreground value is 1 (background value because of reverse stencil)
-
-  // Save result to output
-  vtkNew<vtkImageCast> imageCast;
-  imageCast->SetInputConnection(stencil->GetOutputPort());
-  imageCast->SetOutputScalarTypeToUnsignedChar();
-  imageCast->Update();
-  binaryLabelmap->ShallowCopy(imageCast->GetOutput());
-
-  // Restore geometry of the labelmap that we set to identity before conversion
-  // (so that we can perform the stencil operations in IJK space)
-  binaryLabelmap->SetGeometryFromImageToWorldMatrix(outputLabelmapImageToWorldMatrix);
-
-  // Set segment value to 1
-  segment->SetLabelValue(DEFAULT_LABEL_VALUE);
-
+  stripper->Update();
+  vtkPolyData* strippedPolyData = stripper->GetOutput();
+
+  // Voxelize the surface in slabs along the K axis in parallel. The stencil of each slice only depends on
+  // the surface cut at that slice, so the result is the same as voxelizing the whole extent at once.
+  // Voxels inside the surface are set to the label value, other voxels are not changed.
+  // The stencil is computed in IJK space (unit spacing, zero origin).
+  int labelmapExtent[6] = { 0, -1, 0, -1, 0, -1 };
+  binaryLabelmap->GetExtent(labelmapExtent);
+  int numberOfSlices = labelmapExtent[5] - labelmapExtent[4] + 1;
+  int numberOfThreads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+  // Use more slabs than threads for load balancing, as the surface may be unevenly distributed along K
+  int numberOfSlabs = std::max(1, std::min(numberOfThreads * 2, numberOfSlices / MINIMUM_VOXELIZATION_SLAB_THICKNESS));
+  vtkIdType* increments = binaryLabelmap->GetIncrements();
+  vtkIdType rowIncrement = increments[1];
+  vtkIdType sliceIncrement = increments[2];
+  unsigned char* labelmapPtr = static_cast<unsigned char*>(binaryLabelmapVoxelsPointer);
+  double spacing[3] = { 1.0, 1.0, 1.0 };
+  double origin[3] = { 0.0, 0.0, 0.0 };
+
+  vtkSMPTools::For(0, numberOfSlabs, [&](vtkIdType beginSlab, vtkIdType endSlab)
+    {
+    for (vtkIdType slab = beginSlab; slab < endSlab; ++slab)
+      {
+      int slabExtent[6] = { labelmapExtent[0], labelmapExtent[1], labelmapExtent[2], labelmapExtent[3],
+        labelmapExtent[4] + static_cast<int>(slab * numberOfSlices / numberOfSlabs),
+        labelmapExtent[4] + static_cast<int>((slab + 1) * numberOfSlices / numberOfSlabs) - 1 };
+      if (slabExtent[5] < slabExtent[4])
+        {
+        continue;
+        }
+
+      // Cell traversal of the poly data is not thread-safe, so each slab uses its own copy
+      vtkNew<vtkPolyData> slabPolyData;
+      slabPolyData->DeepCopy(strippedPolyData);
+
+      vtkNew<vtkPolyDataToImageStencil> polyDataToImageStencil;
+      polyDataToImageStencil->SetInputData(slabPolyData.GetPointer());
+      polyDataToImageStencil->SetOutputSpacing(spacing);
+      polyDataToImageStencil->SetOutputOrigin(origin);
+      polyDataToImageStencil->SetOutputWholeExtent(slabExtent);
+      polyDataToImageStencil->Update();
+      vtkImageStencilData* stencilData = polyDataToImageStencil->GetOutput();
+
+      for (int k = slabExtent[4]; k <= slabExtent[5]; ++k)
+        {
+        for (int j = slabExtent[2]; j <= slabExtent[3]; ++j)
+          {
+          unsigned char* rowPtr = labelmapPtr + (k - labelmapExtent[4]) * sliceIncrement + (j - labelmapExtent[2]) * rowIncrement;
+          int iter = 0;
+          int r1 = 0;
+          int r2 = 0;
+          while (stencilData->GetNextExtent(r1, r2, slabExtent[0], slabExtent[1], j, k, iter))
+            {
+            std::fill(rowPtr + (r1 - labelmapExtent[0]), rowPtr + (r2 - labelmapExtent[0] + 1),
+              labelValue);
+            }
+          }
+        }
+      }
+    });
+  binaryLabelmap->Modified();
   return true;
 }
 
@@ -69,6 +69,9 @@ public:
   /// Collapses the segments to as few labelmaps as is possible
   bool PostConvert(vtkSegmentation* segmentation) override;
 
+  /// Created labelmaps are collapsed into shared labelmaps in PostConvert, therefore they cannot be cached
+  bool IsConversionResultCacheable() override { return false; };
+
   /// Get the cost of the conversion.
   unsigned int GetConversionCost(vtkDataObject* sourceRepresentation=nullptr, vtkDataObject* targetRepresentation=nullptr) override;
 
@@ -83,6 +86,13 @@ public:
 
   vtkSetMacro(UseOutputImageDataGeometry, bool);
 
+  /// Voxelize a closed surface into an allocated unsigned char labelmap, using the geometry of the labelmap.
+  /// Voxels inside the surface are set to labelValue, other voxels are not changed.
+  /// Slabs of the labelmap are voxelized in parallel.
+  /// \return Success flag
+  static bool VoxelizeClosedSurface(vtkPolyData* closedSurfacePolyData, vtkOrientedImageData* binaryLabelmap,
+    unsigned char labelValue);
+
 protected:
   /// Calculate actual geometry of the output labelmap volume by verifying that the reference image geometry
   /// encompasses the input surface model, and extending it to the proper directions if necessary.
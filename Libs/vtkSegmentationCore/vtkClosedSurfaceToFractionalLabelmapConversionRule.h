@@ -64,6 +64,9 @@ public:
   /// Overridden to prevent vtkClosedSurfaceToBinaryLabelmapConversionRule::PostConvert
   bool PostConvert(vtkSegmentation* vtkNotUsed(segmentation)) override { return true; };
 
+  /// Fractional labelmaps are not collapsed, so they can be cached
+  bool IsConversionResultCacheable() override { return true; };
+
   /// Get the cost of the conversion.
   unsigned int GetConversionCost(vtkDataObject* sourceRepresentation=nullptr, vtkDataObject* targetRepresentation=nullptr) override;
 
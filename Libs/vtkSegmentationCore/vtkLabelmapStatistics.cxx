@@ -0,0 +1,406 @@
+/*==============================================================================
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// SegmentationCore includes
+#include "vtkLabelmapStatistics.h"
+#include "vtkOrientedImageData.h"
+#include "vtkOrientedImageDataResample.h"
+
+// VTK includes
+#include <vtkDoubleArray.h>
+#include <vtkIdTypeArray.h>
+#include <vtkIntArray.h>
+#include <vtkMatrix4x4.h>
+#include <vtkNew.h>
+#include <vtkObjectFactory.h>
+#include <vtkPointData.h>
+#include <vtkSMPTools.h>
+#include <vtkTable.h>
+
+// STD includes
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <string>
+
+namespace
+{
+
+/// Sums collected for one label within one slice
+struct LabelAccumulatorType
+{
+  vtkIdType VoxelCount{0};
+  double SumI{0.0};
+  double SumJ{0.0};
+  double SumK{0.0};
+  double Sum{0.0};
+  double SumOfSquares{0.0};
+  double Minimum{std::numeric_limits<double>::max()};
+  double Maximum{std::numeric_limits<double>::lowest()};
+  int Extent[6]{std::numeric_limits<int>::max(), std::numeric_limits<int>::min(),
+    std::numeric_limits<int>::max(), std::numeric_limits<int>::min(),
+    std::numeric_limits<int>::max(), std::numeric_limits<int>::min()};
+
+  void Add(const LabelAccumulatorType& other)
+    {
+    this->VoxelCount += other.VoxelCount;
+    this->SumI += other.SumI;
+    this->SumJ += other.SumJ;
+    this->SumK += other.SumK;
+    this->Sum += other.Sum;
+    this->SumOfSquares += other.SumOfSquares;
+    this->Minimum = std::min(this->Minimum, other.Minimum);
+    this->Maximum = std::max(this->Maximum, other.Maximum);
+    for (int axis = 0; axis < 3; ++axis)
+      {
+      this->Extent[axis * 2] = std::min(this->Extent[axis * 2], other.Extent[axis * 2]);
+      this->Extent[axis * 2 + 1] = std::max(this->Extent[axis * 2 + 1], other.Extent[axis * 2 + 1]);
+      }
+    }
+};
+typedef std::map<int, LabelAccumulatorType> LabelAccumulatorMapType;
+
+//----------------------------------------------------------------------------
+/// Accumulate label statistics slice by slice. Each slice has its own accumulators, so that
+/// slices can be processed in parallel and the result does not depend on the number of threads.
+/// If intensityPtr is nullptr then intensity sums are not computed.
+template <class LabelType, class IntensityType>
+void AccumulateLabelStatisticsGeneric(vtkImageData* labelmap, LabelType* labelPtr,
+  IntensityType* intensityPtr, std::vector<LabelAccumulatorMapType>& sliceAccumulators)
+{
+  int extent[6] = { 0, -1, 0, -1, 0, -1 };
+  labelmap->GetExtent(extent);
+  vtkIdType* increments = labelmap->GetIncrements();
+  vtkIdType rowIncrement = increments[1];
+  vtkIdType sliceIncrement = increments[2];
+  int numberOfSlices = extent[5] - extent[4] + 1;
+  sliceAccumulators.clear();
+  sliceAccumulators.resize(numberOfSlices);
+
+  vtkSMPTools::For(0, numberOfSlices, [&](vtkIdType beginSlice, vtkIdType endSlice)
+    {
+    for (vtkIdType sliceIndex = beginSlice; sliceIndex < endSlice; ++sliceIndex)
+      {
+      LabelAccumulatorMapType& accumulators = sliceAccumulators[sliceIndex];
+      int k = extent[4] + static_cast<int>(sliceIndex);
+      // Neighboring voxels typically have the same label, so the last accumulator is reused without map lookup
+      LabelType lastLabel = 0;
+      LabelAccumulatorType* accumulator = nullptr;
+      for (int j = extent[2]; j <= extent[3]; ++j)
+        {
+        vtkIdType rowOffset = sliceIndex * sliceIncrement + (j - extent[2]) * rowIncrement;
+        const LabelType* labelRowPtr = labelPtr + rowOffset;
+        const IntensityType* intensityRowPtr = intensityPtr ? intensityPtr + rowOffset : nullptr;
+        for (int i = extent[0]; i <= extent[1]; ++i)
+          {
+          LabelType label = labelRowPtr[i - extent[0]];
+          if (label <= 0)
+            {
+            continue;
+            }
+          if (!accumulator || label != lastLabel)
+            {
+            accumulator = &accumulators[static_cast<int>(label)];
+            lastLabel = label;
+            }
+          ++accumulator->VoxelCount;
+          accumulator->SumI += i;
+          accumulator->SumJ += j;
+          accumulator->SumK += k;
+          accumulator->Extent[0] = std::min(accumulator->Extent[0], i);
+          accumulator->Extent[1] = std::max(accumulator->Extent[1], i);
+          accumulator->Extent[2] = std::min(accumulator->Extent[2], j);
+          accumulator->Extent[3] = std::max(accumulator->Extent[3], j);
+          accumulator->Extent[4] = std::min(accumulator->Extent[4], k);
+          accumulator->Extent[5] = std::max(accumulator->Extent[5], k);
+          if (intensityRowPtr)
+            {
+            double intensity = static_cast<double>(intensityRowPtr[i - extent[0]]);
+            accumulator->Sum += intensity;
+            accumulator->SumOfSquares += intensity * intensity;
+            accumulator->Minimum = std::min(accumulator->Minimum, intensity);
+            accumulator->Maximum = std::max(accumulator->Maximum, intensity);
+            }
+          }
+        }
+      }
+    });
+}
+
+//----------------------------------------------------------------------------
+template <class LabelType>
+void AccumulateLabelStatisticsForLabelType(vtkImageData* labelmap, LabelType* labelPtr,
+  vtkImageData* intensityImage, std::vector<LabelAccumulatorMapType>& sliceAccumulators)
+{
+  if (!intensityImage)
+    {
+    AccumulateLabelStatisticsGeneric<LabelType, double>(labelmap, labelPtr, nullptr, sliceAccumulators);
+    return;
+    }
+  switch (intensityImage->GetScalarType())
+    {
+    vtkTemplateMacro(AccumulateLabelStatisticsGeneric<LabelType, VTK_TT>(labelmap, labelPtr,
+      static_cast<VTK_TT*>(intensityImage->GetScalarPointer()), sliceAccumulators));
+    default:
+      break;
+    }
+}
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+vtkStandardNewMacro(vtkLabelmapStatistics);
+
+//----------------------------------------------------------------------------
+vtkLabelmapStatistics::vtkLabelmapStatistics() = default;
+
+//----------------------------------------------------------------------------
+vtkLabelmapStatistics::~vtkLabelmapStatistics() = default;
+
+//----------------------------------------------------------------------------
+void vtkLabelmapStatistics::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "Labelmap: " << this->Labelmap.GetPointer() << "\n";
+  os << indent << "IntensityImage: " << this->IntensityImage.GetPointer() << "\n";
+  os << indent << "NumberOfLabels: " << this->Statistics.size() << "\n";
+}
+
+//----------------------------------------------------------------------------
+void vtkLabelmapStatistics::SetLabelmap(vtkOrientedImageData* labelmap)
+{
+  if (this->Labelmap == labelmap)
+    {
+    return;
+    }
+  this->Labelmap = labelmap;
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+vtkOrientedImageData* vtkLabelmapStatistics::GetLabelmap()
+{
+  return this->Labelmap;
+}
+
+//----------------------------------------------------------------------------
+void vtkLabelmapStatistics::SetIntensityImage(vtkOrientedImageData* intensityImage)
+{
+  if (this->IntensityImage == intensityImage)
+    {
+    return;
+    }
+  this->IntensityImage = intensityImage;
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+vtkOrientedImageData* vtkLabelmapStatistics::GetIntensityImage()
+{
+  return this->IntensityImage;
+}
+
+//----------------------------------------------------------------------------
+bool vtkLabelmapStatistics::Compute()
+{
+  this->Statistics.clear();
+  this->IntensityStatisticsComputed = false;
+
+  if (!this->Labelmap || !this->Labelmap->GetPointData() || !this->Labelmap->GetPointData()->GetScalars())
+    {
+    vtkErrorMacro("Compute: Invalid labelmap");
+    return false;
+    }
+  if (this->Labelmap->GetNumberOfScalarComponents() != 1)
+    {
+    vtkErrorMacro("Compute: Labelmap must have a single scalar component");
+    return false;
+    }
+  int labelScalarType = this->Labelmap->GetScalarType();
+  if (labelScalarType == VTK_FLOAT || labelScalarType == VTK_DOUBLE)
+    {
+    vtkErrorMacro("Compute: Labelmap must have integer scalar type");
+    return false;
+    }
+
+  vtkOrientedImageData* intensityImage = this->IntensityImage;
+  if (intensityImage)
+    {
+    if (!intensityImage->GetPointData() || !intensityImage->GetPointData()->GetScalars())
+      {
+      vtkErrorMacro("Compute: Invalid intensity image");
+      return false;
+      }
+    if (!vtkOrientedImageDataResample::DoGeometriesMatch(this->Labelmap, intensityImage)
+      || !vtkOrientedImageDataResample::DoExtentsMatch(this->Labelmap, intensityImage))
+      {
+      vtkErrorMacro("Compute: Intensity image geometry does not match the labelmap geometry");
+      return false;
+      }
+    if (intensityImage->GetNumberOfScalarComponents() != 1)
+      {
+      vtkErrorMacro("Compute: Intensity image must have a single scalar component");
+      return false;
+      }
+    }
+
+  std::vector<LabelAccumulatorMapType> sliceAccumulators;
+  switch (labelScalarType)
+    {
+    vtkTemplateMacro(AccumulateLabelStatisticsForLabelType<VTK_TT>(this->Labelmap,
+      static_cast<VTK_TT*>(this->Labelmap->GetScalarPointer()), intensityImage, sliceAccumulators));
+    default:
+      vtkErrorMacro("Compute: Unknown labelmap scalar type");
+      return false;
+    }
+
+  // Combine the slices
+  LabelAccumulatorMapType accumulators;
+  for (const LabelAccumulatorMapType& slice : sliceAccumulators)
+    {
+    for (LabelAccumulatorMapType::const_iterator labelIt = slice.begin(); labelIt != slice.end(); ++labelIt)
+      {
+      accumulators[labelIt->first].Add(labelIt->second);
+      }
+    }
+
+  double spacing[3] = { 1.0, 1.0, 1.0 };
+  this->Labelmap->GetSpacing(spacing);
+  double voxelVolume = std::abs(spacing[0] * spacing[1] * spacing[2]);
+  vtkNew<vtkMatrix4x4> imageToWorldMatrix;
+  this->Labelmap->GetImageToWorldMatrix(imageToWorldMatrix.GetPointer());
+
+  for (LabelAccumulatorMapType::iterator labelIt = accumulators.begin(); labelIt != accumulators.end(); ++labelIt)
+    {
+    const LabelAccumulatorType& accumulator = labelIt->second;
+    LabelStatisticsType& statistics = this->Statistics[labelIt->first];
+    double voxelCount = static_cast<double>(accumulator.VoxelCount);
+    statistics.VoxelCount = accumulator.VoxelCount;
+    statistics.Volume = voxelCount * voxelVolume;
+    std::copy(accumulator.Extent, accumulator.Extent + 6, statistics.Extent);
+    double centroidIjk[4] = { accumulator.SumI / voxelCount, accumulator.SumJ / voxelCount, accumulator.SumK / voxelCount, 1.0 };
+    double centroidWorld[4] = { 0.0, 0.0, 0.0, 1.0 };
+    imageToWorldMatrix->MultiplyPoint(centroidIjk, centroidWorld);
+    std::copy(centroidWorld, centroidWorld + 3, statistics.Centroid);
+    if (intensityImage)
+      {
+      statistics.Minimum = accumulator.Minimum;
+      statistics.Maximum = accumulator.Maximum;
+      statistics.Mean = accumulator.Sum / voxelCount;
+      double variance = accumulator.SumOfSquares / voxelCount - statistics.Mean * statistics.Mean;
+      statistics.StandardDeviation = std::sqrt(std::max(0.0, variance));
+      }
+    }
+  this->IntensityStatisticsComputed = (intensityImage != nullptr);
+
+  return true;
+}
+
+//----------------------------------------------------------------------------
+void vtkLabelmapStatistics::GetLabelValues(std::vector<int>& labelValues)
+{
+  labelValues.clear();
+  for (LabelStatisticsMapType::iterator labelIt = this->Statistics.begin(); labelIt != this->Statistics.end(); ++labelIt)
+    {
+    labelValues.push_back(labelIt->first);
+    }
+}
+
+//----------------------------------------------------------------------------
+bool vtkLabelmapStatistics::GetLabelStatistics(int labelValue, LabelStatisticsType& statistics)
+{
+  LabelStatisticsMapType::iterator labelIt = this->Statistics.find(labelValue);
+  if (labelIt == this->Statistics.end())
+    {
+    return false;
+    }
+  statistics = labelIt->second;
+  return true;
+}
+
+//----------------------------------------------------------------------------
+void vtkLabelmapStatistics::GetStatisticsTable(vtkTable* table)
+{
+  if (!table)
+    {
+    vtkErrorMacro("GetStatisticsTable: Invalid table");
+    return;
+    }
+  table->Initialize();
+
+  vtkNew<vtkIntArray> labelValueArray;
+  labelValueArray->SetName("LabelValue");
+  table->AddColumn(labelValueArray.GetPointer());
+  vtkNew<vtkIdTypeArray> voxelCountArray;
+  voxelCountArray->SetName("VoxelCount");
+  table->AddColumn(voxelCountArray.GetPointer());
+
+  std::vector<std::string> doubleColumnNames;
+  doubleColumnNames.push_back("Volume_mm3");
+  if (this->IntensityStatisticsComputed)
+    {
+    doubleColumnNames.push_back("Minimum");
+    doubleColumnNames.push_back("Maximum");
+    doubleColumnNames.push_back("Mean");
+    doubleColumnNames.push_back("StandardDeviation");
+    }
+  const char* extentColumnNames[6] = { "ExtentIMin", "ExtentIMax", "ExtentJMin", "ExtentJMax", "ExtentKMin", "ExtentKMax" };
+  const char* centroidColumnNames[3] = { "CentroidX", "CentroidY", "CentroidZ" };
+  std::vector<vtkSmartPointer<vtkDoubleArray> > doubleArrays;
+  for (const std::string& name : doubleColumnNames)
+    {
+    vtkSmartPointer<vtkDoubleArray> array = vtkSmartPointer<vtkDoubleArray>::New();
+    array->SetName(name.c_str());
+    table->AddColumn(array);
+    doubleArrays.push_back(array);
+    }
+  std::vector<vtkSmartPointer<vtkIntArray> > extentArrays;
+  for (int i = 0; i < 6; ++i)
+    {
+    vtkSmartPointer<vtkIntArray> array = vtkSmartPointer<vtkIntArray>::New();
+    array->SetName(extentColumnNames[i]);
+    table->AddColumn(array);
+    extentArrays.push_back(array);
+    }
+  std::vector<vtkSmartPointer<vtkDoubleArray> > centroidArrays;
+  for (int i = 0; i < 3; ++i)
+    {
+    vtkSmartPointer<vtkDoubleArray> array = vtkSmartPointer<vtkDoubleArray>::New();
+    array->SetName(centroidColumnNames[i]);
+    table->AddColumn(array);
+    centroidArrays.push_back(array);
+    }
+
+  for (LabelStatisticsMapType::iterator labelIt = this->Statistics.begin(); labelIt != this->Statistics.end(); ++labelIt)
+    {
+    const LabelStatisticsType& statistics = labelIt->second;
+    labelValueArray->InsertNextValue(labelIt->first);
+    voxelCountArray->InsertNextValue(statistics.VoxelCount);
+    doubleArrays[0]->InsertNextValue(statistics.Volume);
+    if (this->IntensityStatisticsComputed)
+      {
+      doubleArrays[1]->InsertNextValue(statistics.Minimum);
+      doubleArrays[2]->InsertNextValue(statistics.Maximum);
+      doubleArrays[3]->InsertNextValue(statistics.Mean);
+      doubleArrays[4]->InsertNextValue(statistics.StandardDeviation);
+      }
+    for (int i = 0; i < 6; ++i)
+      {
+      extentArrays[i]->InsertNextValue(statistics.Extent[i]);
+      }
+    for (int i = 0; i < 3; ++i)
+      {
+      centroidArrays[i]->InsertNextValue(statistics.Centroid[i]);
+      }
+    }
+}
@@ -0,0 +1,109 @@
+/*==============================================================================
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#ifndef __vtkLabelmapStatistics_h
+#define __vtkLabelmapStatistics_h
+
+// VTK includes
+#include <vtkObject.h>
+#include <vtkSmartPointer.h>
+
+// STD includes
+#include <map>
+#include <vector>
+
+// Segmentation includes
+#include "vtkSegmentationCoreConfigure.h"
+
+class vtkOrientedImageData;
+class vtkTable;
+
+/// \ingroup SegmentationCore
+/// \brief Compute statistics of all labels of a labelmap in one parallel pass over the image.
+///
+/// For each label value (voxels with value <= 0 are background) the voxel count, volume,
+/// IJK bounding box and centroid are computed. If an intensity image is set then minimum, maximum,
+/// mean and standard deviation of the intensity values within each label are computed as well.
+/// Typical use is computing statistics of all segments of a shared labelmap layer at once.
+class vtkSegmentationCore_EXPORT vtkLabelmapStatistics : public vtkObject
+{
+public:
+  /// Statistics of one label
+  struct LabelStatisticsType
+    {
+    vtkIdType VoxelCount{0};
+    /// Volume in cubic millimeters
+    double Volume{0.0};
+    /// Intensity statistics, only valid if an intensity image is set
+    double Minimum{0.0};
+    double Maximum{0.0};
+    double Mean{0.0};
+    double StandardDeviation{0.0};
+    /// Bounding box of the label voxels (IJK extent of the labelmap)
+    int Extent[6]{0, -1, 0, -1, 0, -1};
+    /// Centroid of the label voxels in the world coordinate system of the labelmap
+    double Centroid[3]{0.0, 0.0, 0.0};
+    };
+  typedef std::map<int, LabelStatisticsType> LabelStatisticsMapType;
+
+  static vtkLabelmapStatistics* New();
+  vtkTypeMacro(vtkLabelmapStatistics, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  /// Labelmap image, any integer scalar type
+  void SetLabelmap(vtkOrientedImageData* labelmap);
+  vtkOrientedImageData* GetLabelmap();
+
+  /// Optional intensity image. Must have the same geometry as the labelmap
+  /// (\sa vtkOrientedImageDataResample::ResampleOrientedImageToReferenceOrientedImage).
+  void SetIntensityImage(vtkOrientedImageData* intensityImage);
+  vtkOrientedImageData* GetIntensityImage();
+
+  /// Compute the statistics of all labels
+  /// \return Success flag
+  bool Compute();
+
+  /// Get label values found in the labelmap by the last computation
+  void GetLabelValues(std::vector<int>& labelValues);
+
+  /// Get statistics of a label computed by the last computation
+  /// \return False if the label was not found in the labelmap
+  bool GetLabelStatistics(int labelValue, LabelStatisticsType& statistics);
+
+  /// Get statistics of all labels computed by the last computation
+  const LabelStatisticsMapType& GetAllLabelStatistics() { return this->Statistics; };
+
+  /// Write the statistics into a table, one row for each label.
+  /// Columns: LabelValue, VoxelCount, Volume_mm3, (Minimum, Maximum, Mean, StandardDeviation,)
+  /// ExtentIMin, ExtentIMax, ExtentJMin, ExtentJMax, ExtentKMin, ExtentKMax, CentroidX, CentroidY, CentroidZ
+  void GetStatisticsTable(vtkTable* table);
+
+protected:
+  vtkLabelmapStatistics();
+  ~vtkLabelmapStatistics() override;
+
+protected:
+  vtkSmartPointer<vtkOrientedImageData> Labelmap;
+  vtkSmartPointer<vtkOrientedImageData> IntensityImage;
+
+  /// Result of the last computation
+  LabelStatisticsMapType Statistics;
+  /// Flag indicating if the last computation included intensity statistics
+  bool IntensityStatisticsComputed{false};
+
+private:
+  vtkLabelmapStatistics(const vtkLabelmapStatistics&) = delete;
+  void operator=(const vtkLabelmapStatistics&) = delete;
+};
+
+#endif // __vtkLabelmapStatistics_h
@@ -44,6 +44,11 @@ vtkOrientedImageData::vtkOrientedImageData()
       this->Directions[i][j] = (i == j) ? 1.0 : 0.0;
       }
     }
+  for (i = 0; i < 6; i++)
+    {
+    this->CachedEffectiveExtent[i] = (i % 2 == 0) ? 0 : -1;
+    }
+  this->CachedEffectiveExtentThreshold = 0.0;
 }
 
 //----------------------------------------------------------------------------
@@ -374,3 +379,31 @@ bool vtkOrientedImageData::IsEmpty()
     }
   return false;
 }
+
+//----------------------------------------------------------------------------
+void vtkOrientedImageData::SetCachedEffectiveExtent(const int effectiveExtent[6], double threshold)
+{
+  for (int i = 0; i < 6; i++)
+    {
+    this->CachedEffectiveExtent[i] = effectiveExtent[i];
+    }
+  this->CachedEffectiveExtentThreshold = threshold;
+  // Only the cache time stamp is updated, the image itself is not modified
+  this->CachedEffectiveExtentTime.Modified();
+}
+
+//----------------------------------------------------------------------------
+bool vtkOrientedImageData::GetCachedEffectiveExtent(int effectiveExtent[6], double threshold)
+{
+  if (this->CachedEffectiveExtentTime.GetMTime() == 0
+    || this->CachedEffectiveExtentThreshold != threshold
+    || this->GetMTime() > this->CachedEffectiveExtentTime.GetMTime())
+    {
+    return false;
+    }
+  for (int i = 0; i < 6; i++)
+    {
+    effectiveExtent[i] = this->CachedEffectiveExtent[i];
+    }
+  return true;
+}
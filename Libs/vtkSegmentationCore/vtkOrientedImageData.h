@@ -91,6 +91,13 @@ public:
   /// Determines whether the image data is empty (if the extent has 0 voxels then it is)
   bool IsEmpty();
 
+  /// Store the effective extent computed for the given threshold.
+  /// The cached value remains valid until the image is modified.
+  void SetCachedEffectiveExtent(const int effectiveExtent[6], double threshold);
+  /// Get the effective extent cached for the given threshold.
+  /// eturn False if there is no cached value for the threshold or the image has been modified since it was cached.
+  bool GetCachedEffectiveExtent(int effectiveExtent[6], double threshold);
+
 protected:
   vtkOrientedImageData();
   ~vtkOrientedImageData() override;
@@ -100,6 +107,11 @@ protected:
   /// These are unit length direction cosines
   double Directions[3][3];
 
+  /// Effective extent cache, see SetCachedEffectiveExtent
+  int CachedEffectiveExtent[6];
+  double CachedEffectiveExtentThreshold;
+  vtkTimeStamp CachedEffectiveExtentTime;
+
 private:
   vtkOrientedImageData(const vtkOrientedImageData&) = delete;
   void operator=(const vtkOrientedImageData&) = delete;
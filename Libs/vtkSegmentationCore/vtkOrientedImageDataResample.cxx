@@ -36,6 +36,7 @@
 #include <vtkObjectFactory.h>
 #include <vtkPlaneSource.h>
 #include <vtkPointData.h>
+#include <vtkSMPTools.h>
 #include <vtkSmartPointer.h>
 #include <vtkTransform.h>
 #include <vtkTransformPolyDataFilter.h>
@@ -44,6 +45,7 @@
 
 // STD includes
 #include <algorithm>
+#include <array>
 #include <vector>
 
 vtkStandardNewMacro(vtkOrientedImageDataResample);
@@ -114,114 +116,95 @@ void MergeImageGeneric2(
     return;
     }
 
-  bool baseImageModified = false;
+  // Make sure the fill value is valid for the base image scalar range
+  BaseImageScalarType fillValueBaseImageType = 0;
+  if (fillValue < baseImage->GetScalarTypeMin())
+    {
+    fillValueBaseImageType = static_cast<BaseImageScalarType>(baseImage->GetScalarTypeMin());
+    }
+  else if (fillValue > baseImage->GetScalarTypeMax())
+    {
+    fillValueBaseImageType = static_cast<BaseImageScalarType>(baseImage->GetScalarTypeMax());
+    }
+  else
+    {
+    fillValueBaseImageType = static_cast<BaseImageScalarType>(fillValue);
+    }
 
-  // Loop through output pixels
-  // There is difference in only one line between min/max computation but the comparison
-  // is performed for each pixel, so it is faster to make the conditional expression in the outer loop.
-  // Looping is performed in two step: first we just check if any of the pixels have to be changed,
-  // if we find any, then we set baseImageModified flag and to the second loop without need to set
-  // baseImageModified flag again (setting a flag in a hot loop may impact speed).
-  if (operation == vtkOrientedImageDataResample::OPERATION_MAXIMUM)
+  // Make sure the threshold is valid for the modifier scalar range
+  ModifierImageScalarType maskThresholdModifierType = 0;
+  if (maskThreshold < modifierImage->GetScalarTypeMin())
     {
-    for (vtkIdType idxZ = 0; idxZ <= maxZ; idxZ++)
+    maskThresholdModifierType = static_cast<ModifierImageScalarType>(modifierImage->GetScalarTypeMin());
+    }
+  else if (maskThreshold > modifierImage->GetScalarTypeMax())
+    {
+    maskThresholdModifierType = static_cast<ModifierImageScalarType>(modifierImage->GetScalarTypeMax());
+    }
+  else
+    {
+    maskThresholdModifierType = static_cast<ModifierImageScalarType>(maskThreshold);
+    }
+
+  // Row and slice strides, in number of scalars
+  vtkIdType rowLength = maxX + 1;
+  vtkIdType baseRowStride = rowLength + baseIncY;
+  vtkIdType modifierRowStride = rowLength + modifierIncY;
+  vtkIdType baseSliceStride = (maxY + 1) * baseRowStride + baseIncZ;
+  vtkIdType modifierSliceStride = (maxY + 1) * modifierRowStride + modifierIncZ;
+
+  // Slices are processed in parallel. The row loops are branch-free (the result is always written back
+  // and the modified flag is accumulated), so that the compiler can vectorize them.
+  std::vector<char> sliceModified(maxZ + 1, 0);
+  auto mergeSlices = [&](vtkIdType beginZ, vtkIdType endZ)
+    {
+    for (vtkIdType idxZ = beginZ; idxZ < endZ; idxZ++)
       {
+      BaseImageScalarType* baseRowPtr = baseImagePtr + idxZ * baseSliceStride;
+      ModifierImageScalarType* modifierRowPtr = modifierImagePtr + idxZ * modifierSliceStride;
+      bool modified = false;
       for (vtkIdType idxY = 0; idxY <= maxY; idxY++)
         {
-        for (vtkIdType idxX = 0; idxX <= maxX; idxX++)
+        if (operation == vtkOrientedImageDataResample::OPERATION_MAXIMUM)
           {
-          if (static_cast<BaseImageScalarType>(*modifierImagePtr) > *baseImagePtr)
+          for (vtkIdType idxX = 0; idxX < rowLength; idxX++)
             {
-            *baseImagePtr = *modifierImagePtr;
-            baseImageModified = true;
+            BaseImageScalarType baseValue = baseRowPtr[idxX];
+            BaseImageScalarType modifierValue = static_cast<BaseImageScalarType>(modifierRowPtr[idxX]);
+            BaseImageScalarType result = (modifierValue > baseValue) ? modifierValue : baseValue;
+            modified |= (result != baseValue);
+            baseRowPtr[idxX] = result;
             }
-          baseImagePtr++;
-          modifierImagePtr++;
           }
-        baseImagePtr += baseIncY;
-        modifierImagePtr += modifierIncY;
-        }
-      baseImagePtr += baseIncZ;
-      modifierImagePtr += modifierIncZ;
-      }
-    }
-  else if (operation == vtkOrientedImageDataResample::OPERATION_MINIMUM)
-    {
-    for (vtkIdType idxZ = 0; idxZ <= maxZ; idxZ++)
-      {
-      for (vtkIdType idxY = 0; idxY <= maxY; idxY++)
-        {
-        for (vtkIdType idxX = 0; idxX <= maxX; idxX++)
+        else if (operation == vtkOrientedImageDataResample::OPERATION_MINIMUM)
           {
-          if (static_cast<BaseImageScalarType>(*modifierImagePtr) < *baseImagePtr)
+          for (vtkIdType idxX = 0; idxX < rowLength; idxX++)
             {
-            *baseImagePtr = *modifierImagePtr;
-            baseImageModified = true;
+            BaseImageScalarType baseValue = baseRowPtr[idxX];
+            BaseImageScalarType modifierValue = static_cast<BaseImageScalarType>(modifierRowPtr[idxX]);
+            BaseImageScalarType result = (modifierValue < baseValue) ? modifierValue : baseValue;
+            modified |= (result != baseValue);
+            baseRowPtr[idxX] = result;
             }
-          baseImagePtr++;
-          modifierImagePtr++;
           }
-        baseImagePtr += baseIncY;
-        modifierImagePtr += modifierIncY;
-        }
-      baseImagePtr += baseIncZ;
-      modifierImagePtr += modifierIncZ;
-      }
-    }
-  else if (operation == vtkOrientedImageDataResample::OPERATION_MASKING)
-    {
-
-    // Make sure the fill value is valid for the base image scalar range
-    BaseImageScalarType fillValueBaseImageType = 0;
-    if (fillValue < baseImage->GetScalarTypeMin())
-      {
-      fillValueBaseImageType = static_cast<BaseImageScalarType>(baseImage->GetScalarTypeMin());
-      }
-    else if (fillValue > baseImage->GetScalarTypeMax())
-      {
-      fillValueBaseImageType = static_cast<BaseImageScalarType>(baseImage->GetScalarTypeMax());
-      }
-    else
-      {
-      fillValueBaseImageType = static_cast<BaseImageScalarType>(fillValue);
-      }
-
-    // Make sure the threshold is valid for the modifier scalar range
-    ModifierImageScalarType maskThresholdModifierType = 0;
-    if (maskThreshold < modifierImage->GetScalarTypeMin())
-      {
-      maskThresholdModifierType = static_cast<ModifierImageScalarType>(modifierImage->GetScalarTypeMin());
-      }
-    else if (maskThreshold > modifierImage->GetScalarTypeMax())
-      {
-      maskThresholdModifierType = static_cast<ModifierImageScalarType>(modifierImage->GetScalarTypeMax());
-      }
-    else
-      {
-      maskThresholdModifierType = static_cast<ModifierImageScalarType>(maskThreshold);
-      }
-
-    for (vtkIdType idxZ = 0; idxZ <= maxZ; idxZ++)
-      {
-      for (vtkIdType idxY = 0; idxY <= maxY; idxY++)
-        {
-        for (vtkIdType idxX = 0; idxX <= maxX; idxX++)
+        else if (operation == vtkOrientedImageDataResample::OPERATION_MASKING)
           {
-          if ((*modifierImagePtr) > maskThresholdModifierType)
+          for (vtkIdType idxX = 0; idxX < rowLength; idxX++)
             {
-            *baseImagePtr = fillValueBaseImageType;
-            baseImageModified = true;
+            bool inMask = (modifierRowPtr[idxX] > maskThresholdModifierType);
+            modified |= inMask;
+            baseRowPtr[idxX] = inMask ? fillValueBaseImageType : baseRowPtr[idxX];
             }
-          baseImagePtr++;
-          modifierImagePtr++;
-        }
-        baseImagePtr += baseIncY;
-        modifierImagePtr += modifierIncY;
+          }
+        baseRowPtr += baseRowStride;
+        modifierRowPtr += modifierRowStride;
         }
-      baseImagePtr += baseIncZ;
-      modifierImagePtr += modifierIncZ;
+      sliceModified[idxZ] = modified;
       }
-    }
+    };
+  vtkSMPTools::For(0, static_cast<vtkIdType>(maxZ) + 1, mergeSlices);
+
+  bool baseImageModified = std::find(sliceModified.begin(), sliceModified.end(), 1) != sliceModified.end();
   if (baseImageModified)
     {
     baseImage->Modified();
@@ -603,52 +586,81 @@ template <typename T> void CalculateEffectiveExtentGeneric(vtkOrientedImageData*
     return;
     }
 
-  // Loop through output pixels
-  for (int k = wholeExt[4]; k <= wholeExt[5]; k++)
+  vtkIdType incX = 0;
+  vtkIdType incY = 0;
+  vtkIdType incZ = 0;
+  image->GetIncrements(incX, incY, incZ);
+  T* imageStartPtr = static_cast<T*>(image->GetScalarPointer());
+
+  // Slices are processed in parallel, each computing the I and J range of its voxels above threshold.
+  // Within a slice, a row that is already within the J range only needs to be searched up to the
+  // current minimum I from the beginning and down to the current maximum I from the end.
+  int numberOfSlices = wholeExt[5] - wholeExt[4] + 1;
+  std::vector<std::array<int, 4> > sliceExtents(numberOfSlices);
+  auto processSlices = [&](vtkIdType beginSlice, vtkIdType endSlice)
     {
-    for (int j = wholeExt[2]; j <= wholeExt[3]; j++)
+    for (vtkIdType slice = beginSlice; slice < endSlice; slice++)
       {
-      bool currentLineInEffectiveExtent = (k >= effectiveExtent[4] && k <= effectiveExtent[5] && j >= effectiveExtent[2] && j <= effectiveExtent[3]);
-      int i = wholeExt[0];
-      T* imagePtr = static_cast<T*>(image->GetScalarPointer(i,j,k));
-      int firstSegmentEnd = currentLineInEffectiveExtent ? effectiveExtent[0] : wholeExt[1];
-      for (; i <= firstSegmentEnd; i++)
+      std::array<int, 4>& sliceExtent = sliceExtents[slice];
+      sliceExtent[0] = wholeExt[1] + 1;
+      sliceExtent[1] = wholeExt[0] - 1;
+      sliceExtent[2] = wholeExt[3] + 1;
+      sliceExtent[3] = wholeExt[2] - 1;
+      T* slicePtr = imageStartPtr + slice * incZ;
+      for (int j = wholeExt[2]; j <= wholeExt[3]; j++)
         {
-        if (*(imagePtr++) > threshold)
+        T* rowPtr = slicePtr + (j - wholeExt[2]) * incY;
+        bool currentLineInEffectiveExtent = (j >= sliceExtent[2] && j <= sliceExtent[3]);
+        int firstSegmentEnd = currentLineInEffectiveExtent ? sliceExtent[0] : wholeExt[1];
+        T* imagePtr = rowPtr;
+        for (int i = wholeExt[0]; i <= firstSegmentEnd; i++, imagePtr += incX)
           {
-          if (i < effectiveExtent[0]) { effectiveExtent[0] = i; }
-          if (i > effectiveExtent[1]) { effectiveExtent[1] = i; }
-          if (j < effectiveExtent[2]) { effectiveExtent[2] = j; }
-          if (j > effectiveExtent[3]) { effectiveExtent[3] = j; }
-          if (k < effectiveExtent[4]) { effectiveExtent[4] = k; }
-          if (k > effectiveExtent[5]) { effectiveExtent[5] = k; }
-          currentLineInEffectiveExtent = true;
-          break;
+          if (*imagePtr > threshold)
+            {
+            sliceExtent[0] = std::min(sliceExtent[0], i);
+            sliceExtent[1] = std::max(sliceExtent[1], i);
+            sliceExtent[2] = std::min(sliceExtent[2], j);
+            sliceExtent[3] = std::max(sliceExtent[3], j);
+            currentLineInEffectiveExtent = true;
+            break;
+            }
           }
-        }
-      if (!currentLineInEffectiveExtent)
-        {
-        // We haven't found any non-empty voxel in this line
-        continue;
-        }
-      // Now we need to find the other end of the extent: the last non-empty voxel in the line.
-      // The fastest way to find it is to start backward search from the end of the line.
-      i = wholeExt[1];
-      imagePtr = static_cast<T*>(image->GetScalarPointer(i,j,k));
-      for (; i > effectiveExtent[1]; i--)
-        {
-        if (*(imagePtr--)>threshold)
+        if (!currentLineInEffectiveExtent)
           {
-          if (i < effectiveExtent[0]) { effectiveExtent[0] = i; }
-          if (i > effectiveExtent[1]) { effectiveExtent[1] = i; }
-          if (j < effectiveExtent[2]) { effectiveExtent[2] = j; }
-          if (j > effectiveExtent[3]) { effectiveExtent[3] = j; }
-          if (k < effectiveExtent[4]) { effectiveExtent[4] = k; }
-          if (k > effectiveExtent[5]) { effectiveExtent[5] = k; }
-          break;
+          // We haven't found any non-empty voxel in this line
+          continue;
+          }
+        // Now we need to find the other end of the extent: the last non-empty voxel in the line.
+        // The fastest way to find it is to start backward search from the end of the line.
+        imagePtr = rowPtr + (wholeExt[1] - wholeExt[0]) * incX;
+        for (int i = wholeExt[1]; i > sliceExtent[1]; i--, imagePtr -= incX)
+          {
+          if (*imagePtr > threshold)
+            {
+            sliceExtent[1] = i;
+            break;
+            }
           }
         }
       }
+    };
+  vtkSMPTools::For(0, numberOfSlices, processSlices);
+
+  // Combine the slice results
+  for (int slice = 0; slice < numberOfSlices; slice++)
+    {
+    const std::array<int, 4>& sliceExtent = sliceExtents[slice];
+    if (sliceExtent[0] > sliceExtent[1])
+      {
+      continue;
+      }
+    int k = wholeExt[4] + slice;
+    effectiveExtent[0] = std::min(effectiveExtent[0], sliceExtent[0]);
+    effectiveExtent[1] = std::max(effectiveExtent[1], sliceExtent[1]);
+    effectiveExtent[2] = std::min(effectiveExtent[2], sliceExtent[2]);
+    effectiveExtent[3] = std::max(effectiveExtent[3], sliceExtent[3]);
+    effectiveExtent[4] = std::min(effectiveExtent[4], k);
+    effectiveExtent[5] = std::max(effectiveExtent[5], k);
     }
 }
 
@@ -660,12 +672,18 @@ bool vtkOrientedImageDataResample::CalculateEffectiveExtent(vtkOrientedImageData
     return false;
     }
 
-  switch (image->GetScalarType())
+  // Computing the effective extent requires a scan of the whole image,
+  // therefore the result is cached in the image until it is modified
+  if (!image->GetCachedEffectiveExtent(effectiveExtent, threshold))
     {
-    vtkTemplateMacro(CalculateEffectiveExtentGeneric<VTK_TT>(image, effectiveExtent, threshold));
-  default:
-    vtkGenericWarningMacro("vtkOrientedImageDataResample::CalculateEffectiveExtent: Unknown ScalarType");
-    return false;
+    switch (image->GetScalarType())
+      {
+      vtkTemplateMacro(CalculateEffectiveExtentGeneric<VTK_TT>(image, effectiveExtent, threshold));
+    default:
+      vtkGenericWarningMacro("vtkOrientedImageDataResample::CalculateEffectiveExtent: Unknown ScalarType");
+      return false;
+      }
+    image->SetCachedEffectiveExtent(effectiveExtent, threshold);
     }
 
   // Return with failure if effective input extent is empty
@@ -47,8 +47,11 @@
 
 // STD includes
 #include <algorithm>
+#include <atomic>
+#include <cstring>
 #include <functional>
 #include <sstream>
+#include <thread>
 
 const int DEFAULT_LABEL_VALUE = 1;
 
@@ -66,6 +69,44 @@ public:
     }
 };
 
+//----------------------------------------------------------------------------
+/// Set voxels of the merged labelmap within the extent to mergedLabelValue where the
+/// segment labelmap has the label value of the segment
+template<class T>
+void PaintMergedLabelGeneric(vtkOrientedImageData* mergedImage, vtkOrientedImageData* labelmap,
+  int segmentLabelValue, int mergedLabelValue, const int extent[6])
+{
+  int* labelmapExtent = labelmap->GetExtent();
+  int paintExtent[6] = { 0, -1, 0, -1, 0, -1 };
+  for (int i = 0; i < 3; ++i)
+    {
+    paintExtent[2 * i] = std::max(extent[2 * i], labelmapExtent[2 * i]);
+    paintExtent[2 * i + 1] = std::min(extent[2 * i + 1], labelmapExtent[2 * i + 1]);
+    }
+  if (paintExtent[0] > paintExtent[1] || paintExtent[2] > paintExtent[3] || paintExtent[4] > paintExtent[5]
+    || !labelmap->GetScalarPointer())
+    {
+    return;
+    }
+  const T segmentValue = static_cast<T>(segmentLabelValue);
+  const short mergedValue = static_cast<short>(std::max(static_cast<int>(VTK_SHORT_MIN), std::min(static_cast<int>(VTK_SHORT_MAX), mergedLabelValue)));
+  for (int k = paintExtent[4]; k <= paintExtent[5]; ++k)
+    {
+    for (int j = paintExtent[2]; j <= paintExtent[3]; ++j)
+      {
+      short* mergedPtr = static_cast<short*>(mergedImage->GetScalarPointer(paintExtent[0], j, k));
+      T* labelmapPtr = static_cast<T*>(labelmap->GetScalarPointer(paintExtent[0], j, k));
+      for (int i = paintExtent[0]; i <= paintExtent[1]; ++i, ++mergedPtr, ++labelmapPtr)
+        {
+        if (*labelmapPtr == segmentValue)
+          {
+          *mergedPtr = mergedValue;
+          }
+        }
+      }
+    }
+}
+
 //----------------------------------------------------------------------------
 vtkSegmentation::vtkSegmentation()
 {
@@ -84,6 +125,8 @@ vtkSegmentation::vtkSegmentation()
 
   this->SegmentIdAutogeneratorIndex = 0;
 
+  this->NumberOfConversionThreads = std::max(1, std::min(64, static_cast<int>(std::thread::hardware_concurrency())));
+
   this->SetMasterRepresentationName(vtkSegmentationConverter::GetSegmentationBinaryLabelmapRepresentationName());
 }
 
@@ -161,6 +204,58 @@ void vtkSegmentation::DeepCopy(vtkSegmentation* aSegmentation)
     }
 }
 
+//----------------------------------------------------------------------------
+void vtkSegmentation::CopyWithSharedRepresentationData(vtkSegmentation* aSegmentation)
+{
+  if (!aSegmentation)
+    {
+    return;
+    }
+
+  this->RemoveAllSegments();
+
+  // Copy properties
+  this->SetMasterRepresentationName(aSegmentation->GetMasterRepresentationName());
+
+  // Copy conversion parameters
+  this->Converter->DeepCopy(aSegmentation->Converter);
+
+  // Copy segments list, representations are shallow-copied
+  std::map<vtkDataObject*, vtkDataObject*> copiedDataObjects;
+  for (std::deque< std::string >::iterator segmentIdIt = aSegmentation->SegmentIds.begin(); segmentIdIt != aSegmentation->SegmentIds.end(); ++segmentIdIt)
+    {
+    vtkSegment* sourceSegment = aSegmentation->Segments[*segmentIdIt];
+    vtkSmartPointer<vtkSegment> segment = vtkSmartPointer<vtkSegment>::New();
+    segment->DeepCopyMetadata(sourceSegment);
+    std::vector<std::string> representationNames;
+    sourceSegment->GetContainedRepresentationNames(representationNames);
+    for (std::vector<std::string>::iterator representationNameIt = representationNames.begin();
+      representationNameIt != representationNames.end(); ++representationNameIt)
+      {
+      vtkDataObject* sourceRepresentation = sourceSegment->GetRepresentation(*representationNameIt);
+      std::map<vtkDataObject*, vtkDataObject*>::iterator copiedDataObjectIt = copiedDataObjects.find(sourceRepresentation);
+      if (copiedDataObjectIt != copiedDataObjects.end())
+        {
+        // Shared labelmap
+        segment->AddRepresentation(*representationNameIt, copiedDataObjectIt->second);
+        continue;
+        }
+      vtkDataObject* representationCopy =
+        vtkSegmentationConverterFactory::GetInstance()->ConstructRepresentationObjectByClass(sourceRepresentation->GetClassName());
+      if (!representationCopy)
+        {
+        vtkErrorMacro("CopyWithSharedRepresentationData: Unable to construct representation type class '" << sourceRepresentation->GetClassName() << "'");
+        continue;
+        }
+      representationCopy->ShallowCopy(sourceRepresentation);
+      segment->AddRepresentation(*representationNameIt, representationCopy);
+      copiedDataObjects[sourceRepresentation] = representationCopy;
+      representationCopy->Delete(); // this representation is now owned by the segment
+      }
+    this->AddSegment(segment, *segmentIdIt);
+    }
+}
+
 //----------------------------------------------------------------------------
 void vtkSegmentation::CopyConversionParameters(vtkSegmentation* aSegmentation)
 {
@@ -178,6 +273,9 @@ void vtkSegmentation::PrintSelf(ostream& os, vtkIndent indent)
 
   os << indent << "MasterRepresentationName:  " << this->MasterRepresentationName << "\n";
   os << indent << "Number of segments:  " << this->Segments.size() << "\n";
+  os << indent << "NumberOfConversionThreads:  " << this->NumberOfConversionThreads << "\n";
+  os << indent << "MergedLabelmapCaching:  " << (this->MergedLabelmapCaching ? "true" : "false") << "\n";
+  os << indent << "NumberOfCachedMergedLabelmaps:  " << this->MergedLabelmapCache.size() << "\n";
 
   for (std::deque< std::string >::iterator segmentIdIt = this->SegmentIds.begin();
     segmentIdIt != this->SegmentIds.end(); ++segmentIdIt)
@@ -1019,13 +1117,67 @@ void vtkSegmentation::ApplyNonLinearTransform(vtkAbstractTransform* transform)
 }
 
 //-----------------------------------------------------------------------------
-bool vtkSegmentation::ConvertSegmentsUsingPath(std::vector<std::string> segmentIDs, vtkSegmentationConverter::ConversionPathType path, bool overwriteExisting)
+bool vtkSegmentation::ConvertSegmentsUsingPath(std::vector<std::string> segmentIDs, vtkSegmentationConverter::ConversionPathType path, bool overwriteExisting,
+  const int modifiedExtent[6]/*=nullptr*/)
 {
   if (segmentIDs.empty())
     {
     return true;
     }
 
+  // Reuse results of the same conversion of unmodified master representations from the conversion result cache.
+  // Incremental updates of modified regions are not cached, as the master representation has just been modified.
+  bool useConversionCache = !modifiedExtent && !path.empty() && path.front()
+    && this->MasterRepresentationName == path.front()->GetSourceRepresentationName()
+    && this->Converter->IsConversionPathCacheable(path);
+  std::string conversionCacheKey;
+  if (useConversionCache)
+    {
+    conversionCacheKey = this->Converter->GetConversionCacheKey(path);
+    std::vector<std::string> segmentIDsToConvert;
+    for (auto segmentID : segmentIDs)
+      {
+      vtkSegment* segment = this->GetSegment(segmentID);
+      vtkDataObject* masterRepresentation = (segment ? segment->GetRepresentation(this->MasterRepresentationName) : nullptr);
+      // Existing representations are kept if not overwritten, so only use the cache if all of them are replaced
+      bool targetRepresentationExists = false;
+      for (vtkSegmentationConverterRule* rule : path)
+        {
+        if (segment && segment->GetRepresentation(rule->GetTargetRepresentationName()))
+          {
+          targetRepresentationExists = true;
+          }
+        }
+      vtkSegmentationConverter::RepresentationMapType cachedRepresentations;
+      if ((targetRepresentationExists && !overwriteExisting)
+        || !this->Converter->GetCachedConversionResult(segment, masterRepresentation, conversionCacheKey, cachedRepresentations))
+        {
+        segmentIDsToConvert.push_back(segmentID);
+        continue;
+        }
+      for (vtkSegmentationConverter::RepresentationMapType::iterator reprIt = cachedRepresentations.begin();
+        reprIt != cachedRepresentations.end(); ++reprIt)
+        {
+        vtkDataObject* targetRepresentation = segment->GetRepresentation(reprIt->first);
+        if (targetRepresentation && !strcmp(targetRepresentation->GetClassName(), reprIt->second->GetClassName()))
+          {
+          targetRepresentation->DeepCopy(reprIt->second);
+          }
+        else
+          {
+          vtkSmartPointer<vtkDataObject> representationCopy = vtkSmartPointer<vtkDataObject>::Take(reprIt->second->NewInstance());
+          representationCopy->DeepCopy(reprIt->second);
+          segment->AddRepresentation(reprIt->first, representationCopy);
+          }
+        }
+      }
+    segmentIDs = segmentIDsToConvert;
+    if (segmentIDs.empty())
+      {
+      return true;
+      }
+    }
+
   // Execute each conversion step in the selected path
   vtkSegmentationConverter::ConversionPathType::iterator pathIt;
   for (pathIt = path.begin(); pathIt != path.end(); ++pathIt)
@@ -1039,6 +1191,7 @@ bool vtkSegmentation::ConvertSegmentsUsingPath(std::vector<std::string> segmentI
 
     // Perform conversion step
     currentConversionRule->PreConvert(this);
+    std::vector<vtkSegment*> segmentsToConvert;
     for (auto segmentID : segmentIDs)
       {
       vtkSegment* segment = this->GetSegment(segmentID);
@@ -1061,15 +1214,110 @@ bool vtkSegmentation::ConvertSegmentsUsingPath(std::vector<std::string> segmentI
         {
         continue;
         }
-      currentConversionRule->Convert(segment);
+      segmentsToConvert.push_back(segment);
+      }
+
+    if (modifiedExtent && pathIt == path.begin())
+      {
+      // Only the source of the first conversion step is known to be modified within the extent
+      for (vtkSegment* segment : segmentsToConvert)
+        {
+        currentConversionRule->ConvertModifiedRegion(segment, modifiedExtent);
+        }
+      }
+    else if (currentConversionRule->IsThreadSafe() && this->NumberOfConversionThreads > 1 && segmentsToConvert.size() > 1)
+      {
+      this->ConvertSegmentsInParallel(currentConversionRule, segmentsToConvert);
+      }
+    else
+      {
+      for (vtkSegment* segment : segmentsToConvert)
+        {
+        currentConversionRule->Convert(segment);
+        }
       }
     currentConversionRule->PostConvert(this);
 
   }
 
+  // Store copies of the created representations, as the segment representations may be modified in place later
+  if (useConversionCache)
+    {
+    for (auto segmentID : segmentIDs)
+      {
+      vtkSegment* segment = this->GetSegment(segmentID);
+      vtkSegmentationConverter::RepresentationMapType createdRepresentations;
+      for (vtkSegmentationConverterRule* rule : path)
+        {
+        vtkDataObject* targetRepresentation = segment->GetRepresentation(rule->GetTargetRepresentationName());
+        if (!targetRepresentation)
+          {
+          createdRepresentations.clear();
+          break;
+          }
+        vtkSmartPointer<vtkDataObject> representationCopy = vtkSmartPointer<vtkDataObject>::Take(targetRepresentation->NewInstance());
+        representationCopy->DeepCopy(targetRepresentation);
+        createdRepresentations[rule->GetTargetRepresentationName()] = representationCopy;
+        }
+      this->Converter->AddConversionResultToCache(segment,
+        segment->GetRepresentation(this->MasterRepresentationName), conversionCacheKey, createdRepresentations);
+      }
+    }
+
   return true;
 }
 
+//-----------------------------------------------------------------------------
+void vtkSegmentation::ConvertSegmentsInParallel(vtkSegmentationConverterRule* rule, const std::vector<vtkSegment*>& segments)
+{
+  // Adding representations invokes events, therefore the target representations are created here,
+  // on the calling thread. Convert then only fills the existing target representation objects.
+  // Segments that share a source representation (shared labelmap layers) are converted in the same
+  // task, as the source object is not safe to be used as filter input from multiple threads.
+  std::vector<std::vector<vtkSegment*> > tasks;
+  std::map<vtkDataObject*, size_t> taskIndexBySourceRepresentation;
+  for (vtkSegment* segment : segments)
+    {
+    rule->CreateTargetRepresentation(segment);
+    vtkDataObject* sourceRepresentation = segment->GetRepresentation(rule->GetSourceRepresentationName());
+    std::map<vtkDataObject*, size_t>::iterator taskIt = taskIndexBySourceRepresentation.find(sourceRepresentation);
+    if (taskIt == taskIndexBySourceRepresentation.end())
+      {
+      taskIndexBySourceRepresentation[sourceRepresentation] = tasks.size();
+      tasks.push_back(std::vector<vtkSegment*>(1, segment));
+      }
+    else
+      {
+      tasks[taskIt->second].push_back(segment);
+      }
+    }
+
+  std::atomic<size_t> nextTaskIndex(0);
+  auto convertTasks = [&tasks, &nextTaskIndex, rule]()
+    {
+    for (size_t taskIndex = nextTaskIndex++; taskIndex < tasks.size(); taskIndex = nextTaskIndex++)
+      {
+      for (vtkSegment* segment : tasks[taskIndex])
+        {
+        rule->Convert(segment);
+        }
+      }
+    };
+
+  // The calling thread converts segments as well
+  size_t numberOfThreads = std::min(static_cast<size_t>(this->NumberOfConversionThreads), tasks.size());
+  std::vector<std::thread> threads;
+  for (size_t threadIndex = 1; threadIndex < numberOfThreads; ++threadIndex)
+    {
+    threads.push_back(std::thread(convertTasks));
+    }
+  convertTasks();
+  for (std::vector<std::thread>::iterator threadIt = threads.begin(); threadIt != threads.end(); ++threadIt)
+    {
+    threadIt->join();
+    }
+}
+
 //-----------------------------------------------------------------------------
 bool vtkSegmentation::ConvertSegmentUsingPath(vtkSegment* segment, vtkSegmentationConverter::ConversionPathType path, bool overwriteExisting/*=false*/)
 {
@@ -1356,7 +1604,11 @@ void vtkSegmentation::GetSegmentIDsSharingBinaryLabelmapRepresentation(std::stri
 void vtkSegmentation::MergeSegmentLabelmaps(std::vector<std::string> mergeSegmentIds)
 {
   vtkNew<vtkOrientedImageData> sharedLabelmapRepresentation;
+  // The merged labelmap replaces the segment labelmaps, so it would never be reused from the cache
+  bool wasMergedLabelmapCaching = this->MergedLabelmapCaching;
+  this->MergedLabelmapCaching = false;
   this->GenerateMergedLabelmap(sharedLabelmapRepresentation, EXTENT_UNION_OF_EFFECTIVE_SEGMENTS, nullptr, mergeSegmentIds);
+  this->MergedLabelmapCaching = wasMergedLabelmapCaching;
 
   int value = 0;
   for (std::string segmentId : mergeSegmentIds)
@@ -1458,89 +1710,277 @@ bool vtkSegmentation::GenerateMergedLabelmap(
     }
 
   const short backgroundColorIndex = 0;
-  vtkOrientedImageDataResample::FillImage(sharedImageData, backgroundColorIndex);
 
   // Skip the rest if there are no segments
   if (this->GetNumberOfSegments() == 0)
     {
+    vtkOrientedImageDataResample::FillImage(sharedImageData, backgroundColorIndex);
     return true;
     }
 
-  // Create shared labelmap
+  // Collect binary labelmaps and label values of the segments
   bool success = true;
-  short segmentIndex = 0;
-  for (std::vector<std::string>::iterator segmentIdIt = sharedSegmentIDs.begin(); segmentIdIt != sharedSegmentIDs.end(); ++segmentIdIt, ++segmentIndex)
-    {
-    std::string currentSegmentId = *segmentIdIt;
-    vtkSegment* currentSegment = this->GetSegment(currentSegmentId);
+  size_t numberOfSegments = sharedSegmentIDs.size();
+  std::vector<vtkOrientedImageData*> segmentLabelmaps(numberOfSegments, nullptr);
+  std::vector<int> segmentLabelValues(numberOfSegments, 0);
+  std::vector<int> mergedLabelValues(numberOfSegments, 0);
+  for (size_t segmentIndex = 0; segmentIndex < numberOfSegments; ++segmentIndex)
+    {
+    mergedLabelValues[segmentIndex] = labelValues ? labelValues->GetValue(segmentIndex) : backgroundColorIndex + 1 + static_cast<int>(segmentIndex);
+    vtkSegment* currentSegment = this->GetSegment(sharedSegmentIDs[segmentIndex]);
     if (!currentSegment)
       {
-      vtkErrorMacro("GenerateSharedLabelmap: Segment not found by ID: " << currentSegmentId);
+      vtkErrorMacro("GenerateSharedLabelmap: Segment not found by ID: " << sharedSegmentIDs[segmentIndex]);
       success = false;
       continue;
       }
-
-    // Get binary labelmap from segment
-    vtkOrientedImageData* representationBinaryLabelmap = vtkOrientedImageData::SafeDownCast(
+    segmentLabelmaps[segmentIndex] = vtkOrientedImageData::SafeDownCast(
       currentSegment->GetRepresentation(vtkSegmentationConverter::GetSegmentationBinaryLabelmapRepresentationName()));
-    // If binary labelmap is empty then skip
-    if (representationBinaryLabelmap->IsEmpty())
+    segmentLabelValues[segmentIndex] = currentSegment->GetLabelValue();
+    }
+
+  // Find the cached merged labelmap that can be updated, or start a new one
+  MergedLabelmapCacheEntryType uncachedEntry;
+  MergedLabelmapCacheEntryType* cacheEntry = nullptr;
+  if (this->MergedLabelmapCaching)
+    {
+    vtkNew<vtkMatrix4x4> cachedImageToWorldMatrix;
+    for (std::vector<MergedLabelmapCacheEntryType>::iterator entryIt = this->MergedLabelmapCache.begin();
+      entryIt != this->MergedLabelmapCache.end(); ++entryIt)
       {
-      continue;
+      if (entryIt->SegmentIDs != sharedSegmentIDs || entryIt->MergedLabelValues != mergedLabelValues)
+        {
+        continue;
+        }
+      int* cachedExtent = entryIt->MergedLabelmap->GetExtent();
+      entryIt->MergedLabelmap->GetImageToWorldMatrix(cachedImageToWorldMatrix.GetPointer());
+      if (std::equal(referenceExtent, referenceExtent + 6, cachedExtent)
+        && vtkOrientedImageDataResample::IsEqual(cachedImageToWorldMatrix.GetPointer(), sharedImageToWorldMatrix))
+        {
+        cacheEntry = &(*entryIt);
+        break;
+        }
+      }
+    if (!cacheEntry)
+      {
+      if (this->MergedLabelmapCache.size() >= static_cast<size_t>(MaximumNumberOfMergedLabelmapCacheEntries))
+        {
+        std::vector<MergedLabelmapCacheEntryType>::iterator leastRecentlyUsedIt = this->MergedLabelmapCache.begin();
+        for (std::vector<MergedLabelmapCacheEntryType>::iterator entryIt = this->MergedLabelmapCache.begin();
+          entryIt != this->MergedLabelmapCache.end(); ++entryIt)
+          {
+          if (entryIt->LastUsed < leastRecentlyUsedIt->LastUsed)
+            {
+            leastRecentlyUsedIt = entryIt;
+            }
+          }
+        this->MergedLabelmapCache.erase(leastRecentlyUsedIt);
+        }
+      this->MergedLabelmapCache.push_back(MergedLabelmapCacheEntryType());
+      cacheEntry = &this->MergedLabelmapCache.back();
+      cacheEntry->MergedLabelmap = vtkSmartPointer<vtkOrientedImageData>::New();
+      }
+    cacheEntry->LastUsed = ++this->MergedLabelmapCacheCounter;
+    }
+  else
+    {
+    // Without caching the merged labelmap is generated directly in the output
+    cacheEntry = &uncachedEntry;
+    cacheEntry->MergedLabelmap = sharedImageData;
+    }
+
+  vtkOrientedImageData* mergedImage = cacheEntry->MergedLabelmap;
+  bool fullUpdate = (cacheEntry == &uncachedEntry || cacheEntry->SegmentIDs != sharedSegmentIDs);
+  if (fullUpdate)
+    {
+    if (mergedImage != sharedImageData)
+      {
+      mergedImage->SetExtent(referenceExtent);
+      mergedImage->AllocateScalars(VTK_SHORT, 1);
+      mergedImage->SetImageToWorldMatrix(sharedImageToWorldMatrix);
       }
+    cacheEntry->SegmentIDs = sharedSegmentIDs;
+    cacheEntry->MergedLabelValues = mergedLabelValues;
+    cacheEntry->Labelmaps.assign(numberOfSegments, nullptr);
+    cacheEntry->LabelmapMTimes.assign(numberOfSegments, 0);
+    cacheEntry->LabelValues.assign(numberOfSegments, 0);
+    std::array<int, 6> emptyExtent = {{ 0, -1, 0, -1, 0, -1 }};
+    cacheEntry->Extents.assign(numberOfSegments, emptyExtent);
+    }
 
-    // Set oriented image data used for merging to the representation (may change later if resampling is needed)
-    vtkOrientedImageData* binaryLabelmap = representationBinaryLabelmap;
+  // Determine the region that has to be updated: where changed segments were or are now
+  int updateExtent[6] = { 0, -1, 0, -1, 0, -1 };
+  if (fullUpdate)
+    {
+    std::copy(referenceExtent, referenceExtent + 6, updateExtent);
+    }
+  std::vector<std::array<int, 6> > segmentExtents(numberOfSegments);
+  for (size_t segmentIndex = 0; segmentIndex < numberOfSegments; ++segmentIndex)
+    {
+    std::array<int, 6>& segmentExtent = segmentExtents[segmentIndex];
+    segmentExtent = {{ 0, -1, 0, -1, 0, -1 }};
+    vtkOrientedImageData* labelmap = segmentLabelmaps[segmentIndex];
+    if (labelmap && !labelmap->IsEmpty())
+      {
+      if (vtkOrientedImageDataResample::DoGeometriesMatch(commonGeometryImage, labelmap))
+        {
+        if (vtkOrientedImageDataResample::CalculateEffectiveExtent(labelmap, segmentExtent.data()))
+          {
+          for (int i = 0; i < 3; ++i)
+            {
+            segmentExtent[2 * i] = std::max(segmentExtent[2 * i], referenceExtent[2 * i]);
+            segmentExtent[2 * i + 1] = std::min(segmentExtent[2 * i + 1], referenceExtent[2 * i + 1]);
+            }
+          }
+        }
+      else
+        {
+        // Resampled labelmap may cover any part of the merged labelmap
+        std::copy(referenceExtent, referenceExtent + 6, segmentExtent.begin());
+        }
+      }
 
-    // If labelmap geometries (origin, spacing, and directions) do not match reference then resample temporarily
-    vtkSmartPointer<vtkOrientedImageData> resampledBinaryLabelmap;
-    if (!vtkOrientedImageDataResample::DoGeometriesMatch(commonGeometryImage, representationBinaryLabelmap))
+    bool segmentChanged = fullUpdate
+      || cacheEntry->Labelmaps[segmentIndex].GetPointer() != labelmap
+      || (labelmap && cacheEntry->LabelmapMTimes[segmentIndex] != labelmap->GetMTime())
+      || cacheEntry->LabelValues[segmentIndex] != segmentLabelValues[segmentIndex];
+    if (!segmentChanged)
+      {
+      continue;
+      }
+    const int* changedExtents[2] = { cacheEntry->Extents[segmentIndex].data(), segmentExtent.data() };
+    for (int extentIndex = 0; extentIndex < 2; ++extentIndex)
       {
-      resampledBinaryLabelmap = vtkSmartPointer<vtkOrientedImageData>::New();
+      const int* changedExtent = changedExtents[extentIndex];
+      if (changedExtent[0] > changedExtent[1] || changedExtent[2] > changedExtent[3] || changedExtent[4] > changedExtent[5])
+        {
+        continue;
+        }
+      bool updateExtentEmpty = (updateExtent[0] > updateExtent[1] || updateExtent[2] > updateExtent[3] || updateExtent[4] > updateExtent[5]);
+      for (int i = 0; i < 3; ++i)
+        {
+        updateExtent[2 * i] = updateExtentEmpty ? changedExtent[2 * i] : std::min(updateExtent[2 * i], changedExtent[2 * i]);
+        updateExtent[2 * i + 1] = updateExtentEmpty ? changedExtent[2 * i + 1] : std::max(updateExtent[2 * i + 1], changedExtent[2 * i + 1]);
+        }
+      }
+    }
 
-      // Resample segment labelmap for merging
-      if (!vtkOrientedImageDataResample::ResampleOrientedImageToReferenceGeometry(
-        representationBinaryLabelmap, sharedImageToWorldMatrix, resampledBinaryLabelmap))
+  // Repaint the update region: background first, then all segments that overlap it, in order
+  if (updateExtent[0] <= updateExtent[1] && updateExtent[2] <= updateExtent[3] && updateExtent[4] <= updateExtent[5])
+    {
+    vtkOrientedImageDataResample::FillImage(mergedImage, backgroundColorIndex, updateExtent);
+    for (size_t segmentIndex = 0; segmentIndex < numberOfSegments; ++segmentIndex)
+      {
+      vtkOrientedImageData* representationBinaryLabelmap = segmentLabelmaps[segmentIndex];
+      const std::array<int, 6>& segmentExtent = segmentExtents[segmentIndex];
+      int paintExtent[6] = { 0, -1, 0, -1, 0, -1 };
+      for (int i = 0; i < 3; ++i)
+        {
+        paintExtent[2 * i] = std::max(segmentExtent[2 * i], updateExtent[2 * i]);
+        paintExtent[2 * i + 1] = std::min(segmentExtent[2 * i + 1], updateExtent[2 * i + 1]);
+        }
+      if (!representationBinaryLabelmap
+        || paintExtent[0] > paintExtent[1] || paintExtent[2] > paintExtent[3] || paintExtent[4] > paintExtent[5])
         {
-        vtkErrorMacro("GenerateSharedLabelmap: ResampleOrientedImageToReferenceGeometry failed for segment " << currentSegmentId);
-        success = false;
         continue;
         }
 
-      // Use resampled labelmap for merging
-      binaryLabelmap = resampledBinaryLabelmap;
-      }
+      // Set oriented image data used for merging to the representation (may change later if resampling is needed)
+      vtkOrientedImageData* binaryLabelmap = representationBinaryLabelmap;
 
-    vtkNew<vtkOrientedImageData> thresholdedLabelmap;
-    vtkNew<vtkImageThreshold> threshold;
-    threshold->SetInputData(binaryLabelmap);
-    threshold->ThresholdBetween(currentSegment->GetLabelValue(), currentSegment->GetLabelValue());
-    threshold->SetInValue(1);
-    threshold->SetOutValue(0);
-    threshold->Update();
-    thresholdedLabelmap->ShallowCopy(threshold->GetOutput());
-    thresholdedLabelmap->CopyDirections(binaryLabelmap);
-    binaryLabelmap = thresholdedLabelmap;
+      // If labelmap geometries (origin, spacing, and directions) do not match reference then resample temporarily
+      vtkSmartPointer<vtkOrientedImageData> resampledBinaryLabelmap;
+      if (!vtkOrientedImageDataResample::DoGeometriesMatch(commonGeometryImage, representationBinaryLabelmap))
+        {
+        resampledBinaryLabelmap = vtkSmartPointer<vtkOrientedImageData>::New();
 
-    int labelValue = backgroundColorIndex + 1 + segmentIndex;
-    if (labelValues)
-      {
-      labelValue = labelValues->GetValue(segmentIndex);
+        // Resample segment labelmap for merging
+        if (!vtkOrientedImageDataResample::ResampleOrientedImageToReferenceGeometry(
+          representationBinaryLabelmap, sharedImageToWorldMatrix, resampledBinaryLabelmap))
+          {
+          vtkErrorMacro("GenerateSharedLabelmap: ResampleOrientedImageToReferenceGeometry failed for segment " << sharedSegmentIDs[segmentIndex]);
+          success = false;
+          continue;
+          }
+
+        // Use resampled labelmap for merging
+        binaryLabelmap = resampledBinaryLabelmap;
+        }
+
+      // Copy voxels of the segment into the merged labelmap with the proper label value
+      switch (binaryLabelmap->GetScalarType())
+        {
+        vtkTemplateMacro(PaintMergedLabelGeneric<VTK_TT>(mergedImage, binaryLabelmap,
+          segmentLabelValues[segmentIndex], mergedLabelValues[segmentIndex], paintExtent));
+      default:
+        vtkErrorMacro("GenerateSharedLabelmap: Unknown scalar type in segment " << sharedSegmentIDs[segmentIndex]);
+        success = false;
+        }
       }
+    mergedImage->Modified();
+    }
 
-    // Copy image data voxels into shared labelmap with the proper color index
-    vtkOrientedImageDataResample::ModifyImage(
-      sharedImageData,
-      binaryLabelmap,
-      vtkOrientedImageDataResample::OPERATION_MASKING,
-      nullptr,
-      0,
-      labelValue);
+  // Store the state of the segments the merged labelmap is now up-to-date with
+  for (size_t segmentIndex = 0; segmentIndex < numberOfSegments; ++segmentIndex)
+    {
+    vtkOrientedImageData* labelmap = segmentLabelmaps[segmentIndex];
+    cacheEntry->Labelmaps[segmentIndex] = labelmap;
+    cacheEntry->LabelmapMTimes[segmentIndex] = labelmap ? labelmap->GetMTime() : 0;
+    cacheEntry->LabelValues[segmentIndex] = segmentLabelValues[segmentIndex];
+    cacheEntry->Extents[segmentIndex] = segmentExtents[segmentIndex];
+    }
+
+  if (mergedImage != sharedImageData)
+    {
+    memcpy(sharedImagePtr, mergedImage->GetScalarPointer(),
+      static_cast<size_t>(mergedImage->GetNumberOfPoints()) * mergedImage->GetScalarSize());
+    sharedImageData->Modified();
     }
 
+  if (!success)
+    {
+    // Do not reuse a merged labelmap that could not be generated completely
+    this->ClearMergedLabelmapCache();
+    }
   return success;
 }
 
+//---------------------------------------------------------------------------
+void vtkSegmentation::SetMergedLabelmapCaching(bool caching)
+{
+  if (this->MergedLabelmapCaching == caching)
+    {
+    return;
+    }
+  this->MergedLabelmapCaching = caching;
+  if (!caching)
+    {
+    this->ClearMergedLabelmapCache();
+    }
+  this->Modified();
+}
+
+//---------------------------------------------------------------------------
+void vtkSegmentation::ClearMergedLabelmapCache()
+{
+  this->MergedLabelmapCache.clear();
+}
+
+//---------------------------------------------------------------------------
+unsigned long vtkSegmentation::GetMergedLabelmapCacheMemorySize()
+{
+  unsigned long size = 0;
+  for (std::vector<MergedLabelmapCacheEntryType>::iterator entryIt = this->MergedLabelmapCache.begin();
+    entryIt != this->MergedLabelmapCache.end(); ++entryIt)
+    {
+    if (entryIt->MergedLabelmap)
+      {
+      size += entryIt->MergedLabelmap->GetActualMemorySize();
+      }
+    }
+  return size;
+}
+
 //---------------------------------------------------------------------------
 void vtkSegmentation::SeparateSegmentLabelmap(std::string segmentId)
 {
@@ -24,8 +24,10 @@
 // VTK includes
 #include <vtkObject.h>
 #include <vtkSmartPointer.h>
+#include <vtkWeakPointer.h>
 
 // STD includes
+#include <array>
 #include <map>
 #include <deque>
 #include <vector>
@@ -142,6 +144,11 @@ public:
   /// Deep copy one segmentation into another
   virtual void DeepCopy(vtkSegmentation* aSegmentation);
 
+  /// Copy one segmentation into another. Segments and representation objects
+  /// are copied but the representations share their data arrays with the source.
+  /// Shared arrays must not be modified in place (see vtkMRMLNode::DetachSharedBulkData).
+  virtual void CopyWithSharedRepresentationData(vtkSegmentation* aSegmentation);
+
   /// Copy conversion parameters from another segmentation
   virtual void CopyConversionParameters(vtkSegmentation* aSegmentation);
 
@@ -455,6 +462,9 @@ public:
   void GetConversionParametersForPath(vtkSegmentationConverterRule::ConversionParameterListType& conversionParameters,
     const vtkSegmentationConverter::ConversionPathType& path) { this->Converter->GetConversionParametersForPath(conversionParameters, path); };
 
+  /// Get the converter of the segmentation, for example to configure its conversion result cache
+  vtkSegmentationConverter* GetConverter() { return this->Converter; };
+
   /// Serialize all conversion parameters.
   /// The resulting string can be parsed in a segmentation object using /sa DeserializeConversionParameters
   std::string SerializeAllConversionParameters();
@@ -472,13 +482,45 @@ public:
   /// the segmentation! Use \sa CreateRepresentation for that.
   virtual void SetMasterRepresentationName(const std::string& representationName);
 
+  /// Maximum number of threads used for converting segments.
+  /// Segments are only converted concurrently if the conversion rule is thread-safe
+  /// (\sa vtkSegmentationConverterRule::IsThreadSafe). Segments that share a binary labelmap
+  /// are converted on the same thread. Events are invoked on the calling thread after all
+  /// segments are converted. Default is the number of hardware threads.
+  vtkSetClampMacro(NumberOfConversionThreads, int, 1, 64);
+  vtkGetMacro(NumberOfConversionThreads, int);
+
+  /// Keep the labelmaps generated by \sa GenerateMergedLabelmap and update them incrementally.
+  /// Repeated calls with the same segments, label values and geometry only recompute the regions
+  /// of the segments whose binary labelmap changed since the previous call. Enabled by default.
+  /// Disabling caching removes all cached merged labelmaps.
+  virtual void SetMergedLabelmapCaching(bool caching);
+  vtkGetMacro(MergedLabelmapCaching, bool);
+  vtkBooleanMacro(MergedLabelmapCaching, bool);
+
+  /// Remove all cached merged labelmaps. \sa MergedLabelmapCaching
+  void ClearMergedLabelmapCache();
+
+  /// Get memory used by the cached merged labelmaps, in kibibytes. \sa MergedLabelmapCaching
+  unsigned long GetMergedLabelmapCacheMemorySize();
+
   /// Deep copies source segment to destination segment. If the same representation is found in baseline
   /// with up-to-date timestamp then the representation is reused from baseline.
   static void CopySegment(vtkSegment* destination, vtkSegment* source, vtkSegment* baseline,
     std::map<vtkDataObject*, vtkDataObject*>& cachedRepresentations);
 
 protected:
-  bool ConvertSegmentsUsingPath(std::vector<std::string> segmentIDs, vtkSegmentationConverter::ConversionPathType path, bool overwriteExisting = false);
+  /// Convert given segments along a specified path
+  /// \param modifiedExtent If specified then the master representation of the segments was only modified
+  ///   within this extent since the last conversion, and the first step of the path is allowed to update
+  ///   the target representation incrementally (\sa vtkSegmentationConverterRule::ConvertModifiedRegion)
+  bool ConvertSegmentsUsingPath(std::vector<std::string> segmentIDs, vtkSegmentationConverter::ConversionPathType path, bool overwriteExisting = false,
+    const int modifiedExtent[6] = nullptr);
+
+  /// Convert segments with a thread-safe conversion rule using multiple threads.
+  /// Target representations are created on the calling thread, then segments are grouped by their
+  /// source representation object and the groups are converted concurrently.
+  void ConvertSegmentsInParallel(vtkSegmentationConverterRule* rule, const std::vector<vtkSegment*>& segments);
 
   /// Convert given segment along a specified path
   /// \param segment Segment to convert
@@ -553,6 +595,31 @@ protected:
   /// segment ID.
   int SegmentIdAutogeneratorIndex;
 
+  /// Maximum number of threads used for converting segments
+  int NumberOfConversionThreads;
+
+  /// Merged labelmap generated for a list of segments, with the state of the segments it was generated from
+  struct MergedLabelmapCacheEntryType
+    {
+    std::vector<std::string> SegmentIDs;
+    std::vector<int> MergedLabelValues;
+    /// Merged labelmap in the common geometry
+    vtkSmartPointer<vtkOrientedImageData> MergedLabelmap;
+    /// Binary labelmap, its modified time and label value of each segment at the last update
+    std::vector<vtkWeakPointer<vtkOrientedImageData> > Labelmaps;
+    std::vector<vtkMTimeType> LabelmapMTimes;
+    std::vector<int> LabelValues;
+    /// Extent of the merged labelmap that may contain voxels of each segment
+    std::vector<std::array<int, 6> > Extents;
+    unsigned long LastUsed{0};
+    };
+  /// Merged labelmap cache, \sa MergedLabelmapCaching
+  std::vector<MergedLabelmapCacheEntryType> MergedLabelmapCache;
+  unsigned long MergedLabelmapCacheCounter{0};
+  bool MergedLabelmapCaching{true};
+  /// The least recently used merged labelmap is removed when the cache is full
+  static const int MaximumNumberOfMergedLabelmapCacheEntries = 4;
+
   /// This contains the segment IDs in display order.
   /// (we could retrieve segment IDs from SegmentMap too, but that always contains segments in
   /// alphabetical order)
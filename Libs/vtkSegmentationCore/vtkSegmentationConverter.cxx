@@ -24,8 +24,10 @@
 #include "vtkOrientedImageData.h"
 #include "vtkOrientedImageDataResample.h"
 #include "vtkSegmentationConverterRule.h"
+#include "vtkSegment.h"
 
 // VTK includes
+#include <vtkDataObject.h>
 #include <vtkObjectFactory.h>
 #include <vtkSmartPointer.h>
 #include <vtkMatrix4x4.h>
@@ -35,6 +37,7 @@
 #include <vtkVariant.h>
 
 // STD includes
+#include <algorithm>
 #include <sstream>
 
 //----------------------------------------------------------------------------
@@ -72,6 +75,9 @@ void vtkSegmentationConverter::PrintSelf(ostream& os, vtkIndent indent)
       os << indent << "  Parameter:   " << paramIt->first << " = " << paramIt->second.first << " (" << paramIt->second.second << ")\n";
       }
     }
+  os << indent << "ConversionCacheMemoryBudget: " << this->ConversionCacheMemoryBudget << " MB\n";
+  os << indent << "ConversionCacheMemorySize: " << this->ConversionCacheMemorySize << " KB\n";
+  os << indent << "NumberOfCachedConversionResults: " << this->ConversionCache.size() << "\n";
 }
 
 //----------------------------------------------------------------------------
@@ -530,6 +536,174 @@ void vtkSegmentationConverter::DeserializeConversionParameters(std::string conve
     }
 }
 
+//----------------------------------------------------------------------------
+void vtkSegmentationConverter::SetConversionCacheMemoryBudget(unsigned long budgetMB)
+{
+  if (this->ConversionCacheMemoryBudget == budgetMB)
+    {
+    return;
+    }
+  this->ConversionCacheMemoryBudget = budgetMB;
+  this->PruneConversionCache(budgetMB * 1024);
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkSegmentationConverter::ClearConversionCache()
+{
+  this->ConversionCache.clear();
+  this->ConversionCacheMemorySize = 0;
+}
+
+//----------------------------------------------------------------------------
+bool vtkSegmentationConverter::IsConversionPathCacheable(const ConversionPathType& path)
+{
+  if (this->ConversionCacheMemoryBudget == 0 || path.empty())
+    {
+    return false;
+    }
+  for (vtkSegmentationConverterRule* rule : path)
+    {
+    if (!rule || !rule->IsConversionResultCacheable())
+      {
+      return false;
+      }
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+std::string vtkSegmentationConverter::GetConversionCacheKey(const ConversionPathType& path)
+{
+  std::stringstream ssKey;
+  for (vtkSegmentationConverterRule* rule : path)
+    {
+    if (!rule)
+      {
+      continue;
+      }
+    ssKey << rule->GetName() << SERIALIZATION_SEPARATOR;
+    vtkSegmentationConverterRule::ConversionParameterListType::iterator paramIt;
+    for (paramIt = rule->ConversionParameters.begin(); paramIt != rule->ConversionParameters.end(); ++paramIt)
+      {
+      ssKey << paramIt->first << SERIALIZATION_SEPARATOR_INNER << paramIt->second.first << SERIALIZATION_SEPARATOR;
+      }
+    }
+  return ssKey.str();
+}
+
+//----------------------------------------------------------------------------
+bool vtkSegmentationConverter::GetCachedConversionResult(vtkSegment* segment, vtkDataObject* sourceRepresentation,
+  const std::string& conversionCacheKey, RepresentationMapType& representations)
+{
+  representations.clear();
+  if (!segment || !sourceRepresentation || this->ConversionCache.empty())
+    {
+    return false;
+    }
+
+  // Results of deleted or modified source representations can never be used again
+  this->PruneConversionCache(this->ConversionCacheMemoryBudget * 1024);
+
+  for (ConversionCacheEntryType& entry : this->ConversionCache)
+    {
+    if (entry.Segment == segment
+      && entry.SourceRepresentation == sourceRepresentation
+      && entry.SourceRepresentationMTime == sourceRepresentation->GetMTime()
+      && entry.LabelValue == segment->GetLabelValue()
+      && entry.ConversionCacheKey == conversionCacheKey)
+      {
+      entry.LastUsed = ++this->ConversionCacheCounter;
+      representations = entry.Representations;
+      return true;
+      }
+    }
+  return false;
+}
+
+//----------------------------------------------------------------------------
+void vtkSegmentationConverter::AddConversionResultToCache(vtkSegment* segment, vtkDataObject* sourceRepresentation,
+  const std::string& conversionCacheKey, const RepresentationMapType& representations)
+{
+  if (!segment || !sourceRepresentation || representations.empty() || this->ConversionCacheMemoryBudget == 0)
+    {
+    return;
+    }
+
+  unsigned long memorySize = 0;
+  for (RepresentationMapType::const_iterator reprIt = representations.begin(); reprIt != representations.end(); ++reprIt)
+    {
+    if (!reprIt->second)
+      {
+      return;
+      }
+    memorySize += reprIt->second->GetActualMemorySize();
+    }
+  unsigned long memoryBudget = this->ConversionCacheMemoryBudget * 1024;
+  if (memorySize > memoryBudget)
+    {
+    // Would evict all other results and still not fit
+    return;
+    }
+
+  // Replace previous result of the same conversion
+  for (std::vector<ConversionCacheEntryType>::iterator entryIt = this->ConversionCache.begin();
+    entryIt != this->ConversionCache.end(); ++entryIt)
+    {
+    if (entryIt->Segment == segment && entryIt->SourceRepresentation == sourceRepresentation
+      && entryIt->ConversionCacheKey == conversionCacheKey)
+      {
+      this->ConversionCacheMemorySize -= entryIt->MemorySize;
+      this->ConversionCache.erase(entryIt);
+      break;
+      }
+    }
+
+  this->PruneConversionCache(memoryBudget - memorySize);
+
+  ConversionCacheEntryType entry;
+  entry.Segment = segment;
+  entry.SourceRepresentation = sourceRepresentation;
+  entry.SourceRepresentationMTime = sourceRepresentation->GetMTime();
+  entry.LabelValue = segment->GetLabelValue();
+  entry.ConversionCacheKey = conversionCacheKey;
+  entry.Representations = representations;
+  entry.MemorySize = memorySize;
+  entry.LastUsed = ++this->ConversionCacheCounter;
+  this->ConversionCache.push_back(entry);
+  this->ConversionCacheMemorySize += memorySize;
+}
+
+//----------------------------------------------------------------------------
+void vtkSegmentationConverter::PruneConversionCache(unsigned long maximumMemorySizeKB)
+{
+  // Remove stale entries
+  std::vector<ConversionCacheEntryType>::iterator entryIt = this->ConversionCache.begin();
+  while (entryIt != this->ConversionCache.end())
+    {
+    if (!entryIt->Segment || !entryIt->SourceRepresentation
+      || entryIt->SourceRepresentation->GetMTime() != entryIt->SourceRepresentationMTime)
+      {
+      this->ConversionCacheMemorySize -= entryIt->MemorySize;
+      entryIt = this->ConversionCache.erase(entryIt);
+      }
+    else
+      {
+      ++entryIt;
+      }
+    }
+
+  // Remove least recently used entries until the cache fits
+  while (this->ConversionCacheMemorySize > maximumMemorySizeKB && !this->ConversionCache.empty())
+    {
+    std::vector<ConversionCacheEntryType>::iterator leastRecentlyUsedIt = std::min_element(
+      this->ConversionCache.begin(), this->ConversionCache.end(),
+      [](const ConversionCacheEntryType& a, const ConversionCacheEntryType& b) { return a.LastUsed < b.LastUsed; });
+    this->ConversionCacheMemorySize -= leastRecentlyUsedIt->MemorySize;
+    this->ConversionCache.erase(leastRecentlyUsedIt);
+    }
+}
+
 //----------------------------------------------------------------------------
 void vtkSegmentationConverter::ApplyTransformOnReferenceImageGeometry(vtkAbstractTransform* transform)
 {
@@ -24,10 +24,12 @@
 // VTK includes
 #include <vtkObject.h>
 #include <vtkSmartPointer.h>
+#include <vtkWeakPointer.h>
 
 // STD includes
 #include <map>
 #include <set>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -37,6 +39,7 @@
 #include "vtkSegmentationConverterRule.h"
 
 class vtkAbstractTransform;
+class vtkDataObject;
 class vtkSegment;
 class vtkMatrix4x4;
 class vtkImageData;
@@ -53,16 +56,21 @@ public:
   typedef std::pair<ConversionPathType, unsigned int> ConversionPathAndCostType;
   typedef std::vector<ConversionPathAndCostType> ConversionPathAndCostListType;
 
+  /// Representations created by a conversion, for each representation name (first) stores the representation object (second)
+  typedef std::map<std::string, vtkSmartPointer<vtkDataObject> > RepresentationMapType;
+
   /// Default representation types
   /// In binary and fractional labelmaps values <=0 are considered background voxels (outside), values>0 are foreground (inside).
   static const char* GetSegmentationBinaryLabelmapRepresentationName()     { return "Binary labelmap"; };
   static const char* GetSegmentationFractionalLabelmapRepresentationName() { return "Fractional labelmap"; };
   static const char* GetSegmentationPlanarContourRepresentationName()      { return "Planar contour"; };
   static const char* GetSegmentationClosedSurfaceRepresentationName()      { return "Closed surface"; };
+  static const char* GetSegmentationSparseLabelmapRepresentationName()     { return "Sparse labelmap"; };
   static const char* GetBinaryLabelmapRepresentationName()     { return GetSegmentationBinaryLabelmapRepresentationName(); };
   static const char* GetFractionalLabelmapRepresentationName() { return GetSegmentationFractionalLabelmapRepresentationName(); };
   static const char* GetPlanarContourRepresentationName()      { return GetSegmentationPlanarContourRepresentationName(); };
   static const char* GetClosedSurfaceRepresentationName()      { return GetSegmentationClosedSurfaceRepresentationName(); };
+  static const char* GetSparseLabelmapRepresentationName()     { return GetSegmentationSparseLabelmapRepresentationName(); };
 
   // Common conversion parameters
   // ----------------------------
@@ -122,6 +130,43 @@ public:
   /// Non-linear: calculate new extents and change only the extents
   void ApplyTransformOnReferenceImageGeometry(vtkAbstractTransform* transform);
 
+  /// Maximum memory used by the conversion result cache, in megabytes. 0 disables the cache.
+  /// The cache stores copies of the representations created from the master representation of a segment,
+  /// so that switching back to previously used conversion parameters (for example surface smoothing factor)
+  /// or repeating a forced conversion does not need to run the conversion again. Default is 256.
+  virtual void SetConversionCacheMemoryBudget(unsigned long budgetMB);
+  vtkGetMacro(ConversionCacheMemoryBudget, unsigned long);
+
+  /// Get memory currently used by the conversion result cache, in kibibytes
+  vtkGetMacro(ConversionCacheMemorySize, unsigned long);
+
+  /// Get number of conversion results currently stored in the cache
+  int GetNumberOfCachedConversionResults() { return static_cast<int>(this->ConversionCache.size()); };
+
+  /// Remove all results from the conversion result cache
+  void ClearConversionCache();
+
+  /// Return true if results of the conversion path can be stored in the conversion result cache.
+  /// Requires enabled cache and cacheable rules (\sa vtkSegmentationConverterRule::IsConversionResultCacheable).
+  bool IsConversionPathCacheable(const ConversionPathType& path);
+
+  /// Get the key identifying a conversion path and its current conversion parameters in the conversion result cache
+  std::string GetConversionCacheKey(const ConversionPathType& path);
+
+  /// Get representations previously created from the given source representation of the segment
+  /// with the conversion described in the cache key.
+  /// The source representation must not have been modified since the result was stored.
+  /// \param representations Cached representation objects. They must not be modified, copy them into the segment instead.
+  /// \return True if the conversion result was found in the cache
+  bool GetCachedConversionResult(vtkSegment* segment, vtkDataObject* sourceRepresentation,
+    const std::string& conversionCacheKey, RepresentationMapType& representations);
+
+  /// Store representations created from the given source representation of the segment in the conversion result cache.
+  /// The cache takes ownership of the representation objects, so they must not be modified after calling this method.
+  /// Least recently used results are removed if the memory budget is exceeded.
+  void AddConversionResultToCache(vtkSegment* segment, vtkDataObject* sourceRepresentation,
+    const std::string& conversionCacheKey, const RepresentationMapType& representations);
+
 // Utility functions
 public:
   /// Return cheapest path from a list of paths with costs
@@ -167,6 +212,10 @@ protected:
   ///   the set is not empty).
   void FindPath(const std::string& sourceRepresentationName, const std::string& targetRepresentationName, ConversionPathAndCostListType &pathsCosts, std::set<std::string>& skipRepresentations);
 
+  /// Remove results of deleted or modified source representations and least recently used results
+  /// until the cache fits in the given memory size (in kibibytes)
+  void PruneConversionCache(unsigned long maximumMemorySizeKB);
+
 protected:
   vtkSegmentationConverter();
   ~vtkSegmentationConverter() override;
@@ -185,6 +234,28 @@ protected:
   /// Source representation to target representation rule graph
   RepresentationToRepresentationToRuleMapType RulesGraph;
 
+  /// Entry of the conversion result cache
+  struct ConversionCacheEntryType
+    {
+    vtkWeakPointer<vtkSegment> Segment;
+    vtkWeakPointer<vtkDataObject> SourceRepresentation;
+    vtkMTimeType SourceRepresentationMTime{0};
+    int LabelValue{0};
+    std::string ConversionCacheKey;
+    RepresentationMapType Representations;
+    unsigned long MemorySize{0}; // kibibytes
+    unsigned long LastUsed{0};
+    };
+
+  /// Conversion result cache
+  std::vector<ConversionCacheEntryType> ConversionCache;
+  /// Counter used for determining the least recently used cache entry
+  unsigned long ConversionCacheCounter{0};
+  /// Memory used by the cache entries, in kibibytes
+  unsigned long ConversionCacheMemorySize{0};
+  /// Maximum memory used by the cache, in megabytes
+  unsigned long ConversionCacheMemoryBudget{256};
+
 private:
   vtkSegmentationConverter(const vtkSegmentationConverter&) = delete;
   void operator=(const vtkSegmentationConverter&) = delete;
@@ -87,7 +87,13 @@ void vtkSegmentationConverterRule::SetConversionParameter(const std::string& nam
 //----------------------------------------------------------------------------
 std::string vtkSegmentationConverterRule::GetConversionParameter(const std::string& name)
 {
-  return this->ConversionParameters[name].first;
+  // Parameters are not added here, so that the method can be called concurrently during conversion
+  ConversionParameterListType::const_iterator parameterIt = this->ConversionParameters.find(name);
+  if (parameterIt == this->ConversionParameters.end())
+    {
+    return "";
+    }
+  return parameterIt->second.first;
 }
 
 //----------------------------------------------------------------------------
@@ -92,10 +92,32 @@ public:
   /// \sa ConvertInternal
   virtual bool Convert(vtkSegment* segment) = 0;
 
+  /// Update the target representation after the source representation was modified only within
+  /// the given extent (IJK extent of the source image, for labelmap representations).
+  /// Rules that can update the target representation incrementally override this method,
+  /// the default implementation converts the whole segment.
+  virtual bool ConvertModifiedRegion(vtkSegment* segment, const int vtkNotUsed(modifiedExtent)[6]) { return this->Convert(segment); };
+
   /// Perform post-conversion steps across the specified segments in the segmentation
   /// This step should be unneccessary if only converting a single segment
   virtual bool PostConvert(vtkSegmentation* vtkNotUsed(segmentation)) { return true; };
 
+  /// Return true if Convert can be called concurrently from multiple threads for segments that
+  /// do not share their source representation object (segments that share a binary labelmap are
+  /// always converted on the same thread, in sequence).
+  /// Target representations are created on the main thread before the concurrent conversion
+  /// (\sa CreateTargetRepresentation), therefore Convert of a thread-safe rule must not add or
+  /// replace representations of the segment, must not invoke events, and must only read the
+  /// conversion parameters. False by default.
+  virtual bool IsThreadSafe() { return false; };
+
+  /// Return true if the target representation of a segment only depends on the source representation
+  /// and label value of the same segment and on the conversion parameters. Results of such rules can be
+  /// stored in the conversion result cache of the converter (\sa vtkSegmentationConverter::GetCachedConversionResult).
+  /// Rules that post-process the target representations of all segments together (for example by
+  /// collapsing them into shared labelmaps) must return false. True by default.
+  virtual bool IsConversionResultCacheable() { return true; };
+
   /// Get the cost of the conversion.
   /// \return Expected duration of the conversion in milliseconds. If the arguments are omitted, then a rough average can be
   ///   given just to indicate the relative computational cost of the algorithm. If the objects are given, then a more educated
@@ -155,6 +177,7 @@ protected:
   bool ReplaceTargetRepresentation{false};
 
   friend class vtkSegmentationConverter;
+  friend class vtkSegmentation;
 };
 
 #endif // __vtkSegmentationConverterRule_h
@@ -22,14 +22,106 @@
 #include "vtkSegmentationHistory.h"
 #include "vtkSegmentationConverterFactory.h"
 #include "vtkSegmentation.h"
+#include "vtkOrientedImageData.h"
 
 // VTK includes
 #include <vtkNew.h>
 #include <vtkObjectFactory.h>
 #include <vtkCallbackCommand.h>
+#include <vtkPointData.h>
+#include <vtkSMPTools.h>
 
 // std includes
 #include <algorithm>
+#include <cstring>
+#include <limits>
+#include <set>
+
+namespace
+{
+
+typedef unsigned int RunLengthType;
+
+//----------------------------------------------------------------------------
+template <class T>
+void EncodeSlicesGeneric(const T* scalars, vtkIdType numberOfVoxelsPerSlice, vtkIdType numberOfSlices,
+  std::vector<unsigned char>& data, std::vector<size_t>& sliceOffsets)
+{
+  // Slices are encoded in parallel into separate buffers, then concatenated in slice order
+  std::vector<std::vector<unsigned char> > sliceData(numberOfSlices);
+  vtkSMPTools::For(0, numberOfSlices, [&](vtkIdType beginSlice, vtkIdType endSlice)
+    {
+    for (vtkIdType slice = beginSlice; slice < endSlice; ++slice)
+      {
+      std::vector<unsigned char>& encoded = sliceData[slice];
+      const T* voxelPtr = scalars + slice * numberOfVoxelsPerSlice;
+      const T* sliceEndPtr = voxelPtr + numberOfVoxelsPerSlice;
+      while (voxelPtr < sliceEndPtr)
+        {
+        T value = *voxelPtr;
+        const T* runEndPtr = voxelPtr + 1;
+        vtkIdType maximumRunLength = std::min<vtkIdType>(sliceEndPtr - voxelPtr, std::numeric_limits<RunLengthType>::max());
+        while (runEndPtr < voxelPtr + maximumRunLength && *runEndPtr == value)
+          {
+          ++runEndPtr;
+          }
+        RunLengthType runLength = static_cast<RunLengthType>(runEndPtr - voxelPtr);
+        size_t position = encoded.size();
+        encoded.resize(position + sizeof(RunLengthType) + sizeof(T));
+        memcpy(&encoded[position], &runLength, sizeof(RunLengthType));
+        memcpy(&encoded[position + sizeof(RunLengthType)], &value, sizeof(T));
+        voxelPtr = runEndPtr;
+        }
+      }
+    });
+
+  size_t dataSize = 0;
+  sliceOffsets.resize(numberOfSlices);
+  for (vtkIdType slice = 0; slice < numberOfSlices; ++slice)
+    {
+    sliceOffsets[slice] = dataSize;
+    dataSize += sliceData[slice].size();
+    }
+  data.resize(dataSize);
+  vtkSMPTools::For(0, numberOfSlices, [&](vtkIdType beginSlice, vtkIdType endSlice)
+    {
+    for (vtkIdType slice = beginSlice; slice < endSlice; ++slice)
+      {
+      if (!sliceData[slice].empty())
+        {
+        memcpy(&data[sliceOffsets[slice]], &sliceData[slice][0], sliceData[slice].size());
+        }
+      }
+    });
+}
+
+//----------------------------------------------------------------------------
+template <class T>
+void DecodeSlicesGeneric(T* scalars, vtkIdType numberOfVoxelsPerSlice, vtkIdType numberOfSlices,
+  const std::vector<unsigned char>& data, const std::vector<size_t>& sliceOffsets)
+{
+  vtkSMPTools::For(0, numberOfSlices, [&](vtkIdType beginSlice, vtkIdType endSlice)
+    {
+    for (vtkIdType slice = beginSlice; slice < endSlice; ++slice)
+      {
+      T* voxelPtr = scalars + slice * numberOfVoxelsPerSlice;
+      T* sliceEndPtr = voxelPtr + numberOfVoxelsPerSlice;
+      size_t position = sliceOffsets[slice];
+      while (voxelPtr < sliceEndPtr)
+        {
+        RunLengthType runLength = 0;
+        T value = 0;
+        memcpy(&runLength, &data[position], sizeof(RunLengthType));
+        memcpy(&value, &data[position + sizeof(RunLengthType)], sizeof(T));
+        position += sizeof(RunLengthType) + sizeof(T);
+        std::fill(voxelPtr, voxelPtr + runLength, value);
+        voxelPtr += runLength;
+        }
+      }
+    });
+}
+
+} // end of anonymous namespace
 
 //----------------------------------------------------------------------------
 vtkStandardNewMacro(vtkSegmentationHistory);
@@ -40,6 +132,7 @@ vtkSegmentationHistory::vtkSegmentationHistory()
   this->Segmentation = nullptr;
 
   this->MaximumNumberOfStates = 5;
+  this->MaximumMemorySizeMB = 0;
 
   this->LastRestoredState = 0;
   this->RestoreStateInProgress = false;
@@ -98,6 +191,8 @@ void vtkSegmentationHistory::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "Modified Time: " << this->GetMTime() << "\n";
 
   os << indent << "Number of saved states:  " << this->SegmentationStates.size() << "\n";
+  os << indent << "MaximumNumberOfStates:  " << this->MaximumNumberOfStates << "\n";
+  os << indent << "MaximumMemorySizeMB:  " << this->MaximumMemorySizeMB << "\n";
 }
 
 //---------------------------------------------------------------------------
@@ -143,6 +238,7 @@ bool vtkSegmentationHistory::SaveState()
         }
       }
 
+    this->CompressLabelmapRepresentations(segment, baselineSegment, savedObjects, newSegmentationState);
     vtkSmartPointer<vtkSegment> segmentClone = vtkSmartPointer<vtkSegment>::New();
     vtkSegmentation::CopySegment(segmentClone, segment, baselineSegment, savedObjects);
     newSegmentationState.Segments[*segmentIDIt] = segmentClone;
@@ -185,6 +281,11 @@ bool vtkSegmentationHistory::RestorePreviousState()
     // this->SegmentationStates.size() - 2 is the state that was the last saved state before
     stateToRestore = (int)this->SegmentationStates.size() - 2;
     }
+  if (stateToRestore < 0)
+    {
+    vtkWarningMacro("vtkSegmentation::RestorePreviousState failed: There are no previous state available for restore");
+    return false;
+    }
   return this->RestoreState(stateToRestore);
 }
 
@@ -213,6 +314,18 @@ bool vtkSegmentationHistory::RestoreState(unsigned int stateIndex)
 
   std::set<std::string> segmentIDsToKeep;
   std::map<vtkDataObject*, vtkDataObject*> restoredRepresentations;
+
+  // Decompress labelmaps. Geometry objects are mapped to the decompressed labelmaps,
+  // so that CopySegment uses them directly instead of copying.
+  std::vector<vtkSmartPointer<vtkOrientedImageData> > decompressedLabelmaps;
+  for (CompressedLabelmapsMap::iterator compressedIt = restoredState.CompressedLabelmaps.begin();
+    compressedIt != restoredState.CompressedLabelmaps.end(); ++compressedIt)
+    {
+    vtkSmartPointer<vtkOrientedImageData> labelmap = vtkSmartPointer<vtkOrientedImageData>::New();
+    vtkSegmentationHistory::DecompressLabelmap(*compressedIt->second, labelmap);
+    decompressedLabelmaps.push_back(labelmap);
+    restoredRepresentations[compressedIt->first] = labelmap;
+    }
   for (SegmentsMap::iterator restoredSegmentsIt = restoredState.Segments.begin();
     restoredSegmentsIt != restoredState.Segments.end(); ++restoredSegmentsIt)
     {
@@ -307,6 +420,19 @@ void vtkSegmentationHistory::RemoveAllObsoleteStates()
     this->LastRestoredState--;
     modified = true;
    }
+  if (this->MaximumMemorySizeMB > 0)
+    {
+    vtkIdType maximumMemorySizeKB = static_cast<vtkIdType>(this->MaximumMemorySizeMB) * 1024;
+    while (this->SegmentationStates.size() > 2 && this->GetMemorySizeKB() > maximumMemorySizeKB)
+      {
+      this->SegmentationStates.pop_front();
+      if (this->LastRestoredState > 0)
+        {
+        this->LastRestoredState--;
+        }
+      modified = true;
+      }
+    }
   if (modified)
     {
     this->Modified();
@@ -325,6 +451,161 @@ void vtkSegmentationHistory::SetMaximumNumberOfStates(unsigned int maximumNumber
   this->Modified();
 }
 
+//---------------------------------------------------------------------------
+void vtkSegmentationHistory::SetMaximumMemorySizeMB(unsigned int maximumMemorySizeMB)
+{
+  if (maximumMemorySizeMB == this->MaximumMemorySizeMB)
+    {
+    return;
+    }
+  this->MaximumMemorySizeMB = maximumMemorySizeMB;
+  this->RemoveAllObsoleteStates();
+  this->Modified();
+}
+
+//---------------------------------------------------------------------------
+vtkIdType vtkSegmentationHistory::GetMemorySizeKB()
+{
+  std::set<vtkDataObject*> countedRepresentations;
+  std::set<CompressedLabelmap*> countedCompressedLabelmaps;
+  vtkIdType memorySizeKB = 0;
+  size_t compressedMemorySizeBytes = 0;
+  for (std::deque<SegmentationState>::iterator stateIt = this->SegmentationStates.begin();
+    stateIt != this->SegmentationStates.end(); ++stateIt)
+    {
+    for (CompressedLabelmapsMap::iterator compressedIt = stateIt->CompressedLabelmaps.begin();
+      compressedIt != stateIt->CompressedLabelmaps.end(); ++compressedIt)
+      {
+      countedRepresentations.insert(compressedIt->first);
+      if (countedCompressedLabelmaps.insert(compressedIt->second.get()).second)
+        {
+        compressedMemorySizeBytes += compressedIt->second->Data.size()
+          + compressedIt->second->SliceOffsets.size() * sizeof(size_t);
+        }
+      }
+    for (SegmentsMap::iterator segmentIt = stateIt->Segments.begin(); segmentIt != stateIt->Segments.end(); ++segmentIt)
+      {
+      std::vector<std::string> representationNames;
+      segmentIt->second->GetContainedRepresentationNames(representationNames);
+      for (const std::string& representationName : representationNames)
+        {
+        vtkDataObject* representation = segmentIt->second->GetRepresentation(representationName);
+        if (representation && countedRepresentations.insert(representation).second)
+          {
+          memorySizeKB += representation->GetActualMemorySize();
+          }
+        }
+      }
+    }
+  return memorySizeKB + static_cast<vtkIdType>(compressedMemorySizeBytes / 1024);
+}
+
+//---------------------------------------------------------------------------
+void vtkSegmentationHistory::CompressLabelmapRepresentations(vtkSegment* segment, vtkSegment* baselineSegment,
+  std::map<vtkDataObject*, vtkDataObject*>& savedObjects, SegmentationState& state)
+{
+  std::vector<std::string> representationNames;
+  segment->GetContainedRepresentationNames(representationNames);
+  for (const std::string& representationName : representationNames)
+    {
+    vtkOrientedImageData* labelmap = vtkOrientedImageData::SafeDownCast(segment->GetRepresentation(representationName));
+    if (!labelmap || savedObjects.find(labelmap) != savedObjects.end())
+      {
+      // Not a labelmap or already saved (shared labelmap)
+      continue;
+      }
+
+    vtkDataObject* baselineRepresentation = nullptr;
+    if (baselineSegment)
+      {
+      baselineRepresentation = baselineSegment->GetRepresentation(representationName);
+      }
+    if (baselineRepresentation != nullptr
+      && baselineRepresentation->GetMTime() > labelmap->GetMTime())
+      {
+      // Labelmap is not changed since the last state, reuse its compressed content
+      CompressedLabelmapsMap& baselineCompressedLabelmaps = this->SegmentationStates.back().CompressedLabelmaps;
+      CompressedLabelmapsMap::iterator baselineCompressedIt = baselineCompressedLabelmaps.find(baselineRepresentation);
+      if (baselineCompressedIt != baselineCompressedLabelmaps.end())
+        {
+        state.CompressedLabelmaps[baselineRepresentation] = baselineCompressedIt->second;
+        savedObjects[labelmap] = baselineRepresentation;
+        }
+      // else the baseline is an uncompressed copy, which CopySegment reuses
+      continue;
+      }
+
+    std::shared_ptr<CompressedLabelmap> compressedLabelmap = std::make_shared<CompressedLabelmap>();
+    if (!vtkSegmentationHistory::CompressLabelmap(labelmap, *compressedLabelmap))
+      {
+      // CopySegment stores a full copy
+      continue;
+      }
+    state.CompressedLabelmaps[compressedLabelmap->Geometry] = compressedLabelmap;
+    savedObjects[labelmap] = compressedLabelmap->Geometry;
+    }
+}
+
+//---------------------------------------------------------------------------
+bool vtkSegmentationHistory::CompressLabelmap(vtkOrientedImageData* labelmap, CompressedLabelmap& compressedLabelmap)
+{
+  vtkDataArray* scalars = labelmap->GetPointData()->GetScalars();
+  if (!scalars || scalars->GetNumberOfComponents() != 1
+    || scalars->GetNumberOfTuples() != labelmap->GetNumberOfPoints())
+    {
+    return false;
+    }
+
+  int* extent = labelmap->GetExtent();
+  vtkIdType numberOfSlices = 0;
+  vtkIdType numberOfVoxelsPerSlice = 0;
+  if (extent[0] <= extent[1] && extent[2] <= extent[3] && extent[4] <= extent[5])
+    {
+    numberOfSlices = extent[5] - extent[4] + 1;
+    numberOfVoxelsPerSlice = static_cast<vtkIdType>(extent[1] - extent[0] + 1) * (extent[3] - extent[2] + 1);
+    }
+
+  compressedLabelmap.ScalarType = scalars->GetDataType();
+  switch (compressedLabelmap.ScalarType)
+    {
+    vtkTemplateMacro(EncodeSlicesGeneric<VTK_TT>(static_cast<VTK_TT*>(scalars->GetVoidPointer(0)),
+      numberOfVoxelsPerSlice, numberOfSlices, compressedLabelmap.Data, compressedLabelmap.SliceOffsets));
+    default:
+      return false;
+    }
+
+  compressedLabelmap.Geometry = vtkSmartPointer<vtkOrientedImageData>::New();
+  compressedLabelmap.Geometry->SetExtent(extent);
+  compressedLabelmap.Geometry->SetOrigin(labelmap->GetOrigin());
+  compressedLabelmap.Geometry->SetSpacing(labelmap->GetSpacing());
+  compressedLabelmap.Geometry->CopyDirections(labelmap);
+  return true;
+}
+
+//---------------------------------------------------------------------------
+void vtkSegmentationHistory::DecompressLabelmap(const CompressedLabelmap& compressedLabelmap, vtkOrientedImageData* labelmap)
+{
+  vtkOrientedImageData* geometry = compressedLabelmap.Geometry;
+  labelmap->SetExtent(geometry->GetExtent());
+  labelmap->SetOrigin(geometry->GetOrigin());
+  labelmap->SetSpacing(geometry->GetSpacing());
+  labelmap->CopyDirections(geometry);
+  labelmap->AllocateScalars(compressedLabelmap.ScalarType, 1);
+
+  int* extent = labelmap->GetExtent();
+  vtkIdType numberOfSlices = static_cast<vtkIdType>(compressedLabelmap.SliceOffsets.size());
+  vtkIdType numberOfVoxelsPerSlice = 0;
+  if (numberOfSlices > 0)
+    {
+    numberOfVoxelsPerSlice = static_cast<vtkIdType>(extent[1] - extent[0] + 1) * (extent[3] - extent[2] + 1);
+    }
+  switch (compressedLabelmap.ScalarType)
+    {
+    vtkTemplateMacro(DecodeSlicesGeneric<VTK_TT>(static_cast<VTK_TT*>(labelmap->GetScalarPointer()),
+      numberOfVoxelsPerSlice, numberOfSlices, compressedLabelmap.Data, compressedLabelmap.SliceOffsets));
+    }
+}
+
 //---------------------------------------------------------------------------
 void vtkSegmentationHistory::OnSegmentationModified(vtkObject* vtkNotUsed(caller),
   unsigned long vtkNotUsed(eid),
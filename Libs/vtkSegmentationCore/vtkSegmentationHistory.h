@@ -28,16 +28,23 @@
 // STD includes
 #include <deque>
 #include <map>
+#include <memory>
 #include <vector>
 
 #include "vtkSegmentationCoreConfigure.h"
 
 class vtkCallbackCommand;
 class vtkDataObject;
+class vtkOrientedImageData;
 class vtkSegment;
 class vtkSegmentation;
 
 /// \ingroup SegmentationCore
+/// \brief Store states of a segmentation for undo/redo.
+///
+/// Labelmap representations are stored run-length encoded, which typically reduces
+/// the memory need of a state by orders of magnitude. Representations that are not
+/// changed between states are shared between the states.
 class vtkSegmentationCore_EXPORT vtkSegmentationHistory : public vtkObject
 {
 public:
@@ -83,6 +90,18 @@ public:
   /// Get the limit of how many states may be stored.
   vtkGetMacro(MaximumNumberOfStates, unsigned int);
 
+  /// Limits how much memory the stored states may use, in megabytes. 0 means no limit (default).
+  /// If the limit is exceeded then the oldest states are removed. The two most recent states
+  /// are always kept, so that the last operation can be undone.
+  void SetMaximumMemorySizeMB(unsigned int maximumMemorySizeMB);
+
+  /// Get the limit of how much memory the stored states may use, in megabytes.
+  vtkGetMacro(MaximumMemorySizeMB, unsigned int);
+
+  /// Get the memory used by all stored states, in kilobytes.
+  /// Data shared between states is only counted once.
+  vtkIdType GetMemorySizeKB();
+
   /// Get the current number of states.
   int GetNumberOfStates();
 
@@ -95,6 +114,7 @@ protected:
   void RemoveAllNextStates();
 
   /// Delete all old states so that we keep only up to MaximumNumberOfStates states
+  /// and the memory usage remains below MaximumMemorySizeMB
   void RemoveAllObsoleteStates();
 
   /// Restores a state defined by stateIndex.
@@ -106,16 +126,46 @@ protected:
 
   typedef std::map<std::string, vtkSmartPointer<vtkSegment> > SegmentsMap;
 
+  /// Run-length encoded content of a labelmap representation
+  struct CompressedLabelmap
+    {
+    /// Representation object stored in the state in place of the labelmap.
+    /// It only contains the geometry of the labelmap, without scalars.
+    vtkSmartPointer<vtkOrientedImageData> Geometry;
+    int ScalarType;
+    /// Encoded runs (run length followed by value) of all slices
+    std::vector<unsigned char> Data;
+    /// Start position of each slice in Data
+    std::vector<size_t> SliceOffsets;
+    };
+  /// Compressed labelmaps, indexed by their geometry object that is stored in the segments
+  typedef std::map<vtkDataObject*, std::shared_ptr<CompressedLabelmap> > CompressedLabelmapsMap;
+
   struct SegmentationState
     {
     SegmentsMap Segments;
     std::vector<std::string> SegmentIds; // order of segments
+    CompressedLabelmapsMap CompressedLabelmaps;
     };
 
+  /// Compress labelmap representations of a segment into the state and register the geometry objects
+  /// that replace them in savedObjects, so that vtkSegmentation::CopySegment does not copy the full labelmaps.
+  /// Up-to-date compressed labelmaps of the baseline segment (in the last stored state) are reused.
+  void CompressLabelmapRepresentations(vtkSegment* segment, vtkSegment* baselineSegment,
+    std::map<vtkDataObject*, vtkDataObject*>& savedObjects, SegmentationState& state);
+
+  /// Run-length encode a single-component labelmap
+  /// \return False if the labelmap cannot be compressed
+  static bool CompressLabelmap(vtkOrientedImageData* labelmap, CompressedLabelmap& compressedLabelmap);
+
+  /// Restore labelmap from its compressed content
+  static void DecompressLabelmap(const CompressedLabelmap& compressedLabelmap, vtkOrientedImageData* labelmap);
+
   vtkSegmentation* Segmentation;
   vtkCallbackCommand* SegmentationModifiedCallbackCommand;
   std::deque<SegmentationState> SegmentationStates;
   unsigned int MaximumNumberOfStates;
+  unsigned int MaximumMemorySizeMB;
 
   // Index of the state in SegmentationStates that was restored last.
   // If index == size of states then it means that the segmentation has changed
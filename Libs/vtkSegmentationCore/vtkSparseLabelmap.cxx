@@ -0,0 +1,723 @@
+/*==============================================================================
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// SegmentationCore includes
+#include "vtkSparseLabelmap.h"
+#include "vtkOrientedImageData.h"
+#include "vtkOrientedImageDataResample.h"
+
+// VTK includes
+#include <vtkMatrix4x4.h>
+#include <vtkNew.h>
+#include <vtkObjectFactory.h>
+#include <vtkPointData.h>
+
+// STD includes
+#include <algorithm>
+#include <cstring>
+#include <set>
+
+vtkStandardNewMacro(vtkSparseLabelmap);
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+bool IsExtentEmpty(const int extent[6])
+{
+  return extent[0] > extent[1] || extent[2] > extent[3] || extent[4] > extent[5];
+}
+
+//----------------------------------------------------------------------------
+template <class T>
+void EncodeImageGeneric(T* imagePtr, const int extent[6], int labelValue,
+  std::vector<vtkIdType>& rowOffsets, std::vector<vtkSparseLabelmap::RunType>& runs)
+{
+  int dimI = extent[1] - extent[0] + 1;
+  int dimJ = extent[3] - extent[2] + 1;
+  int dimK = extent[5] - extent[4] + 1;
+  rowOffsets.reserve(static_cast<size_t>(dimJ) * dimK + 1);
+  rowOffsets.push_back(0);
+  T* rowPtr = imagePtr;
+  for (int k = 0; k < dimK; ++k)
+    {
+    for (int j = 0; j < dimJ; ++j, rowPtr += dimI)
+      {
+      int i = 0;
+      while (i < dimI)
+        {
+        int label = static_cast<int>(rowPtr[i]);
+        if (label == 0 || (labelValue != 0 && label != labelValue))
+          {
+          ++i;
+          continue;
+          }
+        int start = i;
+        while (i < dimI && static_cast<int>(rowPtr[i]) == label)
+          {
+          ++i;
+          }
+        vtkSparseLabelmap::RunType run = { extent[0] + start, i - start, label };
+        runs.push_back(run);
+        }
+      rowOffsets.push_back(static_cast<vtkIdType>(runs.size()));
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+template <class T>
+void DecodeImageGeneric(T* imagePtr, const int extent[6], int fillValue,
+  const std::vector<vtkIdType>& rowOffsets, const std::vector<vtkSparseLabelmap::RunType>& runs)
+{
+  vtkIdType dimI = extent[1] - extent[0] + 1;
+  vtkIdType numberOfRows = static_cast<vtkIdType>(rowOffsets.size()) - 1;
+  for (vtkIdType row = 0; row < numberOfRows; ++row)
+    {
+    T* rowPtr = imagePtr + row * dimI;
+    for (vtkIdType runIndex = rowOffsets[row]; runIndex < rowOffsets[row + 1]; ++runIndex)
+      {
+      const vtkSparseLabelmap::RunType& run = runs[runIndex];
+      T value = static_cast<T>(fillValue != 0 ? fillValue : run.Label);
+      std::fill(rowPtr + (run.Start - extent[0]), rowPtr + (run.Start - extent[0] + run.Length), value);
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+/// Combine a row of base runs with a row of modifier runs. Voxels in [domainStart, domainEnd]
+/// are set to operation(base, modifier), other voxels keep the base label.
+/// The result is sorted and adjacent runs with the same label are merged.
+void CombineRow(const vtkSparseLabelmap::RunType* baseRun, const vtkSparseLabelmap::RunType* baseEnd,
+  const vtkSparseLabelmap::RunType* modifierRun, const vtkSparseLabelmap::RunType* modifierEnd,
+  int domainStart, int domainEnd, const std::function<int(int,int)>& operation,
+  std::vector<int>& breaks, std::vector<vtkSparseLabelmap::RunType>& outputRuns)
+{
+  // Collect all positions where either input changes value
+  breaks.clear();
+  for (const vtkSparseLabelmap::RunType* run = baseRun; run != baseEnd; ++run)
+    {
+    breaks.push_back(run->Start);
+    breaks.push_back(run->Start + run->Length);
+    }
+  for (const vtkSparseLabelmap::RunType* run = modifierRun; run != modifierEnd; ++run)
+    {
+    breaks.push_back(run->Start);
+    breaks.push_back(run->Start + run->Length);
+    }
+  breaks.push_back(domainStart);
+  breaks.push_back(domainEnd + 1);
+  std::sort(breaks.begin(), breaks.end());
+  breaks.erase(std::unique(breaks.begin(), breaks.end()), breaks.end());
+
+  size_t firstOutputRun = outputRuns.size();
+  for (size_t breakIndex = 0; breakIndex + 1 < breaks.size(); ++breakIndex)
+    {
+    // Both inputs are constant in [start, end)
+    int start = breaks[breakIndex];
+    int end = breaks[breakIndex + 1];
+    while (baseRun != baseEnd && baseRun->Start + baseRun->Length <= start)
+      {
+      ++baseRun;
+      }
+    while (modifierRun != modifierEnd && modifierRun->Start + modifierRun->Length <= start)
+      {
+      ++modifierRun;
+      }
+    int baseLabel = (baseRun != baseEnd && baseRun->Start <= start) ? baseRun->Label : 0;
+    int modifierLabel = (modifierRun != modifierEnd && modifierRun->Start <= start) ? modifierRun->Label : 0;
+    int label = (start >= domainStart && start <= domainEnd) ? operation(baseLabel, modifierLabel) : baseLabel;
+    if (label == 0)
+      {
+      continue;
+      }
+    if (outputRuns.size() > firstOutputRun && outputRuns.back().Label == label
+      && outputRuns.back().Start + outputRuns.back().Length == start)
+      {
+      outputRuns.back().Length += end - start;
+      }
+    else
+      {
+      vtkSparseLabelmap::RunType run = { start, end - start, label };
+      outputRuns.push_back(run);
+      }
+    }
+}
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+vtkSparseLabelmap::vtkSparseLabelmap()
+{
+  this->Extent[0] = 0;
+  this->Extent[1] = -1;
+  this->Extent[2] = 0;
+  this->Extent[3] = -1;
+  this->Extent[4] = 0;
+  this->Extent[5] = -1;
+  for (int i = 0; i < 3; ++i)
+    {
+    this->Origin[i] = 0.0;
+    this->Spacing[i] = 1.0;
+    for (int j = 0; j < 3; ++j)
+      {
+      this->Directions[i][j] = (i == j ? 1.0 : 0.0);
+      }
+    }
+  this->RowOffsets.push_back(0);
+}
+
+//----------------------------------------------------------------------------
+vtkSparseLabelmap::~vtkSparseLabelmap() = default;
+
+//----------------------------------------------------------------------------
+void vtkSparseLabelmap::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+
+  os << indent << "Extent: " << this->Extent[0] << " " << this->Extent[1] << " " << this->Extent[2]
+    << " " << this->Extent[3] << " " << this->Extent[4] << " " << this->Extent[5] << "\n";
+  os << indent << "Origin: " << this->Origin[0] << " " << this->Origin[1] << " " << this->Origin[2] << "\n";
+  os << indent << "Spacing: " << this->Spacing[0] << " " << this->Spacing[1] << " " << this->Spacing[2] << "\n";
+  os << indent << "Directions:\n";
+  for (int j = 0; j < 3; ++j)
+    {
+    os << indent.GetNextIndent() << this->Directions[j][0] << " " << this->Directions[j][1] << " " << this->Directions[j][2] << "\n";
+    }
+  os << indent << "NumberOfRuns: " << this->Runs.size() << "\n";
+}
+
+//----------------------------------------------------------------------------
+void vtkSparseLabelmap::Initialize()
+{
+  this->Superclass::Initialize();
+  int emptyExtent[6] = { 0, -1, 0, -1, 0, -1 };
+  this->SetExtent(emptyExtent);
+}
+
+//----------------------------------------------------------------------------
+void vtkSparseLabelmap::ShallowCopy(vtkDataObject* src)
+{
+  vtkSparseLabelmap* labelmap = vtkSparseLabelmap::SafeDownCast(src);
+  if (labelmap)
+    {
+    std::copy(labelmap->Extent, labelmap->Extent + 6, this->Extent);
+    std::copy(labelmap->Origin, labelmap->Origin + 3, this->Origin);
+    std::copy(labelmap->Spacing, labelmap->Spacing + 3, this->Spacing);
+    this->SetDirections(labelmap->Directions);
+    this->RowOffsets = labelmap->RowOffsets;
+    this->Runs = labelmap->Runs;
+    }
+  this->Superclass::ShallowCopy(src);
+}
+
+//----------------------------------------------------------------------------
+void vtkSparseLabelmap::DeepCopy(vtkDataObject* src)
+{
+  vtkSparseLabelmap* labelmap = vtkSparseLabelmap::SafeDownCast(src);
+  if (labelmap)
+    {
+    std::copy(labelmap->Extent, labelmap->Extent + 6, this->Extent);
+    std::copy(labelmap->Origin, labelmap->Origin + 3, this->Origin);
+    std::copy(labelmap->Spacing, labelmap->Spacing + 3, this->Spacing);
+    this->SetDirections(labelmap->Directions);
+    this->RowOffsets = labelmap->RowOffsets;
+    this->Runs = labelmap->Runs;
+    }
+  this->Superclass::DeepCopy(src);
+}
+
+//----------------------------------------------------------------------------
+unsigned long vtkSparseLabelmap::GetActualMemorySize()
+{
+  size_t size = this->RowOffsets.capacity() * sizeof(vtkIdType) + this->Runs.capacity() * sizeof(RunType);
+  return this->Superclass::GetActualMemorySize() + static_cast<unsigned long>(size / 1024);
+}
+
+//----------------------------------------------------------------------------
+void vtkSparseLabelmap::CopyGeometryFromImage(vtkOrientedImageData* image)
+{
+  if (!image)
+    {
+    vtkErrorMacro("CopyGeometryFromImage: Invalid input image");
+    return;
+    }
+  image->GetOrigin(this->Origin);
+  image->GetSpacing(this->Spacing);
+  image->GetDirections(this->Directions);
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkSparseLabelmap::CopyGeometryToImage(vtkOrientedImageData* image)
+{
+  if (!image)
+    {
+    vtkErrorMacro("CopyGeometryToImage: Invalid output image");
+    return;
+    }
+  image->SetOrigin(this->Origin);
+  image->SetSpacing(this->Spacing);
+  image->SetDirections(this->Directions);
+}
+
+//----------------------------------------------------------------------------
+void vtkSparseLabelmap::GetImageToWorldMatrix(vtkMatrix4x4* imageToWorldMatrix)
+{
+  if (!imageToWorldMatrix)
+    {
+    return;
+    }
+  vtkNew<vtkOrientedImageData> geometryImage;
+  this->CopyGeometryToImage(geometryImage.GetPointer());
+  geometryImage->GetImageToWorldMatrix(imageToWorldMatrix);
+}
+
+//----------------------------------------------------------------------------
+bool vtkSparseLabelmap::IsGeometryEqual(vtkSparseLabelmap* other)
+{
+  if (!other)
+    {
+    return false;
+    }
+  for (int i = 0; i < 3; ++i)
+    {
+    if (!vtkOrientedImageDataResample::AreEqualWithTolerance(this->Origin[i], other->Origin[i])
+      || !vtkOrientedImageDataResample::AreEqualWithTolerance(this->Spacing[i], other->Spacing[i]))
+      {
+      return false;
+      }
+    for (int j = 0; j < 3; ++j)
+      {
+      if (!vtkOrientedImageDataResample::AreEqualWithTolerance(this->Directions[i][j], other->Directions[i][j]))
+        {
+        return false;
+        }
+      }
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+void vtkSparseLabelmap::SetDirections(double directions[3][3])
+{
+  for (int i = 0; i < 3; ++i)
+    {
+    for (int j = 0; j < 3; ++j)
+      {
+      this->Directions[i][j] = directions[i][j];
+      }
+    }
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkSparseLabelmap::GetDirections(double directions[3][3])
+{
+  for (int i = 0; i < 3; ++i)
+    {
+    for (int j = 0; j < 3; ++j)
+      {
+      directions[i][j] = this->Directions[i][j];
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkSparseLabelmap::SetExtent(const int extent[6])
+{
+  std::copy(extent, extent + 6, this->Extent);
+  this->RowOffsets.assign(this->GetNumberOfRows() + 1, 0);
+  this->Runs.clear();
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkSparseLabelmap::GetExtent(int extent[6])
+{
+  std::copy(this->Extent, this->Extent + 6, extent);
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkSparseLabelmap::GetNumberOfRows()
+{
+  if (IsExtentEmpty(this->Extent))
+    {
+    return 0;
+    }
+  return static_cast<vtkIdType>(this->Extent[3] - this->Extent[2] + 1) * (this->Extent[5] - this->Extent[4] + 1);
+}
+
+//----------------------------------------------------------------------------
+bool vtkSparseLabelmap::SetFromImage(vtkOrientedImageData* image, int labelValue/*=0*/)
+{
+  if (!image)
+    {
+    vtkErrorMacro("SetFromImage: Invalid input image");
+    return false;
+    }
+  this->CopyGeometryFromImage(image);
+
+  int extent[6] = { 0, -1, 0, -1, 0, -1 };
+  image->GetExtent(extent);
+  if (IsExtentEmpty(extent) || !image->GetPointData() || !image->GetPointData()->GetScalars())
+    {
+    // Nothing to encode
+    this->Initialize();
+    return true;
+    }
+  if (image->GetNumberOfScalarComponents() != 1)
+    {
+    vtkErrorMacro("SetFromImage: Input image must have a single scalar component");
+    return false;
+    }
+
+  std::vector<vtkIdType> rowOffsets;
+  std::vector<RunType> runs;
+  switch (image->GetScalarType())
+    {
+    vtkTemplateMacro(EncodeImageGeneric(static_cast<VTK_TT*>(image->GetScalarPointer()), extent, labelValue, rowOffsets, runs));
+    default:
+      vtkErrorMacro("SetFromImage: Unknown image scalar type");
+      return false;
+    }
+
+  std::copy(extent, extent + 6, this->Extent);
+  this->RowOffsets.swap(rowOffsets);
+  this->Runs.swap(runs);
+  this->ShrinkToEffectiveExtent();
+  this->Modified();
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkSparseLabelmap::GetImage(vtkOrientedImageData* image, int fillValue/*=0*/)
+{
+  if (!image)
+    {
+    vtkErrorMacro("GetImage: Invalid output image");
+    return false;
+    }
+
+  int maxLabel = fillValue;
+  for (std::vector<RunType>::iterator runIt = this->Runs.begin(); runIt != this->Runs.end(); ++runIt)
+    {
+    maxLabel = std::max(maxLabel, runIt->Label);
+    }
+  int scalarType = VTK_UNSIGNED_INT;
+  if (maxLabel <= VTK_UNSIGNED_CHAR_MAX)
+    {
+    scalarType = VTK_UNSIGNED_CHAR;
+    }
+  else if (maxLabel <= VTK_UNSIGNED_SHORT_MAX)
+    {
+    scalarType = VTK_UNSIGNED_SHORT;
+    }
+
+  this->CopyGeometryToImage(image);
+  image->SetExtent(this->Extent);
+  image->AllocateScalars(scalarType, 1);
+  if (IsExtentEmpty(this->Extent))
+    {
+    return true;
+    }
+
+  void* imagePtr = image->GetScalarPointer();
+  memset(imagePtr, 0, static_cast<size_t>(image->GetNumberOfPoints()) * image->GetScalarSize());
+  switch (scalarType)
+    {
+    vtkTemplateMacro(DecodeImageGeneric(static_cast<VTK_TT*>(imagePtr), this->Extent, fillValue, this->RowOffsets, this->Runs));
+    }
+  image->Modified();
+  return true;
+}
+
+//----------------------------------------------------------------------------
+int vtkSparseLabelmap::GetLabel(int i, int j, int k)
+{
+  if (i < this->Extent[0] || i > this->Extent[1]
+    || j < this->Extent[2] || j > this->Extent[3]
+    || k < this->Extent[4] || k > this->Extent[5])
+    {
+    return 0;
+    }
+  vtkIdType row = static_cast<vtkIdType>(k - this->Extent[4]) * (this->Extent[3] - this->Extent[2] + 1) + (j - this->Extent[2]);
+  std::vector<RunType>::iterator rowBegin = this->Runs.begin() + this->RowOffsets[row];
+  std::vector<RunType>::iterator rowEnd = this->Runs.begin() + this->RowOffsets[row + 1];
+  // Find the first run that starts after i, the voxel can only be in the run before it
+  std::vector<RunType>::iterator runIt = std::upper_bound(rowBegin, rowEnd, i,
+    [](int index, const RunType& run) { return index < run.Start; });
+  if (runIt == rowBegin)
+    {
+    return 0;
+    }
+  --runIt;
+  return (i < runIt->Start + runIt->Length) ? runIt->Label : 0;
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkSparseLabelmap::GetNumberOfVoxels(int labelValue/*=0*/)
+{
+  vtkIdType numberOfVoxels = 0;
+  for (std::vector<RunType>::iterator runIt = this->Runs.begin(); runIt != this->Runs.end(); ++runIt)
+    {
+    if (labelValue == 0 || runIt->Label == labelValue)
+      {
+      numberOfVoxels += runIt->Length;
+      }
+    }
+  return numberOfVoxels;
+}
+
+//----------------------------------------------------------------------------
+void vtkSparseLabelmap::GetLabelValues(std::vector<int>& labelValues)
+{
+  std::set<int> labelValueSet;
+  for (std::vector<RunType>::iterator runIt = this->Runs.begin(); runIt != this->Runs.end(); ++runIt)
+    {
+    labelValueSet.insert(runIt->Label);
+    }
+  labelValues.assign(labelValueSet.begin(), labelValueSet.end());
+}
+
+//----------------------------------------------------------------------------
+void vtkSparseLabelmap::GetEffectiveExtent(int effectiveExtent[6])
+{
+  effectiveExtent[0] = effectiveExtent[2] = effectiveExtent[4] = VTK_INT_MAX;
+  effectiveExtent[1] = effectiveExtent[3] = effectiveExtent[5] = VTK_INT_MIN;
+  if (this->Runs.empty())
+    {
+    int emptyExtent[6] = { 0, -1, 0, -1, 0, -1 };
+    std::copy(emptyExtent, emptyExtent + 6, effectiveExtent);
+    return;
+    }
+
+  int dimJ = this->Extent[3] - this->Extent[2] + 1;
+  vtkIdType numberOfRows = this->GetNumberOfRows();
+  for (vtkIdType row = 0; row < numberOfRows; ++row)
+    {
+    if (this->RowOffsets[row] == this->RowOffsets[row + 1])
+      {
+      continue;
+      }
+    int j = this->Extent[2] + static_cast<int>(row % dimJ);
+    int k = this->Extent[4] + static_cast<int>(row / dimJ);
+    const RunType& firstRun = this->Runs[this->RowOffsets[row]];
+    const RunType& lastRun = this->Runs[this->RowOffsets[row + 1] - 1];
+    effectiveExtent[0] = std::min(effectiveExtent[0], firstRun.Start);
+    effectiveExtent[1] = std::max(effectiveExtent[1], lastRun.Start + lastRun.Length - 1);
+    effectiveExtent[2] = std::min(effectiveExtent[2], j);
+    effectiveExtent[3] = std::max(effectiveExtent[3], j);
+    effectiveExtent[4] = std::min(effectiveExtent[4], k);
+    effectiveExtent[5] = std::max(effectiveExtent[5], k);
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkSparseLabelmap::ShrinkToEffectiveExtent()
+{
+  int effectiveExtent[6] = { 0, -1, 0, -1, 0, -1 };
+  this->GetEffectiveExtent(effectiveExtent);
+  if (std::equal(effectiveExtent, effectiveExtent + 6, this->Extent))
+    {
+    return;
+    }
+  if (IsExtentEmpty(effectiveExtent))
+    {
+    this->SetExtent(effectiveExtent);
+    return;
+    }
+
+  // Rows outside the effective extent are empty, so the order of the runs does not change,
+  // only the row offsets have to be recomputed.
+  int oldDimJ = this->Extent[3] - this->Extent[2] + 1;
+  std::vector<vtkIdType> rowOffsets;
+  rowOffsets.reserve(static_cast<size_t>(effectiveExtent[3] - effectiveExtent[2] + 1)
+    * (effectiveExtent[5] - effectiveExtent[4] + 1) + 1);
+  rowOffsets.push_back(0);
+  for (int k = effectiveExtent[4]; k <= effectiveExtent[5]; ++k)
+    {
+    for (int j = effectiveExtent[2]; j <= effectiveExtent[3]; ++j)
+      {
+      vtkIdType oldRow = static_cast<vtkIdType>(k - this->Extent[4]) * oldDimJ + (j - this->Extent[2]);
+      rowOffsets.push_back(rowOffsets.back() + this->RowOffsets[oldRow + 1] - this->RowOffsets[oldRow]);
+      }
+    }
+  std::copy(effectiveExtent, effectiveExtent + 6, this->Extent);
+  this->RowOffsets.swap(rowOffsets);
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkSparseLabelmap::Combine(vtkSparseLabelmap* modifier, const int outputExtent[6], bool modifierExtentOnly,
+  const std::function<int(int,int)>& operation)
+{
+  std::vector<vtkIdType> rowOffsets;
+  std::vector<RunType> runs;
+  rowOffsets.push_back(0);
+
+  const int* baseExtent = this->Extent;
+  const int* modifierExtent = modifier->Extent;
+  bool baseEmpty = IsExtentEmpty(baseExtent);
+  bool modifierEmpty = IsExtentEmpty(modifierExtent);
+  int baseDimJ = baseExtent[3] - baseExtent[2] + 1;
+  int modifierDimJ = modifierExtent[3] - modifierExtent[2] + 1;
+  const RunType* baseRuns = this->Runs.data();
+  const RunType* modifierRuns = modifier->Runs.data();
+
+  std::vector<int> breaks;
+  if (!IsExtentEmpty(outputExtent))
+    {
+    rowOffsets.reserve(static_cast<size_t>(outputExtent[3] - outputExtent[2] + 1)
+      * (outputExtent[5] - outputExtent[4] + 1) + 1);
+    for (int k = outputExtent[4]; k <= outputExtent[5]; ++k)
+      {
+      for (int j = outputExtent[2]; j <= outputExtent[3]; ++j)
+        {
+        const RunType* baseBegin = baseRuns;
+        const RunType* baseEnd = baseRuns;
+        if (!baseEmpty && j >= baseExtent[2] && j <= baseExtent[3] && k >= baseExtent[4] && k <= baseExtent[5])
+          {
+          vtkIdType row = static_cast<vtkIdType>(k - baseExtent[4]) * baseDimJ + (j - baseExtent[2]);
+          baseBegin = baseRuns + this->RowOffsets[row];
+          baseEnd = baseRuns + this->RowOffsets[row + 1];
+          }
+        const RunType* modifierBegin = modifierRuns;
+        const RunType* modifierEnd = modifierRuns;
+        bool rowInModifier = !modifierEmpty
+          && j >= modifierExtent[2] && j <= modifierExtent[3] && k >= modifierExtent[4] && k <= modifierExtent[5];
+        if (rowInModifier)
+          {
+          vtkIdType row = static_cast<vtkIdType>(k - modifierExtent[4]) * modifierDimJ + (j - modifierExtent[2]);
+          modifierBegin = modifierRuns + modifier->RowOffsets[row];
+          modifierEnd = modifierRuns + modifier->RowOffsets[row + 1];
+          }
+
+        if (modifierExtentOnly && !rowInModifier)
+          {
+          // Row is not modified
+          runs.insert(runs.end(), baseBegin, baseEnd);
+          }
+        else if (modifierExtentOnly)
+          {
+          CombineRow(baseBegin, baseEnd, modifierBegin, modifierEnd, modifierExtent[0], modifierExtent[1],
+            operation, breaks, runs);
+          }
+        else
+          {
+          CombineRow(baseBegin, baseEnd, modifierBegin, modifierEnd, outputExtent[0], outputExtent[1],
+            operation, breaks, runs);
+          }
+        rowOffsets.push_back(static_cast<vtkIdType>(runs.size()));
+        }
+      }
+    }
+
+  std::copy(outputExtent, outputExtent + 6, this->Extent);
+  this->RowOffsets.swap(rowOffsets);
+  this->Runs.swap(runs);
+}
+
+//----------------------------------------------------------------------------
+bool vtkSparseLabelmap::Merge(vtkSparseLabelmap* modifier, int operation, int fillValue/*=1*/)
+{
+  if (!modifier)
+    {
+    vtkErrorMacro("Merge: Invalid modifier labelmap");
+    return false;
+    }
+  if (!this->IsGeometryEqual(modifier))
+    {
+    vtkErrorMacro("Merge: Geometry of the modifier labelmap does not match");
+    return false;
+    }
+  if (IsExtentEmpty(modifier->Extent))
+    {
+    return true;
+    }
+
+  std::function<int(int,int)> mergeFunction;
+  bool growExtent = false;
+  switch (operation)
+    {
+    case vtkOrientedImageDataResample::OPERATION_MINIMUM:
+      mergeFunction = [](int base, int modifierLabel) { return std::min(base, modifierLabel); };
+      break;
+    case vtkOrientedImageDataResample::OPERATION_MAXIMUM:
+      mergeFunction = [](int base, int modifierLabel) { return std::max(base, modifierLabel); };
+      growExtent = true;
+      break;
+    case vtkOrientedImageDataResample::OPERATION_MASKING:
+      mergeFunction = [fillValue](int base, int modifierLabel) { return modifierLabel != 0 ? fillValue : base; };
+      growExtent = (fillValue != 0);
+      break;
+    default:
+      vtkErrorMacro("Merge: Unknown operation " << operation);
+      return false;
+    }
+
+  int outputExtent[6] = { 0, -1, 0, -1, 0, -1 };
+  std::copy(this->Extent, this->Extent + 6, outputExtent);
+  if (growExtent)
+    {
+    if (IsExtentEmpty(this->Extent))
+      {
+      std::copy(modifier->Extent, modifier->Extent + 6, outputExtent);
+      }
+    else
+      {
+      for (int i = 0; i < 3; ++i)
+        {
+        outputExtent[2 * i] = std::min(this->Extent[2 * i], modifier->Extent[2 * i]);
+        outputExtent[2 * i + 1] = std::max(this->Extent[2 * i + 1], modifier->Extent[2 * i + 1]);
+        }
+      }
+    }
+  if (IsExtentEmpty(outputExtent))
+    {
+    // Nothing to modify
+    return true;
+    }
+
+  this->Combine(modifier, outputExtent, true, mergeFunction);
+  this->ShrinkToEffectiveExtent();
+  this->Modified();
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkSparseLabelmap::ApplyMask(vtkSparseLabelmap* mask, bool notMask/*=false*/)
+{
+  if (!mask)
+    {
+    vtkErrorMacro("ApplyMask: Invalid mask labelmap");
+    return false;
+    }
+  if (!this->IsGeometryEqual(mask))
+    {
+    vtkErrorMacro("ApplyMask: Geometry of the mask labelmap does not match");
+    return false;
+    }
+  if (IsExtentEmpty(this->Extent))
+    {
+    return true;
+    }
+
+  int outputExtent[6] = { 0, -1, 0, -1, 0, -1 };
+  std::copy(this->Extent, this->Extent + 6, outputExtent);
+  this->Combine(mask, outputExtent, false,
+    [notMask](int base, int maskLabel) { return ((maskLabel != 0) != notMask) ? base : 0; });
+  this->ShrinkToEffectiveExtent();
+  this->Modified();
+  return true;
+}
@@ -0,0 +1,164 @@
+/*==============================================================================
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#ifndef __vtkSparseLabelmap_h
+#define __vtkSparseLabelmap_h
+
+// VTK includes
+#include <vtkDataObject.h>
+
+// STD includes
+#include <functional>
+#include <vector>
+
+// Segmentation includes
+#include "vtkSegmentationCoreConfigure.h"
+
+class vtkMatrix4x4;
+class vtkOrientedImageData;
+
+/// \ingroup SegmentationCore
+/// \brief Labelmap that stores only the non-zero voxels, as run-length encoded rows.
+///
+/// Each row of the labelmap (voxels with the same J and K index) is stored as a sorted list of runs
+/// of consecutive voxels with the same non-zero label value. Memory usage is therefore proportional to the
+/// number of runs (roughly the surface area of the labeled regions) instead of the number of voxels in the
+/// extent. The geometry (origin, spacing, directions, extent) has the same meaning as in vtkOrientedImageData.
+///
+/// Merge and masking operations and voxel counting work directly on the runs. Operations between
+/// two sparse labelmaps require the same origin, spacing and directions, but the extents may differ.
+class vtkSegmentationCore_EXPORT vtkSparseLabelmap : public vtkDataObject
+{
+public:
+  static vtkSparseLabelmap* New();
+  vtkTypeMacro(vtkSparseLabelmap, vtkDataObject);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  /// Run of consecutive voxels of the same label value in a row
+  struct RunType
+    {
+    /// I index of the first voxel of the run
+    int Start;
+    /// Number of voxels in the run
+    int Length;
+    /// Label value of the voxels (not zero)
+    int Label;
+    };
+
+  /// Remove all voxels and set empty extent. Geometry is kept.
+  void Initialize() override;
+
+  /// Shallow copy. Runs are always copied, as they are not reference counted.
+  void ShallowCopy(vtkDataObject* src) override;
+  /// Deep copy
+  void DeepCopy(vtkDataObject* src) override;
+
+  /// Return the memory used by the labelmap in kibibytes
+  unsigned long GetActualMemorySize() override;
+
+  /// Set origin, spacing and directions from an oriented image data. Extent and voxels are not changed.
+  void CopyGeometryFromImage(vtkOrientedImageData* image);
+  /// Set origin, spacing and directions of an oriented image data
+  void CopyGeometryToImage(vtkOrientedImageData* image);
+  /// Get the matrix that transforms IJK coordinates to world coordinates
+  void GetImageToWorldMatrix(vtkMatrix4x4* imageToWorldMatrix);
+  /// Return true if origin, spacing and directions are the same in both labelmaps
+  bool IsGeometryEqual(vtkSparseLabelmap* other);
+
+  vtkSetVector3Macro(Origin, double);
+  vtkGetVector3Macro(Origin, double);
+  vtkSetVector3Macro(Spacing, double);
+  vtkGetVector3Macro(Spacing, double);
+  void SetDirections(double directions[3][3]);
+  void GetDirections(double directions[3][3]);
+
+  /// Set the extent of the labelmap. All voxels are removed.
+  void SetExtent(const int extent[6]);
+  /// Get the extent of the labelmap (only voxels within this extent can be non-zero)
+  void GetExtent(int extent[6]);
+  int* GetExtent() VTK_SIZEHINT(6) { return this->Extent; };
+
+  /// Return true if there are no non-zero voxels in the labelmap
+  bool IsEmpty() { return this->Runs.empty(); };
+
+  /// Encode an image. The extent of the sparse labelmap is shrunk to the effective extent of the stored voxels.
+  /// \param image Input image, must have a single scalar component.
+  /// \param labelValue If not zero, only voxels with this value are stored. Otherwise all non-zero voxels are stored.
+  /// \return Success flag
+  bool SetFromImage(vtkOrientedImageData* image, int labelValue = 0);
+
+  /// Write the labelmap into a dense image. Extent and geometry of the image is set from the sparse labelmap.
+  /// Scalar type is the smallest unsigned integer type that can store all label values.
+  /// \param fillValue If not zero, all non-zero voxels are written with this value instead of their label value.
+  /// \return Success flag
+  bool GetImage(vtkOrientedImageData* image, int fillValue = 0);
+
+  /// Get label value of a voxel. Returns 0 for voxels outside the extent.
+  int GetLabel(int i, int j, int k);
+
+  /// Get the number of voxels with the given label value. If the label value is 0 then all non-zero voxels are counted.
+  vtkIdType GetNumberOfVoxels(int labelValue = 0);
+
+  /// Get the number of stored runs
+  vtkIdType GetNumberOfRuns() { return static_cast<vtkIdType>(this->Runs.size()); };
+
+  /// Get all the different non-zero label values, in ascending order
+  void GetLabelValues(std::vector<int>& labelValues);
+
+  /// Get the (inclusive) extent that contains all non-zero voxels. Returns an empty extent if the labelmap is empty.
+  void GetEffectiveExtent(int effectiveExtent[6]);
+
+  /// Shrink the extent to the effective extent
+  void ShrinkToEffectiveExtent();
+
+  /// Combine the modifier labelmap into this labelmap within the extent of the modifier labelmap, same as
+  /// vtkOrientedImageDataResample::ModifyImage does for dense images. Voxels outside the extent of the
+  /// modifier are not changed. The extent is grown if needed.
+  /// \param operation vtkOrientedImageDataResample::OPERATION_MINIMUM, OPERATION_MAXIMUM or OPERATION_MASKING.
+  ///   In masking mode voxels where the modifier is non-zero are set to fillValue.
+  /// \return Success flag
+  bool Merge(vtkSparseLabelmap* modifier, int operation, int fillValue = 1);
+
+  /// Set voxels to zero where the mask is zero (or where the mask is non-zero, if notMask is enabled)
+  /// \return Success flag
+  bool ApplyMask(vtkSparseLabelmap* mask, bool notMask = false);
+
+protected:
+  vtkSparseLabelmap();
+  ~vtkSparseLabelmap() override;
+
+  /// Return the number of rows of the extent. Rows are indexed by (k - extent[4]) * dimensionJ + (j - extent[2])
+  vtkIdType GetNumberOfRows();
+
+  /// Combine the runs of this labelmap with the runs of another labelmap row by row into the output extent.
+  /// Only voxels within the modifier extent are combined if modifierExtentOnly is enabled,
+  /// other voxels keep their current value.
+  void Combine(vtkSparseLabelmap* modifier, const int outputExtent[6], bool modifierExtentOnly,
+    const std::function<int(int,int)>& operation);
+
+  int Extent[6];
+  double Origin[3];
+  double Spacing[3];
+  double Directions[3][3];
+
+  /// Index of the first run of each row in Runs. Contains row count + 1 values.
+  std::vector<vtkIdType> RowOffsets;
+  /// Runs of all rows, in row order
+  std::vector<RunType> Runs;
+
+private:
+  vtkSparseLabelmap(const vtkSparseLabelmap&) = delete;
+  void operator=(const vtkSparseLabelmap&) = delete;
+};
+
+#endif
@@ -0,0 +1,129 @@
+/*==============================================================================
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// SegmentationCore includes
+#include "vtkSparseLabelmapToBinaryLabelmapConversionRule.h"
+#include "vtkOrientedImageData.h"
+#include "vtkSegment.h"
+#include "vtkSegmentation.h"
+#include "vtkSparseLabelmap.h"
+
+// VTK includes
+#include <vtkObjectFactory.h>
+#include <vtkVariant.h>
+
+namespace
+{
+const int SPARSE_LABELMAP_DEFAULT_LABEL_VALUE = 1;
+}
+
+//----------------------------------------------------------------------------
+vtkSegmentationConverterRuleNewMacro(vtkSparseLabelmapToBinaryLabelmapConversionRule);
+
+//----------------------------------------------------------------------------
+vtkSparseLabelmapToBinaryLabelmapConversionRule::vtkSparseLabelmapToBinaryLabelmapConversionRule()
+{
+  // The target labelmap may be shared with other segments, so it must not be modified in place
+  this->ReplaceTargetRepresentation = true;
+
+  // Collapse labelmaps parameter
+  this->ConversionParameters[GetCollapseLabelmapsParameterName()] = std::make_pair("1",
+    "Merge the labelmaps into as few shared labelmaps as possible"
+    " 1 = created labelmaps will be shared if possible without overwriting each other.");
+}
+
+//----------------------------------------------------------------------------
+vtkSparseLabelmapToBinaryLabelmapConversionRule::~vtkSparseLabelmapToBinaryLabelmapConversionRule() = default;
+
+//----------------------------------------------------------------------------
+unsigned int vtkSparseLabelmapToBinaryLabelmapConversionRule::GetConversionCost(
+  vtkDataObject* vtkNotUsed(sourceRepresentation)/*=nullptr*/,
+  vtkDataObject* vtkNotUsed(targetRepresentation)/*=nullptr*/)
+{
+  // Rough input-independent guess (ms)
+  return 50;
+}
+
+//----------------------------------------------------------------------------
+vtkDataObject* vtkSparseLabelmapToBinaryLabelmapConversionRule::ConstructRepresentationObjectByRepresentation(std::string representationName)
+{
+  if ( !representationName.compare(this->GetSourceRepresentationName()) )
+    {
+    return (vtkDataObject*)vtkSparseLabelmap::New();
+    }
+  else if ( !representationName.compare(this->GetTargetRepresentationName()) )
+    {
+    return (vtkDataObject*)vtkOrientedImageData::New();
+    }
+  else
+    {
+    return nullptr;
+    }
+}
+
+//----------------------------------------------------------------------------
+vtkDataObject* vtkSparseLabelmapToBinaryLabelmapConversionRule::ConstructRepresentationObjectByClass(std::string className)
+{
+  if (!className.compare("vtkSparseLabelmap"))
+    {
+    return (vtkDataObject*)vtkSparseLabelmap::New();
+    }
+  else if (!className.compare("vtkOrientedImageData"))
+    {
+    return (vtkDataObject*)vtkOrientedImageData::New();
+    }
+  else
+    {
+    return nullptr;
+    }
+}
+
+//----------------------------------------------------------------------------
+bool vtkSparseLabelmapToBinaryLabelmapConversionRule::Convert(vtkSegment* segment)
+{
+  this->CreateTargetRepresentation(segment);
+
+  // Check validity of source and target representation objects
+  vtkSparseLabelmap* sparseLabelmap = vtkSparseLabelmap::SafeDownCast(
+    segment->GetRepresentation(this->GetSourceRepresentationName()));
+  if (!sparseLabelmap)
+    {
+    vtkErrorMacro("Convert: Source representation is not a sparse labelmap!");
+    return false;
+    }
+  vtkOrientedImageData* binaryLabelmap = vtkOrientedImageData::SafeDownCast(
+    segment->GetRepresentation(this->GetTargetRepresentationName()));
+  if (!binaryLabelmap)
+    {
+    vtkErrorMacro("Convert: Target representation is not an oriented image data!");
+    return false;
+    }
+
+  if (!sparseLabelmap->GetImage(binaryLabelmap, SPARSE_LABELMAP_DEFAULT_LABEL_VALUE))
+    {
+    return false;
+    }
+  segment->SetLabelValue(SPARSE_LABELMAP_DEFAULT_LABEL_VALUE);
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkSparseLabelmapToBinaryLabelmapConversionRule::PostConvert(vtkSegmentation* segmentation)
+{
+  int collapseLabelmaps = vtkVariant(this->ConversionParameters[GetCollapseLabelmapsParameterName()].first).ToInt();
+  if (collapseLabelmaps > 0)
+    {
+    segmentation->CollapseBinaryLabelmaps(false);
+    }
+  return true;
+}
@@ -23,12 +23,16 @@
 
 // VTK includes
 #include <vtkDataArray.h>
+#include <vtkFloatArray.h>
 #include <vtkImageData.h>
 #include <vtkMultiThreader.h>
 #include <vtkNew.h>
 #include <vtkPointData.h>
 #include <vtkVersion.h>
 
+// STD includes
+#include <cmath>
+
 //----------------------------------------------------------------------------
 int vtkDiffusionTensorMathematicsTest1(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
 {
@@ -119,5 +123,29 @@ int vtkDiffusionTensorMathematicsTest1(int vtkNotUsed(argc), char* vtkNotUsed(ar
       }
     std::cout << std::endl << std::endl;
     }
+
+  // Eigensystems are computed once and reused until the tensors are modified
+  vtkFloatArray* eigensystems = vtkDiffusionTensorMathematics::GetCachedEigensystems(scalars);
+  if (!eigensystems || vtkDiffusionTensorMathematics::GetEigensystems(scalars) != eigensystems
+    || eigensystems->GetNumberOfTuples() != scalars->GetNumberOfTuples())
+    {
+    std::cerr << "Line " << __LINE__ << " - Eigensystems are not cached" << std::endl;
+    return EXIT_FAILURE;
+    }
+  // Last tensor is diag(1, 1, 2): largest eigenvalue is 2 with eigenvector (0, 0, 1)
+  float* lastEigensystem = eigensystems->GetPointer(12 * (scalars->GetNumberOfTuples() - 1));
+  if (fabs(lastEigensystem[0] - 2.f) > 1e-5 || fabs(lastEigensystem[1] - 1.f) > 1e-5
+    || fabs(lastEigensystem[2] - 1.f) > 1e-5 || fabs(fabs(lastEigensystem[3 + 3*2 + 0]) - 1.f) > 1e-5)
+    {
+    std::cerr << "Line " << __LINE__ << " - Invalid eigensystem: "
+      << lastEigensystem[0] << " " << lastEigensystem[1] << " " << lastEigensystem[2] << std::endl;
+    return EXIT_FAILURE;
+    }
+  scalars->Modified();
+  if (vtkDiffusionTensorMathematics::GetCachedEigensystems(scalars) != nullptr)
+    {
+    std::cerr << "Line " << __LINE__ << " - Eigensystems are not updated after tensors are modified" << std::endl;
+    return EXIT_FAILURE;
+    }
   return EXIT_SUCCESS;
 }
@@ -0,0 +1,100 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// vtkTeem includes
+#include <vtkImageLabelCombine.h>
+
+// VTK includes
+#include <vtkImageData.h>
+#include <vtkNew.h>
+
+// STD includes
+#include <iostream>
+
+//----------------------------------------------------------------------------
+namespace
+{
+void FillLabels(vtkImageData* image, const short labels[4])
+{
+  image->SetDimensions(4, 1, 1);
+  image->AllocateScalars(VTK_SHORT, 1);
+  short* ptr = static_cast<short*>(image->GetScalarPointer());
+  for (int i = 0; i < 4; ++i)
+    {
+    ptr[i] = labels[i];
+    }
+}
+
+bool CheckLabels(vtkImageData* image, const short expectedLabels[4], int line)
+{
+  short* ptr = static_cast<short*>(image->GetScalarPointer());
+  for (int i = 0; i < 4; ++i)
+    {
+    if (ptr[i] != expectedLabels[i])
+      {
+      std::cerr << "Line " << line << " - Label at voxel " << i << " is " << ptr[i]
+                << ", expected " << expectedLabels[i] << std::endl;
+      return false;
+      }
+    }
+  return true;
+}
+}
+
+//----------------------------------------------------------------------------
+int vtkImageLabelCombineTest1(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
+{
+  const short labels1[4] = { 1, 0, 0, 0 };
+  const short labels2[4] = { 2, 2, 0, 0 };
+  const short labels3[4] = { 3, 3, 3, 0 };
+  vtkNew<vtkImageData> image1;
+  vtkNew<vtkImageData> image2;
+  vtkNew<vtkImageData> image3;
+  FillLabels(image1.GetPointer(), labels1);
+  FillLabels(image2.GetPointer(), labels2);
+  FillLabels(image3.GetPointer(), labels3);
+
+  vtkNew<vtkImageLabelCombine> combiner;
+
+  // Two inputs
+  combiner->SetInput1(image1.GetPointer());
+  combiner->SetInput2(image2.GetPointer());
+  combiner->Update();
+  const short expectedTwoInputs[4] = { 1, 2, 0, 0 };
+  if (!CheckLabels(combiner->GetOutput(), expectedTwoInputs, __LINE__))
+    {
+    return EXIT_FAILURE;
+    }
+
+  // Three inputs combined in one pass, first label wins
+  combiner->AddInput2(image3.GetPointer());
+  combiner->Update();
+  const short expectedFirstWins[4] = { 1, 2, 3, 0 };
+  if (!CheckLabels(combiner->GetOutput(), expectedFirstWins, __LINE__))
+    {
+    return EXIT_FAILURE;
+    }
+
+  // Last label wins
+  combiner->SetOverwriteInput(1);
+  combiner->Update();
+  const short expectedLastWins[4] = { 3, 3, 3, 0 };
+  if (!CheckLabels(combiner->GetOutput(), expectedLastWins, __LINE__))
+    {
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,117 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// vtkTeem includes
+#include <vtkTeemNRRDReader.h>
+#include <vtkTeemNRRDWriter.h>
+
+// VTK includes
+#include <vtkImageData.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+
+// STD includes
+#include <cstring>
+#include <string>
+
+//----------------------------------------------------------------------------
+namespace
+{
+bool WriteAndMap(vtkImageData* image, const std::string& fileName, bool compressed, bool expectedMemoryMapped)
+{
+  vtkNew<vtkTeemNRRDWriter> writer;
+  writer->SetInputData(image);
+  writer->SetFileName(fileName.c_str());
+  writer->SetUseCompression(compressed ? 1 : 0);
+  writer->Write();
+  if (writer->GetWriteError())
+    {
+    std::cerr << "Failed to write " << fileName << std::endl;
+    return false;
+    }
+
+  size_t size = static_cast<size_t>(image->GetNumberOfPoints()) * image->GetScalarSize();
+  {
+  vtkNew<vtkTeemNRRDReader> reader;
+  reader->SetFileName(fileName.c_str());
+  reader->UseMemoryMappingOn();
+  reader->Update();
+  if (reader->GetMemoryMapped() != expectedMemoryMapped)
+    {
+    std::cerr << fileName << ": MemoryMapped is " << reader->GetMemoryMapped()
+              << ", expected " << expectedMemoryMapped << std::endl;
+    return false;
+    }
+  vtkImageData* readImage = reader->GetOutput();
+  int* dimensions = image->GetDimensions();
+  int* readDimensions = readImage->GetDimensions();
+  if (readDimensions[0] != dimensions[0]
+    || readDimensions[1] != dimensions[1]
+    || readDimensions[2] != dimensions[2]
+    || readImage->GetScalarType() != image->GetScalarType())
+    {
+    std::cerr << "Image read from " << fileName << " has unexpected geometry or type" << std::endl;
+    return false;
+    }
+  if (memcmp(readImage->GetScalarPointer(), image->GetScalarPointer(), size) != 0)
+    {
+    std::cerr << "Image read from " << fileName << " has unexpected content" << std::endl;
+    return false;
+    }
+  // modify the voxels, it must not change the file
+  memset(readImage->GetScalarPointer(), 0, size);
+  }
+
+  vtkNew<vtkTeemNRRDReader> reader;
+  reader->SetFileName(fileName.c_str());
+  reader->Update();
+  if (memcmp(reader->GetOutput()->GetScalarPointer(), image->GetScalarPointer(), size) != 0)
+    {
+    std::cerr << "Modifying memory-mapped voxels modified " << fileName << std::endl;
+    return false;
+    }
+  return true;
+}
+}
+
+//----------------------------------------------------------------------------
+int vtkTeemNRRDReaderMemoryMappingTest1(int argc, char* argv[])
+{
+  if (argc < 2)
+    {
+    std::cerr << "Usage: " << argv[0] << " /path/to/temp" << std::endl;
+    return EXIT_FAILURE;
+    }
+  std::string tempDir = argv[1];
+
+  vtkNew<vtkImageData> image;
+  image->SetDimensions(64, 48, 32);
+  image->SetSpacing(0.5, 1.0, 2.0);
+  image->AllocateScalars(VTK_SHORT, 1);
+  short* ptr = static_cast<short*>(image->GetScalarPointer());
+  for (int i = 0; i < 64 * 48 * 32; ++i)
+    {
+    ptr[i] = static_cast<short>(i * 3);
+    }
+
+  if (!WriteAndMap(image.GetPointer(), tempDir + "/vtkTeemNRRDReaderMemoryMappingTest1.nrrd", false, true)
+    || !WriteAndMap(image.GetPointer(), tempDir + "/vtkTeemNRRDReaderMemoryMappingTest1.nhdr", false, true)
+    || !WriteAndMap(image.GetPointer(), tempDir + "/vtkTeemNRRDReaderMemoryMappingTest1_gz.nrrd", true, false))
+    {
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,100 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// vtkTeem includes
+#include <vtkTeemNRRDReader.h>
+#include <vtkTeemNRRDWriter.h>
+
+// VTK includes
+#include <vtkImageData.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+
+// STD includes
+#include <cstring>
+#include <string>
+
+//----------------------------------------------------------------------------
+namespace
+{
+bool WriteAndRead(vtkImageData* image, const std::string& fileName, int numberOfThreads)
+{
+  vtkNew<vtkTeemNRRDWriter> writer;
+  writer->SetInputData(image);
+  writer->SetFileName(fileName.c_str());
+  writer->SetUseCompression(1);
+  writer->SetCompressionLevel(1);
+  writer->SetNumberOfCompressionThreads(numberOfThreads);
+  writer->Write();
+  if (writer->GetWriteError())
+    {
+    std::cerr << "Failed to write " << fileName << " with " << numberOfThreads << " threads" << std::endl;
+    return false;
+    }
+
+  vtkNew<vtkTeemNRRDReader> reader;
+  reader->SetFileName(fileName.c_str());
+  reader->Update();
+  vtkImageData* readImage = reader->GetOutput();
+  int* dimensions = image->GetDimensions();
+  int* readDimensions = readImage->GetDimensions();
+  if (readDimensions[0] != dimensions[0]
+    || readDimensions[1] != dimensions[1]
+    || readDimensions[2] != dimensions[2]
+    || readImage->GetScalarType() != image->GetScalarType())
+    {
+    std::cerr << "Image read from " << fileName << " has unexpected geometry or type" << std::endl;
+    return false;
+    }
+  size_t size = static_cast<size_t>(dimensions[0]) * dimensions[1] * dimensions[2] * image->GetScalarSize();
+  if (memcmp(readImage->GetScalarPointer(), image->GetScalarPointer(), size) != 0)
+    {
+    std::cerr << "Image read from " << fileName << " has unexpected content" << std::endl;
+    return false;
+    }
+  return true;
+}
+}
+
+//----------------------------------------------------------------------------
+int vtkTeemNRRDWriterTest1(int argc, char* argv[])
+{
+  if (argc < 2)
+    {
+    std::cerr << "Usage: " << argv[0] << " /path/to/temp" << std::endl;
+    return EXIT_FAILURE;
+    }
+  std::string tempDir = argv[1];
+
+  // 4 MB of data, compressed in multiple chunks
+  vtkNew<vtkImageData> image;
+  image->SetDimensions(128, 128, 128);
+  image->AllocateScalars(VTK_SHORT, 1);
+  short* ptr = static_cast<short*>(image->GetScalarPointer());
+  for (int i = 0; i < 128 * 128 * 128; ++i)
+    {
+    ptr[i] = static_cast<short>((i * 7) ^ (i >> 9));
+    }
+
+  if (!WriteAndRead(image.GetPointer(), tempDir + "/vtkTeemNRRDWriterTest1_1.nrrd", 1)
+    || !WriteAndRead(image.GetPointer(), tempDir + "/vtkTeemNRRDWriterTest1_4.nrrd", 4)
+    || !WriteAndRead(image.GetPointer(), tempDir + "/vtkTeemNRRDWriterTest1_auto.nrrd", 0)
+    || !WriteAndRead(image.GetPointer(), tempDir + "/vtkTeemNRRDWriterTest1_4.nhdr", 4))
+    {
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
@@ -257,6 +257,16 @@ int vtkDiffusionTensorGlyph::RequestData(
       }
     }
 
+  // Use the eigensystems of all the tensors if they are already computed
+  // (by another glyph or tensor mathematics filter) or if every tensor is glyphed
+  vtkFloatArray* eigensystems = nullptr;
+  if (this->ExtractEigenvalues)
+    {
+    eigensystems = (skipCols <= 1 && skipRows <= 1) ?
+      vtkDiffusionTensorMathematics::GetEigensystems(inTensors)
+      : vtkDiffusionTensorMathematics::GetCachedEigensystems(inTensors);
+    }
+
   //
   // Allocate storage for output PolyData
   //
@@ -427,20 +437,36 @@ int vtkDiffusionTensorGlyph::RequestData(
       // compute orientation vectors and scale factors from tensor
       if ( this->ExtractEigenvalues ) // extract appropriate eigenfunctions
         {
-        for (j=0; j<3; j++)
+        if (eigensystems)
           {
+          // precomputed eigenvalues and eigenvectors
+          const float* eigensystem = eigensystems->GetPointer(eigensystems->GetNumberOfComponents() * inPtId);
           for (i=0; i<3; i++)
             {
-            // this line from vtkTensorGlyph actually transposes
-            //m[i][j] = tensor[i+3*j];
-            // simpler code with 3x3 array:
-            m[i][j] = tensor[j][i];
+            w[i] = eigensystem[i];
+            for (j=0; j<3; j++)
+              {
+              v[i][j] = eigensystem[3 + 3*i + j];
+              }
             }
           }
+        else
+          {
+          for (j=0; j<3; j++)
+            {
+            for (i=0; i<3; i++)
+              {
+              // this line from vtkTensorGlyph actually transposes
+              //m[i][j] = tensor[i+3*j];
+              // simpler code with 3x3 array:
+              m[i][j] = tensor[j][i];
+              }
+            }
 
-        //vtkMath::Jacobi(m, w, v);
-        // Use superior eigensolve from teem.
-        vtkDiffusionTensorMathematics::TeemEigenSolver(m,w,v);
+          //vtkMath::Jacobi(m, w, v);
+          // Use superior eigensolve from teem.
+          vtkDiffusionTensorMathematics::TeemEigenSolver(m,w,v);
+          }
 
         //copy eigenvectors
         xv[0] = v[0][0]; xv[1] = v[1][0]; xv[2] = v[2][0];
@@ -19,6 +19,7 @@
 
 // But, if you are on VS6.0 you don't get the define...
 #include "vtkDataArray.h"
+#include "vtkFloatArray.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkImageData.h"
@@ -28,6 +29,9 @@
 #include "vtkObjectFactory.h"
 #include "vtkTransform.h"
 #include "vtkPointData.h"
+#include "vtkSMPTools.h"
+#include "vtkSmartPointer.h"
+#include "vtkWeakPointer.h"
 #ifndef M_SQRT2
 #define M_SQRT2    1.41421356237309504880168872421      /* sqrt(2) */
 #endif
@@ -38,6 +42,8 @@ extern "C" {
 
 #include <ctime>
 #include <limits>
+#include <map>
+#include <mutex>
 
 #define VTK_EPS 1e-16
 #define MAX(a,b) (((a)>(b))?(a):(b))
@@ -52,6 +58,21 @@ vtkCxxSetObjectMacro(vtkDiffusionTensorMathematics,ScalarMask,vtkImageData);
 //----------------------------------------------------------------------------
 vtkStandardNewMacro(vtkDiffusionTensorMathematics);
 
+namespace
+{
+  // Number of components of an eigensystem: 3 eigenvalues and 3x3 eigenvectors
+  const int EIGENSYSTEM_NUMBER_OF_COMPONENTS = 12;
+
+  struct CachedEigensystems
+  {
+    vtkWeakPointer<vtkDataArray> Tensors;
+    vtkSmartPointer<vtkFloatArray> Eigensystems;
+  };
+  // Eigensystems of tensor arrays. Key is the address of the tensor array.
+  std::map<vtkDataArray*, CachedEigensystems> EigensystemsCache;
+  std::mutex EigensystemsCacheMutex;
+}
+
 
 //----------------------------------------------------------------------------
 vtkDiffusionTensorMathematics::vtkDiffusionTensorMathematics()
@@ -142,6 +163,16 @@ int vtkDiffusionTensorMathematics
 ::RequestData(vtkInformation* request, vtkInformationVector** inputVector,
               vtkInformationVector* outputVector)
 {
+  // Compute the eigensystems of all the tensors before the threads use them
+  vtkImageData* inData = vtkImageData::GetData(inputVector[0]);
+  vtkDataArray* inTensors = inData ? inData->GetPointData()->GetTensors() : nullptr;
+  if (inTensors && this->ExtractEigenvalues
+    && this->Operation != VTK_TENS_D11 && this->Operation != VTK_TENS_D22 && this->Operation != VTK_TENS_D33
+    && this->Operation != VTK_TENS_TRACE && this->Operation != VTK_TENS_DETERMINANT)
+    {
+    vtkDiffusionTensorMathematics::GetEigensystems(inTensors);
+    }
+
   int res = this->Superclass::RequestData(request, inputVector, outputVector);
   for (int i = 0; i < this->GetNumberOfOutputPorts(); ++i)
     {
@@ -450,6 +481,9 @@ static void vtkDiffusionTensorMathematicsExecute1Eigen(vtkDiffusionTensorMathema
 
   // decide whether to extract eigenfunctions or just use input cols
   extractEigenvalues = self->GetExtractEigenvalues();
+  // eigensystems computed for all the tensors in RequestData
+  vtkFloatArray* eigensystems = extractEigenvalues ? vtkDiffusionTensorMathematics::GetCachedEigensystems(inTensors) : nullptr;
+  const float* eigensystemPtr = nullptr;
 
   // transformation of tensor orientations for coloring
   vtkTransform *trans = vtkTransform::New();
@@ -493,6 +527,12 @@ static void vtkDiffusionTensorMathematicsExecute1Eigen(vtkDiffusionTensorMathema
         count++;
         }
 
+      if (eigensystems)
+        {
+        int rowStart[3] = { outExt[0], outExt[2] + idxY, outExt[4] + idxZ };
+        eigensystemPtr = eigensystems->GetPointer(EIGENSYSTEM_NUMBER_OF_COMPONENTS * in1Data->ComputePointId(rowStart));
+        }
+
       for (idxR = 0; idxR < rowLength; idxR++)
         {
         if (doMasking && *inMaskPtr != self->GetMaskLabelValue())
@@ -523,7 +563,19 @@ static void vtkDiffusionTensorMathematicsExecute1Eigen(vtkDiffusionTensorMathema
           tensor[2][2] = static_cast<double>(inPtr[8]);
 
           // get eigenvalues and eigenvectors appropriately
-          if (extractEigenvalues)
+          if (eigensystemPtr)
+            {
+            // precomputed eigensystem
+            for (i=0; i<3; i++)
+              {
+              w[i] = eigensystemPtr[i];
+              for (j=0; j<3; j++)
+                {
+                v[i][j] = eigensystemPtr[3 + 3*i + j];
+                }
+              }
+            }
+          else if (extractEigenvalues)
             {
             for (j=0; j<3; j++)
               {
@@ -782,6 +834,10 @@ static void vtkDiffusionTensorMathematicsExecute1Eigen(vtkDiffusionTensorMathema
         outPtr++;
         inPtr+=9;
         inMaskPtr++;
+        if (eigensystemPtr)
+          {
+          eigensystemPtr += EIGENSYSTEM_NUMBER_OF_COMPONENTS;
+          }
         }
       outPtr += outIncY;
       inPtr += inIncY;
@@ -1357,3 +1413,92 @@ int vtkDiffusionTensorMathematics::TeemEigenSolver(double **m, double *w, double
     return res;
 
 }
+
+//----------------------------------------------------------------------------
+vtkFloatArray* vtkDiffusionTensorMathematics::GetCachedEigensystems(vtkDataArray* tensors)
+{
+  if (!tensors)
+    {
+    return nullptr;
+    }
+  std::lock_guard<std::mutex> lock(EigensystemsCacheMutex);
+  std::map<vtkDataArray*, CachedEigensystems>::iterator cacheIt = EigensystemsCache.find(tensors);
+  if (cacheIt == EigensystemsCache.end()
+    || cacheIt->second.Tensors.GetPointer() != tensors
+    || cacheIt->second.Eigensystems->GetMTime() < tensors->GetMTime()
+    || cacheIt->second.Eigensystems->GetNumberOfTuples() != tensors->GetNumberOfTuples())
+    {
+    return nullptr;
+    }
+  return cacheIt->second.Eigensystems;
+}
+
+//----------------------------------------------------------------------------
+vtkFloatArray* vtkDiffusionTensorMathematics::GetEigensystems(vtkDataArray* tensors)
+{
+  if (!tensors || tensors->GetNumberOfComponents() != 9)
+    {
+    return nullptr;
+    }
+  vtkFloatArray* cachedEigensystems = vtkDiffusionTensorMathematics::GetCachedEigensystems(tensors);
+  if (cachedEigensystems)
+    {
+    return cachedEigensystems;
+    }
+
+  vtkSmartPointer<vtkFloatArray> eigensystems = vtkSmartPointer<vtkFloatArray>::New();
+  eigensystems->SetNumberOfComponents(EIGENSYSTEM_NUMBER_OF_COMPONENTS);
+  eigensystems->SetNumberOfTuples(tensors->GetNumberOfTuples());
+  float* eigensystemsPtr = eigensystems->GetPointer(0);
+  vtkSMPTools::For(0, tensors->GetNumberOfTuples(), [&](vtkIdType begin, vtkIdType end)
+    {
+    double tensor[9];
+    double *m[3], w[3], *v[3];
+    double m0[3], m1[3], m2[3];
+    double v0[3], v1[3], v2[3];
+    m[0] = m0; m[1] = m1; m[2] = m2;
+    v[0] = v0; v[1] = v1; v[2] = v2;
+    for (vtkIdType tensorIndex = begin; tensorIndex < end; ++tensorIndex)
+      {
+      tensors->GetTuple(tensorIndex, tensor);
+      for (int j = 0; j < 3; j++)
+        {
+        for (int i = 0; i < 3; i++)
+          {
+          // transpose
+          m[i][j] = tensor[3*j + i];
+          }
+        }
+      vtkDiffusionTensorMathematics::TeemEigenSolver(m, w, v);
+      float* eigensystem = eigensystemsPtr + EIGENSYSTEM_NUMBER_OF_COMPONENTS * tensorIndex;
+      for (int i = 0; i < 3; i++)
+        {
+        eigensystem[i] = static_cast<float>(w[i]);
+        for (int j = 0; j < 3; j++)
+          {
+          eigensystem[3 + 3*i + j] = static_cast<float>(v[i][j]);
+          }
+        }
+      }
+    });
+  eigensystems->Modified();
+
+  std::lock_guard<std::mutex> lock(EigensystemsCacheMutex);
+  // Remove eigensystems of deleted tensor arrays
+  for (std::map<vtkDataArray*, CachedEigensystems>::iterator cacheIt = EigensystemsCache.begin();
+    cacheIt != EigensystemsCache.end();)
+    {
+    if (cacheIt->second.Tensors.GetPointer() == nullptr)
+      {
+      cacheIt = EigensystemsCache.erase(cacheIt);
+      }
+    else
+      {
+      ++cacheIt;
+      }
+    }
+  CachedEigensystems& cached = EigensystemsCache[tensors];
+  cached.Tensors = tensors;
+  cached.Eigensystems = eigensystems;
+  return eigensystems;
+}
@@ -32,6 +32,8 @@
 // VTK includes
 #include <vtkThreadedImageAlgorithm.h>
 
+class vtkDataArray;
+class vtkFloatArray;
 class vtkMatrix4x4;
 class vtkImageData;
 class VTK_Teem_EXPORT vtkDiffusionTensorMathematics : public vtkThreadedImageAlgorithm
@@ -268,6 +270,18 @@ public:
   //Description
   //Wrap function to teem eigen solver
   static int TeemEigenSolver(double **m, double *w, double **v);
+
+  /// Eigensystems of all the tensors of the array, computed in parallel by TeemEigenSolver.
+  /// Each tuple contains the eigenvalues in decreasing order (3 components) followed by the
+  /// eigenvector matrix v in row-major order (9 components, eigenvectors are the columns).
+  /// The result is cached until the tensor array is modified or deleted, so that filters
+  /// processing the same tensors (scalar invariants, glyphs) compute it only once.
+  /// Must not be called from multiple threads at the same time.
+  /// \return nullptr if tensors is not a 9-component array.
+  static vtkFloatArray* GetEigensystems(vtkDataArray* tensors);
+  /// Eigensystems of the tensors if they are already computed and up-to-date, nullptr otherwise.
+  /// Can be called from any thread. \sa GetEigensystems
+  static vtkFloatArray* GetCachedEigensystems(vtkDataArray* tensors);
   void ComputeTensorIncrements(vtkImageData *imageData, vtkIdType incr[3]);
 
 protected:
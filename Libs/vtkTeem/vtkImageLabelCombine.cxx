@@ -19,6 +19,9 @@
 #include "vtkObjectFactory.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 
+// STD includes
+#include <vector>
+
 
 vtkStandardNewMacro(vtkImageLabelCombine);
 
@@ -39,29 +42,32 @@ int vtkImageLabelCombine::RequestInformation (
   // get the info objects
   vtkInformation *outInfo = outputVector->GetInformationObject(0);
   vtkInformation *inInfo = inputVector[0]->GetInformationObject(0);
-  vtkInformation *inInfo2 = inputVector[1]->GetInformationObject(0);
 
   int ext[6], ext2[6], idx;
 
   inInfo->Get(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT(), ext);
 
-  // two input take intersection
-  if (!inInfo2)
+  // take intersection of all inputs
+  if (inputVector[1]->GetNumberOfInformationObjects() < 1)
     {
     vtkErrorMacro(<< "Second input must be specified for this operation.");
     return 1;
     }
 
-  inInfo2->Get(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT(), ext2);
-  for (idx = 0; idx < 3; ++idx)
+  for (int inputIndex = 0; inputIndex < inputVector[1]->GetNumberOfInformationObjects(); ++inputIndex)
     {
-    if (ext2[idx*2] > ext[idx*2])
-      {
-      ext[idx*2] = ext2[idx*2];
-      }
-    if (ext2[idx*2+1] < ext[idx*2+1])
+    vtkInformation *inInfo2 = inputVector[1]->GetInformationObject(inputIndex);
+    inInfo2->Get(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT(), ext2);
+    for (idx = 0; idx < 3; ++idx)
       {
-      ext[idx*2+1] = ext2[idx*2+1];
+      if (ext2[idx*2] > ext[idx*2])
+        {
+        ext[idx*2] = ext2[idx*2];
+        }
+      if (ext2[idx*2+1] < ext[idx*2+1])
+        {
+        ext[idx*2+1] = ext2[idx*2+1];
+        }
       }
     }
 
@@ -73,18 +79,15 @@ int vtkImageLabelCombine::RequestInformation (
 
 //----------------------------------------------------------------------------
 // This templated function executes the filter for any type of data.
-// Handles the two input operations
+// Combines all the inputs in one pass.
 template <class T>
-void vtkImageLabelCombineExecute2(vtkImageLabelCombine *self,
-                                 vtkImageData *in1Data, T *in1Ptr,
-                                 vtkImageData *in2Data, T *in2Ptr,
+void vtkImageLabelCombineExecute(vtkImageLabelCombine *self,
+                                 std::vector<vtkImageData*>& inDatas,
                                  vtkImageData *outData, T *outPtr,
                                  int outExt[6], int id)
 {
   int idxR, idxY, idxZ;
   int maxY, maxZ;
-  vtkIdType inIncX, inIncY, inIncZ;
-  vtkIdType in2IncX, in2IncY, in2IncZ;
   vtkIdType outIncX, outIncY, outIncZ;
   int rowLength;
   unsigned long count = 0;
@@ -92,19 +95,25 @@ void vtkImageLabelCombineExecute2(vtkImageLabelCombine *self,
   int op = self->GetOverwriteInput();
 
   // find the region to loop over
-  rowLength = (outExt[1] - outExt[0]+1)*in1Data->GetNumberOfScalarComponents();
+  rowLength = (outExt[1] - outExt[0]+1)*inDatas[0]->GetNumberOfScalarComponents();
 
   maxY = outExt[3] - outExt[2];
   maxZ = outExt[5] - outExt[4];
   target = (unsigned long)((maxZ+1)*(maxY+1)/50.0);
   target++;
 
-  T v1;
-  T v2;
-
-  // Get increments to march through data
-  in1Data->GetContinuousIncrements(outExt, inIncX, inIncY, inIncZ);
-  in2Data->GetContinuousIncrements(outExt, in2IncX, in2IncY, in2IncZ);
+  // Inputs in the order they are checked: the first positive label is kept
+  const size_t numberOfInputs = inDatas.size();
+  std::vector<T*> inPtrs(numberOfInputs);
+  std::vector<vtkIdType> inIncYs(numberOfInputs);
+  std::vector<vtkIdType> inIncZs(numberOfInputs);
+  for (size_t inputIndex = 0; inputIndex < numberOfInputs; ++inputIndex)
+    {
+    vtkImageData* inData = inDatas[op == 0 ? inputIndex : numberOfInputs - 1 - inputIndex];
+    vtkIdType inIncX = 0;
+    inData->GetContinuousIncrements(outExt, inIncX, inIncYs[inputIndex], inIncZs[inputIndex]);
+    inPtrs[inputIndex] = static_cast<T*>(inData->GetScalarPointerForExtent(outExt));
+    }
   outData->GetContinuousIncrements(outExt, outIncX, outIncY, outIncZ);
 
   // Loop through output pixels
@@ -123,49 +132,33 @@ void vtkImageLabelCombineExecute2(vtkImageLabelCombine *self,
       for (idxR = 0; idxR < rowLength; idxR++)
         {
         // Pixel operation
-        v1 = *in1Ptr;
-        v2 = *in2Ptr;
-        if (op == 0)
+        T label = 0;
+        for (size_t inputIndex = 0; inputIndex < numberOfInputs; ++inputIndex)
           {
-          if (v1 > 0)
-            {
-            *outPtr = v1;
-            }
-          else if (v2 > 0 && v1 == 0)
-            {
-            *outPtr = v2;
-            }
-          else
-            {
-            *outPtr = 0;
-            }
-          }
-        else
-          {
-          if (v2 > 0)
-            {
-            *outPtr = v2;
-            }
-          else if (v1 > 0 && v2 == 0)
+          T v = inPtrs[inputIndex][idxR];
+          if (v > 0)
             {
-            *outPtr = v1;
+            label = v;
+            break;
             }
-          else
+          if (v != 0)
             {
-            *outPtr = 0;
+            break;
             }
           }
-        outPtr++;
-        in1Ptr++;
-        in2Ptr++;
+        outPtr[idxR] = label;
+        }
+      outPtr += rowLength + outIncY;
+      for (size_t inputIndex = 0; inputIndex < numberOfInputs; ++inputIndex)
+        {
+        inPtrs[inputIndex] += rowLength + inIncYs[inputIndex];
         }
-      outPtr += outIncY;
-      in1Ptr += inIncY;
-      in2Ptr += in2IncY;
       }
     outPtr += outIncZ;
-    in1Ptr += inIncZ;
-    in2Ptr += in2IncZ;
+    for (size_t inputIndex = 0; inputIndex < numberOfInputs; ++inputIndex)
+      {
+      inPtrs[inputIndex] += inIncZs[inputIndex];
+      }
     }
 }
 
@@ -177,28 +170,23 @@ void vtkImageLabelCombineExecute2(vtkImageLabelCombine *self,
 // the datas data types.
 void vtkImageLabelCombine::ThreadedRequestData(
   vtkInformation * vtkNotUsed( request ),
-  vtkInformationVector ** vtkNotUsed( inputVector ),
+  vtkInformationVector ** inputVector,
   vtkInformationVector * vtkNotUsed( outputVector ),
   vtkImageData ***inData,
   vtkImageData **outData,
   int outExt[6], int id)
 {
-  void *inPtr1;
   void *outPtr;
 
-  inPtr1 = inData[0][0]->GetScalarPointerForExtent(outExt);
   outPtr = outData[0]->GetScalarPointerForExtent(outExt);
 
-  void *inPtr2;
-
-  if (!inData[1] || ! inData[1][0])
+  int numberOfInputs2 = inputVector[1]->GetNumberOfInformationObjects();
+  if (!inData[1] || numberOfInputs2 < 1 || !inData[1][0])
     {
     vtkErrorMacro("ImageMathematics requested to perform a two input operation with only one input\n");
     return;
     }
 
-  inPtr2 = inData[1][0]->GetScalarPointerForExtent(outExt);
-
   // this filter expects that input is the same type as output.
   if (inData[0][0]->GetScalarType() != outData[0]->GetScalarType())
     {
@@ -208,32 +196,41 @@ void vtkImageLabelCombine::ThreadedRequestData(
                     << outData[0]->GetScalarType());
       return;
     }
-  /**
-  if (inData[1][0]->GetScalarType() != outData[0]->GetScalarType())
+
+  std::vector<vtkImageData*> inDatas;
+  inDatas.push_back(inData[0][0]);
+  for (int inputIndex = 0; inputIndex < numberOfInputs2; ++inputIndex)
     {
-      vtkErrorMacro(<< "Execute: input2 ScalarType, "
-                    << inData[1][0]->GetScalarType()
-                    << ", must match output ScalarType "
-                    << outData[0]->GetScalarType());
+    vtkImageData* inData2 = inData[1][inputIndex];
+    if (!inData2)
+      {
+      vtkErrorMacro(<< "Execute: input2 connection " << inputIndex << " has no image data");
       return;
-    }
-  **/
-  // this filter expects that inputs that have the same number of components
-  if (inData[0][0]->GetNumberOfScalarComponents() !=
-      inData[1][0]->GetNumberOfScalarComponents())
-    {
+      }
+    // this filter expects that inputs have the same number of components and scalar type
+    if (inData2->GetNumberOfScalarComponents() != inData[0][0]->GetNumberOfScalarComponents())
+      {
       vtkErrorMacro(<< "Execute: input1 NumberOfScalarComponents, "
                     << inData[0][0]->GetNumberOfScalarComponents()
                     << ", must match out input2 NumberOfScalarComponents "
-                    << inData[1][0]->GetNumberOfScalarComponents());
+                    << inData2->GetNumberOfScalarComponents());
       return;
+      }
+    if (inData2->GetScalarType() != inData[0][0]->GetScalarType())
+      {
+      vtkErrorMacro(<< "Execute: input2 ScalarType, "
+                    << inData2->GetScalarType()
+                    << ", must match input1 ScalarType "
+                    << inData[0][0]->GetScalarType());
+      return;
+      }
+    inDatas.push_back(inData2);
     }
 
   switch (inData[0][0]->GetScalarType())
     {
     vtkTemplateMacro(
-                     vtkImageLabelCombineExecute2(this,inData[0][0], (VTK_TT *)(inPtr1),
-                                                  inData[1][0], (VTK_TT *)(inPtr2),
+                     vtkImageLabelCombineExecute(this, inDatas,
                                                   outData[0], (VTK_TT *)(outPtr), outExt, id));
     default:
       vtkErrorMacro(<< "Execute: Unknown ScalarType");
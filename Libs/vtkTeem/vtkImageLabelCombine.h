@@ -22,11 +22,13 @@
 
 #include "vtkThreadedImageAlgorithm.h"
 
-/// \brief Add, subtract, multiply, divide, invert, sin, cos, exp, log.
+/// \brief Combine label maps.
 ///
-/// vtkImageLabelCombine implements basic mathematic operations SetOperation is
-/// used to select the filters behavior.  The filter can take two or one
-/// input.
+/// vtkImageLabelCombine combines the label map of input 1 with the label maps
+/// connected to input 2, in one pass. Any number of label maps can be connected
+/// to input 2 (see AddInput2). Label maps are combined in order: input 1 first,
+/// then the ones of input 2 in the order they were connected. The output extent is
+/// the intersection of the input extents.
 class VTK_Teem_EXPORT vtkImageLabelCombine : public vtkThreadedImageAlgorithm
 {
 public:
@@ -35,7 +37,10 @@ public:
   void PrintSelf(ostream& os, vtkIndent indent) override;
 
   ///
-  /// Set/Get the Operation to perform.
+  /// Set/Get how overlapping labels are combined.
+  /// If 0 (default) then the first label map with a positive label at a voxel
+  /// defines the output label, if 1 then the last one does.
+  /// A negative label before the first positive one sets the output to 0.
   vtkSetMacro(OverwriteInput,int);
   vtkGetMacro(OverwriteInput,int);
 
@@ -49,6 +54,11 @@ public:
   {
       this->SetInputData(1,in);
   }
+  /// Add a label map to combine after the ones already set as input 2
+  virtual void AddInput2(vtkDataObject *in)
+  {
+      this->AddInputData(1,in);
+  }
 
 protected:
   vtkImageLabelCombine();
@@ -31,6 +31,7 @@
 // VTK includes
 #include "vtkBitArray.h"
 #include "vtkCharArray.h"
+#include <vtkDataArray.h>
 #include "vtkDoubleArray.h"
 #include "vtkFloatArray.h"
 #include "vtkImageData.h"
@@ -47,13 +48,134 @@
 #include "vtkUnsignedShortArray.h"
 #include "vtkUnsignedIntArray.h"
 #include "vtkUnsignedLongArray.h"
+#include <vtksys/Encoding.hxx>
 #include <vtksys/SystemTools.hxx>
 
 // Teem includes
 #include "teem/ten.h"
 
+// STD includes
+#include <fstream>
+#include <mutex>
+
+#ifdef _WIN32
+# include <windows.h>
+#else
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <unistd.h>
+#endif
+
 vtkStandardNewMacro(vtkTeemNRRDReader);
 
+namespace
+{
+//----------------------------------------------------------------------------
+/// Memory mappings created by MapFile(), indexed by the data pointer
+/// given to the arrays, so that they can be released when arrays are freed.
+struct MappedRegion
+{
+  void* Base;
+  size_t Length;
+};
+std::mutex MappedRegionsMutex;
+std::map<void*, MappedRegion> MappedRegions;
+
+//----------------------------------------------------------------------------
+/// Map \a size bytes of \a fileName starting at \a offset, copy-on-write.
+void* MapFile(const std::string& fileName, size_t offset, size_t size)
+{
+#ifdef _WIN32
+  SYSTEM_INFO systemInfo;
+  GetSystemInfo(&systemInfo);
+  size_t alignment = systemInfo.dwAllocationGranularity;
+#else
+  size_t alignment = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#endif
+  size_t alignedOffset = offset - offset % alignment;
+  size_t length = size + (offset - alignedOffset);
+  void* base = nullptr;
+#ifdef _WIN32
+  std::wstring wideFileName = vtksys::Encoding::ToWide(fileName);
+  HANDLE file = CreateFileW(wideFileName.c_str(), GENERIC_READ, FILE_SHARE_READ,
+    nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (file == INVALID_HANDLE_VALUE)
+    {
+    return nullptr;
+    }
+  HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+  if (mapping)
+    {
+    base = MapViewOfFile(mapping, FILE_MAP_COPY,
+      static_cast<DWORD>(static_cast<unsigned long long>(alignedOffset) >> 32),
+      static_cast<DWORD>(alignedOffset & 0xffffffff), length);
+    CloseHandle(mapping);
+    }
+  CloseHandle(file);
+#else
+  int file = open(fileName.c_str(), O_RDONLY);
+  if (file < 0)
+    {
+    return nullptr;
+    }
+  base = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE, file, static_cast<off_t>(alignedOffset));
+  close(file);
+  if (base == MAP_FAILED)
+    {
+    base = nullptr;
+    }
+#endif
+  if (!base)
+    {
+    return nullptr;
+    }
+  void* data = static_cast<char*>(base) + (offset - alignedOffset);
+  std::lock_guard<std::mutex> lock(MappedRegionsMutex);
+  MappedRegion region = { base, length };
+  MappedRegions[data] = region;
+  return data;
+}
+
+//----------------------------------------------------------------------------
+/// Array free function releasing a mapping created by MapFile()
+void UnmapFile(void* data)
+{
+  MappedRegion region;
+  {
+  std::lock_guard<std::mutex> lock(MappedRegionsMutex);
+  std::map<void*, MappedRegion>::iterator it = MappedRegions.find(data);
+  if (it == MappedRegions.end())
+    {
+    return;
+    }
+  region = it->second;
+  MappedRegions.erase(it);
+  }
+#ifdef _WIN32
+  UnmapViewOfFile(region.Base);
+#else
+  munmap(region.Base, region.Length);
+#endif
+}
+
+//----------------------------------------------------------------------------
+/// Return the position of the data after the attached header of \a fileName
+/// (after the first empty line), or -1 if not found.
+long long GetAttachedDataOffset(const std::string& fileName)
+{
+  std::ifstream file(fileName.c_str(), std::ios::in | std::ios::binary);
+  std::string line;
+  while (std::getline(file, line))
+    {
+    if (line.empty() || line == "\r")
+      {
+      return static_cast<long long>(file.tellg());
+      }
+    }
+  return -1;
+}
+}
+
 //----------------------------------------------------------------------------
 vtkTeemNRRDReader::vtkTeemNRRDReader()
 {
@@ -62,6 +184,8 @@ vtkTeemNRRDReader::vtkTeemNRRDReader()
   this->MeasurementFrameMatrix = vtkSmartPointer<vtkMatrix4x4>::New();
   this->nrrd = nrrdNew();
   this->UseNativeOrigin = true;
+  this->UseMemoryMapping = false;
+  this->MemoryMapped = false;
   this->ReadStatus = 0;
   this->PointDataType = -1;
   this->DataType = -1;
@@ -807,6 +931,111 @@ void vtkTeemNRRDReader::AllocatePointData(vtkImageData *out, vtkInformation* out
     }
 }
 
+//----------------------------------------------------------------------------
+bool vtkTeemNRRDReader::ReadMemoryMappedData(vtkImageData* imageData, vtkInformation* outInfo)
+{
+  if (!imageData)
+    {
+    return false;
+    }
+  this->ExecuteInformation();
+  if (this->ReadStatus != 0
+    || (this->PointDataType != vtkDataSetAttributes::SCALARS
+        && this->PointDataType != vtkDataSetAttributes::VECTORS))
+    {
+    return false;
+    }
+  // the non-scalar axis must already be the fastest axis
+  unsigned int rangeAxisIdx[NRRD_DIM_MAX] = { 0 };
+  unsigned int rangeAxisNum = nrrdRangeAxesGet(this->nrrd, rangeAxisIdx);
+  if (rangeAxisNum > 1 || (rangeAxisNum == 1 && rangeAxisIdx[0] != 0))
+    {
+    return false;
+    }
+
+  // Read the header again to get the data file, encoding and byte order
+  Nrrd* nrrdHeader = nrrdNew();
+  NrrdIoState* nio = nrrdIoStateNew();
+  nrrdIoStateSet(nio, nrrdIoStateSkipData, 1);
+  bool mappable = (nrrdLoad(nrrdHeader, this->GetFileName(), nio) == 0);
+  size_t dataSize = 0;
+  std::string dataFileName;
+  long long dataOffset = -1;
+  if (mappable)
+    {
+    const unsigned short endianTest = 1;
+    int machineEndian = (*reinterpret_cast<const unsigned char*>(&endianTest) == 1) ? airEndianLittle : airEndianBig;
+    dataSize = nrrdElementNumber(nrrdHeader) * nrrdElementSize(nrrdHeader);
+    mappable = nio->encoding == nrrdEncodingRaw
+      && (nrrdElementSize(nrrdHeader) == 1 || nio->endian == machineEndian)
+      && nio->lineSkip == 0
+      && nio->byteSkip >= 0
+      && nio->dataFNFormat == nullptr
+      && nio->dataFNArr->len <= 1
+      && dataSize > 0;
+    }
+  if (mappable)
+    {
+    if (nio->dataFNArr->len == 0)
+      {
+      // data attached to the header
+      dataFileName = this->GetFileName();
+      dataOffset = GetAttachedDataOffset(dataFileName);
+      }
+    else
+      {
+      dataFileName = nio->dataFN[0];
+      if (!vtksys::SystemTools::FileIsFullPath(dataFileName))
+        {
+        dataFileName = vtksys::SystemTools::CollapseFullPath(dataFileName,
+          vtksys::SystemTools::GetFilenamePath(this->GetFileName()));
+        }
+      dataOffset = 0;
+      }
+    if (dataOffset >= 0)
+      {
+      dataOffset += nio->byteSkip;
+      }
+    mappable = dataOffset >= 0
+      && static_cast<unsigned long long>(vtksys::SystemTools::FileLength(dataFileName))
+         >= static_cast<unsigned long long>(dataOffset) + dataSize;
+    }
+  nrrdNuke(nrrdHeader);
+  nrrdIoStateNix(nio);
+  if (!mappable)
+    {
+    return false;
+    }
+
+  void* data = MapFile(dataFileName, static_cast<size_t>(dataOffset), dataSize);
+  if (!data)
+    {
+    vtkWarningMacro("ReadMemoryMappedData: failed to map " << dataFileName << ", reading it instead");
+    return false;
+    }
+
+  vtkSmartPointer<vtkDataArray> array = vtkSmartPointer<vtkDataArray>::Take(
+    vtkDataArray::CreateDataArray(this->DataType));
+  array->SetNumberOfComponents(this->GetNumberOfComponents());
+  array->SetVoidArray(data, static_cast<vtkIdType>(dataSize / array->GetDataTypeSize()),
+    0, vtkAbstractArray::VTK_DATA_ARRAY_USER_DEFINED);
+  array->SetArrayFreeFunction(UnmapFile);
+  array->SetName("NRRDImage");
+
+  imageData->SetExtent(this->GetUpdateExtent());
+  if (this->PointDataType == vtkDataSetAttributes::SCALARS)
+    {
+    imageData->GetPointData()->SetScalars(array);
+    vtkDataObject::SetPointDataActiveScalarInfo(outInfo, this->DataType, this->GetNumberOfComponents());
+    }
+  else
+    {
+    imageData->GetPointData()->SetVectors(array);
+    }
+  this->MemoryMapped = true;
+  return true;
+}
+
 //----------------------------------------------------------------------------
 int vtkTeemNRRDReader::tenSpaceDirectionReduce(Nrrd *nout, const Nrrd *nin, double SD[9])
 {
@@ -905,6 +1134,13 @@ void vtkTeemNRRDReader::ExecuteDataWithInformation(vtkDataObject *output, vtkInf
         vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT()), 6);
     }
 
+  this->MemoryMapped = false;
+  if (this->UseMemoryMapping && this->GetFileName() != nullptr
+    && this->ReadMemoryMappedData(vtkImageData::SafeDownCast(output), outInfo))
+    {
+    return;
+    }
+
   vtkImageData *imageData = this->AllocateOutputData(output, outInfo);
 
   if (this->GetFileName() == nullptr)
@@ -147,6 +147,22 @@ public:
     UseNativeOrigin = false;
   }
 
+  ///
+  /// Map uncompressed (raw encoded) scalar or vector data files in memory
+  /// instead of reading them into a newly allocated buffer.
+  /// The mapping is copy-on-write: modified voxels are stored in private
+  /// memory and are never written back to the file.
+  /// Files that cannot be mapped (compressed, non-native byte order,
+  /// axes that need to be permuted, tensors...) are read normally.
+  /// Default is off.
+  vtkSetMacro(UseMemoryMapping, bool);
+  vtkGetMacro(UseMemoryMapping, bool);
+  vtkBooleanMacro(UseMemoryMapping, bool);
+
+  ///
+  /// Return true if the data of the last read file is memory-mapped.
+  vtkGetMacro(MemoryMapped, bool);
+
   int NrrdToVTKScalarType( const int nrrdPixelType ) const
   {
   switch( nrrdPixelType )
@@ -256,6 +272,8 @@ protected:
   int DataType;
   int NumberOfComponents;
   bool UseNativeOrigin;
+  bool UseMemoryMapping;
+  bool MemoryMapped;
 
   std::map <std::string, std::string> HeaderKeyValue;
   std::string HeaderKeys; // buffer for returning key list
@@ -268,6 +286,11 @@ protected:
 
   int tenSpaceDirectionReduce(Nrrd *nout, const Nrrd *nin, double SD[9]);
 
+  ///
+  /// Map the data file in memory and set it as point data of \a imageData.
+  /// Return false if the file cannot be mapped.
+  bool ReadMemoryMappedData(vtkImageData* imageData, vtkInformation* outInfo);
+
 private:
   vtkTeemNRRDReader(const vtkTeemNRRDReader&) = delete;
   void operator=(const vtkTeemNRRDReader&) = delete;
@@ -1,4 +1,10 @@
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <fstream>
 #include <map>
+#include <thread>
+#include <vector>
 
 #include "vtkTeemNRRDWriter.h"
 
@@ -8,6 +14,8 @@
 #include "vtkObjectFactory.h"
 #include "vtkInformation.h"
 #include <vtkVersion.h>
+#include <vtk_zlib.h>
+#include <vtksys/SystemTools.hxx>
 
 #include <vnl/vnl_math.h>
 #include <vnl/vnl_double_3.h>
@@ -20,6 +28,49 @@ class AxisInfoMapType : public std::map<unsigned int, std::string> {};
 
 vtkStandardNewMacro(vtkTeemNRRDWriter);
 
+namespace
+{
+/// Size of the data chunks that are compressed independently
+const size_t GzipChunkSize = 1 << 20;
+
+//----------------------------------------------------------------------------
+/// Compress a chunk as raw deflate data. All chunks but the last one end
+/// with a sync flush so that the compressed chunks can be concatenated
+/// into a single deflate stream.
+bool DeflateChunk(const unsigned char* data, size_t size, int level, bool last,
+                  std::vector<unsigned char>& compressed)
+{
+  z_stream stream;
+  memset(&stream, 0, sizeof(stream));
+  if (deflateInit2(&stream, level, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+    {
+    return false;
+    }
+  compressed.resize(deflateBound(&stream, static_cast<uLong>(size)) + 16);
+  stream.next_in = const_cast<Bytef*>(data);
+  stream.avail_in = static_cast<uInt>(size);
+  stream.next_out = &compressed[0];
+  stream.avail_out = static_cast<uInt>(compressed.size());
+  int result = deflate(&stream, last ? Z_FINISH : Z_SYNC_FLUSH);
+  bool success = last ? (result == Z_STREAM_END)
+    : (result == Z_OK && stream.avail_in == 0 && stream.avail_out > 0);
+  compressed.resize(stream.total_out);
+  deflateEnd(&stream);
+  return success;
+}
+
+//----------------------------------------------------------------------------
+void WriteLittleEndian32(std::ostream& os, uLong value)
+{
+  unsigned char bytes[4];
+  for (int i = 0; i < 4; ++i)
+    {
+    bytes[i] = static_cast<unsigned char>((value >> (8 * i)) & 0xff);
+    }
+  os.write(reinterpret_cast<const char*>(bytes), 4);
+}
+}
+
 //----------------------------------------------------------------------------
 vtkTeemNRRDWriter::vtkTeemNRRDWriter()
 {
@@ -31,6 +82,7 @@ vtkTeemNRRDWriter::vtkTeemNRRDWriter()
   this->UseCompression = 1;
   // use default CompressionLevel
   this->CompressionLevel = -1;
+  this->NumberOfCompressionThreads = 0;
   this->DiffusionWeightedData = 0;
   this->FileType = VTK_BINARY;
   this->WriteErrorOff();
@@ -411,6 +463,27 @@ void vtkTeemNRRDWriter::WriteData()
     return;
     }
 
+  // compress large attached-header files on multiple threads
+  int numberOfCompressionThreads = this->NumberOfCompressionThreads;
+  if (numberOfCompressionThreads == 0)
+    {
+    numberOfCompressionThreads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    }
+  size_t dataSize = nrrdElementNumber(nrrd) * nrrdElementSize(nrrd);
+  if (this->GetUseCompression() && nrrdEncodingGzip->available()
+    && numberOfCompressionThreads > 1
+    && dataSize >= 2 * GzipChunkSize
+    && vtksys::SystemTools::LowerCase(
+      vtksys::SystemTools::GetFilenameLastExtension(this->GetFileName())) == ".nrrd")
+    {
+    if (!this->WriteCompressedDataMultiThreaded(nrrd, numberOfCompressionThreads))
+      {
+      this->WriteErrorOn();
+      }
+    nrrd = nrrdNix(nrrd);
+    return;
+    }
+
   NrrdIoState *nio = nrrdIoStateNew();
 
   // set encoding for data: compressed (raw), (uncompressed) raw, or ascii
@@ -451,6 +524,116 @@ void vtkTeemNRRDWriter::WriteData()
   nio = nrrdIoStateNix(nio);
 }
 
+//----------------------------------------------------------------------------
+bool vtkTeemNRRDWriter::WriteCompressedDataMultiThreaded(Nrrd* nrrd, int numberOfThreads)
+{
+  // Write the header only, teem appends the blank line separating it from the data
+  NrrdIoState *nio = nrrdIoStateNew();
+  nio->encoding = nrrdEncodingGzip;
+  nio->zlibLevel = this->CompressionLevel;
+  nio->endian = airEndianUnknown;
+  nio->skipData = AIR_TRUE;
+  if (nrrdSave(this->GetFileName(), nrrd, nio))
+    {
+    char *err = biffGetDone(NRRD);
+    vtkErrorMacro("Write: Error writing header of "
+                      << this->GetFileName() << ":\n" << err);
+    nrrdIoStateNix(nio);
+    return false;
+    }
+  nio = nrrdIoStateNix(nio);
+
+  // Make sure the header ends with an empty line
+  bool headerTerminated = false;
+  {
+  std::ifstream header(this->GetFileName(), std::ios::in | std::ios::binary);
+  header.seekg(-2, std::ios::end);
+  char lastCharacters[2] = { 0, 0 };
+  header.read(lastCharacters, 2);
+  headerTerminated = header.good() && lastCharacters[0] == '\n' && lastCharacters[1] == '\n';
+  }
+
+  std::ofstream output(this->GetFileName(), std::ios::out | std::ios::binary | std::ios::app);
+  if (!output.good())
+    {
+    vtkErrorMacro("Write: Error opening " << this->GetFileName() << " for writing");
+    return false;
+    }
+  if (!headerTerminated)
+    {
+    output.put('\n');
+    }
+
+  // gzip member header: deflate method, no flags, no time stamp, Unix
+  const unsigned char gzipHeader[10] = { 0x1f, 0x8b, 8, 0, 0, 0, 0, 0, 0, 3 };
+  output.write(reinterpret_cast<const char*>(gzipHeader), sizeof(gzipHeader));
+
+  const unsigned char* data = static_cast<const unsigned char*>(nrrd->data);
+  size_t dataSize = nrrdElementNumber(nrrd) * nrrdElementSize(nrrd);
+  size_t numberOfChunks = (dataSize + GzipChunkSize - 1) / GzipChunkSize;
+  int level = (this->CompressionLevel < 0 ? Z_DEFAULT_COMPRESSION : this->CompressionLevel);
+
+  // Compress a window of chunks at a time to bound memory usage,
+  // compressed chunks are written in order.
+  uLong crc = crc32(0L, Z_NULL, 0);
+  const size_t windowSize = static_cast<size_t>(numberOfThreads) * 4;
+  for (size_t windowStart = 0; windowStart < numberOfChunks; windowStart += windowSize)
+    {
+    size_t windowChunks = std::min(windowSize, numberOfChunks - windowStart);
+    std::vector<std::vector<unsigned char> > compressedChunks(windowChunks);
+    std::vector<uLong> chunkCrcs(windowChunks, 0);
+    std::atomic<size_t> nextChunk(0);
+    std::atomic<bool> failed(false);
+    auto compressChunks = [&]()
+      {
+      for (size_t i = nextChunk++; i < windowChunks; i = nextChunk++)
+        {
+        size_t chunkIndex = windowStart + i;
+        size_t offset = chunkIndex * GzipChunkSize;
+        size_t size = std::min(GzipChunkSize, dataSize - offset);
+        chunkCrcs[i] = crc32(0L, data + offset, static_cast<uInt>(size));
+        if (!DeflateChunk(data + offset, size, level, chunkIndex == numberOfChunks - 1, compressedChunks[i]))
+          {
+          failed = true;
+          }
+        }
+      };
+    std::vector<std::thread> threads;
+    for (size_t threadIndex = 0; threadIndex < std::min(static_cast<size_t>(numberOfThreads), windowChunks); ++threadIndex)
+      {
+      threads.push_back(std::thread(compressChunks));
+      }
+    for (std::vector<std::thread>::iterator threadIt = threads.begin(); threadIt != threads.end(); ++threadIt)
+      {
+      threadIt->join();
+      }
+    if (failed)
+      {
+      vtkErrorMacro("Write: Error compressing data of " << this->GetFileName());
+      return false;
+      }
+    for (size_t i = 0; i < windowChunks; ++i)
+      {
+      size_t offset = (windowStart + i) * GzipChunkSize;
+      size_t size = std::min(GzipChunkSize, dataSize - offset);
+      output.write(reinterpret_cast<const char*>(compressedChunks[i].data()), compressedChunks[i].size());
+      crc = crc32_combine(crc, chunkCrcs[i], static_cast<z_off_t>(size));
+      }
+    }
+
+  // gzip member trailer: CRC-32 and size modulo 2^32 of the uncompressed data
+  WriteLittleEndian32(output, crc);
+  WriteLittleEndian32(output, static_cast<uLong>(dataSize & 0xffffffffUL));
+  output.close();
+  if (output.fail())
+    {
+    vtkErrorMacro("Write: Error writing data of " << this->GetFileName());
+    return false;
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
 void vtkTeemNRRDWriter::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os,indent);
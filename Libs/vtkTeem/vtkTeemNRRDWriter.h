@@ -58,6 +58,16 @@ public:
   vtkSetClampMacro(CompressionLevel, int, 0, 9);
   vtkGetMacro(CompressionLevel, int);
 
+  /// Number of threads used for gzip compression.
+  /// If it is not 1, the data is split into chunks that are compressed
+  /// concurrently into a single gzip stream (similarly to pigz), which
+  /// any gzip decoder can read. 0 means one thread per core.
+  /// Only used for binary data with attached header (.nrrd files),
+  /// other files are compressed on a single thread by teem.
+  /// Default is 0.
+  vtkSetClampMacro(NumberOfCompressionThreads, int, 0, 256);
+  vtkGetMacro(NumberOfCompressionThreads, int);
+
   vtkSetClampMacro(FileType,int,VTK_ASCII,VTK_BINARY);
   vtkGetMacro(FileType,int);
   void SetFileTypeToASCII() {this->SetFileType(VTK_ASCII);};
@@ -123,6 +133,7 @@ protected:
 
   int UseCompression;
   int CompressionLevel;
+  int NumberOfCompressionThreads;
   int FileType;
 
   AttributeMapType *Attributes;
@@ -136,6 +147,9 @@ private:
   void operator=(const vtkTeemNRRDWriter&) = delete;
   void vtkImageDataInfoToNrrdInfo(vtkImageData *in, int &nrrdKind, size_t &numComp, int &vtkType, void **buffer);
   int VTKToNrrdPixelType( const int vtkPixelType );
+  /// Write the header with teem and append the gzip-compressed data,
+  /// compressed on multiple threads. Return false if writing failed.
+  bool WriteCompressedDataMultiThreaded(Nrrd* nrrd, int numberOfThreads);
   int DiffusionWeightedData;
 };
 
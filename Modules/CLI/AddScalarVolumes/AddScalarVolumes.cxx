@@ -16,8 +16,7 @@
 =========================================================================*/
 #include "itkImageFileWriter.h"
 
-#include "itkResampleImageFilter.h"
-#include "itkConstrainedValueAdditionImageFilter.h"
+#include "itkVoxelExpressionImageFilter.h"
 #include "itkBSplineInterpolateImageFunction.h"
 #include "itkPluginUtilities.h"
 #include "AddScalarVolumesCLP.h"
@@ -45,9 +44,8 @@ int DoIt( int argc, char * argv[], T )
   typedef itk::ImageFileReader<InputImageType>  ReaderType;
   typedef itk::ImageFileWriter<OutputImageType> WriterType;
 
-  typedef itk::BSplineInterpolateImageFunction<InputImageType>                                       Interpolator;
-  typedef itk::ResampleImageFilter<InputImageType, OutputImageType>                                  ResampleType;
-  typedef itk::ConstrainedValueAdditionImageFilter<InputImageType, OutputImageType, OutputImageType> FilterType;
+  typedef itk::BSplineInterpolateImageFunction<InputImageType>             Interpolator;
+  typedef itk::VoxelExpressionImageFilter<InputImageType, OutputImageType> FilterType;
 
   typename ReaderType::Pointer reader1 = ReaderType::New();
   itk::PluginFilterWatcher watchReader1(reader1, "Read Volume 1",
@@ -64,23 +62,15 @@ int DoIt( int argc, char * argv[], T )
   reader1->Update();
   reader2->Update();
 
+  // Volume 2 is interpolated if the two volumes have different geometry
   typename Interpolator::Pointer interp = Interpolator::New();
-  interp->SetInputImage(reader2->GetOutput() );
   interp->SetSplineOrder(order);
 
-  typename ResampleType::Pointer resample = ResampleType::New();
-  resample->SetInput(reader2->GetOutput() );
-  resample->SetOutputParametersFromImage(reader1->GetOutput() );
-  resample->SetInterpolator( interp );
-  resample->SetDefaultPixelValue( 0 );
-  resample->ReleaseDataFlagOn();
-
-  itk::PluginFilterWatcher watchResample(resample, "Resampling",
-                                         CLPProcessInformation);
-
   typename FilterType::Pointer filter = FilterType::New();
-  filter->SetInput1( reader1->GetOutput() );
-  filter->SetInput2( resample->GetOutput() );
+  filter->SetInput( 0, reader1->GetOutput() );
+  filter->SetInput( 1, reader2->GetOutput() );
+  filter->SetInterpolator( 1, interp );
+  filter->AppendAdd( 1 );
 
   itk::PluginFilterWatcher watchFilter(filter, "Adding",
                                        CLPProcessInformation);
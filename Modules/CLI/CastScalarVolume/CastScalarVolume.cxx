@@ -10,7 +10,7 @@
 =========================================================================*/
 #include "itkImageFileWriter.h"
 
-#include "itkCastImageFilter.h"
+#include "itkVoxelExpressionImageFilter.h"
 
 #include "itkPluginUtilities.h"
 #include "CastScalarVolumeCLP.h"
@@ -38,7 +38,8 @@ int DoIt( int argc, char * argv[], Tin, Tout )
   typedef itk::ImageFileReader<InputImageType>  ReaderType;
   typedef itk::ImageFileWriter<OutputImageType> WriterType;
 
-  typedef itk::CastImageFilter<
+  // Without operations the filter only casts the voxels
+  typedef itk::VoxelExpressionImageFilter<
     InputImageType, OutputImageType>  FilterType;
 
   typename ReaderType::Pointer reader1 = ReaderType::New();
@@ -17,6 +17,13 @@ command line processing and additional features have been added.
 #include "itkShiftScaleImageFilter.h"
 #include "itkGDCMImageIO.h"
 #include "itkMetaDataObject.h"
+#include "itkMultiThreaderBase.h"
+
+#include "gdcmUIDGenerator.h"
+
+// STD includes
+#include <mutex>
+#include <vector>
 
 #include "CreateDICOMSeriesCLP.h"
 
@@ -102,6 +109,7 @@ int DoIt( int argc, char * argv[])
   typedef itk::MetaDataDictionary DictionaryType;
   unsigned int numberOfSlices = image->GetLargestPossibleRegion().GetSize()[2];
 
+  // Only used for getting the UID prefix
   typename ImageIOType::Pointer gdcmIO = ImageIOType::New();
   DictionaryType       dictionary;
 
@@ -347,42 +355,107 @@ int DoIt( int argc, char * argv[])
   // Set study, series, and frame of reference UIDs
   if (studyInstanceUID.empty() && seriesInstanceUID.empty() && frameOfReferenceInstanceUID.empty())
     {
-    // no UIDs are specified, so we ask ITK DICOM IO to generate them.
-    gdcmIO->SetKeepOriginalUID(false);
+    // no UIDs are specified, so we generate them (with the UID root of ITK DICOM IO).
+    // Slices are written by separate DICOM IO objects, which would each generate
+    // different UIDs, therefore the UIDs of the series are generated here.
+    gdcm::UIDGenerator::SetRoot(gdcmIO->GetUIDPrefix().c_str());
+    gdcm::UIDGenerator uidGenerator;
+    studyInstanceUID = uidGenerator.Generate();
+    seriesInstanceUID = uidGenerator.Generate();
+    frameOfReferenceInstanceUID = uidGenerator.Generate();
     }
-  else
+  else if (studyInstanceUID.empty() || seriesInstanceUID.empty() || frameOfReferenceInstanceUID.empty())
     {
     // ITK DICOM IO either sets all UIDs or none of them, so we return with error if not all UIDs are specified
-    if (studyInstanceUID.empty() || seriesInstanceUID.empty() || frameOfReferenceInstanceUID.empty())
+    std::cerr << "If any of UIDs (studyInstanceUID, seriesInstanceUID, and frameOfReferenceInstanceUID)"
+      << " are specified then all of them must be specified." << std::endl;
+    return EXIT_FAILURE;
+    }
+  itk::EncapsulateMetaData<std::string>(dictionary, "0020|000d", studyInstanceUID);
+  itk::EncapsulateMetaData<std::string>(dictionary, "0020|000e", seriesInstanceUID);
+  itk::EncapsulateMetaData<std::string>(dictionary, "0020|0052", frameOfReferenceInstanceUID);
+
+  // -----------------------------------------
+  // Tags that are the same for all slices
+
+  // Image Orientation (Patient)
+  value.str("");
+  value << oMatrix[0][0] << "\\" << oMatrix[1][0] << "\\" << oMatrix[2][0] << "\\";
+  value << oMatrix[0][1] << "\\" << oMatrix[1][1] << "\\" << oMatrix[2][1];
+  itk::EncapsulateMetaData<std::string>(dictionary, "0020|0037", value.str() );
+
+  // Slice Thickness
+  value.str("");
+  value << spacing[2];
+  itk::EncapsulateMetaData<std::string>(dictionary, "0018|0050", value.str() );
+
+  // Always set the rescale interscept and rescale slope (even if
+  // they are at their defaults of 0 and 1 respectively).
+  // value.str("");
+  // value << rescaleIntercept;
+  // itk::EncapsulateMetaData<std::string>(dictionary, "0028|1052", value.str());
+  // value.str("");
+  // value << rescaleSlope;
+  // itk::EncapsulateMetaData<std::string>(dictionary, "0028|1053", value.str());
+
+  // If window center and width are specified then use the same values for all slices.
+  // Otherwise use the full scalar range of voxels in each slice.
+  const bool computeWindow = windowCenter.empty() || windowWidth.empty();
+  if (!computeWindow)
+    {
+    itk::EncapsulateMetaData<std::string>(dictionary, "0028|1050", windowCenter);
+    itk::EncapsulateMetaData<std::string>(dictionary, "0028|1051", windowWidth);
+    }
+
+  // On Windows, it is hard to pass a string such as "%04d" via command-line, as the % is interpreted as an escape character,
+  // therefore we allow the user to omit the leading "%". If the format string does not start with "%" then we add it here.
+  if (!dicomNumberFormat.empty())
+    {
+    if (dicomNumberFormat[0] != '%')
       {
-      std::cerr << "If any of UIDs (studyInstanceUID, seriesInstanceUID, and frameOfReferenceInstanceUID)"
-        << " are specified then all of them must be specified." << std::endl;
-      return EXIT_FAILURE;
+      dicomNumberFormat = "%" + dicomNumberFormat;
+      }
+    }
+
+  // SOP instance UIDs are generated before writing, as the UID generator is not thread-safe
+  std::vector<std::string> sopInstanceUIDs(numberOfSlices);
+    {
+    gdcm::UIDGenerator::SetRoot(gdcmIO->GetUIDPrefix().c_str());
+    gdcm::UIDGenerator uidGenerator;
+    for (unsigned int i = 0; i < numberOfSlices; i++)
+      {
+      sopInstanceUIDs[i] = uidGenerator.Generate();
       }
-    gdcmIO->SetKeepOriginalUID(true);
-    itk::EncapsulateMetaData<std::string>(dictionary, "0020|000d", studyInstanceUID);
-    itk::EncapsulateMetaData<std::string>(dictionary, "0020|000e", seriesInstanceUID);
-    itk::EncapsulateMetaData<std::string>(dictionary, "0020|0052", frameOfReferenceInstanceUID);
     }
 
   // -----------------------------------------
   // For each slice
 
-  float progress = 1.0 / (float) numberOfSlices;
-  for( unsigned int i = 0; i < numberOfSlices; i++ )
+  // Slices are extracted, encoded, and written concurrently. Each slice uses its own
+  // copy of the shared tags, extractor, DICOM IO, and writer.
+  std::mutex outputMutex;
+  unsigned int numberOfWrittenSlices = 0;
+  bool writeFailed = false;
+  auto writeSlice = [&](unsigned int i)
     {
-    std::cout << "<filter-progress>"
-              << (i + 1) * progress
-              << "</filter-progress>"
-              << std::endl
-              << std::flush;
+      {
+      std::lock_guard<std::mutex> lock(outputMutex);
+      if (writeFailed)
+        {
+        return;
+        }
+      }
 
+    DictionaryType sliceDictionary = dictionary;
     std::ostringstream value;
 
     // Instance Number (required, empty if unknown)
     value.str("");
     value << i + 1;
-    itk::EncapsulateMetaData<std::string>(dictionary, "0020|0013", value.str());
+    itk::EncapsulateMetaData<std::string>(sliceDictionary, "0020|0013", value.str());
+
+    // SOP Instance UID (required)
+    itk::EncapsulateMetaData<std::string>(sliceDictionary, "0008|0018", sopInstanceUIDs[i]);
 
     // Image Position (Patient)
     typename Image3DType::PointType    origin;
@@ -392,27 +465,7 @@ int DoIt( int argc, char * argv[])
     image->TransformIndexToPhysicalPoint(index, origin);
     value.str("");
     value << origin[0] << "\\" << origin[1] << "\\" << origin[2];
-    itk::EncapsulateMetaData<std::string>(dictionary, "0020|0032", value.str() );
-
-    // Image Orientation (Patient)
-    value.str("");
-    value << oMatrix[0][0] << "\\" << oMatrix[1][0] << "\\" << oMatrix[2][0] << "\\";
-    value << oMatrix[0][1] << "\\" << oMatrix[1][1] << "\\" << oMatrix[2][1];
-    itk::EncapsulateMetaData<std::string>(dictionary, "0020|0037", value.str() );
-
-    // Slice Thickness
-    value.str("");
-    value << spacing[2];
-    itk::EncapsulateMetaData<std::string>(dictionary, "0018|0050", value.str() );
-
-    // Always set the rescale interscept and rescale slope (even if
-    // they are at their defaults of 0 and 1 respectively).
-    // value.str("");
-    // value << rescaleIntercept;
-    // itk::EncapsulateMetaData<std::string>(dictionary, "0028|1052", value.str());
-    // value.str("");
-    // value << rescaleSlope;
-    // itk::EncapsulateMetaData<std::string>(dictionary, "0028|1053", value.str());
+    itk::EncapsulateMetaData<std::string>(sliceDictionary, "0020|0032", value.str() );
 
     typename Image3DType::RegionType extractRegion;
     typename Image3DType::SizeType   extractSize;
@@ -436,13 +489,11 @@ int DoIt( int argc, char * argv[])
     extract->SetDirectionCollapseToGuess();  // ITKv3 compatible, but not recommended
     extract->SetInput(image );
     extract->SetExtractionRegion(extractRegion);
+    // Slices are already processed in parallel
+    extract->SetNumberOfWorkUnits(1);
     extract->Update();
 
-    // If window center and width are specified then use the same values for all slices.
-    // Otherwise use the full scalar range of voxels in the current slice.
-    std::string currentWindowCenter = windowCenter;
-    std::string currentWindowWidth = windowWidth;
-    if (currentWindowCenter.empty() || currentWindowWidth.empty())
+    if (computeWindow)
       {
       // Window width and center are required attributes (if VOI LUT sequence is not present), therefore
       // if the value is not specified then set it to include the full range of voxel values.
@@ -466,52 +517,70 @@ int DoIt( int argc, char * argv[])
 
       value.str("");
       value << windowCenterValue;
-      currentWindowCenter = value.str();
+      itk::EncapsulateMetaData<std::string>(sliceDictionary, "0028|1050", value.str());
 
       value.str("");
       value << windowWidthValue;
-      currentWindowWidth = value.str();
+      itk::EncapsulateMetaData<std::string>(sliceDictionary, "0028|1051", value.str());
       }
-    itk::EncapsulateMetaData<std::string>(dictionary, "0028|1050", currentWindowCenter);
-    itk::EncapsulateMetaData<std::string>(dictionary, "0028|1051", currentWindowWidth);
 
-    extract->GetOutput()->SetMetaDataDictionary(dictionary);
+    extract->GetOutput()->SetMetaDataDictionary(sliceDictionary);
 
-    typename WriterType::Pointer writer = WriterType::New();
     char                imageNumber[BUFSIZ+1];
     imageNumber[BUFSIZ] = '\0';
-
 #if WIN32
 #define snprintf sprintf_s
 #endif
-    // On Windows, it is hard to pass a string such as "%04d" via command-line, as the % is interpreted as an escape character,
-    // therefore we allow the user to omit the leading "%". If the format string does not start with "%" then we add it here.
-    if (!dicomNumberFormat.empty())
-      {
-      if (dicomNumberFormat[0] != '%')
-        {
-        dicomNumberFormat = "%" + dicomNumberFormat;
-        }
-      }
     snprintf(imageNumber, BUFSIZ, dicomNumberFormat.c_str(), i + 1);
     value.str("");
     value << dicomDirectory << "/" << dicomPrefix << imageNumber << ".dcm";
-    writer->SetFileName(value.str().c_str() );
 
+    // All UIDs are set in the dictionary
+    typename ImageIOType::Pointer sliceIO = ImageIOType::New();
+    sliceIO->SetKeepOriginalUID(true);
+
+    typename WriterType::Pointer writer = WriterType::New();
+    writer->SetFileName(value.str().c_str() );
     writer->SetInput(extract->GetOutput() );
     writer->SetUseCompression(useCompression);
     try
       {
-      writer->SetImageIO(gdcmIO);
+      writer->SetImageIO(sliceIO);
       writer->Update();
       }
     catch( itk::ExceptionObject & excp )
       {
-      std::cerr << "Exception thrown while writing the file " << std::endl;
-      std::cerr << excp << std::endl;
-      return EXIT_FAILURE;
+      std::lock_guard<std::mutex> lock(outputMutex);
+      if (!writeFailed)
+        {
+        std::cerr << "Exception thrown while writing the file " << std::endl;
+        std::cerr << excp << std::endl;
+        writeFailed = true;
+        }
+      return;
       }
+
+    std::lock_guard<std::mutex> lock(outputMutex);
+    ++numberOfWrittenSlices;
+    std::cout << "<filter-progress>"
+              << static_cast<float>(numberOfWrittenSlices) / static_cast<float>(numberOfSlices)
+              << "</filter-progress>"
+              << std::endl
+              << std::flush;
+    };
+
+  itk::MultiThreaderBase::Pointer threader = itk::MultiThreaderBase::New();
+  if (numberOfThreads > 0)
+    {
+    threader->SetMaximumNumberOfThreads(numberOfThreads);
+    threader->SetNumberOfWorkUnits(numberOfThreads);
     }
+  threader->ParallelizeArray(0, numberOfSlices, writeSlice, nullptr);
+  if (writeFailed)
+    {
+    return EXIT_FAILURE;
+    }
+
   std::cout << "<filter-end>" << std::endl;
   std::cout << "<filter-name>ImageFileWriter</filter-name>" << std::endl;
   std::cout << "</filter-end>";
@@ -19,6 +19,7 @@
 #define itkBSplineImageToImageRegistrationMethod_h
 
 #include "itkImage.h"
+#include "itkArray2D.h"
 #include "itkBSplineDeformableTransform.h"
 
 #include "itkOptimizedImageToImageRegistrationMethod.h"
@@ -62,6 +63,8 @@ public:
 
   typedef typename BSplineTransformType::ParametersType ParametersType;
 
+  typedef Array2D<unsigned int> PyramidScheduleType;
+
   //
   // Methods from Superclass
   //
@@ -91,6 +94,13 @@ public:
   itkSetClampMacro( NumberOfLevels, unsigned int, 1, 5 );
   itkGetConstMacro( NumberOfLevels, unsigned int );
 
+  /** Shrink factors of the fixed and moving image pyramids, one row per level
+   *  (coarsest level first) and one column per image dimension.
+   *  If empty (default), the schedule is derived from the number of control
+   *  points and the number of levels. */
+  itkSetMacro( PyramidSchedule, PyramidScheduleType );
+  itkGetConstReferenceMacro( PyramidSchedule, PyramidScheduleType );
+
   BSplineTransformPointer GetBSplineTransform() const;
 
   void ComputeGridRegion( int numberOfControlPoints,
@@ -129,6 +139,8 @@ private:
 
   unsigned int m_NumberOfLevels;
 
+  PyramidScheduleType m_PyramidSchedule;
+
   bool m_GradientOptimizeOnly;
 
 };
@@ -533,6 +533,26 @@ BSplineImageToImageRegistrationMethod<TImage>
       }
     }
 
+  /**/
+  /*   An explicit schedule replaces the one derived from the control points */
+  /**/
+  if( m_PyramidSchedule.rows() > 0 )
+    {
+    if( m_PyramidSchedule.rows() != this->m_NumberOfLevels
+        || m_PyramidSchedule.cols() != ImageDimension )
+      {
+      itkExceptionMacro(<< "PyramidSchedule must have " << this->m_NumberOfLevels
+                        << " rows (levels) and " << ImageDimension << " columns, it has "
+                        << m_PyramidSchedule.rows() << " x " << m_PyramidSchedule.cols() );
+      }
+    fixedSchedule = m_PyramidSchedule;
+    movingSchedule = m_PyramidSchedule;
+    }
+  if( this->GetReportProgress() )
+    {
+    std::cout << "   Pyramid schedule = " << std::endl << fixedSchedule << std::endl;
+    }
+
   /**/
   /*   Third, apply pyramid to fixed image */
   /**/
@@ -636,6 +656,9 @@ BSplineImageToImageRegistrationMethod<TImage>
     reg->SetExpectedDeformationMagnitude( levelDeformationMagnitude );
     reg->SetGradientOptimizeOnly( true );
     reg->SetTargetError( this->GetTargetError() );
+    reg->SetRegistrationNumberOfThreads( this->GetRegistrationNumberOfThreads() );
+    reg->SetRandomNumberSeed( this->GetRandomNumberSeed() );
+    reg->SetUseFixedImageSampleSet( this->GetUseFixedImageSampleSet() );
     reg->SetSampleFromOverlap( this->GetSampleFromOverlap() );
     reg->SetFixedImageSamplesIntensityThreshold(
       this->GetFixedImageSamplesIntensityThreshold() );
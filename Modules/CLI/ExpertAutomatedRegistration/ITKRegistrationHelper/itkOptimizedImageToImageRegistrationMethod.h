@@ -55,6 +55,10 @@ public:
 
   typedef typename TransformType::ParametersType TransformParametersScalesType;
 
+  typedef typename Superclass::PointType PointType;
+
+  typedef typename Superclass::MaskObjectType MaskObjectType;
+
   itkStaticConstMacro( ImageDimension, unsigned int,
                        TImage::ImageDimension );
 
@@ -109,6 +113,14 @@ public:
   itkSetMacro( NumberOfSamples, unsigned int );
   itkGetConstMacro( NumberOfSamples, unsigned int );
 
+  /** If enabled (default), the fixed image samples are drawn once before the
+   *  optimization and every metric evaluation uses the same samples. Otherwise
+   *  the metric draws new samples each time it is initialized, unless samples
+   *  have to be restricted (region of interest, overlap, threshold or mask). */
+  itkSetMacro( UseFixedImageSampleSet, bool );
+  itkGetConstMacro( UseFixedImageSampleSet, bool );
+  itkBooleanMacro( UseFixedImageSampleSet );
+
   itkSetMacro( UseFixedImageSamplesIntensityThreshold, bool );
   itkGetConstMacro( UseFixedImageSamplesIntensityThreshold, bool );
   void SetFixedImageSamplesIntensityThreshold( PixelType val );
@@ -141,8 +153,16 @@ protected:
   typedef InterpolateImageFunction<TImage, double> InterpolatorType;
   typedef ImageToImageMetric<TImage, TImage>       MetricType;
 
+  typedef typename MetricType::FixedImageIndexContainer FixedImageIndexContainer;
+
   virtual void Optimize( MetricType * metric, InterpolatorType * interpolator );
 
+  /** Randomly select NumberOfSamples fixed image voxels that meet the sampling
+   *  criteria (region of interest, overlap, intensity threshold, mask).
+   *  Candidate voxels are found in parallel and the selected indices are
+   *  sorted in memory order. */
+  virtual void ComputeFixedImageSamples( FixedImageIndexContainer & indexList );
+
   void PrintSelf( std::ostream & os, Indent indent ) const override;
 
 private:
@@ -167,6 +187,8 @@ private:
 
   unsigned int m_NumberOfSamples;
 
+  bool m_UseFixedImageSampleSet;
+
   bool      m_UseFixedImageSamplesIntensityThreshold;
   PixelType m_FixedImageSamplesIntensityThreshold;
 
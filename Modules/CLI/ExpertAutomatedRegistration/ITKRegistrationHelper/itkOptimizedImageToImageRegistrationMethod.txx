@@ -43,6 +43,9 @@
 #include "itkImageMaskSpatialObject.h"
 
 #include "itkImage.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
+#include "itkMersenneTwisterRandomVariateGenerator.h"
+#include "itkMultiThreaderBase.h"
 #include <itkConstantBoundaryCondition.h>
 
 
@@ -158,6 +161,7 @@ OptimizedImageToImageRegistrationMethod<TImage>::OptimizedImageToImageRegistrati
   //   registration.  Other derived registration methods should use
   //   their own default.
   m_NumberOfSamples = 100000;
+  m_UseFixedImageSampleSet = true;
   m_FixedImageSamplesIntensityThreshold = 0;
   m_UseFixedImageSamplesIntensityThreshold = false;
 
@@ -241,8 +245,13 @@ void OptimizedImageToImageRegistrationMethod<TImage>::GenerateData()
   metric->SetMovingImage( movingImage );
 
   metric->SetNumberOfSpatialSamples( m_NumberOfSamples );
+  if( this->GetRegistrationNumberOfThreads() > 0 )
+    {
+    metric->SetNumberOfWorkUnits( this->GetRegistrationNumberOfThreads() );
+    }
 
-  if( this->GetUseRegionOfInterest() ||
+  if( this->GetUseFixedImageSampleSet() ||
+      this->GetUseRegionOfInterest() ||
       this->GetSampleFromOverlap() ||
       this->GetUseFixedImageSamplesIntensityThreshold() ||
       this->GetUseFixedImageMaskObject() )
@@ -251,138 +260,20 @@ void OptimizedImageToImageRegistrationMethod<TImage>::GenerateData()
       {
       std::cout << "Creating fixed image samples" << std::endl;
       }
-
-    itk::ImageRegionConstIteratorWithIndex<ImageType> iter( fixedImage,
-                                                            fixedImage->GetLargestPossibleRegion() );
-    typename ImageType::IndexType index;
-    typename ImageType::IndexType movingIndex;
-    typename MetricType::InputPointType fixedPoint;
-    typename MetricType::InputPointType movingPoint;
-
-    iter.GoToBegin();
-    int count = 0;
-    for( iter.GoToBegin(); !iter.IsAtEnd(); ++iter )
-      {
-      index = iter.GetIndex();
-      fixedImage->TransformIndexToPhysicalPoint(index, fixedPoint);
-      if( this->GetSampleFromOverlap() )
-        {
-        movingPoint = this->GetTransform()->TransformPoint( fixedPoint );
-        if( !movingImage->TransformPhysicalPointToIndex( movingPoint, movingIndex ) )
-          {
-          continue;
-          }
-        }
-      if( this->GetUseFixedImageSamplesIntensityThreshold() )
-        {
-        if( iter.Get() < this->m_FixedImageSamplesIntensityThreshold )
-          {
-          continue;
-          }
-        }
-      if( this->GetUseFixedImageMaskObject() )
-        {
-        double val;
-        if( this->GetFixedImageMaskObject()->ValueAtInWorldSpace( fixedPoint, val ) )
-          {
-          if( val == 0 )
-            {
-            continue;
-            }
-          }
-        }
-      if( this->GetUseRegionOfInterest() )
-        {
-        bool isInside = true;
-        for( unsigned int i = 0; i < ImageDimension; i++ )
-          {
-          if( !( (fixedPoint[i] >= this->GetRegionOfInterestPoint1()[i] &&
-                  fixedPoint[i] <= this->GetRegionOfInterestPoint2()[i])
-                 || (fixedPoint[i] >= this->GetRegionOfInterestPoint2()[i] &&
-                     fixedPoint[i] <= this->GetRegionOfInterestPoint1()[i]) ) )
-            {
-            isInside = false;
-            break;
-            }
-          }
-        if( !isInside )
-          {
-          continue;
-          }
-        }
-
-      ++count;
-      }
-    double samplingRate = (double)(m_NumberOfSamples + 2) / (double)count;
-    if( this->GetReportProgress() )
-      {
-      std::cout << "...Second pass, sampling rate = " << samplingRate << std::endl;
-      }
-
-    if( samplingRate > 1 )
-      {
-      samplingRate = 1;
-      itkWarningMacro(<< "Adjusting the number of samples due to restrictive threshold/overlap criteria.");
-      this->SetNumberOfSamples( count );
-      metric->SetNumberOfSpatialSamples( m_NumberOfSamples );
-      }
-    double step = 0;
-    typename MetricType::FixedImageIndexContainer indexList;
-    indexList.clear();
-    for( iter.GoToBegin(); !iter.IsAtEnd(); ++iter )
-      {
-      index = iter.GetIndex();
-      fixedImage->TransformIndexToPhysicalPoint(index, fixedPoint);
-      if( this->GetSampleFromOverlap() )
-        {
-        movingPoint = this->GetTransform()->TransformPoint( fixedPoint );
-        if( !movingImage->TransformPhysicalPointToIndex( movingPoint, movingIndex ) )
-          {
-          continue;
-          }
-        }
-      if( this->GetUseFixedImageSamplesIntensityThreshold() )
-        {
-        if( iter.Get() < this->m_FixedImageSamplesIntensityThreshold )
-          {
-          continue;
-          }
-        }
-      if( this->GetUseFixedImageMaskObject() )
-        {
-        double val;
-        if( this->GetFixedImageMaskObject()->ValueAtInWorldSpace( fixedPoint, val ) )
-          {
-          if( val == 0 )
-            {
-            continue;
-            }
-          }
-        }
-      step = step + samplingRate;
-      if( step > 1 )
-        {
-        indexList.push_back( index );
-        while( step > 1 )
-          {
-          step -= 1;
-          }
-
-        if( indexList.size() == m_NumberOfSamples )
-          {
-          break;
-          }
-        }
-      }
+    FixedImageIndexContainer indexList;
+    this->ComputeFixedImageSamples( indexList );
     if( indexList.size() != m_NumberOfSamples )
       {
-      itkWarningMacro(<< "Full set of samples not collected. Collected "
+      itkWarningMacro(<< "Adjusting the number of samples due to restrictive threshold/overlap criteria. Collected "
                       << indexList.size() << " of " << m_NumberOfSamples );
       this->SetNumberOfSamples( indexList.size() );
       metric->SetNumberOfSpatialSamples( m_NumberOfSamples );
       }
-    std::cout << "Passing index list to metric..." << std::endl;
-    std::cout << "  List size = " << indexList.size() << std::endl;
+    if( this->GetReportProgress() )
+      {
+      std::cout << "Passing index list to metric..." << std::endl;
+      std::cout << "  List size = " << indexList.size() << std::endl;
+      }
     metric->SetFixedImageIndexes( indexList );
     }
 
@@ -432,6 +323,137 @@ void OptimizedImageToImageRegistrationMethod<TImage>::GenerateData()
     }
 }
 
+template <class TImage>
+void
+OptimizedImageToImageRegistrationMethod<TImage>
+::ComputeFixedImageSamples( FixedImageIndexContainer & indexList )
+{
+  typename ImageType::ConstPointer fixedImage = this->GetFixedImage();
+  typename ImageType::ConstPointer movingImage = this->GetMovingImage();
+  typedef typename ImageType::RegionType RegionType;
+  const RegionType region = fixedImage->GetBufferedRegion();
+
+  // The sampling criteria are read once, the candidate test below runs in
+  // several threads at the same time
+  const TransformType * transform = this->GetTransform();
+  const MaskObjectType * fixedMask = this->GetUseFixedImageMaskObject()
+    ? this->GetFixedImageMaskObject() : nullptr;
+  const bool sampleFromOverlap = this->GetSampleFromOverlap();
+  const bool useThreshold = this->GetUseFixedImageSamplesIntensityThreshold();
+  const PixelType threshold = this->GetFixedImageSamplesIntensityThreshold();
+  const bool useRegionOfInterest = this->GetUseRegionOfInterest();
+  const PointType roiPoint1 = this->GetRegionOfInterestPoint1();
+  const PointType roiPoint2 = this->GetRegionOfInterestPoint2();
+
+  /**/
+  /*   First pass, in parallel: mark the voxels that can be sampled */
+  /**/
+  std::vector<unsigned char> isCandidate( region.GetNumberOfPixels(), 0 );
+  MultiThreaderBase::Pointer multiThreader = MultiThreaderBase::New();
+  if( this->GetRegistrationNumberOfThreads() > 0 )
+    {
+    multiThreader->SetNumberOfWorkUnits( this->GetRegistrationNumberOfThreads() );
+    }
+  multiThreader->ParallelizeImageRegion<ImageDimension>( region,
+    [&](const RegionType & subRegion)
+    {
+    typename MetricType::InputPointType fixedPoint;
+    typename MetricType::InputPointType movingPoint;
+    typename ImageType::IndexType       movingIndex;
+    for( ImageRegionConstIteratorWithIndex<ImageType> iter( fixedImage, subRegion ); !iter.IsAtEnd(); ++iter )
+      {
+      if( useThreshold && iter.Get() < threshold )
+        {
+        continue;
+        }
+      const typename ImageType::IndexType & index = iter.GetIndex();
+      fixedImage->TransformIndexToPhysicalPoint( index, fixedPoint );
+      if( sampleFromOverlap )
+        {
+        movingPoint = transform->TransformPoint( fixedPoint );
+        if( !movingImage->TransformPhysicalPointToIndex( movingPoint, movingIndex ) )
+          {
+          continue;
+          }
+        }
+      if( fixedMask )
+        {
+        double val;
+        if( fixedMask->ValueAtInWorldSpace( fixedPoint, val ) && val == 0 )
+          {
+          continue;
+          }
+        }
+      if( useRegionOfInterest )
+        {
+        bool isInside = true;
+        for( unsigned int i = 0; i < ImageDimension; i++ )
+          {
+          if( !( (fixedPoint[i] >= roiPoint1[i] && fixedPoint[i] <= roiPoint2[i])
+                 || (fixedPoint[i] >= roiPoint2[i] && fixedPoint[i] <= roiPoint1[i]) ) )
+            {
+            isInside = false;
+            break;
+            }
+          }
+        if( !isInside )
+          {
+          continue;
+          }
+        }
+      isCandidate[fixedImage->ComputeOffset( index )] = 1;
+      }
+    }, nullptr );
+
+  /**/
+  /*   Second pass: select the samples among the candidates with equal
+   *   probability, in memory order (selection sampling) */
+  /**/
+  SizeValueType numberOfCandidates = 0;
+  for( std::vector<unsigned char>::const_iterator it = isCandidate.begin(); it != isCandidate.end(); ++it )
+    {
+    numberOfCandidates += *it;
+    }
+  SizeValueType numberOfSamples = m_NumberOfSamples;
+  if( numberOfSamples > numberOfCandidates )
+    {
+    numberOfSamples = numberOfCandidates;
+    }
+  if( this->GetReportProgress() )
+    {
+    std::cout << "...Selecting " << numberOfSamples << " of " << numberOfCandidates
+              << " candidate samples" << std::endl;
+    }
+
+  typedef Statistics::MersenneTwisterRandomVariateGenerator GeneratorType;
+  GeneratorType::Pointer generator = GeneratorType::New();
+  if( m_RandomNumberSeed != 0 )
+    {
+    generator->SetSeed( m_RandomNumberSeed );
+    }
+  else
+    {
+    generator->SetSeed();
+    }
+
+  indexList.clear();
+  indexList.reserve( numberOfSamples );
+  SizeValueType remainingCandidates = numberOfCandidates;
+  for( SizeValueType offset = 0; offset < isCandidate.size() && indexList.size() < numberOfSamples; ++offset )
+    {
+    if( !isCandidate[offset] )
+      {
+      continue;
+      }
+    const SizeValueType remainingSamples = numberOfSamples - indexList.size();
+    if( generator->GetVariateWithOpenUpperRange() * remainingCandidates < remainingSamples )
+      {
+      indexList.push_back( fixedImage->ComputeIndex( offset ) );
+      }
+    --remainingCandidates;
+    }
+}
+
 template <class TImage>
 void
 OptimizedImageToImageRegistrationMethod<TImage>
@@ -662,6 +684,8 @@ OptimizedImageToImageRegistrationMethod<TImage>
 
   os << indent << "Number of Samples = " << m_NumberOfSamples << std::endl;
 
+  os << indent << "Use Fixed Image Sample Set = " << m_UseFixedImageSampleSet << std::endl;
+
   os << indent << "Samples threshold = " << m_FixedImageSamplesIntensityThreshold << std::endl;
 
   os << indent << "Target Error = " << m_TargetError << std::endl;
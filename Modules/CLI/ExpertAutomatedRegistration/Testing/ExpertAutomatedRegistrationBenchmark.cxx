@@ -0,0 +1,155 @@
+// ITK includes
+#include <itkCommand.h>
+#include <itkImage.h>
+#include <itkImageRegionIteratorWithIndex.h>
+#include <itkTimeProbe.h>
+#include <itkFactoryRegistration.h>
+
+// ExpertAutomatedRegistration includes
+#include "itkAffineImageToImageRegistrationMethod.h"
+#include "itkBSplineImageToImageRegistrationMethod.h"
+#include "itkRigidImageToImageRegistrationMethod.h"
+
+// STD includes
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+
+typedef itk::Image<float, 3> ImageType;
+
+// Counts the optimizer iterations of a registration
+class IterationCounter : public itk::Command
+{
+public:
+  typedef IterationCounter         Self;
+  typedef itk::Command             Superclass;
+  typedef itk::SmartPointer<Self>  Pointer;
+
+  itkNewMacro( Self );
+
+  void Execute( itk::Object * caller, const itk::EventObject & event ) override
+  {
+    this->Execute( (const itk::Object *)caller, event );
+  }
+
+  void Execute( const itk::Object * itkNotUsed(caller), const itk::EventObject & event ) override
+  {
+    if( itk::IterationEvent().CheckEvent( &event ) )
+      {
+      ++m_NumberOfIterations;
+      }
+  }
+
+  unsigned int m_NumberOfIterations{0};
+};
+
+// Smooth blobs, shifted by offset (in voxels)
+ImageType::Pointer CreateImage( unsigned int size, double offset )
+{
+  ImageType::Pointer image = ImageType::New();
+  ImageType::SizeType imageSize;
+  imageSize.Fill( size );
+  image->SetRegions( imageSize );
+  image->Allocate();
+
+  const double frequency = 6.0 * 3.1415926 / size;
+  itk::ImageRegionIteratorWithIndex<ImageType> it( image, image->GetLargestPossibleRegion() );
+  for( it.GoToBegin(); !it.IsAtEnd(); ++it )
+    {
+    const ImageType::IndexType & index = it.GetIndex();
+    double value = 1.0;
+    for( unsigned int i = 0; i < 3; i++ )
+      {
+      value *= sin( ( index[i] - offset * (i + 1) ) * frequency );
+      }
+    it.Set( static_cast<float>( 100.0 * (1.0 + value) ) );
+    }
+  return image;
+}
+
+template <class TRegistrationMethod>
+void RunBenchmark( const char * name,
+                   typename TRegistrationMethod::Pointer reg,
+                   ImageType * fixedImage, ImageType * movingImage,
+                   unsigned int numberOfIterations, unsigned int numberOfThreads )
+{
+  typedef typename TRegistrationMethod::MetricMethodEnumType MetricMethodEnumType;
+  const MetricMethodEnumType metrics[2] = { TRegistrationMethod::MEAN_SQUARED_ERROR_METRIC,
+                                            TRegistrationMethod::MATTES_MI_METRIC };
+  const char * metricNames[2] = { "MSE", "MattesMI" };
+  for( unsigned int metricIndex = 0; metricIndex < 2; ++metricIndex )
+    {
+    IterationCounter::Pointer counter = IterationCounter::New();
+    reg->SetFixedImage( fixedImage );
+    reg->SetMovingImage( movingImage );
+    reg->SetMetricMethodEnum( metrics[metricIndex] );
+    reg->SetInterpolationMethodEnum( TRegistrationMethod::LINEAR_INTERPOLATION );
+    reg->SetUseEvolutionaryOptimization( false );
+    reg->SetMaxIterations( numberOfIterations );
+    reg->SetRandomNumberSeed( 1 );
+    if( numberOfThreads > 0 )
+      {
+      reg->SetRegistrationNumberOfThreads( numberOfThreads );
+      }
+    reg->SetObserver( counter );
+    reg->Modified();
+
+    itk::TimeProbe probe;
+    probe.Start();
+    reg->Update();
+    probe.Stop();
+
+    const unsigned int iterations = counter->m_NumberOfIterations > 0 ? counter->m_NumberOfIterations : 1;
+    std::cout << name << " " << metricNames[metricIndex]
+              << ": samples = " << reg->GetNumberOfSamples()
+              << ", iterations = " << counter->m_NumberOfIterations
+              << ", total = " << probe.GetTotal() << " s"
+              << ", time per iteration = " << probe.GetTotal() / iterations << " s"
+              << std::endl;
+    }
+}
+
+int main( int argc, char * * argv )
+{
+  itk::itkFactoryRegistration();
+
+  if( argc < 2 )
+    {
+    std::cerr << argv[0]
+              << " <imageSize> [numberOfIterations] [numberOfThreads]"
+              << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  const unsigned int size = static_cast<unsigned int>( atoi( argv[1] ) );
+  const unsigned int numberOfIterations = argc > 2 ? static_cast<unsigned int>( atoi( argv[2] ) ) : 10;
+  const unsigned int numberOfThreads = argc > 3 ? static_cast<unsigned int>( atoi( argv[3] ) ) : 0;
+  if( size < 8 )
+    {
+    std::cerr << "Image size must be at least 8" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  ImageType::Pointer fixedImage = CreateImage( size, 0.0 );
+  ImageType::Pointer movingImage = CreateImage( size, 1.5 );
+  const unsigned int numberOfPixels = size * size * size;
+
+  typedef itk::RigidImageToImageRegistrationMethod<ImageType> RigidMethodType;
+  RigidMethodType::Pointer rigid = RigidMethodType::New();
+  rigid->SetNumberOfSamples( numberOfPixels / 10 );
+  RunBenchmark<RigidMethodType>( "Rigid", rigid, fixedImage, movingImage, numberOfIterations, numberOfThreads );
+
+  typedef itk::AffineImageToImageRegistrationMethod<ImageType> AffineMethodType;
+  AffineMethodType::Pointer affine = AffineMethodType::New();
+  affine->SetNumberOfSamples( numberOfPixels / 10 );
+  RunBenchmark<AffineMethodType>( "Affine", affine, fixedImage, movingImage, numberOfIterations, numberOfThreads );
+
+  typedef itk::BSplineImageToImageRegistrationMethod<ImageType> BSplineMethodType;
+  BSplineMethodType::Pointer bspline = BSplineMethodType::New();
+  bspline->SetNumberOfSamples( numberOfPixels / 5 );
+  bspline->SetNumberOfControlPoints( 8 );
+  bspline->SetNumberOfLevels( 2 );
+  RunBenchmark<BSplineMethodType>( "BSpline", bspline, fixedImage, movingImage, numberOfIterations, numberOfThreads );
+
+  return EXIT_SUCCESS;
+}
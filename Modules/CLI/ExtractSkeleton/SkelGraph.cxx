@@ -232,145 +232,111 @@ void SkelGraph::PrintGraph()
 void SkelGraph::FindMaximalPath()
 // extract maximal path between 2 points in the m_Graph
 {
-  for (std::deque<skel_branch>::iterator branch = m_Graph.begin(); branch != m_Graph.end(); ++branch)
+  const int numberOfBranches = static_cast<int>(m_Graph.size());
+
+  // Flat adjacency list: neighbors of branch b (index = branchID - 1) are
+  // adjacentBranches[adjacencyOffsets[b]..adjacencyOffsets[b+1]-1], connected at adjacentEndPoints.
+  // End 2 neighbors are listed first, as they are visited first.
+  std::vector<int> adjacencyOffsets(numberOfBranches + 1, 0);
+  std::vector<int> adjacentBranches;
+  std::vector<Coord3i> adjacentEndPoints;
+  for (int b = 0; b < numberOfBranches; ++b)
     {
-    branch->max_path_length = 0.0;
-    branch->max_path.clear();
+    const skel_branch& branch = m_Graph[b];
+    for (std::deque<int>::const_iterator nb = branch.end_2_neighbors.begin(); nb != branch.end_2_neighbors.end(); ++nb)
+      {
+      adjacentBranches.push_back(*nb - 1);
+      adjacentEndPoints.push_back(branch.end_2_point);
+      }
+    for (std::deque<int>::const_iterator nb = branch.end_1_neighbors.begin(); nb != branch.end_1_neighbors.end(); ++nb)
+      {
+      adjacentBranches.push_back(*nb - 1);
+      adjacentEndPoints.push_back(branch.end_1_point);
+      }
+    adjacencyOffsets[b + 1] = static_cast<int>(adjacentBranches.size());
     }
 
-  for (std::deque<skel_branch>::iterator act_endbranch = m_Graph.begin(); act_endbranch != m_Graph.end(); ++act_endbranch)
+  // temporary traversal state, reused for each end branch
+  std::vector<double> accLength(numberOfBranches);
+  std::vector<int> previousBranch(numberOfBranches);
+  std::vector<char> visited(numberOfBranches);
+  std::vector<int> waitList;
+  waitList.reserve(numberOfBranches);
+
+  for (int endBranch = 0; endBranch < numberOfBranches; ++endBranch)
     {
+    skel_branch& act_endbranch = m_Graph[endBranch];
+    act_endbranch.max_path_length = 0.0;
+    act_endbranch.max_path.clear();
+
     //  search for next entry that has neighbors but
     // end_1_neighbors == nullptr OR act_endbranch->end_2_neighbors != nullptr
-    if (act_endbranch->end_1_neighbors.empty() && act_endbranch->end_2_neighbors.empty())
+    if (act_endbranch.end_1_neighbors.empty() && act_endbranch.end_2_neighbors.empty())
       {
       // no neighbors
       continue;
       }
-    if (!act_endbranch->end_1_neighbors.empty() && !act_endbranch->end_2_neighbors.empty())
+    if (!act_endbranch.end_1_neighbors.empty() && !act_endbranch.end_2_neighbors.empty())
       {
       // neighbors on both sides
       continue;
       }
 
     // reset temporary acc path and its length
-    for (std::deque<skel_branch>::iterator branch = m_Graph.begin(); branch != m_Graph.end(); ++branch)
-      {
-      branch->acc_length = 0.0;
-      branch->acc_path.clear();
-      }
-
-    // do cost traversal
-    std::deque< skel_branch* > wait_list;
-    wait_list.push_back(&(*act_endbranch));
-    while( !wait_list.empty() )
+    std::fill(accLength.begin(), accLength.end(), 0.0);
+    std::fill(previousBranch.begin(), previousBranch.end(), -1);
+    std::fill(visited.begin(), visited.end(), 0);
+
+    // do cost traversal (breadth first)
+    waitList.clear();
+    waitList.push_back(endBranch);
+    visited[endBranch] = 1;
+    for (size_t next = 0; next < waitList.size(); ++next)
       {
-      // get next entry in wait_list
-      skel_branch * act_node = *(wait_list.begin());
-      wait_list.pop_front();
-
-      // add to path
-      act_node->acc_length += act_node->length;
-      act_node->acc_path.push_back(act_node->branchID);
-      int act_pos_id = act_node->branchID;
-      std::deque<skel_branch>::iterator act_pos_list = m_Graph.begin();
-      // since the graph_id's are the location of its member in the list,
-      // we can use advance for random access
-      advance(act_pos_list, act_pos_id - 1);
-      // std::cout << "A " << act_pos_id  << std::endl;
-      for( int i = 0; i < 2; i++ )
+      const int act_node = waitList[next];
+      accLength[act_node] += m_Graph[act_node].length;
+      // add all neighbors to wait_list that are not yet treated
+      for (int adjacency = adjacencyOffsets[act_node]; adjacency < adjacencyOffsets[act_node + 1]; ++adjacency)
         {
-        std::deque<int> * cont_end = nullptr;
-        Coord3i cont_end_point;
-        if( i == 0 )
-          {
-          cont_end = &(act_node->end_2_neighbors);
-          cont_end_point = act_node->end_2_point;
-          }
-        else if( i == 1 )
-          {
-          cont_end = &(act_node->end_1_neighbors);
-          cont_end_point = act_node->end_1_point;
-          }
-        if (cont_end->empty())
+        const int act_neighbor = adjacentBranches[adjacency];
+        if (visited[act_neighbor])
           {
+          // neighbour already treated
           continue;
           }
-
-        // add all neighbors to wait_list that are not yet treated
-        for(std::deque<int>::iterator neighbors = cont_end->begin(); neighbors != cont_end->end(); ++neighbors)
-          {
-          // get neighbours entry
-          int distance = *neighbors - act_pos_id;
-          std::deque<skel_branch>::iterator act_pos_neigh = act_pos_list;
-          advance(act_pos_neigh, distance);
-          skel_branch * act_neighbor = &(*(act_pos_neigh) );
-          if (!act_neighbor->acc_path.empty())
-            {
-            // neighbour already treated
-            continue;
-            }
-          wait_list.push_back(act_neighbor);
-          // update entries of neighbour
-          // since act_point[0] - pt[0] is either [-1,0,1] -> abs == ^2
-          // add distance between branches to length at preceding branch
-          Coord3i cont_neigh_point;
-          act_neighbor->acc_length = act_node->acc_length;
-          // determine connection costs -> since we do not know which one is the
-          // corresponding endpoint of the neighbour, we have to try out and take
-          // the one combination that yields the smallest costs
-          double conn_costs1 = pointdistance(act_neighbor->end_1_point, cont_end_point);
-          double conn_costs2 = pointdistance(act_neighbor->end_2_point, cont_end_point);
-          act_neighbor->acc_length += (conn_costs1 < conn_costs2 ? conn_costs1 : conn_costs2);
-          // copy path
-          // initiate with copy of path of preceding branch
-          act_neighbor->acc_path = act_node->acc_path;
-          }
+        visited[act_neighbor] = 1;
+        waitList.push_back(act_neighbor);
+        // determine connection costs -> since we do not know which one is the
+        // corresponding endpoint of the neighbour, we have to try out and take
+        // the one combination that yields the smallest costs
+        const skel_branch& neighbor = m_Graph[act_neighbor];
+        double conn_costs1 = pointdistance(neighbor.end_1_point, adjacentEndPoints[adjacency]);
+        double conn_costs2 = pointdistance(neighbor.end_2_point, adjacentEndPoints[adjacency]);
+        accLength[act_neighbor] = accLength[act_node] + (conn_costs1 < conn_costs2 ? conn_costs1 : conn_costs2);
+        previousBranch[act_neighbor] = act_node;
         }
       }
 
     // look for maximum
-    skel_branch * act_max_node = nullptr;
+    int act_max_node = -1;
     double act_max_val = -1;
-    for (std::deque<skel_branch>::iterator branch = m_Graph.begin(); branch != m_Graph.end(); ++branch)
+    for (int b = 0; b < numberOfBranches; ++b)
+      {
+      if (accLength[b] > act_max_val)
+        {
+        act_max_val = accLength[b];
+        act_max_node = b;
+        }
+      }
+    // copy maximal path, from the end branch to the maximum
+    act_endbranch.max_path_length = act_max_val;
+    if (visited[act_max_node])
       {
-      if (branch->acc_length > act_max_val)
+      for (int b = act_max_node; b >= 0; b = previousBranch[b])
         {
-        act_max_val = branch->acc_length;
-        act_max_node = &(*(branch) );
+        act_endbranch.max_path.push_front(m_Graph[b].branchID);
         }
       }
-    // copy maximal path
-    act_endbranch->max_path_length = act_max_val;
-    act_endbranch->max_path = act_max_node->acc_path;
-
-    //     if (DEBUG_VSKEL) {
-    //       std::cout << act_endbranch->branchID
-    //      << " : max length = " << act_endbranch->max_path_length
-    //      << " | path = ";
-    //       //double len = 0.0;
-    //       std::deque<int>::iterator act_path = act_endbranch->max_path->begin();
-    //       //std::deque<skel_branch>::iterator old_pos = m_Graph.end();
-    //       while (act_path != act_endbranch->max_path->end()) {
-    //   // std::deque<skel_branch>::iterator act_pos = m_Graph.begin();
-    //   // advance(act_pos, *act_path - 1);
-    //   //len += act_pos->length;
-    //   //if (old_pos != m_Graph.end()) {
-    //   //double len1 = sqrt(abs(act_pos->end_1_point[0] - old_pos->end_2_point[0]) +
-    //   //         abs(act_pos->end_1_point[1] - old_pos->end_2_point[1]) +
-    //   //         abs(act_pos->end_1_point[2] - old_pos->end_2_point[2]));
-    //   //  double len2 = sqrt(abs(act_pos->end_2_point[0] - old_pos->end_1_point[0]) +
-    //   //         abs(act_pos->end_2_point[1] - old_pos->end_1_point[1]) +
-    //   //         abs(act_pos->end_2_point[2] - old_pos->end_1_point[2]));
-    //   //  if (len1 < len2) len += len1; else len += len2;
-    //   //}
-    //   //old_pos = act_pos;
-    //   std::cout << *act_path << ",";
-    //   // std::cout << len << "-";
-    //   ++act_path;
-    //       }
-    //       std::cout << std::endl;
-    //     }
     }
 
   // Get Maximum of all maximal paths (which is double contained, otherweise it would
@@ -24,16 +24,12 @@ struct skel_branch
   {
     branchID = -1;
     length = 0;
-    acc_length = 0;
     max_path_length = 0;
   }
   int branchID;     // == position in m_Graph
   double length; // length between end points
   std::deque<Coord3i> points;
 
-  double acc_length;  // for temporary use when searching maximal path
-  std::deque<int> acc_path;
-
   double max_path_length;
   std::deque<int> max_path;         // maximal path
 
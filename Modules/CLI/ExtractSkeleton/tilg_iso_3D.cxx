@@ -23,6 +23,9 @@
 /*****************************************************************************/
 #include <cstdio>
 #include <cstdlib>
+#include <vector>
+
+#include "itkMultiThreaderBase.h"
 
 /********************************  Konstanten  *******************************/
 #define LIM  1 /* Voxelwert >= LIM => Objekt (Input-Bild) */
@@ -608,7 +611,6 @@ void tilg_iso_3D(int dx, int dy, int dz,
   int nc, x, y, z;
   int end, i, dir, dir_mask;
   // int free_mask;
-  int *list;
   int  dir_tab[26];
 
   // int b[3][3][3];
@@ -620,12 +622,6 @@ void tilg_iso_3D(int dx, int dy, int dz,
 
   workbuf = data;
   nzz = nx * ny;
-  /* Speicher allozieren */
-  if( (list = (int *) malloc(nzz * nz * sizeof(int) / 4) ) == nullptr )
-    {
-    printf("out of memory\n");
-    return;
-    }
   /* Arbeitskopie des Bildes erstellen und binaerisieren */
   end = nx * ny * nz;
   for( i = 0; i < end; i++ )
@@ -695,8 +691,38 @@ void tilg_iso_3D(int dx, int dy, int dz,
   f_tab[16] =   131072;    /* 17 */
   f_tab[17] =      512;    /*  9 */
 
+  /* Bounding box of the object: voxels are only removed, so
+     only the bounding box needs to be scanned */
+  int xmin = nx, ymin = ny, zmin = nz;
+  int xmax = -1, ymax = -1, zmax = -1;
+  for( z = 1; z < nz - 1; z++ )
+    {
+    for( y = 1; y < ny - 1; y++ )
+      {
+      for( x = 1; x < nx - 1; x++ )
+        {
+        if( P(result, x, y, z) == OBJ )
+          {
+          xmin = (x < xmin) ? x : xmin; xmax = (x > xmax) ? x : xmax;
+          ymin = (y < ymin) ? y : ymin; ymax = (y > ymax) ? y : ymax;
+          zmin = (z < zmin) ? z : zmin; zmax = (z > zmax) ? z : zmax;
+          }
+        }
+      }
+    }
+  if( xmax < 0 )
+    {
+    /* empty object */
+    return;
+    }
+
   /* eigentliches Bildparsing */
-  end = end - nzz - nx - 1;
+  /* In each subcycle the deletable voxels are only marked, and deleted
+     after the scan, so the slices are scanned in parallel.
+     Tilg_Test_3 only uses the global work array p for the sequential
+     thinning (d == 18), the parallel subcycles only read the image. */
+  std::vector<std::vector<int> > slice_lists(zmax - zmin + 1);
+  itk::MultiThreaderBase::Pointer threader = itk::MultiThreaderBase::New();
   cnt = 1;
   while( cnt )
     {
@@ -705,27 +731,43 @@ void tilg_iso_3D(int dx, int dy, int dz,
       {
       cnt1 = 0;
       dir_mask = dir_tab[dir];
-      for( i = nzz + nx + 1; i < end; i++ )
+      threader->ParallelizeArray(zmin, zmax + 1,
+        [&slice_lists, zmin, ymin, ymax, xmin, xmax, dir, dir_mask, type](itk::SizeValueType sz)
         {
-        if( result[i] == OBJ )
+        const int zz = static_cast<int>(sz);
+        std::vector<int>& slice_list = slice_lists[zz - zmin];
+        slice_list.clear();
+        for( int yy = ymin; yy <= ymax; yy++ )
           {
-          nc = Env_Code_3(i);
-          if( ( (~ nc) & dir_mask) == dir_mask )
+          for( int xx = xmin; xx <= xmax; xx++ )
             {
-            if( bitcount(nc) > 2 )
+            const int ii = xx + nx * (yy + zz * ny);
+            if( result[ii] == OBJ )
               {
-              if( Tilg_Test_3(nc, dir, type) == BG )
+              const int code = Env_Code_3(ii);
+              if( ( (~ code) & dir_mask) == dir_mask )
                 {
-                list[cnt1++] = i;
+                if( bitcount(code) > 2 )
+                  {
+                  if( Tilg_Test_3(code, dir, type) == BG )
+                    {
+                    slice_list.push_back(ii);
+                    }
+                  }
                 }
               }
             }
           }
-        }
+        }, nullptr);
       /* Voxel der Liste loeschen */
-      for( i = 0; i < cnt1; i++ )
+      for( z = zmin; z <= zmax; z++ )
         {
-        result[list[i]] = BG;
+        const std::vector<int>& slice_list = slice_lists[z - zmin];
+        for( size_t l = 0; l < slice_list.size(); l++ )
+          {
+          result[slice_list[l]] = BG;
+          }
+        cnt1 += static_cast<int>(slice_list.size());
         }
       cnt += cnt1;
       }
@@ -736,22 +778,27 @@ void tilg_iso_3D(int dx, int dy, int dz,
   while( cnt )
     {
     cnt = 0;
-    for( i = nzz + nx + 1; i < end; i++ )
+    for( z = zmin; z <= zmax; z++ )
       {
-      if( result[i] == OBJ )
+      for( y = ymin; y <= ymax; y++ )
         {
-        nc = Env_Code_3(i);
-        if( bitcount(nc) > 2 )
+        for( x = xmin; x <= xmax; x++ )
           {
-          if( Tilg_Test_3(nc, 18, type) == BG )
+          i = x + nx * (y + z * ny);
+          if( result[i] == OBJ )
             {
-            cnt++;
-            result[i] = BG;
+            nc = Env_Code_3(i);
+            if( bitcount(nc) > 2 )
+              {
+              if( Tilg_Test_3(nc, 18, type) == BG )
+                {
+                cnt++;
+                result[i] = BG;
+                }
+              }
             }
           }
         }
       }
     }
-
-  free(list);
 }
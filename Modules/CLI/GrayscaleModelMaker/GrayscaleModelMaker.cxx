@@ -14,11 +14,15 @@ Version:   $Revision$
 
 #include "GrayscaleModelMakerCLP.h"
 
+#include "vtkAppendPolyData.h"
+#include "vtkCleanPolyData.h"
+#include "vtkDataArray.h"
 #include "vtkDecimatePro.h"
 #include "vtkFieldData.h"
 #include "vtkFlyingEdges3D.h"
 #include "vtkImageChangeInformation.h"
 #include "vtkImageData.h"
+#include "vtkPointData.h"
 #include "vtkPolyDataNormals.h"
 #include "vtkReverseSense.h"
 #include "vtkStringArray.h"
@@ -33,6 +37,137 @@ Version:   $Revision$
 #include "ModuleDescriptionParser.h"
 #include "ModuleDescription.h"
 
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+// Extract the isosurface between slices firstSlice and lastSlice (along the third image axis),
+// transformed to LPS and decimated. Vertices on the boundary of the slab surface are not decimated,
+// so that the surfaces of adjacent slabs can be merged.
+vtkSmartPointer<vtkPolyData> ExtractSlabSurface(vtkImageData* image_IJK, int firstSlice, int lastSlice,
+  double threshold, vtkMatrix4x4* ijkToLPSMatrix, double decimate)
+{
+  // Slices are contiguous in memory, therefore the slab uses the voxels of the image without copying
+  int extent[6] = { 0, -1, 0, -1, 0, -1 };
+  image_IJK->GetExtent(extent);
+  extent[4] = firstSlice;
+  extent[5] = lastSlice;
+  vtkDataArray* imageScalars = image_IJK->GetPointData()->GetScalars();
+  vtkSmartPointer<vtkDataArray> slabScalars = vtkSmartPointer<vtkDataArray>::Take(
+    vtkDataArray::CreateDataArray(imageScalars->GetDataType()));
+  slabScalars->SetNumberOfComponents(imageScalars->GetNumberOfComponents());
+  vtkIdType numberOfVoxels = static_cast<vtkIdType>(extent[1] - extent[0] + 1)
+    * (extent[3] - extent[2] + 1) * (lastSlice - firstSlice + 1);
+  slabScalars->SetVoidArray(image_IJK->GetScalarPointer(extent[0], extent[2], firstSlice),
+    numberOfVoxels * imageScalars->GetNumberOfComponents(), 1);
+  vtkNew<vtkImageData> slab_IJK;
+  slab_IJK->SetExtent(extent);
+  slab_IJK->GetPointData()->SetScalars(slabScalars);
+
+  vtkNew<vtkFlyingEdges3D> mcubes;
+  mcubes->SetInputData(slab_IJK);
+  mcubes->SetValue(0, threshold);
+  mcubes->ComputeScalarsOff();
+  mcubes->ComputeGradientsOff();
+  mcubes->ComputeNormalsOff();
+
+  // Each slab uses its own transform, as the transform filters run in parallel
+  vtkNew<vtkTransform> transformIJKtoLPS;
+  transformIJKtoLPS->SetMatrix(ijkToLPSMatrix);
+  vtkNew<vtkTransformPolyDataFilter> transformer;
+  transformer->SetInputConnection(mcubes->GetOutputPort());
+  transformer->SetTransform(transformIJKtoLPS);
+  transformer->Update();
+  vtkSmartPointer<vtkPolyData> mesh_LPS = transformer->GetOutput();
+
+  if (ijkToLPSMatrix->Determinant() < 0)
+    {
+    vtkNew<vtkReverseSense> reverser;
+    reverser->SetInputData(mesh_LPS);
+    reverser->ReverseNormalsOn();
+    reverser->Update();
+    mesh_LPS = reverser->GetOutput();
+    }
+
+  if (decimate > 0 && mesh_LPS->GetNumberOfPolys() > 0)
+    {
+    vtkNew<vtkDecimatePro> decimator;
+    decimator->SetInputData(mesh_LPS);
+    decimator->SetFeatureAngle(60);
+    decimator->SplittingOff();
+    decimator->PreserveTopologyOn();
+    decimator->BoundaryVertexDeletionOff();
+    decimator->SetMaximumError(1);
+    decimator->SetTargetReduction(decimate);
+    decimator->Update();
+    mesh_LPS = decimator->GetOutput();
+    }
+
+  return mesh_LPS;
+}
+
+//----------------------------------------------------------------------------
+// Extract the isosurface of the image in slabs, processed in parallel.
+// Adjacent slabs share a slice, therefore their surfaces have identical points on the shared slice.
+// Each thread processes one slab at a time, so memory usage depends on the size of the slabs and
+// the number of threads, not on the size of the whole volume.
+vtkSmartPointer<vtkPolyData> ExtractSurfaceInSlabs(vtkImageData* image_IJK, int numberOfSlabs,
+  double threshold, vtkTransform* transformIJKtoLPS, double decimate, bool debug)
+{
+  int extent[6] = { 0, -1, 0, -1, 0, -1 };
+  image_IJK->GetExtent(extent);
+  int numberOfCellSlices = extent[5] - extent[4];
+  numberOfSlabs = std::min(numberOfSlabs, numberOfCellSlices);
+  vtkNew<vtkMatrix4x4> ijkToLPSMatrix;
+  ijkToLPSMatrix->DeepCopy(transformIJKtoLPS->GetMatrix());
+
+  std::vector<vtkSmartPointer<vtkPolyData> > slabMeshes(numberOfSlabs);
+  std::atomic<int> nextSlabIndex(0);
+  auto processSlabs = [&]()
+    {
+    for (int slabIndex = nextSlabIndex++; slabIndex < numberOfSlabs; slabIndex = nextSlabIndex++)
+      {
+      int firstSlice = extent[4] + static_cast<int>(static_cast<long long>(numberOfCellSlices) * slabIndex / numberOfSlabs);
+      int lastSlice = extent[4] + static_cast<int>(static_cast<long long>(numberOfCellSlices) * (slabIndex + 1) / numberOfSlabs);
+      slabMeshes[slabIndex] = ExtractSlabSurface(image_IJK, firstSlice, lastSlice, threshold, ijkToLPSMatrix, decimate);
+      }
+    };
+  int numberOfThreads = std::max(1, std::min(numberOfSlabs, static_cast<int>(std::thread::hardware_concurrency())));
+  if (debug)
+    {
+    std::cout << "Extracting surface in " << numberOfSlabs << " slabs using " << numberOfThreads << " threads" << std::endl;
+    }
+  std::vector<std::thread> threads;
+  for (int threadIndex = 1; threadIndex < numberOfThreads; ++threadIndex)
+    {
+    threads.emplace_back(processSlabs);
+    }
+  processSlabs();
+  for (std::thread& thread : threads)
+    {
+    thread.join();
+    }
+
+  vtkNew<vtkAppendPolyData> appender;
+  for (int slabIndex = 0; slabIndex < numberOfSlabs; ++slabIndex)
+    {
+    if (debug)
+      {
+      std::cout << "Slab " << slabIndex << ": number of polygons = " << slabMeshes[slabIndex]->GetNumberOfPolys() << std::endl;
+      }
+    appender->AddInputData(slabMeshes[slabIndex]);
+    }
+  appender->Update();
+  return appender->GetOutput();
+}
+
+} // end of anonymous namespace
+
 int main(int argc, char* argv[])
 {
   PARSE_ARGS;
@@ -102,73 +237,93 @@ int main(int argc, char* argv[])
     return EXIT_FAILURE;
     }
 
-  vtkNew<vtkFlyingEdges3D> mcubes;
-  vtkPluginFilterWatcher watchMCubes(mcubes, "Marching Cubes", CLPProcessInformation, 1.0 / 7.0, 0.0);
-  mcubes->SetInputData(image_IJK);
-  mcubes->SetValue(0, Threshold);
-  mcubes->ComputeScalarsOff();
-  mcubes->ComputeGradientsOff();
-  mcubes->ComputeNormalsOff();
-  if (Debug)
-    {
-    std::cout << "Number of polygons = " << (mcubes->GetOutput())->GetNumberOfPolys() << endl;
-    }
-
-  // Convert the mesh from voxel space to physical space before decimating or smoothing,
-  // as they rely on actual size and aspect ratio of the mesh.
   vtkSmartPointer<vtkPolyData> mesh_LPS;
-  {
+  if (NumberOfSlabs > 1)
+    {
+    // Surface of each slab is extracted, transformed to LPS, and decimated separately,
+    // then the points at the boundaries between slabs are merged.
+    mesh_LPS = ExtractSurfaceInSlabs(image_IJK, NumberOfSlabs, Threshold, transformIJKtoLPS, Decimate, Debug);
+    vtkNew<vtkCleanPolyData> merger;
+    vtkPluginFilterWatcher watchMerger(merger, "Merge slabs", CLPProcessInformation, 1.0 / 7.0, 1.0 / 7.0);
+    merger->SetInputData(mesh_LPS);
+    merger->PointMergingOn();
+    merger->SetTolerance(0.0);
+    merger->Update();
+    mesh_LPS = merger->GetOutput();
     if (Debug)
       {
-      std::cout << "Transforming to mesh to LPS coordinate system" << std::endl;
-      std::cout << "IJK to LPS matrix from file = ";
-      transformIJKtoLPS->GetMatrix()->Print(std::cout);
+      std::cout << "After merging slabs, number of polygons = " << mesh_LPS->GetNumberOfPolys() << endl;
       }
-    vtkNew<vtkTransformPolyDataFilter> transformer;
-    vtkPluginFilterWatcher watchTranformer(transformer, "Transformer", CLPProcessInformation, 1.0 / 7.0, 4.0 / 7.0);
-    transformer->SetInputConnection(mcubes->GetOutputPort());
-    transformer->SetTransform(transformIJKtoLPS);
-    transformer->Update();
-    mesh_LPS = transformer->GetOutput();
-  }
-
-  if ((transformIJKtoLPS->GetMatrix())->Determinant() < 0)
+    }
+  else
     {
+    vtkNew<vtkFlyingEdges3D> mcubes;
+    vtkPluginFilterWatcher watchMCubes(mcubes, "Marching Cubes", CLPProcessInformation, 1.0 / 7.0, 0.0);
+    mcubes->SetInputData(image_IJK);
+    mcubes->SetValue(0, Threshold);
+    mcubes->ComputeScalarsOff();
+    mcubes->ComputeGradientsOff();
+    mcubes->ComputeNormalsOff();
     if (Debug)
       {
-      std::cout << "Determinant " << (transformIJKtoLPS->GetMatrix())->Determinant()
-        << " is less than zero, reversing..." << std::endl;
+      std::cout << "Number of polygons = " << (mcubes->GetOutput())->GetNumberOfPolys() << endl;
       }
-    vtkNew<vtkReverseSense> reverser;
-    vtkPluginFilterWatcher watchReverser(reverser, "Reversor", CLPProcessInformation, 1.0 / 7.0, 2.0 / 7.0);
-    reverser->SetInputData(mesh_LPS);
-    reverser->ReverseNormalsOn();
-    reverser->Update();
-    mesh_LPS = reverser->GetOutput();
-    }
 
-  if (Decimate > 0)
+    // Convert the mesh from voxel space to physical space before decimating or smoothing,
+    // as they rely on actual size and aspect ratio of the mesh.
     {
-    if (Debug)
+      if (Debug)
+        {
+        std::cout << "Transforming to mesh to LPS coordinate system" << std::endl;
+        std::cout << "IJK to LPS matrix from file = ";
+        transformIJKtoLPS->GetMatrix()->Print(std::cout);
+        }
+      vtkNew<vtkTransformPolyDataFilter> transformer;
+      vtkPluginFilterWatcher watchTranformer(transformer, "Transformer", CLPProcessInformation, 1.0 / 7.0, 4.0 / 7.0);
+      transformer->SetInputConnection(mcubes->GetOutputPort());
+      transformer->SetTransform(transformIJKtoLPS);
+      transformer->Update();
+      mesh_LPS = transformer->GetOutput();
+    }
+
+    if ((transformIJKtoLPS->GetMatrix())->Determinant() < 0)
       {
-      std::cout << "Decimating ... " << std::endl;
+      if (Debug)
+        {
+        std::cout << "Determinant " << (transformIJKtoLPS->GetMatrix())->Determinant()
+          << " is less than zero, reversing..." << std::endl;
+        }
+      vtkNew<vtkReverseSense> reverser;
+      vtkPluginFilterWatcher watchReverser(reverser, "Reversor", CLPProcessInformation, 1.0 / 7.0, 2.0 / 7.0);
+      reverser->SetInputData(mesh_LPS);
+      reverser->ReverseNormalsOn();
+      reverser->Update();
+      mesh_LPS = reverser->GetOutput();
       }
-    // TODO: look at vtkQuadraticDecimation, it produces nicer mesh
-    vtkNew<vtkDecimatePro> decimator;
-    vtkPluginFilterWatcher watchDecimator(decimator, "Decimator", CLPProcessInformation, 1.0 / 7.0, 1.0 / 7.0);
-    decimator->SetInputData(mesh_LPS);
-    decimator->SetFeatureAngle(60);
-    decimator->SplittingOff();
-    decimator->PreserveTopologyOn();
-    decimator->SetMaximumError(1);
-    decimator->SetTargetReduction(Decimate);
-    // TODO add progress to decimator
-    decimator->Update();
-    if (Debug)
+
+    if (Decimate > 0)
       {
-      std::cout << "After decimation, number of polygons = " << (decimator->GetOutput())->GetNumberOfPolys() << endl;
+      if (Debug)
+        {
+        std::cout << "Decimating ... " << std::endl;
+        }
+      // TODO: look at vtkQuadraticDecimation, it produces nicer mesh
+      vtkNew<vtkDecimatePro> decimator;
+      vtkPluginFilterWatcher watchDecimator(decimator, "Decimator", CLPProcessInformation, 1.0 / 7.0, 1.0 / 7.0);
+      decimator->SetInputData(mesh_LPS);
+      decimator->SetFeatureAngle(60);
+      decimator->SplittingOff();
+      decimator->PreserveTopologyOn();
+      decimator->SetMaximumError(1);
+      decimator->SetTargetReduction(Decimate);
+      // TODO add progress to decimator
+      decimator->Update();
+      if (Debug)
+        {
+        std::cout << "After decimation, number of polygons = " << (decimator->GetOutput())->GetNumberOfPolys() << endl;
+        }
+      mesh_LPS = decimator->GetOutput();
       }
-    mesh_LPS = decimator->GetOutput();
     }
 
   if (Smooth > 0)
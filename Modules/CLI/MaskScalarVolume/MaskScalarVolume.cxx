@@ -10,11 +10,8 @@
 =========================================================================*/
 #include "itkImageFileWriter.h"
 
-#include "itkMaskImageFilter.h"
-#include "itkThresholdImageFilter.h"
-
 #include "itkNearestNeighborInterpolateImageFunction.h"
-#include "itkResampleImageFilter.h"
+#include "itkVoxelExpressionImageFilter.h"
 
 #include "itkPluginUtilities.h"
 #include "MaskScalarVolumeCLP.h"
@@ -42,13 +39,8 @@ int DoIt( int argc, char * argv[] )
   typedef itk::ImageFileReader<InputImageType>  ReaderType;
   typedef itk::ImageFileWriter<OutputImageType> WriterType;
 
-  typedef itk::NearestNeighborInterpolateImageFunction<InputImageType> Interpolator;
-  typedef itk::ResampleImageFilter<InputImageType, OutputImageType>    ResampleType;
-  typedef itk::MaskImageFilter<
-    InputImageType, InputImageType, OutputImageType>  FilterType;
-
-  typedef itk::ThresholdImageFilter<
-    InputImageType>  ThresholdFilterType;
+  typedef itk::NearestNeighborInterpolateImageFunction<InputImageType>     Interpolator;
+  typedef itk::VoxelExpressionImageFilter<InputImageType, OutputImageType> FilterType;
 
   typename ReaderType::Pointer reader1 = ReaderType::New();
   itk::PluginFilterWatcher watchReader1(reader1, "Read Input Volume",
@@ -65,29 +57,8 @@ int DoIt( int argc, char * argv[] )
   reader1->Update();
   reader2->Update();
 
-  // have to threshold the mask volume
-  typename ThresholdFilterType::Pointer thresholdFilter = ThresholdFilterType::New();
-  itk::PluginFilterWatcher watchThresholdFilter(thresholdFilter,
-                                                "Threshold Image",
-                                                CLPProcessInformation);
-
-  thresholdFilter->SetInput(0, reader2->GetOutput() );
-  thresholdFilter->SetOutsideValue(0);
-  thresholdFilter->ThresholdOutside(Label, Label);
-  thresholdFilter->ReleaseDataFlagOn();
-
+  // The mask volume is interpolated if it has different geometry than the input volume
   typename Interpolator::Pointer interp = Interpolator::New();
-  interp->SetInputImage(thresholdFilter->GetOutput() );
-
-  typename ResampleType::Pointer resample = ResampleType::New();
-  resample->SetInput(thresholdFilter->GetOutput() );
-  resample->SetOutputParametersFromImage(reader1->GetOutput() );
-  resample->SetInterpolator( interp );
-  resample->SetDefaultPixelValue( 0 );
-  resample->ReleaseDataFlagOn();
-
-  itk::PluginFilterWatcher watchResample(resample, "Resampling",
-                                         CLPProcessInformation);
 
   typename FilterType::Pointer filter = FilterType::New();
   itk::PluginFilterWatcher watchFilter(filter,
@@ -95,8 +66,9 @@ int DoIt( int argc, char * argv[] )
                                        CLPProcessInformation);
 
   filter->SetInput( 0, reader1->GetOutput() );
-  filter->SetInput( 1, resample->GetOutput() );
-  filter->SetOutsideValue( Replace );
+  filter->SetInput( 1, reader2->GetOutput() );
+  filter->SetInterpolator( 1, interp );
+  filter->AppendMask( 1, static_cast<InputPixelType>( Label ), static_cast<OutputPixelType>( Replace ) );
 
   typename WriterType::Pointer writer = WriterType::New();
   itk::PluginFilterWatcher watchWriter(writer,
@@ -45,15 +45,17 @@ Version:   $Revision$
 #include <vtkImageChangeInformation.h>
 #include <vtkImageConstantPad.h>
 #include <vtkImageData.h>
-#include <vtkImageThreshold.h>
-#include <vtkImageToStructuredPoints.h>
 #include <vtkInformation.h>
 #include <vtkLookupTable.h>
+#include <vtkMatrix4x4.h>
 #include <vtkNew.h>
 #include <vtkPointData.h>
+#include <vtkPolyData.h>
 #include <vtkPolyDataNormals.h>
 #include <vtkPolyDataWriter.h>
 #include <vtkReverseSense.h>
+#include <vtkSMPThreadLocal.h>
+#include <vtkSMPTools.h>
 #include <vtkSmartPointer.h>
 #include <vtkSmoothPolyDataFilter.h>
 #include <vtkStreamingDemandDrivenPipeline.h>
@@ -67,6 +69,378 @@ Version:   $Revision$
 // VTKsys includes
 #include <vtksys/SystemTools.hxx>
 
+// STD includes
+#include <algorithm>
+#include <mutex>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+/// Settings of the per-label model generation, shared by all labels
+struct ModelGenerationParameters
+{
+  bool JointSmoothing;
+  bool SincSmoothing;
+  int Smooth;
+  float Decimate;
+  bool SplitNormals;
+  bool PointNormals;
+  bool SaveIntermediateModels;
+  std::string RootDir;
+  const char* FileHeader;
+  /// Transform from the voxel space the models are built in to LPS
+  vtkMatrix4x4* IJKToLPSMatrix;
+};
+
+//----------------------------------------------------------------------------
+/// Model of a single label. Label, Name and Extent are set before the model is
+/// generated, the other members by GenerateLabelModel().
+struct LabelModel
+{
+  int Label;
+  std::string Name;
+  /// Voxel extent of the label, including one voxel of background around it.
+  /// Not used for joint smoothing.
+  int Extent[6];
+  std::string FileName;
+  /// False if no polygons could be created from the label
+  bool Generated;
+  bool Written;
+  vtkIdType NumberOfPolygons;
+  /// Set if a filter failed, the model is not usable then
+  std::string Error;
+};
+
+//----------------------------------------------------------------------------
+/// Compute the voxel extent of all labels in [minLabel, maxLabel] in a single pass
+/// over the image. The extent of label l is stored at labelExtents[6 * (l - minLabel)],
+/// labels without voxels get an empty extent (minimum larger than maximum).
+template <class T>
+void ComputeLabelExtents(vtkImageData* image, int minLabel, int maxLabel, std::vector<int>& labelExtents)
+{
+  const int numberOfLabels = maxLabel - minLabel + 1;
+  std::vector<int> emptyExtents(6 * numberOfLabels);
+  for (int labelIndex = 0; labelIndex < numberOfLabels; ++labelIndex)
+    {
+    for (int axis = 0; axis < 3; ++axis)
+      {
+      emptyExtents[6 * labelIndex + 2 * axis] = VTK_INT_MAX;
+      emptyExtents[6 * labelIndex + 2 * axis + 1] = VTK_INT_MIN;
+      }
+    }
+
+  int extent[6];
+  image->GetExtent(extent);
+  vtkIdType increments[3];
+  image->GetIncrements(increments);
+  const T* scalars = static_cast<const T*>(image->GetScalarPointer());
+
+  vtkSMPThreadLocal<std::vector<int> > threadLabelExtents(emptyExtents);
+  vtkSMPTools::For(extent[4], extent[5] + 1, [&](int beginSlice, int endSlice)
+    {
+    std::vector<int>& localExtents = threadLabelExtents.Local();
+    for (int k = beginSlice; k < endSlice; ++k)
+      {
+      for (int j = extent[2]; j <= extent[3]; ++j)
+        {
+        const T* voxel = scalars + (k - extent[4]) * increments[2] + (j - extent[2]) * increments[1];
+        for (int i = extent[0]; i <= extent[1]; ++i, voxel += increments[0])
+          {
+          // only voxels that vtkImageThreshold::ThresholdBetween(label, label) would select
+          double value = static_cast<double>(*voxel);
+          if (value < minLabel || value > maxLabel || value != floor(value))
+            {
+            continue;
+            }
+          int* labelExtent = &localExtents[6 * (static_cast<int>(value) - minLabel)];
+          labelExtent[0] = std::min(labelExtent[0], i);
+          labelExtent[1] = std::max(labelExtent[1], i);
+          labelExtent[2] = std::min(labelExtent[2], j);
+          labelExtent[3] = std::max(labelExtent[3], j);
+          labelExtent[4] = std::min(labelExtent[4], k);
+          labelExtent[5] = std::max(labelExtent[5], k);
+          }
+        }
+      }
+    });
+
+  labelExtents = emptyExtents;
+  for (typename vtkSMPThreadLocal<std::vector<int> >::iterator it = threadLabelExtents.begin();
+    it != threadLabelExtents.end(); ++it)
+    {
+    const std::vector<int>& localExtents = *it;
+    for (int index = 0; index < 6 * numberOfLabels; index += 2)
+      {
+      labelExtents[index] = std::min(labelExtents[index], localExtents[index]);
+      labelExtents[index + 1] = std::max(labelExtents[index + 1], localExtents[index + 1]);
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+/// Fill mask with 200 where the image has the label value and 0 elsewhere,
+/// in the extent of the mask. Same as thresholding the whole image with
+/// vtkImageThreshold, but only the voxels around the label are visited.
+template <class T>
+void ExtractLabelMask(vtkImageData* image, int label, vtkImageData* mask)
+{
+  int imageExtent[6];
+  image->GetExtent(imageExtent);
+  vtkIdType increments[3];
+  image->GetIncrements(increments);
+  const T* scalars = static_cast<const T*>(image->GetScalarPointer());
+
+  int maskExtent[6];
+  mask->GetExtent(maskExtent);
+  unsigned char* maskVoxel = static_cast<unsigned char*>(mask->GetScalarPointer());
+  for (int k = maskExtent[4]; k <= maskExtent[5]; ++k)
+    {
+    for (int j = maskExtent[2]; j <= maskExtent[3]; ++j)
+      {
+      const T* voxel = scalars + (maskExtent[0] - imageExtent[0]) * increments[0]
+        + (j - imageExtent[2]) * increments[1] + (k - imageExtent[4]) * increments[2];
+      for (int i = maskExtent[0]; i <= maskExtent[1]; ++i, voxel += increments[0])
+        {
+        *(maskVoxel++) = (static_cast<double>(*voxel) == label) ? 200 : 0;
+        }
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+/// Write an intermediate model next to the final models, named after the label and the stage.
+void WriteIntermediateModel(vtkAlgorithmOutput* input, const LabelModel& model,
+                            const std::string& stage, const ModelGenerationParameters& parameters)
+{
+  vtkNew<vtkPolyDataWriter> writer;
+  writer->SetInputConnection(input);
+  writer->SetHeader(parameters.FileHeader);
+  writer->SetFileType(2);
+  std::string fileName = model.Name + std::string("-") + stage + std::string(".vtk");
+  if (parameters.RootDir != "")
+    {
+    fileName = parameters.RootDir + std::string("/") + fileName;
+    }
+  writer->SetFileName(fileName.c_str());
+  if (!writer->Write())
+    {
+    std::cerr << "ERROR: Failed to write intermediate file " << fileName.c_str() << std::endl;
+    }
+}
+
+//----------------------------------------------------------------------------
+/// Build the model of a label and write it to the model file:
+/// contour the label mask (or, for joint smoothing, extract the label from the
+/// jointly smoothed surface), decimate, smooth, transform to LPS, compute normals
+/// and triangle strips.
+/// All the filters are created here and the inputs are only read, so models of
+/// different labels can be generated concurrently.
+void GenerateLabelModel(LabelModel& model, vtkImageData* labelMask, vtkPolyData* jointSurface,
+                        const ModelGenerationParameters& parameters)
+{
+  vtkSmartPointer<vtkAlgorithm> surface;
+  if (!parameters.JointSmoothing)
+    {
+#if VTK_MAJOR_VERSION >= 9 || (VTK_MAJOR_VERSION >= 8 && VTK_MINOR_VERSION >= 2)
+    vtkNew<vtkFlyingEdges3D> mcubes;
+#else
+    vtkNew<vtkMarchingCubes> mcubes;
+#endif
+    mcubes->SetInputData(labelMask);
+    mcubes->SetValue(0, 100.5);
+    mcubes->ComputeScalarsOff();
+    mcubes->ComputeGradientsOff();
+    mcubes->ComputeNormalsOff();
+    try
+      {
+      mcubes->Update();
+      }
+    catch(...)
+      {
+      model.Error = "ERROR while running marching cubes";
+      return;
+      }
+    if (mcubes->GetOutput()->GetNumberOfPolys() == 0)
+      {
+      return;
+      }
+    if (parameters.SaveIntermediateModels)
+      {
+      WriteIntermediateModel(mcubes->GetOutputPort(), model, "MarchingCubes", parameters);
+      }
+    surface = mcubes.GetPointer();
+    }
+  else
+    {
+    vtkNew<vtkThreshold> threshold;
+    threshold->SetInputData(jointSurface);
+    threshold->ThresholdBetween(model.Label, model.Label);
+    vtkNew<vtkGeometryFilter> geometryFilter;
+    geometryFilter->SetInputConnection(threshold->GetOutputPort());
+    surface = geometryFilter.GetPointer();
+    }
+
+  // In switch from vtk 4 to vtk 5, vtkDecimate was deprecated from the Patented dir, use vtkDecimatePro
+  // TODO: look at vtkQuadraticDecimation
+  vtkNew<vtkDecimatePro> decimator;
+  decimator->SetInputConnection(surface->GetOutputPort());
+  decimator->SetFeatureAngle(60);
+  decimator->SplittingOff();
+  decimator->PreserveTopologyOn();
+  decimator->SetMaximumError(1);
+  decimator->SetTargetReduction(parameters.Decimate);
+  try
+    {
+    decimator->Update();
+    }
+  catch(...)
+    {
+    model.Error = "ERROR decimating model";
+    return;
+    }
+  if (parameters.SaveIntermediateModels)
+    {
+    WriteIntermediateModel(decimator->GetOutputPort(), model, "Decimated", parameters);
+    }
+  vtkSmartPointer<vtkAlgorithm> oriented = decimator.GetPointer();
+  if (parameters.IJKToLPSMatrix->Determinant() < 0)
+    {
+    vtkNew<vtkReverseSense> reverser;
+    reverser->SetInputConnection(decimator->GetOutputPort());
+    reverser->ReverseNormalsOn();
+    oriented = reverser.GetPointer();
+    }
+
+  vtkSmartPointer<vtkAlgorithm> smoothed = oriented;
+  if (!parameters.JointSmoothing)
+    {
+    if (parameters.SincSmoothing)
+      {
+      vtkNew<vtkWindowedSincPolyDataFilter> smootherSinc;
+      smootherSinc->SetPassBand(0.1);
+      smootherSinc->SetInputConnection(oriented->GetOutputPort());
+      smootherSinc->SetNumberOfIterations(parameters.Smooth);
+      smootherSinc->FeatureEdgeSmoothingOff();
+      smootherSinc->BoundarySmoothingOff();
+      smoothed = smootherSinc.GetPointer();
+      }
+    else
+      {
+      vtkNew<vtkSmoothPolyDataFilter> smootherPoly;
+      // this next line massively rounds corners
+      smootherPoly->SetRelaxationFactor(0.33);
+      smootherPoly->SetFeatureAngle(60);
+      smootherPoly->SetConvergence(0);
+      smootherPoly->SetInputConnection(oriented->GetOutputPort());
+      smootherPoly->SetNumberOfIterations(parameters.Smooth);
+      smootherPoly->FeatureEdgeSmoothingOff();
+      smootherPoly->BoundarySmoothingOff();
+      smoothed = smootherPoly.GetPointer();
+      }
+    try
+      {
+      smoothed->Update();
+      }
+    catch(...)
+      {
+      model.Error = "ERROR updating smoother for model";
+      return;
+      }
+    if (parameters.SaveIntermediateModels)
+      {
+      WriteIntermediateModel(smoothed->GetOutputPort(), model, "Smoothed", parameters);
+      }
+    }
+
+  // each model gets its own transform, the matrix is only read
+  vtkNew<vtkTransform> transformIJKtoLPS;
+  transformIJKtoLPS->SetMatrix(parameters.IJKToLPSMatrix);
+  vtkNew<vtkTransformPolyDataFilter> transformer;
+  transformer->SetInputConnection(smoothed->GetOutputPort());
+  transformer->SetTransform(transformIJKtoLPS.GetPointer());
+
+  vtkNew<vtkPolyDataNormals> normals;
+  normals->SetComputePointNormals(parameters.PointNormals);
+  normals->SetInputConnection(transformer->GetOutputPort());
+  normals->SetFeatureAngle(60);
+  normals->SetSplitting(parameters.SplitNormals);
+
+  vtkNew<vtkStripper> stripper;
+  stripper->SetInputConnection(normals->GetOutputPort());
+  try
+    {
+    stripper->Update();
+    }
+  catch(...)
+    {
+    model.Error = "ERROR updating stripper for model";
+    return;
+    }
+  model.Generated = true;
+  model.NumberOfPolygons = stripper->GetOutput()->GetNumberOfCells();
+
+  vtkNew<vtkPolyDataWriter> writer;
+  writer->SetInputConnection(stripper->GetOutputPort());
+  writer->SetHeader(parameters.FileHeader);
+  writer->SetFileType(2);
+  writer->SetFileName(model.FileName.c_str());
+  model.Written = (writer->Write() != 0);
+}
+
+//----------------------------------------------------------------------------
+/// Report progress of the label models that are generated concurrently.
+/// vtkPluginFilterWatcher reports the progress of a single filter, which does
+/// not work when the filters of several labels run at the same time, therefore
+/// progress is only reported when the model of a label is completed.
+class LabelModelProgress
+{
+public:
+  LabelModelProgress(ModuleProcessInformation* processInformation, ::size_t numberOfModels,
+                     double start, double fraction, bool quiet)
+    : ProcessInformation(processInformation)
+    , NumberOfModels(numberOfModels)
+    , NumberOfCompletedModels(0)
+    , Start(start)
+    , Fraction(fraction)
+    , Quiet(quiet)
+  {
+  }
+
+  void ModelCompleted(const std::string& name)
+  {
+    std::lock_guard<std::mutex> lock(this->Mutex);
+    this->NumberOfCompletedModels++;
+    double progress = this->Start + this->Fraction * this->NumberOfCompletedModels / this->NumberOfModels;
+    if (this->ProcessInformation)
+      {
+      std::string comment = "Made model " + name;
+      strncpy(this->ProcessInformation->ProgressMessage, comment.c_str(), 1023);
+      this->ProcessInformation->Progress = progress;
+      if (this->ProcessInformation->ProgressCallbackFunction
+          && this->ProcessInformation->ProgressCallbackClientData)
+        {
+        (*(this->ProcessInformation->ProgressCallbackFunction))(this->ProcessInformation->ProgressCallbackClientData);
+        }
+      }
+    else if (!this->Quiet)
+      {
+      std::cout << "<filter-progress>" << progress << "</filter-progress>" << std::endl << std::flush;
+      }
+  }
+
+private:
+  ModuleProcessInformation* ProcessInformation;
+  ::size_t NumberOfModels;
+  ::size_t NumberOfCompletedModels;
+  double Start;
+  double Fraction;
+  bool Quiet;
+  std::mutex Mutex;
+};
+
+} // end of anonymous namespace
+
 int main(int argc, char * argv[])
 {
   PARSE_ARGS;
@@ -288,27 +662,9 @@ int main(int argc, char * argv[])
   vtkSmartPointer<vtkImageAccumulate>               hist;
   std::vector<int>                                  skippedModels;
   std::vector<int>                                  madeModels;
-  vtkSmartPointer<vtkWindowedSincPolyDataFilter>    smootherSinc;
-  vtkSmartPointer<vtkSmoothPolyDataFilter>          smootherPoly;
 
   vtkSmartPointer<vtkImageConstantPad>        padder;
-  vtkSmartPointer<vtkDecimatePro>             decimator;
-
-#if VTK_MAJOR_VERSION >= 9 || (VTK_MAJOR_VERSION >= 8 && VTK_MINOR_VERSION >= 2)
-  vtkSmartPointer<vtkFlyingEdges3D>           mcubes;
-#else
-  vtkSmartPointer<vtkMarchingCubes>           mcubes;
-#endif
-  vtkSmartPointer<vtkImageThreshold>          imageThreshold;
-  vtkSmartPointer<vtkThreshold>               threshold;
-  vtkSmartPointer<vtkImageToStructuredPoints> imageToStructuredPoints;
-  vtkSmartPointer<vtkGeometryFilter>          geometryFilter;
   vtkSmartPointer<vtkTransform>               transformIJKtoLPS;
-  vtkSmartPointer<vtkReverseSense>            reverser;
-  vtkSmartPointer<vtkTransformPolyDataFilter> transformer;
-  vtkSmartPointer<vtkPolyDataNormals>         normals;
-  vtkSmartPointer<vtkStripper>                stripper;
-  vtkSmartPointer<vtkPolyDataWriter>          writer;
 
   const char modelFileHeader[] = "3D Slicer output. SPACE=LPS"; // models are saved in LPS coordinate system
 
@@ -869,7 +1225,7 @@ int main(int argc, char * argv[])
   transformIJKtoLPS->Concatenate(ijkToRasMatrix);
 
   //
-  // Loop through all the labels
+  // Loop through all the labels and name their models
   //
   std::vector<int> loopLabels;
   if (useStartEnd || GenerateAll)
@@ -888,6 +1244,7 @@ int main(int argc, char * argv[])
       loopLabels.push_back(Labels[i]);
       }
     }
+  std::vector<LabelModel> labelModels;
   for(::size_t l = 0; l < loopLabels.size(); l++)
     {
     // get the label out of the vector
@@ -998,753 +1355,290 @@ int main(int argc, char * argv[])
       */
       }
 
-    // threshold
-    if (JointSmoothing == 0)
+    LabelModel model;
+    model.Label = i;
+    model.Name = labelName;
+    if (rootDir != "")
       {
-      if (imageThreshold)
-        {
-        imageThreshold->SetInputData(nullptr);
-        imageThreshold->RemoveAllInputs();
-        imageThreshold = nullptr;
-        }
-      imageThreshold = vtkSmartPointer<vtkImageThreshold>::New();
-      std::string            comment3 = "Threshold " + labelName;
-      vtkPluginFilterWatcher watchImageThreshold(imageThreshold,
-                                                 comment3.c_str(),
-                                                 CLPProcessInformation,
-                                                 1.0 / numFilterSteps,
-                                                 currentFilterOffset / numFilterSteps);
-      currentFilterOffset += 1.0;
-      if (debug)
-        {
-        watchImageThreshold.QuietOn();
-        }
-      if (Pad)
-        {
-        imageThreshold->SetInputConnection(padder->GetOutputPort());
-        }
-      else
-        {
-        imageThreshold->SetInputData(image);
-        }
-      imageThreshold->SetReplaceIn(1);
-      imageThreshold->SetReplaceOut(1);
-      imageThreshold->SetInValue(200);
-      imageThreshold->SetOutValue(0);
+      model.FileName = rootDir + std::string("/") + labelName + std::string(".vtk");
+      }
+    else
+      {
+      std::cout << "WARNING: output directory is an empty string..." << endl;
+      model.FileName = labelName + std::string(".vtk");
+      }
+    model.Generated = false;
+    model.Written = false;
+    model.NumberOfPolygons = 0;
+    labelModels.push_back(model);
+    }   // end of loop over labels
 
-      imageThreshold->ThresholdBetween(i, i);
-      imageThreshold->ReleaseDataFlagOn();
+  //
+  // Generate the models. Without joint smoothing each label is contoured in a mask
+  // that only covers the extent of the label (the extents of all labels are found in
+  // a single pass over the image), so the models of different labels are generated
+  // concurrently. With joint smoothing the labels are extracted from the jointly
+  // smoothed surface one after the other.
+  //
+  if (JointSmoothing == 0 && strcmp(FilterType.c_str(), "Sinc") == 0 && Smooth == 1)
+    {
+    std::cerr << "Warning: Smoothing iterations of 1 not allowed for Sinc filter, using 2" << endl;
+    Smooth = 2;
+    }
+  vtkNew<vtkMatrix4x4> ijkToLPSMatrix;
+  ijkToLPSMatrix->DeepCopy(transformIJKtoLPS->GetMatrix());
+  if (debug && ijkToLPSMatrix->Determinant() < 0)
+    {
+    std::cout << "Determinant " << ijkToLPSMatrix->Determinant() << " is less than zero, reversing..." << endl;
+    }
 
-      if (imageToStructuredPoints)
-        {
-        imageToStructuredPoints->SetInputData(nullptr);
-        imageToStructuredPoints = nullptr;
-        }
-      imageToStructuredPoints = vtkSmartPointer<vtkImageToStructuredPoints>::New();
-      imageToStructuredPoints->SetInputConnection(imageThreshold->GetOutputPort());
+  ModelGenerationParameters parameters;
+  parameters.JointSmoothing = (JointSmoothing != 0);
+  parameters.SincSmoothing = (strcmp(FilterType.c_str(), "Sinc") == 0);
+  parameters.Smooth = Smooth;
+  parameters.Decimate = Decimate;
+  parameters.SplitNormals = SplitNormals;
+  parameters.PointNormals = PointNormals;
+  parameters.SaveIntermediateModels = SaveIntermediateModels;
+  parameters.RootDir = rootDir;
+  parameters.FileHeader = modelFileHeader;
+  parameters.IJKToLPSMatrix = ijkToLPSMatrix.GetPointer();
+
+  double labelsProgressStart = currentFilterOffset / numFilterSteps;
+  LabelModelProgress progress(CLPProcessInformation, labelModels.size(),
+                              labelsProgressStart, 1.0 - labelsProgressStart, debug);
+  if (JointSmoothing == 0)
+    {
+    vtkImageData* labelImage = image;
+    if (Pad)
+      {
       try
         {
-        imageToStructuredPoints->Update();
+        padder->Update();
         }
       catch(...)
         {
-        std::cerr << "ERROR while updating image to structured points for label " << i << std::endl;
+        std::cerr << "ERROR while padding the image." << std::endl;
         return EXIT_FAILURE;
         }
-      imageToStructuredPoints->ReleaseDataFlagOn();
+      labelImage = padder->GetOutput();
       }
-    else
-      {
-      // use the output of the smoother
-      if (threshold)
-        {
-        threshold->SetInputData(nullptr);
-        threshold = nullptr;
-        }
-      threshold = vtkSmartPointer<vtkThreshold>::New();
-      std::string            comment4 = "Threshold " + labelName;
-      vtkPluginFilterWatcher watchThreshold(threshold,
-                                            comment4.c_str(),
-                                            CLPProcessInformation,
-                                            1.0 / numFilterSteps,
-                                            currentFilterOffset / numFilterSteps);
-      currentFilterOffset += 1.0;
-      if (debug)
-        {
-        watchThreshold.QuietOn();
-        }
-      if (smoother == nullptr)
-        {
-        std::cerr << "\nERROR smoothing filter is null for joint smoothing!" << std::endl;
-        return EXIT_FAILURE;
-        }
-      threshold->SetInputConnection(smoother->GetOutputPort());
-      // In VTK 5.0, this is deprecated - the default behaviour seems to
-      // be okay
-      // threshold->SetAttributeModeToUseCellData();
-
-      threshold->ThresholdBetween(i, i);
-      threshold->ReleaseDataFlagOn();
+    int labelImageExtent[6];
+    labelImage->GetExtent(labelImageExtent);
 
-      if (geometryFilter)
-        {
-        geometryFilter->SetInputData(nullptr);
-        geometryFilter = nullptr;
-        }
-      geometryFilter = vtkSmartPointer<vtkGeometryFilter>::New();
-      geometryFilter->SetInputConnection(threshold->GetOutputPort());
-      geometryFilter->ReleaseDataFlagOn();
+    int minLabel = 0;
+    int maxLabel = -1;
+    for(::size_t l = 0; l < labelModels.size(); l++)
+      {
+      minLabel = (l == 0 ? labelModels[l].Label : std::min(minLabel, labelModels[l].Label));
+      maxLabel = (l == 0 ? labelModels[l].Label : std::max(maxLabel, labelModels[l].Label));
       }
-
-    // if not joint smoothing, may need to skip this label
-    int skipLabel = 0;
-    if (JointSmoothing == 0)
+    std::vector<int> labelExtents;
+    if (!labelModels.empty())
       {
-      if (mcubes)
+      switch (labelImage->GetScalarType())
         {
-        mcubes->SetInputData(nullptr);
-        mcubes = nullptr;
+        vtkTemplateMacro(ComputeLabelExtents<VTK_TT>(labelImage, minLabel, maxLabel, labelExtents));
+        default:
+          std::cerr << "ERROR: unsupported scalar type of the input volume: " << labelImage->GetScalarTypeAsString() << std::endl;
+          return EXIT_FAILURE;
         }
-#if VTK_MAJOR_VERSION >= 9 || (VTK_MAJOR_VERSION >= 8 && VTK_MINOR_VERSION >= 2)
-      mcubes = vtkSmartPointer<vtkFlyingEdges3D>::New();
-#else
-      mcubes = vtkSmartPointer<vtkMarchingCubes>::New();
-#endif
-      std::string            comment5 = "Marching Cubes " + labelName;
-      vtkPluginFilterWatcher watchThreshold(mcubes,
-                                            comment5.c_str(),
-                                            CLPProcessInformation,
-                                            1.0 / numFilterSteps,
-                                            currentFilterOffset / numFilterSteps);
-      currentFilterOffset += 1.0;
-      if (debug)
-        {
-        watchThreshold.QuietOn();
-        }
-      mcubes->SetInputConnection(imageToStructuredPoints->GetOutputPort());
-      mcubes->SetValue(0, 100.5);
-      mcubes->ComputeScalarsOff();
-      mcubes->ComputeGradientsOff();
-      mcubes->ComputeNormalsOff();
-      mcubes->ReleaseDataFlagOn();
-      try
-        {
-        mcubes->Update();
-        }
-      catch(...)
+      }
+    for(::size_t l = 0; l < labelModels.size(); l++)
+      {
+      // one voxel of background around the label closes the surface, as in the whole image
+      LabelModel& model = labelModels[l];
+      const int* labelExtent = &labelExtents[6 * (model.Label - minLabel)];
+      for (int axis = 0; axis < 3; ++axis)
         {
-        std::cerr << "ERROR while running marching cubes, for label " << i << std::endl;
-        return EXIT_FAILURE;
+        model.Extent[2 * axis] = std::max(labelExtent[2 * axis] - 1, labelImageExtent[2 * axis]);
+        model.Extent[2 * axis + 1] = std::min(labelExtent[2 * axis + 1] + 1, labelImageExtent[2 * axis + 1]);
         }
       if (debug)
         {
-        std::cout << "\nNumber of polygons = " << (mcubes->GetOutput())->GetNumberOfPolys() << endl;
+        std::cout << "Label " << model.Label << " extent: " << model.Extent[0] << " " << model.Extent[1] << " "
+                  << model.Extent[2] << " " << model.Extent[3] << " " << model.Extent[4] << " " << model.Extent[5] << endl;
         }
+      }
 
-      if ((mcubes->GetOutput())->GetNumberOfPolys()  == 0)
+    vtkSMPTools::For(0, static_cast<vtkIdType>(labelModels.size()), 1, [&](vtkIdType beginModel, vtkIdType endModel)
+      {
+      for (vtkIdType modelIndex = beginModel; modelIndex < endModel; ++modelIndex)
         {
-        std::cout << "Cannot create a model from label " << i
-                  << "\nNo polygons can be created,\nthere may be no voxels with this label in the volume." << endl;
-        if (transformIJKtoLPS)
-          {
-          transformIJKtoLPS = nullptr;
-          }
-        if (imageThreshold)
+        LabelModel& model = labelModels[modelIndex];
+        if (model.Extent[0] <= model.Extent[1] && model.Extent[2] <= model.Extent[3] && model.Extent[4] <= model.Extent[5])
           {
-          if (debug)
+          vtkNew<vtkImageData> labelMask;
+          labelMask->SetExtent(model.Extent);
+          labelMask->SetOrigin(labelImage->GetOrigin());
+          labelMask->SetSpacing(labelImage->GetSpacing());
+          labelMask->AllocateScalars(VTK_UNSIGNED_CHAR, 1);
+          switch (labelImage->GetScalarType())
             {
-            std::cout << "Setting image threshold input to null" << endl;
+            vtkTemplateMacro(ExtractLabelMask<VTK_TT>(labelImage, model.Label, labelMask.GetPointer()));
             }
-          imageThreshold->SetInputData(nullptr);
-          imageThreshold->RemoveAllInputs();
-          imageThreshold = nullptr;
-
-          }
-        if (imageToStructuredPoints)
-          {
-          imageToStructuredPoints->SetInputData(nullptr);
-          imageToStructuredPoints = nullptr;
-          }
-        if (mcubes)
-          {
-          mcubes->SetInputData(nullptr);
-          mcubes = nullptr;
-          }
-        skipLabel = 1;
-        std::cout << "...continuing" << endl;
-        continue;
-        }
-      if (SaveIntermediateModels)
-        {
-        writer = vtkSmartPointer<vtkPolyDataWriter>::New();
-        std::string            commentSaveCubes = "Writing intermediate model after marching cubes " + labelName;
-        vtkPluginFilterWatcher watchWriter(writer,
-                                           commentSaveCubes.c_str(),
-                                           CLPProcessInformation,
-                                           1.0 / numFilterSteps,
-                                           currentFilterOffset / numFilterSteps);
-        currentFilterOffset += 1.0;
-        writer->SetInputConnection(cubes->GetOutputPort());
-        writer->SetHeader(modelFileHeader);
-        writer->SetFileType(2);
-        std::string fileName;
-        if (rootDir != "")
-          {
-          fileName = rootDir + std::string("/") + labelName + std::string("-MarchingCubes.vtk");
-          }
-        else
-          {
-          fileName = labelName + std::string("-MarchingCubes.vtk");
+          GenerateLabelModel(model, labelMask.GetPointer(), nullptr, parameters);
           }
-        if (debug)
-          {
-          watchWriter.QuietOn();
-          std::cout << "Writing intermediate file " << fileName.c_str() << std::endl;
-          }
-        writer->SetFileName(fileName.c_str());
-        if (!writer->Write())
-          {
-          std::cerr << "ERROR: Failed to write intermediate file " << fileName.c_str() << std::endl;
-          }
-        writer->SetInputData(nullptr);
-        writer = nullptr;
+        progress.ModelCompleted(model.Name);
         }
-      }
-    else
+      });
+    }
+  else if (!labelModels.empty())
+    {
+    if (smoother == nullptr)
       {
-      std::cout << "Skipping marching cubes..." << endl;
+      std::cerr << "\nERROR smoothing filter is null for joint smoothing!" << std::endl;
+      return EXIT_FAILURE;
       }
-    if (!skipLabel)
+    // all labels are extracted from the same surface
+    for(::size_t l = 0; l < labelModels.size(); l++)
       {
-      // In switch from vtk 4 to vtk 5, vtkDecimate was deprecated from the Patented dir, use vtkDecimatePro
-      // TODO: look at vtkQuadraticDecimation
-      if (decimator != nullptr)
-        {
-        decimator->SetInputData(nullptr);
-        decimator = nullptr;
-        }
-      decimator = vtkSmartPointer<vtkDecimatePro>::New();
-      std::string            comment6 = "Decimate " + labelName;
-      vtkPluginFilterWatcher watchImageThreshold(decimator,
-                                                 comment6.c_str(),
-                                                 CLPProcessInformation,
-                                                 1.0 / numFilterSteps,
-                                                 currentFilterOffset / numFilterSteps);
-      currentFilterOffset += 1.0;
-      if (debug)
-        {
-        watchImageThreshold.QuietOn();
-        }
-      if (JointSmoothing == 0)
-        {
-        decimator->SetInputConnection(mcubes->GetOutputPort());
-        }
-      else
-        {
-        decimator->SetInputConnection(geometryFilter->GetOutputPort());
-        }
-      decimator->SetFeatureAngle(60);
-      // decimator->SetMaximumIterations(Decimate);
-      // decimator->SetMaximumSubIterations(0);
-
-      // decimator->PreserveEdgesOn();
-      decimator->SplittingOff();
-      decimator->PreserveTopologyOn();
-
-      decimator->SetMaximumError(1);
-      decimator->SetTargetReduction(Decimate);
-      // decimator->SetInitialError(0.0002);
-      // decimator->SetErrorIncrement(0.002);
-      decimator->ReleaseDataFlagOff();
+      GenerateLabelModel(labelModels[l], nullptr, smoother->GetOutput(), parameters);
+      progress.ModelCompleted(labelModels[l].Name);
+      }
+    }
 
-      try
-        {
-        decimator->Update();
-        }
-      catch(...)
-        {
-        std::cerr << "ERROR decimating model " << i << std::endl;
-        return EXIT_FAILURE;
-        }
+  //
+  // Add the models to the scene in label order, so that the scene does not depend
+  // on the order in which the models were completed
+  //
+  for(::size_t l = 0; l < labelModels.size(); l++)
+    {
+    const LabelModel& model = labelModels[l];
+    int i = model.Label;
+    labelName = model.Name;
+    std::string fileName = model.FileName;
+    if (!model.Error.empty())
+      {
+      std::cerr << model.Error << ", for label " << i << std::endl;
+      return EXIT_FAILURE;
+      }
+    if (!model.Generated)
+      {
+      std::cout << "Cannot create a model from label " << i
+                << "\nNo polygons can be created,\nthere may be no voxels with this label in the volume." << endl;
+      std::cout << "...continuing" << endl;
+      continue;
+      }
+    if (debug)
+      {
+      std::cout << "Wrote model " << " " << labelName << " to file " << fileName.c_str()
+                << ", number of cells = " << model.NumberOfPolygons << endl;
+      }
+    if (!model.Written)
+      {
+      std::cerr << "ERROR: Failed to write model file " << fileName.c_str() << std::endl;
+      }
+    if (modelScene.GetPointer() != nullptr)
+      {
       if (debug)
         {
-        std::cout << "After decimation, number of polygons = " << (decimator->GetOutput())->GetNumberOfPolys() << endl;
+        std::cout << "Adding model " << labelName << " to the output scene, with filename " << fileName.c_str()
+                  << endl;
         }
+      // each model needs a mrml node, a storage node and a display node
+      vtkNew<vtkMRMLModelNode> mnode;
+      mnode->SetScene(modelScene.GetPointer());
+      mnode->SetName(labelName.c_str());
 
-      if (SaveIntermediateModels)
-        {
-        writer = vtkSmartPointer<vtkPolyDataWriter>::New();
-        std::string            commentSaveDecimation = "Writing intermediate model after decimation " + labelName;
-        vtkPluginFilterWatcher watchWriter(writer,
-                                           commentSaveDecimation.c_str(),
-                                           CLPProcessInformation,
-                                           1.0 / numFilterSteps,
-                                           currentFilterOffset / numFilterSteps);
-        currentFilterOffset += 1.0;
-        writer->SetInputConnection(decimator->GetOutputPort());
-        writer->SetHeader(modelFileHeader);
-        writer->SetFileType(2);
-        std::string fileName;
-        if (rootDir != "")
-          {
-          fileName = rootDir + std::string("/") + labelName + std::string("-Decimated.vtk");
-          }
-        else
-          {
-          fileName = labelName + std::string("-MarchingCubes.vtk");
-          }
-        if (debug)
-          {
-          watchWriter.QuietOn();
-          std::cout << "Writing intermediate file " << fileName.c_str() << std::endl;
-          }
-        writer->SetFileName(fileName.c_str());
-        if (!writer->Write())
-          {
-          std::cerr << "ERROR: Failed to write intermediate file " << fileName.c_str() << std::endl;
-          }
-        writer->SetInputData(nullptr);
-        writer = nullptr;
-        }
-      if (transformIJKtoLPS == nullptr ||
-          transformIJKtoLPS->GetMatrix() == nullptr)
+      vtkNew<vtkMRMLModelStorageNode> snode;
+      snode->SetFileName(fileName.c_str());
+      if (modelScene->AddNode(snode.GetPointer()) == nullptr)
         {
-        std::cout << "transformIJKtoLPS is "
-                  << (transformIJKtoLPS ==
-            nullptr ? "null" : "okay") << ", it's matrix is "
-                  << (transformIJKtoLPS->GetMatrix() == nullptr ? "null" : "okay") << endl;
-        }
-      else if ((transformIJKtoLPS->GetMatrix())->Determinant() < 0)
-        {
-        if (debug)
-          {
-          std::cout << "Determinant " << (transformIJKtoLPS->GetMatrix())->Determinant()
-                    << " is less than zero, reversing..." << endl;
-          }
-        if (reverser)
-          {
-          reverser->SetInputData(nullptr);
-          reverser = nullptr;
-          }
-        reverser = vtkSmartPointer<vtkReverseSense>::New();
-        std::string            comment7 = "Reverse " + labelName;
-        vtkPluginFilterWatcher watchReverser(reverser,
-                                             comment7.c_str(),
-                                             CLPProcessInformation,
-                                             1.0 / numFilterSteps,
-                                             currentFilterOffset / numFilterSteps);
-        currentFilterOffset += 1.0;
-        if (debug)
-          {
-          watchReverser.QuietOn();
-          }
-        reverser->SetInputConnection(decimator->GetOutputPort());
-        reverser->ReverseNormalsOn();
-        reverser->ReleaseDataFlagOn();
+        std::cerr << "ERROR: unable to add the storage node to the model scene" << endl;
         }
-
-      if (JointSmoothing == 0)
+      vtkNew<vtkMRMLModelDisplayNode> dnode;
+      dnode->SetColor(0.5, 0.5, 0.5);
+      double *rgba;
+      if (colorNode != nullptr)
         {
-        if (strcmp(FilterType.c_str(), "Sinc") == 0)
+        rgba = colorNode->GetLookupTable()->GetTableValue(i);
+        if (rgba != nullptr)
           {
-
-          if (smootherSinc)
-            {
-            smootherSinc->SetInputData(nullptr);
-            smootherSinc = nullptr;
-            }
-          smootherSinc = vtkSmartPointer<vtkWindowedSincPolyDataFilter>::New();
-          std::string            comment8 = "Smooth " + labelName;
-          vtkPluginFilterWatcher watchSmoother(smootherSinc,
-                                               comment8.c_str(),
-                                               CLPProcessInformation,
-                                               1.0 / numFilterSteps,
-                                               currentFilterOffset / numFilterSteps);
-          currentFilterOffset += 1.0;
           if (debug)
             {
-            watchSmoother.QuietOn();
-            }
-          smootherSinc->SetPassBand(0.1);
-          if (Smooth == 1)
-            {
-            std::cerr << "Warning: Smoothing iterations of 1 not allowed for Sinc filter, using 2" << endl;
-            Smooth = 2;
-            }
-          if ((transformIJKtoLPS->GetMatrix())->Determinant() < 0)
-            {
-            smootherSinc->SetInputConnection(reverser->GetOutputPort());
-            }
-          else
-            {
-            smootherSinc->SetInputConnection(decimator->GetOutputPort());
-            }
-          smootherSinc->SetNumberOfIterations(Smooth);
-          smootherSinc->FeatureEdgeSmoothingOff();
-          smootherSinc->BoundarySmoothingOff();
-          smootherSinc->ReleaseDataFlagOn();
-          try
-            {
-            smootherSinc->Update();
-            }
-          catch(...)
-            {
-            std::cerr << "ERROR updating Sinc smoother for model " << i << std::endl;
-            return EXIT_FAILURE;
+            std::cout << "Got colour: " << rgba[0] << " " << rgba[1] << " " << rgba[2] << " " << rgba[3] << endl;
             }
+          dnode->SetColor(rgba[0], rgba[1], rgba[2]);
           }
         else
           {
-          if (smootherPoly)
-            {
-            smootherPoly->SetInputData(nullptr);
-            smootherPoly = nullptr;
-            }
-          smootherPoly = vtkSmartPointer<vtkSmoothPolyDataFilter>::New();
-          std::string            comment9 = "Smooth " + labelName;
-          vtkPluginFilterWatcher watchSmoother(smootherPoly,
-                                               comment9.c_str(),
-                                               CLPProcessInformation,
-                                               1.0 / numFilterSteps,
-                                               currentFilterOffset / numFilterSteps);
-          currentFilterOffset += 1.0;
-          if (debug)
-            {
-            watchSmoother.QuietOn();
-            }
-
-          // this next line massively rounds corners
-          smootherPoly->SetRelaxationFactor(0.33);
-          smootherPoly->SetFeatureAngle(60);
-          smootherPoly->SetConvergence(0);
-
-          if ((transformIJKtoLPS->GetMatrix())->Determinant() < 0)
-            {
-            smootherPoly->SetInputConnection(reverser->GetOutputPort());
-            }
-          else
-            {
-            smootherPoly->SetInputConnection(decimator->GetOutputPort());
-            }
-          smootherPoly->SetNumberOfIterations(Smooth);
-          smootherPoly->FeatureEdgeSmoothingOff();
-          smootherPoly->BoundarySmoothingOff();
-          smootherPoly->ReleaseDataFlagOn();
-          try
-            {
-            smootherPoly->Update();
-            }
-          catch(...)
-            {
-            std::cerr << "ERROR updating Poly smoother for model " << i << std::endl;
-            return EXIT_FAILURE;
-            }
-          }
-
-        if (SaveIntermediateModels)
-          {
-          writer = vtkSmartPointer<vtkPolyDataWriter>::New();
-          std::string            commentSaveSmoothed = "Writing intermediate model after smoothing " + labelName;
-          vtkPluginFilterWatcher watchWriter(writer,
-                                             commentSaveSmoothed.c_str(),
-                                             CLPProcessInformation,
-                                             1.0 / numFilterSteps,
-                                             currentFilterOffset / numFilterSteps);
-          currentFilterOffset += 1.0;
-          if (strcmp(FilterType.c_str(), "Sinc") == 0)
-            {
-            writer->SetInputConnection(smootherSinc->GetOutputPort());
-            }
-          else
-            {
-            writer->SetInputConnection(smootherPoly->GetOutputPort());
-            }
-          writer->SetHeader(modelFileHeader);
-          writer->SetFileType(2);
-          std::string fileName;
-          if (rootDir != "")
-            {
-            fileName = rootDir + std::string("/") + labelName + std::string("-Smoothed.vtk");
-            }
-          else
-            {
-            fileName = labelName + std::string("-Smoothed.vtk");
-            }
-          if (debug)
-            {
-            watchWriter.QuietOn();
-            std::cout << "Writing intermediate file " << fileName.c_str() << std::endl;
-            }
-          writer->SetFileName(fileName.c_str());
-          if (!writer->Write())
-            {
-            std::cerr << "ERROR: Failed to write intermediate file " << fileName.c_str() << std::endl;
-            }
-          writer->SetInputData(nullptr);
-          writer = nullptr;
+          std::cerr << "Couldn't get look up table value for " << i << ", display node colour is not set (grey)"
+                    << endl;
           }
         }
 
-      if (transformer)
-        {
-        transformer->SetInputData(nullptr);
-        transformer = nullptr;
-        }
-      transformer = vtkSmartPointer<vtkTransformPolyDataFilter>::New();
-      std::string            comment1 = "Transform " + labelName;
-      vtkPluginFilterWatcher watchTransformer(transformer,
-                                              comment1.c_str(),
-                                              CLPProcessInformation,
-                                              1.0 / numFilterSteps,
-                                              currentFilterOffset / numFilterSteps);
-      currentFilterOffset += 1.0;
+      dnode->SetVisibility(1);
+      modelScene->AddNode(dnode.GetPointer());
       if (debug)
         {
-        watchTransformer.QuietOn();
+        std::cout << "Added display node: id = " << (dnode->GetID() == nullptr ? "(null)" : dnode->GetID()) << endl;
+        std::cout << "Setting model's storage node: id = "
+                  << (snode->GetID() == nullptr ? "(null)" : snode->GetID()) << endl;
         }
-      if (JointSmoothing == 0)
+      mnode->SetAndObserveStorageNodeID(snode->GetID());
+      mnode->SetAndObserveDisplayNodeID(dnode->GetID());
+      modelScene->AddNode(mnode.GetPointer());
+
+      // put it in the hierarchy, either the flat one by default or
+      // try to find the matching color hierarchy node to make this an
+      // associated node
+      std::string colorName;
+      if (colorNode != nullptr)
         {
-        if (strcmp(FilterType.c_str(), "Sinc") == 0)
-          {
-          transformer->SetInputConnection(smootherSinc->GetOutputPort());
-          }
-        else
-          {
-          transformer->SetInputConnection(smootherPoly->GetOutputPort());
-          }
+        colorName = std::string(colorNode->GetColorNameAsFileName(i));
         }
       else
         {
-        if ((transformIJKtoLPS->GetMatrix())->Determinant() < 0)
-          {
-          transformer->SetInputConnection(reverser->GetOutputPort());
-          }
-        else
+        // might be in a testing case where the hierarchy nodes are
+        // numbered (made from the generic colors)
+        std::stringstream ss;
+        ss << i;
+        colorName = ss.str();
+        if (debug)
           {
-          transformer->SetInputConnection(decimator->GetOutputPort());
+          std::cout << "No color node, guessing at color name being same as label number " << colorName.c_str() << std::endl;
           }
         }
-
-      transformer->SetTransform(transformIJKtoLPS);
-      if (debug)
+      vtkMRMLNode *mrmlNode = nullptr;
+      if (colorName.compare("") != 0)
         {
-        // transformIJKtoLPS->GetMatrix()->Print(std::cout);
+        mrmlNode = modelScene->GetFirstNodeByName(colorName.c_str());
         }
-
-      transformer->ReleaseDataFlagOn();
-      if (normals)
-        {
-        normals->SetInputData(nullptr);
-        normals = nullptr;
-        }
-      normals = vtkSmartPointer<vtkPolyDataNormals>::New();
-      std::string            comment2 = "Normals " + labelName;
-      vtkPluginFilterWatcher watchNormals(normals,
-                                          comment2.c_str(),
-                                          CLPProcessInformation,
-                                          1.0 / numFilterSteps,
-                                          currentFilterOffset / numFilterSteps);
-      currentFilterOffset += 1.0;
-      if (debug)
+      // if there's no color hierarchy, or no color name or the mrml node
+      // named for the color isn't a model hierarchy node, use a flat hierarchy
+      if (topColorHierarchyNode == nullptr ||
+          colorName.compare("") == 0 ||
+          mrmlNode == nullptr ||
+          strcmp(mrmlNode->GetClassName(),"vtkMRMLModelHierarchyNode") != 0)
         {
-        watchNormals.QuietOn();
-        }
-
-      if (PointNormals)
-        {
-        normals->ComputePointNormalsOn();
+        vtkNew<vtkMRMLModelHierarchyNode> mhnd;
+        mhnd->SetHideFromEditors(1);
+        modelScene->AddNode(mhnd.GetPointer());
+        mhnd->SetParentNodeID(rnd->GetID());
+        mhnd->SetModelNodeID(mnode->GetID());
         }
       else
         {
-        normals->ComputePointNormalsOff();
-        }
-      normals->SetInputConnection(transformer->GetOutputPort());
-      normals->SetFeatureAngle(60);
-      normals->SetSplitting(SplitNormals);
-
-      normals->ReleaseDataFlagOn();
-
-      if (stripper)
-        {
-        stripper->SetInputData(nullptr);
-        stripper = nullptr;
-        }
-      stripper = vtkSmartPointer<vtkStripper>::New();
-      std::string            comment3 = "Strip " + labelName;
-      vtkPluginFilterWatcher watchStripper(stripper,
-                                           comment3.c_str(),
-                                           CLPProcessInformation,
-                                           1.0 / numFilterSteps,
-                                           currentFilterOffset / numFilterSteps);
-      currentFilterOffset += 1.0;
-      if (debug)
-        {
-        watchStripper.QuietOn();
-        }
-      stripper->SetInputConnection(normals->GetOutputPort());
-      stripper->ReleaseDataFlagOff();
-
-      // the poly data output from the stripper can be set as an input to a
-      // model's polydata
-      try
-        {
-        stripper->Update();
-        }
-      catch(...)
-        {
-        std::cerr << "ERROR updating stripper for model " << i << std::endl;
-        return EXIT_FAILURE;
-        }
-
-      // but for now we're just going to write it out
-      writer = vtkSmartPointer<vtkPolyDataWriter>::New();
-      std::string            comment4 = "Write " + labelName;
-      vtkPluginFilterWatcher watchWriter(writer,
-                                         comment4.c_str(),
-                                         CLPProcessInformation,
-                                         1.0 / numFilterSteps,
-                                         currentFilterOffset / numFilterSteps);
-      currentFilterOffset += 1.0;
-      if (debug)
-        {
-        watchWriter.QuietOn();
-        }
-      writer->SetInputConnection(stripper->GetOutputPort());
-      writer->SetHeader(modelFileHeader);
-      writer->SetFileType(2);
-      std::string fileName;
-      if (rootDir != "")
-        {
-        fileName = rootDir + std::string("/") + labelName + std::string(".vtk");
-        }
-      else
-        {
-        std::cout << "WARNING: output directory is an empty string..." << endl;
-        fileName = labelName + std::string(".vtk");
-        }
-      writer->SetFileName(fileName.c_str());
-
-      if (debug)
-        {
-        std::cout << "Writing model " << " " << labelName << " to file " << writer->GetFileName()  << endl;
-        }
-      if (!writer->Write())
-        {
-        std::cerr << "ERROR: Failed to write model file " << fileName.c_str() << std::endl;
-        }
-      writer->SetInputData(nullptr);
-      writer = nullptr;
-      if (modelScene.GetPointer() != nullptr)
-        {
-        if (debug)
-          {
-          std::cout << "Adding model " << labelName << " to the output scene, with filename " << fileName.c_str()
-                    << endl;
-          }
-        // each model needs a mrml node, a storage node and a display node
-        vtkNew<vtkMRMLModelNode> mnode;
-        mnode->SetScene(modelScene.GetPointer());
-        mnode->SetName(labelName.c_str());
-
-        vtkNew<vtkMRMLModelStorageNode> snode;
-        snode->SetFileName(fileName.c_str());
-        if (modelScene->AddNode(snode.GetPointer()) == nullptr)
+        // use the template color hierarchy
+        vtkMRMLModelHierarchyNode *colorHierarchyNode = vtkMRMLModelHierarchyNode::SafeDownCast(mrmlNode);
+        if (colorHierarchyNode)
           {
-          std::cerr << "ERROR: unable to add the storage node to the model scene" << endl;
-          }
-        vtkNew<vtkMRMLModelDisplayNode> dnode;
-        dnode->SetColor(0.5, 0.5, 0.5);
-        double *rgba;
-        if (colorNode != nullptr)
-          {
-          rgba = colorNode->GetLookupTable()->GetTableValue(i);
-          if (rgba != nullptr)
-            {
-            if (debug)
-              {
-              std::cout << "Got colour: " << rgba[0] << " " << rgba[1] << " " << rgba[2] << " " << rgba[3] << endl;
-              }
-            dnode->SetColor(rgba[0], rgba[1], rgba[2]);
-            }
-          else
-            {
-            std::cerr << "Couldn't get look up table value for " << i << ", display node colour is not set (grey)"
-                      << endl;
-            }
-          }
-
-        dnode->SetVisibility(1);
-        modelScene->AddNode(dnode.GetPointer());
-        if (debug)
-          {
-          std::cout << "Added display node: id = " << (dnode->GetID() == nullptr ? "(null)" : dnode->GetID()) << endl;
-          std::cout << "Setting model's storage node: id = "
-                    << (snode->GetID() == nullptr ? "(null)" : snode->GetID()) << endl;
-          }
-        mnode->SetAndObserveStorageNodeID(snode->GetID());
-        mnode->SetAndObserveDisplayNodeID(dnode->GetID());
-        modelScene->AddNode(mnode.GetPointer());
-
-        // put it in the hierarchy, either the flat one by default or
-        // try to find the matching color hierarchy node to make this an
-        // associated node
-        std::string colorName;
-        if (colorNode != nullptr)
-          {
-          colorName = std::string(colorNode->GetColorNameAsFileName(i));
-          }
-        else
-          {
-          // might be in a testing case where the hierarchy nodes are
-          // numbered (made from the generic colors)
-          std::stringstream ss;
-          ss << i;
-          colorName = ss.str();
+          colorHierarchyNode->SetAssociatedNodeID(mnode->GetID());
+          // and hide it so that it doesn't clutter up the tree
+          colorHierarchyNode->SetHideFromEditors(1);
           if (debug)
             {
-            std::cout << "No color node, guessing at color name being same as label number " << colorName.c_str() << std::endl;
+            std::cout << "Found a color hierarchy node with name " << colorHierarchyNode->GetName() << ", set it's associated node to this model id: " << mnode->GetID() << std::endl;
             }
           }
-        vtkMRMLNode *mrmlNode = nullptr;
-        if (colorName.compare("") != 0)
-          {
-          mrmlNode = modelScene->GetFirstNodeByName(colorName.c_str());
-          }
-        // if there's no color hierarchy, or no color name or the mrml node
-        // named for the color isn't a model hierarchy node, use a flat hierarchy
-        if (topColorHierarchyNode == nullptr ||
-            colorName.compare("") == 0 ||
-            mrmlNode == nullptr ||
-            strcmp(mrmlNode->GetClassName(),"vtkMRMLModelHierarchyNode") != 0)
-          {
-          vtkNew<vtkMRMLModelHierarchyNode> mhnd;
-          mhnd->SetHideFromEditors(1);
-          modelScene->AddNode(mhnd.GetPointer());
-          mhnd->SetParentNodeID(rnd->GetID());
-          mhnd->SetModelNodeID(mnode->GetID());
-          }
-        else
-          {
-          // use the template color hierarchy
-          vtkMRMLModelHierarchyNode *colorHierarchyNode = vtkMRMLModelHierarchyNode::SafeDownCast(mrmlNode);
-          if (colorHierarchyNode)
-            {
-            colorHierarchyNode->SetAssociatedNodeID(mnode->GetID());
-            // and hide it so that it doesn't clutter up the tree
-            colorHierarchyNode->SetHideFromEditors(1);
-            if (debug)
-              {
-              std::cout << "Found a color hierarchy node with name " << colorHierarchyNode->GetName() << ", set it's associated node to this model id: " << mnode->GetID() << std::endl;
-              }
-            }
-          }
-        if (debug)
-          {
-          std::cout << "...done adding model to output scene" << endl;
-          }
         }
-      } // end of skipping an empty label
-    }   // end of loop over labels
+      if (debug)
+        {
+        std::cout << "...done adding model to output scene" << endl;
+        }
+      }
+    }
   if (debug)
     {
     std::cout << "End of looping over labels" << endl;
@@ -1862,83 +1756,6 @@ int main(int argc, char * argv[])
     hist->SetInputData(nullptr);
     hist = nullptr;
     }
-  if (smootherSinc)
-    {
-    if (debug)
-      {
-      std::cout << "Deleting smootherSinc" << endl;
-      }
-    smootherSinc->SetInputData(nullptr);
-    smootherSinc = nullptr;
-    }
-  if (smootherPoly)
-    {
-    if (debug)
-      {
-      std::cout << "Deleting smoother poly" << endl;
-      }
-    smootherPoly->SetInputData(nullptr);
-    smootherPoly = nullptr;
-    }
-  if (decimator)
-    {
-    if (debug)
-      {
-      std::cout << "Deleting decimator" << endl;
-      }
-    decimator->SetInputData(nullptr);
-    decimator = nullptr;
-    }
-  if (mcubes)
-    {
-    if (debug)
-      {
-      std::cout << "Deleting mcubes" << endl;
-      }
-    mcubes->SetInputData(nullptr);
-    mcubes = nullptr;
-    }
-  if (imageThreshold)
-    {
-    if (debug)
-      {
-      std::cout << "Deleting image threshold" << endl;
-      }
-    imageThreshold->SetInputData(nullptr);
-    imageThreshold->RemoveAllInputs();
-    imageThreshold = nullptr;
-    if (debug)
-      {
-      std::cout << "... done deleting image threshold" << endl;
-      }
-    }
-  if (threshold)
-    {
-    if (debug)
-      {
-      cout << "Deleting threshold" << endl;
-      }
-    threshold->SetInputData(nullptr);
-    threshold = nullptr;
-    }
-  if (imageToStructuredPoints)
-    {
-    if (debug)
-      {
-      std::cout << "Deleting image to structured points" << endl;
-      }
-    imageToStructuredPoints->SetInputData(nullptr);
-    imageToStructuredPoints = nullptr;
-    }
-  if (geometryFilter)
-    {
-    if (debug)
-      {
-      cout << "Deleting geometry filter" << endl;
-      }
-    geometryFilter->SetInputData(nullptr);
-    geometryFilter = nullptr;
-    }
   if (transformIJKtoLPS)
     {
     if (debug)
@@ -1948,42 +1765,6 @@ int main(int argc, char * argv[])
     transformIJKtoLPS->SetInput(nullptr);
     transformIJKtoLPS = nullptr;
     }
-  if (reverser)
-    {
-    if (debug)
-      {
-      std::cout << "Deleting reverser" << endl;
-      }
-    reverser->SetInputData(nullptr);
-    reverser = nullptr;
-    }
-  if (transformer)
-    {
-    if (debug)
-      {
-      std::cout << "Deleting transformer" << endl;
-      }
-    transformer->SetInputData(nullptr);
-    transformer = nullptr;
-    }
-  if (normals)
-    {
-    if (debug)
-      {
-      std::cout << "Deleting normals" << endl;
-      }
-    normals->SetInputData(nullptr);
-    normals = nullptr;
-    }
-  if (stripper)
-    {
-    if (debug)
-      {
-      std::cout << "Deleting stripper" << endl;
-      }
-    stripper->SetInputData(nullptr);
-    stripper = nullptr;
-    }
   if (ici.GetPointer())
     {
     if (debug)
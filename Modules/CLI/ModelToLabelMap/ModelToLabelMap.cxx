@@ -14,16 +14,10 @@
 
 // VTK includes
 #include <vtkImageData.h>
-#include <vtkImageStencil.h>
+#include <vtkMatrix4x4.h>
 #include <vtkNew.h>
 #include <vtkPointData.h>
 #include <vtkPolyData.h>
-#include <vtkPolyDataNormals.h>
-#include <vtkPolyDataToImageStencil.h>
-#include <vtkStripper.h>
-#include <vtkTransform.h>
-#include <vtkTransformPolyDataFilter.h>
-#include <vtkTriangleFilter.h>
 
 // MRML includes
 #include "vtkMRMLModelNode.h"
@@ -31,6 +25,9 @@
 #include "vtkMRMLScalarVolumeNode.h"
 #include "vtkMRMLLabelMapVolumeNode.h"
 #include "vtkMRMLVolumeArchetypeStorageNode.h"
+
+// SegmentationCore includes
+#include "vtkClosedSurfaceToBinaryLabelmapConversionRule.h"
 #include "vtkOrientedImageData.h"
 
 
@@ -87,51 +84,22 @@ int main( int argc, char * argv[] )
     }
   binaryLabelmap->GetPointData()->GetScalars()->Fill(0); // background voxels are 0
 
-  // Now the output labelmap image data contains the right geometry.
-  // We need to apply inverse of geometry matrix to the input poly data so that we can perform
-  // the conversion in IJK space, because the filters do not support oriented image data.
+  // Voxelize the surface directly into the labelmap, in parallel slabs
   vtkNew<vtkMatrix4x4> ijkToRASMatrix;
   referenceVolumeNode->GetIJKToRASMatrix(ijkToRASMatrix);
-  vtkNew<vtkTransform> rasToIJKTransform;
-  rasToIJKTransform->SetMatrix(ijkToRASMatrix);
-  rasToIJKTransform->Inverse();
-
-  // Leave to identity matrix in binary labelmap volume so that we can perform the stencil operation in IJK space,
-  // and now we convert the closed surface to IJK space, too.
-  vtkNew<vtkTransformPolyDataFilter> transformPolyDataFilter;
-  transformPolyDataFilter->SetInputData(closedSurfacePolyData_RAS);
-  transformPolyDataFilter->SetTransform(rasToIJKTransform);
-
-  // Compute polydata normals
-  vtkNew<vtkPolyDataNormals> normalFilter;
-  normalFilter->SetInputConnection(transformPolyDataFilter->GetOutputPort());
-  normalFilter->ConsistencyOn();
-
-  // Make sure that we have a clean triangle polydata
-  vtkNew<vtkTriangleFilter> triangle;
-  triangle->SetInputConnection(normalFilter->GetOutputPort());
-
-  // Convert to triangle strip
-  vtkNew<vtkStripper> stripper;
-  stripper->SetInputConnection(triangle->GetOutputPort());
-
-  // Convert polydata to stencil
-  vtkNew<vtkPolyDataToImageStencil> polyDataToImageStencil;
-  polyDataToImageStencil->SetInputConnection(stripper->GetOutputPort());
-  polyDataToImageStencil->SetOutputSpacing(binaryLabelmap->GetSpacing());
-  polyDataToImageStencil->SetOutputOrigin(binaryLabelmap->GetOrigin());
-  polyDataToImageStencil->SetOutputWholeExtent(binaryLabelmap->GetExtent());
-
-  // Convert stencil to image
-  vtkNew<vtkImageStencil> stencil;
-  stencil->SetInputData(binaryLabelmap);
-  stencil->SetStencilConnection(polyDataToImageStencil->GetOutputPort());
-  stencil->ReverseStencilOn();
-  stencil->SetBackgroundValue(labelValue);
-  stencil->Update();
+  binaryLabelmap->SetGeometryFromImageToWorldMatrix(ijkToRASMatrix);
+  if (!vtkClosedSurfaceToBinaryLabelmapConversionRule::VoxelizeClosedSurface(closedSurfacePolyData_RAS, binaryLabelmap,
+    static_cast<unsigned char>(labelValue)))
+    {
+    std::cerr << "Failed to voxelize input model " << surface << std::endl;
+    return EXIT_FAILURE;
+    }
+  // The volume node stores the geometry, the image data is in IJK space
+  vtkNew<vtkMatrix4x4> identityMatrix;
+  binaryLabelmap->SetGeometryFromImageToWorldMatrix(identityMatrix);
 
   vtkNew<vtkMRMLLabelMapVolumeNode> outputVolumeNode;
-  outputVolumeNode->SetAndObserveImageData(stencil->GetOutput());
+  outputVolumeNode->SetAndObserveImageData(binaryLabelmap);
   outputVolumeNode->SetIJKToRASMatrix(ijkToRASMatrix);
 
   vtkNew<vtkMRMLVolumeArchetypeStorageNode> outputVolumeStorageNode;
@@ -10,9 +10,8 @@
 =========================================================================*/
 #include "itkImageFileWriter.h"
 
-#include "itkResampleImageFilter.h"
 #include "itkBSplineInterpolateImageFunction.h"
-#include "itkConstrainedValueMultiplicationImageFilter.h"
+#include "itkVoxelExpressionImageFilter.h"
 
 #include "itkPluginUtilities.h"
 #include "MultiplyScalarVolumesCLP.h"
@@ -40,9 +39,8 @@ int DoIt( int argc, char * argv[], T )
   typedef itk::ImageFileReader<InputImageType>  ReaderType;
   typedef itk::ImageFileWriter<OutputImageType> WriterType;
 
-  typedef itk::BSplineInterpolateImageFunction<InputImageType>                                             Interpolator;
-  typedef itk::ResampleImageFilter<InputImageType, OutputImageType>                                        ResampleType;
-  typedef itk::ConstrainedValueMultiplicationImageFilter<InputImageType, OutputImageType, OutputImageType> FilterType;
+  typedef itk::BSplineInterpolateImageFunction<InputImageType>             Interpolator;
+  typedef itk::VoxelExpressionImageFilter<InputImageType, OutputImageType> FilterType;
 
   typename ReaderType::Pointer reader1 = ReaderType::New();
   itk::PluginFilterWatcher watchReader1(reader1, "Read Volume 1",
@@ -59,23 +57,15 @@ int DoIt( int argc, char * argv[], T )
   reader1->Update();
   reader2->Update();
 
+  // Volume 2 is interpolated if the two volumes have different geometry
   typename Interpolator::Pointer interp = Interpolator::New();
-  interp->SetInputImage(reader2->GetOutput() );
   interp->SetSplineOrder(order);
 
-  typename ResampleType::Pointer resample = ResampleType::New();
-  resample->SetInput(reader2->GetOutput() );
-  resample->SetOutputParametersFromImage(reader1->GetOutput() );
-  resample->SetInterpolator( interp );
-  resample->SetDefaultPixelValue( 0 );
-  resample->ReleaseDataFlagOn();
-
-  itk::PluginFilterWatcher watchResample(resample, "Resampling",
-                                         CLPProcessInformation);
-
   typename FilterType::Pointer filter = FilterType::New();
-  filter->SetInput1( reader1->GetOutput() );
-  filter->SetInput2( resample->GetOutput() );
+  filter->SetInput( 0, reader1->GetOutput() );
+  filter->SetInput( 1, reader2->GetOutput() );
+  filter->SetInterpolator( 1, interp );
+  filter->AppendMultiply( 1 );
 
   itk::PluginFilterWatcher watchFilter(filter, "Multiplying",
                                        CLPProcessInformation);
@@ -1,6 +1,7 @@
 #include "itkConstantPadImageFilter.h"
-#include "itkExtractImageFilter.h"
 #include "itkImageFileWriter.h"
+#include "itkImageRegionIterator.h"
+#include "itkMultiThreaderBase.h"
 #include "itkN4BiasFieldCorrectionImageFilter.h"
 #include "itkOtsuThresholdImageFilter.h"
 #include "itkShrinkImageFilter.h"
@@ -14,6 +15,10 @@ namespace
 typedef float RealType;
 const int ImageDimension = 3;
 typedef itk::Image<RealType, ImageDimension> ImageType;
+typedef itk::Image<unsigned char, ImageDimension> MaskImageType;
+typedef itk::N4BiasFieldCorrectionImageFilter<ImageType, MaskImageType, ImageType> CorrecterType;
+typedef CorrecterType::BiasFieldControlPointLatticeType LatticeType;
+typedef CorrecterType::ScalarImageType LogFieldImageType;
 
 template <class TFilter>
 class CommandIterationUpdate : public itk::Command
@@ -58,6 +63,77 @@ int SaveIt(ImageType::Pointer img, const char* fname)
   return EXIT_SUCCESS;
 }
 
+/**
+ * Evaluate a log bias field control point lattice on the voxels of image.
+ * The lattice domain is mapped to the largest possible region of the image.
+ * The B-spline evaluation is multithreaded.
+ */
+LogFieldImageType::Pointer ReconstructLogBiasField(const LatticeType* lattice, unsigned int splineOrder,
+                                                   const ImageType* image)
+{
+  const ImageType::RegionType & region = image->GetLargestPossibleRegion();
+  ImageType::PointType origin;
+  image->TransformIndexToPhysicalPoint( region.GetIndex(), origin );
+
+  typedef itk::BSplineControlPointImageFilter<LatticeType, LogFieldImageType> BSplinerType;
+  BSplinerType::Pointer bspliner = BSplinerType::New();
+  bspliner->SetInput( lattice );
+  bspliner->SetSplineOrder( splineOrder );
+  bspliner->SetSize( region.GetSize() );
+  bspliner->SetOrigin( origin );
+  bspliner->SetDirection( image->GetDirection() );
+  bspliner->SetSpacing( image->GetSpacing() );
+  bspliner->Update();
+  return bspliner->GetOutput();
+}
+
+/**
+ * Divide the voxels of image in region by the bias field exp(logField) and store
+ * the result in correctedImage and, if not null, the bias field in biasField.
+ * logField covers the largest possible region of image. Voxels are processed in parallel.
+ */
+void CorrectBiasField(const ImageType* image, const LogFieldImageType* logField, const ImageType::RegionType & region,
+                      ImageType* correctedImage, ImageType* biasField)
+{
+  const ImageType::OffsetType fieldOffset =
+    logField->GetLargestPossibleRegion().GetIndex() - image->GetLargestPossibleRegion().GetIndex();
+  itk::MultiThreaderBase::Pointer threader = itk::MultiThreaderBase::New();
+  threader->ParallelizeImageRegion<ImageDimension>( region,
+    [&]( const ImageType::RegionType & subRegion )
+    {
+    ImageType::RegionType fieldRegion = subRegion;
+    fieldRegion.SetIndex( subRegion.GetIndex() + fieldOffset );
+    itk::ImageRegionConstIterator<ImageType> itImage( image, subRegion );
+    itk::ImageRegionConstIterator<LogFieldImageType> itField( logField, fieldRegion );
+    itk::ImageRegionIterator<ImageType> itCorrected( correctedImage, subRegion );
+    itk::ImageRegionIterator<ImageType> itBias;
+    if( biasField )
+      {
+      itBias = itk::ImageRegionIterator<ImageType>( biasField, subRegion );
+      }
+    for( ; !itImage.IsAtEnd(); ++itImage, ++itField, ++itCorrected )
+      {
+      const RealType bias = std::exp( itField.Get()[0] );
+      itCorrected.Set( itImage.Get() / bias );
+      if( biasField )
+        {
+        itBias.Set( bias );
+        ++itBias;
+        }
+      }
+    }, nullptr );
+}
+
+/** Allocate an image with the geometry of referenceImage on region */
+ImageType::Pointer AllocateImage(const ImageType* referenceImage, const ImageType::RegionType & region)
+{
+  ImageType::Pointer image = ImageType::New();
+  image->CopyInformation( referenceImage );
+  image->SetRegions( region );
+  image->Allocate();
+  return image;
+}
+
 };
 
 int main(int argc, char* * argv)
@@ -67,10 +143,8 @@ int main(int argc, char* * argv)
 
   ImageType::Pointer inputImage = nullptr;
 
-  typedef itk::Image<unsigned char, ImageDimension> MaskImageType;
   MaskImageType::Pointer maskImage = nullptr;
 
-  typedef    itk::N4BiasFieldCorrectionImageFilter<ImageType, MaskImageType, ImageType> CorrecterType;
   CorrecterType::Pointer correcter = CorrecterType::New();
 
   typedef itk::ImageFileReader<ImageType> ReaderType;
@@ -135,6 +209,27 @@ int main(int argc, char* * argv)
     weightImage = weightreader->GetOutput();
     }
 
+  /**
+   * warm start from the log bias field lattice of a previous run
+   */
+  LatticeType::Pointer initialLattice = nullptr;
+  if( initialBiasFieldLatticeName != "" )
+    {
+    typedef itk::ImageFileReader<LatticeType> LatticeReaderType;
+    LatticeReaderType::Pointer latticeReader = LatticeReaderType::New();
+    latticeReader->SetFileName( initialBiasFieldLatticeName.c_str() );
+    try
+      {
+      latticeReader->Update();
+      }
+    catch( itk::ExceptionObject & err )
+      {
+      std::cerr << "Failed to read the initial bias field lattice: " << err << std::endl;
+      return EXIT_FAILURE;
+      }
+    initialLattice = latticeReader->GetOutput();
+    }
+
   /**
    * convergence options
    */
@@ -168,8 +263,6 @@ int main(int argc, char* * argv)
   ImageType::SizeType inputImageSize =
     inputImage->GetLargestPossibleRegion().GetSize();
 
-  ImageType::PointType newOrigin = inputImage->GetOrigin();
-
   if( bsplineOrder )
     {
     correcter->SetSplineOrder(bsplineOrder);
@@ -192,8 +285,6 @@ int main(int argc, char* * argv)
                                              - domain ) / inputImage->GetSpacing()[d] + 0.5 );
       lowerBound[d] = static_cast<itk::SizeValueType>( 0.5 * extraPadding );
       upperBound[d] = extraPadding - lowerBound[d];
-      newOrigin[d] -= ( static_cast<RealType>( lowerBound[d] )
-                        * inputImage->GetSpacing()[d] );
       numberOfControlPoints[d] = numberOfSpans + correcter->GetSplineOrder();
       }
 
@@ -255,7 +346,21 @@ int main(int argc, char* * argv)
   itk::TimeProbe timer;
   timer.Start();
 
-  correcter->SetInput( shrinker->GetOutput() );
+  if( initialLattice )
+    {
+    // Fit only the residual bias that remains after removing the initial bias field
+    LogFieldImageType::Pointer initialLogField =
+      ReconstructLogBiasField( initialLattice, correcter->GetSplineOrder(), shrinker->GetOutput() );
+    ImageType::Pointer warmStartedImage =
+      AllocateImage( shrinker->GetOutput(), shrinker->GetOutput()->GetLargestPossibleRegion() );
+    CorrectBiasField( shrinker->GetOutput(), initialLogField,
+                      shrinker->GetOutput()->GetLargestPossibleRegion(), warmStartedImage, nullptr );
+    correcter->SetInput( warmStartedImage );
+    }
+  else
+    {
+    correcter->SetInput( shrinker->GetOutput() );
+    }
   correcter->SetMaskImage( maskshrinker->GetOutput() );
   if( weightImage )
     {
@@ -312,76 +417,81 @@ int main(int argc, char* * argv)
   /**
    * output
    */
+  LatticeType::ConstPointer logBiasFieldLattice = correcter->GetLogBiasFieldControlPointLattice();
+  if( initialLattice )
+    {
+    if( initialLattice->GetLargestPossibleRegion().GetSize() != logBiasFieldLattice->GetLargestPossibleRegion().GetSize() )
+      {
+      std::cerr << "Size of the initial bias field lattice ("
+                << initialLattice->GetLargestPossibleRegion().GetSize()
+                << ") does not match the fitted lattice ("
+                << logBiasFieldLattice->GetLargestPossibleRegion().GetSize()
+                << "). Use the same B-spline grid, order and number of iterations as the run that created it."
+                << std::endl;
+      return EXIT_FAILURE;
+      }
+    // B-splines are linear in the control points, therefore the log bias
+    // field of the initial and the residual fits add up in the lattice
+    LatticeType::Pointer combinedLattice = LatticeType::New();
+    combinedLattice->CopyInformation( logBiasFieldLattice );
+    combinedLattice->SetRegions( logBiasFieldLattice->GetLargestPossibleRegion() );
+    combinedLattice->Allocate();
+    itk::ImageRegionConstIterator<LatticeType> itFitted( logBiasFieldLattice, logBiasFieldLattice->GetLargestPossibleRegion() );
+    itk::ImageRegionConstIterator<LatticeType> itInitial( initialLattice, initialLattice->GetLargestPossibleRegion() );
+    itk::ImageRegionIterator<LatticeType> itCombined( combinedLattice, combinedLattice->GetLargestPossibleRegion() );
+    for( ; !itCombined.IsAtEnd(); ++itFitted, ++itInitial, ++itCombined )
+      {
+      itCombined.Set( itFitted.Get() + itInitial.Get() );
+      }
+    logBiasFieldLattice = combinedLattice;
+    }
+
+  if( outputBiasFieldLatticeName != "" )
+    {
+    typedef itk::ImageFileWriter<LatticeType> LatticeWriterType;
+    LatticeWriterType::Pointer latticeWriter = LatticeWriterType::New();
+    latticeWriter->SetFileName( outputBiasFieldLatticeName.c_str() );
+    latticeWriter->SetInput( logBiasFieldLattice );
+    try
+      {
+      latticeWriter->Update();
+      }
+    catch( itk::ExceptionObject & err )
+      {
+      std::cerr << "Failed to write the bias field lattice: " << err << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
   if( outputImageName != "" )
     {
     /**
      * Reconsruct the bias field at full image resoluion.  Divide
      * the original input image by the bias field to get the final
-     * corrected image.
+     * corrected image. Only the voxels of the original (not padded)
+     * input image are computed.
      */
-    typedef itk::BSplineControlPointImageFilter<
-      CorrecterType::BiasFieldControlPointLatticeType,
-      CorrecterType::ScalarImageType> BSplinerType;
-    BSplinerType::Pointer bspliner = BSplinerType::New();
-    bspliner->SetInput( correcter->GetLogBiasFieldControlPointLattice() );
-    bspliner->SetSplineOrder( correcter->GetSplineOrder() );
-    bspliner->SetSize( inputImage->GetLargestPossibleRegion().GetSize() );
-    bspliner->SetOrigin( newOrigin );
-    bspliner->SetDirection( inputImage->GetDirection() );
-    bspliner->SetSpacing( inputImage->GetSpacing() );
-    bspliner->Update();
-
-    ImageType::Pointer logField = ImageType::New();
-    logField->SetOrigin( inputImage->GetOrigin() );
-    logField->SetSpacing( inputImage->GetSpacing() );
-    logField->SetRegions( inputImage->GetLargestPossibleRegion() );
-    logField->SetDirection( inputImage->GetDirection() );
-    logField->Allocate();
-
-    itk::ImageRegionIterator<CorrecterType::ScalarImageType> IB(
-      bspliner->GetOutput(),
-      bspliner->GetOutput()->GetLargestPossibleRegion() );
-    itk::ImageRegionIterator<ImageType> IF( logField,
-                                            logField->GetLargestPossibleRegion() );
-    for( IB.GoToBegin(), IF.GoToBegin(); !IB.IsAtEnd(); ++IB, ++IF )
-      {
-      IF.Set( IB.Get()[0] );
-      }
-
-    typedef itk::ExpImageFilter<ImageType, ImageType> ExpFilterType;
-    ExpFilterType::Pointer expFilter = ExpFilterType::New();
-    expFilter->SetInput( logField );
-    expFilter->Update();
-
-    typedef itk::DivideImageFilter<ImageType, ImageType, ImageType> DividerType;
-    DividerType::Pointer divider = DividerType::New();
-    divider->SetInput1( inputImage );
-    divider->SetInput2( expFilter->GetOutput() );
-    divider->Update();
+    LogFieldImageType::Pointer logField =
+      ReconstructLogBiasField( logBiasFieldLattice, correcter->GetSplineOrder(), inputImage );
 
     ImageType::RegionType inputRegion;
     inputRegion.SetIndex( inputImageIndex );
     inputRegion.SetSize( inputImageSize );
 
-    typedef itk::ExtractImageFilter<ImageType, ImageType> CropperType;
-    CropperType::Pointer cropper = CropperType::New();
-    cropper->SetInput( divider->GetOutput() );
-    cropper->SetExtractionRegion( inputRegion );
-    cropper->SetDirectionCollapseToSubmatrix();
-    cropper->Update();
-
-    CropperType::Pointer biasFieldCropper = CropperType::New();
-    biasFieldCropper->SetInput( expFilter->GetOutput() );
-    biasFieldCropper->SetExtractionRegion( inputRegion );
-    biasFieldCropper->SetDirectionCollapseToSubmatrix();
-    biasFieldCropper->Update();
-
+    ImageType::Pointer correctedImage = AllocateImage( inputImage, inputRegion );
+    ImageType::Pointer biasField = nullptr;
     if( outputBiasFieldName != "" )
+      {
+      biasField = AllocateImage( inputImage, inputRegion );
+      }
+    CorrectBiasField( inputImage, logField, inputRegion, correctedImage, biasField );
+
+    if( biasField )
       {
       typedef itk::ImageFileWriter<ImageType> WriterType;
       WriterType::Pointer writer = WriterType::New();
       writer->SetFileName( outputBiasFieldName.c_str() );
-      writer->SetInput( biasFieldCropper->GetOutput() );
+      writer->SetInput( biasField );
       writer->SetUseCompression(true);
       writer->Update();
       }
@@ -398,7 +508,7 @@ int main(int argc, char* * argv)
       // signed types
       const char *fname = outputImageName.c_str();
 
-      return SaveIt(cropper->GetOutput(), fname);
+      return SaveIt(correctedImage, fname);
       }
     catch( itk::ExceptionObject & e )
       {
@@ -5,20 +5,115 @@
 #include <vtkTeemNRRDReader.h>
 
 // VTK includes
+#include <vtkCharArray.h>
 #include <vtkImageData.h>
+#include <vtkMath.h>
+#include <vtkMatrix4x4.h>
 #include <vtkNew.h>
-#include <vtkPolyData.h>
-#include <vtkPolyDataReader.h>
-#include <vtkPolyDataWriter.h>
-#include <vtkProbeFilter.h>
-#include <vtkTransform.h>
-#include <vtkTransformFilter.h>
-#include <vtkImageChangeInformation.h>
+#include <vtkPointData.h>
+#include <vtkPointSet.h>
+#include <vtkSMPTools.h>
+#include <vtkSmartPointer.h>
 
 #include "vtkMRMLModelNode.h"
 #include "vtkMRMLModelStorageNode.h"
 
-#include <vtksys/SystemTools.hxx>
+// STD includes
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace
+{
+
+/// Points that are slightly outside the volume (less than this distance, in voxels)
+/// are probed at the closest position in the volume
+const double PROBE_TOLERANCE = 1e-3;
+
+/// Precomputed lookup of a point in a volume: index offsets of the 8 corners
+/// of the containing voxel cell and trilinear interpolation weights
+struct ProbeLocation
+{
+  vtkIdType CornerOffsets[8];
+  double Weights[8];
+};
+
+//----------------------------------------------------------------------------
+// Find the cell around a point given in continuous IJK coordinates.
+// Returns false if the point is outside the volume.
+bool LocatePoint(const double ijk[3], const int extent[6], const vtkIdType increments[3], ProbeLocation& location)
+{
+  int lowerIndex[3] = { 0, 0, 0 };
+  int upperIndex[3] = { 0, 0, 0 };
+  double fraction[3] = { 0.0, 0.0, 0.0 };
+  for (int axis = 0; axis < 3; ++axis)
+    {
+    const int minIndex = extent[2 * axis];
+    const int maxIndex = extent[2 * axis + 1];
+    double coordinate = ijk[axis];
+    if (coordinate < minIndex - PROBE_TOLERANCE || coordinate > maxIndex + PROBE_TOLERANCE)
+      {
+      return false;
+      }
+    coordinate = std::min(std::max(coordinate, static_cast<double>(minIndex)), static_cast<double>(maxIndex));
+    if (minIndex == maxIndex)
+      {
+      // single slice along this axis
+      lowerIndex[axis] = minIndex;
+      upperIndex[axis] = minIndex;
+      continue;
+      }
+    lowerIndex[axis] = std::min(static_cast<int>(std::floor(coordinate)), maxIndex - 1);
+    upperIndex[axis] = lowerIndex[axis] + 1;
+    fraction[axis] = coordinate - lowerIndex[axis];
+    }
+  for (int corner = 0; corner < 8; ++corner)
+    {
+    const int cornerIndex[3] = {
+      (corner & 1) ? upperIndex[0] : lowerIndex[0],
+      (corner & 2) ? upperIndex[1] : lowerIndex[1],
+      (corner & 4) ? upperIndex[2] : lowerIndex[2] };
+    location.CornerOffsets[corner] = (cornerIndex[0] - extent[0]) * increments[0]
+      + (cornerIndex[1] - extent[2]) * increments[1] + (cornerIndex[2] - extent[4]) * increments[2];
+    location.Weights[corner] = ((corner & 1) ? fraction[0] : 1.0 - fraction[0])
+      * ((corner & 2) ? fraction[1] : 1.0 - fraction[1])
+      * ((corner & 4) ? fraction[2] : 1.0 - fraction[2]);
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+// Interpolate all components of a voxel array at the located points.
+// Points outside the volume get 0 values.
+template <class T>
+void InterpolateArray(const T* voxels, int numberOfComponents, const std::vector<ProbeLocation>& locations,
+  const char* valid, T* values)
+{
+  vtkSMPTools::For(0, static_cast<vtkIdType>(locations.size()), [&](vtkIdType beginPoint, vtkIdType endPoint)
+    {
+    for (vtkIdType pointId = beginPoint; pointId < endPoint; ++pointId)
+      {
+      T* pointValues = values + pointId * numberOfComponents;
+      if (!valid[pointId])
+        {
+        std::fill(pointValues, pointValues + numberOfComponents, static_cast<T>(0));
+        continue;
+        }
+      const ProbeLocation& location = locations[pointId];
+      for (int component = 0; component < numberOfComponents; ++component)
+        {
+        double value = 0.0;
+        for (int corner = 0; corner < 8; ++corner)
+          {
+          value += location.Weights[corner] * voxels[location.CornerOffsets[corner] * numberOfComponents + component];
+          }
+        vtkMath::RoundDoubleToIntegralIfNecessary(value, pointValues + component);
+        }
+      }
+    });
+}
+
+} // end of anonymous namespace
 
 int main(int argc, char* argv[])
 {
@@ -38,13 +133,6 @@ int main(int argc, char* argv[])
     }
   std::cout << "Done reading the file " << InputVolume << endl;
 
-  vtkNew<vtkImageChangeInformation> ici;
-  ici->SetInputConnection(readerVol->GetOutputPort());
-  ici->SetOutputSpacing(1, 1, 1);
-  ici->SetOutputOrigin(0, 0, 0);
-  ici->Update();
-  vtkImageData* volume_Ijk = ici->GetOutput();
-
   vtkNew<vtkMRMLModelStorageNode> modelStorageNode;
   vtkNew<vtkMRMLModelNode> modelNode;
   modelStorageNode->SetFileName(InputModel.c_str());
@@ -54,25 +142,81 @@ int main(int argc, char* argv[])
     return EXIT_FAILURE;
     }
 
-  // Transform the model into the volume's IJK space
-  vtkNew<vtkTransformFilter> modelTransformerRasToIjk;
-  vtkNew<vtkTransform> transformRasToIjk;
-  transformRasToIjk->SetMatrix(readerVol->GetRasToIjkMatrix());
-  modelTransformerRasToIjk->SetTransform(transformRasToIjk);
-  modelTransformerRasToIjk->SetInputConnection(modelNode->GetMeshConnection());
+  vtkPointSet* mesh = modelNode->GetMesh();
+  if (!mesh)
+    {
+    std::cerr << "Invalid mesh in model file " << InputModel << std::endl;
+    return EXIT_FAILURE;
+    }
 
-  vtkNew<vtkProbeFilter> probe;
-  probe->SetSourceData(volume_Ijk);
-  probe->SetInputConnection(modelTransformerRasToIjk->GetOutputPort());
+  // Locate all model points in the volume's IJK space in parallel,
+  // then interpolate each volume array at the located points
+  vtkNew<vtkMatrix4x4> rasToIjk;
+  rasToIjk->DeepCopy(readerVol->GetRasToIjkMatrix());
+  vtkIdType increments[3] = { 0, 0, 0 };
+  volume->GetIncrements(increments);
+  const int numberOfScalarComponents = volume->GetNumberOfScalarComponents();
+  for (int axis = 0; axis < 3; ++axis)
+    {
+    // increments are in scalar components, locations are stored in voxels
+    increments[axis] /= numberOfScalarComponents;
+    }
+  const vtkIdType numberOfPoints = mesh->GetNumberOfPoints();
+  std::vector<ProbeLocation> locations(numberOfPoints);
+  vtkNew<vtkCharArray> validPointMask;
+  validPointMask->SetName("vtkValidPointMask");
+  validPointMask->SetNumberOfTuples(numberOfPoints);
+  char* valid = validPointMask->GetPointer(0);
+  vtkSMPTools::For(0, numberOfPoints, [&](vtkIdType beginPoint, vtkIdType endPoint)
+    {
+    double ras[4] = { 0.0, 0.0, 0.0, 1.0 };
+    double ijk[4] = { 0.0, 0.0, 0.0, 1.0 };
+    for (vtkIdType pointId = beginPoint; pointId < endPoint; ++pointId)
+      {
+      mesh->GetPoint(pointId, ras);
+      rasToIjk->MultiplyPoint(ras, ijk);
+      valid[pointId] = LocatePoint(ijk, extent, increments, locations[pointId]) ? 1 : 0;
+      }
+    });
 
-  // Transform the model back into RAS space
-  vtkNew<vtkTransformFilter> modelTransformerIjkToRas;
-  modelTransformerIjkToRas->SetTransform(transformRasToIjk->GetInverse());
-  modelTransformerIjkToRas->SetInputConnection(probe->GetOutputPort());
-  modelTransformerIjkToRas->Update();
+  // Same output as vtkProbeFilter: the input mesh structure with the probed volume arrays
+  vtkSmartPointer<vtkPointSet> probedMesh = vtkSmartPointer<vtkPointSet>::Take(mesh->NewInstance());
+  probedMesh->CopyStructure(mesh);
+  probedMesh->GetFieldData()->PassData(mesh->GetFieldData());
+  vtkPointData* volumePointData = volume->GetPointData();
+  for (int arrayIndex = 0; arrayIndex < volumePointData->GetNumberOfArrays(); ++arrayIndex)
+    {
+    vtkDataArray* voxelArray = volumePointData->GetArray(arrayIndex);
+    if (!voxelArray || voxelArray->GetNumberOfTuples() != volume->GetNumberOfPoints())
+      {
+      continue;
+      }
+    vtkSmartPointer<vtkDataArray> probedArray = vtkSmartPointer<vtkDataArray>::Take(
+      vtkDataArray::CreateDataArray(voxelArray->GetDataType()));
+    probedArray->SetName(voxelArray->GetName());
+    probedArray->SetNumberOfComponents(voxelArray->GetNumberOfComponents());
+    probedArray->SetNumberOfTuples(numberOfPoints);
+    switch (voxelArray->GetDataType())
+      {
+      vtkTemplateMacro(InterpolateArray<VTK_TT>(static_cast<VTK_TT*>(voxelArray->GetVoidPointer(0)),
+        voxelArray->GetNumberOfComponents(), locations, valid, static_cast<VTK_TT*>(probedArray->GetVoidPointer(0))));
+      default:
+        std::cerr << "Unsupported volume array type: " << voxelArray->GetDataTypeAsString() << std::endl;
+        return EXIT_FAILURE;
+      }
+    if (voxelArray == volumePointData->GetScalars())
+      {
+      probedMesh->GetPointData()->SetScalars(probedArray);
+      }
+    else
+      {
+      probedMesh->GetPointData()->AddArray(probedArray);
+      }
+    }
+  probedMesh->GetPointData()->AddArray(validPointMask);
 
   // Save the output
-  modelNode->SetAndObserveMesh(modelTransformerIjkToRas->GetOutput());
+  modelNode->SetAndObserveMesh(probedMesh);
   modelStorageNode->SetFileName(OutputModel.c_str());
   if (!modelStorageNode->WriteData(modelNode))
     {
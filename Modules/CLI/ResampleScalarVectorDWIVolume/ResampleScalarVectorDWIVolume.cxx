@@ -17,7 +17,9 @@
 #include <itkCompositeTransform.h>
 #include <itkImageFileReader.h>
 #include <itkImageFileWriter.h>
+#include <itkImageRegionSplitterSlowDimension.h>
 #include <itkMetaDataObject.h>
+#include <itkMultiThreaderBase.h>
 #include <itkNearestNeighborInterpolateImageFunction.h>
 #include <itkResampleImageFilter.h>
 #include <itkBSplineInterpolateImageFunction.h>
@@ -38,6 +40,9 @@
 #include "itkWarpTransform3D.h"
 
 // STD includes
+#include <algorithm>
+#include <mutex>
+#include <sstream>
 
 // Use an anonymous namespace to keep class types and function names
 // from colliding when module is used as shared object module.  Every
@@ -52,6 +57,7 @@ namespace
 struct parameters
   {
   int numberOfThread;
+  int numberOfStreamDivisions;
   std::string interpolationType;
   std::string transformType;
   std::vector<double> transformMatrix;
@@ -685,89 +691,57 @@ SetAllTransform( parameters & list,
   return transform;
 }
 
-// Write back the vector of images into a image vector
+// Copy one component of the vector image into a scalar image.
+// The scalar image is allocated with the geometry of the vector image if needed.
 template <class PixelType>
-int AddImage( typename itk::VectorImage<PixelType, 3>
-              ::Pointer & imagePile,
-              const std::vector<typename itk::Image<PixelType, 3>::Pointer> & vectorImage
-              )
+void ExtractComponent( const typename itk::VectorImage<PixelType, 3>
+                       ::Pointer & imagePile,
+                       unsigned int component,
+                       typename itk::Image<PixelType, 3>::Pointer & image
+                       )
 {
   typedef itk::Image<PixelType, 3> ImageType;
-  imagePile->SetRegions( vectorImage.at( 0 )->GetLargestPossibleRegion().GetSize() );
-  imagePile->SetOrigin( vectorImage.at( 0 )->GetOrigin() );
-  imagePile->SetDirection( vectorImage.at( 0 )->GetDirection() );
-  imagePile->SetSpacing( vectorImage.at( 0 )->GetSpacing() );
-  imagePile->SetVectorLength( vectorImage.size() );
-  imagePile->Allocate();
-  typename itk::ImageRegionIterator<itk::VectorImage<PixelType, 3> > out( imagePile,
-                                                                          imagePile->GetLargestPossibleRegion()
-                                                                          );
-  typedef typename itk::ImageRegionIterator<ImageType> IteratorImageType;
-  std::vector<IteratorImageType> in;
-  for( unsigned int i = 0; i < imagePile->GetVectorLength(); i++ )
+  if( !image )
     {
-    IteratorImageType intemp( vectorImage.at( i ), vectorImage.at( i )->GetLargestPossibleRegion() );
-    intemp.GoToBegin();
-    in.push_back( intemp );
+    image = ImageType::New();
+    image->SetRegions( imagePile->GetLargestPossibleRegion() );
+    image->SetOrigin( imagePile->GetOrigin() );
+    image->SetDirection( imagePile->GetDirection() );
+    image->SetSpacing( imagePile->GetSpacing() );
+    image->Allocate();
     }
-  itk::VariableLengthVector<PixelType> value;
-  value.SetSize( vectorImage.size() );
-  for( out.GoToBegin(); !out.IsAtEnd(); ++out )
+  const unsigned int numberOfComponents = imagePile->GetVectorLength();
+  const itk::SizeValueType numberOfPixels = image->GetLargestPossibleRegion().GetNumberOfPixels();
+  const PixelType * in = imagePile->GetBufferPointer() + component;
+  PixelType *       out = image->GetBufferPointer();
+  for( itk::SizeValueType i = 0; i < numberOfPixels; i++ )
     {
-    for( unsigned int i = 0; i < imagePile->GetVectorLength(); i++ )
-      {
-      value.SetElement( i, in.at( i ).Get() );
-      ++in[i];
-      }
-    out.Set( value );
+    out[i] = in[i * numberOfComponents];
     }
-  return EXIT_SUCCESS;
+  // the resampler must run again on the new voxels
+  image->Modified();
 }
 
-// Separate the vector image into a vector of images
+// Copy a resampled region of a scalar image into one component of the vector image.
+// The region must be split along the slowest dimension only, so that its voxels
+// are contiguous in both images.
 template <class PixelType>
-int SeparateImages( const typename itk::VectorImage<PixelType, 3>
-                    ::Pointer & imagePile,
-                    std::vector<typename itk::Image<PixelType, 3>::Pointer> & vectorImage
-                    )
+void PasteComponent( const typename itk::Image<PixelType, 3>
+                     ::Pointer & image,
+                     unsigned int component,
+                     typename itk::VectorImage<PixelType, 3>::Pointer & imagePile
+                     )
 {
-  typedef itk::Image<PixelType, 3>       ImageType;
-  typedef itk::VectorImage<PixelType, 3> VectorImageType;
-  typename itk::VectorImage<PixelType, 3>::SizeType size;
-  typename itk::VectorImage<PixelType, 3>::DirectionType direction;
-  typename itk::VectorImage<PixelType, 3>::PointType origin;
-  typename itk::VectorImage<PixelType, 3>::SpacingType spacing;
-  size = imagePile->GetLargestPossibleRegion().GetSize();
-  direction = imagePile->GetDirection();
-  origin = imagePile->GetOrigin();
-  spacing = imagePile->GetSpacing();
-  typename itk::ImageRegionIterator<VectorImageType> in( imagePile,
-                                                         imagePile->GetLargestPossibleRegion() );
-  typedef typename itk::ImageRegionIterator<ImageType> IteratorImageType;
-  std::vector<IteratorImageType> out;
-  for( unsigned int i = 0; i < imagePile->GetVectorLength(); i++ )
+  const typename itk::Image<PixelType, 3>::RegionType & region = image->GetBufferedRegion();
+  const unsigned int       numberOfComponents = imagePile->GetVectorLength();
+  const itk::SizeValueType numberOfPixels = region.GetNumberOfPixels();
+  const PixelType *        in = image->GetBufferPointer();
+  PixelType *              out = imagePile->GetBufferPointer()
+    + imagePile->ComputeOffset( region.GetIndex() ) * numberOfComponents + component;
+  for( itk::SizeValueType i = 0; i < numberOfPixels; i++ )
     {
-    typename ImageType::Pointer imageTemp = ImageType::New();
-    imageTemp->SetRegions( size );
-    imageTemp->SetOrigin( origin );
-    imageTemp->SetDirection( direction );
-    imageTemp->SetSpacing( spacing );
-    imageTemp->Allocate();
-    vectorImage.push_back( imageTemp );
-    IteratorImageType outtemp( imageTemp, imageTemp->GetLargestPossibleRegion() );
-    outtemp.GoToBegin();
-    out.push_back( outtemp );
+    out[i * numberOfComponents] = in[i];
     }
-  for( in.GoToBegin(); !in.IsAtEnd(); ++in )
-    {
-    itk::VariableLengthVector<PixelType> value = in.Get();
-    for( unsigned int i = 0; i < imagePile->GetVectorLength(); i++ )
-      {
-      out[i].Set( value[i] );
-      ++out[i];
-      }
-    }
-  return EXIT_SUCCESS;
 }
 
 // Verify if some input parameters are null
@@ -1222,9 +1196,8 @@ int Rotate( parameters & list )
   typedef itk::ResampleImageFilter<ImageType, ImageType>   ResampleType;
   typedef itk::Transform<double, 3, 3>                     TransformType;
   typedef itk::VectorImage<PixelType, 3>                   VectorImageType;
-  typename ImageType::Pointer image;
-  std::vector<typename ImageType::Pointer> vectorOfImage;
-  itk::MetaDataDictionary                  dico;
+  typename VectorImageType::Pointer inputImage;
+  itk::MetaDataDictionary           dico;
   try
     {
     // open image file
@@ -1232,31 +1205,35 @@ int Rotate( parameters & list )
     reader = itk::ImageFileReader<VectorImageType>::New();
     reader->SetFileName( list.inputVolume.c_str() );
     reader->Update();
+    inputImage = reader->GetOutput();
+    inputImage->DisconnectPipeline();
     if( list.space )  // && list.transformationFile.compare( "" ) )
       {
-      RASLPS<VectorImageType>( reader->GetOutput() );
+      RASLPS<VectorImageType>( inputImage );
       }
     // Save metadata dictionary
-    dico = reader->GetOutput()->GetMetaDataDictionary();
-    // Separate the vector image into a vector of images
-    SeparateImages<PixelType>( reader->GetOutput(), vectorOfImage );
+    dico = inputImage->GetMetaDataDictionary();
     }
   catch( itk::ExceptionObject &exception )
     {
     std::cerr << exception << std::endl;
     return EXIT_FAILURE;
     }
-  // Set interpolator
-  typename InterpolatorType::Pointer interpol;
-  interpol = SetInterpolator<ImageType>( list );
+  // Image with the geometry of the input, used to initialize the output parameters and the transforms.
+  // Its voxels are not needed.
+  typename ImageType::Pointer inputGeometry = ImageType::New();
+  inputGeometry->SetRegions( inputImage->GetLargestPossibleRegion() );
+  inputGeometry->SetOrigin( inputImage->GetOrigin() );
+  inputGeometry->SetDirection( inputImage->GetDirection() );
+  inputGeometry->SetSpacing( inputImage->GetSpacing() );
   // Create resampler and initialize its output parameters
   typename ResampleType::Pointer resample = ResampleType::New();
-  SetOutputParameters<ImageType>( list, resample, vectorOfImage[0] );
+  SetOutputParameters<ImageType>( list, resample, inputGeometry );
   TransformType::Pointer transform;
   // Load transforms and compute a merged transform
   try
     {
-    transform = SetAllTransform<ImageType>(list, resample, vectorOfImage[0]);
+    transform = SetAllTransform<ImageType>(list, resample, inputGeometry);
     }
   catch (itk::ExceptionObject& exception)
     {
@@ -1267,21 +1244,75 @@ int Rotate( parameters & list )
     {
     return EXIT_FAILURE;
     }
-  resample->SetTransform( transform );
-  resample->SetInterpolator( interpol );
-  std::vector<typename ImageType::Pointer> vectorOutputImage;
-  // Resample all the images separately
-  for( ::size_t idx = 0; idx < vectorOfImage.size(); idx++ )
+  // The resampled components are written directly in the output image
+  const unsigned int numberOfComponents = inputImage->GetVectorLength();
+  typename VectorImageType::Pointer outputImage = VectorImageType::New();
+  outputImage->SetRegions( resample->GetSize() );
+  outputImage->SetOrigin( resample->GetOutputOrigin() );
+  outputImage->SetDirection( resample->GetOutputDirection() );
+  outputImage->SetSpacing( resample->GetOutputSpacing() );
+  outputImage->SetVectorLength( numberOfComponents );
+  outputImage->Allocate();
+  // The output is resampled in pieces split along the slowest dimension,
+  // only one piece of each component is stored at a time.
+  const typename VectorImageType::RegionType outputRegion = outputImage->GetLargestPossibleRegion();
+  itk::ImageRegionSplitterSlowDimension::Pointer splitter = itk::ImageRegionSplitterSlowDimension::New();
+  const unsigned int numberOfPieces = splitter->GetNumberOfSplits(
+    outputRegion, static_cast<unsigned int>( std::max( list.numberOfStreamDivisions, 1 ) ) );
+  // Components are resampled in parallel (e.g. DWI gradients), each one by a single threaded resampler.
+  // When there are fewer components than threads (e.g. scalar volumes), the components are
+  // resampled one after the other by a multithreaded resampler instead.
+  const unsigned int numberOfThreads = list.numberOfThread > 0 ? static_cast<unsigned int>( list.numberOfThread )
+    : itk::MultiThreaderBase::GetGlobalDefaultNumberOfThreads();
+  const unsigned int numberOfComponentThreads = numberOfComponents >= numberOfThreads ? numberOfThreads : 1;
+  const unsigned int numberOfResamplerThreads = numberOfComponentThreads > 1 ? 1 : numberOfThreads;
+  std::mutex  errorMutex;
+  std::string errorMessage;
+  itk::MultiThreaderBase::Pointer threader = itk::MultiThreaderBase::New();
+  threader->SetNumberOfWorkUnits( numberOfComponentThreads );
+  threader->ParallelizeArray( 0, numberOfComponents,
+    [&]( itk::SizeValueType component )
     {
-    resample->SetInput( vectorOfImage[idx] );
-    resample->Update();
-    vectorOutputImage.push_back( resample->GetOutput() );
-    vectorOutputImage[idx]->DisconnectPipeline();
+    try
+      {
+      typename ImageType::Pointer componentImage;
+      ExtractComponent<PixelType>( inputImage, component, componentImage );
+      // Each component gets its own resampler and interpolator, the transform is shared
+      typename ResampleType::Pointer componentResample = ResampleType::New();
+      componentResample->SetInput( componentImage );
+      componentResample->SetTransform( transform );
+      componentResample->SetInterpolator( SetInterpolator<ImageType>( list ) );
+      componentResample->SetSize( resample->GetSize() );
+      componentResample->SetOutputStartIndex( resample->GetOutputStartIndex() );
+      componentResample->SetOutputOrigin( resample->GetOutputOrigin() );
+      componentResample->SetOutputSpacing( resample->GetOutputSpacing() );
+      componentResample->SetOutputDirection( resample->GetOutputDirection() );
+      componentResample->SetDefaultPixelValue( resample->GetDefaultPixelValue() );
+      componentResample->SetNumberOfWorkUnits( numberOfResamplerThreads );
+      typename ImageType::Pointer resampledImage = componentResample->GetOutput();
+      for( unsigned int piece = 0; piece < numberOfPieces; piece++ )
+        {
+        typename ImageType::RegionType pieceRegion = outputRegion;
+        splitter->GetSplit( piece, numberOfPieces, pieceRegion );
+        resampledImage->SetRequestedRegion( pieceRegion );
+        resampledImage->Update();
+        PasteComponent<PixelType>( resampledImage, component, outputImage );
+        }
+      }
+    catch( itk::ExceptionObject &exception )
+      {
+      std::lock_guard<std::mutex> lock( errorMutex );
+      std::stringstream message;
+      message << exception;
+      errorMessage = message.str();
+      }
+    },
+    nullptr );
+  if( !errorMessage.empty() )
+    {
+    std::cerr << errorMessage << std::endl;
+    return EXIT_FAILURE;
     }
-  typename itk::VectorImage<PixelType, 3>::Pointer outputImage;
-  outputImage = itk::VectorImage<PixelType, 3>::New();
-  AddImage<PixelType>( outputImage, vectorOutputImage );
-  vectorOutputImage.clear();
   // If necessary, transform gradient vectors with the loaded transformations
   int dwmriProblem = CheckDWMRI( dico, transform );
   if( list.space ) // && list.transformationFile.compare( "" ) )
@@ -1319,6 +1350,7 @@ int main( int argc, char * argv[] )
   PARSE_ARGS;
   parameters list;
   list.numberOfThread = numberOfThread;
+  list.numberOfStreamDivisions = numberOfStreamDivisions;
   list.interpolationType = interpolationType;
   list.transformType = transformType;
   list.transformMatrix = transformMatrix;
@@ -2,7 +2,7 @@
 #define SFLS_h_
 
 // std
-#include <list>
+#include <vector>
 
 // itk
 #include "vnl/vnl_vector_fixed.h"
@@ -13,7 +13,10 @@ public:
   typedef CSFLS Self;
 
   typedef vnl_vector_fixed<int, 3> NodeType;
-  typedef std::list<NodeType>      CSFLSLayer;
+  /* Points of a layer are packed in a vector: layers are scanned
+     sequentially every iteration and points leaving a layer are
+     removed by compacting it in place. */
+  typedef std::vector<NodeType> CSFLSLayer;
 
   // typedef boost::shared_ptr< Self > Pointer;
 
@@ -15,6 +15,7 @@
 
 #include "itkImageRegionConstIteratorWithIndex.h"
 #include "itkImageRegionConstIterator.h"
+#include "itkMultiThreaderBase.h"
 
 /* ============================================================   */
 template <typename TPixel>
@@ -82,45 +83,37 @@ CSFLSRobustStatSegmentor3DLabelMap<TPixel>
   double fmax = std::numeric_limits<double>::min();
   double kappaMax = std::numeric_limits<double>::min();
 
-  long    n = this->m_lz.size();
-  double* kappaOnZeroLS = new double[n];
-  double* cvForce = new double[n];
+  long                n = this->m_lz.size();
+  std::vector<double> kappaOnZeroLS(n);
+  std::vector<double> cvForce(n);
 
-  std::vector<typename CSFLSLayer::iterator> m_lzIterVct( n );
+  /* The points of the zero layer are distinct, so their features can be
+     computed and stored in the feature images in parallel. */
+  if( n > 0 )
     {
-    long iiizzz = 0;
-    for( typename CSFLSLayer::iterator itz = this->m_lz.begin(); itz != this->m_lz.end(); ++itz )
+    itk::MultiThreaderBase::Pointer threader = itk::MultiThreaderBase::New();
+    threader->ParallelizeArray(0, n, [this, &kappaOnZeroLS, &cvForce](itk::SizeValueType i)
       {
-      m_lzIterVct[iiizzz++] = itz;
-      }
-    }
-
-// #ifndef NDEBUG
-//     std::ofstream ff("/tmp/force.txt");
-// #endif
-  for( long i = 0; i < n; ++i )
-    {
-    typename CSFLSLayer::iterator itz = m_lzIterVct[i];
+      long ix = this->m_lz[i][0];
+      long iy = this->m_lz[i][1];
+      long iz = this->m_lz[i][2];
 
-    long ix = (*itz)[0];
-    long iy = (*itz)[1];
-    long iz = (*itz)[2];
+      TIndex idx = {{ix, iy, iz}};
 
-    TIndex idx = {{ix, iy, iz}};
+      kappaOnZeroLS[i] = this->computeKappa(ix, iy, iz);
 
-    kappaOnZeroLS[i] = this->computeKappa(ix, iy, iz);
+      std::vector<double> f(m_numberOfFeature);
 
-    std::vector<double> f(m_numberOfFeature);
+      computeFeatureAt(idx, f);
 
-    computeFeatureAt(idx, f);
-
-    // double a = -kernelEvaluation(f);
-    double a = -kernelEvaluationUsingPDF(f);
-
-    fmax = fmax > fabs(a) ? fmax : fabs(a);
+      // double a = -kernelEvaluation(f);
+      cvForce[i] = -kernelEvaluationUsingPDF(f);
+      }, nullptr);
+    }
+  for( long i = 0; i < n; ++i )
+    {
+    fmax = fmax > fabs(cvForce[i]) ? fmax : fabs(cvForce[i]);
     kappaMax = kappaMax > fabs(kappaOnZeroLS[i]) ? kappaMax : fabs(kappaOnZeroLS[i]);
-
-    cvForce[i] = a;
     }
 
   // std::cout<<"fmax = "<<fmax<<std::endl;
@@ -132,9 +125,6 @@ CSFLSRobustStatSegmentor3DLabelMap<TPixel>
     this->m_force[i] = (1 - (this->m_curvatureWeight) ) * cvForce[i] / (fmax + 1e-10) \
       +  (this->m_curvatureWeight) * kappaOnZeroLS[i] / (kappaMax + 1e-10);
     }
-
-  delete[] kappaOnZeroLS;
-  delete[] cvForce;
 }
 
 /* ============================================================  */
@@ -269,6 +259,7 @@ CSFLSRobustStatSegmentor3DLabelMap<TPixel>
     {
     // compute the feature
     std::vector<double> neighborIntensities;
+    neighborIntensities.reserve( (2 * m_statNeighborX + 1) * (2 * m_statNeighborY + 1) * (2 * m_statNeighborZ + 1) );
 
     long ix = idx[0];
     long iy = idx[1];
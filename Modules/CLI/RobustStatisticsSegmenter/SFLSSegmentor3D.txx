@@ -11,6 +11,7 @@
 #include <fstream>
 
 #include "itkImageRegionIteratorWithIndex.h"
+#include "itkMultiThreaderBase.h"
 
 template <typename TPixel>
 CSFLSSegmentor3D<TPixel>
@@ -421,78 +422,80 @@ CSFLSSegmentor3D<TPixel>
     scan Lz values [-2.5 -1.5)[-1.5 -.5)[-.5 .5](.5 1.5](1.5 2.5]
     ========                */
     {
-    // std::list<double>::const_iterator itf = m_force.begin();
-
-    long                              nz = m_lz.size();
-    std::vector<CSFLSLayer::iterator> m_lzIterVct( nz );
+    /* The new phi of a zero layer point only depends on the point itself,
+       so it is computed in parallel. The points that change status are then
+       moved to their lists in the order of the zero layer. */
+    enum { In2out = 1, Out2in = 2, ToLp1 = 4, ToLn1 = 8 };
+    long              nz = m_lz.size();
+    std::vector<char> lzStatus(nz, 0);
+    if( nz > 0 )
       {
-      long iiizzz = 0;
-      for( CSFLSLayer::iterator itz = m_lz.begin(); itz != m_lz.end(); ++itz )
+      itk::MultiThreaderBase::Pointer threader = itk::MultiThreaderBase::New();
+      threader->ParallelizeArray(0, nz, [this, &lzStatus](itk::SizeValueType itf)
         {
-        m_lzIterVct[iiizzz++] = itz;
-        }
-      }
-    //    for (CSFLSLayer::iterator itz = m_lz.begin(); itz != m_lz.end(); ++itf)
-    // #pragma omp parallel for
-    for( long iiizzz = 0; iiizzz < nz; ++iiizzz )
-      {
-      long itf = iiizzz;
+        TIndex idx = {{m_lz[itf][0], m_lz[itf][1], m_lz[itf][2]}};
 
-      CSFLSLayer::iterator itz = m_lzIterVct[iiizzz];
+        double phi_old = mp_phi->GetPixel(idx);
+        double phi_new = phi_old + m_force[itf];
 
-      long ix = (*itz)[0];
-      long iy = (*itz)[1];
-      long iz = (*itz)[2];
+        /*----------------------------------------------------------------------
+          Update the lists of pt who change the state, for faster
+          energy fnal computation. */
+        char status = 0;
+        if( phi_old <= 0 && phi_new > 0 )
+          {
+          status |= In2out;
+          }
+        if( phi_old > 0  && phi_new <= 0 )
+          {
+          status |= Out2in;
+          }
 
-      TIndex idx = {{ix, iy, iz}};
+        mp_phi->SetPixel(idx, phi_new);
 
-      double phi_old = mp_phi->GetPixel(idx);
-      double phi_new = phi_old + m_force[itf];
+        if( phi_new > 0.5 )
+          {
+          status |= ToLp1;
+          }
+        else if( phi_new < -0.5 )
+          {
+          status |= ToLn1;
+          }
+        lzStatus[itf] = status;
+        }, nullptr);
+      }
 
-      /*----------------------------------------------------------------------
-        Update the lists of pt who change the state, for faster
-        energy fnal computation. */
-      if( phi_old <= 0 && phi_new > 0 )
+    CSFLSLayer::iterator itzKept = m_lz.begin();
+    for( long itf = 0; itf < nz; ++itf )
+      {
+      const NodeType& node = m_lz[itf];
+      if( lzStatus[itf] & In2out )
         {
-        m_lIn2out.push_back(NodeType(ix, iy, iz) );
+        m_lIn2out.push_back(node);
         }
-
-      if( phi_old > 0  && phi_new <= 0 )
+      if( lzStatus[itf] & Out2in )
         {
-        m_lOut2in.push_back(NodeType(ix, iy, iz) );
+        m_lOut2in.push_back(node);
         }
 
-      //           // DEBUG
-      //           if (phi_new > 3.1 || phi_new < -3.1)
-      //             {
-      //               std::cout<<"phi_old = "<<phi_old<<std::endl;
-      //               std::cout<<"its lbl = "<<(int)mp_label->get(ix, iy)<<std::endl;
-
-      //               std::cerr<<"phi_new > 3.1 || phi_new < -3.1\n";
-      //               raise(SIGABRT);
-      //             }
-
-      mp_phi->SetPixel(idx, phi_new);
-
-      if( phi_new > 0.5 )
+      if( lzStatus[itf] & ToLp1 )
         {
-        Sp1.push_back(*itz);
-        itz = m_lz.erase(itz);
+        Sp1.push_back(node);
         }
-      else if( phi_new < -0.5 )
+      else if( lzStatus[itf] & ToLn1 )
         {
-        Sn1.push_back(*itz);
-        itz = m_lz.erase(itz);
+        Sn1.push_back(node);
         }
       else
         {
-        ++itz;
+        *itzKept++ = node;
         }
       /*--------------------------------------------------
         NOTE, mp_label are (should) NOT update here. They should
         be updated with Sz, Sn/p's
         --------------------------------------------------*/
       }
+    m_lz.erase(itzKept, m_lz.end());
     }
 
   //     // debug
@@ -502,7 +505,8 @@ CSFLSSegmentor3D<TPixel>
 
     2.1 scan Ln1 values [-2.5 -1.5)[-1.5 -.5)[-.5 .5](.5 1.5](1.5 2.5]
     ==========                     */
-  for( CSFLSLayer::iterator itn1 = m_ln1.begin(); itn1 != m_ln1.end(); )
+  CSFLSLayer::iterator itn1Kept = m_ln1.begin();
+  for( CSFLSLayer::iterator itn1 = m_ln1.begin(); itn1 != m_ln1.end(); ++itn1 )
     {
     long ix = (*itn1)[0];
     long iy = (*itn1)[1];
@@ -521,16 +525,14 @@ CSFLSSegmentor3D<TPixel>
       if( phi_new >= -0.5 )
         {
         Sz.push_back(*itn1);
-        itn1 = m_ln1.erase(itn1);
         }
       else if( phi_new < -1.5 )
         {
         Sn2.push_back(*itn1);
-        itn1 = m_ln1.erase(itn1);
         }
       else
         {
-        ++itn1;
+        *itn1Kept++ = *itn1;
         }
       }
     else
@@ -540,18 +542,19 @@ CSFLSSegmentor3D<TPixel>
         should go to Sn2. And the phi shold be further -1
       */
       Sn2.push_back(*itn1);
-      itn1 = m_ln1.erase(itn1);
 
       mp_phi->SetPixel(idx, mp_phi->GetPixel(idx) - 1);
       }
     }
+  m_ln1.erase(itn1Kept, m_ln1.end());
 
   //     // debug
   //     labelsCoherentCheck1();
   /*--------------------------------------------------
     2.2 scan Lp1 values [-2.5 -1.5)[-1.5 -.5)[-.5 .5](.5 1.5](1.5 2.5]
     ========          */
-  for( CSFLSLayer::iterator itp1 = m_lp1.begin(); itp1 != m_lp1.end(); )
+  CSFLSLayer::iterator itp1Kept = m_lp1.begin();
+  for( CSFLSLayer::iterator itp1 = m_lp1.begin(); itp1 != m_lp1.end(); ++itp1 )
     {
     long ix = (*itp1)[0];
     long iy = (*itp1)[1];
@@ -570,16 +573,14 @@ CSFLSSegmentor3D<TPixel>
       if( phi_new <= 0.5 )
         {
         Sz.push_back(*itp1);
-        itp1 = m_lp1.erase(itp1);
         }
       else if( phi_new > 1.5 )
         {
         Sp2.push_back(*itp1);
-        itp1 = m_lp1.erase(itp1);
         }
       else
         {
-        ++itp1;
+        *itp1Kept++ = *itp1;
         }
       }
     else
@@ -590,18 +591,19 @@ CSFLSSegmentor3D<TPixel>
       */
 
       Sp2.push_back(*itp1);
-      itp1 = m_lp1.erase(itp1);
 
       mp_phi->SetPixel(idx, mp_phi->GetPixel(idx) + 1);
       }
     }
+  m_lp1.erase(itp1Kept, m_lp1.end());
 
   //     // debug
   //     labelsCoherentCheck1();
   /*--------------------------------------------------
     2.3 scan Ln2 values [-2.5 -1.5)[-1.5 -.5)[-.5 .5](.5 1.5](1.5 2.5]
     ==========                                      */
-  for( CSFLSLayer::iterator itn2 = m_ln2.begin(); itn2 != m_ln2.end(); )
+  CSFLSLayer::iterator itn2Kept = m_ln2.begin();
+  for( CSFLSLayer::iterator itn2 = m_ln2.begin(); itn2 != m_ln2.end(); ++itn2 )
     {
     long ix = (*itn2)[0];
     long iy = (*itn2)[1];
@@ -620,33 +622,32 @@ CSFLSSegmentor3D<TPixel>
       if( phi_new >= -1.5 )
         {
         Sn1.push_back(*itn2);
-        itn2 = m_ln2.erase(itn2);
         }
       else if( phi_new < -2.5 )
         {
-        itn2 = m_ln2.erase(itn2);
         mp_phi->SetPixel(idx, -3);
         mp_label->SetPixel(idx, -3);
         }
       else
         {
-        ++itn2;
+        *itn2Kept++ = *itn2;
         }
       }
     else
       {
-      itn2 = m_ln2.erase(itn2);
       mp_phi->SetPixel(idx, -3);
       mp_label->SetPixel(idx, -3);
       }
     }
+  m_ln2.erase(itn2Kept, m_ln2.end());
 
   //     // debug
   //     labelsCoherentCheck1();
   /*--------------------------------------------------
     2.4 scan Lp2 values [-2.5 -1.5)[-1.5 -.5)[-.5 .5](.5 1.5](1.5 2.5]
     ========= */
-  for( CSFLSLayer::iterator itp2 = m_lp2.begin(); itp2 != m_lp2.end(); )
+  CSFLSLayer::iterator itp2Kept = m_lp2.begin();
+  for( CSFLSLayer::iterator itp2 = m_lp2.begin(); itp2 != m_lp2.end(); ++itp2 )
     {
     long   ix = (*itp2)[0];
     long   iy = (*itp2)[1];
@@ -664,26 +665,24 @@ CSFLSSegmentor3D<TPixel>
       if( phi_new <= 1.5 )
         {
         Sp1.push_back(*itp2);
-        itp2 = m_lp2.erase(itp2);
         }
       else if( phi_new > 2.5 )
         {
-        itp2 = m_lp2.erase(itp2);
         mp_phi->SetPixel(idx, 3);
         mp_label->SetPixel(idx, 3);
         }
       else
         {
-        ++itp2;
+        *itp2Kept++ = *itp2;
         }
       }
     else
       {
-      itp2 = m_lp2.erase(itp2);
       mp_phi->SetPixel(idx, 3);
       mp_label->SetPixel(idx, 3);
       }
     }
+  m_lp2.erase(itp2Kept, m_lp2.end());
 
   //     // debug
   //     labelsCoherentCheck1();
@@ -18,7 +18,7 @@
 
 #include "itkImageFileReader.h"
 #include "itkImageFileWriter.h"
-#include "itkVotingBinaryHoleFillingImageFilter.h"
+#include "itkSlidingWindowVotingBinaryHoleFillingImageFilter.h"
 #include "itkPluginFilterWatcher.h"
 
 #include "VotingBinaryHoleFillingImageFilterCLP.h"
@@ -52,7 +52,9 @@ int main( int argc, char * argv[] )
   reader->SetFileName( inputVolume.c_str() );
   writer->SetFileName( outputVolume.c_str() );
 
-  typedef itk::VotingBinaryHoleFillingImageFilter<
+  // Same output as itk::VotingBinaryHoleFillingImageFilter, but the foreground
+  // voxels are counted in a neighborhood that slides along the rows
+  typedef itk::SlidingWindowVotingBinaryHoleFillingImageFilter<
     InputImageType, OutputImageType>  FilterType;
 
   FilterType::Pointer      filter = FilterType::New();
@@ -0,0 +1,223 @@
+/*=========================================================================
+
+  Copyright Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+=========================================================================*/
+#include "itkImageFileWriter.h"
+
+#include "itkBSplineInterpolateImageFunction.h"
+#include "itkNearestNeighborInterpolateImageFunction.h"
+#include "itkVoxelExpressionImageFilter.h"
+
+#include "itkPluginUtilities.h"
+#include "VoxelExpressionCLP.h"
+
+// Use an anonymous namespace to keep class types and function names
+// from colliding when module is used as shared object module.  Every
+// thing should be in an anonymous namespace except for the module
+// entry point, e.g. main()
+//
+namespace
+{
+
+template <class Tin, class Tout>
+int DoIt( int argc, char * argv[] )
+{
+
+  PARSE_ARGS;
+
+  typedef    Tin InputPixelType;
+  typedef    Tout OutputPixelType;
+
+  typedef itk::Image<InputPixelType,  3> InputImageType;
+  typedef itk::Image<OutputPixelType, 3> OutputImageType;
+
+  typedef itk::ImageFileReader<InputImageType>  ReaderType;
+  typedef itk::ImageFileWriter<OutputImageType> WriterType;
+
+  typedef itk::BSplineInterpolateImageFunction<InputImageType>         Interpolator;
+  typedef itk::NearestNeighborInterpolateImageFunction<InputImageType> MaskInterpolator;
+  typedef itk::VoxelExpressionImageFilter<InputImageType, OutputImageType> FilterType;
+
+  typename FilterType::Pointer filter = FilterType::New();
+  std::string errorMessage;
+  if( !filter->AppendOperations( operations, errorMessage ) )
+    {
+    std::cerr << errorMessage << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  typename ReaderType::Pointer reader = ReaderType::New();
+  itk::PluginFilterWatcher watchReader(reader, "Read Volume",
+                                       CLPProcessInformation);
+  reader->SetFileName( inputVolume.c_str() );
+  filter->SetInput( 0, reader->GetOutput() );
+
+  const std::string operandVolumes[3] = { operandVolume1, operandVolume2, operandVolume3 };
+  std::vector<typename ReaderType::Pointer> operandReaders;
+  for( unsigned int operandIndex = 1; operandIndex <= 3; ++operandIndex )
+    {
+    const std::string & operandVolume = operandVolumes[operandIndex - 1];
+    if( operandVolume.empty() )
+      {
+      continue;
+      }
+    typename ReaderType::Pointer operandReader = ReaderType::New();
+    operandReader->SetFileName( operandVolume.c_str() );
+    operandReaders.push_back( operandReader );
+    filter->SetInput( operandIndex, operandReader->GetOutput() );
+
+    // Volumes used as masks are interpolated with nearest neighbor
+    bool usedAsMask = false;
+    for( unsigned int operationIndex = 0; operationIndex < filter->GetNumberOfOperations(); ++operationIndex )
+      {
+      const typename FilterType::Operation & operation = filter->GetOperation( operationIndex );
+      if( operation.Type == FilterType::MASK && operation.InputIndex == operandIndex )
+        {
+        usedAsMask = true;
+        }
+      }
+    if( usedAsMask )
+      {
+      filter->SetInterpolator( operandIndex, MaskInterpolator::New() );
+      }
+    else
+      {
+      typename Interpolator::Pointer interp = Interpolator::New();
+      interp->SetSplineOrder( order );
+      filter->SetInterpolator( operandIndex, interp );
+      }
+    }
+
+  itk::PluginFilterWatcher watchFilter(filter, "Computing voxel expression",
+                                       CLPProcessInformation);
+
+  typename WriterType::Pointer writer = WriterType::New();
+  itk::PluginFilterWatcher watchWriter(writer,
+                                       "Write Volume",
+                                       CLPProcessInformation);
+  writer->SetFileName( outputVolume.c_str() );
+  writer->SetInput( filter->GetOutput() );
+  writer->SetUseCompression(1);
+  writer->Update();
+
+  return EXIT_SUCCESS;
+}
+
+template <class Tin>
+int DoItForOutputType( int argc, char * argv[] )
+{
+
+  PARSE_ARGS;
+
+  if( outputType == std::string("Input") )
+    {
+    return DoIt<Tin, Tin>( argc, argv );
+    }
+  else if( outputType == std::string("Char") )
+    {
+    return DoIt<Tin, char>( argc, argv );
+    }
+  else if( outputType == std::string("UnsignedChar") )
+    {
+    return DoIt<Tin, unsigned char>( argc, argv );
+    }
+  else if( outputType == std::string("Short") )
+    {
+    return DoIt<Tin, short>( argc, argv );
+    }
+  else if( outputType == std::string("UnsignedShort") )
+    {
+    return DoIt<Tin, unsigned short>( argc, argv );
+    }
+  else if( outputType == std::string("Int") )
+    {
+    return DoIt<Tin, int>( argc, argv );
+    }
+  else if( outputType == std::string("UnsignedInt") )
+    {
+    return DoIt<Tin, unsigned int>( argc, argv );
+    }
+  else if( outputType == std::string("Long") )
+    {
+    return DoIt<Tin, long>( argc, argv );
+    }
+  else if( outputType == std::string("UnsignedLong") )
+    {
+    return DoIt<Tin, unsigned long>( argc, argv );
+    }
+  else if( outputType == std::string("Float") )
+    {
+    return DoIt<Tin, float>( argc, argv );
+    }
+  else if( outputType == std::string("Double") )
+    {
+    return DoIt<Tin, double>( argc, argv );
+    }
+  std::cerr << "Unknown output type: " << outputType << std::endl;
+  return EXIT_FAILURE;
+}
+
+} // end of anonymous namespace
+
+int main( int argc, char * argv[] )
+{
+
+  PARSE_ARGS;
+
+  itk::ImageIOBase::IOPixelType     pixelType;
+  itk::ImageIOBase::IOComponentType componentType;
+
+  try
+    {
+    itk::GetImageType(inputVolume, pixelType, componentType);
+
+    switch( componentType )
+      {
+      case itk::ImageIOBase::UCHAR:
+        return DoItForOutputType<unsigned char>( argc, argv );
+        break;
+      case itk::ImageIOBase::CHAR:
+        return DoItForOutputType<char>( argc, argv );
+        break;
+      case itk::ImageIOBase::USHORT:
+        return DoItForOutputType<unsigned short>( argc, argv );
+        break;
+      case itk::ImageIOBase::SHORT:
+        return DoItForOutputType<short>( argc, argv );
+        break;
+      case itk::ImageIOBase::UINT:
+        return DoItForOutputType<unsigned int>( argc, argv );
+        break;
+      case itk::ImageIOBase::INT:
+        return DoItForOutputType<int>( argc, argv );
+        break;
+      case itk::ImageIOBase::ULONG:
+        return DoItForOutputType<unsigned long>( argc, argv );
+        break;
+      case itk::ImageIOBase::LONG:
+        return DoItForOutputType<long>( argc, argv );
+        break;
+      case itk::ImageIOBase::FLOAT:
+        return DoItForOutputType<float>( argc, argv );
+        break;
+      case itk::ImageIOBase::DOUBLE:
+        return DoItForOutputType<double>( argc, argv );
+        break;
+      case itk::ImageIOBase::UNKNOWNCOMPONENTTYPE:
+      default:
+        std::cout << "unknown component type" << std::endl;
+        break;
+      }
+    }
+  catch( itk::ExceptionObject & excep )
+    {
+    std::cerr << argv[0] << ": exception caught !" << std::endl;
+    std::cerr << excep << std::endl;
+    return EXIT_FAILURE;
+    }
+  return EXIT_SUCCESS;
+}
@@ -40,8 +40,12 @@
 // VTK includes
 #include <vtkBoundingBox.h>
 #include <vtkGeneralTransform.h>
+#include <vtkImageBSplineCoefficients.h>
+#include <vtkImageBSplineInterpolator.h>
 #include <vtkImageConstantPad.h>
 #include <vtkImageData.h>
+#include <vtkImageReslice.h>
+#include <vtkImageSincInterpolator.h>
 #include <vtkNew.h>
 #include <vtkMatrix4x4.h>
 #include <vtkMatrix3x3.h>
@@ -418,6 +422,78 @@ bool vtkSlicerCropVolumeLogic::GetInterpolatedCropOutputGeometry(vtkMRMLAnnotati
   return true;
 }
 
+//----------------------------------------------------------------------------
+bool vtkSlicerCropVolumeLogic::GetInterpolatedCropOutputGeometry(vtkMRMLAnnotationROINode* roi, vtkMRMLVolumeNode* inputVolume,
+  vtkMRMLVolumeNode* outputVolume, bool isotropicResampling, double spacingScale, int outputExtent[6], vtkMatrix4x4* outputIJKToRAS)
+{
+  if (!roi || !inputVolume || !outputIJKToRAS)
+    {
+    return false;
+    }
+  vtkMRMLTransformNode* roiTransform = roi->GetParentTransformNode();
+  vtkMRMLTransformNode* outputTransform = outputVolume ? outputVolume->GetParentTransformNode() : nullptr;
+  if ((roiTransform && !roiTransform->IsTransformToWorldLinear())
+    || (outputTransform && !outputTransform->IsTransformToWorldLinear()))
+    {
+    return false;
+    }
+
+  double outputSpacing[3] = { 0 };
+  if (!vtkSlicerCropVolumeLogic::GetInterpolatedCropOutputGeometry(roi, inputVolume, isotropicResampling, spacingScale,
+    outputExtent, outputSpacing))
+    {
+    return false;
+    }
+
+  double roiXYZ[3] = { 0 };
+  roi->GetXYZ(roiXYZ);
+  double roiRadius[3] = { 0 };
+  roi->GetRadiusXYZ(roiRadius);
+
+  vtkNew<vtkMatrix4x4> roiIJKToRAS;
+  roiIJKToRAS->SetElement(0, 0, outputSpacing[0]);
+  roiIJKToRAS->SetElement(1, 1, outputSpacing[1]);
+  roiIJKToRAS->SetElement(2, 2, outputSpacing[2]);
+  roiIJKToRAS->SetElement(0, 3, roiXYZ[0] - roiRadius[0]);
+  roiIJKToRAS->SetElement(1, 3, roiXYZ[1] - roiRadius[1]);
+  roiIJKToRAS->SetElement(2, 3, roiXYZ[2] - roiRadius[2]);
+
+  // account for the ROI parent transform, if present
+  vtkNew<vtkMatrix4x4> roiMatrix;
+  vtkMRMLTransformNode::GetMatrixTransformBetweenNodes(roiTransform, outputTransform, roiMatrix.GetPointer());
+  vtkMatrix4x4::Multiply4x4(roiMatrix.GetPointer(), roiIJKToRAS.GetPointer(), outputIJKToRAS);
+
+  // Center the output image in the ROI. For that, compute the size difference between
+  // the ROI and the output image.
+  for (int axisIndex = 0; axisIndex < 3; axisIndex++)
+    {
+    double axisDirection[3] =
+      {
+      outputIJKToRAS->GetElement(0, axisIndex),
+      outputIJKToRAS->GetElement(1, axisIndex),
+      outputIJKToRAS->GetElement(2, axisIndex)
+      };
+    outputSpacing[axisIndex] = vtkMath::Norm(axisDirection);
+    }
+  // Origin is in the voxel's center. Shift the origin by half voxel
+  // to have the ROI edge at the output image voxel edge.
+  double outputOrigin_IJK[4] = { 0.0, 0.0, 0.0, 1.0 };
+  for (int axisIndex = 0; axisIndex < 3; axisIndex++)
+    {
+    double sizeDifference_IJK = roiRadius[axisIndex] * 2 / outputSpacing[axisIndex]
+      - (outputExtent[axisIndex * 2 + 1] - outputExtent[axisIndex * 2] + 1);
+    outputOrigin_IJK[axisIndex] = 0.5 + sizeDifference_IJK / 2;
+    }
+  double outputOrigin_RAS[4] = { 0.0, 0.0, 0.0, 1.0 };
+  outputIJKToRAS->MultiplyPoint(outputOrigin_IJK, outputOrigin_RAS);
+  for (int row = 0; row < 3; row++)
+    {
+    outputIJKToRAS->SetElement(row, 3, outputOrigin_RAS[row]);
+    }
+
+  return true;
+}
+
 //----------------------------------------------------------------------------
 int vtkSlicerCropVolumeLogic::CropInterpolated(vtkMRMLAnnotationROINode* roi, vtkMRMLVolumeNode* inputVolume, vtkMRMLVolumeNode* outputVolume,
   bool isotropicResampling, double spacingScale, int interpolationMode, double fillValue)
@@ -427,6 +503,134 @@ int vtkSlicerCropVolumeLogic::CropInterpolated(vtkMRMLAnnotationROINode* roi, vt
     return -1;
     }
 
+  if (vtkMRMLDiffusionWeightedVolumeNode::SafeDownCast(inputVolume))
+    {
+    return this->CropInterpolatedUsingResampleModule(roi, inputVolume, outputVolume,
+      isotropicResampling, spacingScale, interpolationMode, fillValue);
+    }
+
+  vtkMRMLTransformNode *roiTransform = roi->GetParentTransformNode();
+  if (roiTransform && !roiTransform->IsTransformToWorldLinear())
+    {
+    vtkErrorMacro("vtkSlicerCropVolumeLogic::CropInterpolated: ROI is under a non-linear transform");
+    return -5;
+    }
+  vtkMRMLTransformNode *outputTransform = outputVolume->GetParentTransformNode();
+  if (outputTransform && !outputTransform->IsTransformToWorldLinear())
+    {
+    vtkErrorMacro("vtkSlicerCropVolumeLogic::CropInterpolated: output volume is under a non-linear transform");
+    return -6;
+    }
+
+  int outputExtent[6] = { 0, -1, 0, -1, 0, -1 };
+  vtkNew<vtkMatrix4x4> outputIJKToRAS;
+  if (!vtkSlicerCropVolumeLogic::GetInterpolatedCropOutputGeometry(roi, inputVolume, outputVolume,
+    isotropicResampling, spacingScale, outputExtent, outputIJKToRAS.GetPointer()))
+    {
+    vtkErrorMacro("vtkSlicerCropVolumeLogic::CropInterpolated: failed to get output geometry");
+    return -1;
+    }
+
+  return this->ResampleInterpolated(inputVolume, outputVolume, outputExtent, outputIJKToRAS.GetPointer(),
+    interpolationMode, fillValue);
+}
+
+//----------------------------------------------------------------------------
+int vtkSlicerCropVolumeLogic::ResampleInterpolated(vtkMRMLVolumeNode* inputVolume, vtkMRMLVolumeNode* outputVolume,
+  const int outputExtent[6], vtkMatrix4x4* outputIJKToRAS, int interpolationMode, double fillValue)
+{
+  if (!inputVolume || !outputVolume || !outputIJKToRAS)
+    {
+    return -1;
+    }
+  vtkMRMLTransformNode *outputTransform = outputVolume->GetParentTransformNode();
+  if (outputTransform && !outputTransform->IsTransformToWorldLinear())
+    {
+    vtkErrorMacro("vtkSlicerCropVolumeLogic::ResampleInterpolated: output volume is under a non-linear transform");
+    return -6;
+    }
+  vtkImageData* inputImage = inputVolume->GetImageData();
+  if (!inputImage)
+    {
+    vtkWarningMacro("vtkSlicerCropVolumeLogic::ResampleInterpolated: input image is empty");
+    outputVolume->SetAndObserveImageData(nullptr);
+    return 0;
+    }
+
+  // Transform from output IJK to input IJK coordinate system
+  vtkNew<vtkGeneralTransform> outputIJKToInputIJK;
+  outputIJKToInputIJK->PostMultiply();
+  outputIJKToInputIJK->Concatenate(outputIJKToRAS);
+  vtkNew<vtkGeneralTransform> outputToInputTransform;
+  vtkMRMLTransformNode::GetTransformBetweenNodes(outputTransform, inputVolume->GetParentTransformNode(),
+    outputToInputTransform.GetPointer());
+  outputIJKToInputIJK->Concatenate(outputToInputTransform.GetPointer());
+  vtkNew<vtkMatrix4x4> inputRASToIJK;
+  inputVolume->GetRASToIJKMatrix(inputRASToIJK.GetPointer());
+  outputIJKToInputIJK->Concatenate(inputRASToIJK.GetPointer());
+
+  // Reslicing is faster with a linear transform, use it if there is no warping transform
+  vtkNew<vtkTransform> outputIJKToInputIJKLinear;
+  vtkAbstractTransform* resliceTransform = outputIJKToInputIJK.GetPointer();
+  if (vtkMRMLTransformNode::IsGeneralTransformLinear(outputIJKToInputIJK.GetPointer(), outputIJKToInputIJKLinear.GetPointer()))
+    {
+    resliceTransform = outputIJKToInputIJKLinear.GetPointer();
+    }
+
+  // vtkImageReslice works directly on the voxels of the input image, in multiple threads
+  vtkNew<vtkImageReslice> reslice;
+  reslice->SetInputData(inputImage);
+  reslice->SetResliceTransform(resliceTransform);
+  reslice->SetOutputExtent(const_cast<int*>(outputExtent));
+  reslice->SetOutputOrigin(0.0, 0.0, 0.0);
+  reslice->SetOutputSpacing(1.0, 1.0, 1.0);
+  reslice->SetBackgroundLevel(fillValue);
+  reslice->SetOutputScalarType(inputImage->GetScalarType());
+  vtkNew<vtkImageSincInterpolator> sincInterpolator;
+  vtkNew<vtkImageBSplineInterpolator> bSplineInterpolator;
+  vtkNew<vtkImageBSplineCoefficients> bSplineCoefficients;
+  switch (interpolationMode)
+    {
+    case vtkMRMLCropVolumeParametersNode::InterpolationNearestNeighbor:
+      reslice->SetInterpolationModeToNearestNeighbor();
+      break;
+    case vtkMRMLCropVolumeParametersNode::InterpolationWindowedSinc:
+      sincInterpolator->SetWindowFunctionToHamming();
+      reslice->SetInterpolator(sincInterpolator.GetPointer());
+      break;
+    case vtkMRMLCropVolumeParametersNode::InterpolationBSpline:
+      // B-spline interpolator uses the spline coefficients of the image instead of the voxel values
+      bSplineCoefficients->SetInputData(inputImage);
+      bSplineCoefficients->SetSplineDegree(3);
+      bSplineInterpolator->SetSplineDegree(3);
+      reslice->SetInputConnection(bSplineCoefficients->GetOutputPort());
+      reslice->SetInterpolator(bSplineInterpolator.GetPointer());
+      break;
+    case vtkMRMLCropVolumeParametersNode::InterpolationLinear:
+    default:
+      reslice->SetInterpolationModeToLinear();
+      break;
+    }
+  reslice->Update();
+
+  int wasModified = outputVolume->StartModify();
+  outputVolume->SetAndObserveImageData(reslice->GetOutput());
+  outputVolume->SetIJKToRASMatrix(outputIJKToRAS);
+  outputVolume->ShiftImageDataExtentToZeroStart();
+  outputVolume->EndModify(wasModified);
+
+  return 0;
+}
+
+//----------------------------------------------------------------------------
+int vtkSlicerCropVolumeLogic::CropInterpolatedUsingResampleModule(vtkMRMLAnnotationROINode* roi, vtkMRMLVolumeNode* inputVolume,
+  vtkMRMLVolumeNode* outputVolume, bool isotropicResampling, double spacingScale, int interpolationMode, double fillValue)
+{
+  if (!roi || !inputVolume || !outputVolume)
+    {
+    return -1;
+    }
+
   if (this->Internal->ResampleLogic == nullptr)
     {
     vtkErrorMacro("CropVolume: resample logic is not set");
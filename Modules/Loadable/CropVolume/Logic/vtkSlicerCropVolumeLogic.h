@@ -91,13 +91,30 @@ public:
     int outputExtent[6], bool limitToInputExtent=false);
 
   /// Perform interpolated cropping.
+  /// Volumes are resampled in-process (using multiple threads), except diffusion weighted
+  /// volumes, which are resampled by the resample CLI module (see SetResampleLogic).
   int CropInterpolated(vtkMRMLAnnotationROINode* roi, vtkMRMLVolumeNode* inputVolume, vtkMRMLVolumeNode* outputNode,
     bool isotropicResampling, double spacingScale, int interpolationMode, double fillValue);
 
+  /// Resample input volume into the output geometry computed by GetInterpolatedCropOutputGeometry.
+  /// The same geometry can be used for cropping multiple volumes, such as all frames of a volume sequence.
+  /// Input volume may be under a non-linear transform, output volume must not be.
+  /// Diffusion weighted volumes are resampled as vector volumes.
+  int ResampleInterpolated(vtkMRMLVolumeNode* inputVolume, vtkMRMLVolumeNode* outputNode,
+    const int outputExtent[6], vtkMatrix4x4* outputIJKToRAS, int interpolationMode, double fillValue);
+
   /// Computes output volume geometry for interpolated cropping (without actually cropping the image).
   static bool GetInterpolatedCropOutputGeometry(vtkMRMLAnnotationROINode* roi, vtkMRMLVolumeNode* inputVolume,
     bool isotropicResampling, double spacingScale, int outputExtent[6], double outputSpacing[3]);
 
+  /// Computes output volume extent and IJK to RAS matrix for interpolated cropping (without actually cropping the image).
+  /// The IJK to RAS matrix is specified in the coordinate system of the parent transform of outputNode.
+  /// If outputNode is nullptr then it is specified in the world coordinate system.
+  /// Returns false if the ROI or the output node is under a non-linear transform.
+  static bool GetInterpolatedCropOutputGeometry(vtkMRMLAnnotationROINode* roi, vtkMRMLVolumeNode* inputVolume,
+    vtkMRMLVolumeNode* outputNode, bool isotropicResampling, double spacingScale,
+    int outputExtent[6], vtkMatrix4x4* outputIJKToRAS);
+
   /// Sets ROI to fit to input volume.
   /// If ROI is under a non-linear transform then the ROI transform will be reset to RAS.
   static bool FitROIToInputVolume(vtkMRMLCropVolumeParametersNode* parametersNode);
@@ -112,6 +129,10 @@ protected:
   vtkSlicerCropVolumeLogic();
   ~vtkSlicerCropVolumeLogic() override;
 
+  /// Perform interpolated cropping using the resample CLI module.
+  int CropInterpolatedUsingResampleModule(vtkMRMLAnnotationROINode* roi, vtkMRMLVolumeNode* inputVolume,
+    vtkMRMLVolumeNode* outputNode, bool isotropicResampling, double spacingScale, int interpolationMode, double fillValue);
+
 private:
   vtkSlicerCropVolumeLogic(const vtkSlicerCropVolumeLogic&) = delete;
   void operator=(const vtkSlicerCropVolumeLogic&) = delete;
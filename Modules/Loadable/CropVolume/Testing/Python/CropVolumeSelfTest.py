@@ -79,7 +79,20 @@ class CropVolumeSelfTestTest(ScriptedLoadableModuleTest):
     cropVolumeNode.SetROINodeID(roi.GetID())
 
     cropVolumeLogic = slicer.modules.cropvolume.logic()
-    cropVolumeLogic.Apply(cropVolumeNode)
+    self.assertEqual(cropVolumeLogic.Apply(cropVolumeNode), 0)
+
+    # Output geometry matches the geometry computed without cropping
+    outputVolume = slicer.mrmlScene.GetNodeByID(cropVolumeNode.GetOutputVolumeNodeID())
+    outputExtent = [0, -1, 0, -1, 0, -1]
+    outputIJKToRAS = vtk.vtkMatrix4x4()
+    self.assertTrue(cropVolumeLogic.GetInterpolatedCropOutputGeometry(roi, vol, outputVolume,
+      cropVolumeNode.GetIsotropicResampling(), cropVolumeNode.GetSpacingScalingConst(), outputExtent, outputIJKToRAS))
+    self.assertEqual(list(outputVolume.GetImageData().GetExtent()), outputExtent)
+    actualIJKToRAS = vtk.vtkMatrix4x4()
+    outputVolume.GetIJKToRASMatrix(actualIJKToRAS)
+    for row in range(4):
+      for column in range(4):
+        self.assertAlmostEqual(actualIJKToRAS.GetElement(row, column), outputIJKToRAS.GetElement(row, column), places=5)
 
     self.delayDisplay('First test passed, closing the scene and running again')
     # test clearing the scene and running a second time
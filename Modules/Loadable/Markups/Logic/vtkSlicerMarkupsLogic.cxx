@@ -63,12 +63,14 @@
 #include <vtkPolyDataNormals.h>
 #include <vtkMassProperties.h>
 #include <vtkStringArray.h>
+#include <vtkSmartPointer.h>
 #include <vtkThinPlateSplineTransform.h>
 #include <vtkTransform.h>
 #include <vtkTransformPolyDataFilter.h>
 
 // STD includes
 #include <cassert>
+#include <vector>
 
 //----------------------------------------------------------------------------
 vtkStandardNewMacro(vtkSlicerMarkupsLogic);
@@ -1059,6 +1061,11 @@ void vtkSlicerMarkupsLogic::ConvertAnnotationFiducialsToMarkups()
       }
 
 
+    // process all the changes of a scene in one batch, so that observers
+    // of the scene (views, displayable managers, node selectors) are updated
+    // only once and not for each node added or removed
+    scene->StartState(vtkMRMLScene::BatchProcessState);
+
     // go through all the annotation fiducials and collect their hierarchies
     vtkStringArray *hierarchyNodeIDs = vtkStringArray::New();
 
@@ -1093,7 +1100,8 @@ void vtkSlicerMarkupsLogic::ConvertAnnotationFiducialsToMarkups()
     if (hierarchyNodeIDs->GetNumberOfValues() == 0)
       {
       hierarchyNodeIDs->Delete();
-      return;
+      scene->EndState(vtkMRMLScene::BatchProcessState);
+      continue;
       }
     else
       {
@@ -1102,6 +1110,7 @@ void vtkSlicerMarkupsLogic::ConvertAnnotationFiducialsToMarkups()
       }
     // now iterate over the hierarchies that have fiducials in them and convert
     // them to markups lists
+    std::vector< vtkSmartPointer<vtkMRMLNode> > nodesToRemove;
     for (int i = 0; i < hierarchyNodeIDs->GetNumberOfValues(); ++i)
       {
       vtkMRMLNode *mrmlNode = nullptr;
@@ -1135,6 +1144,10 @@ void vtkSlicerMarkupsLogic::ConvertAnnotationFiducialsToMarkups()
       vtkCollection *children = vtkCollection::New();
       hierarchyNode->GetAssociatedChildrenNodes(children, "vtkMRMLAnnotationFiducialNode");
       vtkDebugMacro("Found " << children->GetNumberOfItems() << " annot fids in this hierarchy");
+      // add all the control points in one batch, so that the events are
+      // invoked and the measurements are updated only once per list
+      int wasModifying = markupsNode->StartPointModify();
+      bool displaySettingsCopied = false;
       for (int c = 0; c < children->GetNumberOfItems(); ++c)
         {
         vtkMRMLAnnotationFiducialNode *annotNode;
@@ -1143,25 +1156,30 @@ void vtkSlicerMarkupsLogic::ConvertAnnotationFiducialsToMarkups()
           {
           continue;
           }
-        double coord[3];
-        annotNode->GetFiducialCoordinates(coord);
-        int fidIndex = markupsNode->AddFiducial(coord[0], coord[1], coord[2]);
-        vtkDebugMacro("Added a fiducial at index " << fidIndex);
-        markupsNode->SetNthControlPointLabel(fidIndex, std::string(annotNode->GetName()));
+        vtkMRMLMarkupsNode::ControlPoint *controlPoint = new vtkMRMLMarkupsNode::ControlPoint;
+        annotNode->GetFiducialCoordinates(controlPoint->Position);
+        controlPoint->PositionStatus = vtkMRMLMarkupsNode::PositionDefined;
+        controlPoint->Label = std::string(annotNode->GetName() ? annotNode->GetName() : "");
         char *desc = annotNode->GetDescription();
         if (desc)
           {
-          markupsNode->SetNthControlPointDescription(fidIndex,std::string(desc));
+          controlPoint->Description = std::string(desc);
           }
-        markupsNode->SetNthControlPointSelected(fidIndex, annotNode->GetSelected());
-        markupsNode->SetNthControlPointVisibility(fidIndex,
-                                            annotNode->GetDisplayVisibility());
-        markupsNode->SetNthControlPointLocked(fidIndex, annotNode->GetLocked());
+        controlPoint->Selected = (annotNode->GetSelected() != 0);
+        controlPoint->Visibility = (annotNode->GetDisplayVisibility() != 0);
+        controlPoint->Locked = (annotNode->GetLocked() != 0);
         const char *assocNodeID = annotNode->GetAttribute("AssociatedNodeID");
         if (assocNodeID)
           {
-          markupsNode->SetNthControlPointAssociatedNodeID(fidIndex, assocNodeID);
+          controlPoint->AssociatedNodeID = std::string(assocNodeID);
           }
+        int fidIndex = markupsNode->AddControlPoint(controlPoint, false);
+        if (fidIndex < 0)
+          {
+          delete controlPoint;
+          continue;
+          }
+        vtkDebugMacro("Added a fiducial at index " << fidIndex);
 
         // get the display nodes
         vtkMRMLAnnotationPointDisplayNode *pointDisplayNode = nullptr;
@@ -1169,14 +1187,12 @@ void vtkSlicerMarkupsLogic::ConvertAnnotationFiducialsToMarkups()
         pointDisplayNode = annotNode->GetAnnotationPointDisplayNode();
         textDisplayNode = annotNode->GetAnnotationTextDisplayNode();
 
-        if (c == 0)
+        vtkMRMLMarkupsDisplayNode *markupDisplayNode = markupsNode->GetMarkupsDisplayNode();
+        if (!displaySettingsCopied && markupDisplayNode && pointDisplayNode && textDisplayNode)
           {
           // use the first display node to get display settings
-          vtkMRMLMarkupsDisplayNode *markupDisplayNode = markupsNode->GetMarkupsDisplayNode();
-          if (!markupDisplayNode || !pointDisplayNode || !textDisplayNode)
-            {
-            continue;
-            }
+          displaySettingsCopied = true;
+          int wasModifyingDisplay = markupDisplayNode->StartModify();
           markupDisplayNode->SetColor(pointDisplayNode->GetColor());
           markupDisplayNode->SetSelectedColor(pointDisplayNode->GetSelectedColor());
           markupDisplayNode->SetGlyphScale(pointDisplayNode->GetGlyphScale());
@@ -1189,41 +1205,54 @@ void vtkSlicerMarkupsLogic::ConvertAnnotationFiducialsToMarkups()
           markupDisplayNode->SetSliceProjection(pointDisplayNode->GetSliceProjection());
           markupDisplayNode->SetSliceProjectionColor(pointDisplayNode->GetProjectedColor());
           markupDisplayNode->SetSliceProjectionOpacity(pointDisplayNode->GetProjectedOpacity());
+          markupDisplayNode->EndModify(wasModifyingDisplay);
           }
         //
-        // clean up the no longer needed annotation nodes
+        // collect the no longer needed annotation nodes, they are removed
+        // after all the lists are converted
         //
-        // remove the 1:1 hierarchy node
+        // the 1:1 hierarchy node
         vtkMRMLHierarchyNode *oneToOneHierarchyNode =
           vtkMRMLHierarchyNode::GetAssociatedHierarchyNode(annotNode->GetScene(),
                                                            annotNode->GetID());
         if (oneToOneHierarchyNode)
           {
-          scene->RemoveNode(oneToOneHierarchyNode);
+          nodesToRemove.push_back(oneToOneHierarchyNode);
           }
-
-        // remove the display nodes
+        // the display nodes
         if (pointDisplayNode)
           {
-        scene->RemoveNode(pointDisplayNode);
+          nodesToRemove.push_back(pointDisplayNode);
           }
         if (textDisplayNode)
           {
-          scene->RemoveNode(textDisplayNode);
+          nodesToRemove.push_back(textDisplayNode);
           }
         // is there a storage node?
         vtkMRMLStorageNode *storageNode = annotNode->GetStorageNode();
         if (storageNode)
           {
-          scene->RemoveNode(storageNode);
+          nodesToRemove.push_back(storageNode);
           }
-        // now remove the annotation node
-        scene->RemoveNode(annotNode);
+        // the annotation node
+        nodesToRemove.push_back(annotNode);
         }
+      markupsNode->EndPointModify(wasModifying);
       children->RemoveAllItems();
       children->Delete();
       }
     hierarchyNodeIDs->Delete();
+
+    // clean up the no longer needed annotation nodes
+    for (std::vector< vtkSmartPointer<vtkMRMLNode> >::iterator nodeIt = nodesToRemove.begin();
+         nodeIt != nodesToRemove.end(); ++nodeIt)
+      {
+      if ((*nodeIt)->GetScene() == scene)
+        {
+        scene->RemoveNode(*nodeIt);
+        }
+      }
+    scene->EndState(vtkMRMLScene::BatchProcessState);
     } // end of looping over the scene
   sceneViews->RemoveAllItems();
   sceneViews->Delete();
@@ -169,6 +169,9 @@ public:
   /// and moves the fiducials that are under them into new markups nodes. Leaves
   /// the top level hierarchy nodes intact as they may be parents to ruler or
   /// ROIs but deletes the 1:1 hierarchy nodes.
+  /// Each scene is converted in one batch process and the control points of
+  /// each list are added in one point modify batch, so converting scenes with
+  /// many annotation fiducials does not update the views for each fiducial.
   void ConvertAnnotationFiducialsToMarkups();
 
   /// Iterate over the markups in the list and reset the markup labels using
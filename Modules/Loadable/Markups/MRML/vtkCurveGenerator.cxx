@@ -23,6 +23,7 @@
 
 // VTK includes
 #include <vtkCardinalSpline.h>
+#include <vtkCellArray.h>
 #include <vtkDoubleArray.h>
 #include <vtkInformation.h>
 #include <vtkInformationVector.h>
@@ -30,6 +31,7 @@
 #include <vtkParametricSpline.h>
 #include <vtkParametricFunction.h>
 #include "vtkParametricPolynomialApproximation.h"
+#include <vtkIdList.h>
 #include <vtkPoints.h>
 #include <vtkPointData.h>
 #include <vtkPointLocator.h>
@@ -41,6 +43,8 @@
 // std includes
 #include <algorithm>
 #include <list>
+#include <map>
+#include <utility>
 
 //------------------------------------------------------------------------------
 vtkStandardNewMacro(vtkCurveGenerator);
@@ -71,6 +75,7 @@ vtkCurveGenerator::vtkCurveGenerator()
   this->SurfacePointLocator = vtkSmartPointer<vtkPointLocator>::New();
   this->SurfacePathFilter = vtkSmartPointer<vtkSlicerDijkstraGraphGeodesicPath>::New();
   this->SurfacePathFilter->StopWhenEndReachedOn();
+  this->SurfacePointIds = vtkSmartPointer<vtkIdList>::New();
   this->InputParameters = nullptr;
   this->ParametricFunction = nullptr;
 }
@@ -90,6 +95,7 @@ void vtkCurveGenerator::PrintSelf(std::ostream &os, vtkIndent indent)
   os << indent << "KochanekTension: " << this->KochanekTension << std::endl;
   os << indent << "KochanekEndsCopyNearestDerivatives: " << this->KochanekEndsCopyNearestDerivatives << std::endl;
   os << indent << "PolynomialOrder: " << this->PolynomialOrder << std::endl;
+  os << indent << "IncrementalUpdate: " << this->IncrementalUpdate << std::endl;
   os << indent << "SurfaceCostFunctionType: " <<
     vtkSlicerDijkstraGraphGeodesicPath::GetCostFunctionTypeAsString(this->GetSurfaceCostFunctionType()) << std::endl;
 }
@@ -535,7 +541,7 @@ int vtkCurveGenerator::GeneratePoints(vtkPoints* inputPoints, vtkPolyData* input
   this->InterpolatedPointIdsForControlPoints.clear();
 
   // Initialize pedigree IDs array
-  vtkNew<vtkDoubleArray> outputPedigreeIdArray;
+  vtkSmartPointer<vtkDoubleArray> outputPedigreeIdArray = vtkSmartPointer<vtkDoubleArray>::New();
   outputPedigreeIdArray->SetName("PedigreeIDs");
   outputPedigreeIdArray->SetNumberOfComponents(1);
 
@@ -550,6 +556,22 @@ int vtkCurveGenerator::GeneratePoints(vtkPoints* inputPoints, vtkPolyData* input
       {
       return 0;
       }
+    if (this->IsInterpolatingCurve())
+      {
+      // Keep the same pedigree IDs array if the number of curve points has not changed,
+      // so that measurements interpolated from control point values can be reused.
+      if (this->InterpolatingCurvePedigreeIds
+        && this->InterpolatingCurvePedigreeIds->GetNumberOfTuples() == outputPedigreeIdArray->GetNumberOfTuples()
+        && this->InterpolatingCurvePedigreeIdsPointsPerSegment == this->NumberOfPointsPerInterpolatingSegment)
+        {
+        outputPedigreeIdArray = this->InterpolatingCurvePedigreeIds;
+        }
+      else
+        {
+        this->InterpolatingCurvePedigreeIds = outputPedigreeIdArray;
+        this->InterpolatingCurvePedigreeIdsPointsPerSegment = this->NumberOfPointsPerInterpolatingSegment;
+        }
+      }
     break;
     }
   case vtkCurveGenerator::CURVE_TYPE_SHORTEST_DISTANCE_ON_SURFACE:
@@ -626,21 +648,64 @@ int vtkCurveGenerator::GeneratePointsFromFunction(vtkPoints* inputPoints, vtkPoi
   outputPedigreeIdArray->Reset();
   outputPedigreeIdArray->FillComponent(0, 0.0);
 
+  std::vector<bool> segmentsToUpdate;
+  bool incrementalUpdate = this->GetSplineSegmentsToUpdate(inputPoints, numberOfSegments, segmentsToUpdate);
+  std::vector<double> segmentLengths;
+  if (incrementalUpdate)
+    {
+    // Only re-evaluate the segments that are affected by the modified control points
+    segmentLengths = this->SplineCache.SegmentLengths;
+    outputPoints->DeepCopy(this->SplineCache.OutputPoints);
+    for (int segmentIndex = 0; segmentIndex < numberOfSegments; segmentIndex++)
+      {
+      if (!segmentsToUpdate[segmentIndex])
+        {
+        continue;
+        }
+      double segmentLength = 0.0;
+      double previousPoint[3] = { 0.0 };
+      int firstPointIndex = segmentIndex * this->NumberOfPointsPerInterpolatingSegment;
+      for (int pointIndex = firstPointIndex; pointIndex <= firstPointIndex + this->NumberOfPointsPerInterpolatingSegment; pointIndex++)
+        {
+        double sampleParameter = pointIndex / (double)(totalNumberOfPoints - 1);
+        double curvePoint[3];
+        this->ParametricFunction->Evaluate(&sampleParameter, curvePoint, nullptr);
+        outputPoints->SetPoint(pointIndex, curvePoint);
+        if (pointIndex > firstPointIndex)
+          {
+          segmentLength += sqrt(vtkMath::Distance2BetweenPoints(previousPoint, curvePoint));
+          }
+        previousPoint[0] = curvePoint[0];
+        previousPoint[1] = curvePoint[1];
+        previousPoint[2] = curvePoint[2];
+        }
+      segmentLengths[segmentIndex] = segmentLength;
+      }
+    outputPoints->Modified();
+    }
+  else
+    {
+    segmentLengths.resize(numberOfSegments, 0.0);
+    }
+
   double previousPoint[3] = { 0.0 };
   for (int pointIndex = 0; pointIndex < totalNumberOfPoints; pointIndex++)
     {
-    double sampleParameter = pointIndex / (double)(totalNumberOfPoints - 1);
-    double curvePoint[3];
-    this->ParametricFunction->Evaluate(&sampleParameter, curvePoint, nullptr);
-    outputPoints->InsertNextPoint(curvePoint);
-    if (pointIndex > 0)
+    if (!incrementalUpdate)
       {
-      double segmentLength = sqrt(vtkMath::Distance2BetweenPoints(previousPoint, curvePoint));
-      this->OutputCurveLength += segmentLength;
+      double sampleParameter = pointIndex / (double)(totalNumberOfPoints - 1);
+      double curvePoint[3];
+      this->ParametricFunction->Evaluate(&sampleParameter, curvePoint, nullptr);
+      outputPoints->InsertNextPoint(curvePoint);
+      if (pointIndex > 0)
+        {
+        int segmentIndex = (pointIndex - 1) / this->NumberOfPointsPerInterpolatingSegment;
+        segmentLengths[segmentIndex] += sqrt(vtkMath::Distance2BetweenPoints(previousPoint, curvePoint));
+        }
+      previousPoint[0] = curvePoint[0];
+      previousPoint[1] = curvePoint[1];
+      previousPoint[2] = curvePoint[2];
       }
-    previousPoint[0] = curvePoint[0];
-    previousPoint[1] = curvePoint[1];
-    previousPoint[2] = curvePoint[2];
 
     // Calculate pedigree ID for point
     // Each poly data point corresponding to a control point has the same ID as the control point index,
@@ -654,9 +719,116 @@ int vtkCurveGenerator::GeneratePointsFromFunction(vtkPoints* inputPoints, vtkPoi
     outputPedigreeIdArray->InsertValue(pointIndex, pedigreeId);
   }
 
+  for (double segmentLength : segmentLengths)
+    {
+    this->OutputCurveLength += segmentLength;
+    }
+  this->UpdateSplineCache(inputPoints, outputPoints, segmentLengths);
   return 1;
 }
 
+//------------------------------------------------------------------------------
+bool vtkCurveGenerator::GetSplineSegmentsToUpdate(vtkPoints* inputPoints, int numberOfSegments, std::vector<bool>& segmentsToUpdate)
+{
+  // Number of segments before and after a control point that depend on the position of the control point
+  int numberOfAffectedSegmentsBefore = 0;
+  int numberOfAffectedSegmentsAfter = 0;
+  switch (this->CurveType)
+    {
+    case vtkCurveGenerator::CURVE_TYPE_LINEAR_SPLINE:
+      numberOfAffectedSegmentsBefore = 1;
+      numberOfAffectedSegmentsAfter = 0;
+      break;
+    case vtkCurveGenerator::CURVE_TYPE_KOCHANEK_SPLINE:
+      // derivative at a control point is computed from the previous and next control points
+      numberOfAffectedSegmentsBefore = 2;
+      numberOfAffectedSegmentsAfter = 1;
+      break;
+    default:
+      // coefficients of cardinal splines are computed by solving a linear system for the whole curve
+      return false;
+    }
+
+  int numberOfInputPoints = inputPoints->GetNumberOfPoints();
+  const SplineCurveCache& cache = this->SplineCache;
+  if (!this->IncrementalUpdate
+    || !cache.OutputPoints
+    || cache.CurveType != this->CurveType
+    || cache.CurveIsClosed != this->CurveIsClosed
+    || cache.NumberOfPointsPerInterpolatingSegment != this->NumberOfPointsPerInterpolatingSegment
+    || cache.KochanekBias != this->KochanekBias
+    || cache.KochanekContinuity != this->KochanekContinuity
+    || cache.KochanekTension != this->KochanekTension
+    || cache.KochanekEndsCopyNearestDerivatives != this->KochanekEndsCopyNearestDerivatives
+    || cache.InputPoints.size() != static_cast<size_t>(numberOfInputPoints) * 3
+    || cache.SegmentLengths.size() != static_cast<size_t>(numberOfSegments))
+    {
+    return false;
+    }
+
+  segmentsToUpdate.assign(numberOfSegments, false);
+  int numberOfModifiedPoints = 0;
+  for (int pointIndex = 0; pointIndex < numberOfInputPoints; pointIndex++)
+    {
+    double point[3] = { 0.0 };
+    inputPoints->GetPoint(pointIndex, point);
+    const double* cachedPoint = &cache.InputPoints[pointIndex * 3];
+    if (point[0] == cachedPoint[0] && point[1] == cachedPoint[1] && point[2] == cachedPoint[2])
+      {
+      continue;
+      }
+    numberOfModifiedPoints++;
+    if (numberOfModifiedPoints > numberOfInputPoints / 4)
+      {
+      // most of the curve is changed, faster to regenerate all
+      return false;
+      }
+    for (int segmentIndex = pointIndex - numberOfAffectedSegmentsBefore;
+      segmentIndex <= pointIndex + numberOfAffectedSegmentsAfter; segmentIndex++)
+      {
+      if (this->CurveIsClosed)
+        {
+        segmentsToUpdate[(segmentIndex + numberOfSegments) % numberOfSegments] = true;
+        }
+      else if (segmentIndex >= 0 && segmentIndex < numberOfSegments)
+        {
+        segmentsToUpdate[segmentIndex] = true;
+        }
+      }
+    }
+  return true;
+}
+
+//------------------------------------------------------------------------------
+void vtkCurveGenerator::UpdateSplineCache(vtkPoints* inputPoints, vtkPoints* outputPoints, const std::vector<double>& segmentLengths)
+{
+  SplineCurveCache& cache = this->SplineCache;
+  if (!this->IncrementalUpdate
+    || (this->CurveType != vtkCurveGenerator::CURVE_TYPE_LINEAR_SPLINE
+      && this->CurveType != vtkCurveGenerator::CURVE_TYPE_KOCHANEK_SPLINE))
+    {
+    cache.OutputPoints = nullptr;
+    cache.InputPoints.clear();
+    cache.SegmentLengths.clear();
+    return;
+    }
+  cache.CurveType = this->CurveType;
+  cache.CurveIsClosed = this->CurveIsClosed;
+  cache.NumberOfPointsPerInterpolatingSegment = this->NumberOfPointsPerInterpolatingSegment;
+  cache.KochanekBias = this->KochanekBias;
+  cache.KochanekContinuity = this->KochanekContinuity;
+  cache.KochanekTension = this->KochanekTension;
+  cache.KochanekEndsCopyNearestDerivatives = this->KochanekEndsCopyNearestDerivatives;
+  vtkIdType numberOfInputPoints = inputPoints->GetNumberOfPoints();
+  cache.InputPoints.resize(numberOfInputPoints * 3);
+  for (vtkIdType pointIndex = 0; pointIndex < numberOfInputPoints; pointIndex++)
+    {
+    inputPoints->GetPoint(pointIndex, &cache.InputPoints[pointIndex * 3]);
+    }
+  cache.OutputPoints = outputPoints;
+  cache.SegmentLengths = segmentLengths;
+}
+
 //------------------------------------------------------------------------------
 int vtkCurveGenerator::GeneratePointsFromSurface(
   vtkPoints* inputPoints, vtkPolyData* inputSurface, vtkPoints* outputPoints, vtkDoubleArray* outputPedigreeIdArray)
@@ -688,6 +860,19 @@ int vtkCurveGenerator::GeneratePointsFromSurface(
   this->SurfacePointLocator->SetDataSet(inputSurface);
   this->SurfacePointLocator->BuildLocator();
 
+  // Paths between surface vertices are reused if the surface and the cost function are not changed,
+  // therefore moving a control point only requires computing its two adjacent segments.
+  if (this->SurfacePathCacheSurface != inputSurface
+    || this->SurfacePathCacheTime.GetMTime() < inputSurface->GetMTime()
+    || this->SurfacePathCacheCostFunctionType != this->SurfacePathFilter->GetCostFunctionType())
+    {
+    this->SurfacePathCache.clear();
+    this->SurfacePathCacheSurface = inputSurface;
+    this->SurfacePathCacheCostFunctionType = this->SurfacePathFilter->GetCostFunctionType();
+    }
+  std::map<std::pair<vtkIdType, vtkIdType>, std::vector<vtkIdType> > usedSurfacePaths;
+
+  this->SurfacePointIds->Reset();
   for (vtkIdType controlPointIndex = 0; controlPointIndex < numberOfSegments; ++controlPointIndex)
     {
     double controlPoint1[3] = { 0 };
@@ -698,21 +883,30 @@ int vtkCurveGenerator::GeneratePointsFromSurface(
     inputPoints->GetPoint((controlPointIndex + 1) % numberOfInputPoints, controlPoint2);
     vtkIdType id2 = this->SurfacePointLocator->FindClosestPoint(controlPoint2);
 
-    // Path is traced backward, so start vertex should be point2, and end should be point1.
-    this->SurfacePathFilter->SetStartVertex(id2);
-    this->SurfacePathFilter->SetEndVertex(id1);
-    this->SurfacePathFilter->Update();
+    std::pair<vtkIdType, vtkIdType> segmentKey(id1, id2);
+    auto cachedPathIt = this->SurfacePathCache.find(segmentKey);
+    if (cachedPathIt == this->SurfacePathCache.end())
+      {
+      // Path is traced backward, so start vertex should be point2, and end should be point1.
+      this->SurfacePathFilter->SetStartVertex(id2);
+      this->SurfacePathFilter->SetEndVertex(id1);
+      this->SurfacePathFilter->Update();
+      vtkIdList* pathPointIds = this->SurfacePathFilter->GetIdList();
+      std::vector<vtkIdType> path(pathPointIds->GetPointer(0), pathPointIds->GetPointer(0) + pathPointIds->GetNumberOfIds());
+      cachedPathIt = this->SurfacePathCache.insert(std::make_pair(segmentKey, path)).first;
+      }
+    const std::vector<vtkIdType>& path = usedSurfacePaths.insert(*cachedPathIt).first->second;
 
-    vtkPolyData* outputPath = this->SurfacePathFilter->GetOutput();
     double previousPoint[3] = { 0 };
-    for (vtkIdType pointIndex = 0; pointIndex < outputPath->GetNumberOfPoints(); ++pointIndex)
+    for (vtkIdType pointIndex = 0; pointIndex < static_cast<vtkIdType>(path.size()); ++pointIndex)
       {
       double curvePoint[3] = { 0 };
-      outputPath->GetPoint(pointIndex, curvePoint);
+      inputSurface->GetPoint(path[pointIndex], curvePoint);
 
       if (controlPointIndex == 0 || pointIndex > 0)
         {
         vtkIdType outputPointId = outputPoints->InsertNextPoint(curvePoint);
+        this->SurfacePointIds->InsertNextId(path[pointIndex]);
         if (static_cast<vtkIdType>(this->InterpolatedPointIdsForControlPoints.size()) <= controlPointIndex)
           {
           this->InterpolatedPointIdsForControlPoints.push_back(outputPointId);
@@ -731,6 +925,10 @@ int vtkCurveGenerator::GeneratePointsFromSurface(
     }
   this->InterpolatedPointIdsForControlPoints.push_back(outputPoints->GetNumberOfPoints() - 1);
 
+  // Only keep paths of the current curve
+  this->SurfacePathCache.swap(usedSurfacePaths);
+  this->SurfacePathCacheTime.Modified();
+
   // Generate pedigree IDs array
   outputPedigreeIdArray->Initialize();
   outputPedigreeIdArray->SetNumberOfTuples(outputPoints->GetNumberOfPoints());
@@ -761,7 +959,11 @@ int vtkCurveGenerator::GenerateLines(vtkPolyData* polyData)
   // Update lines: a single cell containing a line with point
   // indices: 0, 1, ..., last point (and an extra 0 if closed curve).
   vtkIdType numberOfPoints = polyData->GetNumberOfPoints();
-  vtkNew<vtkCellArray> lines;
+  if (!this->OutputLines)
+    {
+    this->OutputLines = vtkSmartPointer<vtkCellArray>::New();
+    }
+  vtkCellArray* lines = this->OutputLines;
   if (numberOfPoints > 1)
     {
     bool closed = (numberOfPoints > 2 && this->CurveIsClosed);
@@ -779,7 +981,8 @@ int vtkCurveGenerator::GenerateLines(vtkPolyData* polyData)
 #endif
       lines->GetCell(0, currentNumberOfCellPoints, currentCellPoints);
 
-      if (currentNumberOfCellPoints == numberOfCellPoints)
+      if (currentNumberOfCellPoints == numberOfCellPoints
+        && currentCellPoints[numberOfCellPoints - 1] == (closed ? 0 : numberOfPoints - 1))
         {
         needToUpdateLines = false;
         }
@@ -800,6 +1003,11 @@ int vtkCurveGenerator::GenerateLines(vtkPolyData* polyData)
       lines->Modified();
       }
     }
+  else if (lines->GetNumberOfCells() > 0)
+    {
+    lines->Reset();
+    lines->Modified();
+    }
   polyData->SetLines(lines);
   return 1;
 }
@@ -1036,7 +1244,7 @@ bool vtkCurveGenerator::IsInterpolatingCurve()
 //------------------------------------------------------------------------------
 vtkIdList* vtkCurveGenerator::GetSurfacePointIds()
 {
-  return this->SurfacePathFilter->GetIdList();
+  return this->SurfacePointIds;
 }
 
 //------------------------------------------------------------------------------
@@ -28,8 +28,15 @@
 #include <vtkSetGet.h>
 #include <vtkSmartPointer.h>
 
+// std includes
+#include <map>
+#include <utility>
+#include <vector>
+
 class vtkSlicerDijkstraGraphGeodesicPath;
+class vtkCellArray;
 class vtkDoubleArray;
+class vtkIdList;
 class vtkPoints;
 class vtkSpline;
 
@@ -82,6 +89,14 @@ public:
 
   virtual bool IsInterpolatingCurve();
 
+  /// If enabled then only the segments of linear and Kochanek spline curves that are affected
+  /// by modified control points are regenerated, the rest of the curve is reused from the previous output.
+  /// These splines are local: each segment only depends on a few neighboring control points.
+  /// Default true.
+  vtkGetMacro(IncrementalUpdate, bool);
+  vtkSetMacro(IncrementalUpdate, bool);
+  vtkBooleanMacro(IncrementalUpdate, bool);
+
   /// Sample an *interpolating* curve this many times per segment (pair of points in sequence). Range 1 and up. Default 5.
   vtkSetMacro(NumberOfPointsPerInterpolatingSegment, int);
   vtkGetMacro(NumberOfPointsPerInterpolatingSegment, int);
@@ -179,7 +194,8 @@ public:
   /// Currently only works for shortest surface distance
   vtkIdType GetControlPointIdFromInterpolatedPointId(vtkIdType interpolatedPointId);
 
-  /// Get the list of curve point ids on the surface mesh
+  /// Get the list of surface mesh point ids of all the curve points.
+  /// Only available for shortest distance on surface curve type.
   vtkIdList* GetSurfacePointIds();
 
   /// Get the length of the curve
@@ -228,13 +244,46 @@ protected:
   double PolynomialSampleWidth;
   int PolynomialWeightFunction;
   std::vector<vtkIdType> InterpolatedPointIdsForControlPoints;
+  bool IncrementalUpdate{true};
 
   // internal storage
   vtkSmartPointer<vtkPointLocator> SurfacePointLocator;
   vtkSmartPointer<vtkSlicerDijkstraGraphGeodesicPath> SurfacePathFilter;
+  vtkSmartPointer<vtkIdList> SurfacePointIds;
+  /// Surface vertex ids of paths between pairs of surface vertices, from the first to the second vertex
+  std::map<std::pair<vtkIdType, vtkIdType>, std::vector<vtkIdType> > SurfacePathCache;
+  vtkPolyData* SurfacePathCacheSurface{nullptr};
+  vtkTimeStamp SurfacePathCacheTime;
+  int SurfacePathCacheCostFunctionType{-1};
   vtkSmartPointer<vtkDoubleArray> InputParameters;
   vtkSmartPointer<vtkParametricFunction> ParametricFunction;
 
+  /// Curve generated from a spline function in the previous execution,
+  /// used for regenerating only the segments that are affected by modified control points.
+  struct SplineCurveCache
+    {
+    int CurveType{-1};
+    bool CurveIsClosed{false};
+    int NumberOfPointsPerInterpolatingSegment{0};
+    double KochanekBias{0.0};
+    double KochanekContinuity{0.0};
+    double KochanekTension{0.0};
+    bool KochanekEndsCopyNearestDerivatives{false};
+    /// Control point coordinates (x0, y0, z0, x1, ...)
+    std::vector<double> InputPoints;
+    vtkSmartPointer<vtkPoints> OutputPoints;
+    std::vector<double> SegmentLengths;
+    };
+  SplineCurveCache SplineCache;
+
+  /// Pedigree IDs of interpolating curves only depend on the number of curve points,
+  /// the same array is kept in the output while they do not change.
+  vtkSmartPointer<vtkDoubleArray> InterpolatingCurvePedigreeIds;
+  int InterpolatingCurvePedigreeIdsPointsPerSegment{0};
+
+  /// Lines of the output, kept between executions to avoid regenerating the point indices
+  vtkSmartPointer<vtkCellArray> OutputLines;
+
   // output
   double OutputCurveLength;
 
@@ -246,6 +295,11 @@ protected:
   void SetParametricFunctionToPolynomial(vtkPoints* inputPoints);
   int GeneratePoints(vtkPoints* inputPoints, vtkPolyData* inputSurface, vtkPolyData* outputPolyData);
   int GeneratePointsFromFunction(vtkPoints* inputPoints, vtkPoints* outputPoints, vtkDoubleArray* outputPedigreeIdArray);
+  /// Get the segments that need to be regenerated because their control points have been modified
+  /// since the previous execution. Returns false if the whole curve has to be regenerated.
+  bool GetSplineSegmentsToUpdate(vtkPoints* inputPoints, int numberOfSegments, std::vector<bool>& segmentsToUpdate);
+  /// Store the generated spline curve for incremental update in the next execution
+  void UpdateSplineCache(vtkPoints* inputPoints, vtkPoints* outputPoints, const std::vector<double>& segmentLengths);
   int GeneratePointsFromSurface(vtkPoints* inputPoints, vtkPolyData* inputSurface, vtkPoints* outputPoints, vtkDoubleArray* outputPedigreeIdArray);
   int GenerateLines(vtkPolyData* polyData);
 
@@ -28,12 +28,17 @@
 #include <vtkCellData.h>
 #include <vtkDoubleArray.h>
 #include <vtkFieldData.h>
+#include <vtkIdList.h>
 #include <vtkInformation.h>
 #include <vtkInformationVector.h>
 #include <vtkPointData.h>
+#include <vtkPoints.h>
 #include <vtkPolyData.h>
 #include <vtkTriangleFilter.h>
 
+// STD includes
+#include <algorithm>
+
 //------------------------------------------------------------------------------
 vtkStandardNewMacro(vtkCurveMeasurementsCalculator);
 
@@ -167,6 +172,45 @@ int vtkCurveMeasurementsCalculator::RequestData(
   return 1;
 }
 
+//------------------------------------------------------------------------------
+void vtkCurveMeasurementsCalculator::CalculateCurvatureAtLinePoint(vtkPoints* points, vtkIdList* linePoints, vtkIdType idx,
+  double& kappa, double& length)
+{
+  double prevPoint[3] = { 0.0 }; // pp
+  points->GetPoint(linePoints->GetId(idx - 1), prevPoint);
+  double point[3] = { 0.0 }; // p
+  points->GetPoint(linePoints->GetId(idx), point);
+  double nextPoint[3] = { 0.0 };
+  points->GetPoint(linePoints->GetId(idx + 1), nextPoint);
+
+  double prevDiffVector[3] = { point[0]-prevPoint[0], point[1]-prevPoint[1], point[2]-prevPoint[2] };
+  double prevDiffNorm = sqrt(prevDiffVector[0]*prevDiffVector[0] + prevDiffVector[1]*prevDiffVector[1] + prevDiffVector[2]*prevDiffVector[2]);
+  double prevNormDiffVector[3] = { prevDiffVector[0]/prevDiffNorm, prevDiffVector[1]/prevDiffNorm, prevDiffVector[2]/prevDiffNorm }; // pT
+
+  double diffVector[3] = { nextPoint[0]-point[0], nextPoint[1]-point[1], nextPoint[2]-point[2] };
+  double diffNorm = sqrt(diffVector[0]*diffVector[0] + diffVector[1]*diffVector[1] + diffVector[2]*diffVector[2]); // ds
+  double normDiffVector[3] = { diffVector[0]/diffNorm, diffVector[1]/diffNorm, diffVector[2]/diffNorm }; // T
+
+  // Local curvature
+  kappa = sqrt( (normDiffVector[0]-prevNormDiffVector[0])*(normDiffVector[0]-prevNormDiffVector[0])
+              + (normDiffVector[1]-prevNormDiffVector[1])*(normDiffVector[1]-prevNormDiffVector[1])
+              + (normDiffVector[2]-prevNormDiffVector[2])*(normDiffVector[2]-prevNormDiffVector[2]) )
+          / diffNorm;
+
+  // Length of the curve between the midpoints of the adjacent line segments (skip first point)
+  double meanPoint[3] = { (nextPoint[0]+point[0]) / 2.0, (nextPoint[1]+point[1]) / 2.0, (nextPoint[2]+point[2]) / 2.0 }; // m
+  double prevMeanPoint[3] = { point[0], point[1], point[2] }; // pm
+  if (idx > 1)
+    {
+    prevMeanPoint[0] = (point[0]+prevPoint[0]) / 2.0;
+    prevMeanPoint[1] = (point[1]+prevPoint[1]) / 2.0;
+    prevMeanPoint[2] = (point[2]+prevPoint[2]) / 2.0;
+    }
+  length = sqrt( (meanPoint[0]-prevMeanPoint[0])*(meanPoint[0]-prevMeanPoint[0])
+               + (meanPoint[1]-prevMeanPoint[1])*(meanPoint[1]-prevMeanPoint[1])
+               + (meanPoint[2]-prevMeanPoint[2])*(meanPoint[2]-prevMeanPoint[2]) );
+}
+
 //------------------------------------------------------------------------------
 bool vtkCurveMeasurementsCalculator::CalculatePolyDataCurvature(vtkPolyData* polyData)
 {
@@ -189,6 +233,62 @@ bool vtkCurveMeasurementsCalculator::CalculatePolyDataCurvature(vtkPolyData* pol
   lines->GetCell(0, linePoints);
   vtkIdType numberOfPoints = // Last point in closed curve line is the first point
     (this->CurveIsClosed ? linePoints->GetNumberOfIds()-1 : linePoints->GetNumberOfIds());
+  if (numberOfPoints < 2)
+    {
+    return false;
+    }
+
+  // Curvature at a point only depends on the point and its two neighbors, therefore if only a few points
+  // are moved since the last computation then only the curvature values around them are recomputed.
+  CurvatureCache& cache = this->Curvature;
+  std::vector<bool> pointsToUpdate(numberOfPoints, true);
+  bool incrementalUpdate = (cache.CurveIsClosed == this->CurveIsClosed
+    && cache.Points.size() == static_cast<size_t>(numberOfPoints) * 3);
+  if (incrementalUpdate)
+    {
+    pointsToUpdate.assign(numberOfPoints, false);
+    vtkIdType numberOfModifiedPoints = 0;
+    for (vtkIdType idx = 0; idx < numberOfPoints && incrementalUpdate; ++idx)
+      {
+      double point[3] = { 0.0 };
+      points->GetPoint(linePoints->GetId(idx), point);
+      double* cachedPoint = &cache.Points[idx * 3];
+      if (point[0] == cachedPoint[0] && point[1] == cachedPoint[1] && point[2] == cachedPoint[2])
+        {
+        continue;
+        }
+      cachedPoint[0] = point[0];
+      cachedPoint[1] = point[1];
+      cachedPoint[2] = point[2];
+      // most of the curve is changed, faster to recompute all
+      incrementalUpdate = (++numberOfModifiedPoints <= numberOfPoints / 4);
+      for (vtkIdType neighborIdx = std::max<vtkIdType>(idx - 1, 0); neighborIdx <= std::min(idx + 1, numberOfPoints - 1); ++neighborIdx)
+        {
+        pointsToUpdate[neighborIdx] = true;
+        }
+      }
+    }
+  if (!incrementalUpdate)
+    {
+    pointsToUpdate.assign(numberOfPoints, true);
+    cache.CurveIsClosed = this->CurveIsClosed;
+    cache.Points.resize(numberOfPoints * 3);
+    for (vtkIdType idx = 0; idx < numberOfPoints; ++idx)
+      {
+      points->GetPoint(linePoints->GetId(idx), &cache.Points[idx * 3]);
+      }
+    cache.Values.assign(numberOfPoints, 0.0);
+    cache.Lengths.assign(numberOfPoints, 0.0);
+    }
+
+  // The curvature for the first and last points is 0.0 for open curves
+  for (vtkIdType idx=1; idx<numberOfPoints-1; ++idx)
+    {
+    if (pointsToUpdate[idx])
+      {
+      this->CalculateCurvatureAtLinePoint(points, linePoints, idx, cache.Values[idx], cache.Lengths[idx]);
+      }
+    }
 
   // Initialize curvature array
   vtkNew<vtkDoubleArray> curvatureValues;
@@ -196,97 +296,45 @@ bool vtkCurveMeasurementsCalculator::CalculatePolyDataCurvature(vtkPolyData* pol
   curvatureValues->SetName("Curvature");
   curvatureValues->SetNumberOfComponents(1);
   curvatureValues->SetNumberOfTuples(numberOfPoints);
-  curvatureValues->Reset();
-  curvatureValues->FillComponent(0,0.0);
+  for (vtkIdType idx=0; idx<numberOfPoints; ++idx)
+    {
+    curvatureValues->SetValue(linePoints->GetId(idx), cache.Values[idx]);
+    }
+  if (this->CurveIsClosed)
+    {
+    // Use the adjacent values for closed curve instead of the singular values
+    curvatureValues->SetValue(linePoints->GetId(0), cache.Values[1]);
+    curvatureValues->SetValue(linePoints->GetId(numberOfPoints-1), cache.Values[numberOfPoints-2]);
+    }
 
-  // Initialize curvature variables
-  double minKappa = 0.0;
+  // Statistics
   double maxKappa = 0.0;
   double meanKappa = 0.0; // Mean is weighted by the length of each segment
-
-  // Get values for first point
-  double prevPoint[3] = {points->GetPoint(linePoints->GetId(0))[0], points->GetPoint(linePoints->GetId(0))[1], points->GetPoint(linePoints->GetId(0))[2]}; // pp
-  double* currPoint = points->GetPoint(linePoints->GetId(1)); // p
-  double diffVector[3] = {currPoint[0]-prevPoint[0], currPoint[1]-prevPoint[1], currPoint[2]-prevPoint[2]};
-  double diffNorm = sqrt(diffVector[0]*diffVector[0] + diffVector[1]*diffVector[1] + diffVector[2]*diffVector[2]); // ds
-  double normDiffVector[3] = {0.0, 0.0, 0.0}; // T
-  double prevNormDiffVector[3] = {diffVector[0]/diffNorm, diffVector[1]/diffNorm, diffVector[2]/diffNorm}; // pT
-  double meanPoint[3] = {0.0, 0.0, 0.0}; // m
-  double prevMeanPoint[3] = {currPoint[0], currPoint[1], currPoint[2]}; // pm (Skip first point)
-  double kappa = 0.0;
-  double currentLength = 0.0;
   double length = 0.0;
-
-  // The curvature for the first cell is 0.0 for open curves
-  curvatureValues->InsertValue(linePoints->GetId(0), 0.0);
-
-  prevPoint[0] = currPoint[0]; prevPoint[1] = currPoint[1]; prevPoint[2] = currPoint[2];
   for (vtkIdType idx=1; idx<numberOfPoints-1; ++idx)
     {
-    currPoint = points->GetPoint(linePoints->GetId(idx+1));
-
-    diffVector[0] = currPoint[0]-prevPoint[0];
-    diffVector[1] = currPoint[1]-prevPoint[1];
-    diffVector[2] = currPoint[2]-prevPoint[2];
-    diffNorm = sqrt(diffVector[0]*diffVector[0] + diffVector[1]*diffVector[1] + diffVector[2]*diffVector[2]);
-
-    normDiffVector[0] = diffVector[0] / diffNorm;
-    normDiffVector[1] = diffVector[1] / diffNorm;
-    normDiffVector[2] = diffVector[2] / diffNorm;
-
-    // Local curvature
-    kappa = sqrt( (normDiffVector[0]-prevNormDiffVector[0])*(normDiffVector[0]-prevNormDiffVector[0])
-                + (normDiffVector[1]-prevNormDiffVector[1])*(normDiffVector[1]-prevNormDiffVector[1])
-                + (normDiffVector[2]-prevNormDiffVector[2])*(normDiffVector[2]-prevNormDiffVector[2]) )
-            / diffNorm;
-    curvatureValues->InsertValue(linePoints->GetId(idx), kappa);
-
-    // Statistics
-    meanPoint[0] = (currPoint[0]+prevPoint[0]) / 2.0;
-    meanPoint[1] = (currPoint[1]+prevPoint[1]) / 2.0;
-    meanPoint[2] = (currPoint[2]+prevPoint[2]) / 2.0;
-
-    currentLength = sqrt( (meanPoint[0]-prevMeanPoint[0])*(meanPoint[0]-prevMeanPoint[0])
-                        + (meanPoint[1]-prevMeanPoint[1])*(meanPoint[1]-prevMeanPoint[1])
-                        + (meanPoint[2]-prevMeanPoint[2])*(meanPoint[2]-prevMeanPoint[2]) );
-    if (kappa < minKappa)
-      {
-      minKappa = kappa;
-      }
-    else if (kappa > maxKappa)
-      {
-      maxKappa = kappa;
-      }
-    meanKappa += kappa * currentLength; // weighted mean
-    length += currentLength;
+    maxKappa = std::max(maxKappa, cache.Values[idx]);
+    meanKappa += cache.Values[idx] * cache.Lengths[idx]; // weighted mean
+    length += cache.Lengths[idx];
+    }
 
-    // Propagate current values to previous
+  // Length between the last point and the midpoint of the last line segment
+  double lastPoint[3] = { 0.0 };
+  points->GetPoint(linePoints->GetId(numberOfPoints-1), lastPoint);
+  double lastMeanPoint[3] = { 0.0 };
+  points->GetPoint(linePoints->GetId(1), lastMeanPoint);
+  if (numberOfPoints > 2)
+    {
+    double secondLastPoint[3] = { 0.0 };
+    points->GetPoint(linePoints->GetId(numberOfPoints-2), secondLastPoint);
     for (int i=0; i<3; ++i)
       {
-      prevPoint[i] = currPoint[i];
-      prevMeanPoint[i] = meanPoint[i];
-      prevNormDiffVector[i] = normDiffVector[i];
+      lastMeanPoint[i] = (lastPoint[i]+secondLastPoint[i]) / 2.0;
       }
-    } // For each line point
-
-  if (!this->CurveIsClosed)
-    {
-    // The curvature for the last cell by definition is 0.0 for open curves
-    curvatureValues->InsertValue(linePoints->GetId(numberOfPoints-1), 0.0);
-    }
-  else
-    {
-    // Use the adjacent values for closed curve instead of the singular values
-    curvatureValues->SetComponent(linePoints->GetId(0), 0,
-      curvatureValues->GetValue(linePoints->GetId(1)));
-    curvatureValues->InsertValue(linePoints->GetId(numberOfPoints-1),
-      curvatureValues->GetValue(linePoints->GetId(numberOfPoints-2)));
     }
-
-  currentLength = sqrt( (prevPoint[0]-prevMeanPoint[0])*(prevPoint[0]-prevMeanPoint[0])
-                      + (prevPoint[1]-prevMeanPoint[1])*(prevPoint[1]-prevMeanPoint[1])
-                      + (prevPoint[2]-prevMeanPoint[2])*(prevPoint[2]-prevMeanPoint[2]) );
-  length += currentLength;
+  length += sqrt( (lastPoint[0]-lastMeanPoint[0])*(lastPoint[0]-lastMeanPoint[0])
+                + (lastPoint[1]-lastMeanPoint[1])*(lastPoint[1]-lastMeanPoint[1])
+                + (lastPoint[2]-lastMeanPoint[2])*(lastPoint[2]-lastMeanPoint[2]) );
   meanKappa = meanKappa / length;
 
   // Set mean and max curvature to measurements
@@ -366,12 +414,28 @@ bool vtkCurveMeasurementsCalculator::InterpolateControlPointMeasurementToPolyDat
       }
 
     // Observe control point data array. If it is modified, then interpolation needs to be re-run
-    controlPointValues->AddObserver(vtkCommand::ModifiedEvent, this->ControlPointArrayModifiedCallbackCommand);
-    vtkWeakPointer<vtkDoubleArray> controlPointArrayWeakPointer(controlPointValues);
-    this->ObservedControlPointArrays->AddItem(controlPointArrayWeakPointer);
+    if (!controlPointValues->HasObserver(vtkCommand::ModifiedEvent, this->ControlPointArrayModifiedCallbackCommand))
+      {
+      controlPointValues->AddObserver(vtkCommand::ModifiedEvent, this->ControlPointArrayModifiedCallbackCommand);
+      vtkWeakPointer<vtkDoubleArray> controlPointArrayWeakPointer(controlPointValues);
+      this->ObservedControlPointArrays->AddItem(controlPointArrayWeakPointer);
+      }
 
-    vtkNew<vtkDoubleArray> interpolatedMeasurement;
     std::string arrayName = std::string("Interpolated:") + (currentMeasurement->GetName() ? std::string(currentMeasurement->GetName()) : "Unknown");
+
+    // Interpolated values only depend on the control point values and the pedigree IDs,
+    // reuse the previous result if none of them has changed (for example, when only the curve shape is changed).
+    InterpolatedMeasurementCache& cache = this->InterpolatedMeasurements[arrayName];
+    if (cache.InterpolatedValues
+      && cache.ControlPointValues == controlPointValues && cache.ControlPointValuesMTime == controlPointValues->GetMTime()
+      && cache.PedigreeIds == pedigreeIdsArray && cache.PedigreeIdsMTime == pedigreeIdsArray->GetMTime()
+      && cache.InterpolatedValues->GetNumberOfTuples() == numberOfPoints)
+      {
+      outputPolyData->GetPointData()->AddArray(cache.InterpolatedValues);
+      continue;
+      }
+
+    vtkNew<vtkDoubleArray> interpolatedMeasurement;
     interpolatedMeasurement->SetName(arrayName.c_str());
     interpolatedMeasurement->SetNumberOfComponents(1);
     interpolatedMeasurement->SetNumberOfTuples(numberOfPoints);
@@ -401,6 +465,11 @@ bool vtkCurveMeasurementsCalculator::InterpolateControlPointMeasurementToPolyDat
       }
 
     outputPolyData->GetPointData()->AddArray(interpolatedMeasurement);
+    cache.ControlPointValues = controlPointValues;
+    cache.ControlPointValuesMTime = controlPointValues->GetMTime();
+    cache.PedigreeIds = pedigreeIdsArray;
+    cache.PedigreeIdsMTime = pedigreeIdsArray->GetMTime();
+    cache.InterpolatedValues = interpolatedMeasurement;
     }
 
   return true;
@@ -20,15 +20,24 @@
 
 // VTK includes
 #include <vtkCollection.h>
+#include <vtkDoubleArray.h>
 #include <vtkPolyData.h>
 #include <vtkPolyDataAlgorithm.h>
 #include <vtkSetGet.h>
+#include <vtkSmartPointer.h>
 #include <vtkWeakPointer.h>
 
+// STD includes
+#include <map>
+#include <string>
+#include <vector>
+
 // Export
 #include "vtkSlicerMarkupsModuleMRMLExport.h"
 
 class vtkCallbackCommand;
+class vtkIdList;
+class vtkPoints;
 
 /// Filter that generates curves between points of an input polydata
 class VTK_SLICER_MARKUPS_MODULE_MRML_EXPORT vtkCurveMeasurementsCalculator : public vtkPolyDataAlgorithm
@@ -75,6 +84,9 @@ public:
 
 protected:
   bool CalculatePolyDataCurvature(vtkPolyData* polyData);
+  /// Calculate curvature at a point of the curve line from the point and its two neighbors.
+  /// Length is the curve length between the midpoints of the adjacent line segments, used for weighting.
+  static void CalculateCurvatureAtLinePoint(vtkPoints* points, vtkIdList* linePoints, vtkIdType idx, double& kappa, double& length);
   bool InterpolateControlPointMeasurementToPolyData(vtkPolyData* outputPolyData);
 
   /// Callback function observing data array modified events.
@@ -99,6 +111,31 @@ protected:
   /// List of observed control point arrays (for removal of observations)
   vtkCollection* ObservedControlPointArrays;
 
+  /// Curvature values from the previous execution, indexed by line point index.
+  /// Only the values around moved points are recomputed.
+  struct CurvatureCache
+    {
+    bool CurveIsClosed{false};
+    /// Point coordinates (x0, y0, z0, x1, ...)
+    std::vector<double> Points;
+    std::vector<double> Values;
+    std::vector<double> Lengths;
+    };
+  CurvatureCache Curvature;
+
+  /// Interpolated control point measurement from the previous execution.
+  /// It is reused if neither the control point values nor the pedigree IDs have changed.
+  struct InterpolatedMeasurementCache
+    {
+    vtkWeakPointer<vtkDoubleArray> ControlPointValues;
+    vtkMTimeType ControlPointValuesMTime{0};
+    vtkWeakPointer<vtkDoubleArray> PedigreeIds;
+    vtkMTimeType PedigreeIdsMTime{0};
+    vtkSmartPointer<vtkDoubleArray> InterpolatedValues;
+    };
+  /// Interpolated measurements cache, indexed by the interpolated array name
+  std::map<std::string, InterpolatedMeasurementCache> InterpolatedMeasurements;
+
 protected:
   int FillInputPortInformation(int port, vtkInformation* info) override;
   int RequestData(vtkInformation* request, vtkInformationVector** inputVector, vtkInformationVector* outputVector) override;
@@ -0,0 +1,335 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Copyright (c) Laboratory for Percutaneous Surgery (PerkLab)
+  Queen's University, Kingston, ON, Canada. All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// Markups MRML includes
+#include "vtkCurvePointLocator.h"
+
+// VTK includes
+#include <vtkMath.h>
+#include <vtkObjectFactory.h>
+#include <vtkPoints.h>
+
+// STD includes
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+/// Leaf nodes contain at most this many points
+const vtkIdType MAXIMUM_NUMBER_OF_POINTS_IN_LEAF = 8;
+}
+
+//------------------------------------------------------------------------------
+vtkStandardNewMacro(vtkCurvePointLocator);
+
+//------------------------------------------------------------------------------
+vtkCurvePointLocator::vtkCurvePointLocator() = default;
+
+//------------------------------------------------------------------------------
+vtkCurvePointLocator::~vtkCurvePointLocator() = default;
+
+//------------------------------------------------------------------------------
+void vtkCurvePointLocator::PrintSelf(std::ostream &os, vtkIndent indent)
+{
+  Superclass::PrintSelf(os, indent);
+  os << indent << "Points: " << this->Points.GetPointer() << std::endl;
+  os << indent << "Closed: " << this->Closed << std::endl;
+  os << indent << "Number of nodes: " << this->Nodes.size() << std::endl;
+}
+
+//------------------------------------------------------------------------------
+void vtkCurvePointLocator::SetPoints(vtkPoints* points)
+{
+  if (this->Points == points)
+    {
+    return;
+    }
+  this->Points = points;
+  this->Modified();
+}
+
+//------------------------------------------------------------------------------
+vtkPoints* vtkCurvePointLocator::GetPoints()
+{
+  return this->Points;
+}
+
+//------------------------------------------------------------------------------
+void vtkCurvePointLocator::BuildLocator()
+{
+  if (this->BuildTime > this->GetMTime()
+    && (!this->Points || this->BuildTime > this->Points->GetMTime()))
+    {
+    // up-to-date
+    return;
+    }
+
+  this->Nodes.clear();
+  vtkIdType numberOfPoints = (this->Points ? this->Points->GetNumberOfPoints() : 0);
+  this->PointCoordinates.resize(numberOfPoints * 3);
+  for (vtkIdType pointIndex = 0; pointIndex < numberOfPoints; ++pointIndex)
+    {
+    this->Points->GetPoint(pointIndex, &this->PointCoordinates[pointIndex * 3]);
+    }
+  if (numberOfPoints > 0)
+    {
+    this->Nodes.reserve(2 * (numberOfPoints / MAXIMUM_NUMBER_OF_POINTS_IN_LEAF + 1));
+    this->Nodes.resize(1);
+    this->BuildNode(0, 0, numberOfPoints);
+    }
+  this->BuildTime.Modified();
+}
+
+//------------------------------------------------------------------------------
+void vtkCurvePointLocator::BuildNode(int nodeIndex, vtkIdType firstPointIndex, vtkIdType lastPointIndex)
+{
+  vtkIdType numberOfPoints = static_cast<vtkIdType>(this->PointCoordinates.size() / 3);
+  if (lastPointIndex - firstPointIndex > MAXIMUM_NUMBER_OF_POINTS_IN_LEAF)
+    {
+    // Children are stored next to each other, they may be reallocated while building the subtrees
+    int firstChild = static_cast<int>(this->Nodes.size());
+    this->Nodes.resize(this->Nodes.size() + 2);
+    vtkIdType middlePointIndex = (firstPointIndex + lastPointIndex) / 2;
+    this->BuildNode(firstChild, firstPointIndex, middlePointIndex);
+    this->BuildNode(firstChild + 1, middlePointIndex, lastPointIndex);
+
+    Node& node = this->Nodes[nodeIndex];
+    node.FirstPointIndex = firstPointIndex;
+    node.LastPointIndex = lastPointIndex;
+    node.FirstChild = firstChild;
+    const double* bounds0 = this->Nodes[firstChild].Bounds;
+    const double* bounds1 = this->Nodes[firstChild + 1].Bounds;
+    for (int i = 0; i < 3; ++i)
+      {
+      node.Bounds[i * 2] = std::min(bounds0[i * 2], bounds1[i * 2]);
+      node.Bounds[i * 2 + 1] = std::max(bounds0[i * 2 + 1], bounds1[i * 2 + 1]);
+      }
+    return;
+    }
+
+  Node& node = this->Nodes[nodeIndex];
+  node.FirstPointIndex = firstPointIndex;
+  node.LastPointIndex = lastPointIndex;
+  node.FirstChild = -1;
+  node.Bounds[0] = node.Bounds[2] = node.Bounds[4] = VTK_DOUBLE_MAX;
+  node.Bounds[1] = node.Bounds[3] = node.Bounds[5] = VTK_DOUBLE_MIN;
+  // include the end point of the last line segment
+  vtkIdType lastBoundsPointIndex = std::min(lastPointIndex, numberOfPoints - 1);
+  for (vtkIdType pointIndex = firstPointIndex; pointIndex <= lastBoundsPointIndex; ++pointIndex)
+    {
+    const double* point = &this->PointCoordinates[pointIndex * 3];
+    for (int i = 0; i < 3; ++i)
+      {
+      node.Bounds[i * 2] = std::min(node.Bounds[i * 2], point[i]);
+      node.Bounds[i * 2 + 1] = std::max(node.Bounds[i * 2 + 1], point[i]);
+      }
+    }
+}
+
+//------------------------------------------------------------------------------
+double vtkCurvePointLocator::GetDistance2ToBounds(const double position[3], const double bounds[6])
+{
+  double distance2 = 0.0;
+  for (int i = 0; i < 3; ++i)
+    {
+    double distance = 0.0;
+    if (position[i] < bounds[i * 2])
+      {
+      distance = bounds[i * 2] - position[i];
+      }
+    else if (position[i] > bounds[i * 2 + 1])
+      {
+      distance = position[i] - bounds[i * 2 + 1];
+      }
+    distance2 += distance * distance;
+    }
+  return distance2;
+}
+
+//------------------------------------------------------------------------------
+double vtkCurvePointLocator::GetMaximumDistance2ToBounds(const double position[3], const double bounds[6])
+{
+  double distance2 = 0.0;
+  for (int i = 0; i < 3; ++i)
+    {
+    double distance = std::max(fabs(position[i] - bounds[i * 2]), fabs(position[i] - bounds[i * 2 + 1]));
+    distance2 += distance * distance;
+    }
+  return distance2;
+}
+
+//------------------------------------------------------------------------------
+double vtkCurvePointLocator::GetClosestPositionOnSegment(const double position[3],
+  const double* segmentStart, const double* segmentEnd, double closestPosition[3])
+{
+  double segmentVector[3] = { segmentEnd[0] - segmentStart[0], segmentEnd[1] - segmentStart[1], segmentEnd[2] - segmentStart[2] };
+  double segmentLength2 = vtkMath::Dot(segmentVector, segmentVector);
+  double t = 0.0;
+  if (segmentLength2 > 0.0)
+    {
+    double startToPosition[3] = { position[0] - segmentStart[0], position[1] - segmentStart[1], position[2] - segmentStart[2] };
+    t = std::min(std::max(vtkMath::Dot(startToPosition, segmentVector) / segmentLength2, 0.0), 1.0);
+    }
+  for (int i = 0; i < 3; ++i)
+    {
+    closestPosition[i] = segmentStart[i] + t * segmentVector[i];
+    }
+  return vtkMath::Distance2BetweenPoints(position, closestPosition);
+}
+
+//------------------------------------------------------------------------------
+vtkIdType vtkCurvePointLocator::FindClosestPoint(const double position[3])
+{
+  this->BuildLocator();
+  if (this->Nodes.empty())
+    {
+    return -1;
+    }
+
+  double closestDistance2 = VTK_DOUBLE_MAX;
+  vtkIdType closestPointIndex = -1;
+  std::vector<int> nodesToVisit(1, 0);
+  while (!nodesToVisit.empty())
+    {
+    const Node& node = this->Nodes[nodesToVisit.back()];
+    nodesToVisit.pop_back();
+    if (GetDistance2ToBounds(position, node.Bounds) > closestDistance2)
+      {
+      continue;
+      }
+    if (node.FirstChild < 0)
+      {
+      for (vtkIdType pointIndex = node.FirstPointIndex; pointIndex < node.LastPointIndex; ++pointIndex)
+        {
+        double distance2 = vtkMath::Distance2BetweenPoints(position, &this->PointCoordinates[pointIndex * 3]);
+        if (distance2 < closestDistance2)
+          {
+          closestDistance2 = distance2;
+          closestPointIndex = pointIndex;
+          }
+        }
+      continue;
+      }
+    // visit the closer child first
+    bool firstChildIsCloser = GetDistance2ToBounds(position, this->Nodes[node.FirstChild].Bounds)
+      <= GetDistance2ToBounds(position, this->Nodes[node.FirstChild + 1].Bounds);
+    nodesToVisit.push_back(firstChildIsCloser ? node.FirstChild + 1 : node.FirstChild);
+    nodesToVisit.push_back(firstChildIsCloser ? node.FirstChild : node.FirstChild + 1);
+    }
+  return closestPointIndex;
+}
+
+//------------------------------------------------------------------------------
+vtkIdType vtkCurvePointLocator::FindFarthestPoint(const double position[3])
+{
+  this->BuildLocator();
+  if (this->Nodes.empty())
+    {
+    return -1;
+    }
+
+  double farthestDistance2 = -1.0;
+  vtkIdType farthestPointIndex = -1;
+  std::vector<int> nodesToVisit(1, 0);
+  while (!nodesToVisit.empty())
+    {
+    const Node& node = this->Nodes[nodesToVisit.back()];
+    nodesToVisit.pop_back();
+    if (GetMaximumDistance2ToBounds(position, node.Bounds) < farthestDistance2)
+      {
+      continue;
+      }
+    if (node.FirstChild < 0)
+      {
+      for (vtkIdType pointIndex = node.FirstPointIndex; pointIndex < node.LastPointIndex; ++pointIndex)
+        {
+        double distance2 = vtkMath::Distance2BetweenPoints(position, &this->PointCoordinates[pointIndex * 3]);
+        // in case of equal distances, the point with lower index is returned
+        if (distance2 > farthestDistance2 || (distance2 == farthestDistance2 && pointIndex < farthestPointIndex))
+          {
+          farthestDistance2 = distance2;
+          farthestPointIndex = pointIndex;
+          }
+        }
+      continue;
+      }
+    // visit the farther child first
+    bool firstChildIsFarther = GetMaximumDistance2ToBounds(position, this->Nodes[node.FirstChild].Bounds)
+      >= GetMaximumDistance2ToBounds(position, this->Nodes[node.FirstChild + 1].Bounds);
+    nodesToVisit.push_back(firstChildIsFarther ? node.FirstChild + 1 : node.FirstChild);
+    nodesToVisit.push_back(firstChildIsFarther ? node.FirstChild : node.FirstChild + 1);
+    }
+  return farthestPointIndex;
+}
+
+//------------------------------------------------------------------------------
+vtkIdType vtkCurvePointLocator::FindClosestPositionOnCurve(const double position[3], double closestPosition[3])
+{
+  this->BuildLocator();
+  vtkIdType numberOfPoints = static_cast<vtkIdType>(this->PointCoordinates.size() / 3);
+  if (numberOfPoints < 2)
+    {
+    return -1;
+    }
+
+  double closestDistance2 = VTK_DOUBLE_MAX;
+  vtkIdType closestSegmentIndex = -1;
+  double positionOnSegment[3] = { 0.0 };
+  if (this->Closed && numberOfPoints > 2)
+    {
+    // segment from the last point to the first point is not contained in the hierarchy
+    closestDistance2 = GetClosestPositionOnSegment(position,
+      &this->PointCoordinates[(numberOfPoints - 1) * 3], &this->PointCoordinates[0], closestPosition);
+    closestSegmentIndex = numberOfPoints - 1;
+    }
+
+  std::vector<int> nodesToVisit(1, 0);
+  while (!nodesToVisit.empty())
+    {
+    const Node& node = this->Nodes[nodesToVisit.back()];
+    nodesToVisit.pop_back();
+    if (GetDistance2ToBounds(position, node.Bounds) > closestDistance2)
+      {
+      continue;
+      }
+    if (node.FirstChild < 0)
+      {
+      vtkIdType lastSegmentIndex = std::min(node.LastPointIndex, numberOfPoints - 1);
+      for (vtkIdType segmentIndex = node.FirstPointIndex; segmentIndex < lastSegmentIndex; ++segmentIndex)
+        {
+        double distance2 = GetClosestPositionOnSegment(position, &this->PointCoordinates[segmentIndex * 3],
+          &this->PointCoordinates[(segmentIndex + 1) * 3], positionOnSegment);
+        if (distance2 < closestDistance2)
+          {
+          closestDistance2 = distance2;
+          closestSegmentIndex = segmentIndex;
+          closestPosition[0] = positionOnSegment[0];
+          closestPosition[1] = positionOnSegment[1];
+          closestPosition[2] = positionOnSegment[2];
+          }
+        }
+      continue;
+      }
+    // visit the closer child first
+    bool firstChildIsCloser = GetDistance2ToBounds(position, this->Nodes[node.FirstChild].Bounds)
+      <= GetDistance2ToBounds(position, this->Nodes[node.FirstChild + 1].Bounds);
+    nodesToVisit.push_back(firstChildIsCloser ? node.FirstChild + 1 : node.FirstChild);
+    nodesToVisit.push_back(firstChildIsCloser ? node.FirstChild : node.FirstChild + 1);
+    }
+  return closestSegmentIndex;
+}
@@ -0,0 +1,110 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Copyright (c) Laboratory for Percutaneous Surgery (PerkLab)
+  Queen's University, Kingston, ON, Canada. All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#ifndef __vtkCurvePointLocator_h
+#define __vtkCurvePointLocator_h
+
+// VTK includes
+#include <vtkObject.h>
+#include <vtkSmartPointer.h>
+#include <vtkTimeStamp.h>
+
+// STD includes
+#include <vector>
+
+// export
+#include "vtkSlicerMarkupsModuleMRMLExport.h"
+
+class vtkPoints;
+
+/// \brief Locate points and positions along a curve.
+///
+/// Curve points are sorted along the curve, therefore consecutive points are close to each other.
+/// The locator builds a bounding volume hierarchy by recursively halving the range of point indices
+/// and uses it for finding the closest curve point, the closest position on the line segments
+/// of the curve, and the farthest curve point.
+///
+/// The hierarchy is built on the first query and rebuilt when the points are modified.
+class VTK_SLICER_MARKUPS_MODULE_MRML_EXPORT vtkCurvePointLocator : public vtkObject
+{
+public:
+  static vtkCurvePointLocator* New();
+  vtkTypeMacro(vtkCurvePointLocator, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  /// Curve points
+  void SetPoints(vtkPoints* points);
+  vtkPoints* GetPoints();
+
+  /// If enabled then the curve has a line segment from the last point to the first point.
+  vtkSetMacro(Closed, bool);
+  vtkGetMacro(Closed, bool);
+  vtkBooleanMacro(Closed, bool);
+
+  /// Build the hierarchy if the points have been modified since the last build.
+  /// It is called automatically by the find methods.
+  void BuildLocator();
+
+  /// Get index of the closest curve point. Returns -1 if there are no points.
+  vtkIdType FindClosestPoint(const double position[3]);
+
+  /// Get index of the farthest curve point. Returns -1 if there are no points.
+  vtkIdType FindFarthestPoint(const double position[3]);
+
+  /// Get the closest position on the line segments of the curve.
+  /// Returns index of the found line segment (index of its first point), -1 if there are less than two points.
+  vtkIdType FindClosestPositionOnCurve(const double position[3], double closestPosition[3]);
+
+protected:
+  vtkCurvePointLocator();
+  ~vtkCurvePointLocator() override;
+
+  /// Node of the hierarchy, containing curve points of index range [FirstPointIndex, LastPointIndex).
+  /// Bounds also include the point at LastPointIndex (if it exists), so that they contain
+  /// all the line segments that start at the node's points.
+  struct Node
+    {
+    double Bounds[6];
+    vtkIdType FirstPointIndex;
+    vtkIdType LastPointIndex;
+    /// Index of the first child node, the second child follows it. -1 for leaf nodes.
+    int FirstChild;
+    };
+
+  /// Fill the node at nodeIndex and create its children recursively
+  void BuildNode(int nodeIndex, vtkIdType firstPointIndex, vtkIdType lastPointIndex);
+  static double GetDistance2ToBounds(const double position[3], const double bounds[6]);
+  static double GetMaximumDistance2ToBounds(const double position[3], const double bounds[6]);
+  /// Compute closest position on line segment, returns squared distance
+  static double GetClosestPositionOnSegment(const double position[3],
+    const double* segmentStart, const double* segmentEnd, double closestPosition[3]);
+
+  vtkSmartPointer<vtkPoints> Points;
+  bool Closed{false};
+
+  /// Point coordinates (x0, y0, z0, x1, ...)
+  std::vector<double> PointCoordinates;
+  std::vector<Node> Nodes;
+  vtkTimeStamp BuildTime;
+
+private:
+  vtkCurvePointLocator(const vtkCurvePointLocator&) = delete;
+  void operator=(const vtkCurvePointLocator&) = delete;
+};
+
+#endif
@@ -20,6 +20,7 @@
 // MRML includes
 #include "vtkCurveGenerator.h"
 #include "vtkCurveMeasurementsCalculator.h"
+#include "vtkCurvePointLocator.h"
 #include "vtkMRMLMarkupsDisplayNode.h"
 #include "vtkMRMLMeasurementLength.h"
 #include "vtkMRMLMeasurementConstant.h"
@@ -41,7 +42,6 @@
 #include <vtkFrenetSerretFrame.h>
 #include <vtkGeneralTransform.h>
 #include <vtkGenericCell.h>
-#include <vtkLine.h>
 #include <vtkMatrix4x4.h>
 #include <vtkNew.h>
 #include <vtkOBBTree.h>
@@ -110,6 +110,8 @@ vtkMRMLMarkupsCurveNode::vtkMRMLMarkupsCurveNode()
 
   this->CurvePolyToWorldTransformer->SetInputConnection(this->CurveMeasurementsCalculator->GetOutputPort());
 
+  this->CurvePointLocatorWorld = vtkSmartPointer<vtkCurvePointLocator>::New();
+
   this->ShortestDistanceSurfaceActiveScalar = "";
 
   // Setup measurements calculated for this markup type
@@ -821,8 +823,8 @@ vtkIdType vtkMRMLMarkupsCurveNode::GetClosestCurvePointIndexToPositionWorld(cons
     {
     return -1;
     }
-  this->TransformedCurvePolyLocator->Update(); // or ->BuildLocator()?
-  return this->TransformedCurvePolyLocator->FindClosestPoint(posWorld);
+  this->CurvePointLocatorWorld->SetPoints(points);
+  return this->CurvePointLocatorWorld->FindClosestPoint(posWorld);
 }
 
 //---------------------------------------------------------------------------
@@ -893,30 +895,10 @@ vtkIdType vtkMRMLMarkupsCurveNode::GetFarthestCurvePointIndexToPositionWorld(con
   vtkPoints* points = this->GetCurvePointsWorld();
   if (!points || points->GetNumberOfPoints()<1)
     {
-    return false;
-    }
-
-  double farthestPoint[3] = { 0.0 };
-  points->GetPoint(0, farthestPoint);
-  double farthestPointDistance2 = vtkMath::Distance2BetweenPoints(posWorld, farthestPoint);
-  vtkIdType farthestPointId = 0;
-
-  vtkIdType numberOfPoints = points->GetNumberOfPoints();
-  for (vtkIdType pointIndex = 1; pointIndex < numberOfPoints; pointIndex++)
-    {
-    double* nextPoint = points->GetPoint(pointIndex);
-    double nextPointDistance2 = vtkMath::Distance2BetweenPoints(posWorld, nextPoint);
-    if (nextPointDistance2 > farthestPointDistance2)
-      {
-      farthestPoint[0] = nextPoint[0];
-      farthestPoint[1] = nextPoint[1];
-      farthestPoint[2] = nextPoint[2];
-      farthestPointDistance2 = nextPointDistance2;
-      farthestPointId = pointIndex;
-      }
+    return -1;
     }
-
-  return farthestPointId;
+  this->CurvePointLocatorWorld->SetPoints(points);
+  return this->CurvePointLocatorWorld->FindFarthestPoint(posWorld);
 }
 
 //---------------------------------------------------------------------------
@@ -1111,51 +1093,9 @@ vtkIdType vtkMRMLMarkupsCurveNode::GetClosestPointPositionAlongCurveWorld(const
     return -1;
     }
 
-  // Find closest curve point
-  vtkIdType closestCurvePointIndex = this->GetClosestCurvePointIndexToPositionWorld(posWorld);
-  if (closestCurvePointIndex < 0)
-    {
-    return -1;
-    }
-  double closestCurvePoint[3] = { 0.0 };
-  points->GetPoint(closestCurvePointIndex, closestCurvePoint);
-  double closestDistance2 = vtkMath::Distance2BetweenPoints(posWorld, closestPosWorld);
-  closestPosWorld[0] = closestCurvePoint[0];
-  closestPosWorld[1] = closestCurvePoint[1];
-  closestPosWorld[2] = closestCurvePoint[2];
-  vtkIdType lineIndex = closestCurvePointIndex;
-
-  // See if we can find any points closer along the curve
-  double relativePositionAlongLine = -1.0; // between 0.0-1.0 if between the endpoints of the line segment
-  double otherPoint[3] = { 0.0 };
-  double closestPointOnLine[3] = { 0.0 };
-  if (closestCurvePointIndex - 1 >= 0)
-    {
-    points->GetPoint(closestCurvePointIndex - 1, otherPoint);
-    double distance2 = vtkLine::DistanceToLine(posWorld, closestCurvePoint, otherPoint, relativePositionAlongLine, closestPointOnLine);
-    if (distance2 < closestDistance2 && relativePositionAlongLine >= 0 && relativePositionAlongLine <= 1)
-      {
-      closestDistance2 = distance2;
-      closestPosWorld[0] = closestPointOnLine[0];
-      closestPosWorld[1] = closestPointOnLine[1];
-      closestPosWorld[2] = closestPointOnLine[2];
-      lineIndex = closestCurvePointIndex - 1;
-      }
-    }
-  if (closestCurvePointIndex + 1 < points->GetNumberOfPoints())
-    {
-    points->GetPoint(closestCurvePointIndex + 1, otherPoint);
-    double distance2 = vtkLine::DistanceToLine(posWorld, closestCurvePoint, otherPoint, relativePositionAlongLine, closestPointOnLine);
-    if (distance2 < closestDistance2 && relativePositionAlongLine >= 0 && relativePositionAlongLine <= 1)
-      {
-      closestDistance2 = distance2;
-      closestPosWorld[0] = closestPointOnLine[0];
-      closestPosWorld[1] = closestPointOnLine[1];
-      closestPosWorld[2] = closestPointOnLine[2];
-      lineIndex = closestCurvePointIndex;
-      }
-    }
-  return lineIndex;
+  this->CurvePointLocatorWorld->SetPoints(points);
+  this->CurvePointLocatorWorld->SetClosed(this->CurveClosed);
+  return this->CurvePointLocatorWorld->FindClosestPositionOnCurve(posWorld, closestPosWorld);
 }
 
 //---------------------------------------------------------------------------
@@ -38,6 +38,7 @@ class vtkAssignAttribute;
 class vtkCallbackCommand;
 class vtkCleanPolyData;
 class vtkCurveMeasurementsCalculator;
+class vtkCurvePointLocator;
 class vtkPassThroughFilter;
 class vtkPlane;
 class vtkTransformPolyDataFilter;
@@ -274,6 +275,9 @@ protected:
   vtkSmartPointer<vtkArrayCalculator> SurfaceScalarCalculator;
   vtkSmartPointer<vtkPassThroughFilter> SurfaceScalarPassThroughFilter;
   vtkSmartPointer<vtkCurveMeasurementsCalculator> CurveMeasurementsCalculator;
+  /// Locator for finding closest and farthest curve points in world coordinate system.
+  /// Built on the first query after the curve is modified.
+  vtkSmartPointer<vtkCurvePointLocator> CurvePointLocatorWorld;
   const char* ShortestDistanceSurfaceActiveScalar;
 
   /// Filter that changes the active scalar of the input mesh using the ActiveScalarName
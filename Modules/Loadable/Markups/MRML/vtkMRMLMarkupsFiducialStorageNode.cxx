@@ -515,6 +515,9 @@ int vtkMRMLMarkupsFiducialStorageNode::ReadDataInternal(vtkMRMLNode *refNode)
 
   if (fstr.is_open())
     {
+    // invoke point events and update measurements once after all points are read
+    int wasPointModifying = markupsNode->StartPointModify();
+
     if (markupsNode->GetNumberOfControlPoints() > 0)
       {
       // clear out the list
@@ -673,6 +676,7 @@ int vtkMRMLMarkupsFiducialStorageNode::ReadDataInternal(vtkMRMLNode *refNode)
         }
       }
     fstr.close();
+    markupsNode->EndPointModify(wasPointModifying);
     }
   else
     {
@@ -462,7 +462,11 @@ bool vtkMRMLMarkupsJsonStorageNode::vtkInternal::UpdateMarkupsNodeFromJsonValue(
 
   if (markupObject.HasMember("controlPoints"))
     {
-    if (!this->ReadControlPoints(markupObject["controlPoints"], coordinateSystem, markupsNode))
+    // invoke point events and update measurements once after all points are read
+    int wasPointModifying = markupsNode->StartPointModify();
+    bool success = this->ReadControlPoints(markupObject["controlPoints"], coordinateSystem, markupsNode);
+    markupsNode->EndPointModify(wasPointModifying);
+    if (!success)
       {
       vtkErrorWithObjectMacro(this->External, "vtkMRMLMarkupsJsonStorageNode::vtkInternal::UpdateMarkupsNodeFromJsonDocument failed:"
         << " invalid controlPoints item");
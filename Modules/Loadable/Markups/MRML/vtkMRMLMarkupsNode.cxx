@@ -70,6 +70,8 @@ vtkMRMLMarkupsNode::vtkMRMLMarkupsNode()
 
   this->CurveInputPoly = vtkSmartPointer<vtkPolyData>::New();
   vtkNew<vtkPoints> curveInputPoints;
+  // same precision as control point positions, so that they can be accessed directly
+  curveInputPoints->SetDataTypeToDouble();
   this->CurveInputPoly->SetPoints(curveInputPoints);
 
   this->CurveGenerator = vtkSmartPointer<vtkCurveGenerator>::New();
@@ -207,6 +209,7 @@ void vtkMRMLMarkupsNode::CopyContent(vtkMRMLNode* anode, bool deepCopy/*=true*/)
     }
 
   this->CurveInputPoly->GetPoints()->Reset();
+  int wasPointModifying = this->StartPointModify();
   this->RemoveAllControlPoints();
   int numMarkups = node->GetNumberOfControlPoints();
   for (int n = 0; n < numMarkups; n++)
@@ -216,6 +219,7 @@ void vtkMRMLMarkupsNode::CopyContent(vtkMRMLNode* anode, bool deepCopy/*=true*/)
     (*controlPointCopy) = (*controlPoint);
     this->AddControlPoint(controlPointCopy, false);
     }
+  this->EndPointModify(wasPointModifying);
 }
 
 //---------------------------------------------------------------------------
@@ -343,7 +347,10 @@ void vtkMRMLMarkupsNode::RemoveAllControlPoints()
   this->CurveInputPoly->GetPoints()->Reset();
   this->CurveInputPoly->GetPoints()->Squeeze();
 
-  this->UpdateInteractionHandleToWorldMatrix();
+  if (this->PointModifyDepth == 0)
+    {
+    this->UpdateInteractionHandleToWorldMatrix();
+    }
 
   this->InvokeCustomModifiedEvent(vtkMRMLMarkupsNode::PointRemovedEvent);
   if (definedPointsExisted)
@@ -504,7 +511,10 @@ int vtkMRMLMarkupsNode::AddControlPoint(ControlPoint *controlPoint, bool autoLab
   this->CurveInputPoly->GetPoints()->InsertNextPoint(controlPoint->Position);
   this->CurveInputPoly->GetPoints()->Modified();
 
-  this->UpdateInteractionHandleToWorldMatrix();
+  if (this->PointModifyDepth == 0)
+    {
+    this->UpdateInteractionHandleToWorldMatrix();
+    }
 
   int controlPointIndex = this->GetNumberOfControlPoints() - 1;
   this->InvokeCustomModifiedEvent(vtkMRMLMarkupsNode::PointAddedEvent,  static_cast<void*>(&controlPointIndex));
@@ -647,7 +657,10 @@ void vtkMRMLMarkupsNode::RemoveNthControlPoint(int pointIndex)
   this->ControlPoints.erase(this->ControlPoints.begin() + pointIndex);
 
   this->UpdateCurvePolyFromControlPoints();
-  this->UpdateInteractionHandleToWorldMatrix();
+  if (this->PointModifyDepth == 0)
+    {
+    this->UpdateInteractionHandleToWorldMatrix();
+    }
 
   if (positionWasDefined)
     {
@@ -690,7 +703,10 @@ bool vtkMRMLMarkupsNode::InsertControlPoint(ControlPoint *controlPoint, int targ
   std::vector < ControlPoint* >::iterator result = this->ControlPoints.insert(pos, controlPoint);
 
   this->UpdateCurvePolyFromControlPoints();
-  this->UpdateInteractionHandleToWorldMatrix();
+  if (this->PointModifyDepth == 0)
+    {
+    this->UpdateInteractionHandleToWorldMatrix();
+    }
 
   // let observers know that a markup was added
   this->InvokeCustomModifiedEvent(vtkMRMLMarkupsNode::PointAddedEvent, static_cast<void*>(&targetIndex));
@@ -756,7 +772,10 @@ void vtkMRMLMarkupsNode::SwapControlPoints(int m1, int m2)
   *controlPoint2 = controlPoint1Backup;
 
   this->UpdateCurvePolyFromControlPoints();
-  this->UpdateInteractionHandleToWorldMatrix();
+  if (this->PointModifyDepth == 0)
+    {
+    this->UpdateInteractionHandleToWorldMatrix();
+    }
 
   // and let listeners know that two control points have changed
   this->InvokeCustomModifiedEvent(vtkMRMLMarkupsNode::PointModifiedEvent, static_cast<void*>(&m1));
@@ -807,7 +826,10 @@ void vtkMRMLMarkupsNode::SetNthControlPointPosition(const int pointIndex,
   points->SetPoint(pointIndex, x, y, z);
   points->Modified();
 
-  this->UpdateInteractionHandleToWorldMatrix();
+  if (this->PointModifyDepth == 0)
+    {
+    this->UpdateInteractionHandleToWorldMatrix();
+    }
 
   // throw an event to let listeners know the position has changed
   int n = pointIndex;
@@ -824,7 +846,7 @@ void vtkMRMLMarkupsNode::SetNthControlPointPosition(const int pointIndex,
 
   this->UpdateMeasurements();
 
-  if (this->GetDisplayNode())
+  if (this->PointModifyDepth == 0 && this->GetDisplayNode())
     {
     this->GetDisplayNode()->UpdateScalarRange();
     }
@@ -887,7 +909,10 @@ void vtkMRMLMarkupsNode::SetNthControlPointPositionOrientationWorldFromArray(
   points->SetPoint(pointIndex, controlPoint->Position);
   points->Modified();
 
-  this->UpdateInteractionHandleToWorldMatrix();
+  if (this->PointModifyDepth == 0)
+    {
+    this->UpdateInteractionHandleToWorldMatrix();
+    }
 
   // throw an event to let listeners know the position has changed
   int n = pointIndex;
@@ -1820,7 +1845,191 @@ void vtkMRMLMarkupsNode::GetControlPointLabels(vtkStringArray* labels)
 }
 
 //---------------------------------------------------------------------------
-void vtkMRMLMarkupsNode::SetControlPointPositionsWorld(vtkPoints* points)
+int vtkMRMLMarkupsNode::StartPointModify()
+{
+  int wasModifying = this->StartModify();
+  if (this->PointModifyDepth == 0)
+    {
+    this->ModifiedPointRange[0] = VTK_INT_MAX;
+    this->ModifiedPointRange[1] = -1;
+    this->ModifiedPointRangeValid = false;
+    }
+  this->PointModifyDepth++;
+  return wasModifying;
+}
+
+//---------------------------------------------------------------------------
+void vtkMRMLMarkupsNode::EndPointModify(int wasModifying)
+{
+  if (this->PointModifyDepth <= 0)
+    {
+    vtkErrorMacro("EndPointModify: StartPointModify was not called");
+    return;
+    }
+  this->PointModifyDepth--;
+  if (this->PointModifyDepth == 0)
+    {
+    this->UpdateInteractionHandleToWorldMatrix();
+    this->UpdateMeasurements();
+    if (this->GetDisplayNode())
+      {
+      this->GetDisplayNode()->UpdateScalarRange();
+      }
+    }
+  this->EndModify(wasModifying);
+
+  if (this->PointModifyDepth == 0 && this->ModifiedPointRangeValid)
+    {
+    this->ModifiedPointRangeValid = false;
+    int modifiedPointRange[2] =
+      {
+      this->ModifiedPointRange[0],
+      std::min(this->ModifiedPointRange[1], this->GetNumberOfControlPoints() - 1)
+      };
+    this->InvokeCustomModifiedEvent(vtkMRMLMarkupsNode::PointsModifiedEvent, static_cast<void*>(modifiedPointRange));
+    }
+}
+
+//---------------------------------------------------------------------------
+void vtkMRMLMarkupsNode::InvokeCustomModifiedEvent(int eventId, void* callData/*=nullptr*/)
+{
+  if (this->PointModifyDepth > 0)
+    {
+    switch (eventId)
+      {
+      case vtkMRMLMarkupsNode::PointAddedEvent:
+      case vtkMRMLMarkupsNode::PointRemovedEvent:
+      case vtkMRMLMarkupsNode::PointModifiedEvent:
+      case vtkMRMLMarkupsNode::PointPositionDefinedEvent:
+      case vtkMRMLMarkupsNode::PointPositionUndefinedEvent:
+        {
+        // Keep track of the range of affected points for PointsModifiedEvent.
+        // Adding or removing a point shifts all the following points.
+        int pointIndex = (callData ? *static_cast<int*>(callData) : -1);
+        bool shiftsPoints = (eventId == vtkMRMLMarkupsNode::PointAddedEvent || eventId == vtkMRMLMarkupsNode::PointRemovedEvent);
+        if (pointIndex < 0)
+          {
+          this->ModifiedPointRange[0] = 0;
+          this->ModifiedPointRange[1] = VTK_INT_MAX;
+          }
+        else
+          {
+          this->ModifiedPointRange[0] = std::min(this->ModifiedPointRange[0], pointIndex);
+          this->ModifiedPointRange[1] = std::max(this->ModifiedPointRange[1], shiftsPoints ? VTK_INT_MAX : pointIndex);
+          }
+        this->ModifiedPointRangeValid = true;
+        break;
+        }
+      default:
+        break;
+      }
+    }
+  this->Superclass::InvokeCustomModifiedEvent(eventId, callData);
+}
+
+//---------------------------------------------------------------------------
+void vtkMRMLMarkupsNode::TransformControlPointPositions(vtkPoints* inputPoints, vtkPoints* outputPoints, bool toWorld)
+{
+  vtkMRMLTransformNode* transformNode = this->GetParentTransformNode();
+  if (!transformNode)
+    {
+    if (outputPoints != inputPoints)
+      {
+      outputPoints->DeepCopy(inputPoints);
+      }
+    return;
+    }
+  vtkNew<vtkGeneralTransform> transform;
+  if (toWorld)
+    {
+    transformNode->GetTransformToWorld(transform);
+    }
+  else
+    {
+    transformNode->GetTransformFromWorld(transform);
+    }
+  vtkMRMLTransformNode::TransformPoints(transform, inputPoints, outputPoints);
+}
+
+//---------------------------------------------------------------------------
+int vtkMRMLMarkupsNode::AddControlPoints(vtkPoints* points, vtkStringArray* labels/*=nullptr*/)
+{
+  if (!points)
+    {
+    vtkErrorMacro("AddControlPoints: invalid points");
+    return -1;
+    }
+  vtkIdType numberOfPoints = points->GetNumberOfPoints();
+  if (labels && labels->GetNumberOfValues() != numberOfPoints)
+    {
+    vtkErrorMacro("AddControlPoints: number of labels (" << labels->GetNumberOfValues()
+      << ") does not match number of points (" << numberOfPoints << ")");
+    return -1;
+    }
+  if (this->MaximumNumberOfControlPoints != 0
+    && this->GetNumberOfControlPoints() + numberOfPoints > this->MaximumNumberOfControlPoints)
+    {
+    vtkErrorMacro("AddControlPoints: number of existing points (" << this->GetNumberOfControlPoints()
+      << ") plus requested number of new points (" << numberOfPoints << ") are more than maximum number of control points allowed ("
+      << this->MaximumNumberOfControlPoints << ")");
+    return -1;
+    }
+  int firstControlPointIndex = this->GetNumberOfControlPoints();
+  if (numberOfPoints == 0)
+    {
+    return firstControlPointIndex;
+    }
+
+  int wasModifying = this->StartPointModify();
+
+  this->ControlPoints.reserve(this->ControlPoints.size() + numberOfPoints);
+  vtkPoints* curvePoints = this->CurveInputPoly->GetPoints();
+  curvePoints->Resize(firstControlPointIndex + numberOfPoints);
+  for (vtkIdType pointIndex = 0; pointIndex < numberOfPoints; pointIndex++)
+    {
+    ControlPoint* controlPoint = new ControlPoint;
+    points->GetPoint(pointIndex, controlPoint->Position);
+    controlPoint->PositionStatus = PositionDefined;
+    controlPoint->ID = this->GenerateUniqueControlPointID();
+    if (labels)
+      {
+      controlPoint->Label = labels->GetValue(pointIndex);
+      }
+    if (controlPoint->Label.empty())
+      {
+      controlPoint->Label = this->GenerateControlPointLabel(this->LastUsedControlPointNumber);
+      }
+    this->ControlPoints.push_back(controlPoint);
+    curvePoints->InsertNextPoint(controlPoint->Position);
+    }
+  curvePoints->Modified();
+
+  // Events are compressed until EndPointModify, therefore they are invoked only once, with nullptr call data
+  this->InvokeCustomModifiedEvent(vtkMRMLMarkupsNode::PointAddedEvent);
+  this->InvokeCustomModifiedEvent(vtkMRMLMarkupsNode::PointModifiedEvent);
+  this->InvokeCustomModifiedEvent(vtkMRMLMarkupsNode::PointPositionDefinedEvent);
+  this->StorableModifiedTime.Modified();
+
+  this->EndPointModify(wasModifying);
+  return firstControlPointIndex;
+}
+
+//---------------------------------------------------------------------------
+int vtkMRMLMarkupsNode::AddControlPointsWorld(vtkPoints* points, vtkStringArray* labels/*=nullptr*/)
+{
+  if (!points)
+    {
+    vtkErrorMacro("AddControlPointsWorld: invalid points");
+    return -1;
+    }
+  vtkNew<vtkPoints> pointsLocal;
+  pointsLocal->SetDataTypeToDouble();
+  this->TransformControlPointPositions(points, pointsLocal, false);
+  return this->AddControlPoints(pointsLocal, labels);
+}
+
+//---------------------------------------------------------------------------
+void vtkMRMLMarkupsNode::SetControlPointPositions(vtkPoints* points)
 {
   if (!points)
     {
@@ -1828,36 +2037,91 @@ void vtkMRMLMarkupsNode::SetControlPointPositionsWorld(vtkPoints* points)
     return;
     }
 
-  int wasModified = this->StartModify();
-  this->IsUpdatingPoints = true;
+  int wasModifying = this->StartPointModify();
 
   vtkIdType numberOfPoints = points->GetNumberOfPoints();
-  for (vtkIdType pointIndex = 0; pointIndex < numberOfPoints; pointIndex++)
+  int numberOfExistingPoints = this->GetNumberOfControlPoints();
+
+  // Update existing points
+  vtkIdType numberOfUpdatedPoints = std::min(numberOfPoints, static_cast<vtkIdType>(numberOfExistingPoints));
+  bool positionDefined = false;
+  bool positionUndefined = false;
+  vtkPoints* curvePoints = this->CurveInputPoly->GetPoints();
+  for (vtkIdType pointIndex = 0; pointIndex < numberOfUpdatedPoints; pointIndex++)
+    {
+    ControlPoint* controlPoint = this->ControlPoints[pointIndex];
+    points->GetPoint(pointIndex, controlPoint->Position);
+    if (controlPoint->PositionStatus != PositionDefined)
+      {
+      controlPoint->PositionStatus = PositionDefined;
+      positionDefined = true;
+      }
+    curvePoints->SetPoint(pointIndex, controlPoint->Position);
+    }
+  if (numberOfUpdatedPoints > 0)
     {
-    double* posWorld = points->GetPoint(pointIndex);
-    if (pointIndex < this->GetNumberOfControlPoints())
+    curvePoints->Modified();
+    this->InvokeCustomModifiedEvent(vtkMRMLMarkupsNode::PointModifiedEvent);
+    if (positionDefined)
       {
-      // point already exists, just update it
-      this->SetNthControlPointPositionWorldFromArray(pointIndex, posWorld);
+      this->InvokeCustomModifiedEvent(vtkMRMLMarkupsNode::PointPositionDefinedEvent);
       }
-    else
+    this->StorableModifiedTime.Modified();
+    }
+
+  if (numberOfPoints > numberOfExistingPoints)
+    {
+    // Add new points
+    vtkNew<vtkPoints> newPoints;
+    newPoints->SetDataTypeToDouble();
+    newPoints->SetNumberOfPoints(numberOfPoints - numberOfExistingPoints);
+    for (vtkIdType pointIndex = numberOfExistingPoints; pointIndex < numberOfPoints; pointIndex++)
       {
-      // need to add a new point
-      vtkMRMLMarkupsNode::AddControlPointWorld(vtkVector3d(posWorld));
+      newPoints->SetPoint(pointIndex - numberOfExistingPoints, points->GetPoint(pointIndex));
       }
+    this->AddControlPoints(newPoints);
     }
-  while (this->GetNumberOfControlPoints() > numberOfPoints)
+  else if (numberOfPoints < numberOfExistingPoints)
     {
-    this->RemoveNthControlPoint(this->GetNumberOfControlPoints() - 1);
+    // Remove extra points
+    for (int pointIndex = static_cast<int>(numberOfPoints); pointIndex < numberOfExistingPoints; pointIndex++)
+      {
+      if (this->ControlPoints[pointIndex]->PositionStatus == PositionDefined)
+        {
+        positionUndefined = true;
+        }
+      delete this->ControlPoints[pointIndex];
+      }
+    this->ControlPoints.resize(numberOfPoints);
+    curvePoints->SetNumberOfPoints(numberOfPoints);
+    curvePoints->Modified();
+    this->InvokeCustomModifiedEvent(vtkMRMLMarkupsNode::PointRemovedEvent);
+    if (positionUndefined)
+      {
+      this->InvokeCustomModifiedEvent(vtkMRMLMarkupsNode::PointPositionUndefinedEvent);
+      }
+    this->StorableModifiedTime.Modified();
     }
 
-  this->IsUpdatingPoints = false;
-  this->UpdateMeasurements();
-  this->EndModify(wasModified);
+  this->EndPointModify(wasModifying);
 }
 
 //---------------------------------------------------------------------------
-void vtkMRMLMarkupsNode::GetControlPointPositionsWorld(vtkPoints* points)
+void vtkMRMLMarkupsNode::SetControlPointPositionsWorld(vtkPoints* points)
+{
+  if (!points)
+    {
+    this->RemoveAllControlPoints();
+    return;
+    }
+  vtkNew<vtkPoints> pointsLocal;
+  pointsLocal->SetDataTypeToDouble();
+  this->TransformControlPointPositions(points, pointsLocal, false);
+  this->SetControlPointPositions(pointsLocal);
+}
+
+//---------------------------------------------------------------------------
+void vtkMRMLMarkupsNode::GetControlPointPositions(vtkPoints* points)
 {
   if (!points)
     {
@@ -1865,12 +2129,67 @@ void vtkMRMLMarkupsNode::GetControlPointPositionsWorld(vtkPoints* points)
     }
   int numberOfControlPoints = this->GetNumberOfControlPoints();
   points->SetNumberOfPoints(numberOfControlPoints);
-  double posWorld[3] = { 0.0 };
   for (int controlPointIndex = 0; controlPointIndex < numberOfControlPoints; controlPointIndex++)
     {
-    this->GetNthControlPointPositionWorld(controlPointIndex, posWorld);
-    points->SetPoint(controlPointIndex, posWorld);
+    points->SetPoint(controlPointIndex, this->ControlPoints[controlPointIndex]->Position);
+    }
+}
+
+//---------------------------------------------------------------------------
+void vtkMRMLMarkupsNode::GetControlPointPositionsWorld(vtkPoints* points)
+{
+  if (!points)
+    {
+    return;
+    }
+  // Transform all points at once instead of getting the transform for each point
+  this->GetControlPointPositions(points);
+  this->TransformControlPointPositions(points, points, true);
+}
+
+//---------------------------------------------------------------------------
+vtkPoints* vtkMRMLMarkupsNode::GetControlPointPositionsArray()
+{
+  return this->CurveInputPoly->GetPoints();
+}
+
+//---------------------------------------------------------------------------
+void vtkMRMLMarkupsNode::ControlPointPositionsArrayModified()
+{
+  vtkPoints* curvePoints = this->CurveInputPoly->GetPoints();
+  int numberOfControlPoints = this->GetNumberOfControlPoints();
+  if (curvePoints->GetNumberOfPoints() != numberOfControlPoints)
+    {
+    vtkErrorMacro("ControlPointPositionsArrayModified: number of points in the array (" << curvePoints->GetNumberOfPoints()
+      << ") does not match number of control points (" << numberOfControlPoints << ")");
+    this->UpdateCurvePolyFromControlPoints();
+    return;
+    }
+  if (numberOfControlPoints == 0)
+    {
+    return;
+    }
+
+  int wasModifying = this->StartPointModify();
+  bool positionDefined = false;
+  for (int pointIndex = 0; pointIndex < numberOfControlPoints; pointIndex++)
+    {
+    ControlPoint* controlPoint = this->ControlPoints[pointIndex];
+    curvePoints->GetPoint(pointIndex, controlPoint->Position);
+    if (controlPoint->PositionStatus != PositionDefined)
+      {
+      controlPoint->PositionStatus = PositionDefined;
+      positionDefined = true;
+      }
     }
+  curvePoints->Modified();
+  this->InvokeCustomModifiedEvent(vtkMRMLMarkupsNode::PointModifiedEvent);
+  if (positionDefined)
+    {
+    this->InvokeCustomModifiedEvent(vtkMRMLMarkupsNode::PointPositionDefinedEvent);
+    }
+  this->StorableModifiedTime.Modified();
+  this->EndPointModify(wasModifying);
 }
 
 //---------------------------------------------------------------------------
@@ -2046,7 +2365,7 @@ void vtkMRMLMarkupsNode::ClearValueForAllMeasurements()
 //---------------------------------------------------------------------------
 void vtkMRMLMarkupsNode::UpdateMeasurements()
 {
-  if (this->IsUpdatingPoints)
+  if (this->PointModifyDepth > 0)
     {
     return;
     }
@@ -2161,16 +2480,14 @@ void vtkMRMLMarkupsNode::UpdateInteractionHandleToWorldMatrix()
   double origin_World[3] = { 0 };
   int numberOfControlPoints = this->GetNumberOfMarkups();
   vtkNew<vtkPoints> controlPoints_World;
+  controlPoints_World->SetDataTypeToDouble();
+  this->GetControlPointPositionsWorld(controlPoints_World);
   for (int i = 0; i < numberOfControlPoints; ++i)
     {
-    double controlPointPosition_World[3] = { 0.0 };
-    this->GetNthControlPointPositionWorld(i, controlPointPosition_World);
-
+    double* controlPointPosition_World = controlPoints_World->GetPoint(i);
     origin_World[0] += controlPointPosition_World[0] / numberOfControlPoints;
     origin_World[1] += controlPointPosition_World[1] / numberOfControlPoints;
     origin_World[2] += controlPointPosition_World[2] / numberOfControlPoints;
-
-    controlPoints_World->InsertNextPoint(controlPointPosition_World);
     }
 
   for (int i = 0; i < 3; ++i)
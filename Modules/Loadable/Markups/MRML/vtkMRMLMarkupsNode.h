@@ -209,9 +209,15 @@ public:
   /// - PointStartInteractionEvent when starting interacting with a control point.
   /// - PointEndInteractionEvent when an interaction with a control point process finishes.
   /// - CenterPointModifiedEvent when position of the centerpoint is changed (displayed for example for closed curves)
+  /// - PointsModifiedEvent: control points were added/removed/modified between StartPointModify and EndPointModify.
+  ///   Invoked once, after all the compressed Point* events.
   ///
   /// Event data for Point* events: Event callData is control point index address (int*). If the pointer is nullptr
   /// then one or more points are added/removed/modified.
+  /// Event data for PointsModifiedEvent: Event callData is the address of an int[2] array containing the index of
+  /// the first and last affected control point. If points were added or removed then the range extends to the last
+  /// control point (and it is empty if only the last points were removed). If the pointer is nullptr then the range
+  /// is not known (event was invoked within StartModify/EndModify).
   ///
   /// Note: the current active node (control point or line) information are stored in the display node.
   ///
@@ -227,6 +233,7 @@ public:
     PointStartInteractionEvent,
     PointEndInteractionEvent,
     CenterPointModifiedEvent,
+    PointsModifiedEvent,
   };
 
   /// Placement status of a control point.
@@ -579,16 +586,61 @@ public:
   /// Get the index of the closest control point to the world coordinates
   int GetClosestControlPointIndexToPositionWorld(double pos[3]);
 
-  /// Set all control point positions from a point list.
+  /// Add control points at the positions specified in a point list, in local coordinate system.
+  /// If labels is specified then it must contain one label for each point,
+  /// empty labels are generated automatically.
+  /// All points are added in one batch: PointAddedEvent, PointModifiedEvent,
+  /// and PointPositionDefinedEvent are invoked once, with nullptr call data,
+  /// and measurements are updated once after all points are added.
+  /// Returns the index of the first added control point, -1 on failure.
+  int AddControlPoints(vtkPoints* points, vtkStringArray* labels = nullptr);
+
+  /// Add control points at the positions specified in a point list, in world coordinate system.
+  /// \sa AddControlPoints
+  int AddControlPointsWorld(vtkPoints* points, vtkStringArray* labels = nullptr);
+
+  /// Set all control point positions from a point list, in local coordinate system.
   /// If points is nullptr then all control points are removed.
   /// New control points are added if needed.
   /// Existing control points are updated with the new positions.
   /// Any extra existing control points are removed.
+  /// Events are invoked once for all points, with nullptr call data.
+  void SetControlPointPositions(vtkPoints* points);
+
+  /// Set all control point positions from a point list, in world coordinate system.
+  /// \sa SetControlPointPositions
   void SetControlPointPositionsWorld(vtkPoints* points);
 
+  /// Get a copy of all control point positions in local coordinate system
+  void GetControlPointPositions(vtkPoints* points);
+
   /// Get a copy of all control point positions in world coordinate system
   void GetControlPointPositionsWorld(vtkPoints* points);
 
+  /// Get all control point positions in local coordinate system, without copying.
+  /// Positions are stored contiguously as doubles, therefore they can be accessed and
+  /// modified in place (for example as a numpy array in Python).
+  /// After all modifications are completed, call ControlPointPositionsArrayModified.
+  /// The number of points must not be changed, use SetControlPointPositions to add or remove points.
+  vtkPoints* GetControlPointPositionsArray();
+
+  /// Update control points after positions were modified in the array returned by
+  /// GetControlPointPositionsArray. Events are invoked once for all points, with nullptr call data.
+  void ControlPointPositionsArrayModified();
+
+  /// Start a batch of control point modifications, such as adding or moving many points one by one.
+  /// Until the matching EndPointModify call:
+  /// - Point* events and Modified event are compressed (as in StartModify),
+  /// - measurements, interaction handles, and display scalar range are not updated,
+  ///   so the curve is regenerated only once, when it is requested after the batch.
+  /// Calls can be nested. The outermost EndPointModify invokes PointsModifiedEvent once.
+  /// Returns the previous disable modified event state, which must be passed to EndPointModify.
+  int StartPointModify();
+  void EndPointModify(int wasModifying);
+
+  /// Keeps track of the control points that are modified between StartPointModify and EndPointModify.
+  void InvokeCustomModifiedEvent(int eventId, void* callData = nullptr) override;
+
   /// 4x4 matrix detailing the orientation and position in world coordinates of the interaction handles.
   virtual vtkMatrix4x4* GetInteractionHandleToWorldMatrix();
 
@@ -651,6 +703,10 @@ protected:
   /// Calculates the handle to world matrix based on the current control points
   virtual void UpdateInteractionHandleToWorldMatrix();
 
+  /// Transform positions between local and world coordinate system, using all threads.
+  /// Output points may be the same object as input points.
+  void TransformControlPointPositions(vtkPoints* inputPoints, vtkPoints* outputPoints, bool toWorld);
+
   /// Used for limiting number of control points that may be placed.
   /// This is a soft limit at which automatic placement stops.
   int RequiredNumberOfControlPoints{0};
@@ -705,8 +761,11 @@ protected:
   /// Transform that moves the xyz unit vectors and origin of the interaction handles to local coordinates
   vtkSmartPointer<vtkMatrix4x4> InteractionHandleToWorldMatrix;
 
-  /// Flag set from SetControlPointPositionsWorld that pauses update of measurements until the update is complete.
-  bool IsUpdatingPoints{false};
+  /// Number of nested StartPointModify calls. Update of measurements is paused until the update is complete.
+  int PointModifyDepth{0};
+  /// Range of control point indices that are affected by the current batch of modifications.
+  int ModifiedPointRange[2] = { 0, -1 };
+  bool ModifiedPointRangeValid{false};
 
   friend class qSlicerMarkupsModuleWidget; // To directly access measurements
 };
@@ -22,10 +22,22 @@
 #include "vtkSlicerDijkstraGraphGeodesicPath.h"
 
 // VTK includes
+#include <vtkCellArray.h>
 #include <vtkFloatArray.h>
+#include <vtkIdList.h>
 #include <vtkPointData.h>
 #include <vtkInformation.h>
 #include <vtkInformationVector.h>
+#include <vtkMath.h>
+#include <vtkNew.h>
+#include <vtkPoints.h>
+
+// STD includes
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <utility>
 
 //------------------------------------------------------------------------------
 vtkStandardNewMacro(vtkSlicerDijkstraGraphGeodesicPath);
@@ -124,29 +136,233 @@ int vtkSlicerDijkstraGraphGeodesicPath::RequestData(
     return 0;
     }
 
-  if (this->AdjacencyBuildTime.GetMTime() < input->GetMTime() ||
-      this->CostFunctionType != this->PreviousCostFunctionType ||
-      static_cast<bool>(this->UseScalarWeights) != this->PreviousUseScalarWeights)
+  bool costFunctionChanged = (this->CostFunctionType != this->PreviousCostFunctionType ||
+    static_cast<bool>(this->UseScalarWeights) != this->PreviousUseScalarWeights);
+  this->PreviousUseScalarWeights = this->UseScalarWeights;
+  this->PreviousCostFunctionType = this->CostFunctionType;
+
+  if (this->RepelPathFromVertices)
     {
-    this->Initialize(input);
+    // Repelling cost depends on the path, use the base class implementation
+    if (this->AdjacencyBuildTime.GetMTime() < input->GetMTime() || costFunctionChanged)
+      {
+      this->Initialize(input);
+      }
+    else
+      {
+      this->Reset();
+      }
+    if (this->NumberOfVertices == 0)
+      {
+      return 0;
+      }
+    this->ShortestPath(input, this->StartVertex, this->EndVertex);
+    this->TraceShortestPath(input, output, this->StartVertex, this->EndVertex);
+    return 1;
     }
-  else
+
+  if (this->GraphInput != input || this->GraphBuildTime.GetMTime() < input->GetMTime() || costFunctionChanged)
     {
-    this->Reset();
+    this->BuildGraph(input);
     }
-  this->PreviousUseScalarWeights = this->UseScalarWeights;
-  this->PreviousCostFunctionType= this->CostFunctionType;
-
-  if (this->NumberOfVertices == 0)
+  this->IdList->Reset();
+  vtkIdType numberOfVertices = input->GetNumberOfPoints();
+  if (numberOfVertices == 0
+    || this->StartVertex < 0 || this->StartVertex >= numberOfVertices
+    || this->EndVertex < 0 || this->EndVertex >= numberOfVertices)
     {
     return 0;
     }
 
-  this->ShortestPath(input, this->StartVertex, this->EndVertex);
-  this->TraceShortestPath(input, output, this->StartVertex, this->EndVertex);
+  // Path is traced backward, from the end vertex to the start vertex
+  vtkNew<vtkPoints> points;
+  if (this->ShortestPathAStar(input, this->StartVertex, this->EndVertex))
+    {
+    for (vtkIdType vertex = this->EndVertex; vertex != this->StartVertex; vertex = this->VertexPredecessor[vertex])
+      {
+      this->IdList->InsertNextId(vertex);
+      }
+    }
+  else
+    {
+    vtkWarningMacro("RequestData: no path found between vertex " << this->StartVertex << " and " << this->EndVertex);
+    this->IdList->InsertNextId(this->EndVertex);
+    }
+  this->IdList->InsertNextId(this->StartVertex);
+
+  vtkIdType numberOfPathPoints = this->IdList->GetNumberOfIds();
+  points->SetNumberOfPoints(numberOfPathPoints);
+  vtkNew<vtkCellArray> lines;
+  lines->InsertNextCell(numberOfPathPoints);
+  for (vtkIdType pointIndex = 0; pointIndex < numberOfPathPoints; ++pointIndex)
+    {
+    points->SetPoint(pointIndex, input->GetPoint(this->IdList->GetId(pointIndex)));
+    lines->InsertCellPoint(pointIndex);
+    }
+  output->SetPoints(points);
+  output->SetLines(lines);
   return 1;
 }
 
+//------------------------------------------------------------------------------
+void vtkSlicerDijkstraGraphGeodesicPath::BuildGraph(vtkPolyData* inData)
+{
+  vtkIdType numberOfVertices = inData->GetNumberOfPoints();
+
+  // Collect unique directed edges. Edge costs may not be symmetric, so both directions are stored.
+  // Only polygons are used, same as in vtkDijkstraGraphGeodesicPath.
+  std::vector<std::vector<vtkIdType> > neighbors(numberOfVertices);
+  auto addEdge = [&neighbors](vtkIdType u, vtkIdType v)
+    {
+    if (u == v)
+      {
+      return;
+      }
+    std::vector<vtkIdType>& neighborsOfU = neighbors[u];
+    if (std::find(neighborsOfU.begin(), neighborsOfU.end(), v) == neighborsOfU.end())
+      {
+      neighborsOfU.push_back(v);
+      }
+    };
+  vtkNew<vtkIdList> cellPointIds;
+  vtkIdType numberOfCells = inData->GetNumberOfCells();
+  for (vtkIdType cellId = 0; cellId < numberOfCells; ++cellId)
+    {
+    int cellType = inData->GetCellType(cellId);
+    if (cellType != VTK_POLYGON && cellType != VTK_TRIANGLE && cellType != VTK_QUAD)
+      {
+      continue;
+      }
+    inData->GetCellPoints(cellId, cellPointIds);
+    vtkIdType numberOfCellPoints = cellPointIds->GetNumberOfIds();
+    for (vtkIdType i = 0; i < numberOfCellPoints; ++i)
+      {
+      vtkIdType u = cellPointIds->GetId(i);
+      vtkIdType v = cellPointIds->GetId((i + 1) % numberOfCellPoints);
+      addEdge(u, v);
+      addEdge(v, u);
+      }
+    }
+
+  this->GraphOffsets.resize(numberOfVertices + 1);
+  this->GraphNeighbors.clear();
+  this->GraphCosts.clear();
+  double minimumCostPerLength = std::numeric_limits<double>::max();
+  for (vtkIdType u = 0; u < numberOfVertices; ++u)
+    {
+    this->GraphOffsets[u] = static_cast<vtkIdType>(this->GraphNeighbors.size());
+    double pointU[3] = { 0.0, 0.0, 0.0 };
+    inData->GetPoint(u, pointU);
+    for (vtkIdType v : neighbors[u])
+      {
+      double cost = this->CalculateStaticEdgeCost(inData, u, v);
+      this->GraphNeighbors.push_back(v);
+      this->GraphCosts.push_back(cost);
+
+      double pointV[3] = { 0.0, 0.0, 0.0 };
+      inData->GetPoint(v, pointV);
+      double length = sqrt(vtkMath::Distance2BetweenPoints(pointU, pointV));
+      if (length > 0.0)
+        {
+        minimumCostPerLength = std::min(minimumCostPerLength, cost / length);
+        }
+      else if (cost < 0.0)
+        {
+        minimumCostPerLength = 0.0;
+        }
+      }
+    }
+  this->GraphOffsets[numberOfVertices] = static_cast<vtkIdType>(this->GraphNeighbors.size());
+
+  // Negative costs cannot be handled by the heuristic (nor by Dijkstra's algorithm).
+  // The scale is slightly reduced so that rounding errors cannot make the heuristic overestimate the cost.
+  if (this->GraphNeighbors.empty() || minimumCostPerLength <= 0.0)
+    {
+    this->HeuristicScale = 0.0;
+    }
+  else
+    {
+    this->HeuristicScale = minimumCostPerLength * (1.0 - 1e-9);
+    }
+
+  this->VertexCost.resize(numberOfVertices);
+  this->VertexPredecessor.resize(numberOfVertices);
+  this->VertexSearchId.assign(numberOfVertices, 0);
+  this->VertexClosedSearchId.assign(numberOfVertices, 0);
+  this->SearchId = 0;
+  this->NumberOfVertices = static_cast<int>(numberOfVertices);
+
+  this->GraphInput = inData;
+  this->GraphBuildTime.Modified();
+}
+
+//------------------------------------------------------------------------------
+bool vtkSlicerDijkstraGraphGeodesicPath::ShortestPathAStar(vtkPolyData* inData, vtkIdType startVertex, vtkIdType endVertex)
+{
+  if (++this->SearchId == 0)
+    {
+    // Search id wrapped around, values from previous searches would be considered valid
+    std::fill(this->VertexSearchId.begin(), this->VertexSearchId.end(), 0);
+    std::fill(this->VertexClosedSearchId.begin(), this->VertexClosedSearchId.end(), 0);
+    this->SearchId = 1;
+    }
+  const unsigned int searchId = this->SearchId;
+
+  double endPoint[3] = { 0.0, 0.0, 0.0 };
+  inData->GetPoint(endVertex, endPoint);
+  auto heuristic = [&](vtkIdType vertex)
+    {
+    if (this->HeuristicScale == 0.0)
+      {
+      return 0.0;
+      }
+    double point[3] = { 0.0, 0.0, 0.0 };
+    inData->GetPoint(vertex, point);
+    return this->HeuristicScale * sqrt(vtkMath::Distance2BetweenPoints(point, endPoint));
+    };
+
+  // Open vertices ordered by the estimated total cost of the path through them.
+  // Vertices are not removed from the queue when their cost decreases, outdated entries are skipped instead.
+  typedef std::pair<double, vtkIdType> QueueItem;
+  std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<QueueItem> > openVertices;
+  this->VertexCost[startVertex] = 0.0;
+  this->VertexPredecessor[startVertex] = -1;
+  this->VertexSearchId[startVertex] = searchId;
+  openVertices.push(QueueItem(heuristic(startVertex), startVertex));
+  while (!openVertices.empty())
+    {
+    vtkIdType u = openVertices.top().second;
+    openVertices.pop();
+    if (this->VertexClosedSearchId[u] == searchId)
+      {
+      continue;
+      }
+    if (u == endVertex)
+      {
+      return true;
+      }
+    this->VertexClosedSearchId[u] = searchId;
+    double costU = this->VertexCost[u];
+    for (vtkIdType edgeIndex = this->GraphOffsets[u]; edgeIndex < this->GraphOffsets[u + 1]; ++edgeIndex)
+      {
+      vtkIdType v = this->GraphNeighbors[edgeIndex];
+      if (this->VertexClosedSearchId[v] == searchId)
+        {
+        continue;
+        }
+      double costV = costU + this->GraphCosts[edgeIndex];
+      if (this->VertexSearchId[v] != searchId || costV < this->VertexCost[v])
+        {
+        this->VertexSearchId[v] = searchId;
+        this->VertexCost[v] = costV;
+        this->VertexPredecessor[v] = u;
+        openVertices.push(QueueItem(costV + heuristic(v), v));
+        }
+      }
+    }
+  return false;
+}
+
 //------------------------------------------------------------------------------
 double vtkSlicerDijkstraGraphGeodesicPath::CalculateStaticEdgeCost(vtkDataSet* inData, vtkIdType u, vtkIdType v)
 {
@@ -24,10 +24,20 @@
 // VTK includes
 #include <vtkDijkstraGraphGeodesicPath.h>
 
+// STD includes
+#include <vector>
+
 // export
 #include "vtkSlicerMarkupsModuleMRMLExport.h"
 
 /// Filter that generates curves between points of an input polydata
+///
+/// The edge graph of the input surface and the static edge costs are computed once and reused
+/// until the input or the cost function is changed. Shortest paths are computed using A* search
+/// with Euclidean distance heuristic (scaled by the smallest cost per unit length of all edges,
+/// so that the found path is still optimal), which visits far fewer vertices than Dijkstra's
+/// algorithm when the start and end vertices are close to each other on a large surface.
+/// If RepelPathFromVertices is enabled then the path is computed by the base class.
 class VTK_SLICER_MARKUPS_MODULE_MRML_EXPORT vtkSlicerDijkstraGraphGeodesicPath : public vtkDijkstraGraphGeodesicPath
 {
 public:
@@ -64,10 +74,35 @@ protected:
   /// \sa SetCostFunctionType()
   double CalculateStaticEdgeCost(vtkDataSet* inData, vtkIdType u, vtkIdType v) override;
 
+  /// Build edge graph of the input in compressed sparse row format with the static edge costs.
+  void BuildGraph(vtkPolyData* inData);
+
+  /// Find the shortest path from startVertex to endVertex using A* search.
+  /// Returns false if there is no path between the vertices.
+  bool ShortestPathAStar(vtkPolyData* inData, vtkIdType startVertex, vtkIdType endVertex);
+
   int CostFunctionType;
   int PreviousCostFunctionType;
   bool PreviousUseScalarWeights;
 
+  /// Edges starting from vertex i are stored in GraphNeighbors and GraphCosts
+  /// from index GraphOffsets[i] to GraphOffsets[i+1]-1.
+  std::vector<vtkIdType> GraphOffsets;
+  std::vector<vtkIdType> GraphNeighbors;
+  std::vector<double> GraphCosts;
+  /// Smallest cost per unit length of all edges, heuristic is not used if it is 0
+  double HeuristicScale{0.0};
+  vtkTimeStamp GraphBuildTime;
+  vtkPolyData* GraphInput{nullptr};
+
+  /// Search state. A vertex is only valid in the current search if its VertexSearchId matches SearchId,
+  /// therefore the arrays do not need to be reset for each search.
+  std::vector<double> VertexCost;
+  std::vector<vtkIdType> VertexPredecessor;
+  std::vector<unsigned int> VertexSearchId;
+  std::vector<unsigned int> VertexClosedSearchId;
+  unsigned int SearchId{0};
+
 protected:
   vtkSlicerDijkstraGraphGeodesicPath();
   ~vtkSlicerDijkstraGraphGeodesicPath() override;
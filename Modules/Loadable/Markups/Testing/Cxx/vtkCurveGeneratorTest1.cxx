@@ -0,0 +1,143 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Copyright (c) Kitware Inc.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// Markups MRML includes
+#include "vtkCurveGenerator.h"
+#include "vtkCurveMeasurementsCalculator.h"
+
+// MRML includes
+#include "vtkMRMLCoreTestingMacros.h"
+
+// VTK includes
+#include <vtkCollection.h>
+#include <vtkDoubleArray.h>
+#include <vtkMath.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+/// Generate curve from the same control points with and without incremental update
+/// (in a generator that has not been executed before) and compare the results.
+int CompareWithFullUpdate(vtkCurveGenerator* incrementalGenerator, vtkCurveMeasurementsCalculator* incrementalCalculator,
+  vtkPoints* controlPoints)
+{
+  incrementalGenerator->SetInputPoints(controlPoints);
+  incrementalCalculator->Update();
+
+  vtkNew<vtkCurveGenerator> generator;
+  generator->IncrementalUpdateOff();
+  generator->SetCurveType(incrementalGenerator->GetCurveType());
+  generator->SetCurveIsClosed(incrementalGenerator->GetCurveIsClosed());
+  generator->SetNumberOfPointsPerInterpolatingSegment(incrementalGenerator->GetNumberOfPointsPerInterpolatingSegment());
+  generator->SetInputPoints(controlPoints);
+  vtkNew<vtkCollection> measurements;
+  vtkNew<vtkCurveMeasurementsCalculator> calculator;
+  calculator->SetMeasurements(measurements.GetPointer());
+  calculator->SetCurveIsClosed(incrementalCalculator->GetCurveIsClosed());
+  calculator->CalculateCurvatureOn();
+  calculator->SetInputConnection(generator->GetOutputPort());
+  calculator->Update();
+
+  vtkPolyData* expected = calculator->GetOutput();
+  vtkPolyData* actual = incrementalCalculator->GetOutput();
+  CHECK_INT(actual->GetNumberOfPoints(), expected->GetNumberOfPoints());
+  CHECK_DOUBLE_TOLERANCE(incrementalGenerator->GetOutputCurveLength(), generator->GetOutputCurveLength(), 1e-6);
+  vtkDoubleArray* expectedCurvature = vtkDoubleArray::SafeDownCast(expected->GetPointData()->GetArray("Curvature"));
+  vtkDoubleArray* actualCurvature = vtkDoubleArray::SafeDownCast(actual->GetPointData()->GetArray("Curvature"));
+  CHECK_NOT_NULL(expectedCurvature);
+  CHECK_NOT_NULL(actualCurvature);
+  for (vtkIdType pointIndex = 0; pointIndex < expected->GetNumberOfPoints(); ++pointIndex)
+    {
+    double expectedPoint[3] = { 0.0 };
+    expected->GetPoint(pointIndex, expectedPoint);
+    double actualPoint[3] = { 0.0 };
+    actual->GetPoint(pointIndex, actualPoint);
+    CHECK_DOUBLE_TOLERANCE(vtkMath::Distance2BetweenPoints(expectedPoint, actualPoint), 0.0, 1e-10);
+    CHECK_DOUBLE_TOLERANCE(actualCurvature->GetValue(pointIndex), expectedCurvature->GetValue(pointIndex), 1e-6);
+    }
+  return EXIT_SUCCESS;
+}
+
+//----------------------------------------------------------------------------
+int TestIncrementalUpdate(int curveType, bool closed)
+{
+  const int numberOfControlPoints = 30;
+  vtkNew<vtkPoints> controlPoints;
+  for (int i = 0; i < numberOfControlPoints; ++i)
+    {
+    controlPoints->InsertNextPoint(i * 10.0, vtkMath::Random(-20.0, 20.0), vtkMath::Random(-20.0, 20.0));
+    }
+
+  vtkNew<vtkCurveGenerator> generator;
+  generator->SetCurveType(curveType);
+  generator->SetCurveIsClosed(closed);
+  generator->SetNumberOfPointsPerInterpolatingSegment(8);
+  vtkNew<vtkCollection> measurements;
+  vtkNew<vtkCurveMeasurementsCalculator> calculator;
+  calculator->SetMeasurements(measurements.GetPointer());
+  calculator->SetCurveIsClosed(closed);
+  calculator->CalculateCurvatureOn();
+  calculator->SetInputConnection(generator->GetOutputPort());
+  CHECK_EXIT_SUCCESS(CompareWithFullUpdate(generator.GetPointer(), calculator.GetPointer(), controlPoints.GetPointer()));
+
+  // Move single points, including the first and last points that are neighbors in closed curves
+  int movedPointIndices[] = { 0, 1, 15, numberOfControlPoints - 2, numberOfControlPoints - 1 };
+  for (int movedPointIndex : movedPointIndices)
+    {
+    double point[3] = { 0.0 };
+    controlPoints->GetPoint(movedPointIndex, point);
+    controlPoints->SetPoint(movedPointIndex, point[0] + 3.0, point[1] - 5.0, point[2] + 7.0);
+    controlPoints->Modified();
+    CHECK_EXIT_SUCCESS(CompareWithFullUpdate(generator.GetPointer(), calculator.GetPointer(), controlPoints.GetPointer()));
+    }
+
+  // Move two points at once
+  controlPoints->SetPoint(5, 1.0, 2.0, 3.0);
+  controlPoints->SetPoint(20, 4.0, 5.0, 6.0);
+  controlPoints->Modified();
+  CHECK_EXIT_SUCCESS(CompareWithFullUpdate(generator.GetPointer(), calculator.GetPointer(), controlPoints.GetPointer()));
+
+  // Add a point
+  controlPoints->InsertNextPoint(numberOfControlPoints * 10.0, 0.0, 0.0);
+  controlPoints->Modified();
+  CHECK_EXIT_SUCCESS(CompareWithFullUpdate(generator.GetPointer(), calculator.GetPointer(), controlPoints.GetPointer()));
+
+  return EXIT_SUCCESS;
+}
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+int vtkCurveGeneratorTest1(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
+{
+  vtkMath::RandomSeed(42);
+
+  CHECK_EXIT_SUCCESS(TestIncrementalUpdate(vtkCurveGenerator::CURVE_TYPE_LINEAR_SPLINE, false));
+  CHECK_EXIT_SUCCESS(TestIncrementalUpdate(vtkCurveGenerator::CURVE_TYPE_LINEAR_SPLINE, true));
+  CHECK_EXIT_SUCCESS(TestIncrementalUpdate(vtkCurveGenerator::CURVE_TYPE_KOCHANEK_SPLINE, false));
+  CHECK_EXIT_SUCCESS(TestIncrementalUpdate(vtkCurveGenerator::CURVE_TYPE_KOCHANEK_SPLINE, true));
+  // Cardinal spline is always fully regenerated
+  CHECK_EXIT_SUCCESS(TestIncrementalUpdate(vtkCurveGenerator::CURVE_TYPE_CARDINAL_SPLINE, false));
+
+  std::cout << "vtkCurveGeneratorTest1 passed." << std::endl;
+  return EXIT_SUCCESS;
+}
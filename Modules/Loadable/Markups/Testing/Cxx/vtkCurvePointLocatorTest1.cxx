@@ -0,0 +1,114 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Copyright (c) Laboratory for Percutaneous Surgery (PerkLab)
+  Queen's University, Kingston, ON, Canada. All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// Markups MRML includes
+#include "vtkCurvePointLocator.h"
+
+// MRML includes
+#include "vtkMRMLCoreTestingMacros.h"
+
+// VTK includes
+#include <vtkLine.h>
+#include <vtkMath.h>
+#include <vtkNew.h>
+#include <vtkPoints.h>
+
+// STD includes
+#include <algorithm>
+
+//----------------------------------------------------------------------------
+int vtkCurvePointLocatorTest1(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
+{
+  vtkMath::RandomSeed(42);
+
+  // Random walk, similar to a centerline
+  vtkNew<vtkPoints> points;
+  double point[3] = { 0.0, 0.0, 0.0 };
+  for (int i = 0; i < 1000; ++i)
+    {
+    points->InsertNextPoint(point);
+    for (int j = 0; j < 3; ++j)
+      {
+      point[j] += vtkMath::Random(-1.0, 1.0);
+      }
+    }
+
+  vtkNew<vtkCurvePointLocator> locator;
+  double position[3] = { 0.0, 0.0, 0.0 };
+  double closestPosition[3] = { 0.0, 0.0, 0.0 };
+  CHECK_INT(locator->FindClosestPoint(position), -1);
+  CHECK_INT(locator->FindFarthestPoint(position), -1);
+  CHECK_INT(locator->FindClosestPositionOnCurve(position, closestPosition), -1);
+
+  locator->SetPoints(points);
+  for (int closed = 0; closed < 2; ++closed)
+    {
+    locator->SetClosed(closed);
+    vtkIdType numberOfSegments = (closed ? points->GetNumberOfPoints() : points->GetNumberOfPoints() - 1);
+    for (int queryIndex = 0; queryIndex < 100; ++queryIndex)
+      {
+      for (int j = 0; j < 3; ++j)
+        {
+        position[j] = vtkMath::Random(-30.0, 30.0);
+        }
+
+      // Compute results by checking all points and segments
+      double expectedClosestDistance2 = VTK_DOUBLE_MAX;
+      double expectedFarthestDistance2 = -1.0;
+      double expectedClosestDistanceToCurve2 = VTK_DOUBLE_MAX;
+      for (vtkIdType pointIndex = 0; pointIndex < points->GetNumberOfPoints(); ++pointIndex)
+        {
+        double distance2 = vtkMath::Distance2BetweenPoints(position, points->GetPoint(pointIndex));
+        expectedClosestDistance2 = std::min(expectedClosestDistance2, distance2);
+        expectedFarthestDistance2 = std::max(expectedFarthestDistance2, distance2);
+        }
+      for (vtkIdType segmentIndex = 0; segmentIndex < numberOfSegments; ++segmentIndex)
+        {
+        double segmentStart[3] = { 0.0 };
+        points->GetPoint(segmentIndex, segmentStart);
+        double segmentEnd[3] = { 0.0 };
+        points->GetPoint((segmentIndex + 1) % points->GetNumberOfPoints(), segmentEnd);
+        double t = 0.0;
+        double closestPoint[3] = { 0.0 };
+        expectedClosestDistanceToCurve2 = std::min(expectedClosestDistanceToCurve2,
+          vtkLine::DistanceToLine(position, segmentStart, segmentEnd, t, closestPoint));
+        }
+
+      vtkIdType closestPointIndex = locator->FindClosestPoint(position);
+      CHECK_DOUBLE_TOLERANCE(vtkMath::Distance2BetweenPoints(position, points->GetPoint(closestPointIndex)), expectedClosestDistance2, 1e-9);
+      vtkIdType farthestPointIndex = locator->FindFarthestPoint(position);
+      CHECK_DOUBLE_TOLERANCE(vtkMath::Distance2BetweenPoints(position, points->GetPoint(farthestPointIndex)), expectedFarthestDistance2, 1e-9);
+      vtkIdType segmentIndex = locator->FindClosestPositionOnCurve(position, closestPosition);
+      CHECK_BOOL(segmentIndex >= 0 && segmentIndex < numberOfSegments, true);
+      CHECK_DOUBLE_TOLERANCE(vtkMath::Distance2BetweenPoints(position, closestPosition), expectedClosestDistanceToCurve2, 1e-6);
+      }
+    }
+
+  // Modified points are taken into account
+  points->SetPoint(500, 1000.0, 0.0, 0.0);
+  points->Modified();
+  position[0] = 900.0;
+  position[1] = 0.0;
+  position[2] = 0.0;
+  CHECK_INT(locator->FindClosestPoint(position), 500);
+  position[0] = -900.0;
+  CHECK_INT(locator->FindFarthestPoint(position), 500);
+
+  std::cout << "vtkCurvePointLocatorTest1 passed." << std::endl;
+  return EXIT_SUCCESS;
+}
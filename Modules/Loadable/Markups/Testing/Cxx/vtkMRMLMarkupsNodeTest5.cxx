@@ -0,0 +1,195 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Portions (c) Copyright Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// MRML includes
+#include "vtkMRMLCoreTestingMacros.h"
+#include "vtkMRMLCoreTestingUtilities.h"
+#include "vtkMRMLLinearTransformNode.h"
+#include "vtkMRMLMarkupsFiducialNode.h"
+#include "vtkMRMLScene.h"
+
+// VTK includes
+#include <vtkCallbackCommand.h>
+#include <vtkMatrix4x4.h>
+#include <vtkNew.h>
+#include <vtkPoints.h>
+#include <vtkStringArray.h>
+#include <vtkTestingOutputWindow.h>
+
+namespace
+{
+
+int ModifiedPointRange[2] = { -1, -1 };
+
+//----------------------------------------------------------------------------
+void PointsModifiedCallback(vtkObject* vtkNotUsed(caller), unsigned long vtkNotUsed(eid), void* vtkNotUsed(clientData), void* callData)
+{
+  int* range = static_cast<int*>(callData);
+  ModifiedPointRange[0] = range ? range[0] : -1;
+  ModifiedPointRange[1] = range ? range[1] : -1;
+}
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+// Test adding and updating many control points at once
+int vtkMRMLMarkupsNodeTest5(int , char * [] )
+{
+  vtkNew<vtkMRMLScene> scene;
+  vtkNew<vtkMRMLMarkupsFiducialNode> markupsNode;
+  scene->AddNode(markupsNode);
+
+  vtkNew<vtkMRMLLinearTransformNode> transformNode;
+  scene->AddNode(transformNode);
+  vtkNew<vtkMatrix4x4> matrix;
+  matrix->SetElement(0, 3, 10.0);
+  matrix->SetElement(1, 3, -20.0);
+  transformNode->SetMatrixTransformToParent(matrix);
+  markupsNode->SetAndObserveTransformNodeID(transformNode->GetID());
+
+  vtkNew<vtkMRMLCoreTestingUtilities::vtkMRMLNodeCallback> callback;
+  markupsNode->AddObserver(vtkCommand::AnyEvent, callback);
+  vtkNew<vtkCallbackCommand> pointsModifiedCallback;
+  pointsModifiedCallback->SetCallback(PointsModifiedCallback);
+  markupsNode->AddObserver(vtkMRMLMarkupsNode::PointsModifiedEvent, pointsModifiedCallback);
+
+  const int numberOfPoints = 1000;
+  vtkNew<vtkPoints> pointsWorld;
+  for (int i = 0; i < numberOfPoints; ++i)
+    {
+    pointsWorld->InsertNextPoint(i, 2.0 * i, 3.0 * (i % 7));
+    }
+
+  // Add points in world coordinates, events are only invoked once
+  CHECK_INT(markupsNode->AddControlPointsWorld(pointsWorld), 0);
+  CHECK_INT(markupsNode->GetNumberOfControlPoints(), numberOfPoints);
+  CHECK_INT(callback->GetNumberOfEvents(vtkMRMLMarkupsNode::PointAddedEvent), 1);
+  CHECK_INT(callback->GetNumberOfEvents(vtkMRMLMarkupsNode::PointPositionDefinedEvent), 1);
+  CHECK_INT(callback->GetNumberOfEvents(vtkCommand::ModifiedEvent), 1);
+  CHECK_INT(callback->GetNumberOfEvents(vtkMRMLMarkupsNode::PointsModifiedEvent), 1);
+  CHECK_INT(ModifiedPointRange[0], 0);
+  CHECK_INT(ModifiedPointRange[1], numberOfPoints - 1);
+  double position[3] = { 0.0, 0.0, 0.0 };
+  markupsNode->GetNthControlPointPosition(10, position);
+  CHECK_DOUBLE_TOLERANCE(position[0], 0.0, 1e-6);
+  CHECK_DOUBLE_TOLERANCE(position[1], 40.0, 1e-6);
+  CHECK_DOUBLE_TOLERANCE(position[2], 9.0, 1e-6);
+  CHECK_BOOL(markupsNode->GetNthControlPointLabel(numberOfPoints - 1).empty(), false);
+
+  vtkNew<vtkPoints> actualPointsWorld;
+  markupsNode->GetControlPointPositionsWorld(actualPointsWorld);
+  CHECK_INT(actualPointsWorld->GetNumberOfPoints(), numberOfPoints);
+  for (int i = 0; i < numberOfPoints; ++i)
+    {
+    for (int c = 0; c < 3; ++c)
+      {
+      CHECK_DOUBLE_TOLERANCE(actualPointsWorld->GetPoint(i)[c], pointsWorld->GetPoint(i)[c], 1e-6);
+      }
+    }
+
+  // Interaction handle is at the center of the points
+  double* handleToWorld = markupsNode->GetInteractionHandleToWorldMatrix()->GetData();
+  CHECK_DOUBLE_TOLERANCE(handleToWorld[3], (numberOfPoints - 1) * 0.5, 1e-6);
+  CHECK_DOUBLE_TOLERANCE(handleToWorld[7], (numberOfPoints - 1) * 1.0, 1e-6);
+
+  // Labels
+  vtkNew<vtkPoints> morePoints;
+  morePoints->InsertNextPoint(1.0, 2.0, 3.0);
+  morePoints->InsertNextPoint(4.0, 5.0, 6.0);
+  vtkNew<vtkStringArray> labels;
+  labels->InsertNextValue("first");
+  labels->InsertNextValue("second");
+  CHECK_INT(markupsNode->AddControlPoints(morePoints, labels), numberOfPoints);
+  CHECK_STD_STRING(markupsNode->GetNthControlPointLabel(numberOfPoints + 1), "second");
+  labels->InsertNextValue("third");
+  TESTING_OUTPUT_ASSERT_ERRORS_BEGIN();
+  CHECK_INT(markupsNode->AddControlPoints(morePoints, labels), -1);
+  TESTING_OUTPUT_ASSERT_ERRORS_END();
+  CHECK_INT(markupsNode->GetNumberOfControlPoints(), numberOfPoints + 2);
+
+  // Modify individual points in one batch
+  callback->ResetNumberOfEvents();
+  int wasModifying = markupsNode->StartPointModify();
+  markupsNode->SetNthControlPointPosition(30, 1.0, 2.0, 3.0);
+  int nestedWasModifying = markupsNode->StartPointModify();
+  markupsNode->SetNthControlPointLabel(70, "seventy");
+  markupsNode->SetNthControlPointPosition(50, 1.0, 2.0, 3.0);
+  markupsNode->EndPointModify(nestedWasModifying);
+  CHECK_INT(callback->GetNumberOfEvents(vtkMRMLMarkupsNode::PointModifiedEvent), 0);
+  markupsNode->EndPointModify(wasModifying);
+  CHECK_INT(callback->GetNumberOfEvents(vtkMRMLMarkupsNode::PointModifiedEvent), 1);
+  CHECK_INT(callback->GetNumberOfEvents(vtkMRMLMarkupsNode::PointsModifiedEvent), 1);
+  CHECK_INT(ModifiedPointRange[0], 30);
+  CHECK_INT(ModifiedPointRange[1], 70);
+
+  // Removing a point affects all the following points
+  callback->ResetNumberOfEvents();
+  wasModifying = markupsNode->StartPointModify();
+  markupsNode->SetNthControlPointPosition(40, 1.0, 2.0, 3.0);
+  markupsNode->RemoveNthControlPoint(60);
+  markupsNode->EndPointModify(wasModifying);
+  CHECK_INT(callback->GetNumberOfEvents(vtkMRMLMarkupsNode::PointRemovedEvent), 1);
+  CHECK_INT(ModifiedPointRange[0], 40);
+  CHECK_INT(ModifiedPointRange[1], markupsNode->GetNumberOfControlPoints() - 1);
+
+  // Update, add, and remove points in one batch
+  callback->ResetNumberOfEvents();
+  vtkNew<vtkPoints> newPoints;
+  for (int i = 0; i < numberOfPoints + 10; ++i)
+    {
+    newPoints->InsertNextPoint(-i, 0.0, 0.0);
+    }
+  markupsNode->SetControlPointPositions(newPoints);
+  CHECK_INT(markupsNode->GetNumberOfControlPoints(), numberOfPoints + 10);
+  CHECK_INT(callback->GetNumberOfEvents(vtkMRMLMarkupsNode::PointModifiedEvent), 1);
+  CHECK_INT(callback->GetNumberOfEvents(vtkMRMLMarkupsNode::PointAddedEvent), 1);
+  CHECK_INT(callback->GetNumberOfEvents(vtkCommand::ModifiedEvent), 1);
+  markupsNode->GetNthControlPointPosition(numberOfPoints + 5, position);
+  CHECK_DOUBLE_TOLERANCE(position[0], -(numberOfPoints + 5.0), 1e-6);
+
+  callback->ResetNumberOfEvents();
+  newPoints->SetNumberOfPoints(5);
+  markupsNode->SetControlPointPositionsWorld(newPoints);
+  CHECK_INT(markupsNode->GetNumberOfControlPoints(), 5);
+  CHECK_INT(markupsNode->GetCurvePoints()->GetNumberOfPoints(), 5);
+  CHECK_INT(callback->GetNumberOfEvents(vtkMRMLMarkupsNode::PointRemovedEvent), 1);
+  markupsNode->GetNthControlPointPositionWorld(4, position);
+  CHECK_DOUBLE_TOLERANCE(position[0], -4.0, 1e-6);
+  CHECK_DOUBLE_TOLERANCE(position[1], 0.0, 1e-6);
+
+  // Modify positions in place
+  callback->ResetNumberOfEvents();
+  vtkPoints* positionsArray = markupsNode->GetControlPointPositionsArray();
+  CHECK_INT(positionsArray->GetNumberOfPoints(), 5);
+  CHECK_INT(positionsArray->GetDataType(), VTK_DOUBLE);
+  positionsArray->SetPoint(2, 7.0, 8.0, 9.0);
+  positionsArray->SetPoint(3, 1.0, 2.0, 3.0);
+  markupsNode->ControlPointPositionsArrayModified();
+  CHECK_INT(callback->GetNumberOfEvents(vtkMRMLMarkupsNode::PointModifiedEvent), 1);
+  CHECK_INT(callback->GetNumberOfEvents(vtkCommand::ModifiedEvent), 1);
+  markupsNode->GetNthControlPointPosition(2, position);
+  CHECK_DOUBLE_TOLERANCE(position[0], 7.0, 1e-6);
+  CHECK_DOUBLE_TOLERANCE(position[2], 9.0, 1e-6);
+  markupsNode->GetNthControlPointPosition(3, position);
+  CHECK_DOUBLE_TOLERANCE(position[1], 2.0, 1e-6);
+
+  markupsNode->SetControlPointPositionsWorld(nullptr);
+  CHECK_INT(markupsNode->GetNumberOfControlPoints(), 0);
+
+  std::cout << "Success." << std::endl;
+  return EXIT_SUCCESS;
+}
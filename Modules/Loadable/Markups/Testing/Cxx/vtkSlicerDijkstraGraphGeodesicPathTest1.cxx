@@ -0,0 +1,108 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Portions (c) Copyright Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// Markups MRML includes
+#include "vtkSlicerDijkstraGraphGeodesicPath.h"
+
+// MRML includes
+#include "vtkMRMLCoreTestingMacros.h"
+
+// VTK includes
+#include <vtkIdList.h>
+#include <vtkMath.h>
+#include <vtkNew.h>
+#include <vtkPolyData.h>
+#include <vtkSphereSource.h>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+double GetPathLength(vtkPolyData* path)
+{
+  double length = 0.0;
+  for (vtkIdType pointIndex = 1; pointIndex < path->GetNumberOfPoints(); ++pointIndex)
+    {
+    length += sqrt(vtkMath::Distance2BetweenPoints(path->GetPoint(pointIndex - 1), path->GetPoint(pointIndex)));
+    }
+  return length;
+}
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+// Compare shortest paths with the VTK implementation of Dijkstra's algorithm
+int vtkSlicerDijkstraGraphGeodesicPathTest1(int , char * [] )
+{
+  vtkNew<vtkSphereSource> sphereSource;
+  sphereSource->SetRadius(50.0);
+  sphereSource->SetThetaResolution(80);
+  sphereSource->SetPhiResolution(80);
+  sphereSource->Update();
+  vtkPolyData* sphere = sphereSource->GetOutput();
+  vtkIdType numberOfPoints = sphere->GetNumberOfPoints();
+
+  vtkNew<vtkDijkstraGraphGeodesicPath> expectedPathFilter;
+  expectedPathFilter->SetInputData(sphere);
+  expectedPathFilter->StopWhenEndReachedOn();
+  vtkNew<vtkSlicerDijkstraGraphGeodesicPath> pathFilter;
+  pathFilter->SetInputData(sphere);
+  pathFilter->SetCostFunctionType(vtkSlicerDijkstraGraphGeodesicPath::COST_FUNCTION_TYPE_DISTANCE);
+
+  vtkIdType vertexPairs[][2] =
+    {
+    { 0, 1 },
+    { 10, numberOfPoints - 1 },
+    { numberOfPoints / 3, numberOfPoints / 2 },
+    { numberOfPoints / 2, numberOfPoints / 3 },
+    { 100, 100 },
+    };
+  for (auto& vertexPair : vertexPairs)
+    {
+    expectedPathFilter->SetStartVertex(vertexPair[0]);
+    expectedPathFilter->SetEndVertex(vertexPair[1]);
+    expectedPathFilter->Update();
+    pathFilter->SetStartVertex(vertexPair[0]);
+    pathFilter->SetEndVertex(vertexPair[1]);
+    pathFilter->Update();
+
+    vtkPolyData* expectedPath = expectedPathFilter->GetOutput();
+    vtkPolyData* path = pathFilter->GetOutput();
+    CHECK_DOUBLE_TOLERANCE(GetPathLength(path), GetPathLength(expectedPath), 1e-3);
+
+    // Path is traced from the end vertex to the start vertex
+    vtkIdList* pathIds = pathFilter->GetIdList();
+    CHECK_INT(pathIds->GetNumberOfIds(), path->GetNumberOfPoints());
+    CHECK_INT(pathIds->GetId(0), vertexPair[1]);
+    CHECK_INT(pathIds->GetId(pathIds->GetNumberOfIds() - 1), vertexPair[0]);
+    CHECK_INT(path->GetNumberOfCells(), 1);
+    }
+
+  // Modified surface is taken into account
+  sphereSource->SetRadius(100.0);
+  sphereSource->Update();
+  expectedPathFilter->SetStartVertex(0);
+  expectedPathFilter->SetEndVertex(numberOfPoints - 1);
+  expectedPathFilter->Update();
+  pathFilter->SetStartVertex(0);
+  pathFilter->SetEndVertex(numberOfPoints - 1);
+  pathFilter->Update();
+  CHECK_DOUBLE_TOLERANCE(GetPathLength(pathFilter->GetOutput()), GetPathLength(expectedPathFilter->GetOutput()), 1e-3);
+
+  std::cout << "Success." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -51,6 +51,10 @@
 #include <vtkMRMLInteractionEventData.h>
 #include <vtkMRMLTransformNode.h>
 
+// STD includes
+#include <algorithm>
+#include <cmath>
+
 //----------------------------------------------------------------------
 static const double INTERACTION_HANDLE_RADIUS = 0.0625;
 static const double INTERACTION_HANDLE_DIAMETER = INTERACTION_HANDLE_RADIUS * 2.0;
@@ -149,6 +153,8 @@ vtkSlicerMarkupsWidgetRepresentation::vtkSlicerMarkupsWidgetRepresentation()
   this->AlwaysOnTop = false;
 
   this->InteractionPipeline = nullptr;
+
+  this->LabelDecimationMinimumNumberOfControlPoints = 200;
 }
 
 //----------------------------------------------------------------------
@@ -430,6 +436,7 @@ void vtkSlicerMarkupsWidgetRepresentation::PrintSelf(ostream& os,
   //Superclass typedef defined in vtkTypeMacro() found in vtkSetGet.h
   this->Superclass::PrintSelf(os, indent);
   os << indent << "Point Placer: " << this->PointPlacer << "\n";
+  os << indent << "Label Decimation Minimum Number Of Control Points: " << this->LabelDecimationMinimumNumberOfControlPoints << "\n";
 }
 
 //-----------------------------------------------------------------------------
@@ -541,6 +548,9 @@ void vtkSlicerMarkupsWidgetRepresentation::UpdateFromMRML(
     this->SetMarkupsNode(markupsNode);
     }
 
+  // Control point positions or visibility may have changed
+  this->ControlPointsDisplayPositionIndex.Reset();
+
   if (this->MarkupsNode)
     {
     this->TextActor->SetInput(this->MarkupsNode->GetPropertiesLabelText().c_str());
@@ -1407,3 +1417,96 @@ int vtkSlicerMarkupsWidgetRepresentation::GetGlyphTypeSourceFromDisplay(int glyp
       return -1;
     }
 }
+
+//----------------------------------------------------------------------
+bool vtkSlicerMarkupsWidgetRepresentation::IsLabelDecimationRequired(vtkIdType numberOfControlPoints)
+{
+  return this->LabelDecimationMinimumNumberOfControlPoints > 0
+    && numberOfControlPoints >= this->LabelDecimationMinimumNumberOfControlPoints;
+}
+
+//----------------------------------------------------------------------
+void vtkSlicerMarkupsWidgetRepresentation::DisplayPositionIndex::Reset()
+{
+  this->Points.clear();
+  this->Bins.clear();
+  this->ViewParameters.clear();
+  this->Built = false;
+}
+
+//----------------------------------------------------------------------
+void vtkSlicerMarkupsWidgetRepresentation::DisplayPositionIndex::AddPoint(
+  int controlPointIndex, const double displayPosition[3], double tolerance)
+{
+  Point point;
+  point.ControlPointIndex = controlPointIndex;
+  point.DisplayPosition[0] = displayPosition[0];
+  point.DisplayPosition[1] = displayPosition[1];
+  point.DisplayPosition[2] = displayPosition[2];
+  point.Tolerance = tolerance;
+  this->Points.push_back(point);
+  this->Built = false;
+}
+
+//----------------------------------------------------------------------
+long long vtkSlicerMarkupsWidgetRepresentation::DisplayPositionIndex::GetBinKey(int binX, int binY) const
+{
+  return (static_cast<long long>(binX) << 32) ^ static_cast<long long>(static_cast<unsigned int>(binY));
+}
+
+//----------------------------------------------------------------------
+void vtkSlicerMarkupsWidgetRepresentation::DisplayPositionIndex::Build()
+{
+  // Bins are at least as large as the largest tolerance, therefore all points that can be picked
+  // at a display position are in the bin of the position or in its neighbor bins.
+  this->BinSize = 1.0;
+  for (const Point& point : this->Points)
+    {
+    this->BinSize = std::max(this->BinSize, point.Tolerance);
+    }
+  this->Bins.clear();
+  for (int pointIndex = 0; pointIndex < static_cast<int>(this->Points.size()); ++pointIndex)
+    {
+    const double* displayPosition = this->Points[pointIndex].DisplayPosition;
+    int binX = static_cast<int>(std::floor(displayPosition[0] / this->BinSize));
+    int binY = static_cast<int>(std::floor(displayPosition[1] / this->BinSize));
+    this->Bins[this->GetBinKey(binX, binY)].push_back(pointIndex);
+    }
+  this->Built = true;
+}
+
+//----------------------------------------------------------------------
+void vtkSlicerMarkupsWidgetRepresentation::DisplayPositionIndex::FindPoints(
+  const double displayPosition[2], std::vector<const Point*>& foundPoints) const
+{
+  foundPoints.clear();
+  int centerBinX = static_cast<int>(std::floor(displayPosition[0] / this->BinSize));
+  int centerBinY = static_cast<int>(std::floor(displayPosition[1] / this->BinSize));
+  std::vector<int> foundPointIndices;
+  for (int binX = centerBinX - 1; binX <= centerBinX + 1; ++binX)
+    {
+    for (int binY = centerBinY - 1; binY <= centerBinY + 1; ++binY)
+      {
+      std::unordered_map<long long, std::vector<int> >::const_iterator binIt = this->Bins.find(this->GetBinKey(binX, binY));
+      if (binIt == this->Bins.end())
+        {
+        continue;
+        }
+      for (int pointIndex : binIt->second)
+        {
+        const Point& point = this->Points[pointIndex];
+        if (std::abs(point.DisplayPosition[0] - displayPosition[0]) <= point.Tolerance
+          && std::abs(point.DisplayPosition[1] - displayPosition[1]) <= point.Tolerance)
+          {
+          foundPointIndices.push_back(pointIndex);
+          }
+        }
+      }
+    }
+  // Points were added in control point index order
+  std::sort(foundPointIndices.begin(), foundPointIndices.end());
+  for (int pointIndex : foundPointIndices)
+    {
+    foundPoints.push_back(&this->Points[pointIndex]);
+    }
+}
@@ -49,6 +49,10 @@
 
 #include "vtkSmartPointer.h"
 
+// STD includes
+#include <unordered_map>
+#include <vector>
+
 class vtkActor2D;
 class vtkAppendPolyData;
 class vtkArcSource;
@@ -162,6 +166,13 @@ public:
   /// Get the direction vector of the interaction handle from the interaction origin in world coordinates
   virtual void GetInteractionHandleVectorWorld(int type, int index, double axis[3]);
 
+  /// Labels of all control points are placed if there are less control points than this value.
+  /// Otherwise only those labels are placed that are in the view and do not overlap with
+  /// labels of higher priority, which keeps rendering fast and the view readable for large point lists.
+  /// Set to 0 to always place all labels. Default is 200.
+  vtkSetMacro(LabelDecimationMinimumNumberOfControlPoints, int);
+  vtkGetMacro(LabelDecimationMinimumNumberOfControlPoints, int);
+
 protected:
   vtkSlicerMarkupsWidgetRepresentation();
   ~vtkSlicerMarkupsWidgetRepresentation() override;
@@ -287,6 +298,50 @@ protected:
   };
   typedef std::vector<MarkupsInteractionPipeline::HandleInfo> HandleInfoList;
 
+  /// Spatial index of control point positions in display coordinates.
+  /// Control points are binned in a uniform grid, which allows finding control points
+  /// near a display position without checking all the control points.
+  /// The index is built when picking and reused until the markup or the view changes.
+  class DisplayPositionIndex
+  {
+  public:
+    struct Point
+      {
+      int ControlPointIndex;
+      double DisplayPosition[3];
+      /// Maximum distance from the display position where the control point can be picked
+      double Tolerance;
+      };
+
+    /// Remove all points. The index must be built again before it can be used.
+    void Reset();
+    /// Add a point. Points must be added in increasing control point index order.
+    void AddPoint(int controlPointIndex, const double displayPosition[3], double tolerance);
+    /// Build the grid of the added points.
+    void Build();
+    bool IsBuilt() const { return this->Built; }
+
+    /// Get points that are within their tolerance from the display position along the x and y axes.
+    /// Points are returned in increasing control point index order.
+    void FindPoints(const double displayPosition[2], std::vector<const Point*>& foundPoints) const;
+
+    /// View parameters (camera, view size, tolerances) that the index was built for.
+    /// The index has to be rebuilt if they change.
+    std::vector<double> ViewParameters;
+
+  protected:
+    long long GetBinKey(int binX, int binY) const;
+
+    std::vector<Point> Points;
+    /// Point indices (in Points) for each non-empty bin
+    std::unordered_map<long long, std::vector<int> > Bins;
+    double BinSize{1.0};
+    bool Built{false};
+  };
+
+  /// Return true if labels of the specified number of control points should be decimated.
+  bool IsLabelDecimationRequired(vtkIdType numberOfControlPoints);
+
   // Calculate view size and scale factor
   virtual void UpdateViewScaleFactor() = 0;
 
@@ -336,6 +391,11 @@ protected:
   /// Update the interaction pipeline
   virtual void UpdateInteractionPipeline();
 
+  /// Display positions of control points, for picking
+  DisplayPositionIndex ControlPointsDisplayPositionIndex;
+
+  int LabelDecimationMinimumNumberOfControlPoints;
+
 private:
   vtkSlicerMarkupsWidgetRepresentation(const vtkSlicerMarkupsWidgetRepresentation&) = delete;
   void operator=(const vtkSlicerMarkupsWidgetRepresentation&) = delete;
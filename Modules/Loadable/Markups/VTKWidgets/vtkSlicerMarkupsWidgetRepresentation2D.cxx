@@ -317,6 +317,8 @@ void vtkSlicerMarkupsWidgetRepresentation2D::UpdateAllPointsAndLabelsFromMRML(do
     controlPoints->LabelControlPointsPolyData->GetPointData()->GetNormals()->Modified();
     controlPoints->LabelControlPointsPolyData->Modified();
 
+    controlPoints->LabelsMapper->SetPlaceAllLabels(!this->IsLabelDecimationRequired(controlPoints->Labels->GetNumberOfValues()));
+
     if (controlPointType == Active)
       {
       controlPoints->Actor->VisibilityOn();
@@ -545,21 +547,17 @@ void vtkSlicerMarkupsWidgetRepresentation2D::CanInteract(
       }
     }
 
-  vtkIdType numberOfPoints = markupsNode->GetNumberOfControlPoints();
-
-  double pointDisplayPos[4] = { 0.0, 0.0, 0.0, 1.0 };
-  double pointWorldPos[4] = { 0.0, 0.0, 0.0, 1.0 };
-
-  vtkNew<vtkMatrix4x4> rasToxyMatrix;
-  sliceNode->GetXYToRAS()->Invert(sliceNode->GetXYToRAS(), rasToxyMatrix.GetPointer());
-  for (int i = 0; i < numberOfPoints; i++)
+  // Only check control points that are near the display position
+  this->UpdateControlPointsDisplayPositionIndex();
+  std::vector<const DisplayPositionIndex::Point*> foundPoints;
+  this->ControlPointsDisplayPositionIndex.FindPoints(displayPosition3, foundPoints);
+  for (const DisplayPositionIndex::Point* point : foundPoints)
     {
-    if (!this->GetNthControlPointViewVisibility(i))
+    if (!this->GetNthControlPointViewVisibility(point->ControlPointIndex))
       {
       continue;
       }
-    markupsNode->GetNthControlPointPositionWorld(i, pointWorldPos);
-    rasToxyMatrix->MultiplyPoint(pointWorldPos, pointDisplayPos);
+    double pointDisplayPos[3] = { point->DisplayPosition[0], point->DisplayPosition[1], point->DisplayPosition[2] };
     if (this->MarkupsDisplayNode->GetSliceProjection())
       {
       pointDisplayPos[2] = displayPosition3[2];
@@ -569,11 +567,52 @@ void vtkSlicerMarkupsWidgetRepresentation2D::CanInteract(
       {
       closestDistance2 = dist2;
       foundComponentType = vtkMRMLMarkupsDisplayNode::ComponentControlPoint;
-      foundComponentIndex = i;
+      foundComponentIndex = point->ControlPointIndex;
       }
     }
 }
 
+//----------------------------------------------------------------------
+void vtkSlicerMarkupsWidgetRepresentation2D::UpdateControlPointsDisplayPositionIndex()
+{
+  vtkMRMLSliceNode* sliceNode = this->GetSliceNode();
+  vtkMRMLMarkupsNode* markupsNode = this->GetMarkupsNode();
+  if (!sliceNode || !markupsNode)
+    {
+    this->ControlPointsDisplayPositionIndex.Reset();
+    return;
+    }
+
+  // Display positions depend on the slice geometry
+  double maxPickingDistanceFromControlPoint = sqrt(this->GetMaximumControlPointPickingDistance2());
+  std::vector<double> viewParameters =
+    {
+    static_cast<double>(sliceNode->GetXYToRAS()->GetMTime()),
+    maxPickingDistanceFromControlPoint
+    };
+  if (this->ControlPointsDisplayPositionIndex.IsBuilt()
+    && this->ControlPointsDisplayPositionIndex.ViewParameters == viewParameters)
+    {
+    return;
+    }
+
+  this->ControlPointsDisplayPositionIndex.Reset();
+  this->ControlPointsDisplayPositionIndex.ViewParameters = viewParameters;
+  double pointDisplayPos[4] = { 0.0, 0.0, 0.0, 1.0 };
+  double pointWorldPos[4] = { 0.0, 0.0, 0.0, 1.0 };
+  vtkNew<vtkMatrix4x4> rasToxyMatrix;
+  vtkMatrix4x4::Invert(sliceNode->GetXYToRAS(), rasToxyMatrix);
+  // Visibility on the slice is checked when picking
+  int numberOfPoints = markupsNode->GetNumberOfControlPoints();
+  for (int i = 0; i < numberOfPoints; i++)
+    {
+    markupsNode->GetNthControlPointPositionWorld(i, pointWorldPos);
+    rasToxyMatrix->MultiplyPoint(pointWorldPos, pointDisplayPos);
+    this->ControlPointsDisplayPositionIndex.AddPoint(i, pointDisplayPos, maxPickingDistanceFromControlPoint);
+    }
+  this->ControlPointsDisplayPositionIndex.Build();
+}
+
 //----------------------------------------------------------------------
 void vtkSlicerMarkupsWidgetRepresentation2D::CanInteractWithHandles(
   vtkMRMLInteractionEventData* interactionEventData,
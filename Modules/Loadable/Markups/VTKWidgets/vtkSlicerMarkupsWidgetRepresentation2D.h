@@ -119,6 +119,9 @@ protected:
   // in pixels.
   double GetMaximumControlPointPickingDistance2();
 
+  /// Build display position index of control points if it is not built for the current slice view yet
+  void UpdateControlPointsDisplayPositionIndex();
+
   bool GetAllControlPointsVisible() override;
 
   /// Check, if the point is displayable in the current slice geometry
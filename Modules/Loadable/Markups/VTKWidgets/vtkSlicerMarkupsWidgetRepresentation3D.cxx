@@ -18,6 +18,7 @@
 
 // VTK includes
 #include "vtkCamera.h"
+#include "vtkCellArray.h"
 #include "vtkCellPicker.h"
 #include "vtkLabelPlacementMapper.h"
 #include "vtkLine.h"
@@ -46,6 +47,9 @@
 #include <vtkMRMLInteractionEventData.h>
 #include <vtkMRMLViewNode.h>
 
+// STD includes
+#include <algorithm>
+
 vtkSlicerMarkupsWidgetRepresentation3D::ControlPointsPipeline3D::ControlPointsPipeline3D()
 {
   this->Glypher = vtkSmartPointer<vtkGlyph3D>::New();
@@ -149,6 +153,9 @@ vtkSlicerMarkupsWidgetRepresentation3D::ControlPointsPipeline3D::ControlPointsPi
   this->LabelsOccludedActor->SetMapper(this->LabelsOccludedMapper);
   this->LabelsOccludedActor->PickableOff();
   this->LabelsOccludedActor->DragableOff();
+
+  this->ControlPointVertices = vtkSmartPointer<vtkCellArray>::New();
+  this->RenderAsPointSprites = false;
 };
 
 vtkSlicerMarkupsWidgetRepresentation3D::ControlPointsPipeline3D::~ControlPointsPipeline3D() = default;
@@ -189,6 +196,8 @@ vtkSlicerMarkupsWidgetRepresentation3D::vtkSlicerMarkupsWidgetRepresentation3D()
   // while still providing enough leeway to ensure that occluded actors are rendered correctly relative to themselves
   // and to other occluded actors.
   this->OccludedRelativeOffset = -25000;
+
+  this->PointSpriteMinimumNumberOfControlPoints = 1000;
 }
 
 //----------------------------------------------------------------------
@@ -290,6 +299,12 @@ void vtkSlicerMarkupsWidgetRepresentation3D::UpdateAllPointsAndLabelsFromMRML()
       controlPoints->ControlPointIndices->InsertNextValue(pointIndex);
       }
 
+    this->UpdatePointSpriteRendering(controlPoints);
+
+    bool placeAllLabels = !this->IsLabelDecimationRequired(controlPoints->ControlPointIndices->GetNumberOfValues());
+    controlPoints->LabelsMapper->SetPlaceAllLabels(placeAllLabels);
+    controlPoints->LabelsOccludedMapper->SetPlaceAllLabels(placeAllLabels);
+
     if (controlPoints->ControlPointIndices->GetNumberOfValues() > 0)
       {
       controlPoints->ControlPoints->Modified();
@@ -394,6 +409,34 @@ void vtkSlicerMarkupsWidgetRepresentation3D::CanInteract(
       }
     }
 
+  // Occluded control points can be picked if they are displayed
+  bool occludedPointsPickable = (this->MarkupsDisplayNode
+    && this->MarkupsDisplayNode->GetOccludedVisibility()
+    && this->MarkupsDisplayNode->GetOccludedOpacity() > 0.0);
+
+  if (interactionEventData->IsDisplayPositionValid())
+    {
+    // Only check control points that are near the display position
+    this->UpdateControlPointsDisplayPositionIndex();
+    std::vector<const DisplayPositionIndex::Point*> foundPoints;
+    this->ControlPointsDisplayPositionIndex.FindPoints(displayPosition3, foundPoints);
+    for (const DisplayPositionIndex::Point* point : foundPoints)
+      {
+      double dist2 = vtkMath::Distance2BetweenPoints(point->DisplayPosition, displayPosition3);
+      if (dist2 < point->Tolerance * point->Tolerance && dist2 < closestDistance2
+        && (occludedPointsPickable || this->GetNthControlPointViewVisibility(point->ControlPointIndex)))
+        {
+        closestDistance2 = dist2;
+        foundComponentType = vtkMRMLMarkupsDisplayNode::ComponentControlPoint;
+        foundComponentIndex = point->ControlPointIndex;
+        }
+      }
+    return;
+    }
+
+  const double* worldPosition = interactionEventData->GetWorldPosition();
+  double worldTolerance = this->ControlPointSize / 2.0 +
+    this->PickingTolerance / interactionEventData->GetWorldToPhysicalScale();
   vtkIdType numberOfPoints = markupsNode->GetNumberOfControlPoints();
   for (int i = 0; i < numberOfPoints; i++)
     {
@@ -401,94 +444,125 @@ void vtkSlicerMarkupsWidgetRepresentation3D::CanInteract(
       {
       continue;
       }
-    double centerPosWorld[4] = { 0.0, 0.0, 0.0, 1.0 };
-    double centerPosDisplay[4] = { 0.0, 0.0, 0.0, 1.0 };
+    double centerPosWorld[3] = { 0.0, 0.0, 0.0 };
     markupsNode->GetNthControlPointPositionWorld(i, centerPosWorld);
-    this->Renderer->SetWorldPoint(centerPosWorld);
-
-    // Check SelectVisiblePoints output to see if the point is occluded or not.
-    // SelectVisiblePoints is very sensitive to when it is executed (it has to check the z buffer after
-    // opaque geometry is rendered but 2D labels are not yet), therefore we do not
-    // update its output but just use the last output generated for the last rendering.
-    bool pointVisible = false;
-    if (this->MarkupsDisplayNode
-      && this->MarkupsDisplayNode->GetOccludedVisibility()
-      && this->MarkupsDisplayNode->GetOccludedOpacity() > 0.0)
+    double dist2 = vtkMath::Distance2BetweenPoints(centerPosWorld, worldPosition);
+    if (dist2 < worldTolerance * worldTolerance && dist2 < closestDistance2
+      && (occludedPointsPickable || this->GetNthControlPointViewVisibility(i)))
       {
-      pointVisible = true;
+      closestDistance2 = dist2;
+      foundComponentType = vtkMRMLMarkupsDisplayNode::ComponentControlPoint;
+      foundComponentIndex = i;
       }
-    for (int controlPointType = 0; controlPointType <= Active && !pointVisible; ++controlPointType)
+    }
+}
+
+//----------------------------------------------------------------------
+void vtkSlicerMarkupsWidgetRepresentation3D::UpdateControlPointsDisplayPositionIndex()
+{
+  vtkMRMLMarkupsNode* markupsNode = this->GetMarkupsNode();
+  if (!markupsNode || !this->Renderer || !this->Renderer->GetActiveCamera())
+    {
+    this->ControlPointsDisplayPositionIndex.Reset();
+    return;
+    }
+
+  // Display positions and picking tolerances depend on the camera and the renderer size
+  int* rendererSize = this->Renderer->GetSize();
+  std::vector<double> viewParameters =
+    {
+    static_cast<double>(this->Renderer->GetActiveCamera()->GetMTime()),
+    static_cast<double>(rendererSize[0]),
+    static_cast<double>(rendererSize[1]),
+    this->ControlPointSize,
+    this->PickingTolerance * this->ScreenScaleFactor
+    };
+  if (this->ControlPointsDisplayPositionIndex.IsBuilt()
+    && this->ControlPointsDisplayPositionIndex.ViewParameters == viewParameters)
+    {
+    return;
+    }
+
+  this->ControlPointsDisplayPositionIndex.Reset();
+  this->ControlPointsDisplayPositionIndex.ViewParameters = viewParameters;
+  int numberOfPoints = markupsNode->GetNumberOfControlPoints();
+  for (int i = 0; i < numberOfPoints; i++)
+    {
+    if (!markupsNode->GetNthControlPointVisibility(i))
       {
-      if ((controlPointType == Unselected && markupsNode->GetNthControlPointSelected(i))
-        || (controlPointType == Selected && !markupsNode->GetNthControlPointSelected(i)))
-        {
-        continue;
-        }
-      ControlPointsPipeline3D* controlPoints = this->GetControlPointsPipeline(controlPointType);
-      vtkPolyData* visiblePointsPoly = controlPoints->SelectVisiblePoints->GetOutput();
-      if (!visiblePointsPoly || !visiblePointsPoly->GetPointData())
-        {
-        continue;
-        }
-      vtkIdTypeArray* visiblePointIndices = vtkIdTypeArray::SafeDownCast(visiblePointsPoly->GetPointData()->GetAbstractArray("controlPointIndices"));
-      if (!visiblePointIndices)
-        {
-        continue;
-        }
-      if (visiblePointIndices->LookupValue(i) >= 0)
-        {
-        // visible
-        pointVisible = true;
-        break;
-        }
+      continue;
       }
+    double pointPosWorld[3] = { 0.0, 0.0, 0.0 };
+    markupsNode->GetNthControlPointPositionWorld(i, pointPosWorld);
+    double pixelTolerance = this->ControlPointSize / 2.0 / this->GetViewScaleFactorAtPosition(pointPosWorld)
+      + this->PickingTolerance * this->ScreenScaleFactor;
+    double pointPosDisplay[3] = { 0.0, 0.0, 0.0 };
+    this->Renderer->SetWorldPoint(pointPosWorld[0], pointPosWorld[1], pointPosWorld[2], 1.0);
+    this->Renderer->WorldToDisplay();
+    this->Renderer->GetDisplayPoint(pointPosDisplay);
+    pointPosDisplay[2] = 0.0;
+    this->ControlPointsDisplayPositionIndex.AddPoint(i, pointPosDisplay, pixelTolerance);
+    }
+  this->ControlPointsDisplayPositionIndex.Build();
+}
 
-    if (interactionEventData->IsDisplayPositionValid())
+//----------------------------------------------------------------------
+void vtkSlicerMarkupsWidgetRepresentation3D::UpdatePointSpriteRendering(ControlPointsPipeline3D* controlPoints)
+{
+  vtkIdType numberOfPoints = controlPoints->ControlPointIndices->GetNumberOfValues();
+  bool renderAsPointSprites = this->PointSpriteMinimumNumberOfControlPoints > 0
+    && numberOfPoints >= this->PointSpriteMinimumNumberOfControlPoints;
+
+  if (renderAsPointSprites)
+    {
+    // Point sprites are rendered from vertex cells, no glyph geometry is generated
+    if (controlPoints->ControlPointVertices->GetNumberOfCells() != numberOfPoints)
       {
-      double pixelTolerance = this->ControlPointSize / 2.0 / this->GetViewScaleFactorAtPosition(centerPosWorld)
-        + this->PickingTolerance * this->ScreenScaleFactor;
-      this->Renderer->SetWorldPoint(centerPosWorld);
-      this->Renderer->WorldToDisplay();
-      this->Renderer->GetDisplayPoint(centerPosDisplay);
-      centerPosDisplay[2] = 0.0;
-      double dist2 = vtkMath::Distance2BetweenPoints(centerPosDisplay, displayPosition3);
-      if (dist2 < pixelTolerance * pixelTolerance && dist2 < closestDistance2 && pointVisible)
+      controlPoints->ControlPointVertices->Initialize();
+      controlPoints->ControlPointVertices->AllocateExact(numberOfPoints, numberOfPoints);
+      for (vtkIdType pointIndex = 0; pointIndex < numberOfPoints; ++pointIndex)
         {
-        closestDistance2 = dist2;
-        foundComponentType = vtkMRMLMarkupsDisplayNode::ComponentControlPoint;
-        foundComponentIndex = i;
+        controlPoints->ControlPointVertices->InsertNextCell(1, &pointIndex);
         }
+      controlPoints->ControlPointsPolyData->SetVerts(controlPoints->ControlPointVertices);
       }
-    else
+    if (!controlPoints->RenderAsPointSprites)
       {
-      const double* worldPosition = interactionEventData->GetWorldPosition();
-      double worldTolerance = this->ControlPointSize / 2.0 +
-        this->PickingTolerance / interactionEventData->GetWorldToPhysicalScale();
-      double dist2 = vtkMath::Distance2BetweenPoints(centerPosWorld, worldPosition);
-      if (dist2 < worldTolerance * worldTolerance && dist2 < closestDistance2 && pointVisible)
-        {
-        closestDistance2 = dist2;
-        foundComponentType = vtkMRMLMarkupsDisplayNode::ComponentControlPoint;
-        foundComponentIndex = i;
-        }
+      controlPoints->Mapper->SetInputData(controlPoints->ControlPointsPolyData);
+      controlPoints->OccludedMapper->SetInputData(controlPoints->ControlPointsPolyData);
       }
+    bool renderPointsAsSpheres = this->MarkupsDisplayNode && this->MarkupsDisplayNode->GlyphTypeIs3D();
+    double pointSizePixel = this->GetPointSpriteSizePixel();
+    controlPoints->Property->SetRenderPointsAsSpheres(renderPointsAsSpheres);
+    controlPoints->Property->SetPointSize(pointSizePixel);
+    controlPoints->OccludedProperty->SetRenderPointsAsSpheres(renderPointsAsSpheres);
+    controlPoints->OccludedProperty->SetPointSize(pointSizePixel);
     }
+  else if (controlPoints->RenderAsPointSprites)
+    {
+    controlPoints->ControlPointVertices->Initialize();
+    controlPoints->ControlPointsPolyData->SetVerts(nullptr);
+    controlPoints->Mapper->SetInputConnection(controlPoints->Glypher->GetOutputPort());
+    controlPoints->OccludedMapper->SetInputConnection(controlPoints->Glypher->GetOutputPort());
+    controlPoints->Property->SetRenderPointsAsSpheres(false);
+    controlPoints->Property->SetPointSize(3.);
+    controlPoints->OccludedProperty->SetRenderPointsAsSpheres(false);
+    controlPoints->OccludedProperty->SetPointSize(3.);
+    }
+  controlPoints->RenderAsPointSprites = renderAsPointSprites;
+}
 
-  /* This would probably faster for many points:
-
-  this->BuildLocator();
-
-  double closestDistance2 = VTK_DOUBLE_MAX;
-  int closestNode = static_cast<int> (this->Locator->FindClosestPointWithinRadius(
-    this->PixelTolerance, displayPos, closestDistance2));
-
-  if (closestNode != this->GetActiveNode())
+//----------------------------------------------------------------------
+double vtkSlicerMarkupsWidgetRepresentation3D::GetPointSpriteSizePixel()
+{
+  if (!this->Renderer || !this->Renderer->GetActiveCamera())
     {
-    this->SetActiveNode(closestNode);
-    this->NeedToRender = 1;
+    return this->ControlPointSize;
     }
-  return (this->GetActiveNode() >= 0);
-  */
+  // Sprites have the same size in screen space, use the glyph size at the focal point
+  double cameraFP[3] = { 0.0 };
+  this->Renderer->GetActiveCamera()->GetFocalPoint(cameraFP);
+  return std::max(1.0, this->ControlPointSize / this->GetViewScaleFactorAtPosition(cameraFP));
 }
 
 //----------------------------------------------------------------------
@@ -907,6 +981,13 @@ int vtkSlicerMarkupsWidgetRepresentation3D::RenderOpaqueGeometry(
         controlPoints->Glypher->SetScaleFactor(this->ControlPointSize);
         controlPoints->SelectVisiblePoints->SetToleranceWorld(this->ControlPointSize * 0.7);
         }
+      if (controlPoints->RenderAsPointSprites)
+        {
+        // Size of sprites in pixels changes as the camera is zoomed
+        double pointSizePixel = this->GetPointSpriteSizePixel();
+        controlPoints->Property->SetPointSize(pointSizePixel);
+        controlPoints->OccludedProperty->SetPointSize(pointSizePixel);
+        }
       count += controlPoints->Actor->RenderOpaqueGeometry(viewport);
       }
     if (controlPoints->OccludedActor->GetVisibility())
@@ -1048,6 +1129,7 @@ void vtkSlicerMarkupsWidgetRepresentation3D::PrintSelf(ostream& os,
       os << indent << "Property: (none)\n";
       }
     }
+  os << indent << "Point Sprite Minimum Number Of Control Points: " << this->PointSpriteMinimumNumberOfControlPoints << "\n";
   if (this->TextActor)
     {
     os << indent << "Text Visibility: " << this->TextActor->GetVisibility() << "\n";
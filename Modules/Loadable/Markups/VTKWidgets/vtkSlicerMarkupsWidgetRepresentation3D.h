@@ -32,6 +32,7 @@
 
 class vtkActor;
 class vtkActor2D;
+class vtkCellArray;
 class vtkCellPicker;
 class vtkGlyph3D;
 class vtkLabelPlacementMapper;
@@ -92,6 +93,14 @@ public:
   vtkSetMacro(OccludedRelativeOffset, double);
   vtkGetMacro(OccludedRelativeOffset, double);
 
+  /// Control points are rendered as point sprites if there are at least this many control points.
+  /// Point sprites are drawn by the GPU directly from the control point positions (as shaded spheres
+  /// for 3D glyph types and as squares for 2D glyph types), which is much faster than generating
+  /// and rendering glyph geometry for each control point. Size of point sprites is fixed in screen space.
+  /// Set to 0 to always render glyphs. Default is 1000.
+  vtkSetMacro(PointSpriteMinimumNumberOfControlPoints, int);
+  vtkGetMacro(PointSpriteMinimumNumberOfControlPoints, int);
+
 protected:
   vtkSlicerMarkupsWidgetRepresentation3D();
   ~vtkSlicerMarkupsWidgetRepresentation3D() override;
@@ -104,6 +113,9 @@ protected:
 
   void UpdateInteractionPipeline() override;
 
+  /// Build display position index of control points if it is not built for the current view yet
+  void UpdateControlPointsDisplayPositionIndex();
+
   class ControlPointsPipeline3D : public ControlPointsPipeline
   {
   public:
@@ -131,6 +143,10 @@ protected:
     vtkSmartPointer<vtkActor>   OccludedActor;
     vtkSmartPointer<vtkActor2D> LabelsActor;
     vtkSmartPointer<vtkActor2D> LabelsOccludedActor;
+
+    /// Vertex cells of control points, used for rendering point sprites
+    vtkSmartPointer<vtkCellArray> ControlPointVertices;
+    bool RenderAsPointSprites;
   };
 
   ControlPointsPipeline3D* GetControlPointsPipeline(int controlPointType);
@@ -139,6 +155,11 @@ protected:
 
   virtual void UpdateAllPointsAndLabelsFromMRML();
 
+  /// Switch between rendering glyphs and point sprites in the pipeline
+  void UpdatePointSpriteRendering(ControlPointsPipeline3D* controlPoints);
+  /// Get size of point sprites in pixels, corresponding to the control point size at the camera focal point
+  double GetPointSpriteSizePixel();
+
   /// Update the occluded relative offsets for an occluded mapper
   /// Allows occluded regions to be rendered on top.
   /// Sets the folowing parameter on the mappers:
@@ -154,6 +175,7 @@ protected:
   bool TextActorOccluded;
   bool HideTextActorIfAllPointsOccluded;
   double OccludedRelativeOffset;
+  int PointSpriteMinimumNumberOfControlPoints;
 
 private:
   vtkSlicerMarkupsWidgetRepresentation3D(const vtkSlicerMarkupsWidgetRepresentation3D&) = delete;
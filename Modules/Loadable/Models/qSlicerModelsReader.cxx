@@ -85,7 +85,7 @@ QStringList qSlicerModelsReader::extensions()const
 {
   return QStringList()
     << "Model (*.vtk *.vtp  *.vtu *.g *.byu *.stl *.ply *.orig"
-         " *.inflated *.sphere *.white *.smoothwm *.pial *.obj *.ucd)";
+         " *.inflated *.sphere *.white *.smoothwm *.pial *.obj *.ucd *.bmesh)";
 }
 
 //-----------------------------------------------------------------------------
@@ -285,9 +285,12 @@ If segments overlap, segment higher in the segments table will have priority. <b
           clippedSelectedSegmentLabelmap = selectedSegmentLabelmap
 
         if smoothingMethod == MEDIAN:
-          # Median filter does not require a particular label value
-          smoothingFilter = vtk.vtkImageMedian3D()
+          # Median filter does not require a particular label value.
+          # The ITK filter computes the median using a sliding histogram, which is fast even for large kernels.
+          import vtkITK
+          smoothingFilter = vtkITK.vtkITKMedianImageFilter()
           smoothingFilter.SetInputData(clippedSelectedSegmentLabelmap)
+          smoothingFilter.SetRadius(int(kernelSizePixel[0]/2), int(kernelSizePixel[1]/2), int(kernelSizePixel[2]/2))
 
         else:
           # We need to know exactly the value of the segment voxels, apply threshold to make force the selected label value
@@ -308,8 +311,8 @@ If segments overlap, segment higher in the segments table will have priority. <b
           else: # must be smoothingMethod == MORPHOLOGICAL_CLOSING:
             smoothingFilter.SetOpenValue(backgroundValue)
             smoothingFilter.SetCloseValue(labelValue)
+          smoothingFilter.SetKernelSize(kernelSizePixel[0],kernelSizePixel[1],kernelSizePixel[2])
 
-        smoothingFilter.SetKernelSize(kernelSizePixel[0],kernelSizePixel[1],kernelSizePixel[2])
         smoothingFilter.Update()
 
         self.modifySelectedSegmentByLabelmap(smoothingFilter.GetOutput(), selectedSegmentLabelmap, modifierLabelmap, maskImage, maskExtent)
@@ -675,10 +675,12 @@ class SegmentEditorThresholdEffect(AbstractScriptedSegmentEditorEffect):
     # Set values to pipelines
     for sliceWidget in self.previewPipelines:
       pipeline = self.previewPipelines[sliceWidget]
-      pipeline.lookupTable.SetTableValue(1,  r, g, b,  opacity)
+      # Threshold is applied by the lookup table directly on the resliced master volume,
+      # therefore changing the threshold range only requires mapping the displayed slice to colors
+      pipeline.lookupTable.SetTableValue(0,  r, g, b,  opacity)
+      pipeline.lookupTable.SetTableRange(min, max)
       layerLogic = self.getMasterVolumeLayerLogic(sliceWidget)
-      pipeline.thresholdFilter.SetInputConnection(layerLogic.GetReslice().GetOutputPort())
-      pipeline.thresholdFilter.ThresholdBetween(min, max)
+      pipeline.colorMapper.SetInputConnection(layerLogic.GetReslice().GetOutputPort())
       pipeline.actor.VisibilityOn()
       sliceWidget.sliceView().scheduleRender()
 
@@ -923,18 +925,19 @@ class PreviewPipeline(object):
   """
 
   def __init__(self):
+    # Voxels within the table range are shown in the segment color,
+    # voxels outside the range are transparent
     self.lookupTable = vtk.vtkLookupTable()
-    self.lookupTable.SetRampToLinear()
-    self.lookupTable.SetNumberOfTableValues(2)
+    self.lookupTable.SetNumberOfTableValues(1)
     self.lookupTable.SetTableRange(0, 1)
     self.lookupTable.SetTableValue(0,  0, 0, 0,  0)
+    self.lookupTable.UseBelowRangeColorOn()
+    self.lookupTable.SetBelowRangeColor(0, 0, 0, 0)
+    self.lookupTable.UseAboveRangeColorOn()
+    self.lookupTable.SetAboveRangeColor(0, 0, 0, 0)
     self.colorMapper = vtk.vtkImageMapToRGBA()
     self.colorMapper.SetOutputFormatToRGBA()
     self.colorMapper.SetLookupTable(self.lookupTable)
-    self.thresholdFilter = vtk.vtkImageThreshold()
-    self.thresholdFilter.SetInValue(1)
-    self.thresholdFilter.SetOutValue(0)
-    self.thresholdFilter.SetOutputScalarTypeToUnsignedChar()
 
     # Feedback actor
     self.mapper = vtk.vtkImageMapper()
@@ -947,8 +950,7 @@ class PreviewPipeline(object):
     self.mapper.SetColorWindow(255)
     self.mapper.SetColorLevel(128)
 
-    # Setup pipeline
-    self.colorMapper.SetInputConnection(self.thresholdFilter.GetOutputPort())
+    # Setup pipeline (color mapper input is set to the master volume reslice output in preview)
     self.mapper.SetInputConnection(self.colorMapper.GetOutputPort())
 
 ###
@@ -48,10 +48,7 @@
 #include <vtkGlyph2D.h>
 #include <vtkGlyph3D.h>
 #include <vtkIdList.h>
-#include <vtkImageChangeInformation.h>
-#include <vtkImageStencil.h>
 #include <vtkImageStencilData.h>
-#include <vtkImageStencilToImage.h>
 #include <vtkMath.h>
 #include <vtkMatrix4x4.h>
 #include <vtkNew.h>
@@ -94,7 +91,81 @@
 #include "qSlicerApplication.h"
 #include "vtkMRMLSliceLogic.h"
 #include "vtkMRMLSliceLayerLogic.h"
-#include "vtkOrientedImageDataResample.h"
+
+namespace
+{
+
+//-----------------------------------------------------------------------------
+/// Grow extent to include a box
+void ExpandExtent(int extent[6], const int boxExtent[6])
+{
+  bool extentEmpty = (extent[0] > extent[1] || extent[2] > extent[3] || extent[4] > extent[5]);
+  for (int i = 0; i < 3; ++i)
+    {
+    if (extentEmpty || boxExtent[2 * i] < extent[2 * i])
+      {
+      extent[2 * i] = boxExtent[2 * i];
+      }
+    if (extentEmpty || boxExtent[2 * i + 1] > extent[2 * i + 1])
+      {
+      extent[2 * i + 1] = boxExtent[2 * i + 1];
+      }
+    }
+}
+
+//-----------------------------------------------------------------------------
+/// Rasterize the stencil directly into the labelmap, translated by the specified number of voxels.
+/// Voxels inside the stencil are set to fillValue if their current value is lower (same as maximum
+/// operation with a brush image). The extent of the painted voxels is added to modifiedExtent.
+template <class T>
+void PaintStencilIntoLabelmap(vtkImageStencilData* stencil, const int shift[3], vtkImageData* labelmap,
+  T fillValue, int modifiedExtent[6])
+{
+  int stencilExtent[6] = { 0, -1, 0, -1, 0, -1 };
+  stencil->GetExtent(stencilExtent);
+  int labelmapExtent[6] = { 0, -1, 0, -1, 0, -1 };
+  labelmap->GetExtent(labelmapExtent);
+  vtkIdType increments[3] = { 0, 0, 0 };
+  labelmap->GetIncrements(increments);
+  T* labelmapPtr = static_cast<T*>(labelmap->GetScalarPointer());
+
+  // Only rows that are within the labelmap after translation are processed
+  int jMin = std::max(stencilExtent[2], labelmapExtent[2] - shift[1]);
+  int jMax = std::min(stencilExtent[3], labelmapExtent[3] - shift[1]);
+  int kMin = std::max(stencilExtent[4], labelmapExtent[4] - shift[2]);
+  int kMax = std::min(stencilExtent[5], labelmapExtent[5] - shift[2]);
+  for (int k = kMin; k <= kMax; ++k)
+    {
+    for (int j = jMin; j <= jMax; ++j)
+      {
+      T* rowPtr = labelmapPtr + (k + shift[2] - labelmapExtent[4]) * increments[2]
+        + (j + shift[1] - labelmapExtent[2]) * increments[1];
+      int iter = 0;
+      int r1 = 0;
+      int r2 = 0;
+      while (stencil->GetNextExtent(r1, r2, stencilExtent[0], stencilExtent[1], j, k, iter))
+        {
+        int iMin = std::max(r1 + shift[0], labelmapExtent[0]);
+        int iMax = std::min(r2 + shift[0], labelmapExtent[1]);
+        if (iMin > iMax)
+          {
+          continue;
+          }
+        for (T* voxelPtr = rowPtr + (iMin - labelmapExtent[0]); voxelPtr <= rowPtr + (iMax - labelmapExtent[0]); ++voxelPtr)
+          {
+          if (*voxelPtr < fillValue)
+            {
+            *voxelPtr = fillValue;
+            }
+          }
+        int runExtent[6] = { iMin, iMax, j + shift[1], j + shift[1], k + shift[2], k + shift[2] };
+        ExpandExtent(modifiedExtent, runExtent);
+        }
+      }
+    }
+}
+
+} // end of anonymous namespace
 
 //-----------------------------------------------------------------------------
 /// Visualization objects and pipeline for each slice view for the paint brush
@@ -505,11 +576,8 @@ void qSlicerSegmentEditorPaintEffectPrivate::paintPixels(
       continue;
       }
 
-    for (int i = 0; i < 3; ++i)
-      {
-      updateExtent[2 * i] = std::max(updateExtent[2 * i], ijk[i]);
-      updateExtent[2 * i + 1] = std::min(updateExtent[2 * i + 1], ijk[i]);
-      }
+    int pixelExtent[6] = { ijk[0], ijk[0], ijk[1], ijk[1], ijk[2], ijk[2] };
+    ExpandExtent(updateExtent, pixelExtent);
     modifierLabelmap->SetScalarComponentFromDouble(ijk[0], ijk[1], ijk[2], 0, valueToSet);
     }
   modifierLabelmap->Modified();
@@ -539,55 +607,37 @@ void qSlicerSegmentEditorPaintEffectPrivate::paintBrushes(
     return;
     }
 
+  // The brush is rasterized once into a stencil (in a labelmap IJK coordinate system centered at the brush origin)
+  // and the stencil runs are written directly into the labelmap at each brush position.
   this->BrushPolyDataToStencil->Update();
   vtkImageStencilData* stencilData = this->BrushPolyDataToStencil->GetOutput();
-  int stencilExtent[6]={0,-1,0,-1,0,-1};
-  stencilData->GetExtent(stencilExtent);
 
   vtkNew<vtkPoints> paintCoordinates_Ijk;
   this->transformPointsFromWorldToIJK(modifierLabelmap, segmentationNode, this->PaintCoordinates_World, paintCoordinates_Ijk);
 
-  vtkNew<vtkImageStencilToImage> stencilToImage;
-  stencilToImage->SetInputConnection(this->BrushPolyDataToStencil->GetOutputPort());
-  stencilToImage->SetInsideValue(q->m_FillValue);
-  stencilToImage->SetOutsideValue(q->m_EraseValue);
-  stencilToImage->SetOutputScalarType(modifierLabelmap->GetScalarType());
-
-  vtkNew<vtkImageChangeInformation> brushPositioner;
-  brushPositioner->SetInputConnection(stencilToImage->GetOutputPort());
-  brushPositioner->SetOutputSpacing(modifierLabelmap->GetSpacing());
-  brushPositioner->SetOutputOrigin(modifierLabelmap->GetOrigin());
-
+  // Only the painted voxels are included in the update extent, which is then used
+  // for limiting the region that segment modification, undo state and surface update need to process.
+  int paintedExtent[6] = { 0, -1, 0, -1, 0, -1 };
   vtkIdType numberOfPoints = this->PaintCoordinates_World->GetNumberOfPoints();
   for (int pointIndex = 0; pointIndex < numberOfPoints; pointIndex++)
     {
     double* shiftDouble = paintCoordinates_Ijk->GetPoint(pointIndex);
     int shift[3] = {vtkMath::Round(shiftDouble[0]), vtkMath::Round(shiftDouble[1]), vtkMath::Round(shiftDouble[2])};
-    brushPositioner->SetExtentTranslation(shift);
-    brushPositioner->Update();
-    vtkNew<vtkOrientedImageData> orientedBrushPositionerOutput;
-    orientedBrushPositionerOutput->ShallowCopy(brushPositioner->GetOutput());
-    orientedBrushPositionerOutput->CopyDirections(modifierLabelmap);
-    if (pointIndex == 0)
+    switch (modifierLabelmap->GetScalarType())
       {
-      orientedBrushPositionerOutput->GetExtent(updateExtent);
+      vtkTemplateMacro(PaintStencilIntoLabelmap<VTK_TT>(stencilData, shift, modifierLabelmap,
+        static_cast<VTK_TT>(q->m_FillValue), paintedExtent));
+      default:
+        qCritical() << Q_FUNC_INFO << ": Unknown modifier labelmap scalar type";
+        return;
       }
-    else
+    }
+  if (updateExtent)
+    {
+    for (int i = 0; i < 6; i++)
       {
-      int* brushExtent = orientedBrushPositionerOutput->GetExtent();
-      for (int i = 0; i < 3; i++)
-        {
-        if (brushExtent[i * 2] < updateExtent[i * 2])
-          {
-          updateExtent[i * 2] = brushExtent[i * 2];
-          }
-        if (brushExtent[i * 2 + 1] > updateExtent[i * 2 + 1])
-          {
-          updateExtent[i * 2 + 1] = brushExtent[i * 2 + 1];
-          }
-        }
+      updateExtent[i] = paintedExtent[i];
       }
-    vtkOrientedImageDataResample::ModifyImage(modifierLabelmap, orientedBrushPositionerOutput.GetPointer(), vtkOrientedImageDataResample::OPERATION_MAXIMUM);
     }
   modifierLabelmap->Modified();
 }
@@ -1712,8 +1762,6 @@ void qSlicerSegmentEditorPaintEffect::paintApply(qMRMLWidget* viewWidget)
     return;
     }
 
-  this->saveStateForUndo();
-
   QList<int> updateExtentList;
   int updateExtent[6] = { 0, -1, 0, -1, 0, -1 };
 
@@ -1733,11 +1781,20 @@ void qSlicerSegmentEditorPaintEffect::paintApply(qMRMLWidget* viewWidget)
     updateExtent[2 * i] = std::max(updateExtent[2 * i], modifierExtent[2 * i]);
     updateExtent[2 * i + 1] = std::min(updateExtent[2 * i + 1], modifierExtent[2 * i + 1]);
     }
+  if (updateExtent[0] > updateExtent[1] || updateExtent[2] > updateExtent[3] || updateExtent[4] > updateExtent[5])
+    {
+    // Nothing was painted within the labelmap (empty extent would mean the whole labelmap for segment modification)
+    d->clearBrushPipelines();
+    d->PaintCoordinates_World->Reset();
+    return;
+    }
   for (int i = 0; i < 6; i++)
     {
     updateExtentList << updateExtent[i];
     }
 
+  this->saveStateForUndo();
+
   // Notify editor about changes
   qSlicerSegmentEditorAbstractEffect::ModificationMode modificationMode;
   if (this->m_AlwaysErase)
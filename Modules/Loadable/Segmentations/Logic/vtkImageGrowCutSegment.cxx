@@ -1,6 +1,11 @@
 #include "vtkImageGrowCutSegment.h"
 
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
 #include <iostream>
+#include <limits>
+#include <thread>
 #include <vector>
 
 #include <vtkInformation.h>
@@ -8,24 +13,156 @@
 #include <vtkMath.h>
 #include <vtkNew.h>
 #include <vtkObjectFactory.h>
+#include <vtkSMPTools.h>
 #include <vtkSmartPointer.h>
 #include <vtkStreamingDemandDrivenPipeline.h>
 #include <vtkTimerLog.h>
 
-#include "FibHeap.h"
-
 vtkStandardNewMacro(vtkImageGrowCutSegment);
 
 //----------------------------------------------------------------------------
 
+// type for cost function - single precision is enough
+typedef float NodeKeyValueType;
 const int NodeKeyValueTypeID = VTK_FLOAT;  // must match NodeKeyValueType, stores "distance" (difference in voxels)
 
+// type for storing a pixel index
+// Images containing more than 2^32 voxels would take too much time and memory to grow-cut anyway,
+// so 32-bit indices are used to reduce memory usage.
+typedef unsigned int NodeIndexType;
+
 typedef unsigned char MaskPixelType;
 const int MaskPixelTypeID = VTK_UNSIGNED_CHAR;
 
 const NodeKeyValueType DIST_INF = std::numeric_limits<NodeKeyValueType>::max();
 const NodeKeyValueType DIST_EPSILON = 1e-3;
 
+// Minimum number of slices in a partition that is processed by a separate thread.
+// Thinner partitions would need too many rounds of boundary exchange.
+const int MINIMUM_PARTITION_THICKNESS = 32;
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+/// Monotone priority queue of voxel indices, keyed by distance (radix heap).
+/// Non-negative floating-point distances are ordered the same way as their bit patterns, so entries are
+/// stored in buckets by the highest bit that differs from the last extracted key. Each entry is moved to
+/// a lower bucket at most 32 times, and only 8 bytes are stored per entry.
+/// Pushed keys must not be smaller than the last extracted key (this holds for Dijkstra's algorithm),
+/// except when the queue is empty.
+class DistanceRadixHeap
+{
+public:
+  void Push(NodeKeyValueType distance, NodeIndexType index)
+    {
+    if (this->Size == 0)
+      {
+      this->LastKey = 0;
+      }
+    Entry entry = { ToKey(distance), index };
+    this->Buckets[GetBucketIndex(entry.Key, this->LastKey)].push_back(entry);
+    ++this->Size;
+    }
+
+  bool Pop(NodeKeyValueType& distance, NodeIndexType& index)
+    {
+    if (this->Size == 0)
+      {
+      return false;
+      }
+    if (this->Buckets[0].empty())
+      {
+      // Redistribute the first non-empty bucket, using its minimum as the new last key
+      int bucketIndex = 1;
+      while (this->Buckets[bucketIndex].empty())
+        {
+        ++bucketIndex;
+        }
+      std::vector<Entry>& bucket = this->Buckets[bucketIndex];
+      uint32_t minimumKey = bucket[0].Key;
+      for (const Entry& entry : bucket)
+        {
+        minimumKey = std::min(minimumKey, entry.Key);
+        }
+      this->LastKey = minimumKey;
+      for (const Entry& entry : bucket)
+        {
+        this->Buckets[GetBucketIndex(entry.Key, this->LastKey)].push_back(entry);
+        }
+      bucket.clear();
+      }
+    Entry entry = this->Buckets[0].back();
+    this->Buckets[0].pop_back();
+    --this->Size;
+    distance = FromKey(entry.Key);
+    index = entry.Index;
+    return true;
+    }
+
+  bool IsEmpty() const { return this->Size == 0; }
+
+  /// Remove all entries and release memory
+  void Clear()
+    {
+    for (int bucketIndex = 0; bucketIndex < NumberOfBuckets; ++bucketIndex)
+      {
+      std::vector<Entry>().swap(this->Buckets[bucketIndex]);
+      }
+    this->Size = 0;
+    this->LastKey = 0;
+    }
+
+private:
+  struct Entry
+    {
+    uint32_t Key;
+    NodeIndexType Index;
+    };
+
+  static uint32_t ToKey(NodeKeyValueType distance)
+    {
+    uint32_t key = 0;
+    memcpy(&key, &distance, sizeof(key));
+    return key;
+    }
+
+  static NodeKeyValueType FromKey(uint32_t key)
+    {
+    NodeKeyValueType distance = 0;
+    memcpy(&distance, &key, sizeof(key));
+    return distance;
+    }
+
+  /// Bucket 0 contains keys equal to the last key, bucket i contains keys whose highest differing bit is bit i-1
+  static int GetBucketIndex(uint32_t key, uint32_t lastKey)
+    {
+    uint32_t difference = key ^ lastKey;
+    if (difference == 0)
+      {
+      return 0;
+      }
+#if defined(__GNUC__) || defined(__clang__)
+    return 32 - __builtin_clz(difference);
+#else
+    int bucketIndex = 0;
+    while (difference)
+      {
+      ++bucketIndex;
+      difference >>= 1;
+      }
+    return bucketIndex;
+#endif
+    }
+
+  static const int NumberOfBuckets = 33;
+  std::vector<Entry> Buckets[NumberOfBuckets];
+  uint32_t LastKey{0};
+  size_t Size{0};
+};
+
+} // end of anonymous namespace
+
 //----------------------------------------------------------------------------
 class vtkImageGrowCutSegment::vtkInternal
 {
@@ -48,6 +185,36 @@ public:
   template< class SourceVolType, class SeedVolType>
   bool ExecuteGrowCut2(vtkImageData *intensityVolume, vtkImageData *seedLabelVolume, vtkImageData *maskLabelVolume, double distancePenalty);
 
+  /// Set up the partitions of the volume that are processed in parallel, and the queue of each partition
+  void InitializePartitions();
+
+  /// Get partition that contains the voxel
+  int GetPartitionIndex(NodeIndexType index)
+    {
+    return std::min(static_cast<int>((index / this->m_DimXY) / this->m_PartitionThickness), this->m_NumberOfPartitions - 1);
+    }
+
+  /// Add voxel to the queue of its partition
+  void PushVoxel(NodeKeyValueType distance, NodeIndexType index)
+    {
+    this->m_PartitionQueues[this->GetPartitionIndex(index)].Push(distance, index);
+    }
+
+  /// Distance of a neighbor voxel through the current voxel.
+  /// The same function must be used for propagation and for finding the voxels that got their label
+  /// through a given voxel, because the latter relies on exact equality of distances.
+  template<typename IntensityPixelType>
+  static NodeKeyValueType GetNeighborDistance(NodeKeyValueType pixCenter, IntensityPixelType neighborIntensity,
+    NodeKeyValueType currentDistance, double neighborDistancePenalty)
+    {
+    return fabs(pixCenter - neighborIntensity) + currentDistance + neighborDistancePenalty;
+    }
+
+  /// Reset distance and label of all voxels whose shortest path starts from one of the removed seeds, and
+  /// add the voxels bordering the reset region to the queues, so that labels can be propagated into the region again.
+  template<typename IntensityPixelType, typename LabelPixelType>
+  void InvalidateRemovedSeeds(vtkImageData *intensityVolume, const std::vector<NodeIndexType>& removedSeedIndices);
+
   // Stores the shortest distance from known labels to each point
   // If a point is set to DIST_INF then that point will modified, as a shorter distance path will be found.
   // If a point is set to DIST_EPSILON, then the distance is so small that a shorter path will not be found and so
@@ -61,13 +228,22 @@ public:
   NodeIndexType m_DimX;
   NodeIndexType m_DimY;
   NodeIndexType m_DimZ;
+  NodeIndexType m_DimXY;
 
   std::vector<NodeIndexType> m_NeighborIndexOffsets;
   std::vector<double> m_NeighborDistancePenalties;
   std::vector<unsigned char> m_NumberOfNeighbors; // size of neighborhood (everywhere the same except at the image boundary)
 
-  FibHeap *m_Heap;
-  FibHeapNode *m_HeapNodes; // a node is stored for each voxel
+  // Non-zero for voxels that were seeds in the last computation. Used for detecting removed seeds,
+  // as seeds cannot be distinguished from grown voxels based on their distance.
+  std::vector<unsigned char> m_SeedVoxels;
+
+  // The volume is split into slabs along Z. Each slab has its own queue and is processed on a separate thread.
+  // Labels that propagate into a neighbor slab are exchanged between rounds, until no distance changes.
+  int m_NumberOfPartitions;
+  NodeIndexType m_PartitionThickness;
+  std::vector<DistanceRadixHeap> m_PartitionQueues;
+
   bool m_bSegInitialized;
 };
 
@@ -75,8 +251,12 @@ public:
 vtkImageGrowCutSegment::vtkInternal::vtkInternal()
 {
   m_DistancePenalty = 0.0;
-  m_Heap = nullptr;
-  m_HeapNodes = nullptr;
+  m_DimX = 0;
+  m_DimY = 0;
+  m_DimZ = 0;
+  m_DimXY = 0;
+  m_NumberOfPartitions = 1;
+  m_PartitionThickness = 1;
   m_bSegInitialized = false;
   m_DistanceVolume = vtkSmartPointer<vtkImageData>::New();
   m_ResultLabelVolume = vtkSmartPointer<vtkImageData>::New();
@@ -91,50 +271,35 @@ vtkImageGrowCutSegment::vtkInternal::~vtkInternal()
 //-----------------------------------------------------------------------------
 void vtkImageGrowCutSegment::vtkInternal::Reset()
 {
-  if (m_Heap != nullptr)
-    {
-    delete m_Heap;
-    m_Heap = nullptr;
-    }
-  if (m_HeapNodes != nullptr)
-    {
-    delete[]m_HeapNodes;
-    m_HeapNodes = nullptr;
-    }
+  m_PartitionQueues.clear();
+  std::vector<unsigned char>().swap(m_SeedVoxels);
   m_bSegInitialized = false;
   m_DistanceVolume->Initialize();
   m_ResultLabelVolume->Initialize();
 }
 
+//-----------------------------------------------------------------------------
+void vtkImageGrowCutSegment::vtkInternal::InitializePartitions()
+{
+  int numberOfThreads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+  m_NumberOfPartitions = std::max(1, std::min(numberOfThreads, static_cast<int>(m_DimZ) / MINIMUM_PARTITION_THICKNESS));
+  m_PartitionThickness = (m_DimZ + m_NumberOfPartitions - 1) / m_NumberOfPartitions;
+  m_PartitionQueues.clear();
+  m_PartitionQueues.resize(m_NumberOfPartitions);
+}
+
 //-----------------------------------------------------------------------------
 template<typename IntensityPixelType, typename LabelPixelType>
 bool vtkImageGrowCutSegment::vtkInternal::InitializationAHP(
-    vtkImageData *vtkNotUsed(intensityVolume),
+    vtkImageData *intensityVolume,
     vtkImageData *seedLabelVolume,
     vtkImageData *maskLabelVolume,
     double distancePenalty)
 {
-  // Release memory before reallocating
-  if (m_Heap != nullptr)
-    {
-    delete m_Heap;
-    m_Heap = nullptr;
-    }
-  if (m_HeapNodes != nullptr)
-    {
-    delete[] m_HeapNodes;
-    m_HeapNodes = nullptr;
-    }
-
   NodeIndexType dimXYZ = m_DimX * m_DimY * m_DimZ;
-  if ((m_HeapNodes = new FibHeapNode[dimXYZ+1]) == nullptr)  // size is +1 for storing the zeroValueElement
-    {
-    vtkGenericWarningMacro("Memory allocation failed. Dimensions: " << m_DimX << "x" << m_DimY << "x" << m_DimZ);
-    return false;
-    }
+  m_DimXY = m_DimX * m_DimY;
+  this->InitializePartitions();
 
-  m_Heap = new FibHeap;
-  m_Heap->SetHeapNodes(m_HeapNodes);
   LabelPixelType* seedLabelVolumePtr = nullptr;
   if (seedLabelVolume)
     {
@@ -209,105 +374,157 @@ bool vtkImageGrowCutSegment::vtkInternal::InitializationAHP(
         }
       }
 
-    if (!maskLabelVolumePtr)
+    // Only seeds are added to the queues, other voxels are added when their distance decreases
+    m_SeedVoxels.assign(dimXYZ, 0);
+    for (NodeIndexType index = 0; index < dimXYZ; index++)
       {
-      // no mask
-      for (NodeIndexType index = 0; index < dimXYZ; index++)
+      if (maskLabelVolumePtr && maskLabelVolumePtr[index] != 0)
         {
-        LabelPixelType seedValue = seedLabelVolumePtr[index];
-        resultLabelVolumePtr[index] = seedValue;
-        if (seedValue == 0)
-          {
-          m_HeapNodes[index] = DIST_INF;
-          distanceVolumePtr[index] = DIST_INF;
-          }
-        else
-          {
-          m_HeapNodes[index] = DIST_EPSILON;
-          distanceVolumePtr[index] = DIST_EPSILON;
-          }
-        m_HeapNodes[index].SetIndexValue(index);
-        m_Heap->Insert(&m_HeapNodes[index]);
+        // masked region
+        resultLabelVolumePtr[index] = 0;
+        // small distance will prevent overwriting of masked voxels
+        // and masked voxels are not added to the queue to exclude them from region growing
+        distanceVolumePtr[index] = DIST_EPSILON;
+        continue;
         }
-      }
-    else
-      {
-      // with mask
-      for (NodeIndexType index = 0; index < dimXYZ; index++)
+      LabelPixelType seedValue = seedLabelVolumePtr[index];
+      resultLabelVolumePtr[index] = seedValue;
+      if (seedValue == 0)
         {
-        if (maskLabelVolumePtr[index] != 0)
-          {
-          // masked region
-          resultLabelVolumePtr[index] = 0;
-          // small distance will prevent overwriting of masked voxels
-          m_HeapNodes[index] = DIST_EPSILON;
-          distanceVolumePtr[index] = DIST_EPSILON;
-          // we don't add masked voxels to the heap
-          // to exclude them from region growing
-          }
-        else
-          {
-          // non-masked region
-          LabelPixelType seedValue = seedLabelVolumePtr[index];
-          resultLabelVolumePtr[index] = seedValue;
-          if (seedValue == 0)
-            {
-            m_HeapNodes[index] = DIST_INF;
-            distanceVolumePtr[index] = DIST_INF;
-            }
-          else
-            {
-            m_HeapNodes[index] = DIST_EPSILON;
-            distanceVolumePtr[index] = DIST_EPSILON;
-            }
-          m_HeapNodes[index].SetIndexValue(index);
-          m_Heap->Insert(&m_HeapNodes[index]);
-          }
+        distanceVolumePtr[index] = DIST_INF;
+        }
+      else
+        {
+        distanceVolumePtr[index] = DIST_EPSILON;
+        m_SeedVoxels[index] = 1;
+        this->PushVoxel(DIST_EPSILON, index);
         }
       }
     }
   else
     {
-    // Already initialized
+    // Already initialized, only the region that the seed changes can affect is recomputed.
+    // Other voxels keep their distance from the previous computation.
     LabelPixelType* resultLabelVolumePtr = static_cast<LabelPixelType*>(m_ResultLabelVolume->GetScalarPointer());
     NodeKeyValueType* distanceVolumePtr = static_cast<NodeKeyValueType*>(m_DistanceVolume->GetScalarPointer());
+
+    // Find removed and changed seeds
+    std::vector<NodeIndexType> removedSeedIndices;
     for (NodeIndexType index = 0; index < dimXYZ; index++)
       {
-      if (seedLabelVolumePtr[index] != 0)
+      if (m_SeedVoxels[index] && (maskLabelVolumePtr == nullptr || maskLabelVolumePtr[index] == 0)
+        && seedLabelVolumePtr[index] != resultLabelVolumePtr[index])
         {
-        // Only grow from new/changed seeds
-        if (resultLabelVolumePtr[index] != seedLabelVolumePtr[index] // changed seed
-          || distanceVolumePtr[index] > DIST_EPSILON // new seed
-          )
-          {
-          m_HeapNodes[index] = DIST_EPSILON;
-          distanceVolumePtr[index] = DIST_EPSILON;
-          resultLabelVolumePtr[index] = seedLabelVolumePtr[index];
-          m_HeapNodes[index].SetIndexValue(index);
-          m_Heap->Insert(&m_HeapNodes[index]);
-          }
-        // Old seeds will be completely ignored in updates, as their labels have been already propagated
-        // and their value cannot changed (because their value is prescribed).
+        removedSeedIndices.push_back(index);
         }
-      else
+      }
+    if (!removedSeedIndices.empty())
+      {
+      this->InvalidateRemovedSeeds<IntensityPixelType, LabelPixelType>(intensityVolume, removedSeedIndices);
+      }
+
+    // Grow from new and changed seeds. Old seeds are ignored, as their labels have been already propagated
+    // and their value cannot change (because their value is prescribed).
+    for (NodeIndexType index = 0; index < dimXYZ; index++)
+      {
+      if (seedLabelVolumePtr[index] != 0 && !m_SeedVoxels[index]
+        && (maskLabelVolumePtr == nullptr || maskLabelVolumePtr[index] == 0))
         {
-        m_HeapNodes[index] = DIST_INF;
-        m_HeapNodes[index].SetIndexValue(index);
-        m_Heap->Insert(&m_HeapNodes[index]);
+        distanceVolumePtr[index] = DIST_EPSILON;
+        resultLabelVolumePtr[index] = seedLabelVolumePtr[index];
+        m_SeedVoxels[index] = 1;
+        this->PushVoxel(DIST_EPSILON, index);
         }
       }
     }
 
-  // Insert 0 then extract it, which will balance heap
-  NodeIndexType zeroValueElementIndex = dimXYZ;
-  m_HeapNodes[zeroValueElementIndex] = 0;
-  m_HeapNodes[zeroValueElementIndex].SetIndexValue(zeroValueElementIndex);
-  m_Heap->Insert(&m_HeapNodes[zeroValueElementIndex]);
-  m_Heap->ExtractMin();
-
   return true;
 }
 
+//-----------------------------------------------------------------------------
+template<typename IntensityPixelType, typename LabelPixelType>
+void vtkImageGrowCutSegment::vtkInternal::InvalidateRemovedSeeds(
+  vtkImageData *intensityVolume, const std::vector<NodeIndexType>& removedSeedIndices)
+{
+  LabelPixelType* resultLabelVolumePtr = static_cast<LabelPixelType*>(m_ResultLabelVolume->GetScalarPointer());
+  NodeKeyValueType* distanceVolumePtr = static_cast<NodeKeyValueType*>(m_DistanceVolume->GetScalarPointer());
+  IntensityPixelType* imSrc = static_cast<IntensityPixelType*>(intensityVolume->GetScalarPointer());
+
+  // Voxels that got their label through an invalidated voxel are found by checking if their distance
+  // equals the distance through the invalidated voxel (the previous-voxel links of the shortest paths are not stored).
+  // Voxels that have the same distance through a different voxel are invalidated as well, which is not necessary
+  // but harmless, as they are recomputed.
+  struct InvalidatedVoxelType
+    {
+    NodeIndexType Index;
+    NodeKeyValueType Distance;
+    LabelPixelType Label;
+    };
+  std::vector<InvalidatedVoxelType> voxelsToVisit;
+  std::vector<NodeIndexType> invalidatedIndices;
+  for (NodeIndexType index : removedSeedIndices)
+    {
+    InvalidatedVoxelType voxel = { index, distanceVolumePtr[index], resultLabelVolumePtr[index] };
+    voxelsToVisit.push_back(voxel);
+    distanceVolumePtr[index] = DIST_INF;
+    resultLabelVolumePtr[index] = 0;
+    m_SeedVoxels[index] = 0;
+    invalidatedIndices.push_back(index);
+    }
+  while (!voxelsToVisit.empty())
+    {
+    InvalidatedVoxelType voxel = voxelsToVisit.back();
+    voxelsToVisit.pop_back();
+    NodeKeyValueType pixCenter = imSrc[voxel.Index];
+    unsigned char nbSize = m_NumberOfNeighbors[voxel.Index];
+    for (unsigned char i = 0; i < nbSize; i++)
+      {
+      NodeIndexType indexNgbh = voxel.Index + m_NeighborIndexOffsets[i];
+      if (m_SeedVoxels[indexNgbh] || resultLabelVolumePtr[indexNgbh] != voxel.Label
+        || distanceVolumePtr[indexNgbh] == DIST_INF
+        || distanceVolumePtr[indexNgbh] != GetNeighborDistance(pixCenter, imSrc[indexNgbh], voxel.Distance, m_NeighborDistancePenalties[i]))
+        {
+        continue;
+        }
+      InvalidatedVoxelType neighborVoxel = { indexNgbh, distanceVolumePtr[indexNgbh], voxel.Label };
+      voxelsToVisit.push_back(neighborVoxel);
+      distanceVolumePtr[indexNgbh] = DIST_INF;
+      resultLabelVolumePtr[indexNgbh] = 0;
+      invalidatedIndices.push_back(indexNgbh);
+      }
+    }
+
+  // Labels are propagated again from valid voxels bordering the invalidated region.
+  // Voxels at the image boundary do not propagate labels, so they are not added to the queue.
+  for (NodeIndexType index : invalidatedIndices)
+    {
+    NodeIndexType x = index % m_DimX;
+    NodeIndexType y = (index / m_DimX) % m_DimY;
+    NodeIndexType z = index / m_DimXY;
+    for (int iz = -1; iz <= 1; iz++)
+      {
+      for (int iy = -1; iy <= 1; iy++)
+        {
+        for (int ix = -1; ix <= 1; ix++)
+          {
+          if ((x == 0 && ix < 0) || (x == m_DimX - 1 && ix > 0)
+            || (y == 0 && iy < 0) || (y == m_DimY - 1 && iy > 0)
+            || (z == 0 && iz < 0) || (z == m_DimZ - 1 && iz > 0))
+            {
+            continue;
+            }
+          NodeIndexType indexNgbh = index + ix + m_DimX * iy + m_DimXY * iz;
+          if (m_NumberOfNeighbors[indexNgbh] > 0 && distanceVolumePtr[indexNgbh] != DIST_INF
+            && resultLabelVolumePtr[indexNgbh] != 0)
+            {
+            this->PushVoxel(distanceVolumePtr[indexNgbh], indexNgbh);
+            }
+          }
+        }
+      }
+    }
+}
+
 //-----------------------------------------------------------------------------
 template<typename IntensityPixelType, typename LabelPixelType>
 void vtkImageGrowCutSegment::vtkInternal::DijkstraBasedClassificationAHP(
@@ -315,91 +532,100 @@ void vtkImageGrowCutSegment::vtkInternal::DijkstraBasedClassificationAHP(
     vtkImageData *vtkNotUsed(seedLabelVolume),
     vtkImageData *vtkNotUsed(maskLabelVolume))
 {
-  if (m_Heap == nullptr || m_HeapNodes == nullptr)
+  if (m_PartitionQueues.empty())
     {
     return;
     }
 
   LabelPixelType* resultLabelVolumePtr = static_cast<LabelPixelType*>(m_ResultLabelVolume->GetScalarPointer());
+  NodeKeyValueType* distanceVolumePtr = static_cast<NodeKeyValueType*>(m_DistanceVolume->GetScalarPointer());
   IntensityPixelType* imSrc = static_cast<IntensityPixelType*>(intensityVolume->GetScalarPointer());
 
-  if (!m_bSegInitialized)
+  // Label propagated into a voxel of a neighbor partition
+  struct BoundaryUpdateType
     {
-    // Full computation
-    NodeKeyValueType* distanceVolumePtr = static_cast<NodeKeyValueType*>(m_DistanceVolume->GetScalarPointer());
-    LabelPixelType* resultLabelVolumePtr = static_cast<LabelPixelType*>(m_ResultLabelVolume->GetScalarPointer());
-
-    // Normal Dijkstra (to be used in initializing the segmenter for the current image)
-    while (!m_Heap->IsEmpty())
+    NodeIndexType Index;
+    NodeKeyValueType Distance;
+    LabelPixelType Label;
+    };
+  std::vector<std::vector<BoundaryUpdateType> > boundaryUpdates(m_NumberOfPartitions);
+
+  // The same algorithm is used for full computation and quick update: in quick update the queues only
+  // contain new seeds and the distances are kept from the previous computation (adaptive Dijkstra).
+  while (true)
+    {
+    // Dijkstra within each partition. A partition only writes its own voxels, updates of voxels
+    // in neighbor partitions are collected and applied after all partitions are completed.
+    vtkSMPTools::For(0, m_NumberOfPartitions, [&](vtkIdType beginPartition, vtkIdType endPartition)
       {
-      FibHeapNode* hnMin = m_Heap->ExtractMin();
-      NodeIndexType index = hnMin->GetIndexValue();
-      NodeKeyValueType currentDistance = hnMin->GetKeyValue();
-      LabelPixelType currentLabel = resultLabelVolumePtr[index];
-
-      // Update neighbors
-      NodeKeyValueType pixCenter = imSrc[index];
-      unsigned char nbSize = m_NumberOfNeighbors[index];
-      for (unsigned char i = 0; i < nbSize; i++)
+      for (vtkIdType partitionIndex = beginPartition; partitionIndex < endPartition; ++partitionIndex)
         {
-        NodeIndexType indexNgbh = index + m_NeighborIndexOffsets[i];
-        NodeKeyValueType neighborCurrentDistance = distanceVolumePtr[indexNgbh];
-        NodeKeyValueType neighborNewDistance = fabs(pixCenter - imSrc[indexNgbh]) + currentDistance + m_NeighborDistancePenalties[i];
-        if (neighborCurrentDistance > neighborNewDistance)
+        DistanceRadixHeap& queue = m_PartitionQueues[partitionIndex];
+        std::vector<BoundaryUpdateType>& partitionBoundaryUpdates = boundaryUpdates[partitionIndex];
+        NodeIndexType partitionBeginIndex = static_cast<NodeIndexType>(partitionIndex) * m_PartitionThickness * m_DimXY;
+        NodeIndexType partitionEndIndex = (partitionIndex == m_NumberOfPartitions - 1) ? m_DimXY * m_DimZ
+          : static_cast<NodeIndexType>(partitionIndex + 1) * m_PartitionThickness * m_DimXY;
+        NodeKeyValueType currentDistance = 0;
+        NodeIndexType index = 0;
+        while (queue.Pop(currentDistance, index))
           {
-          distanceVolumePtr[indexNgbh] = neighborNewDistance;
-          resultLabelVolumePtr[indexNgbh] = currentLabel;
-          m_Heap->DecreaseKey(&m_HeapNodes[indexNgbh], neighborNewDistance);
+          if (currentDistance != distanceVolumePtr[index])
+            {
+            // A shorter path to this voxel has been found since it was added to the queue
+            continue;
+            }
+          LabelPixelType currentLabel = resultLabelVolumePtr[index];
+
+          // Update neighbors
+          NodeKeyValueType pixCenter = imSrc[index];
+          unsigned char nbSize = m_NumberOfNeighbors[index];
+          for (unsigned char i = 0; i < nbSize; i++)
+            {
+            NodeIndexType indexNgbh = index + m_NeighborIndexOffsets[i];
+            NodeKeyValueType neighborNewDistance = GetNeighborDistance(pixCenter, imSrc[indexNgbh], currentDistance, m_NeighborDistancePenalties[i]);
+            if (indexNgbh < partitionBeginIndex || indexNgbh >= partitionEndIndex)
+              {
+              BoundaryUpdateType update = { indexNgbh, neighborNewDistance, currentLabel };
+              partitionBoundaryUpdates.push_back(update);
+              continue;
+              }
+            if (distanceVolumePtr[indexNgbh] > neighborNewDistance)
+              {
+              distanceVolumePtr[indexNgbh] = neighborNewDistance;
+              resultLabelVolumePtr[indexNgbh] = currentLabel;
+              queue.Push(neighborNewDistance, indexNgbh);
+              }
+            }
           }
         }
-      }
-    }
-  else
-    {
-    // Quick update
+      });
 
-    // Adaptive Dijkstra
-    NodeKeyValueType* distanceVolumePtr = static_cast<NodeKeyValueType*>(m_DistanceVolume->GetScalarPointer());
-    while (!m_Heap->IsEmpty())
+    // Exchange boundary updates between partitions, in a fixed order to get reproducible results
+    bool distanceChanged = false;
+    for (std::vector<BoundaryUpdateType>& partitionBoundaryUpdates : boundaryUpdates)
       {
-      FibHeapNode* hnMin = m_Heap->ExtractMin();
-      NodeKeyValueType currentDistance = hnMin->GetKeyValue();
-
-      // Stop if minimum value is infinite (it means there are no more voxels to propagate labels from)
-      if (currentDistance == DIST_INF)
-        {
-        break;
-        }
-
-      NodeIndexType index = hnMin->GetIndexValue();
-      LabelPixelType currentLabel = resultLabelVolumePtr[index];
-
-      // Update neighbors
-      NodeKeyValueType pixCenter = imSrc[index];
-      unsigned char nbSize = m_NumberOfNeighbors[index];
-      for (unsigned char i = 0; i < nbSize; i++)
+      for (const BoundaryUpdateType& update : partitionBoundaryUpdates)
         {
-        NodeIndexType indexNgbh = index + m_NeighborIndexOffsets[i];
-        NodeKeyValueType neighborCurrentDistance = distanceVolumePtr[indexNgbh];
-        NodeKeyValueType neighborNewDistance = fabs(pixCenter - imSrc[indexNgbh]) + currentDistance + m_NeighborDistancePenalties[i];
-        if (neighborCurrentDistance > neighborNewDistance)
+        if (distanceVolumePtr[update.Index] > update.Distance)
           {
-          distanceVolumePtr[indexNgbh] = neighborNewDistance;
-          resultLabelVolumePtr[indexNgbh] = currentLabel;
-
-          m_Heap->DecreaseKey(&m_HeapNodes[indexNgbh], neighborNewDistance);
+          distanceVolumePtr[update.Index] = update.Distance;
+          resultLabelVolumePtr[update.Index] = update.Label;
+          this->PushVoxel(update.Distance, update.Index);
+          distanceChanged = true;
           }
         }
+      partitionBoundaryUpdates.clear();
+      }
+    if (!distanceChanged)
+      {
+      break;
       }
     }
 
   m_bSegInitialized = true;
 
   // Release memory
-  delete m_Heap;
-  m_Heap = nullptr;
-  delete[] m_HeapNodes;
-  m_HeapNodes = nullptr;
+  m_PartitionQueues.clear();
 }
 
 //-----------------------------------------------------------------------------
@@ -27,7 +27,9 @@ public:
   void SetMaskVolume(vtkImageData* labelImage) { this->SetInputData(2, labelImage); }
 
   /// Reset to initial state. This forces full recomputation of the result label volume.
-  /// This method has to be called if intensity volume changes or if seeds are deleted after initial computation.
+  /// This method has to be called if intensity volume, mask volume, or distance penalty changes.
+  /// Changes of the seed label volume are processed incrementally on update: only the region
+  /// where labels were propagated from removed or changed seeds and the region reachable from new seeds are recomputed.
   void Reset();
 
   /// Spatial regularization factor, which can force growing in nearby regions.
@@ -26,6 +26,9 @@
 #include "vtkClosedSurfaceToBinaryLabelmapConversionRule.h"
 #include "vtkClosedSurfaceToFractionalLabelmapConversionRule.h"
 #include "vtkFractionalLabelmapToClosedSurfaceConversionRule.h"
+#include "vtkLabelmapStatistics.h"
+#include "vtkBinaryLabelmapToSparseLabelmapConversionRule.h"
+#include "vtkSparseLabelmapToBinaryLabelmapConversionRule.h"
 #include "vtkOrientedImageData.h"
 #include "vtkOrientedImageDataResample.h"
 #include "vtkSegmentationConverterFactory.h"
@@ -46,6 +49,7 @@
 #include <vtkImageConstantPad.h>
 #include <vtkImageMathematics.h>
 #include <vtkImageThreshold.h>
+#include <vtkIntArray.h>
 #include <vtkLookupTable.h>
 #include <vtkMatrix4x4.h>
 #include <vtkNew.h>
@@ -59,6 +63,7 @@
 #include <vtkRenderWindow.h>
 #include <vtkSTLWriter.h>
 #include <vtkStringArray.h>
+#include <vtkTable.h>
 #include <vtkTransform.h>
 #include <vtkTransformPolyDataFilter.h>
 #include <vtkTriangleFilter.h>
@@ -71,6 +76,7 @@
 #include <vtkITKImageWriter.h>
 
 // MRML includes
+#include <vtkMRMLApplicationLogic.h>
 #include <vtkMRMLScene.h>
 #include "vtkMRMLSegmentationNode.h"
 #include "vtkMRMLSegmentationDisplayNode.h"
@@ -86,6 +92,7 @@
 #include <vtkEventBroker.h>
 
 // STD includes
+#include <set>
 #include <sstream>
 
 //----------------------------------------------------------------------------
@@ -110,6 +117,229 @@ vtkSlicerSegmentationsModuleLogic::~vtkSlicerSegmentationsModuleLogic()
     this->SubjectHierarchyUIDCallbackCommand = nullptr;
     }
   this->SetTerminologiesLogic(nullptr);
+  this->RemoveMemoryCaches();
+}
+
+//----------------------------------------------------------------------------
+void vtkSlicerSegmentationsModuleLogic::SetMRMLApplicationLogic(vtkMRMLApplicationLogic* logic)
+{
+  if (logic == this->GetMRMLApplicationLogic())
+    {
+    return;
+    }
+  this->RemoveMemoryCaches();
+  this->Superclass::SetMRMLApplicationLogic(logic);
+  if (!logic)
+    {
+    return;
+    }
+  this->MemoryCachesApplicationLogic = logic;
+
+  vtkMRMLApplicationLogic::MemoryCacheType mergedLabelmapCache;
+  mergedLabelmapCache.Name = "Segmentation merged labelmaps";
+  mergedLabelmapCache.RegenerationCost = 1.0;
+  mergedLabelmapCache.GetMemorySize = [this]()
+    {
+    unsigned long size = 0;
+    std::vector<vtkMRMLNode*> segmentationNodes;
+    if (this->GetMRMLScene())
+      {
+      this->GetMRMLScene()->GetNodesByClass("vtkMRMLSegmentationNode", segmentationNodes);
+      }
+    for (vtkMRMLNode* node : segmentationNodes)
+      {
+      vtkSegmentation* segmentation = vtkMRMLSegmentationNode::SafeDownCast(node)->GetSegmentation();
+      size += (segmentation ? segmentation->GetMergedLabelmapCacheMemorySize() : 0);
+      }
+    return size;
+    };
+  mergedLabelmapCache.Release = [this]()
+    {
+    std::vector<vtkMRMLNode*> segmentationNodes;
+    if (this->GetMRMLScene())
+      {
+      this->GetMRMLScene()->GetNodesByClass("vtkMRMLSegmentationNode", segmentationNodes);
+      }
+    for (vtkMRMLNode* node : segmentationNodes)
+      {
+      vtkSegmentation* segmentation = vtkMRMLSegmentationNode::SafeDownCast(node)->GetSegmentation();
+      if (segmentation)
+        {
+        segmentation->ClearMergedLabelmapCache();
+        }
+      }
+    };
+  this->MemoryCacheIds.push_back(logic->AddMemoryCache(mergedLabelmapCache));
+
+  vtkMRMLApplicationLogic::MemoryCacheType conversionCache;
+  conversionCache.Name = "Segmentation conversion results";
+  conversionCache.RegenerationCost = 2.0;
+  conversionCache.GetMemorySize = [this]()
+    {
+    unsigned long size = 0;
+    std::vector<vtkMRMLNode*> segmentationNodes;
+    if (this->GetMRMLScene())
+      {
+      this->GetMRMLScene()->GetNodesByClass("vtkMRMLSegmentationNode", segmentationNodes);
+      }
+    for (vtkMRMLNode* node : segmentationNodes)
+      {
+      vtkSegmentation* segmentation = vtkMRMLSegmentationNode::SafeDownCast(node)->GetSegmentation();
+      size += (segmentation ? segmentation->GetConverter()->GetConversionCacheMemorySize() : 0);
+      }
+    return size;
+    };
+  conversionCache.Release = [this]()
+    {
+    std::vector<vtkMRMLNode*> segmentationNodes;
+    if (this->GetMRMLScene())
+      {
+      this->GetMRMLScene()->GetNodesByClass("vtkMRMLSegmentationNode", segmentationNodes);
+      }
+    for (vtkMRMLNode* node : segmentationNodes)
+      {
+      vtkSegmentation* segmentation = vtkMRMLSegmentationNode::SafeDownCast(node)->GetSegmentation();
+      if (segmentation)
+        {
+        segmentation->GetConverter()->ClearConversionCache();
+        }
+      }
+    };
+  this->MemoryCacheIds.push_back(logic->AddMemoryCache(conversionCache));
+
+  vtkMRMLApplicationLogic::MemoryCacheType derivedRepresentations;
+  derivedRepresentations.Name = "Segmentation derived representations";
+  derivedRepresentations.RegenerationCost = 10.0;
+  // representations are part of the segmentation node content
+  derivedRepresentations.IncludedInNodesMemorySize = true;
+  derivedRepresentations.GetMemorySize = [this]()
+    {
+    return vtkSlicerSegmentationsModuleLogic::GetUndisplayedDerivedRepresentationsMemorySize(this->GetMRMLScene());
+    };
+  derivedRepresentations.Release = [this]()
+    {
+    vtkSlicerSegmentationsModuleLogic::RemoveUndisplayedDerivedRepresentations(this->GetMRMLScene());
+    };
+  this->MemoryCacheIds.push_back(logic->AddMemoryCache(derivedRepresentations));
+}
+
+//----------------------------------------------------------------------------
+void vtkSlicerSegmentationsModuleLogic::RemoveMemoryCaches()
+{
+  if (this->MemoryCachesApplicationLogic)
+    {
+    for (int cacheId : this->MemoryCacheIds)
+      {
+      this->MemoryCachesApplicationLogic->RemoveMemoryCache(cacheId);
+      }
+    }
+  this->MemoryCacheIds.clear();
+  this->MemoryCachesApplicationLogic = nullptr;
+}
+
+namespace
+{
+//----------------------------------------------------------------------------
+/// Get names of representations of the segmentation that are neither the master nor displayed by any display node
+void GetUndisplayedDerivedRepresentationNames(vtkMRMLSegmentationNode* segmentationNode, std::vector<std::string>& representationNames)
+{
+  representationNames.clear();
+  vtkSegmentation* segmentation = segmentationNode->GetSegmentation();
+  if (!segmentation)
+    {
+    return;
+    }
+  std::set<std::string> displayedRepresentationNames;
+  for (int displayNodeIndex = 0; displayNodeIndex < segmentationNode->GetNumberOfDisplayNodes(); ++displayNodeIndex)
+    {
+    vtkMRMLSegmentationDisplayNode* displayNode = vtkMRMLSegmentationDisplayNode::SafeDownCast(
+      segmentationNode->GetNthDisplayNode(displayNodeIndex));
+    if (!displayNode || !displayNode->GetVisibility())
+      {
+      continue;
+      }
+    if (displayNode->GetVisibility2D())
+      {
+      displayedRepresentationNames.insert(displayNode->GetDisplayRepresentationName2D());
+      }
+    if (displayNode->GetVisibility3D())
+      {
+      displayedRepresentationNames.insert(displayNode->GetDisplayRepresentationName3D());
+      }
+    }
+  std::vector<std::string> containedRepresentationNames;
+  segmentation->GetContainedRepresentationNames(containedRepresentationNames);
+  for (const std::string& name : containedRepresentationNames)
+    {
+    if (name != segmentation->GetMasterRepresentationName()
+      && displayedRepresentationNames.find(name) == displayedRepresentationNames.end())
+      {
+      representationNames.push_back(name);
+      }
+    }
+}
+}
+
+//----------------------------------------------------------------------------
+unsigned long vtkSlicerSegmentationsModuleLogic::GetUndisplayedDerivedRepresentationsMemorySize(vtkMRMLScene* scene)
+{
+  if (!scene)
+    {
+    return 0;
+    }
+  unsigned long size = 0;
+  std::vector<vtkMRMLNode*> segmentationNodes;
+  scene->GetNodesByClass("vtkMRMLSegmentationNode", segmentationNodes);
+  for (vtkMRMLNode* node : segmentationNodes)
+    {
+    vtkMRMLSegmentationNode* segmentationNode = vtkMRMLSegmentationNode::SafeDownCast(node);
+    std::vector<std::string> representationNames;
+    GetUndisplayedDerivedRepresentationNames(segmentationNode, representationNames);
+    if (representationNames.empty())
+      {
+      continue;
+      }
+    // Representations may be shared between segments, count them only once
+    std::set<vtkDataObject*> countedRepresentations;
+    vtkSegmentation* segmentation = segmentationNode->GetSegmentation();
+    for (int segmentIndex = 0; segmentIndex < segmentation->GetNumberOfSegments(); ++segmentIndex)
+      {
+      vtkSegment* segment = segmentation->GetNthSegment(segmentIndex);
+      for (const std::string& name : representationNames)
+        {
+        vtkDataObject* representation = segment->GetRepresentation(name);
+        if (representation && countedRepresentations.insert(representation).second)
+          {
+          size += representation->GetActualMemorySize();
+          }
+        }
+      }
+    }
+  return size;
+}
+
+//----------------------------------------------------------------------------
+int vtkSlicerSegmentationsModuleLogic::RemoveUndisplayedDerivedRepresentations(vtkMRMLScene* scene)
+{
+  if (!scene)
+    {
+    return 0;
+    }
+  int numberOfRemovedRepresentations = 0;
+  std::vector<vtkMRMLNode*> segmentationNodes;
+  scene->GetNodesByClass("vtkMRMLSegmentationNode", segmentationNodes);
+  for (vtkMRMLNode* node : segmentationNodes)
+    {
+    vtkMRMLSegmentationNode* segmentationNode = vtkMRMLSegmentationNode::SafeDownCast(node);
+    std::vector<std::string> representationNames;
+    GetUndisplayedDerivedRepresentationNames(segmentationNode, representationNames);
+    for (const std::string& name : representationNames)
+      {
+      segmentationNode->GetSegmentation()->RemoveRepresentation(name);
+      numberOfRemovedRepresentations++;
+      }
+    }
+  return numberOfRemovedRepresentations;
 }
 
 //----------------------------------------------------------------------------
@@ -159,6 +389,23 @@ void vtkSlicerSegmentationsModuleLogic::RegisterNodes()
     vtkSmartPointer<vtkFractionalLabelmapToClosedSurfaceConversionRule>::New() );
 }
 
+//-----------------------------------------------------------------------------
+void vtkSlicerSegmentationsModuleLogic::RegisterSparseLabelmapConversionRules()
+{
+  vtkSegmentationConverterFactory* factory = vtkSegmentationConverterFactory::GetInstance();
+  const vtkSegmentationConverterFactory::RuleListType& rules = factory->GetConverterRules();
+  for (vtkSegmentationConverterFactory::RuleListType::const_iterator ruleIt = rules.begin(); ruleIt != rules.end(); ++ruleIt)
+    {
+    if (vtkBinaryLabelmapToSparseLabelmapConversionRule::SafeDownCast(*ruleIt))
+      {
+      // already registered
+      return;
+      }
+    }
+  factory->RegisterConverterRule(vtkSmartPointer<vtkBinaryLabelmapToSparseLabelmapConversionRule>::New());
+  factory->RegisterConverterRule(vtkSmartPointer<vtkSparseLabelmapToBinaryLabelmapConversionRule>::New());
+}
+
 //---------------------------------------------------------------------------
 void vtkSlicerSegmentationsModuleLogic::OnMRMLSceneNodeAdded(vtkMRMLNode* node)
 {
@@ -1887,6 +2134,26 @@ bool vtkSlicerSegmentationsModuleLogic::SetBinaryLabelmapToSegment(
   bool result = vtkSegmentationModifier::ModifyBinaryLabelmap(labelmap, segmentation, segmentID, mergeMode, extent, minimumOfAllSegments,
     false, segmentIdsToOverwrite, &modifiedSegmentIDs);
 
+  // If the segments were only modified within the extent then the representations can be updated incrementally.
+  // The extent is in the IJK coordinate system of the modifier labelmap, so it can only be used if the modified
+  // segment labelmaps have the same geometry. When replacing without an extent, the whole labelmap is replaced.
+  const int* modifiedExtent = nullptr;
+  if (result && extent && mergeMode != MODE_REPLACE)
+    {
+    modifiedExtent = extent;
+    for (std::vector<std::string>::iterator segmentIDIt = modifiedSegmentIDs.begin(); segmentIDIt != modifiedSegmentIDs.end(); ++segmentIDIt)
+      {
+      vtkSegment* modifiedSegment = segmentation->GetSegment(*segmentIDIt);
+      vtkOrientedImageData* modifiedLabelmap = modifiedSegment ? vtkOrientedImageData::SafeDownCast(
+        modifiedSegment->GetRepresentation(vtkSegmentationConverter::GetSegmentationBinaryLabelmapRepresentationName())) : nullptr;
+      if (!vtkOrientedImageDataResample::DoGeometriesMatch(labelmap, modifiedLabelmap))
+        {
+        modifiedExtent = nullptr;
+        break;
+        }
+      }
+    }
+
   // Re-convert all other representations
   bool conversionHappened = false;
   std::vector<std::string> representationNames;
@@ -1909,7 +2176,7 @@ bool vtkSlicerSegmentationsModuleLogic::SetBinaryLabelmapToSegment(
           {
           continue;
           }
-        conversionHappened |= segmentation->ConvertSegmentsUsingPath(modifiedSegmentIDs, cheapestPath, true);
+        conversionHappened |= segmentation->ConvertSegmentsUsingPath(modifiedSegmentIDs, cheapestPath, true, modifiedExtent);
         }
       }
     }
@@ -2363,6 +2630,101 @@ bool vtkSlicerSegmentationsModuleLogic::ExportSegmentsBinaryLabelmapRepresentati
   return true;
 }
 
+//-----------------------------------------------------------------------------
+bool vtkSlicerSegmentationsModuleLogic::ComputeSharedLabelmapStatistics(vtkMRMLSegmentationNode* segmentationNode,
+  std::string sharedSegmentID, vtkTable* statisticsTable, vtkMRMLScalarVolumeNode* intensityVolumeNode/*=nullptr*/)
+{
+  if (!segmentationNode || !segmentationNode->GetSegmentation() || !statisticsTable)
+    {
+    vtkGenericWarningMacro("vtkSlicerSegmentationsModuleLogic::ComputeSharedLabelmapStatistics: Invalid inputs");
+    return false;
+    }
+  vtkSegmentation* segmentation = segmentationNode->GetSegmentation();
+  vtkSegment* sharedSegment = segmentation->GetSegment(sharedSegmentID);
+  vtkOrientedImageData* sharedLabelmap = sharedSegment ? vtkOrientedImageData::SafeDownCast(
+    sharedSegment->GetRepresentation(vtkSegmentationConverter::GetBinaryLabelmapRepresentationName())) : nullptr;
+  if (!sharedLabelmap)
+    {
+    vtkGenericWarningMacro("vtkSlicerSegmentationsModuleLogic::ComputeSharedLabelmapStatistics: Binary labelmap of segment "
+      << sharedSegmentID << " is not available");
+    return false;
+    }
+
+  vtkNew<vtkLabelmapStatistics> labelmapStatistics;
+  labelmapStatistics->SetLabelmap(sharedLabelmap);
+  if (intensityVolumeNode)
+    {
+    vtkSmartPointer<vtkOrientedImageData> intensityImage = vtkSmartPointer<vtkOrientedImageData>::Take(
+      vtkSlicerSegmentationsModuleLogic::CreateOrientedImageDataFromVolumeNode(intensityVolumeNode, segmentationNode->GetParentTransformNode()));
+    if (!intensityImage)
+      {
+      vtkGenericWarningMacro("vtkSlicerSegmentationsModuleLogic::ComputeSharedLabelmapStatistics: Invalid intensity volume");
+      return false;
+      }
+    if (!vtkOrientedImageDataResample::DoGeometriesMatch(intensityImage, sharedLabelmap)
+      || !vtkOrientedImageDataResample::DoExtentsMatch(intensityImage, sharedLabelmap))
+      {
+      vtkSmartPointer<vtkOrientedImageData> resampledIntensityImage = vtkSmartPointer<vtkOrientedImageData>::New();
+      if (!vtkOrientedImageDataResample::ResampleOrientedImageToReferenceOrientedImage(intensityImage, sharedLabelmap, resampledIntensityImage))
+        {
+        vtkGenericWarningMacro("vtkSlicerSegmentationsModuleLogic::ComputeSharedLabelmapStatistics: Failed to resample intensity volume");
+        return false;
+        }
+      intensityImage = resampledIntensityImage;
+      }
+    labelmapStatistics->SetIntensityImage(intensityImage);
+    }
+  if (!labelmapStatistics->Compute())
+    {
+    return false;
+    }
+
+  vtkNew<vtkTable> labelStatisticsTable;
+  labelmapStatistics->GetStatisticsTable(labelStatisticsTable.GetPointer());
+  vtkIntArray* labelValueArray = vtkIntArray::SafeDownCast(labelStatisticsTable->GetColumnByName("LabelValue"));
+
+  // One row for each segment in the layer, segments without voxels get zero values
+  statisticsTable->Initialize();
+  vtkNew<vtkStringArray> segmentIdArray;
+  segmentIdArray->SetName("SegmentID");
+  statisticsTable->AddColumn(segmentIdArray.GetPointer());
+  for (vtkIdType columnIndex = 0; columnIndex < labelStatisticsTable->GetNumberOfColumns(); ++columnIndex)
+    {
+    vtkAbstractArray* labelColumn = labelStatisticsTable->GetColumn(columnIndex);
+    vtkSmartPointer<vtkAbstractArray> column = vtkSmartPointer<vtkAbstractArray>::Take(labelColumn->NewInstance());
+    column->SetName(labelColumn->GetName());
+    statisticsTable->AddColumn(column);
+    }
+
+  std::vector<std::string> segmentIDs;
+  segmentation->GetSegmentIDsSharingBinaryLabelmapRepresentation(sharedSegmentID, segmentIDs, true);
+  for (std::string segmentID : segmentIDs)
+    {
+    int labelValue = segmentation->GetSegment(segmentID)->GetLabelValue();
+    vtkIdType labelRow = labelValueArray ? labelValueArray->LookupValue(labelValue) : -1;
+    segmentIdArray->InsertNextValue(segmentID);
+    for (vtkIdType columnIndex = 0; columnIndex < labelStatisticsTable->GetNumberOfColumns(); ++columnIndex)
+      {
+      vtkDataArray* labelColumn = vtkDataArray::SafeDownCast(labelStatisticsTable->GetColumn(columnIndex));
+      vtkDataArray* column = vtkDataArray::SafeDownCast(statisticsTable->GetColumn(columnIndex + 1));
+      if (!labelColumn || !column)
+        {
+        continue;
+        }
+      if (labelRow >= 0)
+        {
+        column->InsertNextTuple(labelRow, labelColumn);
+        }
+      else
+        {
+        column->InsertNextTuple1(labelColumn == labelValueArray ? labelValue : 0.0);
+        }
+      }
+    }
+
+  return true;
+}
+
 //-----------------------------------------------------------------------------
 vtkMRMLSegmentationNode* vtkSlicerSegmentationsModuleLogic::GetDefaultSegmentationNode()
 {
@@ -33,11 +33,15 @@
 // Segmentations includes
 #include "vtkMRMLSegmentationNode.h"
 
+// VTK includes
+#include <vtkWeakPointer.h>
+
 class vtkCallbackCommand;
 class vtkOrientedImageData;
 class vtkPolyData;
 class vtkDataObject;
 class vtkGeneralTransform;
+class vtkTable;
 
 class vtkMRMLSegmentationStorageNode;
 class vtkMRMLScalarVolumeNode;
@@ -55,6 +59,12 @@ public:
   vtkTypeMacro(vtkSlicerSegmentationsModuleLogic,vtkSlicerModuleLogic);
   void PrintSelf(ostream& os, vtkIndent indent) override;
 
+  /// Register the conversion rules between binary labelmap and sparse labelmap representations.
+  /// They are not registered by default because sparse labelmap is only meant as a derived
+  /// representation: it has no storage or transform support, so it must not be used as master.
+  /// Calling this method multiple times registers the rules only once.
+  static void RegisterSparseLabelmapConversionRules();
+
   /// Get segmentation node containing a segmentation object. As segmentation objects are out-of-MRML
   /// VTK objects, there is no direct link from it to its parent node, so must be found from the MRML scene.
   /// \param scene MRML scene
@@ -427,10 +437,36 @@ public:
   static void GenerateMergedLabelmapInReferenceGeometry(vtkMRMLSegmentationNode* segmentationNode, vtkMRMLVolumeNode* referenceVolumeNode,
     vtkStringArray* segmentIDs, int extentComputationMode, vtkOrientedImageData* mergedLabelmap_Reference);
 
+  /// Compute statistics of all segments sharing the binary labelmap of a segment, in one pass over the labelmap
+  /// (\sa vtkLabelmapStatistics). Much faster than computing statistics segment by segment if there are many segments.
+  /// \param segmentationNode Node containing the segmentation. Binary labelmap must be the master representation.
+  /// \param sharedSegmentID ID of any segment in the shared labelmap layer
+  /// \param statisticsTable Output table with a row for each segment in the layer. Columns are SegmentID and the
+  ///   columns of vtkLabelmapStatistics::GetStatisticsTable. Centroids are in the coordinate system of the segmentation node.
+  /// \param intensityVolumeNode If specified then intensity statistics are computed as well. The volume is resampled
+  ///   to the geometry of the labelmap using nearest neighbor interpolation if necessary.
+  /// \return Success flag
+  static bool ComputeSharedLabelmapStatistics(vtkMRMLSegmentationNode* segmentationNode, std::string sharedSegmentID,
+    vtkTable* statisticsTable, vtkMRMLScalarVolumeNode* intensityVolumeNode=nullptr);
+
 public:
   /// Set Terminologies module logic
   void SetTerminologiesLogic(vtkSlicerTerminologiesModuleLogic* terminologiesLogic);
 
+  /// Register the merged labelmap caches, the conversion result caches and the
+  /// representations that are not displayed (and can be converted again from the master
+  /// representation) as memory caches in the application logic.
+  /// \sa vtkMRMLApplicationLogic::SetMemoryBudget
+  void SetMRMLApplicationLogic(vtkMRMLApplicationLogic* logic) override;
+
+  /// Remove representations other than the master representation that are not displayed
+  /// in any view, to reduce memory usage. They are created again when needed.
+  /// Returns the number of removed representations.
+  static int RemoveUndisplayedDerivedRepresentations(vtkMRMLScene* scene);
+
+  /// Memory used by representations that would be removed by RemoveUndisplayedDerivedRepresentations, in kibibytes.
+  static unsigned long GetUndisplayedDerivedRepresentationsMemorySize(vtkMRMLScene* scene);
+
 protected:
   void SetMRMLSceneInternal(vtkMRMLScene * newScene) override;
 
@@ -467,6 +503,11 @@ protected:
   /// Terminologies module logic
   vtkSlicerTerminologiesModuleLogic* TerminologiesLogic{nullptr};
 
+  /// Application logic that the memory caches are registered in, and the identifiers of the caches
+  void RemoveMemoryCaches();
+  vtkWeakPointer<vtkMRMLApplicationLogic> MemoryCachesApplicationLogic;
+  std::vector<int> MemoryCacheIds;
+
 private:
   vtkSlicerSegmentationsModuleLogic(const vtkSlicerSegmentationsModuleLogic&) = delete;
   void operator=(const vtkSlicerSegmentationsModuleLogic&) = delete;
@@ -58,14 +58,17 @@
 #include <vtkImageMapToRGBA.h>
 #include <vtkImageThreshold.h>
 #include <vtkImageReslice.h>
+#include <vtkIdList.h>
 #include <vtkIntArray.h>
 #include <vtkLookupTable.h>
+#include <vtkMath.h>
 #include <vtkMatrix4x4.h>
 #include <vtkNew.h>
 #include <vtkObjectFactory.h>
 #include <vtkPlane.h>
 #include <vtkPointData.h>
 #include <vtkPointLocator.h>
+#include <vtkPolyData.h>
 #include <vtkPolyDataMapper2D.h>
 #include <vtkProperty2D.h>
 #include <vtkRenderer.h>
@@ -78,13 +81,26 @@
 
 // STD includes
 #include <algorithm>
+#include <list>
 #include <set>
+#include <vector>
 #include <map>
 #include <sstream>
 
 //---------------------------------------------------------------------------
 vtkStandardNewMacro(vtkMRMLSegmentationsDisplayableManager2D );
 
+//---------------------------------------------------------------------------
+// Number of resliced images that are kept for each labelmap layer in each slice view.
+// Allows quick display of recently visited slices when scrolling back and forth.
+static const unsigned int RESLICED_IMAGE_CACHE_SIZE = 8;
+
+//---------------------------------------------------------------------------
+// Surfaces with fewer cells are cut directly, without using a slab index
+static const vtkIdType SLAB_INDEX_MINIMUM_NUMBER_OF_CELLS = 10000;
+// Approximate number of cells in each slab of the slab index
+static const vtkIdType SLAB_INDEX_CELLS_PER_SLAB = 2000;
+
 //---------------------------------------------------------------------------
 // Convert a linear transform that is almost exactly a permute transform
 // to an exact permute transform.
@@ -158,8 +174,15 @@ public:
       this->Triangulator = vtkSmartPointer<vtkContourTriangulator>::New();
 
       // Set up poly data outline pipeline
+      // Cutter input is set in UpdateCutterInput: either the full surface or only the cells near the slice plane
+      this->SlabIndexNormal[0] = 0.0;
+      this->SlabIndexNormal[1] = 0.0;
+      this->SlabIndexNormal[2] = 0.0;
+      this->SlabIndexUpdatedTime = 0;
+      this->SlabIndexOrigin = 0.0;
+      this->SlabThickness = 1.0;
+      this->NearbyCells = vtkSmartPointer<vtkPolyData>::New();
 #if VTK_MAJOR_VERSION >= 9 || (VTK_MAJOR_VERSION >= 8 && VTK_MINOR_VERSION >= 2)
-      this->Cutter->SetInputConnection(this->ModelWarper->GetOutputPort());
       this->Cutter->SetPlane(this->Plane);
       this->Cutter->BuildTreeOff(); // the cutter crashes for complex geometries if build tree is enabled
       vtkSmartPointer<vtkTransformPolyDataFilter> polyDataOutlineTransformer = vtkSmartPointer<vtkTransformPolyDataFilter>::New();
@@ -263,6 +286,17 @@ public:
 #endif
     vtkSmartPointer<vtkContourTriangulator> Triangulator;
 
+    /// Slab index of the surface cells (in world coordinate system) along the slice normal.
+    /// Each slab contains the cells that overlap with it, so that only these cells have to be cut
+    /// when the slice plane is moved along its normal.
+    std::vector<std::vector<vtkIdType> > SlabCells;
+    double SlabIndexNormal[3];
+    double SlabIndexOrigin;
+    double SlabThickness;
+    vtkMTimeType SlabIndexUpdatedTime;
+    /// Cells of the surface that intersect the slice plane
+    vtkSmartPointer<vtkPolyData> NearbyCells;
+
     vtkSmartPointer<vtkActor2D> ImageOutlineActor;
     vtkSmartPointer<vtkActor2D> ImageFillActor;
     vtkSmartPointer<vtkImageReslice> Reslice;
@@ -273,6 +307,18 @@ public:
     vtkSmartPointer<vtkImageThreshold> ImageThreshold;
 
     vtkMTimeType SliceIntersectionUpdatedTime;
+
+    /// Resliced labelmap images of recently displayed slices, most recently used first.
+    /// An entry can be reused if the labelmap has not changed and the reslicing parameters are the same.
+    struct ResliceCacheEntry
+      {
+      double SliceToImageMatrix[16];
+      int OutputExtent[6];
+      int InterpolationMode;
+      vtkMTimeType ImageMTime;
+      vtkSmartPointer<vtkImageData> ReslicedImage;
+      };
+    std::list<ResliceCacheEntry> ResliceCache;
     };
 
   typedef std::map<vtkSmartPointer<vtkDataObject>, Pipeline*> PipelineMapType; // first: representation object; second: display pipeline
@@ -316,6 +362,15 @@ public:
   void ClearDisplayableNodes();
   bool IsSegmentVisibleInCurrentSlice(vtkMRMLSegmentationDisplayNode* displayNode, Pipeline* pipeline, const std::string &segmentID);
 
+  /// Set the surface as cutter input. For large surfaces only those cells are used that intersect the slice plane
+  /// (found using a slab index, which is rebuilt when the surface or the slice normal changes).
+  /// Pipeline's model warper and plane must be set up before calling this method.
+  void UpdateCutterInput(Pipeline* pipeline);
+
+  /// Get resliced image from the pipeline's cache or compute it using the pipeline's reslice filter
+  /// (and store it in the cache). Reslice filter must be fully set up before calling this method.
+  vtkImageData* GetReslicedImage(Pipeline* pipeline, vtkOrientedImageData* imageData, vtkMatrix4x4* sliceToImageMatrix);
+
 private:
   vtkSmartPointer<vtkMatrix4x4> SliceXYToRAS;
   vtkMRMLSegmentationsDisplayableManager2D* External;
@@ -845,6 +900,7 @@ void vtkMRMLSegmentationsDisplayableManager2D::vtkInternal::UpdateDisplayNodePip
         // Set Plane transform
         this->SetSlicePlaneFromMatrix(this->SliceXYToRAS, pipeline->Plane);
         pipeline->Plane->Modified();
+        this->UpdateCutterInput(pipeline);
 
         // Set PolyData transform
         vtkNew<vtkMatrix4x4> rasToSliceXY;
@@ -1071,7 +1127,9 @@ void vtkMRMLSegmentationsDisplayableManager2D::vtkInternal::UpdateDisplayNodePip
       // to a linear transform.
       // Also attempt to make it a permute transform, as it makes reslicing even faster.
       vtkSmartPointer<vtkTransform> linearSliceToImageTransform = vtkSmartPointer<vtkTransform>::New();
-      if (vtkMRMLTransformNode::IsGeneralTransformLinear(pipeline->SliceToImageTransform, linearSliceToImageTransform))
+      bool sliceToImageTransformLinear = vtkMRMLTransformNode::IsGeneralTransformLinear(
+        pipeline->SliceToImageTransform, linearSliceToImageTransform);
+      if (sliceToImageTransformLinear)
         {
         SnapToPermuteMatrix(linearSliceToImageTransform);
         pipeline->Reslice->SetResliceTransform(linearSliceToImageTransform);
@@ -1102,6 +1160,17 @@ void vtkMRMLSegmentationsDisplayableManager2D::vtkInternal::UpdateDisplayNodePip
       int sliceOutputExtent[6] = { 0, dimensions[0] - 1, 0, dimensions[1] - 1, 0, dimensions[2] - 1 };
       pipeline->Reslice->SetOutputExtent(sliceOutputExtent);
 
+      if (sliceToImageTransformLinear
+        && shownRepresenatationName != vtkSegmentationConverter::GetSegmentationFractionalLabelmapRepresentationName())
+        {
+        // Reuse resliced image of recently displayed slices.
+        // Non-linear transforms cannot be compared cheaply, so in that case cache is not used.
+        vtkImageData* reslicedImage = this->GetReslicedImage(pipeline, imageData, linearSliceToImageTransform->GetMatrix());
+        pipeline->LabelOutline->SetInputData(reslicedImage);
+        pipeline->ImageFillActor->GetMapper()->GetInputAlgorithm()->SetInputData(reslicedImage);
+        continue;
+        }
+
       // Smooth the border of fractional labelmaps
       pipeline->LabelOutline->SetInputConnection(pipeline->Reslice->GetOutputPort());
       pipeline->ImageFillActor->GetMapper()->GetInputAlgorithm()->SetInputConnection(pipeline->Reslice->GetOutputPort());
@@ -1133,6 +1202,142 @@ void vtkMRMLSegmentationsDisplayableManager2D::vtkInternal::UpdateDisplayNodePip
     }
 }
 
+//---------------------------------------------------------------------------
+void vtkMRMLSegmentationsDisplayableManager2D::vtkInternal::UpdateCutterInput(Pipeline* pipeline)
+{
+  pipeline->ModelWarper->Update();
+  vtkPolyData* surface = pipeline->ModelWarper->GetOutput();
+  vtkPoints* points = surface->GetPoints();
+  vtkCellArray* polys = surface->GetPolys();
+  if (!points || !polys || surface->GetNumberOfCells() != polys->GetNumberOfCells()
+    || polys->GetNumberOfCells() < SLAB_INDEX_MINIMUM_NUMBER_OF_CELLS)
+    {
+    // Small surface or it contains other cells than polygons, cut it directly
+    pipeline->SlabCells.clear();
+    pipeline->Cutter->SetInputData(surface);
+    return;
+    }
+
+  double normal[3] = { 0.0, 0.0, 1.0 };
+  pipeline->Plane->GetNormal(normal);
+  vtkMath::Normalize(normal);
+
+  // Rebuild slab index if the surface or the slice normal has changed
+  if (pipeline->SlabCells.empty() || pipeline->SlabIndexUpdatedTime < surface->GetMTime()
+    || vtkMath::Dot(normal, pipeline->SlabIndexNormal) < 1.0 - 1e-6)
+    {
+    vtkIdType numberOfCells = polys->GetNumberOfCells();
+    vtkIdType numberOfPoints = points->GetNumberOfPoints();
+    std::vector<double> pointPositions(numberOfPoints);
+    double minimumPosition = VTK_DOUBLE_MAX;
+    double maximumPosition = VTK_DOUBLE_MIN;
+    for (vtkIdType pointId = 0; pointId < numberOfPoints; ++pointId)
+      {
+      double point[3] = { 0.0, 0.0, 0.0 };
+      points->GetPoint(pointId, point);
+      pointPositions[pointId] = vtkMath::Dot(point, normal);
+      minimumPosition = std::min(minimumPosition, pointPositions[pointId]);
+      maximumPosition = std::max(maximumPosition, pointPositions[pointId]);
+      }
+    int numberOfSlabs = static_cast<int>(std::max(vtkIdType(1), numberOfCells / SLAB_INDEX_CELLS_PER_SLAB));
+    pipeline->SlabIndexOrigin = minimumPosition;
+    pipeline->SlabThickness = std::max((maximumPosition - minimumPosition) / numberOfSlabs, 1e-6);
+    pipeline->SlabCells.assign(numberOfSlabs, std::vector<vtkIdType>());
+    vtkNew<vtkIdList> cellPointIds;
+    polys->InitTraversal();
+    for (vtkIdType cellId = 0; polys->GetNextCell(cellPointIds); ++cellId)
+      {
+      double cellMinimumPosition = VTK_DOUBLE_MAX;
+      double cellMaximumPosition = VTK_DOUBLE_MIN;
+      for (vtkIdType i = 0; i < cellPointIds->GetNumberOfIds(); ++i)
+        {
+        double position = pointPositions[cellPointIds->GetId(i)];
+        cellMinimumPosition = std::min(cellMinimumPosition, position);
+        cellMaximumPosition = std::max(cellMaximumPosition, position);
+        }
+      int firstSlab = std::max(0, static_cast<int>((cellMinimumPosition - pipeline->SlabIndexOrigin) / pipeline->SlabThickness));
+      int lastSlab = std::min(numberOfSlabs - 1, static_cast<int>((cellMaximumPosition - pipeline->SlabIndexOrigin) / pipeline->SlabThickness));
+      for (int slab = firstSlab; slab <= lastSlab; ++slab)
+        {
+        pipeline->SlabCells[slab].push_back(cellId);
+        }
+      }
+    std::copy(normal, normal + 3, pipeline->SlabIndexNormal);
+    pipeline->SlabIndexUpdatedTime = surface->GetMTime();
+    }
+
+  // Collect cells of the slab that contains the slice plane
+  pipeline->NearbyCells->Initialize();
+  pipeline->NearbyCells->SetPoints(points);
+  pipeline->NearbyCells->GetPointData()->PassData(surface->GetPointData());
+  vtkNew<vtkCellArray> nearbyPolys;
+  double planeOrigin[3] = { 0.0, 0.0, 0.0 };
+  pipeline->Plane->GetOrigin(planeOrigin);
+  double planePosition = vtkMath::Dot(planeOrigin, normal);
+  int numberOfSlabs = static_cast<int>(pipeline->SlabCells.size());
+  if (planePosition >= pipeline->SlabIndexOrigin
+    && planePosition <= pipeline->SlabIndexOrigin + pipeline->SlabThickness * numberOfSlabs)
+    {
+    int slab = std::min(numberOfSlabs - 1,
+      static_cast<int>((planePosition - pipeline->SlabIndexOrigin) / pipeline->SlabThickness));
+    vtkNew<vtkIdList> cellPointIds;
+    for (vtkIdType cellId : pipeline->SlabCells[slab])
+      {
+      surface->GetCellPoints(cellId, cellPointIds);
+      nearbyPolys->InsertNextCell(cellPointIds);
+      }
+    }
+  pipeline->NearbyCells->SetPolys(nearbyPolys);
+  pipeline->Cutter->SetInputData(pipeline->NearbyCells);
+}
+
+//---------------------------------------------------------------------------
+vtkImageData* vtkMRMLSegmentationsDisplayableManager2D::vtkInternal::GetReslicedImage(
+  Pipeline* pipeline, vtkOrientedImageData* imageData, vtkMatrix4x4* sliceToImageMatrix)
+{
+  vtkMTimeType imageMTime = imageData->GetMTime();
+  vtkDataArray* scalars = imageData->GetPointData() ? imageData->GetPointData()->GetScalars() : nullptr;
+  if (scalars)
+    {
+    imageMTime = std::max(imageMTime, scalars->GetMTime());
+    }
+  int* outputExtent = pipeline->Reslice->GetOutputExtent();
+  int interpolationMode = pipeline->Reslice->GetInterpolationMode();
+
+  for (std::list<Pipeline::ResliceCacheEntry>::iterator entryIt = pipeline->ResliceCache.begin();
+    entryIt != pipeline->ResliceCache.end(); ++entryIt)
+    {
+    if (entryIt->ImageMTime != imageMTime || entryIt->InterpolationMode != interpolationMode
+      || !std::equal(outputExtent, outputExtent + 6, entryIt->OutputExtent)
+      || !std::equal(&sliceToImageMatrix->Element[0][0], &sliceToImageMatrix->Element[0][0] + 16, entryIt->SliceToImageMatrix))
+      {
+      continue;
+      }
+    // Move to front (most recently used)
+    pipeline->ResliceCache.splice(pipeline->ResliceCache.begin(), pipeline->ResliceCache, entryIt);
+    return pipeline->ResliceCache.front().ReslicedImage;
+    }
+
+  // Remove entries of previous versions of the labelmap, as they cannot be used anymore
+  pipeline->ResliceCache.remove_if([imageMTime](const Pipeline::ResliceCacheEntry& entry)
+    { return entry.ImageMTime != imageMTime; });
+
+  pipeline->Reslice->Update();
+  Pipeline::ResliceCacheEntry entry;
+  std::copy(&sliceToImageMatrix->Element[0][0], &sliceToImageMatrix->Element[0][0] + 16, entry.SliceToImageMatrix);
+  std::copy(outputExtent, outputExtent + 6, entry.OutputExtent);
+  entry.InterpolationMode = interpolationMode;
+  entry.ImageMTime = imageMTime;
+  entry.ReslicedImage = vtkSmartPointer<vtkImageData>::New();
+  entry.ReslicedImage->DeepCopy(pipeline->Reslice->GetOutput());
+  pipeline->ResliceCache.push_front(entry);
+  if (pipeline->ResliceCache.size() > RESLICED_IMAGE_CACHE_SIZE)
+    {
+    pipeline->ResliceCache.pop_back();
+    }
+  return pipeline->ResliceCache.front().ReslicedImage;
+}
+
 //---------------------------------------------------------------------------
 void vtkMRMLSegmentationsDisplayableManager2D::vtkInternal::AddObservations(vtkMRMLSegmentationNode* node)
 {
@@ -1692,10 +1897,15 @@ void vtkMRMLSegmentationsDisplayableManager2D::GetVisibleSegmentsForPosition(dou
         continue;
         }
 
-      for (int i = 0; i < segmentation->GetNumberOfSegments(); ++i)
+      // Only the segments that share this labelmap need to be checked
+      std::vector<std::string> layerSegmentIDs = segmentation->GetSegmentIDsForDataObject(imageData, shownRepresenatationName);
+      for (const std::string& segmentID : layerSegmentIDs)
         {
-        vtkSegment* segment = segmentation->GetNthSegment(i);
-        std::string segmentID = segmentation->GetSegmentIdBySegment(segment);
+        vtkSegment* segment = segmentation->GetSegment(segmentID);
+        if (!segment)
+          {
+          continue;
+          }
 
         // Skip if segment is not visible in the current slice
         if (!this->Internal->IsSegmentVisibleInCurrentSlice(displayNode, pipeline, segmentID))
@@ -1714,8 +1924,7 @@ void vtkMRMLSegmentationsDisplayableManager2D::GetVisibleSegmentsForPosition(dou
           }
 
         int labelmapValue = segment->GetLabelValue();
-        if ((shownRepresenatationName == vtkSegmentationConverter::GetBinaryLabelmapRepresentationName() && voxelValue != labelmapValue) ||
-          segment->GetRepresentation(shownRepresenatationName) != imageData)
+        if (shownRepresenatationName == vtkSegmentationConverter::GetBinaryLabelmapRepresentationName() && voxelValue != labelmapValue)
           {
           continue;
           }
@@ -1744,7 +1953,7 @@ void vtkMRMLSegmentationsDisplayableManager2D::GetVisibleSegmentsForPosition(dou
       int subId = -1;
       double dist2 = 0.0;
       double pcoords[3] = { 0.0, 0.0, 0.0 };
-      double* weights = new double[sliceFillPolyData->GetMaxCellSize()];
+      std::vector<double> weights(sliceFillPolyData->GetMaxCellSize());
       for (int index = 0; index<sliceFillPolyData->GetNumberOfCells(); ++index)
         {
         vtkCell* cell = sliceFillPolyData->GetCell(index);
@@ -1757,21 +1966,13 @@ void vtkMRMLSegmentationsDisplayableManager2D::GetVisibleSegmentsForPosition(dou
           continue;
           }
         // Inside bounds the position is evaluated in the cell
-        if (cell->EvaluatePosition(ras, nullptr, subId, pcoords, dist2, weights) == 1)
+        if (cell->EvaluatePosition(ras, nullptr, subId, pcoords, dist2, weights.data()) == 1)
           {
-          std::string segmentID;
-          for (int i = 0; i < segmentation->GetNumberOfSegments(); ++i)
-            {
-            vtkSegment* segment = segmentation->GetNthSegment(i);
-            if (pipelineIt->first == segment->GetRepresentation(displayNode->GetDisplayRepresentationName2D()))
-              {
-              segmentID = segmentation->GetSegmentIdBySegment(segment);
-              break;
-              }
-            }
-          if (!segmentID.empty())
+          std::vector<std::string> polyDataSegmentIDs =
+            segmentation->GetSegmentIDsForDataObject(polyData, shownRepresenatationName);
+          if (!polyDataSegmentIDs.empty())
             {
-            segmentIDsAtPosition.insert(segmentID);
+            segmentIDsAtPosition.insert(polyDataSegmentIDs[0]);
             }
           break;
           }
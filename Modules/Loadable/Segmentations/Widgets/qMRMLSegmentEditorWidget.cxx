@@ -3049,6 +3049,20 @@ void qMRMLSegmentEditorWidget::setMaximumNumberOfUndoStates(int maxNumberOfState
   d->SegmentationHistory->SetMaximumNumberOfStates(maxNumberOfStates);
 }
 
+//-----------------------------------------------------------------------------
+int qMRMLSegmentEditorWidget::maximumUndoMemorySizeMB() const
+{
+  Q_D(const qMRMLSegmentEditorWidget);
+  return d->SegmentationHistory->GetMaximumMemorySizeMB();
+}
+
+//-----------------------------------------------------------------------------
+void qMRMLSegmentEditorWidget::setMaximumUndoMemorySizeMB(int maximumMemorySizeMB)
+{
+  Q_D(qMRMLSegmentEditorWidget);
+  d->SegmentationHistory->SetMaximumMemorySizeMB(maximumMemorySizeMB);
+}
+
 //------------------------------------------------------------------------------
 bool qMRMLSegmentEditorWidget::readOnly() const
 {
@@ -72,6 +72,7 @@ class Q_SLICER_MODULE_SEGMENTATIONS_WIDGETS_EXPORT qMRMLSegmentEditorWidget : pu
   Q_PROPERTY(bool switchToSegmentationsButtonVisible READ switchToSegmentationsButtonVisible WRITE setSwitchToSegmentationsButtonVisible)
   Q_PROPERTY(bool undoEnabled READ undoEnabled WRITE setUndoEnabled)
   Q_PROPERTY(int maximumNumberOfUndoStates READ maximumNumberOfUndoStates WRITE setMaximumNumberOfUndoStates)
+  Q_PROPERTY(int maximumUndoMemorySizeMB READ maximumUndoMemorySizeMB WRITE setMaximumUndoMemorySizeMB)
   Q_PROPERTY(bool readOnly READ readOnly WRITE setReadOnly)
   Q_PROPERTY(Qt::ToolButtonStyle effectButtonStyle READ effectButtonStyle WRITE setEffectButtonStyle)
   Q_PROPERTY(bool unorderedEffectsVisible READ unorderedEffectsVisible WRITE setUnorderedEffectsVisible)
@@ -166,6 +167,8 @@ public:
   bool undoEnabled() const;
   /// Get maximum number of saved undo/redo states.
   int maximumNumberOfUndoStates() const;
+  /// Get maximum memory size of saved undo/redo states in megabytes. 0 means no limit.
+  int maximumUndoMemorySizeMB() const;
   /// Get whether widget is read-only
   bool readOnly() const;
 
@@ -266,6 +269,9 @@ public slots:
   void setUndoEnabled(bool);
   /// Set maximum number of saved undo/redo states.
   void setMaximumNumberOfUndoStates(int);
+  /// Set maximum memory size of saved undo/redo states in megabytes. 0 means no limit.
+  /// Oldest states are removed if the limit is exceeded.
+  void setMaximumUndoMemorySizeMB(int);
   /// Set whether the widget is read-only
   void setReadOnly(bool aReadOnly);
   /// Enable/disable masking using master volume intensity
@@ -42,6 +42,7 @@
 
 // VTK includes
 #include <vtkAbstractTransform.h>
+#include <vtkImageConstantPad.h>
 #include <vtkImageData.h>
 #include <vtkMatrix4x4.h>
 #include <vtkNew.h>
@@ -52,7 +53,32 @@
 
 // STL includes
 #include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <thread>
 
+namespace
+{
+//----------------------------------------------------------------------------
+/// Get data node of a synchronized sequence. Numeric index value is parsed only once
+/// for all synchronized sequences and found by binary search.
+vtkMRMLNode* GetSynchronizedDataNode(vtkMRMLSequenceNode* sequenceNode, const std::string& indexValue,
+  double numericIndexValue, bool exactMatchRequired)
+{
+  if (sequenceNode->GetIndexType() != vtkMRMLSequenceNode::NumericIndex)
+    {
+    return sequenceNode->GetDataNodeAtValue(indexValue, exactMatchRequired);
+    }
+  int itemNumber = sequenceNode->GetItemNumberFromNumericIndexValue(numericIndexValue, exactMatchRequired);
+  if (itemNumber < 0)
+    {
+    return nullptr;
+    }
+  return sequenceNode->GetNthDataNode(itemNumber);
+}
+}
 
 //----------------------------------------------------------------------------
 vtkStandardNewMacro(vtkSlicerSequencesLogic);
@@ -144,6 +170,7 @@ vtkMRMLSequenceNode* vtkSlicerSequencesLogic::AddSequence(const char* filename)
     }
   vtkNew<vtkMRMLSequenceNode> sequenceNode;
   vtkNew<vtkMRMLSequenceStorageNode> sequenceStorageNode;
+  vtkNew<vtkMRMLLinearTransformSequenceStorageNode> linearTransformSequenceStorageNode;
   vtkNew<vtkMRMLVolumeSequenceStorageNode> volumeSequenceStorageNode;
 
   vtkMRMLStorageNode* storageNode = nullptr;
@@ -151,6 +178,10 @@ vtkMRMLSequenceNode* vtkSlicerSequencesLogic::AddSequence(const char* filename)
     {
     storageNode = sequenceStorageNode;
     }
+  else if (linearTransformSequenceStorageNode->SupportedFileType(filename))
+    {
+    storageNode = linearTransformSequenceStorageNode;
+    }
   else if(volumeSequenceStorageNode->SupportedFileType(filename))
     {
     storageNode = volumeSequenceStorageNode;
@@ -244,6 +275,11 @@ void vtkSlicerSequencesLogic::UpdateAllProxyNodes()
       vtkErrorMacro("Browser node is invalid");
       continue;
       }
+    if (browserNode->GetRecordingActive() && browserNode->GetNumberOfQueuedRecordingSamples() > 0)
+      {
+      // Add samples that have been captured since the last update
+      browserNode->FlushRecordingQueue();
+      }
     if (!browserNode->GetPlaybackActive())
       {
       this->LastSequenceBrowserUpdateTimeSec.erase(browserNode);
@@ -318,6 +354,7 @@ void vtkSlicerSequencesLogic::UpdateProxyNodesFromSequences(vtkMRMLSequenceBrows
     {
     indexValue=browserNode->GetMasterSequenceNode()->GetNthIndexValue(selectedItemNumber);
     }
+  double numericIndexValue = atof(indexValue.c_str());
 
   std::vector< vtkMRMLSequenceNode* > synchronizedSequenceNodes;
   browserNode->GetSynchronizedSequenceNodes(synchronizedSequenceNodes, true);
@@ -345,12 +382,12 @@ void vtkSlicerSequencesLogic::UpdateProxyNodesFromSequences(vtkMRMLSequenceBrows
       // we want to save changes, therefore we have to make sure a data node is available for the current index
       if (synchronizedSequenceNode->GetNumberOfDataNodes() > 0)
         {
-        sourceDataNode = synchronizedSequenceNode->GetDataNodeAtValue(indexValue, true /*exact match*/);
+        sourceDataNode = GetSynchronizedDataNode(synchronizedSequenceNode, indexValue, numericIndexValue, true /*exact match*/);
         if (sourceDataNode == nullptr)
           {
           // No source node is available for the current exact index.
           // Add a copy of the closest (previous) item into the sequence at the exact index.
-          sourceDataNode = synchronizedSequenceNode->GetDataNodeAtValue(indexValue, false /*closest match*/);
+          sourceDataNode = GetSynchronizedDataNode(synchronizedSequenceNode, indexValue, numericIndexValue, false /*closest match*/);
           if (sourceDataNode)
             {
             sourceDataNode = synchronizedSequenceNode->SetDataNodeAtValue(sourceDataNode, indexValue);
@@ -371,7 +408,7 @@ void vtkSlicerSequencesLogic::UpdateProxyNodesFromSequences(vtkMRMLSequenceBrows
     else
       {
       // we just want to show a node, therefore we can just use closest data node
-      sourceDataNode = synchronizedSequenceNode->GetDataNodeAtValue(indexValue, false /*closest match*/);
+      sourceDataNode = GetSynchronizedDataNode(synchronizedSequenceNode, indexValue, numericIndexValue, false /*closest match*/);
       }
     if (sourceDataNode==nullptr)
       {
@@ -379,6 +416,15 @@ void vtkSlicerSequencesLogic::UpdateProxyNodesFromSequences(vtkMRMLSequenceBrows
       continue;
       }
 
+    // Voxels of lazily loaded volume sequences are only read when the frame is shown
+    vtkMRMLVolumeSequenceStorageNode* volumeSequenceStorageNode =
+      vtkMRMLVolumeSequenceStorageNode::SafeDownCast(synchronizedSequenceNode->GetStorageNode());
+    if (volumeSequenceStorageNode && !volumeSequenceStorageNode->LoadFrame(sourceDataNode))
+      {
+      vtkErrorMacro("vtkSlicerSequencesLogic::UpdateProxyNodesFromSequences: failed to read frame of sequence "
+        << (synchronizedSequenceNode->GetName() ? synchronizedSequenceNode->GetName() : "(unnamed)"));
+      }
+
     // Get the current target output node
     vtkMRMLNode* targetProxyNode=browserNode->GetProxyNode(synchronizedSequenceNode);
     if (targetProxyNode!=nullptr)
@@ -739,3 +785,165 @@ vtkMRMLSequenceBrowserNode* vtkSlicerSequencesLogic::GetFirstBrowserNodeForSeque
     }
   return nullptr;
 }
+
+//---------------------------------------------------------------------------
+bool vtkSlicerSequencesLogic::ApplyToSequenceItems(vtkMRMLSequenceNode* inputSequence, vtkMRMLSequenceNode* outputSequence,
+  SequenceItemOperation operation, int numberOfThreads/*=0*/, int maximumNumberOfPendingItems/*=0*/)
+{
+  if (!inputSequence || !outputSequence || !operation)
+    {
+    vtkErrorMacro("vtkSlicerSequencesLogic::ApplyToSequenceItems failed: invalid input or output sequence or operation");
+    return false;
+    }
+  int numberOfItems = inputSequence->GetNumberOfDataNodes();
+  if (numberOfThreads <= 0)
+    {
+    numberOfThreads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    }
+  numberOfThreads = std::max(1, std::min(numberOfThreads, numberOfItems));
+  if (maximumNumberOfPendingItems <= 0)
+    {
+    maximumNumberOfPendingItems = 2 * numberOfThreads;
+    }
+
+  // Index values are retrieved before the output is cleared, as output may be the same as the input
+  std::vector<std::string> indexValues;
+  for (int itemNumber = 0; itemNumber < numberOfItems; ++itemNumber)
+    {
+    indexValues.push_back(inputSequence->GetNthIndexValue(itemNumber));
+    }
+
+  int wasModifying = outputSequence->StartModify();
+  if (outputSequence != inputSequence)
+    {
+    outputSequence->RemoveAllDataNodes();
+    outputSequence->SetIndexType(inputSequence->GetIndexType());
+    outputSequence->SetIndexName(inputSequence->GetIndexName());
+    outputSequence->SetIndexUnit(inputSequence->GetIndexUnit());
+    }
+
+  vtkMRMLVolumeSequenceStorageNode* volumeSequenceStorageNode =
+    vtkMRMLVolumeSequenceStorageNode::SafeDownCast(inputSequence->GetStorageNode());
+
+  struct PendingItem
+    {
+    /// Input node is referenced so that it remains valid even if the sequence releases it
+    vtkSmartPointer<vtkMRMLNode> InputNode;
+    vtkSmartPointer<vtkMRMLNode> OutputNode;
+    bool Done{false};
+    };
+  std::mutex mutex;
+  std::condition_variable itemQueued;
+  std::condition_variable itemDone;
+  std::deque<int> queuedItemNumbers;
+  std::map<int, PendingItem> pendingItems;
+  bool stopRequested = false;
+
+  std::vector<std::thread> workers;
+  for (int threadIndex = 0; threadIndex < numberOfThreads; ++threadIndex)
+    {
+    workers.push_back(std::thread([&]()
+      {
+      std::unique_lock<std::mutex> lock(mutex);
+      while (true)
+        {
+        itemQueued.wait(lock, [&]() { return stopRequested || !queuedItemNumbers.empty(); });
+        if (queuedItemNumbers.empty())
+          {
+          return;
+          }
+        int itemNumber = queuedItemNumbers.front();
+        queuedItemNumbers.pop_front();
+        vtkMRMLNode* inputNode = pendingItems[itemNumber].InputNode;
+        lock.unlock();
+        vtkSmartPointer<vtkMRMLNode> outputNode = inputNode ? operation(inputNode, itemNumber) : nullptr;
+        lock.lock();
+        pendingItems[itemNumber].OutputNode = outputNode;
+        pendingItems[itemNumber].Done = true;
+        itemDone.notify_all();
+        }
+      }));
+    }
+
+  bool success = true;
+  int nextItemNumberToQueue = 0;
+  for (int itemNumber = 0; itemNumber < numberOfItems; ++itemNumber)
+    {
+    // Keep the workers busy, but only with a limited number of items
+    while (nextItemNumberToQueue < numberOfItems && nextItemNumberToQueue - itemNumber < maximumNumberOfPendingItems)
+      {
+      vtkMRMLNode* inputNode = inputSequence->GetNthDataNode(nextItemNumberToQueue);
+      if (volumeSequenceStorageNode && !volumeSequenceStorageNode->LoadFrame(inputNode))
+        {
+        vtkErrorMacro("vtkSlicerSequencesLogic::ApplyToSequenceItems: failed to load item " << nextItemNumberToQueue);
+        inputNode = nullptr;
+        }
+      {
+      std::lock_guard<std::mutex> lock(mutex);
+      pendingItems[nextItemNumberToQueue].InputNode = inputNode;
+      queuedItemNumbers.push_back(nextItemNumberToQueue);
+      }
+      itemQueued.notify_one();
+      ++nextItemNumberToQueue;
+      }
+
+    // Results are stored in the sequence on this thread, in the order of the items
+    vtkSmartPointer<vtkMRMLNode> outputNode;
+    {
+    std::unique_lock<std::mutex> lock(mutex);
+    itemDone.wait(lock, [&]() { return pendingItems[itemNumber].Done; });
+    outputNode = pendingItems[itemNumber].OutputNode;
+    pendingItems.erase(itemNumber);
+    }
+    if (!outputNode)
+      {
+      vtkErrorMacro("vtkSlicerSequencesLogic::ApplyToSequenceItems: operation failed for item " << itemNumber);
+      success = false;
+      continue;
+      }
+    outputSequence->SetDataNodeAtValue(outputNode, indexValues[itemNumber]);
+    }
+
+  {
+  std::lock_guard<std::mutex> lock(mutex);
+  stopRequested = true;
+  }
+  itemQueued.notify_all();
+  for (std::thread& worker : workers)
+    {
+    worker.join();
+    }
+
+  outputSequence->EndModify(wasModifying);
+  return success;
+}
+
+//---------------------------------------------------------------------------
+bool vtkSlicerSequencesLogic::CropVolumeSequence(vtkMRMLSequenceNode* inputSequence, vtkMRMLSequenceNode* outputSequence,
+  int extent[6], double fillValue/*=0.0*/)
+{
+  int outputExtent[6] = { extent[0], extent[1], extent[2], extent[3], extent[4], extent[5] };
+  return this->ApplyToSequenceItems(inputSequence, outputSequence,
+    [outputExtent, fillValue](vtkMRMLNode* inputNode, int vtkNotUsed(itemNumber)) -> vtkSmartPointer<vtkMRMLNode>
+    {
+    vtkMRMLVolumeNode* inputVolume = vtkMRMLVolumeNode::SafeDownCast(inputNode);
+    if (!inputVolume || !inputVolume->GetImageData())
+      {
+      return nullptr;
+      }
+    vtkNew<vtkImageConstantPad> imageClip;
+    imageClip->SetInputData(inputVolume->GetImageData());
+    imageClip->SetOutputWholeExtent(const_cast<int*>(outputExtent));
+    imageClip->SetConstant(fillValue);
+    imageClip->Update();
+
+    vtkSmartPointer<vtkMRMLVolumeNode> outputVolume = vtkSmartPointer<vtkMRMLVolumeNode>::Take(inputVolume->NewInstance());
+    outputVolume->CopyContent(inputVolume, false);
+    vtkNew<vtkMatrix4x4> ijkToRAS;
+    inputVolume->GetIJKToRASMatrix(ijkToRAS);
+    outputVolume->SetAndObserveImageData(imageClip->GetOutput());
+    outputVolume->SetIJKToRASMatrix(ijkToRAS);
+    outputVolume->ShiftImageDataExtentToZeroStart();
+    return outputVolume.GetPointer();
+    });
+}
@@ -29,8 +29,12 @@
 
 // MRML includes
 
+// VTK includes
+#include <vtkSmartPointer.h>
+
 // STD includes
 #include <cstdlib>
+#include <functional>
 
 #include "vtkSlicerSequencesModuleLogicExport.h"
 
@@ -94,6 +98,32 @@ public:
   /// use GetBrowserNodesForSequenceNode instead.
   vtkMRMLSequenceBrowserNode* GetFirstBrowserNodeForSequenceNode(vtkMRMLSequenceNode* sequenceNode);
 
+#ifndef __VTK_WRAP__
+  /// Operation that computes the output node of a sequence item from the input data node.
+  /// It is called from worker threads, therefore it must not access the MRML scene
+  /// or modify the input node. Returns nullptr if the item cannot be processed.
+  typedef std::function<vtkSmartPointer<vtkMRMLNode>(vtkMRMLNode* inputDataNode, int itemNumber)> SequenceItemOperation;
+
+  /// Apply an operation to every item of the input sequence using a pool of worker threads
+  /// and store the results in the output sequence at the same index values.
+  /// Input data nodes are retrieved (and lazily loaded frames are read) on the calling thread,
+  /// at most \a maximumNumberOfPendingItems items ahead of the item that is stored next,
+  /// which limits the memory used by the operation.
+  /// If output sequence is the same as the input sequence then the items are replaced.
+  /// \param numberOfThreads number of worker threads, 0 means the number of hardware threads.
+  /// \param maximumNumberOfPendingItems 0 means twice the number of threads.
+  /// Returns false if the sequences are invalid or the operation failed for any of the items.
+  bool ApplyToSequenceItems(vtkMRMLSequenceNode* inputSequence, vtkMRMLSequenceNode* outputSequence,
+    SequenceItemOperation operation, int numberOfThreads = 0, int maximumNumberOfPendingItems = 0);
+#endif
+
+  /// Crop all volumes of a sequence to a voxel extent (in IJK coordinates of the volumes).
+  /// Voxels of the extent that are outside of the input volume are set to \a fillValue.
+  /// Volumes are cropped in parallel. See ApplyToSequenceItems.
+  /// Returns false if any of the items is not a volume or cropping failed.
+  bool CropVolumeSequence(vtkMRMLSequenceNode* inputSequence, vtkMRMLSequenceNode* outputSequence,
+    int extent[6], double fillValue = 0.0);
+
 protected:
   vtkSlicerSequencesLogic();
   ~vtkSlicerSequencesLogic() override;
@@ -25,6 +25,7 @@
 
 // MRML includes
 #include <vtkMRMLScene.h>
+#include <vtkMRMLTransformNode.h>
 #include <vtkMRMLVolumeNode.h>
 #include <vtkMRMLHierarchyNode.h>
 
@@ -32,6 +33,7 @@
 #include <vtkNew.h>
 #include <vtkIntArray.h>
 #include <vtkCommand.h>
+#include <vtkMatrix4x4.h>
 #include <vtkCollection.h>
 #include <vtkCollectionIterator.h>
 #include <vtkObjectFactory.h>
@@ -39,6 +41,7 @@
 #include <vtksys/RegularExpression.hxx>
 #include <vtkTimerLog.h>
 #include <vtkVariant.h>
+#include <vtkWeakPointer.h>
 
 // STD includes
 #include <sstream>
@@ -114,6 +117,30 @@ std::string vtkMRMLSequenceBrowserNode::SynchronizationProperties::ToString()
   return ss.str();
 }
 
+// Proxy node states that are captured during recording but not added to the sequences yet
+struct vtkMRMLSequenceBrowserNode::RecordingQueueType
+  {
+  struct ItemType
+    {
+    vtkWeakPointer<vtkMRMLSequenceNode> SequenceNode;
+    std::string IndexValue;
+    /// Copy of the proxy node, not set for linear transforms
+    vtkSmartPointer<vtkMRMLNode> DataNode;
+    /// Position of the matrix of a linear transform in TransformMatrixElements, -1 if not a transform
+    int MatrixElementsOffset{-1};
+    };
+
+  std::vector<ItemType> Items;
+  /// Elements of recorded transform matrices, 16 values for each
+  std::vector<double> TransformMatrixElements;
+  /// Copy of the first recorded transform of each sequence in the batch,
+  /// other properties than the matrix are only recorded from that
+  std::map<vtkMRMLSequenceNode*, vtkSmartPointer<vtkMRMLTransformNode> > TransformTemplates;
+  vtkNew<vtkMatrix4x4> Matrix;
+  /// Number of recorded time points
+  int NumberOfSamples{0};
+};
+
 //------------------------------------------------------------------------------
 vtkMRMLNodeNewMacro(vtkMRMLSequenceBrowserNode);
 
@@ -124,10 +151,14 @@ vtkMRMLSequenceBrowserNode::vtkMRMLSequenceBrowserNode()
   this->SetHideFromEditors(false);
   this->RecordingTimeOffsetSec = vtkTimerLog::GetUniversalTime();
   this->LastSaveProxyNodesStateTimeSec = vtkTimerLog::GetUniversalTime();
+  this->RecordingQueue = new RecordingQueueType;
 }
 
 //----------------------------------------------------------------------------
-vtkMRMLSequenceBrowserNode::~vtkMRMLSequenceBrowserNode() = default;
+vtkMRMLSequenceBrowserNode::~vtkMRMLSequenceBrowserNode()
+{
+  delete this->RecordingQueue;
+}
 
 //----------------------------------------------------------------------------
 void vtkMRMLSequenceBrowserNode::WriteXML(ostream& of, int nIndent)
@@ -143,6 +174,7 @@ void vtkMRMLSequenceBrowserNode::WriteXML(ostream& of, int nIndent)
   of << indent << " selectedItemNumber=\"" << this->SelectedItemNumber << "\"";
   of << indent << " recordingActive=\"" << (this->RecordingActive ? "true" : "false") << "\"";
   of << indent << " recordOnMasterModifiedOnly=\"" << (this->RecordMasterOnly ? "true" : "false") << "\"";
+  of << indent << " recordingBatchSize=\"" << this->RecordingBatchSize << "\"";
 
   std::string recordingSamplingModeString = this->GetRecordingSamplingModeAsString();
   if (!recordingSamplingModeString.empty())
@@ -261,6 +293,14 @@ void vtkMRMLSequenceBrowserNode::ReadXMLAttributes(const char** atts)
         this->SetRecordMasterOnly(0);
         }
       }
+    else if (!strcmp(attName, "recordingBatchSize"))
+      {
+      std::stringstream ss;
+      ss << attValue;
+      int recordingBatchSize = 1;
+      ss >> recordingBatchSize;
+      this->SetRecordingBatchSize(recordingBatchSize);
+      }
     else if (!strcmp(attName, "recordingSamplingMode"))
       {
       int recordingSamplingMode = this->GetRecordingSamplingModeFromString(attValue);
@@ -361,6 +401,7 @@ void vtkMRMLSequenceBrowserNode::Copy(vtkMRMLNode *anode)
   this->SetPlaybackLooped(node->GetPlaybackLooped());
   this->SetRecordMasterOnly(node->GetRecordMasterOnly());
   this->SetRecordingSamplingMode(node->GetRecordingSamplingMode());
+  this->SetRecordingBatchSize(node->GetRecordingBatchSize());
   this->SetIndexDisplayMode(node->GetIndexDisplayMode());
   this->SetIndexDisplayFormat(node->GetIndexDisplayFormat());
   this->SetRecordingActive(node->GetRecordingActive());
@@ -384,6 +425,7 @@ void vtkMRMLSequenceBrowserNode::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << " Recording active: " << (this->RecordingActive ? "true" : "false") << '\n';
   os << indent << " Recording on master modified only: " << (this->RecordMasterOnly ? "true" : "false") << '\n';
   os << indent << " Recording sampling mode: " << this->GetRecordingSamplingModeAsString() << "\n";
+  os << indent << " Recording batch size: " << this->RecordingBatchSize << "\n";
   os << indent << " Index display mode: " << this->GetIndexDisplayModeAsString() << "\n";
   os << indent << " Index display format: " << this->GetIndexDisplayFormat() << "\n";
 
@@ -946,6 +988,11 @@ void vtkMRMLSequenceBrowserNode::GetSynchronizedSequenceNodes(vtkCollection* syn
 //---------------------------------------------------------------------------
 void vtkMRMLSequenceBrowserNode::SetRecordingActive(bool recording)
 {
+  if (this->RecordingActive && !recording)
+    {
+    // Captured samples are not added later, as browsing may change proxy nodes
+    this->FlushRecordingQueue();
+    }
   // Before activating the recording, set the initial timestamp to be correct
   this->RecordingTimeOffsetSec = vtkTimerLog::GetUniversalTime();
   int numberOfItems = this->GetNumberOfItems();
@@ -958,6 +1005,14 @@ void vtkMRMLSequenceBrowserNode::SetRecordingActive(bool recording)
     timeString >> timeValue;
     this->RecordingTimeOffsetSec -= timeValue;
     }
+  if (recording && !this->RecordingActive)
+    {
+    // Preallocate the queue for a full batch
+    std::vector< vtkMRMLSequenceNode* > sequenceNodes;
+    this->GetSynchronizedSequenceNodes(sequenceNodes, true);
+    this->RecordingQueue->Items.reserve(sequenceNodes.size() * this->RecordingBatchSize);
+    this->RecordingQueue->TransformMatrixElements.reserve(sequenceNodes.size() * this->RecordingBatchSize * 16);
+    }
   if (this->RecordingActive!=recording)
     {
     this->RecordingActive = recording;
@@ -1078,10 +1133,28 @@ void vtkMRMLSequenceBrowserNode::SaveProxyNodesState()
       }
     this->LastSaveProxyNodesStateTimeSec = currentTime;
     currTime << (currentTime - this->RecordingTimeOffsetSec);
+
+    // Only capture the proxy node states now, they are added to the sequences in batches
+    std::vector< vtkMRMLSequenceNode* > sequenceNodes;
+    this->GetSynchronizedSequenceNodes(sequenceNodes, true);
+    for (vtkMRMLSequenceNode* sequenceNode : sequenceNodes)
+      {
+      if (this->GetRecording(sequenceNode))
+        {
+        this->QueueProxyNodeState(sequenceNode, currTime.str());
+        }
+      }
+    this->RecordingQueue->NumberOfSamples++;
+    if (this->RecordingQueue->NumberOfSamples >= this->RecordingBatchSize)
+      {
+      this->FlushRecordingQueue();
+      }
+    return;
     }
   else
     {
     // Recording a single snapshot
+    this->FlushRecordingQueue();
     // TODO: add support for non-numeric index type
     double lastItemTime = 0;
     int numberOfItems = this->GetNumberOfItems();
@@ -1117,6 +1190,103 @@ void vtkMRMLSequenceBrowserNode::SaveProxyNodesState()
   this->EndModify(wasModified);
 }
 
+//---------------------------------------------------------------------------
+void vtkMRMLSequenceBrowserNode::QueueProxyNodeState(vtkMRMLSequenceNode* sequenceNode, const std::string& indexValue)
+{
+  vtkMRMLNode* proxyNode = this->GetProxyNode(sequenceNode);
+  if (!proxyNode)
+    {
+    return;
+    }
+  RecordingQueueType::ItemType item;
+  item.SequenceNode = sequenceNode;
+  item.IndexValue = indexValue;
+  vtkMRMLTransformNode* transformProxyNode = vtkMRMLTransformNode::SafeDownCast(proxyNode);
+  if (transformProxyNode && transformProxyNode->IsLinear())
+    {
+    // Fast path for tracked tools: only store the matrix
+    vtkSmartPointer<vtkMRMLTransformNode>& transformTemplate = this->RecordingQueue->TransformTemplates[sequenceNode];
+    if (!transformTemplate)
+      {
+      transformTemplate = vtkSmartPointer<vtkMRMLTransformNode>::Take(
+        vtkMRMLTransformNode::SafeDownCast(transformProxyNode->CreateNodeInstance()));
+      transformTemplate->CopyContent(transformProxyNode);
+      }
+    transformProxyNode->GetMatrixTransformToParent(this->RecordingQueue->Matrix);
+    std::vector<double>& matrixElements = this->RecordingQueue->TransformMatrixElements;
+    item.MatrixElementsOffset = static_cast<int>(matrixElements.size());
+    const double* elements = &(this->RecordingQueue->Matrix->Element[0][0]);
+    matrixElements.insert(matrixElements.end(), elements, elements + 16);
+    }
+  else
+    {
+    item.DataNode = vtkSmartPointer<vtkMRMLNode>::Take(proxyNode->CreateNodeInstance());
+    item.DataNode->CopyContent(proxyNode);
+    }
+  this->RecordingQueue->Items.push_back(item);
+}
+
+//---------------------------------------------------------------------------
+void vtkMRMLSequenceBrowserNode::FlushRecordingQueue()
+{
+  RecordingQueueType* queue = this->RecordingQueue;
+  queue->NumberOfSamples = 0;
+  if (queue->Items.empty())
+    {
+    return;
+    }
+
+  // Sequence nodes and the browser node are only modified once for the whole batch
+  int wasModified = this->StartModify();
+  std::map<vtkMRMLSequenceNode*, int> sequenceNodesWasModified;
+  vtkNew<vtkMatrix4x4> matrix;
+  for (RecordingQueueType::ItemType& item : queue->Items)
+    {
+    vtkMRMLSequenceNode* sequenceNode = item.SequenceNode;
+    if (!sequenceNode)
+      {
+      // sequence node has been deleted since the state was captured
+      continue;
+      }
+    if (sequenceNodesWasModified.find(sequenceNode) == sequenceNodesWasModified.end())
+      {
+      sequenceNodesWasModified[sequenceNode] = sequenceNode->StartModify();
+      }
+    if (item.MatrixElementsOffset >= 0)
+      {
+      vtkMRMLTransformNode* transformTemplate = queue->TransformTemplates[sequenceNode];
+      matrix->DeepCopy(&queue->TransformMatrixElements[item.MatrixElementsOffset]);
+      transformTemplate->SetMatrixTransformToParent(matrix);
+      // the template is reused for the next item, so it must be deep-copied
+      sequenceNode->SetDataNodeAtValue(transformTemplate, item.IndexValue);
+      }
+    else
+      {
+      // the captured copy is not used anymore, so it is enough to shallow-copy it
+      sequenceNode->SetDataNodeAtValue(item.DataNode, item.IndexValue, true);
+      }
+    }
+  // clear does not release memory, the queue remains preallocated
+  queue->Items.clear();
+  queue->TransformMatrixElements.clear();
+  queue->TransformTemplates.clear();
+
+  for (std::map<vtkMRMLSequenceNode*, int>::iterator sequenceNodeIt = sequenceNodesWasModified.begin();
+    sequenceNodeIt != sequenceNodesWasModified.end(); ++sequenceNodeIt)
+    {
+    sequenceNodeIt->first->EndModify(sequenceNodeIt->second);
+    }
+  this->Modified();
+  this->SelectLastItem();
+  this->EndModify(wasModified);
+}
+
+//---------------------------------------------------------------------------
+int vtkMRMLSequenceBrowserNode::GetNumberOfQueuedRecordingSamples()
+{
+  return this->RecordingQueue->NumberOfSamples;
+}
+
 //---------------------------------------------------------------------------
 void vtkMRMLSequenceBrowserNode::OnNodeReferenceAdded(vtkMRMLNodeReference* nodeReference)
 {
@@ -159,6 +159,22 @@ public:
   vtkGetMacro(RecordingSamplingMode, int);
   virtual std::string GetRecordingSamplingModeAsString();
 
+  /// Number of samples that are collected during recording before they are added to the sequences.
+  /// Proxy node states are only captured (timestamped and copied) when they are modified and
+  /// they are added to the sequences in batches, which allows recording at high rates.
+  /// Only matrices are captured for linear transform proxy nodes.
+  /// Captured samples are added when the batch is full, when FlushRecordingQueue is called
+  /// (the sequences module calls it periodically), and when recording is stopped.
+  /// Default is 1 (samples are added immediately).
+  vtkSetClampMacro(RecordingBatchSize, int, 1, VTK_INT_MAX);
+  vtkGetMacro(RecordingBatchSize, int);
+
+  /// Add all captured samples to the sequences.
+  void FlushRecordingQueue();
+
+  /// Number of captured samples that have not been added to the sequences yet.
+  int GetNumberOfQueuedRecordingSamples();
+
   /// Helper functions for converting between string and code representation of recording sampling modes
   static std::string GetRecordingSamplingModeAsString(int recordingSamplingMode);
   static int GetRecordingSamplingModeFromString(const std::string &recordingSamplingModeString);
@@ -319,6 +335,9 @@ protected:
   std::string GetSynchronizationPostfixFromSequence(vtkMRMLSequenceNode* sequenceNode);
   std::string GetSynchronizationPostfixFromSequenceID(const char* sequenceNodeID);
 
+  /// Capture current state of the proxy node of the sequence into the recording queue
+  void QueueProxyNodeState(vtkMRMLSequenceNode* sequenceNode, const std::string& indexValue);
+
 protected:
   bool PlaybackActive{false};
   double PlaybackRateFps{10.0};
@@ -331,6 +350,7 @@ protected:
   double LastSaveProxyNodesStateTimeSec;
   bool RecordMasterOnly{false};
   int RecordingSamplingMode{vtkMRMLSequenceBrowserNode::SamplingLimitedToPlaybackFrameRate};
+  int RecordingBatchSize{1};
   int IndexDisplayMode{vtkMRMLSequenceBrowserNode::IndexDisplayAsIndexValue};
   std::string IndexDisplayFormat;
 
@@ -344,6 +364,9 @@ protected:
 private:
   struct SynchronizationProperties;
   std::map< std::string, SynchronizationProperties* > SynchronizationPropertiesMap;
+
+  struct RecordingQueueType;
+  RecordingQueueType* RecordingQueue;
 };
 
 #endif
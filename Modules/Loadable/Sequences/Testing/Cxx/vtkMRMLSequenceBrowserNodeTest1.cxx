@@ -26,6 +26,7 @@
 #include "vtkMRMLTransformNode.h"
 
 // VTK includes
+#include <vtkMatrix4x4.h>
 #include <vtkNew.h>
 
 double valueForIndex(int i)
@@ -102,5 +103,49 @@ int vtkMRMLSequenceBrowserNodeTest1(int argc, char* argv[])
     CHECK_STD_STRING(formattedIndexValue, expectedFormat);
     }
 
+  // Batched recording of a transform
+  vtkNew<vtkMRMLSequenceNode> recordedSequenceNode;
+  scene->AddNode(recordedSequenceNode.GetPointer());
+  vtkNew<vtkMRMLTransformNode> proxyTransformNode;
+  scene->AddNode(proxyTransformNode.GetPointer());
+  vtkNew<vtkMRMLSequenceBrowserNode> recordingBrowserNode;
+  scene->AddNode(recordingBrowserNode.GetPointer());
+  recordingBrowserNode->SetAndObserveMasterSequenceNodeID(recordedSequenceNode->GetID());
+  recordingBrowserNode->AddProxyNode(proxyTransformNode.GetPointer(), recordedSequenceNode.GetPointer(), false);
+  recordingBrowserNode->SetRecording(recordedSequenceNode.GetPointer(), true);
+  recordingBrowserNode->SetRecordingSamplingMode(vtkMRMLSequenceBrowserNode::SamplingAll);
+  recordingBrowserNode->SetRecordingBatchSize(5);
+  recordingBrowserNode->SetRecordingActive(true);
+
+  vtkNew<vtkMatrix4x4> matrix;
+  for (int i = 0; i < 3; ++i)
+    {
+    matrix->SetElement(0, 3, i);
+    proxyTransformNode->SetMatrixTransformToParent(matrix.GetPointer());
+    recordingBrowserNode->SaveProxyNodesState();
+    }
+  // Samples are only captured until the batch is full
+  CHECK_INT(recordingBrowserNode->GetNumberOfQueuedRecordingSamples(), 3);
+  CHECK_INT(recordedSequenceNode->GetNumberOfDataNodes(), 0);
+
+  for (int i = 3; i < 6; ++i)
+    {
+    matrix->SetElement(0, 3, i);
+    proxyTransformNode->SetMatrixTransformToParent(matrix.GetPointer());
+    recordingBrowserNode->SaveProxyNodesState();
+    }
+  CHECK_INT(recordingBrowserNode->GetNumberOfQueuedRecordingSamples(), 1);
+  CHECK_BOOL(recordedSequenceNode->GetNumberOfDataNodes() > 0, true);
+
+  // Stopping the recording adds the remaining samples
+  recordingBrowserNode->SetRecordingActive(false);
+  CHECK_INT(recordingBrowserNode->GetNumberOfQueuedRecordingSamples(), 0);
+  vtkMRMLTransformNode* lastRecordedTransformNode = vtkMRMLTransformNode::SafeDownCast(
+    recordedSequenceNode->GetNthDataNode(recordedSequenceNode->GetNumberOfDataNodes() - 1));
+  CHECK_NOT_NULL(lastRecordedTransformNode);
+  vtkNew<vtkMatrix4x4> lastRecordedMatrix;
+  lastRecordedTransformNode->GetMatrixTransformToParent(lastRecordedMatrix.GetPointer());
+  CHECK_DOUBLE(lastRecordedMatrix->GetElement(0, 3), 5.0);
+
   return 0;
 }
@@ -113,6 +113,67 @@ int vtkMRMLSequenceNodeTest1( int, char * [] )
   seqNode->UpdateIndexValue("96", "32");
   CHECK_BOOL(SequenceSortedByIndex(seqNode.GetPointer()), true);
 
+  // Numeric index lookup
+  CHECK_INT(seqNode->GetItemNumberFromNumericIndexValue(-1.0), 0);
+  CHECK_INT(seqNode->GetItemNumberFromIndexValue("32"), seqNode->GetItemNumberFromNumericIndexValue(32.0005));
+  CHECK_INT(seqNode->GetItemNumberFromNumericIndexValue(33.0), -1);
+  CHECK_STD_STRING(seqNode->GetNthIndexValue(seqNode->GetItemNumberFromNumericIndexValue(33.0, false)), "32");
+
+  // Text index lookup, after items are appended, removed, and renamed
+  vtkNew< vtkMRMLSequenceNode > textSeqNode;
+  textSeqNode->SetIndexType(vtkMRMLSequenceNode::TextIndex);
+  textSeqNode->SetDataNodeAtValue(dataNode.GetPointer(), "first");
+  textSeqNode->SetDataNodeAtValue(dataNode.GetPointer(), "second");
+  CHECK_INT(textSeqNode->GetItemNumberFromIndexValue("second"), 1);
+  textSeqNode->SetDataNodeAtValue(dataNode.GetPointer(), "third");
+  CHECK_INT(textSeqNode->GetItemNumberFromIndexValue("third"), 2);
+  textSeqNode->RemoveDataNodeAtValue("first");
+  CHECK_INT(textSeqNode->GetItemNumberFromIndexValue("third"), 1);
+  CHECK_INT(textSeqNode->GetItemNumberFromIndexValue("first"), -1);
+  textSeqNode->UpdateIndexValue("second", "fourth");
+  CHECK_INT(textSeqNode->GetItemNumberFromIndexValue("fourth"), 0);
+  CHECK_INT(textSeqNode->GetItemNumberFromIndexValue("second"), -1);
+
+  // Linear transforms stored as matrices
+  vtkNew< vtkMRMLSequenceNode > matrixSeqNode;
+  int numberOfMatrices = 100;
+  for (int i = 0; i < numberOfMatrices; i++)
+    {
+    std::ostringstream indexStr;
+    indexStr << i;
+    transformMatrix->SetElement(2, 3, i);
+    matrixSeqNode->SetMatrixAtValue(transformMatrix.GetPointer(), indexStr.str());
+    }
+  CHECK_INT(matrixSeqNode->GetNumberOfDataNodes(), numberOfMatrices);
+  CHECK_INT(matrixSeqNode->GetSequenceScene()->GetNumberOfNodes(), 0);
+  vtkNew<vtkMatrix4x4> itemMatrix;
+  CHECK_BOOL(matrixSeqNode->GetNthMatrix(40, itemMatrix.GetPointer()), true);
+  CHECK_DOUBLE(itemMatrix->GetElement(2, 3), 40.0);
+  CHECK_STD_STRING(matrixSeqNode->GetDataNodeClassName(), "vtkMRMLLinearTransformNode");
+
+  // Transform nodes are created on access, changes are kept when they are released
+  vtkMRMLTransformNode* itemTransformNode = vtkMRMLTransformNode::SafeDownCast(matrixSeqNode->GetDataNodeAtValue("50"));
+  CHECK_NOT_NULL(itemTransformNode);
+  itemTransformNode->GetMatrixTransformToParent(itemMatrix.GetPointer());
+  CHECK_DOUBLE(itemMatrix->GetElement(2, 3), 50.0);
+  itemMatrix->SetElement(0, 3, 7.0);
+  itemTransformNode->SetMatrixTransformToParent(itemMatrix.GetPointer());
+  for (int i = 0; i < numberOfMatrices; i++)
+    {
+    CHECK_NOT_NULL(matrixSeqNode->GetNthDataNode(i));
+    }
+  CHECK_BOOL(matrixSeqNode->GetSequenceScene()->GetNumberOfNodes() < numberOfMatrices, true);
+  CHECK_BOOL(matrixSeqNode->GetNthMatrix(50, itemMatrix.GetPointer()), true);
+  CHECK_DOUBLE(itemMatrix->GetElement(0, 3), 7.0);
+
+  // Copy keeps items stored as matrices
+  vtkNew< vtkMRMLSequenceNode > copiedMatrixSeqNode;
+  copiedMatrixSeqNode->Copy(matrixSeqNode.GetPointer());
+  CHECK_INT(copiedMatrixSeqNode->GetNumberOfDataNodes(), numberOfMatrices);
+  CHECK_INT(copiedMatrixSeqNode->GetSequenceScene()->GetNumberOfNodes(), 0);
+  CHECK_BOOL(copiedMatrixSeqNode->GetNthMatrix(50, itemMatrix.GetPointer()), true);
+  CHECK_DOUBLE(itemMatrix->GetElement(0, 3), 7.0);
+
   /*
   bool res = true;
   TESTING_OUTPUT_ASSERT_ERRORS_BEGIN();
@@ -0,0 +1,107 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Portions (c) Copyright Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// Sequences includes
+#include <vtkSlicerSequencesLogic.h>
+
+// MRML includes
+#include <vtkMRMLScalarVolumeNode.h>
+#include <vtkMRMLSequenceNode.h>
+
+// VTK includes
+#include <vtkDataArray.h>
+#include <vtkImageData.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+
+#include "vtkMRMLCoreTestingMacros.h"
+#include "vtkTestingOutputWindow.h"
+
+//-----------------------------------------------------------------------------
+int vtkSlicerSequencesLogicTest1( int , char * [] )
+{
+  vtkNew<vtkSlicerSequencesLogic> logic;
+
+  // Sequence of volumes, voxel values are the item number
+  const int numberOfItems = 25;
+  vtkNew<vtkMRMLSequenceNode> inputSequence;
+  inputSequence->SetIndexName("time");
+  inputSequence->SetIndexUnit("s");
+  for (int itemNumber = 0; itemNumber < numberOfItems; ++itemNumber)
+    {
+    vtkNew<vtkImageData> image;
+    image->SetDimensions(8, 8, 8);
+    image->AllocateScalars(VTK_SHORT, 1);
+    image->GetPointData()->GetScalars()->Fill(itemNumber);
+    vtkNew<vtkMRMLScalarVolumeNode> volume;
+    volume->SetAndObserveImageData(image);
+    volume->SetOrigin(10.0, 20.0, 30.0);
+    volume->SetSpacing(2.0, 2.0, 2.0);
+    inputSequence->SetDataNodeAtValue(volume, std::to_string(itemNumber * 0.5));
+    }
+
+  // Crop, extent extends beyond the input along the last axis
+  vtkNew<vtkMRMLSequenceNode> outputSequence;
+  int extent[6] = { 2, 5, 0, 3, 6, 9 };
+  CHECK_BOOL(logic->CropVolumeSequence(inputSequence, outputSequence, extent, -1.0), true);
+  CHECK_INT(outputSequence->GetNumberOfDataNodes(), numberOfItems);
+  CHECK_STD_STRING(outputSequence->GetIndexName(), "time");
+  for (int itemNumber = 0; itemNumber < numberOfItems; ++itemNumber)
+    {
+    CHECK_STD_STRING(outputSequence->GetNthIndexValue(itemNumber), inputSequence->GetNthIndexValue(itemNumber));
+    vtkMRMLScalarVolumeNode* outputVolume = vtkMRMLScalarVolumeNode::SafeDownCast(outputSequence->GetNthDataNode(itemNumber));
+    CHECK_NOT_NULL(outputVolume);
+    vtkImageData* outputImage = outputVolume->GetImageData();
+    CHECK_NOT_NULL(outputImage);
+    int* dimensions = outputImage->GetDimensions();
+    CHECK_INT(dimensions[0], 4);
+    CHECK_INT(dimensions[1], 4);
+    CHECK_INT(dimensions[2], 4);
+    CHECK_DOUBLE(outputVolume->GetOrigin()[0], 14.0);
+    CHECK_DOUBLE(outputVolume->GetOrigin()[2], 42.0);
+    CHECK_DOUBLE(outputImage->GetScalarComponentAsDouble(0, 0, 0, 0), itemNumber);
+    CHECK_DOUBLE(outputImage->GetScalarComponentAsDouble(0, 0, 3, 0), -1.0);
+    }
+
+  // In-place operation, with fewer threads and pending items than items
+  CHECK_BOOL(logic->ApplyToSequenceItems(inputSequence, inputSequence,
+    [](vtkMRMLNode* inputNode, int itemNumber) -> vtkSmartPointer<vtkMRMLNode>
+      {
+      vtkSmartPointer<vtkMRMLNode> outputNode = vtkSmartPointer<vtkMRMLNode>::Take(inputNode->NewInstance());
+      outputNode->CopyContent(inputNode);
+      outputNode->SetAttribute("ItemNumber", std::to_string(itemNumber).c_str());
+      return outputNode;
+      }, 3, 4), true);
+  CHECK_INT(inputSequence->GetNumberOfDataNodes(), numberOfItems);
+  for (int itemNumber = 0; itemNumber < numberOfItems; ++itemNumber)
+    {
+    CHECK_STD_STRING(std::string(inputSequence->GetNthDataNode(itemNumber)->GetAttribute("ItemNumber")), std::to_string(itemNumber));
+    }
+
+  // Failure of the operation is reported
+  TESTING_OUTPUT_ASSERT_ERRORS_BEGIN();
+  CHECK_BOOL(logic->ApplyToSequenceItems(inputSequence, outputSequence,
+    [](vtkMRMLNode* inputNode, int itemNumber) -> vtkSmartPointer<vtkMRMLNode>
+      {
+      return itemNumber == 7 ? nullptr : inputNode;
+      }), false);
+  TESTING_OUTPUT_ASSERT_ERRORS_END();
+  CHECK_INT(outputSequence->GetNumberOfDataNodes(), numberOfItems - 1);
+
+  std::cout << "vtkSlicerSequencesLogicTest1 passed." << std::endl;
+  return EXIT_SUCCESS;
+}
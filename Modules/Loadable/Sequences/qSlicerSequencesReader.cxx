@@ -91,6 +91,7 @@ QStringList qSlicerSequencesReader::extensions()const
 {
   return QStringList()
     << "Sequence (*.seq.mrb *.mrb)"
+    << "Linear Transform Sequence (*.tfm.seq.nrrd)"
     << "Volume Sequence (*.seq.nrrd *.seq.nhdr)" << "Volume Sequence (*.nrrd *.nhdr)";
 }
 
@@ -31,7 +31,9 @@
 #include "qMRMLSubjectHierarchyModel.h"
 
 // Qt includes
+#include <QHash>
 #include <QStandardItem>
+#include <QTimer>
 
 // -----------------------------------------------------------------------------
 // qMRMLSortFilterSubjectHierarchyProxyModelPrivate
@@ -43,13 +45,28 @@ class qMRMLSortFilterSubjectHierarchyProxyModelPrivate
 public:
   qMRMLSortFilterSubjectHierarchyProxyModelPrivate();
 
+  /// Discard all cached filter results
+  void invalidateFilterResults();
+  /// Get lowercase name of an item. Names are cached until the item changes
+  const QString& lowercaseItemName(vtkMRMLSubjectHierarchyNode* shNode, vtkIdType itemID);
+
   QString NameFilter;
+  QString LowercaseNameFilter;
+  QString PendingNameFilter;
+  QTimer NameFilterTimer;
   QString AttributeNameFilter;
   QString AttributeValueFilter;
   QStringList LevelFilter;
   QStringList NodeTypes;
   QStringList HideChildNodeTypes;
   vtkIdType HideItemsUnaffiliatedWithItemID;
+
+  /// Cached results of filterAcceptsItem, with and without accepting items based on their children
+  QHash<vtkIdType, bool> AcceptedItems;
+  QHash<vtkIdType, bool> AcceptedItemsWithoutChildren;
+  /// Flag indicating that the cached filter results are obsolete (they are cleared on next filtering)
+  bool FilterResultsValid;
+  QHash<vtkIdType, QString> LowercaseItemNames;
 };
 
 // -----------------------------------------------------------------------------
@@ -61,7 +78,29 @@ qMRMLSortFilterSubjectHierarchyProxyModelPrivate::qMRMLSortFilterSubjectHierarch
   , NodeTypes(QStringList())
   , HideChildNodeTypes(QStringList())
   , HideItemsUnaffiliatedWithItemID(vtkMRMLSubjectHierarchyNode::INVALID_ITEM_ID)
+  , FilterResultsValid(false)
+{
+  this->NameFilterTimer.setSingleShot(true);
+  this->NameFilterTimer.setInterval(0);
+}
+
+// -----------------------------------------------------------------------------
+void qMRMLSortFilterSubjectHierarchyProxyModelPrivate::invalidateFilterResults()
 {
+  // Clearing is deferred, because the source model may change many times between two filterings
+  this->FilterResultsValid = false;
+}
+
+// -----------------------------------------------------------------------------
+const QString& qMRMLSortFilterSubjectHierarchyProxyModelPrivate::lowercaseItemName(
+  vtkMRMLSubjectHierarchyNode* shNode, vtkIdType itemID)
+{
+  QHash<vtkIdType, QString>::iterator nameIt = this->LowercaseItemNames.find(itemID);
+  if (nameIt == this->LowercaseItemNames.end())
+    {
+    nameIt = this->LowercaseItemNames.insert(itemID, QString::fromStdString(shNode->GetItemName(itemID)).toLower());
+    }
+  return nameIt.value();
 }
 
 // -----------------------------------------------------------------------------
@@ -87,6 +126,9 @@ qMRMLSortFilterSubjectHierarchyProxyModel::qMRMLSortFilterSubjectHierarchyProxyM
   // correct values (which doesn't call filterAcceptsRow() on the up to date
   // value unless DynamicSortFilter is true).
   this->setDynamicSortFilter(true);
+
+  Q_D(qMRMLSortFilterSubjectHierarchyProxyModel);
+  QObject::connect(&d->NameFilterTimer, SIGNAL(timeout()), this, SLOT(applyPendingNameFilter()));
 }
 
 //------------------------------------------------------------------------------
@@ -114,15 +156,113 @@ vtkMRMLSubjectHierarchyNode* qMRMLSortFilterSubjectHierarchyProxyModel::subjectH
   return model->subjectHierarchyNode();
 }
 
+//-----------------------------------------------------------------------------
+void qMRMLSortFilterSubjectHierarchyProxyModel::setSourceModel(QAbstractItemModel* newSourceModel)
+{
+  Q_D(qMRMLSortFilterSubjectHierarchyProxyModel);
+  if (this->sourceModel())
+    {
+    QObject::disconnect(this->sourceModel(), nullptr, this, nullptr);
+    }
+  d->LowercaseItemNames.clear();
+  d->invalidateFilterResults();
+  // Connect before the superclass so that cached results are invalidated before the
+  // proxy model processes the changes (when dynamic filtering is enabled)
+  if (newSourceModel)
+    {
+    QObject::connect(newSourceModel, SIGNAL(dataChanged(QModelIndex,QModelIndex)),
+      this, SLOT(onSourceDataChanged(QModelIndex,QModelIndex)));
+    QObject::connect(newSourceModel, SIGNAL(rowsInserted(QModelIndex,int,int)), this, SLOT(onSourceModelChanged()));
+    QObject::connect(newSourceModel, SIGNAL(rowsRemoved(QModelIndex,int,int)), this, SLOT(onSourceModelChanged()));
+    QObject::connect(newSourceModel, SIGNAL(rowsMoved(QModelIndex,int,int,QModelIndex,int)), this, SLOT(onSourceModelChanged()));
+    QObject::connect(newSourceModel, SIGNAL(layoutChanged()), this, SLOT(onSourceModelChanged()));
+    QObject::connect(newSourceModel, SIGNAL(modelReset()), this, SLOT(onSourceModelChanged()));
+    }
+  this->Superclass::setSourceModel(newSourceModel);
+}
+
+//-----------------------------------------------------------------------------
+void qMRMLSortFilterSubjectHierarchyProxyModel::onSourceModelChanged()
+{
+  Q_D(qMRMLSortFilterSubjectHierarchyProxyModel);
+  d->invalidateFilterResults();
+}
+
+//-----------------------------------------------------------------------------
+void qMRMLSortFilterSubjectHierarchyProxyModel::onSourceDataChanged(const QModelIndex& topLeft, const QModelIndex& bottomRight)
+{
+  Q_D(qMRMLSortFilterSubjectHierarchyProxyModel);
+  qMRMLSubjectHierarchyModel* model = qobject_cast<qMRMLSubjectHierarchyModel*>(this->sourceModel());
+  if (model)
+    {
+    // Names of the changed items need to be retrieved again
+    for (int row = topLeft.row(); row <= bottomRight.row(); ++row)
+      {
+      d->LowercaseItemNames.remove(model->subjectHierarchyItemFromIndex(topLeft.sibling(row, 0)));
+      }
+    }
+  // Acceptance of the ancestors of the changed items may also change
+  d->invalidateFilterResults();
+}
+
+//-----------------------------------------------------------------------------
+int qMRMLSortFilterSubjectHierarchyProxyModel::nameFilterDelay()const
+{
+  Q_D(const qMRMLSortFilterSubjectHierarchyProxyModel);
+  return d->NameFilterTimer.interval();
+}
+
+//-----------------------------------------------------------------------------
+void qMRMLSortFilterSubjectHierarchyProxyModel::setNameFilterDelay(int delayMsec)
+{
+  Q_D(qMRMLSortFilterSubjectHierarchyProxyModel);
+  d->NameFilterTimer.setInterval(qMax(0, delayMsec));
+}
+
 //-----------------------------------------------------------------------------
 void qMRMLSortFilterSubjectHierarchyProxyModel::setNameFilter(QString filter)
 {
   Q_D(qMRMLSortFilterSubjectHierarchyProxyModel);
-  if (d->NameFilter == filter)
+  d->PendingNameFilter = filter;
+  if (d->NameFilterTimer.interval() > 0)
     {
+    // Restart the timer, so that the filter is only applied when typing stops
+    d->NameFilterTimer.start();
     return;
     }
-  d->NameFilter = filter;
+  d->NameFilterTimer.stop();
+  this->applyPendingNameFilter();
+}
+
+//-----------------------------------------------------------------------------
+void qMRMLSortFilterSubjectHierarchyProxyModel::applyPendingNameFilter()
+{
+  Q_D(qMRMLSortFilterSubjectHierarchyProxyModel);
+  if (d->NameFilter == d->PendingNameFilter)
+    {
+    return;
+    }
+  QString newLowercaseNameFilter = d->PendingNameFilter.toLower();
+  if ( d->FilterResultsValid && !d->NameFilter.isEmpty()
+    && newLowercaseNameFilter.contains(d->LowercaseNameFilter) )
+    {
+    // The filter is extended (e.g. by typing), so the new criterion is stricter than the previous one:
+    // items that were filtered out remain filtered out, only the accepted items need to be evaluated again
+    for (QHash<vtkIdType, bool>::iterator itemIt = d->AcceptedItems.begin(); itemIt != d->AcceptedItems.end(); )
+      {
+      itemIt = (itemIt.value() ? d->AcceptedItems.erase(itemIt) : itemIt + 1);
+      }
+    for (QHash<vtkIdType, bool>::iterator itemIt = d->AcceptedItemsWithoutChildren.begin(); itemIt != d->AcceptedItemsWithoutChildren.end(); )
+      {
+      itemIt = (itemIt.value() ? d->AcceptedItemsWithoutChildren.erase(itemIt) : itemIt + 1);
+      }
+    }
+  else
+    {
+    d->invalidateFilterResults();
+    }
+  d->NameFilter = d->PendingNameFilter;
+  d->LowercaseNameFilter = newLowercaseNameFilter;
   this->invalidateFilter();
 }
 
@@ -135,6 +275,7 @@ void qMRMLSortFilterSubjectHierarchyProxyModel::setAttributeNameFilter(QString f
     return;
     }
   d->AttributeNameFilter = filter;
+  d->invalidateFilterResults();
   this->invalidateFilter();
 }
 
@@ -147,6 +288,7 @@ void qMRMLSortFilterSubjectHierarchyProxyModel::setAttributeValueFilter(QString
     return;
     }
   d->AttributeValueFilter = filter;
+  d->invalidateFilterResults();
   this->invalidateFilter();
 }
 
@@ -159,6 +301,7 @@ void qMRMLSortFilterSubjectHierarchyProxyModel::setLevelFilter(QStringList filte
     return;
     }
   d->LevelFilter = filter;
+  d->invalidateFilterResults();
   this->invalidateFilter();
 }
 
@@ -171,6 +314,7 @@ void qMRMLSortFilterSubjectHierarchyProxyModel::setNodeTypes(const QStringList&
     return;
     }
   d->NodeTypes = types;
+  d->invalidateFilterResults();
   this->invalidateFilter();
 }
 
@@ -183,6 +327,7 @@ void qMRMLSortFilterSubjectHierarchyProxyModel::setHideChildNodeTypes(const QStr
     return;
     }
   d->HideChildNodeTypes = types;
+  d->invalidateFilterResults();
   this->invalidateFilter();
 }
 
@@ -202,6 +347,7 @@ void qMRMLSortFilterSubjectHierarchyProxyModel::setHideItemsUnaffiliatedWithItem
     return;
     }
   d->HideItemsUnaffiliatedWithItemID = itemID;
+  d->invalidateFilterResults();
   this->invalidateFilter();
 }
 
@@ -292,7 +438,38 @@ bool qMRMLSortFilterSubjectHierarchyProxyModel::filterAcceptsRow(int sourceRow,
 bool qMRMLSortFilterSubjectHierarchyProxyModel::filterAcceptsItem(vtkIdType itemID,
                                                                   bool canAcceptIfAnyChildIsAccepted/*=true*/)const
 {
-  Q_D(const qMRMLSortFilterSubjectHierarchyProxyModel);
+  // The cache is modified in const methods, as it does not change the filtering results
+  qMRMLSortFilterSubjectHierarchyProxyModelPrivate* d =
+    const_cast<qMRMLSortFilterSubjectHierarchyProxyModelPrivate*>(this->d_func());
+  if (!d->FilterResultsValid)
+    {
+    d->AcceptedItems.clear();
+    d->AcceptedItemsWithoutChildren.clear();
+    d->FilterResultsValid = true;
+    }
+  // Accepting items with an accepted child evaluates the whole branch,
+  // so caching the results makes filtering the tree linear in the number of items
+  QHash<vtkIdType, bool>& acceptedItems = (canAcceptIfAnyChildIsAccepted ? d->AcceptedItems : d->AcceptedItemsWithoutChildren);
+  QHash<vtkIdType, bool>::const_iterator acceptedIt = acceptedItems.constFind(itemID);
+  if (acceptedIt != acceptedItems.constEnd())
+    {
+    return acceptedIt.value();
+    }
+  bool accepted = this->evaluateFilterForItem(itemID, canAcceptIfAnyChildIsAccepted);
+  // Evaluation may have invalidated the cache (reentrant filtering), in that case do not store the result
+  if (d->FilterResultsValid)
+    {
+    acceptedItems.insert(itemID, accepted);
+    }
+  return accepted;
+}
+
+//------------------------------------------------------------------------------
+bool qMRMLSortFilterSubjectHierarchyProxyModel::evaluateFilterForItem(vtkIdType itemID,
+                                                                      bool canAcceptIfAnyChildIsAccepted)const
+{
+  qMRMLSortFilterSubjectHierarchyProxyModelPrivate* d =
+    const_cast<qMRMLSortFilterSubjectHierarchyProxyModelPrivate*>(this->d_func());
 
   if (!itemID)
     {
@@ -462,8 +639,7 @@ bool qMRMLSortFilterSubjectHierarchyProxyModel::filterAcceptsItem(vtkIdType item
   // Filter by item name
   if (!d->NameFilter.isEmpty())
     {
-    QString itemName(shNode->GetItemName(itemID).c_str());
-    if (!itemName.contains(d->NameFilter, Qt::CaseInsensitive))
+    if (!d->lowercaseItemName(shNode, itemID).contains(d->LowercaseNameFilter))
       {
       if (canAcceptIfAnyChildIsAccepted)
         {
@@ -46,6 +46,10 @@ class Q_SLICER_MODULE_SUBJECTHIERARCHY_WIDGETS_EXPORT qMRMLSortFilterSubjectHier
 
   /// Filter to show only items that contain the string in their names. Empty by default
   Q_PROPERTY(QString nameFilter READ nameFilter WRITE setNameFilter)
+  /// Delay in milliseconds after the last change of the name filter before filtering is performed,
+  /// so that typing in a search box does not filter the whole tree on every keystroke.
+  /// 0 (default) filters immediately.
+  Q_PROPERTY(int nameFilterDelay READ nameFilterDelay WRITE setNameFilterDelay)
   /// Filter to show only items that contain an attribute with this name. Empty by default
   Q_PROPERTY(QString attributeNameFilter READ attributeNameFilter WRITE setAttributeNameFilter)
   /// Filter to show only items that contain an attribute with \sa attributeNameFilter (must be set)
@@ -79,6 +83,8 @@ public:
   Q_INVOKABLE vtkMRMLScene* mrmlScene()const;
 
   QString nameFilter()const;
+  int nameFilterDelay()const;
+  void setNameFilterDelay(int delayMsec);
   QString attributeNameFilter()const;
   QString attributeValueFilter()const;
   QStringList levelFilter()const;
@@ -106,9 +112,12 @@ public:
   /// This method test each item via \a filterAcceptsItem
   bool filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent)const override;
 
-  /// Filters items to decide which to display in the view
+  /// Filters items to decide which to display in the view.
+  /// Results are cached until the filter criteria or the source model change.
   virtual bool filterAcceptsItem(vtkIdType itemID, bool canAcceptIfAnyChildIsAccepted=true)const;
 
+  void setSourceModel(QAbstractItemModel* sourceModel) override;
+
   Qt::ItemFlags flags(const QModelIndex & index)const override;
 
 public slots:
@@ -119,7 +128,16 @@ public slots:
   void setNodeTypes(const QStringList& types);
   void setHideChildNodeTypes(const QStringList& types);
 
+protected slots:
+  /// Apply the name filter set with a delay
+  void applyPendingNameFilter();
+  /// Invalidate cached filter results when the source model changes
+  void onSourceModelChanged();
+  void onSourceDataChanged(const QModelIndex& topLeft, const QModelIndex& bottomRight);
+
 protected:
+  /// Evaluate the filter criteria for an item (without using the cached results)
+  bool evaluateFilterForItem(vtkIdType itemID, bool canAcceptIfAnyChildIsAccepted)const;
 
   QStandardItem* sourceItem(const QModelIndex& index)const;
 
@@ -55,6 +55,8 @@
 #include "qSlicerSubjectHierarchyAbstractPlugin.h"
 #include "qSlicerSubjectHierarchyDefaultPlugin.h"
 
+// STD includes
+#include <set>
 
 //------------------------------------------------------------------------------
 qMRMLSubjectHierarchyModelPrivate::qMRMLSubjectHierarchyModelPrivate(qMRMLSubjectHierarchyModel& object)
@@ -805,11 +807,67 @@ void qMRMLSubjectHierarchyModel::updateFromSubjectHierarchy()
   // Get all subject hierarchy items
   std::vector<vtkIdType> allItemIDs;
   d->SubjectHierarchyNode->GetItemChildren(d->SubjectHierarchyNode->GetSceneItemID(), allItemIDs, true);
+  std::set<vtkIdType> allItemIDSet(allItemIDs.begin(), allItemIDs.end());
 
-  // Update all items
+  // Remove the model items of the subject hierarchy items that have been removed (e.g. during
+  // batch processing). Children that are still in the hierarchy are inserted again below.
+  QList<QStandardItem*> removedItems;
+  QList<QStandardItem*> itemsToVisit;
+  itemsToVisit << this->subjectHierarchySceneItem();
+  while (!itemsToVisit.isEmpty())
+    {
+    QStandardItem* parentItem = itemsToVisit.takeLast();
+    for (int row=0; row<parentItem->rowCount(); ++row)
+      {
+      QStandardItem* childItem = parentItem->child(row);
+      if (!childItem)
+        {
+        continue;
+        }
+      if (allItemIDSet.count(this->subjectHierarchyItemFromItem(childItem)))
+        {
+        itemsToVisit << childItem;
+        }
+      else
+        {
+        removedItems << childItem;
+        }
+      }
+    }
+  foreach (QStandardItem* removedItem, removedItems)
+    {
+    removedItem->parent()->removeRow(removedItem->row());
+    }
+
+  // Insert the subject hierarchy items that are not in the model yet (e.g. added during scene
+  // import or batch processing). Parents are always before their children in the list.
+  std::set<vtkIdType> insertedItemIDs;
+  for (std::vector<vtkIdType>::iterator itemIt=allItemIDs.begin(); itemIt!=allItemIDs.end(); ++itemIt)
+    {
+    vtkIdType itemID = (*itemIt);
+    if (this->itemFromSubjectHierarchyItem(itemID))
+      {
+      continue;
+      }
+    int index = d->SubjectHierarchyNode->GetItemPositionUnderParent(itemID);
+    QStandardItem* parentItem = this->itemFromSubjectHierarchyItem(this->parentSubjectHierarchyItem(itemID));
+    if (parentItem && index > parentItem->rowCount())
+      {
+      // Siblings that have been moved are placed when they are updated
+      index = parentItem->rowCount();
+      }
+    d->insertSubjectHierarchyItem(itemID, index);
+    insertedItemIDs.insert(itemID);
+    }
+
+  // Update all the other items
   for (std::vector<vtkIdType>::iterator itemIt=allItemIDs.begin(); itemIt!=allItemIDs.end(); ++itemIt)
     {
     vtkIdType itemID = (*itemIt);
+    if (insertedItemIDs.count(itemID))
+      {
+      continue;
+      }
     for (int col=0; col<this->columnCount(); ++col)
       {
       QStandardItem* item = this->itemFromSubjectHierarchyItem(itemID, col);
@@ -1478,6 +1536,12 @@ void qMRMLSubjectHierarchyModel::onEvent(
 //------------------------------------------------------------------------------
 void qMRMLSubjectHierarchyModel::onSubjectHierarchyItemAdded(vtkIdType itemID)
 {
+  Q_D(qMRMLSubjectHierarchyModel);
+  if (d->MRMLScene && (d->MRMLScene->IsImporting() || d->MRMLScene->IsBatchProcessing()))
+    {
+    // The item is inserted when the model is updated after the import or batch processing
+    return;
+    }
   this->insertSubjectHierarchyItem(itemID);
 }
 
@@ -1555,8 +1619,12 @@ void qMRMLSubjectHierarchyModel::onSubjectHierarchyItemModified(vtkIdType itemID
 //------------------------------------------------------------------------------
 void qMRMLSubjectHierarchyModel::onMRMLSceneImported(vtkMRMLScene* scene)
 {
-  Q_UNUSED(scene);
-  this->rebuildFromSubjectHierarchy();
+  if (scene && scene->IsBatchProcessing())
+    {
+    // The model is updated once, at the end of the batch processing
+    return;
+    }
+  this->updateFromSubjectHierarchy();
 }
 
 //------------------------------------------------------------------------------
@@ -206,7 +206,9 @@ protected:
   /// This is a hard-update that is uses more resources. Use sparingly.
   virtual void rebuildFromSubjectHierarchy();
   /// Updates properties in the model based on subject hierarchy.
-  /// This is a soft update that is quick. Calls \sa rebuildFromSubjectHierarchy if necessary.
+  /// This is a soft update that is quick: items of removed subject hierarchy items are removed,
+  /// items that are not in the model yet are inserted, and the other items are updated.
+  /// Calls \sa rebuildFromSubjectHierarchy if necessary.
   virtual void updateFromSubjectHierarchy();
 
   virtual QStandardItem* insertSubjectHierarchyItem(vtkIdType itemID);
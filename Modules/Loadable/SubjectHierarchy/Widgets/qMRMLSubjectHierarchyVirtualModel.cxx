@@ -0,0 +1,1117 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Copyright (c) Brigham and Women's Hospital
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// Qt includes
+#include <QDebug>
+#include <QHash>
+#include <QIcon>
+#include <QVector>
+
+// SubjectHierarchy includes
+#include "qMRMLSubjectHierarchyVirtualModel.h"
+#include "qMRMLSubjectHierarchyModel.h"
+#include "qSlicerSubjectHierarchyPluginHandler.h"
+#include "qSlicerSubjectHierarchyAbstractPlugin.h"
+
+// Slicer includes
+#include <qSlicerCoreApplication.h>
+#include <qSlicerModuleManager.h>
+#include <qSlicerAbstractCoreModule.h>
+
+// MRML includes
+#include <vtkMRMLScene.h>
+#include <vtkMRMLSubjectHierarchyConstants.h>
+#include <vtkMRMLSubjectHierarchyNode.h>
+#include <vtkMRMLTransformNode.h>
+#include <vtkMRMLTransformableNode.h>
+
+// Terminologies includes
+#include "qSlicerTerminologyItemDelegate.h"
+#include "vtkSlicerTerminologyEntry.h"
+#include "vtkSlicerTerminologiesModuleLogic.h"
+
+// VTK includes
+#include <vtkCallbackCommand.h>
+#include <vtkSmartPointer.h>
+#include <vtkWeakPointer.h>
+
+//------------------------------------------------------------------------------
+// qMRMLSubjectHierarchyVirtualModelPrivate
+//------------------------------------------------------------------------------
+class qMRMLSubjectHierarchyVirtualModelPrivate
+{
+  Q_DECLARE_PUBLIC(qMRMLSubjectHierarchyVirtualModel);
+
+protected:
+  qMRMLSubjectHierarchyVirtualModel* const q_ptr;
+public:
+  qMRMLSubjectHierarchyVirtualModelPrivate(qMRMLSubjectHierarchyVirtualModel& object);
+  virtual ~qMRMLSubjectHierarchyVirtualModelPrivate();
+  void init();
+
+  /// Tree structure of an item. Only item IDs are stored, all other data is
+  /// retrieved from the subject hierarchy when requested.
+  struct TreeItem
+    {
+    TreeItem() : Parent(vtkMRMLSubjectHierarchyNode::INVALID_ITEM_ID), Row(0) {}
+    vtkIdType Parent;
+    /// Position of the item under its parent
+    int Row;
+    QVector<vtkIdType> Children;
+    };
+
+  /// Insert the item into the tree structure under the parent item at the given row.
+  /// Negative row appends the item.
+  void attachTreeItem(vtkIdType itemID, vtkIdType parentItemID, int row);
+  /// Remove the item from the children of its parent
+  void detachTreeItem(vtkIdType itemID);
+  /// Insert the item and all its children (as they are in the subject hierarchy) into the tree structure
+  void addSubtree(vtkIdType itemID, vtkIdType parentItemID, int row);
+  /// Remove the item and all its children from the tree structure
+  void removeSubtree(vtkIdType itemID);
+
+  /// Returns true if the model is not updated on item events (it is reset afterwards)
+  bool isUpdateSuspended()const;
+
+  /// Owner plugin of the item, nullptr if there is no owner plugin
+  qSlicerSubjectHierarchyAbstractPlugin* ownerPlugin(vtkIdType itemID)const;
+
+  /// Get terminologies module logic. If not found in cache get from module object
+  vtkSlicerTerminologiesModuleLogic* terminologiesModuleLogic();
+
+public:
+  vtkSmartPointer<vtkCallbackCommand> CallBack;
+
+  int NameColumn;
+  int IDColumn;
+  int VisibilityColumn;
+  int ColorColumn;
+  int TransformColumn;
+  int DescriptionColumn;
+
+  QIcon UnknownIcon;
+  QIcon WarningIcon;
+
+  QIcon NoTransformIcon;
+  QIcon FolderTransformIcon;
+  QIcon LinearTransformIcon;
+  QIcon DeformableTransformIcon;
+
+  vtkWeakPointer<vtkMRMLSubjectHierarchyNode> SubjectHierarchyNode;
+  vtkWeakPointer<vtkMRMLScene> MRMLScene;
+  vtkSlicerTerminologiesModuleLogic* TerminologiesModuleLogic;
+
+  vtkIdType SceneItemID;
+  QHash<vtkIdType, TreeItem> TreeItems;
+
+  /// Children of a removed item that are reinserted after the removal
+  /// (they are reparented if the removal is not recursive)
+  QList<vtkIdType> Orphans;
+};
+
+//------------------------------------------------------------------------------
+qMRMLSubjectHierarchyVirtualModelPrivate::qMRMLSubjectHierarchyVirtualModelPrivate(qMRMLSubjectHierarchyVirtualModel& object)
+  : q_ptr(&object)
+  , NameColumn(-1)
+  , IDColumn(-1)
+  , VisibilityColumn(-1)
+  , ColorColumn(-1)
+  , TransformColumn(-1)
+  , DescriptionColumn(-1)
+  , SubjectHierarchyNode(nullptr)
+  , MRMLScene(nullptr)
+  , TerminologiesModuleLogic(nullptr)
+  , SceneItemID(vtkMRMLSubjectHierarchyNode::INVALID_ITEM_ID)
+{
+  this->CallBack = vtkSmartPointer<vtkCallbackCommand>::New();
+
+  this->UnknownIcon = QIcon(":Icons/Unknown.png");
+  this->WarningIcon = QIcon(":Icons/Warning.png");
+
+  this->NoTransformIcon = QIcon(":/Icons/NoTransform.png");
+  this->FolderTransformIcon = QIcon(":/Icons/FolderTransform.png");
+  this->LinearTransformIcon = QIcon(":/Icons/LinearTransform.png");
+  this->DeformableTransformIcon = QIcon(":Icons/DeformableTransform.png");
+}
+
+//------------------------------------------------------------------------------
+qMRMLSubjectHierarchyVirtualModelPrivate::~qMRMLSubjectHierarchyVirtualModelPrivate()
+{
+  if (this->SubjectHierarchyNode)
+    {
+    this->SubjectHierarchyNode->RemoveObserver(this->CallBack);
+    }
+  if (this->MRMLScene)
+    {
+    this->MRMLScene->RemoveObserver(this->CallBack);
+    }
+}
+
+//------------------------------------------------------------------------------
+void qMRMLSubjectHierarchyVirtualModelPrivate::init()
+{
+  Q_Q(qMRMLSubjectHierarchyVirtualModel);
+  this->CallBack->SetClientData(q);
+  this->CallBack->SetCallback(qMRMLSubjectHierarchyVirtualModel::onEvent);
+
+  // Same columns as in qMRMLSubjectHierarchyModel
+  this->NameColumn = 0;
+  this->DescriptionColumn = 1;
+  this->VisibilityColumn = 2;
+  this->ColorColumn = 3;
+  this->TransformColumn = 4;
+  this->IDColumn = 5;
+}
+
+//------------------------------------------------------------------------------
+void qMRMLSubjectHierarchyVirtualModelPrivate::attachTreeItem(vtkIdType itemID, vtkIdType parentItemID, int row)
+{
+  // Create the entry of the item first, as inserting into the hash invalidates iterators
+  this->TreeItems[itemID].Parent = parentItemID;
+  QHash<vtkIdType, TreeItem>::iterator parentIt = this->TreeItems.find(parentItemID);
+  if (parentIt == this->TreeItems.end())
+    {
+    qCritical() << Q_FUNC_INFO << ": Parent item " << parentItemID << " is not in the model";
+    return;
+    }
+  QVector<vtkIdType>& siblings = parentIt->Children;
+  if (row < 0 || row > siblings.size())
+    {
+    row = siblings.size();
+    }
+  siblings.insert(row, itemID);
+  for (int siblingRow = row; siblingRow < siblings.size(); ++siblingRow)
+    {
+    this->TreeItems.find(siblings[siblingRow])->Row = siblingRow;
+    }
+}
+
+//------------------------------------------------------------------------------
+void qMRMLSubjectHierarchyVirtualModelPrivate::detachTreeItem(vtkIdType itemID)
+{
+  QHash<vtkIdType, TreeItem>::iterator itemIt = this->TreeItems.find(itemID);
+  if (itemIt == this->TreeItems.end())
+    {
+    return;
+    }
+  QHash<vtkIdType, TreeItem>::iterator parentIt = this->TreeItems.find(itemIt->Parent);
+  itemIt->Parent = vtkMRMLSubjectHierarchyNode::INVALID_ITEM_ID;
+  if (parentIt == this->TreeItems.end())
+    {
+    return;
+    }
+  QVector<vtkIdType>& siblings = parentIt->Children;
+  const int row = itemIt->Row;
+  siblings.remove(row);
+  for (int siblingRow = row; siblingRow < siblings.size(); ++siblingRow)
+    {
+    this->TreeItems.find(siblings[siblingRow])->Row = siblingRow;
+    }
+}
+
+//------------------------------------------------------------------------------
+void qMRMLSubjectHierarchyVirtualModelPrivate::addSubtree(vtkIdType itemID, vtkIdType parentItemID, int row)
+{
+  this->attachTreeItem(itemID, parentItemID, row);
+  std::vector<vtkIdType> childIDs;
+  this->SubjectHierarchyNode->GetItemChildren(itemID, childIDs);
+  for (std::vector<vtkIdType>::iterator childIt = childIDs.begin(); childIt != childIDs.end(); ++childIt)
+    {
+    this->addSubtree(*childIt, itemID, -1);
+    }
+}
+
+//------------------------------------------------------------------------------
+void qMRMLSubjectHierarchyVirtualModelPrivate::removeSubtree(vtkIdType itemID)
+{
+  this->detachTreeItem(itemID);
+  QHash<vtkIdType, TreeItem>::iterator itemIt = this->TreeItems.find(itemID);
+  if (itemIt == this->TreeItems.end())
+    {
+    return;
+    }
+  QVector<vtkIdType> childIDs = itemIt->Children;
+  this->TreeItems.erase(itemIt);
+  foreach(vtkIdType childID, childIDs)
+    {
+    // Children are erased without detaching them one by one
+    this->TreeItems.find(childID)->Parent = vtkMRMLSubjectHierarchyNode::INVALID_ITEM_ID;
+    this->removeSubtree(childID);
+    }
+}
+
+//------------------------------------------------------------------------------
+bool qMRMLSubjectHierarchyVirtualModelPrivate::isUpdateSuspended()const
+{
+  return !this->SubjectHierarchyNode
+    || (this->MRMLScene && (this->MRMLScene->IsClosing() || this->MRMLScene->IsBatchProcessing()));
+}
+
+//------------------------------------------------------------------------------
+qSlicerSubjectHierarchyAbstractPlugin* qMRMLSubjectHierarchyVirtualModelPrivate::ownerPlugin(vtkIdType itemID)const
+{
+  if (this->SubjectHierarchyNode->GetItemOwnerPluginName(itemID).empty())
+    {
+    return nullptr;
+    }
+  return qSlicerSubjectHierarchyPluginHandler::instance()->getOwnerPluginForSubjectHierarchyItem(itemID);
+}
+
+//------------------------------------------------------------------------------
+vtkSlicerTerminologiesModuleLogic* qMRMLSubjectHierarchyVirtualModelPrivate::terminologiesModuleLogic()
+{
+  if (this->TerminologiesModuleLogic)
+    {
+    return this->TerminologiesModuleLogic;
+    }
+  qSlicerAbstractCoreModule* terminologiesModule =
+    qSlicerCoreApplication::application()->moduleManager()->module("Terminologies");
+  if (terminologiesModule)
+    {
+    this->TerminologiesModuleLogic = vtkSlicerTerminologiesModuleLogic::SafeDownCast(terminologiesModule->logic());
+    }
+  return this->TerminologiesModuleLogic;
+}
+
+//------------------------------------------------------------------------------
+// qMRMLSubjectHierarchyVirtualModel
+//------------------------------------------------------------------------------
+qMRMLSubjectHierarchyVirtualModel::qMRMLSubjectHierarchyVirtualModel(QObject *_parent)
+  : QAbstractItemModel(_parent)
+  , d_ptr(new qMRMLSubjectHierarchyVirtualModelPrivate(*this))
+{
+  Q_D(qMRMLSubjectHierarchyVirtualModel);
+  d->init();
+}
+
+//------------------------------------------------------------------------------
+qMRMLSubjectHierarchyVirtualModel::~qMRMLSubjectHierarchyVirtualModel() = default;
+
+//------------------------------------------------------------------------------
+void qMRMLSubjectHierarchyVirtualModel::setMRMLScene(vtkMRMLScene* scene)
+{
+  Q_D(qMRMLSubjectHierarchyVirtualModel);
+  if (scene == d->MRMLScene)
+    {
+    return;
+    }
+  if (d->MRMLScene)
+    {
+    d->MRMLScene->RemoveObserver(d->CallBack);
+    }
+
+  d->MRMLScene = scene;
+  this->setSubjectHierarchyNode(scene ? vtkMRMLSubjectHierarchyNode::GetSubjectHierarchyNode(scene) : nullptr);
+
+  if (scene)
+    {
+    scene->AddObserver(vtkMRMLScene::EndCloseEvent, d->CallBack);
+    scene->AddObserver(vtkMRMLScene::EndImportEvent, d->CallBack);
+    scene->AddObserver(vtkMRMLScene::StartBatchProcessEvent, d->CallBack);
+    scene->AddObserver(vtkMRMLScene::EndBatchProcessEvent, d->CallBack);
+    scene->AddObserver(vtkMRMLScene::NodeRemovedEvent, d->CallBack);
+    }
+}
+
+//------------------------------------------------------------------------------
+vtkMRMLScene* qMRMLSubjectHierarchyVirtualModel::mrmlScene()const
+{
+  Q_D(const qMRMLSubjectHierarchyVirtualModel);
+  return d->MRMLScene;
+}
+
+//------------------------------------------------------------------------------
+void qMRMLSubjectHierarchyVirtualModel::setSubjectHierarchyNode(vtkMRMLSubjectHierarchyNode* shNode)
+{
+  Q_D(qMRMLSubjectHierarchyVirtualModel);
+  if (shNode == d->SubjectHierarchyNode)
+    {
+    return;
+    }
+  if (d->SubjectHierarchyNode)
+    {
+    d->SubjectHierarchyNode->RemoveObserver(d->CallBack);
+    }
+
+  d->SubjectHierarchyNode = shNode;
+  this->rebuildFromSubjectHierarchy();
+
+  if (shNode)
+    {
+    // Same priorities as in qMRMLSubjectHierarchyModel: the plugin handler processes new items
+    // before the model, and the model processes removal of items first.
+    shNode->AddObserver(vtkMRMLSubjectHierarchyNode::SubjectHierarchyItemAddedEvent, d->CallBack, -10.0);
+    shNode->AddObserver(vtkMRMLSubjectHierarchyNode::SubjectHierarchyItemAboutToBeRemovedEvent, d->CallBack, +10.0);
+    shNode->AddObserver(vtkMRMLSubjectHierarchyNode::SubjectHierarchyItemRemovedEvent, d->CallBack, -10.0);
+    shNode->AddObserver(vtkMRMLSubjectHierarchyNode::SubjectHierarchyItemModifiedEvent, d->CallBack, -10.0);
+    shNode->AddObserver(vtkMRMLSubjectHierarchyNode::SubjectHierarchyItemTransformModifiedEvent, d->CallBack, -10.0);
+    shNode->AddObserver(vtkMRMLSubjectHierarchyNode::SubjectHierarchyItemDisplayModifiedEvent, d->CallBack, -10.0);
+    shNode->AddObserver(vtkMRMLSubjectHierarchyNode::SubjectHierarchyItemReparentedEvent, d->CallBack, -10.0);
+    }
+}
+
+//------------------------------------------------------------------------------
+vtkMRMLSubjectHierarchyNode* qMRMLSubjectHierarchyVirtualModel::subjectHierarchyNode()const
+{
+  Q_D(const qMRMLSubjectHierarchyVirtualModel);
+  return d->SubjectHierarchyNode;
+}
+
+//------------------------------------------------------------------------------
+void qMRMLSubjectHierarchyVirtualModel::rebuildFromSubjectHierarchy()
+{
+  Q_D(qMRMLSubjectHierarchyVirtualModel);
+  this->beginResetModel();
+  d->TreeItems.clear();
+  d->Orphans.clear();
+  d->SceneItemID = vtkMRMLSubjectHierarchyNode::INVALID_ITEM_ID;
+  if (d->SubjectHierarchyNode)
+    {
+    d->SceneItemID = d->SubjectHierarchyNode->GetSceneItemID();
+    d->TreeItems.insert(d->SceneItemID, qMRMLSubjectHierarchyVirtualModelPrivate::TreeItem());
+    std::vector<vtkIdType> childIDs;
+    d->SubjectHierarchyNode->GetItemChildren(d->SceneItemID, childIDs);
+    for (std::vector<vtkIdType>::iterator childIt = childIDs.begin(); childIt != childIDs.end(); ++childIt)
+      {
+      d->addSubtree(*childIt, d->SceneItemID, -1);
+      }
+    }
+  this->endResetModel();
+}
+
+//------------------------------------------------------------------------------
+QModelIndex qMRMLSubjectHierarchyVirtualModel::subjectHierarchySceneIndex()const
+{
+  Q_D(const qMRMLSubjectHierarchyVirtualModel);
+  return this->indexFromSubjectHierarchyItem(d->SceneItemID);
+}
+
+//------------------------------------------------------------------------------
+vtkIdType qMRMLSubjectHierarchyVirtualModel::subjectHierarchyItemFromIndex(const QModelIndex& index)const
+{
+  if (!index.isValid() || index.model() != this)
+    {
+    return vtkMRMLSubjectHierarchyNode::INVALID_ITEM_ID;
+    }
+  return static_cast<vtkIdType>(index.internalId());
+}
+
+//------------------------------------------------------------------------------
+QModelIndex qMRMLSubjectHierarchyVirtualModel::indexFromSubjectHierarchyItem(vtkIdType itemID, int column/*=0*/)const
+{
+  Q_D(const qMRMLSubjectHierarchyVirtualModel);
+  QHash<vtkIdType, qMRMLSubjectHierarchyVirtualModelPrivate::TreeItem>::const_iterator itemIt = d->TreeItems.find(itemID);
+  if (itemIt == d->TreeItems.end() || column < 0 || column > this->maxColumnId())
+    {
+    return QModelIndex();
+    }
+  return this->createIndex(itemIt->Row, column, static_cast<quintptr>(itemID));
+}
+
+//------------------------------------------------------------------------------
+QModelIndex qMRMLSubjectHierarchyVirtualModel::index(int row, int column, const QModelIndex& parent/*=QModelIndex()*/)const
+{
+  Q_D(const qMRMLSubjectHierarchyVirtualModel);
+  if (row < 0 || column < 0 || column > this->maxColumnId())
+    {
+    return QModelIndex();
+    }
+  if (!parent.isValid())
+    {
+    // The scene item is the only top-level item
+    return (row == 0 ? this->indexFromSubjectHierarchyItem(d->SceneItemID, column) : QModelIndex());
+    }
+  if (parent.column() != 0)
+    {
+    return QModelIndex();
+    }
+  QHash<vtkIdType, qMRMLSubjectHierarchyVirtualModelPrivate::TreeItem>::const_iterator parentIt =
+    d->TreeItems.find(this->subjectHierarchyItemFromIndex(parent));
+  if (parentIt == d->TreeItems.end() || row >= parentIt->Children.size())
+    {
+    return QModelIndex();
+    }
+  return this->createIndex(row, column, static_cast<quintptr>(parentIt->Children[row]));
+}
+
+//------------------------------------------------------------------------------
+QModelIndex qMRMLSubjectHierarchyVirtualModel::parent(const QModelIndex& index)const
+{
+  Q_D(const qMRMLSubjectHierarchyVirtualModel);
+  QHash<vtkIdType, qMRMLSubjectHierarchyVirtualModelPrivate::TreeItem>::const_iterator itemIt =
+    d->TreeItems.find(this->subjectHierarchyItemFromIndex(index));
+  if (itemIt == d->TreeItems.end())
+    {
+    return QModelIndex();
+    }
+  return this->indexFromSubjectHierarchyItem(itemIt->Parent);
+}
+
+//------------------------------------------------------------------------------
+int qMRMLSubjectHierarchyVirtualModel::rowCount(const QModelIndex& parent/*=QModelIndex()*/)const
+{
+  Q_D(const qMRMLSubjectHierarchyVirtualModel);
+  if (!parent.isValid())
+    {
+    return (d->TreeItems.contains(d->SceneItemID) ? 1 : 0);
+    }
+  if (parent.column() != 0)
+    {
+    return 0;
+    }
+  QHash<vtkIdType, qMRMLSubjectHierarchyVirtualModelPrivate::TreeItem>::const_iterator parentIt =
+    d->TreeItems.find(this->subjectHierarchyItemFromIndex(parent));
+  return (parentIt == d->TreeItems.end() ? 0 : parentIt->Children.size());
+}
+
+//------------------------------------------------------------------------------
+int qMRMLSubjectHierarchyVirtualModel::columnCount(const QModelIndex& parent/*=QModelIndex()*/)const
+{
+  Q_UNUSED(parent);
+  return this->maxColumnId() + 1;
+}
+
+//------------------------------------------------------------------------------
+bool qMRMLSubjectHierarchyVirtualModel::hasChildren(const QModelIndex& parent/*=QModelIndex()*/)const
+{
+  return this->rowCount(parent) > 0;
+}
+
+//------------------------------------------------------------------------------
+QVariant qMRMLSubjectHierarchyVirtualModel::data(const QModelIndex& index, int role/*=Qt::DisplayRole*/)const
+{
+  Q_D(const qMRMLSubjectHierarchyVirtualModel);
+  vtkIdType itemID = this->subjectHierarchyItemFromIndex(index);
+  if (!d->SubjectHierarchyNode || !d->TreeItems.contains(itemID))
+    {
+    return QVariant();
+    }
+  if (role == qMRMLSubjectHierarchyModel::SubjectHierarchyItemIDRole)
+    {
+    return QVariant(qlonglong(itemID));
+    }
+  if (itemID == d->SceneItemID)
+    {
+    return QVariant();
+    }
+  return this->subjectHierarchyItemData(itemID, index.column(), role);
+}
+
+//------------------------------------------------------------------------------
+QVariant qMRMLSubjectHierarchyVirtualModel::subjectHierarchyItemData(vtkIdType itemID, int column, int role)const
+{
+  Q_D(const qMRMLSubjectHierarchyVirtualModel);
+  vtkMRMLSubjectHierarchyNode* shNode = d->SubjectHierarchyNode;
+  qSlicerSubjectHierarchyAbstractPlugin* ownerPlugin = d->ownerPlugin(itemID);
+
+  // Name column
+  if (column == this->nameColumn())
+    {
+    if (role == Qt::DisplayRole || role == Qt::EditRole)
+      {
+      return (ownerPlugin ? ownerPlugin->displayedItemName(itemID) : QString::fromStdString(shNode->GetItemName(itemID)));
+      }
+    if (role == Qt::ToolTipRole)
+      {
+      if (ownerPlugin)
+        {
+        return ownerPlugin->tooltip(itemID);
+        }
+      if (!shNode->GetItemOwnerPluginName(itemID).empty())
+        {
+        return tr("No subject hierarchy role assigned! Please report error");
+        }
+      return QVariant();
+      }
+    if (role == Qt::DecorationRole)
+      {
+      if (!ownerPlugin)
+        {
+        return (shNode->GetItemOwnerPluginName(itemID).empty() ? d->UnknownIcon : d->WarningIcon);
+        }
+      QIcon icon = ownerPlugin->icon(itemID);
+      return (icon.isNull() ? d->UnknownIcon : icon);
+      }
+    }
+
+  // ID column is shown even if there is no owner plugin
+  if (column == this->idColumn() && role == Qt::DisplayRole)
+    {
+    vtkMRMLNode* dataNode = shNode->GetItemDataNode(itemID);
+    return (dataNode ? QString(dataNode->GetID()) : QVariant());
+    }
+
+  if (!ownerPlugin)
+    {
+    return QVariant();
+    }
+
+  // Description column
+  if (column == this->descriptionColumn() && (role == Qt::DisplayRole || role == Qt::EditRole))
+    {
+    vtkMRMLNode* dataNode = shNode->GetItemDataNode(itemID);
+    return (dataNode ? QString(dataNode->GetDescription()) : QVariant());
+    }
+
+  // Visibility column
+  if (column == this->visibilityColumn())
+    {
+    if (role == qMRMLSubjectHierarchyModel::VisibilityRole)
+      {
+      return ownerPlugin->getDisplayVisibility(itemID);
+      }
+    if (role == Qt::DecorationRole)
+      {
+      QIcon visibilityIcon = ownerPlugin->visibilityIcon(ownerPlugin->getDisplayVisibility(itemID));
+      return (visibilityIcon.isNull() ? QVariant() : QVariant(visibilityIcon));
+      }
+    }
+
+  // Color column
+  if (column == this->colorColumn())
+    {
+    QMap<int, QVariant> terminologyMetaData;
+    QColor color = ownerPlugin->getDisplayColor(itemID, terminologyMetaData);
+    if (role == Qt::DecorationRole)
+      {
+      return color;
+      }
+    if (role == Qt::ToolTipRole)
+      {
+      vtkSlicerTerminologiesModuleLogic* terminologiesLogic =
+        const_cast<qMRMLSubjectHierarchyVirtualModelPrivate*>(d)->terminologiesModuleLogic();
+      if (!terminologiesLogic)
+        {
+        qCritical() << Q_FUNC_INFO << ": Terminologies module is not found";
+        return QVariant();
+        }
+      vtkSmartPointer<vtkSlicerTerminologyEntry> terminologyEntry = vtkSmartPointer<vtkSlicerTerminologyEntry>::New();
+      terminologiesLogic->DeserializeTerminologyEntry(
+        terminologyMetaData.value(qSlicerTerminologyItemDelegate::TerminologyRole).toString().toUtf8().constData(), terminologyEntry);
+      return QString(terminologiesLogic->GetInfoStringFromTerminologyEntry(terminologyEntry).c_str());
+      }
+    return terminologyMetaData.value(role);
+    }
+
+  // Transform column
+  if (column == this->transformColumn())
+    {
+    if (role == Qt::WhatsThisRole)
+      {
+      return QString("Transform");
+      }
+    vtkMRMLTransformableNode* transformableNode = vtkMRMLTransformableNode::SafeDownCast(shNode->GetItemDataNode(itemID));
+    vtkMRMLTransformNode* parentTransformNode = (transformableNode ? transformableNode->GetParentTransformNode() : nullptr);
+    if (role == qMRMLSubjectHierarchyModel::TransformIDRole)
+      {
+      return (parentTransformNode ? QString(parentTransformNode->GetID()) : QString());
+      }
+    if (role == Qt::DecorationRole)
+      {
+      if (transformableNode)
+        {
+        if (!parentTransformNode)
+          {
+          return d->NoTransformIcon;
+          }
+        return (parentTransformNode->IsLinear() ? d->LinearTransformIcon : d->DeformableTransformIcon);
+        }
+      return (d->TreeItems.value(itemID).Children.isEmpty() ? QVariant() : QVariant(d->FolderTransformIcon));
+      }
+    if (role == Qt::ToolTipRole)
+      {
+      if (transformableNode)
+        {
+        return (parentTransformNode ? tr("%1 (%2)").arg(parentTransformNode->GetName()).arg(parentTransformNode->GetID()) : QString());
+        }
+      return (d->TreeItems.value(itemID).Children.isEmpty() ? tr("This node is not transformable") : tr("Apply transform to children"));
+      }
+    }
+
+  return QVariant();
+}
+
+//------------------------------------------------------------------------------
+bool qMRMLSubjectHierarchyVirtualModel::setData(const QModelIndex& index, const QVariant& value, int role/*=Qt::EditRole*/)
+{
+  Q_D(qMRMLSubjectHierarchyVirtualModel);
+  vtkIdType itemID = this->subjectHierarchyItemFromIndex(index);
+  if (!d->SubjectHierarchyNode || !d->TreeItems.contains(itemID) || itemID == d->SceneItemID)
+    {
+    return false;
+    }
+  // The subject hierarchy invokes item modified events, which update the views
+  if (index.column() == this->nameColumn() && role == Qt::EditRole)
+    {
+    // This call renames associated data node if any
+    d->SubjectHierarchyNode->SetItemName(itemID, value.toString().toUtf8().constData());
+    return true;
+    }
+  if (index.column() == this->descriptionColumn() && role == Qt::EditRole)
+    {
+    vtkMRMLNode* dataNode = d->SubjectHierarchyNode->GetItemDataNode(itemID);
+    if (!dataNode)
+      {
+      return false;
+      }
+    dataNode->SetDescription(value.toString().toUtf8().constData());
+    return true;
+    }
+  if (index.column() == this->visibilityColumn() && role == qMRMLSubjectHierarchyModel::VisibilityRole)
+    {
+    qSlicerSubjectHierarchyAbstractPlugin* ownerPlugin = d->ownerPlugin(itemID);
+    if (!ownerPlugin)
+      {
+      return false;
+      }
+    ownerPlugin->setDisplayVisibility(itemID, value.toInt());
+    return true;
+    }
+  return false;
+}
+
+//------------------------------------------------------------------------------
+QVariant qMRMLSubjectHierarchyVirtualModel::headerData(int section, Qt::Orientation orientation, int role/*=Qt::DisplayRole*/)const
+{
+  if (orientation != Qt::Horizontal)
+    {
+    return QVariant();
+    }
+  if (role == Qt::DisplayRole)
+    {
+    if (section == this->nameColumn())
+      {
+      return tr("Node");
+      }
+    if (section == this->descriptionColumn())
+      {
+      return tr("Description");
+      }
+    if (section == this->idColumn())
+      {
+      return tr("IDs");
+      }
+    return QString();
+    }
+  if (role == Qt::ToolTipRole)
+    {
+    if (section == this->nameColumn())
+      {
+      return tr("Node name and type");
+      }
+    if (section == this->descriptionColumn())
+      {
+      return tr("Node description");
+      }
+    if (section == this->visibilityColumn())
+      {
+      return tr("Show/hide branch or node");
+      }
+    if (section == this->colorColumn())
+      {
+      return tr("Node color");
+      }
+    if (section == this->transformColumn())
+      {
+      return tr("Applied transform");
+      }
+    if (section == this->idColumn())
+      {
+      return tr("Node ID");
+      }
+    }
+  if (role == Qt::DecorationRole)
+    {
+    if (section == this->visibilityColumn())
+      {
+      return QIcon(":/Icons/Small/SlicerVisibleInvisible.png");
+      }
+    if (section == this->colorColumn())
+      {
+      return QIcon(":/Icons/Colors.png");
+      }
+    if (section == this->transformColumn())
+      {
+      return QIcon(":/Icons/Transform.png");
+      }
+    }
+  return QVariant();
+}
+
+//------------------------------------------------------------------------------
+Qt::ItemFlags qMRMLSubjectHierarchyVirtualModel::flags(const QModelIndex& index)const
+{
+  Q_D(const qMRMLSubjectHierarchyVirtualModel);
+  vtkIdType itemID = this->subjectHierarchyItemFromIndex(index);
+  if (!d->TreeItems.contains(itemID))
+    {
+    return Qt::NoItemFlags;
+    }
+  Qt::ItemFlags flags = Qt::ItemIsEnabled | Qt::ItemIsSelectable;
+  if (itemID != d->SceneItemID
+    && (index.column() == this->nameColumn() || index.column() == this->descriptionColumn()))
+    {
+    flags |= Qt::ItemIsEditable;
+    }
+  return flags;
+}
+
+//-----------------------------------------------------------------------------
+void qMRMLSubjectHierarchyVirtualModel::onEvent(
+  vtkObject* caller, unsigned long event, void* clientData, void* callData )
+{
+  vtkMRMLSubjectHierarchyNode* shNode = reinterpret_cast<vtkMRMLSubjectHierarchyNode*>(caller);
+  vtkMRMLScene* scene = reinterpret_cast<vtkMRMLScene*>(caller);
+  qMRMLSubjectHierarchyVirtualModel* model = reinterpret_cast<qMRMLSubjectHierarchyVirtualModel*>(clientData);
+  if (!model || (!shNode && !scene))
+    {
+    qCritical() << Q_FUNC_INFO << ": Invalid event parameters";
+    return;
+    }
+
+  // Get item ID for subject hierarchy node events
+  vtkIdType itemID = vtkMRMLSubjectHierarchyNode::INVALID_ITEM_ID;
+  if (callData)
+    {
+    vtkIdType* itemIdPtr = reinterpret_cast<vtkIdType*>(callData);
+    if (itemIdPtr)
+      {
+      itemID = *itemIdPtr;
+      }
+    }
+
+  // Get node for scene events
+  vtkMRMLNode* node = reinterpret_cast<vtkMRMLNode*>(callData);
+
+  switch (event)
+    {
+    case vtkMRMLSubjectHierarchyNode::SubjectHierarchyItemAddedEvent:
+      model->onSubjectHierarchyItemAdded(itemID);
+      break;
+    case vtkMRMLSubjectHierarchyNode::SubjectHierarchyItemAboutToBeRemovedEvent:
+      model->onSubjectHierarchyItemAboutToBeRemoved(itemID);
+      break;
+    case vtkMRMLSubjectHierarchyNode::SubjectHierarchyItemRemovedEvent:
+      model->onSubjectHierarchyItemRemoved(itemID);
+      break;
+    case vtkMRMLSubjectHierarchyNode::SubjectHierarchyItemModifiedEvent:
+    case vtkMRMLSubjectHierarchyNode::SubjectHierarchyItemTransformModifiedEvent:
+    case vtkMRMLSubjectHierarchyNode::SubjectHierarchyItemDisplayModifiedEvent:
+    case vtkMRMLSubjectHierarchyNode::SubjectHierarchyItemReparentedEvent:
+      model->onSubjectHierarchyItemModified(itemID);
+      break;
+    case vtkMRMLScene::EndImportEvent:
+      model->onMRMLSceneImported(scene);
+      break;
+    case vtkMRMLScene::EndCloseEvent:
+      model->onMRMLSceneClosed(scene);
+      break;
+    case vtkMRMLScene::StartBatchProcessEvent:
+      model->onMRMLSceneStartBatchProcess(scene);
+      break;
+    case vtkMRMLScene::EndBatchProcessEvent:
+      model->onMRMLSceneEndBatchProcess(scene);
+      break;
+    case vtkMRMLScene::NodeRemovedEvent:
+      model->onMRMLNodeRemoved(node);
+      break;
+    }
+}
+
+//------------------------------------------------------------------------------
+void qMRMLSubjectHierarchyVirtualModel::onSubjectHierarchyItemAdded(vtkIdType itemID)
+{
+  Q_D(qMRMLSubjectHierarchyVirtualModel);
+  if (d->isUpdateSuspended() || d->TreeItems.contains(itemID))
+    {
+    return;
+    }
+  vtkIdType parentItemID = d->SubjectHierarchyNode->GetItemParent(itemID);
+  QHash<vtkIdType, qMRMLSubjectHierarchyVirtualModelPrivate::TreeItem>::const_iterator parentIt = d->TreeItems.find(parentItemID);
+  if (parentIt == d->TreeItems.end())
+    {
+    qCritical() << Q_FUNC_INFO << ": Parent of subject hierarchy item " << itemID << " is not in the model";
+    return;
+    }
+  int row = qBound(0, d->SubjectHierarchyNode->GetItemPositionUnderParent(itemID), parentIt->Children.size());
+  this->beginInsertRows(this->indexFromSubjectHierarchyItem(parentItemID), row, row);
+  d->addSubtree(itemID, parentItemID, row);
+  this->endInsertRows();
+}
+
+//------------------------------------------------------------------------------
+void qMRMLSubjectHierarchyVirtualModel::onSubjectHierarchyItemAboutToBeRemoved(vtkIdType itemID)
+{
+  Q_D(qMRMLSubjectHierarchyVirtualModel);
+  if (d->isUpdateSuspended())
+    {
+    return;
+    }
+  d->Orphans.removeAll(itemID);
+  QHash<vtkIdType, qMRMLSubjectHierarchyVirtualModelPrivate::TreeItem>::const_iterator itemIt = d->TreeItems.find(itemID);
+  if (itemIt == d->TreeItems.end() || itemID == d->SceneItemID)
+    {
+    return;
+    }
+  // Children of the removed item are reparented if the removal is not recursive, therefore they are
+  // inserted again after the removal. Children of virtual branches are removed with their parent.
+  if (!d->SubjectHierarchyNode->IsItemVirtualBranchParent(itemID))
+    {
+    foreach(vtkIdType childID, itemIt->Children)
+      {
+      d->Orphans << childID;
+      }
+    }
+  const int row = itemIt->Row;
+  this->beginRemoveRows(this->indexFromSubjectHierarchyItem(itemIt->Parent), row, row);
+  d->removeSubtree(itemID);
+  this->endRemoveRows();
+}
+
+//------------------------------------------------------------------------------
+void qMRMLSubjectHierarchyVirtualModel::onSubjectHierarchyItemRemoved(vtkIdType itemID)
+{
+  Q_D(qMRMLSubjectHierarchyVirtualModel);
+  Q_UNUSED(itemID);
+  if (d->isUpdateSuspended())
+    {
+    return;
+    }
+  QList<vtkIdType> orphans = d->Orphans;
+  d->Orphans.clear();
+  foreach(vtkIdType orphanID, orphans)
+    {
+    this->onSubjectHierarchyItemAdded(orphanID);
+    }
+}
+
+//------------------------------------------------------------------------------
+void qMRMLSubjectHierarchyVirtualModel::onSubjectHierarchyItemModified(vtkIdType itemID)
+{
+  Q_D(qMRMLSubjectHierarchyVirtualModel);
+  if (d->isUpdateSuspended() || itemID == d->SceneItemID)
+    {
+    return;
+    }
+  QHash<vtkIdType, qMRMLSubjectHierarchyVirtualModelPrivate::TreeItem>::const_iterator itemIt = d->TreeItems.find(itemID);
+  if (itemIt == d->TreeItems.end())
+    {
+    return;
+    }
+
+  // Move the item if it was reparented or reordered
+  const vtkIdType oldParentItemID = itemIt->Parent;
+  const int oldRow = itemIt->Row;
+  const vtkIdType newParentItemID = d->SubjectHierarchyNode->GetItemParent(itemID);
+  QHash<vtkIdType, qMRMLSubjectHierarchyVirtualModelPrivate::TreeItem>::const_iterator newParentIt = d->TreeItems.find(newParentItemID);
+  if (newParentIt != d->TreeItems.end())
+    {
+    int newRow = d->SubjectHierarchyNode->GetItemPositionUnderParent(itemID);
+    const int lastRow = (newParentItemID == oldParentItemID ? newParentIt->Children.size() - 1 : newParentIt->Children.size());
+    newRow = qBound(0, newRow, lastRow);
+    if (newParentItemID != oldParentItemID || newRow != oldRow)
+      {
+      // Destination row is specified as the row before the item is removed from its parent
+      const int destinationRow = (newParentItemID == oldParentItemID && newRow > oldRow ? newRow + 1 : newRow);
+      if (!this->beginMoveRows(this->indexFromSubjectHierarchyItem(oldParentItemID), oldRow, oldRow,
+        this->indexFromSubjectHierarchyItem(newParentItemID), destinationRow))
+        {
+        this->rebuildFromSubjectHierarchy();
+        return;
+        }
+      d->detachTreeItem(itemID);
+      d->attachTreeItem(itemID, newParentItemID, newRow);
+      this->endMoveRows();
+      }
+    }
+
+  // Data is retrieved when the views request it
+  emit dataChanged(this->indexFromSubjectHierarchyItem(itemID, 0),
+    this->indexFromSubjectHierarchyItem(itemID, this->maxColumnId()));
+}
+
+//------------------------------------------------------------------------------
+void qMRMLSubjectHierarchyVirtualModel::onMRMLSceneImported(vtkMRMLScene* scene)
+{
+  Q_UNUSED(scene);
+  this->rebuildFromSubjectHierarchy();
+  emit subjectHierarchyUpdated();
+}
+
+//------------------------------------------------------------------------------
+void qMRMLSubjectHierarchyVirtualModel::onMRMLSceneClosed(vtkMRMLScene* scene)
+{
+  Q_D(qMRMLSubjectHierarchyVirtualModel);
+  // Make sure there is one subject hierarchy node in the scene, and it is used by the model
+  vtkMRMLSubjectHierarchyNode* newSubjectHierarchyNode = vtkMRMLSubjectHierarchyNode::ResolveSubjectHierarchy(scene);
+  if (!newSubjectHierarchyNode)
+    {
+    qCritical() << Q_FUNC_INFO << ": No subject hierarchy node could be retrieved from the scene";
+    }
+  if (newSubjectHierarchyNode == d->SubjectHierarchyNode)
+    {
+    // Item events are ignored while closing
+    this->rebuildFromSubjectHierarchy();
+    }
+  else
+    {
+    this->setSubjectHierarchyNode(newSubjectHierarchyNode);
+    }
+}
+
+//------------------------------------------------------------------------------
+void qMRMLSubjectHierarchyVirtualModel::onMRMLSceneStartBatchProcess(vtkMRMLScene* scene)
+{
+  Q_UNUSED(scene);
+  emit subjectHierarchyAboutToBeUpdated();
+}
+
+//------------------------------------------------------------------------------
+void qMRMLSubjectHierarchyVirtualModel::onMRMLSceneEndBatchProcess(vtkMRMLScene* scene)
+{
+  Q_UNUSED(scene);
+  // Item events are ignored during batch processing
+  this->rebuildFromSubjectHierarchy();
+  emit subjectHierarchyUpdated();
+}
+
+//------------------------------------------------------------------------------
+void qMRMLSubjectHierarchyVirtualModel::onMRMLNodeRemoved(vtkMRMLNode* node)
+{
+  Q_D(qMRMLSubjectHierarchyVirtualModel);
+  if (d->MRMLScene->IsClosing() || !node->IsA("vtkMRMLSubjectHierarchyNode"))
+    {
+    return;
+    }
+  // Make sure there is one subject hierarchy node in the scene, and it is used by the model
+  vtkMRMLSubjectHierarchyNode* newSubjectHierarchyNode = vtkMRMLSubjectHierarchyNode::ResolveSubjectHierarchy(d->MRMLScene);
+  if (!newSubjectHierarchyNode)
+    {
+    qCritical() << Q_FUNC_INFO << ": No subject hierarchy node could be retrieved from the scene";
+    }
+  this->setSubjectHierarchyNode(newSubjectHierarchyNode);
+}
+
+//------------------------------------------------------------------------------
+int qMRMLSubjectHierarchyVirtualModel::nameColumn()const
+{
+  Q_D(const qMRMLSubjectHierarchyVirtualModel);
+  return d->NameColumn;
+}
+
+//------------------------------------------------------------------------------
+void qMRMLSubjectHierarchyVirtualModel::setNameColumn(int column)
+{
+  Q_D(qMRMLSubjectHierarchyVirtualModel);
+  this->beginResetModel();
+  d->NameColumn = column;
+  this->endResetModel();
+}
+
+//------------------------------------------------------------------------------
+int qMRMLSubjectHierarchyVirtualModel::idColumn()const
+{
+  Q_D(const qMRMLSubjectHierarchyVirtualModel);
+  return d->IDColumn;
+}
+
+//------------------------------------------------------------------------------
+void qMRMLSubjectHierarchyVirtualModel::setIDColumn(int column)
+{
+  Q_D(qMRMLSubjectHierarchyVirtualModel);
+  this->beginResetModel();
+  d->IDColumn = column;
+  this->endResetModel();
+}
+
+//------------------------------------------------------------------------------
+int qMRMLSubjectHierarchyVirtualModel::visibilityColumn()const
+{
+  Q_D(const qMRMLSubjectHierarchyVirtualModel);
+  return d->VisibilityColumn;
+}
+
+//------------------------------------------------------------------------------
+void qMRMLSubjectHierarchyVirtualModel::setVisibilityColumn(int column)
+{
+  Q_D(qMRMLSubjectHierarchyVirtualModel);
+  this->beginResetModel();
+  d->VisibilityColumn = column;
+  this->endResetModel();
+}
+
+//------------------------------------------------------------------------------
+int qMRMLSubjectHierarchyVirtualModel::colorColumn()const
+{
+  Q_D(const qMRMLSubjectHierarchyVirtualModel);
+  return d->ColorColumn;
+}
+
+//------------------------------------------------------------------------------
+void qMRMLSubjectHierarchyVirtualModel::setColorColumn(int column)
+{
+  Q_D(qMRMLSubjectHierarchyVirtualModel);
+  this->beginResetModel();
+  d->ColorColumn = column;
+  this->endResetModel();
+}
+
+//------------------------------------------------------------------------------
+int qMRMLSubjectHierarchyVirtualModel::transformColumn()const
+{
+  Q_D(const qMRMLSubjectHierarchyVirtualModel);
+  return d->TransformColumn;
+}
+
+//------------------------------------------------------------------------------
+void qMRMLSubjectHierarchyVirtualModel::setTransformColumn(int column)
+{
+  Q_D(qMRMLSubjectHierarchyVirtualModel);
+  this->beginResetModel();
+  d->TransformColumn = column;
+  this->endResetModel();
+}
+
+//------------------------------------------------------------------------------
+int qMRMLSubjectHierarchyVirtualModel::descriptionColumn()const
+{
+  Q_D(const qMRMLSubjectHierarchyVirtualModel);
+  return d->DescriptionColumn;
+}
+
+//------------------------------------------------------------------------------
+void qMRMLSubjectHierarchyVirtualModel::setDescriptionColumn(int column)
+{
+  Q_D(qMRMLSubjectHierarchyVirtualModel);
+  this->beginResetModel();
+  d->DescriptionColumn = column;
+  this->endResetModel();
+}
+
+//------------------------------------------------------------------------------
+int qMRMLSubjectHierarchyVirtualModel::maxColumnId()const
+{
+  Q_D(const qMRMLSubjectHierarchyVirtualModel);
+  int maxId = -1;
+  maxId = qMax(maxId, d->NameColumn);
+  maxId = qMax(maxId, d->DescriptionColumn);
+  maxId = qMax(maxId, d->IDColumn);
+  maxId = qMax(maxId, d->VisibilityColumn);
+  maxId = qMax(maxId, d->ColorColumn);
+  maxId = qMax(maxId, d->TransformColumn);
+  return maxId;
+}
@@ -0,0 +1,156 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Copyright (c) Brigham and Women's Hospital
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#ifndef __qMRMLSubjectHierarchyVirtualModel_h
+#define __qMRMLSubjectHierarchyVirtualModel_h
+
+// Qt includes
+#include <QAbstractItemModel>
+
+// CTK includes
+#include <ctkPimpl.h>
+#include <ctkVTKObject.h>
+
+// SubjectHierarchy includes
+#include "qSlicerSubjectHierarchyModuleWidgetsExport.h"
+
+class qMRMLSubjectHierarchyVirtualModelPrivate;
+class vtkMRMLSubjectHierarchyNode;
+class vtkMRMLNode;
+class vtkMRMLScene;
+
+/// \brief Item model for subject hierarchy that does not store item data
+///
+/// Unlike qMRMLSubjectHierarchyModel, which creates a QStandardItem for each column of each
+/// subject hierarchy item and updates them whenever the items change, this model only keeps
+/// the tree structure (item IDs of the children of each item). Displayed data is retrieved from
+/// the subject hierarchy node and the owner plugins when the view requests it (in data()),
+/// therefore large hierarchies are loaded quickly and use little memory.
+///
+/// The model indices store the subject hierarchy item ID as internal ID. The scene item is
+/// the only top-level item (\sa subjectHierarchySceneIndex). Adding, removing, and reparenting
+/// items are propagated to the views as row insertion, removal, and move notifications,
+/// and the model is reset after scene import, close, or batch processing.
+///
+/// Columns, properties, and data roles are the same as in qMRMLSubjectHierarchyModel.
+/// Names, descriptions, and visibility can be edited, drag-and-drop is not supported.
+///
+class Q_SLICER_MODULE_SUBJECTHIERARCHY_WIDGETS_EXPORT qMRMLSubjectHierarchyVirtualModel : public QAbstractItemModel
+{
+  Q_OBJECT
+  QVTK_OBJECT
+
+  /// Column of the data node names (or item names), and the owner plugin icons.
+  /// A value of -1 hides it. First column (0) by default.
+  Q_PROPERTY (int nameColumn READ nameColumn WRITE setNameColumn)
+  /// Column of the data node visibility. A value of -1 hides it.
+  Q_PROPERTY (int visibilityColumn READ visibilityColumn WRITE setVisibilityColumn)
+  /// Column of the data node color. A value of -1 hides it.
+  Q_PROPERTY(int colorColumn READ colorColumn WRITE setColorColumn)
+  /// Column of the parent transforms. A value of -1 hides it.
+  Q_PROPERTY (int transformColumn READ transformColumn WRITE setTransformColumn)
+  /// Column of the data node descriptions. A value of -1 hides it.
+  Q_PROPERTY (int descriptionColumn READ descriptionColumn WRITE setDescriptionColumn)
+  /// Column of the data node IDs. A value of -1 hides it.
+  Q_PROPERTY (int idColumn READ idColumn WRITE setIDColumn)
+
+public:
+  typedef QAbstractItemModel Superclass;
+  qMRMLSubjectHierarchyVirtualModel(QObject *parent=nullptr);
+  ~qMRMLSubjectHierarchyVirtualModel() override;
+
+  int nameColumn()const;
+  void setNameColumn(int column);
+
+  int visibilityColumn()const;
+  void setVisibilityColumn(int column);
+
+  int colorColumn()const;
+  void setColorColumn(int column);
+
+  int transformColumn()const;
+  void setTransformColumn(int column);
+
+  int descriptionColumn()const;
+  void setDescriptionColumn(int column);
+
+  int idColumn()const;
+  void setIDColumn(int column);
+
+  QModelIndex index(int row, int column, const QModelIndex& parent=QModelIndex())const override;
+  QModelIndex parent(const QModelIndex& index)const override;
+  int rowCount(const QModelIndex& parent=QModelIndex())const override;
+  int columnCount(const QModelIndex& parent=QModelIndex())const override;
+  bool hasChildren(const QModelIndex& parent=QModelIndex())const override;
+  QVariant data(const QModelIndex& index, int role=Qt::DisplayRole)const override;
+  bool setData(const QModelIndex& index, const QVariant& value, int role=Qt::EditRole) override;
+  QVariant headerData(int section, Qt::Orientation orientation, int role=Qt::DisplayRole)const override;
+  Qt::ItemFlags flags(const QModelIndex& index)const override;
+
+  Q_INVOKABLE virtual void setMRMLScene(vtkMRMLScene* scene);
+  Q_INVOKABLE vtkMRMLScene* mrmlScene()const;
+
+  vtkMRMLSubjectHierarchyNode* subjectHierarchyNode()const;
+
+  /// Invalid until a valid scene is set
+  QModelIndex subjectHierarchySceneIndex()const;
+
+  vtkIdType subjectHierarchyItemFromIndex(const QModelIndex& index)const;
+  QModelIndex indexFromSubjectHierarchyItem(vtkIdType itemID, int column=0)const;
+
+signals:
+  /// This signal is sent when the whole subject hierarchy is about to be updated
+  void subjectHierarchyAboutToBeUpdated();
+  /// This signal is sent after the whole subject hierarchy is updated
+  void subjectHierarchyUpdated();
+
+protected slots:
+  virtual void onSubjectHierarchyItemAdded(vtkIdType itemID);
+  virtual void onSubjectHierarchyItemAboutToBeRemoved(vtkIdType itemID);
+  virtual void onSubjectHierarchyItemRemoved(vtkIdType itemID);
+  virtual void onSubjectHierarchyItemModified(vtkIdType itemID);
+
+  virtual void onMRMLSceneImported(vtkMRMLScene* scene);
+  virtual void onMRMLSceneClosed(vtkMRMLScene* scene);
+  virtual void onMRMLSceneStartBatchProcess(vtkMRMLScene* scene);
+  virtual void onMRMLSceneEndBatchProcess(vtkMRMLScene* scene);
+  virtual void onMRMLNodeRemoved(vtkMRMLNode* node);
+
+protected:
+  /// Set the subject hierarchy node found in the given scene. Called only internally.
+  virtual void setSubjectHierarchyNode(vtkMRMLSubjectHierarchyNode* shNode);
+
+  /// Reset the model and rebuild the tree structure from the subject hierarchy
+  virtual void rebuildFromSubjectHierarchy();
+
+  /// Data of an item in a column. Reimplement in subclasses to add roles or columns.
+  virtual QVariant subjectHierarchyItemData(vtkIdType itemID, int column, int role)const;
+
+  /// Must be reimplemented in subclasses that add new column types
+  virtual int maxColumnId()const;
+
+  static void onEvent(vtkObject* caller, unsigned long event, void* clientData, void* callData);
+
+protected:
+  QScopedPointer<qMRMLSubjectHierarchyVirtualModelPrivate> d_ptr;
+
+private:
+  Q_DECLARE_PRIVATE(qMRMLSubjectHierarchyVirtualModel);
+  Q_DISABLE_COPY(qMRMLSubjectHierarchyVirtualModel);
+};
+
+#endif
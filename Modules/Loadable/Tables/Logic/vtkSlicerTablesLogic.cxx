@@ -56,7 +56,8 @@ void vtkSlicerTablesLogic::PrintSelf(ostream& os, vtkIndent indent)
 
 //----------------------------------------------------------------------------
 vtkMRMLTableNode* vtkSlicerTablesLogic
-::AddTable(const char* fileName, const char* name /*=nullptr*/, bool findSchema /*=true*/, const char* password /*=0*/)
+::AddTable(const char* fileName, const char* name /*=nullptr*/, bool findSchema /*=true*/, const char* password /*=0*/,
+  vtkIdType maximumNumberOfRows /*=-1*/, bool autoDetectColumnTypes /*=false*/)
 {
   if (!this->GetMRMLScene())
     {
@@ -129,6 +130,8 @@ vtkMRMLTableNode* vtkSlicerTablesLogic
     vtkNew<vtkMRMLTableStorageNode> tableStorageNode;
     tableStorageNode->SetFileName(fileName);
     tableStorageNode->SetAutoFindSchema(findSchema);
+    tableStorageNode->SetMaximumNumberOfRows(maximumNumberOfRows);
+    tableStorageNode->SetAutoDetectColumnTypes(autoDetectColumnTypes);
     this->GetMRMLScene()->AddNode(tableStorageNode.GetPointer());
 
     vtkNew<vtkMRMLTableNode> tableNode1;
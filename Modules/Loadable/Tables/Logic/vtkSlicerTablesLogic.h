@@ -50,7 +50,11 @@ public:
   /// Loads a table from filename.
   /// If findSchema is true then the method looks for a schema file (for example, basefilename.schema.csv)
   /// and if a schema file is found then it is used.
-  vtkMRMLTableNode* AddTable(const char* fileName, const char* name = nullptr, bool findSchema = true, const char* password = nullptr);
+  /// If maximumNumberOfRows is not negative then only the first maximumNumberOfRows rows are read
+  /// (for previewing large tables). If autoDetectColumnTypes is true then the type of columns
+  /// that are not defined in the schema is detected from the values.
+  vtkMRMLTableNode* AddTable(const char* fileName, const char* name = nullptr, bool findSchema = true, const char* password = nullptr,
+    vtkIdType maximumNumberOfRows = -1, bool autoDetectColumnTypes = false);
 
   /// Returns ID of the layout that is similar to current layout but also contains a table view
   static int GetLayoutWithTable(int currentLayout);
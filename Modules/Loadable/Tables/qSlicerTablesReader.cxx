@@ -152,10 +152,23 @@ bool qSlicerTablesReader::load(const IOProperties& properties)
       }
     }
 
+  // Optionally only the first rows are read, for previewing large tables
+  vtkIdType maximumNumberOfRows = -1;
+  if (properties.contains("maximumNumberOfRows"))
+    {
+    maximumNumberOfRows = properties["maximumNumberOfRows"].toLongLong();
+    }
+  bool autoDetectColumnTypes = false;
+  if (properties.contains("autoDetectColumnTypes"))
+    {
+    autoDetectColumnTypes = properties["autoDetectColumnTypes"].toBool();
+    }
+
   vtkMRMLTableNode* node = nullptr;
   if (d->Logic!=nullptr)
     {
-    node = d->Logic->AddTable(fileName.toUtf8(),uname.c_str(), true, password.c_str());
+    node = d->Logic->AddTable(fileName.toUtf8(),uname.c_str(), true, password.c_str(),
+      maximumNumberOfRows, autoDetectColumnTypes);
     }
   if (node)
     {
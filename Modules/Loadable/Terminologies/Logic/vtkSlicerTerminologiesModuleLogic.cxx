@@ -28,6 +28,7 @@
 #include "vtkSlicerTerminologyType.h"
 
 // MRMLLogic includes
+#include <vtkMRMLApplicationLogic.h>
 #include <vtkMRMLScene.h>
 
 // Slicer includes
@@ -44,6 +45,8 @@
 
 // STD includes
 #include <algorithm>
+#include <future>
+#include <unordered_map>
 
 #include "rapidjson/document.h"     // rapidjson's DOM-style API
 #include "rapidjson/prettywriter.h" // for stringify JSON
@@ -66,13 +69,39 @@ public:
   // on Linux and Mac), therefore we store a simple pointer and create/delete
   // the document object manually
   typedef std::map<std::string, rapidjson::Document* > TerminologyMap;
-  vtkInternal();
+  vtkInternal(vtkSlicerTerminologiesModuleLogic* external);
   ~vtkInternal();
 
+  /// Parse Json file. Can be called from any thread.
+  /// \return New document object, nullptr if the file cannot be read or parsed
+  static rapidjson::Document* ReadJsonFile(const std::string& filePath);
+
+  /// Store terminology or anatomic context document based on its schema.
+  /// Takes ownership of the document. Logs errors if the document is invalid or null.
+  /// \return Success flag
+  bool AddContext(rapidjson::Document* jsonRoot, const std::string& filePath);
+  /// Store terminology document. Takes ownership of the document.
+  /// \return Context name of the terminology. Empty string on failure.
+  std::string AddTerminology(rapidjson::Document* terminologyRoot, const std::string& filePath);
+  /// Store anatomic context document. Takes ownership of the document.
+  /// \return Context name of the anatomic context. Empty string on failure.
+  std::string AddAnatomicContext(rapidjson::Document* anatomicContextRoot, const std::string& filePath);
+
   /// Utility function to get code in Json array
   /// \param foundIndex Output parameter for index of found object in input array. -1 if not found
   /// \return Json object if found, otherwise null Json object
   rapidjson::Value& GetCodeInArray(CodeIdentifier codeId, rapidjson::Value& jsonArray, int &foundIndex);
+  /// Get code in a Json array of a loaded context using a code index that is built
+  /// at the first lookup in the array. Lookups take constant time afterwards.
+  /// \return Json object if found, otherwise null Json object
+  rapidjson::Value& GetCodeInLoadedArray(CodeIdentifier codeId, rapidjson::Value& jsonArray);
+  /// Find codes in a Json array of a loaded context with code meaning containing the search
+  /// string (case-insensitive). Uses a trigram index of the code meanings that is built at the
+  /// first search in the array, so that only codes that contain the rarest trigram of the search
+  /// string are compared. Codes are returned in array order.
+  void FindCodesInLoadedArray(rapidjson::Value& jsonArray, std::string search, std::vector<CodeIdentifier>& codes);
+  /// Remove all code indices. Must be called when a loaded document is changed or deleted.
+  void ClearCodeIndices();
 
   /// Get root Json value for the terminology with given name
   rapidjson::Value& GetTerminologyRootByName(std::string terminologyName);
@@ -138,8 +167,10 @@ public:
   void GetJsonCodeFromIdentifier(rapidjson::Value& code, CodeIdentifier identifier, rapidjson::Document::AllocatorType& allocator);
 
   /// Utility function for safe (memory-leak-free) setting of a document pointer in map
-  static void SetDocumentInTerminologyMap(TerminologyMap& terminologyMap, const std::string& name, rapidjson::Document* doc)
+  void SetDocumentInTerminologyMap(TerminologyMap& terminologyMap, const std::string& name, rapidjson::Document* doc)
     {
+    // The document may have been changed in place, or the previous one is deleted
+    this->ClearCodeIndices();
     if (terminologyMap.find(name) != terminologyMap.end())
       {
       if (doc == terminologyMap[name])
@@ -155,22 +186,67 @@ public:
     }
 
 public:
+  vtkSlicerTerminologiesModuleLogic* External;
+
   /// Loaded terminologies. Key is the context name, value is the root item.
   TerminologyMap LoadedTerminologies;
 
   /// Loaded anatomical region contexts. Key is the context name, value is the root item.
   TerminologyMap LoadedAnatomicContexts;
+
+  /// Index of a code array in a loaded context.
+  /// Key is "CodingSchemeDesignator^CodeValue", value is the index of the first matching item.
+  typedef std::unordered_map<std::string, rapidjson::SizeType> CodeIndex;
+  /// Code indices of arrays of loaded contexts (categories, types, modifiers, regions),
+  /// with the size of the array when the index was built. Key is the address of the array.
+  std::map<const rapidjson::Value*, std::pair<rapidjson::SizeType, CodeIndex> > CodeArrayIndices;
+
+  /// Search index of a code array in a loaded context
+  struct CodeSearchIndex
+    {
+    /// Valid codes of the array, in array order
+    std::vector<CodeIdentifier> Codes;
+    /// Lowercase code meaning of each code
+    std::vector<std::string> LowerCaseCodeMeanings;
+    /// Indices of the codes (in increasing order) whose lowercase code meaning contains
+    /// the trigram. Key contains the three characters of the trigram.
+    std::unordered_map<unsigned int, std::vector<size_t> > TrigramCodes;
+    };
+  /// Search indices of arrays of loaded contexts. Key is the address of the array.
+  std::map<const rapidjson::Value*, CodeSearchIndex> CodeArraySearchIndices;
+
+  enum PendingContextType
+    {
+    PendingTerminology,
+    PendingAnatomicContext,
+    PendingUserContext
+    };
+  /// Files that are read in the background. \sa LoadDefaultContextsAsync
+  std::vector<std::pair<PendingContextType, std::string> > PendingContextFiles;
+  /// Documents parsed from \sa PendingContextFiles (in the same order)
+  std::future<std::vector<rapidjson::Document*> > PendingContextDocuments;
 };
 
 //---------------------------------------------------------------------------
 // vtkInternal methods
 
 //---------------------------------------------------------------------------
-vtkSlicerTerminologiesModuleLogic::vtkInternal::vtkInternal() = default;
+vtkSlicerTerminologiesModuleLogic::vtkInternal::vtkInternal(vtkSlicerTerminologiesModuleLogic* external)
+  : External(external)
+{
+}
 
 //---------------------------------------------------------------------------
 vtkSlicerTerminologiesModuleLogic::vtkInternal::~vtkInternal()
 {
+  if (this->PendingContextDocuments.valid())
+    {
+    std::vector<rapidjson::Document*> documents = this->PendingContextDocuments.get();
+    for (rapidjson::Document* document : documents)
+      {
+      delete document;
+      }
+    }
   for (TerminologyMap::iterator termIt = this->LoadedTerminologies.begin();
     termIt != this->LoadedTerminologies.end(); ++termIt)
     {
@@ -215,9 +291,296 @@ rapidjson::Value& vtkSlicerTerminologiesModuleLogic::vtkInternal::GetCodeInArray
   return JSON_EMPTY_VALUE;
 }
 
+//---------------------------------------------------------------------------
+rapidjson::Value& vtkSlicerTerminologiesModuleLogic::vtkInternal::GetCodeInLoadedArray(CodeIdentifier codeId, rapidjson::Value &jsonArray)
+{
+  if (!jsonArray.IsArray())
+    {
+    return JSON_EMPTY_VALUE;
+    }
+
+  std::pair<rapidjson::SizeType, CodeIndex>& arrayIndex = this->CodeArrayIndices[&jsonArray];
+  if (arrayIndex.first != jsonArray.Size() || (arrayIndex.second.empty() && jsonArray.Size() > 0))
+    {
+    // Build index
+    arrayIndex.first = jsonArray.Size();
+    arrayIndex.second.clear();
+    arrayIndex.second.reserve(jsonArray.Size());
+    for (rapidjson::SizeType index = 0; index < jsonArray.Size(); ++index)
+      {
+      rapidjson::Value& currentObject = jsonArray[index];
+      if (!currentObject.IsObject())
+        {
+        continue;
+        }
+      rapidjson::Value::MemberIterator codingSchemeDesignatorIt = currentObject.FindMember("CodingSchemeDesignator");
+      rapidjson::Value::MemberIterator codeValueIt = currentObject.FindMember("CodeValue");
+      if (codingSchemeDesignatorIt == currentObject.MemberEnd() || !codingSchemeDesignatorIt->value.IsString()
+        || codeValueIt == currentObject.MemberEnd() || !codeValueIt->value.IsString())
+        {
+        continue;
+        }
+      std::string key = std::string(codingSchemeDesignatorIt->value.GetString()) + "^" + codeValueIt->value.GetString();
+      // Keep the first matching item, as the linear search does
+      arrayIndex.second.insert(std::make_pair(key, index));
+      }
+    }
+
+  CodeIndex::iterator codeIt = arrayIndex.second.find(codeId.CodingSchemeDesignator + "^" + codeId.CodeValue);
+  if (codeIt == arrayIndex.second.end())
+    {
+    return JSON_EMPTY_VALUE;
+    }
+  return jsonArray[codeIt->second];
+}
+
+//---------------------------------------------------------------------------
+void vtkSlicerTerminologiesModuleLogic::vtkInternal::FindCodesInLoadedArray(
+  rapidjson::Value &jsonArray, std::string search, std::vector<CodeIdentifier>& codes)
+{
+  codes.clear();
+  if (!jsonArray.IsArray())
+    {
+    return;
+    }
+
+  auto trigramKey = [](const std::string& text, size_t position)
+    {
+    return (static_cast<unsigned int>(static_cast<unsigned char>(text[position])) << 16)
+      | (static_cast<unsigned int>(static_cast<unsigned char>(text[position + 1])) << 8)
+      | static_cast<unsigned int>(static_cast<unsigned char>(text[position + 2]));
+    };
+
+  std::map<const rapidjson::Value*, CodeSearchIndex>::iterator indexIt = this->CodeArraySearchIndices.find(&jsonArray);
+  if (indexIt == this->CodeArraySearchIndices.end())
+    {
+    // Build index
+    CodeSearchIndex& searchIndex = this->CodeArraySearchIndices[&jsonArray];
+    for (rapidjson::SizeType index = 0; index < jsonArray.Size(); ++index)
+      {
+      rapidjson::Value& currentObject = jsonArray[index];
+      if (!currentObject.IsObject())
+        {
+        continue;
+        }
+      rapidjson::Value& codeMeaning = currentObject["CodeMeaning"];
+      rapidjson::Value& codingSchemeDesignator = currentObject["CodingSchemeDesignator"];
+      rapidjson::Value& codeValue = currentObject["CodeValue"];
+      if (!codeMeaning.IsString() || !codingSchemeDesignator.IsString() || !codeValue.IsString())
+        {
+        vtkErrorWithObjectMacro(this->External, "FindCodesInLoadedArray: Invalid code at index " << index
+          << (codeMeaning.IsString() ? std::string(" (") + codeMeaning.GetString() + ")" : std::string()));
+        continue;
+        }
+      std::string lowerCaseCodeMeaning = codeMeaning.GetString();
+      std::transform(lowerCaseCodeMeaning.begin(), lowerCaseCodeMeaning.end(), lowerCaseCodeMeaning.begin(), ::tolower);
+      size_t codeIndex = searchIndex.Codes.size();
+      for (size_t position = 0; position + 3 <= lowerCaseCodeMeaning.size(); ++position)
+        {
+        std::vector<size_t>& trigramCodes = searchIndex.TrigramCodes[trigramKey(lowerCaseCodeMeaning, position)];
+        if (trigramCodes.empty() || trigramCodes.back() != codeIndex)
+          {
+          trigramCodes.push_back(codeIndex);
+          }
+        }
+      searchIndex.Codes.push_back(CodeIdentifier(codingSchemeDesignator.GetString(), codeValue.GetString(), codeMeaning.GetString()));
+      searchIndex.LowerCaseCodeMeanings.push_back(lowerCaseCodeMeaning);
+      }
+    indexIt = this->CodeArraySearchIndices.find(&jsonArray);
+    }
+  const CodeSearchIndex& searchIndex = indexIt->second;
+
+  if (search.empty())
+    {
+    codes = searchIndex.Codes;
+    return;
+    }
+
+  // Make lowercase for case-insensitive comparison
+  std::transform(search.begin(), search.end(), search.begin(), ::tolower);
+
+  if (search.size() < 3)
+    {
+    // Too short for using the trigram index
+    for (size_t codeIndex = 0; codeIndex < searchIndex.Codes.size(); ++codeIndex)
+      {
+      if (searchIndex.LowerCaseCodeMeanings[codeIndex].find(search) != std::string::npos)
+        {
+        codes.push_back(searchIndex.Codes[codeIndex]);
+        }
+      }
+    return;
+    }
+
+  // Only codes that contain all trigrams of the search string can match, so it is
+  // enough to check the codes containing the least frequent one
+  const std::vector<size_t>* candidateCodes = nullptr;
+  for (size_t position = 0; position + 3 <= search.size(); ++position)
+    {
+    std::unordered_map<unsigned int, std::vector<size_t> >::const_iterator trigramIt =
+      searchIndex.TrigramCodes.find(trigramKey(search, position));
+    if (trigramIt == searchIndex.TrigramCodes.end())
+      {
+      // No code contains this trigram
+      return;
+      }
+    if (!candidateCodes || trigramIt->second.size() < candidateCodes->size())
+      {
+      candidateCodes = &(trigramIt->second);
+      }
+    }
+  for (size_t codeIndex : *candidateCodes)
+    {
+    if (searchIndex.LowerCaseCodeMeanings[codeIndex].find(search) != std::string::npos)
+      {
+      codes.push_back(searchIndex.Codes[codeIndex]);
+      }
+    }
+}
+
+//---------------------------------------------------------------------------
+void vtkSlicerTerminologiesModuleLogic::vtkInternal::ClearCodeIndices()
+{
+  this->CodeArrayIndices.clear();
+  this->CodeArraySearchIndices.clear();
+}
+
+//---------------------------------------------------------------------------
+rapidjson::Document* vtkSlicerTerminologiesModuleLogic::vtkInternal::ReadJsonFile(const std::string& filePath)
+{
+  FILE *fp = fopen(filePath.c_str(), "r");
+  if (!fp)
+    {
+    return nullptr;
+    }
+  rapidjson::Document* document = new rapidjson::Document;
+  char buffer[4096];
+  rapidjson::FileReadStream fs(fp, buffer, sizeof(buffer));
+  bool parseError = document->ParseStream(fs).HasParseError();
+  fclose(fp);
+  if (parseError)
+    {
+    delete document;
+    return nullptr;
+    }
+  return document;
+}
+
+//---------------------------------------------------------------------------
+bool vtkSlicerTerminologiesModuleLogic::vtkInternal::AddContext(rapidjson::Document* jsonRoot, const std::string& filePath)
+{
+  if (!jsonRoot)
+    {
+    vtkErrorWithObjectMacro(this->External, "LoadContextFromFile: Failed to load context from file '" << filePath);
+    return false;
+    }
+
+  // Load document based on schema
+  rapidjson::Value::MemberIterator schemaIt = jsonRoot->FindMember("@schema");
+  if (schemaIt == jsonRoot->MemberEnd())
+    {
+    vtkErrorWithObjectMacro(this->External, "LoadContextFromFile: File " << filePath << " does not contain schema information");
+    delete jsonRoot;
+    return false;
+    }
+  std::string schema = (*jsonRoot)["@schema"].GetString();
+  if (!schema.compare(TERMINOLOGY_CONTEXT_SCHEMA) || !schema.compare(TERMINOLOGY_CONTEXT_SCHEMA_1))
+    {
+    // Store terminology
+    std::string contextName = (*jsonRoot)["SegmentationCategoryTypeContextName"].GetString();
+    this->SetDocumentInTerminologyMap(this->LoadedTerminologies, contextName, jsonRoot);
+    vtkDebugWithObjectMacro(this->External, "Terminology named '" << contextName << "' successfully loaded from file " << filePath);
+    }
+  else if (!schema.compare(ANATOMIC_CONTEXT_SCHEMA) || !schema.compare(ANATOMIC_CONTEXT_SCHEMA_1))
+    {
+    // Store anatomic context
+    std::string contextName = (*jsonRoot)["AnatomicContextName"].GetString();
+    this->SetDocumentInTerminologyMap(this->LoadedAnatomicContexts, contextName, jsonRoot);
+    vtkDebugWithObjectMacro(this->External, "Anatomic context named '" << contextName << "' successfully loaded from file " << filePath);
+    }
+  else
+    {
+    vtkErrorWithObjectMacro(this->External, "LoadContextFromFile: File " << filePath << " is neither a terminology nor anatomic context file according to its schema");
+    delete jsonRoot;
+    return false;
+    }
+
+  this->External->Modified();
+  return true;
+}
+
+//---------------------------------------------------------------------------
+std::string vtkSlicerTerminologiesModuleLogic::vtkInternal::AddTerminology(rapidjson::Document* terminologyRoot, const std::string& filePath)
+{
+  if (!terminologyRoot)
+    {
+    vtkErrorWithObjectMacro(this->External, "LoadTerminologyFromFile: Failed to load terminology from file '" << filePath << "'");
+    return "";
+    }
+
+  // Check schema
+  rapidjson::Value::MemberIterator schemaIt = terminologyRoot->FindMember("@schema");
+  if (schemaIt == terminologyRoot->MemberEnd())
+    {
+    vtkErrorWithObjectMacro(this->External, "LoadTerminologyFromFile: File " << filePath << " does not contain schema information");
+    delete terminologyRoot;
+    return "";
+    }
+  std::string schema = (*terminologyRoot)["@schema"].GetString();
+  if (schema.compare(TERMINOLOGY_CONTEXT_SCHEMA) && schema.compare(TERMINOLOGY_CONTEXT_SCHEMA_1))
+    {
+    vtkErrorWithObjectMacro(this->External, "LoadTerminologyFromFile: File " << filePath << " is not a terminology context file according to its schema");
+    delete terminologyRoot;
+    return "";
+    }
+
+  // Store terminology
+  std::string contextName = (*terminologyRoot)["SegmentationCategoryTypeContextName"].GetString();
+  this->SetDocumentInTerminologyMap(this->LoadedTerminologies, contextName, terminologyRoot);
+
+  vtkDebugWithObjectMacro(this->External, "Terminology named '" << contextName << "' successfully loaded from file " << filePath);
+  this->External->Modified();
+  return contextName;
+}
+
+//---------------------------------------------------------------------------
+std::string vtkSlicerTerminologiesModuleLogic::vtkInternal::AddAnatomicContext(rapidjson::Document* anatomicContextRoot, const std::string& filePath)
+{
+  if (!anatomicContextRoot)
+    {
+    vtkErrorWithObjectMacro(this->External, "LoadAnatomicContextFromFile: Failed to load anatomic context from file " << filePath);
+    return "";
+    }
+
+  // Check schema
+  rapidjson::Value::MemberIterator schemaIt = anatomicContextRoot->FindMember("@schema");
+  if (schemaIt == anatomicContextRoot->MemberEnd())
+    {
+    vtkErrorWithObjectMacro(this->External, "LoadAnatomicContextFromFile: File " << filePath << " does not contain schema information");
+    delete anatomicContextRoot;
+    return "";
+    }
+  std::string schema = (*anatomicContextRoot)["@schema"].GetString();
+  if (schema.compare(ANATOMIC_CONTEXT_SCHEMA) && schema.compare(ANATOMIC_CONTEXT_SCHEMA_1))
+    {
+    vtkErrorWithObjectMacro(this->External, "LoadAnatomicContextFromFile: File " << filePath << " is not an anatomic context file according to its schema");
+    delete anatomicContextRoot;
+    return "";
+    }
+
+  // Store anatomic context
+  std::string contextName = (*anatomicContextRoot)["AnatomicContextName"].GetString();
+  this->SetDocumentInTerminologyMap(this->LoadedAnatomicContexts, contextName, anatomicContextRoot);
+
+  vtkDebugWithObjectMacro(this->External, "Anatomic context named '" << contextName << "' successfully loaded from file " << filePath);
+  this->External->Modified();
+  return contextName;
+}
+
 //---------------------------------------------------------------------------
 rapidjson::Value& vtkSlicerTerminologiesModuleLogic::vtkInternal::GetTerminologyRootByName(std::string terminologyName)
 {
+  this->External->WaitForDefaultContexts();
   TerminologyMap::iterator termIt = this->LoadedTerminologies.find(terminologyName);
   if (termIt != this->LoadedTerminologies.end() && termIt->second != nullptr)
     {
@@ -271,8 +634,7 @@ rapidjson::Value& vtkSlicerTerminologiesModuleLogic::vtkInternal::GetCategoryInT
     return JSON_EMPTY_VALUE;
     }
 
-  int index = -1;
-  return this->GetCodeInArray(categoryId, categoryArray, index);
+  return this->GetCodeInLoadedArray(categoryId, categoryArray);
 }
 
 //---------------------------------------------------------------------------
@@ -370,8 +732,7 @@ rapidjson::Value& vtkSlicerTerminologiesModuleLogic::vtkInternal::GetTypeInTermi
     return JSON_EMPTY_VALUE;
     }
 
-  int index = -1;
-  return this->GetCodeInArray(typeId, typeArray, index);
+  return this->GetCodeInLoadedArray(typeId, typeArray);
 }
 
 //---------------------------------------------------------------------------
@@ -498,13 +859,13 @@ rapidjson::Value& vtkSlicerTerminologiesModuleLogic::vtkInternal::GetTypeModifie
     return JSON_EMPTY_VALUE;
     }
 
-  int index = -1;
-  return this->GetCodeInArray(modifierId, typeModifierArray, index);
+  return this->GetCodeInLoadedArray(modifierId, typeModifierArray);
 }
 
 //---------------------------------------------------------------------------
 rapidjson::Value& vtkSlicerTerminologiesModuleLogic::vtkInternal::GetAnatomicContextRootByName(std::string anatomicContextName)
 {
+  this->External->WaitForDefaultContexts();
   TerminologyMap::iterator anIt = this->LoadedAnatomicContexts.find(anatomicContextName);
   if (anIt != this->LoadedAnatomicContexts.end() && anIt->second != nullptr)
     {
@@ -558,8 +919,7 @@ rapidjson::Value& vtkSlicerTerminologiesModuleLogic::vtkInternal::GetRegionInAna
     return JSON_EMPTY_VALUE;
     }
 
-  int index = -1;
-  return this->GetCodeInArray(regionId, regionArray, index);
+  return this->GetCodeInLoadedArray(regionId, regionArray);
 }
 
 //---------------------------------------------------------------------------
@@ -610,8 +970,7 @@ rapidjson::Value& vtkSlicerTerminologiesModuleLogic::vtkInternal::GetRegionModif
     return JSON_EMPTY_VALUE;
     }
 
-  int index = -1;
-  return this->GetCodeInArray(modifierId, regionModifierArray, index);
+  return this->GetCodeInLoadedArray(modifierId, regionModifierArray);
 }
 
 //---------------------------------------------------------------------------
@@ -623,6 +982,9 @@ bool vtkSlicerTerminologiesModuleLogic::vtkInternal::ConvertSegmentationDescript
     return false;
     }
 
+  // The converted document may be a loaded context that is changed in place
+  this->ClearCodeIndices();
+
   // Get segment attributes
   rapidjson::Value& segmentAttributesArray = descriptorDoc["segmentAttributes"];
   if (!segmentAttributesArray.IsArray())
@@ -843,6 +1205,9 @@ bool vtkSlicerTerminologiesModuleLogic::vtkInternal::ConvertSegmentationDescript
     return false;
     }
 
+  // The converted document may be a loaded context that is changed in place
+  this->ClearCodeIndices();
+
   // Get segment attributes
   rapidjson::Value& segmentAttributesArray = descriptorDoc["segmentAttributes"];
   if (!segmentAttributesArray.IsArray())
@@ -994,7 +1359,7 @@ void vtkSlicerTerminologiesModuleLogic::vtkInternal::GetJsonCodeFromIdentifier(
 //----------------------------------------------------------------------------
 vtkSlicerTerminologiesModuleLogic::vtkSlicerTerminologiesModuleLogic()
 {
-  this->Internal = new vtkInternal();
+  this->Internal = new vtkInternal(this);
 }
 
 //----------------------------------------------------------------------------
@@ -1019,6 +1384,11 @@ void vtkSlicerTerminologiesModuleLogic::SetMRMLSceneInternal(vtkMRMLScene* newSc
 
   // Load default terminologies and anatomical contexts
   // Note: Do it here not in the constructor so that the module shared directory is properly initialized
+  if (this->LoadDefaultContextsInBackground)
+    {
+    this->LoadDefaultContextsAsync();
+    return;
+    }
   bool wasModifying = this->GetDisableModifiedEvent();
   this->SetDisableModifiedEvent(true);
   this->LoadDefaultTerminologies();
@@ -1028,120 +1398,157 @@ void vtkSlicerTerminologiesModuleLogic::SetMRMLSceneInternal(vtkMRMLScene* newSc
 }
 
 //---------------------------------------------------------------------------
-bool vtkSlicerTerminologiesModuleLogic::LoadContextFromFile(std::string filePath)
+void vtkSlicerTerminologiesModuleLogic::GetDefaultContextFilePaths(std::vector<std::string>& terminologyFilePaths,
+  std::vector<std::string>& anatomicContextFilePaths, std::vector<std::string>& userContextFilePaths)
 {
-  rapidjson::Document* jsonRoot = new rapidjson::Document;
+  terminologyFilePaths.clear();
+  terminologyFilePaths.push_back(this->GetModuleShareDirectory() + "/SegmentationCategoryTypeModifier-SlicerGeneralAnatomy.term.json");
+  terminologyFilePaths.push_back(this->GetModuleShareDirectory() + "/SegmentationCategoryTypeModifier-DICOM-Master.term.json");
 
-  FILE *fp = fopen(filePath.c_str(), "r");
-  if (!fp)
+  anatomicContextFilePaths.clear();
+  anatomicContextFilePaths.push_back(this->GetModuleShareDirectory() + "/AnatomicRegionAndModifier-DICOM-Master.term.json");
+
+  userContextFilePaths.clear();
+  if (!this->UserContextsPath || !vtksys::SystemTools::FileExists(this->UserContextsPath, false))
     {
-    vtkErrorMacro("LoadContextFromFile: Failed to load context from file '" << filePath);
-    delete jsonRoot;
-    return false;
+    return;
     }
-  char buffer[4096];
-  rapidjson::FileReadStream fs(fp, buffer, sizeof(buffer));
-  if (jsonRoot->ParseStream(fs).HasParseError())
+
+  // Try to load all json files in the user settings directory
+  vtkSmartPointer<vtkDirectory> userSettingsDir = vtkSmartPointer<vtkDirectory>::New();
+  userSettingsDir->Open(this->UserContextsPath);
+  vtkStringArray* files = userSettingsDir->GetFiles();
+  for (int index=0; index<files->GetNumberOfValues(); ++index)
     {
-    vtkErrorMacro("LoadContextFromFile: Failed to load context from file '" << filePath);
-    fclose(fp);
-    delete jsonRoot;
-    return false;
+    std::string fileName = files->GetValue(index);
+
+    // Only load json files
+    if ( userSettingsDir->FileIsDirectory(fileName.c_str())
+      || fileName.size() < 5 || fileName.substr(fileName.size()-5).compare(".json") )
+      {
+      continue;
+      }
+
+    userContextFilePaths.push_back(std::string(this->UserContextsPath) + "/" + fileName);
     }
+}
 
-  // Load document based on schema
-  rapidjson::Value::MemberIterator schemaIt = jsonRoot->FindMember("@schema");
-  if (schemaIt == jsonRoot->MemberEnd())
+//---------------------------------------------------------------------------
+void vtkSlicerTerminologiesModuleLogic::LoadDefaultContextsAsync()
+{
+  // Make sure the previous loading is finished
+  this->WaitForDefaultContexts();
+
+  if (!this->UserContextsPath)
     {
-    vtkErrorMacro("LoadContextFromFile: File " << filePath << " does not contain schema information");
-    fclose(fp);
-    delete jsonRoot;
-    return false;
+    vtkErrorMacro("LoadUserContexts: User settings directory 'None' does not exist");
     }
-  std::string schema = (*jsonRoot)["@schema"].GetString();
-  if (!schema.compare(TERMINOLOGY_CONTEXT_SCHEMA) || !schema.compare(TERMINOLOGY_CONTEXT_SCHEMA_1))
+  std::vector<std::string> terminologyFilePaths;
+  std::vector<std::string> anatomicContextFilePaths;
+  std::vector<std::string> userContextFilePaths;
+  this->GetDefaultContextFilePaths(terminologyFilePaths, anatomicContextFilePaths, userContextFilePaths);
+
+  // Contexts are added in the same order as in the synchronous loading
+  std::vector<std::pair<vtkInternal::PendingContextType, std::string> >& pendingFiles = this->Internal->PendingContextFiles;
+  pendingFiles.clear();
+  for (const std::string& filePath : terminologyFilePaths)
     {
-    // Store terminology
-    std::string contextName = (*jsonRoot)["SegmentationCategoryTypeContextName"].GetString();
-    vtkSlicerTerminologiesModuleLogic::vtkInternal::SetDocumentInTerminologyMap(
-      this->Internal->LoadedTerminologies, contextName, jsonRoot);
-    vtkDebugMacro("Terminology named '" << contextName << "' successfully loaded from file " << filePath);
+    pendingFiles.push_back(std::make_pair(vtkInternal::PendingTerminology, filePath));
     }
-  else if (!schema.compare(ANATOMIC_CONTEXT_SCHEMA) || !schema.compare(ANATOMIC_CONTEXT_SCHEMA_1))
+  for (const std::string& filePath : anatomicContextFilePaths)
     {
-    // Store anatomic context
-    std::string contextName = (*jsonRoot)["AnatomicContextName"].GetString();
-    vtkSlicerTerminologiesModuleLogic::vtkInternal::SetDocumentInTerminologyMap(
-      this->Internal->LoadedAnatomicContexts, contextName, jsonRoot);
-    vtkDebugMacro("Anatomic context named '" << contextName << "' successfully loaded from file " << filePath);
+    pendingFiles.push_back(std::make_pair(vtkInternal::PendingAnatomicContext, filePath));
     }
-  else
+  for (const std::string& filePath : userContextFilePaths)
     {
-    vtkErrorMacro("LoadContextFromFile: File " << filePath << " is neither a terminology nor anatomic context file according to its schema");
-    fclose(fp);
-    delete jsonRoot;
-    return false;
+    pendingFiles.push_back(std::make_pair(vtkInternal::PendingUserContext, filePath));
     }
 
-  fclose(fp);
-  this->Modified();
-  return true;
+  std::vector<std::string> filePaths;
+  for (const std::pair<vtkInternal::PendingContextType, std::string>& pendingFile : pendingFiles)
+    {
+    filePaths.push_back(pendingFile.second);
+    }
+  // The application logic forwards the event to the main thread
+  vtkMRMLApplicationLogic* appLogic = this->GetMRMLApplicationLogic();
+  vtkObject* caller = this;
+  this->Internal->PendingContextDocuments = std::async(std::launch::async, [filePaths, appLogic, caller]()
+    {
+    std::vector<rapidjson::Document*> documents;
+    for (const std::string& filePath : filePaths)
+      {
+      documents.push_back(vtkInternal::ReadJsonFile(filePath));
+      }
+    if (appLogic)
+      {
+      appLogic->InvokeEventWithDelay(0, caller, vtkSlicerTerminologiesModuleLogic::DefaultContextsLoadedEvent);
+      }
+    return documents;
+    });
 }
 
 //---------------------------------------------------------------------------
-std::string vtkSlicerTerminologiesModuleLogic::LoadTerminologyFromFile(std::string filePath)
+void vtkSlicerTerminologiesModuleLogic::WaitForDefaultContexts()
 {
-  rapidjson::Document* terminologyRoot = new rapidjson::Document;
-
-  FILE *fp = fopen(filePath.c_str(), "r");
-  if (!fp)
+  if (!this->Internal->PendingContextDocuments.valid())
     {
-    vtkErrorMacro("LoadTerminologyFromFile: Failed to load terminology from file '" << filePath << "'");
-    delete terminologyRoot;
-    return "";
-    }
-  char buffer[4096];
-  rapidjson::FileReadStream fs(fp, buffer, sizeof(buffer));
-  if (terminologyRoot->ParseStream(fs).HasParseError())
-    {
-    vtkErrorMacro("LoadTerminologyFromFile: Failed to load terminology from file '" << filePath << "'");
-    fclose(fp);
-    delete terminologyRoot;
-    return "";
+    return;
     }
+  // The future becomes invalid, so the load functions called below do not wait again
+  std::vector<rapidjson::Document*> documents = this->Internal->PendingContextDocuments.get();
+  std::vector<std::pair<vtkInternal::PendingContextType, std::string> > pendingFiles;
+  std::swap(pendingFiles, this->Internal->PendingContextFiles);
 
-  // Check schema
-  rapidjson::Value::MemberIterator schemaIt = terminologyRoot->FindMember("@schema");
-  if (schemaIt == terminologyRoot->MemberEnd())
-    {
-    vtkErrorMacro("LoadTerminologyFromFile: File " << filePath << " does not contain schema information");
-    fclose(fp);
-    delete terminologyRoot;
-    return "";
-    }
-  std::string schema = (*terminologyRoot)["@schema"].GetString();
-  if (schema.compare(TERMINOLOGY_CONTEXT_SCHEMA) && schema.compare(TERMINOLOGY_CONTEXT_SCHEMA_1))
+  bool wasModifying = this->GetDisableModifiedEvent();
+  this->SetDisableModifiedEvent(true);
+  for (size_t index = 0; index < pendingFiles.size() && index < documents.size(); ++index)
     {
-    vtkErrorMacro("LoadTerminologyFromFile: File " << filePath << " is not a terminology context file according to its schema");
-    fclose(fp);
-    delete terminologyRoot;
-    return "";
+    const std::string& filePath = pendingFiles[index].second;
+    const std::string fileName = vtksys::SystemTools::GetFilenameWithoutExtension(filePath);
+    switch (pendingFiles[index].first)
+      {
+      case vtkInternal::PendingTerminology:
+        if (this->Internal->AddTerminology(documents[index], filePath).empty())
+          {
+          vtkErrorMacro("LoadDefaultTerminologies: Failed to load terminology '" << fileName << "'");
+          }
+        break;
+      case vtkInternal::PendingAnatomicContext:
+        if (this->Internal->AddAnatomicContext(documents[index], filePath).empty())
+          {
+          vtkErrorMacro("LoadDefaultAnatomicContexts: Failed to load anatomical region context '" << fileName << "'");
+          }
+        break;
+      case vtkInternal::PendingUserContext:
+        if (!this->Internal->AddContext(documents[index], filePath))
+          {
+          vtkErrorMacro("LoadUserContexts: Failed to load terminology from file "
+            << vtksys::SystemTools::GetFilenameName(filePath));
+          }
+        break;
+      }
     }
+  this->SetDisableModifiedEvent(wasModifying);
+}
 
-  // Store terminology
-  std::string contextName = (*terminologyRoot)["SegmentationCategoryTypeContextName"].GetString();
-  vtkSlicerTerminologiesModuleLogic::vtkInternal::SetDocumentInTerminologyMap(
-    this->Internal->LoadedTerminologies, contextName, terminologyRoot);
+//---------------------------------------------------------------------------
+bool vtkSlicerTerminologiesModuleLogic::LoadContextFromFile(std::string filePath)
+{
+  this->WaitForDefaultContexts();
+  return this->Internal->AddContext(vtkInternal::ReadJsonFile(filePath), filePath);
+}
 
-  vtkDebugMacro("Terminology named '" << contextName << "' successfully loaded from file " << filePath);
-  fclose(fp);
-  this->Modified();
-  return contextName;
+//---------------------------------------------------------------------------
+std::string vtkSlicerTerminologiesModuleLogic::LoadTerminologyFromFile(std::string filePath)
+{
+  this->WaitForDefaultContexts();
+  return this->Internal->AddTerminology(vtkInternal::ReadJsonFile(filePath), filePath);
 }
 
 //---------------------------------------------------------------------------
 bool vtkSlicerTerminologiesModuleLogic::LoadTerminologyFromSegmentDescriptorFile(std::string contextName, std::string filePath)
 {
+  this->WaitForDefaultContexts();
   FILE *fp = fopen(filePath.c_str(), "r");
   if (!fp)
     {
@@ -1180,7 +1587,7 @@ bool vtkSlicerTerminologiesModuleLogic::LoadTerminologyFromSegmentDescriptorFile
     }
 
   // Store terminology
-  vtkSlicerTerminologiesModuleLogic::vtkInternal::SetDocumentInTerminologyMap(
+  this->Internal->SetDocumentInTerminologyMap(
     this->Internal->LoadedTerminologies, contextName, convertedDoc );
 
   vtkDebugMacro("Terminology named '" << contextName << "' successfully loaded from file " << filePath);
@@ -1192,74 +1599,31 @@ bool vtkSlicerTerminologiesModuleLogic::LoadTerminologyFromSegmentDescriptorFile
 //---------------------------------------------------------------------------
 void vtkSlicerTerminologiesModuleLogic::LoadDefaultTerminologies()
 {
-  std::string success("");
-  success = this->LoadTerminologyFromFile(this->GetModuleShareDirectory() + "/SegmentationCategoryTypeModifier-SlicerGeneralAnatomy.term.json");
-  if (success.empty())
+  std::vector<std::string> terminologyFilePaths;
+  std::vector<std::string> anatomicContextFilePaths;
+  std::vector<std::string> userContextFilePaths;
+  this->GetDefaultContextFilePaths(terminologyFilePaths, anatomicContextFilePaths, userContextFilePaths);
+  for (const std::string& filePath : terminologyFilePaths)
     {
-    vtkErrorMacro("LoadDefaultTerminologies: Failed to load terminology 'SegmentationCategoryTypeModifier-SlicerGeneralAnatomy'");
-    }
-  success = this->LoadTerminologyFromFile(this->GetModuleShareDirectory() + "/SegmentationCategoryTypeModifier-DICOM-Master.term.json");
-  if (success.empty())
-    {
-    vtkErrorMacro("LoadDefaultTerminologies: Failed to load terminology 'SegmentationCategoryTypeModifier-DICOM-Master'");
+    if (this->LoadTerminologyFromFile(filePath).empty())
+      {
+      vtkErrorMacro("LoadDefaultTerminologies: Failed to load terminology '"
+        << vtksys::SystemTools::GetFilenameWithoutExtension(filePath) << "'");
+      }
     }
 }
 
 //---------------------------------------------------------------------------
 std::string vtkSlicerTerminologiesModuleLogic::LoadAnatomicContextFromFile(std::string filePath)
 {
-  rapidjson::Document* anatomicContextRoot = new rapidjson::Document;
-
-  FILE *fp = fopen(filePath.c_str(), "r");
-  if (!fp)
-    {
-    vtkErrorMacro("LoadAnatomicContextFromFile: Failed to load anatomic context from file " << filePath);
-    delete anatomicContextRoot;
-    return "";
-    }
-
-  char buffer[4096];
-  rapidjson::FileReadStream fs(fp, buffer, sizeof(buffer));
-  if (anatomicContextRoot->ParseStream(fs).HasParseError())
-    {
-    vtkErrorMacro("LoadAnatomicContextFromFile: Failed to load anatomic context from file " << filePath);
-    fclose(fp);
-    delete anatomicContextRoot;
-    return "";
-    }
-
-  // Check schema
-  rapidjson::Value::MemberIterator schemaIt = anatomicContextRoot->FindMember("@schema");
-  if (schemaIt == anatomicContextRoot->MemberEnd())
-    {
-    vtkErrorMacro("LoadAnatomicContextFromFile: File " << filePath << " does not contain schema information");
-    fclose(fp);
-    delete anatomicContextRoot;
-    return "";
-    }
-  std::string schema = (*anatomicContextRoot)["@schema"].GetString();
-  if (schema.compare(ANATOMIC_CONTEXT_SCHEMA) && schema.compare(ANATOMIC_CONTEXT_SCHEMA_1))
-    {
-    vtkErrorMacro("LoadAnatomicContextFromFile: File " << filePath << " is not an anatomic context file according to its schema");
-    fclose(fp);
-    delete anatomicContextRoot;
-    return "";
-    }
-
-  // Store anatomic context
-  std::string contextName = (*anatomicContextRoot)["AnatomicContextName"].GetString();
-  vtkSlicerTerminologiesModuleLogic::vtkInternal::SetDocumentInTerminologyMap(
-    this->Internal->LoadedAnatomicContexts, contextName, anatomicContextRoot);
-
-  vtkDebugMacro("Anatomic context named '" << contextName << "' successfully loaded from file " << filePath);
-  fclose(fp);
-  this->Modified();
-  return contextName;
+  this->WaitForDefaultContexts();
+  return this->Internal->AddAnatomicContext(vtkInternal::ReadJsonFile(filePath), filePath);
 }
 
 //---------------------------------------------------------------------------
 bool vtkSlicerTerminologiesModuleLogic::LoadAnatomicContextFromSegmentDescriptorFile(std::string contextName, std::string filePath)
 {
+  this->WaitForDefaultContexts();
   FILE *fp = fopen(filePath.c_str(), "r");
   if (!fp)
     {
@@ -1298,7 +1662,7 @@ bool vtkSlicerTerminologiesModuleLogic::LoadAnatomicContextFromSegmentDescriptor
     }
 
   // Store anatomic context
-  vtkSlicerTerminologiesModuleLogic::vtkInternal::SetDocumentInTerminologyMap(
+  this->Internal->SetDocumentInTerminologyMap(
     this->Internal->LoadedAnatomicContexts, contextName, convertedDoc );
 
   vtkDebugMacro("Anatomic context named '" << contextName << "' successfully loaded from file " << filePath);
@@ -1310,11 +1674,17 @@ bool vtkSlicerTerminologiesModuleLogic::LoadAnatomicContextFromSegmentDescriptor
 //---------------------------------------------------------------------------
 void vtkSlicerTerminologiesModuleLogic::LoadDefaultAnatomicContexts()
 {
-  std::string success("");
-  success = this->LoadAnatomicContextFromFile(this->GetModuleShareDirectory() + "/AnatomicRegionAndModifier-DICOM-Master.term.json");
-  if (success.empty())
+  std::vector<std::string> terminologyFilePaths;
+  std::vector<std::string> anatomicContextFilePaths;
+  std::vector<std::string> userContextFilePaths;
+  this->GetDefaultContextFilePaths(terminologyFilePaths, anatomicContextFilePaths, userContextFilePaths);
+  for (const std::string& filePath : anatomicContextFilePaths)
     {
-    vtkErrorMacro("LoadDefaultAnatomicContexts: Failed to load anatomical region context 'AnatomicRegionAndModifier-DICOM-Master'");
+    if (this->LoadAnatomicContextFromFile(filePath).empty())
+      {
+      vtkErrorMacro("LoadDefaultAnatomicContexts: Failed to load anatomical region context '"
+        << vtksys::SystemTools::GetFilenameWithoutExtension(filePath) << "'");
+      }
     }
 }
 
@@ -1323,35 +1693,20 @@ void vtkSlicerTerminologiesModuleLogic::LoadUserContexts()
 {
   if (!this->UserContextsPath)
     {
-    vtkErrorMacro("LoadUserContexts: User settings directory '"
-      << (this->UserContextsPath ? this->UserContextsPath : "None") << "' does not exist");
+    vtkErrorMacro("LoadUserContexts: User settings directory 'None' does not exist");
     return;
     }
-  if (!vtksys::SystemTools::FileExists(this->UserContextsPath, false))
-    {
-    return;
-    }
-
-  // Try to load all json files in the user settings directory
-  vtkSmartPointer<vtkDirectory> userSettingsDir = vtkSmartPointer<vtkDirectory>::New();
-  userSettingsDir->Open(this->UserContextsPath);
-  vtkStringArray* files = userSettingsDir->GetFiles();
-  for (int index=0; index<files->GetNumberOfValues(); ++index)
+  std::vector<std::string> terminologyFilePaths;
+  std::vector<std::string> anatomicContextFilePaths;
+  std::vector<std::string> userContextFilePaths;
+  this->GetDefaultContextFilePaths(terminologyFilePaths, anatomicContextFilePaths, userContextFilePaths);
+  for (const std::string& jsonFilePath : userContextFilePaths)
     {
-    std::string fileName = files->GetValue(index);
-
-    // Only load json files
-    if ( userSettingsDir->FileIsDirectory(fileName.c_str())
-      || fileName.size() < 5 || fileName.substr(fileName.size()-5).compare(".json") )
-      {
-      continue;
-      }
-
     // Try loading file
-    std::string jsonFilePath = std::string(this->UserContextsPath) + "/" + fileName;
     if (!this->LoadContextFromFile(jsonFilePath))
       {
-      vtkErrorMacro("LoadUserContexts: Failed to load terminology from file " << files->GetValue(index));
+      vtkErrorMacro("LoadUserContexts: Failed to load terminology from file "
+        << vtksys::SystemTools::GetFilenameName(jsonFilePath));
       }
     }
 }
@@ -1359,6 +1714,7 @@ void vtkSlicerTerminologiesModuleLogic::LoadUserContexts()
 //---------------------------------------------------------------------------
 void vtkSlicerTerminologiesModuleLogic::GetLoadedTerminologyNames(std::vector<std::string> &terminologyNames)
 {
+  this->WaitForDefaultContexts();
   terminologyNames.clear();
 
   vtkSlicerTerminologiesModuleLogic::vtkInternal::TerminologyMap::iterator termIt;
@@ -1388,6 +1744,7 @@ void vtkSlicerTerminologiesModuleLogic::GetLoadedTerminologyNames(vtkStringArray
 //---------------------------------------------------------------------------
 void vtkSlicerTerminologiesModuleLogic::GetLoadedAnatomicContextNames(std::vector<std::string> &anatomicContextNames)
 {
+  this->WaitForDefaultContexts();
   anatomicContextNames.clear();
 
   vtkSlicerTerminologiesModuleLogic::vtkInternal::TerminologyMap::iterator anIt;
@@ -1432,38 +1789,7 @@ bool vtkSlicerTerminologiesModuleLogic::FindCategoriesInTerminology(std::string
     return false;
     }
 
-  // Make lowercase for case-insensitive comparison
-  std::transform(search.begin(), search.end(), search.begin(), ::tolower);
-
-  // Traverse categories
-  rapidjson::SizeType index = 0;
-  while (index < categoryArray.Size())
-    {
-    rapidjson::Value& category = categoryArray[index];
-    if (category.IsObject())
-      {
-      rapidjson::Value& categoryName = category["CodeMeaning"];
-      rapidjson::Value& categoryCodingSchemeDesignator = category["CodingSchemeDesignator"];
-      rapidjson::Value& categoryCodeValue = category["CodeValue"];
-      if (categoryName.IsString() && categoryCodingSchemeDesignator.IsString() && categoryCodeValue.IsString())
-        {
-        // Add category to list if search string is empty or is contained by the current category name
-        std::string categoryNameStr = categoryName.GetString();
-        std::string categoryNameLowerCase(categoryNameStr);
-        std::transform(categoryNameLowerCase.begin(), categoryNameLowerCase.end(), categoryNameLowerCase.begin(), ::tolower);
-        if (search.empty() || categoryNameLowerCase.find(search) != std::string::npos)
-          {
-          CodeIdentifier categoryId(categoryCodingSchemeDesignator.GetString(), categoryCodeValue.GetString(), categoryNameStr);
-          categories.push_back(categoryId);
-          }
-        }
-      else
-        {
-        vtkErrorMacro("FindCategoriesInTerminology: Invalid category '" << categoryName.GetString() << "' in terminology '" << terminologyName << "'");
-        }
-      }
-    ++index;
-    }
+  this->Internal->FindCodesInLoadedArray(categoryArray, search, categories);
 
   return true;
 }
@@ -1552,39 +1878,7 @@ bool vtkSlicerTerminologiesModuleLogic::FindTypesInTerminologyCategory(
     return false;
     }
 
-  // Make lowercase for case-insensitive comparison
-  std::transform(search.begin(), search.end(), search.begin(), ::tolower);
-
-  // Traverse types
-  rapidjson::SizeType index = 0;
-  while (index < typeArray.Size())
-    {
-    rapidjson::Value& type = typeArray[index];
-    if (type.IsObject())
-      {
-      rapidjson::Value& typeName = type["CodeMeaning"];
-      rapidjson::Value& typeCodingSchemeDesignator = type["CodingSchemeDesignator"];
-      rapidjson::Value& typeCodeValue = type["CodeValue"];
-      if (typeName.IsString() && typeCodingSchemeDesignator.IsString() && typeCodeValue.IsString())
-        {
-        // Add type to list if search string is empty or is contained by the current type name
-        std::string typeNameStr = typeName.GetString();
-        std::string typeNameLowerCase(typeNameStr);
-        std::transform(typeNameLowerCase.begin(), typeNameLowerCase.end(), typeNameLowerCase.begin(), ::tolower);
-        if (search.empty() || typeNameLowerCase.find(search) != std::string::npos)
-          {
-          CodeIdentifier typeId(typeCodingSchemeDesignator.GetString(), typeCodeValue.GetString(), typeNameStr);
-          types.push_back(typeId);
-          }
-        }
-      else
-        {
-        vtkErrorMacro("FindTypesInTerminologyCategory: Invalid type '" << typeName.GetString() << "in category '"
-          << categoryId.CodeMeaning << "' in terminology '" << terminologyName << "'");
-        }
-      }
-    ++index;
-    }
+  this->Internal->FindCodesInLoadedArray(typeArray, search, types);
 
   return true;
 }
@@ -1786,39 +2080,7 @@ bool vtkSlicerTerminologiesModuleLogic::FindRegionsInAnatomicContext(std::string
     return false;
     }
 
-  // Make lowercase for case-insensitive comparison
-  std::transform(search.begin(), search.end(), search.begin(), ::tolower);
-
-  // Traverse regions
-  rapidjson::SizeType index = 0;
-  while (index<regionArray.Size())
-    {
-    rapidjson::Value& region = regionArray[index];
-    if (region.IsObject())
-      {
-      rapidjson::Value& regionName = region["CodeMeaning"];
-      rapidjson::Value& regionCodingSchemeDesignator = region["CodingSchemeDesignator"];
-      rapidjson::Value& regionCodeValue = region["CodeValue"];
-      if (regionName.IsString() && regionCodingSchemeDesignator.IsString() && regionCodeValue.IsString())
-        {
-        // Add region name to list if search string is empty or is contained by the current region name
-        std::string regionNameStr = regionName.GetString();
-        std::string regionNameLowerCase(regionNameStr);
-        std::transform(regionNameLowerCase.begin(), regionNameLowerCase.end(), regionNameLowerCase.begin(), ::tolower);
-        if (search.empty() || regionNameLowerCase.find(search) != std::string::npos)
-          {
-          CodeIdentifier regionId(regionCodingSchemeDesignator.GetString(), regionCodeValue.GetString(), regionNameStr);
-          regions.push_back(regionId);
-          }
-        }
-      else
-        {
-        vtkErrorMacro("FindRegionsInAnatomicContext: Invalid region '" << regionName.GetString()
-          << "' in anatomic context '" << anatomicContextName << "'");
-        }
-      }
-    ++index;
-    }
+  this->Internal->FindCodesInLoadedArray(regionArray, search, regions);
 
   return true;
 }
@@ -60,6 +60,13 @@ public:
       std::string CodeMeaning; // Human readable name (not required for ID)
     };
 
+  enum
+    {
+    /// Invoked (in the main thread) when the default and user contexts have been read
+    /// in the background. \sa LoadDefaultContextsInBackground
+    DefaultContextsLoadedEvent = vtkCommand::UserEvent + 1
+    };
+
   /// Node attribute name for name auto generated
   static const char* GetNameAutoGeneratedAttributeName() { return "Terminologies.AutoUpdateNodeName"; };
   /// Node attribute name for color auto generated
@@ -226,10 +233,23 @@ public:
   /// Assemble human readable info string from a terminology entry, for example for tooltips
   static std::string GetInfoStringFromTerminologyEntry(vtkSlicerTerminologyEntry* entry);
 
+  /// Wait until the default and user contexts that are read in the background
+  /// are loaded. All methods accessing the loaded contexts call this method, therefore
+  /// it only needs to be called explicitly for making sure that loading errors are reported.
+  /// \sa LoadDefaultContextsInBackground
+  void WaitForDefaultContexts();
+
 public:
   vtkGetStringMacro(UserContextsPath);
   vtkSetStringMacro(UserContextsPath);
 
+  /// If enabled (default), the default terminologies and anatomic contexts and the contexts in
+  /// \sa UserContextsPath are read in a background thread when the scene is set, so that module
+  /// setup is not delayed by parsing the large JSON files. \sa DefaultContextsLoadedEvent
+  vtkGetMacro(LoadDefaultContextsInBackground, bool);
+  vtkSetMacro(LoadDefaultContextsInBackground, bool);
+  vtkBooleanMacro(LoadDefaultContextsInBackground, bool);
+
 protected:
   vtkSlicerTerminologiesModuleLogic();
   ~vtkSlicerTerminologiesModuleLogic() override;
@@ -242,11 +262,20 @@ protected:
   void LoadDefaultAnatomicContexts();
   /// Load terminologies and anatomic contexts from the user settings directory \sa UserContextsPath
   void LoadUserContexts();
+  /// Start reading the default and user contexts in a background thread
+  void LoadDefaultContextsAsync();
+
+  /// Get the files loaded by \sa LoadDefaultTerminologies, \sa LoadDefaultAnatomicContexts,
+  /// and \sa LoadUserContexts.
+  void GetDefaultContextFilePaths(std::vector<std::string>& terminologyFilePaths,
+    std::vector<std::string>& anatomicContextFilePaths, std::vector<std::string>& userContextFilePaths);
 
 protected:
   /// The path from which the json files are automatically loaded on startup
   char* UserContextsPath{nullptr};
 
+  bool LoadDefaultContextsInBackground{true};
+
 private:
   vtkSlicerTerminologiesModuleLogic(const vtkSlicerTerminologiesModuleLogic&) = delete;
   void operator=(const vtkSlicerTerminologiesModuleLogic&) = delete;
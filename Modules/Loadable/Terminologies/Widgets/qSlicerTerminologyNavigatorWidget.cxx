@@ -48,6 +48,9 @@
 #include <QTableWidgetItem>
 #include <QTimer>
 
+// STD includes
+#include <set>
+
 //-----------------------------------------------------------------------------
 // TerminologyInfoBundle methods
 
@@ -1064,6 +1067,8 @@ void qSlicerTerminologyNavigatorWidget::populateCategoryTable()
     d->CurrentTerminologyName.toUtf8().constData(), categories, d->SearchBox_Category->text().toUtf8().constData() );
 
   QTableWidgetItem* selectedItem = nullptr;
+  // Repaint only once all items are added
+  d->tableWidget_Category->setUpdatesEnabled(false);
   d->tableWidget_Category->setRowCount(categories.size());
   int index = 0;
   std::vector<vtkSlicerTerminologiesModuleLogic::CodeIdentifier>::iterator idIt;
@@ -1082,6 +1087,7 @@ void qSlicerTerminologyNavigatorWidget::populateCategoryTable()
       selectedItem = addedCategoryItem;
       }
     }
+  d->tableWidget_Category->setUpdatesEnabled(true);
 
   // Select category if selection was valid and item shows up in search
   if (selectedItem)
@@ -1134,6 +1140,8 @@ void qSlicerTerminologyNavigatorWidget::populateTypeTable()
   // Get types in selected categories containing the search string. If no search string then add every type
   std::vector<vtkSlicerTerminologiesModuleLogic::CodeIdentifier> types;
   QMap<int, int> typeIndexToCategoryIndexMap;
+  // Coding scheme designator and code value of the added types, for fast duplicate check
+  std::set<std::pair<std::string, std::string> > addedTypeCodes;
   int typeIndex = 0;
   int categoryIndex = 0;
   std::string searchTerm(d->SearchBox_Type->text().toUtf8().constData());
@@ -1148,19 +1156,8 @@ void qSlicerTerminologyNavigatorWidget::populateTypeTable()
 
     for (idIt=typesInCategory.begin(); idIt!=typesInCategory.end(); ++idIt)
       {
-      // Determine if type already exists in list
-      bool duplicate = false;
-      std::vector<vtkSlicerTerminologiesModuleLogic::CodeIdentifier>::iterator typeIt;
-      for (typeIt=types.begin(); typeIt!=types.end(); ++typeIt)
-        {
-        if ( !idIt->CodeValue.compare(typeIt->CodeValue)
-          && !idIt->CodingSchemeDesignator.compare(typeIt->CodingSchemeDesignator) )
-          {
-          duplicate = true;
-          break;
-          }
-        }
-      if (!duplicate)
+      // Add type only if it does not already exist in list
+      if (addedTypeCodes.insert(std::make_pair(idIt->CodingSchemeDesignator, idIt->CodeValue)).second)
         {
         // Add type
         types.push_back(*idIt);
@@ -1176,6 +1173,8 @@ void qSlicerTerminologyNavigatorWidget::populateTypeTable()
     }
 
     QTableWidgetItem* selectedItem = nullptr;
+    // Repaint only once all items are added
+    d->tableWidget_Type->setUpdatesEnabled(false);
 
     // Show none item only if search term is empty (if user is searching then they want an actual type)
     int noneTypeExists = 0;
@@ -1218,6 +1217,7 @@ void qSlicerTerminologyNavigatorWidget::populateTypeTable()
         selectedItem = addedTypeItem;
         }
       }
+    d->tableWidget_Type->setUpdatesEnabled(true);
 
   if (selectedItem)
     {
@@ -1974,6 +1974,8 @@ void qSlicerTerminologyNavigatorWidget::populateRegionTable()
     regions, d->SearchBox_AnatomicRegion->text().toUtf8().constData() );
 
   QTableWidgetItem* selectedItem = nullptr;
+  // Repaint only once all items are added
+  d->tableWidget_AnatomicRegion->setUpdatesEnabled(false);
   d->tableWidget_AnatomicRegion->setRowCount(regions.size());
   int index = 0;
   std::vector<vtkSlicerTerminologiesModuleLogic::CodeIdentifier>::iterator idIt;
@@ -1992,6 +1994,7 @@ void qSlicerTerminologyNavigatorWidget::populateRegionTable()
       selectedItem = addedRegionItem;
       }
     }
+  d->tableWidget_AnatomicRegion->setUpdatesEnabled(true);
 
   // Select region if selection was valid and item shows up in search
   if (selectedItem)
@@ -0,0 +1,125 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2005 Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Program:   3D Slicer
+
+=========================================================================auto=*/
+
+// Logic includes
+#include "vtkSlicerTransformLogic.h"
+
+// MRML includes
+#include "vtkMRMLCoreTestingMacros.h"
+#include "vtkMRMLScene.h"
+#include "vtkMRMLTransformDisplayNode.h"
+#include "vtkMRMLTransformNode.h"
+
+// VTK includes
+#include <vtkImageData.h>
+#include <vtkMatrix4x4.h>
+#include <vtkNew.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkThinPlateSplineTransform.h>
+
+namespace
+{
+
+//-----------------------------------------------------------------------------
+/// Compute 2D contour visualization at the given slice offset with and without cache
+/// and check that the bounds of the contours match.
+int TestContourAtSliceOffset(vtkMRMLTransformDisplayNode* displayNode, double sliceOffset,
+  vtkSlicerTransformLogic::ContourVisualization2dCache* cache, double tolerance)
+{
+  vtkNew<vtkMatrix4x4> sliceToRAS;
+  sliceToRAS->SetElement(2, 3, sliceOffset);
+  double fieldOfViewOrigin[3] = { 0.0, 0.0, 0.0 };
+  double fieldOfViewSize[3] = { 120.0, 120.0, 1.0 };
+
+  vtkNew<vtkPolyData> expectedContours;
+  CHECK_BOOL(vtkSlicerTransformLogic::GetVisualization2d(expectedContours.GetPointer(), displayNode,
+    sliceToRAS.GetPointer(), fieldOfViewOrigin, fieldOfViewSize), true);
+  vtkNew<vtkPolyData> cachedContours;
+  CHECK_BOOL(vtkSlicerTransformLogic::GetVisualization2d(cachedContours.GetPointer(), displayNode,
+    sliceToRAS.GetPointer(), fieldOfViewOrigin, fieldOfViewSize, nullptr, cache), true);
+
+  CHECK_BOOL(expectedContours->GetNumberOfPoints() > 0, true);
+  CHECK_BOOL(cachedContours->GetNumberOfPoints() > 0, true);
+  double expectedBounds[6] = { 0.0 };
+  expectedContours->GetBounds(expectedBounds);
+  double cachedBounds[6] = { 0.0 };
+  cachedContours->GetBounds(cachedBounds);
+  for (int i = 0; i < 6; ++i)
+    {
+    CHECK_DOUBLE_TOLERANCE(cachedBounds[i], expectedBounds[i], tolerance);
+    }
+  return EXIT_SUCCESS;
+}
+
+} // end of anonymous namespace
+
+//-----------------------------------------------------------------------------
+int vtkSlicerTransformLogicTest4(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
+{
+  vtkNew<vtkMRMLScene> scene;
+
+  // Warping transform: displacement is largest around the origin
+  vtkNew<vtkPoints> sourceLandmarks;
+  vtkNew<vtkPoints> targetLandmarks;
+  for (int i = 0; i < 8; ++i)
+    {
+    double point[3] = { (i & 1) ? 50.0 : -50.0, (i & 2) ? 50.0 : -50.0, (i & 4) ? 50.0 : -50.0 };
+    sourceLandmarks->InsertNextPoint(point);
+    targetLandmarks->InsertNextPoint(point);
+    }
+  sourceLandmarks->InsertNextPoint(0.0, 0.0, 0.0);
+  targetLandmarks->InsertNextPoint(5.0, 10.0, 3.0);
+  vtkNew<vtkThinPlateSplineTransform> thinPlateSplineTransform;
+  thinPlateSplineTransform->SetBasisToR();
+  thinPlateSplineTransform->SetSourceLandmarks(sourceLandmarks.GetPointer());
+  thinPlateSplineTransform->SetTargetLandmarks(targetLandmarks.GetPointer());
+
+  vtkNew<vtkMRMLTransformNode> transformNode;
+  scene->AddNode(transformNode.GetPointer());
+  transformNode->SetAndObserveTransformToParent(thinPlateSplineTransform.GetPointer());
+
+  vtkNew<vtkMRMLTransformDisplayNode> displayNode;
+  scene->AddNode(displayNode.GetPointer());
+  transformNode->SetAndObserveDisplayNodeID(displayNode->GetID());
+  displayNode->SetVisualizationMode(vtkMRMLTransformDisplayNode::VIS_MODE_CONTOUR);
+  displayNode->SetContourResolutionMm(4.0);
+  double levels[3] = { 2.0, 4.0, 6.0 };
+  displayNode->SetContourLevelsMm(levels, 3);
+
+  vtkSlicerTransformLogic::ContourVisualization2dCache cache;
+
+  // First slice is sampled directly
+  CHECK_EXIT_SUCCESS(TestContourAtSliceOffset(displayNode.GetPointer(), 0.0, &cache, 1e-3));
+  CHECK_NOT_NULL(cache.MagnitudeVolume);
+  CHECK_INT(cache.MagnitudeVolume->GetDimensions()[2], 1);
+
+  // Moving the slice samples a slab around it
+  CHECK_EXIT_SUCCESS(TestContourAtSliceOffset(displayNode.GetPointer(), 4.0, &cache, 1e-3));
+  vtkImageData* slab = cache.MagnitudeVolume;
+  CHECK_BOOL(slab->GetDimensions()[2] > 1, true);
+
+  // Slices within the slab reuse the samples
+  CHECK_EXIT_SUCCESS(TestContourAtSliceOffset(displayNode.GetPointer(), 12.0, &cache, 1e-3));
+  CHECK_POINTER(cache.MagnitudeVolume.GetPointer(), slab);
+  CHECK_EXIT_SUCCESS(TestContourAtSliceOffset(displayNode.GetPointer(), -6.0, &cache, 1.0));
+  CHECK_POINTER(cache.MagnitudeVolume.GetPointer(), slab);
+
+  // Modified transform invalidates the cache
+  targetLandmarks->SetPoint(8, 8.0, 12.0, 3.0);
+  targetLandmarks->Modified();
+  thinPlateSplineTransform->Modified();
+  CHECK_EXIT_SUCCESS(TestContourAtSliceOffset(displayNode.GetPointer(), 12.0, &cache, 1e-3));
+  CHECK_INT(cache.MagnitudeVolume->GetDimensions()[2], 1);
+
+  std::cout << "vtkSlicerTransformLogicTest4 passed." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -18,6 +18,7 @@ or http://www.slicer.org/copyright/copyright.txt for details.
 #include "vtkMRMLGridTransformNode.h"
 #include "vtkMRMLLinearTransformNode.h"
 #include "vtkMRMLMarkupsNode.h"
+#include "vtkMRMLModelNode.h"
 #include "vtkMRMLScalarVolumeDisplayNode.h"
 #include "vtkMRMLScalarVolumeNode.h"
 #include "vtkMRMLScene.h"
@@ -30,7 +31,10 @@ or http://www.slicer.org/copyright/copyright.txt for details.
 #include <itksys/SystemTools.hxx>
 
 // VTK includes
+#include <vtkAlgorithmOutput.h>
 #include <vtkAppendPolyData.h>
+#include <vtkCommand.h>
+#include <vtkCellData.h>
 #include <vtkCollection.h>
 #include <vtkArrowSource.h>
 #include <vtkBoundingBox.h>
@@ -52,15 +56,21 @@ or http://www.slicer.org/copyright/copyright.txt for details.
 #include <vtkPoints.h>
 #include <vtkPointSet.h>
 #include <vtkPointData.h>
+#include <vtkSMPTools.h>
 #include <vtkSphereSource.h>
 #include <vtkThinPlateSplineTransform.h>
 #include <vtkTransform.h>
 #include <vtkTransformPolyDataFilter.h>
+#include <vtkTrivialProducer.h>
 #include <vtkTubeFilter.h>
 #include <vtkUnstructuredGrid.h>
 #include <vtkVectorNorm.h>
 #include <vtkWarpVector.h>
 
+// STD includes
+#include <algorithm>
+#include <functional>
+
 // ITK includes
 #include "itkBSplineDeformableTransform.h"
 #include "itkCenteredAffineTransform.h"
@@ -79,6 +89,174 @@ or http://www.slicer.org/copyright/copyright.txt for details.
 
 vtkStandardNewMacro(vtkSlicerTransformLogic);
 
+namespace
+{
+
+//----------------------------------------------------------------------------
+/// Fill a float image with the displacement of the transform at each voxel position.
+/// If magnitude is true then the image has one component (displacement magnitude),
+/// otherwise three components (displacement vector).
+/// Rows of the image are processed in parallel. If progressCallback is specified then
+/// it is called after each block of slices and processing stops if it returns false.
+/// Returns true if all voxels are computed.
+bool SampleDisplacementField(vtkImageData* image, vtkAbstractTransform* transform, vtkMatrix4x4* ijkToRAS, bool magnitude,
+  const std::function<bool(double)>& progressCallback = std::function<bool(double)>())
+{
+  image->AllocateScalars(VTK_FLOAT, magnitude ? 1 : 3);
+  float* voxels = static_cast<float*>(image->GetScalarPointer());
+  int* extent = image->GetExtent();
+  const vtkIdType rowSize = static_cast<vtkIdType>(extent[1] - extent[0] + 1);
+  const vtkIdType numberOfRowsInSlice = static_cast<vtkIdType>(extent[3] - extent[2] + 1);
+  const vtkIdType numberOfRows = numberOfRowsInSlice * (extent[5] - extent[4] + 1);
+  if (rowSize <= 0 || numberOfRows <= 0)
+  {
+    return true;
+  }
+  const int numberOfComponents = magnitude ? 1 : 3;
+
+  // Update once, then the transform can be evaluated concurrently
+  transform->Update();
+
+  auto sampleRows = [&](vtkIdType beginRow, vtkIdType endRow)
+  {
+    double point_IJK[4] = { 0, 0, 0, 1 };
+    double point_RAS[4] = { 0, 0, 0, 1 };
+    double transformedPoint_RAS[3] = { 0, 0, 0 };
+    for (vtkIdType row = beginRow; row < endRow; ++row)
+    {
+      point_IJK[1] = extent[2] + row % numberOfRowsInSlice;
+      point_IJK[2] = extent[4] + row / numberOfRowsInSlice;
+      float* voxelPtr = voxels + row * rowSize * numberOfComponents;
+      for (vtkIdType i = 0; i < rowSize; ++i)
+      {
+        point_IJK[0] = extent[0] + i;
+        ijkToRAS->MultiplyPoint(point_IJK, point_RAS);
+        transform->InternalTransformPoint(point_RAS, transformedPoint_RAS);
+        double displacement_RAS[3] =
+        {
+          transformedPoint_RAS[0] - point_RAS[0],
+          transformedPoint_RAS[1] - point_RAS[1],
+          transformedPoint_RAS[2] - point_RAS[2]
+        };
+        if (magnitude)
+        {
+          *(voxelPtr++) = static_cast<float>(vtkMath::Norm(displacement_RAS));
+        }
+        else
+        {
+          *(voxelPtr++) = static_cast<float>(displacement_RAS[0]);
+          *(voxelPtr++) = static_cast<float>(displacement_RAS[1]);
+          *(voxelPtr++) = static_cast<float>(displacement_RAS[2]);
+        }
+      }
+    }
+  };
+
+  // Without progress reporting all rows are processed at once, otherwise about 100 blocks of whole slices
+  vtkIdType blockSize = numberOfRows;
+  if (progressCallback)
+  {
+    blockSize = std::max<vtkIdType>(numberOfRows / 100 / numberOfRowsInSlice, 1) * numberOfRowsInSlice;
+  }
+  for (vtkIdType beginRow = 0; beginRow < numberOfRows; beginRow += blockSize)
+  {
+    vtkIdType endRow = std::min(beginRow + blockSize, numberOfRows);
+    vtkSMPTools::For(beginRow, endRow, sampleRows);
+    if (progressCallback && !progressCallback(static_cast<double>(endRow) / numberOfRows))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+/// Get displacement magnitudes of a slice from the contour visualization cache.
+/// The slice samples are defined by ijkToRAS and imageSize. The cache is updated if it does not contain the slice.
+/// sliceImage receives the magnitudes in the in-plane grid of the cached volume and
+/// sliceImageToRAS is set to the IJK to RAS matrix of sliceImage.
+void GetCachedContourMagnitudes(vtkSlicerTransformLogic::ContourVisualization2dCache* cache,
+  vtkMRMLTransformNode* transformNode, vtkMatrix4x4* ijkToRAS, int imageSize[3],
+  vtkImageData* sliceImage, vtkMatrix4x4* sliceImageToRAS)
+{
+  // Number of slices sampled on each side of the slice when the slice is moved out of the cached volume
+  const int slabHalfThickness = 8;
+  const double tolerance = 1e-3;
+
+  vtkMTimeType transformMTime = transformNode ? transformNode->GetTransformToWorldMTime() : 0;
+  bool sameSampling = (cache->MagnitudeVolume && cache->MagnitudeVolumeIJKToRAS && cache->TransformMTime == transformMTime);
+  for (int row = 0; row < 3 && sameSampling; row++)
+  {
+    for (int col = 0; col < 3 && sameSampling; col++)
+    {
+      sameSampling = (fabs(cache->MagnitudeVolumeIJKToRAS->GetElement(row, col) - ijkToRAS->GetElement(row, col)) < 1e-6);
+    }
+  }
+
+  // Position of the slice origin in the IJK coordinate system of the cached volume
+  double sliceOrigin_RAS[4] = { ijkToRAS->GetElement(0, 3), ijkToRAS->GetElement(1, 3), ijkToRAS->GetElement(2, 3), 1.0 };
+  double sliceOrigin_Volume[4] = { 0.0, 0.0, 0.0, 1.0 };
+  bool inPlaneCovered = false;
+  bool depthCovered = false;
+  if (sameSampling)
+  {
+    vtkNew<vtkMatrix4x4> rasToVolume;
+    vtkMatrix4x4::Invert(cache->MagnitudeVolumeIJKToRAS, rasToVolume.GetPointer());
+    rasToVolume->MultiplyPoint(sliceOrigin_RAS, sliceOrigin_Volume);
+    int* extent = cache->MagnitudeVolume->GetExtent();
+    inPlaneCovered = sliceOrigin_Volume[0] >= extent[0] - tolerance && sliceOrigin_Volume[0] + imageSize[0] - 1 <= extent[1] + tolerance
+      && sliceOrigin_Volume[1] >= extent[2] - tolerance && sliceOrigin_Volume[1] + imageSize[1] - 1 <= extent[3] + tolerance;
+    depthCovered = sliceOrigin_Volume[2] >= extent[4] - tolerance && sliceOrigin_Volume[2] <= extent[5] + tolerance;
+  }
+  if (!inPlaneCovered || !depthCovered)
+  {
+    // Sample a slab only if the slice is moved along its normal, otherwise (transform is modified,
+    // slice is rotated, panned, or zoomed) it is not likely that samples of nearby slices will be used.
+    int halfThickness = (sameSampling && inPlaneCovered) ? slabHalfThickness : 0;
+    cache->MagnitudeVolume = vtkSmartPointer<vtkImageData>::New();
+    cache->MagnitudeVolume->SetExtent(0, imageSize[0] - 1, 0, imageSize[1] - 1, -halfThickness, halfThickness);
+    vtkSlicerTransformLogic::GetTransformedPointSamplesAsMagnitudeImage(cache->MagnitudeVolume, transformNode, ijkToRAS);
+    cache->MagnitudeVolumeIJKToRAS = vtkSmartPointer<vtkMatrix4x4>::New();
+    cache->MagnitudeVolumeIJKToRAS->DeepCopy(ijkToRAS);
+    cache->TransformMTime = transformMTime;
+    sliceOrigin_Volume[0] = 0.0;
+    sliceOrigin_Volume[1] = 0.0;
+    sliceOrigin_Volume[2] = 0.0;
+  }
+
+  // Interpolate between the two nearest cached slices
+  int* extent = cache->MagnitudeVolume->GetExtent();
+  int sliceExtent[6] =
+  {
+    std::max(extent[0], static_cast<int>(floor(sliceOrigin_Volume[0] + tolerance))),
+    std::min(extent[1], static_cast<int>(ceil(sliceOrigin_Volume[0] + imageSize[0] - 1 - tolerance))),
+    std::max(extent[2], static_cast<int>(floor(sliceOrigin_Volume[1] + tolerance))),
+    std::min(extent[3], static_cast<int>(ceil(sliceOrigin_Volume[1] + imageSize[1] - 1 - tolerance))),
+    0, 0
+  };
+  int k0 = std::min(std::max(extent[4], static_cast<int>(floor(sliceOrigin_Volume[2] + tolerance))), extent[5]);
+  int k1 = std::min(k0 + 1, extent[5]);
+  double weight = (k1 > k0) ? std::min(std::max(sliceOrigin_Volume[2] - k0, 0.0), 1.0) : 0.0;
+  sliceImage->SetExtent(sliceExtent);
+  sliceImage->AllocateScalars(VTK_FLOAT, 1);
+  for (int j = sliceExtent[2]; j <= sliceExtent[3]; j++)
+  {
+    float* outputPtr = static_cast<float*>(sliceImage->GetScalarPointer(sliceExtent[0], j, 0));
+    float* inputPtr0 = static_cast<float*>(cache->MagnitudeVolume->GetScalarPointer(sliceExtent[0], j, k0));
+    float* inputPtr1 = static_cast<float*>(cache->MagnitudeVolume->GetScalarPointer(sliceExtent[0], j, k1));
+    for (int i = sliceExtent[0]; i <= sliceExtent[1]; i++)
+    {
+      *(outputPtr++) = static_cast<float>((1.0 - weight) * (*(inputPtr0++)) + weight * (*(inputPtr1++)));
+    }
+  }
+
+  vtkNew<vtkMatrix4x4> sliceOffset;
+  sliceOffset->SetElement(2, 3, sliceOrigin_Volume[2]);
+  vtkMatrix4x4::Multiply4x4(cache->MagnitudeVolumeIJKToRAS, sliceOffset.GetPointer(), sliceImageToRAS);
+}
+
+} // end of anonymous namespace
+
 //----------------------------------------------------------------------------
 vtkSlicerTransformLogic::vtkSlicerTransformLogic() = default;
 
@@ -95,6 +273,67 @@ bool vtkSlicerTransformLogic::hardenTransform(vtkMRMLTransformableNode* transfor
   return transformableNode->HardenTransform();
 }
 
+//-----------------------------------------------------------------------------
+bool vtkSlicerTransformLogic::HardenTransformWithProgress(vtkMRMLTransformableNode* transformableNode)
+{
+  if (!transformableNode)
+  {
+    return false;
+  }
+  this->AbortProcessing = false;
+  this->ReportProgress(0.0);
+  vtkMRMLTransformNode* transformNode = transformableNode->GetParentTransformNode();
+  vtkMRMLModelNode* modelNode = vtkMRMLModelNode::SafeDownCast(transformableNode);
+  vtkPointSet* mesh = modelNode ? modelNode->GetMesh() : nullptr;
+  bool isInPipeline = modelNode && !vtkTrivialProducer::SafeDownCast(
+    modelNode->GetMeshConnection() ? modelNode->GetMeshConnection()->GetProducer() : nullptr);
+  if (!transformNode || transformNode->IsTransformToWorldLinear()
+    || !mesh || !mesh->GetPoints() || isInPipeline
+    || mesh->GetPointData()->GetVectors() || mesh->GetCellData()->GetNormals() || mesh->GetCellData()->GetVectors())
+  {
+    // Linear transforms are fast to apply, volumes are resampled by a multi-threaded filter,
+    // and other nodes are not large enough to need progress reporting.
+    bool success = transformableNode->HardenTransform();
+    this->ReportProgress(1.0);
+    return success;
+  }
+
+  // Transform the model points in parallel, in blocks, to allow progress reporting and cancellation.
+  // The model is only changed if all points are transformed.
+  vtkNew<vtkGeneralTransform> hardeningTransform;
+  transformNode->GetTransformToWorld(hardeningTransform.GetPointer());
+  vtkNew<vtkPoints> transformedPoints;
+  transformedPoints->SetDataType(mesh->GetPoints()->GetDataType());
+  vtkDataArray* normals = mesh->GetPointData()->GetNormals();
+  vtkSmartPointer<vtkDataArray> transformedNormals;
+  if (normals)
+  {
+    transformedNormals = vtkSmartPointer<vtkDataArray>::Take(normals->NewInstance());
+    transformedNormals->SetName(normals->GetName());
+  }
+  if (!vtkMRMLTransformNode::TransformPoints(hardeningTransform.GetPointer(), mesh->GetPoints(), transformedPoints.GetPointer(),
+    normals, transformedNormals, [this](double progress) { return this->ReportProgress(progress); }))
+  {
+    vtkWarningMacro("vtkSlicerTransformLogic::HardenTransformWithProgress: cancelled, transform of "
+      << (modelNode->GetName() ? modelNode->GetName() : "") << " is not hardened");
+    return false;
+  }
+  mesh->SetPoints(transformedPoints.GetPointer());
+  if (normals)
+  {
+    mesh->GetPointData()->SetNormals(transformedNormals);
+  }
+  modelNode->SetAndObserveTransformNodeID(nullptr);
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+bool vtkSlicerTransformLogic::ReportProgress(double progress)
+{
+  this->InvokeEvent(vtkCommand::ProgressEvent, &progress);
+  return !this->AbortProcessing;
+}
+
 //----------------------------------------------------------------------------
 vtkMRMLTransformNode* vtkSlicerTransformLogic::AddTransform(const char* filename, vtkMRMLScene *scene)
 {
@@ -402,37 +641,7 @@ bool vtkSlicerTransformLogic::GetTransformedPointSamplesAsMagnitudeImage(vtkImag
   // The orientation of the volume cannot be set in the image
   // therefore the volume will not appear in the correct position
   // if the direction matrix is not identity.
-  magnitudeImage->AllocateScalars(VTK_FLOAT, 1);
-
-  double point_RAS[4] = { 0, 0, 0, 1 };
-  double transformedPoint_RAS[4] = { 0, 0, 0, 1 };
-  double pointDislocationVector_RAS[4] = { 0, 0, 0, 1 };
-  double point_IJK[4] = { 0, 0, 0, 1 };
-  float* voxelPtr = static_cast<float*>(magnitudeImage->GetScalarPointer());
-  int* extent = magnitudeImage->GetExtent();
-  for (point_IJK[2] = extent[4]; point_IJK[2] <= extent[5]; point_IJK[2]++)
-  {
-    for (point_IJK[1] = extent[2]; point_IJK[1] <= extent[3]; point_IJK[1]++)
-    {
-      for (point_IJK[0] = extent[0]; point_IJK[0] <= extent[1]; point_IJK[0]++)
-      {
-        ijkToRAS->MultiplyPoint(point_IJK, point_RAS);
-
-        inputTransform->TransformPoint(point_RAS, transformedPoint_RAS);
-
-        pointDislocationVector_RAS[0] = transformedPoint_RAS[0] - point_RAS[0];
-        pointDislocationVector_RAS[1] = transformedPoint_RAS[1] - point_RAS[1];
-        pointDislocationVector_RAS[2] = transformedPoint_RAS[2] - point_RAS[2];
-
-        float mag = sqrt(
-          pointDislocationVector_RAS[0] * pointDislocationVector_RAS[0] +
-          pointDislocationVector_RAS[1] * pointDislocationVector_RAS[1] +
-          pointDislocationVector_RAS[2] * pointDislocationVector_RAS[2]);
-
-        *(voxelPtr++) = mag;
-      }
-    }
-  }
+  SampleDisplacementField(magnitudeImage, inputTransform.GetPointer(), ijkToRAS, true /* magnitude */);
 
   return true;
 }
@@ -549,8 +758,10 @@ vtkMRMLVolumeNode* vtkSlicerTransformLogic::CreateDisplacementVolumeFromTransfor
 
 //----------------------------------------------------------------------------
 vtkMRMLTransformNode* vtkSlicerTransformLogic::ConvertToGridTransform(vtkMRMLTransformNode* inputTransformNode,
-  vtkMRMLVolumeNode* referenceVolumeNode /* = nullptr */, vtkMRMLTransformNode* existingOutputTransformNode /* = nullptr */)
+  vtkMRMLVolumeNode* referenceVolumeNode /* = nullptr */, vtkMRMLTransformNode* existingOutputTransformNode /* = nullptr */,
+  bool computeTransformToParent /* = false */)
 {
+  this->AbortProcessing = false;
   if (inputTransformNode == nullptr)
   {
     vtkErrorMacro("vtkSlicerTransformLogic::ConvertToGridTransform failed: inputTransformNode is invalid");
@@ -584,17 +795,26 @@ vtkMRMLTransformNode* vtkSlicerTransformLogic::ConvertToGridTransform(vtkMRMLTra
     outputGridTransformNode->SetName(scene->GenerateUniqueName(nodeName).c_str());
     scene->AddNode(outputGridTransformNode);
   }
-  // Create/get grid transform
-  vtkOrientedGridTransform* outputGridTransform = vtkOrientedGridTransform::SafeDownCast(
+  // Create/get grid transform.
+  // The grid is stored in the direction it is sampled in, so that evaluating it does not require iterative inversion.
+  vtkOrientedGridTransform* outputGridTransform = vtkOrientedGridTransform::SafeDownCast(computeTransformToParent ?
     outputGridTransformNode->GetTransformToParentAs("vtkOrientedGridTransform",
-    false /* don't report conversion error */,
-    true /* we would like to modify the transform */));
+      false /* don't report conversion error */, true /* we would like to modify the transform */)
+    : outputGridTransformNode->GetTransformFromParentAs("vtkOrientedGridTransform",
+      false /* don't report conversion error */, true /* we would like to modify the transform */));
   if (outputGridTransform == nullptr)
   {
     // we cannot reuse the existing transform, create a new one
     vtkNew<vtkOrientedGridTransform> newOutputGridTransform;
     outputGridTransform = newOutputGridTransform.GetPointer();
-    outputGridTransformNode->SetAndObserveTransformFromParent(outputGridTransform);
+    if (computeTransformToParent)
+    {
+      outputGridTransformNode->SetAndObserveTransformToParent(outputGridTransform);
+    }
+    else
+    {
+      outputGridTransformNode->SetAndObserveTransformFromParent(outputGridTransform);
+    }
   }
   // Create/get displacement field image
   vtkImageData* outputVolume = outputGridTransform->GetDisplacementGrid();
@@ -668,8 +888,25 @@ vtkMRMLTransformNode* vtkSlicerTransformLogic::ConvertToGridTransform(vtkMRMLTra
   }
 
   // Fill the volume with displacement values
-  bool transformToWorld = false; // usually grid transform is defined as transform from parent
-  vtkSlicerTransformLogic::GetTransformedPointSamplesAsVectorImage(outputVolume, inputTransformNode, ijkToRas.GetPointer(), transformToWorld);
+  // (usually grid transform is defined as transform from parent)
+  vtkNew<vtkGeneralTransform> inputTransform;
+  if (computeTransformToParent)
+  {
+    inputTransformNode->GetTransformToWorld(inputTransform.GetPointer());
+  }
+  else
+  {
+    inputTransformNode->GetTransformFromWorld(inputTransform.GetPointer());
+  }
+  this->ReportProgress(0.0);
+  bool completed = SampleDisplacementField(outputVolume, inputTransform.GetPointer(), ijkToRas.GetPointer(), false /* vector */,
+    [this](double progress) { return this->ReportProgress(progress); });
+  outputGridTransform->Modified();
+  if (!completed)
+  {
+    vtkWarningMacro("vtkSlicerTransformLogic::ConvertToGridTransform: cancelled, displacement field is incomplete");
+    return nullptr;
+  }
 
   return outputGridTransformNode.GetPointer();
 }
@@ -696,30 +933,7 @@ bool vtkSlicerTransformLogic::GetTransformedPointSamplesAsVectorImage(vtkImageDa
   // The orientation of the volume cannot be set in the image
   // therefore the volume will not appear in the correct position
   // if the direction matrix is not identity.
-  vectorImage->AllocateScalars(VTK_FLOAT, 3);
-
-  double point_RAS[4] = { 0, 0, 0, 1 };
-  double transformedPoint_RAS[4] = { 0, 0, 0, 1 };
-  double point_IJK[4] = { 0, 0, 0, 1 };
-  float* voxelPtr = static_cast<float*>(vectorImage->GetScalarPointer());
-  int* extent = vectorImage->GetExtent();
-  for (point_IJK[2] = extent[4]; point_IJK[2] <= extent[5]; point_IJK[2]++)
-  {
-    for (point_IJK[1] = extent[2]; point_IJK[1] <= extent[3]; point_IJK[1]++)
-    {
-      for (point_IJK[0] = extent[0]; point_IJK[0] <= extent[1]; point_IJK[0]++)
-      {
-        ijkToRAS->MultiplyPoint(point_IJK, point_RAS);
-
-        inputTransform->TransformPoint(point_RAS, transformedPoint_RAS);
-
-        // store the pointDislocationVector_RAS components in the image
-        *(voxelPtr++) = static_cast<float>(transformedPoint_RAS[0] - point_RAS[0]);
-        *(voxelPtr++) = static_cast<float>(transformedPoint_RAS[1] - point_RAS[1]);
-        *(voxelPtr++) = static_cast<float>(transformedPoint_RAS[2] - point_RAS[2]);
-      }
-    }
-  }
+  SampleDisplacementField(vectorImage, inputTransform.GetPointer(), ijkToRAS, false /* vector */);
 
   return true;
 }
@@ -1090,7 +1304,7 @@ void vtkSlicerTransformLogic::GetGridVisualization3d(vtkPolyData* output, vtkMRM
 //----------------------------------------------------------------------------
 void vtkSlicerTransformLogic::GetContourVisualization2d(vtkPolyData* output,
   vtkMRMLTransformDisplayNode* displayNode, vtkMatrix4x4* sliceToRAS,
-  double* fieldOfViewOrigin, double* fieldOfViewSize)
+  double* fieldOfViewOrigin, double* fieldOfViewSize, ContourVisualization2dCache* contourCache /*=nullptr*/)
 {
   vtkNew<vtkImageData> magnitudeImage;
   double pointSpacing = displayNode->GetContourResolutionMm();
@@ -1116,8 +1330,18 @@ void vtkSlicerTransformLogic::GetContourVisualization2d(vtkPolyData* output,
   int imageSize[3] = { numOfPointsX, numOfPointsY, 1 };
 
   vtkMRMLTransformNode* inputTransformNode = vtkMRMLTransformNode::SafeDownCast(displayNode->GetDisplayableNode());
-  magnitudeImage->SetExtent(0, imageSize[0] - 1, 0, imageSize[1] - 1, 0, imageSize[2] - 1);
-  GetTransformedPointSamplesAsMagnitudeImage(magnitudeImage.GetPointer(), inputTransformNode, ijkToRAS.GetPointer());
+  vtkNew<vtkMatrix4x4> magnitudeImageToRAS;
+  if (contourCache)
+  {
+    GetCachedContourMagnitudes(contourCache, inputTransformNode, ijkToRAS.GetPointer(), imageSize,
+      magnitudeImage.GetPointer(), magnitudeImageToRAS.GetPointer());
+  }
+  else
+  {
+    magnitudeImage->SetExtent(0, imageSize[0] - 1, 0, imageSize[1] - 1, 0, imageSize[2] - 1);
+    GetTransformedPointSamplesAsMagnitudeImage(magnitudeImage.GetPointer(), inputTransformNode, ijkToRAS.GetPointer());
+    magnitudeImageToRAS->DeepCopy(ijkToRAS.GetPointer());
+  }
 
   vtkNew<vtkContourFilter> contourFilter;
   double* levels = displayNode->GetContourLevelsMm();
@@ -1130,7 +1354,7 @@ void vtkSlicerTransformLogic::GetContourVisualization2d(vtkPolyData* output,
 
   vtkNew<vtkTransformPolyDataFilter> transformSliceToRas;
   vtkNew<vtkTransform> sliceToRasTransform;
-  sliceToRasTransform->SetMatrix(ijkToRAS.GetPointer());
+  sliceToRasTransform->SetMatrix(magnitudeImageToRAS.GetPointer());
   transformSliceToRas->SetTransform(sliceToRasTransform.GetPointer());
   transformSliceToRas->SetInputConnection(contourFilter->GetOutputPort());
   transformSliceToRas->Update();
@@ -1209,6 +1433,14 @@ void vtkSlicerTransformLogic::GetContourVisualization3d(vtkPolyData* output, vtk
 bool vtkSlicerTransformLogic::GetVisualization2d(vtkPolyData* output_RAS,
   vtkMRMLTransformDisplayNode* displayNode, vtkMRMLSliceNode* sliceNode,
   vtkMRMLMarkupsNode* glyphPointsNode /*=nullptr*/)
+{
+  return vtkSlicerTransformLogic::GetVisualization2d(output_RAS, displayNode, sliceNode, glyphPointsNode, nullptr);
+}
+
+//----------------------------------------------------------------------------
+bool vtkSlicerTransformLogic::GetVisualization2d(vtkPolyData* output_RAS,
+  vtkMRMLTransformDisplayNode* displayNode, vtkMRMLSliceNode* sliceNode,
+  vtkMRMLMarkupsNode* glyphPointsNode, ContourVisualization2dCache* contourCache)
 {
   if (displayNode == nullptr || output_RAS == nullptr || sliceNode == nullptr)
   {
@@ -1225,7 +1457,7 @@ bool vtkSlicerTransformLogic::GetVisualization2d(vtkPolyData* output_RAS,
     samplePoints_RAS = vtkSmartPointer<vtkPoints>::New();
     vtkSlicerTransformLogic::GetMarkupsAsPoints(glyphPointsNode, samplePoints_RAS);
   }
-  GetVisualization2d(output_RAS, displayNode, sliceToRAS, fieldOfViewOrigin, fieldOfViewSize, samplePoints_RAS);
+  GetVisualization2d(output_RAS, displayNode, sliceToRAS, fieldOfViewOrigin, fieldOfViewSize, samplePoints_RAS, contourCache);
 
   return true;
 }
@@ -1233,6 +1465,15 @@ bool vtkSlicerTransformLogic::GetVisualization2d(vtkPolyData* output_RAS,
 //----------------------------------------------------------------------------
 bool vtkSlicerTransformLogic::GetVisualization2d(vtkPolyData* output, vtkMRMLTransformDisplayNode* displayNode,
   vtkMatrix4x4* sliceToRAS, double* fieldOfViewOrigin, double* fieldOfViewSize, vtkPoints* samplePositions_RAS /*=nullptr*/)
+{
+  return vtkSlicerTransformLogic::GetVisualization2d(output, displayNode, sliceToRAS, fieldOfViewOrigin, fieldOfViewSize,
+    samplePositions_RAS, nullptr);
+}
+
+//----------------------------------------------------------------------------
+bool vtkSlicerTransformLogic::GetVisualization2d(vtkPolyData* output, vtkMRMLTransformDisplayNode* displayNode,
+  vtkMatrix4x4* sliceToRAS, double* fieldOfViewOrigin, double* fieldOfViewSize, vtkPoints* samplePositions_RAS,
+  ContourVisualization2dCache* contourCache)
 {
   if (displayNode == nullptr || output == nullptr || sliceToRAS == nullptr || fieldOfViewOrigin == nullptr || fieldOfViewSize == nullptr)
   {
@@ -1256,7 +1497,7 @@ bool vtkSlicerTransformLogic::GetVisualization2d(vtkPolyData* output, vtkMRMLTra
     GetGridVisualization2d(output, displayNode, sliceToRAS, fieldOfViewOrigin, fieldOfViewSize);
     break;
   case vtkMRMLTransformDisplayNode::VIS_MODE_CONTOUR:
-    GetContourVisualization2d(output, displayNode, sliceToRAS, fieldOfViewOrigin, fieldOfViewSize);
+    GetContourVisualization2d(output, displayNode, sliceToRAS, fieldOfViewOrigin, fieldOfViewSize, contourCache);
     break;
   }
 
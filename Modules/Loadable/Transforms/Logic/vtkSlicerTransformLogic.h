@@ -27,6 +27,9 @@
 // MRMLLogic includes
 #include <vtkMRMLAbstractLogic.h>
 
+// VTK includes
+#include <vtkSmartPointer.h>
+
 // STD includes
 #include <vector>
 
@@ -64,6 +67,21 @@ class VTK_SLICER_TRANSFORMS_MODULE_LOGIC_EXPORT vtkSlicerTransformLogic : public
   /// vtkMRMLTransformableNode::HardenTransform() method instead.
   static bool hardenTransform(vtkMRMLTransformableNode* node);
 
+  /// Apply the associated transform to the transformable node, reporting progress.
+  /// Non-linear transforms of models are evaluated by multiple threads, in blocks of points.
+  /// vtkCommand::ProgressEvent is invoked on the logic after each block (call data is a
+  /// pointer to a double value between 0 and 1). If an observer calls SetAbortProcessing(true)
+  /// then processing stops, the node is left unchanged, and false is returned.
+  /// Other nodes are hardened by vtkMRMLTransformableNode::HardenTransform().
+  bool HardenTransformWithProgress(vtkMRMLTransformableNode* node);
+
+  /// Request stopping of HardenTransformWithProgress or ConvertToGridTransform.
+  /// Typically called from an observer of vtkCommand::ProgressEvent.
+  /// The flag is reset at the start of each operation.
+  vtkSetMacro(AbortProcessing, bool);
+  vtkGetMacro(AbortProcessing, bool);
+  vtkBooleanMacro(AbortProcessing, bool);
+
   ///
   /// Read transform from file
   vtkMRMLTransformNode* AddTransform (const char* filename, vtkMRMLScene *scene);
@@ -82,6 +100,35 @@ class VTK_SLICER_TRANSFORMS_MODULE_LOGIC_EXPORT vtkSlicerTransformLogic : public
   static bool GetVisualization2d(vtkPolyData* output_RAS, vtkMRMLTransformDisplayNode* displayNode,
     vtkMatrix4x4* sliceToRAS, double* fieldOfViewOrigin, double* fieldOfViewSize, vtkPoints* samplePositions_RAS = nullptr);
 
+#ifndef __VTK_WRAP__
+  /// Displacement magnitude samples that 2D contour visualization reuses while the slice is moved.
+  /// Samples are stored in a volume that is aligned with the slice. When the slice is moved along its normal
+  /// then a slab of slices around the new position is sampled, and contours of further slice positions
+  /// within the slab are computed by interpolating between the stored slices.
+  /// The volume is sampled again if the transform or the slice orientation, spacing, or field of view changes.
+  struct ContourVisualization2dCache
+  {
+    vtkSmartPointer<vtkImageData> MagnitudeVolume;
+    vtkSmartPointer<vtkMatrix4x4> MagnitudeVolumeIJKToRAS;
+    unsigned long TransformMTime{0};
+  };
+
+  /// Generate polydata for 2D transform visualization.
+  /// If contourCache is specified then contour visualization reuses displacement magnitudes
+  /// sampled for previous slice positions. Each view should use its own cache.
+  /// Return true on success.
+  static bool GetVisualization2d(vtkPolyData* output_RAS, vtkMRMLTransformDisplayNode* displayNode,
+    vtkMRMLSliceNode* sliceNode, vtkMRMLMarkupsNode* glyphPointsNode, ContourVisualization2dCache* contourCache);
+
+  /// Generate polydata for 2D transform visualization.
+  /// If contourCache is specified then contour visualization reuses displacement magnitudes
+  /// sampled for previous slice positions.
+  /// Return true on success.
+  static bool GetVisualization2d(vtkPolyData* output_RAS, vtkMRMLTransformDisplayNode* displayNode,
+    vtkMatrix4x4* sliceToRAS, double* fieldOfViewOrigin, double* fieldOfViewSize, vtkPoints* samplePositions_RAS,
+    ContourVisualization2dCache* contourCache);
+#endif
+
   /// Generate polydata for 3D transform visualization
   /// roiToRAS defines the ROI origin and direction.
   /// roiSize defines the ROI size (in the ROI coordinate system spacing)  .
@@ -109,8 +156,14 @@ class VTK_SLICER_TRANSFORMS_MODULE_LOGIC_EXPORT vtkSlicerTransformLogic : public
   /// Convert the input transform to a grid transform.
   /// If referenceVolumeNode is specified then it will determine the origin, spacing, extent, and orientation of the displacement field.
   /// If existingOutputTransformNode is specified then instead of creating a new transform node, that existing node will be updated.
+  /// If computeTransformToParent is true then the transform to world is sampled and stored as transform to parent
+  /// (precomputed inverse of the usual grid transform), so that transforming models, markups, and other point sets
+  /// does not require iterative inversion of the grid. By default the transform from world is sampled, which is
+  /// the direction used for resampling volumes.
+  /// The displacement field is computed by multiple threads. vtkCommand::ProgressEvent is invoked during
+  /// the computation and it can be cancelled by SetAbortProcessing(true), in which case nullptr is returned.
   vtkMRMLTransformNode* ConvertToGridTransform(vtkMRMLTransformNode* inputTransformNode, vtkMRMLVolumeNode* referenceVolumeNode = nullptr,
-    vtkMRMLTransformNode* existingOutputTransformNode = nullptr);
+    vtkMRMLTransformNode* existingOutputTransformNode = nullptr, bool computeTransformToParent = false);
 
   /// Take samples from the displacement field and store the magnitude in an image volume
   /// The extents of the output image must be set before calling this method.
@@ -177,6 +230,12 @@ protected:
   vtkSlicerTransformLogic(const vtkSlicerTransformLogic&);
   void operator=(const vtkSlicerTransformLogic&);
 
+  /// Invoke vtkCommand::ProgressEvent with the progress value (0..1).
+  /// Returns false if processing should be stopped.
+  bool ReportProgress(double progress);
+
+  bool AbortProcessing{false};
+
   /// Generate glyph for 2D transform visualization
   /// If samplePositions_RAS is specified then those samples will be used as glyph starting points instead of a regular grid.
   /// \sa GetVisualization2d
@@ -196,10 +255,13 @@ protected:
   /// \sa GetVisualization3d
   static void GetGridVisualization3d(vtkPolyData* output_RAS, vtkMRMLTransformDisplayNode* displayNode, vtkMatrix4x4* roiToRAS, int* roiSize);
 
+#ifndef __VTK_WRAP__
   /// Generate contours for 2D transform visualization
+  /// If contourCache is specified then displacement magnitudes are taken from the cache (and the cache is updated if needed).
   /// \sa GetVisualization2d
   static void GetContourVisualization2d(vtkPolyData* output_RAS, vtkMRMLTransformDisplayNode* displayNode, vtkMatrix4x4* sliceToRAS,
-    double* fieldOfViewOrigin, double* fieldOfViewSize);
+    double* fieldOfViewOrigin, double* fieldOfViewSize, ContourVisualization2dCache* contourCache = nullptr);
+#endif
   /// Generate contours for 3D transform visualization
   /// \sa GetVisualization3d
   static void GetContourVisualization3d(vtkPolyData* output_RAS, vtkMRMLTransformDisplayNode* displayNode, vtkMatrix4x4* roiToRAS, int* roiSize);
@@ -23,6 +23,7 @@
 #include <QFileDialog>
 #include <QApplication>
 #include <QClipboard>
+#include <QProgressDialog>
 #include <QStringBuilder>
 #include <QTableWidgetItem>
 
@@ -48,6 +49,7 @@
 
 // VTK includes
 #include <vtkAddonMathUtilities.h>
+#include <vtkCommand.h>
 #include <vtkNew.h>
 #include <vtkSmartPointer.h>
 #include <vtkTransform.h>
@@ -65,6 +67,8 @@ public:
   vtkMRMLTransformNode*         MRMLTransformNode;
   QAction*                      CopyAction;
   QAction*                      PasteAction;
+  QProgressDialog*              ProgressDialog;
+  int                           ProgressOffset;
 };
 
 //-----------------------------------------------------------------------------
@@ -74,6 +78,8 @@ qSlicerTransformsModuleWidgetPrivate::qSlicerTransformsModuleWidgetPrivate(qSlic
   this->MRMLTransformNode = nullptr;
   this->CopyAction = nullptr;
   this->PasteAction = nullptr;
+  this->ProgressDialog = nullptr;
+  this->ProgressOffset = 0;
 }
 //-----------------------------------------------------------------------------
 vtkSlicerTransformLogic* qSlicerTransformsModuleWidgetPrivate::logic()const
@@ -509,12 +515,23 @@ void qSlicerTransformsModuleWidget::hardenSelectedNodes()
   Q_D(qSlicerTransformsModuleWidget);
   QList<vtkSmartPointer<vtkMRMLTransformableNode> > nodesToTransform =
     qSlicerTransformsModuleWidgetPrivate::getSelectedNodes(d->TransformedTreeView);
-  QApplication::setOverrideCursor(QCursor(Qt::BusyCursor));
+  // Hardening non-linear transforms on large models may take a long time, show progress (100 steps per node)
+  QProgressDialog progressDialog(tr("Hardening transforms..."), tr("Cancel"), 0, 100 * nodesToTransform.size(), this);
+  progressDialog.setWindowModality(Qt::WindowModal);
+  progressDialog.setMinimumDuration(1000);
+  d->ProgressDialog = &progressDialog;
+  qvtkConnect(d->logic(), vtkCommand::ProgressEvent, this, SLOT(onLogicProgress(vtkObject*, void*)));
+  d->ProgressOffset = 0;
   foreach(vtkSmartPointer<vtkMRMLTransformableNode> node, nodesToTransform)
     {
-    d->logic()->hardenTransform(vtkMRMLTransformableNode::SafeDownCast(node));
+    if (!d->logic()->HardenTransformWithProgress(node) && d->logic()->GetAbortProcessing())
+      {
+      break;
+      }
+    d->ProgressOffset += 100;
     }
-  QApplication::restoreOverrideCursor();
+  qvtkDisconnect(d->logic(), vtkCommand::ProgressEvent, this, SLOT(onLogicProgress(vtkObject*, void*)));
+  d->ProgressDialog = nullptr;
 }
 
 //-----------------------------------------------------------------------------
@@ -590,7 +607,15 @@ void qSlicerTransformsModuleWidget::convert()
     }
   else if (outputTransformNode)
     {
+    QProgressDialog progressDialog(tr("Computing displacement field..."), tr("Cancel"), 0, 100, this);
+    progressDialog.setWindowModality(Qt::WindowModal);
+    progressDialog.setMinimumDuration(1000);
+    d->ProgressDialog = &progressDialog;
+    d->ProgressOffset = 0;
+    qvtkConnect(d->logic(), vtkCommand::ProgressEvent, this, SLOT(onLogicProgress(vtkObject*, void*)));
     d->logic()->ConvertToGridTransform(d->MRMLTransformNode, referenceVolumeNode, outputTransformNode);
+    qvtkDisconnect(d->logic(), vtkCommand::ProgressEvent, this, SLOT(onLogicProgress(vtkObject*, void*)));
+    d->ProgressDialog = nullptr;
     }
   else
     {
@@ -599,6 +624,23 @@ void qSlicerTransformsModuleWidget::convert()
   QApplication::restoreOverrideCursor();
 }
 
+//-----------------------------------------------------------------------------
+void qSlicerTransformsModuleWidget::onLogicProgress(vtkObject* vtkNotUsed(caller), void* callData)
+{
+  Q_D(qSlicerTransformsModuleWidget);
+  double* progress = reinterpret_cast<double*>(callData);
+  if (!d->ProgressDialog || !progress)
+    {
+    return;
+    }
+  // Setting the value of a modal progress dialog processes events, which allows pressing Cancel
+  d->ProgressDialog->setValue(d->ProgressOffset + static_cast<int>(*progress * 100.0));
+  if (d->ProgressDialog->wasCanceled())
+    {
+    d->logic()->SetAbortProcessing(true);
+    }
+}
+
 //-----------------------------------------------------------------------------
 void qSlicerTransformsModuleWidget::updateConvertButtonState()
 {
@@ -82,6 +82,9 @@ protected slots:
   void updateConvertButtonState();
   void convert();
 
+  /// Update the progress dialog from vtkCommand::ProgressEvent of the logic
+  void onLogicProgress(vtkObject* caller, void* callData);
+
 protected:
   ///
   /// Convenient method to return the coordinate system currently selected
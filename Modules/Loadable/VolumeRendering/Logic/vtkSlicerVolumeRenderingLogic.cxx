@@ -43,6 +43,7 @@
 
 // VTK includes
 #include <vtkColorTransferFunction.h>
+#include <vtkDataArray.h>
 #include <vtkImageData.h>
 #include <vtkLookupTable.h>
 #include <vtkNew.h>
@@ -948,6 +949,48 @@ vtkMRMLVolumeRenderingDisplayNode* vtkSlicerVolumeRenderingLogic::GetFirstVolume
   return nullptr;
 }
 
+//----------------------------------------------------------------------------
+vtkIdType vtkSlicerVolumeRenderingLogic::EstimateGPUTextureMemorySize(
+  vtkMRMLVolumeRenderingDisplayNode* displayNode, int* numberOfViews/*=nullptr*/)
+{
+  if (numberOfViews)
+    {
+    *numberOfViews = 0;
+    }
+  if (!displayNode || !displayNode->GetScene() || !displayNode->GetVisibility()
+    || !(displayNode->IsA("vtkMRMLGPURayCastVolumeRenderingDisplayNode")
+      || displayNode->IsA("vtkMRMLMultiVolumeRenderingDisplayNode")))
+    {
+    return 0;
+    }
+  vtkMRMLVolumeNode* volumeNode = displayNode->GetVolumeNode();
+  vtkImageData* imageData = volumeNode ? volumeNode->GetImageData() : nullptr;
+  if (!imageData || !imageData->GetPointData() || !imageData->GetPointData()->GetScalars())
+    {
+    return 0;
+    }
+  // Textures store at most 32 bits per component (double scalars are uploaded as float)
+  vtkDataArray* scalars = imageData->GetPointData()->GetScalars();
+  vtkIdType bytesPerVoxel = scalars->GetNumberOfComponents() * std::min(scalars->GetDataTypeSize(), 4);
+  vtkIdType textureSize = imageData->GetNumberOfPoints() * bytesPerVoxel;
+
+  int viewCount = 0;
+  std::vector<vtkMRMLNode*> viewNodes;
+  displayNode->GetScene()->GetNodesByClass("vtkMRMLViewNode", viewNodes);
+  for (vtkMRMLNode* viewNode : viewNodes)
+    {
+    if (displayNode->IsDisplayableInView(viewNode->GetID()))
+      {
+      viewCount++;
+      }
+    }
+  if (numberOfViews)
+    {
+    *numberOfViews = viewCount;
+    }
+  return textureSize * viewCount;
+}
+
 // Description:
 // Find volume rendering display node referencing the view node and volume node
 //----------------------------------------------------------------------------
@@ -258,6 +258,15 @@ public:
   /// Find first volume rendering display node
   vtkMRMLVolumeRenderingDisplayNode* GetFirstVolumeRenderingDisplayNode(vtkMRMLVolumeNode *volumeNode);
 
+  /// Estimate graphics memory used by the textures of the volume rendered by GPU ray casting.
+  /// Each 3D view has its own rendering context and uploads its own copy of the volume
+  /// to the graphics card, therefore the estimate is the texture size multiplied by the
+  /// number of views where the volume is visible. The volume image in CPU memory is
+  /// shared between slice views and volume rendering, it is not included.
+  /// If \a numberOfViews is not nullptr then it is set to the number of views.
+  /// Returns 0 for CPU rendering methods.
+  vtkIdType EstimateGPUTextureMemorySize(vtkMRMLVolumeRenderingDisplayNode* displayNode, int* numberOfViews = nullptr);
+
   /// Find the first volume rendering display node that uses the ROI
   vtkMRMLVolumeRenderingDisplayNode* GetFirstVolumeRenderingDisplayNodeByROINode(vtkMRMLAnnotationROINode* roiNode);
 
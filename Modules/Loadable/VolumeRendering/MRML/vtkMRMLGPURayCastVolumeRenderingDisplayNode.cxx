@@ -39,20 +39,49 @@ vtkMRMLGPURayCastVolumeRenderingDisplayNode::~vtkMRMLGPURayCastVolumeRenderingDi
 //----------------------------------------------------------------------------
 void vtkMRMLGPURayCastVolumeRenderingDisplayNode::ReadXMLAttributes(const char** atts)
 {
+  int wasModifying = this->StartModify();
   this->Superclass::ReadXMLAttributes(atts);
 
-//  vtkMRMLReadXMLBeginMacro(atts);
-//  vtkMRMLReadXMLEndMacro();
+  vtkMRMLReadXMLBeginMacro(atts);
+  vtkMRMLReadXMLBooleanMacro(autoPartitioning, AutoPartitioning);
+  vtkMRMLReadXMLBooleanMacro(emptySpaceSkipping, EmptySpaceSkipping);
+  vtkMRMLReadXMLEndMacro();
+
+  this->EndModify(wasModifying);
 }
 
 //----------------------------------------------------------------------------
 void vtkMRMLGPURayCastVolumeRenderingDisplayNode::WriteXML(ostream& of, int nIndent)
 {
   this->Superclass::WriteXML(of, nIndent);
+
+  vtkMRMLWriteXMLBeginMacro(of);
+  vtkMRMLWriteXMLBooleanMacro(autoPartitioning, AutoPartitioning);
+  vtkMRMLWriteXMLBooleanMacro(emptySpaceSkipping, EmptySpaceSkipping);
+  vtkMRMLWriteXMLEndMacro();
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLGPURayCastVolumeRenderingDisplayNode::Copy(vtkMRMLNode *anode)
+{
+  int wasModifying = this->StartModify();
+  this->Superclass::Copy(anode);
+
+  vtkMRMLCopyBeginMacro(anode);
+  vtkMRMLCopyBooleanMacro(AutoPartitioning);
+  vtkMRMLCopyBooleanMacro(EmptySpaceSkipping);
+  vtkMRMLCopyEndMacro();
+
+  this->EndModify(wasModifying);
 }
 
 //----------------------------------------------------------------------------
 void vtkMRMLGPURayCastVolumeRenderingDisplayNode::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os,indent);
+
+  vtkMRMLPrintBeginMacro(os, indent);
+  vtkMRMLPrintBooleanMacro(AutoPartitioning);
+  vtkMRMLPrintBooleanMacro(EmptySpaceSkipping);
+  vtkMRMLPrintEndMacro();
 }
@@ -49,15 +49,41 @@ public:
   /// \sa vtkMRMLNode::CopyContent
   vtkMRMLCopyContentDefaultMacro(vtkMRMLGPURayCastVolumeRenderingDisplayNode);
 
+  // Description:
+  // Copy the node's attributes to this object
+  void Copy(vtkMRMLNode *node) override;
+
   // Description:
   // Get node XML tag name (like Volume, Model)
   const char* GetNodeTagName() override {return "GPURayCastVolumeRendering";}
 
+  /// Render volumes that do not fit into the GPU memory size of the view
+  /// (vtkMRMLViewNode::GetGPUMemorySize) in bricks: the volume is split into
+  /// partitions that are uploaded and rendered one after the other.
+  /// Rendering is slower than with a single texture, but large volumes can be rendered
+  /// with the GPU instead of failing or falling back to CPU rendering.
+  /// Disabled by default.
+  vtkSetMacro(AutoPartitioning, bool);
+  vtkGetMacro(AutoPartitioning, bool);
+  vtkBooleanMacro(AutoPartitioning, bool);
+
+  /// Skip space that is fully transparent with the current scalar opacity function.
+  /// Minimum and maximum voxel values are computed in blocks of voxels when the volume
+  /// changes, and rays are only cast within the bounding box of blocks that contain
+  /// any visible value. Only applies to single-component volumes.
+  /// Disabled by default.
+  vtkSetMacro(EmptySpaceSkipping, bool);
+  vtkGetMacro(EmptySpaceSkipping, bool);
+  vtkBooleanMacro(EmptySpaceSkipping, bool);
+
 protected:
   vtkMRMLGPURayCastVolumeRenderingDisplayNode();
   ~vtkMRMLGPURayCastVolumeRenderingDisplayNode() override;
   vtkMRMLGPURayCastVolumeRenderingDisplayNode(const vtkMRMLGPURayCastVolumeRenderingDisplayNode&);
   void operator=(const vtkMRMLGPURayCastVolumeRenderingDisplayNode&);
+
+  bool AutoPartitioning{false};
+  bool EmptySpaceSkipping{false};
 };
 
 #endif
@@ -18,6 +18,44 @@
 #include <limits>
 #include <sstream>
 
+namespace
+{
+
+//----------------------------------------------------------------------------
+/// Copy a transfer function into an existing one if they are different.
+/// Keeping the function object, and its modification time when there is no change,
+/// allows renderers to reuse their shaders and uploaded transfer function textures.
+template <class FunctionType, int NodeSize>
+void CopyFunctionIfDifferent(FunctionType* source, FunctionType* target)
+{
+  bool different = (source->GetSize() != target->GetSize() || source->GetClamping() != target->GetClamping());
+  for (int nodeIndex = 0; !different && nodeIndex < source->GetSize(); ++nodeIndex)
+    {
+    double sourceNode[NodeSize];
+    double targetNode[NodeSize];
+    source->GetNodeValue(nodeIndex, sourceNode);
+    target->GetNodeValue(nodeIndex, targetNode);
+    different = !std::equal(sourceNode, sourceNode + NodeSize, targetNode);
+    }
+  if (different)
+    {
+    target->DeepCopy(source);
+    }
+}
+
+//----------------------------------------------------------------------------
+void CopyColorFunctionIfDifferent(vtkColorTransferFunction* source, vtkColorTransferFunction* target)
+{
+  if (source->GetColorSpace() != target->GetColorSpace() || source->GetHSVWrap() != target->GetHSVWrap())
+    {
+    target->DeepCopy(source);
+    return;
+    }
+  CopyFunctionIfDifferent<vtkColorTransferFunction, 6>(source, target);
+}
+
+} // end of anonymous namespace
+
 //----------------------------------------------------------------------------
 vtkMRMLNodeNewMacro(vtkMRMLVolumePropertyNode);
 
@@ -162,22 +200,15 @@ void vtkMRMLVolumePropertyNode::CopyParameterSet(vtkMRMLNode *anode)
     this->VolumeProperty->SetComponentWeight(i,node->GetVolumeProperty()->GetComponentWeight(i));
     //TODO: No set method for GrayTransferFunction, ColorChannels, and DefaultGradientOpacity
 
-    // Transfer functions
-    vtkColorTransferFunction* rgbTransfer = vtkColorTransferFunction::New();
-    rgbTransfer->DeepCopy(node->GetVolumeProperty()->GetRGBTransferFunction(i));
-    this->SetColor(rgbTransfer, i);
-    rgbTransfer->Delete();
-
-    vtkPiecewiseFunction* scalar = vtkPiecewiseFunction::New();
-    scalar->DeepCopy(node->GetVolumeProperty()->GetScalarOpacity(i));
-    this->SetScalarOpacity(scalar, i);
-    scalar->Delete();
+    // Transfer functions. Existing functions are updated in place (e.g., when switching presets)
+    // so that renderers do not need to rebuild shaders and re-upload unchanged transfer functions.
+    CopyColorFunctionIfDifferent(node->GetVolumeProperty()->GetRGBTransferFunction(i),
+      this->VolumeProperty->GetRGBTransferFunction(i));
+    CopyFunctionIfDifferent<vtkPiecewiseFunction, 4>(node->GetVolumeProperty()->GetScalarOpacity(i),
+      this->VolumeProperty->GetScalarOpacity(i));
     this->VolumeProperty->SetScalarOpacityUnitDistance(i,this->VolumeProperty->GetScalarOpacityUnitDistance(i));
-
-    vtkPiecewiseFunction* gradient = vtkPiecewiseFunction::New();
-    gradient->DeepCopy(node->GetVolumeProperty()->GetGradientOpacity(i));
-    this->SetGradientOpacity(gradient, i);
-    gradient->Delete();
+    CopyFunctionIfDifferent<vtkPiecewiseFunction, 4>(node->GetVolumeProperty()->GetGradientOpacity(i),
+      this->VolumeProperty->GetGradientOpacity(i));
 
     // Lighting
     this->VolumeProperty->SetDisableGradientOpacity(i,node->GetVolumeProperty()->GetDisableGradientOpacity(i));
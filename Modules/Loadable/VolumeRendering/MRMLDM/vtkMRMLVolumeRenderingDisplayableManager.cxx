@@ -19,6 +19,8 @@
 
 ==============================================================================*/
 
+#include "vtkSlicerConfigure.h" // Slicer_VTK_RENDERING_USE_{OpenGL|OpenGL2}_BACKEND
+
 // Volume Rendering includes
 #include "vtkMRMLVolumeRenderingDisplayableManager.h"
 
@@ -48,22 +50,122 @@
 #include <vtkInteractorStyle.h>
 #include <vtkMatrix4x4.h>
 #include <vtkPlane.h>
+#include <vtkPlaneCollection.h>
 #include <vtkPlanes.h>
 #include <vtkRenderWindow.h>
 #include <vtkRenderWindowInteractor.h>
 #include <vtkRenderer.h>
+#include <vtkTimerLog.h>
 #if VTK_MAJOR_VERSION >= 9 || (VTK_MAJOR_VERSION >= 8 && VTK_MINOR_VERSION >= 2)
 #include <vtkMultiVolume.h>
 #endif
 #include <vtkVolume.h>
 #include <vtkVolumeProperty.h>
 #include <vtkDoubleArray.h>
+#include <vtkExtractVOI.h>
 #include <vtkVolumePicker.h>
+#if defined(Slicer_VTK_RENDERING_USE_OpenGL2_BACKEND)
+#include <vtkOpenGLGPUVolumeRayCastMapper.h>
+#endif
+#include <vtkPointData.h>
+#include <vtkSMPTools.h>
 
 #include <vtkImageData.h> //TODO: Used for workaround. Remove when fixed
 #include <vtkTrivialProducer.h> //TODO: Used for workaround. Remove when fixed
 #include <vtkPiecewiseFunction.h> //TODO: Used for workaround. Remove when fixed
 
+// STD includes
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace
+{
+
+//---------------------------------------------------------------------------
+/// Compute minimum and maximum of the first scalar component in macro-cells of
+/// cellSize^3 voxels. Neighbor cells share their boundary voxels, so that all voxels
+/// that are interpolated for a sample inside a cell are taken into account.
+template <class T>
+void ComputeMacroCellRanges(const T* scalars, const int dimensions[3], int numberOfComponents,
+  int cellSize, const int gridDimensions[3], std::vector<double>& minimums, std::vector<double>& maximums)
+{
+  vtkSMPTools::For(0, gridDimensions[2], [&](vtkIdType beginCellK, vtkIdType endCellK)
+    {
+    for (vtkIdType cellK = beginCellK; cellK < endCellK; ++cellK)
+      {
+      for (int cellJ = 0; cellJ < gridDimensions[1]; ++cellJ)
+        {
+        for (int cellI = 0; cellI < gridDimensions[0]; ++cellI)
+          {
+          double minimum = VTK_DOUBLE_MAX;
+          double maximum = VTK_DOUBLE_MIN;
+          int kEnd = std::min(int(cellK + 1) * cellSize, dimensions[2] - 1);
+          int jEnd = std::min((cellJ + 1) * cellSize, dimensions[1] - 1);
+          int iBegin = cellI * cellSize;
+          int iEnd = std::min((cellI + 1) * cellSize, dimensions[0] - 1);
+          for (int k = int(cellK) * cellSize; k <= kEnd; ++k)
+            {
+            for (int j = cellJ * cellSize; j <= jEnd; ++j)
+              {
+              const T* voxel = scalars + ((vtkIdType(k) * dimensions[1] + j) * dimensions[0] + iBegin) * numberOfComponents;
+              for (int i = iBegin; i <= iEnd; ++i, voxel += numberOfComponents)
+                {
+                double value = static_cast<double>(*voxel);
+                minimum = std::min(minimum, value);
+                maximum = std::max(maximum, value);
+                }
+              }
+            }
+          vtkIdType cellIndex = (cellK * gridDimensions[1] + cellJ) * gridDimensions[0] + cellI;
+          minimums[cellIndex] = minimum;
+          maximums[cellIndex] = maximum;
+          }
+        }
+      }
+    });
+}
+
+//---------------------------------------------------------------------------
+/// Largest value of a piecewise function in a closed range. The function is
+/// monotonic between nodes, so only nodes and range endpoints need to be evaluated.
+double GetMaximumValueInRange(vtkPiecewiseFunction* function, double rangeMin, double rangeMax)
+{
+  double maximum = std::max(function->GetValue(rangeMin), function->GetValue(rangeMax));
+  double node[4] = { 0.0, 0.0, 0.0, 0.0 };
+  for (int nodeIndex = 0; nodeIndex < function->GetSize(); ++nodeIndex)
+    {
+    function->GetNodeValue(nodeIndex, node);
+    if (node[0] > rangeMin && node[0] < rangeMax)
+      {
+      maximum = std::max(maximum, node[1]);
+      }
+    }
+  return maximum;
+}
+
+//---------------------------------------------------------------------------
+/// Return true if the function evaluates to 1 everywhere.
+bool IsConstantOneFunction(vtkPiecewiseFunction* function)
+{
+  if (!function || function->GetSize() == 0 || !function->GetClamping())
+    {
+    return false;
+    }
+  double node[4] = { 0.0, 0.0, 0.0, 0.0 };
+  for (int nodeIndex = 0; nodeIndex < function->GetSize(); ++nodeIndex)
+    {
+    function->GetNodeValue(nodeIndex, node);
+    if (node[1] != 1.0)
+      {
+      return false;
+      }
+    }
+  return true;
+}
+
+} // end of anonymous namespace
+
 //---------------------------------------------------------------------------
 vtkStandardNewMacro(vtkMRMLVolumeRenderingDisplayableManager);
 
@@ -112,6 +214,29 @@ public:
       this->RayCastMapperGPU = vtkSmartPointer<vtkGPUVolumeRayCastMapper>::New();
     }
     vtkSmartPointer<vtkGPUVolumeRayCastMapper> RayCastMapperGPU;
+    /// Number of bricks along each axis that the volume is rendered in
+    int Partitions[3] = { 1, 1, 1 };
+
+    /// Scalar range of macro-cells of the rendered volume, used for skipping transparent space.
+    /// Only depends on the image data, therefore it is reused when the volume property changes.
+    vtkWeakPointer<vtkImageData> MacroCellImageData;
+    vtkMTimeType MacroCellImageMTime = 0;
+    int MacroCellGridDimensions[3] = { 0, 0, 0 };
+    std::vector<double> MacroCellMinimums;
+    std::vector<double> MacroCellMaximums;
+    /// Box of macro-cells that are not fully transparent, in macro-cell indices.
+    /// Only depends on the macro-cell ranges and the opacity function, therefore it
+    /// is reused when only the camera, the ROI or other display properties change.
+    vtkWeakPointer<vtkPiecewiseFunction> OpaqueCellBoxOpacityFunction;
+    vtkMTimeType OpaqueCellBoxOpacityMTime = 0;
+    bool OpaqueCellBoxValid = false;
+    int OpaqueCellBox[6] = { 0, -1, 0, -1, 0, -1 };
+
+    /// Extracts the part of the volume that is inside the cropping ROI, so that only
+    /// that part is uploaded to the GPU. Extent is kept while the ROI is inside it
+    /// to avoid re-uploading the texture on every ROI change.
+    vtkSmartPointer<vtkExtractVOI> CroppedVolumeExtractor;
+    int CroppedVolumeExtent[6] = { 0, -1, 0, -1, 0, -1 };
   };
   //-------------------------------------------------------------------------
   class PipelineMultiVolume : public Pipeline
@@ -123,6 +248,8 @@ public:
     }
 
     unsigned int ActorPortIndex;
+    /// Volume is connected to the multi-volume mapper and actor
+    bool ConnectedToMultiVolume{false};
   };
 
   //-------------------------------------------------------------------------
@@ -155,8 +282,29 @@ public:
 
   double GetFramerate();
   vtkIdType GetMaxMemoryInBytes(vtkMRMLVolumeRenderingDisplayNode* displayNode);
+  /// Set the number of bricks the uploaded volume is split into.
+  /// Must be called after GetGPUInputConnection(), which sets the uploaded extent.
+  void UpdateGPUPartitions(vtkMRMLGPURayCastVolumeRenderingDisplayNode* displayNode,
+    vtkMRMLVolumeNode* volumeNode, const Pipeline* pipeline);
+  void UpdateEmptySpaceSkipping(vtkMRMLGPURayCastVolumeRenderingDisplayNode* displayNode,
+    vtkMRMLVolumeNode* volumeNode, const Pipeline* pipeline);
+  /// Get the mapper input: the full volume, or only the part of it inside the cropping ROI.
+  vtkAlgorithmOutput* GetGPUInputConnection(vtkMRMLGPURayCastVolumeRenderingDisplayNode* displayNode,
+    vtkMRMLVolumeNode* volumeNode, const Pipeline* pipeline);
   void UpdateDesiredUpdateRate(vtkMRMLVolumeRenderingDisplayNode* displayNode);
 
+  // Adaptive quality
+  // Sample distances are adjusted based on the measured render time to keep the
+  // requested frame rate during interaction, and refined to full quality when idle.
+  static void OnRenderEvent(vtkObject* caller, unsigned long eid, void* clientData, void* callData);
+  void ObserveRenderer();
+  void UnobserveRenderer();
+  bool IsInteracting();
+  void UpdateAdaptiveQuality();
+  void SetQualityReduction(double qualityReduction);
+  void GetAdaptiveQualityParameters(double& sampleDistanceScale, double& imageSampleDistance);
+  void ApplyAdaptiveQuality(vtkMRMLVolumeRenderingDisplayNode* displayNode, vtkVolumeMapper* mapper);
+
   // Observations
   void AddObservations(vtkMRMLVolumeNode* node);
   void RemoveObservations(vtkMRMLVolumeNode* node);
@@ -191,6 +339,18 @@ public:
   /// When interaction is >0, we are in interactive mode (low level of detail)
   int Interaction;
 
+  /// Camera is being manipulated in the view
+  bool CameraInteraction{false};
+
+  /// Current reduction of the rendering cost in adaptive quality mode (1 = full quality)
+  double QualityReduction{1.0};
+  /// Reduction that kept the frame rate at the last interaction, used when the next interaction starts
+  double InteractiveQualityReduction{1.0};
+  /// Time when rendering of the current frame started
+  double RenderStartTime{0.0};
+  vtkSmartPointer<vtkCallbackCommand> RenderCallbackCommand;
+  vtkWeakPointer<vtkRenderer> ObservedRenderer;
+
   /// Picker of volume in renderer
   vtkSmartPointer<vtkVolumePicker> VolumePicker;
 
@@ -251,12 +411,17 @@ vtkMRMLVolumeRenderingDisplayableManager::vtkInternal::vtkInternal(vtkMRMLVolume
 
   this->VolumePicker = vtkSmartPointer<vtkVolumePicker>::New();
   this->VolumePicker->SetTolerance(0.005);
+
+  this->RenderCallbackCommand = vtkSmartPointer<vtkCallbackCommand>::New();
+  this->RenderCallbackCommand->SetClientData(this);
+  this->RenderCallbackCommand->SetCallback(vtkInternal::OnRenderEvent);
 }
 
 //---------------------------------------------------------------------------
 vtkMRMLVolumeRenderingDisplayableManager::vtkInternal::~vtkInternal()
 {
   this->ClearDisplayableNodes();
+  this->UnobserveRenderer();
 
   if (this->DisplayObservedEvents)
     {
@@ -622,8 +787,12 @@ vtkMRMLVolumeRenderingDisplayableManager::vtkInternal::RemovePipelineIt(Pipeline
     if (pipelineMulti)
       {
       // Remove volume actor from multi-volume actor collection
-      this->MultiVolumeMapper->RemoveInputConnection(pipelineMulti->ActorPortIndex, 0);
-      this->MultiVolumeActor->RemoveVolume(pipelineMulti->ActorPortIndex);
+      if (pipelineMulti->ConnectedToMultiVolume)
+        {
+        this->MultiVolumeMapper->RemoveInputConnection(pipelineMulti->ActorPortIndex, 0);
+        this->MultiVolumeActor->RemoveVolume(pipelineMulti->ActorPortIndex);
+        pipelineMulti->ConnectedToMultiVolume = false;
+        }
 
       // Remove common actor from renderer and local cache if the last volume have been removed
       bool foundMultiVolumeActor = false;
@@ -779,13 +948,21 @@ void vtkMRMLVolumeRenderingDisplayableManager::vtkInternal::UpdateDisplayNodePip
       {
       if (displayNodeVisible)
         {
-        this->MultiVolumeMapper->SetInputConnection(pipelineMulti->ActorPortIndex, volumeNode->GetImageDataConnection());
-        this->MultiVolumeActor->SetVolume(pipelineMulti->VolumeActor, pipelineMulti->ActorPortIndex);
+        // Changing inputs makes the mapper rebuild its shader and upload all volume textures,
+        // which becomes very slow with several volumes, therefore only reconnect if needed
+        if (!pipelineMulti->ConnectedToMultiVolume
+          || this->MultiVolumeMapper->GetInputConnection(pipelineMulti->ActorPortIndex, 0) != volumeNode->GetImageDataConnection())
+          {
+          this->MultiVolumeMapper->SetInputConnection(pipelineMulti->ActorPortIndex, volumeNode->GetImageDataConnection());
+          this->MultiVolumeActor->SetVolume(pipelineMulti->VolumeActor, pipelineMulti->ActorPortIndex);
+          pipelineMulti->ConnectedToMultiVolume = true;
+          }
         }
-      else
+      else if (pipelineMulti->ConnectedToMultiVolume)
         {
         this->MultiVolumeMapper->RemoveInputConnection(pipelineMulti->ActorPortIndex, 0);
         this->MultiVolumeActor->RemoveVolume(pipelineMulti->ActorPortIndex);
+        pipelineMulti->ConnectedToMultiVolume = false;
         }
 
       // Workaround: if none of the volumes are visible then VTK renders a gray box,
@@ -825,7 +1002,7 @@ void vtkMRMLVolumeRenderingDisplayableManager::vtkInternal::UpdateDisplayNodePip
     switch (viewNode->GetRaycastTechnique())
       {
       case vtkMRMLViewNode::Adaptive:
-        cpuMapper->SetAutoAdjustSampleDistances(true);
+        cpuMapper->SetAutoAdjustSampleDistances(false);
         cpuMapper->SetLockSampleDistanceToInputSpacing(false);
         cpuMapper->SetImageSampleDistance(1.0);
         break;
@@ -843,6 +1020,10 @@ void vtkMRMLVolumeRenderingDisplayableManager::vtkInternal::UpdateDisplayNodePip
 
     cpuMapper->SetSampleDistance(displayNode->GetSampleDistance());
     cpuMapper->SetInteractiveSampleDistance(displayNode->GetSampleDistance());
+    if (viewNode->GetVolumeRenderingQuality() == vtkMRMLViewNode::Adaptive)
+      {
+      this->ApplyAdaptiveQuality(displayNode, cpuMapper);
+      }
 
     // Make sure the correct mapper is set to the volume
     pipeline->VolumeActor->SetMapper(mapper);
@@ -862,7 +1043,7 @@ void vtkMRMLVolumeRenderingDisplayableManager::vtkInternal::UpdateDisplayNodePip
     switch (viewNode->GetVolumeRenderingQuality())
       {
       case vtkMRMLViewNode::Adaptive:
-        gpuMapper->SetAutoAdjustSampleDistances(true);
+        gpuMapper->SetAutoAdjustSampleDistances(false);
         gpuMapper->SetLockSampleDistanceToInputSpacing(false);
         gpuMapper->SetUseJittering(viewNode->GetVolumeRenderingSurfaceSmoothing());
         break;
@@ -870,24 +1051,34 @@ void vtkMRMLVolumeRenderingDisplayableManager::vtkInternal::UpdateDisplayNodePip
         gpuMapper->SetAutoAdjustSampleDistances(false);
         gpuMapper->SetLockSampleDistanceToInputSpacing(true);
         gpuMapper->SetUseJittering(viewNode->GetVolumeRenderingSurfaceSmoothing());
+        gpuMapper->SetImageSampleDistance(1.0);
         break;
       case vtkMRMLViewNode::Maximum:
         gpuMapper->SetAutoAdjustSampleDistances(false);
         gpuMapper->SetLockSampleDistanceToInputSpacing(false);
         gpuMapper->SetUseJittering(viewNode->GetVolumeRenderingSurfaceSmoothing());
+        gpuMapper->SetImageSampleDistance(1.0);
         break;
       }
 
     gpuMapper->SetSampleDistance(gpuDisplayNode->GetSampleDistance());
+    if (viewNode->GetVolumeRenderingQuality() == vtkMRMLViewNode::Adaptive)
+      {
+      this->ApplyAdaptiveQuality(gpuDisplayNode, gpuMapper);
+      }
     gpuMapper->SetMaxMemoryInBytes(this->GetMaxMemoryInBytes(gpuDisplayNode));
+    // Partitions depend on the extent that is uploaded, which is set by GetGPUInputConnection
+    vtkAlgorithmOutput* inputConnection = this->GetGPUInputConnection(gpuDisplayNode, volumeNode, pipeline);
+    this->UpdateGPUPartitions(gpuDisplayNode, volumeNode, pipeline);
+    this->UpdateEmptySpaceSkipping(gpuDisplayNode, volumeNode, pipeline);
 
     // Make sure the correct mapper is set to the volume
     pipeline->VolumeActor->SetMapper(mapper);
     // Make sure the correct volume is set to the mapper
     // Reconnection is expensive operation, therefore only do it if needed
-    if (mapper->GetInputConnection(0, 0) != volumeNode->GetImageDataConnection())
+    if (mapper->GetInputConnection(0, 0) != inputConnection)
       {
-      mapper->SetInputConnection(0, volumeNode->GetImageDataConnection());
+      mapper->SetInputConnection(0, inputConnection);
       }
     }
   else if (displayNode->IsA("vtkMRMLMultiVolumeRenderingDisplayNode"))
@@ -899,7 +1090,7 @@ void vtkMRMLVolumeRenderingDisplayableManager::vtkInternal::UpdateDisplayNodePip
     switch (viewNode->GetRaycastTechnique())
       {
       case vtkMRMLViewNode::Adaptive:
-        gpuMultiMapper->SetAutoAdjustSampleDistances(true);
+        gpuMultiMapper->SetAutoAdjustSampleDistances(false);
         gpuMultiMapper->SetLockSampleDistanceToInputSpacing(false);
         gpuMultiMapper->SetUseJittering(viewNode->GetVolumeRenderingSurfaceSmoothing());
         break;
@@ -943,10 +1134,31 @@ void vtkMRMLVolumeRenderingDisplayableManager::vtkInternal::UpdateDisplayNodePip
 
   // Set volume property
   vtkVolumeProperty* volumeProperty = displayNode->GetVolumePropertyNode() ? displayNode->GetVolumePropertyNode()->GetVolumeProperty() : nullptr;
+#if VTK_MAJOR_VERSION >= 9
+  if (volumeProperty)
+    {
+    // Default gradient opacity is constant 1, which does not change the rendering. Ray casting would still
+    // compute the gradient and look up the gradient opacity at every sample, so it is disabled in this case.
+    volumeProperty->SetDisableGradientOpacity(IsConstantOneFunction(volumeProperty->GetGradientOpacity()));
+    }
+#endif
   pipeline->VolumeActor->SetProperty(volumeProperty);
   // vtkMultiVolume's GetProperty returns the volume property from the first volume actor, and that is used when assembling the
-  // shader, so need to set the volume property to the the first volume actor (in this case dummy actor, see above TODO)
-  if (this->MultiVolumeActor)
+  // shader, so need to set the volume property to the the first volume actor (in this case dummy actor, see above TODO).
+  // Always use the property of the same volume (lowest port) so that the shader is not rebuilt when
+  // another volume is updated.
+  const PipelineMultiVolume* pipelineMulti = dynamic_cast<const PipelineMultiVolume*>(pipeline);
+  bool firstMultiVolume = (pipelineMulti != nullptr);
+  for (Pipeline* otherPipeline : this->DisplayPipelines)
+    {
+    const PipelineMultiVolume* otherPipelineMulti = dynamic_cast<const PipelineMultiVolume*>(otherPipeline);
+    if (firstMultiVolume && otherPipelineMulti && otherPipelineMulti->ConnectedToMultiVolume
+      && otherPipelineMulti->ActorPortIndex < pipelineMulti->ActorPortIndex)
+      {
+      firstMultiVolume = false;
+      }
+    }
+  if (this->MultiVolumeActor && firstMultiVolume)
     {
     double* multiVolumeBounds = this->MultiVolumeActor->GetBounds();
     if (multiVolumeBounds[0] < multiVolumeBounds[1]) // Prevent error that GetVolume throws if volume is null (TODO: need GetNumberOfVolumes)
@@ -990,6 +1202,26 @@ void vtkMRMLVolumeRenderingDisplayableManager::vtkInternal::UpdatePipelineROIs(
   // Calculate and set clipping planes
   vtkNew<vtkPlanes> planes;
   displayNode->GetROINode()->GetTransformedPlanes(planes.GetPointer());
+
+  // Update existing planes if possible, as replacing the plane collection
+  // would make the mapper rebuild its shader.
+  vtkPlaneCollection* currentPlanes = volumeMapper->GetClippingPlanes();
+  if (currentPlanes && currentPlanes->GetNumberOfItems() == planes->GetNumberOfPlanes())
+    {
+    for (int planeIndex = 0; planeIndex < planes->GetNumberOfPlanes(); ++planeIndex)
+      {
+      vtkPlane* newPlane = planes->GetPlane(planeIndex);
+      vtkPlane* currentPlane = currentPlanes->GetItem(planeIndex);
+      double origin[3] = { 0.0, 0.0, 0.0 };
+      double normal[3] = { 0.0, 0.0, 0.0 };
+      newPlane->GetOrigin(origin);
+      newPlane->GetNormal(normal);
+      // vtkPlane setters only call Modified if the value is changed
+      currentPlane->SetOrigin(origin);
+      currentPlane->SetNormal(normal);
+      }
+    return;
+    }
   volumeMapper->SetClippingPlanes(planes.GetPointer());
 }
 
@@ -1042,6 +1274,294 @@ vtkIdType vtkMRMLVolumeRenderingDisplayableManager::vtkInternal::GetMaxMemoryInB
   return gpuMemorySizeB;
 }
 
+//---------------------------------------------------------------------------
+void vtkMRMLVolumeRenderingDisplayableManager::vtkInternal::UpdateGPUPartitions(
+  vtkMRMLGPURayCastVolumeRenderingDisplayNode* displayNode, vtkMRMLVolumeNode* volumeNode, const Pipeline* pipeline)
+{
+  PipelineGPU* pipelineGpu = const_cast<PipelineGPU*>(dynamic_cast<const PipelineGPU*>(pipeline));
+  if (!pipelineGpu)
+    {
+    return;
+    }
+  int partitions[3] = { 1, 1, 1 };
+  vtkImageData* imageData = volumeNode ? volumeNode->GetImageData() : nullptr;
+  vtkDataArray* scalars = (imageData && imageData->GetPointData()) ? imageData->GetPointData()->GetScalars() : nullptr;
+  if (displayNode->GetAutoPartitioning() && scalars)
+    {
+    // Largest texture dimension that all supported graphics cards can allocate
+    const int maximumBrickDimension = 2048;
+    vtkIdType maxBrickSizeInBytes = this->GetMaxMemoryInBytes(displayNode);
+    vtkIdType bytesPerVoxel = scalars->GetNumberOfComponents() * std::min(scalars->GetDataTypeSize(), 4);
+    int dimensions[3] = { 0, 0, 0 };
+    imageData->GetDimensions(dimensions);
+    if (pipelineGpu->CroppedVolumeExtractor)
+      {
+      // Only the part of the volume inside the cropping ROI is uploaded
+      const int* uploadedExtent = pipelineGpu->CroppedVolumeExtent;
+      for (int axis = 0; axis < 3; ++axis)
+        {
+        dimensions[axis] = std::max(uploadedExtent[axis * 2 + 1] - uploadedExtent[axis * 2] + 1, 1);
+        }
+      }
+    // Split the longest brick axis until bricks fit into the memory budget and texture size limit
+    for (;;)
+      {
+      int brickDimensions[3];
+      int longestAxis = 0;
+      for (int axis = 0; axis < 3; ++axis)
+        {
+        brickDimensions[axis] = (dimensions[axis] + partitions[axis] - 1) / partitions[axis];
+        if (brickDimensions[axis] > brickDimensions[longestAxis])
+          {
+          longestAxis = axis;
+          }
+        }
+      vtkIdType brickSizeInBytes = vtkIdType(brickDimensions[0]) * brickDimensions[1] * brickDimensions[2] * bytesPerVoxel;
+      if ((brickSizeInBytes <= maxBrickSizeInBytes && brickDimensions[longestAxis] <= maximumBrickDimension)
+        || brickDimensions[longestAxis] <= 1 || partitions[longestAxis] >= VTK_UNSIGNED_SHORT_MAX / 2)
+        {
+        break;
+        }
+      partitions[longestAxis] *= 2;
+      }
+    }
+  if (std::equal(partitions, partitions + 3, pipelineGpu->Partitions))
+    {
+    return;
+    }
+  std::copy(partitions, partitions + 3, pipelineGpu->Partitions);
+#if defined(Slicer_VTK_RENDERING_USE_OpenGL2_BACKEND)
+  vtkOpenGLGPUVolumeRayCastMapper* openGLMapper = vtkOpenGLGPUVolumeRayCastMapper::SafeDownCast(pipelineGpu->RayCastMapperGPU);
+  if (openGLMapper)
+    {
+    openGLMapper->SetPartitions(partitions[0], partitions[1], partitions[2]);
+    }
+#endif
+}
+
+//---------------------------------------------------------------------------
+void vtkMRMLVolumeRenderingDisplayableManager::vtkInternal::UpdateEmptySpaceSkipping(
+  vtkMRMLGPURayCastVolumeRenderingDisplayNode* displayNode, vtkMRMLVolumeNode* volumeNode, const Pipeline* pipeline)
+{
+  PipelineGPU* pipelineGpu = const_cast<PipelineGPU*>(dynamic_cast<const PipelineGPU*>(pipeline));
+  if (!pipelineGpu)
+    {
+    return;
+    }
+  vtkGPUVolumeRayCastMapper* mapper = pipelineGpu->RayCastMapperGPU;
+  vtkImageData* imageData = volumeNode ? volumeNode->GetImageData() : nullptr;
+  vtkDataArray* scalars = (imageData && imageData->GetPointData()) ? imageData->GetPointData()->GetScalars() : nullptr;
+  vtkVolumeProperty* volumeProperty = displayNode->GetVolumePropertyNode() ? displayNode->GetVolumePropertyNode()->GetVolumeProperty() : nullptr;
+  vtkPiecewiseFunction* scalarOpacity = volumeProperty ? volumeProperty->GetScalarOpacity() : nullptr;
+  // Opacity of multi-component volumes depend on all components, they are not skipped
+  if (!displayNode->GetEmptySpaceSkipping() || !scalars || scalars->GetNumberOfComponents() != 1
+    || !scalarOpacity || scalarOpacity->GetSize() == 0)
+    {
+    mapper->CroppingOff();
+    pipelineGpu->MacroCellImageData = nullptr;
+    pipelineGpu->MacroCellMinimums.clear();
+    pipelineGpu->MacroCellMaximums.clear();
+    pipelineGpu->OpaqueCellBoxValid = false;
+    return;
+    }
+
+  int dimensions[3] = { 0, 0, 0 };
+  imageData->GetDimensions(dimensions);
+  const int cellSize = 8;
+
+  // Macro-cell scalar ranges only need to be recomputed when the voxels change
+  if (pipelineGpu->MacroCellImageData != imageData || pipelineGpu->MacroCellImageMTime != imageData->GetMTime())
+    {
+    vtkIdType numberOfCells = 1;
+    for (int axis = 0; axis < 3; ++axis)
+      {
+      pipelineGpu->MacroCellGridDimensions[axis] = std::max((dimensions[axis] - 1 + cellSize - 1) / cellSize, 1);
+      numberOfCells *= pipelineGpu->MacroCellGridDimensions[axis];
+      }
+    pipelineGpu->MacroCellMinimums.resize(numberOfCells);
+    pipelineGpu->MacroCellMaximums.resize(numberOfCells);
+    switch (scalars->GetDataType())
+      {
+      vtkTemplateMacro(ComputeMacroCellRanges(static_cast<VTK_TT*>(scalars->GetVoidPointer(0)), dimensions, 1,
+        cellSize, pipelineGpu->MacroCellGridDimensions, pipelineGpu->MacroCellMinimums, pipelineGpu->MacroCellMaximums));
+      default:
+        mapper->CroppingOff();
+        pipelineGpu->MacroCellImageData = nullptr;
+        pipelineGpu->OpaqueCellBoxValid = false;
+        return;
+      }
+    pipelineGpu->MacroCellImageData = imageData;
+    pipelineGpu->MacroCellImageMTime = imageData->GetMTime();
+    pipelineGpu->OpaqueCellBoxValid = false;
+    }
+
+  // Find the box of macro-cells that are not fully transparent with the current opacity function.
+  // Scanning all the macro-cells is only needed when the voxels or the opacity function change.
+  int* opaqueCellBox = pipelineGpu->OpaqueCellBox;
+  if (!pipelineGpu->OpaqueCellBoxValid || pipelineGpu->OpaqueCellBoxOpacityFunction != scalarOpacity
+    || pipelineGpu->OpaqueCellBoxOpacityMTime != scalarOpacity->GetMTime())
+    {
+    const int* gridDimensions = pipelineGpu->MacroCellGridDimensions;
+    int newOpaqueCellBox[6] = { gridDimensions[0], -1, gridDimensions[1], -1, gridDimensions[2], -1 };
+    vtkIdType cellIndex = 0;
+    for (int cellK = 0; cellK < gridDimensions[2]; ++cellK)
+      {
+      for (int cellJ = 0; cellJ < gridDimensions[1]; ++cellJ)
+        {
+        for (int cellI = 0; cellI < gridDimensions[0]; ++cellI, ++cellIndex)
+          {
+          if (GetMaximumValueInRange(scalarOpacity,
+            pipelineGpu->MacroCellMinimums[cellIndex], pipelineGpu->MacroCellMaximums[cellIndex]) <= 0.0)
+            {
+            continue;
+            }
+          int cell[3] = { cellI, cellJ, cellK };
+          for (int axis = 0; axis < 3; ++axis)
+            {
+            newOpaqueCellBox[axis * 2] = std::min(newOpaqueCellBox[axis * 2], cell[axis]);
+            newOpaqueCellBox[axis * 2 + 1] = std::max(newOpaqueCellBox[axis * 2 + 1], cell[axis]);
+            }
+          }
+        }
+      }
+    std::copy(newOpaqueCellBox, newOpaqueCellBox + 6, opaqueCellBox);
+    pipelineGpu->OpaqueCellBoxOpacityFunction = scalarOpacity;
+    pipelineGpu->OpaqueCellBoxOpacityMTime = scalarOpacity->GetMTime();
+    pipelineGpu->OpaqueCellBoxValid = true;
+    }
+  if (opaqueCellBox[1] < opaqueCellBox[0])
+    {
+    // Nothing is visible, cropping would not make rendering faster
+    mapper->CroppingOff();
+    return;
+    }
+
+  // Cropping planes are in the coordinate system of the image data, before the actor transform.
+  // The GPU mapper only casts rays within the cropped bounding box.
+  double origin[3] = { 0.0, 0.0, 0.0 };
+  double spacing[3] = { 1.0, 1.0, 1.0 };
+  int extent[6] = { 0, -1, 0, -1, 0, -1 };
+  imageData->GetOrigin(origin);
+  imageData->GetSpacing(spacing);
+  imageData->GetExtent(extent);
+  double croppingPlanes[6] = { 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 };
+  for (int axis = 0; axis < 3; ++axis)
+    {
+    int firstVoxel = opaqueCellBox[axis * 2] * cellSize;
+    int lastVoxel = std::min((opaqueCellBox[axis * 2 + 1] + 1) * cellSize, dimensions[axis] - 1);
+    double bound1 = origin[axis] + (extent[axis * 2] + firstVoxel) * spacing[axis];
+    double bound2 = origin[axis] + (extent[axis * 2] + lastVoxel) * spacing[axis];
+    croppingPlanes[axis * 2] = std::min(bound1, bound2);
+    croppingPlanes[axis * 2 + 1] = std::max(bound1, bound2);
+    }
+  mapper->SetCroppingRegionPlanes(croppingPlanes);
+  mapper->SetCroppingRegionFlagsToSubVolume();
+  mapper->CroppingOn();
+}
+
+//---------------------------------------------------------------------------
+vtkAlgorithmOutput* vtkMRMLVolumeRenderingDisplayableManager::vtkInternal::GetGPUInputConnection(
+  vtkMRMLGPURayCastVolumeRenderingDisplayNode* displayNode, vtkMRMLVolumeNode* volumeNode, const Pipeline* pipeline)
+{
+  PipelineGPU* pipelineGpu = const_cast<PipelineGPU*>(dynamic_cast<const PipelineGPU*>(pipeline));
+  vtkImageData* imageData = volumeNode ? volumeNode->GetImageData() : nullptr;
+  if (!pipelineGpu || !imageData)
+    {
+    return volumeNode ? volumeNode->GetImageDataConnection() : nullptr;
+    }
+  int wholeExtent[6] = { 0, -1, 0, -1, 0, -1 };
+  imageData->GetExtent(wholeExtent);
+
+  // Get IJK extent of the cropping ROI. Clipping planes still perform the exact cropping,
+  // this only reduces the amount of data that is uploaded to the GPU.
+  bool cropVolume = false;
+  int roiExtent[6] = { 0, -1, 0, -1, 0, -1 };
+  vtkNew<vtkMatrix4x4> ijkToWorldMatrix;
+  if (displayNode->GetCroppingEnabled() && displayNode->GetROINode()
+    && this->GetVolumeTransformToWorld(volumeNode, ijkToWorldMatrix))
+    {
+    vtkNew<vtkMatrix4x4> worldToIjkMatrix;
+    vtkMatrix4x4::Invert(ijkToWorldMatrix, worldToIjkMatrix);
+    double roiBounds[6] = { 0.0, -1.0, 0.0, -1.0, 0.0, -1.0 };
+    displayNode->GetROINode()->GetRASBounds(roiBounds);
+    double ijkBounds[6] = { VTK_DOUBLE_MAX, VTK_DOUBLE_MIN, VTK_DOUBLE_MAX, VTK_DOUBLE_MIN, VTK_DOUBLE_MAX, VTK_DOUBLE_MIN };
+    for (int corner = 0; corner < 8; ++corner)
+      {
+      double worldPoint[4] = { roiBounds[corner & 1], roiBounds[2 + ((corner >> 1) & 1)], roiBounds[4 + ((corner >> 2) & 1)], 1.0 };
+      double ijkPoint[4] = { 0.0, 0.0, 0.0, 1.0 };
+      worldToIjkMatrix->MultiplyPoint(worldPoint, ijkPoint);
+      for (int axis = 0; axis < 3; ++axis)
+        {
+        ijkBounds[axis * 2] = std::min(ijkBounds[axis * 2], ijkPoint[axis]);
+        ijkBounds[axis * 2 + 1] = std::max(ijkBounds[axis * 2 + 1], ijkPoint[axis]);
+        }
+      }
+    // Keep one extra voxel on each side for interpolation and round outward to
+    // blocks so that small ROI changes do not change the extent.
+    const int blockSize = 16;
+    cropVolume = true;
+    for (int axis = 0; axis < 3; ++axis)
+      {
+      int first = std::max(static_cast<int>(std::floor(ijkBounds[axis * 2])) - 1, wholeExtent[axis * 2]);
+      int last = std::min(static_cast<int>(std::ceil(ijkBounds[axis * 2 + 1])) + 1, wholeExtent[axis * 2 + 1]);
+      if (first > last)
+        {
+        // ROI is outside the volume, nothing would be rendered anyway
+        cropVolume = false;
+        break;
+        }
+      first = wholeExtent[axis * 2] + ((first - wholeExtent[axis * 2]) / blockSize) * blockSize;
+      last = wholeExtent[axis * 2] + ((last - wholeExtent[axis * 2]) / blockSize + 1) * blockSize - 1;
+      roiExtent[axis * 2] = first;
+      roiExtent[axis * 2 + 1] = std::min(last, wholeExtent[axis * 2 + 1]);
+      }
+    }
+
+  if (!cropVolume || std::equal(roiExtent, roiExtent + 6, wholeExtent))
+    {
+    // Render the full volume
+    pipelineGpu->CroppedVolumeExtractor = nullptr;
+    return volumeNode->GetImageDataConnection();
+    }
+
+  // Keep the current extent while it contains the ROI and is not much larger than needed,
+  // to avoid uploading the volume again while the ROI is being adjusted.
+  int* currentExtent = pipelineGpu->CroppedVolumeExtent;
+  bool updateExtent = (pipelineGpu->CroppedVolumeExtractor == nullptr);
+  double currentVoxelCount = 1.0;
+  double roiVoxelCount = 1.0;
+  for (int axis = 0; axis < 3; ++axis)
+    {
+    if (roiExtent[axis * 2] < currentExtent[axis * 2] || roiExtent[axis * 2 + 1] > currentExtent[axis * 2 + 1])
+      {
+      updateExtent = true;
+      }
+    currentVoxelCount *= std::max(currentExtent[axis * 2 + 1] - currentExtent[axis * 2] + 1, 0);
+    roiVoxelCount *= roiExtent[axis * 2 + 1] - roiExtent[axis * 2] + 1;
+    }
+  if (currentVoxelCount > 2.0 * roiVoxelCount)
+    {
+    updateExtent = true;
+    }
+
+  if (!pipelineGpu->CroppedVolumeExtractor)
+    {
+    pipelineGpu->CroppedVolumeExtractor = vtkSmartPointer<vtkExtractVOI>::New();
+    }
+  vtkExtractVOI* extractor = pipelineGpu->CroppedVolumeExtractor;
+  if (extractor->GetInputConnection(0, 0) != volumeNode->GetImageDataConnection())
+    {
+    extractor->SetInputConnection(volumeNode->GetImageDataConnection());
+    }
+  if (updateExtent)
+    {
+    std::copy(roiExtent, roiExtent + 6, currentExtent);
+    // Output keeps the extent of the input, so IJK coordinates are not changed
+    extractor->SetVOI(currentExtent);
+    }
+  return extractor->GetOutputPort();
+}
+
 //---------------------------------------------------------------------------
 void vtkMRMLVolumeRenderingDisplayableManager::vtkInternal::UpdateDesiredUpdateRate(vtkMRMLVolumeRenderingDisplayNode* displayNode)
 {
@@ -1182,11 +1702,175 @@ void vtkMRMLVolumeRenderingDisplayableManager::vtkInternal::UpdateMultiVolumeMap
     }
 
 #if VTK_MAJOR_VERSION >= 9 || (VTK_MAJOR_VERSION >= 8 && VTK_MINOR_VERSION >= 2)
+  double sampleDistanceScale = 1.0;
+  double imageSampleDistance = 1.0;
+  this->GetAdaptiveQualityParameters(sampleDistanceScale, imageSampleDistance);
   vtkGPUVolumeRayCastMapper* gpuMultiMapper = vtkGPUVolumeRayCastMapper::SafeDownCast(this->MultiVolumeMapper);
-  gpuMultiMapper->SetSampleDistance(minimumSampleDistance);
+  gpuMultiMapper->SetSampleDistance(minimumSampleDistance * sampleDistanceScale);
+  gpuMultiMapper->SetImageSampleDistance(imageSampleDistance);
 #endif
 }
 
+//---------------------------------------------------------------------------
+void vtkMRMLVolumeRenderingDisplayableManager::vtkInternal::OnRenderEvent(
+  vtkObject* vtkNotUsed(caller), unsigned long eid, void* clientData, void* vtkNotUsed(callData))
+{
+  vtkInternal* self = reinterpret_cast<vtkInternal*>(clientData);
+  if (eid == vtkCommand::StartEvent)
+    {
+    self->RenderStartTime = vtkTimerLog::GetUniversalTime();
+    }
+  else if (eid == vtkCommand::EndEvent)
+    {
+    self->UpdateAdaptiveQuality();
+    }
+}
+
+//---------------------------------------------------------------------------
+void vtkMRMLVolumeRenderingDisplayableManager::vtkInternal::ObserveRenderer()
+{
+  vtkRenderer* renderer = this->External->GetRenderer();
+  if (renderer == this->ObservedRenderer)
+    {
+    return;
+    }
+  this->UnobserveRenderer();
+  if (!renderer)
+    {
+    return;
+    }
+  renderer->AddObserver(vtkCommand::StartEvent, this->RenderCallbackCommand);
+  renderer->AddObserver(vtkCommand::EndEvent, this->RenderCallbackCommand);
+  this->ObservedRenderer = renderer;
+}
+
+//---------------------------------------------------------------------------
+void vtkMRMLVolumeRenderingDisplayableManager::vtkInternal::UnobserveRenderer()
+{
+  if (this->ObservedRenderer)
+    {
+    this->ObservedRenderer->RemoveObserver(this->RenderCallbackCommand);
+    this->ObservedRenderer = nullptr;
+    }
+}
+
+//---------------------------------------------------------------------------
+bool vtkMRMLVolumeRenderingDisplayableManager::vtkInternal::IsInteracting()
+{
+  return this->CameraInteraction || this->Interaction > 0;
+}
+
+//---------------------------------------------------------------------------
+void vtkMRMLVolumeRenderingDisplayableManager::vtkInternal::UpdateAdaptiveQuality()
+{
+  vtkMRMLViewNode* viewNode = this->External->GetMRMLViewNode();
+  if (!viewNode || viewNode->GetVolumeRenderingQuality() != vtkMRMLViewNode::Adaptive
+    || this->DisplayPipelines.empty())
+    {
+    this->QualityReduction = 1.0;
+    return;
+    }
+
+  // Maximum of sample distance scale (4x) times image sample distance squared (4x4)
+  const double maximumQualityReduction = 64.0;
+  double qualityReduction = this->QualityReduction;
+  if (this->IsInteracting())
+    {
+#if VTK_MAJOR_VERSION >= 9
+    // Commands are only queued by the renderer, wait for the GPU to measure the actual frame time
+    vtkRenderWindow* renderWindow = this->External->GetRenderer()->GetRenderWindow();
+    if (renderWindow)
+      {
+      renderWindow->WaitForCompletion();
+      }
+#endif
+    double renderTimeInSeconds = vtkTimerLog::GetUniversalTime() - this->RenderStartTime;
+    // Ratio of actual and requested frame time. Small differences are ignored to prevent
+    // oscillation and large steps are limited so that a single slow frame does not
+    // reduce quality too much.
+    double frameTimeRatio = renderTimeInSeconds * this->GetFramerate();
+    if (frameTimeRatio > 1.2 || frameTimeRatio < 0.8)
+      {
+      qualityReduction *= std::max(0.5, std::min(frameTimeRatio, 2.0));
+      qualityReduction = std::max(1.0, std::min(qualityReduction, maximumQualityReduction));
+      }
+    this->InteractiveQualityReduction = qualityReduction;
+    this->SetQualityReduction(qualityReduction);
+    }
+  else if (qualityReduction > 1.0)
+    {
+    // Refine progressively when idle: render a few frames with increasing quality
+    this->SetQualityReduction(std::max(1.0, qualityReduction / 4.0));
+    this->External->RequestRender();
+    }
+}
+
+//---------------------------------------------------------------------------
+void vtkMRMLVolumeRenderingDisplayableManager::vtkInternal::SetQualityReduction(double qualityReduction)
+{
+  vtkMRMLViewNode* viewNode = this->External->GetMRMLViewNode();
+  if (!viewNode || viewNode->GetVolumeRenderingQuality() != vtkMRMLViewNode::Adaptive)
+    {
+    // Sample distances are set by UpdateDisplayNodePipeline in other quality modes
+    this->QualityReduction = 1.0;
+    return;
+    }
+  if (qualityReduction == this->QualityReduction)
+    {
+    return;
+    }
+  this->QualityReduction = qualityReduction;
+  for (Pipeline* pipeline : this->DisplayPipelines)
+    {
+    if (!pipeline->DisplayNode || pipeline->DisplayNode->IsA("vtkMRMLMultiVolumeRenderingDisplayNode"))
+      {
+      continue;
+      }
+    this->ApplyAdaptiveQuality(pipeline->DisplayNode, this->GetVolumeMapper(pipeline->DisplayNode));
+    }
+  this->UpdateMultiVolumeMapperSampleDistance();
+}
+
+//---------------------------------------------------------------------------
+void vtkMRMLVolumeRenderingDisplayableManager::vtkInternal::GetAdaptiveQualityParameters(
+  double& sampleDistanceScale, double& imageSampleDistance)
+{
+  // Take fewer samples along rays first, and render to a lower resolution image
+  // only if that is not enough, as it is more visible
+  const double maximumSampleDistanceScale = 4.0;
+  const double maximumImageSampleDistance = 4.0;
+  vtkMRMLViewNode* viewNode = this->External->GetMRMLViewNode();
+  if (!viewNode || viewNode->GetVolumeRenderingQuality() != vtkMRMLViewNode::Adaptive)
+    {
+    sampleDistanceScale = 1.0;
+    imageSampleDistance = 1.0;
+    return;
+    }
+  sampleDistanceScale = std::min(this->QualityReduction, maximumSampleDistanceScale);
+  imageSampleDistance = std::min(sqrt(this->QualityReduction / sampleDistanceScale), maximumImageSampleDistance);
+}
+
+//---------------------------------------------------------------------------
+void vtkMRMLVolumeRenderingDisplayableManager::vtkInternal::ApplyAdaptiveQuality(
+  vtkMRMLVolumeRenderingDisplayNode* displayNode, vtkVolumeMapper* mapper)
+{
+  double sampleDistanceScale = 1.0;
+  double imageSampleDistance = 1.0;
+  this->GetAdaptiveQualityParameters(sampleDistanceScale, imageSampleDistance);
+  double sampleDistance = displayNode->GetSampleDistance() * sampleDistanceScale;
+  if (vtkGPUVolumeRayCastMapper* gpuMapper = vtkGPUVolumeRayCastMapper::SafeDownCast(mapper))
+    {
+    gpuMapper->SetSampleDistance(sampleDistance);
+    gpuMapper->SetImageSampleDistance(imageSampleDistance);
+    }
+  else if (vtkFixedPointVolumeRayCastMapper* cpuMapper = vtkFixedPointVolumeRayCastMapper::SafeDownCast(mapper))
+    {
+    cpuMapper->SetSampleDistance(sampleDistance);
+    cpuMapper->SetInteractiveSampleDistance(sampleDistance);
+    cpuMapper->SetImageSampleDistance(imageSampleDistance);
+    }
+}
+
 //---------------------------------------------------------------------------
 void vtkMRMLVolumeRenderingDisplayableManager::vtkInternal::FindPickedDisplayNodeFromVolumeActor(vtkVolume* volume)
 {
@@ -1249,6 +1933,7 @@ void vtkMRMLVolumeRenderingDisplayableManager::Create()
 {
   Superclass::Create();
   this->ObserveGraphicalResourcesCreatedEvent();
+  this->Internal->ObserveRenderer();
   this->SetUpdateFromMRMLRequested(true);
 }
 
@@ -1501,9 +2186,17 @@ void vtkMRMLVolumeRenderingDisplayableManager::OnInteractorStyleEvent(int eventI
 {
   switch (eventID)
     {
-    case vtkCommand::EndInteractionEvent:
     case vtkCommand::StartInteractionEvent:
+      this->Internal->CameraInteraction = true;
+      // Start from the quality that kept the frame rate in the previous interaction
+      this->Internal->SetQualityReduction(this->Internal->InteractiveQualityReduction);
+      this->Internal->UpdatePipelineTransforms(nullptr);
+      break;
+    case vtkCommand::EndInteractionEvent:
+      this->Internal->CameraInteraction = false;
       this->Internal->UpdatePipelineTransforms(nullptr);
+      // Refine to full quality
+      this->RequestRender();
       break;
     default:
       break;
@@ -1638,3 +2331,34 @@ const char* vtkMRMLVolumeRenderingDisplayableManager::GetPickedNodeID()
 {
   return this->Internal->PickedNodeID.c_str();
 }
+
+//---------------------------------------------------------------------------
+unsigned long vtkMRMLVolumeRenderingDisplayableManager::GetGraphicsMemorySize()
+{
+  unsigned long size = this->Superclass::GetGraphicsMemorySize();
+  for (vtkInternal::Pipeline* pipeline : this->Internal->DisplayPipelines)
+    {
+    if (!pipeline->VolumeActor->GetVisibility())
+      {
+      continue;
+      }
+    vtkDataObject* uploadedVolume = nullptr;
+    const vtkInternal::PipelineGPU* pipelineGpu = dynamic_cast<const vtkInternal::PipelineGPU*>(pipeline);
+    const vtkInternal::PipelineMultiVolume* pipelineMulti = dynamic_cast<const vtkInternal::PipelineMultiVolume*>(pipeline);
+    if (pipelineGpu && pipelineGpu->RayCastMapperGPU->GetNumberOfInputConnections(0) > 0)
+      {
+      uploadedVolume = pipelineGpu->RayCastMapperGPU->GetInputDataObject(0, 0);
+      }
+    else if (pipelineMulti && pipelineMulti->ConnectedToMultiVolume
+      && static_cast<int>(pipelineMulti->ActorPortIndex) < this->Internal->MultiVolumeMapper->GetNumberOfInputPorts()
+      && this->Internal->MultiVolumeMapper->GetNumberOfInputConnections(pipelineMulti->ActorPortIndex) > 0)
+      {
+      uploadedVolume = this->Internal->MultiVolumeMapper->GetInputDataObject(pipelineMulti->ActorPortIndex, 0);
+      }
+    if (uploadedVolume)
+      {
+      size += uploadedVolume->GetActualMemorySize();
+      }
+    }
+  return size;
+}
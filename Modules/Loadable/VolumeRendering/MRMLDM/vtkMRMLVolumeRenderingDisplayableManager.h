@@ -66,6 +66,10 @@ public:
   /// Get the MRML ID of the picked node, returns empty string if no pick
   const char* GetPickedNodeID() override;
 
+  /// Estimated size (in kibibytes) of the volumes uploaded as textures
+  /// by the GPU ray cast and multi-volume mappers for visible volumes.
+  unsigned long GetGraphicsMemorySize() override;
+
 public:
   static int DefaultGPUMemorySize;
 
@@ -23,6 +23,7 @@
 #include "vtkSlicerVolumeRenderingLogic.h"
 
 // VTK includes
+#include <vtkColorTransferFunction.h>
 #include <vtkPiecewiseFunction.h>
 
 // STD includes
@@ -33,6 +34,7 @@ namespace
 {
 int readWrite();
 int piecewiseFunctionFromString();
+int copyParameterSet();
 }
 
 //---------------------------------------------------------------------------
@@ -52,6 +54,7 @@ int vtkMRMLVolumePropertyNodeTest1(int argc, char *[] )
 
   CHECK_EXIT_SUCCESS(readWrite());
   CHECK_EXIT_SUCCESS(piecewiseFunctionFromString());
+  CHECK_EXIT_SUCCESS(copyParameterSet());
 
   vtkNew<vtkMRMLApplicationLogic> applicationLogic;
   applicationLogic->SetMRMLScene(scene.GetPointer()); // register custom nodes
@@ -163,4 +166,40 @@ int piecewiseFunctionFromString()
   return EXIT_SUCCESS;
 }
 
+//---------------------------------------------------------------------------
+int copyParameterSet()
+{
+  vtkNew<vtkMRMLVolumePropertyNode> presetNode;
+  presetNode->GetScalarOpacity()->AddPoint(0., 0.);
+  presetNode->GetScalarOpacity()->AddPoint(100., 1.);
+  presetNode->GetColor()->AddRGBPoint(0., 0., 0., 0.);
+  presetNode->GetColor()->AddRGBPoint(100., 1., 0.5, 0.);
+
+  vtkNew<vtkMRMLVolumePropertyNode> propertyNode;
+  vtkPiecewiseFunction* scalarOpacity = propertyNode->GetScalarOpacity();
+  vtkColorTransferFunction* color = propertyNode->GetColor();
+  propertyNode->CopyParameterSet(presetNode.GetPointer());
+
+  // Transfer functions are copied into the existing objects
+  CHECK_POINTER(propertyNode->GetScalarOpacity(), scalarOpacity);
+  CHECK_POINTER(propertyNode->GetColor(), color);
+  CHECK_INT(scalarOpacity->GetSize(), 2);
+  CHECK_DOUBLE(scalarOpacity->GetValue(100.), 1.);
+  CHECK_INT(color->GetSize(), 2);
+  CHECK_DOUBLE(color->GetColor(100.)[1], 0.5);
+
+  // Copying the same parameters again does not modify the transfer functions
+  vtkMTimeType scalarOpacityMTime = scalarOpacity->GetMTime();
+  vtkMTimeType colorMTime = color->GetMTime();
+  propertyNode->CopyParameterSet(presetNode.GetPointer());
+  CHECK_INT(scalarOpacity->GetMTime(), scalarOpacityMTime);
+  CHECK_INT(color->GetMTime(), colorMTime);
+
+  // Changed preset is copied
+  presetNode->GetScalarOpacity()->AddPoint(50., 0.5);
+  propertyNode->CopyParameterSet(presetNode.GetPointer());
+  CHECK_INT(scalarOpacity->GetSize(), 3);
+  return EXIT_SUCCESS;
+}
+
 }
@@ -410,6 +410,19 @@ void qSlicerVolumeRenderingModuleWidget::updateWidgetFromMRML()
   QString currentRenderingMethod = displayNode ? QString(displayNode->GetClassName()) : defaultRenderingMethod;
   d->RenderingMethodComboBox->setCurrentIndex(d->RenderingMethodComboBox->findData(currentRenderingMethod) );
   d->MemorySizeComboBox->setCurrentGPUMemory(firstViewNode ? firstViewNode->GetGPUMemorySize() : 0);
+  vtkSlicerVolumeRenderingLogic* volumeRenderingLogic = vtkSlicerVolumeRenderingLogic::SafeDownCast(this->logic());
+  int numberOfTextureViews = 0;
+  vtkIdType textureMemorySize = volumeRenderingLogic ?
+    volumeRenderingLogic->EstimateGPUTextureMemorySize(displayNode, &numberOfTextureViews) : 0;
+  if (numberOfTextureViews > 0)
+    {
+    d->TextureMemoryValueLabel->setText(tr("%1 MB (%2 view(s))")
+      .arg(static_cast<double>(textureMemorySize) / (1024.0 * 1024.0), 0, 'f', 1).arg(numberOfTextureViews));
+    }
+  else
+    {
+    d->TextureMemoryValueLabel->setText("-");
+    }
   d->QualityControlComboBox->setCurrentIndex(firstViewNode ? firstViewNode->GetVolumeRenderingQuality() : -1);
   d->AutoReleaseGraphicsResourcesCheckBox->setChecked(firstViewNode ? firstViewNode->GetAutoReleaseGraphicsResources() : false);
 
@@ -195,15 +195,42 @@ class CropVolumeSequenceLogic(ScriptedLoadableModuleLogic):
 
     try:
       qt.QApplication.setOverrideCursor(qt.Qt.WaitCursor)
-      numberOfDataNodes = inputVolSeq.GetNumberOfDataNodes()
-      for seqItemNumber in range(numberOfDataNodes):
-        slicer.app.processEvents(qt.QEventLoop.ExcludeUserInputEvents)
-        seqBrowser.SetSelectedItemNumber(seqItemNumber)
-        slicer.modules.sequences.logic().UpdateProxyNodesFromSequences(seqBrowser)
-        slicer.modules.cropvolume.logic().Apply(cropParameters)
-        if outputVolSeq:
-          # Saved cropped result
-          outputVolSeq.SetDataNodeAtValue(outputVolume, inputVolSeq.GetNthIndexValue(seqItemNumber))
+      if cropParameters.GetVoxelBased():
+        # Voxel-based cropping is done for all the frames at once, in parallel.
+        # Crop extent is computed from the first frame (frames of a volume sequence share the same geometry).
+        cropExtent = [0, -1, 0, -1, 0, -1]
+        if not slicer.vtkSlicerCropVolumeLogic.GetVoxelBasedCropOutputExtent(cropParameters.GetROINode(), inputVolume, cropExtent, False):
+          raise ValueError("Failed to compute output extent of voxel-based cropping")
+        if not slicer.modules.sequences.logic().CropVolumeSequence(inputVolSeq, outputVolSeq if outputVolSeq else inputVolSeq,
+          cropExtent, cropParameters.GetFillValue()):
+          raise ValueError("Failed to crop volume sequence")
+      else:
+        cropLogic = slicer.modules.cropvolume.logic()
+        # Output geometry is computed from the first frame and used for resampling all the frames
+        # (frames of a volume sequence share the same geometry).
+        # Diffusion weighted volumes are cropped by the resample module, frame by frame.
+        outputExtent = [0, -1, 0, -1, 0, -1]
+        outputIJKToRAS = vtk.vtkMatrix4x4()
+        useSharedGeometry = not inputVolume.IsA("vtkMRMLDiffusionWeightedVolumeNode")
+        if useSharedGeometry:
+          if not cropLogic.GetInterpolatedCropOutputGeometry(cropParameters.GetROINode(), inputVolume,
+            outputVolume if outputVolume else inputVolume, cropParameters.GetIsotropicResampling(),
+            cropParameters.GetSpacingScalingConst(), outputExtent, outputIJKToRAS):
+            raise ValueError("Failed to compute output geometry of interpolated cropping")
+        numberOfDataNodes = inputVolSeq.GetNumberOfDataNodes()
+        for seqItemNumber in range(numberOfDataNodes):
+          slicer.app.processEvents(qt.QEventLoop.ExcludeUserInputEvents)
+          seqBrowser.SetSelectedItemNumber(seqItemNumber)
+          slicer.modules.sequences.logic().UpdateProxyNodesFromSequences(seqBrowser)
+          if useSharedGeometry:
+            if cropLogic.ResampleInterpolated(inputVolume, outputVolume if outputVolume else inputVolume,
+              outputExtent, outputIJKToRAS, cropParameters.GetInterpolationMode(), cropParameters.GetFillValue()) != 0:
+              raise ValueError("Failed to crop volume sequence item %d" % seqItemNumber)
+          else:
+            cropLogic.Apply(cropParameters)
+          if outputVolSeq:
+            # Saved cropped result
+            outputVolSeq.SetDataNodeAtValue(outputVolume, inputVolSeq.GetNthIndexValue(seqItemNumber))
 
     finally:
       qt.QApplication.restoreOverrideCursor()
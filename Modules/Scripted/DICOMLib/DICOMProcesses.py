@@ -306,9 +306,18 @@ class DICOMListener(DICOMStoreSCPProcess):
   def __init__(self, database, fileToBeAddedCallback=None, fileAddedCallback=None):
     self.dicomDatabase = database
     self.indexer = ctk.ctkDICOMIndexer()
+    # Received files are indexed in batches by the indexer's worker thread,
+    # so that the database is written in a few transactions and the GUI is not blocked
+    self.indexer.setDatabase(self.dicomDatabase)
+    self.indexer.backgroundImportEnabled = True
     self.fileToBeAddedCallback = fileToBeAddedCallback
     self.fileAddedCallback = fileAddedCallback
     self.lastFileAdded = None
+    self.pendingFiles = []
+    self.indexingTimer = qt.QTimer()
+    self.indexingTimer.setSingleShot(True)
+    self.indexingTimer.setInterval(500)
+    self.indexingTimer.connect('timeout()', self.indexPendingFiles)
 
     databaseDirectory = self.dicomDatabase.databaseDirectory
     if not databaseDirectory:
@@ -321,6 +330,12 @@ class DICOMListener(DICOMStoreSCPProcess):
   def __del__(self):
     super(DICOMListener, self).__del__()
 
+  def stop(self):
+    # index the files that have been received already
+    self.indexingTimer.stop()
+    self.indexPendingFiles()
+    super(DICOMListener,self).stop()
+
   def readFromStandardOutput(self):
     super(DICOMListener,self).readFromStandardOutput(readLineCallback=self.processStdoutLine)
 
@@ -333,15 +348,25 @@ class DICOMListener(DICOMStoreSCPProcess):
       logging.debug("indexing: %s " % dicomFilePath)
       if self.fileToBeAddedCallback:
         self.fileToBeAddedCallback()
-      self.indexer.addFile(self.dicomDatabase, dicomFilePath, True)
-      logging.debug("done indexing")
-      self.lastFileAdded = dicomFilePath
-      if self.fileAddedCallback:
-        logging.debug("calling callback...")
-        self.fileAddedCallback()
-        logging.debug("callback done")
-      else:
-        logging.debug("no callback")
+      self.pendingFiles.append(dicomFilePath)
+      if not self.indexingTimer.isActive():
+        self.indexingTimer.start()
+
+  def indexPendingFiles(self):
+    """Index the files received since the last call in one batch."""
+    if not self.pendingFiles:
+      return
+    files = self.pendingFiles
+    self.pendingFiles = []
+    logging.debug("indexing %d received files" % len(files))
+    self.indexer.addListOfFiles(files, True)
+    self.lastFileAdded = files[-1]
+    if self.fileAddedCallback:
+      logging.debug("calling callback...")
+      self.fileAddedCallback()
+      logging.debug("callback done")
+    else:
+      logging.debug("no callback")
 
 
 class DICOMSender(DICOMProcess):
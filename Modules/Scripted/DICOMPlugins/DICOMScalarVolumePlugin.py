@@ -136,14 +136,16 @@ class DICOMScalarVolumePluginClass(DICOMPlugin):
     fileLists parameter (list of file lists).
     """
     loadables = []
+    uncachedFileLists = []
     for files in fileLists:
       cachedLoadables = self.getCachedLoadables(files)
       if cachedLoadables:
         loadables += cachedLoadables
       else:
-        loadablesForFiles = self.examineFiles(files)
-        loadables += loadablesForFiles
-        self.cacheLoadables(files,loadablesForFiles)
+        uncachedFileLists.append(files)
+    for files, loadablesForFiles in zip(uncachedFileLists, self.examineFileLists(uncachedFileLists)):
+      loadables += loadablesForFiles
+      self.cacheLoadables(files,loadablesForFiles)
 
     # sort the loadables by series number if possible
     loadables.sort(key=cmp_to_key(lambda x,y: self.seriesSorter(x,y)))
@@ -159,6 +161,73 @@ class DICOMScalarVolumePluginClass(DICOMPlugin):
     cleanValue = cleanValue.replace("\\", "-")
     return cleanValue
 
+  def examineFileLists(self,fileLists):
+    """ Returns a list of DICOMLoadable lists, one for each file list.
+    Headers of all the files are read and analyzed in C++ by vtkITKDICOMSeriesAnalyzer,
+    file lists that it cannot read are examined by examineFiles.
+    """
+    if not fileLists:
+      return []
+    analyzer = vtkITK.vtkITKDICOMSeriesAnalyzer()
+    analyzer.SetSpacingTolerance(self.epsilon)
+    analyzer.SetSplitByTime(self.allowLoadingByTime())
+    analyzer.SetAcquisitionGeometryRegularization(self.acquisitionGeometryRegularizationEnabled())
+    for files in fileLists:
+      fileNames = vtk.vtkStringArray()
+      for file in files:
+        fileNames.InsertNextValue(file)
+      analyzer.AddFileList(fileNames)
+    analyzer.Update()
+
+    analyzedLoadables = [[] for files in fileLists]
+    for loadableIndex in range(analyzer.GetNumberOfLoadables()):
+      analyzedLoadables[analyzer.GetLoadableFileListIndex(loadableIndex)].append(loadableIndex)
+
+    # Values for these tags will only be enumerated (value itself will not be part of the loadable name)
+    subseriesTagsToEnumerateValues = [
+      "seriesInstanceUID",
+      "imageOrientationPatient",
+      "diffusionGradientOrientation",
+    ]
+
+    loadablesForFileLists = []
+    for fileListIndex, files in enumerate(fileLists):
+      if not analyzer.GetFileListAnalyzed(fileListIndex):
+        loadablesForFileLists.append(self.examineFiles(files))
+        continue
+      excludedSOPClassUID = analyzer.GetFileListExcludedSOPClassUID(fileListIndex)
+      if excludedSOPClassUID == '1.2.840.10008.5.1.4.1.1.66.4' and 'DICOMSegmentationPlugin' not in slicer.modules.dicomPlugins:
+        logging.warning('Please install Quantitative Reporting extension to enable loading of DICOM Segmentation objects')
+      elif excludedSOPClassUID == '1.2.840.10008.5.1.4.1.1.481.3' and 'DicomRtImportExportPlugin' not in slicer.modules.dicomPlugins:
+        logging.warning('Please install SlicerRT extension to enable loading of DICOM RT Structure Set objects')
+      seriesUID = slicer.dicomDatabase.fileValue(files[0],self.tags['seriesUID'])
+      seriesName = self.defaultSeriesNodeName(seriesUID)
+      loadables = []
+      for loadableIndex in analyzedLoadables[fileListIndex]:
+        loadable = DICOMLoadable()
+        fileNames = vtk.vtkStringArray()
+        analyzer.GetLoadableFileNames(loadableIndex, fileNames)
+        loadable.files = [fileNames.GetValue(i) for i in range(fileNames.GetNumberOfValues())]
+        tag = analyzer.GetLoadableSplitTag(loadableIndex)
+        value = analyzer.GetLoadableSplitValue(loadableIndex)
+        if not tag:
+          loadable.name = self.cleanNodeName(seriesName)
+          loadable.tooltip = "%d files, first file: %s" % (len(loadable.files), loadable.files[0])
+        else:
+          if tag in subseriesTagsToEnumerateValues:
+            loadable.name = seriesName + " - %s %d" % (tag, analyzer.GetLoadableSplitValueIndex(loadableIndex)+1)
+          else:
+            loadable.name = seriesName + " - %s %s" % (tag, value)
+          loadable.name = self.cleanNodeName(loadable.name)
+          loadable.tooltip = "%d files, grouped by %s = %s. First file: %s. %s = %s" % (len(loadable.files), tag, value, loadable.files[0], tag, value)
+        loadable.warning = analyzer.GetLoadableWarning(loadableIndex)
+        loadable.grayscale = analyzer.GetLoadableGrayscale(loadableIndex)
+        loadable.selected = analyzer.GetLoadableSelected(loadableIndex)
+        loadable.confidence = analyzer.GetLoadableConfidence(loadableIndex)
+        loadables.append(loadable)
+      loadablesForFileLists.append(loadables)
+    return loadablesForFileLists
+
   def examineFiles(self,files):
     """ Returns a list of DICOMLoadable instances
     corresponding to ways of interpreting the
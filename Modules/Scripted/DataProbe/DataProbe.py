@@ -80,6 +80,9 @@ class DataProbeInfoWidget(object):
     self.painter = qt.QPainter()
     self.pen = qt.QPen()
 
+    # Used in processEvent()
+    self.layerIJKsArray = vtk.vtkIntArray()
+
     self._createSmall()
 
     #Helper class to calculate and display tensor scalars
@@ -224,25 +227,20 @@ class DataProbeInfoWidget(object):
 
     self.viewInfo.text = self.generateViewDescription(xyz, ras, sliceNode, sliceLogic)
 
-    def _roundInt(value):
-      try:
-        return int(round(value))
-      except ValueError:
-        return 0
+    # voxel index of all layers is computed in one call
+    layerIJKs = self.layerIJKsArray
+    sliceLogic.ProbePosition(xyz, layerIJKs, None, None, None)
 
     hasVolume = False
-    layerLogicCalls = (('L', sliceLogic.GetLabelLayer),
-                       ('F', sliceLogic.GetForegroundLayer),
-                       ('B', sliceLogic.GetBackgroundLayer))
-    for layer,logicCall in layerLogicCalls:
+    layerLogicCalls = (('L', sliceLogic.GetLabelLayer, slicer.vtkMRMLSliceLogic.LayerLabel),
+                       ('F', sliceLogic.GetForegroundLayer, slicer.vtkMRMLSliceLogic.LayerForeground),
+                       ('B', sliceLogic.GetBackgroundLayer, slicer.vtkMRMLSliceLogic.LayerBackground))
+    for layer,logicCall,layerIndex in layerLogicCalls:
       layerLogic = logicCall()
       volumeNode = layerLogic.GetVolumeNode()
-      ijk = [0, 0, 0]
+      ijk = [int(value) for value in layerIJKs.GetTuple3(layerIndex)]
       if volumeNode:
         hasVolume = True
-        xyToIJK = layerLogic.GetXYToIJKTransform()
-        ijkFloat = xyToIJK.TransformDoublePoint(xyz)
-        ijk = [_roundInt(value) for value in ijkFloat]
       self.layerNames[layer].setText(self.generateLayerName(layerLogic))
       self.layerIJKs[layer].setText(self.generateIJKPixelDescription(ijk, layerLogic))
       self.layerValues[layer].setText(self.generateIJKPixelValueDescription(ijk, layerLogic))
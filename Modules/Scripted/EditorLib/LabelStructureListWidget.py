@@ -336,20 +336,24 @@ class LabelStructureListWidget(qt.QWidget):
     combiner = vtkTeem.vtkImageLabelCombine()
 
     #
-    # iterate through structures merging into merge volume
+    # merge all structures into merge volume in one pass,
+    # labels of structures earlier in the list take precedence
     #
     for row in range(rows):
       structureName = self.structures.item(row,2).text()
       structureVolume = self.structureVolume( structureName )
-
       if row == 0:
-        # first row, just copy into merge volume
-        merge.GetImageData().DeepCopy( structureVolume.GetImageData() )
-        continue
+        combiner.SetInputConnection(0, structureVolume.GetImageDataConnection() )
+      elif row == 1:
+        combiner.SetInputConnection(1, structureVolume.GetImageDataConnection() )
+      else:
+        combiner.AddInputConnection(1, structureVolume.GetImageDataConnection() )
 
-      combiner.SetInputConnection(0, merge.GetImageDataConnection() )
-      combiner.SetInputConnection(1, structureVolume.GetImageDataConnection() )
-      self.statusText( "Merging %s" % structureName )
+    if rows == 1:
+      # single structure, just copy into merge volume
+      merge.GetImageData().DeepCopy( self.structureVolume( self.structures.item(0,2).text() ).GetImageData() )
+    elif rows > 1:
+      self.statusText( "Merging %d structures" % rows )
       combiner.Update()
       merge.GetImageData().DeepCopy( combiner.GetOutput() )
 
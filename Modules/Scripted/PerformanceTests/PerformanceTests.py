@@ -37,6 +37,7 @@ class PerformanceTestsWidget(ScriptedLoadableModuleWidget):
         ( 'Web View Test', self.webViewTest ),
         ( 'Fill Out Web Form Test', self.webViewFormTest ),
         ( 'Memory Check', self.memoryCheck ),
+        ( 'Memory Usage', self.memoryUsage ),
       )
 
     for test in tests:
@@ -312,6 +313,45 @@ class PerformanceTestsWidget(ScriptedLoadableModuleWidget):
     self.sysInfoWindow.show()
     self.memoryCallback()
 
+  def memoryUsage(self, maximumNumberOfNodes=20):
+    """Show the nodes that use the most memory in a window"""
+    scene = slicer.mrmlScene
+    nodeSizes = []
+    for nodeIndex in range(scene.GetNumberOfNodes()):
+      node = scene.GetNthNode(nodeIndex)
+      nodeSizes.append((node.GetContentMemorySize(), node))
+    nodeSizes.sort(key=lambda nodeSize: nodeSize[0], reverse=True)
+
+    # Textures and other graphics resources held by the displayable managers
+    graphicsMemorySize = 0
+    layoutManager = slicer.app.layoutManager()
+    if layoutManager:
+      for viewIndex in range(layoutManager.threeDViewCount):
+        view = layoutManager.threeDWidget(viewIndex).threeDView()
+        displayableManagers = vtk.vtkCollection()
+        view.getDisplayableManagers(displayableManagers)
+        for managerIndex in range(displayableManagers.GetNumberOfItems()):
+          graphicsMemorySize += displayableManagers.GetItemAsObject(managerIndex).GetGraphicsMemorySize()
+
+    if not hasattr(self, 'memoryUsageWindow'):
+      self.memoryUsageWindow = qt.QTableWidget()
+      self.memoryUsageWindow.setWindowTitle('Memory Usage')
+      self.memoryUsageWindow.setColumnCount(3)
+      self.memoryUsageWindow.setHorizontalHeaderLabels(['Name', 'Class', 'Size (MB)'])
+      self.memoryUsageWindow.horizontalHeader().setStretchLastSection(True)
+      self.memoryUsageWindow.resize(500, 600)
+    rows = [('All nodes', '', scene.GetNodesMemorySize()),
+            ('Undo stack', '', scene.GetUndoStackMemorySize()),
+            ('Graphics (3D views)', '', graphicsMemorySize)]
+    for size, node in nodeSizes[:maximumNumberOfNodes]:
+      rows.append((node.GetName(), node.GetClassName(), size))
+    self.memoryUsageWindow.setRowCount(len(rows))
+    for rowIndex, row in enumerate(rows):
+      self.memoryUsageWindow.setItem(rowIndex, 0, qt.QTableWidgetItem(row[0]))
+      self.memoryUsageWindow.setItem(rowIndex, 1, qt.QTableWidgetItem(row[1]))
+      self.memoryUsageWindow.setItem(rowIndex, 2, qt.QTableWidgetItem('%.1f' % (row[2] / 1024.0)))
+    self.memoryUsageWindow.show()
+
 
 class sliceLogicTest(object):
   def __init__(self):
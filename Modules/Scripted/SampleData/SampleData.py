@@ -610,11 +610,82 @@ class SampleDataLogic(object):
   def downloadSourceIntoCache(self, source):
     """Download all files for the given source and return a
     list of file paths for the results"""
+    self.prefetchFilesIntoCache(source.uris, source.fileNames, source.checksums)
     filePaths = []
     for uri,fileName,checksum in zip(source.uris,source.fileNames,source.checksums):
       filePaths.append(self.downloadFileIntoCache(uri, fileName, checksum))
     return filePaths
 
+  def downloadSourcesIntoCache(self, sources):
+    """Download all files of all the given sources and return a
+    list of file paths for each source.
+
+    Missing files of all the sources are downloaded concurrently.
+    """
+    uris, fileNames, checksums = [], [], []
+    for source in sources:
+      if source.uris:
+        uris.extend(source.uris)
+        fileNames.extend(source.fileNames)
+        checksums.extend(source.checksums)
+    self.prefetchFilesIntoCache(uris, fileNames, checksums)
+    return [self.downloadSourceIntoCache(source) for source in sources if source.uris]
+
+  def prefetchFilesIntoCache(self, uris, fileNames, checksums, maximumConcurrentDownloads=4):
+    """Download the files that are not in the cache yet, concurrently.
+
+    Checksums are computed while the data is received. Files that fail to
+    download are skipped (they are downloaded again by :func:`downloadFile`)
+    and files with a checksum mismatch are removed.
+
+    Nothing is done if less than two files are missing, a single file is
+    downloaded by :func:`downloadFile` that reports the download progress.
+    """
+    destFolderPath = slicer.mrmlScene.GetCacheManager().GetRemoteCacheDirectory()
+    missingFiles = {}
+    for uri, fileName, checksum in zip(uris or [], fileNames or [], checksums or []):
+      if not uri or not fileName or fileName in missingFiles:
+        continue
+      filePath = destFolderPath + '/' + fileName
+      if not os.path.exists(filePath) or os.stat(filePath).st_size == 0:
+        missingFiles[fileName] = (uri, filePath, checksum)
+    if len(missingFiles) < 2:
+      return
+    try:
+      os.makedirs(destFolderPath, exist_ok=True)
+    except OSError:
+      self.logMessage('<b>Failed to create cache folder %s</b>' % destFolderPath, logging.ERROR)
+      return
+
+    def download(uri, filePath, checksum):
+      (algo, digest) = extractAlgoAndDigest(checksum)
+      current_digest = SampleDataLogic.streamDownload(uri, filePath, algo)
+      return algo is None or current_digest == digest
+
+    import concurrent.futures
+    self.logMessage('<b>Requesting download</b> of %d files ...' % len(missingFiles))
+    with concurrent.futures.ThreadPoolExecutor(max_workers=maximumConcurrentDownloads) as executor:
+      futures = {executor.submit(download, *missingFiles[fileName]): fileName for fileName in missingFiles}
+      pending = set(futures.keys())
+      while pending:
+        # keep the application responsive while the files are downloaded
+        done, pending = concurrent.futures.wait(pending, timeout=0.1)
+        slicer.app.processEvents()
+        for future in done:
+          uri, filePath, checksum = missingFiles[futures[future]]
+          try:
+            checksumOK = future.result()
+          except IOError as e:
+            self.logMessage('<b>\tDownload failed: %s</b>' % e, logging.ERROR)
+            continue
+          if not checksumOK:
+            self.logMessage('<b>Checksum verification failed for %s</b>' % filePath)
+            qt.QFile(filePath).remove()
+            continue
+          if checksum is not None:
+            self.recordVerifiedChecksum(filePath, checksum)
+          self.logMessage('<b>Download finished</b> <i>%s</i>' % futures[future])
+
   def downloadFromSource(self, source, maximumAttemptsCount=3):
     """Given an instance of SampleDataSource, downloads the associated data and
     load them into Slicer if it applies.
@@ -638,6 +709,9 @@ class SampleDataLogic(object):
     resultNodes = []
     resultFilePaths = []
 
+    # Files of multi-file sources are downloaded concurrently
+    self.prefetchFilesIntoCache(source.uris, source.fileNames, source.checksums)
+
     for uri,fileName,nodeName,checksum,loadFile,loadFileType in zip(source.uris,source.fileNames,source.nodeNames,source.checksums,source.loadFiles,source.loadFileType):
 
       current_source = SampleDataSource(uris=uri, fileNames=fileName, nodeNames=nodeName, checksums=checksum, loadFiles=loadFile, loadFileType=loadFileType, loadFileProperties=source.loadFileProperties)
@@ -832,10 +906,10 @@ class SampleDataLogic(object):
     filePath = destFolderPath + '/' + name
     (algo, digest) = extractAlgoAndDigest(checksum)
     if not os.path.exists(filePath) or os.stat(filePath).st_size == 0:
-      import urllib.request, urllib.parse, urllib.error
       self.logMessage('<b>Requesting download</b> <i>%s</i> from %s ...' % (name, uri))
       try:
-        urllib.request.urlretrieve(uri, filePath, self.reportHook)
+        # checksum is computed while downloading
+        current_digest = self.streamDownload(uri, filePath, algo, self.reportHook)
         self.logMessage('<b>Download finished</b>')
       except IOError as e:
         self.logMessage('<b>\tDownload failed: %s</b>' % e, logging.ERROR)
@@ -843,22 +917,24 @@ class SampleDataLogic(object):
 
       if algo is not None:
         self.logMessage('<b>Verifying checksum</b>')
-        current_digest = computeChecksum(algo, filePath)
         if current_digest != digest:
           self.logMessage('<b>Checksum verification failed. Computed checksum %s different from expected checksum %s</b>' % (current_digest, digest))
           qt.QFile(filePath).remove()
         else:
+          self.recordVerifiedChecksum(filePath, checksum)
           self.downloadPercent = 100
           self.logMessage('<b>Checksum OK</b>')
     else:
       if algo is not None:
         self.logMessage('<b>Verifying checksum</b>')
-        current_digest = computeChecksum(algo, filePath)
-        if current_digest != digest:
+        verified = self.isChecksumVerified(filePath, checksum)
+        if not verified and computeChecksum(algo, filePath) != digest:
           self.logMessage('<b>File already exists in cache but checksum is different - re-downloading it.</b>')
           qt.QFile(filePath).remove()
           return self.downloadFile(uri, destFolderPath, name, checksum)
         else:
+          if not verified:
+            self.recordVerifiedChecksum(filePath, checksum)
           self.downloadPercent = 100
           self.logMessage('<b>File already exists and checksum is OK - reusing it.</b>')
       else:
@@ -866,6 +942,73 @@ class SampleDataLogic(object):
         self.logMessage('<b>File already exists in cache - reusing it.</b>')
     return filePath
 
+  @staticmethod
+  def streamDownload(uri, filePath, algo=None, reportHook=None, blockSize=1024*1024):
+    """Download ``uri`` into ``filePath`` and return the digest of the data
+    computed with ``algo`` while it is received (``None`` if no ``algo`` is given).
+
+    Data is written into ``<filePath>.part``, which is renamed when the download
+    is complete, so that an interrupted download does not leave a truncated
+    file in the cache. This method can be called from multiple threads.
+
+    :raises IOError: if the download fails.
+    """
+    import hashlib, urllib.request
+    hash = hashlib.new(algo) if algo is not None else None
+    partFilePath = filePath + '.part'
+    try:
+      with urllib.request.urlopen(uri) as response, open(partFilePath, 'wb') as output:
+        totalSize = int(response.info().get('Content-Length', -1))
+        blocksSoFar = 0
+        while True:
+          block = response.read(blockSize)
+          if not block:
+            break
+          output.write(block)
+          if hash is not None:
+            hash.update(block)
+          blocksSoFar += 1
+          if reportHook and totalSize > 0:
+            reportHook(blocksSoFar, blockSize, totalSize)
+      os.replace(partFilePath, filePath)
+    except:
+      if os.path.exists(partFilePath):
+        os.remove(partFilePath)
+      raise
+    return hash.hexdigest() if hash is not None else None
+
+  checksumRecordsFileName = 'SampleDataChecksums.json'
+
+  def _readChecksumRecords(self, folderPath):
+    import json
+    try:
+      with open(os.path.join(folderPath, self.checksumRecordsFileName)) as recordsFile:
+        return json.load(recordsFile)
+    except (IOError, ValueError):
+      return {}
+
+  def isChecksumVerified(self, filePath, checksum):
+    """Return True if ``filePath`` was verified against ``checksum`` and it has
+    not changed since then, so that cached files are not hashed at each use.
+    """
+    record = self._readChecksumRecords(os.path.dirname(filePath)).get(os.path.basename(filePath))
+    fileInfo = os.stat(filePath)
+    return record == [checksum, fileInfo.st_size, fileInfo.st_mtime]
+
+  def recordVerifiedChecksum(self, filePath, checksum):
+    """Record that ``filePath`` content matches ``checksum``.
+    """
+    import json
+    folderPath = os.path.dirname(filePath)
+    records = self._readChecksumRecords(folderPath)
+    fileInfo = os.stat(filePath)
+    records[os.path.basename(filePath)] = [checksum, fileInfo.st_size, fileInfo.st_mtime]
+    try:
+      with open(os.path.join(folderPath, self.checksumRecordsFileName), 'w') as recordsFile:
+        json.dump(records, recordsFile)
+    except IOError as e:
+      self.logMessage('<b>Failed to record checksum: %s</b>' % e, logging.WARNING)
+
   def loadScene(self, uri,  fileProperties = {}):
     self.logMessage('<b>Requesting load</b> %s ...' % uri)
     fileProperties['fileName'] = uri
@@ -921,6 +1064,7 @@ class SampleDataTest(ScriptedLoadableModuleTest):
   def runTest(self):
     for test in [
       self.test_downloadFromSource_downloadFiles,
+      self.test_downloadFile_checksum,
       self.test_downloadFromSource_downloadZipFile,
       self.test_downloadFromSource_loadMRBFile,
       self.test_downloadFromSource_loadMRMLFile,
@@ -975,6 +1119,29 @@ class SampleDataTest(ScriptedLoadableModuleTest):
     self.assertTrue(os.path.isfile(filePaths[1]))
     self.assertEqual(sceneMTime, slicer.mrmlScene.GetMTime())
 
+  def test_downloadFile_checksum(self):
+    """Checksum is computed while downloading and recorded for the cached file.
+    """
+    import hashlib, tempfile
+    logic = SampleDataLogic()
+    with tempfile.TemporaryDirectory() as tempDir:
+      sourceFilePath = os.path.join(tempDir, 'source.txt')
+      with open(sourceFilePath, 'wb') as sourceFile:
+        sourceFile.write(b'SampleData' * 1000)
+      checksum = 'SHA256:' + hashlib.sha256(b'SampleData' * 1000).hexdigest()
+      cacheDir = os.path.join(tempDir, 'cache')
+      os.makedirs(cacheDir)
+
+      filePath = logic.downloadFile(self.path2uri(sourceFilePath), cacheDir, 'downloaded.txt', checksum)
+      self.assertTrue(os.path.isfile(filePath))
+      self.assertFalse(os.path.exists(filePath + '.part'))
+      self.assertTrue(logic.isChecksumVerified(filePath, checksum))
+
+      # An invalid download is removed from the cache
+      wrongChecksum = 'SHA256:' + hashlib.sha256(b'other').hexdigest()
+      filePath = logic.downloadFile(self.path2uri(sourceFilePath), cacheDir, 'invalid.txt', wrongChecksum)
+      self.assertFalse(os.path.exists(filePath))
+
   def test_downloadFromSource_downloadZipFile(self):
     logic = SampleDataLogic()
     sceneMTime = slicer.mrmlScene.GetMTime()
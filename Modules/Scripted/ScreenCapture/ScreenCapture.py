@@ -673,7 +673,15 @@ class ScreenCaptureWidget(ScriptedLoadableModuleWidget):
     transparentBackground = self.transparentBackgroundCheckBox.checked
     if captureAllViews:
       self.logic.showViewControllers(False)
+    fps = self.videoFrameRateSliderWidget.value
+    forwardBackward = self.forwardBackwardCheckBox.checked
+    numberOfRepeats = int(self.repeatSliderWidget.value)
+    videoWriter = None
     try:
+      if videoOutputRequested and not forwardBackward and numberOfRepeats == 1:
+        # Frames are encoded while they are captured, no image files are needed
+        videoWriter = self.logic.createVideoWriter(fps, self.extraVideoOptionsWidget.text,
+          outputDir, self.videoFileNameWidget.text)
       if numberOfSteps < 2:
         if imageFileNamePattern != self.snapshotFileNamePattern or outputDir != self.snapshotOutputDir:
           self.snapshotIndex = 0
@@ -684,31 +692,27 @@ class ScreenCaptureWidget(ScriptedLoadableModuleWidget):
       elif self.animationModeWidget.currentText == "slice sweep":
         self.logic.captureSliceSweep(viewNode, self.sliceStartOffsetSliderWidget.value,
           self.sliceEndOffsetSliderWidget.value, numberOfSteps, outputDir, imageFileNamePattern,
-          captureAllViews = captureAllViews, transparentBackground = transparentBackground)
+          captureAllViews = captureAllViews, transparentBackground = transparentBackground, videoWriter = videoWriter)
       elif self.animationModeWidget.currentText == "slice fade":
         self.logic.captureSliceFade(viewNode, numberOfSteps, outputDir, imageFileNamePattern,
-        captureAllViews = captureAllViews, transparentBackground = transparentBackground)
+        captureAllViews = captureAllViews, transparentBackground = transparentBackground, videoWriter = videoWriter)
       elif self.animationModeWidget.currentText == "3D rotation":
         self.logic.capture3dViewRotation(viewNode, self.rotationSliderWidget.minimumValue,
           self.rotationSliderWidget.maximumValue, numberOfSteps,
           self.rotationAxisWidget.itemData(self.rotationAxisWidget.currentIndex),
           outputDir, imageFileNamePattern,
-          captureAllViews = captureAllViews, transparentBackground = transparentBackground)
+          captureAllViews = captureAllViews, transparentBackground = transparentBackground, videoWriter = videoWriter)
       elif self.animationModeWidget.currentText == "sequence":
         self.logic.captureSequence(viewNode, self.sequenceBrowserNodeSelectorWidget.currentNode(),
           self.sequenceStartItemIndexWidget.value, self.sequenceEndItemIndexWidget.value,
           numberOfSteps, outputDir, imageFileNamePattern,
-          captureAllViews = captureAllViews, transparentBackground = transparentBackground)
+          captureAllViews = captureAllViews, transparentBackground = transparentBackground, videoWriter = videoWriter)
       else:
         raise ValueError('Unsupported view node type.')
 
       import shutil
 
-      fps = self.videoFrameRateSliderWidget.value
-
-      if numberOfSteps > 1:
-        forwardBackward = self.forwardBackwardCheckBox.checked
-        numberOfRepeats = int(self.repeatSliderWidget.value)
+      if numberOfSteps > 1 and not videoWriter:
         filePathPattern = os.path.join(outputDir, imageFileNamePattern)
         fileIndex = numberOfSteps
         for repeatIndex in range(numberOfRepeats):
@@ -731,20 +735,25 @@ class ScreenCaptureWidget(ScriptedLoadableModuleWidget):
         numberOfSteps *= numberOfRepeats
 
       try:
-        if videoOutputRequested:
+        if videoWriter:
+          self.logic.finishVideo(videoWriter)
+        elif videoOutputRequested:
           self.logic.createVideo(fps, self.extraVideoOptionsWidget.text,
             outputDir, imageFileNamePattern, self.videoFileNameWidget.text)
         elif (self.outputTypeWidget.currentText == "lightbox image"):
           self.logic.createLightboxImage(int(self.lightboxColumnCountSliderWidget.value),
             outputDir, imageFileNamePattern, numberOfSteps, self.lightboxImageFileNameWidget.text)
       finally:
-        if not self.outputTypeWidget.currentText == "image series":
+        if not self.outputTypeWidget.currentText == "image series" and not videoWriter:
           self.logic.deleteTemporaryFiles(outputDir, imageFileNamePattern, numberOfSteps)
 
       self.addLog("Done.")
       self.createdOutputFile = os.path.join(outputDir, self.videoFileNameWidget.text) if videoOutputRequested else outputDir
       self.showCreatedOutputFileButton.enabled = True
     except Exception as e:
+      if videoWriter and videoWriter.encoding:
+        # stop the encoder process
+        videoWriter.finish()
       self.addLog("Error: {0}".format(str(e)))
       import traceback
       traceback.print_exc()
@@ -971,7 +980,11 @@ class ScreenCaptureLogic(ScriptedLoadableModuleLogic):
 
     return sliceOffsetResolution
 
-  def captureImageFromView(self, view, filename, transparentBackground=False):
+  def captureImageFromView(self, view, filename, transparentBackground=False, videoWriter=None):
+    """
+    Capture the view (or all views if view is None) into an image file.
+    If videoWriter is specified then the image is added as next video frame instead of written into a file.
+    """
 
     slicer.app.processEvents()
     if view:
@@ -982,6 +995,12 @@ class ScreenCaptureLogic(ScriptedLoadableModuleLogic):
     else:
       slicer.util.forceRenderAllViews()
 
+    if videoWriter and view and not transparentBackground and self.watermarkPosition < 0:
+      # Pixels are read directly into the encoder queue, no image filters are needed
+      if not videoWriter.addFrameFromRenderWindow(view.renderWindow()):
+        raise ValueError('Adding video frame failed: ' + videoWriter.errorOutput())
+      return
+
     if view is None:
       if transparentBackground:
         logging.warning("Transparent background is only available for single-view capture")
@@ -1036,6 +1055,12 @@ class ScreenCaptureLogic(ScriptedLoadableModuleLogic):
       # image is too small, most likely it is invalid
       raise ValueError('Capture image from view failed')
 
+    if videoWriter:
+      # Video writer crops the frames to even size
+      if not videoWriter.addFrameFromImage(self.addWatermark(capturedImage)):
+        raise ValueError('Adding video frame failed: ' + videoWriter.errorOutput())
+      return
+
     # Make sure image witdth and height is even, otherwise encoding may fail
     imageWidthOdd = (imageSize[0] & 1 == 1)
     imageHeightOdd = (imageSize[1] & 1 == 1)
@@ -1150,7 +1175,7 @@ class ScreenCaptureLogic(ScriptedLoadableModuleLogic):
       raise ValueError('Invalid view node.')
 
   def captureSliceSweep(self, sliceNode, startSliceOffset, endSliceOffset, numberOfImages,
-                        outputDir, outputFilenamePattern, captureAllViews = None, transparentBackground = False):
+                        outputDir, outputFilenamePattern, captureAllViews = None, transparentBackground = False, videoWriter = None):
 
     self.cancelRequested = False
 
@@ -1169,9 +1194,9 @@ class ScreenCaptureLogic(ScriptedLoadableModuleLogic):
     offsetStepSize = (endSliceOffset-startSliceOffset)/(numberOfImages-1)
     for offsetIndex in range(numberOfImages):
       filename = filePathPattern % offsetIndex
-      self.addLog("Write "+filename)
+      self.addLog("Add video frame %d" % offsetIndex if videoWriter else "Write "+filename)
       sliceLogic.SetSliceOffset(startSliceOffset+offsetIndex*offsetStepSize)
-      self.captureImageFromView(None if captureAllViews else sliceView, filename, transparentBackground)
+      self.captureImageFromView(None if captureAllViews else sliceView, filename, transparentBackground, videoWriter)
       if self.cancelRequested:
         break
 
@@ -1180,7 +1205,7 @@ class ScreenCaptureLogic(ScriptedLoadableModuleLogic):
       raise ValueError('User requested cancel.')
 
   def captureSliceFade(self, sliceNode, numberOfImages, outputDir,
-                        outputFilenamePattern, captureAllViews = None, transparentBackground = False):
+                        outputFilenamePattern, captureAllViews = None, transparentBackground = False, videoWriter = None):
 
     self.cancelRequested = False
 
@@ -1200,9 +1225,9 @@ class ScreenCaptureLogic(ScriptedLoadableModuleLogic):
     opacityStepSize = (endForegroundOpacity - startForegroundOpacity) / (numberOfImages - 1)
     for offsetIndex in range(numberOfImages):
       filename = filePathPattern % offsetIndex
-      self.addLog("Write "+filename)
+      self.addLog("Add video frame %d" % offsetIndex if videoWriter else "Write "+filename)
       compositeNode.SetForegroundOpacity(startForegroundOpacity + offsetIndex * opacityStepSize)
-      self.captureImageFromView(None if captureAllViews else sliceView, filename, transparentBackground)
+      self.captureImageFromView(None if captureAllViews else sliceView, filename, transparentBackground, videoWriter)
       if self.cancelRequested:
         break
 
@@ -1212,7 +1237,7 @@ class ScreenCaptureLogic(ScriptedLoadableModuleLogic):
       raise ValueError('User requested cancel.')
 
   def capture3dViewRotation(self, viewNode, startRotation, endRotation, numberOfImages, rotationAxis,
-    outputDir, outputFilenamePattern, captureAllViews = None, transparentBackground = False):
+    outputDir, outputFilenamePattern, captureAllViews = None, transparentBackground = False, videoWriter = None):
     """
     Acquire a set of screenshots of the 3D view while rotating it.
     """
@@ -1246,8 +1271,8 @@ class ScreenCaptureLogic(ScriptedLoadableModuleLogic):
     for offsetIndex in range(numberOfImages):
       if not self.cancelRequested:
         filename = filePathPattern % offsetIndex
-        self.addLog("Write " + filename)
-        self.captureImageFromView(None if captureAllViews else renderView, filename, transparentBackground)
+        self.addLog("Add video frame %d" % offsetIndex if videoWriter else "Write " + filename)
+        self.captureImageFromView(None if captureAllViews else renderView, filename, transparentBackground, videoWriter)
       if rotationAxis == AXIS_YAW:
         renderView.yaw()
       else:
@@ -1274,7 +1299,7 @@ class ScreenCaptureLogic(ScriptedLoadableModuleLogic):
 
   def captureSequence(self, viewNode, sequenceBrowserNode, sequenceStartIndex,
                         sequenceEndIndex, numberOfImages, outputDir, outputFilenamePattern,
-                        captureAllViews = None, transparentBackground = False):
+                        captureAllViews = None, transparentBackground = False, videoWriter = None):
     """
     Acquire a set of screenshots of a view while iterating through a sequence.
     """
@@ -1292,8 +1317,8 @@ class ScreenCaptureLogic(ScriptedLoadableModuleLogic):
     for offsetIndex in range(numberOfImages):
       sequenceBrowserNode.SetSelectedItemNumber(int(sequenceStartIndex+offsetIndex*stepSize))
       filename = filePathPattern % offsetIndex
-      self.addLog("Write " + filename)
-      self.captureImageFromView(None if captureAllViews else renderView, filename, transparentBackground)
+      self.addLog("Add video frame %d" % offsetIndex if videoWriter else "Write " + filename)
+      self.captureImageFromView(None if captureAllViews else renderView, filename, transparentBackground, videoWriter)
       if self.cancelRequested:
         break
 
@@ -1345,6 +1370,36 @@ class ScreenCaptureLogic(ScriptedLoadableModuleLogic):
 
     self.addLog("Lighbox image saved to file: "+outputLightboxImageFilePath)
 
+  def createVideoWriter(self, frameRate, extraOptions, outputDir, videoFileName):
+    """
+    Create a video writer that encodes frames while they are captured, without writing image files.
+    Frames can be added by passing the writer to the capture methods, encoding is completed by finishVideo.
+    """
+    import os.path
+    ffmpegPath = os.path.abspath(self.getFfmpegPath())
+    if not os.path.isfile(ffmpegPath):
+      raise ValueError("Video creation failed: ffmpeg executable path is invalid: "+ffmpegPath)
+    if not os.path.exists(outputDir):
+      os.makedirs(outputDir)
+    videoWriter = slicer.qMRMLVideoWriter()
+    videoWriter.ffmpegPath = ffmpegPath
+    videoWriter.frameRate = frameRate
+    videoWriter.outputFileName = os.path.join(outputDir, videoFileName)
+    videoWriter.extraOptions = [_f for _f in extraOptions.split(' ') if _f]
+    self.addLog("Export to video while capturing: " + videoWriter.outputFileName)
+    return videoWriter
+
+  def finishVideo(self, videoWriter):
+    """
+    Wait for the encoding of all the frames added to the video writer.
+    """
+    self.addLog("Finish video encoding...")
+    if not videoWriter.finish():
+      self.addLog("ffmpeg error output: " + videoWriter.errorOutput())
+      raise ValueError("ffmpeg returned with error")
+    self.addLog("Video export succeeded to file: " + videoWriter.outputFileName)
+    logging.debug("ffmpeg error output: " + videoWriter.errorOutput())
+
   def createVideo(self, frameRate, extraOptions, outputDir, imageFileNamePattern, videoFileName):
     self.addLog("Export to video...")
 